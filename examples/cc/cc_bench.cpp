@@ -0,0 +1,485 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// CCD/CCSD benchmark with synthetic integrals.
+//
+// Runs a fixed number of spin-orbital CCD or CCSD iterations, in the
+// formulation of Stanton, Gauss, Watts, and Bartlett (J. Chem. Phys. 94,
+// 4334 (1991)), on random integrals of the requested size and block
+// sparsity, and reports the time and flops of each term of the amplitude
+// equations (see README). The integrals are neither physical nor
+// antisymmetric, so the energy is only a checksum of the run.
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <tiledarray.h>
+
+namespace {
+
+  typedef TiledArray::TSpArrayD array_type;
+
+  /// Benchmark parameters
+  struct Options {
+    std::string method = "ccsd"; ///< ccd or ccsd
+    long nocc = 0l; ///< Number of occupied orbitals
+    long nvir = 0l; ///< Number of virtual orbitals
+    long bocc = 0l; ///< Block size of the occupied orbitals
+    long bvir = 0l; ///< Block size of the virtual orbitals
+    double sparsity = 100.0; ///< Percent (1-100) of non-zero integral blocks
+    long iterations = 5l; ///< Number of iterations
+    unsigned int seed = 42u; ///< Seed of the integrals
+  }; // struct Options
+
+  void usage(const char* name) {
+    std::cout << "Usage: " << name << " --nocc O --nvir V [options]\n"
+        << "  --method ccd|ccsd  amplitude equations [ccsd]\n"
+        << "  --nocc O        number of occupied orbitals\n"
+        << "  --nvir V        number of virtual orbitals\n"
+        << "  --block B       block size of the occupied and virtual orbitals [16]\n"
+        << "  --bocc, --bvir  block sizes of the occupied and virtual orbitals\n"
+        << "  --sparsity P    percent (1-100) of non-zero integral blocks [100]\n"
+        << "  --iterations N  number of iterations [5]\n"
+        << "  --seed S        seed of the integrals [42]\n";
+  }
+
+  /// Parse the command line
+
+  /// Options are given as \c --name \c value or \c --name=value .
+  /// \throw std::runtime_error When an option or its value is invalid
+  Options parse(int argc, char** argv) {
+    std::map<std::string, std::string> args;
+    for(int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if(arg.compare(0, 2, "--") != 0)
+        throw std::runtime_error("unrecognized argument " + arg);
+      arg.erase(0, 2);
+      const auto eq = arg.find('=');
+      if(eq != std::string::npos)
+        args[arg.substr(0, eq)] = arg.substr(eq + 1);
+      else if(i + 1 < argc)
+        args[arg] = argv[++i];
+      else
+        throw std::runtime_error("missing value of --" + arg);
+    }
+
+    Options opt;
+    auto get = [&] (const std::string& name, long& value) {
+      const auto it = args.find(name);
+      if(it != args.end()) {
+        value = std::stol(it->second);
+        args.erase(it);
+      }
+    };
+    long block = 16l, seed = opt.seed;
+    get("nocc", opt.nocc);
+    get("nvir", opt.nvir);
+    get("block", block);
+    opt.bocc = opt.bvir = block;
+    get("bocc", opt.bocc);
+    get("bvir", opt.bvir);
+    get("iterations", opt.iterations);
+    get("seed", seed);
+    opt.seed = seed;
+    for(auto name : { "method", "sparsity" }) {
+      const auto it = args.find(name);
+      if(it == args.end())
+        continue;
+      if(it->first == "method") opt.method = it->second;
+      else opt.sparsity = std::stod(it->second);
+      args.erase(it);
+    }
+    if(! args.empty())
+      throw std::runtime_error("unrecognized option --" + args.begin()->first);
+
+    if(opt.method != "ccd" && opt.method != "ccsd")
+      throw std::runtime_error("unknown method " + opt.method);
+    if(opt.nocc <= 0l || opt.nvir <= 0l)
+      throw std::runtime_error("orbital counts must be greater than zero");
+    if(opt.bocc <= 0l || opt.bvir <= 0l)
+      throw std::runtime_error("block sizes must be greater than zero");
+    if(opt.sparsity <= 0.0 || opt.sparsity > 100.0)
+      throw std::runtime_error("sparsity must be in (0, 100]");
+    if(opt.iterations <= 0l)
+      throw std::runtime_error("number of iterations must be greater than zero");
+    return opt;
+  }
+
+  /// Uniform blocking of a dimension; the last block holds the remainder
+  TiledArray::TiledRange1 make_trange1(const long size, const long block) {
+    std::vector<long> blocking;
+    for(long i = 0l; i < size; i += block)
+      blocking.push_back(i);
+    blocking.push_back(size);
+    return TiledArray::TiledRange1(blocking.begin(), blocking.end());
+  }
+
+  /// Random tensor with random block sparsity
+
+  /// The same blocks are non-zero on every process, and the elements of a
+  /// block depend only on \c seed and the block, so the tensor does not
+  /// depend on the number of processes.
+  /// \param world The world of the tensor
+  /// \param trange The tiled range of the tensor
+  /// \param sparsity The percent of non-zero blocks
+  /// \param seed The seed of the blocks and elements
+  /// \param scale The elements are uniform in [-scale, scale]
+  array_type make_random(TiledArray::World& world, const TiledArray::TiledRange& trange,
+      const double sparsity, const unsigned int seed, const double scale)
+  {
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 100.0);
+    TiledArray::Tensor<float> norms(trange.tiles_range(), 0.0f);
+    for(std::size_t ord = 0ul; ord < norms.size(); ++ord)
+      if(uniform(engine) < sparsity)
+        norms[ord] = scale * std::sqrt(trange.make_tile_range(ord).volume() / 3.0);
+
+    array_type result(world, trange, TiledArray::SparseShape<float>(norms, trange));
+    result.init_tiles([seed, scale] (const TiledArray::Range& range) {
+      unsigned long hash = seed;
+      for(const auto lo : range.lobound())
+        hash = hash * 1000003ul + lo;
+      std::mt19937 tile_engine(hash);
+      std::uniform_real_distribution<double> value(-scale, scale);
+      array_type::value_type tile(range);
+      for(auto& x : tile)
+        x = value(tile_engine);
+      return tile;
+    });
+    return result;
+  }
+
+  /// Inverse orbital energy denominators
+
+  /// \param world The world of the tensor
+  /// \param trange The tiled range of the tensor, with the occupied modes
+  /// first
+  /// \param nocc_modes The number of occupied modes
+  /// \param eps_occ The occupied orbital energies
+  /// \param eps_vir The virtual orbital energies
+  /// \return The tensor of \f$ 1/(\sum \epsilon_i - \sum \epsilon_a) \f$
+  array_type make_denominator(TiledArray::World& world,
+      const TiledArray::TiledRange& trange, const unsigned int nocc_modes,
+      const std::vector<double>& eps_occ, const std::vector<double>& eps_vir)
+  {
+    TiledArray::Tensor<float> norms(trange.tiles_range(), 0.0f);
+    for(std::size_t ord = 0ul; ord < norms.size(); ++ord)
+      norms[ord] = std::sqrt(float(trange.make_tile_range(ord).volume()));
+
+    array_type result(world, trange, TiledArray::SparseShape<float>(norms, trange));
+    result.init_tiles([nocc_modes, eps_occ, eps_vir] (const TiledArray::Range& range) {
+      array_type::value_type tile(range);
+      for(const auto& index : range) {
+        double denominator = 0.0;
+        for(unsigned int d = 0u; d < range.rank(); ++d)
+          denominator += (d < nocc_modes ? eps_occ[index[d]] : - eps_vir[index[d]]);
+        tile[index] = 1.0 / denominator;
+      }
+      return tile;
+    });
+    return result;
+  }
+
+  /// Time and flops of the terms of the amplitude equations
+  class TermTimer {
+    TiledArray::World& world_;
+    std::vector<std::string> names_; ///< Terms in the order of their first use
+    std::map<std::string, std::vector<double> > stats_; ///< { calls, seconds, flops } of each term
+
+  public:
+
+    explicit TermTimer(TiledArray::World& world) : world_(world) { }
+
+    /// Evaluate and time a term
+
+    /// The term is fenced on both sides, so its time does not overlap with
+    /// the other terms.
+    /// \param name The name of the term
+    /// \param op The evaluation of the term
+    template <typename Op>
+    void operator()(const std::string& name, Op&& op) {
+      world_.gop.fence();
+      const TiledArray::WorkStatistics begin = TiledArray::work_statistics();
+      const double start = madness::wall_time();
+      op();
+      world_.gop.fence();
+      const double time = madness::wall_time() - start;
+      const TiledArray::WorkStatistics end = TiledArray::work_statistics();
+
+      auto it = stats_.find(name);
+      if(it == stats_.end()) {
+        names_.push_back(name);
+        it = stats_.emplace(name, std::vector<double>(3ul, 0.0)).first;
+      }
+      it->second[0] += 1.0;
+      it->second[1] += time;
+      it->second[2] += double(end.flops - begin.flops);
+    }
+
+    /// Print the breakdown of the terms
+
+    /// The flops of all processes are summed, and the time is that of the
+    /// slowest process.
+    /// \note This function is collective.
+    void report(std::ostream& os) {
+      std::vector<double> times, flops;
+      for(const auto& name : names_) {
+        times.push_back(stats_[name][1]);
+        flops.push_back(stats_[name][2]);
+      }
+      world_.gop.max(times.data(), times.size());
+      world_.gop.sum(flops.data(), flops.size());
+      if(world_.rank() != 0)
+        return;
+
+      double total = 0.0;
+      for(const double t : times)
+        total += t;
+      os << "\n" << std::left << std::setw(36) << "term" << std::right
+         << std::setw(8) << "calls" << std::setw(12) << "time (s)"
+         << std::setw(10) << "%" << std::setw(12) << "GFLOP"
+         << std::setw(12) << "GFLOP/s" << "\n" << std::fixed;
+      for(std::size_t i = 0ul; i < names_.size(); ++i) {
+        const double gflop = flops[i] / 1.0e9;
+        os << std::left << std::setw(36) << names_[i] << std::right
+           << std::setw(8) << std::setprecision(0) << stats_[names_[i]][0]
+           << std::setw(12) << std::setprecision(4) << times[i]
+           << std::setw(10) << std::setprecision(1) << 100.0 * times[i] / total
+           << std::setw(12) << std::setprecision(3) << gflop
+           << std::setw(12) << std::setprecision(3)
+           << (times[i] > 0.0 ? gflop / times[i] : 0.0) << "\n";
+      }
+      os << std::left << std::setw(36) << "total" << std::right << std::setw(20)
+         << std::setprecision(4) << total << "\n";
+      os.unsetf(std::ios::fixed);
+    }
+  }; // class TermTimer
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    if(argc < 2) {
+      if(world.rank() == 0)
+        usage(argv[0]);
+      TiledArray::finalize();
+      return 0;
+    }
+    const Options opt = parse(argc, argv);
+    const bool ccsd = (opt.method == "ccsd");
+
+    const TiledArray::TiledRange1 o = make_trange1(opt.nocc, opt.bocc),
+        v = make_trange1(opt.nvir, opt.bvir);
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: " << opt.method << " benchmark with synthetic integrals"
+          << "\nNumber of nodes     = " << world.size()
+          << "\nOccupied orbitals   = " << opt.nocc << " (block size " << opt.bocc << ")"
+          << "\nVirtual orbitals    = " << opt.nvir << " (block size " << opt.bvir << ")"
+          << "\nIntegral sparsity   = " << opt.sparsity << "% non-zero blocks"
+          << "\nIterations          = " << opt.iterations << "\n";
+
+    // Integrals <pq||rs>, scaled so that the amplitudes stay bounded
+    const double scale = 0.1 / double(opt.nocc + opt.nvir);
+    const array_type V_oooo = make_random(world, { o, o, o, o }, opt.sparsity, opt.seed + 1u, scale);
+    const array_type V_ooov = make_random(world, { o, o, o, v }, opt.sparsity, opt.seed + 2u, scale);
+    const array_type V_oovv = make_random(world, { o, o, v, v }, opt.sparsity, opt.seed + 3u, scale);
+    const array_type V_ovvo = make_random(world, { o, v, v, o }, opt.sparsity, opt.seed + 4u, scale);
+    const array_type V_ovvv = make_random(world, { o, v, v, v }, opt.sparsity, opt.seed + 5u, scale);
+    const array_type V_vvvv = make_random(world, { v, v, v, v }, opt.sparsity, opt.seed + 6u, scale);
+
+    // Canonical orbital energies; the off-diagonal Fock matrix is zero
+    std::vector<double> eps_occ(opt.nocc), eps_vir(opt.nvir);
+    for(long i = 0l; i < opt.nocc; ++i)
+      eps_occ[i] = -1.0 - 0.5 * double(i) / double(opt.nocc);
+    for(long a = 0l; a < opt.nvir; ++a)
+      eps_vir[a] = 0.5 + double(a) / double(opt.nvir);
+    const array_type D1 = make_denominator(world, { o, v }, 1u, eps_occ, eps_vir);
+    const array_type D2 = make_denominator(world, { o, o, v, v }, 2u, eps_occ, eps_vir);
+    world.gop.fence();
+
+    // MP2 guess
+    array_type t1, t2, tau, tau_t;
+    t2("i,j,a,b") = D2("i,j,a,b") * V_oovv("i,j,a,b");
+    if(ccsd)
+      t1("i,a") = 0.0 * D1("i,a");
+
+    TermTimer term(world);
+    double energy = 0.0;
+    const double start = madness::wall_time();
+    for(long iter = 0l; iter < opt.iterations; ++iter) {
+      array_type Fae, Fmi, Fme, Wmnij, Wmbej, X, Y, r1, r2;
+
+      // Effective doubles
+      if(ccsd) {
+        term("tau", [&] {
+          tau("i,j,a,b") = t2("i,j,a,b") + t1("i,a") * t1("j,b") - t1("i,b") * t1("j,a");
+          tau_t("i,j,a,b") = t2("i,j,a,b")
+              + 0.5 * (t1("i,a") * t1("j,b") - t1("i,b") * t1("j,a"));
+        });
+      } else {
+        tau = t2;
+        tau_t = t2;
+      }
+
+      // Intermediates
+      term("intermediate Fae", [&] {
+        Fae("a,e") = -0.5 * tau_t("m,n,a,f") * V_oovv("m,n,e,f");
+        if(ccsd)
+          Fae("a,e") += t1("m,f") * V_ovvv("m,a,f,e");
+      });
+      term("intermediate Fmi", [&] {
+        Fmi("m,i") = 0.5 * tau_t("i,n,e,f") * V_oovv("m,n,e,f");
+        if(ccsd)
+          Fmi("m,i") += t1("n,e") * V_ooov("m,n,i,e");
+      });
+      if(ccsd)
+        term("intermediate Fme", [&] {
+          Fme("m,e") = t1("n,f") * V_oovv("m,n,e,f");
+        });
+      term("intermediate Wmnij", [&] {
+        // Includes the tau * tau part of Wabef
+        Wmnij("m,n,i,j") = V_oooo("m,n,i,j") + 0.5 * tau("i,j,e,f") * V_oovv("m,n,e,f");
+        if(ccsd) {
+          X("m,n,i,j") = t1("j,e") * V_ooov("m,n,i,e");
+          Wmnij("m,n,i,j") += X("m,n,i,j") - X("m,n,j,i");
+        }
+      });
+      term("intermediate Wmbej", [&] {
+        if(ccsd) {
+          Y("j,n,f,b") = 0.5 * t2("j,n,f,b") + t1("j,f") * t1("n,b");
+          Wmbej("m,b,e,j") = V_ovvo("m,b,e,j") - Y("j,n,f,b") * V_oovv("m,n,e,f")
+              + t1("j,f") * V_ovvv("m,b,e,f") + t1("n,b") * V_ooov("m,n,j,e");
+        } else {
+          Wmbej("m,b,e,j") = V_ovvo("m,b,e,j") - 0.5 * t2("j,n,f,b") * V_oovv("m,n,e,f");
+        }
+      });
+
+      // Singles equation
+      if(ccsd) {
+        term("T1 Fae", [&] { r1("i,a") = t1("i,e") * Fae("a,e"); });
+        term("T1 Fmi", [&] { r1("i,a") -= t1("m,a") * Fmi("m,i"); });
+        term("T1 Fme", [&] { r1("i,a") += t2("i,m,a,e") * Fme("m,e"); });
+        term("T1 ovvo", [&] { r1("i,a") += t1("n,f") * V_ovvo("n,a,f,i"); });
+        term("T1 ovvv", [&] { r1("i,a") -= 0.5 * t2("i,m,e,f") * V_ovvv("m,a,e,f"); });
+        term("T1 ooov", [&] { r1("i,a") += 0.5 * t2("m,n,a,e") * V_ooov("n,m,i,e"); });
+      }
+
+      // Doubles equation
+      r2("i,j,a,b") = V_oovv("i,j,a,b");
+      term("T2 Fae", [&] {
+        if(ccsd) {
+          Y("b,e") = Fae("b,e") - 0.5 * t1("m,b") * Fme("m,e");
+          X("i,j,a,b") = t2("i,j,a,e") * Y("b,e");
+        } else {
+          X("i,j,a,b") = t2("i,j,a,e") * Fae("b,e");
+        }
+        r2("i,j,a,b") += X("i,j,a,b") - X("i,j,b,a");
+      });
+      term("T2 Fmi", [&] {
+        if(ccsd) {
+          Y("m,j") = Fmi("m,j") + 0.5 * t1("j,e") * Fme("m,e");
+          X("i,j,a,b") = t2("i,m,a,b") * Y("m,j");
+        } else {
+          X("i,j,a,b") = t2("i,m,a,b") * Fmi("m,j");
+        }
+        r2("i,j,a,b") -= X("i,j,a,b") - X("j,i,a,b");
+      });
+      term("T2 Wmnij (hole ladder)", [&] {
+        r2("i,j,a,b") += 0.5 * tau("m,n,a,b") * Wmnij("m,n,i,j");
+      });
+      term("T2 vvvv (particle ladder)", [&] {
+        r2("i,j,a,b") += 0.5 * tau("i,j,e,f") * V_vvvv("a,b,e,f");
+      });
+      if(ccsd)
+        term("T2 ovvv (particle ladder)", [&] {
+          X("i,j,a,b") = (tau("i,j,e,f") * V_ovvv("m,a,e,f")) * t1("m,b");
+          r2("i,j,a,b") += 0.5 * (X("i,j,a,b") - X("i,j,b,a"));
+        });
+      term("T2 Wmbej (ring)", [&] {
+        X("i,j,a,b") = t2("i,m,a,e") * Wmbej("m,b,e,j");
+        if(ccsd)
+          X("i,j,a,b") -= t1("i,e") * (t1("m,a") * V_ovvo("m,b,e,j"));
+        r2("i,j,a,b") += X("i,j,a,b") - X("j,i,a,b") - X("i,j,b,a") + X("j,i,b,a");
+      });
+      if(ccsd) {
+        term("T2 ovvv", [&] {
+          X("i,j,a,b") = t1("i,e") * V_ovvv("j,e,a,b");
+          r2("i,j,a,b") -= X("i,j,a,b") - X("j,i,a,b");
+        });
+        term("T2 ooov", [&] {
+          X("i,j,a,b") = t1("m,a") * V_ooov("i,j,m,b");
+          r2("i,j,a,b") -= X("i,j,a,b") - X("i,j,b,a");
+        });
+      }
+
+      // Update the amplitudes
+      term("update", [&] {
+        t2("i,j,a,b") = D2("i,j,a,b") * r2("i,j,a,b");
+        if(ccsd)
+          t1("i,a") = D1("i,a") * r1("i,a");
+      });
+
+      energy = 0.25 * V_oovv("i,j,a,b").dot(t2("i,j,a,b")).get();
+      if(ccsd)
+        energy += 0.5 * V_oovv("i,j,a,b").dot(t1("i,a") * t1("j,b")).get();
+      const double residual = r2("i,j,a,b").norm().get();
+      if(world.rank() == 0)
+        std::cout << "Iteration " << iter << ": energy = " << std::setprecision(12)
+            << energy << "  residual norm = " << residual << "\n";
+    }
+    const double time = madness::wall_time() - start;
+
+    term.report(std::cout);
+    if(world.rank() == 0)
+      std::cout << "\nAverage iteration time (s) = " << time / double(opt.iterations)
+          << "\nFinal energy (checksum)    = " << std::setprecision(12) << energy << "\n";
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
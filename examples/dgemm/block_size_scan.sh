@@ -5,6 +5,7 @@ cols=4400
 repeats=5
 
 current_dir=`pwd`
+output=$current_dir/block_size_scan.csv
 
 export MAD_NUM_THREADS=4
 
@@ -16,8 +17,8 @@ do
            [[ $(($cols % $j)) -eq 0 ]]; 
            then
                echo "Doing i = $i and j = $j"
-               echo "$i $j" > $current_dir/output_asymm"$i"_"$j".txt
-               $current_dir/ta_dense $rows $i $cols $j $repeats >> $current_dir/output_asymm"$i"_"$j".txt
+               $current_dir/ta_bench --m $rows --bm $i --n $cols --bn $j --k $rows --bk $i \
+                   --repeat $repeats --format csv --output $output
         fi
     done
 done
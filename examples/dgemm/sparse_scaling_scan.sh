@@ -0,0 +1,29 @@
+#!/bin/bash
+
+# Strong scaling of block-sparse contractions over the number of processes,
+# for each block pattern and contraction shape of ta_bench.
+
+size=16384
+block=256
+repeats=5
+procs="1 2 4 8 16"
+
+current_dir=`pwd`
+output=$current_dir/sparse_scaling_scan.csv
+
+export MAD_NUM_THREADS=4
+
+for np in $procs
+do
+    for shape in square tall inner
+    do
+        for pattern in "band --band 4" "cluster --cluster 8 --coupling 5" \
+                       "exp --decay 0.5" "power --decay 3" "random --sparsity 10"
+        do
+            echo "Doing np = $np shape = $shape pattern = $pattern"
+            mpirun -np $np $current_dir/ta_bench --size $size --block $block \
+                --shape $shape --pattern $pattern \
+                --repeat $repeats --format csv --output $output
+        done
+    done
+done
@@ -0,0 +1,478 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Matrix multiply benchmark with machine-readable output.
+//
+// Runs C(m,n) = A(m,k) * B(k,n) for dense matrices and for block-sparse
+// matrices with random, banded, clustered, or decaying block patterns, with
+// a common command line, and reports statistics of the repetitions as text,
+// JSON, or CSV (see README).
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <tiledarray.h>
+#include <TiledArray/version.h>
+
+namespace {
+
+  /// Benchmark parameters
+  struct Options {
+    std::string pattern = "dense"; ///< Block pattern: dense, random, band, cluster, exp, or power
+    std::string shape = "square"; ///< Contraction shape: square, tall, or inner
+    long m = 0l, n = 0l, k = 0l; ///< Matrix dimensions
+    long bm = 0l, bn = 0l, bk = 0l; ///< Block sizes
+    double sparsity = 100.0; ///< Percent (1-100) of non-zero blocks of the random pattern
+    long band = 1l; ///< Number of block diagonals from the center of the band pattern
+    long cluster = 4l; ///< Number of block rows of each cluster of the cluster pattern
+    double coupling = 0.0; ///< Percent (0-100) of non-zero blocks between clusters
+    double decay = 1.0; ///< Decay rate of the exp and power patterns
+    long repeat = 5l; ///< Number of timed repetitions
+    long warmup = 1l; ///< Number of untimed repetitions
+    unsigned int seed = 42u; ///< Seed of the random pattern
+    std::string format = "text"; ///< Output format: text, json, or csv
+    std::string output; ///< Output file, appended to (empty = standard output)
+  }; // struct Options
+
+  /// Summary of the timed repetitions
+  struct Results {
+    std::vector<double> times; ///< Wall time of each repetition
+    double flops = 0.0; ///< Floating point operations of one repetition
+    double comm_bytes = 0.0; ///< Predicted bytes received by all processes in one repetition
+    double bytes_sent = 0.0; ///< Measured bytes sent by all processes in one repetition
+    std::vector<double> rank_flops; ///< Measured floating point operations of each process
+    std::vector<double> peak_bytes; ///< Peak tensor memory of each process
+    double left_blocks = 0.0, right_blocks = 0.0; ///< Number of non-zero argument blocks
+  }; // struct Results
+
+  void usage(const char* name) {
+    std::cout << "Usage: " << name << " --size N [options]\n"
+        << "  --pattern dense|random|band|cluster|exp|power  block pattern of A and B [dense]\n"
+        << "  --size N        set m, n, and k from N and the shape\n"
+        << "  --shape square|tall|inner  m=n=k=N; n=N/8; or m=n=N/8 [square]\n"
+        << "  --m, --n, --k   matrix dimensions\n"
+        << "  --block B       set the block sizes of m, n, and k to B\n"
+        << "  --bm, --bn, --bk  block sizes [128]\n"
+        << "  --sparsity P    percent (1-100) of non-zero blocks (random) [100]\n"
+        << "  --band W        block diagonals from the center (band) [1]\n"
+        << "  --cluster C     block rows of each cluster (cluster) [4]\n"
+        << "  --coupling P    percent (0-100) of blocks between clusters (cluster) [0]\n"
+        << "  --decay D       decay rate of block values with the distance from\n"
+        << "                  the diagonal (exp, power) [1]\n"
+        << "  --repeat R      timed repetitions [5]\n"
+        << "  --warmup W      untimed repetitions [1]\n"
+        << "  --seed S        seed of the random pattern [42]\n"
+        << "  --format text|json|csv  output format [text]\n"
+        << "  --output FILE   append the results to FILE\n";
+  }
+
+  /// Parse the command line
+
+  /// Options are given as \c --name \c value or \c --name=value .
+  /// \throw std::runtime_error When an option or its value is invalid
+  Options parse(int argc, char** argv) {
+    std::map<std::string, std::string> args;
+    for(int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if(arg.compare(0, 2, "--") != 0)
+        throw std::runtime_error("unrecognized argument " + arg);
+      arg.erase(0, 2);
+      const auto eq = arg.find('=');
+      if(eq != std::string::npos)
+        args[arg.substr(0, eq)] = arg.substr(eq + 1);
+      else if(i + 1 < argc)
+        args[arg] = argv[++i];
+      else
+        throw std::runtime_error("missing value of --" + arg);
+    }
+
+    Options opt;
+    auto get = [&] (const std::string& name, long& value) {
+      const auto it = args.find(name);
+      if(it != args.end()) {
+        value = std::stol(it->second);
+        args.erase(it);
+      }
+    };
+    auto get_real = [&] (const std::string& name, double& value) {
+      const auto it = args.find(name);
+      if(it != args.end()) {
+        value = std::stod(it->second);
+        args.erase(it);
+      }
+    };
+    for(auto name : { "pattern", "shape", "format", "output" }) {
+      const auto it = args.find(name);
+      if(it == args.end())
+        continue;
+      if(it->first == "pattern") opt.pattern = it->second;
+      else if(it->first == "shape") opt.shape = it->second;
+      else if(it->first == "format") opt.format = it->second;
+      else opt.output = it->second;
+      args.erase(it);
+    }
+    long size = 0l, block = 128l, seed = opt.seed;
+    get("size", size);
+    get("block", block);
+    const long thin = std::max(size / 8l, 1l);
+    opt.m = (opt.shape == "inner" ? thin : size);
+    opt.n = (opt.shape == "square" ? size : thin);
+    opt.k = size;
+    opt.bm = opt.bn = opt.bk = block;
+    get("m", opt.m); get("n", opt.n); get("k", opt.k);
+    get("bm", opt.bm); get("bn", opt.bn); get("bk", opt.bk);
+    get("band", opt.band);
+    get("cluster", opt.cluster);
+    get("repeat", opt.repeat);
+    get("warmup", opt.warmup);
+    get("seed", seed);
+    opt.seed = seed;
+    get_real("sparsity", opt.sparsity);
+    get_real("coupling", opt.coupling);
+    get_real("decay", opt.decay);
+    if(! args.empty())
+      throw std::runtime_error("unrecognized option --" + args.begin()->first);
+
+    if(opt.m <= 0l || opt.n <= 0l || opt.k <= 0l)
+      throw std::runtime_error("matrix dimensions must be greater than zero");
+    if(opt.bm <= 0l || opt.bn <= 0l || opt.bk <= 0l)
+      throw std::runtime_error("block sizes must be greater than zero");
+    if(opt.pattern != "dense" && opt.pattern != "random" && opt.pattern != "band"
+        && opt.pattern != "cluster" && opt.pattern != "exp" && opt.pattern != "power")
+      throw std::runtime_error("unknown pattern " + opt.pattern);
+    if(opt.shape != "square" && opt.shape != "tall" && opt.shape != "inner")
+      throw std::runtime_error("unknown shape " + opt.shape);
+    if(opt.sparsity <= 0.0 || opt.sparsity > 100.0)
+      throw std::runtime_error("sparsity must be in (0, 100]");
+    if(opt.band <= 0l)
+      throw std::runtime_error("band width must be greater than zero");
+    if(opt.cluster <= 0l)
+      throw std::runtime_error("cluster size must be greater than zero");
+    if(opt.coupling < 0.0 || opt.coupling > 100.0)
+      throw std::runtime_error("coupling must be in [0, 100]");
+    if(opt.decay <= 0.0)
+      throw std::runtime_error("decay rate must be greater than zero");
+    if(opt.repeat <= 0l || opt.warmup < 0l)
+      throw std::runtime_error("invalid number of repetitions");
+    if(opt.format != "text" && opt.format != "json" && opt.format != "csv")
+      throw std::runtime_error("unknown format " + opt.format);
+    return opt;
+  }
+
+  /// Uniform blocking of a dimension; the last block holds the remainder
+  TiledArray::TiledRange1 make_trange1(const long size, const long block) {
+    std::vector<long> blocking;
+    for(long i = 0l; i < size; i += block)
+      blocking.push_back(i);
+    blocking.push_back(size);
+    return TiledArray::TiledRange1(blocking.begin(), blocking.end());
+  }
+
+  /// Block pattern of an argument
+
+  /// The distance of block (i,j) from the diagonal is measured in block
+  /// columns, with the rows scaled to the number of columns:
+  /// - \c random : blocks are non-zero with probability \c sparsity
+  /// - \c band : blocks closer than \c band to the diagonal are non-zero
+  /// - \c cluster : the diagonal blocks of clusters of \c cluster block rows
+  ///   (and the matching columns) are non-zero, and the blocks between
+  ///   clusters with probability \c coupling
+  /// - \c exp , \c power : the values of a block are \f$ e^{-d x} \f$ or
+  ///   \f$ (1 + x)^{-d} \f$ , for distance \f$ x \f$ and decay rate
+  ///   \f$ d \f$ , so the blocks below the zero threshold of
+  ///   \c SparseShape are dropped
+  /// \return The value of the elements of each block; zero blocks are zero
+  TiledArray::Tensor<float> make_values(const TiledArray::TiledRange& trange,
+      const Options& opt, std::mt19937& engine)
+  {
+    const auto& tiles = trange.tiles_range();
+    TiledArray::Tensor<float> values(tiles, 0.0f);
+    const long rows = tiles.extent(0), cols = tiles.extent(1);
+    const long cluster_cols = std::max(opt.cluster * cols / rows, 1l);
+    std::uniform_real_distribution<double> uniform(0.0, 100.0);
+    for(long i = 0l; i < rows; ++i)
+      for(long j = 0l; j < cols; ++j) {
+        const double distance = std::abs(double(i * cols) / double(rows) - double(j));
+        float value = 1.0f;
+        if(opt.pattern == "random")
+          value = (uniform(engine) < opt.sparsity ? 1.0f : 0.0f);
+        else if(opt.pattern == "band")
+          value = (std::abs(i * cols / rows - j) < opt.band ? 1.0f : 0.0f);
+        else if(opt.pattern == "cluster")
+          value = ((i / opt.cluster == j / cluster_cols)
+              || (uniform(engine) < opt.coupling) ? 1.0f : 0.0f);
+        else if(opt.pattern == "exp")
+          value = std::exp(-opt.decay * distance);
+        else if(opt.pattern == "power")
+          value = std::pow(1.0 + distance, -opt.decay);
+        values(i, j) = value;
+      }
+    return values;
+  }
+
+  /// Tile norms of a matrix with the block values \c values
+  TiledArray::Tensor<float> make_norms(const TiledArray::TiledRange& trange,
+      const TiledArray::Tensor<float>& values)
+  {
+    TiledArray::Tensor<float> norms(values.range());
+    for(std::size_t i = 0ul; i < values.size(); ++i)
+      norms[i] = values[i] * std::sqrt(float(trange.make_tile_range(i).volume()));
+    return norms;
+  }
+
+  /// Set the local non-zero tiles of \c array to the block values \c values
+  template <typename Array>
+  void fill(Array& array, const TiledArray::Tensor<float>& values) {
+    for(const auto index : *array.pmap())
+      if(! array.is_zero(index))
+        array.set(index, typename Array::value_type(
+            array.trange().make_tile_range(index), double(values[index])));
+  }
+
+  /// Count the non-zero blocks of an array
+  template <typename Array>
+  double nonzero_blocks(const Array& array) {
+    double count = 0.0;
+    for(std::size_t i = 0ul; i < array.trange().tiles_range().volume(); ++i)
+      if(! array.is_zero(i))
+        count += 1.0;
+    return count;
+  }
+
+  /// Time the repetitions of C = A * B
+  template <typename Array>
+  Results run(TiledArray::World& world, const Options& opt, Array& a, Array& b,
+      const TiledArray::Tensor<float>& a_values,
+      const TiledArray::Tensor<float>& b_values)
+  {
+    Results results;
+    fill(a, a_values);
+    fill(b, b_values);
+    results.left_blocks = nonzero_blocks(a);
+    results.right_blocks = nonzero_blocks(b);
+
+    const auto plan = (a("m,k") * b("k,n")).plan("m,n", world);
+    results.flops = plan.flops;
+    results.comm_bytes = double(plan.total_comm_bytes());
+
+    Array c;
+    for(long i = 0l; i < opt.warmup; ++i) {
+      c("m,n") = a("m,k") * b("k,n");
+      world.gop.fence();
+    }
+
+    results.peak_bytes.assign(world.size(), 0.0);
+    double& local_peak = results.peak_bytes[world.rank()];
+    for(long i = 0l; i < opt.repeat; ++i) {
+      world.gop.fence();
+      TiledArray::MemoryScope scope;
+      const double start = madness::wall_time();
+      c("m,n") = a("m,k") * b("k,n");
+      world.gop.fence();
+      results.times.push_back(madness::wall_time() - start);
+      local_peak = std::max(local_peak, double(scope.end()));
+    }
+    world.gop.sum(results.peak_bytes.data(), results.peak_bytes.size());
+
+    // Work and communication of the last repetition
+    const TiledArray::WorkStatistics work = TiledArray::last_eval_statistics();
+    results.rank_flops.assign(world.size(), 0.0);
+    results.rank_flops[world.rank()] = double(work.flops);
+    world.gop.sum(results.rank_flops.data(), results.rank_flops.size());
+    results.bytes_sent = double(work.bytes_sent);
+    world.gop.sum(results.bytes_sent);
+
+    // Report the slowest process
+    world.gop.max(results.times.data(), results.times.size());
+    return results;
+  }
+
+  /// Statistics of the repetition times
+  struct Statistics {
+    double min, max, mean, median, stddev;
+
+    explicit Statistics(std::vector<double> x) {
+      std::sort(x.begin(), x.end());
+      const double count = double(x.size());
+      min = x.front();
+      max = x.back();
+      mean = std::accumulate(x.begin(), x.end(), 0.0) / count;
+      median = (x.size() % 2ul ? x[x.size() / 2ul] :
+          0.5 * (x[x.size() / 2ul - 1ul] + x[x.size() / 2ul]));
+      double ss = 0.0;
+      for(const double xi : x)
+        ss += (xi - mean) * (xi - mean);
+      stddev = (x.size() > 1ul ? std::sqrt(ss / (count - 1.0)) : 0.0);
+    }
+  }; // struct Statistics
+
+  void print(std::ostream& os, const TiledArray::World& world, const Options& opt,
+      const Results& results, const bool header)
+  {
+    const Statistics time(results.times);
+    const double gflop = results.flops / 1.0e9;
+    const double peak_max = *std::max_element(results.peak_bytes.begin(),
+        results.peak_bytes.end());
+
+    // The ratio of the maximum to the mean work of the processes
+    const double flops_max = *std::max_element(results.rank_flops.begin(),
+        results.rank_flops.end());
+    const double flops_sum = std::accumulate(results.rank_flops.begin(),
+        results.rank_flops.end(), 0.0);
+    const double imbalance = (flops_sum > 0.0 ?
+        flops_max * double(results.rank_flops.size()) / flops_sum : 1.0);
+
+    if(opt.format == "json") {
+      os << std::setprecision(9)
+         << "{\"benchmark\": \"ta_bench\", \"revision\": \"" << TILEDARRAY_REVISION
+         << "\", \"nproc\": " << world.size()
+         << ", \"pattern\": \"" << opt.pattern << "\""
+         << ", \"shape\": \"" << opt.shape << "\""
+         << ", \"m\": " << opt.m << ", \"n\": " << opt.n << ", \"k\": " << opt.k
+         << ", \"bm\": " << opt.bm << ", \"bn\": " << opt.bn << ", \"bk\": " << opt.bk
+         << ", \"sparsity\": " << opt.sparsity << ", \"band\": " << opt.band
+         << ", \"cluster\": " << opt.cluster << ", \"coupling\": " << opt.coupling
+         << ", \"decay\": " << opt.decay
+         << ", \"repeat\": " << opt.repeat << ", \"warmup\": " << opt.warmup
+         << ", \"left_blocks\": " << results.left_blocks
+         << ", \"right_blocks\": " << results.right_blocks
+         << ", \"gflop\": " << gflop
+         << ", \"time\": {\"min\": " << time.min << ", \"median\": " << time.median
+         << ", \"mean\": " << time.mean << ", \"max\": " << time.max
+         << ", \"stddev\": " << time.stddev << "}"
+         << ", \"gflops\": {\"mean\": " << gflop / time.mean
+         << ", \"max\": " << gflop / time.min << "}"
+         << ", \"bytes_moved\": " << results.comm_bytes
+         << ", \"bytes_sent\": " << results.bytes_sent
+         << ", \"flop_imbalance\": " << imbalance
+         << ", \"peak_memory_bytes\": [";
+      for(std::size_t p = 0ul; p < results.peak_bytes.size(); ++p)
+        os << (p ? ", " : "") << results.peak_bytes[p];
+      os << "]}\n";
+    } else if(opt.format == "csv") {
+      if(header)
+        os << "revision,nproc,pattern,m,n,k,bm,bn,bk,sparsity,band,repeat,warmup,"
+              "gflop,time_min,time_median,time_mean,time_max,time_stddev,"
+              "gflops_mean,gflops_max,bytes_moved,peak_memory_max,"
+              "shape,cluster,coupling,decay,bytes_sent,flop_imbalance\n";
+      os << std::setprecision(9) << TILEDARRAY_REVISION << "," << world.size()
+         << "," << opt.pattern << "," << opt.m << "," << opt.n << "," << opt.k
+         << "," << opt.bm << "," << opt.bn << "," << opt.bk << "," << opt.sparsity
+         << "," << opt.band << "," << opt.repeat << "," << opt.warmup << "," << gflop
+         << "," << time.min << "," << time.median << "," << time.mean << "," << time.max
+         << "," << time.stddev << "," << gflop / time.mean << "," << gflop / time.min
+         << "," << results.comm_bytes << "," << peak_max << "," << opt.shape
+         << "," << opt.cluster << "," << opt.coupling << "," << opt.decay
+         << "," << results.bytes_sent << "," << imbalance << "\n";
+    } else {
+      os << "TiledArray: " << opt.pattern << " matrix multiply benchmark"
+         << "\nGit HASH: " << TILEDARRAY_REVISION
+         << "\nNumber of nodes     = " << world.size()
+         << "\nMatrix sizes        = " << opt.m << "x" << opt.k << " * " << opt.k << "x" << opt.n
+         << "\nBlock sizes         = " << opt.bm << "x" << opt.bk << " * " << opt.bk << "x" << opt.bn
+         << "\nNon-zero blocks     = " << results.left_blocks << " * " << results.right_blocks
+         << "\nRepetitions         = " << opt.repeat << " (+" << opt.warmup << " warm-up)"
+         << "\nGFLOP               = " << gflop
+         << "\nWall time (sec)     = min " << time.min << "  median " << time.median
+         << "  mean " << time.mean << "  max " << time.max << "  stddev " << time.stddev
+         << "\nGFLOPS              = mean " << gflop / time.mean << "  max " << gflop / time.min
+         << "\nBytes moved         = " << results.comm_bytes << " predicted, "
+         << results.bytes_sent << " sent"
+         << "\nFLOP imbalance      = " << imbalance << " (max/mean)"
+         << "\nPeak memory (MiB)   = " << peak_max / (1024.0 * 1024.0) << " max/rank\n";
+    }
+  }
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    if(argc < 2) {
+      if(world.rank() == 0)
+        usage(argv[0]);
+      TiledArray::finalize();
+      return 0;
+    }
+    const Options opt = parse(argc, argv);
+
+    const TiledArray::TiledRange1 tr_m = make_trange1(opt.m, opt.bm),
+        tr_n = make_trange1(opt.n, opt.bn), tr_k = make_trange1(opt.k, opt.bk);
+    const TiledArray::TiledRange trange_a{ tr_m, tr_k }, trange_b{ tr_k, tr_n };
+
+    // Every process generates the same pattern
+    std::mt19937 engine(opt.seed);
+    const TiledArray::Tensor<float> a_values = make_values(trange_a, opt, engine);
+    const TiledArray::Tensor<float> b_values = make_values(trange_b, opt, engine);
+
+    Results results;
+    if(opt.pattern == "dense") {
+      TiledArray::TArrayD a(world, trange_a), b(world, trange_b);
+      results = run(world, opt, a, b, a_values, b_values);
+    } else {
+      TiledArray::TSpArrayD a(world, trange_a, TiledArray::SparseShape<float>(
+          make_norms(trange_a, a_values), trange_a));
+      TiledArray::TSpArrayD b(world, trange_b, TiledArray::SparseShape<float>(
+          make_norms(trange_b, b_values), trange_b));
+      results = run(world, opt, a, b, a_values, b_values);
+    }
+
+    if(world.rank() == 0) {
+      if(opt.output.empty()) {
+        print(std::cout, world, opt, results, true);
+      } else {
+        const bool header = ! std::ifstream(opt.output).good();
+        std::ofstream file(opt.output, std::ios::app);
+        print(file, world, opt, results, header);
+      }
+    }
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
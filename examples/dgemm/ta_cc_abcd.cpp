@@ -214,6 +214,12 @@ void cc_abcd(TA::World& world,
     if (false)
       t2_v("i,j,a,b") = t2("i,j,c,d") * v("a,b,c,d");
 
+    // when t2 and v are symmetric under the exchange of particles, the
+    // result is too, and only its unique tiles need to be computed
+    if (false)
+      t2_v("i,j,a,b") = (t2("i,j,c,d") * v("a,b,c,d")).set_symmetry(
+          TA::symmetry::PermutationGroup({TA::symmetry::Permutation{1, 0, 3, 2}}));
+
     // this demonstrates to the PaRSEC team what happens under the hood of the expression above
     if (true) {
       tensor_contract_444(t2_v, t2, v);
@@ -0,0 +1,247 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Exchange build with direct integrals.
+//
+// The (ao ao|df) integrals of the first step of the exchange build,
+// K1("j,Z,P") = C("m,Z") * Eri("m,j,P"), are lazy tiles that are computed
+// when they are evaluated, at a configurable cost per element. The step is
+// timed with the integral tiles:
+//   stored     evaluated once, before the timing, into a stored array
+//   broadcast  evaluated by their owners, and the evaluated tiles broadcast
+//   recompute  broadcast as lazy tiles, and evaluated by every consumer
+// each with and without the cache of evaluated lazy tiles.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <tiledarray.h>
+
+namespace {
+
+  /// Broadcast lazy integral tiles, instead of the evaluated tiles
+  bool recompute_integrals = false;
+
+  /// The number of integral tiles that were evaluated by this process
+  std::atomic<std::size_t>& integral_evaluations() {
+    static std::atomic<std::size_t> evaluations(0ul);
+    return evaluations;
+  }
+
+} // namespace
+
+/// A tile of direct integrals
+
+/// The tile is computed when it is evaluated, which takes \c cost seconds
+/// per element.
+class IntegralTile {
+  TA::Range range_; ///< The range of the tile
+  double cost_; ///< The evaluation time per element, in seconds
+
+public:
+  typedef TA::TensorD eval_type; ///< The evaluated tile type
+
+  IntegralTile() : range_(), cost_(0.0) { }
+  IntegralTile(const TA::Range& range, const double cost) :
+    range_(range), cost_(cost)
+  { }
+
+  /// \return The range of the tile
+  const TA::Range& range() const { return range_; }
+
+  /// Compute the integrals
+  explicit operator eval_type() const {
+    ++integral_evaluations();
+    const auto end = std::chrono::steady_clock::now() +
+        std::chrono::duration<double>(cost_ * double(range_.volume()));
+    while(std::chrono::steady_clock::now() < end) { }
+
+    eval_type result(range_);
+    const double scale = 1.0 / double(range_.volume());
+    for(std::size_t i = 0ul; i < result.size(); ++i)
+      result[i] = scale * double(i % 7ul + 1ul);
+    return result;
+  }
+
+  template <typename Archive>
+  void serialize(Archive& ar) { ar & range_ & cost_; }
+}; // class IntegralTile
+
+namespace TiledArray {
+
+  /// Select whether integral tiles are broadcast or recomputed
+  template <>
+  struct lazy_tile_cost<IntegralTile> {
+    template <typename Range>
+    static double eval_time(const Range&) {
+      return (recompute_integrals ? 0.0 : std::numeric_limits<double>::infinity());
+    }
+  };
+
+} // namespace TiledArray
+
+using array_type = TA::TSpArrayD;
+using integral_array_type = TA::DistArray<IntegralTile, TA::SparsePolicy>;
+
+int main(int argc, char** argv) {
+  // Initialize runtime
+  TA::World& world = TA::initialize(argc, argv);
+
+  // Get command line arguments
+  if(argc < 7) {
+    std::cout << "Usage: ta_k_build_lazy ao_size ao_blk_size occ_size occ_block_size df_size df_blk_size [repetitions] [ns_per_integral]\n";
+    TA::finalize();
+    return 0;
+  }
+  const long ao_size = atol(argv[1]);
+  const long ao_blk_size = atol(argv[2]);
+  const long occ_size = atol(argv[3]);
+  const long occ_blk_size = atol(argv[4]);
+  const long df_size = atol(argv[5]);
+  const long df_blk_size = atol(argv[6]);
+  if (ao_size <= 0 || occ_size <= 0 || df_size <= 0) {
+    std::cerr << "Error: sizes must be greater than zero.\n";
+    return 1;
+  }
+  if (ao_blk_size <= 0 || df_blk_size <= 0 || occ_blk_size <= 0) {
+    std::cerr << "Error: block sizes must be greater than zero.\n";
+    return 1;
+  }
+  const long repeat = (argc >= 8 ? atol(argv[7]) : 5);
+  if (repeat <= 0) {
+    std::cerr << "Error: number of repetitions must be greater than zero.\n";
+    return 1;
+  }
+  const double cost = (argc >= 9 ? atof(argv[8]) : 10.0) * 1.0e-9;
+  if (cost < 0.0) {
+    std::cerr << "Error: the integral cost must not be negative.\n";
+    return 1;
+  }
+
+  // Construct tiled ranges
+  auto make_trange1 = [] (const long size, const long block) {
+    std::vector<long> blocking;
+    for(long i = 0; i < size; i += block)
+      blocking.push_back(i);
+    blocking.push_back(size);
+    return TA::TiledRange1(blocking.begin(), blocking.end());
+  };
+  const TA::TiledRange1 ao_tr1 = make_trange1(ao_size, ao_blk_size);
+  const TA::TiledRange1 occ_tr1 = make_trange1(occ_size, occ_blk_size);
+  const TA::TiledRange1 df_tr1 = make_trange1(df_size, df_blk_size);
+  const TA::TiledRange coeff_trange{ ao_tr1, occ_tr1 };
+  const TA::TiledRange aad_trange{ ao_tr1, ao_tr1, df_tr1 };
+
+  if(world.rank() == 0)
+    std::cout << "TiledArray: Exchange Build Test with Direct Integrals ...\n"
+              << "Number of nodes     = " << world.size()
+              << "\nAO size             = " << ao_size << " (block " << ao_blk_size << ")"
+              << "\nocc size            = " << occ_size << " (block " << occ_blk_size << ")"
+              << "\ndf size             = " << df_size << " (block " << df_blk_size << ")"
+              << "\nIntegral cost       = " << cost * 1.0e9 << " ns"
+              << "\nIntegral tiles      = " << aad_trange.tiles_range().volume()
+              << "\nRepetitions         = " << repeat << "\n";
+
+  auto make_shape = [](const TA::TiledRange& trange) -> TA::SparseShape<float> {
+    TA::Tensor<float> tile_norms(trange.tiles_range(), 1.e20f);
+    return TA::SparseShape<float>(tile_norms, trange);
+  };
+
+  // Construct and initialize arrays
+  array_type C(world, coeff_trange, make_shape(coeff_trange));
+  C.fill(1.0);
+  integral_array_type Eri(world, aad_trange, make_shape(aad_trange));
+  Eri.init_tiles([cost] (const TA::Range& range) { return IntegralTile(range, cost); });
+  world.gop.fence();
+
+  const double k1_gflop = 2.0 * double(occ_size * ao_size * ao_size * df_size) / 1.0e9;
+  double reference = 0.0;
+
+  if(world.rank() == 0)
+    std::cout << "\n" << std::left << std::setw(12) << "integrals" << std::setw(8)
+              << "cache" << std::right << std::setw(14) << "K1 time (s)"
+              << std::setw(12) << "GFLOP/s" << std::setw(16) << "tile evals/it"
+              << std::setw(12) << "cache hits" << std::setw(12) << "error" << "\n";
+
+  // Time K1 with one treatment of the integrals; the time of the first
+  // iteration, which fills the cache, is included.
+  auto run = [&] (const char* mode, const bool cache) {
+    if(cache)
+      Eri.enable_lazy_tile_cache(TA::LazyTileCachePolicy::local_and_received,
+          std::numeric_limits<std::size_t>::max());
+    else
+      Eri.enable_lazy_tile_cache(TA::LazyTileCachePolicy::never, 0ul);
+    Eri.clear_lazy_tile_cache();
+    const std::size_t hits = Eri.lazy_tile_cache()->hits();
+    integral_evaluations() = 0ul;
+    const bool stored = (std::string(mode) == "stored");
+    world.gop.fence();
+
+    array_type Eri_stored;
+    if(stored) {
+      Eri_stored("m,j,P") = Eri("m,j,P");
+      world.gop.fence();
+    }
+
+    array_type K_temp;
+    const double start = madness::wall_time();
+    for(long i = 0; i < repeat; ++i) {
+      if(stored)
+        K_temp("j,Z,P") = C("m,Z") * Eri_stored("m,j,P");
+      else
+        K_temp("j,Z,P") = C("m,Z") * Eri("m,j,P");
+      world.gop.fence();
+    }
+    const double time = (madness::wall_time() - start) / double(repeat);
+
+    double counts[2] = { double(integral_evaluations()),
+        double(Eri.lazy_tile_cache()->hits() - hits) };
+    world.gop.sum(counts, 2);
+    const double norm = K_temp("j,Z,P").norm().get();
+    if(reference == 0.0)
+      reference = norm;
+
+    if(world.rank() == 0) {
+      // Integral tiles evaluated per iteration, by all processes
+      const double evaluations = counts[0] / (stored ? 1.0 : double(repeat));
+      std::cout << std::left << std::setw(12) << mode << std::setw(8)
+                << (cache ? "yes" : "no") << std::right << std::setw(14)
+                << time << std::setw(12) << k1_gflop / time << std::setw(16)
+                << evaluations << std::setw(12) << counts[1] << std::setw(12)
+                << std::abs(norm - reference) / reference << "\n";
+    }
+  };
+
+  run("stored", false);
+  for(const bool cache : { false, true }) {
+    recompute_integrals = false;
+    run("broadcast", cache);
+    recompute_integrals = true;
+    run("recompute", cache);
+  }
+  recompute_integrals = false;
+
+  world.gop.fence();
+  TA::finalize();
+  return 0;
+}
@@ -40,6 +40,15 @@ void print_map(std::size_t m, std::size_t n, const std::vector<ProcessID>& map)
   }
 }
 
+void print_diagnostics(TiledArray::World& world, const std::shared_ptr<TiledArray::Pmap>& pmap,
+    const TiledArray::TiledRange& trange)
+{
+  const TiledArray::PmapDiagnostics diagnostics =
+      TiledArray::pmap_diagnostics(*pmap, trange, TiledArray::DenseShape());
+  if(world.rank() == 0)
+    diagnostics.print(std::cout);
+}
+
 void print_local(TiledArray::World& world, const std::shared_ptr<TiledArray::Pmap>& pmap) {
   for(ProcessID r = 0; r < world.size(); ++r) {
     world.gop.fence();
@@ -60,6 +69,15 @@ int main(int argc, char** argv) {
   std::size_t M = 200;
   std::size_t N = 100;
 
+  std::vector<std::size_t> row_tiles, col_tiles;
+  for(std::size_t i = 0ul; i <= m; ++i)
+    row_tiles.push_back(i * M / m);
+  for(std::size_t j = 0ul; j <= n; ++j)
+    col_tiles.push_back(j * N / n);
+  const TiledArray::TiledRange trange{
+      TiledArray::TiledRange1(row_tiles.begin(), row_tiles.end()),
+      TiledArray::TiledRange1(col_tiles.begin(), col_tiles.end()) };
+
   std::shared_ptr<TiledArray::Pmap> blocked_pmap(new TiledArray::detail::BlockedPmap(world, m * n));
   std::vector<ProcessID> blocked_map = make_map(m, n, blocked_pmap);
 
@@ -76,6 +94,7 @@ int main(int argc, char** argv) {
   }
 
   print_local(world, blocked_pmap);
+  print_diagnostics(world, blocked_pmap, trange);
 
   world.gop.fence();
 
@@ -87,6 +106,7 @@ int main(int argc, char** argv) {
   }
 
   print_local(world, cyclic_pmap);
+  print_diagnostics(world, cyclic_pmap, trange);
 
   world.gop.fence();
 
@@ -97,6 +117,7 @@ int main(int argc, char** argv) {
   }
 
   print_local(world, hash_pmap);
+  print_diagnostics(world, hash_pmap, trange);
   TiledArray::finalize();
 
   return 0;
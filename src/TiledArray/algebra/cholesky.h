@@ -0,0 +1,272 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  cholesky.h
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_CHOLESKY_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_CHOLESKY_H__INCLUDED
+
+#include <vector>
+#include <Eigen/Cholesky>
+#include <TiledArray/math/blas.h>
+#include <TiledArray/conversions/eigen.h>
+#include "../dist_array.h"
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Cholesky factorization of a diagonal tile (POTRF)
+
+    /// \param a A symmetric positive definite tile
+    /// \return The lower triangular tile \c l , where <tt>a = l * l^T</tt>
+    /// \throw TiledArray::Exception When \c a is not positive definite
+    template <typename Tile>
+    inline Tile tile_potrf(const Tile& a) {
+      typedef Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic,
+          Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+      Eigen::LLT<matrix_type> llt(eigen_map(a));
+      if(llt.info() != Eigen::Success)
+        TA_EXCEPTION("cholesky: the matrix is not positive definite");
+      Tile l(a.range());
+      eigen_map(l) = llt.matrixL();
+      return l;
+    }
+
+    /// Right triangular solve of a panel tile (TRSM)
+
+    /// \param a The panel tile
+    /// \param l The lower triangular diagonal tile
+    /// \return <tt>a * l^-T</tt>
+    template <typename Tile>
+    inline Tile tile_trsm_right(const Tile& a, const Tile& l) {
+      Tile x = a.clone();
+      auto x_map = eigen_map(x);
+      eigen_map(l).template triangularView<Eigen::Lower>().transpose().
+          template solveInPlace<Eigen::OnTheRight>(x_map);
+      return x;
+    }
+
+    /// Left triangular solve of a tile (TRSM)
+
+    /// \param b The right-hand side tile
+    /// \param l The lower triangular diagonal tile
+    /// \param transpose Solve with <tt>l^T</tt> instead of \c l
+    /// \return <tt>l^-1 * b</tt> , or <tt>l^-T * b</tt>
+    template <typename Tile>
+    inline Tile tile_trsm_left(const Tile& b, const Tile& l, const bool transpose) {
+      Tile x = b.clone();
+      auto x_map = eigen_map(x);
+      if(transpose)
+        eigen_map(l).template triangularView<Eigen::Lower>().transpose().
+            solveInPlace(x_map);
+      else
+        eigen_map(l).template triangularView<Eigen::Lower>().solveInPlace(x_map);
+      return x;
+    }
+
+    /// Update of a tile with a product of two tiles (GEMM, or SYRK)
+
+    /// \param op_a The operation applied to \c a
+    /// \param op_b The operation applied to \c b
+    /// \param c The tile to be updated
+    /// \param a The left-hand tile
+    /// \param b The right-hand tile
+    /// \return <tt>c - op_a(a) * op_b(b)</tt>
+    template <typename Tile>
+    inline Tile tile_gemm_update(const madness::cblas::CBLAS_TRANSPOSE op_a,
+        const madness::cblas::CBLAS_TRANSPOSE op_b, const Tile& c,
+        const Tile& a, const Tile& b)
+    {
+      typedef typename Tile::value_type value_type;
+      Tile result = c.clone();
+      const integer m = result.range().extent(0);
+      const integer n = result.range().extent(1);
+      const integer k = (op_a == madness::cblas::NoTrans ?
+          a.range().extent(1) : a.range().extent(0));
+      math::gemm(op_a, op_b, m, n, k, value_type(-1), a.data(),
+          integer(a.range().extent(1)), b.data(), integer(b.range().extent(1)),
+          value_type(1), result.data(), n);
+      return result;
+    }
+
+    /// Cache of the tile futures of an array
+
+    /// Remote tiles are fetched once, and the tiles of the array are not
+    /// modified by the algorithms that use the cache.
+    template <typename Array>
+    class TileCache {
+      const Array& array_;
+      std::vector<Future<typename Array::value_type> > tiles_;
+      std::vector<bool> cached_;
+
+    public:
+      TileCache(const Array& array) :
+        array_(array), tiles_(array.trange().tiles_range().volume()),
+        cached_(tiles_.size(), false)
+      { }
+
+      /// \param i The row tile index
+      /// \param j The column tile index
+      /// \return A future to tile <tt>(i,j)</tt>
+      const Future<typename Array::value_type>&
+      operator()(const std::size_t i, const std::size_t j) {
+        const std::size_t ord = array_.trange().tiles_range().ordinal(i, j);
+        if(! cached_[ord]) {
+          tiles_[ord] = array_.find(ord);
+          cached_[ord] = true;
+        }
+        return tiles_[ord];
+      }
+    }; // class TileCache
+
+  }  // namespace detail
+
+  /// Tiled Cholesky factorization
+
+  /// Computes the lower triangular factor \c L of a symmetric positive
+  /// definite matrix, <tt>A = L * L^T</tt> , with the right-looking tiled
+  /// algorithm. Each tile of \c L is computed on the process that owns it,
+  /// in place: tile <tt>(i,j)</tt> is updated with
+  /// <tt>L(i,k) * L(j,k)^T</tt> for <tt>k < j</tt> (GEMM, or SYRK on the
+  /// diagonal), and then factorized (POTRF, <tt>i == j</tt>) or solved
+  /// against <tt>L(j,j)</tt> (TRSM, <tt>i > j</tt>). The tasks are submitted
+  /// to the task queue without blocking, so the factorization of a panel
+  /// proceeds concurrently with the trailing updates of the previous panels;
+  /// the panel tasks have high priority, since they are on the critical
+  /// path. Only the tiles of \c L are communicated.
+  /// \note This function does not block; call \c World::gop.fence() or
+  /// wait for the tiles before \c A is modified.
+  /// \tparam Tile The tile type, a real-valued \c Tensor
+  /// \param A A real symmetric positive definite matrix, with the same tiling
+  /// of the rows and columns; only its lower triangle is referenced
+  /// \return The lower triangular Cholesky factor, with the tiled range and
+  /// process map of \c A
+  template <typename Tile>
+  inline DistArray<Tile, DensePolicy>
+  cholesky(const DistArray<Tile, DensePolicy>& A) {
+    typedef DistArray<Tile, DensePolicy> array_type;
+    TA_USER_ASSERT(A.trange().tiles_range().rank() == 2u,
+        "cholesky: the argument must be a matrix");
+    TA_USER_ASSERT(A.trange().dim(0) == A.trange().dim(1),
+        "cholesky: the rows and columns must have the same tiling");
+
+    World& world = A.world();
+    const std::size_t nt = A.trange().tiles_range().extent(0);
+    array_type L(world, A.trange(), A.pmap());
+    detail::TileCache<array_type> L_tiles(L);
+
+    auto gemm_nt = [] (const Tile& c, const Tile& a, const Tile& b) {
+      return detail::tile_gemm_update(madness::cblas::NoTrans,
+          madness::cblas::Trans, c, a, b);
+    };
+
+    for(std::size_t j = 0ul; j < nt; ++j) {
+      for(std::size_t i = 0ul; i < nt; ++i) {
+        const std::size_t ord = A.trange().tiles_range().ordinal(i, j);
+        if(! L.is_local(ord))
+          continue;
+
+        if(i < j) {
+          L.set(ord, typename array_type::element_type(0));
+          continue;
+        }
+
+        Future<Tile> tile = A.find(ord);
+        for(std::size_t k = 0ul; k < j; ++k)
+          tile = world.taskq.add(gemm_nt, tile, L_tiles(i, k), L_tiles(j, k));
+
+        if(i == j)
+          L.set(ord, world.taskq.add(& detail::tile_potrf<Tile>, tile,
+              madness::TaskAttributes::hipri()));
+        else
+          L.set(ord, world.taskq.add(& detail::tile_trsm_right<Tile>, tile,
+              L_tiles(j, j), madness::TaskAttributes::hipri()));
+      }
+    }
+
+    return L;
+  }
+
+  /// Tiled triangular solve
+
+  /// Solves <tt>L * X = B</tt> (forward substitution), or
+  /// <tt>L^T * X = B</tt> (back substitution), for a lower triangular \c L ,
+  /// e.g. the result of \c cholesky() . As in \c cholesky() , each tile of
+  /// \c X is computed by the process that owns it, and the tasks are
+  /// submitted without blocking. A system <tt>A * X = B</tt> is solved with
+  /// <tt>triangular_solve(L, triangular_solve(L, B), true)</tt> .
+  /// \tparam Tile The tile type, a real-valued \c Tensor
+  /// \param L A lower triangular matrix
+  /// \param B The right-hand side, with the row tiling of \c L
+  /// \param transpose Solve with <tt>L^T</tt> instead of \c L (default =
+  /// false)
+  /// \return The solution, with the tiled range and process map of \c B
+  template <typename Tile>
+  inline DistArray<Tile, DensePolicy>
+  triangular_solve(const DistArray<Tile, DensePolicy>& L,
+      const DistArray<Tile, DensePolicy>& B, const bool transpose = false)
+  {
+    typedef DistArray<Tile, DensePolicy> array_type;
+    TA_USER_ASSERT(L.trange().tiles_range().rank() == 2u,
+        "triangular_solve: L must be a matrix");
+    TA_USER_ASSERT(B.trange().tiles_range().rank() == 2u,
+        "triangular_solve: B must be a matrix");
+    TA_USER_ASSERT(L.trange().dim(1) == B.trange().dim(0),
+        "triangular_solve: the rows of B must have the tiling of L");
+
+    World& world = B.world();
+    const std::size_t nt = L.trange().tiles_range().extent(0);
+    const std::size_t nc = B.trange().tiles_range().extent(1);
+    array_type X(world, B.trange(), B.pmap());
+    detail::TileCache<array_type> L_tiles(L);
+    detail::TileCache<array_type> X_tiles(X);
+
+    auto gemm = [transpose] (const Tile& c, const Tile& a, const Tile& b) {
+      return detail::tile_gemm_update((transpose ? madness::cblas::Trans :
+          madness::cblas::NoTrans), madness::cblas::NoTrans, c, a, b);
+    };
+    auto trsm = [transpose] (const Tile& b, const Tile& l) {
+      return detail::tile_trsm_left(b, l, transpose);
+    };
+
+    for(std::size_t c = 0ul; c < nc; ++c) {
+      for(std::size_t i = 0ul; i < nt; ++i) {
+        const std::size_t ord = B.trange().tiles_range().ordinal(i, c);
+        if(! X.is_local(ord))
+          continue;
+
+        Future<Tile> tile = B.find(ord);
+        if(transpose) {
+          for(std::size_t k = i + 1ul; k < nt; ++k)
+            tile = world.taskq.add(gemm, tile, L_tiles(k, i), X_tiles(k, c));
+        } else {
+          for(std::size_t k = 0ul; k < i; ++k)
+            tile = world.taskq.add(gemm, tile, L_tiles(i, k), X_tiles(k, c));
+        }
+        X.set(ord, world.taskq.add(trsm, tile, L_tiles(i, i),
+            madness::TaskAttributes::hipri()));
+      }
+    }
+
+    return X;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_CHOLESKY_H__INCLUDED
@@ -0,0 +1,310 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  davidson.h
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_DAVIDSON_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_DAVIDSON_H__INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Eigenvalues>
+#include <TiledArray/math/eigen.h>
+#include <TiledArray/algebra/utils.h>
+#include "../dist_array.h"
+
+namespace TiledArray {
+
+  /// Block-Davidson eigensolver
+
+  /// Computes the lowest eigenpairs of a symmetric operator \c a that is
+  /// only available through its action on a vector, <tt>a(x, result)</tt>
+  /// (e.g. an EOM-CC or CIS sigma builder). The subspace vectors and their
+  /// images under \c a are kept as \c DistArray objects; only the small
+  /// subspace matrix \f$ G = V^T A V \f$ is replicated on every process.
+  ///
+  /// Each iteration
+  /// \li extends \f$ G \f$ with the overlaps of the new images, one
+  ///     \c dot_products() traversal (and one all-reduce) per new vector;
+  /// \li diagonalizes \f$ G \f$ and forms the residuals
+  ///     \f$ r_k = \sum_i y_{ik} (A v_i - \theta_k v_i) \f$ with one
+  ///     \c linear_combination() pass each, and reduces all residual norms
+  ///     with one all-reduce;
+  /// \li preconditions the residuals of the unconverged roots, and
+  ///     orthogonalizes them against the subspace with two rounds of
+  ///     classical Gram-Schmidt, where each round is one batched multi-dot
+  ///     and one fused linear combination.
+  ///
+  /// When the subspace would exceed \c max_subspace vectors, it is collapsed
+  /// to the current Ritz vectors.
+  /// \tparam Array The \c DistArray type of the vectors
+  template <typename Array>
+  class DavidsonSolver {
+    public:
+      typedef typename Array::element_type value_type;
+      typedef typename detail::scalar_t<value_type> scalar_type;
+      typedef Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic> EigenMatrixX;
+      typedef Eigen::Matrix<scalar_type, Eigen::Dynamic, 1> EigenVectorX;
+
+      /// Constructor
+
+      /// \param nroots The number of (lowest) eigenpairs to compute
+      /// \param max_subspace The maximum number of subspace vectors
+      ///   (default = 0, which uses \c 8*nroots )
+      /// \param tol The convergence threshold of the 2-norm of the residuals
+      ///   (default = 1e-8)
+      /// \param max_niter The maximum number of iterations (default = 100)
+      DavidsonSolver(unsigned int nroots,
+                     unsigned int max_subspace = 0,
+                     scalar_type tol = 1.0e-8,
+                     unsigned int max_niter = 100) :
+        nroots_(nroots),
+        max_subspace_(max_subspace ? max_subspace : 8 * nroots),
+        tol_(tol), max_niter_(max_niter)
+      {
+        TA_USER_ASSERT(nroots_ > 0u, "DavidsonSolver: nroots must be positive");
+        TA_USER_ASSERT(max_subspace_ >= 2u * nroots_,
+            "DavidsonSolver: max_subspace must be at least 2*nroots");
+      }
+
+      /// Compute the lowest eigenpairs
+
+      /// \tparam F type that evaluates the action of the operator, will call
+      ///   \c F::operator()(x,result)
+      /// \tparam P The preconditioner type, will call
+      ///   \c P::operator()(theta,r,result) to compute an approximation to
+      ///   \f$ (A - \theta)^{-1} r \f$ , e.g. \f$ (\mathrm{diag}(A) - \theta)^{-1} r \f$
+      /// \param a The operator
+      /// \param precond The preconditioner
+      /// \param[in,out] x On input, at least \c nroots guess vectors; on
+      ///   output, the \c nroots eigenvectors, normalized
+      /// \return The \c nroots lowest eigenvalues, in ascending order
+      /// \throw TiledArray::Exception When the guess vectors are linearly
+      ///   dependent or there are fewer than \c nroots of them
+      /// \throw std::domain_error When the eigenpairs are not converged in
+      ///   \c max_niter iterations
+      template <typename F, typename P>
+      EigenVectorX operator()(F& a, const P& precond, std::vector<Array>& x) {
+        TA_USER_ASSERT(x.size() >= nroots_,
+            "DavidsonSolver: not enough guess vectors");
+
+        V_.clear();
+        AV_.clear();
+        G_.resize(0, 0);
+
+        std::vector<Array> new_vectors;
+        for(const Array& xk : x) {
+          Array t = xk;
+          if(orthonormalize(t, new_vectors))
+            new_vectors.push_back(t);
+        }
+        TA_USER_ASSERT(new_vectors.size() >= nroots_,
+            "DavidsonSolver: the guess vectors are linearly dependent");
+        extend(a, new_vectors);
+
+        for(unsigned int iter = 0; iter < max_niter_; ++iter) {
+
+          // Ritz values and vectors of the subspace
+          Eigen::SelfAdjointEigenSolver<EigenMatrixX> eig(G_);
+          const EigenVectorX theta = eig.eigenvalues().head(nroots_);
+          const EigenMatrixX Y = eig.eigenvectors().leftCols(nroots_);
+
+          // residuals, r_k = sum_i y_ik (A v_i - theta_k v_i), and their norms
+          // with one all-reduce
+          std::vector<Array> residuals(nroots_);
+          std::vector<Future<scalar_type> > rnorm2;
+          {
+            ReductionBatch<scalar_type> batch(world());
+            for(unsigned int k = 0; k < nroots_; ++k) {
+              residuals[k] = combine(Y.col(k), value_type(1), AV_,
+                  value_type(-theta[k]), V_);
+              const std::string vars = detail::dummy_annotation(
+                  residuals[k].trange().tiles_range().rank());
+              rnorm2.push_back(residuals[k](vars).squared_norm(batch));
+            }
+            batch.flush();
+          }
+
+          // precondition the residuals of the unconverged roots
+          new_vectors.clear();
+          for(unsigned int k = 0; k < nroots_; ++k) {
+            if(std::sqrt(rnorm2[k].get()) < tol_)
+              continue;
+            Array t;
+            precond(theta[k], residuals[k], t);
+            new_vectors.push_back(t);
+          }
+
+          // converged?
+          if(new_vectors.empty()) {
+            x.resize(nroots_);
+            for(unsigned int k = 0; k < nroots_; ++k)
+              x[k] = combine(Y.col(k), value_type(1), V_, value_type(0), V_);
+            return theta;
+          }
+
+          // collapse the subspace to the Ritz vectors
+          if(V_.size() + new_vectors.size() > max_subspace_) {
+            std::vector<Array> V(nroots_), AV(nroots_);
+            for(unsigned int k = 0; k < nroots_; ++k) {
+              V[k] = combine(Y.col(k), value_type(1), V_, value_type(0), V_);
+              AV[k] = combine(Y.col(k), value_type(1), AV_, value_type(0), AV_);
+            }
+            V_ = std::move(V);
+            AV_ = std::move(AV);
+            G_ = EigenMatrixX(theta.template cast<value_type>().asDiagonal());
+          }
+
+          // orthonormalize the corrections against the subspace and each other
+          std::vector<Array> corrections;
+          for(Array& t : new_vectors)
+            if(orthonormalize(t, corrections))
+              corrections.push_back(t);
+          if(corrections.empty())
+            throw std::domain_error("DavidsonSolver: the subspace cannot be extended");
+
+          extend(a, corrections);
+        }
+
+        throw std::domain_error("DavidsonSolver: max # of iterations exceeded");
+      }
+
+      /// Subspace size accessor
+
+      /// \return The number of vectors in the current subspace
+      std::size_t subspace_size() const { return V_.size(); }
+
+    private:
+      unsigned int nroots_; ///< The number of roots
+      unsigned int max_subspace_; ///< The maximum subspace size
+      scalar_type tol_; ///< The residual norm threshold
+      unsigned int max_niter_; ///< The maximum number of iterations
+      std::vector<Array> V_; ///< The orthonormal subspace vectors
+      std::vector<Array> AV_; ///< The images of the subspace vectors
+      EigenMatrixX G_; ///< The subspace matrix, G(i,j) = <v_i|A|v_j>
+
+      World& world() const { return V_.front().world(); }
+
+      /// Linear combination of the subspace vectors
+
+      /// \return <tt>sum_i y_i (f1 * v1_i + f2 * v2_i)</tt>
+      template <typename Coefs>
+      static Array combine(const Coefs& y,
+          const value_type f1, const std::vector<Array>& v1,
+          const value_type f2, const std::vector<Array>& v2)
+      {
+        std::vector<value_type> c;
+        std::vector<const Array*> terms;
+        for(std::size_t i = 0ul; i < v1.size(); ++i) {
+          c.push_back(f1 * y[i]);
+          terms.push_back(&v1[i]);
+          if(f2 != value_type(0)) {
+            c.push_back(f2 * y[i]);
+            terms.push_back(&v2[i]);
+          }
+        }
+        Array result;
+        linear_combination(result, c, terms);
+        return result;
+      }
+
+      /// Orthonormalize a vector against the subspace
+
+      /// Two rounds of classical Gram-Schmidt, each of which is one batched
+      /// multi-dot and one fused linear combination.
+      /// \param[in,out] t The vector to be orthonormalized
+      /// \param others Additional orthonormal vectors that are not yet in the
+      ///   subspace
+      /// \return \c false if \c t is linearly dependent on the subspace
+      bool orthonormalize(Array& t, const std::vector<Array>& others) const {
+        std::vector<const Array*> basis;
+        for(const Array& v : V_)
+          basis.push_back(&v);
+        for(const Array& v : others)
+          basis.push_back(&v);
+        basis.push_back(&t);
+
+        scalar_type norm0 = 0, norm = 0;
+        for(unsigned int round = 0; round < 2u; ++round) {
+          // overlaps with the basis, and the squared norm of t, in one pass
+          const auto overlaps = dot_products(t, basis);
+          if(round == 0u)
+            norm = norm0 = std::sqrt(std::abs(overlaps.back()));
+          if(basis.size() == 1ul)
+            break;
+
+          std::vector<value_type> c(1, value_type(1));
+          std::vector<const Array*> terms(1, &t);
+          value_type norm2 = overlaps.back();
+          for(std::size_t i = 0ul; i + 1ul < basis.size(); ++i) {
+            c.push_back(-overlaps[i]);
+            terms.push_back(basis[i]);
+            norm2 -= overlaps[i] * overlaps[i];
+          }
+          linear_combination(t, c, terms);
+          norm = std::sqrt(std::max(scalar_type(0), scalar_type(norm2)));
+        }
+
+        if(norm <= 1.0e-10 * norm0 || norm == scalar_type(0))
+          return false;
+        scale(t, value_type(1) / norm);
+        return true;
+      }
+
+      /// Add orthonormal vectors to the subspace
+
+      /// \param a The operator
+      /// \param vectors The orthonormal vectors to be added
+      template <typename F>
+      void extend(F& a, const std::vector<Array>& vectors) {
+        const std::size_t n0 = V_.size();
+        const std::size_t n = n0 + vectors.size();
+        for(const Array& v : vectors) {
+          Array av;
+          a(v, av);
+          V_.push_back(v);
+          AV_.push_back(av);
+        }
+
+        // G(i,j) = <v_i|A v_j> for the new columns, one multi-dot per new
+        // image
+        G_.conservativeResize(n, n);
+        std::vector<const Array*> basis;
+        for(const Array& v : V_)
+          basis.push_back(&v);
+        for(std::size_t j = n0; j < n; ++j) {
+          const auto overlaps = dot_products(AV_[j], basis);
+          for(std::size_t i = 0ul; i < n; ++i)
+            G_(i,j) = overlaps[i];
+        }
+        // symmetrize the new rows and block
+        for(std::size_t j = n0; j < n; ++j)
+          for(std::size_t i = 0ul; i < n0; ++i)
+            G_(j,i) = G_(i,j);
+        for(std::size_t j = n0; j < n; ++j)
+          for(std::size_t i = n0; i < j; ++i)
+            G_(i,j) = G_(j,i) = 0.5 * (G_(i,j) + G_(j,i));
+      }
+  }; // class DavidsonSolver
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_DAVIDSON_H__INCLUDED
@@ -27,12 +27,55 @@
 #define TILEDARRAY_ALGEBRA_DIIS_H__INCLUDED
 
 #include <deque>
+#include <vector>
 #include <TiledArray/math/eigen.h>
 #include <TiledArray/algebra/utils.h>
+#include <TiledArray/compressed_array.h>
 #include "../dist_array.h"
 
 namespace TiledArray {
 
+  namespace detail {
+
+    /// A DIIS history vector
+
+    /// Vectors other than arrays of tensors are held as is.
+    /// \tparam D The vector type
+    template <typename D>
+    class DIISVector {
+    private:
+      D x_; ///< The vector
+
+    public:
+      DIISVector(const D& x, const TensorCompression::Mode, const double) :
+        x_(x)
+      { }
+
+      /// \return A pointer to the vector
+      const D* uncompressed() const { return & x_; }
+
+      /// \return A copy of the vector
+      D get() const { return x_; }
+    }; // class DIISVector
+
+    /// A DIIS history array, which may be held compressed
+
+    /// \tparam T The element type of the tiles
+    /// \tparam A The allocator type of the tiles
+    /// \tparam Policy The policy type of the array
+    template <typename T, typename A, typename Policy>
+    class DIISVector<DistArray<Tensor<T, A>, Policy> > :
+        public CompressedArray<Tensor<T, A>, Policy>
+    {
+    public:
+      DIISVector(const DistArray<Tensor<T, A>, Policy>& x,
+          const TensorCompression::Mode mode, const double tolerance) :
+        CompressedArray<Tensor<T, A>, Policy>(x, mode, tolerance)
+      { }
+    }; // class DIISVector
+
+  }  // namespace detail
+
   /// DIIS (``direct inversion of iterative subspace'') extrapolation
 
   /// The DIIS class provides DIIS extrapolation to an iterative solver of
@@ -76,6 +119,11 @@ namespace TiledArray {
   ///
   /// The original DIIS reference: P. Pulay, Chem. Phys. Lett. 73, 393 (1980).
   ///
+  /// The history vectors sit idle between iterations, and the history of
+  /// arrays may be held compressed (see \c set_compression() ), so a larger
+  /// subspace fits in the same memory. Compressed vectors are decompressed
+  /// one at a time when they are used.
+  ///
   /// \tparam D type of \c x
   template <typename D>
   class DIIS {
@@ -84,6 +132,7 @@ namespace TiledArray {
       typedef typename detail::scalar_t<value_type> scalar_type;
       typedef Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> EigenMatrixX;
       typedef Eigen::Matrix<value_type, Eigen::Dynamic, 1> EigenVectorX;
+      typedef detail::DIISVector<D> stored_type; ///< The type of the history vectors
 
       /// Constructor
 
@@ -116,7 +165,9 @@ namespace TiledArray {
              iter(0), ngroup(ngr),
              ngroupdiis(ngrdiis),
              damping_factor(dmp),
-             mixing_fraction(mf)
+             mixing_fraction(mf),
+             compression_(TensorCompression::none),
+             compression_tolerance_(0.0)
            {
             init();
            }
@@ -126,6 +177,24 @@ namespace TiledArray {
         x_extrap_.clear();
       }
 
+      /// Set the compression of the history vectors
+
+      /// The history vectors that are stored after this call are held
+      /// compressed (see \c CompressedArray ), when \c D is an array of
+      /// tensors. The \c lossy mode bounds the absolute error of each
+      /// element of the history vectors by \c tolerance , which should be
+      /// well below the convergence threshold.
+      /// \param mode The compression mode
+      /// \param tolerance Elements with a magnitude less than \c tolerance
+      /// are set to zero in \c lossy mode [ default = 0 ]
+      void set_compression(const TensorCompression::Mode mode,
+          const double tolerance = 0.0)
+      {
+        TA_ASSERT(tolerance >= 0.0);
+        compression_ = mode;
+        compression_tolerance_ = tolerance;
+      }
+
       /// \param[in,out] x On input, the most recent solution guess; on output,
       ///   the extrapolated guess
       /// \param[in,out] error On input, the most recent error; on output, the
@@ -153,9 +222,13 @@ namespace TiledArray {
 
         // extrapolate the error if needed
         if (extrapolate_error && (mixing_fraction == 0.0 || x_extrap_.empty())) {
+          std::vector<value_type> coefs(1, value_type(1));
+          std::vector<const stored_type*> terms;
           for (unsigned int k=nskip_, kk=1; k < nvec; ++k, ++kk) {
-            axpy(error, C_[kk], errors_[k]);
+            coefs.push_back(C_[kk]);
+            terms.push_back(&errors_[k]);
           }
+          combine(error, coefs, &error, terms);
         }
       }
 
@@ -184,13 +257,13 @@ namespace TiledArray {
         }
 
         // push x to the set
-        x_.push_back(x);
+        x_.push_back(stored_type(x, compression_, compression_tolerance_));
 
         if (iter == 1) { // the first iteration
           if (not x_extrap_.empty() && do_mixing) {
-            zero(x);
-            axpy(x, (1.0-mixing_fraction), x_[0]);
-            axpy(x, mixing_fraction, x_extrap_[0]);
+            combine(x,
+                {value_type(1.0-mixing_fraction), value_type(mixing_fraction)},
+                nullptr, {&x_[0], &x_extrap_[0]});
           }
         }
         else if (iter > start && (((iter - start) % ngroup) < ngroupdiis)) { // not the first iteration and need to extrapolate?
@@ -200,21 +273,27 @@ namespace TiledArray {
 
           TA_USER_ASSERT(c.size() == rank,
                          "DIIS: numbers of coefficients and x's do not match");
-          zero(x);
+          // form the extrapolated x in one pass over all terms
+          std::vector<value_type> coefs;
+          std::vector<const stored_type*> terms;
           for (unsigned int k=nskip, kk=1; k < nvec; ++k, ++kk) {
             if (not do_mixing || x_extrap_.empty()) {
-              //std::cout << "contrib " << k << " c=" << c[kk] << ":" << std::endl << x_[k] << std::endl;
-              axpy(x, c[kk], x_[k]);
+              coefs.push_back(c[kk]);
+              terms.push_back(&x_[k]);
             } else {
-              axpy(x, c[kk] * (1.0 - mixing_fraction), x_[k]);
-              axpy(x, c[kk] * mixing_fraction, x_extrap_[k]);
+              coefs.push_back(c[kk] * (1.0 - mixing_fraction));
+              terms.push_back(&x_[k]);
+              coefs.push_back(c[kk] * mixing_fraction);
+              terms.push_back(&x_extrap_[k]);
             }
           }
+          combine(x, coefs, nullptr, terms);
 
         } // do DIIS
 
         // only need to keep extrapolated x if doing mixing
-        if (do_mixing) x_extrap_.push_back(x);
+        if (do_mixing)
+          x_extrap_.push_back(stored_type(x, compression_, compression_tolerance_));
       }
 
       /// calling this function computes extrapolation parameters,
@@ -241,13 +320,15 @@ namespace TiledArray {
         }
 
         // push error to the set
-        errors_.push_back(error);
+        errors_.push_back(stored_type(error, compression_, compression_tolerance_));
         const unsigned int nvec = errors_.size();
 
-        // and compute the most recent elements of B, B(i,j) = <ei|ej>
-        for (unsigned int i=0; i < nvec-1; i++)
-          B_(i,nvec-1) = B_(nvec-1,i) = dot_product(errors_[i], errors_[nvec-1]);
-        B_(nvec-1,nvec-1) = dot_product(errors_[nvec-1], errors_[nvec-1]);
+        // and compute the most recent elements of B, B(i,j) = <ei|ej>, with
+        // a single traversal of the most recent error and one global sync
+        const auto overlaps = history_dot_products(error);
+        for (unsigned int i=0; i < nvec; i++)
+          B_(i,nvec-1) = B_(nvec-1,i) = overlaps[i];
+        set_error(std::sqrt(std::abs(B_(nvec-1,nvec-1))));
 
         // compute extrapolation coefficients C_ and number of skipped vectors nskip_
         if (iter > start && (((iter - start) % ngroup) < ngroupdiis)) { // not the first iteration and need to extrapolate?
@@ -323,7 +404,8 @@ namespace TiledArray {
         iter=0;
         if (data) {
           const bool do_mixing = (mixing_fraction != 0.0);
-          if (do_mixing) x_extrap_.push_front(*data);
+          if (do_mixing)
+            x_extrap_.push_front(stored_type(*data, compression_, compression_tolerance_));
         }
       }
 
@@ -340,6 +422,15 @@ namespace TiledArray {
       /// calling this function returns whether diis parameters C_ and nskip_ have been computed
       bool parameters_computed() { return parameters_computed_; }
 
+      /// calling this function returns the 2-norm of the most recent error,
+      /// which is computed with the DIIS overlaps at no extra cost
+      /// (see \c ThresholdSchedule )
+      scalar_type error_norm() const {
+        TA_USER_ASSERT(errorset_,
+                       "DIIS: no error has been given");
+        return error_;
+      }
+
     private:
       scalar_type error_;
       bool errorset_;
@@ -357,13 +448,78 @@ namespace TiledArray {
       bool parameters_computed_; //! whether diis parameters C_ and nskip_ have been computed
       unsigned int nskip_; //! number of skipped vectors in extrapolation
 
-      std::deque<D> x_; //!< set of most recent x given as input (i.e. not exrapolated)
-      std::deque<D> errors_; //!< set of most recent errors
-      std::deque<D> x_extrap_; //!< set of most recent extrapolated x
+      TensorCompression::Mode compression_; //!< compression of the history vectors
+      double compression_tolerance_; //!< largest magnitude of the dropped elements
+
+      std::deque<stored_type> x_; //!< set of most recent x given as input (i.e. not exrapolated)
+      std::deque<stored_type> errors_; //!< set of most recent errors
+      std::deque<stored_type> x_extrap_; //!< set of most recent extrapolated x
 
       void set_error(scalar_type e) { error_ = e; errorset_ = true; }
       scalar_type error() { return error_; }
 
+      /// Linear combination of history vectors
+
+      /// Uncompressed vectors are combined in one pass (see
+      /// \c linear_combination() ); compressed vectors are decompressed and
+      /// added one at a time, so at most one of them is decompressed at once.
+      /// \param[out] y The result
+      /// \param c The coefficients, where \c c[0] is the coefficient of
+      /// \c x0 , if it is given
+      /// \param x0 The first term, or a null pointer
+      /// \param x The history vectors of the other terms
+      void combine(D& y, const std::vector<value_type>& c, const D* x0,
+          const std::vector<const stored_type*>& x) const
+      {
+        TA_ASSERT(c.size() == (x0 ? 1ul : 0ul) + x.size());
+        std::vector<const D*> terms;
+        if(x0)
+          terms.push_back(x0);
+        for(const stored_type* xk : x)
+          if(xk->uncompressed())
+            terms.push_back(xk->uncompressed());
+        if(terms.size() == c.size()) {
+          linear_combination(y, c, terms);
+          return;
+        }
+
+        const std::size_t offset = (x0 ? 1ul : 0ul);
+        D result;
+        if(x0) {
+          linear_combination(result, {c[0]}, {x0});
+        } else {
+          const D x_front = x.front()->get();
+          linear_combination(result, {c[0]}, {&x_front});
+        }
+        for(std::size_t k = 1ul; k < c.size(); ++k)
+          axpy(result, c[k], x[k - offset]->get());
+        y = result;
+      }
+
+      /// Dot products of the most recent error with the error history
+
+      /// \param error The most recent error
+      /// \return The dot products of \c error with each vector in \c errors_
+      std::vector<value_type> history_dot_products(const D& error) const {
+        std::vector<const D*> prev_errors;
+        for(const stored_type& e : errors_)
+          if(e.uncompressed())
+            prev_errors.push_back(e.uncompressed());
+        if(prev_errors.size() == errors_.size()) {
+          const auto overlaps = dot_products(error, prev_errors);
+          return std::vector<value_type>(overlaps.begin(), overlaps.end());
+        }
+
+        // Decompress the errors one at a time
+        std::vector<value_type> overlaps;
+        overlaps.reserve(errors_.size());
+        for(const stored_type& e : errors_) {
+          const D ei = e.get();
+          overlaps.push_back(dot_products(error, std::vector<const D*>(1, &ei)).front());
+        }
+        return overlaps;
+      }
+
       void init() {
         iter = 0;
 
@@ -0,0 +1,245 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  gmres.h
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_GMRES_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_GMRES_H__INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <TiledArray/algebra/utils.h>
+#include "../dist_array.h"
+
+namespace TiledArray {
+
+  /// Solves linear system <tt> a(x) = b </tt> using the restarted GMRES
+  /// method, where \c a is a linear, not necessarily symmetric, function of
+  /// \c x .
+
+  /// The Krylov basis is built with right preconditioning, and the
+  /// preconditioned basis vectors are kept (flexible GMRES), so the
+  /// preconditioner may change between iterations. Each Arnoldi step
+  /// orthogonalizes <tt>w = a(M^-1 v_j)</tt> with classical Gram-Schmidt:
+  /// the inner products <tt>(v_i . w)</tt> and <tt>(w . w)</tt> are
+  /// computed with one fused reduction (see \c dot_products() ), the norm of
+  /// the orthogonalized vector follows from
+  /// <tt>|w|^2 - sum_i (v_i . w)^2</tt> , and the next basis vector is
+  /// formed in one pass with \c linear_combination() . A second
+  /// Gram-Schmidt pass, with one more reduction, is made only when that
+  /// norm indicates a loss of orthogonality.
+  /// \tparam D The type of \c x and \c b , which must provide the
+  /// functions \c size() , \c dot_products() , \c linear_combination() and
+  /// \c norm2() (see \c algebra/utils.h )
+  /// \tparam F type that evaluates the LHS, will call \c F::operator()(x,result)
+  /// \tparam P The preconditioner type, an approximate inverse of \c a , will
+  /// call \c P::operator()(r,result) (e.g. \c BlockDiagonalPreconditioner )
+  template <typename D, typename F, typename P>
+  struct GMRESSolver {
+    typedef typename D::element_type value_type;
+
+    /// \param restart The dimension of the Krylov subspace before a restart
+    /// (default = 30)
+    /// \param max_niter The maximum number of iterations (default = 1000)
+    explicit GMRESSolver(const unsigned int restart = 30u,
+        const unsigned int max_niter = 1000u) :
+      restart_(restart), max_niter_(max_niter)
+    { }
+
+    /// \param a object of type F
+    /// \param b RHS
+    /// \param x unknown
+    /// \param preconditioner The preconditioner
+    /// \param convergence_target The convergence target [default = 1e-10]
+    /// \return The 2-norm of the residual, a(x) - b, divided by the number of
+    /// elements in the residual.
+    value_type operator()(F& a, const D& b, D& x, const P& preconditioner,
+        value_type convergence_target = 1.0e-10)
+    {
+      const std::size_t rhs_size = size(b);
+      const value_type target = convergence_target * value_type(rhs_size);
+
+      // starting guess: x_0 = M^-1 . b
+      D XX;
+      preconditioner(b, XX);
+
+      std::vector<D> V, Z;
+      std::vector<std::vector<value_type> > H; // the columns of R
+      std::vector<value_type> cs, sn, g;
+      unsigned int iter = 0u;
+      while (true) {
+
+        // r = b - a(x), v_0 = r / |r|
+        D RR;
+        a(XX, RR);
+        linear_combination(RR, { value_type(1), value_type(-1) }, { &b, &RR });
+        const value_type beta = norm2(RR);
+        if (beta < target) {
+          x = XX;
+          return beta / value_type(rhs_size);
+        }
+        if (iter >= max_niter_) {
+          x = XX;
+          throw std::domain_error("GMRES: max # of iterations exceeded");
+        }
+
+        V.assign(1ul, D());
+        linear_combination(V[0], { value_type(1) / beta }, { &RR });
+        Z.clear();
+        H.clear();
+        cs.clear();
+        sn.clear();
+        g.assign(1ul, beta);
+
+        for (unsigned int j = 0u; j < restart_ && iter < max_niter_; ++j, ++iter) {
+
+          // w = a(M^-1 v_j)
+          Z.emplace_back();
+          preconditioner(V[j], Z[j]);
+          D WW;
+          a(Z[j], WW);
+
+          // h_ij = (v_i . w), and the norm of w - sum_i h_ij v_i
+          std::vector<value_type> h, hc;
+          value_type h_next = orthogonalize(V, WW, h);
+          if (h_next * h_next < value_type(0.5) * (h_next * h_next + squared_sum(h))) {
+            // Reorthogonalize w against the basis
+            D WW_orth;
+            linear_combination(WW_orth, combination_coefficients(h, value_type(1)),
+                combination_terms(V, WW));
+            WW = WW_orth;
+            h_next = orthogonalize(V, WW, hc);
+            for (std::size_t i = 0ul; i < h.size(); ++i)
+              h[i] += hc[i];
+          } else {
+            hc = h;
+          }
+
+          // v_j+1 = (w - sum_i h_ij v_i) / h_j+1,j
+          if (h_next > value_type(0)) {
+            const std::vector<value_type> c = combination_coefficients(hc, h_next);
+            V.emplace_back();
+            linear_combination(V.back(), c, combination_terms(V, WW, j + 1u));
+          }
+          h.push_back(h_next);
+
+          // Apply the previous rotations to the new column of H, and compute
+          // the rotation that eliminates h_j+1,j
+          for (std::size_t i = 0ul; i < j; ++i) {
+            const value_type t = cs[i] * h[i] + sn[i] * h[i + 1ul];
+            h[i + 1ul] = -sn[i] * h[i] + cs[i] * h[i + 1ul];
+            h[i] = t;
+          }
+          const value_type r = std::sqrt(h[j] * h[j] + h_next * h_next);
+          cs.push_back(r > value_type(0) ? h[j] / r : value_type(1));
+          sn.push_back(r > value_type(0) ? h_next / r : value_type(0));
+          h[j] = r;
+          h.pop_back();
+          H.push_back(h);
+          g.push_back(-sn[j] * g[j]);
+          g[j] *= cs[j];
+
+          if (std::abs(g[j + 1u]) < target || h_next == value_type(0)) {
+            ++iter;
+            break;
+          }
+        }
+
+        // x += sum_j y_j M^-1 v_j, where R y = g
+        const std::size_t k = H.size();
+        std::vector<value_type> y(k);
+        for (std::size_t i = k; i-- > 0ul; ) {
+          value_type t = g[i];
+          for (std::size_t l = i + 1ul; l < k; ++l)
+            t -= H[l][i] * y[l];
+          y[i] = t / H[i][i];
+        }
+        std::vector<value_type> c(1ul, value_type(1));
+        std::vector<const D*> terms(1ul, &XX);
+        for (std::size_t i = 0ul; i < k; ++i) {
+          c.push_back(y[i]);
+          terms.push_back(&Z[i]);
+        }
+        linear_combination(XX, c, terms);
+      } // restart loop
+    }
+
+  private:
+
+    unsigned int restart_; ///< The dimension of the Krylov subspace
+    unsigned int max_niter_; ///< The maximum number of iterations
+
+    /// Gram-Schmidt coefficients of a vector
+
+    /// \param V The basis
+    /// \param w The vector
+    /// \param[out] h The dot products <tt>(v_i . w)</tt>
+    /// \return The norm of <tt>w - sum_i h_i v_i</tt> , computed from the
+    /// norm of \c w
+    static value_type orthogonalize(const std::vector<D>& V, const D& w,
+        std::vector<value_type>& h)
+    {
+      h = dot_products(w, combination_terms(V, w));
+      const value_type ww = h.back();
+      h.pop_back();
+      const value_type norm_squared = ww - squared_sum(h);
+      return (norm_squared > value_type(0) ? std::sqrt(norm_squared) : value_type(0));
+    }
+
+    /// The coefficients of <tt>(w - sum_i h_i v_i) / scale</tt>
+    static std::vector<value_type>
+    combination_coefficients(const std::vector<value_type>& h, const value_type scale) {
+      std::vector<value_type> c;
+      c.reserve(h.size() + 1ul);
+      for (const value_type hi : h)
+        c.push_back(-hi / scale);
+      c.push_back(value_type(1) / scale);
+      return c;
+    }
+
+    /// The terms of <tt>w - sum_i h_i v_i</tt>
+
+    /// \param V The basis
+    /// \param w The vector
+    /// \param n The number of basis vectors (default = all)
+    static std::vector<const D*> combination_terms(const std::vector<D>& V,
+        const D& w, std::size_t n = std::size_t(-1))
+    {
+      n = std::min(n, V.size());
+      std::vector<const D*> x;
+      x.reserve(n + 1ul);
+      for (std::size_t i = 0ul; i < n; ++i)
+        x.push_back(&V[i]);
+      x.push_back(&w);
+      return x;
+    }
+
+    static value_type squared_sum(const std::vector<value_type>& h) {
+      value_type result = 0;
+      for (const value_type hi : h)
+        result += hi * hi;
+      return result;
+    }
+  };
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_GMRES_H__INCLUDED
@@ -0,0 +1,215 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  matrix_functions.h
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_MATRIX_FUNCTIONS_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_MATRIX_FUNCTIONS_H__INCLUDED
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <TiledArray/conversions/truncate.h>
+#include <TiledArray/special/diagonal_array.h>
+#include "../dist_array.h"
+
+// Iterative matrix functions built on (sparse) contractions. Each iteration
+// is followed by a truncation of the iterates, so for SparsePolicy arrays
+// tiles whose norm falls below the shape threshold are dropped and the
+// sparsity of banded or local matrices is preserved; the cost then scales
+// linearly with the matrix size.
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Coupled Newton-Schulz iteration for the square root and inverse square root
+
+    /// With \f$ Y_0 = S/c \f$ and \f$ Z_0 = I \f$, the iteration
+    /// \f$ T_k = (3I - Z_k Y_k)/2 \f$, \f$ Y_{k+1} = Y_k T_k \f$,
+    /// \f$ Z_{k+1} = T_k Z_k \f$ converges quadratically to
+    /// \f$ Y = (S/c)^{1/2} \f$ and \f$ Z = (S/c)^{-1/2} \f$. The scaling
+    /// factor \f$ c = ||S||_F \f$ bounds the spectrum of \f$ S/c \f$ by 1.
+    /// \return The pair \f$ (S^{1/2}, S^{-1/2}) \f$
+    template <typename T, typename Policy>
+    inline std::pair<DistArray<Tensor<T>, Policy>, DistArray<Tensor<T>, Policy> >
+    newton_schulz_sqrt(const DistArray<Tensor<T>, Policy>& S, const T tol,
+        const unsigned int max_niter)
+    {
+      typedef DistArray<Tensor<T>, Policy> array_type;
+      TA_USER_ASSERT(S.trange().tiles_range().rank() == 2u,
+          "newton_schulz_sqrt: the argument must be a matrix");
+
+      const T c = S("i,j").norm().get();
+      const array_type I =
+          diagonal_array<T, Policy>(S.world(), S.trange(), T(1));
+
+      array_type Y, Z = I, E, TT;
+      Y("i,j") = (T(1) / c) * S("i,j");
+      for(unsigned int iter = 0u; iter < max_niter; ++iter) {
+        E("i,j") = I("i,j") - Z("i,k") * Y("k,j");
+        const T error = E("i,j").norm().get();
+        TT("i,j") = I("i,j") + T(0.5) * E("i,j");
+        Y("i,j") = Y("i,k") * TT("k,j");
+        Z("i,j") = TT("i,k") * Z("k,j");
+        truncate(Y);
+        truncate(Z);
+
+        if(error < tol) {
+          Y("i,j") = std::sqrt(c) * Y("i,j");
+          Z("i,j") = (T(1) / std::sqrt(c)) * Z("i,j");
+          return std::make_pair(Y, Z);
+        }
+      }
+
+      throw std::domain_error("newton_schulz_sqrt: max # of iterations exceeded");
+    }
+
+  }  // namespace detail
+
+  /// Matrix inverse square root
+
+  /// Computes \f$ S^{-1/2} \f$ of a symmetric positive definite matrix,
+  /// e.g. the overlap matrix of a Lowdin orthogonalization, with the coupled
+  /// Newton-Schulz iteration. Only contractions and additions are used, and
+  /// the iterates are truncated after each iteration, so the sparsity of
+  /// \c S is preserved as far as the decay of \f$ S^{-1/2} \f$ allows.
+  /// \param S A symmetric positive definite matrix
+  /// \param tol The convergence threshold of
+  ///   \f$ ||I - Z_k Y_k||_F \f$ (default = 1e-10)
+  /// \param max_niter The maximum number of iterations (default = 100)
+  /// \return \f$ S^{-1/2} \f$
+  /// \throw std::domain_error When the iteration does not converge
+  template <typename T, typename Policy>
+  inline DistArray<Tensor<T>, Policy>
+  matrix_inverse_sqrt(const DistArray<Tensor<T>, Policy>& S,
+      const T tol = 1.0e-10, const unsigned int max_niter = 100u)
+  {
+    return detail::newton_schulz_sqrt(S, tol, max_niter).second;
+  }
+
+  /// Matrix square root
+
+  /// Computes \f$ S^{1/2} \f$ of a symmetric positive definite matrix with
+  /// the coupled Newton-Schulz iteration; see \c matrix_inverse_sqrt() .
+  /// \param S A symmetric positive definite matrix
+  /// \param tol The convergence threshold (default = 1e-10)
+  /// \param max_niter The maximum number of iterations (default = 100)
+  /// \return \f$ S^{1/2} \f$
+  /// \throw std::domain_error When the iteration does not converge
+  template <typename T, typename Policy>
+  inline DistArray<Tensor<T>, Policy>
+  matrix_sqrt(const DistArray<Tensor<T>, Policy>& S,
+      const T tol = 1.0e-10, const unsigned int max_niter = 100u)
+  {
+    return detail::newton_schulz_sqrt(S, tol, max_niter).first;
+  }
+
+  /// Matrix inverse
+
+  /// Computes \f$ S^{-1} \f$ with the Newton-Schulz iteration
+  /// \f$ X_{k+1} = X_k (2I - S X_k) \f$, starting from
+  /// \f$ X_0 = S^T / ||S||_F^2 \f$, which converges for any nonsingular
+  /// \f$ S \f$. The iterates are truncated after each iteration.
+  /// \param S A nonsingular matrix
+  /// \param tol The convergence threshold of \f$ ||I - S X_k||_F \f$
+  ///   (default = 1e-10)
+  /// \param max_niter The maximum number of iterations (default = 100)
+  /// \return \f$ S^{-1} \f$
+  /// \throw std::domain_error When the iteration does not converge
+  template <typename T, typename Policy>
+  inline DistArray<Tensor<T>, Policy>
+  matrix_inverse(const DistArray<Tensor<T>, Policy>& S,
+      const T tol = 1.0e-10, const unsigned int max_niter = 100u)
+  {
+    typedef DistArray<Tensor<T>, Policy> array_type;
+    TA_USER_ASSERT(S.trange().tiles_range().rank() == 2u,
+        "matrix_inverse: the argument must be a matrix");
+    TA_USER_ASSERT(S.trange().dim(0) == S.trange().dim(1),
+        "matrix_inverse: the rows and columns must have the same tiling");
+
+    const T norm = S("i,j").norm().get();
+    const array_type I =
+        diagonal_array<T, Policy>(S.world(), S.trange(), T(1));
+
+    array_type X, R;
+    X("i,j") = (T(1) / (norm * norm)) * S("j,i");
+    for(unsigned int iter = 0u; iter < max_niter; ++iter) {
+      R("i,j") = I("i,j") - S("i,k") * X("k,j");
+      const T error = R("i,j").norm().get();
+      if(error < tol)
+        return X;
+
+      // X (2I - S X) = X + X R
+      X("i,j") = X("i,j") + X("i,k") * R("k,j");
+      truncate(X);
+    }
+
+    throw std::domain_error("matrix_inverse: max # of iterations exceeded");
+  }
+
+  /// Matrix exponential
+
+  /// Computes \f$ e^S \f$ by scaling and squaring: the Taylor series of
+  /// \f$ e^{S/2^s} \f$, where \f$ ||S/2^s||_F \leq 1/2 \f$, is summed until
+  /// the norm of a term is below \c tol , and the result is squared \c s
+  /// times. The terms and the squares are truncated, as in the
+  /// Newton-Schulz iterations.
+  /// \param S A square matrix
+  /// \param tol The truncation threshold of the Taylor series
+  ///   (default = 1e-12)
+  /// \return \f$ e^S \f$
+  template <typename T, typename Policy>
+  inline DistArray<Tensor<T>, Policy>
+  matrix_exp(const DistArray<Tensor<T>, Policy>& S, const T tol = 1.0e-12) {
+    typedef DistArray<Tensor<T>, Policy> array_type;
+    TA_USER_ASSERT(S.trange().tiles_range().rank() == 2u,
+        "matrix_exp: the argument must be a matrix");
+    TA_USER_ASSERT(S.trange().dim(0) == S.trange().dim(1),
+        "matrix_exp: the rows and columns must have the same tiling");
+
+    const T norm = S("i,j").norm().get();
+    unsigned int nsquare = 0u;
+    while(norm > T(0.5) * T(1ul << nsquare))
+      ++nsquare;
+
+    array_type A, E, term;
+    A("i,j") = (T(1) / T(1ul << nsquare)) * S("i,j");
+    E = diagonal_array<T, Policy>(S.world(), S.trange(), T(1));
+    E("i,j") = E("i,j") + A("i,j");
+    term = A;
+    for(unsigned int k = 2u; k < 100u; ++k) {
+      term("i,j") = (T(1) / T(k)) * term("i,k") * A("k,j");
+      truncate(term);
+      E("i,j") = E("i,j") + term("i,j");
+      if(term("i,j").norm().get() < tol)
+        break;
+    }
+    truncate(E);
+
+    for(unsigned int i = 0u; i < nsquare; ++i) {
+      E("i,j") = E("i,k") * E("k,j");
+      truncate(E);
+    }
+
+    return E;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_MATRIX_FUNCTIONS_H__INCLUDED
@@ -0,0 +1,288 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  randomized_svd.h
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_RANDOMIZED_SVD_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_RANDOMIZED_SVD_H__INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <Eigen/QR>
+#include <Eigen/SVD>
+#include <TiledArray/conversions/eigen.h>
+#include "../dist_array.h"
+
+namespace TiledArray {
+  namespace detail {
+
+    /// A column-major Eigen matrix, for the small replicated factorizations
+    template <typename T>
+    using svd_matrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+
+    /// Make a tall-skinny array
+
+    /// \param world The world of the array
+    /// \param rows The tiling of the rows
+    /// \param ncols The number of columns, which are a single tile
+    /// \param pmap The process map (default = the default process map)
+    /// \return An array with one column of tiles
+    template <typename T>
+    inline DistArray<Tensor<T>, DensePolicy>
+    make_tall_skinny(World& world, const TiledRange1& rows, const std::size_t ncols,
+        const std::shared_ptr<Pmap>& pmap = std::shared_ptr<Pmap>())
+    {
+      const std::array<TiledRange1, 2> dims = {{ rows, TiledRange1(0ul, ncols) }};
+      return DistArray<Tensor<T>, DensePolicy>(world,
+          TiledRange(dims.begin(), dims.end()), pmap);
+    }
+
+    /// Multiply a tall-skinny array by a small replicated matrix
+
+    /// Each tile is multiplied by the process that owns it; there is no
+    /// communication, and this function does not block.
+    /// \param Y A tall-skinny array, with one column of tiles
+    /// \param M A replicated matrix, with as many rows as \c Y has columns
+    /// \return <tt>Y * M</tt> , with the row tiling of \c Y
+    template <typename T>
+    inline DistArray<Tensor<T>, DensePolicy>
+    right_multiply(const DistArray<Tensor<T>, DensePolicy>& Y,
+        const svd_matrix<T>& M)
+    {
+      TA_ASSERT(Y.trange().tiles_range().extent(1) == 1ul);
+      TA_ASSERT(Y.trange().elements_range().extent(1) == std::size_t(M.rows()));
+      DistArray<Tensor<T>, DensePolicy> result =
+          make_tall_skinny<T>(Y.world(), Y.trange().dim(0), M.cols(), Y.pmap());
+
+      for(const auto ord : *result.pmap()) {
+        result.set(ord, Y.world().taskq.add([M] (const Range& range,
+            const Tensor<T>& y)
+        {
+          Tensor<T> tile(range);
+          eigen_map(tile) = eigen_map(y) * M;
+          return tile;
+        }, result.trange().make_tile_range(ord), Y.find(ord)));
+      }
+
+      return result;
+    }
+
+    /// Tall-skinny QR decomposition
+
+    /// Each row tile \f$ Y_i \f$ is factorized locally,
+    /// \f$ Y_i = Q_i R_i \f$ , the small triangular factors are stacked and
+    /// summed over all processes, and the stack is factorized on every
+    /// process, \f$ [R_1; R_2; \ldots] = Q' R \f$ . The orthonormal factor is
+    /// \f$ Q = \mathrm{diag}(Q_i) Q' \f$ . There is one reduction of
+    /// <tt>ntiles * ncols^2</tt> elements.
+    /// \param Y A tall-skinny array, with one column of tiles and at least as
+    /// many rows as columns
+    /// \return The orthonormal factor \c Q , with the tiling of \c Y , and the
+    /// replicated triangular factor \c R
+    template <typename T>
+    inline std::pair<DistArray<Tensor<T>, DensePolicy>, svd_matrix<T> >
+    tsqr(const DistArray<Tensor<T>, DensePolicy>& Y) {
+      typedef svd_matrix<T> matrix_type;
+      typedef std::pair<matrix_type, matrix_type> qr_type;
+      TA_ASSERT(Y.trange().tiles_range().extent(1) == 1ul);
+
+      World& world = Y.world();
+      const TiledRange1& rows = Y.trange().dim(0);
+      const std::size_t ncols = Y.trange().elements_range().extent(1);
+      TA_USER_ASSERT(rows.elements_range().second - rows.elements_range().first >= ncols,
+          "tsqr: the array must have at least as many rows as columns");
+
+      // The offsets of the triangular factors in the stack
+      std::vector<std::size_t> offsets(1ul, 0ul);
+      for(std::size_t i = rows.tiles_range().first; i < rows.tiles_range().second; ++i)
+        offsets.push_back(offsets.back() + std::min(rows.tile(i).second -
+            rows.tile(i).first, ncols));
+
+      // Factorize the local tiles
+      std::vector<std::pair<std::size_t, Future<qr_type> > > local_qr;
+      for(const auto ord : *Y.pmap()) {
+        local_qr.emplace_back(ord, world.taskq.add([] (const Tensor<T>& y) {
+          const matrix_type a = eigen_map(y);
+          const auto k = std::min(a.rows(), a.cols());
+          Eigen::HouseholderQR<matrix_type> qr(a);
+          qr_type result;
+          result.first = qr.householderQ() * matrix_type::Identity(a.rows(), k);
+          result.second = qr.matrixQR().topRows(k).
+              template triangularView<Eigen::Upper>();
+          return result;
+        }, Y.find(ord)));
+      }
+
+      matrix_type stack = matrix_type::Zero(offsets.back(), ncols);
+      for(const auto& qr : local_qr)
+        stack.middleRows(offsets[qr.first], qr.second.get().second.rows()) =
+            qr.second.get().second;
+      world.gop.sum(stack.data(), stack.size());
+
+      Eigen::HouseholderQR<matrix_type> qr(stack);
+      const matrix_type Q2 = qr.householderQ() *
+          matrix_type::Identity(stack.rows(), ncols);
+      const matrix_type R = qr.matrixQR().topRows(ncols).
+          template triangularView<Eigen::Upper>();
+
+      DistArray<Tensor<T>, DensePolicy> Q =
+          make_tall_skinny<T>(world, rows, ncols, Y.pmap());
+      for(const auto& local : local_qr) {
+        const std::size_t ord = local.first;
+        const matrix_type Q2_i = Q2.middleRows(offsets[ord],
+            offsets[ord + 1ul] - offsets[ord]);
+        Q.set(ord, world.taskq.add([Q2_i] (const Range& range, const qr_type& qr) {
+          Tensor<T> tile(range);
+          eigen_map(tile) = qr.first * Q2_i;
+          return tile;
+        }, Q.trange().make_tile_range(ord), local.second));
+      }
+
+      return std::make_pair(Q, R);
+    }
+
+    /// Make a Gaussian random sketch matrix
+
+    /// The elements of each tile are generated from \c seed and the first
+    /// row of the tile, so the sketch does not depend on the process map.
+    /// \param world The world of the array
+    /// \param rows The tiling of the rows
+    /// \param ncols The number of columns
+    /// \param seed The random seed
+    /// \return A random array with one column of tiles
+    template <typename T>
+    inline DistArray<Tensor<T>, DensePolicy>
+    random_sketch(World& world, const TiledRange1& rows, const std::size_t ncols,
+        const unsigned int seed)
+    {
+      DistArray<Tensor<T>, DensePolicy> omega =
+          make_tall_skinny<T>(world, rows, ncols);
+      omega.init_tiles([seed] (const Range& range) {
+        std::mt19937 generator(seed + 7919u * range.lobound_data()[0]);
+        std::normal_distribution<T> distribution;
+        Tensor<T> tile(range);
+        for(auto& value : tile)
+          value = distribution(generator);
+        return tile;
+      });
+      return omega;
+    }
+
+  }  // namespace detail
+
+  /// Randomized range finder
+
+  /// Computes an orthonormal basis \c Q of the approximate range of \c A ,
+  /// \f$ A \approx Q Q^T A \f$ , from a Gaussian random sketch
+  /// \f$ Y = A \Omega \f$ with \c rank columns. Each power iteration,
+  /// \f$ Y = A (A^T Q) \f$ , sharpens the decay of the singular values of the
+  /// sketch, and the sketches are orthonormalized with a tall-skinny QR
+  /// decomposition. \c A is read in <tt>2 + 2 * npower</tt> contractions.
+  /// \tparam T The element type, a real floating point type
+  /// \param A The matrix
+  /// \param rank The number of columns of the basis, not larger than the
+  /// dimensions of \c A
+  /// \param npower The number of power iterations (default = 1)
+  /// \param seed The seed of the random sketch (default = 42)
+  /// \return \c Q , with the row tiling of \c A and a single column tile
+  template <typename T>
+  inline DistArray<Tensor<T>, DensePolicy>
+  randomized_range_finder(const DistArray<Tensor<T>, DensePolicy>& A,
+      const std::size_t rank, const unsigned int npower = 1u,
+      const unsigned int seed = 42u)
+  {
+    typedef DistArray<Tensor<T>, DensePolicy> array_type;
+    TA_USER_ASSERT(A.trange().tiles_range().rank() == 2u,
+        "randomized_range_finder: the argument must be a matrix");
+
+    const array_type omega = detail::random_sketch<T>(A.world(), A.trange().dim(1),
+        rank, seed);
+    array_type Y, Z;
+    Y("i,k") = A("i,j") * omega("j,k");
+    array_type Q = detail::tsqr(Y).first;
+    for(unsigned int p = 0u; p < npower; ++p) {
+      Z("j,k") = A("i,j") * Q("i,k");
+      const array_type Qz = detail::tsqr(Z).first;
+      Y("i,k") = A("i,j") * Qz("j,k");
+      Q = detail::tsqr(Y).first;
+    }
+
+    return Q;
+  }
+
+  /// Randomized singular value decomposition
+
+  /// Computes the rank-\c k approximation \f$ A \approx U \Sigma V^T \f$ .
+  /// The range of \c A is found with \c randomized_range_finder() , with
+  /// \c oversampling extra columns, and the projection
+  /// \f$ B^T = A^T Q = Q_b R_b \f$ is factorized with a tall-skinny QR
+  /// decomposition. The SVD of the small triangular factor,
+  /// \f$ R_b^T = U' \Sigma V'^T \f$ , is computed on every process, and
+  /// \f$ U = Q U' \f$ , \f$ V = Q_b V' \f$ . The cost is a few passes over
+  /// \c A and reductions of small matrices, instead of a full factorization.
+  /// \tparam T The element type, a real floating point type
+  /// \param A The matrix
+  /// \param k The rank of the approximation
+  /// \param oversampling The number of extra sketch columns (default = 10)
+  /// \param npower The number of power iterations (default = 1)
+  /// \param seed The seed of the random sketch (default = 42)
+  /// \return The tuple \f$ (U, \Sigma, V) \f$ , where \c U and \c V have the
+  /// row and column tiling of \c A , respectively, and a single column tile
+  /// of \c k columns, and \f$ \Sigma \f$ holds the \c k largest singular
+  /// values, in descending order
+  template <typename T>
+  inline std::tuple<DistArray<Tensor<T>, DensePolicy>, std::vector<T>,
+      DistArray<Tensor<T>, DensePolicy> >
+  randomized_svd(const DistArray<Tensor<T>, DensePolicy>& A, const std::size_t k,
+      const std::size_t oversampling = 10ul, const unsigned int npower = 1u,
+      const unsigned int seed = 42u)
+  {
+    typedef DistArray<Tensor<T>, DensePolicy> array_type;
+    typedef detail::svd_matrix<T> matrix_type;
+    TA_USER_ASSERT(A.trange().tiles_range().rank() == 2u,
+        "randomized_svd: the argument must be a matrix");
+    const std::size_t m = A.trange().elements_range().extent(0);
+    const std::size_t n = A.trange().elements_range().extent(1);
+    TA_USER_ASSERT(k <= std::min(m, n),
+        "randomized_svd: the rank is larger than the matrix");
+    const std::size_t l = std::min(k + oversampling, std::min(m, n));
+
+    const array_type Q = randomized_range_finder(A, l, npower, seed);
+    array_type Bt;
+    Bt("j,k") = A("i,j") * Q("i,k");
+    const auto qr_b = detail::tsqr(Bt);
+
+    Eigen::JacobiSVD<matrix_type> svd(qr_b.second.transpose(),
+        Eigen::ComputeFullU | Eigen::ComputeFullV);
+    std::vector<T> sigma(svd.singularValues().data(),
+        svd.singularValues().data() + k);
+
+    return std::make_tuple(
+        detail::right_multiply(Q, matrix_type(svd.matrixU().leftCols(k))), sigma,
+        detail::right_multiply(qr_b.first, matrix_type(svd.matrixV().leftCols(k))));
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_RANDOMIZED_SVD_H__INCLUDED
@@ -0,0 +1,153 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  threshold_schedule.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_THRESHOLD_SCHEDULE_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_THRESHOLD_SCHEDULE_H__INCLUDED
+
+#include <TiledArray/algebra/diis.h>
+#include <TiledArray/sparse_shape.h>
+#include <algorithm>
+
+namespace TiledArray {
+
+  /// Sparsity threshold schedule of an iterative solver
+
+  /// The early iterations of an iterative solver, e.g. of the coupled-cluster
+  /// or SCF equations, do not need tight screening, since their error is
+  /// dominated by the residual. This object ties the zero threshold of the
+  /// sparse arrays of the solver to the norm of the residual:
+  /// \f[
+  ///   \tau_i = \min(\tau_{i-1}, \max(\tau_{\rm tight},
+  ///       \min(\tau_{\rm loose}, r \| e_i \|)))
+  /// \f]
+  /// where \f$ \| e_i \| \f$ is the norm of the residual of iteration
+  /// \f$ i \f$ , e.g. as measured by \c DIIS , and \f$ r \f$ is the ratio of
+  /// the threshold and the residual norm. The threshold never loosens, so
+  /// the final iterations are screened with \f$ \tau_{\rm tight} \f$ , which
+  /// controls the accuracy of the converged result.
+  ///
+  /// Arrays carry the threshold in their shape: \c truncate() truncates an
+  /// array with the current threshold, which becomes the zero threshold of
+  /// its shape, so the results of expressions that use the array are
+  /// screened with it (binary operations use the tighter threshold of their
+  /// arguments). \c apply() also sets the default threshold of new shapes.
+  /// \code
+  /// TA::DIIS<TA::TSpArrayD> diis;
+  /// TA::ThresholdSchedule<> schedule(1e-10, 1e-6);
+  /// for(...) {
+  ///   r("i,j") = ...; // residual of t
+  ///   diis.extrapolate(t, r);
+  ///   schedule.update(diis);
+  ///   schedule.truncate(t);
+  /// }
+  /// \endcode
+  /// \tparam T The threshold type
+  template <typename T = float>
+  class ThresholdSchedule {
+  public:
+    typedef T value_type; ///< The threshold type
+
+  private:
+    value_type tight_; ///< The threshold of the converged iterations
+    value_type loose_; ///< The threshold of the first iterations
+    value_type ratio_; ///< The ratio of the threshold and the residual norm
+    value_type threshold_; ///< The current threshold
+
+  public:
+
+    /// Constructor
+
+    /// \param tight The threshold of the converged iterations
+    /// \param loose The threshold of the first iterations
+    /// \param ratio The ratio of the threshold and the residual norm
+    /// [ default = 0.01 ]
+    ThresholdSchedule(const value_type tight, const value_type loose,
+        const value_type ratio = value_type(0.01)) :
+      tight_(tight), loose_(loose), ratio_(ratio), threshold_(loose)
+    {
+      TA_USER_ASSERT(tight <= loose, "ThresholdSchedule::ThresholdSchedule() "
+          "-- The tight threshold must not be greater than the loose threshold.");
+      TA_USER_ASSERT(ratio > value_type(0), "ThresholdSchedule::ThresholdSchedule() "
+          "-- The ratio must be positive.");
+    }
+
+    /// The current threshold
+
+    /// \return The zero threshold of the current iteration
+    value_type threshold() const { return threshold_; }
+
+    /// The threshold of the converged iterations
+
+    /// \return The tightest threshold of this schedule
+    value_type tight() const { return tight_; }
+
+    /// Check that the schedule has reached the tight threshold
+
+    /// A solver should not be considered converged before the arrays are
+    /// screened with the tight threshold.
+    /// \return \c true when the current threshold is the tight threshold
+    bool is_tight() const { return threshold_ <= tight_; }
+
+    /// Update the threshold with a residual norm
+
+    /// \tparam S The residual norm type
+    /// \param residual_norm The norm of the residual of the current iteration
+    /// \return The updated threshold
+    template <typename S>
+    value_type update(const S residual_norm) {
+      const value_type target = std::max(tight_,
+          std::min(loose_, value_type(ratio_ * residual_norm)));
+      threshold_ = std::min(threshold_, target);
+      return threshold_;
+    }
+
+    /// Update the threshold with the residual norm measured by DIIS
+
+    /// \tparam D The DIIS data type
+    /// \param diis The DIIS object of the solver, which has been given the
+    /// residual of the current iteration
+    /// \return The updated threshold
+    template <typename D>
+    value_type update(const DIIS<D>& diis) { return update(diis.error_norm()); }
+
+    /// Set the default threshold of new sparse shapes to the current threshold
+    void apply() const { SparseShape<value_type>::threshold(threshold_); }
+
+    /// Truncate an array with the current threshold
+
+    /// The current threshold becomes the zero threshold of the array shape.
+    /// Tiles that were dropped with a looser threshold are not restored,
+    /// they are recomputed by the next iteration of the solver. Dense arrays
+    /// are not modified.
+    /// \tparam Tile The tile type of the array
+    /// \tparam Policy The policy type of the array
+    /// \param array The array to be truncated
+    template <typename Tile, typename Policy>
+    void truncate(DistArray<Tile, Policy>& array) const {
+      array.truncate(threshold_);
+    }
+
+  }; // class ThresholdSchedule
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_THRESHOLD_SCHEDULE_H__INCLUDED
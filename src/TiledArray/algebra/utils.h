@@ -27,6 +27,7 @@
 #define TILEDARRAY_ALGEBRA_UTILS_H__INCLUDED
 
 #include <sstream>
+#include <vector>
 
 #include "../dist_array.h"
 #include "../expressions/expr.h"
@@ -43,6 +44,86 @@ namespace TiledArray {
       return oss.str();
     }
 
+    /// Reduction of the local dot product vectors
+
+    /// \tparam T The dot product type
+    template <typename T>
+    struct DotProductsReduceOp {
+      typedef std::vector<T> result_type; ///< The dot products type
+      typedef std::vector<T> argument_type; ///< The partial dot products type
+
+      result_type operator()() const { return result_type(); }
+      result_type operator()(const result_type& temp) const { return temp; }
+      void operator()(result_type& result, const argument_type& arg) const {
+        if(arg.empty())
+          return;
+        if(result.empty()) {
+          result = arg;
+        } else {
+          TA_ASSERT(result.size() == arg.size());
+          for(std::size_t i = 0ul; i < result.size(); ++i)
+            result[i] += arg[i];
+        }
+      }
+    }; // struct DotProductsReduceOp
+
+    /// Key tag of the \c dot_products all-reduce
+    struct DotProductsTag { };
+
+    /// Dot products of a tile with a set of tiles
+
+    /// \param a The tile
+    /// \param x The tiles, where zero tiles are empty
+    /// \return The dot products of \c a with each tile in \c x
+    template <typename T, typename Tile>
+    inline std::vector<T> dot_tiles(const Tile& a,
+        const std::vector<Future<Tile> >& x)
+    {
+      std::vector<T> result(x.size(), T(0));
+      for(std::size_t i = 0ul; i < x.size(); ++i)
+        if(! x[i].get().empty())
+          result[i] = dot(a, x[i].get());
+      return result;
+    }
+
+    /// Sum the dot products of the local tiles
+
+    /// \param n The number of dot products
+    /// \param tiles The dot products of each local tile
+    /// \return The local dot products
+    template <typename T>
+    inline std::vector<T> sum_dot_tiles(const std::size_t n,
+        const std::vector<Future<std::vector<T> > >& tiles)
+    {
+      std::vector<T> result(n, T(0));
+      for(const Future<std::vector<T> >& tile : tiles)
+        for(std::size_t i = 0ul; i < n; ++i)
+          result[i] += tile.get()[i];
+      return result;
+    }
+
+    /// Linear combination of a set of tiles
+
+    /// \param c The coefficients
+    /// \param x The tiles, where zero tiles are empty
+    /// \return The sum of \c c[k]*x[k]
+    template <typename Tile, typename Scalar>
+    inline Tile combine_tiles(const std::vector<Scalar>& c,
+        const std::vector<Future<Tile> >& x)
+    {
+      Tile result;
+      for(std::size_t k = 0ul; k < x.size(); ++k) {
+        const Tile& tile = x[k].get();
+        if(tile.empty())
+          continue;
+        if(result.empty())
+          result = scale(tile, c[k]);
+        else
+          add_to(result, scale(tile, c[k]));
+      }
+      return result;
+    }
+
   } // namespace detail
 
   template <typename Tile, typename Policy>
@@ -91,6 +172,64 @@ namespace TiledArray {
     return a1(vars).dot(a2(vars)).get();
   }
 
+  /// Dot products of a vector with a set of vectors
+
+  /// Fallback for vector types other than \c DistArray , which computes each
+  /// dot product with \c dot_product() .
+  /// \param a The vector
+  /// \param x Pointers to the vectors
+  /// \return The dot products of \c a with each vector in \c x
+  template <typename D>
+  inline auto dot_products(const D& a, const std::vector<const D*>& x) ->
+      std::vector<decltype(dot_product(a, a))>
+  {
+    std::vector<decltype(dot_product(a, a))> result;
+    result.reserve(x.size());
+    for(const D* xi : x)
+      result.push_back(dot_product(a, *xi));
+    return result;
+  }
+
+  /// Dot products of an array with a set of arrays
+
+  /// All dot products are computed in a single traversal of the local tiles
+  /// of \c a , i.e. each tile of \c a is read once, and are combined with
+  /// one all-reduce, instead of one per dot product. The arrays must have
+  /// the same tiled range as \c a . This function is collective and blocks
+  /// until the result is available.
+  /// \param a The array
+  /// \param x Pointers to the arrays
+  /// \return The dot products of \c a with each array in \c x
+  template <typename Tile, typename Policy>
+  inline std::vector<typename DistArray<Tile,Policy>::element_type>
+  dot_products(const DistArray<Tile,Policy>& a,
+      const std::vector<const DistArray<Tile,Policy>*>& x)
+  {
+    typedef typename DistArray<Tile,Policy>::element_type element_type;
+    typedef typename DistArray<Tile,Policy>::value_type value_type;
+    World& world = a.world();
+
+    std::vector<Future<std::vector<element_type> > > tiles;
+    for(const auto index : *a.pmap()) {
+      if(a.is_zero(index))
+        continue;
+      std::vector<Future<value_type> > x_tiles;
+      x_tiles.reserve(x.size());
+      for(const DistArray<Tile,Policy>* xi : x) {
+        TA_ASSERT(xi->trange() == a.trange());
+        x_tiles.push_back(xi->is_zero(index) ? Future<value_type>(value_type())
+                                             : xi->find(index));
+      }
+      tiles.push_back(world.taskq.add(& detail::dot_tiles<element_type, value_type>,
+          a.find(index), x_tiles));
+    }
+
+    typedef madness::TaggedKey<madness::uniqueidT, detail::DotProductsTag> key_type;
+    return world.gop.all_reduce(key_type(world.unique_obj_id()),
+        world.taskq.add(& detail::sum_dot_tiles<element_type>, x.size(), tiles),
+        detail::DotProductsReduceOp<element_type>()).get();
+  }
+
   template <typename Left, typename Right>
   inline typename TiledArray::expressions::ExprTrait<Left>::scalar_type
   dot(const TiledArray::expressions::Expr<Left>& a1,
@@ -119,6 +258,71 @@ namespace TiledArray {
     y(vars) = y(vars) + a * x(vars);
   }
 
+  /// Linear combination of a set of vectors
+
+  /// Fallback for vector types other than \c DistArray , which is computed
+  /// with \c zero() and a series of \c axpy() .
+  /// \param[out] y The result, <tt>sum_k c[k] * x[k]</tt>
+  /// \param c The coefficients
+  /// \param x Pointers to the vectors, at least one, which may include \c y
+  template <typename D>
+  inline void linear_combination(D& y,
+      const std::vector<typename D::element_type>& c,
+      const std::vector<const D*>& x)
+  {
+    TA_ASSERT(! x.empty());
+    TA_ASSERT(c.size() == x.size());
+    D result = *x.front();
+    zero(result);
+    for(std::size_t k = 0ul; k < x.size(); ++k)
+      axpy(result, c[k], *x[k]);
+    y = result;
+  }
+
+  /// Linear combination of a set of arrays
+
+  /// The result is formed in a single pass over the tiles, where each tile
+  /// of the result is the sum of the tiles of the arrays, instead of one
+  /// pass (and one result array) per term. The arrays must have the same
+  /// tiled range, and the result has the process map of the first array.
+  /// \param[out] y The result, <tt>sum_k c[k] * x[k]</tt>
+  /// \param c The coefficients
+  /// \param x Pointers to the arrays, which may include \c y
+  template <typename Tile, typename Policy>
+  inline void linear_combination(DistArray<Tile,Policy>& y,
+      const std::vector<typename DistArray<Tile,Policy>::element_type>& c,
+      const std::vector<const DistArray<Tile,Policy>*>& x)
+  {
+    typedef typename DistArray<Tile,Policy>::value_type value_type;
+    typedef typename DistArray<Tile,Policy>::shape_type shape_type;
+    TA_ASSERT(! x.empty());
+    TA_ASSERT(c.size() == x.size());
+
+    const DistArray<Tile,Policy>& first = *x.front();
+    shape_type shape = first.shape().scale(c.front());
+    for(std::size_t k = 1ul; k < x.size(); ++k) {
+      TA_ASSERT(x[k]->trange() == first.trange());
+      shape = shape.add(x[k]->shape().scale(c[k]));
+    }
+
+    DistArray<Tile,Policy> result(first.world(), first.trange(), shape,
+        first.pmap());
+    for(const auto index : *result.pmap()) {
+      if(result.is_zero(index))
+        continue;
+      std::vector<Future<value_type> > x_tiles;
+      x_tiles.reserve(x.size());
+      for(const DistArray<Tile,Policy>* xk : x)
+        x_tiles.push_back(xk->is_zero(index) ? Future<value_type>(value_type())
+                                             : xk->find(index));
+      result.set(index, result.world().taskq.add(
+          & detail::combine_tiles<value_type,
+              typename DistArray<Tile,Policy>::element_type>, c, x_tiles));
+    }
+
+    y = result;
+  }
+
   template <typename Tile, typename Policy>
   inline void assign(DistArray<Tile,Policy>& m1,
                      const DistArray<Tile,Policy>& m2) {
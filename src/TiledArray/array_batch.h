@@ -0,0 +1,215 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  array_batch.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_ARRAY_BATCH_H__INCLUDED
+#define TILEDARRAY_ARRAY_BATCH_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/expressions/expr_batch.h>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+
+  /// A family of arrays with the same tiling and distribution
+
+  /// The members of a batch, e.g. the per-pair amplitudes of a local
+  /// correlation method, share one tiled range and one process map, so the
+  /// tiling metadata and the tile ownership are computed once for the whole
+  /// family instead of once per array. Expressions that assign the members
+  /// are evaluated together (see \c assign_async() ), with one set of tasks
+  /// issued for all members and a single wait, instead of one synchronous
+  /// assignment per member.
+  /// \tparam Tile The tile type of the members
+  /// \tparam Policy The policy of the members
+  template <typename Tile, typename Policy>
+  class ArrayBatch {
+  public:
+    typedef ArrayBatch<Tile, Policy> ArrayBatch_; ///< This object type
+    typedef DistArray<Tile, Policy> array_type; ///< The member array type
+    typedef typename array_type::size_type size_type; ///< Size type
+    typedef typename array_type::trange_type trange_type; ///< Tiled range type
+    typedef typename array_type::shape_type shape_type; ///< Shape type
+    typedef typename array_type::pmap_interface pmap_interface; ///< Process map interface type
+    typedef typename std::vector<array_type>::iterator iterator; ///< Member iterator
+    typedef typename std::vector<array_type>::const_iterator const_iterator; ///< Member const iterator
+
+  private:
+
+    World* world_; ///< The world of the members
+    trange_type trange_; ///< The tiled range of the members
+    std::shared_ptr<pmap_interface> pmap_; ///< The process map of the members
+    std::vector<array_type> arrays_; ///< The members
+
+    /// Initialize the shared process map
+
+    /// \param pmap The process map of the members, or an empty pointer for
+    /// the policy default
+    void init_pmap(const std::shared_ptr<pmap_interface>& pmap) {
+      pmap_ = (pmap ? pmap :
+          Policy::default_pmap(*world_, trange_.tiles_range().volume()));
+      TA_USER_ASSERT(pmap_->size() == trange_.tiles_range().volume(),
+          "ArrayBatch::ArrayBatch() -- The size of the process map is not "
+          "equal to the number of tiles in the TiledRange object.");
+    }
+
+  public:
+
+    /// Default constructor
+
+    /// Constructs an empty batch
+    ArrayBatch() : world_(nullptr), trange_(), pmap_(), arrays_() { }
+
+    /// Dense batch constructor
+
+    /// \param world The world where the members live
+    /// \param trange The tiled range of the members
+    /// \param n The number of members
+    /// \param pmap The tile index -> process map of the members [ default =
+    /// the policy default ]
+    ArrayBatch(World& world, const trange_type& trange, const size_type n,
+        const std::shared_ptr<pmap_interface>& pmap = std::shared_ptr<pmap_interface>()) :
+      world_(&world), trange_(trange), pmap_(), arrays_()
+    {
+      init_pmap(pmap);
+      arrays_.reserve(n);
+      for(size_type i = 0ul; i < n; ++i)
+        arrays_.emplace_back(world, trange_, pmap_);
+    }
+
+    /// Sparse batch constructor
+
+    /// \param world The world where the members live
+    /// \param trange The tiled range of the members
+    /// \param shapes The shape of each member
+    /// \param pmap The tile index -> process map of the members [ default =
+    /// the policy default ]
+    ArrayBatch(World& world, const trange_type& trange,
+        const std::vector<shape_type>& shapes,
+        const std::shared_ptr<pmap_interface>& pmap = std::shared_ptr<pmap_interface>()) :
+      world_(&world), trange_(trange), pmap_(), arrays_()
+    {
+      init_pmap(pmap);
+      arrays_.reserve(shapes.size());
+      for(const shape_type& shape : shapes)
+        arrays_.emplace_back(world, trange_, shape, pmap_);
+    }
+
+    ArrayBatch(const ArrayBatch_&) = default;
+    ArrayBatch(ArrayBatch_&&) = default;
+    ArrayBatch_& operator=(const ArrayBatch_&) = default;
+    ArrayBatch_& operator=(ArrayBatch_&&) = default;
+
+    /// World accessor
+
+    /// \return A reference to the world of the members
+    World& world() const {
+      TA_ASSERT(world_);
+      return *world_;
+    }
+
+    /// Tiled range accessor
+
+    /// \return The tiled range shared by the members
+    const trange_type& trange() const { return trange_; }
+
+    /// Process map accessor
+
+    /// \return The process map shared by the members
+    const std::shared_ptr<pmap_interface>& pmap() const { return pmap_; }
+
+    /// The number of members
+
+    /// \return The number of arrays in this batch
+    size_type size() const { return arrays_.size(); }
+
+    /// Member accessor
+
+    /// \param i The index of the member
+    /// \return A reference to member \c i
+    array_type& operator[](const size_type i) {
+      TA_ASSERT(i < arrays_.size());
+      return arrays_[i];
+    }
+
+    /// Member accessor
+
+    /// \param i The index of the member
+    /// \return A const reference to member \c i
+    const array_type& operator[](const size_type i) const {
+      TA_ASSERT(i < arrays_.size());
+      return arrays_[i];
+    }
+
+    /// \return An iterator to the first member
+    iterator begin() { return arrays_.begin(); }
+
+    /// \return A const iterator to the first member
+    const_iterator begin() const { return arrays_.begin(); }
+
+    /// \return An iterator past the last member
+    iterator end() { return arrays_.end(); }
+
+    /// \return A const iterator past the last member
+    const_iterator end() const { return arrays_.end(); }
+
+    /// Assign an expression to every member without waiting
+
+    /// For each member \c i , <tt>(*this)[i](vars) = op(i)</tt> is added to
+    /// one \c expressions::ExprBatch , so the statements of all members are
+    /// issued together and their tasks run concurrently. The members keep
+    /// the shared process map when the expression does not choose its own
+    /// distribution. Statements that read other members of this batch are
+    /// ordered after the statements that write those members.
+    /// \tparam Op The expression generator type
+    /// \param vars The variable list of the members
+    /// \param op The expression generator, where <tt>op(i)</tt> returns the
+    /// expression that is assigned to member \c i
+    /// \return The completion handles of the assignments, in member order
+    template <typename Op>
+    std::vector<expressions::EvalHandle>
+    assign_async(const std::string& vars, const Op& op) {
+      expressions::ExprBatch batch;
+      for(size_type i = 0ul; i < arrays_.size(); ++i)
+        batch.add(arrays_[i](vars), op(i));
+      return batch.eval_async();
+    }
+
+    /// Assign an expression to every member
+
+    /// Equivalent to \c assign_async() followed by a wait for the local
+    /// tiles of all members.
+    /// \tparam Op The expression generator type
+    /// \param vars The variable list of the members
+    /// \param op The expression generator, where <tt>op(i)</tt> returns the
+    /// expression that is assigned to member \c i
+    template <typename Op>
+    void assign(const std::string& vars, const Op& op) {
+      for(expressions::EvalHandle& handle : assign_async(vars, op))
+        handle.wait();
+    }
+
+  }; // class ArrayBatch
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ARRAY_BATCH_H__INCLUDED
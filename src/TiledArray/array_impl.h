@@ -28,8 +28,21 @@
 
 #include <TiledArray/tensor_impl.h>
 #include <TiledArray/distributed_storage.h>
+#include <TiledArray/remote_tile_cache.h>
+#include <TiledArray/eval_tile_cache.h>
+#include <TiledArray/layout_cache.h>
+#include <TiledArray/tensor/compression.h>
+#include <TiledArray/tensor/memory_tracker.h>
+#include <TiledArray/symm/tile_symmetry.h>
+#include <TiledArray/tile_interface/permute.h>
 #include <TiledArray/transform_iterator.h>
 #include <TiledArray/type_traits.h>
+#include <tiledarray_fwd.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
@@ -410,6 +423,53 @@ namespace TiledArray {
 
     }; // class TensorIterator
 
+    /// Tag of the all-reduce keys of array completion
+    struct ArrayCompletionTag { };
+
+    /// Completion of a set of tiles
+
+    /// The tiles are counted as they are added, and the count is decremented
+    /// as they are assigned. The future returned by \c done() is set when
+    /// the tiles that were added before \c start() are all assigned, and
+    /// the object deletes itself.
+    class TileCompletion : public madness::CallbackInterface {
+      std::atomic<std::size_t> pending_; ///< The tiles that are not assigned, plus one until start()
+      Future<bool> done_; ///< Set when all tiles are assigned
+
+    public:
+      TileCompletion() : pending_(1ul), done_() { }
+
+      virtual ~TileCompletion() { }
+
+      /// \return A future that is set when all tiles are assigned
+      const Future<bool>& done() const { return done_; }
+
+      /// Add a tile
+
+      /// \tparam T The tile type
+      /// \param tile The future of the tile
+      template <typename T>
+      void add(Future<T>& tile) {
+        if(tile.probe())
+          return;
+        ++pending_;
+        tile.register_callback(this);
+      }
+
+      /// Stop adding tiles
+      void start() { notify(); }
+
+      /// Tile assignment notification
+      virtual void notify() {
+        if(--pending_ == 0ul) {
+          Future<bool> done = done_;
+          delete this;
+          done.set(true);
+        }
+      }
+
+    }; // class TileCompletion
+
     /// Tensor implementation and base for other tensor implementation objects
 
     /// This implementation object holds the data for tensor object, which
@@ -436,6 +496,9 @@ namespace TiledArray {
           numeric_type; ///< the numeric type that supports Tile
       typedef DistributedStorage<value_type> storage_type; ///< The data container type
       typedef typename storage_type::future future; ///< Future tile type
+      typedef RemoteTileCache<future> cache_type; ///< Remote tile cache type
+      typedef EvalTileCache<value_type> eval_cache_type; ///< Evaluated lazy tile cache type
+      typedef LayoutCache<ArrayImpl_> layout_cache_type; ///< Permuted layout cache type
       typedef TileReference<ArrayImpl_> reference; ///< Tile reference type
       typedef TileConstReference<ArrayImpl_> const_reference; ///< Tile constant reference type
       typedef ArrayIterator<ArrayImpl_, reference> iterator; ///< Iterator type
@@ -444,6 +507,109 @@ namespace TiledArray {
     private:
 
       storage_type data_; ///< Tile container
+      mutable cache_type cache_; ///< Read cache of remote tiles
+      std::shared_ptr<eval_cache_type> eval_cache_; ///< Cache of evaluated lazy tiles
+      mutable layout_cache_type layouts_; ///< Cache of permuted copies of this tensor
+      bool diagonal_; ///< Only the diagonal elements are non-zero
+      mutable std::size_t completions_ = 0ul; ///< The number of collective completion tests
+      std::shared_ptr<const symmetry::TileSymmetry> symmetry_; ///< Permutational symmetry of the tiles
+      std::uint64_t version_ = 0ul; ///< The number of modifications of the tiles
+      std::vector<std::uint64_t> tile_versions_; ///< The version of the last modification of each tile (empty if none)
+
+      /// Record a modification of a set of tiles
+
+      /// The version of this tensor is incremented and becomes the version
+      /// of the modified tiles. The same tiles must be recorded, in the same
+      /// order of modifications, on all processes.
+      /// \param tiles The ordinal indices of the modified tiles
+      void touch(const std::vector<size_type>& tiles) {
+        ++version_;
+        if(tile_versions_.empty())
+          tile_versions_.resize(TensorImpl_::size(), 0ul);
+        for(const size_type index : tiles)
+          tile_versions_[index] = version_;
+      }
+
+      /// Record a modification of all tiles
+      void touch() {
+        ++version_;
+        tile_versions_.assign(TensorImpl_::size(), version_);
+      }
+
+      /// Get a remote tile without a copy
+
+      /// \param index The ordinal index of the remote tile
+      /// \param bytes The size of the tile data
+      /// \return A \c future to the tile
+      template <typename T = value_type,
+          typename std::enable_if<has_tile_buffer<T>::value>::type* = nullptr>
+      future get_remote(const size_type index, const size_type bytes) const {
+        if(ZeroCopy::enabled(bytes) && ! TensorCompression::compress(bytes))
+          return data_.get(index,
+              value_type(TensorImpl_::trange().make_tile_range(index)));
+        return data_.get(index);
+      }
+
+      /// Get a remote tile
+
+      /// \param index The ordinal index of the remote tile
+      /// \return A \c future to the tile
+      template <typename T = value_type,
+          typename std::enable_if<! has_tile_buffer<T>::value>::type* = nullptr>
+      future get_remote(const size_type index, const size_type) const {
+        return data_.get(index);
+      }
+
+      /// Size of the data of a tile
+
+      /// \param tile The tile
+      /// \return The number of bytes of the data of \c tile
+      template <typename T = value_type,
+          typename std::enable_if<has_member_function_size_anyreturn<T>::value>::type* = nullptr>
+      static size_type tile_bytes(const T& tile) {
+        return tile.size() * sizeof(numeric_type);
+      }
+
+      /// Size of the data of a tile that has no size (e.g. a lazy tile)
+
+      /// \return Zero
+      template <typename T = value_type,
+          typename std::enable_if<! has_member_function_size_anyreturn<T>::value>::type* = nullptr>
+      static size_type tile_bytes(const T&) { return 0ul; }
+
+      /// Check for a tile that is stored
+
+      /// \param index The ordinal index of a tile
+      /// \return \c true if tile \c index is non-zero and, when the tiles
+      /// are symmetric, the representative of its orbit
+      bool is_stored(const size_type index) const {
+        return ! TensorImpl_::is_zero(index) &&
+            (! symmetry_ || symmetry_->is_representative(index));
+      }
+
+      /// Materialize a tile from the representative of its orbit
+
+      /// \param tile The representative tile
+      /// \param perm The permutation that maps \c tile to the result
+      /// \return A \c future to the permuted tile
+      template <typename T = value_type,
+          typename std::enable_if<detail::has_member_function_permute_anyreturn<
+              const T, const Permutation&>::value>::type* = nullptr>
+      future permute_tile(const future& tile, const Permutation& perm) const {
+        return TensorImpl_::world().taskq.add(
+            tile_interface::Permute<value_type, value_type>(), tile, perm);
+      }
+
+      /// Materialize a tile of a type that cannot be permuted
+
+      /// \throw TiledArray::Exception Always
+      template <typename T = value_type,
+          typename std::enable_if<! detail::has_member_function_permute_anyreturn<
+              const T, const Permutation&>::value>::type* = nullptr>
+      future permute_tile(const future&, const Permutation&) const {
+        TA_EXCEPTION("The tiles of a symmetric array must support permute().");
+        return future();
+      }
 
     public:
 
@@ -456,25 +622,130 @@ namespace TiledArray {
       /// \param pmap The tile-process map
       /// \throw TiledArray::Exception When the size of shape is not equal to
       /// zero
+      /// \note The local tiles of a dense tensor are stored in dense slots
+      /// (see \c DistributedStorage ), since all of them will be set.
       ArrayImpl(World& world, const trange_type& trange, const shape_type& shape,
           const std::shared_ptr<pmap_interface>& pmap) :
         TensorImpl_(world, trange, shape, pmap),
-        data_(world, trange.tiles_range().volume(), pmap)
+        data_(world, trange.tiles_range().volume(), pmap, shape.is_dense()),
+        eval_cache_(std::make_shared<eval_cache_type>()), diagonal_(false)
       { }
 
       /// Virtual destructor
       virtual ~ArrayImpl() { }
 
+      /// Release this object
+
+      /// \c op is called as soon as no local task or message handler
+      /// references the tiles of this object (see
+      /// \c DistributedStorage::release() ).
+      /// \param op The release operation, e.g. deletes this object
+      void release(std::function<void()> op) { data_.release(std::move(op)); }
+
+      /// In-flight operations
+
+      /// \return The number of local operations that reference the tiles of
+      /// this object
+      std::size_t in_flight() const { return data_.in_flight(); }
+
+      /// Diagonal attribute accessor
+
+      /// \return \c true if only the diagonal elements of the tensor are
+      /// non-zero
+      bool is_diagonal() const { return diagonal_; }
+
+      /// Set the diagonal attribute
+
+      /// \param diagonal \c true if only the diagonal elements of the tensor
+      /// are non-zero
+      void set_diagonal(const bool diagonal) { diagonal_ = diagonal; }
+
+      /// Tile symmetry accessor
+
+      /// \return The permutational symmetry of the tiles, or a null pointer
+      /// when every non-zero tile is stored
+      const std::shared_ptr<const symmetry::TileSymmetry>& tile_symmetry() const {
+        return symmetry_;
+      }
+
+      /// Set the tile symmetry
+
+      /// Local tiles that are not the representatives of their orbits are
+      /// removed; they are computed from their representatives when accessed.
+      /// \param symmetry The permutational symmetry of the tiles, or a null
+      /// pointer to store every non-zero tile
+      /// \note No task that uses this tensor may be running.
+      void set_tile_symmetry(const std::shared_ptr<const symmetry::TileSymmetry>& symmetry) {
+        symmetry_ = symmetry;
+        cache_.clear();
+        eval_cache_->clear();
+        layouts_.clear();
+        if(! symmetry_)
+          return;
+
+        for(const size_type index : *TensorImpl_::pmap())
+          if(! TensorImpl_::is_zero(index) && ! symmetry_->is_representative(index))
+            data_.erase(index);
+      }
+
       /// Tile future accessor
 
       /// \tparam Index The index type
       /// \param i The tile index
       /// \return A \c future to tile \c i
       /// \throw TiledArray::Exception When tile \c i is zero
+      /// \note When the tiles are symmetric, a tile that is not the
+      /// representative of its orbit is a permuted copy of the representative.
       template <typename Index>
       future get(const Index& i) const {
         TA_ASSERT(! TensorImpl_::is_zero(i));
-        return data_.get(TensorImpl_::trange().tiles_range().ordinal(i));
+        const size_type index = TensorImpl_::trange().tiles_range().ordinal(i);
+        if(symmetry_) {
+          const auto rep = symmetry_->representative(index);
+          if(rep.second)
+            return permute_tile(get(rep.first), rep.second);
+        }
+        if(data_.is_local(index))
+          return data_.get(index);
+
+        const size_type bytes =
+            TensorImpl_::trange().make_tile_range(index).volume() *
+            sizeof(numeric_type);
+        if(! cache_.enabled())
+          return get_remote(index, bytes);
+        return cache_.find(index, bytes,
+            [=] () { return this->get_remote(index, bytes); });
+      }
+
+      /// Request remote tiles into the read cache
+
+      /// The non-zero remote tiles of \c indices that are not cached are
+      /// requested with one message per owner, and their futures are added
+      /// to the read cache, so later calls to \c get() find them there.
+      /// Nothing is requested when the cache is disabled.
+      /// \param indices The ordinal indices of the tiles
+      void prefetch(const std::vector<size_type>& indices) const {
+        if(! cache_.enabled())
+          return;
+
+        std::vector<size_type> remote;
+        remote.reserve(indices.size());
+        for(size_type index : indices) {
+          if(TensorImpl_::is_zero(index))
+            continue;
+          if(symmetry_)
+            index = symmetry_->representative(index).first;
+          if(! data_.is_local(index) && ! cache_.contains(index))
+            remote.push_back(index);
+        }
+        std::sort(remote.begin(), remote.end());
+        remote.erase(std::unique(remote.begin(), remote.end()), remote.end());
+
+        const std::vector<future> tiles = data_.get_batch(remote);
+        for(size_type i = 0ul; i < remote.size(); ++i)
+          cache_.insert(remote[i],
+              TensorImpl_::trange().make_tile_range(remote[i]).volume() *
+              sizeof(numeric_type), tiles[i]);
       }
 
       /// Tile future accessor
@@ -497,10 +768,229 @@ namespace TiledArray {
       /// \tparam Value The value type
       /// \param i The index of the tile to be set
       /// \param value The object tat contains the tile value
+      /// \note When the tiles are symmetric, only the representatives of the
+      /// orbits are stored and other tiles are ignored.
       template <typename Index, typename Value>
       void set(const Index& i, const Value& value) {
         TA_ASSERT(! TensorImpl_::is_zero(i));
-        data_.set(TensorImpl_::trange().tiles_range().ordinal(i), value);
+        if(cache_.enabled())
+          cache_.clear();
+        if(is_cacheable_lazy_tile<value_type>::value)
+          eval_cache_->clear();
+        const size_type index = TensorImpl_::trange().tiles_range().ordinal(i);
+        if(symmetry_ && ! symmetry_->is_representative(index))
+          return;
+        data_.set(index, value);
+      }
+
+      /// Update the norms of a set of local tiles
+
+      /// This collective function replaces the shape of this tensor with a
+      /// copy in which the norms of \c tile_norms have been merged, see
+      /// \c shape_type::update . Local tiles that become zero are removed,
+      /// and the tiles are recorded as modified (see \c mark_modified() ).
+      /// \tparam SparseNormSequence A sequence of
+      /// <tt>std::pair<size_type,value_type></tt> objects, where \c first is
+      /// the ordinal index of a local tile and \c second is its Frobenius norm
+      /// \param tile_norms The Frobenius norms of the modified local tiles
+      /// \note No task that uses this tensor may be running.
+      template <typename SparseNormSequence>
+      void update_shape(const SparseNormSequence& tile_norms) {
+        const shape_type shape =
+            TensorImpl_::shape().update(TensorImpl_::world(), tile_norms);
+        TensorImpl_::shape(shape);
+        cache_.clear();
+        eval_cache_->clear();
+        layouts_.clear();
+
+        std::vector<size_type> tiles;
+        for(const auto& ordinal_norm : tile_norms) {
+          TA_ASSERT(data_.is_local(ordinal_norm.first));
+          tiles.push_back(ordinal_norm.first);
+          if(shape.is_zero(ordinal_norm.first))
+            data_.erase(ordinal_norm.first);
+        }
+        mark_modified(tiles);
+      }
+
+      /// Record the in-place modification of a set of local tiles
+
+      /// This collective function gathers the tiles that were modified by
+      /// each process and assigns them the next version of this tensor (see
+      /// \c tile_version() ).
+      /// \param tiles The ordinal indices of the local tiles that were
+      /// modified by this process
+      void mark_modified(std::vector<size_type> tiles) {
+        World& world = TensorImpl_::world();
+        if(world.size() > 1) {
+          size_type count = tiles.size();
+          world.gop.sum(count);
+          tiles = world.gop.concat0(tiles, (count + 1ul) * sizeof(size_type) + 1024ul);
+          world.gop.broadcast_serializable(tiles, 0);
+        }
+        touch(tiles);
+      }
+
+      /// Version accessor
+
+      /// \return The number of modifications of the tiles of this tensor
+      std::uint64_t version() const { return version_; }
+
+      /// Tile version accessor
+
+      /// \param index The ordinal index of a tile
+      /// \return The version of this tensor in which tile \c index was last
+      /// modified, or zero if it was not modified since it was set
+      std::uint64_t tile_version(const size_type index) const {
+        TA_ASSERT(index < TensorImpl_::size());
+        return (tile_versions_.empty() ? 0ul : tile_versions_[index]);
+      }
+
+      /// Replace the shape and the local tiles in place
+
+      /// The caches and the diagonal attribute are reset, and each local
+      /// tile is removed. The local tiles that are non-zero in \c shape are
+      /// then set with <tt>op(index, old)</tt>, where \c old is the future of
+      /// the removed tile, or a default future when the tile was not stored,
+      /// so \c op may reuse the memory of the tile that it replaces. All
+      /// tiles are recorded as modified (see \c tile_version() ).
+      /// \tparam Op The tile factory type
+      /// \param shape The new shape of this tensor
+      /// \param op The tile factory, which returns the future of a tile
+      /// \note No task that uses this tensor may be running.
+      template <typename Op>
+      void reassign(const shape_type& shape, const Op& op) {
+        TA_ASSERT(! symmetry_);
+        cache_.clear();
+        eval_cache_->clear();
+        layouts_.clear();
+        diagonal_ = false;
+
+        const shape_type old_shape = TensorImpl_::shape();
+        TensorImpl_::shape(shape);
+        touch();
+        for(const size_type index : *TensorImpl_::pmap()) {
+          future old;
+          if(! old_shape.is_zero(index)) {
+            old = data_.get(index);
+            data_.erase(index);
+          }
+          if(! shape.is_zero(index))
+            data_.set(index, op(index, old));
+        }
+      }
+
+      /// Memory of the local tiles
+
+      /// \return The memory of the local tiles that are assigned
+      ArrayMemoryUsage memory_usage() const {
+        ArrayMemoryUsage usage{ 0ul, 0ul, 0ul };
+        for(const size_type index : *TensorImpl_::pmap()) {
+          if(! is_stored(index))
+            continue;
+          const future tile = data_.get(index);
+          if(tile.probe()) {
+            usage.bytes += tile_bytes(tile.get());
+            ++usage.tiles;
+          } else {
+            ++usage.pending;
+          }
+        }
+        return usage;
+      }
+
+      /// Test for the assignment of the local tiles
+
+      /// \return \c true if all local tiles that are stored are assigned
+      bool probe_local() const {
+        for(const size_type index : *TensorImpl_::pmap()) {
+          if(is_stored(index) && ! data_.get(index).probe())
+            return false;
+        }
+        return true;
+      }
+
+      /// Completion of the local tiles
+
+      /// \return A future that is set when the local tiles that are stored
+      /// at the time of the call are assigned
+      Future<bool> local_completion() const {
+        TileCompletion* completion = new TileCompletion();
+        const Future<bool> done = completion->done();
+        for(const size_type index : *TensorImpl_::pmap()) {
+          if(! is_stored(index))
+            continue;
+          future tile = data_.get(index);
+          completion->add(tile);
+        }
+        completion->start();
+        return done;
+      }
+
+      /// Completion of the tiles of all processes
+
+      /// This collective function does not block: each process contributes
+      /// the completion of its local tiles to an all-reduce, keyed by the id
+      /// of this tensor and the number of previous calls, so the calls must
+      /// be made in the same order on all processes.
+      /// \return A future that is set when the tiles of all processes are
+      /// assigned
+      Future<bool> completion() const {
+        typedef madness::TaggedKey<std::pair<madness::uniqueidT, std::size_t>,
+            ArrayCompletionTag> key_type;
+        return TensorImpl_::world().gop.all_reduce(
+            key_type(std::make_pair(id(), completions_++)), local_completion(),
+            std::logical_and<bool>());
+      }
+
+      /// Send the local tiles of this tensor to a tensor with another process map
+
+      /// Tiles that stay on this process are shared with \c result . The other
+      /// tiles are grouped by their owner in \c result , and each group is
+      /// sent in messages of about \c message_elements elements, so that a
+      /// message is sent as soon as its tiles are assigned. \c result may
+      /// live in another world that includes the processes of this tensor,
+      /// e.g. the parent of a subworld.
+      /// \param result A tensor with the tiled range and the shape of this
+      /// tensor, and no tiles
+      /// \param message_elements The number of elements of each message
+      void redistribute(ArrayImpl_& result, const size_type message_elements) const {
+        TA_ASSERT(result.trange() == TensorImpl_::trange());
+        const ProcessID rank = result.world().rank();
+        result.symmetry_ = symmetry_;
+
+        // The tiles that will be sent to each process
+        struct Message {
+          std::vector<size_type> indices; ///< Tile indices
+          std::vector<future> tiles; ///< Tiles
+          size_type elements = 0ul; ///< The number of elements of the tiles
+        }; // struct Message
+        std::vector<Message> messages(result.world().size());
+
+        for(const size_type index : *TensorImpl_::pmap()) {
+          if(! is_stored(index))
+            continue;
+
+          const ProcessID dest = result.owner(index);
+          const future tile = data_.get(index);
+          if(dest == rank) {
+            result.data_.set(index, tile);
+          } else {
+            Message& message = messages[dest];
+            message.indices.push_back(index);
+            message.tiles.push_back(tile);
+            message.elements += TensorImpl_::trange().make_tile_range(index).volume();
+            if(message.elements >= message_elements) {
+              result.data_.set_batch(dest, std::move(message.indices),
+                  std::move(message.tiles));
+              message = Message();
+            }
+          }
+        }
+
+        for(ProcessID dest = 0; dest < ProcessID(messages.size()); ++dest)
+          result.data_.set_batch(dest, std::move(messages[dest].indices),
+              std::move(messages[dest].tiles));
       }
 
       /// Array begin iterator
@@ -552,36 +1042,61 @@ namespace TiledArray {
       /// \return A const reference to this object unique id
       const madness::uniqueidT& id() const { return data_.id(); }
 
+      /// Aggregate remote tile requests
+
+      /// \param buffer_size The number of requests of each message, or zero
+      /// to send each request in its own message
+      /// \see DistributedStorage::aggregate
+      void aggregate(const size_type buffer_size) { data_.aggregate(buffer_size); }
+
+      /// Send the buffered remote tile requests
+      void flush() const { data_.flush(); }
+
+      /// Remote tile cache accessor
+
+      /// \return A reference to the read cache of remote tiles
+      cache_type& remote_cache() const { return cache_; }
+
+      /// Evaluated lazy tile cache accessor
+
+      /// \return A shared pointer to the cache of evaluated lazy tiles
+      const std::shared_ptr<eval_cache_type>& eval_cache() const { return eval_cache_; }
+
+      /// Permuted layout cache accessor
+
+      /// \return A reference to the cache of permuted copies of this tensor
+      layout_cache_type& layout_cache() const { return layouts_; }
+
     }; // class ArrayImpl
 
 
 #ifndef TILEDARRAY_HEADER_ONLY
 
     extern template
-    class ArrayImpl<Tensor<double, Eigen::aligned_allocator<double> >, DensePolicy>;
+    class ArrayImpl<Tensor<double, default_allocator<double> >, DensePolicy>;
     extern template
-    class ArrayImpl<Tensor<float, Eigen::aligned_allocator<float> >, DensePolicy>;
+    class ArrayImpl<Tensor<float, default_allocator<float> >, DensePolicy>;
     extern template
-    class ArrayImpl<Tensor<int, Eigen::aligned_allocator<int> >, DensePolicy>;
+    class ArrayImpl<Tensor<int, default_allocator<int> >, DensePolicy>;
     extern template
-    class ArrayImpl<Tensor<long, Eigen::aligned_allocator<long> >, DensePolicy>;
+    class ArrayImpl<Tensor<long, default_allocator<long> >, DensePolicy>;
 //    extern template
-//    class ArrayImpl<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, DensePolicy>;
+//    class ArrayImpl<Tensor<std::complex<double>, default_allocator<std::complex<double> > >, DensePolicy>;
 //    extern template
-//    class ArrayImpl<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, DensePolicy>;
+//    class ArrayImpl<Tensor<std::complex<float>, default_allocator<std::complex<float> > >, DensePolicy>;
 
     extern template
-    class ArrayImpl<Tensor<double, Eigen::aligned_allocator<double> >, SparsePolicy>;
+    class ArrayImpl<Tensor<double, default_allocator<double> >, SparsePolicy>;
     extern template
-    class ArrayImpl<Tensor<float, Eigen::aligned_allocator<float> >, SparsePolicy>;
+    class ArrayImpl<Tensor<float, default_allocator<float> >, SparsePolicy>;
     extern template
-    class ArrayImpl<Tensor<int, Eigen::aligned_allocator<int> >, SparsePolicy>;
+    class ArrayImpl<Tensor<int, default_allocator<int> >, SparsePolicy>;
     extern template
-    class ArrayImpl<Tensor<long, Eigen::aligned_allocator<long> >, SparsePolicy>;
+    class ArrayImpl<Tensor<long, default_allocator<long> >, SparsePolicy>;
 //    extern template
-//    class ArrayImpl<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, SparsePolicy>;
+//    class ArrayImpl<Tensor<std::complex<double>, default_allocator<std::complex<double> > >, SparsePolicy>;
 //    extern template
-//    class ArrayImpl<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, SparsePolicy>;
+//    class ArrayImpl<Tensor<std::complex<float>, default_allocator<std::complex<float> > >, SparsePolicy>;
 
 #endif // TILEDARRAY_HEADER_ONLY
 
@@ -22,6 +22,8 @@
 
 #include <TiledArray/error.h>
 #include <TiledArray/transform_iterator.h>
+#include <TiledArray/math/simd.h>
+#include <algorithm>
 #include <climits>
 #include <iosfwd>
 #include <iomanip>
@@ -235,8 +237,12 @@ namespace TiledArray {
       /// \throw std::range_error If the bitset sizes are not equal.
       Bitset<Block>& operator|=(const Bitset<Block>& other) {
         TA_ASSERT(size_ == other.size_);
-        for(size_type i = 0; i < blocks_; ++i)
-          set_[i] |= other.set_[i];
+        block_type* const result = set_;
+        const block_type* const arg = other.set_;
+        const size_type n = blocks_;
+        TILEDARRAY_PRAGMA_SIMD
+        for(size_type i = 0; i < n; ++i)
+          result[i] |= arg[i];
 
         return *this;
       }
@@ -248,8 +254,12 @@ namespace TiledArray {
       /// \throw std::range_error If the bitset sizes are not equal.
       Bitset<Block>& operator&=(const Bitset<Block>& other) {
         TA_ASSERT(size_ == other.size_);
-        for(size_type i = 0; i < blocks_; ++i)
-          set_[i] &= other.set_[i];
+        block_type* const result = set_;
+        const block_type* const arg = other.set_;
+        const size_type n = blocks_;
+        TILEDARRAY_PRAGMA_SIMD
+        for(size_type i = 0; i < n; ++i)
+          result[i] &= arg[i];
 
         return *this;
       }
@@ -262,8 +272,12 @@ namespace TiledArray {
       /// \throw std::range_error If the bitset sizes are not equal.
       Bitset<Block>& operator^=(const Bitset<Block>& other) {
         TA_ASSERT(size_ == other.size_);
-        for(size_type i = 0; i < blocks_; ++i)
-          set_[i] ^= other.set_[i];
+        block_type* const result = set_;
+        const block_type* const arg = other.set_;
+        const size_type n = blocks_;
+        TILEDARRAY_PRAGMA_SIMD
+        for(size_type i = 0; i < n; ++i)
+          result[i] ^= arg[i];
 
         return *this;
       }
@@ -519,16 +533,28 @@ namespace TiledArray {
       /// \return The number of non-zero bits
       size_type count() const {
         size_type c = 0ul;
-        for(size_type i = 0ul; i < blocks_; ++i) {
-          block_type v = set_[i]; // temp
-          v = v - ((v >> 1) & xffff / 3);
-          v = (v & xffff / 15 * 3) + ((v >> 2) & xffff / 15 * 3);
-          v = (v + (v >> 4)) & xffff / 255 * 15;
-          c += block_type(v * (xffff / 255)) >> (sizeof(block_type) - 1) * CHAR_BIT; // count
-        }
+        for(size_type i = 0ul; i < blocks_; ++i)
+          c += popcount(set_[i]);
         return c;
       }
 
+      /// Find the first set bit
+
+      /// \return The index of the first set bit, or \c size() if no bits are
+      /// set
+      /// \throw nothing
+      size_type find_first() const { return find_from(0ul); }
+
+      /// Find the next set bit
+
+      /// \param i The index of the bit after which the search starts
+      /// \return The index of the first set bit after \c i , or \c size() if
+      /// there is none
+      /// \throw nothing
+      size_type find_next(size_type i) const {
+        return (i + 1ul < size_ ? find_from(i + 1ul) : size_);
+      }
+
       /// Data pointer accessor
 
       /// The pointer to the data points to a contiguous block of memory of type
@@ -584,6 +610,65 @@ namespace TiledArray {
       /// bit index.
       static block_type mask(size_type i) { return one << bit_index(i); }
 
+      /// The unsigned integer type with the size of a block
+      typedef typename std::make_unsigned<Block>::type word_type;
+
+      /// Count the set bits of a block
+
+      /// \param block The block
+      /// \return The number of set bits in \c block
+      static size_type popcount(const block_type block) {
+        const word_type w = word_type(block);
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(static_cast<unsigned long long>(w));
+#else
+        // SWAR population count
+        word_type v = w - ((w >> 1) & word_type(~word_type(0)) / 3);
+        v = (v & word_type(~word_type(0)) / 15 * 3) +
+            ((v >> 2) & word_type(~word_type(0)) / 15 * 3);
+        v = (v + (v >> 4)) & word_type(~word_type(0)) / 255 * 15;
+        return word_type(v * (word_type(~word_type(0)) / 255)) >>
+            (sizeof(word_type) - 1) * CHAR_BIT;
+#endif // defined(__GNUC__) || defined(__clang__)
+      }
+
+      /// Index of the lowest set bit of a block
+
+      /// \param block A non-zero block
+      /// \return The index of the lowest set bit in \c block
+      static size_type lowest_bit(const block_type block) {
+        TA_ASSERT(block != zero);
+        const word_type w = word_type(block);
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(static_cast<unsigned long long>(w));
+#else
+        size_type i = 0ul;
+        while(! ((w >> i) & 1u))
+          ++i;
+        return i;
+#endif // defined(__GNUC__) || defined(__clang__)
+      }
+
+      /// Find the first set bit at or after a given bit
+
+      /// \param i The first bit of the search
+      /// \return The index of the first set bit at or after \c i , or
+      /// \c size_ if there is none
+      size_type find_from(const size_type i) const {
+        if(i >= size_)
+          return size_;
+        size_type b = block_index(i);
+        // Mask the bits before i in the first block
+        block_type block = set_[b] & block_type(xffff << bit_index(i));
+        while(block == zero) {
+          if(++b == blocks_)
+            return size_;
+          block = set_[b];
+        }
+        // flip() may set the bits of the tail, which are not part of the set
+        return std::min(b * block_bits + lowest_bit(block), size_);
+      }
+
       size_type size_;    ///< The number of bits in the set
       size_type blocks_;  ///< The number of blocks used to store the bits
       block_type* set_;   ///< An array that store the bits
@@ -53,7 +53,7 @@ namespace TiledArray {
           [](const size_type l, const size_type r) { return l <= r; }));
 
       // Initialize the block range data members
-      data_ = new size_type[range.rank() << 2];
+      data_ = allocate_data(range.rank());
       offset_ = range.offset();
       volume_ = 1ul;
       rank_ = range.rank();
@@ -148,24 +148,28 @@ namespace TiledArray {
       // Check that index is contained by range.
       TA_ASSERT(includes(index));
 
-      // Construct result coordinate index object and allocate its memory.
-      ordinal_type result = 0ul;
+      return detail::rank_dispatch(rank_, [&] (auto r) {
+        const unsigned int n = detail::kernel_rank(r, rank_);
 
-      // Get pointers to the data
-      const auto * MADNESS_RESTRICT const size = data_ + rank_ + rank_;
-      const auto * MADNESS_RESTRICT const stride = size + rank_;
+        // Construct result coordinate index object and allocate its memory.
+        ordinal_type result = 0ul;
 
-      // Compute the coordinate index of o in range.
-      for(int i = int(rank_) - 1; i >= 0; --i) {
-        const auto size_i = size[i];
-        const auto stride_i = stride[i];
+        // Get pointers to the data
+        const auto * MADNESS_RESTRICT const size = data_ + n + n;
+        const auto * MADNESS_RESTRICT const stride = size + n;
 
-        // Compute result index element i
-        result += (index % size_i) * stride_i;
-        index /= size_i;
-      }
+        // Compute the coordinate index of o in range.
+        for(int i = int(n) - 1; i >= 0; --i) {
+          const auto size_i = size[i];
+          const auto stride_i = stride[i];
+
+          // Compute result index element i
+          result += (index % size_i) * stride_i;
+          index /= size_i;
+        }
 
-      return result + block_offset_ - offset_;
+        return result + block_offset_ - offset_;
+      });
     }
 
     /// Resize of block range is not supported
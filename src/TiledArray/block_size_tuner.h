@@ -0,0 +1,474 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  block_size_tuner.h
+ *
+ */
+
+#ifndef TILEDARRAY_BLOCK_SIZE_TUNER_H__INCLUDED
+#define TILEDARRAY_BLOCK_SIZE_TUNER_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/error.h>
+#include <TiledArray/math/blas.h>
+#include <TiledArray/tiled_range1.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Block size selection for matrix products
+
+  /// BlockSizeTuner recommends the block size of the \c TiledRange1 of the
+  /// three dimensions of an \f$ M \times K \f$ by \f$ K \times N \f$ product
+  /// on the processes of a world. Each candidate block size is scored with a
+  /// model of SUMMA:
+  /// \f[
+  ///   T(b) = \max\left(\left\lceil \frac{t}{\tau} \right\rceil
+  ///     \frac{2 m n k}{r(b)}, \; s \alpha + \frac{8 e}{\beta}\right)
+  ///     + (t + s) \gamma
+  /// \f]
+  /// where \f$ t \f$ is the number of tile products of the most loaded
+  /// process, \f$ \tau \f$ the number of threads, \f$ m n k \f$ the size of
+  /// a tile product, and \f$ s \f$ and \f$ e \f$ the number of tiles and
+  /// elements that the process receives. The machine parameters are
+  /// calibrated on first use: the single-thread GEMM rate \f$ r(b) \f$ of
+  /// each candidate, the broadcast latency \f$ \alpha \f$ and bandwidth
+  /// \f$ \beta \f$, and the task overhead \f$ \gamma \f$. Optionally, the
+  /// best candidates of the model are also timed on the actual product.
+  ///
+  /// The calibration and the recommendations are cached in a file per
+  /// machine, keyed by the number of processes and threads, so they are
+  /// computed once. The file is \c $TA_BLOCK_SIZE_CACHE when that is set,
+  /// otherwise <tt>$HOME/.tiledarray_block_size.<host>.txt</tt>, where
+  /// \c host is the host name of process 0.
+  /// \code
+  /// TiledArray::BlockSizeTuner tuner(world);
+  /// const auto rec = tuner.recommend(m, n, k);
+  /// TiledArray::TiledRange1 trm = tuner.make_trange1(m, rec.block);
+  /// \endcode
+  class BlockSizeTuner {
+  public:
+    typedef std::size_t size_type; ///< Size type
+
+    /// Calibrated machine parameters
+    struct MachineModel {
+      double latency = 0.0; ///< Broadcast latency per message, in seconds
+      double bandwidth = 0.0; ///< Broadcast bandwidth, in bytes per second (0 with one process)
+      double task_overhead = 0.0; ///< Time per task, in seconds
+      std::map<size_type, double> gemm_rate; ///< Single-thread flop rate of each block size
+    }; // struct MachineModel
+
+    /// Block size recommendation
+    struct Recommendation {
+      size_type block = 0ul; ///< The recommended block size
+      double time = 0.0; ///< The predicted, or measured, time of the product in seconds
+      bool measured = false; ///< True if \c time was measured
+      bool cached = false; ///< True if the recommendation was read from the cache
+    }; // struct Recommendation
+
+  private:
+    World& world_; ///< The world of the products
+    std::string cache_file_; ///< The cache file name
+    std::vector<size_type> candidates_; ///< Candidate block sizes
+    size_type threads_; ///< Number of threads per process
+    std::string cache_; ///< The contents of the cache file
+    bool calibrated_ = false; ///< True when \c model_ is set
+    MachineModel model_; ///< The machine parameters
+
+    /// Read the cache file on process 0 and broadcast its contents
+    void load_cache() {
+      if(world_.rank() == 0) {
+        std::ifstream file(cache_file_);
+        std::stringstream ss;
+        if(file)
+          ss << file.rdbuf();
+        cache_ = ss.str();
+      }
+      world_.gop.broadcast_serializable(cache_, 0);
+    }
+
+    /// Append a line to the cache, and to the cache file on process 0
+    void store(const std::string& line) {
+      cache_ += line + "\n";
+      if(world_.rank() == 0) {
+        std::ofstream file(cache_file_, std::ios::app);
+        if(file)
+          file << line << "\n";
+      }
+    }
+
+    /// Search the cache
+
+    /// \param key The leading fields of the line
+    /// \return The remaining fields of the last line that starts with
+    /// \c key , or an empty string
+    std::string lookup(const std::string& key) const {
+      std::istringstream ss(cache_);
+      std::string line, result;
+      while(std::getline(ss, line))
+        if(line.compare(0, key.size() + 1ul, key + " ") == 0)
+          result = line.substr(key.size() + 1ul);
+      return result;
+    }
+
+    /// The key of the machine parameters of this world
+    std::string machine_key() const {
+      std::stringstream ss;
+      ss << "machine " << world_.size() << " " << threads_;
+      return ss.str();
+    }
+
+    /// Measure the single-thread GEMM rate of a block size
+
+    /// \param block The block size
+    /// \return The flop rate of a \c block cubed product
+    static double time_gemm(const size_type block) {
+      const integer b = block;
+      std::vector<double> a(block * block, 1.0), c(block * block, 0.0);
+      const double flops = 2.0 * double(block) * double(block) * double(block);
+      const size_type repeats = std::max<size_type>(2ul, size_type(2.0e8 / flops));
+
+      math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, b, b, b,
+          1.0, a.data(), b, a.data(), b, 0.0, c.data(), b);
+      const double start = madness::wall_time();
+      for(size_type i = 0ul; i < repeats; ++i)
+        math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, b, b, b,
+            1.0, a.data(), b, a.data(), b, 1.0, c.data(), b);
+      const double time = madness::wall_time() - start;
+      return (time > 0.0 ? flops * double(repeats) / time : std::numeric_limits<double>::max());
+    }
+
+    /// Measure the time of a broadcast from process 0
+
+    /// \param bytes The message size
+    /// \return The time of a broadcast of \c bytes on the slowest process
+    double time_bcast(const size_type bytes) {
+      std::vector<char> buffer(bytes, '\0');
+      const size_type repeats = 4ul;
+      world_.gop.fence();
+      const double start = madness::wall_time();
+      for(size_type i = 0ul; i < repeats; ++i)
+        world_.gop.broadcast(buffer.data(), bytes, 0);
+      double time = (madness::wall_time() - start) / double(repeats);
+      world_.gop.max(time);
+      return time;
+    }
+
+    /// Calibrate the machine parameters
+    void calibrate() {
+      // GEMM rate, averaged over the processes
+      std::vector<double> rates;
+      for(const size_type block : candidates_)
+        rates.push_back(time_gemm(block));
+      world_.gop.sum(rates.data(), rates.size());
+      for(size_type i = 0ul; i < candidates_.size(); ++i)
+        model_.gemm_rate[candidates_[i]] = rates[i] / double(world_.size());
+
+      // Task overhead
+      const size_type ntasks = 10000ul;
+      world_.gop.fence();
+      double start = madness::wall_time();
+      for(size_type i = 0ul; i < ntasks; ++i)
+        world_.taskq.add([] () { });
+      world_.gop.fence();
+      double time = (madness::wall_time() - start) / double(ntasks);
+      world_.gop.max(time);
+      model_.task_overhead = time;
+
+      // Broadcast latency and bandwidth, per level of the broadcast tree
+      if(world_.size() > 1) {
+        const double levels = std::ceil(std::log2(double(world_.size())));
+        const size_type small = 8ul, large = 1ul << 23;
+        const double t_small = time_bcast(small), t_large = time_bcast(large);
+        model_.latency = t_small / levels;
+        model_.bandwidth = (t_large > t_small ?
+            double(large - small) * levels / (t_large - t_small) :
+            std::numeric_limits<double>::max());
+      }
+    }
+
+    /// Find the rate of a block size that was not calibrated
+
+    /// \return The rate of the nearest calibrated block size
+    double gemm_rate(const size_type block) const {
+      TA_ASSERT(! model_.gemm_rate.empty());
+      auto it = model_.gemm_rate.lower_bound(block);
+      if(it == model_.gemm_rate.end())
+        --it;
+      return it->second;
+    }
+
+    static size_type ceil_div(const size_type x, const size_type y) {
+      return (x + y - 1ul) / y;
+    }
+
+  public:
+
+    /// Constructor
+
+    /// \param world The world of the products
+    /// \param cache_file The cache file name [ default = \c default_cache_file() ]
+    /// \note This function is collective.
+    explicit BlockSizeTuner(World& world,
+        const std::string& cache_file = default_cache_file()) :
+      world_(world), cache_file_(cache_file),
+      candidates_{ 16ul, 24ul, 32ul, 48ul, 64ul, 96ul, 128ul, 192ul, 256ul,
+          384ul, 512ul, 768ul, 1024ul, 1536ul, 2048ul },
+      threads_(std::max<size_type>(madness::ThreadPool::size(), 1ul))
+    {
+      load_cache();
+    }
+
+    /// The default cache file name
+
+    /// \return \c $TA_BLOCK_SIZE_CACHE or
+    /// <tt>$HOME/.tiledarray_block_size.<host>.txt</tt>
+    static std::string default_cache_file() {
+      const char* file = getenv("TA_BLOCK_SIZE_CACHE");
+      if(file)
+        return file;
+      char hostname[256] = { '\0' };
+      gethostname(hostname, sizeof(hostname) - 1ul);
+      const char* home = getenv("HOME");
+      return std::string(home ? home : ".") + "/.tiledarray_block_size."
+          + hostname + ".txt";
+    }
+
+    /// Cache file name accessor
+    const std::string& cache_file() const { return cache_file_; }
+
+    /// Set the candidate block sizes
+
+    /// \param candidates The candidate block sizes
+    /// \throw TiledArray::Exception When \c candidates is empty or contains
+    /// zero
+    void set_candidates(std::vector<size_type> candidates) {
+      std::sort(candidates.begin(), candidates.end());
+      candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+      TA_USER_ASSERT(! candidates.empty() && candidates.front() > 0ul,
+          "BlockSizeTuner::set_candidates(): candidates must be non-zero.");
+      candidates_ = std::move(candidates);
+      calibrated_ = false;
+    }
+
+    /// Candidate block sizes accessor
+    const std::vector<size_type>& candidates() const { return candidates_; }
+
+    /// Machine parameters accessor
+
+    /// The parameters are read from the cache, or calibrated and cached when
+    /// the cache has no parameters for the process and thread count, or for
+    /// one of the candidates.
+    /// \return The machine parameters
+    /// \note This function is collective on the first call.
+    const MachineModel& model() {
+      if(calibrated_)
+        return model_;
+
+      // Read the cached parameters
+      model_ = MachineModel();
+      std::istringstream ss(lookup(machine_key()));
+      size_type block = 0ul;
+      double rate = 0.0;
+      bool complete = static_cast<bool>(ss >> model_.latency >> model_.bandwidth
+          >> model_.task_overhead);
+      while(ss >> block >> rate)
+        model_.gemm_rate[block] = rate;
+      for(const size_type b : candidates_)
+        complete = complete && model_.gemm_rate.count(b);
+
+      if(! complete) {
+        model_ = MachineModel();
+        calibrate();
+        std::stringstream line;
+        line << machine_key() << " " << std::setprecision(8) << model_.latency
+             << " " << model_.bandwidth << " " << model_.task_overhead;
+        for(const auto& r : model_.gemm_rate)
+          line << " " << r.first << " " << r.second;
+        store(line.str());
+      }
+      calibrated_ = true;
+      return model_;
+    }
+
+    /// Predict the time of a product
+
+    /// \param m The number of rows of the product
+    /// \param n The number of columns of the product
+    /// \param k The contracted dimension of the product
+    /// \param block The block size of all three dimensions
+    /// \return The predicted time of the product, in seconds
+    /// \note This function is collective on the first call.
+    double predict(const size_type m, const size_type n, const size_type k,
+        const size_type block)
+    {
+      const MachineModel& mm = model();
+      const size_type nprocs = world_.size();
+      const size_type Mt = ceil_div(m, block), Nt = ceil_div(n, block),
+          Kt = ceil_div(k, block);
+
+      // Near-square process grid, as constructed by ProcGrid for square
+      // problems
+      size_type Pr = std::max<size_type>(size_type(std::sqrt(double(nprocs))), 1ul);
+      Pr = std::min(Pr, Mt);
+      const size_type Pc = std::min(std::max<size_type>(nprocs / Pr, 1ul), Nt);
+      const size_type local_Mt = ceil_div(Mt, Pr), local_Nt = ceil_div(Nt, Pc);
+
+      // Compute
+      const double tm = double(m) / double(Mt), tn = double(n) / double(Nt),
+          tk = double(k) / double(Kt);
+      const double tasks = double(local_Mt * local_Nt * Kt);
+      const double compute = std::ceil(tasks / double(threads_))
+          * 2.0 * tm * tn * tk / gemm_rate(block);
+
+      // Communication
+      double messages = 0.0, elements = 0.0;
+      if(Pc > 1ul) {
+        messages += double(local_Mt * Kt);
+        elements += double(local_Mt * Kt) * tm * tk;
+      }
+      if(Pr > 1ul) {
+        messages += double(local_Nt * Kt);
+        elements += double(local_Nt * Kt) * tk * tn;
+      }
+      const double comm = (mm.bandwidth > 0.0 ?
+          messages * mm.latency + 8.0 * elements / mm.bandwidth : 0.0);
+
+      return std::max(compute, comm) + (tasks + messages) * mm.task_overhead;
+    }
+
+    /// Time a product
+
+    /// \param m The number of rows of the product
+    /// \param n The number of columns of the product
+    /// \param k The contracted dimension of the product
+    /// \param block The block size of all three dimensions
+    /// \param repeats The number of timed products [ default = 2 ]
+    /// \return The average time of the product on the slowest process
+    /// \note This function is collective.
+    double measure(const size_type m, const size_type n, const size_type k,
+        const size_type block, const size_type repeats = 2ul)
+    {
+      TA_USER_ASSERT(repeats > 0ul, "BlockSizeTuner::measure(): repeats must be non-zero.");
+      const TiledRange1 trm = make_trange1(m, block), trn = make_trange1(n, block),
+          trk = make_trange1(k, block);
+      TArrayD a(world_, TiledRange{ trm, trk }), b(world_, TiledRange{ trk, trn }), c;
+      a.fill(1.0);
+      b.fill(1.0);
+
+      // Warm up
+      c("m,n") = a("m,k") * b("k,n");
+      world_.gop.fence();
+      const double start = madness::wall_time();
+      for(size_type i = 0ul; i < repeats; ++i)
+        c("m,n") = a("m,k") * b("k,n");
+      world_.gop.fence();
+      double time = (madness::wall_time() - start) / double(repeats);
+      world_.gop.max(time);
+      return time;
+    }
+
+    /// Recommend a block size
+
+    /// The candidates that are not larger than the largest dimension are
+    /// scored with the model (see \c predict() ); when \c measure_best is
+    /// non-zero, that many of the best scored candidates are also timed
+    /// with \c measure() , and the fastest is recommended. The
+    /// recommendation is cached.
+    /// \param m The number of rows of the product
+    /// \param n The number of columns of the product
+    /// \param k The contracted dimension of the product
+    /// \param measure_best The number of candidates to time [ default = 0 ]
+    /// \return The recommendation
+    /// \note This function is collective.
+    Recommendation recommend(const size_type m, const size_type n,
+        const size_type k, const size_type measure_best = 0ul)
+    {
+      TA_USER_ASSERT((m > 0ul) && (n > 0ul) && (k > 0ul),
+          "BlockSizeTuner::recommend(): dimensions must be non-zero.");
+      std::stringstream key;
+      key << "block " << world_.size() << " " << threads_ << " " << m << " "
+          << n << " " << k << " " << measure_best;
+
+      Recommendation result;
+      std::istringstream cached(lookup(key.str()));
+      if(cached >> result.block >> result.time >> result.measured) {
+        result.cached = true;
+        return result;
+      }
+
+      // Score the candidates with the model
+      const size_type largest = std::max(m, std::max(n, k));
+      std::vector<std::pair<double, size_type> > scores;
+      for(const size_type block : candidates_)
+        if(block <= largest || scores.empty())
+          scores.emplace_back(predict(m, n, k, block), block);
+      std::sort(scores.begin(), scores.end());
+      result.block = scores.front().second;
+      result.time = scores.front().first;
+
+      // Time the best candidates
+      if(measure_best > 0ul) {
+        result.measured = true;
+        result.time = std::numeric_limits<double>::max();
+        const size_type count = std::min(measure_best, scores.size());
+        for(size_type i = 0ul; i < count; ++i) {
+          const double time = measure(m, n, k, scores[i].second);
+          if(time < result.time) {
+            result.time = time;
+            result.block = scores[i].second;
+          }
+        }
+      }
+
+      std::stringstream line;
+      line << key.str() << " " << result.block << " " << std::setprecision(8)
+           << result.time << " " << result.measured;
+      store(line.str());
+      return result;
+    }
+
+    /// Uniform tiling of a dimension
+
+    /// \param extent The extent of the dimension
+    /// \param block The block size
+    /// \return A tiling of \c extent into tiles of size \c block , with the
+    /// remainder in the last tile
+    static TiledRange1 make_trange1(const size_type extent, const size_type block) {
+      TA_USER_ASSERT(block > 0ul, "BlockSizeTuner::make_trange1(): block must be non-zero.");
+      std::vector<size_type> boundaries;
+      for(size_type i = 0ul; i < extent; i += block)
+        boundaries.push_back(i);
+      boundaries.push_back(extent);
+      return TiledRange1(boundaries.begin(), boundaries.end());
+    }
+
+  }; // class BlockSizeTuner
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_BLOCK_SIZE_TUNER_H__INCLUDED
@@ -0,0 +1,734 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  checkpoint.h
+ *
+ */
+
+#ifndef TILEDARRAY_CHECKPOINT_H__INCLUDED
+#define TILEDARRAY_CHECKPOINT_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/error.h>
+#include <madness/world/vector_archive.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// The layout of checkpoint files
+
+    /// A checkpoint file starts with a header of 64-bit words:
+    /// \li the magic number, \c magic or \c raw_magic ;
+    /// \li the number of words in the header;
+    /// \li the rank of the array;
+    /// \li for each dimension, the number of tiles followed by the tile
+    /// boundaries;
+    /// \li the number of tiles, followed by the size, in bytes, of each
+    /// tile in ordinal order (zero for zero tiles);
+    /// \li format specific words.
+    ///
+    /// The tiles follow the header, in ordinal order. In \c magic files
+    /// the tiles are serialized. In \c raw_magic files the tiles hold the
+    /// elements of \c Tensor tiles, at offsets aligned to \c alignment
+    /// bytes, so they can be mapped into memory; the format specific words
+    /// are the element size and the Frobenius norms of the tiles, stored as
+    /// \c double . The file does not depend on the number of processes or
+    /// on the process map of the array.
+    struct CheckpointFormat {
+      typedef std::uint64_t word_type; ///< The header word type
+
+      static constexpr word_type magic = 0x3130544e50435441ull; ///< "ATCPNT01"
+      static constexpr word_type raw_magic = 0x3130574152435441ull; ///< "ATCRAW01"
+      static constexpr std::size_t alignment = 64ul; ///< Raw tile alignment
+
+      /// Make the header of a checkpoint file
+
+      /// \param magic_number The magic number of the file format
+      /// \param trange The tiled range of the array
+      /// \param sizes The size of each tile, in bytes
+      /// \param extra The format specific words
+      /// \return The header
+      static std::vector<word_type> make_header(const word_type magic_number,
+          const TiledRange& trange, const std::vector<word_type>& sizes,
+          const std::vector<word_type>& extra = std::vector<word_type>())
+      {
+        std::vector<word_type> header = { magic_number, 0ull, trange.rank() };
+        for(const auto& trange1 : trange.data()) {
+          header.push_back(trange1.tile_extent());
+          header.push_back(trange1.elements_range().first);
+          for(const auto& tile : trange1)
+            header.push_back(tile.second);
+        }
+        header.push_back(sizes.size());
+        header.insert(header.end(), sizes.begin(), sizes.end());
+        header.insert(header.end(), extra.begin(), extra.end());
+        if(magic_number == raw_magic)
+          header.resize(align(header.size() * sizeof(word_type)) / sizeof(word_type), 0ull);
+        header[1] = header.size();
+        return header;
+      }
+
+      /// Read the tiled range and the tile sizes from a header
+
+      /// \param header The header
+      /// \param magic_number The magic number of the file format
+      /// \param[out] trange The tiled range of the array
+      /// \param[out] sizes The size of each tile, in bytes
+      /// \param[out] extra The format specific words, if not null
+      /// \throw TiledArray::Exception When \c header is not a valid header
+      static void parse_header(const std::vector<word_type>& header,
+          const word_type magic_number, TiledRange& trange,
+          std::vector<word_type>& sizes, std::vector<word_type>* extra = nullptr)
+      {
+        if((header.size() < 4ul) || (header[0] != magic_number) || (header[1] != header.size()))
+          TA_EXCEPTION("Invalid checkpoint file header");
+
+        std::size_t pos = 3ul;
+        std::vector<TiledRange1> ranges;
+        for(word_type d = 0ull; d < header[2]; ++d) {
+          const std::size_t first = pos + 1ul;
+          const std::size_t last = first + header[pos] + 1ul;
+          if(last > header.size())
+            TA_EXCEPTION("Invalid checkpoint file header");
+          ranges.emplace_back(header.begin() + first, header.begin() + last);
+          pos = last;
+        }
+        trange = TiledRange(ranges.begin(), ranges.end());
+
+        if((pos >= header.size()) || (header.size() - pos - 1ul < header[pos])
+            || (header[pos] != trange.tiles_range().volume()))
+          TA_EXCEPTION("Invalid checkpoint file header");
+        const auto last = header.begin() + pos + 1ul + header[pos];
+        sizes.assign(header.begin() + pos + 1ul, last);
+        if(extra)
+          extra->assign(last, header.end());
+      }
+
+      /// Round a size up to a multiple of \c alignment
+
+      /// \param bytes The size, in bytes
+      /// \return The aligned size
+      static std::size_t align(const std::size_t bytes) {
+        return (bytes + alignment - 1ul) & ~(alignment - 1ul);
+      }
+
+      /// The offsets of the tiles in a checkpoint file
+
+      /// \param header_words The number of words in the header
+      /// \param sizes The size of each tile, in bytes
+      /// \return The offset of each tile, in bytes
+      static std::vector<MPI_Offset> offsets(const std::size_t header_words,
+          const std::vector<word_type>& sizes)
+      {
+        std::vector<MPI_Offset> result(sizes.size());
+        MPI_Offset offset = header_words * sizeof(word_type);
+        for(std::size_t i = 0ul; i < sizes.size(); ++i) {
+          result[i] = offset;
+          offset += sizes[i];
+        }
+        return result;
+      }
+
+      /// The largest I/O operation
+
+      /// \return The number of bytes in each read or write of a tile
+      static std::size_t chunk_bytes() {
+        return std::size_t(std::numeric_limits<int>::max()) & ~std::size_t(4095);
+      }
+
+      /// Check the return value of an MPI function
+
+      /// \param error The return value
+      /// \param function The name of the function
+      /// \throw TiledArray::Exception When \c error is not \c MPI_SUCCESS
+      static void check(const int error, const char* function) {
+        if(error != MPI_SUCCESS)
+          TA_EXCEPTION(function);
+      }
+
+    }; // struct CheckpointFormat
+
+  }  // namespace detail
+
+  /// A pending checkpoint write
+
+  /// The tile data is written to the file with non-blocking MPI-IO
+  /// operations, which progress while the computation continues. \c wait()
+  /// must be called, by all processes, before the file is used.
+  class CheckpointWrite {
+  private:
+    World* world_; ///< The world of the array
+    MPI_File file_; ///< The checkpoint file
+    std::vector<MPI_Request> requests_; ///< The pending writes
+    std::shared_ptr<void> data_; ///< The owner of the data of the writes
+
+    // Not allowed
+    CheckpointWrite(const CheckpointWrite&);
+    CheckpointWrite& operator=(const CheckpointWrite&);
+
+  public:
+
+    /// Constructor
+
+    /// \param world The world of the array
+    /// \param file The open checkpoint file
+    /// \param requests The pending writes
+    /// \param data The owner of the data of the pending writes
+    CheckpointWrite(World& world, MPI_File file,
+        std::vector<MPI_Request>&& requests, std::shared_ptr<void>&& data) :
+      world_(&world), file_(file), requests_(std::move(requests)),
+      data_(std::move(data))
+    { }
+
+    CheckpointWrite(CheckpointWrite&& other) :
+      world_(other.world_), file_(other.file_),
+      requests_(std::move(other.requests_)), data_(std::move(other.data_))
+    {
+      other.world_ = nullptr;
+    }
+
+    /// Destructor
+
+    /// Waits for the write, if \c wait() was not called.
+    ~CheckpointWrite() { wait(); }
+
+    /// Wait for the write to complete
+
+    /// Tasks are run while the writes are pending. This is a collective
+    /// operation, which closes the file.
+    void wait() {
+      if(! world_)
+        return;
+
+      world_->await([this] () -> bool {
+        SAFE_MPI_GLOBAL_MUTEX;
+        int flag = 0;
+        detail::CheckpointFormat::check(MPI_Testall(requests_.size(),
+            requests_.data(), &flag, MPI_STATUSES_IGNORE), "MPI_Testall");
+        return flag;
+      });
+
+      {
+        SAFE_MPI_GLOBAL_MUTEX;
+        detail::CheckpointFormat::check(MPI_File_close(&file_), "MPI_File_close");
+      }
+      requests_.clear();
+      data_.reset();
+      world_ = nullptr;
+    }
+
+  }; // class CheckpointWrite
+
+  namespace detail {
+
+    /// A block of data in a checkpoint file
+    struct CheckpointBlock {
+      MPI_Offset offset; ///< The offset of the block in the file
+      const char* data; ///< The data of the block
+      std::size_t bytes; ///< The size of the block
+    }; // struct CheckpointBlock
+
+    /// Open a checkpoint file and start the writes
+
+    /// \param world The world of the array
+    /// \param filename The name of the checkpoint file
+    /// \param header The header, which is written by process 0
+    /// \param offsets The offset of each tile
+    /// \param sizes The size of each tile
+    /// \param blocks The local data
+    /// \param data The owner of the data of \c blocks
+    /// \return The pending write
+    inline CheckpointWrite
+    start_checkpoint_write(World& world, const std::string& filename,
+        const std::vector<CheckpointFormat::word_type>& header,
+        const std::vector<MPI_Offset>& offsets,
+        const std::vector<CheckpointFormat::word_type>& sizes,
+        const std::vector<CheckpointBlock>& blocks, std::shared_ptr<void>&& data)
+    {
+      const MPI_Offset header_bytes = header.size() * sizeof(CheckpointFormat::word_type);
+
+      MPI_File file;
+      std::vector<MPI_Request> requests;
+      SAFE_MPI_GLOBAL_MUTEX;
+      CheckpointFormat::check(MPI_File_open(
+          world.mpi.comm().Get_mpi_comm(), const_cast<char*>(filename.c_str()),
+          MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file), "MPI_File_open");
+      CheckpointFormat::check(MPI_File_set_size(file, (sizes.empty() ? header_bytes :
+          offsets.back() + MPI_Offset(sizes.back()))), "MPI_File_set_size");
+      if(world.rank() == 0)
+        CheckpointFormat::check(MPI_File_write_at(file, 0,
+            const_cast<CheckpointFormat::word_type*>(header.data()), header_bytes,
+            MPI_BYTE, MPI_STATUS_IGNORE), "MPI_File_write_at");
+
+      const std::size_t chunk = CheckpointFormat::chunk_bytes();
+      for(const CheckpointBlock& block : blocks) {
+        for(std::size_t offset = 0ul; offset < block.bytes; offset += chunk) {
+          const int count = std::min(chunk, block.bytes - offset);
+          requests.emplace_back();
+          CheckpointFormat::check(MPI_File_iwrite_at(file, block.offset + offset,
+              const_cast<char*>(block.data) + offset, count, MPI_BYTE,
+              &requests.back()), "MPI_File_iwrite_at");
+        }
+      }
+
+      return CheckpointWrite(world, file, std::move(requests), std::move(data));
+    }
+
+  }  // namespace detail
+
+  /// Write an array to a checkpoint file
+
+  /// The local tiles are serialized by tasks, as they are computed, and
+  /// written to a single shared file with non-blocking MPI-IO operations.
+  /// The file holds the tiled range, a tile index, and the tiles in ordinal
+  /// order, so it may be read with a different number of processes and
+  /// process map (see \c read_array() ). This is a collective operation; it
+  /// returns once the writes are started, and the write completes with
+  /// <tt>CheckpointWrite::wait()</tt> .
+  /// \tparam Tile The tile type of the array, which must be serializable
+  /// \tparam Policy The policy type of the array
+  /// \param array The array to be written
+  /// \param filename The name of the checkpoint file
+  /// \return The pending write
+  /// \throw TiledArray::Exception When an MPI-IO operation fails
+  template <typename Tile, typename Policy>
+  inline CheckpointWrite
+  write_array(const DistArray<Tile, Policy>& array, const std::string& filename) {
+    typedef detail::CheckpointFormat::word_type word_type;
+
+    World& world = array.world();
+    const std::size_t ntiles = array.trange().tiles_range().volume();
+
+    // Serialize the local tiles
+    std::vector<std::size_t> local;
+    local.reserve(array.pmap()->local_size());
+    for(const std::size_t ord : *array.pmap())
+      if(! array.is_zero(ord))
+        local.push_back(ord);
+
+    // Each tile is serialized once, into a growing buffer. Vector archives
+    // are not message archives, so the tiles are not compressed by
+    // TensorCompression and the checkpoint holds the exact data.
+    std::vector<std::vector<unsigned char> > buffers(local.size());
+    madness::AtomicInt counter; counter = 0;
+    auto task = [&buffers,&counter] (const std::size_t i, const Tile& tile) {
+      madness::archive::VectorOutputArchive ar(buffers[i]);
+      ar & tile;
+      buffers[i].shrink_to_fit();
+      ++counter;
+    };
+    for(std::size_t i = 0ul; i < local.size(); ++i)
+      world.taskq.add(task, i, array.find(local[i]));
+    const int task_count = local.size();
+    if(task_count > 0)
+      world.await([&counter,task_count] () -> bool { return counter == task_count; });
+
+    // Collect the tile index
+    std::vector<word_type> sizes(ntiles, 0ull);
+    for(std::size_t i = 0ul; i < local.size(); ++i)
+      sizes[local[i]] = buffers[i].size();
+    world.gop.sum(sizes.data(), ntiles);
+
+    const std::vector<word_type> header =
+        detail::CheckpointFormat::make_header(detail::CheckpointFormat::magic,
+            array.trange(), sizes);
+    const std::vector<MPI_Offset> offsets =
+        detail::CheckpointFormat::offsets(header.size(), sizes);
+
+    // Start the writes
+    std::vector<detail::CheckpointBlock> blocks;
+    blocks.reserve(local.size());
+    for(std::size_t i = 0ul; i < local.size(); ++i)
+      blocks.push_back(detail::CheckpointBlock{ offsets[local[i]],
+          reinterpret_cast<const char*>(buffers[i].data()), buffers[i].size() });
+
+    return detail::start_checkpoint_write(world, filename, header, offsets,
+        sizes, blocks,
+        std::make_shared<std::vector<std::vector<unsigned char> > >(std::move(buffers)));
+  }
+
+  namespace detail {
+
+    /// Construct a dense array from checkpoint tiles
+
+    /// Zero tiles of the checkpoint are set to zero.
+    template <typename Tile>
+    inline DistArray<Tile, DensePolicy>
+    make_checkpoint_array(World& world, const TiledRange& trange,
+        const std::shared_ptr<typename DensePolicy::pmap_interface>& pmap,
+        const std::vector<std::size_t>& local, std::vector<Tile>& tiles,
+        const TiledArray::Tensor<float>&, const bool)
+    {
+      DistArray<Tile, DensePolicy> array(world, trange, pmap);
+      std::size_t i = 0ul;
+      for(const std::size_t ord : *pmap) {
+        if((i < local.size()) && (local[i] == ord))
+          array.set(ord, std::move(tiles[i++]));
+        else
+          array.set(ord, 0);
+      }
+      return array;
+    }
+
+    /// Construct a sparse array from checkpoint tiles
+
+    /// The shape is computed from the norms of the tiles, which are
+    /// reduced over all processes unless \c all_norms is \c true .
+    template <typename Tile>
+    inline DistArray<Tile, SparsePolicy>
+    make_checkpoint_array(World& world, const TiledRange& trange,
+        const std::shared_ptr<typename SparsePolicy::pmap_interface>& pmap,
+        const std::vector<std::size_t>& local, std::vector<Tile>& tiles,
+        const TiledArray::Tensor<float>& tile_norms, const bool all_norms)
+    {
+      const SparseShape<float> shape = (all_norms ?
+          SparseShape<float>(tile_norms, trange) :
+          SparseShape<float>(world, tile_norms, trange));
+      DistArray<Tile, SparsePolicy> array(world, trange, shape, pmap);
+      for(std::size_t i = 0ul; i < local.size(); ++i)
+        if(! array.is_zero(local[i]))
+          array.set(local[i], std::move(tiles[i]));
+      return array;
+    }
+
+  }  // namespace detail
+
+  /// Read an array from a checkpoint file
+
+  /// Each process reads its local tiles, for the process map \c pmap , with
+  /// non-blocking MPI-IO operations, and the tiles are deserialized by
+  /// tasks. The number of processes and the process map may differ from
+  /// those of the array that was written. A sparse array gets its shape from
+  /// the norms of the tiles; a dense array gets zero tiles in place of the
+  /// zero tiles of the file. This is a collective operation.
+  /// \tparam Array The array type
+  /// \param world The world of the array
+  /// \param filename The name of the checkpoint file
+  /// \param pmap The process map of the array [ default = the default
+  /// process map of the array policy ]
+  /// \return The array
+  /// \throw TiledArray::Exception When the file is not a checkpoint file, or
+  /// an MPI-IO operation fails
+  template <typename Array>
+  inline Array read_array(World& world, const std::string& filename,
+      std::shared_ptr<typename Array::pmap_interface> pmap =
+          std::shared_ptr<typename Array::pmap_interface>())
+  {
+    typedef detail::CheckpointFormat::word_type word_type;
+    typedef typename Array::value_type value_type;
+
+    MPI_File file;
+    {
+      SAFE_MPI_GLOBAL_MUTEX;
+      detail::CheckpointFormat::check(MPI_File_open(
+          world.mpi.comm().Get_mpi_comm(), const_cast<char*>(filename.c_str()),
+          MPI_MODE_RDONLY, MPI_INFO_NULL, &file), "MPI_File_open");
+    }
+
+    // Read the header on process 0 and broadcast it
+    std::vector<word_type> header;
+    if(world.rank() == 0) {
+      SAFE_MPI_GLOBAL_MUTEX;
+      word_type prefix[2] = { 0ull, 0ull };
+      detail::CheckpointFormat::check(MPI_File_read_at(file, 0, prefix,
+          sizeof(prefix), MPI_BYTE, MPI_STATUS_IGNORE), "MPI_File_read_at");
+      if(prefix[0] == detail::CheckpointFormat::magic) {
+        header.resize(prefix[1]);
+        detail::CheckpointFormat::check(MPI_File_read_at(file, 0, header.data(),
+            header.size() * sizeof(word_type), MPI_BYTE, MPI_STATUS_IGNORE),
+            "MPI_File_read_at");
+      }
+    }
+    world.gop.broadcast_serializable(header, 0);
+
+    TiledRange trange;
+    std::vector<word_type> sizes;
+    detail::CheckpointFormat::parse_header(header,
+        detail::CheckpointFormat::magic, trange, sizes);
+    const std::vector<MPI_Offset> offsets =
+        detail::CheckpointFormat::offsets(header.size(), sizes);
+
+    if(! pmap)
+      pmap = Array::policy_type::default_pmap(world, sizes.size());
+    TA_USER_ASSERT(pmap->size() == sizes.size(),
+        "TiledArray::read_array(): the process map does not match the tiled range");
+
+    // Read the local tiles
+    std::vector<std::size_t> local;
+    local.reserve(pmap->local_size());
+    for(const std::size_t ord : *pmap)
+      if(sizes[ord])
+        local.push_back(ord);
+
+    std::vector<std::vector<unsigned char> > buffers(local.size());
+    std::vector<MPI_Request> requests;
+    {
+      SAFE_MPI_GLOBAL_MUTEX;
+      const std::size_t chunk = detail::CheckpointFormat::chunk_bytes();
+      for(std::size_t i = 0ul; i < local.size(); ++i) {
+        buffers[i].resize(sizes[local[i]]);
+        for(std::size_t offset = 0ul; offset < buffers[i].size(); offset += chunk) {
+          const int count = std::min(chunk, buffers[i].size() - offset);
+          requests.emplace_back();
+          detail::CheckpointFormat::check(MPI_File_iread_at(file,
+              offsets[local[i]] + offset, buffers[i].data() + offset, count,
+              MPI_BYTE, &requests.back()), "MPI_File_iread_at");
+        }
+      }
+    }
+    world.await([&requests] () -> bool {
+      SAFE_MPI_GLOBAL_MUTEX;
+      int flag = 0;
+      detail::CheckpointFormat::check(MPI_Testall(requests.size(),
+          requests.data(), &flag, MPI_STATUSES_IGNORE), "MPI_Testall");
+      return flag;
+    });
+    {
+      SAFE_MPI_GLOBAL_MUTEX;
+      detail::CheckpointFormat::check(MPI_File_close(&file), "MPI_File_close");
+    }
+
+    // Deserialize the tiles and compute their norms
+    std::vector<value_type> tiles(local.size());
+    TiledArray::Tensor<float> tile_norms(trange.tiles_range(), 0.0f);
+    madness::AtomicInt counter; counter = 0;
+    auto task = [&buffers,&tiles,&tile_norms,&local,&counter] (const std::size_t i) {
+      madness::archive::VectorInputArchive ar(buffers[i]);
+      ar & tiles[i];
+      tile_norms[local[i]] = tiles[i].norm();
+      std::vector<unsigned char>().swap(buffers[i]);
+      ++counter;
+    };
+    for(std::size_t i = 0ul; i < local.size(); ++i)
+      world.taskq.add(task, i);
+    const int task_count = local.size();
+    if(task_count > 0)
+      world.await([&counter,task_count] () -> bool { return counter == task_count; });
+
+    return detail::make_checkpoint_array(world, trange, pmap, local, tiles,
+        tile_norms, false);
+  }
+
+  /// Write an array to a file that can be mapped into memory
+
+  /// The file has the layout of checkpoint files, but the tiles hold the
+  /// elements as they are stored in memory, at aligned offsets, and the
+  /// header holds the tile norms, so the array can be mapped into memory
+  /// with \c map_array() . This is a collective operation; it returns once
+  /// the writes are started, and the write completes with
+  /// <tt>CheckpointWrite::wait()</tt> .
+  /// \tparam T The element type of the tiles
+  /// \tparam A The allocator type of the tiles
+  /// \tparam Policy The policy type of the array
+  /// \param array The array to be written
+  /// \param filename The name of the file
+  /// \return The pending write
+  /// \throw TiledArray::Exception When an MPI-IO operation fails
+  template <typename T, typename A, typename Policy>
+  inline CheckpointWrite
+  write_mapped_array(const DistArray<Tensor<T, A>, Policy>& array,
+      const std::string& filename)
+  {
+    static_assert(std::is_scalar<T>::value,
+        "TiledArray::write_mapped_array(): the tile elements must be scalars");
+    typedef detail::CheckpointFormat::word_type word_type;
+    typedef Tensor<T, A> tile_type;
+
+    World& world = array.world();
+    const std::size_t ntiles = array.trange().tiles_range().volume();
+
+    std::vector<std::size_t> local;
+    local.reserve(array.pmap()->local_size());
+    for(const std::size_t ord : *array.pmap())
+      if(! array.is_zero(ord))
+        local.push_back(ord);
+
+    // Collect the local tiles and their norms
+    auto tiles = std::make_shared<std::vector<tile_type> >(local.size());
+    std::vector<double> norms(ntiles, 0.0);
+    madness::AtomicInt counter; counter = 0;
+    std::vector<tile_type>& local_tiles = *tiles;
+    auto task = [&local_tiles,&norms,&counter] (const std::size_t i,
+        const std::size_t ord, const tile_type& tile)
+    {
+      local_tiles[i] = tile;
+      norms[ord] = tile.norm();
+      ++counter;
+    };
+    for(std::size_t i = 0ul; i < local.size(); ++i)
+      world.taskq.add(task, i, local[i], array.find(local[i]));
+    const int task_count = local.size();
+    if(task_count > 0)
+      world.await([&counter,task_count] () -> bool { return counter == task_count; });
+
+    // Collect the tile index and the norms
+    std::vector<word_type> sizes(ntiles, 0ull);
+    for(std::size_t i = 0ul; i < local.size(); ++i)
+      sizes[local[i]] = detail::CheckpointFormat::align(local_tiles[i].size() * sizeof(T));
+    world.gop.sum(sizes.data(), ntiles);
+    world.gop.sum(norms.data(), ntiles);
+
+    std::vector<word_type> extra(ntiles + 1ul);
+    extra[0] = sizeof(T);
+    std::memcpy(extra.data() + 1, norms.data(), ntiles * sizeof(double));
+
+    const std::vector<word_type> header =
+        detail::CheckpointFormat::make_header(detail::CheckpointFormat::raw_magic,
+            array.trange(), sizes, extra);
+    const std::vector<MPI_Offset> offsets =
+        detail::CheckpointFormat::offsets(header.size(), sizes);
+
+    // Start the writes, directly from the tile data
+    std::vector<detail::CheckpointBlock> blocks;
+    blocks.reserve(local.size());
+    for(std::size_t i = 0ul; i < local.size(); ++i)
+      blocks.push_back(detail::CheckpointBlock{ offsets[local[i]],
+          reinterpret_cast<const char*>(local_tiles[i].data()),
+          local_tiles[i].size() * sizeof(T) });
+
+    return detail::start_checkpoint_write(world, filename, header, offsets,
+        sizes, blocks, std::move(tiles));
+  }
+
+  namespace detail {
+
+    /// Map a file into memory
+
+    /// The file is mapped privately: the pages are shared with the page
+    /// cache until they are modified, and modifications are not written to
+    /// the file.
+    /// \param filename The name of the file
+    /// \param[out] bytes The size of the file
+    /// \return The owner of the mapping, which points to its first byte
+    /// \throw TiledArray::Exception When the file cannot be mapped
+    inline std::shared_ptr<void> map_file(const std::string& filename, std::size_t& bytes) {
+      const int fd = ::open(filename.c_str(), O_RDONLY);
+      if(fd < 0)
+        TA_EXCEPTION("Unable to open the mapped array file");
+      struct stat status;
+      if((::fstat(fd, &status) != 0) || (status.st_size <= 0)) {
+        ::close(fd);
+        TA_EXCEPTION("Unable to map the mapped array file");
+      }
+      bytes = status.st_size;
+      void* const address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+          MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if(address == MAP_FAILED)
+        TA_EXCEPTION("Unable to map the mapped array file");
+
+      const std::size_t size = bytes;
+      return std::shared_ptr<void>(address,
+          [size] (void* p) { ::munmap(p, size); });
+    }
+
+  }  // namespace detail
+
+  /// Map an array file into memory
+
+  /// Each process maps the file written by \c write_mapped_array() , and
+  /// its local tiles, for the process map \c pmap , are \c Tensor views of
+  /// the mapped pages: the tile data is not copied, and it is read by the
+  /// operating system when it is used, and kept in the page cache, which is
+  /// shared by the processes of a node. The mapping is released with the
+  /// last tile. A sparse array gets its shape from the norms in the file
+  /// header, so the tiles are not read at startup. The array is meant to be
+  /// read; modifications of its tiles are private to the process and are
+  /// not written to the file. This is a collective operation.
+  /// \tparam Array The array type, with \c Tensor tiles
+  /// \param world The world of the array
+  /// \param filename The name of the file
+  /// \param pmap The process map of the array [ default = the default
+  /// process map of the array policy ]
+  /// \return The array
+  /// \throw TiledArray::Exception When the file is not a mapped array file
+  /// for the tile type of \c Array , or it cannot be mapped
+  template <typename Array>
+  inline Array map_array(World& world, const std::string& filename,
+      std::shared_ptr<typename Array::pmap_interface> pmap =
+          std::shared_ptr<typename Array::pmap_interface>())
+  {
+    typedef detail::CheckpointFormat::word_type word_type;
+    typedef typename Array::value_type value_type;
+    typedef typename value_type::value_type element_type;
+
+    std::size_t bytes = 0ul;
+    const std::shared_ptr<void> mapping = detail::map_file(filename, bytes);
+    const word_type* const words = static_cast<const word_type*>(mapping.get());
+    if((bytes < 2ul * sizeof(word_type)) ||
+        (words[0] != detail::CheckpointFormat::raw_magic) ||
+        (words[1] > bytes / sizeof(word_type)))
+      TA_EXCEPTION("Invalid mapped array file");
+
+    TiledRange trange;
+    std::vector<word_type> sizes, extra;
+    detail::CheckpointFormat::parse_header(
+        std::vector<word_type>(words, words + words[1]),
+        detail::CheckpointFormat::raw_magic, trange, sizes, &extra);
+    if((extra.size() < sizes.size() + 1ul) || (extra[0] != sizeof(element_type)))
+      TA_EXCEPTION("The mapped array file does not match the tile type");
+    const std::vector<MPI_Offset> offsets =
+        detail::CheckpointFormat::offsets(words[1], sizes);
+    if(! sizes.empty() && (std::size_t(offsets.back()) + sizes.back() > bytes))
+      TA_EXCEPTION("The mapped array file is truncated");
+
+    TiledArray::Tensor<float> tile_norms(trange.tiles_range(), 0.0f);
+    for(std::size_t i = 0ul; i < sizes.size(); ++i) {
+      double norm = 0.0;
+      std::memcpy(&norm, extra.data() + 1ul + i, sizeof(double));
+      tile_norms[i] = norm;
+    }
+
+    if(! pmap)
+      pmap = Array::policy_type::default_pmap(world, sizes.size());
+    TA_USER_ASSERT(pmap->size() == sizes.size(),
+        "TiledArray::map_array(): the process map does not match the tiled range");
+
+    // Make views of the local tiles
+    char* const base = static_cast<char*>(mapping.get());
+    std::vector<std::size_t> local;
+    std::vector<value_type> tiles;
+    local.reserve(pmap->local_size());
+    tiles.reserve(pmap->local_size());
+    for(const std::size_t ord : *pmap) {
+      if(sizes[ord]) {
+        local.push_back(ord);
+        tiles.emplace_back(trange.make_tile_range(ord), mapping,
+            reinterpret_cast<element_type*>(base + offsets[ord]));
+      }
+    }
+
+    return detail::make_checkpoint_array(world, trange, pmap, local, tiles,
+        tile_norms, true);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CHECKPOINT_H__INCLUDED
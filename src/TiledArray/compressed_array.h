@@ -0,0 +1,253 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  compressed_array.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_COMPRESSED_ARRAY_H__INCLUDED
+#define TILEDARRAY_COMPRESSED_ARRAY_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/error.h>
+#include <TiledArray/tensor/compression.h>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+
+  /// An array that is held compressed in memory
+
+  /// The local tiles of an array that is rarely used, e.g. the history
+  /// vectors of \c DIIS , are compressed at rest with the encoding of
+  /// \c TensorCompression , and are decompressed when the array is
+  /// accessed with \c get() . The \c lossless mode keeps the exact data;
+  /// the \c lossy mode also drops the elements whose magnitude is below a
+  /// tolerance, which bounds the absolute error of each element. A tile is
+  /// kept uncompressed when encoding it does not reduce its size. In
+  /// \c none mode the array itself is held.
+  /// \tparam Tile The tile type, e.g. \c Tensor<double> , whose elements are
+  /// arithmetic or complex
+  /// \tparam Policy The policy type of the array
+  template <typename Tile, typename Policy>
+  class CompressedArray {
+  public:
+    typedef CompressedArray<Tile, Policy> CompressedArray_; ///< This object type
+    typedef DistArray<Tile, Policy> array_type; ///< The array type
+    typedef typename array_type::size_type size_type; ///< Size type
+    typedef typename array_type::shape_type shape_type; ///< Shape type
+    typedef typename array_type::pmap_interface pmap_interface; ///< Process map type
+    typedef typename Tile::value_type value_type; ///< The element type
+    typedef detail::scalar_t<value_type> scalar_type; ///< The type of the element components
+
+    static_assert(std::is_arithmetic<scalar_type>::value,
+        "TiledArray::CompressedArray: the tile elements must be arithmetic or complex");
+
+  private:
+
+    /// The compressed data of a tile
+    struct Code {
+      bool encoded = false; ///< \c true if \c bytes holds the encoded data
+      std::vector<unsigned char> bytes; ///< The tile data
+    }; // struct Code
+
+    typedef std::shared_ptr<const Code> code_ptr; ///< Shared tile data
+
+    World* world_; ///< The world of the array
+    TiledRange trange_; ///< The tiled range of the array
+    shape_type shape_; ///< The shape of the array
+    std::shared_ptr<pmap_interface> pmap_; ///< The process map of the array
+    TensorCompression::Mode mode_; ///< The compression mode
+    array_type array_; ///< The array, held in \c none mode
+    std::vector<std::pair<size_type, code_ptr> > tiles_; ///< The compressed local tiles
+
+    /// The number of components of the elements of a tile
+    static std::size_t components(const Tile& tile) {
+      return tile.size() * (sizeof(value_type) / sizeof(scalar_type));
+    }
+
+    /// Compress a tile
+
+    /// \param tile The tile
+    /// \param tolerance Elements with a magnitude less than \c tolerance are
+    /// set to zero
+    /// \return The compressed data of \c tile
+    static code_ptr encode_tile(const Tile& tile, const scalar_type tolerance) {
+      const std::size_t n = components(tile);
+      const scalar_type* const data = reinterpret_cast<const scalar_type*>(tile.data());
+      std::shared_ptr<Code> code = std::make_shared<Code>();
+      code->bytes = detail::shuffle_encode(data, n, tolerance);
+      code->encoded = (code->bytes.size() < n * sizeof(scalar_type));
+      if(! code->encoded) {
+        const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(data);
+        code->bytes.assign(bytes, bytes + n * sizeof(scalar_type));
+      }
+      code->bytes.shrink_to_fit();
+      return code;
+    }
+
+    /// Decompress a tile
+
+    /// \param range The range of the tile
+    /// \param code The compressed data of the tile
+    /// \return The tile
+    static Tile decode_tile(const typename Tile::range_type& range, const code_ptr& code) {
+      Tile tile(range);
+      const std::size_t n = components(tile);
+      scalar_type* const data = reinterpret_cast<scalar_type*>(tile.data());
+      if(code->encoded)
+        detail::shuffle_decode(code->bytes.data(), code->bytes.size(), data, n);
+      else
+        std::memcpy(data, code->bytes.data(), n * sizeof(scalar_type));
+      return tile;
+    }
+
+  public:
+
+    /// Construct an empty compressed array
+    CompressedArray() :
+      world_(nullptr), trange_(), shape_(), pmap_(),
+      mode_(TensorCompression::none), array_(), tiles_()
+    { }
+
+    CompressedArray(const CompressedArray_&) = default;
+    CompressedArray(CompressedArray_&&) = default;
+    CompressedArray_& operator=(const CompressedArray_&) = default;
+    CompressedArray_& operator=(CompressedArray_&&) = default;
+
+    /// Compress an array
+
+    /// The local tiles of \c array are compressed by tasks, and this
+    /// function blocks until they are compressed; it does not communicate.
+    /// \param array The array
+    /// \param mode The compression mode
+    /// \param tolerance Elements with a magnitude less than \c tolerance are
+    /// set to zero in \c lossy mode [ default = 0 ]
+    CompressedArray(const array_type& array, const TensorCompression::Mode mode,
+        const double tolerance = 0.0) :
+      world_(& array.world()), trange_(array.trange()), shape_(array.shape()),
+      pmap_(array.pmap()), mode_(mode), array_(), tiles_()
+    {
+      TA_ASSERT(tolerance >= 0.0);
+      if(mode_ == TensorCompression::none) {
+        array_ = array;
+        return;
+      }
+
+      const scalar_type drop = (mode_ == TensorCompression::lossy ?
+          scalar_type(tolerance) : scalar_type(0));
+      std::vector<std::pair<size_type, Future<code_ptr> > > codes;
+      for(const auto index : *pmap_) {
+        if(shape_.is_zero(index))
+          continue;
+        codes.emplace_back(index, world_->taskq.add(& CompressedArray_::encode_tile,
+            array.find(index), drop));
+      }
+
+      tiles_.reserve(codes.size());
+      for(auto& code : codes)
+        tiles_.emplace_back(code.first, code.second.get());
+    }
+
+    /// Check that the array is empty
+
+    /// \return \c true if this object holds no array
+    bool empty() const { return world_ == nullptr; }
+
+    /// Compression mode accessor
+
+    /// \return The compression mode
+    TensorCompression::Mode mode() const { return mode_; }
+
+    /// The uncompressed array
+
+    /// \return A pointer to the array held in \c none mode, or a null pointer
+    /// if the array is compressed
+    const array_type* uncompressed() const {
+      return (mode_ == TensorCompression::none ? & array_ : nullptr);
+    }
+
+    /// Decompress the array
+
+    /// The tiles are decompressed by tasks. Like the construction of a
+    /// \c DistArray , this must be done in the same order on all processes.
+    /// \return The array
+    array_type get() const {
+      TA_ASSERT(! empty());
+      if(mode_ == TensorCompression::none)
+        return array_;
+
+      array_type result(*world_, trange_, shape_, pmap_);
+      for(const auto& tile : tiles_)
+        result.set(tile.first, world_->taskq.add(& CompressedArray_::decode_tile,
+            trange_.make_tile_range(tile.first), tile.second));
+      return result;
+    }
+
+    /// The memory held by the local tiles
+
+    /// \return The size of the local tile data of this process, in bytes
+    std::size_t bytes() const {
+      if(mode_ == TensorCompression::none)
+        return uncompressed_bytes();
+      std::size_t result = 0ul;
+      for(const auto& tile : tiles_)
+        result += tile.second->bytes.size();
+      return result;
+    }
+
+    /// The uncompressed size of the local tiles
+
+    /// \return The size of the local tiles of this process, uncompressed, in
+    /// bytes
+    std::size_t uncompressed_bytes() const {
+      if(empty())
+        return 0ul;
+      std::size_t result = 0ul;
+      for(const auto index : *pmap_)
+        if(! shape_.is_zero(index))
+          result += trange_.make_tile_range(index).volume() * sizeof(value_type);
+      return result;
+    }
+
+  }; // class CompressedArray
+
+  /// Compress an array
+
+  /// \tparam Tile The tile type of the array
+  /// \tparam Policy The policy type of the array
+  /// \param array The array
+  /// \param mode The compression mode [ default = \c lossless ]
+  /// \param tolerance Elements with a magnitude less than \c tolerance are
+  /// set to zero in \c lossy mode [ default = 0 ]
+  /// \return The compressed array
+  template <typename Tile, typename Policy>
+  inline CompressedArray<Tile, Policy>
+  make_compressed(const DistArray<Tile, Policy>& array,
+      const TensorCompression::Mode mode = TensorCompression::lossless,
+      const double tolerance = 0.0)
+  {
+    return CompressedArray<Tile, Policy>(array, mode, tolerance);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_COMPRESSED_ARRAY_H__INCLUDED
@@ -0,0 +1,545 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_COMPRESSED_NORMS_H__INCLUDED
+#define TILEDARRAY_COMPRESSED_NORMS_H__INCLUDED
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <TiledArray/tensor.h>
+#include <TiledArray/perm_index.h>
+#include <TiledArray/math/gemm_helper.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Compressed tile norms
+
+    /// Only the non-zero norms are stored, as a list of ordinal indices in
+    /// increasing order and the matching norm values, so memory and the work
+    /// of the norm algebra scale with the number of non-zero tiles instead of
+    /// the volume of the tile range. A look-up is a binary search.
+    /// Operations that produce zero norms drop them from the result.
+    /// Objects are immutable once constructed, and are shared by
+    /// \c SparseShape objects.
+    /// \tparam T The norm value type
+    template <typename T>
+    class CompressedNorms {
+    public:
+      typedef CompressedNorms<T> CompressedNorms_; ///< This object type
+      typedef T value_type; ///< The norm value type
+      typedef Range::size_type size_type; ///< Size type
+
+    private:
+      Range range_; ///< The tile range
+      std::vector<size_type> ordinals_; ///< The ordinal indices of the non-zero norms, in increasing order
+      std::vector<value_type> values_; ///< The non-zero norms
+      mutable std::mutex mutex_; ///< Protects \c dense_
+      mutable Tensor<value_type> dense_; ///< The dense norms, constructed on first use
+
+      /// Sort the norms by ordinal index
+
+      /// When an ordinal index is repeated, the last of its norms is kept.
+      void sort() {
+        if(std::adjacent_find(ordinals_.begin(), ordinals_.end(),
+            std::greater_equal<size_type>()) == ordinals_.end())
+          return;
+
+        std::vector<size_type> order(ordinals_.size());
+        std::iota(order.begin(), order.end(), size_type(0));
+        std::stable_sort(order.begin(), order.end(),
+            [this] (const size_type l, const size_type r)
+            { return ordinals_[l] < ordinals_[r]; });
+
+        std::vector<size_type> ordinals;
+        std::vector<value_type> values;
+        ordinals.reserve(order.size());
+        values.reserve(order.size());
+        for(const size_type i : order) {
+          if(! ordinals.empty() && (ordinals.back() == ordinals_[i])) {
+            values.back() = values_[i];
+          } else {
+            ordinals.push_back(ordinals_[i]);
+            values.push_back(values_[i]);
+          }
+        }
+        ordinals_.swap(ordinals);
+        values_.swap(values);
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param range The tile range
+      /// \param ordinals The ordinal indices of the non-zero norms
+      /// \param values The non-zero norms
+      CompressedNorms(const Range& range, std::vector<size_type> ordinals,
+          std::vector<value_type> values) :
+        range_(range), ordinals_(std::move(ordinals)), values_(std::move(values)),
+        mutex_(), dense_()
+      {
+        TA_ASSERT(ordinals_.size() == values_.size());
+        sort();
+      }
+
+      /// Compress dense norms
+
+      /// \param norms The dense norms; zero norms are not stored
+      explicit CompressedNorms(const Tensor<value_type>& norms) :
+        range_(norms.range()), ordinals_(), values_(), mutex_(), dense_()
+      {
+        const size_type volume = norms.range().volume();
+        for(size_type i = 0ul; i < volume; ++i) {
+          const value_type value = norms[i];
+          if(value != value_type(0)) {
+            ordinals_.push_back(i);
+            values_.push_back(value);
+          }
+        }
+      }
+
+      CompressedNorms(const CompressedNorms_&) = delete;
+      CompressedNorms_& operator=(const CompressedNorms_&) = delete;
+
+      /// Range accessor
+
+      /// \return The tile range
+      const Range& range() const { return range_; }
+
+      /// Non-zero count accessor
+
+      /// \return The number of non-zero norms
+      size_type size() const { return ordinals_.size(); }
+
+      /// Ordinal index accessor
+
+      /// \return The ordinal indices of the non-zero norms, in increasing order
+      const std::vector<size_type>& ordinals() const { return ordinals_; }
+
+      /// Value accessor
+
+      /// \return The non-zero norms
+      const std::vector<value_type>& values() const { return values_; }
+
+      /// Norm accessor
+
+      /// \param ordinal The ordinal index of a tile
+      /// \return The norm of the tile at \c ordinal , or zero
+      value_type operator[](const size_type ordinal) const {
+        TA_ASSERT(range_.includes(ordinal));
+        const auto it = std::lower_bound(ordinals_.begin(), ordinals_.end(), ordinal);
+        if((it == ordinals_.end()) || (*it != ordinal))
+          return value_type(0);
+        return values_[it - ordinals_.begin()];
+      }
+
+      /// Uncompress the norms
+
+      /// \return A new tensor with the norms of all tiles
+      Tensor<value_type> to_tensor() const {
+        Tensor<value_type> result(range_, value_type(0));
+        for(size_type i = 0ul; i < ordinals_.size(); ++i)
+          result[ordinals_[i]] = values_[i];
+        return result;
+      }
+
+      /// Dense norm accessor
+
+      /// The dense norms are constructed on the first call, and held by this
+      /// object, so they use memory proportional to the volume of the tile
+      /// range.
+      /// \return The norms of all tiles
+      const Tensor<value_type>& dense() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(dense_.empty())
+          dense_ = to_tensor();
+        return dense_;
+      }
+
+      /// Apply an operation to the non-zero norms
+
+      /// \tparam Op The operation type
+      /// \param op The operation, <tt>op(value, ordinal)</tt> returns the
+      /// result norm, where zero results are dropped
+      /// \return The result norms
+      template <typename Op>
+      std::shared_ptr<const CompressedNorms_> unary(const Op& op) const {
+        std::vector<size_type> ordinals;
+        std::vector<value_type> values;
+        ordinals.reserve(ordinals_.size());
+        values.reserve(ordinals_.size());
+        for(size_type i = 0ul; i < ordinals_.size(); ++i) {
+          const value_type value = op(values_[i], ordinals_[i]);
+          if(value != value_type(0)) {
+            ordinals.push_back(ordinals_[i]);
+            values.push_back(value);
+          }
+        }
+        return std::make_shared<CompressedNorms_>(range_,
+            std::move(ordinals), std::move(values));
+      }
+
+      /// Combine the norms of the tiles that are non-zero in either argument
+
+      /// \tparam Op The operation type
+      /// \param other The right-hand norms
+      /// \param op The operation, <tt>op(left, right)</tt> returns the result
+      /// norm, where a missing norm is zero and zero results are dropped
+      /// \return The result norms
+      template <typename Op>
+      std::shared_ptr<const CompressedNorms_>
+      binary_union(const CompressedNorms_& other, const Op& op) const {
+        TA_ASSERT(range_ == other.range_);
+        std::vector<size_type> ordinals;
+        std::vector<value_type> values;
+        ordinals.reserve(std::max(ordinals_.size(), other.ordinals_.size()));
+        values.reserve(ordinals.capacity());
+
+        auto push = [&] (const size_type ordinal, const value_type value) {
+          if(value != value_type(0)) {
+            ordinals.push_back(ordinal);
+            values.push_back(value);
+          }
+        };
+
+        size_type l = 0ul, r = 0ul;
+        while((l < ordinals_.size()) && (r < other.ordinals_.size())) {
+          if(ordinals_[l] < other.ordinals_[r]) {
+            push(ordinals_[l], op(values_[l], value_type(0)));
+            ++l;
+          } else if(other.ordinals_[r] < ordinals_[l]) {
+            push(other.ordinals_[r], op(value_type(0), other.values_[r]));
+            ++r;
+          } else {
+            push(ordinals_[l], op(values_[l], other.values_[r]));
+            ++l;
+            ++r;
+          }
+        }
+        for(; l < ordinals_.size(); ++l)
+          push(ordinals_[l], op(values_[l], value_type(0)));
+        for(; r < other.ordinals_.size(); ++r)
+          push(other.ordinals_[r], op(value_type(0), other.values_[r]));
+
+        return std::make_shared<CompressedNorms_>(range_,
+            std::move(ordinals), std::move(values));
+      }
+
+      /// Combine the norms of the tiles that are non-zero in both arguments
+
+      /// \tparam Op The operation type
+      /// \param other The right-hand norms
+      /// \param op The operation, <tt>op(left, right, ordinal)</tt> returns
+      /// the result norm, where zero results are dropped
+      /// \return The result norms
+      template <typename Op>
+      std::shared_ptr<const CompressedNorms_>
+      binary_intersection(const CompressedNorms_& other, const Op& op) const {
+        TA_ASSERT(range_ == other.range_);
+        std::vector<size_type> ordinals;
+        std::vector<value_type> values;
+
+        size_type l = 0ul, r = 0ul;
+        while((l < ordinals_.size()) && (r < other.ordinals_.size())) {
+          if(ordinals_[l] < other.ordinals_[r]) {
+            ++l;
+          } else if(other.ordinals_[r] < ordinals_[l]) {
+            ++r;
+          } else {
+            const value_type value = op(values_[l], other.values_[r], ordinals_[l]);
+            if(value != value_type(0)) {
+              ordinals.push_back(ordinals_[l]);
+              values.push_back(value);
+            }
+            ++l;
+            ++r;
+          }
+        }
+
+        return std::make_shared<CompressedNorms_>(range_,
+            std::move(ordinals), std::move(values));
+      }
+
+      /// Permute the norms
+
+      /// \param perm The permutation
+      /// \return The permuted norms
+      std::shared_ptr<const CompressedNorms_> permute(const Permutation& perm) const {
+        const PermIndex perm_index(range_, perm);
+        std::vector<size_type> ordinals;
+        ordinals.reserve(ordinals_.size());
+        for(const size_type ordinal : ordinals_)
+          ordinals.push_back(perm_index(ordinal));
+
+        return std::make_shared<CompressedNorms_>(perm * range_,
+            std::move(ordinals), values_);
+      }
+
+      /// Copy the norms of a sub-block
+
+      /// The result range has the extent of the block and a zero lower bound.
+      /// \tparam Index The bound index type
+      /// \param lower_bound The lower bound of the sub-block
+      /// \param upper_bound The upper bound of the sub-block
+      /// \return The norms of the sub-block
+      template <typename Index>
+      std::shared_ptr<const CompressedNorms_>
+      block(const Index& lower_bound, const Index& upper_bound) const {
+        const unsigned int rank = range_.rank();
+        TA_ASSERT(detail::size(lower_bound) == rank);
+        TA_ASSERT(detail::size(upper_bound) == rank);
+        const auto* MADNESS_RESTRICT const lower = detail::data(lower_bound);
+        const auto* MADNESS_RESTRICT const upper = detail::data(upper_bound);
+        const auto* MADNESS_RESTRICT const lobound = range_.lobound_data();
+        const auto* MADNESS_RESTRICT const extent = range_.extent_data();
+        const auto* MADNESS_RESTRICT const stride = range_.stride_data();
+
+        std::vector<size_type> block_extent(rank);
+        for(unsigned int d = 0u; d < rank; ++d)
+          block_extent[d] = upper[d] - lower[d];
+        Range block_range(block_extent);
+        const auto* MADNESS_RESTRICT const block_stride = block_range.stride_data();
+
+        std::vector<size_type> ordinals;
+        std::vector<value_type> values;
+        for(size_type i = 0ul; i < ordinals_.size(); ++i) {
+          size_type ordinal = 0ul;
+          bool included = true;
+          for(unsigned int d = 0u; included && (d < rank); ++d) {
+            const size_type index_d = lobound[d] + (ordinals_[i] / stride[d]) % extent[d];
+            included = (index_d >= size_type(lower[d])) && (index_d < size_type(upper[d]));
+            ordinal += (index_d - lower[d]) * block_stride[d];
+          }
+          if(included) {
+            ordinals.push_back(ordinal);
+            values.push_back(values_[i]);
+          }
+        }
+
+        return std::make_shared<CompressedNorms_>(block_range,
+            std::move(ordinals), std::move(values));
+      }
+
+      /// Replace the norms of a sub-block
+
+      /// \tparam Index The bound index type
+      /// \param lower_bound The lower bound of the sub-block
+      /// \param upper_bound The upper bound of the sub-block
+      /// \param other The norms of the sub-block, with the extent of the block
+      /// \return A copy of these norms, where the sub-block contains \c other
+      template <typename Index>
+      std::shared_ptr<const CompressedNorms_>
+      update_block(const Index& lower_bound, const Index& upper_bound,
+          const CompressedNorms_& other) const
+      {
+        const unsigned int rank = range_.rank();
+        TA_ASSERT(other.range_.rank() == rank);
+        const auto* MADNESS_RESTRICT const lower = detail::data(lower_bound);
+        const auto* MADNESS_RESTRICT const upper = detail::data(upper_bound);
+        const auto* MADNESS_RESTRICT const lobound = range_.lobound_data();
+        const auto* MADNESS_RESTRICT const extent = range_.extent_data();
+        const auto* MADNESS_RESTRICT const stride = range_.stride_data();
+        const auto* MADNESS_RESTRICT const other_extent = other.range_.extent_data();
+        const auto* MADNESS_RESTRICT const other_stride = other.range_.stride_data();
+
+        std::vector<size_type> ordinals;
+        std::vector<value_type> values;
+        ordinals.reserve(ordinals_.size() + other.ordinals_.size());
+        values.reserve(ordinals.capacity());
+
+        // Keep the norms outside of the block
+        for(size_type i = 0ul; i < ordinals_.size(); ++i) {
+          bool included = true;
+          for(unsigned int d = 0u; included && (d < rank); ++d) {
+            const size_type index_d = lobound[d] + (ordinals_[i] / stride[d]) % extent[d];
+            included = (index_d >= size_type(lower[d])) && (index_d < size_type(upper[d]));
+          }
+          if(! included) {
+            ordinals.push_back(ordinals_[i]);
+            values.push_back(values_[i]);
+          }
+        }
+
+        // Insert the norms of the block
+        for(size_type i = 0ul; i < other.ordinals_.size(); ++i) {
+          size_type ordinal = 0ul;
+          for(unsigned int d = 0u; d < rank; ++d) {
+            const size_type index_d = lower[d]
+                + (other.ordinals_[i] / other_stride[d]) % other_extent[d];
+            ordinal += (index_d - lobound[d]) * stride[d];
+          }
+          ordinals.push_back(ordinal);
+          values.push_back(other.values_[i]);
+        }
+
+        return std::make_shared<CompressedNorms_>(range_,
+            std::move(ordinals), std::move(values));
+      }
+
+      /// Replace the norms of a set of tiles
+
+      /// \param ordinals The ordinal indices of the tiles, in increasing order
+      /// \param values The new norms of the tiles, where a zero norm removes
+      /// the tile
+      /// \return A copy of these norms, where the norms of \c ordinals are
+      /// replaced by \c values
+      std::shared_ptr<const CompressedNorms_>
+      update(const std::vector<size_type>& ordinals,
+          const std::vector<value_type>& values) const
+      {
+        TA_ASSERT(ordinals.size() == values.size());
+        TA_ASSERT(std::is_sorted(ordinals.begin(), ordinals.end()));
+
+        std::vector<size_type> result_ordinals;
+        std::vector<value_type> result_values;
+        result_ordinals.reserve(ordinals_.size() + ordinals.size());
+        result_values.reserve(result_ordinals.capacity());
+
+        // Merge the sorted norms, where the new norms take precedence
+        size_type i = 0ul, j = 0ul;
+        while((i < ordinals_.size()) || (j < ordinals.size())) {
+          if((j == ordinals.size()) ||
+              ((i < ordinals_.size()) && (ordinals_[i] < ordinals[j]))) {
+            result_ordinals.push_back(ordinals_[i]);
+            result_values.push_back(values_[i]);
+            ++i;
+          } else {
+            TA_ASSERT(ordinals[j] < range_.volume());
+            if((i < ordinals_.size()) && (ordinals_[i] == ordinals[j]))
+              ++i;
+            if(values[j] != value_type(0)) {
+              result_ordinals.push_back(ordinals[j]);
+              result_values.push_back(values[j]);
+            }
+            ++j;
+          }
+        }
+
+        return std::make_shared<CompressedNorms_>(range_,
+            std::move(result_ordinals), std::move(result_values));
+      }
+
+      /// Contract norms
+
+      /// Computes the matrix product of the norms, where this object is the
+      /// left-hand argument, as defined by \c gemm_helper . Each product of a
+      /// left and right norm with inner index \c k is scaled by
+      /// <tt>k_scale[k] * k_scale[k]</tt> . Only the pairs of non-zero norms
+      /// are visited, and a dense accumulator for a single row of the result
+      /// is used.
+      /// \param other The right-hand norms
+      /// \param gemm_helper The contraction helper
+      /// \param k_scale The scaling factors of the inner index, or empty if
+      /// there is no scaling
+      /// \param factor The scaling factor of the result
+      /// \param threshold Result norms less than this value are dropped
+      /// \return The result norms
+      std::shared_ptr<const CompressedNorms_>
+      gemm(const CompressedNorms_& other, const math::GemmHelper& gemm_helper,
+          const std::vector<value_type>& k_scale, const value_type factor,
+          const value_type threshold) const
+      {
+        integer M = 0, N = 0, K = 0;
+        gemm_helper.compute_matrix_sizes(M, N, K, range_, other.range_);
+        TA_ASSERT(k_scale.empty() || (k_scale.size() == size_type(K)));
+        const bool left_trans = (gemm_helper.left_op() != madness::cblas::NoTrans);
+        const bool right_trans = (gemm_helper.right_op() != madness::cblas::NoTrans);
+
+        // Bucket the left norms by row (m) and the right norms by row (k)
+        std::vector<size_type> left_ptr(M + 1, 0ul), right_ptr(K + 1, 0ul);
+        for(const size_type ordinal : ordinals_)
+          ++left_ptr[(left_trans ? ordinal % M : ordinal / K) + 1];
+        for(const size_type ordinal : other.ordinals_)
+          ++right_ptr[(right_trans ? ordinal % K : ordinal / N) + 1];
+        std::partial_sum(left_ptr.begin(), left_ptr.end(), left_ptr.begin());
+        std::partial_sum(right_ptr.begin(), right_ptr.end(), right_ptr.begin());
+
+        std::vector<std::pair<size_type, value_type> > left(ordinals_.size());
+        {
+          std::vector<size_type> next(left_ptr.begin(), left_ptr.end() - 1);
+          for(size_type i = 0ul; i < ordinals_.size(); ++i) {
+            const size_type ordinal = ordinals_[i];
+            const size_type m = (left_trans ? ordinal % M : ordinal / K);
+            const size_type k = (left_trans ? ordinal / M : ordinal % K);
+            left[next[m]++] = std::make_pair(k,
+                values_[i] * (k_scale.empty() ? value_type(1) : k_scale[k]));
+          }
+        }
+        std::vector<std::pair<size_type, value_type> > right(other.ordinals_.size());
+        {
+          std::vector<size_type> next(right_ptr.begin(), right_ptr.end() - 1);
+          for(size_type i = 0ul; i < other.ordinals_.size(); ++i) {
+            const size_type ordinal = other.ordinals_[i];
+            const size_type k = (right_trans ? ordinal % K : ordinal / N);
+            const size_type n = (right_trans ? ordinal / K : ordinal % N);
+            right[next[k]++] = std::make_pair(n,
+                other.values_[i] * (k_scale.empty() ? value_type(1) : k_scale[k]));
+          }
+        }
+
+        // Accumulate each row of the result
+        std::vector<size_type> ordinals;
+        std::vector<value_type> values;
+        std::vector<value_type> accumulator(N, value_type(0));
+        std::vector<char> touched(N, 0);
+        std::vector<size_type> columns;
+        for(integer m = 0; m < M; ++m) {
+          for(size_type l = left_ptr[m]; l < left_ptr[m + 1]; ++l) {
+            const size_type k = left[l].first;
+            const value_type left_value = left[l].second;
+            for(size_type r = right_ptr[k]; r < right_ptr[k + 1]; ++r) {
+              const size_type n = right[r].first;
+              accumulator[n] += left_value * right[r].second;
+              if(! touched[n]) {
+                touched[n] = 1;
+                columns.push_back(n);
+              }
+            }
+          }
+
+          std::sort(columns.begin(), columns.end());
+          for(const size_type n : columns) {
+            const value_type value = accumulator[n] * factor;
+            if((value >= threshold) && (value != value_type(0))) {
+              ordinals.push_back(m * N + n);
+              values.push_back(value);
+            }
+            accumulator[n] = value_type(0);
+            touched[n] = 0;
+          }
+          columns.clear();
+        }
+
+        return std::make_shared<CompressedNorms_>(
+            gemm_helper.make_result_range<Range>(range_, other.range_),
+            std::move(ordinals), std::move(values));
+      }
+
+    }; // class CompressedNorms
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_COMPRESSED_NORMS_H__INCLUDED
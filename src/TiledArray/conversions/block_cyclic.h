@@ -0,0 +1,345 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  block_cyclic.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_CONVERSIONS_BLOCK_CYCLIC_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_BLOCK_CYCLIC_H__INCLUDED
+
+#include <TiledArray/conversions/make_array.h>
+#include <TiledArray/conversions/retile.h>
+#include <TiledArray/pmap/cyclic_pmap.h>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Layout of a 2-D block-cyclic matrix
+
+  /// This is the distribution of a ScaLAPACK matrix: the \c m by \c n
+  /// matrix is split into \c mb by \c nb blocks, which are distributed
+  /// cyclically over a \c proc_rows by \c proc_cols process grid, where
+  /// process \c p is at row <tt>p / proc_cols</tt> and column
+  /// <tt>p % proc_cols</tt> of the grid (i.e. a BLACS grid initialized in
+  /// row-major order over the processes of the world, with the first block
+  /// on process 0). Each process stores its blocks in a column-major local
+  /// matrix with leading dimension \c lld() .
+  ///
+  /// An array with the tiled range \c trange() and a \c CyclicPmap with
+  /// the same process grid (see \c pmap() ) holds the same blocks on each
+  /// process, one block per tile, so it is converted to and from the local
+  /// matrix without communication.
+  class BlockCyclicLayout {
+  public:
+    typedef std::size_t size_type; ///< Size type
+
+  private:
+    size_type m_; ///< Number of matrix rows
+    size_type n_; ///< Number of matrix columns
+    size_type mb_; ///< Number of rows in a block
+    size_type nb_; ///< Number of columns in a block
+    size_type proc_rows_; ///< Number of process rows
+    size_type proc_cols_; ///< Number of process columns
+    size_type proc_row_; ///< The process row of this process
+    size_type proc_col_; ///< The process column of this process
+    size_type local_rows_; ///< Number of rows of the local matrix
+    size_type local_cols_; ///< Number of columns of the local matrix
+
+    /// Number of rows or columns of a process (ScaLAPACK \c NUMROC )
+
+    /// \param n The number of rows or columns of the matrix
+    /// \param nb The block size
+    /// \param proc The process row or column
+    /// \param procs The number of process rows or columns
+    /// \return The number of rows or columns that are stored by \c proc
+    static size_type numroc(const size_type n, const size_type nb,
+        const size_type proc, const size_type procs)
+    {
+      const size_type blocks = n / nb;
+      size_type result = (blocks / procs) * nb;
+      if(proc < blocks % procs)
+        result += nb;
+      else if(proc == blocks % procs)
+        result += n % nb;
+      return result;
+    }
+
+    /// Construct the tiling of a dimension
+
+    /// \param n The number of rows or columns of the matrix
+    /// \param nb The block size
+    /// \return One tile per block
+    static TiledRange1 make_trange1(const size_type n, const size_type nb) {
+      std::vector<size_type> bounds;
+      for(size_type i = 0ul; i < n; i += nb)
+        bounds.push_back(i);
+      bounds.push_back(n);
+      return TiledRange1(bounds.begin(), bounds.end());
+    }
+
+  public:
+
+    /// Constructor
+
+    /// \param world The world of the matrix
+    /// \param m The number of matrix rows
+    /// \param n The number of matrix columns
+    /// \param mb The number of rows in a block
+    /// \param nb The number of columns in a block
+    /// \param proc_rows The number of process rows
+    /// \param proc_cols The number of process columns
+    /// \throw TiledArray::Exception When the grid has more processes than
+    /// \c world
+    BlockCyclicLayout(World& world, const size_type m, const size_type n,
+        const size_type mb, const size_type nb, const size_type proc_rows,
+        const size_type proc_cols) :
+      m_(m), n_(n), mb_(mb), nb_(nb), proc_rows_(proc_rows),
+      proc_cols_(proc_cols), proc_row_(proc_rows), proc_col_(proc_cols),
+      local_rows_(0ul), local_cols_(0ul)
+    {
+      TA_USER_ASSERT((m > 0ul) && (n > 0ul) && (mb > 0ul) && (nb > 0ul),
+          "TiledArray::BlockCyclicLayout: the matrix and block sizes must be positive");
+      TA_USER_ASSERT((proc_rows > 0ul) && (proc_cols > 0ul) &&
+          (proc_rows * proc_cols <= size_type(world.size())),
+          "TiledArray::BlockCyclicLayout: the process grid does not fit in the world");
+
+      const size_type rank = world.rank();
+      if(rank < proc_rows_ * proc_cols_) {
+        proc_row_ = rank / proc_cols_;
+        proc_col_ = rank % proc_cols_;
+        local_rows_ = numroc(m_, mb_, proc_row_, proc_rows_);
+        local_cols_ = numroc(n_, nb_, proc_col_, proc_cols_);
+      }
+    }
+
+    size_type m() const { return m_; } ///< Number of matrix rows
+    size_type n() const { return n_; } ///< Number of matrix columns
+    size_type mb() const { return mb_; } ///< Number of rows in a block
+    size_type nb() const { return nb_; } ///< Number of columns in a block
+    size_type proc_rows() const { return proc_rows_; } ///< Number of process rows
+    size_type proc_cols() const { return proc_cols_; } ///< Number of process columns
+    size_type local_rows() const { return local_rows_; } ///< Number of local matrix rows
+    size_type local_cols() const { return local_cols_; } ///< Number of local matrix columns
+
+    /// Leading dimension of the local matrix
+
+    /// \return The ScaLAPACK \c LLD of the local matrix
+    size_type lld() const { return std::max<size_type>(local_rows_, 1ul); }
+
+    /// Size of the local matrix
+
+    /// \return The number of elements of the local matrix
+    size_type local_size() const { return lld() * local_cols_; }
+
+    /// ScaLAPACK array descriptor
+
+    /// \param context The BLACS context of the process grid
+    /// \return The descriptor of the matrix
+    std::array<int, 9> descriptor(const int context) const {
+      return {{ 1, context, int(m_), int(n_), int(mb_), int(nb_), 0, 0, int(lld()) }};
+    }
+
+    /// The tiled range with one tile per block
+
+    /// \return The tiled range of the matrix
+    TiledRange trange() const {
+      return TiledRange{ make_trange1(m_, mb_), make_trange1(n_, nb_) };
+    }
+
+    /// The process map of the blocks
+
+    /// \param world The world of the matrix
+    /// \return A process map that maps each tile of \c trange() to the
+    /// process of its block
+    std::shared_ptr<Pmap> pmap(World& world) const {
+      return std::make_shared<detail::CyclicPmap>(world, (m_ + mb_ - 1ul) / mb_,
+          (n_ + nb_ - 1ul) / nb_, proc_rows_, proc_cols_);
+    }
+
+    /// Check that a distribution has this layout
+
+    /// \param trange The tiled range of the distribution
+    /// \param pmap The process map of the distribution
+    /// \return \c true if the tiles of the distribution are the blocks of
+    /// this layout, on the processes that own the blocks
+    bool is_layout_of(const TiledRange& trange, const Pmap& pmap) const {
+      const detail::CyclicPmap* const cyclic =
+          dynamic_cast<const detail::CyclicPmap*>(&pmap);
+      return cyclic && (cyclic->nrows_proc() == proc_rows_) &&
+          (cyclic->ncols_proc() == proc_cols_) && (trange == this->trange()) &&
+          (cyclic->nrows() == trange.tiles_range().extent(0)) &&
+          (cyclic->ncols() == trange.tiles_range().extent(1));
+    }
+
+    /// Check that an array has this layout
+
+    /// \tparam Array The array type
+    /// \param array The array
+    /// \return \c true if the tiles of \c array are the blocks of this
+    /// layout, on the processes that own the blocks
+    template <typename Array>
+    bool is_layout_of(const Array& array) const {
+      return is_layout_of(array.trange(), *array.pmap());
+    }
+
+    /// Offset of a tile in the local matrix
+
+    /// \param tile_row The tile row
+    /// \param tile_col The tile column
+    /// \return The offset of the first element of the block in the local
+    /// matrix
+    size_type local_offset(const size_type tile_row, const size_type tile_col) const {
+      return (tile_row / proc_rows_) * mb_ + (tile_col / proc_cols_) * nb_ * lld();
+    }
+
+  }; // class BlockCyclicLayout
+
+  /// Copy an array into a local block-cyclic matrix
+
+  /// When \c array has the layout (see \c BlockCyclicLayout::is_layout_of() ),
+  /// each process copies its own tiles into \c local , without
+  /// communication. Otherwise, the array is first retiled and redistributed
+  /// to the layout. Zero tiles are stored as zeros. This is a collective
+  /// operation.
+  /// \tparam Tile The tile type of the array, a \c Tensor
+  /// \tparam Policy The policy type of the array
+  /// \param array The array, with the tiled range of a \c layout.m() by
+  /// \c layout.n() matrix
+  /// \param layout The layout of the matrix
+  /// \param[out] local The local matrix, with \c layout.local_size()
+  /// elements
+  template <typename Tile, typename Policy>
+  inline void array_to_block_cyclic(const DistArray<Tile, Policy>& array,
+      const BlockCyclicLayout& layout, typename Tile::value_type* const local)
+  {
+    typedef typename Tile::value_type numeric_type;
+
+    if(! layout.is_layout_of(array)) {
+      array_to_block_cyclic(retile(array, layout.trange(), layout.pmap(array.world())),
+          layout, local);
+      return;
+    }
+
+    std::fill(local, local + layout.local_size(), numeric_type(0));
+
+    // Copy the local tiles in parallel
+    World& world = array.world();
+    const std::size_t cols = array.trange().tiles_range().extent(1);
+    const std::size_t lld = layout.lld();
+    madness::AtomicInt counter; counter = 0;
+    int task_count = 0;
+    for(const auto index : *array.pmap()) {
+      if(array.is_zero(index)) continue;
+      const std::size_t offset = layout.local_offset(index / cols, index % cols);
+      world.taskq.add([&counter,local,offset,lld] (const Tile& tile) {
+        const std::size_t rows = tile.range().extent(0);
+        const std::size_t tile_cols = tile.range().extent(1);
+        const numeric_type* MADNESS_RESTRICT const data = tile.data();
+        for(std::size_t j = 0ul; j < tile_cols; ++j) {
+          numeric_type* MADNESS_RESTRICT const column = local + offset + j * lld;
+          for(std::size_t i = 0ul; i < rows; ++i)
+            column[i] = data[i * tile_cols + j];
+        }
+        ++counter;
+      }, array.find(index));
+      ++task_count;
+    }
+
+    if(task_count > 0)
+      world.await([&counter,task_count] () -> bool { return counter == task_count; });
+  }
+
+  /// Copy a local block-cyclic matrix into an array
+
+  /// Each process copies the blocks of \c local into its own tiles of an
+  /// array with the layout, without communication. This is a collective
+  /// operation.
+  /// \tparam Array The array type, with \c Tensor tiles
+  /// \param world The world of the array
+  /// \param layout The layout of the matrix
+  /// \param local The local matrix, with \c layout.local_size() elements,
+  /// which is no longer used when this function returns
+  /// \return An array with tiled range \c layout.trange() and process map
+  /// \c layout.pmap()
+  template <typename Array>
+  inline Array block_cyclic_to_array(World& world, const BlockCyclicLayout& layout,
+      const typename Array::value_type::value_type* const local)
+  {
+    typedef typename Array::value_type value_type;
+    typedef typename value_type::value_type numeric_type;
+
+    const std::size_t mb = layout.mb(), nb = layout.nb(), lld = layout.lld();
+    Array result = make_array<Array>(world, layout.trange(), layout.pmap(world),
+        [&layout,local,mb,nb,lld] (value_type& tile, const Range& range) {
+          tile = value_type(range);
+          const std::size_t rows = range.extent(0);
+          const std::size_t cols = range.extent(1);
+          const numeric_type* MADNESS_RESTRICT const block = local +
+              layout.local_offset(range.lobound(0) / mb, range.lobound(1) / nb);
+          numeric_type* MADNESS_RESTRICT const data = tile.data();
+          for(std::size_t i = 0ul; i < rows; ++i)
+            for(std::size_t j = 0ul; j < cols; ++j)
+              data[i * cols + j] = block[i + j * lld];
+          return tile.norm();
+        });
+
+    // The tiles of a dense array are copied by tasks, which must finish
+    // before the local matrix is released
+    for(const auto index : *result.pmap())
+      if(! result.is_zero(index))
+        result.find(index).get();
+
+    return result;
+  }
+
+  /// Copy a local block-cyclic matrix into an array with another distribution
+
+  /// The matrix is copied into an array with the layout (see
+  /// \c block_cyclic_to_array() ), which is then retiled and redistributed
+  /// unless \c trange and \c pmap are those of the layout. This is a
+  /// collective operation.
+  /// \tparam Array The array type, with \c Tensor tiles
+  /// \param world The world of the array
+  /// \param layout The layout of the matrix
+  /// \param local The local matrix, with \c layout.local_size() elements
+  /// \param trange The tiled range of the result
+  /// \param pmap The process map of the result [ default = the default
+  /// process map ]
+  /// \return An array with tiled range \c trange
+  template <typename Array>
+  inline Array block_cyclic_to_array(World& world, const BlockCyclicLayout& layout,
+      const typename Array::value_type::value_type* const local,
+      const TiledRange& trange,
+      std::shared_ptr<typename Array::pmap_interface> pmap =
+          std::shared_ptr<typename Array::pmap_interface>())
+  {
+    Array result = block_cyclic_to_array<Array>(world, layout, local);
+    if(! pmap)
+      pmap = Array::policy_type::default_pmap(world, trange.tiles_range().volume());
+    if(layout.is_layout_of(trange, *pmap))
+      return result;
+    return retile(result, trange, pmap);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_BLOCK_CYCLIC_H__INCLUDED
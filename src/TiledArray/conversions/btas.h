@@ -23,6 +23,7 @@
 #ifndef TILEDARRAY_CONVERSIONS_BTAS_H__INCLUDED
 #define TILEDARRAY_CONVERSIONS_BTAS_H__INCLUDED
 
+#include <algorithm>
 #include <limits>
 
 #include <TiledArray/block_range.h>
@@ -35,6 +36,8 @@
 #include <TiledArray/policies/sparse_policy.h>
 #include <TiledArray/pmap/replicated_pmap.h>
 
+#include <btas/tensorview.h>
+
 namespace TiledArray {
 
   /// Copy a block of a btas::Tensor into a TiledArray::Tensor
@@ -54,8 +57,13 @@ namespace TiledArray {
 
     const auto& src_range = src.range();
     const auto& dst_range = dst.range();
-    auto src_blk_range = TiledArray::BlockRange(detail::make_ta_range(src_range), dst_range.lobound(), dst_range.upbound());
     using std::data;
+    if(dst_range == src_range) {
+      // The layouts match, copy the contiguous data
+      std::copy(data(src), data(src) + dst_range.volume(), dst.data());
+      return;
+    }
+    auto src_blk_range = TiledArray::BlockRange(detail::make_ta_range(src_range), dst_range.lobound(), dst_range.upbound());
     auto src_view = TiledArray::make_const_map(data(src), src_blk_range);
 
     dst = src_view;
@@ -78,13 +86,77 @@ namespace TiledArray {
 
     const auto& src_range = src.range();
     const auto& dst_range = dst.range();
-    auto dst_blk_range = TiledArray::BlockRange(detail::make_ta_range(dst_range), src_range.lobound(), src_range.upbound());
     using std::data;
+    if(src_range == dst_range) {
+      // The layouts match, copy the contiguous data
+      std::copy(src.data(), src.data() + src_range.volume(), data(dst));
+      return;
+    }
+    auto dst_blk_range = TiledArray::BlockRange(detail::make_ta_range(dst_range), src_range.lobound(), src_range.upbound());
     auto dst_view = TiledArray::make_map(data(dst), dst_blk_range);
 
     dst_view = src;
   }
 
+  /// Make a TiledArray::Tensor view of a btas::Tensor
+
+  /// The view refers to the storage of \c src ; no data is copied. It is
+  /// valid as long as the storage of \c src is not reallocated.
+  /// \tparam T The tensor element type
+  /// \tparam Range_ The range type of the btas::Tensor object
+  /// \tparam Storage_ The storage type of the btas::Tensor object
+  /// \param src The btas::Tensor object
+  /// \return A \c TensorMap over the data of \c src
+  /// \throw TiledArray::Exception When the range of \c src is not row-major.
+  template <typename T, typename Range_, typename Storage_>
+  inline TensorMap<T> make_ta_view(btas::Tensor<T,Range_,Storage_>& src) {
+    using std::data;
+    return TiledArray::make_map(data(src), detail::make_ta_range(src.range()));
+  }
+
+  /// Make a constant TiledArray::Tensor view of a btas::Tensor
+
+  /// \tparam T The tensor element type
+  /// \tparam Range_ The range type of the btas::Tensor object
+  /// \tparam Storage_ The storage type of the btas::Tensor object
+  /// \param src The btas::Tensor object
+  /// \return A \c TensorConstMap over the data of \c src
+  /// \throw TiledArray::Exception When the range of \c src is not row-major.
+  template <typename T, typename Range_, typename Storage_>
+  inline TensorConstMap<T> make_ta_view(const btas::Tensor<T,Range_,Storage_>& src) {
+    using std::data;
+    return TiledArray::make_map(data(src), detail::make_ta_range(src.range()));
+  }
+
+  /// Make a btas::TensorView of a TiledArray::Tensor
+
+  /// The view uses \c src as its storage, so BTAS kernels can operate on
+  /// the tile without copying it. Since \c Tensor is shallow-copied, the
+  /// view refers to the data of \c src and of its copies.
+  /// \tparam T The tensor element type
+  /// \tparam Allocator_ The allocator type of the TiledArray::Tensor object
+  /// \param src The TiledArray::Tensor object
+  /// \return A \c btas::TensorView , with range type \c TiledArray::Range ,
+  /// over the data of \c src
+  template <typename T, typename Allocator_>
+  inline btas::TensorView<T, TiledArray::Range, Tensor<T, Allocator_> >
+  make_btas_view(Tensor<T, Allocator_>& src) {
+    return btas::make_view(src.range(), src);
+  }
+
+  /// Make a constant btas::TensorView of a TiledArray::Tensor
+
+  /// \tparam T The tensor element type
+  /// \tparam Allocator_ The allocator type of the TiledArray::Tensor object
+  /// \param src The TiledArray::Tensor object
+  /// \return A constant \c btas::TensorView , with range type
+  /// \c TiledArray::Range , over the data of \c src
+  template <typename T, typename Allocator_>
+  inline btas::TensorConstView<T, TiledArray::Range, Tensor<T, Allocator_> >
+  make_btas_view(const Tensor<T, Allocator_>& src) {
+    return btas::make_cview(src.range(), src);
+  }
+
 namespace detail {
 
 /// Task function for converting btas::Tensor subblock to a TiledArray::DistArray
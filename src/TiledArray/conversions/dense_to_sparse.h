@@ -2,15 +2,62 @@
 #ifndef TILEDARRAY_DENSETOSPARSE_H__INCLUDED
 #define TILEDARRAY_DENSETOSPARSE_H__INCLUDED
 
+#include <utility>
+#include <vector>
 #include "../dist_array.h"
 
 namespace TiledArray {
 
+  namespace detail {
+
+    /// Compute the norms of the local tiles of a dense array
+
+    /// The norms are computed by tasks, one per tile.
+    /// \tparam Tile The tile type of the array
+    /// \param dense_array The dense array
+    /// \param[out] tile_norms The tile norms; the norms of the local tiles
+    /// are written to it
+    /// \return The ordinal indices and futures of the local tiles
+    template <typename Tile>
+    std::vector<std::pair<std::size_t, Future<Tile> > >
+    local_tile_norms(DistArray<Tile, DensePolicy> const &dense_array,
+        TiledArray::Tensor<float>& tile_norms)
+    {
+      World& world = dense_array.world();
+      const auto& pmap = dense_array.pmap();
+
+      std::vector<std::pair<std::size_t, Future<Tile> > > tiles;
+      tiles.reserve(pmap->local_size());
+
+      madness::AtomicInt counter; counter = 0;
+      int task_count = 0;
+      auto task = [&tile_norms,&counter] (const std::size_t ord, const Tile& tile) {
+        tile_norms[ord] = tile.norm();
+        ++counter;
+      };
+
+      for (const std::size_t ord : *pmap) {
+        Future<Tile> tile = dense_array.find(ord);
+        world.taskq.add(task, ord, tile);
+        ++task_count;
+        tiles.emplace_back(ord, std::move(tile));
+      }
+
+      // Wait for the tile norms
+      if (task_count > 0)
+        world.await([&counter,task_count] () -> bool { return counter == task_count; });
+
+      return tiles;
+    }
+
+  }  // namespace detail
+
   /// Function to convert a dense array into a block sparse array
 
   /// If the input array is dense then create a copy by checking the norms of the
   /// tiles in the dense array and then cloning the significant tiles into the
-  /// sparse array.
+  /// sparse array. The norms of the local tiles are computed in parallel, and
+  /// the shape is built with a single reduction.
   template <typename Tile>
   DistArray<Tile, SparsePolicy>
   to_sparse(DistArray<Tile, DensePolicy> const &dense_array) {
@@ -18,13 +65,7 @@ namespace TiledArray {
 
       // Constructing a tensor to hold the norm of each tile in the Dense Array
       TiledArray::Tensor<float> tile_norms(dense_array.trange().tiles_range(), 0.0);
-
-      const auto end = dense_array.end();
-      const auto begin = dense_array.begin();
-      for (auto it = begin; it != end; ++it) {
-          // write the norm of each local tile to the tensor
-          tile_norms[it.ordinal()] = it->get().norm();
-      }
+      const auto tiles = detail::local_tile_norms(dense_array, tile_norms);
 
       // Construct a sparse shape the constructor will handle communicating the
       // norms of the local tiles to the other nodes
@@ -32,15 +73,50 @@ namespace TiledArray {
                                            dense_array.trange());
 
       ArrayType sparse_array(dense_array.world(), dense_array.trange(),
-                             shape);
+                             shape, dense_array.pmap());
 
       // Loop over the local dense tiles and if that tile is in the
       // sparse_array set the sparse array tile with a clone so as not to hold
       // a pointer to the original tile.
-      for (auto it = begin; it != end; ++it) {
-          const auto ord = it.ordinal();
-          if (!sparse_array.is_zero(ord)) {
-              sparse_array.set(ord, it->get().clone());
+      for (const auto& tile : tiles) {
+          if (!sparse_array.is_zero(tile.first)) {
+              sparse_array.set(tile.first, tile.second.get().clone());
+          }
+      }
+
+      return sparse_array;
+  }
+
+  /// Function to convert a dense array into a block sparse array, consuming
+  /// the dense array
+
+  /// The significant tiles of \c dense_array are moved into the sparse array
+  /// without copying them, and \c dense_array is released, so the
+  /// conversion does not need memory for a second copy of the array. The
+  /// data of the other tiles is released with \c dense_array .
+  /// \param dense_array The dense array; it is empty on return
+  template <typename Tile>
+  DistArray<Tile, SparsePolicy>
+  to_sparse(DistArray<Tile, DensePolicy>&& dense_array) {
+      typedef DistArray<Tile, SparsePolicy> ArrayType;  // return type
+
+      World& world = dense_array.world();
+      const auto trange = dense_array.trange();
+      const auto pmap = dense_array.pmap();
+
+      TiledArray::Tensor<float> tile_norms(trange.tiles_range(), 0.0);
+      auto tiles = detail::local_tile_norms(dense_array, tile_norms);
+
+      // Release the dense array
+      dense_array = DistArray<Tile, DensePolicy>();
+
+      TiledArray::SparseShape<float> shape(world, tile_norms, trange);
+      ArrayType sparse_array(world, trange, shape, pmap);
+
+      // Move the significant tiles into the sparse array
+      for (auto& tile : tiles) {
+          if (!sparse_array.is_zero(tile.first)) {
+              sparse_array.set(tile.first, std::move(tile.second));
           }
       }
 
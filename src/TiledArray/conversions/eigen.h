@@ -317,6 +317,75 @@ namespace TiledArray {
       (*counter)++;
     }
 
+    struct EigenGatherTag { };
+    struct EigenScatterTag { };
+
+    /// Tiles of an array and their ordinal indices
+
+    /// A process sends all of the tiles it holds for a gather or scatter in
+    /// one message.
+    template <typename T>
+    using indexed_tiles = std::vector<std::pair<std::size_t, T> >;
+
+    /// Task function for packing the local tiles of an array
+
+    /// \tparam T The tile type
+    /// \param indices The indices of the tiles
+    /// \param tiles The tiles
+    /// \return The indexed tiles
+    template <typename T>
+    indexed_tiles<T> pack_tiles(const std::vector<std::size_t>& indices,
+        const std::vector<Future<T> >& tiles)
+    {
+      indexed_tiles<T> result;
+      result.reserve(indices.size());
+      for(std::size_t i = 0ul; i < indices.size(); ++i)
+        result.emplace_back(indices[i], tiles[i].get());
+      return result;
+    }
+
+    /// Task function for assigning tensors to Eigen submatrices
+
+    /// \tparam Derived The matrix type
+    /// \tparam T Tensor type
+    /// \param tiles The tensors to be copied
+    /// \param matrix The matrix to be assigned
+    /// \param counter The task counter
+    template <typename Derived, typename T>
+    void counted_tiles_to_eigen_submatrix(const indexed_tiles<T>& tiles,
+        Eigen::MatrixBase<Derived>* matrix, madness::AtomicInt* counter)
+    {
+      for(const auto& tile : tiles)
+        tensor_to_eigen_submatrix(tile.second, *matrix);
+      (*counter)++;
+    }
+
+    /// Task function for sending the tiles of a process in a scatter
+
+    /// \tparam A Array type
+    /// \tparam Derived The matrix type
+    /// \param matrix The matrix that will be copied
+    /// \param array The array that will hold the result
+    /// \param proc The process that owns the tiles
+    /// \param counter The task counter
+    template <typename A, typename Derived>
+    void counted_scatter_eigen_submatrix(const Eigen::MatrixBase<Derived>* matrix,
+        const A* array, const ProcessID proc, madness::AtomicInt* counter)
+    {
+      typedef madness::TaggedKey<madness::DistributedID, EigenScatterTag> key_type;
+      indexed_tiles<typename A::value_type> tiles;
+      for(std::size_t i = 0ul; i < array->size(); ++i) {
+        if(array->owner(i) != proc)
+          continue;
+        typename A::value_type tensor(array->trange().make_tile_range(i));
+        eigen_submatrix_to_tensor(*matrix, tensor);
+        tiles.emplace_back(i, std::move(tensor));
+      }
+      array->world().gop.send(proc,
+          key_type(madness::DistributedID(array->id(), proc)), tiles);
+      (*counter)++;
+    }
+
   } // namespace detail
 
   /// Convert an Eigen matrix into an Array object
@@ -476,6 +545,158 @@ namespace TiledArray {
     return matrix;
   }
 
+  /// Gather an Array object into an Eigen matrix on one process
+
+  /// Unlike \c array_to_eigen() , the array does not need to be replicated:
+  /// each process sends its local non-zero tiles to \c root in a single
+  /// message, and \c root copies the tiles into the matrix in parallel, so
+  /// only \c root holds a copy of the whole matrix. This function must be
+  /// called by every process of the world of \c array , and blocks until the
+  /// matrix is assembled.
+  /// \tparam Tile The array tile type
+  /// \tparam EigenStorageOrder The storage order of the resulting Eigen::Matrix
+  ///      object; the default is Eigen::ColMajor, i.e. the column-major storage
+  /// \param array The array to be converted
+  /// \param root The process that receives the matrix [default = 0]
+  /// \return An Eigen matrix with the content of \c array on \c root , and an
+  /// empty matrix on the other processes
+  /// \throw TiledArray::Exception When the number of dimensions of \c array
+  /// is not equal to 1 or 2.
+  template <typename Tile, typename Policy,
+            unsigned int EigenStorageOrder = Eigen::ColMajor>
+  Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic, Eigen::Dynamic,
+                EigenStorageOrder>
+  gather_array_to_eigen(const DistArray<Tile, Policy>& array,
+      const ProcessID root = 0)
+  {
+    typedef Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic,
+                          Eigen::Dynamic, EigenStorageOrder>
+        EigenMatrix;
+    typedef typename DistArray<Tile, Policy>::value_type value_type;
+    typedef madness::TaggedKey<madness::DistributedID, detail::EigenGatherTag> key_type;
+
+    const auto rank = array.trange().tiles_range().rank();
+    TA_USER_ASSERT((rank == 2u) || (rank == 1u),
+        "TiledArray::gather_array_to_eigen(): The array dimensions must be equal to 1 or 2.");
+
+    World& world = array.world();
+
+    // Collect the local non-zero tiles
+    std::vector<std::size_t> indices;
+    std::vector<Future<value_type> > tiles;
+    for(const std::size_t i : *array.pmap()) {
+      if(array.is_zero(i))
+        continue;
+      indices.push_back(i);
+      tiles.push_back(array.find(i));
+    }
+
+    EigenMatrix matrix;
+    if(world.rank() != root) {
+      world.gop.send(root, key_type(madness::DistributedID(array.id(), world.rank())),
+          world.taskq.add(& detail::pack_tiles<value_type>, indices, tiles));
+    } else {
+      const auto* MADNESS_RESTRICT const array_extent =
+          array.trange().elements_range().extent_data();
+      // if array is sparse must initialize to zero
+      matrix = EigenMatrix::Zero(array_extent[0], (rank == 2 ? array_extent[1] : 1));
+
+      // Copy the local tiles, and the tiles of each remote process
+      madness::AtomicInt counter;
+      counter = 0;
+      int n = 0;
+      for(const Future<value_type>& tile : tiles) {
+        world.taskq.add(& detail::counted_tensor_to_eigen_submatrix<EigenMatrix,
+            value_type>, tile, &matrix, &counter);
+        ++n;
+      }
+      for(ProcessID p = 0; p < world.size(); ++p) {
+        if(p == root)
+          continue;
+        world.taskq.add(& detail::counted_tiles_to_eigen_submatrix<EigenMatrix,
+            value_type>, world.gop.template recv<detail::indexed_tiles<value_type> >(
+                p, key_type(madness::DistributedID(array.id(), p))),
+            &matrix, &counter);
+        ++n;
+      }
+
+      world.await([&counter,n] () { return counter == n; });
+    }
+
+    // The messages of a later gather of this array use the same keys
+    world.gop.fence();
+
+    return matrix;
+  }
+
+  /// Scatter an Eigen matrix on one process into an Array object
+
+  /// Unlike \c eigen_to_array() , the matrix is only needed on \c root , and
+  /// the array is distributed with its default process map: \c root copies
+  /// the tiles of each process out of \c matrix in parallel, and sends them
+  /// to that process in a single message. This function must be called by
+  /// every process of \c world , and blocks until the tiles are set.
+  /// \tparam A The array type
+  /// \tparam Derived The Eigen matrix derived type
+  /// \param world The world where the array will live
+  /// \param trange The tiled range of the new array
+  /// \param matrix The Eigen matrix to be copied; it is only used on \c root
+  /// \param root The process that holds the matrix [default = 0]
+  /// \return An \c Array object that is a copy of \c matrix
+  template <typename A, typename Derived>
+  A scatter_eigen_to_array(World& world, const typename A::trange_type& trange,
+      const Eigen::MatrixBase<Derived>& matrix, const ProcessID root = 0)
+  {
+    typedef typename A::size_type size_type;
+    typedef madness::TaggedKey<madness::DistributedID, detail::EigenScatterTag> key_type;
+
+    A array(world, trange);
+
+    if(world.rank() == root) {
+      // Check that trange matches the dimensions of other
+      if((matrix.cols() > 1) && (matrix.rows() > 1)) {
+        TA_USER_ASSERT(trange.tiles_range().rank() == 2,
+            "TiledArray::scatter_eigen_to_array(): The number of dimensions in trange is not equal to that of the Eigen matrix.");
+        TA_USER_ASSERT(trange.elements_range().extent(0) == size_type(matrix.rows()),
+            "TiledArray::scatter_eigen_to_array(): The number of rows in trange is not equal to the number of rows in the Eigen matrix.");
+        TA_USER_ASSERT(trange.elements_range().extent(1) == size_type(matrix.cols()),
+            "TiledArray::scatter_eigen_to_array(): The number of columns in trange is not equal to the number of columns in the Eigen matrix.");
+      } else {
+        TA_USER_ASSERT(trange.tiles_range().rank() == 1,
+            "TiledArray::scatter_eigen_to_array(): The number of dimensions in trange must match that of the Eigen matrix.");
+        TA_USER_ASSERT(trange.elements_range().extent(0) == size_type(matrix.size()),
+            "TiledArray::scatter_eigen_to_array(): The size of trange must be equal to the matrix size.");
+      }
+
+      // Copy the local tiles, and pack the tiles of each remote process
+      madness::AtomicInt counter;
+      counter = 0;
+      std::int64_t n = 0;
+      for(const std::size_t i : *array.pmap()) {
+        world.taskq.add(& detail::counted_eigen_submatrix_to_tensor<A, Derived>,
+            &matrix, &array, i, &counter);
+        ++n;
+      }
+      for(ProcessID p = 0; p < world.size(); ++p) {
+        if(p == root)
+          continue;
+        world.taskq.add(& detail::counted_scatter_eigen_submatrix<A, Derived>,
+            &matrix, &array, p, &counter);
+        ++n;
+      }
+
+      world.await([&counter,n] () { return counter == n; });
+    } else {
+      Future<detail::indexed_tiles<typename A::value_type> > tiles =
+          world.gop.template recv<detail::indexed_tiles<typename A::value_type> >(
+              root, key_type(madness::DistributedID(array.id(), world.rank())));
+      for(const auto& tile : tiles.get())
+        array.set(tile.first, tile.second);
+    }
+
+    return array;
+  }
+
   /// Convert a row-major matrix buffer into an Array object
 
   /// This function will copy the content of \c buffer into an \c Array object
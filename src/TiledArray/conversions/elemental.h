@@ -36,7 +36,10 @@
 
 #include <El.hpp>
 
+#include <algorithm>
+#include <memory>
 #include <utility>
+#include <vector>
 
 namespace TiledArray {
 namespace detail {
@@ -67,11 +70,195 @@ inline bool uniformly_blocked(TiledRange const &trange){
     return true;
 }
 
+/// Split the tiles of a matrix into conversion rounds
+
+/// The tiles are taken in ordinal order, and a round is closed when it holds
+/// \c max_elements elements, or more if a single tile is larger. Every
+/// process computes the same rounds from \c trange , so the tiles of a round
+/// do not need to be communicated.
+/// \param trange The tiled range of the matrix
+/// \param max_elements The maximum number of elements in a round, or 0 for
+/// one eighth of the matrix
+/// \return The first tile of each round, followed by the number of tiles
+inline std::vector<std::size_t> conversion_rounds(TiledRange const &trange,
+        std::size_t max_elements){
+    if(max_elements == 0ul)
+        max_elements = std::max<std::size_t>(trange.elements_range().volume() / 8ul, 1ul);
+
+    const auto vol = trange.tiles_range().volume();
+    std::vector<std::size_t> rounds(1, 0ul);
+    std::size_t elements = 0ul;
+    for(auto i = 0ul; i < vol; ++i){
+        const auto tile_elements = trange.make_tile_range(i).volume();
+        if((elements > 0ul) && (elements + tile_elements > max_elements)){
+            rounds.push_back(i);
+            elements = 0ul;
+        }
+        elements += tile_elements;
+    }
+    rounds.push_back(vol);
+    return rounds;
+}
+
+/// Streaming redistribution between a DistArray and an Elemental matrix
+
+/// The elements of a tiled matrix are exchanged with the element-cyclic
+/// <tt>[MC,MR]</tt> distribution of Elemental in rounds of tiles (see
+/// \c conversion_rounds() ). In each round, every process packs one buffer
+/// per destination, in which the elements of each tile are ordered by tile
+/// ordinal and then row-major, and the buffers are exchanged with one
+/// all-to-all-v. Since both sides know which tiles each process holds, the
+/// receiver unpacks the elements in the same order without any index data.
+/// The next round is packed by a task while the current round is
+/// exchanged, so only the buffers of two rounds are held at once.
+/// \tparam T The element type
+template <typename T>
+class ElementalRedistribution {
+    public:
+        typedef El::DistMatrix<T> matrix_type; ///< Element-cyclic matrix type
+
+        /// Packed elements of a round
+        struct Buffers {
+            std::vector<T> data; ///< The elements for all destinations
+            std::vector<int> counts; ///< The number of elements per destination
+            std::vector<int> displs; ///< The offset of each destination in data
+        }; // struct Buffers
+
+        /// \param world The world of the array
+        /// \param matrix The Elemental matrix
+        ElementalRedistribution(World& world, matrix_type const& matrix) :
+            matrix_(matrix), comm_(matrix.DistComm()),
+            col_stride_(matrix.ColStride()),
+            world_ranks_(El::mpi::Size(matrix.DistComm())),
+            dist_ranks_(world.size(), -1)
+        {
+            TA_USER_ASSERT(world_ranks_.size() == world.size(),
+                    "The Elemental grid must contain every process of the world.");
+
+            // Map the ranks of the Elemental communicator to world ranks
+            const int rank = world.rank();
+            El::mpi::AllGather(&rank, 1, world_ranks_.data(), 1, comm_);
+            for(auto d = 0ul; d < world_ranks_.size(); ++d)
+                dist_ranks_[world_ranks_[d]] = d;
+        }
+
+        /// The Elemental rank of a world process
+        int dist_rank(ProcessID p) const { return dist_ranks_[p]; }
+
+        /// The world process of an Elemental rank
+        ProcessID world_rank(int d) const { return world_ranks_[d]; }
+
+        /// The Elemental rank that owns an element
+        int owner(El::Int m, El::Int n) const {
+            return matrix_.RowOwner(m) + col_stride_ * matrix_.ColOwner(n);
+        }
+
+        /// Set the offsets of packed buffers from their counts
+        static void make_displs(Buffers& buffers) {
+            buffers.displs.assign(buffers.counts.size(), 0);
+            for(auto d = 1ul; d < buffers.counts.size(); ++d)
+                buffers.displs[d] = buffers.displs[d - 1] + buffers.counts[d - 1];
+            buffers.data.resize(buffers.displs.back() + buffers.counts.back());
+        }
+
+        /// Pack tiles for the Elemental ranks that own their elements
+
+        /// \param tiles The tiles of this process in the round
+        /// \return The packed elements
+        Buffers pack_tiles(std::vector<Future<Tensor<T>>> const& tiles) const {
+            Buffers buffers;
+            buffers.counts.assign(world_ranks_.size(), 0);
+            for(auto const& f : tiles){
+                auto const& tile = f.get();
+                auto lo = tile.range().lobound_data();
+                auto up = tile.range().upbound_data();
+                for(auto m = lo[0]; m < up[0]; ++m)
+                    for(auto n = lo[1]; n < up[1]; ++n)
+                        ++buffers.counts[owner(m, n)];
+            }
+            make_displs(buffers);
+
+            std::vector<int> pos = buffers.displs;
+            for(auto const& f : tiles){
+                auto const& tile = f.get();
+                auto lo = tile.range().lobound_data();
+                auto up = tile.range().upbound_data();
+                const T* MADNESS_RESTRICT data = tile.data();
+                for(auto m = lo[0]; m < up[0]; ++m)
+                    for(auto n = lo[1]; n < up[1]; ++n, ++data)
+                        buffers.data[pos[owner(m, n)]++] = *data;
+            }
+            return buffers;
+        }
+
+        /// Pack the local elements of the matrix for the owners of tiles
+
+        /// \param array The result array
+        /// \param first The first tile of the round
+        /// \param last The end of the round
+        /// \return The packed elements
+        template <typename Array>
+        Buffers pack_matrix(Array const& array, std::size_t first,
+                std::size_t last) const {
+            Buffers buffers;
+            buffers.counts.assign(world_ranks_.size(), 0);
+            for(int pass = 0; pass < 2; ++pass){
+                std::vector<int> pos = buffers.displs;
+                for(auto i = first; i < last; ++i){
+                    const int dest = dist_rank(array.owner(i));
+                    auto range = array.trange().make_tile_range(i);
+                    auto lo = range.lobound_data();
+                    auto up = range.upbound_data();
+                    for(El::Int m = lo[0]; m < El::Int(up[0]); ++m){
+                        if(! matrix_.IsLocalRow(m)) continue;
+                        const El::Int lm = matrix_.LocalRow(m);
+                        for(El::Int n = lo[1]; n < El::Int(up[1]); ++n){
+                            if(! matrix_.IsLocalCol(n)) continue;
+                            if(pass == 0)
+                                ++buffers.counts[dest];
+                            else
+                                buffers.data[pos[dest]++] =
+                                    matrix_.GetLocal(lm, matrix_.LocalCol(n));
+                        }
+                    }
+                }
+                if(pass == 0)
+                    make_displs(buffers);
+            }
+            return buffers;
+        }
+
+        /// Exchange the packed elements of a round
+
+        /// \param send The elements packed by this process
+        /// \return The elements received by this process
+        Buffers exchange(Buffers const& send) const {
+            Buffers recv;
+            recv.counts.resize(send.counts.size());
+            El::mpi::AllToAll(send.counts.data(), 1, recv.counts.data(), 1, comm_);
+            make_displs(recv);
+            El::mpi::AllToAll(send.data.data(), send.counts.data(),
+                    send.displs.data(), recv.data.data(), recv.counts.data(),
+                    recv.displs.data(), comm_);
+            return recv;
+        }
+
+    private:
+        matrix_type const& matrix_; ///< The Elemental matrix
+        El::mpi::Comm comm_; ///< The distribution communicator of the matrix
+        El::Int col_stride_; ///< The number of process rows of the matrix
+        std::vector<int> world_ranks_; ///< The world rank of each Elemental rank
+        std::vector<int> dist_ranks_; ///< The Elemental rank of each world rank
+}; // class ElementalRedistribution
+
 template <typename Array>
 El::DistMatrix<typename Array::element_type> matrix_to_el(
-        Array const& A, El::Grid const &g){
-    
-    // Check for matrix and uniform blocking
+        Array const& A, El::Grid const &g, std::size_t max_round_elements = 0ul){
+    typedef typename Array::element_type T;
+    typedef ElementalRedistribution<T> redist_type;
+    typedef typename redist_type::Buffers buffers_type;
+
+    // Check for matrix
     TiledRange const &trange = A.trange();
     TA_ASSERT(trange.rank() == 2);
 
@@ -81,88 +268,129 @@ El::DistMatrix<typename Array::element_type> matrix_to_el(
     const auto ncols = elem_extent[1];
 
     // Construct elem array, zero it to avoid having to write zero tiles
-    auto el_A = El::DistMatrix<typename Array::element_type>(nrows, ncols, g);
+    auto el_A = El::DistMatrix<T>(nrows, ncols, g);
     El::Zero(el_A);
 
-    // Loop over all tiles
-    const auto vol = trange.tiles_range().volume();
-    for(auto i = 0ul; i < vol; ++i){
-
-        // Write local tiles into a queue and allow elemental to do all 
-        // communication of elements to the remote nodes.
-        if(!A.is_zero(i) && A.is_local(i)){
-            auto tile = A.find(i).get();
-            
-            auto lo = tile.range().lobound_data();
-            auto up = tile.range().upbound_data();
-
-            for(auto m = lo[0]; m < up[0]; ++m){
-                for(auto n = lo[1]; n < up[1]; ++n){
-                    el_A.QueueUpdate(m,n,tile(m,n));
+    World& world = A.world();
+    const redist_type redist(world, el_A);
+    const std::vector<std::size_t> rounds = conversion_rounds(trange, max_round_elements);
+
+    // Pack the local non-zero tiles of a round in a task
+    auto pack = [&] (std::size_t r) -> Future<buffers_type> {
+        std::vector<Future<Tensor<T>>> tiles;
+        for(auto i = rounds[r]; i < rounds[r + 1]; ++i)
+            if(A.is_local(i) && ! A.is_zero(i))
+                tiles.push_back(A.find(i));
+        return world.taskq.add([&redist] (std::vector<Future<Tensor<T>>> const& t) {
+                return redist.pack_tiles(t);
+            }, tiles);
+    };
+
+    const auto nrounds = rounds.size() - 1ul;
+    const El::Int ldim = el_A.LDim();
+    T* MADNESS_RESTRICT const buffer = el_A.Buffer();
+    Future<buffers_type> next = pack(0ul);
+    for(auto r = 0ul; r < nrounds; ++r){
+        // Exchange this round while the next round is packed
+        const buffers_type send = next.get();
+        if(r + 1ul < nrounds)
+            next = pack(r + 1ul);
+        const buffers_type recv = redist.exchange(send);
+
+        // Unpack the elements in the order of the senders
+        for(auto d = 0ul; d < recv.counts.size(); ++d){
+            if(recv.counts[d] == 0) continue;
+            const ProcessID source = redist.world_rank(d);
+            const T* MADNESS_RESTRICT data = recv.data.data() + recv.displs[d];
+            for(auto i = rounds[r]; i < rounds[r + 1]; ++i){
+                if((A.owner(i) != source) || A.is_zero(i)) continue;
+                auto range = trange.make_tile_range(i);
+                auto lo = range.lobound_data();
+                auto up = range.upbound_data();
+                for(El::Int m = lo[0]; m < El::Int(up[0]); ++m){
+                    if(! el_A.IsLocalRow(m)) continue;
+                    const El::Int lm = el_A.LocalRow(m);
+                    for(El::Int n = lo[1]; n < El::Int(up[1]); ++n)
+                        if(el_A.IsLocalCol(n))
+                            buffer[lm + el_A.LocalCol(n) * ldim] = *data++;
                 }
             }
+            TA_ASSERT(data == recv.data.data() + recv.displs[d] + recv.counts[d]);
         }
     }
 
-    // Initialize the communication process
-    el_A.ProcessQueues();
-
     return el_A;
 }
 
 
 template<typename T>
 DistArray<Tensor<T>, DensePolicy> el_to_matrix(
-        El::AbstractDistMatrix<T> const &M, World& world, 
-        TiledRange const &trange){
+        El::AbstractDistMatrix<T> const &M, World& world,
+        TiledRange const &trange, std::size_t max_round_elements = 0ul){
+    typedef ElementalRedistribution<T> redist_type;
+    typedef typename redist_type::Buffers buffers_type;
+
     TA_ASSERT(trange.rank() == 2);
-    TA_USER_ASSERT(uniformly_blocked(trange), "The output TiledRange must be uniformly blocked.");
 #if !defined(EL_RELEASE)
     TA_USER_ASSERT(madness::ThreadPool::size() == 0, "TA::el_to_matrix(): Elemental compiled in Debug mode is not re-entrant," \
      " must execute with MAD_NUM_THREADS=1 (and without TBB). Recompile Elemental in Release mode to use MAD_NUM_THREADS>1 or to use TBB.");
 #endif
 
-    // Determine block size
-    auto const& tr1_row = trange.data()[0];
-    auto const& tr1_col = trange.data()[1];
-    auto row_bs = tr1_row.begin()->second - tr1_row.begin()->first;
-    auto col_bs = tr1_col.begin()->second - tr1_col.begin()->first;
-
-    // Copy the unknown matrix distribution into a block based distribution 
-    El::DistMatrix<T, El::MC, El::MR, El::BLOCK> Mb(M.Height(), M.Width(), M.Grid(), row_bs, col_bs);
-    Mb = M;
+    // The element-cyclic distribution is used as is; other distributions
+    // are copied into it first
+    std::unique_ptr<El::DistMatrix<T>> Mc;
+    if((M.ColDist() != El::MC) || (M.RowDist() != El::MR) ||
+            (M.Wrap() != El::ELEMENT)){
+        Mc.reset(new El::DistMatrix<T>(M.Height(), M.Width(), M.Grid()));
+        El::Copy(M, *Mc);
+    }
+    El::DistMatrix<T> const& Me = (Mc ? *Mc :
+            static_cast<El::DistMatrix<T> const&>(M));
 
     DistArray<Tensor<T>, DensePolicy> A(world, trange);
-
-    // Loop over the tiles in the trange
-    const auto vol = trange.tiles_range().volume();
-    for(auto i = 0ul; i < vol; ++i){
-        // Make the tiled range for tile i
-        auto range = trange.make_tile_range(i);
-        auto lo = range.lobound_data();
-
-        auto task = [&](Range rng){
-            auto lo = rng.lobound_data();
-            auto up = rng.upbound_data();
-            auto tile = Tensor<T>(rng, 0.0);
-            
-            // Copy by element 
-            for(auto m = lo[0]; m != up[0]; ++m){
-                for(auto n = lo[1]; n != up[1]; ++n){
-                    tile(m,n) = Mb.GetLocal(Mb.LocalRow(m),Mb.LocalCol(n));
+    const redist_type redist(world, Me);
+    const std::vector<std::size_t> rounds = conversion_rounds(trange, max_round_elements);
+
+    auto pack = [&] (std::size_t r) -> Future<buffers_type> {
+        return world.taskq.add([&redist,&A,&rounds,r] () {
+                return redist.pack_matrix(A, rounds[r], rounds[r + 1]);
+            });
+    };
+
+    const auto nrounds = rounds.size() - 1ul;
+    const El::Int col_stride = Me.ColStride();
+    Future<buffers_type> next = pack(0ul);
+    for(auto r = 0ul; r < nrounds; ++r){
+        // Exchange this round while the next round is packed
+        const buffers_type send = next.get();
+        if(r + 1ul < nrounds)
+            next = pack(r + 1ul);
+        const buffers_type recv = redist.exchange(send);
+
+        // Assemble the local tiles of the round from the elements of each
+        // source, in the order they were packed
+        std::vector<const T*> data(recv.counts.size());
+        for(auto d = 0ul; d < recv.counts.size(); ++d)
+            data[d] = recv.data.data() + recv.displs[d];
+        for(auto i = rounds[r]; i < rounds[r + 1]; ++i){
+            if(! A.is_local(i)) continue;
+            Tensor<T> tile(trange.make_tile_range(i));
+            auto lo = tile.range().lobound_data();
+            auto up = tile.range().upbound_data();
+            const auto ncols = up[1] - lo[1];
+            for(auto d = 0ul; d < recv.counts.size(); ++d){
+                const El::Int row_owner = d % col_stride;
+                const El::Int col_owner = d / col_stride;
+                for(El::Int m = lo[0]; m < El::Int(up[0]); ++m){
+                    if(Me.RowOwner(m) != row_owner) continue;
+                    for(El::Int n = lo[1]; n < El::Int(up[1]); ++n)
+                        if(Me.ColOwner(n) == col_owner)
+                            tile.data()[(m - lo[0]) * ncols + (n - lo[1])] = *data[d]++;
                 }
             }
-            
-            return tile;
-        };
-         
-        // Send local writes to task
-        if(Mb.IsLocal(lo[0], lo[1])){
-            auto tile_future = A.world().taskq.add(task, range);
-            A.set(i, tile_future);
+            A.set(i, tile);
         }
     }
-    A.world().gop.fence();
 
     return A;
 }
@@ -204,14 +432,17 @@ class TensorFlattening {
 /// @param A a TA Array with a TA Tensor Tile type
 /// @param g an Elemental Grid
 /// @param tf a TensorFlattening object that fuses indices in tensors with more than 2 dimensions
+/// @param max_round_elements The maximum number of elements exchanged in a
+/// round of the redistribution, or 0 for one eighth of the array
 template <typename Array>
 El::DistMatrix<typename Array::element_type> array_to_el(
         Array const& A, El::Grid const &g = El::Grid::Default(), 
-        TensorFlattening const &tf = TensorFlattening()){
+        TensorFlattening const &tf = TensorFlattening(),
+        std::size_t max_round_elements = 0ul){
 
     if(A.trange().rank() == 2){
         // Flattening is not needed for the matrix case.
-        return detail::matrix_to_el(A, g);
+        return detail::matrix_to_el(A, g, max_round_elements);
     } else {
         TA_USER_ASSERT(false, "array_to_el currently only supports converting matrices, higher order tensor conversions will be supported at a latter date.");
     }
@@ -221,17 +452,20 @@ El::DistMatrix<typename Array::element_type> array_to_el(
 
 /// @param M An Elemental DistMatrix 
 /// @param world A madness world
-/// @param trange A TiledRange that must be uniformly blocked in each dimension
+/// @param trange A TiledRange
 /// @param tf A tensor flattening that dictates which dimensions to unfold. 
+/// @param max_round_elements The maximum number of elements exchanged in a
+/// round of the redistribution, or 0 for one eighth of the array
 template<typename T>
 DistArray<Tensor<T>, DensePolicy> el_to_array(
         El::AbstractDistMatrix<T> const &M, World& world, 
         TiledRange const &trange, 
-        TensorFlattening const &tf = TensorFlattening()){
+        TensorFlattening const &tf = TensorFlattening(),
+        std::size_t max_round_elements = 0ul){
 
     if(trange.rank() == 2){
         // Flattening is not needed for the matrix case.
-        return detail::el_to_matrix(M, world, trange);
+        return detail::el_to_matrix(M, world, trange, max_round_elements);
     } else {
         TA_USER_ASSERT(false, "el_to_array currently only supports converting matrices, higher order tensor conversions will be supported at a latter date.");
     }
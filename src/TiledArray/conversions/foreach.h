@@ -27,11 +27,7 @@
 #define TILEDARRAY_CONVERSIONS_FOREACH_H__INCLUDED
 
 #include <TiledArray/type_traits.h>
-
-/// Forward declarations
-namespace Eigen {
-  template <typename> class aligned_allocator;
-} // namespace Eigen
+#include <tiledarray_fwd.h>
 
 namespace TiledArray {
 
@@ -168,10 +164,15 @@ namespace TiledArray {
 
     /// base implementation of sparse TiledArray::foreach
 
+    /// Result tiles whose norm per element is less than \c threshold are
+    /// dropped as soon as they are computed, and the result shape is built
+    /// from the computed norms with \c threshold as its zero threshold, so
+    /// the result does not need to be truncated.
     /// \note can't autodeduce \c ResultTile from \c void \c Op(ResultTile,ArgTile)
     template <bool inplace = false, typename Op,
         typename ResultTile, typename ArgTile, typename... ArgTiles>
     inline DistArray<ResultTile, SparsePolicy> foreach (Op&& op, const ShapeReductionMethod shape_reduction,
+        const typename DistArray<ArgTile, SparsePolicy>::shape_type::value_type threshold,
         const_if_t<not inplace, DistArray<ArgTile, SparsePolicy>>& arg,
         const DistArray<ArgTiles, SparsePolicy>&... args) {
 
@@ -192,18 +193,24 @@ namespace TiledArray {
 
       // Construct a tensor to hold updated tile norms for the result shape.
       TiledArray::Tensor<typename shape_type::value_type,
-          Eigen::aligned_allocator<typename shape_type::value_type> >
+          default_allocator<typename shape_type::value_type> >
       tile_norms(arg.trange().tiles_range(), 0);
 
       // Construct the task function used to construct the result tiles.
       madness::AtomicInt counter; counter = 0;
       int task_count = 0;
-      auto task = [&op,&counter,&tile_norms](const size_type index,
+      const auto& trange = arg.trange();
+      auto task = [&op,&counter,&tile_norms,&trange,threshold](const size_type index,
           const_if_t<not inplace, arg_value_type>& arg_tile,
           const ArgTiles&... arg_tiles) -> result_value_type {
         nonvoid_op_helper<inplace, result_value_type> op_caller;
         auto result_tile = op_caller(std::forward<Op>(op), tile_norms[index],
             arg_tile, arg_tiles...);
+        // Drop the tile if it will be zero in the result shape
+        if(tile_norms[index] < threshold * trange.make_tile_range(index).volume()) {
+          tile_norms[index] = 0;
+          result_tile = result_value_type();
+        }
         ++counter;
         return std::move(result_tile);
       };
@@ -242,9 +249,9 @@ namespace TiledArray {
       if(task_count > 0)
         world.await([&counter,task_count] () -> bool { return counter == task_count; });
 
-      // Construct the new array
+      // Construct the new array; dropped tiles have zero norms
       result_array_type result(world, arg.trange(),
-          shape_type(world, tile_norms, arg.trange()), arg.pmap());
+          shape_type(world, tile_norms, arg.trange(), threshold), arg.pmap());
       for(typename std::vector<datum_type>::const_iterator it = tiles.begin(); it != tiles.end(); ++it) {
         const size_type index = it->first;
         if(! result.is_zero(index))
@@ -369,18 +376,26 @@ namespace TiledArray {
   ///     const typename TiledArray::DistArray<Tile,SparsePolicy>::value_type& arg_tile);
   /// \endcode
   /// where the return value of \c op is the 2-norm (Frobenius norm) of the
-  /// result tile.
+  /// result tile. Result tiles whose norm per element is less than
+  /// \c threshold are dropped when they are computed, so the result is
+  /// already truncated.
   /// \note This function should not be used to initialize the tiles of an array
   /// object.
   /// \tparam Op Tile operation
   /// \tparam Tile The tile type of the array
   /// \param op The tile function
   /// \param arg The argument array
+  /// \param threshold The zero threshold of the result shape
+  /// [ default = \c SparseShape::threshold() ]
   template <typename ResultTile, typename ArgTile, typename Op,
             typename = typename std::enable_if<!std::is_same<ResultTile,ArgTile>::value>::type>
   inline DistArray<ResultTile, SparsePolicy>
-  foreach(const DistArray<ArgTile, SparsePolicy> arg, Op&& op) {
-    return detail::foreach<false, Op, ResultTile, ArgTile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
+  foreach(const DistArray<ArgTile, SparsePolicy> arg, Op&& op,
+      const typename DistArray<ArgTile, SparsePolicy>::shape_type::value_type threshold =
+          DistArray<ArgTile, SparsePolicy>::shape_type::threshold())
+  {
+    return detail::foreach<false, Op, ResultTile, ArgTile>(std::forward<Op>(op),
+        ShapeReductionMethod::Intersect, threshold, arg);
   }
 
   /// Apply a function to each tile of a sparse Array
@@ -389,8 +404,12 @@ namespace TiledArray {
   /// the case \c ResultTile == \c ArgTile
   template <typename Tile, typename Op>
   inline DistArray<Tile, SparsePolicy>
-  foreach(const DistArray<Tile, SparsePolicy>& arg, Op&& op) {
-    return detail::foreach<false, Op, Tile, Tile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
+  foreach(const DistArray<Tile, SparsePolicy>& arg, Op&& op,
+      const typename DistArray<Tile, SparsePolicy>::shape_type::value_type threshold =
+          DistArray<Tile, SparsePolicy>::shape_type::threshold())
+  {
+    return detail::foreach<false, Op, Tile, Tile>(std::forward<Op>(op),
+        ShapeReductionMethod::Intersect, threshold, arg);
   }
 
 
@@ -424,6 +443,9 @@ namespace TiledArray {
   /// \param arg The argument array to be modified
   /// \param fence A flag that indicates fencing behavior. If \c true this
   /// function will fence before data is modified.
+  /// \param threshold The zero threshold of the result shape; tiles whose
+  /// norm per element is less than \c threshold are dropped
+  /// [ default = \c SparseShape::threshold() ]
   /// \warning This function fences by default to avoid data race conditions.
   /// Only disable the fence if you can ensure, the data is not being read by
   /// another thread.
@@ -436,7 +458,10 @@ namespace TiledArray {
   template <typename Tile, typename Op,
       typename = typename std::enable_if<! TiledArray::detail::is_array<typename std::decay<Op>::type>::value>::type>
   inline void
-  foreach_inplace(DistArray<Tile, SparsePolicy>& arg, Op&& op, bool fence = true) {
+  foreach_inplace(DistArray<Tile, SparsePolicy>& arg, Op&& op, bool fence = true,
+      const typename DistArray<Tile, SparsePolicy>::shape_type::value_type threshold =
+          DistArray<Tile, SparsePolicy>::shape_type::threshold())
+  {
 
     // The tile data is being modified in place, which means we may need to
     // fence to ensure no other threads are using the data.
@@ -444,7 +469,8 @@ namespace TiledArray {
       arg.world().gop.fence();
 
     // Set the arg with the new array
-    arg = detail::foreach<true, Op, Tile, Tile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
+    arg = detail::foreach<true, Op, Tile, Tile>(std::forward<Op>(op),
+        ShapeReductionMethod::Intersect, threshold, arg);
   }
 
   /// Apply a function to each tile of dense Arrays
@@ -489,9 +515,12 @@ namespace TiledArray {
   inline DistArray<ResultTile, SparsePolicy>
   foreach(const DistArray<LeftTile, SparsePolicy>& left,
       const DistArray<RightTile, SparsePolicy>& right, Op&& op,
-      const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect) {
+      const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect,
+      const typename DistArray<LeftTile, SparsePolicy>::shape_type::value_type threshold =
+          DistArray<LeftTile, SparsePolicy>::shape_type::threshold())
+  {
     return detail::foreach<false, Op, ResultTile, LeftTile, RightTile>(std::forward<Op>(op),
-        shape_reduction, left, right);
+        shape_reduction, threshold, left, right);
   }
 
   /// Specialization of foreach<ResultTile,ArgTile,Op> for
@@ -500,9 +529,12 @@ namespace TiledArray {
   inline DistArray<LeftTile, SparsePolicy>
   foreach(const DistArray<LeftTile, SparsePolicy>& left,
       const DistArray<RightTile, SparsePolicy>& right, Op&& op,
-      const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect) {
+      const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect,
+      const typename DistArray<LeftTile, SparsePolicy>::shape_type::value_type threshold =
+          DistArray<LeftTile, SparsePolicy>::shape_type::threshold())
+  {
     return detail::foreach<false, Op, LeftTile, LeftTile, RightTile>(std::forward<Op>(op),
-        shape_reduction, left, right);
+        shape_reduction, threshold, left, right);
   }
 
   /// This function takes two input tiles and put result into the left tile
@@ -511,7 +543,10 @@ namespace TiledArray {
   foreach_inplace(DistArray<LeftTile, SparsePolicy>& left,
       const DistArray<RightTile, SparsePolicy>& right, Op&& op,
       const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect,
-      bool fence = true) {
+      bool fence = true,
+      const typename DistArray<LeftTile, SparsePolicy>::shape_type::value_type threshold =
+          DistArray<LeftTile, SparsePolicy>::shape_type::threshold())
+  {
 
     // The tile data is being modified in place, which means we may need to
     // fence to ensure no other threads are using the data.
@@ -520,7 +555,7 @@ namespace TiledArray {
 
     // Set the arg with the new array
     left = detail::foreach<true, Op, LeftTile, LeftTile, RightTile>(std::forward<Op>(op),
-        shape_reduction, left, right);
+        shape_reduction, threshold, left, right);
   }
 
 } // namespace TiledArray
@@ -26,13 +26,14 @@
 #ifndef TILEDARRAY_CONVERSIONS_MAKE_ARRAY_H__INCLUDED
 #define TILEDARRAY_CONVERSIONS_MAKE_ARRAY_H__INCLUDED
 
+#include <TiledArray/error.h>
 #include <TiledArray/madness.h>
 #include <TiledArray/type_traits.h>
-
-/// Forward declarations
-namespace Eigen {
-  template <typename> class aligned_allocator;
-} // namespace Eigen
+#include <tiledarray_fwd.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
 
 namespace TiledArray {
 
@@ -145,7 +146,7 @@ namespace TiledArray {
 
     // Construct a tensor to hold updated tile norms for the result shape.
     TiledArray::Tensor<typename detail::shape_t<Array>::value_type,
-        Eigen::aligned_allocator<typename detail::shape_t<Array>::value_type> >
+        default_allocator<typename detail::shape_t<Array>::value_type> >
     tile_norms(trange.tiles_range(), 0);
 
     // Construct the task function used to construct the result tiles.
@@ -222,6 +223,278 @@ namespace TiledArray {
         trange.tiles_range().volume()), op);
   }
 
+  namespace detail {
+
+    /// The scratch buffer of batched tile initialization
+
+    /// Each thread has its own buffer, which is reused by all the tiles it
+    /// initializes.
+    /// \tparam T The element type of the buffer
+    /// \return The buffer of this thread
+    template <typename T>
+    inline std::vector<T>& make_array_scratch() {
+      static thread_local std::vector<T> scratch;
+      return scratch;
+    }
+
+    /// The default number of tiles in each batch of \c make_array_batched
+
+    /// \param local_size The number of local tiles
+    /// \return The batch size, which makes about 8 batches per thread
+    inline std::size_t make_array_batch_size(const std::size_t local_size) {
+      const std::size_t batches = 8ul * (madness::ThreadPool::size() + 1ul);
+      return std::max<std::size_t>(1ul, (local_size + batches - 1ul) / batches);
+    }
+
+  }  // namespace detail
+
+  /// Construct a dense Array with batched tasks
+
+  /// This function is equivalent to \c make_array() , but each task
+  /// initializes a batch of local tiles, which reduces the task overhead
+  /// when there are many small tiles. The tile operation is also given a
+  /// scratch buffer that is reused by the tiles initialized by a thread.
+  /// The expected signature of the tile operation is:
+  /// \code
+  /// void op(tile_t& tile, const range_t& range, std::vector<numeric_t>& scratch);
+  /// \endcode
+  /// where `numeric_t` is the numeric type of `tile_t`.
+  /// \tparam Array The `DistArray` type
+  /// \tparam Op Tile operation
+  /// \param world The world where the array will live
+  /// \param trange The tiled range of the array
+  /// \param pmap A shared pointer to the array process map
+  /// \param op The tile function/functor
+  /// \param batch_size The number of tiles initialized by each task
+  /// [ default = about 8 tasks per thread ]
+  /// \return An array object of type `Array`
+  template <typename Array, typename Op,
+      typename std::enable_if<is_dense<Array>::value>::type* = nullptr>
+  inline Array
+  make_array_batched(World& world, const detail::trange_t<Array>& trange,
+      const std::shared_ptr<detail::pmap_t<Array> >& pmap, Op&& op,
+      std::size_t batch_size = 0ul)
+  {
+    typedef typename Array::value_type value_type;
+    typedef typename Array::size_type size_type;
+    typedef typename detail::numeric_type<value_type>::type numeric_type;
+
+    // Make an empty result array
+    Array result(world, trange, pmap);
+
+    const std::vector<size_type> local(pmap->begin(), pmap->end());
+    if(batch_size == 0ul)
+      batch_size = detail::make_array_batch_size(local.size());
+
+    for(std::size_t first = 0ul; first < local.size(); first += batch_size) {
+      const std::size_t last = std::min(first + batch_size, local.size());
+
+      // Store the result tiles, which are set by the task
+      std::vector<Future<value_type> > tiles(last - first);
+      for(std::size_t i = first; i < last; ++i)
+        result.set(local[i], tiles[i - first]);
+
+      // Spawn a task to evaluate the batch of tiles
+      const std::vector<size_type> indices(local.begin() + first, local.begin() + last);
+      world.taskq.add([=] () mutable {
+        std::vector<numeric_type>& scratch =
+            detail::make_array_scratch<numeric_type>();
+        for(std::size_t i = 0ul; i < indices.size(); ++i) {
+          value_type tile;
+          op(tile, result.trange().make_tile_range(indices[i]), scratch);
+          tiles[i].set(std::move(tile));
+        }
+      });
+    }
+
+    return result;
+  }
+
+  /// Construct a sparse Array with batched tasks
+
+  /// This function is equivalent to \c make_array() , but each task
+  /// initializes a batch of local tiles, which reduces the task overhead
+  /// when there are many small tiles. The tile operation returns the norm
+  /// of the tile it initializes, and it is given a scratch buffer that is
+  /// reused by the tiles initialized by a thread. The shape is constructed
+  /// with a single reduction of the norms. The expected signature of the
+  /// tile operation is:
+  /// \code
+  /// value_t op(tile_t& tile, const range_t& range, std::vector<numeric_t>& scratch);
+  /// \endcode
+  /// where `numeric_t` is the numeric type of `tile_t`. Tiles with a zero
+  /// norm need not be initialized.
+  /// \tparam Array The `DistArray` type
+  /// \tparam Op Tile operation
+  /// \param world The world where the array will live
+  /// \param trange The tiled range of the array
+  /// \param pmap A shared pointer to the array process map
+  /// \param op The tile function/functor
+  /// \param batch_size The number of tiles initialized by each task
+  /// [ default = about 8 tasks per thread ]
+  /// \return An array object of type `Array`
+  template <typename Array, typename Op,
+      typename std::enable_if<! is_dense<Array>::value>::type* = nullptr>
+  inline Array
+  make_array_batched(World& world, const detail::trange_t<Array>& trange,
+      const std::shared_ptr<detail::pmap_t<Array> >& pmap, Op&& op,
+      std::size_t batch_size = 0ul)
+  {
+    typedef typename Array::value_type value_type;
+    typedef typename Array::size_type size_type;
+    typedef typename detail::numeric_type<value_type>::type numeric_type;
+
+    const std::vector<size_type> local(pmap->begin(), pmap->end());
+    if(batch_size == 0ul)
+      batch_size = detail::make_array_batch_size(local.size());
+
+    // Construct a tensor to hold updated tile norms for the result shape.
+    TiledArray::Tensor<typename detail::shape_t<Array>::value_type,
+        default_allocator<typename detail::shape_t<Array>::value_type> >
+    tile_norms(trange.tiles_range(), 0);
+    std::vector<value_type> tiles(local.size());
+
+    // Construct the task function used to construct the batches of tiles.
+    madness::AtomicInt counter; counter = 0;
+    int task_count = 0;
+    auto task = [&] (const std::size_t first, const std::size_t last) {
+      std::vector<numeric_type>& scratch =
+          detail::make_array_scratch<numeric_type>();
+      for(std::size_t i = first; i < last; ++i)
+        tile_norms[local[i]] = op(tiles[i], trange.make_tile_range(local[i]), scratch);
+      ++counter;
+    };
+
+    for(std::size_t first = 0ul; first < local.size(); first += batch_size) {
+      world.taskq.add(task, first, std::min(first + batch_size, local.size()));
+      ++task_count;
+    }
+
+    // Wait for tile norm data to be collected.
+    if(task_count > 0)
+      world.await([&counter,task_count] () -> bool { return counter == task_count; });
+
+    // Construct the new array
+    Array result(world, trange,
+        typename Array::shape_type(world, tile_norms, trange), pmap);
+    for(std::size_t i = 0ul; i < local.size(); ++i)
+      if(! result.is_zero(local[i]))
+        result.set(local[i], std::move(tiles[i]));
+
+    return result;
+  }
+
+  namespace detail {
+
+    /// Owner of the external buffers of an array view
+
+    /// The release function is called when the last tile that aliases the
+    /// buffers is destroyed.
+    class ArrayViewOwner {
+      std::function<void()> release_; ///< The release function
+
+    public:
+      explicit ArrayViewOwner(std::function<void()> release) :
+        release_(std::move(release))
+      { }
+
+      ArrayViewOwner(const ArrayViewOwner&) = delete;
+      ArrayViewOwner& operator=(const ArrayViewOwner&) = delete;
+
+      ~ArrayViewOwner() {
+        if(release_)
+          release_();
+      }
+    }; // class ArrayViewOwner
+
+  }  // namespace detail
+
+  /// Construct an Array whose local tiles alias external buffers
+
+  /// The local tiles of the result are views of tile-contiguous buffers
+  /// that are owned by the caller, e.g. the output of an integral engine,
+  /// so no element is copied. The buffer of each local tile holds the
+  /// elements of the tile in row-major order of the tile range. The
+  /// buffers must stay valid until \c release is called, which happens
+  /// when the last tile that aliases them is destroyed; tiles that are
+  /// evaluated from the array (e.g. by an expression) are new tensors,
+  /// which do not alias the buffers. The expected signature of the buffer
+  /// function is:
+  /// \code
+  /// numeric_t* op(std::size_t index);
+  /// \endcode
+  /// where `numeric_t` is the numeric type of the tiles, and \c index is
+  /// the ordinal of a local tile. For a sparse array, \c op returns
+  /// \c nullptr for a zero tile, and the shape is computed from the norms
+  /// of the other tiles. A single tile may be made the same way with the
+  /// shared-memory \c Tensor constructor.
+  /// \tparam Array The `DistArray` type, with \c Tensor tiles
+  /// \tparam Op The buffer function type
+  /// \param world The world where the array will live
+  /// \param trange The tiled range of the array
+  /// \param pmap A shared pointer to the array process map
+  /// \param op The buffer function/functor
+  /// \param release The function that is called when the buffers are no
+  /// longer used [ default = none ]
+  /// \return An array object of type `Array`
+  template <typename Array, typename Op>
+  inline Array
+  make_array_view(World& world, const detail::trange_t<Array>& trange,
+      const std::shared_ptr<detail::pmap_t<Array> >& pmap, Op&& op,
+      std::function<void()> release = std::function<void()>())
+  {
+    typedef typename Array::value_type value_type;
+    typedef typename Array::size_type size_type;
+
+    // The tiles share the owner of the buffers
+    const std::shared_ptr<void> owner =
+        std::make_shared<detail::ArrayViewOwner>(std::move(release));
+
+    const std::vector<size_type> local(pmap->begin(), pmap->end());
+    std::vector<value_type> tiles(local.size());
+    for(std::size_t i = 0ul; i < local.size(); ++i) {
+      const auto data = op(local[i]);
+      TA_USER_ASSERT(data || ! is_dense<Array>::value,
+          "TiledArray::make_array_view(): the tiles of a dense array must have a buffer");
+      if(data)
+        tiles[i] = value_type(trange.make_tile_range(local[i]), owner, data);
+    }
+
+    // Compute the norms of the non-zero tiles of a sparse array in batches
+    typename Array::shape_type shape;
+    if(! is_dense<Array>::value) {
+      TiledArray::Tensor<typename detail::shape_t<Array>::value_type,
+          default_allocator<typename detail::shape_t<Array>::value_type> >
+      tile_norms(trange.tiles_range(), 0);
+
+      madness::AtomicInt counter; counter = 0;
+      int task_count = 0;
+      auto task = [&] (const std::size_t first, const std::size_t last) {
+        for(std::size_t i = first; i < last; ++i)
+          if(! tiles[i].empty())
+            tile_norms[local[i]] = tiles[i].norm();
+        ++counter;
+      };
+      const std::size_t batch_size = detail::make_array_batch_size(local.size());
+      for(std::size_t first = 0ul; first < local.size(); first += batch_size) {
+        world.taskq.add(task, first, std::min(first + batch_size, local.size()));
+        ++task_count;
+      }
+      if(task_count > 0)
+        world.await([&counter,task_count] () -> bool { return counter == task_count; });
+
+      shape = typename Array::shape_type(world, tile_norms, trange);
+    }
+
+    // Construct the new array
+    Array result(world, trange, shape, pmap);
+    for(std::size_t i = 0ul; i < local.size(); ++i)
+      if(! result.is_zero(local[i]))
+        result.set(local[i], std::move(tiles[i]));
+
+    return result;
+  }
+
 } // namespace TiledArray
 
 #endif // TILEDARRAY_CONVERSIONS_MAKE_ARRAY_H__INCLUDED
@@ -0,0 +1,136 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_CONVERSIONS_REBALANCE_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_REBALANCE_H__INCLUDED
+
+#include <TiledArray/pmap/weighted_pmap.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Forward declarations
+  template <typename, typename> class DistArray;
+
+  /// Load imbalance of a process map
+
+  /// \param pmap The process map
+  /// \param weights The weight of each tile, e.g. its work or its volume
+  /// \return The ratio of the largest load of a process to the average load,
+  /// minus one, or zero if all weights are zero
+  inline double imbalance(const Pmap& pmap,
+      const std::vector<std::size_t>& weights)
+  {
+    TA_ASSERT(weights.size() == pmap.size());
+    std::vector<double> load(pmap.procs(), 0.0);
+    double total = 0.0;
+    for(std::size_t i = 0ul; i < weights.size(); ++i) {
+      load[pmap.owner(i)] += weights[i];
+      total += weights[i];
+    }
+    if(total == 0.0)
+      return 0.0;
+    const double max_load = *std::max_element(load.begin(), load.end());
+    return max_load * double(pmap.procs()) / total - 1.0;
+  }
+
+  /// The tile weights of an array
+
+  /// The weight of a tile is the work that was measured for it, e.g. the
+  /// number of operations or microseconds of the evaluations that produced
+  /// or used it in the previous iteration, or, when no work is given, the
+  /// number of elements of the tile, or zero for a zero tile.
+  /// \tparam Tile The tile type of the array
+  /// \tparam Policy The policy type of the array
+  /// \param array The array
+  /// \param local_work The work of each local tile, indexed by the ordinal
+  /// of the tile, or an empty vector; the entries of non-local tiles are
+  /// ignored
+  /// \return The weight of each tile, which is the same on all processes
+  /// \note This function is collective when \c local_work is not empty.
+  template <typename Tile, typename Policy>
+  inline std::vector<std::size_t>
+  tile_weights(const DistArray<Tile, Policy>& array,
+      const std::vector<std::size_t>& local_work = std::vector<std::size_t>())
+  {
+    const std::size_t size = array.size();
+    std::vector<std::size_t> weights(size, 0ul);
+    if(local_work.empty()) {
+      for(std::size_t i = 0ul; i < size; ++i)
+        if(! array.is_zero(i))
+          weights[i] = array.trange().make_tile_range(i).volume();
+    } else {
+      TA_USER_ASSERT(local_work.size() == size,
+          "TiledArray::tile_weights(): the work must be given for every tile.");
+      for(const auto i : *array.pmap())
+        weights[i] = local_work[i];
+      array.world().gop.sum(weights.data(), size);
+    }
+    return weights;
+  }
+
+  /// Rebalance the tiles of an array when its load is imbalanced
+
+  /// The load of each process is the sum of the weights of its tiles (see
+  /// \c tile_weights ). When the imbalance of the load exceeds
+  /// \c threshold , a \c WeightedPmap is constructed from the weights and
+  /// the tiles are migrated to it with \c DistArray::redistribute . This is
+  /// intended to be called between the iterations of a solver, e.g. when the
+  /// sparsity of the amplitudes changes.
+  /// \tparam Tile The tile type of the array
+  /// \tparam Policy The policy type of the array
+  /// \param[in,out] array The array to rebalance
+  /// \param threshold The largest acceptable imbalance, as a fraction of the
+  /// average load [ default = 0.1 ]
+  /// \param local_work The work of each local tile that was measured by
+  /// recent evaluations, or an empty vector to balance the memory of the
+  /// non-zero tiles [ default = empty ]
+  /// \return \c true if the tiles were migrated
+  /// \note This function is collective.
+  template <typename Tile, typename Policy>
+  inline bool rebalance(DistArray<Tile, Policy>& array,
+      const double threshold = 0.1,
+      const std::vector<std::size_t>& local_work = std::vector<std::size_t>())
+  {
+    TA_USER_ASSERT(threshold >= 0.0,
+        "TiledArray::rebalance(): the threshold must be non-negative.");
+    if(array.world().size() == 1)
+      return false;
+
+    const std::vector<std::size_t> weights = tile_weights(array, local_work);
+    if(imbalance(*array.pmap(), weights) <= threshold)
+      return false;
+
+    const std::shared_ptr<Pmap> pmap =
+        std::make_shared<detail::WeightedPmap>(array.world(), weights);
+
+    // Only migrate the tiles when the new map improves the balance
+    if(imbalance(*pmap, weights) >= imbalance(*array.pmap(), weights))
+      return false;
+
+    array = array.redistribute(pmap);
+    array.world().gop.fence();
+    return true;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_REBALANCE_H__INCLUDED
@@ -0,0 +1,226 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  retile.h
+ *
+ */
+
+#ifndef TILEDARRAY_CONVERSIONS_RETILE_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_RETILE_H__INCLUDED
+
+#include "../dist_array.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// A block of an old tile that is copied into a new tile
+    struct RetileBlock {
+      std::vector<std::size_t> lower; ///< The lower bound of the block
+      std::vector<std::size_t> upper; ///< The upper bound of the block
+    }; // struct RetileBlock
+
+    /// Check that two tiled ranges cover the same elements
+
+    /// \param trange1 The first tiled range
+    /// \param trange2 The second tiled range
+    /// \return \c true if the element ranges of \c trange1 and \c trange2
+    /// are equal
+    inline bool is_same_elements(const TiledRange& trange1, const TiledRange& trange2) {
+      if(trange1.rank() != trange2.rank())
+        return false;
+      for(std::size_t d = 0ul; d < trange1.rank(); ++d)
+        if(trange1.data()[d].elements_range() != trange2.data()[d].elements_range())
+          return false;
+      return true;
+    }
+
+    /// Spawn the tasks that assemble the local tiles of a retiled array
+
+    /// Each new tile is assembled from the blocks of the old tiles that it
+    /// overlaps. Each old tile that is needed by this process is fetched
+    /// once, even when it overlaps several local new tiles, and zero old
+    /// tiles are not fetched. A new tile that only overlaps zero old tiles
+    /// is not computed.
+    /// \tparam Tile The tile type, which must be constructible from a range
+    /// and a value, and provide \c block()
+    /// \tparam Policy The array policy type
+    /// \param array The array to be retiled
+    /// \param trange The new tiled range
+    /// \param pmap The process map of the new array
+    /// \param[out] tile_norms The norms of the new tiles, if not null
+    /// \param[out] counter Incremented when a norm is computed
+    /// \return The ordinal indices and futures of the local new tiles
+    template <typename Tile, typename Policy>
+    std::vector<std::pair<std::size_t, Future<Tile> > >
+    retile_tiles(const DistArray<Tile, Policy>& array, const TiledRange& trange,
+        const std::shared_ptr<typename Policy::pmap_interface>& pmap,
+        TiledArray::Tensor<float>* tile_norms, madness::AtomicInt* counter)
+    {
+      typedef typename DistArray<Tile, Policy>::size_type size_type;
+      typedef typename Tile::value_type value_type;
+
+      World& world = array.world();
+      const TiledRange& old_trange = array.trange();
+      const std::size_t rank = trange.rank();
+
+      std::unordered_map<size_type, Future<Tile> > cache;
+      std::vector<std::pair<std::size_t, Future<Tile> > > result;
+      result.reserve(pmap->local_size());
+
+      std::vector<std::size_t> tile_lower(rank), tile_upper(rank);
+      for(const size_type ord : *pmap) {
+        const Range range = trange.make_tile_range(ord);
+
+        // The old tiles that overlap the new tile
+        for(std::size_t d = 0ul; d < rank; ++d) {
+          const TiledRange1& old_trange1 = old_trange.data()[d];
+          tile_lower[d] = old_trange1.element_to_tile(range.lobound_data()[d]);
+          tile_upper[d] = old_trange1.element_to_tile(range.upbound_data()[d] - 1ul) + 1ul;
+        }
+
+        std::vector<Future<Tile> > tiles;
+        std::vector<RetileBlock> blocks;
+        for(const auto& index : Range(tile_lower, tile_upper)) {
+          const size_type old_ord = old_trange.tiles_range().ordinal(index);
+          if(array.is_zero(old_ord))
+            continue;
+
+          auto it = cache.find(old_ord);
+          if(it == cache.end())
+            it = cache.emplace(old_ord, array.find(old_ord)).first;
+          tiles.push_back(it->second);
+
+          // The overlap of the new and the old tile
+          const Range old_range = old_trange.make_tile_range(old_ord);
+          RetileBlock block;
+          for(std::size_t d = 0ul; d < rank; ++d) {
+            block.lower.push_back(std::max(range.lobound_data()[d], old_range.lobound_data()[d]));
+            block.upper.push_back(std::min(range.upbound_data()[d], old_range.upbound_data()[d]));
+          }
+          blocks.push_back(std::move(block));
+        }
+        if(tiles.empty())
+          continue;
+
+        auto task = [range,blocks,ord,tile_norms,counter]
+            (const std::vector<Future<Tile> >& old_tiles) -> Tile
+        {
+          Tile tile(range, value_type(0));
+          for(std::size_t i = 0ul; i < old_tiles.size(); ++i) {
+            const Tile& old_tile = old_tiles[i].get();
+            tile.block(blocks[i].lower, blocks[i].upper) =
+                old_tile.block(blocks[i].lower, blocks[i].upper);
+          }
+          if(tile_norms) {
+            (*tile_norms)[ord] = tile.norm();
+            ++(*counter);
+          }
+          return tile;
+        };
+        result.emplace_back(ord, world.taskq.add(task, tiles));
+      }
+
+      return result;
+    }
+
+  }  // namespace detail
+
+  /// Change the tiling of a dense array
+
+  /// Each new tile is assembled, by the process that owns it, from the
+  /// blocks of the old tiles that it overlaps; each old tile is fetched at
+  /// most once by each process.
+  /// \tparam Tile The tile type of the array
+  /// \param array The array to be retiled
+  /// \param trange The new tiled range, which must cover the same elements
+  /// as the tiled range of \c array
+  /// \param pmap The process map of the result [ default = the default
+  /// process map ]
+  /// \return An array with the data of \c array and tiled range \c trange
+  template <typename Tile>
+  inline DistArray<Tile, DensePolicy>
+  retile(const DistArray<Tile, DensePolicy>& array, const TiledRange& trange,
+      std::shared_ptr<typename DensePolicy::pmap_interface> pmap =
+          std::shared_ptr<typename DensePolicy::pmap_interface>())
+  {
+    TA_USER_ASSERT(detail::is_same_elements(array.trange(), trange),
+        "TiledArray::retile(): the tiled ranges must cover the same elements");
+    World& world = array.world();
+    if(! pmap)
+      pmap = DensePolicy::default_pmap(world, trange.tiles_range().volume());
+
+    DistArray<Tile, DensePolicy> result(world, trange, pmap);
+    for(const auto& tile : detail::retile_tiles(array, trange, pmap, nullptr, nullptr))
+      result.set(tile.first, tile.second);
+
+    return result;
+  }
+
+  /// Change the tiling of a sparse array
+
+  /// Each new tile is assembled, by the process that owns it, from the
+  /// blocks of the non-zero old tiles that it overlaps; each old tile is
+  /// fetched at most once by each process, and a new tile that only
+  /// overlaps zero tiles is zero. The shape of the result is computed from
+  /// the norms of the new tiles, with a single reduction, and it has the
+  /// zero threshold of the shape of \c array .
+  /// \tparam Tile The tile type of the array
+  /// \param array The array to be retiled
+  /// \param trange The new tiled range, which must cover the same elements
+  /// as the tiled range of \c array
+  /// \param pmap The process map of the result [ default = the default
+  /// process map ]
+  /// \return An array with the data of \c array and tiled range \c trange
+  template <typename Tile>
+  inline DistArray<Tile, SparsePolicy>
+  retile(const DistArray<Tile, SparsePolicy>& array, const TiledRange& trange,
+      std::shared_ptr<typename SparsePolicy::pmap_interface> pmap =
+          std::shared_ptr<typename SparsePolicy::pmap_interface>())
+  {
+    typedef typename DistArray<Tile, SparsePolicy>::shape_type shape_type;
+
+    TA_USER_ASSERT(detail::is_same_elements(array.trange(), trange),
+        "TiledArray::retile(): the tiled ranges must cover the same elements");
+    World& world = array.world();
+    if(! pmap)
+      pmap = SparsePolicy::default_pmap(world, trange.tiles_range().volume());
+
+    TiledArray::Tensor<float> tile_norms(trange.tiles_range(), 0.0f);
+    madness::AtomicInt counter; counter = 0;
+    const auto tiles = detail::retile_tiles(array, trange, pmap, &tile_norms, &counter);
+
+    // Wait for the tile norms
+    const int task_count = tiles.size();
+    if(task_count > 0)
+      world.await([&counter,task_count] () -> bool { return counter == task_count; });
+
+    DistArray<Tile, SparsePolicy> result(world, trange,
+        shape_type(world, tile_norms, trange, array.shape().zero_threshold()), pmap);
+    for(const auto& tile : tiles)
+      if(! result.is_zero(tile.first))
+        result.set(tile.first, tile.second);
+
+    return result;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_RETILE_H__INCLUDED
@@ -26,6 +26,8 @@
 #ifndef TILEDARRAY_CONVERSIONS_TO_NEW_TILE_TYPE_H__INCLUDED
 #define TILEDARRAY_CONVERSIONS_TO_NEW_TILE_TYPE_H__INCLUDED
 
+#include <utility>
+#include <vector>
 #include "../dist_array.h"
 
 namespace TiledArray {
@@ -67,5 +69,60 @@ namespace TiledArray {
     return new_array;
   }
 
+  /// Function to convert an array to a new array with a different tile type,
+  /// consuming the original array.
+
+  /// The tiles of \c old_array are passed to \c op as rvalues, and
+  /// \c old_array is released once the tile futures have been collected,
+  /// so its tiles are only referenced by the conversion tasks. When \c op
+  /// wraps or unwraps the tile data, e.g. <tt>Tensor<T></tt> to
+  /// <tt>Tile<Tensor<T> ></tt> , the new tiles reuse the buffers of the
+  /// original tiles, and the conversion does not need memory for a second
+  /// copy of the array.
+  /// \tparam Tile The array tile type
+  /// \tparam Policy The array policy type
+  /// \tparam Op The tile conversion operation type, which may take its
+  /// argument by rvalue reference
+  /// \param old_array The array to be converted; it is empty on return
+  /// \param op The tile type conversion operation
+  template <typename Tile, typename Policy, typename Op>
+  inline DistArray<typename std::result_of<Op(Tile)>::type, Policy>
+  to_new_tile_type(DistArray<Tile, Policy>&& old_array, Op &&op) {
+    using OutTileType = typename std::result_of<Op(Tile)>::type;
+    using OutArray = DistArray<OutTileType, Policy>;
+    using size_type = typename DistArray<Tile, Policy>::size_type;
+
+    static_assert(!std::is_same<Tile, OutTileType>::value,
+        "Can't call new tile type if tile type does not change.");
+
+    auto &world = old_array.world();
+
+    // Create new array
+    OutArray new_array(world, old_array.trange(), old_array.shape(), old_array.pmap());
+
+    // Collect the local tiles
+    std::vector<std::pair<size_type, Future<Tile> > > tiles;
+    tiles.reserve(old_array.pmap()->local_size());
+    for(const size_type index : *old_array.pmap()) {
+      // Must check for zero because pmap_iter does not.
+      if(!old_array.is_zero(index))
+        tiles.emplace_back(index, old_array.find(index));
+    }
+
+    // Release the original array
+    old_array = DistArray<Tile, Policy>();
+
+    auto task = [op] (const Tile& tile) -> OutTileType {
+      Tile arg = tile; // Shallow copy of the tile data
+      return op(std::move(arg));
+    };
+    for(auto& tile : tiles) {
+      // Spawn a task to evaluate the tile
+      new_array.set(tile.first, world.taskq.add(task, std::move(tile.second)));
+    }
+
+    return new_array;
+  }
+
 } // namespace TiledArray
 #endif // TILEDARRAY_CONVERSIONS_TO_NEW_TILE_TYPE_H__INCLUDED
@@ -43,19 +43,44 @@ namespace TiledArray {
   template <typename Tile>
   inline void truncate(DistArray<Tile, DensePolicy>& array) { }
 
-  /// Truncate a sparse Array
+  /// Truncate a dense Array
+
+  /// This is a no op
+  /// \tparam Tile The tile type of the array
+  /// \param[in,out] array The array object to be truncated
+  /// \param threshold The zero threshold
+  template <typename Tile, typename T>
+  inline void truncate(DistArray<Tile, DensePolicy>& array, const T threshold) { }
 
+  /// Truncate a sparse Array with a given zero threshold
+
+  /// Tiles whose norm per element is less than \c threshold are dropped,
+  /// and \c threshold becomes the zero threshold of the array shape, so it
+  /// is carried to the results of expressions that use \c array .
   /// \tparam Tile The tile type of the array
   /// \param[in,out] array The array object to be truncated
+  /// \param threshold The zero threshold of the truncated array
   template <typename Tile>
-  inline void truncate(DistArray<Tile, SparsePolicy>& array) {
+  inline void truncate(DistArray<Tile, SparsePolicy>& array,
+      const typename DistArray<Tile, SparsePolicy>::shape_type::value_type threshold)
+  {
     typedef typename DistArray<Tile, SparsePolicy>::value_type value_type;
     array =
         foreach(array, [] (value_type& result_tile, const value_type& arg_tile) {
           typename detail::scalar_type<value_type>::type norm = arg_tile.norm();
           result_tile = arg_tile; // Assume this is shallow copy
           return norm;
-        });
+        }, threshold);
+  }
+
+  /// Truncate a sparse Array
+
+  /// The array is truncated with the zero threshold of its shape.
+  /// \tparam Tile The tile type of the array
+  /// \param[in,out] array The array object to be truncated
+  template <typename Tile>
+  inline void truncate(DistArray<Tile, SparsePolicy>& array) {
+    truncate(array, array.shape().zero_threshold());
   }
 
 } // namespace TiledArray
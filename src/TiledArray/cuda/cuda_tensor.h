@@ -0,0 +1,964 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  cuda_tensor.h
+ *
+ */
+
+#ifndef TILEDARRAY_CUDA_CUDA_TENSOR_H__INCLUDED
+#define TILEDARRAY_CUDA_CUDA_TENSOR_H__INCLUDED
+
+#include <TiledArray/config.h>
+
+#ifdef TILEDARRAY_HAS_CUDA
+
+#include <TiledArray/external/cuda.h>
+#include <TiledArray/cuda/kernels.h>
+#include <TiledArray/tensor/tensor.h>
+#include <TiledArray/math/gemm_helper.h>
+#include <TiledArray/conversions/to_new_tile_type.h>
+#include <TiledArray/tile_interface/async.h>
+#include <array>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+
+  /// A tensor that is stored in GPU memory
+
+  /// \c CudaTensor implements the tile interface of \c Tensor with cuBLAS
+  /// (\c gemm , \c add , \c subt , \c mult , \c scale , \c neg , and the
+  /// norms) and with device kernels (\c permute ), so arrays of
+  /// \c CudaTensor tiles are evaluated by expressions on the GPU, and their
+  /// tiles stay in device memory between operations. Only serialization,
+  /// the conversion to \c Tensor , and the reductions other than the norms
+  /// and the dot product copy the data to the host. The data is shallow
+  /// copied, like that of \c Tensor ; use \c clone() for a deep copy.
+  /// The operations are queued on the stream of the calling thread, which
+  /// is synchronized before the operation returns, unless synchronization
+  /// is deferred (see \c async_trait ).
+  /// \tparam T The element type, \c float or \c double
+  /// \tparam Allocator The allocator of the data, \c cuda::device_allocator
+  /// for device memory or \c cuda::um_allocator for unified memory
+  template <typename T, typename Allocator = cuda::device_allocator<T> >
+  class CudaTensor {
+    static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+        "CudaTensor<T>: T must be float or double");
+
+  public:
+    typedef CudaTensor<T, Allocator> CudaTensor_; ///< This class type
+    typedef Range range_type; ///< Tensor range type
+    typedef typename range_type::size_type size_type; ///< Size type
+    typedef Allocator allocator_type; ///< Allocator type
+    typedef T value_type; ///< Element type
+    typedef T numeric_type; ///< The scalar type used for scaling
+    typedef T scalar_type; ///< The norm type
+    typedef T* pointer; ///< Device pointer type
+    typedef const T* const_pointer; ///< Device const pointer type
+
+  private:
+    range_type range_; ///< The range of the tensor
+    std::shared_ptr<T> data_; ///< The device data of the tensor
+
+    /// Allocate device data
+
+    /// \param n The number of elements
+    /// \return A shared pointer to \c n elements of uninitialized data
+    static std::shared_ptr<T> allocate(const size_type n) {
+      return std::shared_ptr<T>(allocator_type().allocate(n),
+          [n] (T* const ptr) { allocator_type().deallocate(ptr, n); });
+    }
+
+    /// Copy data between the host and the device, or within the device
+    static void copy(T* const dst, const T* const src, const size_type n) {
+      cuda::check(cudaMemcpy(dst, src, n * sizeof(T), cudaMemcpyDefault));
+    }
+
+    /// Queue a copy of this tensor
+
+    /// \param ctx The context of the calling thread
+    /// \return A tensor that is filled with the data of this tensor when
+    /// the stream of \c ctx is synchronized
+    CudaTensor_ copy(cuda::ThreadContext& ctx) const {
+      CudaTensor_ result(range_);
+      cuda::check(cudaMemcpyAsync(result.data(), data(), size() * sizeof(T),
+          cudaMemcpyDefault, ctx.stream()));
+      return result;
+    }
+
+    /// Queue a permuted copy of this tensor
+
+    /// \param ctx The context of the calling thread
+    /// \param perm The permutation to be applied to this tensor
+    /// \return A tensor that is filled with the permuted data of this tensor
+    /// when the stream of \c ctx is synchronized
+    CudaTensor_ permute(cuda::ThreadContext& ctx, const Permutation& perm) const {
+      TA_ASSERT(perm.dim() == range_.rank());
+      TA_USER_ASSERT(range_.rank() <= cuda::max_rank,
+          "CudaTensor::permute(): the rank of the tensor is too large");
+      CudaTensor_ result(perm * range_);
+
+      const unsigned int rank = range_.rank();
+      std::vector<std::size_t> extent(rank), result_stride(rank);
+      for(unsigned int d = 0u; d < rank; ++d) {
+        extent[d] = range_.extent_data()[d];
+        result_stride[d] = result.range_.stride_data()[perm[d]];
+      }
+      cuda::check(cuda::permute(data(), result.data(), rank, extent.data(),
+          result_stride.data(), size(), ctx.stream()));
+      return result;
+    }
+
+    /// Apply an operation to a copy of this tensor
+
+    /// \tparam Op The operation type
+    /// \param op The operation, <tt>op(ctx, result)</tt> , that queues the
+    /// modification of \c result
+    /// \return The result of \c op
+    template <typename Op>
+    CudaTensor_ apply(Op&& op) const {
+      TA_ASSERT(! empty());
+      cuda::ThreadContext& ctx = cuda::ThreadContext::instance();
+      CudaTensor_ result = copy(ctx);
+      op(ctx, result);
+      ctx.complete();
+      return result;
+    }
+
+    /// Apply an operation to a copy of this tensor, and permute the result
+
+    /// \tparam Op The operation type
+    /// \param op The operation, <tt>op(ctx, result)</tt> , that queues the
+    /// modification of \c result
+    /// \param perm The permutation to be applied to the result of \c op
+    /// \return The permuted result of \c op
+    template <typename Op>
+    CudaTensor_ apply(Op&& op, const Permutation& perm) const {
+      TA_ASSERT(! empty());
+      cuda::ThreadContext& ctx = cuda::ThreadContext::instance();
+      CudaTensor_ temp = copy(ctx);
+      op(ctx, temp);
+      CudaTensor_ result = temp.permute(ctx, perm);
+      ctx.complete();
+      return result;
+    }
+
+    /// Apply an operation to this tensor
+
+    /// \tparam Op The operation type
+    /// \param op The operation, <tt>op(ctx, *this)</tt> , that queues the
+    /// modification of this tensor
+    /// \return A reference to this tensor
+    template <typename Op>
+    CudaTensor_& apply_to(Op&& op) {
+      TA_ASSERT(! empty());
+      cuda::ThreadContext& ctx = cuda::ThreadContext::instance();
+      op(ctx, *this);
+      ctx.complete();
+      return *this;
+    }
+
+    /// Check that \c other has the range of this tensor
+    void check_congruent(const CudaTensor_& other) const {
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(other.range() == range_);
+    }
+
+  public:
+
+    /// Construct an empty tensor
+    CudaTensor() = default;
+
+    /// Construct a tensor with uninitialized data
+
+    /// \param range The range of the tensor
+    explicit CudaTensor(const range_type& range) :
+      range_(range), data_(allocate(range.volume()))
+    { }
+
+    /// Construct a tensor with all elements equal to \c value
+
+    /// \param range The range of the tensor
+    /// \param value The value of the elements
+    CudaTensor(const range_type& range, const value_type value) :
+      range_(range), data_(allocate(range.volume()))
+    {
+      cuda::ThreadContext& ctx = cuda::ThreadContext::instance();
+      cuda::check(cudaMemsetAsync(data(), 0, size() * sizeof(T), ctx.stream()));
+      if(value != value_type(0))
+        cuda::check(cuda::add_to(data(), value, size(), ctx.stream()));
+      ctx.complete();
+    }
+
+    /// Copy a host tensor to the device
+
+    /// \tparam A The allocator type of \c other
+    /// \param other The host tensor
+    template <typename A>
+    explicit CudaTensor(const Tensor<T, A>& other) :
+      range_(other.range()), data_()
+    {
+      if(! other.empty()) {
+        data_ = allocate(other.size());
+        copy(data(), other.data(), other.size());
+      }
+    }
+
+    /// Copy this tensor to the host
+
+    /// \tparam A The allocator type of the host tensor
+    /// \return A host tensor with the data of this tensor
+    template <typename A>
+    explicit operator Tensor<T, A>() const {
+      if(empty())
+        return Tensor<T, A>();
+      Tensor<T, A> result(range_);
+      copy(result.data(), data(), size());
+      return result;
+    }
+
+    /// Create a deep copy of this tensor
+
+    /// \return A tensor with a copy of the data of this tensor
+    CudaTensor_ clone() const {
+      if(empty())
+        return CudaTensor_();
+      cuda::ThreadContext& ctx = cuda::ThreadContext::instance();
+      CudaTensor_ result = copy(ctx);
+      ctx.complete();
+      return result;
+    }
+
+    /// Tensor range accessor
+
+    /// \return The range of this tensor
+    const range_type& range() const { return range_; }
+
+    /// Tensor size accessor
+
+    /// \return The number of elements in this tensor
+    size_type size() const { return range_.volume(); }
+
+    /// Test for an empty tensor
+
+    /// \return \c true if this tensor has no data
+    bool empty() const { return ! data_; }
+
+    /// Device data accessor
+
+    /// \return The device pointer to the data of this tensor
+    pointer data() { return data_.get(); }
+
+    /// Device data accessor
+
+    /// \return The device pointer to the data of this tensor
+    const_pointer data() const { return data_.get(); }
+
+    /// Serialize the tensor
+
+    /// The data is staged in the pinned host buffer of the calling thread.
+    /// \tparam Archive The output archive type
+    /// \param[out] ar The output archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_output_archive<Archive>::value>::type* = nullptr>
+    void serialize(Archive& ar) {
+      if(data_) {
+        const size_type n = size();
+        cuda::ThreadContext& ctx = cuda::ThreadContext::instance();
+        T* const buffer = static_cast<T*>(ctx.host_buffer(n * sizeof(T)));
+        cuda::check(cudaMemcpyAsync(buffer, data(), n * sizeof(T),
+            cudaMemcpyDefault, ctx.stream()));
+        ctx.synchronize();
+        ar & n & madness::archive::wrap(buffer, n) & range_;
+      } else {
+        ar & size_type(0ul);
+      }
+    }
+
+    /// Deserialize the tensor
+
+    /// The data is staged in the pinned host buffer of the calling thread,
+    /// so the transfer of a received tile to the device is asynchronous and
+    /// overlaps with the operations on the streams of other threads, e.g.
+    /// the GEMMs of the previous SUMMA step.
+    /// \tparam Archive The input archive type
+    /// \param[out] ar The input archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_input_archive<Archive>::value>::type* = nullptr>
+    void serialize(Archive& ar) {
+      size_type n = 0ul;
+      ar & n;
+      if(n) {
+        cuda::ThreadContext& ctx = cuda::ThreadContext::instance();
+        T* const buffer = static_cast<T*>(ctx.host_buffer(n * sizeof(T)));
+        ar & madness::archive::wrap(buffer, n) & range_;
+        data_ = allocate(n);
+        cuda::check(cudaMemcpyAsync(data(), buffer, n * sizeof(T),
+            cudaMemcpyDefault, ctx.stream()));
+        ctx.synchronize();
+      } else {
+        range_ = range_type();
+        data_.reset();
+      }
+    }
+
+    /// Swap tensor data
+
+    /// \param other The tensor to swap with this
+    void swap(CudaTensor_& other) {
+      std::swap(range_, other.range_);
+      std::swap(data_, other.data_);
+    }
+
+    // Permutation operations
+
+    /// Create a permuted copy of this tensor
+
+    /// \param perm The permutation to be applied to this tensor
+    /// \return A permuted copy of this tensor
+    CudaTensor_ permute(const Permutation& perm) const {
+      TA_ASSERT(! empty());
+      cuda::ThreadContext& ctx = cuda::ThreadContext::instance();
+      CudaTensor_ result = permute(ctx, perm);
+      ctx.complete();
+      return result;
+    }
+
+    // Scaling operations
+
+    /// Scale this tensor
+
+    /// \param factor The scaling factor
+    /// \return A new tensor where the elements are scaled by \c factor
+    CudaTensor_ scale(const numeric_type factor) const {
+      return apply([=] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::scal(ctx.handle(), result.size(), factor, result.data()); });
+    }
+
+    /// Scale and permute this tensor
+
+    /// \param factor The scaling factor
+    /// \param perm The permutation to be applied to the result
+    /// \return A new tensor equal to <tt>perm ^ (*this * factor)</tt>
+    CudaTensor_ scale(const numeric_type factor, const Permutation& perm) const {
+      return apply([=] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::scal(ctx.handle(), result.size(), factor, result.data()); }, perm);
+    }
+
+    /// Scale this tensor in place
+
+    /// \param factor The scaling factor
+    /// \return A reference to this tensor
+    CudaTensor_& scale_to(const numeric_type factor) {
+      return apply_to([=] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::scal(ctx.handle(), result.size(), factor, result.data()); });
+    }
+
+    // Addition operations
+
+    /// Add this and \c right to construct a new tensor
+
+    /// \param right The tensor that will be added to this tensor
+    /// \return A new tensor equal to <tt>*this + right</tt>
+    CudaTensor_ add(const CudaTensor_& right) const {
+      return add(right, numeric_type(1));
+    }
+
+    /// Add this and \c right , and permute the result
+
+    /// \param right The tensor that will be added to this tensor
+    /// \param perm The permutation to be applied to the result
+    /// \return A new tensor equal to <tt>perm ^ (*this + right)</tt>
+    CudaTensor_ add(const CudaTensor_& right, const Permutation& perm) const {
+      return add(right, numeric_type(1), perm);
+    }
+
+    /// Scale the sum of this and \c right
+
+    /// \param right The tensor that will be added to this tensor
+    /// \param factor The scaling factor
+    /// \return A new tensor equal to <tt>(*this + right) * factor</tt>
+    CudaTensor_ add(const CudaTensor_& right, const numeric_type factor) const {
+      check_congruent(right);
+      return apply([&] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::axpy(ctx.handle(), result.size(), numeric_type(1), right.data(), result.data());
+        if(factor != numeric_type(1))
+          cuda::scal(ctx.handle(), result.size(), factor, result.data());
+      });
+    }
+
+    /// Scale and permute the sum of this and \c right
+
+    /// \param right The tensor that will be added to this tensor
+    /// \param factor The scaling factor
+    /// \param perm The permutation to be applied to the result
+    /// \return A new tensor equal to <tt>perm ^ ((*this + right) * factor)</tt>
+    CudaTensor_ add(const CudaTensor_& right, const numeric_type factor,
+        const Permutation& perm) const
+    {
+      check_congruent(right);
+      return apply([&] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::axpy(ctx.handle(), result.size(), numeric_type(1), right.data(), result.data());
+        if(factor != numeric_type(1))
+          cuda::scal(ctx.handle(), result.size(), factor, result.data());
+      }, perm);
+    }
+
+    /// Add a constant to a copy of this tensor
+
+    /// \param value The constant to be added
+    /// \return A new tensor equal to <tt>*this + value</tt>
+    CudaTensor_ add(const numeric_type value) const {
+      return apply([=] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::check(cuda::add_to(result.data(), value, result.size(), ctx.stream())); });
+    }
+
+    /// Add a constant to a copy of this tensor, and permute the result
+
+    /// \param value The constant to be added
+    /// \param perm The permutation to be applied to the result
+    /// \return A new tensor equal to <tt>perm ^ (*this + value)</tt>
+    CudaTensor_ add(const numeric_type value, const Permutation& perm) const {
+      return apply([=] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::check(cuda::add_to(result.data(), value, result.size(), ctx.stream())); }, perm);
+    }
+
+    /// Add \c right to this tensor
+
+    /// \param right The tensor that will be added to this tensor
+    /// \return A reference to this tensor
+    CudaTensor_& add_to(const CudaTensor_& right) {
+      return add_to(right, numeric_type(1));
+    }
+
+    /// Add \c right to this tensor, and scale the sum
+
+    /// \param right The tensor that will be added to this tensor
+    /// \param factor The scaling factor
+    /// \return A reference to this tensor, equal to <tt>(*this + right) * factor</tt>
+    CudaTensor_& add_to(const CudaTensor_& right, const numeric_type factor) {
+      check_congruent(right);
+      return apply_to([&] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::axpy(ctx.handle(), result.size(), numeric_type(1), right.data(), result.data());
+        if(factor != numeric_type(1))
+          cuda::scal(ctx.handle(), result.size(), factor, result.data());
+      });
+    }
+
+    /// Add a constant to this tensor
+
+    /// \param value The constant to be added
+    /// \return A reference to this tensor
+    CudaTensor_& add_to(const numeric_type value) {
+      return apply_to([=] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::check(cuda::add_to(result.data(), value, result.size(), ctx.stream())); });
+    }
+
+    // Subtraction operations
+
+    /// Subtract \c right from this to construct a new tensor
+
+    /// \param right The tensor that will be subtracted from this tensor
+    /// \return A new tensor equal to <tt>*this - right</tt>
+    CudaTensor_ subt(const CudaTensor_& right) const {
+      return subt(right, numeric_type(1));
+    }
+
+    /// Subtract \c right from this, and permute the result
+
+    /// \param right The tensor that will be subtracted from this tensor
+    /// \param perm The permutation to be applied to the result
+    /// \return A new tensor equal to <tt>perm ^ (*this - right)</tt>
+    CudaTensor_ subt(const CudaTensor_& right, const Permutation& perm) const {
+      return subt(right, numeric_type(1), perm);
+    }
+
+    /// Scale the difference of this and \c right
+
+    /// \param right The tensor that will be subtracted from this tensor
+    /// \param factor The scaling factor
+    /// \return A new tensor equal to <tt>(*this - right) * factor</tt>
+    CudaTensor_ subt(const CudaTensor_& right, const numeric_type factor) const {
+      check_congruent(right);
+      return apply([&] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::axpy(ctx.handle(), result.size(), numeric_type(-1), right.data(), result.data());
+        if(factor != numeric_type(1))
+          cuda::scal(ctx.handle(), result.size(), factor, result.data());
+      });
+    }
+
+    /// Scale and permute the difference of this and \c right
+
+    /// \param right The tensor that will be subtracted from this tensor
+    /// \param factor The scaling factor
+    /// \param perm The permutation to be applied to the result
+    /// \return A new tensor equal to <tt>perm ^ ((*this - right) * factor)</tt>
+    CudaTensor_ subt(const CudaTensor_& right, const numeric_type factor,
+        const Permutation& perm) const
+    {
+      check_congruent(right);
+      return apply([&] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::axpy(ctx.handle(), result.size(), numeric_type(-1), right.data(), result.data());
+        if(factor != numeric_type(1))
+          cuda::scal(ctx.handle(), result.size(), factor, result.data());
+      }, perm);
+    }
+
+    /// Subtract a constant from a copy of this tensor
+
+    /// \param value The constant to be subtracted
+    /// \return A new tensor equal to <tt>*this - value</tt>
+    CudaTensor_ subt(const numeric_type value) const { return add(-value); }
+
+    /// Subtract a constant from a copy of this tensor, and permute the result
+
+    /// \param value The constant to be subtracted
+    /// \param perm The permutation to be applied to the result
+    /// \return A new tensor equal to <tt>perm ^ (*this - value)</tt>
+    CudaTensor_ subt(const numeric_type value, const Permutation& perm) const {
+      return add(-value, perm);
+    }
+
+    /// Subtract \c right from this tensor
+
+    /// \param right The tensor that will be subtracted from this tensor
+    /// \return A reference to this tensor
+    CudaTensor_& subt_to(const CudaTensor_& right) {
+      return subt_to(right, numeric_type(1));
+    }
+
+    /// Subtract \c right from this tensor, and scale the difference
+
+    /// \param right The tensor that will be subtracted from this tensor
+    /// \param factor The scaling factor
+    /// \return A reference to this tensor, equal to <tt>(*this - right) * factor</tt>
+    CudaTensor_& subt_to(const CudaTensor_& right, const numeric_type factor) {
+      check_congruent(right);
+      return apply_to([&] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::axpy(ctx.handle(), result.size(), numeric_type(-1), right.data(), result.data());
+        if(factor != numeric_type(1))
+          cuda::scal(ctx.handle(), result.size(), factor, result.data());
+      });
+    }
+
+    /// Subtract a constant from this tensor
+
+    /// \param value The constant to be subtracted
+    /// \return A reference to this tensor
+    CudaTensor_& subt_to(const numeric_type value) { return add_to(-value); }
+
+    // Multiplication operations
+
+    /// Multiply this by \c right element-wise
+
+    /// \param right The tensor that will be multiplied by this tensor
+    /// \return A new tensor equal to <tt>*this * right</tt>
+    CudaTensor_ mult(const CudaTensor_& right) const {
+      return mult(right, numeric_type(1));
+    }
+
+    /// Multiply this by \c right element-wise, and permute the result
+
+    /// \param right The tensor that will be multiplied by this tensor
+    /// \param perm The permutation to be applied to the result
+    /// \return A new tensor equal to <tt>perm ^ (*this * right)</tt>
+    CudaTensor_ mult(const CudaTensor_& right, const Permutation& perm) const {
+      return mult(right, numeric_type(1), perm);
+    }
+
+    /// Scale the element-wise product of this and \c right
+
+    /// \param right The tensor that will be multiplied by this tensor
+    /// \param factor The scaling factor
+    /// \return A new tensor equal to <tt>(*this * right) * factor</tt>
+    CudaTensor_ mult(const CudaTensor_& right, const numeric_type factor) const {
+      check_congruent(right);
+      return apply([&] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::dgmm(ctx.handle(), result.size(), result.data(), right.data(), result.data());
+        if(factor != numeric_type(1))
+          cuda::scal(ctx.handle(), result.size(), factor, result.data());
+      });
+    }
+
+    /// Scale and permute the element-wise product of this and \c right
+
+    /// \param right The tensor that will be multiplied by this tensor
+    /// \param factor The scaling factor
+    /// \param perm The permutation to be applied to the result
+    /// \return A new tensor equal to <tt>perm ^ ((*this * right) * factor)</tt>
+    CudaTensor_ mult(const CudaTensor_& right, const numeric_type factor,
+        const Permutation& perm) const
+    {
+      check_congruent(right);
+      return apply([&] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::dgmm(ctx.handle(), result.size(), result.data(), right.data(), result.data());
+        if(factor != numeric_type(1))
+          cuda::scal(ctx.handle(), result.size(), factor, result.data());
+      }, perm);
+    }
+
+    /// Multiply this tensor by \c right element-wise
+
+    /// \param right The tensor that will be multiplied by this tensor
+    /// \return A reference to this tensor
+    CudaTensor_& mult_to(const CudaTensor_& right) {
+      return mult_to(right, numeric_type(1));
+    }
+
+    /// Multiply this tensor by \c right element-wise, and scale the product
+
+    /// \param right The tensor that will be multiplied by this tensor
+    /// \param factor The scaling factor
+    /// \return A reference to this tensor, equal to <tt>(*this * right) * factor</tt>
+    CudaTensor_& mult_to(const CudaTensor_& right, const numeric_type factor) {
+      check_congruent(right);
+      return apply_to([&] (cuda::ThreadContext& ctx, CudaTensor_& result) {
+        cuda::dgmm(ctx.handle(), result.size(), result.data(), right.data(), result.data());
+        if(factor != numeric_type(1))
+          cuda::scal(ctx.handle(), result.size(), factor, result.data());
+      });
+    }
+
+    // Negation operations
+
+    /// Create a negated copy of this tensor
+
+    /// \return A new tensor equal to <tt>-*this</tt>
+    CudaTensor_ neg() const { return scale(numeric_type(-1)); }
+
+    /// Create a negated and permuted copy of this tensor
+
+    /// \param perm The permutation to be applied to the result
+    /// \return A new tensor equal to <tt>perm ^ -*this</tt>
+    CudaTensor_ neg(const Permutation& perm) const {
+      return scale(numeric_type(-1), perm);
+    }
+
+    /// Negate this tensor
+
+    /// \return A reference to this tensor
+    CudaTensor_& neg_to() { return scale_to(numeric_type(-1)); }
+
+    // GEMM operations
+
+    /// Contract this tensor with \c other
+
+    /// The contraction is computed by cuBLAS; see \c Tensor::gemm() for the
+    /// supported contractions.
+    /// \param other The tensor that will be contracted with this tensor
+    /// \param factor Multiply the result by this constant
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return A new tensor which is the result of contracting this tensor
+    /// with \c other and scaled by \c factor
+    CudaTensor_ gemm(const CudaTensor_& other, const numeric_type factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(range_.rank() == gemm_helper.left_rank());
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(other.range().rank() == gemm_helper.right_rank());
+      TA_ASSERT(gemm_helper.left_right_congruent(range_.extent_data(),
+          other.range().extent_data()));
+
+      CudaTensor_ result(gemm_helper.make_result_range<range_type>(range_, other.range()));
+      gemm(result, *this, other, factor, numeric_type(0), gemm_helper);
+      return result;
+    }
+
+    /// Contract two tensors and accumulate the scaled result to this tensor
+
+    /// \param left The left-hand tensor that will be contracted
+    /// \param right The right-hand tensor that will be contracted
+    /// \param factor The contraction result will be scaling by this value,
+    /// then accumulated into \c this
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return A reference to this tensor
+    CudaTensor_& gemm(const CudaTensor_& left, const CudaTensor_& right,
+        const numeric_type factor, const math::GemmHelper& gemm_helper)
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(range_.rank() == gemm_helper.result_rank());
+      TA_ASSERT(! left.empty());
+      TA_ASSERT(left.range().rank() == gemm_helper.left_rank());
+      TA_ASSERT(! right.empty());
+      TA_ASSERT(right.range().rank() == gemm_helper.right_rank());
+      TA_ASSERT(gemm_helper.left_result_congruent(left.range().extent_data(),
+          range_.extent_data()));
+      TA_ASSERT(gemm_helper.right_result_congruent(right.range().extent_data(),
+          range_.extent_data()));
+      TA_ASSERT(gemm_helper.left_right_congruent(left.range().extent_data(),
+          right.range().extent_data()));
+
+      gemm(*this, left, right, factor, numeric_type(1), gemm_helper);
+      return *this;
+    }
+
+  private:
+
+    /// <tt>result = left * right * factor + result * beta</tt>
+
+    /// cuBLAS is column-major, so the row-major product
+    /// <tt>C = op(A) op(B)</tt> is computed as <tt>C^T = op(B)^T op(A)^T</tt> .
+    static void gemm(CudaTensor_& result, const CudaTensor_& left,
+        const CudaTensor_& right, const numeric_type factor,
+        const numeric_type beta, const math::GemmHelper& gemm_helper)
+    {
+      integer m = 1, n = 1, k = 1;
+      gemm_helper.compute_matrix_sizes(m, n, k, left.range(), right.range());
+      const integer lda = (gemm_helper.left_op() == madness::cblas::NoTrans ? k : m);
+      const integer ldb = (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
+
+      cuda::ThreadContext& ctx = cuda::ThreadContext::instance();
+      cuda::gemm(ctx.handle(), to_cublas_op(gemm_helper.right_op()),
+          to_cublas_op(gemm_helper.left_op()), n, m, k, factor, right.data(), ldb,
+          left.data(), lda, beta, result.data(), n);
+      ctx.complete();
+    }
+
+    /// Convert a CBLAS transpose operation to a cuBLAS operation
+    static cublasOperation_t to_cublas_op(const madness::cblas::CBLAS_TRANSPOSE op) {
+      switch(op) {
+        case madness::cblas::Trans: return CUBLAS_OP_T;
+        case madness::cblas::ConjTrans: return CUBLAS_OP_C;
+        default: return CUBLAS_OP_N;
+      }
+    }
+
+    /// Copy this tensor to the host
+    Tensor<T> host() const { return static_cast<Tensor<T> >(*this); }
+
+  public:
+
+    // Reduction operations
+
+    /// Square of the vector 2-norm
+
+    /// \return The sum of the squares of the elements of this tensor
+    scalar_type squared_norm() const {
+      TA_ASSERT(! empty());
+      return cuda::dot(cuda::ThreadContext::instance().handle(), size(), data(), data());
+    }
+
+    /// Vector 2-norm
+
+    /// \return The square root of the sum of the squares of the elements of
+    /// this tensor
+    scalar_type norm() const {
+      TA_ASSERT(! empty());
+      return cuda::nrm2(cuda::ThreadContext::instance().handle(), size(), data());
+    }
+
+    /// Vector dot product
+
+    /// \param other The other tensor
+    /// \return The sum of the products of the elements of this and \c other
+    numeric_type dot(const CudaTensor_& other) const {
+      check_congruent(other);
+      return cuda::dot(cuda::ThreadContext::instance().handle(), size(), data(), other.data());
+    }
+
+    /// Vector inner product
+
+    /// \param other The other tensor
+    /// \return The sum of the products of the elements of this and \c other
+    numeric_type inner_product(const CudaTensor_& other) const { return dot(other); }
+
+    /// Sum of the elements, computed on the host
+    numeric_type sum() const { return host().sum(); }
+
+    /// Product of the elements, computed on the host
+    numeric_type product() const { return host().product(); }
+
+    /// Sum of the diagonal elements, computed on the host
+    numeric_type trace() const { return host().trace(); }
+
+    /// Minimum element, computed on the host
+    numeric_type min() const { return host().min(); }
+
+    /// Maximum element, computed on the host
+    numeric_type max() const { return host().max(); }
+
+    /// Absolute minimum element, computed on the host
+    scalar_type abs_min() const { return host().abs_min(); }
+
+    /// Absolute maximum element, computed on the host
+    scalar_type abs_max() const { return host().abs_max(); }
+
+  }; // class CudaTensor
+
+  /// Contract tile pairs with batched GEMMs
+
+  /// Pair \c i is contracted as <tt>results[i] += lefts[i] * rights[i] *
+  /// factor</tt> ; an empty result tile is initialized to zero. The pairs
+  /// are grouped by their matrix dimensions, and each group is evaluated
+  /// with a single \c cublas<t>gemmBatched call (or \c cublas<t>gemm for a
+  /// group of one pair), on the stream of the calling thread, so the result
+  /// tiles stay on the device. The result tiles must be distinct.
+  /// \tparam T The element type
+  /// \tparam Allocator The allocator type
+  /// \param results The result tiles
+  /// \param lefts The left-hand tiles
+  /// \param rights The right-hand tiles
+  /// \param factor The scaling factor
+  /// \param gemm_helper The *GEMM operation meta data
+  template <typename T, typename Allocator>
+  inline void gemm_batch(const std::vector<CudaTensor<T, Allocator>*>& results,
+      const std::vector<const CudaTensor<T, Allocator>*>& lefts,
+      const std::vector<const CudaTensor<T, Allocator>*>& rights,
+      const T factor, const math::GemmHelper& gemm_helper)
+  {
+    typedef CudaTensor<T, Allocator> tensor_type;
+    TA_ASSERT(results.size() == lefts.size());
+    TA_ASSERT(results.size() == rights.size());
+    const std::size_t count = results.size();
+    if(count == 0ul)
+      return;
+
+    // Initialize the empty result tiles, and group the pairs by dimensions
+    std::map<std::array<integer, 3>, std::vector<std::size_t> > groups;
+    for(std::size_t i = 0ul; i < count; ++i) {
+      TA_ASSERT(! lefts[i]->empty());
+      TA_ASSERT(! rights[i]->empty());
+      if(results[i]->empty())
+        *results[i] = tensor_type(gemm_helper.template make_result_range<Range>(
+            lefts[i]->range(), rights[i]->range()), T(0));
+
+      integer m = 1, n = 1, k = 1;
+      gemm_helper.compute_matrix_sizes(m, n, k, lefts[i]->range(), rights[i]->range());
+      groups[std::array<integer, 3>{{m, n, k}}].push_back(i);
+    }
+
+    auto to_cublas_op = [] (const madness::cblas::CBLAS_TRANSPOSE op) {
+      return (op == madness::cblas::Trans ? CUBLAS_OP_T :
+          (op == madness::cblas::ConjTrans ? CUBLAS_OP_C : CUBLAS_OP_N));
+    };
+    const cublasOperation_t op_a = to_cublas_op(gemm_helper.left_op());
+    const cublasOperation_t op_b = to_cublas_op(gemm_helper.right_op());
+
+    // The matrix pointers of all groups are copied to the device at once;
+    // cuBLAS is column-major, so C^T = op(B)^T op(A)^T is computed.
+    std::vector<const void*> pointers;
+    pointers.reserve(3ul * count);
+    for(const auto& group : groups) {
+      for(const std::size_t i : group.second) pointers.push_back(rights[i]->data());
+      for(const std::size_t i : group.second) pointers.push_back(lefts[i]->data());
+      for(const std::size_t i : group.second) pointers.push_back(results[i]->data());
+    }
+
+    cuda::ThreadContext& ctx = cuda::ThreadContext::instance();
+    void** const device_pointers = ctx.pointers(pointers.size());
+    cuda::check(cudaMemcpyAsync(device_pointers, pointers.data(),
+        pointers.size() * sizeof(void*), cudaMemcpyHostToDevice, ctx.stream()));
+
+    std::size_t offset = 0ul;
+    for(const auto& group : groups) {
+      const integer m = group.first[0], n = group.first[1], k = group.first[2];
+      const integer lda = (gemm_helper.left_op() == madness::cblas::NoTrans ? k : m);
+      const integer ldb = (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
+      const std::size_t size = group.second.size();
+
+      if(size == 1ul) {
+        const std::size_t i = group.second.front();
+        cuda::gemm(ctx.handle(), op_b, op_a, n, m, k, factor, rights[i]->data(),
+            ldb, lefts[i]->data(), lda, T(1), results[i]->data(), n);
+      } else {
+        cuda::gemm_batched(ctx.handle(), op_b, op_a, n, m, k, factor,
+            reinterpret_cast<const T* const*>(device_pointers + offset), ldb,
+            reinterpret_cast<const T* const*>(device_pointers + offset + size), lda,
+            T(1), reinterpret_cast<T* const*>(device_pointers + offset + 2ul * size),
+            n, size);
+      }
+      offset += 3ul * size;
+    }
+
+    ctx.complete();
+  }
+
+  /// Asynchronous operations of device tiles
+
+  /// The operations that are evaluated by distributed evaluators only queue
+  /// their kernels, and the tile is published when the stream of the thread
+  /// reaches it, so the worker thread does not wait for the device.
+  /// \tparam T The element type
+  /// \tparam Allocator The allocator type
+  template <typename T, typename Allocator>
+  struct async_trait<CudaTensor<T, Allocator> > {
+    static constexpr bool is_async = true;
+
+    /// Defer the synchronization of the operations of the calling thread
+    class scope_type {
+      bool previous_; ///< The previous state of the thread
+    public:
+      scope_type() :
+        previous_(cuda::ThreadContext::instance().defer_synchronization(true))
+      { }
+      ~scope_type() {
+        cuda::ThreadContext::instance().defer_synchronization(previous_);
+      }
+    }; // class scope_type
+
+    /// \return A future that is set with \c tile when its kernels complete
+    static Future<CudaTensor<T, Allocator> >
+    when_ready(CudaTensor<T, Allocator>&& tile) {
+      return cuda::when_complete(std::move(tile));
+    }
+  }; // struct async_trait
+
+  /// Copy the tiles of an array to the device
+
+  /// \tparam T The element type
+  /// \tparam A The allocator type of the host tiles
+  /// \tparam Policy The array policy type
+  /// \param array An array with host tiles
+  /// \return An array with the tiles of \c array in device memory
+  template <typename T, typename A, typename Policy>
+  inline DistArray<CudaTensor<T>, Policy>
+  to_device(const DistArray<Tensor<T, A>, Policy>& array) {
+    return to_new_tile_type(array, [] (const Tensor<T, A>& tile) {
+      return CudaTensor<T>(tile);
+    });
+  }
+
+  /// Copy the tiles of an array to the host
+
+  /// \tparam T The element type
+  /// \tparam Allocator The allocator type of the device tiles
+  /// \tparam Policy The array policy type
+  /// \param array An array with device tiles
+  /// \return An array with the tiles of \c array in host memory
+  template <typename T, typename Allocator, typename Policy>
+  inline DistArray<Tensor<T>, Policy>
+  to_host(const DistArray<CudaTensor<T, Allocator>, Policy>& array) {
+    return to_new_tile_type(array, [] (const CudaTensor<T, Allocator>& tile) {
+      return static_cast<Tensor<T> >(tile);
+    });
+  }
+
+  template <typename T, typename Allocator>
+  inline std::ostream& operator<<(std::ostream& os, const CudaTensor<T, Allocator>& tile) {
+    os << static_cast<Tensor<T> >(tile);
+    return os;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_HAS_CUDA
+
+#endif // TILEDARRAY_CUDA_CUDA_TENSOR_H__INCLUDED
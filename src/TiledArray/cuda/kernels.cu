@@ -0,0 +1,109 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  kernels.cu
+ *
+ */
+
+#include <TiledArray/cuda/kernels.h>
+
+namespace TiledArray {
+  namespace cuda {
+
+    namespace {
+
+      /// The number of threads in a block
+      constexpr unsigned int block_size = 256u;
+
+      /// The shape of a permutation, passed to the kernel by value
+      struct PermuteShape {
+        unsigned int rank;
+        std::size_t extent[max_rank];
+        std::size_t result_stride[max_rank];
+      }; // struct PermuteShape
+
+      template <typename T>
+      __global__ void permute_kernel(const T* __restrict__ arg,
+          T* __restrict__ result, const PermuteShape shape, const std::size_t n)
+      {
+        const std::size_t i = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+        if(i >= n)
+          return;
+
+        // Decompose the ordinal of arg, from the last (fastest) dimension
+        std::size_t ord = i;
+        std::size_t result_ord = 0ul;
+        for(int d = int(shape.rank) - 1; d >= 0; --d) {
+          const std::size_t idx = ord % shape.extent[d];
+          ord /= shape.extent[d];
+          result_ord += idx * shape.result_stride[d];
+        }
+        result[result_ord] = arg[i];
+      }
+
+      template <typename T>
+      __global__ void add_to_kernel(T* data, const T value, const std::size_t n) {
+        const std::size_t i = std::size_t(blockIdx.x) * blockDim.x + threadIdx.x;
+        if(i < n)
+          data[i] += value;
+      }
+
+      /// The number of blocks that cover \c n elements
+      inline unsigned int grid_size(const std::size_t n) {
+        return (n + block_size - 1ul) / block_size;
+      }
+
+    }  // namespace
+
+    template <typename T>
+    cudaError_t permute(const T* arg, T* result, const unsigned int rank,
+        const std::size_t* extent, const std::size_t* result_stride,
+        const std::size_t n, cudaStream_t stream)
+    {
+      if(rank > max_rank)
+        return cudaErrorInvalidValue;
+      if(n == 0ul)
+        return cudaSuccess;
+
+      PermuteShape shape;
+      shape.rank = rank;
+      for(unsigned int d = 0u; d < rank; ++d) {
+        shape.extent[d] = extent[d];
+        shape.result_stride[d] = result_stride[d];
+      }
+      permute_kernel<<<grid_size(n), block_size, 0, stream>>>(arg, result, shape, n);
+      return cudaGetLastError();
+    }
+
+    template <typename T>
+    cudaError_t add_to(T* data, const T value, const std::size_t n, cudaStream_t stream) {
+      if(n == 0ul)
+        return cudaSuccess;
+      add_to_kernel<<<grid_size(n), block_size, 0, stream>>>(data, value, n);
+      return cudaGetLastError();
+    }
+
+    // Explicit instantiations for the element types supported by cuBLAS
+    template cudaError_t permute<float>(const float*, float*, const unsigned int,
+        const std::size_t*, const std::size_t*, const std::size_t, cudaStream_t);
+    template cudaError_t permute<double>(const double*, double*, const unsigned int,
+        const std::size_t*, const std::size_t*, const std::size_t, cudaStream_t);
+    template cudaError_t add_to<float>(float*, const float, const std::size_t, cudaStream_t);
+    template cudaError_t add_to<double>(double*, const double, const std::size_t, cudaStream_t);
+
+  }  // namespace cuda
+}  // namespace TiledArray
@@ -0,0 +1,72 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  kernels.h
+ *
+ */
+
+#ifndef TILEDARRAY_CUDA_KERNELS_H__INCLUDED
+#define TILEDARRAY_CUDA_KERNELS_H__INCLUDED
+
+// This header is also compiled by nvcc, so it does not include the
+// configuration of TiledArray; it is only used when TILEDARRAY_HAS_CUDA is
+// defined.
+
+#include <cuda_runtime.h>
+#include <cstddef>
+
+namespace TiledArray {
+  namespace cuda {
+
+    /// The maximum rank of the tensors that are permuted by \c permute()
+    constexpr unsigned int max_rank = 16u;
+
+    /// Permute a row-major tensor on the device
+
+    /// Element \c i of \c arg , which has the multi-index \c idx in \c arg ,
+    /// is copied to the element of \c result with the ordinal
+    /// <tt>sum(idx[d] * result_stride[d])</tt> .
+    /// \tparam T The element type (\c float or \c double )
+    /// \param arg The device data of the tensor to be permuted
+    /// \param[out] result The device data of the permuted tensor
+    /// \param rank The rank of the tensors, at most \c max_rank
+    /// \param extent The extents of \c arg
+    /// \param result_stride The stride in \c result of each dimension of
+    /// \c arg , i.e. the stride of dimension <tt>perm[d]</tt> of \c result
+    /// \param n The number of elements
+    /// \param stream The stream on which the kernel is queued
+    /// \return The status of the kernel launch
+    template <typename T>
+    cudaError_t permute(const T* arg, T* result, const unsigned int rank,
+        const std::size_t* extent, const std::size_t* result_stride,
+        const std::size_t n, cudaStream_t stream);
+
+    /// Add a constant to the elements of a tensor on the device
+
+    /// \tparam T The element type (\c float or \c double )
+    /// \param[in,out] data The device data of the tensor
+    /// \param value The constant to be added to each element
+    /// \param n The number of elements
+    /// \param stream The stream on which the kernel is queued
+    /// \return The status of the kernel launch
+    template <typename T>
+    cudaError_t add_to(T* data, const T value, const std::size_t n, cudaStream_t stream);
+
+  }  // namespace cuda
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_CUDA_KERNELS_H__INCLUDED
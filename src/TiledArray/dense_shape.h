@@ -100,6 +100,17 @@ namespace TiledArray {
 
     /// \return Always \c false
     static constexpr bool empty() { return false; }
+
+    /// Zero threshold accessor
+
+    /// \return Always zero, since no tile is zero
+    static constexpr float zero_threshold() { return 0.0f; }
+
+    /// Change the zero threshold
+
+    /// No operation since there are no zero tiles.
+    template <typename Real>
+    static DenseShape with_threshold(const Real) { return DenseShape(); }
    
     DenseShape mask(const DenseShape &) const {
       return DenseShape{};
@@ -109,6 +120,10 @@ namespace TiledArray {
     static DenseShape update_block(const Index&, const Index&, const DenseShape&)
     { return DenseShape(); }
 
+    template <typename SparseNormSequence>
+    static DenseShape update(World&, const SparseNormSequence&)
+    { return DenseShape(); }
+
     template <typename Index>
     static DenseShape block(const Index&, const Index&) { return DenseShape(); }
 
@@ -183,6 +198,16 @@ namespace TiledArray {
     static DenseShape gemm(const DenseShape&, const Scalar, const math::GemmHelper&, const Permutation&)
     { return DenseShape(); }
 
+    template <typename Scalar>
+    static DenseShape batched_gemm(const DenseShape&, const Scalar, const unsigned int,
+        const unsigned int)
+    { return DenseShape(); }
+
+    template <typename Scalar>
+    static DenseShape batched_gemm(const DenseShape&, const Scalar, const unsigned int,
+        const unsigned int, const Permutation&)
+    { return DenseShape(); }
+
   }; // class DenseShape
 
   constexpr inline bool operator==(const DenseShape& a, const DenseShape& b) { return true; }
@@ -31,19 +31,19 @@
 
 namespace TiledArray {
 
-  template class DistArray<Tensor<double, Eigen::aligned_allocator<double> >, DensePolicy>;
-  template class DistArray<Tensor<float, Eigen::aligned_allocator<float> >, DensePolicy>;
-  template class DistArray<Tensor<int, Eigen::aligned_allocator<int> >, DensePolicy>;
-  template class DistArray<Tensor<long, Eigen::aligned_allocator<long> >, DensePolicy>;
-//  template class DistArray<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, DensePolicy>;
-//  template class DistArray<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, DensePolicy>;
+  template class DistArray<Tensor<double, default_allocator<double> >, DensePolicy>;
+  template class DistArray<Tensor<float, default_allocator<float> >, DensePolicy>;
+  template class DistArray<Tensor<int, default_allocator<int> >, DensePolicy>;
+  template class DistArray<Tensor<long, default_allocator<long> >, DensePolicy>;
+//  template class DistArray<Tensor<std::complex<double>, default_allocator<std::complex<double> > >, DensePolicy>;
+//  template class DistArray<Tensor<std::complex<float>, default_allocator<std::complex<float> > >, DensePolicy>;
 
-  template class DistArray<Tensor<double, Eigen::aligned_allocator<double> >, SparsePolicy>;
-  template class DistArray<Tensor<float, Eigen::aligned_allocator<float> >, SparsePolicy>;
-  template class DistArray<Tensor<int, Eigen::aligned_allocator<int> >, SparsePolicy>;
-  template class DistArray<Tensor<long, Eigen::aligned_allocator<long> >, SparsePolicy>;
-//  template class DistArray<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, SparsePolicy>;
-//  template class DistArray<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, SparsePolicy>;
+  template class DistArray<Tensor<double, default_allocator<double> >, SparsePolicy>;
+  template class DistArray<Tensor<float, default_allocator<float> >, SparsePolicy>;
+  template class DistArray<Tensor<int, default_allocator<int> >, SparsePolicy>;
+  template class DistArray<Tensor<long, default_allocator<long> >, SparsePolicy>;
+//  template class DistArray<Tensor<std::complex<double>, default_allocator<std::complex<double> > >, SparsePolicy>;
+//  template class DistArray<Tensor<std::complex<float>, default_allocator<std::complex<float> > >, SparsePolicy>;
 
 
 } // namespace TiledArray
@@ -30,6 +30,8 @@
 #include <TiledArray/conversions/truncate.h>
 #include <TiledArray/conversions/clone.h>
 #include <TiledArray/tile_interface/cast.h>
+#include <TiledArray/expressions/variable_list.h>
+#include <TiledArray/math/random.h>
 
 namespace TiledArray {
 
@@ -47,7 +49,7 @@ namespace TiledArray {
   /// used to construct distributed tensor algebraic operations.
   /// \tparam T The element type of for array tiles
   /// \tparam Tile The tile type [ Default = \c Tensor<T> ]
-  template <typename Tile = Tensor<double, Eigen::aligned_allocator<double> >,
+  template <typename Tile = Tensor<double, default_allocator<double> >,
       typename Policy = DensePolicy>
   class DistArray {
   public:
@@ -79,7 +81,10 @@ namespace TiledArray {
     /// Array deleter function
 
     /// This function schedules a task for lazy cleanup. Array objects are
-    /// deleted only after the object has been deleted in all processes.
+    /// released only after the object has been deleted in all processes, and
+    /// are then deleted as soon as no local task or message handler
+    /// references their tiles (see \c ArrayImpl::release() ), without
+    /// waiting for a fence.
     /// \param pimpl The implementation pointer to be deleted.
     static void lazy_deleter(const impl_type* const pimpl) {
       if(pimpl) {
@@ -90,8 +95,10 @@ namespace TiledArray {
 
           try {
             world.gop.lazy_sync(id, [pimpl]() {
-              delete pimpl;
-              DistArray_::cleanup_counter_--;
+              const_cast<impl_type*>(pimpl)->release([pimpl]() {
+                delete pimpl;
+                DistArray_::cleanup_counter_--;
+              });
             });
           }
           catch(madness::MadnessException& e) {
@@ -337,6 +344,294 @@ namespace TiledArray {
       return find<std::initializer_list<Integer>>(i);
     }
 
+    /// Request remote tiles that will be found later
+
+    /// The remote tiles of \c indices are requested from their owners, with
+    /// one message per owner, into the read cache of remote tiles (see
+    /// \c enable_remote_cache() ), and this function returns without
+    /// waiting for them. A later \c find() of one of the tiles returns the
+    /// cached future. Zero, local, and already cached tiles are skipped, and
+    /// nothing is requested when the cache is disabled, e.g.
+    /// \code
+    /// array.enable_remote_cache(1ul << 30);
+    /// for(std::size_t block = 0; block < blocks; ++block) {
+    ///   if(block + 1 < blocks)
+    ///     array.prefetch(tiles_of(block + 1));
+    ///   for(const auto index : tiles_of(block))
+    ///     use(array.find(index).get());
+    /// }
+    /// \endcode
+    /// \tparam Indices A container of tile indices or ordinal indices
+    /// \param indices The tiles that will be found
+    /// \note This function is not collective.
+    template <typename Indices>
+    void prefetch(const Indices& indices) const {
+      check_pimpl();
+      std::vector<size_type> ordinals;
+      for(const auto& i : indices) {
+        check_index(i);
+        ordinals.push_back(pimpl_->trange().tiles_range().ordinal(i));
+      }
+      pimpl_->prefetch(ordinals);
+    }
+
+    /// Enable the read cache of remote tiles
+
+    /// Remote tiles that are requested by \c find() on this process are
+    /// cached, with least-recently-used eviction, until the size of the
+    /// cached tiles reaches \c max_bytes . The cache is cleared when a tile
+    /// of this array is set; it must be cleared with \c clear_remote_cache()
+    /// when the owners of the remote tiles may have modified them, e.g.
+    /// after the fence that follows an in-place operation.
+    /// \param max_bytes The maximum size of the cached tiles, in bytes, or
+    /// zero to disable the cache
+    /// \note This function is not collective.
+    void enable_remote_cache(const size_type max_bytes) {
+      check_pimpl();
+      pimpl_->remote_cache().capacity(max_bytes);
+    }
+
+    /// Remove all tiles from the read cache of remote tiles
+    void clear_remote_cache() {
+      check_pimpl();
+      pimpl_->remote_cache().clear();
+    }
+
+    /// Remote tile cache hit counter
+
+    /// \return The number of remote tile requests of this process that were
+    /// found in the read cache
+    size_type remote_cache_hits() const {
+      check_pimpl();
+      return pimpl_->remote_cache().hits();
+    }
+
+    /// Remote tile cache miss counter
+
+    /// \return The number of remote tile requests of this process that were
+    /// sent to the owner of the tile while the read cache was enabled
+    size_type remote_cache_misses() const {
+      check_pimpl();
+      return pimpl_->remote_cache().misses();
+    }
+
+    /// Memory of the local tiles
+
+    /// \return The size of the data of the local tiles that are assigned,
+    /// and the number of assigned and pending local tiles
+    /// \note This function is not collective; see \c memory_report() for
+    /// the memory of all processes.
+    ArrayMemoryUsage memory_usage() const {
+      check_pimpl();
+      return pimpl_->memory_usage();
+    }
+
+    /// Test for the assignment of the local tiles
+
+    /// \return \c true if all local non-zero tiles are assigned
+    /// \note This function is not collective.
+    bool is_local_complete() const {
+      check_pimpl();
+      return pimpl_->probe_local();
+    }
+
+    /// Completion of the local tiles
+
+    /// \return A future that is set when the local non-zero tiles are
+    /// assigned
+    /// \note This function is not collective.
+    Future<bool> local_completion() const {
+      check_pimpl();
+      return pimpl_->local_completion();
+    }
+
+    /// Completion of the tiles of all processes
+
+    /// Each process counts its pending local tiles, and the counts are
+    /// combined by a non-blocking all-reduce, so a consumer can wait for the
+    /// result of an expression without a global fence, while unrelated
+    /// tasks keep running:
+    /// \code
+    /// c("i,j") = a("i,k") * b("k,j");
+    /// d("i,j") = e("i,j") + f("i,j"); // overlaps with the contraction
+    /// c.wait_complete();
+    /// \endcode
+    /// \return A future that is set when the tiles of all processes are
+    /// assigned
+    /// \note This function is collective: it must be called on all
+    /// processes, in the same order with respect to the other completion
+    /// tests of this array.
+    Future<bool> completion() const {
+      check_pimpl();
+      return pimpl_->completion();
+    }
+
+    /// Wait for the tiles of all processes
+
+    /// Tasks are executed while waiting.
+    /// \note This function is collective.
+    /// \see completion()
+    void wait_complete() const { completion().get(); }
+
+    /// Enable the cache of evaluated lazy tiles
+
+    /// When the tiles of this array are lazy tiles (e.g. tiles that compute
+    /// their data directly when they are evaluated), the tiles that are
+    /// evaluated by expressions on this process, as selected by
+    /// \c policy , are cached, with least-recently-used eviction, until the
+    /// size of the cached tiles reaches \c max_bytes . A cached tile is
+    /// copied, instead of evaluated again, when it is used by a subsequent
+    /// expression. The cache is cleared when a tile of this array is set.
+    /// It has no effect for other tile types.
+    /// \param policy The tiles that are cached
+    /// \param max_bytes The maximum size of the cached tiles, in bytes
+    /// \note This function is not collective.
+    void enable_lazy_tile_cache(const LazyTileCachePolicy policy,
+        const size_type max_bytes)
+    {
+      check_pimpl();
+      pimpl_->eval_cache()->enable(policy, max_bytes);
+    }
+
+    /// Remove all tiles from the cache of evaluated lazy tiles
+    void clear_lazy_tile_cache() {
+      check_pimpl();
+      pimpl_->eval_cache()->clear();
+    }
+
+    /// Evaluated lazy tile cache accessor
+
+    /// \return A shared pointer to the cache of evaluated lazy tiles
+    const std::shared_ptr<typename impl_type::eval_cache_type>&
+    lazy_tile_cache() const {
+      check_pimpl();
+      return pimpl_->eval_cache();
+    }
+
+    /// Enable the cache of permuted layouts
+
+    /// Permuted copies of this array that are added with \c cache_layout()
+    /// are kept until their total size reaches \c max_bytes per process,
+    /// where the oldest layouts are evicted first.
+    /// \param max_bytes The maximum size of the layouts per process, in
+    /// bytes, or zero to disable the cache
+    /// \note This function is collective.
+    void enable_layout_cache(const size_type max_bytes) {
+      check_pimpl();
+      pimpl_->layout_cache().capacity(max_bytes);
+    }
+
+    /// Remove all permuted layouts of this array
+
+    /// The layouts are dropped when the array is assigned, or when its shape
+    /// or tile symmetry is modified. This function must be called when the
+    /// tile data is modified in place by other means, e.g. through the tiles
+    /// returned by \c find() .
+    /// \note This function is collective.
+    void clear_layout_cache() {
+      check_pimpl();
+      pimpl_->layout_cache().clear();
+    }
+
+    /// Add a permuted layout of this array to the layout cache
+
+    /// The array is permuted once from \c vars to \c layout_vars and the
+    /// copy is cached, so expressions that use this array with the index
+    /// order of \c layout_vars , e.g. as an argument of a contraction that
+    /// requires that order, read the copy instead of permuting the tiles:
+    /// \code
+    /// v.enable_layout_cache(1ul << 30);
+    /// v.cache_layout("a,b,i,j", "i,a,j,b");
+    /// r("i,a,j,b") = v("a,b,i,j") + ...; // the tiles of v are not permuted
+    /// \endcode
+    /// The size of a layout is the size of the data of the non-zero tiles,
+    /// divided by the number of processes.
+    /// \param vars The variable list of this array
+    /// \param layout_vars The variable list of the layout, which must be a
+    /// permutation of \c vars
+    /// \return \c true if the layout was cached, or \c false if it does not
+    /// fit in the capacity of the cache
+    /// \note This function is collective.
+    bool cache_layout(const std::string& vars, const std::string& layout_vars) {
+      check_pimpl();
+      const expressions::VariableList array_vars(vars);
+      const expressions::VariableList target_vars(layout_vars);
+      TA_USER_ASSERT(target_vars.is_permutation(array_vars),
+          "DistArray::cache_layout() -- The layout variable list is not a "
+          "permutation of the array variable list.");
+      const Permutation perm = target_vars.permutation(array_vars);
+      if(! perm)
+        return false;
+
+      size_type elements = 0ul;
+      const size_type n = pimpl_->trange().tiles_range().volume();
+      for(size_type i = 0ul; i < n; ++i)
+        if(! pimpl_->is_zero(i))
+          elements += pimpl_->trange().make_tile_range(i).volume();
+      const size_type bytes = elements *
+          sizeof(typename TiledArray::detail::numeric_type<value_type>::type) /
+          size_type(world().size());
+      if(bytes > pimpl_->layout_cache().capacity())
+        return false;
+
+      DistArray_ layout;
+      layout(layout_vars) = (*this)(vars);
+      return pimpl_->layout_cache().insert(perm, layout.pimpl_, bytes);
+    }
+
+    /// Permuted layout accessor
+
+    /// \param perm The permutation from this array to the layout
+    /// \return The cached layout, or an uninitialized array if there is no
+    /// layout for \c perm
+    DistArray_ layout(const Permutation& perm) const {
+      check_pimpl();
+      DistArray_ result;
+      result.pimpl_ = pimpl_->layout_cache().find(perm);
+      return result;
+    }
+
+    /// The number of cached layouts
+
+    /// \return The number of permuted layouts of this array
+    size_type layout_count() const {
+      check_pimpl();
+      return pimpl_->layout_cache().size();
+    }
+
+    /// Aggregate remote tile requests
+
+    /// Tiles that are set on or requested from another process are buffered
+    /// for each owner, and the buffer of an owner is sent in one message
+    /// when it holds \c buffer_size tiles, instead of one message per tile.
+    /// This is useful when a process that does not own the tiles fills the
+    /// array, e.g.
+    /// \code
+    /// array.aggregate(64);
+    /// for(std::size_t i = 0; i < array.size(); ++i)
+    ///   array.set(i, make_tile(i));
+    /// array.flush();
+    /// world.gop.fence();
+    /// \endcode
+    /// \param buffer_size The number of tiles of each message, or zero to
+    /// send each tile in its own message, which also flushes the buffers
+    /// \note The buffered requests must be sent with \c flush() before the
+    /// fence that completes them, and before a buffered \c find() is waited
+    /// for. This function is not collective and must not be called while
+    /// other threads set or find tiles of this array.
+    void aggregate(const size_type buffer_size) {
+      check_pimpl();
+      pimpl_->aggregate(buffer_size);
+    }
+
+    /// Send the buffered remote tile requests
+
+    /// \see aggregate()
+    void flush() const {
+      check_pimpl();
+      pimpl_->flush();
+    }
+
     /// Set a tile and fill it using a sequence
 
     /// \tparam Index An index or integral type
@@ -446,12 +741,28 @@ namespace TiledArray {
       fill_local(value, skip_set);
     }
 
-    /// Fill all local tiles with random values obtained as \code (element_type)std::rand()/RAND_MAX \endcode
+    /// Fill all local tiles with uniform random values in <tt>[0, 1)</tt>
+
+    /// Uses the seeds 0, 1, 2, ... on successive calls (see
+    /// \c math::next_random_seed() ).
     /// \param skip_set If false, will throw if any tiles are already set
     void fill_random(bool skip_set = false) {
-      init_elements([](const auto &) {
-        return (element_type)std::rand() / RAND_MAX;
-      });
+      fill_random(skip_set, math::next_random_seed());
+    }
+
+    /// Fill all local tiles with uniform random values in <tt>[0, 1)</tt>
+
+    /// Each element is a counter-based random number of its ordinal in the
+    /// element range (see \c math::philox_uniform() ), so the array only
+    /// depends on \c seed , and not on the tiling, the process map, or the
+    /// number of threads. The rows of each tile are filled by a vectorized
+    /// loop.
+    /// \param skip_set If false, will throw if any tiles are already set
+    /// \param seed The seed of the random numbers
+    void fill_random(bool skip_set, const std::uint64_t seed) {
+      const auto elements = trange().elements_range();
+      init_tiles([seed, elements] (const range_type& range) -> value_type
+      { return make_random_tile(range, elements, seed); }, skip_set);
     }
 
     /// Initialize (local) tiles with a user provided functor
@@ -490,8 +801,11 @@ namespace TiledArray {
 
       auto it = pimpl_->pmap()->begin();
       const auto end = pimpl_->pmap()->end();
+      const auto& symmetry = pimpl_->tile_symmetry();
       for(; it != end; ++it) {
         const auto index = *it;
+        if(symmetry && ! symmetry->is_representative(index))
+          continue;
         if(! pimpl_->is_zero(index)) {
           if (skip_set) {
             auto fut = find(index);
@@ -500,7 +814,10 @@ namespace TiledArray {
           }
           Future<value_type> tile = pimpl_->world().taskq.add(
               [] (DistArray_* array, const size_type index, const Op& op) -> value_type
-              { return op(array->trange().make_tile_range(index)); },
+              {
+                NumaScope scope(array->pmap()->numa_node(index));
+                return op(array->trange().make_tile_range(index));
+              },
               this, index, op);
           set(index, tile);
         }
@@ -657,6 +974,66 @@ namespace TiledArray {
       return pimpl_->is_dense();
     }
 
+    /// Check for a diagonal array
+
+    /// The diagonal attribute is set by \c diagonal_array() , and allows
+    /// contractions with a matrix to be evaluated as a scaling of the rows
+    /// or columns of its tiles. It is not kept by the results of expressions.
+    /// \return \c true when only the diagonal elements of the array are
+    /// non-zero
+    bool is_diagonal() const {
+      check_pimpl();
+      return pimpl_->is_diagonal();
+    }
+
+    /// Set the diagonal attribute
+
+    /// \param diagonal \c true when only the diagonal elements of the array
+    /// are non-zero; the tiles must not be modified afterwards
+    void set_diagonal(const bool diagonal = true) {
+      check_pimpl();
+      pimpl_->set_diagonal(diagonal);
+    }
+
+    /// Tile symmetry accessor
+
+    /// \return The permutational symmetry of the tiles, or a null pointer
+    /// when every non-zero tile is stored
+    const std::shared_ptr<const symmetry::TileSymmetry>& tile_symmetry() const {
+      check_pimpl();
+      return pimpl_->tile_symmetry();
+    }
+
+    /// Store only the unique tiles of a symmetric array
+
+    /// The elements of the array must be invariant under the mode
+    /// permutations of \c group , so that each tile is a permutation of the
+    /// representative of its orbit (see \c symmetry::TileSymmetry ). Only
+    /// the representative tiles are stored, and the other tiles are computed
+    /// from them when they are accessed. Local tiles that are not
+    /// representatives are removed, and tiles that are set afterwards are
+    /// ignored unless they are representatives. The shape must have the same
+    /// symmetry as the elements. The symmetry is not kept by the results of
+    /// expressions.
+    /// \param group The group of mode permutations that leave the array
+    /// invariant
+    /// \note This is a local operation; it must be called on every process,
+    /// and no task that uses this array may be running.
+    void set_tile_symmetry(const symmetry::PermutationGroup& group) {
+      check_pimpl();
+      pimpl_->set_tile_symmetry(
+          std::make_shared<const symmetry::TileSymmetry>(group, trange()));
+    }
+
+    /// Store every non-zero tile
+
+    /// The tiles that are not stored by a symmetric array are not restored;
+    /// they must be set before they are used.
+    void clear_tile_symmetry() {
+      check_pimpl();
+      pimpl_->set_tile_symmetry(nullptr);
+    }
+
     /// \deprecated use DistArray::shape()
     DEPRECATED const shape_type& get_shape() const {  return pimpl_->shape(); }
 
@@ -740,7 +1117,14 @@ namespace TiledArray {
     void swap(DistArray_& other) { std::swap(pimpl_, other.pimpl_); }
 
     /// Convert a distributed array into a replicated array
-    void make_replicated() {
+
+    /// The tiles are exchanged among the node leaders and then sent to the
+    /// other processes of each node (see \c detail::Replicator ). See
+    /// \c make_node_shared() for replicated arrays that are held once per
+    /// node.
+    /// \param message_elements The approximate number of elements in each
+    /// message [ default = 1048576 ]
+    void make_replicated(const std::size_t message_elements = 1048576ul) {
       check_pimpl();
       if((! pimpl_->pmap()->is_replicated()) && (world().size() > 1)) {
         // Construct a replicated array
@@ -750,7 +1134,8 @@ namespace TiledArray {
         // Create the replicator object that will do an all-to-all broadcast of
         // the local tile data.
         auto replicator =
-            std::make_shared<detail::Replicator<DistArray_>>(*this, result);
+            std::make_shared<detail::Replicator<DistArray_>>(*this, result,
+            message_elements);
 
         // Put the replicator pointer in the deferred cleanup object so it will
         // be deleted at the end of the next fence.
@@ -761,11 +1146,141 @@ namespace TiledArray {
       }
     }
 
+    /// Redistribute this array with another process map
+
+    /// The local tiles of this array are sent to their owners in the new
+    /// process map, in one message per destination process and about
+    /// \c message_elements elements, instead of one message per tile. The
+    /// tiles are sent as they are assigned, so this array may be the result
+    /// of an expression that is still being evaluated.
+    /// \param pmap The process map of the result, or an empty pointer for the
+    /// default process map
+    /// \param message_elements The number of elements that are sent in each
+    /// message [ default = 2^20 ]
+    /// \return An array with the tiles of this array, distributed by \c pmap
+    DistArray_ redistribute(const std::shared_ptr<pmap_interface>& pmap,
+        const size_type message_elements = 1048576ul) const
+    {
+      check_pimpl();
+      DistArray_ result(world(), trange(), shape(), pmap);
+      pimpl_->redistribute(*result.pimpl_, message_elements);
+      return result;
+    }
+
+    /// Send the tiles of this array to another array
+
+    /// The local tiles of this array are sent to their owners in \c result
+    /// as in \c redistribute() . \c result may live in a world that includes
+    /// the processes of this array, e.g. the parent of the subworld of this
+    /// array, where the processes that are not in the world of this array do
+    /// not call this function.
+    /// \param result An array with the tiled range and the shape of this
+    /// array, and no tiles
+    /// \param message_elements The number of elements that are sent in each
+    /// message [ default = 2^20 ]
+    void redistribute(DistArray_& result,
+        const size_type message_elements = 1048576ul) const
+    {
+      check_pimpl();
+      result.check_pimpl();
+      pimpl_->redistribute(*result.pimpl_, message_elements);
+    }
+
     /// Update shape data and remove tiles that are below the zero threshold
 
     /// \note This function is a no-op for dense arrays.
     void truncate() { TiledArray::truncate(*this); }
 
+    /// Update shape data and remove tiles that are below \c threshold
+
+    /// \c threshold becomes the zero threshold of the shape.
+    /// \param threshold The zero threshold of the truncated array
+    /// \note This function is a no-op for dense arrays.
+    template <typename T>
+    void truncate(const T threshold) { TiledArray::truncate(*this, threshold); }
+
+    /// Update the shape norms of modified tiles
+
+    /// This collective function merges the norms of the local tiles that were
+    /// modified in place into the shape of this array, without rebuilding
+    /// it; the communication and computation scale with the number of
+    /// modified tiles. Local tiles that become zero are removed, and tiles
+    /// that become non-zero may be set afterwards. The tiles are recorded
+    /// as modified (see \c mark_modified() ).
+    /// \tparam SparseNormSequence A sequence of
+    /// <tt>std::pair<size_type,float></tt> objects, where \c first is the
+    /// ordinal index of a local tile and \c second is its Frobenius norm
+    /// \param tile_norms The Frobenius norms of the modified local tiles
+    /// \note All shallow copies of this array share the updated shape, and no
+    /// expression that uses this array may be evaluating.
+    /// \note This function is a no-op for dense arrays.
+    template <typename SparseNormSequence>
+    void update_shape(const SparseNormSequence& tile_norms) {
+      check_pimpl();
+      pimpl_->update_shape(tile_norms);
+    }
+
+    /// Record the in-place modification of local tiles
+
+    /// This collective function assigns the next version of this array (see
+    /// \c version() ) to the tiles that were modified in place by any
+    /// process, e.g. through the tiles returned by \c find() . Reusable
+    /// expression plans (see \c expressions::ExprPlan ) use the versions to
+    /// recompute only the result tiles that depend on modified tiles.
+    /// \param tiles The ordinal indices of the local tiles that were
+    /// modified by this process
+    /// \note All shallow copies of this array share the versions.
+    void mark_modified(const std::vector<size_type>& tiles) {
+      check_pimpl();
+      pimpl_->mark_modified(tiles);
+    }
+
+    /// Version accessor
+
+    /// The version is incremented by each modification of the tiles of this
+    /// array that is recorded by \c mark_modified() , \c update_shape() ,
+    /// or \c reassign() .
+    /// \return The version of this array
+    std::uint64_t version() const {
+      check_pimpl();
+      return pimpl_->version();
+    }
+
+    /// Tile version accessor
+
+    /// \tparam Index The index type
+    /// \param i The index of a tile
+    /// \return The version of this array in which tile \c i was last
+    /// modified, or zero if it was not modified since it was set
+    template <typename Index>
+    std::uint64_t tile_version(const Index& i) const {
+      check_index(i);
+      return pimpl_->tile_version(trange().tiles_range().ordinal(i));
+    }
+
+    /// Replace the shape and the local tiles in place
+
+    /// Each local tile is removed, and the local tiles that are non-zero in
+    /// \c shape are set with <tt>op(index, old)</tt>, where \c old is the
+    /// future of the tile that was removed (a default future when the tile
+    /// was zero), so the new tiles may reuse its memory. Unlike assigning a
+    /// new array, the array object, its process map, and the settings of
+    /// its caches are kept.
+    /// \tparam Op The tile factory type
+    /// \param shape The new shape, which must have the tiled range of this
+    /// array
+    /// \param op The tile factory, which returns a \c Future<value_type>
+    /// \note This is a local operation; it must be called on every process.
+    /// All shallow copies of this array share the new tiles, and no
+    /// expression that uses this array may be evaluating.
+    template <typename Op>
+    void reassign(const shape_type& shape, const Op& op) {
+      check_pimpl();
+      TA_USER_ASSERT(! pimpl_->tile_symmetry(),
+          "DistArray::reassign(): the tiles of a symmetric array cannot be reassigned.");
+      pimpl_->reassign(shape, op);
+    }
+
     /// Check if the array is initialized
 
     /// \return \c false if the array has been default initialized, otherwise
@@ -774,6 +1289,44 @@ namespace TiledArray {
 
   private:
 
+    /// Make a random tensor tile
+
+    /// The tile is constructed with its own type, so the allocator of the
+    /// tensor is used, and filled through its data pointer.
+    /// \param range The range of the tile
+    /// \param elements The element range of the array
+    /// \param seed The seed of the random numbers
+    /// \return The random tile
+    template <typename T = value_type>
+    static typename std::enable_if<detail::is_tensor<T>::value, T>::type
+    make_random_tile(const range_type& range,
+        const typename trange_type::range_type& elements,
+        const std::uint64_t seed)
+    {
+      T tile(range);
+      math::random_fill(tile, elements, seed);
+      return tile;
+    }
+
+    /// Make a random tile of another type
+
+    /// The random numbers are generated in a \c TiledArray::Tensor , which
+    /// is converted to the tile type, e.g. \c Tile<Tensor<T>> .
+    /// \param range The range of the tile
+    /// \param elements The element range of the array
+    /// \param seed The seed of the random numbers
+    /// \return The random tile
+    template <typename T = value_type>
+    static typename std::enable_if<! detail::is_tensor<T>::value, T>::type
+    make_random_tile(const range_type& range,
+        const typename trange_type::range_type& elements,
+        const std::uint64_t seed)
+    {
+      TiledArray::Tensor<element_type> tensor(range);
+      math::random_fill(tensor, elements, seed);
+      return T(std::move(tensor));
+    }
+
     template <typename Index>
     typename std::enable_if<std::is_integral<Index>::value>::type
     check_index(const Index i) const {
@@ -812,30 +1365,30 @@ namespace TiledArray {
 #ifndef TILEDARRAY_HEADER_ONLY
 
   extern template
-  class DistArray<Tensor<double, Eigen::aligned_allocator<double> >, DensePolicy>;
+  class DistArray<Tensor<double, default_allocator<double> >, DensePolicy>;
   extern template
-  class DistArray<Tensor<float, Eigen::aligned_allocator<float> >, DensePolicy>;
+  class DistArray<Tensor<float, default_allocator<float> >, DensePolicy>;
   extern template
-  class DistArray<Tensor<int, Eigen::aligned_allocator<int> >, DensePolicy>;
+  class DistArray<Tensor<int, default_allocator<int> >, DensePolicy>;
   extern template
-  class DistArray<Tensor<long, Eigen::aligned_allocator<long> >, DensePolicy>;
+  class DistArray<Tensor<long, default_allocator<long> >, DensePolicy>;
 //  extern template
-//  class DistArray<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, DensePolicy>;
+//  class DistArray<Tensor<std::complex<double>, default_allocator<std::complex<double> > >, DensePolicy>;
 //  extern template
-//  class DistArray<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, DensePolicy>
+//  class DistArray<Tensor<std::complex<float>, default_allocator<std::complex<float> > >, DensePolicy>
 
   extern template
-  class DistArray<Tensor<double, Eigen::aligned_allocator<double> >, SparsePolicy>;
+  class DistArray<Tensor<double, default_allocator<double> >, SparsePolicy>;
   extern template
-  class DistArray<Tensor<float, Eigen::aligned_allocator<float> >, SparsePolicy>;
+  class DistArray<Tensor<float, default_allocator<float> >, SparsePolicy>;
   extern template
-  class DistArray<Tensor<int, Eigen::aligned_allocator<int> >, SparsePolicy>;
+  class DistArray<Tensor<int, default_allocator<int> >, SparsePolicy>;
   extern template
-  class DistArray<Tensor<long, Eigen::aligned_allocator<long> >, SparsePolicy>;
+  class DistArray<Tensor<long, default_allocator<long> >, SparsePolicy>;
 //  extern template
-//  class DistArray<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, SparsePolicy>;
+//  class DistArray<Tensor<std::complex<double>, default_allocator<std::complex<double> > >, SparsePolicy>;
 //  extern template
-//  class DistArray<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, SparsePolicy>;
+//  class DistArray<Tensor<std::complex<float>, default_allocator<std::complex<float> > >, SparsePolicy>;
 
 #endif // TILEDARRAY_HEADER_ONLY
 
@@ -28,6 +28,7 @@
 
 #include <TiledArray/dist_eval/dist_eval.h>
 #include <TiledArray/block_range.h>
+#include <TiledArray/eval_tile_cache.h>
 
 namespace TiledArray {
   namespace detail {
@@ -45,24 +46,46 @@ namespace TiledArray {
       typedef Op op_type; ///< The operation that will modify this tile
       typedef typename op_type::result_type eval_type;
       typedef Tile tile_type; ///< The input tile type
+      typedef EvalTileCache<Tile> cache_type; ///< The evaluated tile cache type
 
     private:
       mutable tile_type tile_; ///< The input tile
       std::shared_ptr<op_type> op_; ///< The operation that will be applied to argument tiles
       bool consume_; ///< If true, \c tile_ is consumable
+      std::shared_ptr<cache_type> cache_; ///< The cache of evaluated tiles, or null
+      std::size_t index_; ///< The array index of \c tile_ in \c cache_
 
       template <typename T>
       using eval_t = typename eval_trait<typename std::decay<T>::type>::type;
 
+      /// Evaluate the tile with the op object
+      auto eval_tile(std::false_type) const {
+        return ((!Op::is_consumable) && consume_ ? op_->consume(tile_)
+                                                 : (*op_)(tile_));
+      }
+
+      /// Evaluate the tile with the op object, or find it in the cache
+
+      /// The evaluated tile is not shared with the cache, so it is consumed
+      /// by the op object.
+      auto eval_tile(std::true_type) const {
+        typedef decltype(this->eval_tile(std::false_type())) result_type;
+        if(! cache_)
+          return eval_tile(std::false_type());
+        eval_t<tile_type> tile = cache_->evaluate(index_, tile_);
+        return result_type(op_->consume(tile));
+      }
+
     public:
       /// Default constructor
-      LazyArrayTile() : tile_(), op_(), consume_(false) { }
+      LazyArrayTile() : tile_(), op_(), consume_(false), cache_(), index_(0ul) { }
 
       /// Copy constructor
 
       /// \param other The LazyArrayTile object to be copied
       LazyArrayTile(const LazyArrayTile_& other) :
-        tile_(other.tile_), op_(other.op_), consume_(other.consume_)
+        tile_(other.tile_), op_(other.op_), consume_(other.consume_),
+        cache_(other.cache_), index_(other.index_)
       { }
 
       /// Construct from tile and operation
@@ -71,7 +94,20 @@ namespace TiledArray {
       /// \param op The operation to be applied to the input tile
       /// \param consume If true, the input tile may be consumed by \c op
       LazyArrayTile(const tile_type& tile, const std::shared_ptr<op_type>& op, const bool consume) :
-        tile_(tile), op_(op), consume_(consume)
+        tile_(tile), op_(op), consume_(consume), cache_(), index_(0ul)
+      { }
+
+      /// Construct from tile, operation, and evaluated tile cache
+
+      /// \param tile The input tile that will be modified
+      /// \param op The operation to be applied to the input tile
+      /// \param consume If true, the input tile may be consumed by \c op
+      /// \param cache The cache of the evaluated tiles of the array
+      /// \param index The array index of \c tile
+      LazyArrayTile(const tile_type& tile, const std::shared_ptr<op_type>& op,
+          const bool consume, const std::shared_ptr<cache_type>& cache,
+          const std::size_t index) :
+        tile_(tile), op_(op), consume_(consume), cache_(cache), index_(index)
       { }
 
       /// Assignment operator
@@ -81,6 +117,8 @@ namespace TiledArray {
         tile_ = other.tile_;
         op_ = other.op_;
         consume_ = other.consume_;
+        cache_ = other.cache_;
+        index_ = other.index_;
 
         return *this;
       }
@@ -99,28 +137,44 @@ namespace TiledArray {
                                                      : (*op_)(tile_)));
       /// Convert tile to evaluation type using the op object
       explicit operator conversion_result_type() const {
-        return ((!Op::is_consumable) && consume_ ? op_->consume(tile_)
-                                                 : (*op_)(tile_));
+        return eval_tile(is_cacheable_lazy_tile<tile_type>());
       }
 #else
       /// Convert tile to evaluation type using the op object
       explicit operator auto() const {
-        return ((!Op::is_consumable) && consume_ ? op_->consume(tile_)
-                                                 : (*op_)(tile_));
+        return eval_tile(is_cacheable_lazy_tile<tile_type>());
       }
 #endif
 
       /// return ref to input tile
       const tile_type& tile() const { return tile_; }
 
-      /// Serialization (not implemented)
+      /// Serialization
 
+      /// The input tile and the operation are serialized when the tile is
+      /// recomputable (see \c is_recomputable_array_tile ), so the tile is
+      /// evaluated by the process that receives it; the evaluated tile cache
+      /// is not serialized.
       /// \tparam Archive The archive type
       template <typename Archive>
-      void serialize(const Archive&) {
+      void serialize(const Archive& ar) {
+        serialize(ar, is_recomputable_array_tile<LazyArrayTile_>());
+      }
+
+    private:
+
+      template <typename Archive>
+      void serialize(const Archive&, std::false_type) {
         TA_ASSERT(false);
       }
 
+      template <typename Archive>
+      void serialize(const Archive& ar, std::true_type) {
+        if(! op_)
+          op_ = std::make_shared<op_type>();
+        ar & tile_ & consume_ & (*op_);
+      }
+
     }; // LazyArrayTile
 
 
@@ -221,15 +275,15 @@ namespace TiledArray {
         if(tile.probe()) {
           // Skip the task since the tile is ready
           Future<value_type> result;
-          result.set(make_tile(tile, consumable_tile));
+          result.set(make_tile(tile, consumable_tile, array_index));
           const_cast<ArrayEvalImpl_*>(this)->notify();
           return result;
         } else {
           // Spawn a task to set the tile when the input tile is ready.
           Future<value_type> result =
               TensorImpl_::world().taskq.add(shared_from_this(),
-              & ArrayEvalImpl_::make_tile, tile, consumable_tile,
-              madness::TaskAttributes::hipri());
+              & ArrayEvalImpl_::make_tile, tile, consumable_tile, array_index,
+              task_attributes(TaskClass::tile));
 
           result.register_callback(const_cast<ArrayEvalImpl_*>(this));
           return result;
@@ -246,7 +300,20 @@ namespace TiledArray {
 
     private:
 
-      value_type make_tile(const typename array_type::value_type& tile, const bool consume) const {
+      /// Make a lazy tile
+
+      /// The evaluated tile cache of \c array_ is used when it is enabled
+      /// for the tile.
+      /// \param tile The array tile that is the basis for lazy tile
+      /// \param consume If true, \c tile may be consumed
+      /// \param index The array index of \c tile
+      value_type make_tile(const typename array_type::value_type& tile,
+          const bool consume, const size_type index) const
+      {
+        const auto& cache = array_.lazy_tile_cache();
+        if(is_cacheable_lazy_tile<typename array_type::value_type>::value &&
+            cache->enabled(array_.is_local(index)))
+          return value_type(tile, op_, consume, cache, index);
         return value_type(tile, op_, consume);
       }
 
@@ -0,0 +1,308 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  batched_contraction_eval.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_BATCHED_CONTRACTION_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_BATCHED_CONTRACTION_EVAL_H__INCLUDED
+
+#include <unordered_map>
+
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/reduce_task.h>
+#include <TiledArray/type_traits.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Batched distributed contraction evaluator
+
+    /// Evaluates \f$ C_{b m n} = \sum_k A_{b m k} B_{b k n} \f$ , where the
+    /// batch index \c b is shared by the arguments and the result but is not
+    /// summed. The tiles of the left-hand argument are ordered as
+    /// (batch, row, inner), those of the right-hand argument as (batch,
+    /// inner, column), and the (unpermuted) result tiles as (batch, row,
+    /// column). The arguments are distributed such that all tiles of a batch
+    /// are owned by one process (see \c BatchPmap ), which contracts the
+    /// result tiles of that batch from its local tiles. Tiles are not
+    /// broadcast: each argument tile is moved at most once, from the array
+    /// that holds it to the process of its batch, and each result tile is
+    /// sent to its owner.
+    /// \tparam Left The left-hand argument evaluator type
+    /// \tparam Right The right-hand argument evaluator type
+    /// \tparam Op The batched contraction/reduction operation type (see
+    /// \c BatchedContractReduce )
+    /// \tparam Policy The tensor policy class
+    template <typename Left, typename Right, typename Op, typename Policy>
+    class BatchedContractionEvalImpl :
+        public DistEvalImpl<typename Op::result_type, Policy>
+    {
+    public:
+      typedef BatchedContractionEvalImpl<Left, Right, Op, Policy>
+          BatchedContractionEvalImpl_; ///< This object type
+      typedef DistEvalImpl<typename Op::result_type, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Left left_type; ///< The left-hand argument type
+      typedef Right right_type; ///< The right-hand argument type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::range_type range_type; ///< Range type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+      typedef Op op_type; ///< Tile evaluation operator type
+
+    private:
+
+      typedef Future<typename left_type::eval_type> left_future; ///< Future to a left-hand argument tile
+      typedef Future<typename right_type::eval_type> right_future; ///< Future to a right-hand argument tile
+
+      left_type left_; ///< The left-hand argument
+      right_type right_; ///< The right-hand argument
+      op_type op_; ///< The batched tile contraction operation
+
+      const size_type batches_; ///< Number of batch tiles
+      const size_type rows_; ///< Number of tile rows in each batch
+      const size_type k_; ///< Number of inner tiles
+      const size_type cols_; ///< Number of tile columns in each batch
+
+      /// Tile conversion task function
+
+      /// \tparam Tile The input tile type
+      /// \param tile The input tile
+      /// \return The evaluated version of the lazy tile
+      template <typename Tile>
+      static auto convert_tile(const Tile& tile) {
+        TiledArray::Cast<typename eval_trait<Tile>::type, Tile> cast;
+        return cast(tile);
+      }
+
+      /// Conversion function
+
+      /// This function does nothing since tile is not a lazy tile.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return \c tile
+      template <typename Arg>
+      static typename std::enable_if<
+          ! is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_arg_tile(Arg& arg, const typename Arg::size_type index) { return arg.get(index); }
+
+      /// Conversion function
+
+      /// This function spawns a task that will convert a lazy tile from the
+      /// tile type to the evaluated tile type.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return A future to the evaluated tile
+      template <typename Arg>
+      static typename std::enable_if<
+          is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_arg_tile(Arg& arg, const typename Arg::size_type index) {
+        auto convert_tile_fn =
+            &BatchedContractionEvalImpl_::template convert_tile<typename Arg::value_type>;
+        return arg.world().taskq.add(convert_tile_fn, arg.get(index),
+                                     madness::TaskAttributes::hipri());
+      }
+
+      /// The process that contracts a batch
+
+      /// \param batch The batch tile index
+      /// \return The process that owns the argument tiles of \c batch
+      ProcessID batch_owner(const size_type batch) const {
+        return left_.owner(batch * rows_ * k_);
+      }
+
+      /// Check that a result tile is needed
+
+      /// \param index The unpermuted index of the result tile
+      /// \return \c true if the result tile is non-zero
+      bool is_result_needed(const size_type index) const {
+        return ! TensorImpl_::is_zero(DistEvalImpl_::perm_index_to_target(index));
+      }
+
+      /// Take the local tiles of the arguments that are used
+
+      /// \tparam Arg The argument type
+      /// \tparam Used The predicate type
+      /// \param arg The argument
+      /// \param used A predicate that is \c true for argument tiles that
+      /// contribute to a non-zero result tile
+      /// \param[out] tiles The tiles of \c arg that are used by this process
+      template <typename Arg, typename Used>
+      void take_tiles(Arg& arg, const Used& used,
+          std::unordered_map<size_type, Future<typename Arg::eval_type> >& tiles)
+      {
+        for(auto it = arg.pmap()->begin(); it != arg.pmap()->end(); ++it) {
+          const size_type index = *it;
+          if(arg.is_zero(index)) continue;
+          if(used(index))
+            tiles.emplace(index, get_arg_tile(arg, index));
+          else
+            arg.discard(index);
+        }
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param left The left-hand argument evaluator
+      /// \param right The right-hand argument evaluator
+      /// \param world The world where the result lives
+      /// \param trange The tiled range object for the result
+      /// \param shape The tensor shape object for the result
+      /// \param pmap The tile-process map for the result
+      /// \param perm The permutation that is applied to result tile indices
+      /// \param op The batched tile contraction operation
+      /// \param batches The number of batch tiles
+      /// \param k The number of tiles in the inner dimension
+      /// \note The trange, shape, and pmap refer to the final, permuted, state
+      /// for the result.
+      BatchedContractionEvalImpl(const left_type& left, const right_type& right,
+          World& world, const trange_type trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm,
+          const op_type& op, const size_type batches, const size_type k) :
+        DistEvalImpl_(world, trange, shape, pmap, perm),
+        left_(left), right_(right), op_(op), batches_(batches),
+        rows_(left.size() / (batches * k)), k_(k),
+        cols_(right.size() / (batches * k))
+      {
+        TA_ASSERT(left.size() == (batches_ * rows_ * k_));
+        TA_ASSERT(right.size() == (batches_ * k_ * cols_));
+      }
+
+      virtual ~BatchedContractionEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+        const size_type batch =
+            DistEvalImpl_::perm_index_to_source(i) / (rows_ * cols_);
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::world().gop.template recv<value_type>(
+            batch_owner(batch), key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Evaluate the tiles of this tensor
+
+      /// Each process contracts the result tiles of the batches of its
+      /// argument tiles, one reduction task per result tile.
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        World& world = TensorImpl_::world();
+
+        // Start evaluate child tensors
+        left_.eval();
+        right_.eval();
+
+        // Take the local argument tiles that contribute to a non-zero result
+        std::unordered_map<size_type, left_future> left_tiles;
+        take_tiles(left_, [this] (const size_type index) {
+              TA_ASSERT(right_.owner((index / (rows_ * k_)) * k_ * cols_)
+                  == left_.owner(index));
+              const size_type batch = index / (rows_ * k_);
+              const size_type row = (index / k_) % rows_;
+              const size_type k = index % k_;
+              for(size_type col = 0ul; col < cols_; ++col)
+                if(! right_.is_zero((batch * k_ + k) * cols_ + col) &&
+                    is_result_needed((batch * rows_ + row) * cols_ + col))
+                  return true;
+              return false;
+            }, left_tiles);
+        std::unordered_map<size_type, right_future> right_tiles;
+        take_tiles(right_, [this] (const size_type index) {
+              const size_type batch = index / (k_ * cols_);
+              const size_type k = (index / cols_) % k_;
+              const size_type col = index % cols_;
+              for(size_type row = 0ul; row < rows_; ++row)
+                if(! left_.is_zero((batch * rows_ + row) * k_ + k) &&
+                    is_result_needed((batch * rows_ + row) * cols_ + col))
+                  return true;
+              return false;
+            }, right_tiles);
+
+        // Contract the result tiles of the local batches
+        int tile_count = 0;
+        for(size_type batch = 0ul; batch < batches_; ++batch) {
+          if(batch_owner(batch) != world.rank()) continue;
+
+          for(size_type row = 0ul; row < rows_; ++row) {
+            for(size_type col = 0ul; col < cols_; ++col) {
+              const size_type index = (batch * rows_ + row) * cols_ + col;
+              const size_type perm_index = DistEvalImpl_::perm_index_to_target(index);
+              if(TensorImpl_::is_zero(perm_index)) continue;
+
+              ReducePairTask<op_type> task(world, op_);
+              bool empty = true;
+              for(size_type k = 0ul; k < k_; ++k) {
+                const size_type left_index = (batch * rows_ + row) * k_ + k;
+                const size_type right_index = (batch * k_ + k) * cols_ + col;
+                if(left_.is_zero(left_index) || right_.is_zero(right_index))
+                  continue;
+                task.add(left_tiles[left_index], right_tiles[right_index]);
+                empty = false;
+              }
+
+              if(empty) {
+                // The result shape may be non-zero within its threshold
+                DistEvalImpl_::set_tile(perm_index, value_type(
+                    TensorImpl_::trange().make_tile_range(perm_index),
+                    typename value_type::numeric_type(0)));
+              } else {
+                DistEvalImpl_::set_tile(perm_index, task.submit());
+              }
+              ++tile_count;
+            }
+          }
+        }
+
+        // Wait for child tensors to be evaluated, and process tasks while waiting.
+        left_.wait();
+        right_.wait();
+
+        return tile_count;
+      }
+
+    }; // class BatchedContractionEvalImpl
+
+  } // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_BATCHED_CONTRACTION_EVAL_H__INCLUDED
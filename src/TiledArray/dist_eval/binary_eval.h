@@ -20,8 +20,10 @@
 #ifndef TILEDARRAY_DIST_EVAL_BINARY_EVAL_H__INCLUDED
 #define TILEDARRAY_DIST_EVAL_BINARY_EVAL_H__INCLUDED
 
+#include <vector>
 #include <TiledArray/dist_eval/dist_eval.h>
 #include <TiledArray/zero_tensor.h>
+#include <TiledArray/tile_interface/async.h>
 
 namespace TiledArray {
   namespace detail {
@@ -58,8 +60,9 @@ namespace TiledArray {
 
     private:
 
-      left_type left_; ///< Left argument
-      right_type right_; ///< Right argument
+      left_type left_; ///< Left argument, which is released when this object is evaluated
+      right_type right_; ///< Right argument, which is released when this object is evaluated
+      std::shared_ptr<pmap_interface> arg_pmap_; ///< The process map of the arguments
       op_type op_; ///< binary element operator
 
     public:
@@ -79,7 +82,7 @@ namespace TiledArray {
           const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm,
           const op_type& op) :
         DistEvalImpl_(world, trange, shape, pmap, perm),
-        left_(left), right_(right), op_(op)
+        left_(left), right_(right), arg_pmap_(left.pmap()), op_(op)
       {
         TA_ASSERT(left.trange() == right.trange());
       }
@@ -98,8 +101,8 @@ namespace TiledArray {
 
 
         const size_type source_index = DistEvalImpl_::perm_index_to_source(i);
-        const ProcessID source =  left_.owner(source_index); // Left and right
-                                                  // should have the same owner
+        const ProcessID source = arg_pmap_->owner(source_index); // Left and right
+                                                  // have the same owner
 
         const madness::DistributedID key(DistEvalImpl_::id(), i);
         return TensorImpl_::world().gop.template recv<value_type>(source, key);
@@ -116,12 +119,35 @@ namespace TiledArray {
 
       /// Task function for evaluating tiles
 
+      /// Tiles of asynchronous types (see \c async_trait ) are set when their
+      /// kernels complete, without blocking this task.
       /// \param i The tile index
       /// \param left The left-hand tile
       /// \param right The right-hand tile
       template <typename L, typename R>
       void eval_tile(const size_type i, L left, R right) {
-        DistEvalImpl_::set_tile(i, op_(left, right));
+        TaskTraceScope trace("dist_eval", "binary tile");
+        TileTimerScope timer(TileTimings::binary, i);
+        DistEvalImpl_::set_tile(i, async_invoke(op_, left, right));
+      }
+
+      /// Task function for evaluating a chunk of tiles
+
+      /// \param indices The tile indices
+      /// \param lefts The left-hand tiles
+      /// \param rights The right-hand tiles
+      template <typename L, typename R>
+      void eval_tiles(const std::vector<size_type>& indices,
+          std::vector<Future<typename left_type::value_type> > lefts,
+          std::vector<Future<typename right_type::value_type> > rights)
+      {
+        TaskTraceScope trace("dist_eval", "binary tiles");
+        for(size_type j = 0ul; j < indices.size(); ++j) {
+          TileTimerScope timer(TileTimings::binary, indices[j]);
+          L left = lefts[j].get();
+          R right = rights[j].get();
+          DistEvalImpl_::set_tile(indices[j], async_invoke(op_, left, right));
+        }
       }
 
       /// Evaluate the tiles of this tensor
@@ -149,9 +175,36 @@ namespace TiledArray {
 
         size_type task_count = 0ul;
 
+        // Small tiles with two non-zero arguments are evaluated in chunks
+        std::shared_ptr<BinaryEvalImpl_> self = shared_from_this();
+        TileChunker chunker(left_.pmap()->local_size());
+        std::vector<size_type> indices;
+        std::vector<Future<typename left_type::value_type> > lefts;
+        std::vector<Future<typename right_type::value_type> > rights;
+        auto submit = [&] () {
+          if(indices.size() == 1ul)
+            TensorImpl_::world().taskq.add(self,
+                & BinaryEvalImpl_::template eval_tile<left_argument_type, right_argument_type>,
+                indices.front(), lefts.front(), rights.front(),
+                task_attributes(TaskClass::tile));
+          else
+            TensorImpl_::world().taskq.add(self,
+                & BinaryEvalImpl_::template eval_tiles<left_argument_type, right_argument_type>,
+                indices, lefts, rights, task_attributes(TaskClass::tile));
+          indices.clear();
+          lefts.clear();
+          rights.clear();
+        };
+        auto add = [&] (const size_type source_index, const size_type target_index) {
+          indices.push_back(target_index);
+          lefts.push_back(left_.get(source_index));
+          rights.push_back(right_.get(source_index));
+          if(chunker.add(TensorImpl_::trange().make_tile_range(target_index).volume()))
+            submit();
+        };
+
         // Construct local iterator
         TA_ASSERT(left_.pmap() == right_.pmap());
-        std::shared_ptr<BinaryEvalImpl_> self = shared_from_this();
         typename pmap_interface::const_iterator it = left_.pmap()->begin();
         const typename pmap_interface::const_iterator end = left_.pmap()->end();
 
@@ -163,9 +216,7 @@ namespace TiledArray {
             const size_type target_index = DistEvalImpl_::perm_index_to_target(source_index);
 
             // Schedule tile evaluation task
-            TensorImpl_::world().taskq.add(self,
-                & BinaryEvalImpl_::template eval_tile<left_argument_type, right_argument_type>,
-                target_index, left_.get(source_index), right_.get(source_index));
+            add(source_index, target_index);
 
             ++task_count;
           }
@@ -181,15 +232,15 @@ namespace TiledArray {
               if(left_.is_zero(index)) {
                 TensorImpl_::world().taskq.add(self,
                   & BinaryEvalImpl_::template eval_tile<const ZeroTensor, right_argument_type>,
-                  target_index, ZeroTensor(), right_.get(index));
+                  target_index, ZeroTensor(), right_.get(index),
+                  task_attributes(TaskClass::tile));
               } else if(right_.is_zero(index)) {
                 TensorImpl_::world().taskq.add(self,
                   & BinaryEvalImpl_::template eval_tile<left_argument_type, const ZeroTensor>,
-                  target_index, left_.get(index), ZeroTensor());
+                  target_index, left_.get(index), ZeroTensor(),
+                  task_attributes(TaskClass::tile));
               } else {
-                TensorImpl_::world().taskq.add(self,
-                  & BinaryEvalImpl_::template eval_tile<left_argument_type, right_argument_type>,
-                  target_index, left_.get(index), right_.get(index));
+                add(index, target_index);
               }
 
               ++task_count;
@@ -203,10 +254,17 @@ namespace TiledArray {
           }
         }
 
+        if(! indices.empty())
+          submit();
+
         // Wait for child tensors to be evaluated, and process tasks while waiting.
         left_.wait();
         right_.wait();
 
+        // All tiles of the children were taken, so they are no longer needed
+        left_.release();
+        right_.release();
+
         return task_count;
       }
 
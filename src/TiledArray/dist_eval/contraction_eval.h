@@ -20,14 +20,31 @@
 #ifndef TILEDARRAY_DIST_EVAL_CONTRACTION_EVAL_H__INCLUDED
 #define TILEDARRAY_DIST_EVAL_CONTRACTION_EVAL_H__INCLUDED
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <string>
 #include <vector>
 
 #include <TiledArray/config.h>
+#include <TiledArray/bitset.h>
 #include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/dist_eval/node_bcast.h>
+#include <TiledArray/dist_eval/partial_reduce_op.h>
+#include <TiledArray/dist_eval/summa_depth_controller.h>
+#include <TiledArray/dist_eval/summa_group_cache.h>
+#include <TiledArray/dist_eval/summa_options.h>
+#include <TiledArray/dist_eval/summa_overlap_stats.h>
+#include <TiledArray/dist_eval/summa_timeline.h>
 #include <TiledArray/proc_grid.h>
 #include <TiledArray/reduce_task.h>
 #include <TiledArray/type_traits.h>
 #include <TiledArray/shape.h>
+#include <TiledArray/work_counter.h>
+#include <TiledArray/symm/tile_symmetry.h>
+#include <TiledArray/tile_op/contract_reduce.h>
 
 //#define TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL 1
 //#define TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE 1
@@ -38,6 +55,36 @@
 namespace TiledArray {
   namespace detail {
 
+    /// How SUMMA sends the tiles of sparse iterations
+    enum class SummaSendMode {
+      group, ///< Broadcast each tile over the process group of its iteration
+      targeted, ///< Send each tile only to the processes that use it
+      automatic ///< Send targeted when that moves less data than the group
+    };
+
+    /// Send mode of sparse SUMMA iterations
+
+    /// The broadcast group of a sparse SUMMA iteration includes every process
+    /// that uses any tile of the iteration, so each tile is also sent to
+    /// processes that do not use it. Targeted sends compute the destinations
+    /// of each tile from the argument and result shapes, and send it
+    /// point-to-point to those processes only. The initial mode is set with
+    /// the \c TA_SUMMA_SEND_MODE environment variable (\c group ,
+    /// \c targeted , or \c auto ) [ default = auto ]. The mode must be the
+    /// same on every process.
+    /// \return A reference to the send mode
+    inline SummaSendMode& summa_send_mode() {
+      static SummaSendMode mode = [] () {
+        const char* value = getenv("TA_SUMMA_SEND_MODE");
+        if(value && std::string(value) == "group")
+          return SummaSendMode::group;
+        if(value && std::string(value) == "targeted")
+          return SummaSendMode::targeted;
+        return SummaSendMode::automatic;
+      }();
+      return mode;
+    }
+
     /// \brief Distributed contraction evaluator implementation
 
     /// \tparam Left The left-hand argument evaluator type
@@ -49,6 +96,19 @@ namespace TiledArray {
     /// argument and the column phase of the right-hand argument are equal to
     /// the number of rows and columns, respectively, in the \c ProcGrid object
     /// passed to the constructor.
+    /// \note When the \c ProcGrid object has more than one layer (2.5D SUMMA),
+    /// the inner dimension is partitioned among the layers, and the
+    /// arguments are expected to have the distribution of the process maps
+    /// constructed by \c ProcGrid::make_row_phase_pmap() and
+    /// \c ProcGrid::make_col_phase_pmap() . Each layer evaluates a partial
+    /// result that is reduced onto the processes of layer 0.
+    /// \note When the result process map is replicated, the local partial
+    /// results of all processes are packed into one buffer of the non-zero
+    /// result tiles, which is summed onto every process by a single
+    /// all-reduce; the result tiles are not sent individually.
+    /// \note The tiles of a sparse iteration may be sent point-to-point to
+    /// the processes that use them, instead of broadcast over the group of
+    /// the iteration (see \c summa_send_mode() ).
     template <typename Left, typename Right, typename Op, typename Policy>
     class Summa :
         public DistEvalImpl<typename Op::result_type, Policy>,
@@ -68,6 +128,16 @@ namespace TiledArray {
       typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
       typedef typename DistEvalImpl_::eval_type eval_type; ///< Tile evaluation type
       typedef Op op_type; ///< Tile evaluation operator type
+      typedef std::function<bool(size_type, Future<value_type>&)>
+          result_seed_type; ///< Result tile initial value function type
+
+      /// The tile pairs of each local row are contracted with one
+      /// \c gemm_batch call, e.g. by batched BLAS on the device
+      static constexpr bool batched_gemm =
+          has_gemm_batch<typename op_type::result_type,
+              typename std::decay<typename op_type::first_argument_type>::type,
+              typename std::decay<typename op_type::second_argument_type>::type,
+              typename op_type::scalar_type>::value;
 
     private:
       static size_type max_memory_; ///< Maximum memory used per node
@@ -82,12 +152,60 @@ namespace TiledArray {
       madness::Group row_group_; ///< The row process group for this rank
       madness::Group col_group_; ///< The column process group for this rank
 
+      // Cached broadcast groups for sparse arguments (empty if not cached)
+      std::shared_ptr<SummaGroupCache::Entry> group_cache_; ///< The cached groups of this contraction
+
       // Dimension information
       const size_type k_; ///< Number of tiles in the inner dimension
       const ProcGrid proc_grid_; ///< Process grid for this contraction
+      const size_type k_begin_; ///< The first inner tile index of this process's layer
+      const size_type k_end_; ///< The end of the inner tile range of this process's layer
+      const bool work_order_; ///< Visit sparse iterations in order of decreasing work
+      std::vector<size_type> k_order_; ///< Inner index of each iteration position (empty = natural order)
+      Bitset<> local_nonzero_k_; ///< Iterations with local non-zero tiles in both arguments
+      const bool left_dense_; ///< \c left_ has no zero tiles
+      const bool right_dense_; ///< \c right_ has no zero tiles
+
+      // Pipeline depth control
+      const size_type mem_limit_; ///< Maximum memory used per node for this contraction
+      const size_type depth_limit_; ///< Maximum number of concurrent SUMMA iterations for this contraction
+      SummaDepthController depth_controller_; ///< Adjusts the number of concurrent SUMMA iterations
 
       // Contraction results
       ReducePairTask<op_type>* reduce_tasks_; ///< A pointer to the reduction tasks
+      result_seed_type result_seed_; ///< Initial values of the result tiles (may be empty)
+
+      // Batched contraction of the tile pairs of each step
+      typedef typename op_type::result_type batch_result_type; ///< The accumulated result tile type
+      const bool batch_; ///< Contract the tile pairs of each local row of a step in a single task
+      std::vector<batch_result_type> batch_results_; ///< Result tiles accumulated by batch tasks
+      std::vector<char> batch_added_; ///< Flags result tiles that were given at least one tile pair
+      std::vector<Future<bool> > batch_rows_; ///< Completion of the last batch task of each local row
+      madness::Spinlock batch_lock_; ///< Protects \c batch_rows_ and \c batch_added_
+
+      // Replicated result
+      typedef typename numeric_type<value_type>::type
+          replicated_numeric_type; ///< The element type of the replicated result
+      typedef std::vector<replicated_numeric_type>
+          replicated_buffer_type; ///< The buffer type of the replicated result
+      typedef std::integral_constant<bool, is_tensor<value_type>::value>
+          replicable_type; ///< \c std::true_type if the result tiles can be packed
+      const bool replicated_; ///< The result is all-reduced onto every process
+      std::vector<size_type> replicated_offsets_; ///< The offset of each result tile in the buffer
+      replicated_buffer_type replicated_buffer_; ///< The local partial results of this process
+      madness::AtomicInt replicated_pending_; ///< The number of local partial results that are not packed, plus one
+      Future<replicated_buffer_type> replicated_local_; ///< The packed local partial results
+
+      // Result symmetry
+      const std::shared_ptr<const symmetry::TileSymmetry> symmetry_; ///< Only the orbit representatives of the result are computed (may be null)
+
+      // Communication
+      const bool prefetch_; ///< Post the broadcasts of pipelined steps before they run
+      const bool node_bcast_; ///< Broadcast panels in two levels, between and within nodes
+      std::shared_ptr<NodeMap> node_map_; ///< The node of each process (empty for flat broadcasts)
+      mutable std::map<std::pair<size_type, ProcessID>,
+          std::shared_ptr<NodeBcast> > node_bcasts_; ///< Two-level broadcasts of each group and root
+      mutable madness::Spinlock node_bcast_lock_; ///< Protects \c node_bcasts_
 
       // Constants used to iterate over columns and rows of left_ and right_, respectively.
       const size_type left_start_local_; ///< The starting point of left column iterator ranges (just add k for specific columns)
@@ -111,6 +229,39 @@ namespace TiledArray {
 #endif
       ;
 
+      /// Replicated result reduction operation
+
+      /// Sums the packed partial results of the processes. Processes without
+      /// local result tiles contribute an empty buffer, which is skipped.
+      class ReplicatedReduceOp {
+      public:
+        typedef replicated_buffer_type result_type; ///< The result buffer type
+        typedef replicated_buffer_type argument_type; ///< The partial result buffer type
+
+        /// Create an empty result object
+        result_type operator()() const { return result_type(); }
+
+        /// Post processing step (no operation, passthrough)
+        result_type operator()(const result_type& temp) const { return temp; }
+
+        /// Add the partial result \c arg to \c result
+        void operator()(result_type& result, const argument_type& arg) const {
+          if(arg.empty())
+            return;
+          if(result.empty()) {
+            result = arg;
+          } else {
+            TA_ASSERT(result.size() == arg.size());
+            math::inplace_vector_op([] (replicated_numeric_type& MADNESS_RESTRICT l,
+                const replicated_numeric_type r) { l += r; },
+                result.size(), result.data(), arg.data());
+          }
+        }
+      }; // class ReplicatedReduceOp
+
+      /// Key tag of the replicated result all-reduce
+      struct ReplicatedReduceTag { };
+
     protected:
 
       // Import base class functions
@@ -188,12 +339,14 @@ namespace TiledArray {
       /// \param key_offset The key that will be used to identify the process group
       /// \param proc_map The operator that will convert a process row/column
       /// index into the absolute process index (ProcessID)
+      /// \param id The object id used to identify the process group
       /// \return A sparse process group that includes process in the row or
       /// column of this process as defined by \c proc_grid_.
       template <typename Shape, typename ProcMap>
-      madness::Group make_group(const Shape& shape, const std::vector<bool>& process_mask, size_type index,
+      madness::Group make_group(const Shape& shape, const Bitset<>& process_mask, size_type index,
           const size_type end, const size_type stride, const size_type max_group_size,
-          const size_type k, const size_type key_offset, const ProcMap& proc_map) const
+          const size_type k, const size_type key_offset, const ProcMap& proc_map,
+          const madness::uniqueidT& id) const
       {
         // Generate the list of processes in rank_row
         std::vector<ProcessID> proc_list(max_group_size, -1);
@@ -208,7 +361,7 @@ namespace TiledArray {
         for(p = 0ul; (index < end) && (count < max_group_size); index += stride,
             p = (p + 1u) % max_group_size)
         {
-          if((proc_list[p] != -1) || (shape.is_zero(index)) || !process_mask.at(p)) continue;
+          if((proc_list[p] != -1) || (shape.is_zero(index)) || !process_mask[p]) continue;
 
           proc_list[p] = proc_map(p);
           ++count;
@@ -224,14 +377,89 @@ namespace TiledArray {
         proc_list.resize(count);
 
         return madness::Group(TensorImpl_::world(), proc_list,
-            madness::DistributedID(DistEvalImpl_::id(), k + key_offset));
+            madness::DistributedID(id, k + key_offset));
+      }
+
+      /// Process group factory function for a dense argument
+
+      /// This function generates the process group of the processes in
+      /// \c process_mask , which is used when the tiles of the argument
+      /// that selects the processes are all non-zero.
+      /// \tparam ProcMap The process map operation type
+      /// \param process_mask the process mask, if
+      ///        \code process_mask[p] == true \endcode,
+      ///        process \c p is included in the result (p is row/col index
+      ///        in this process's row/column)
+      /// \param max_group_size The number of processes in this process row or
+      /// column as defined by \c proc_grid_.
+      /// \param k The broadcast group index
+      /// \param key_offset The key that will be used to identify the process group
+      /// \param proc_map The operator that will convert a process row/column
+      /// index into the absolute process index (ProcessID)
+      /// \param id The object id used to identify the process group
+      /// \return A process group that includes the root of the broadcast and
+      /// the processes in \c process_mask
+      template <typename ProcMap>
+      madness::Group make_group(const Bitset<>& process_mask,
+          const size_type max_group_size, const size_type k,
+          const size_type key_offset, const ProcMap& proc_map,
+          const madness::uniqueidT& id) const
+      {
+        const size_type root = k % max_group_size;
+        std::vector<ProcessID> proc_list;
+        proc_list.reserve(max_group_size);
+        for(size_type p = 0ul; p < max_group_size; ++p)
+          if((p == root) || process_mask[p])
+            proc_list.push_back(proc_map(p));
+
+        return madness::Group(TensorImpl_::world(), proc_list,
+            madness::DistributedID(id, k + key_offset));
       }
 
       /// Row process group factory function
 
+      /// The group is taken from the group cache when this contraction has a
+      /// cache entry.
       /// \param k The broadcast group index
       /// \return A row process group
       madness::Group make_row_group(const size_type k) const {
+        if(group_cache_)
+          return group_cache_->row_group(k, [=] (const madness::uniqueidT& id)
+              { return this->build_row_group(k, id); });
+        return build_row_group(k, DistEvalImpl_::id());
+      }
+
+      /// Column process group factory function
+
+      /// The group is taken from the group cache when this contraction has a
+      /// cache entry.
+      /// \param k The broadcast group index
+      /// \return A column process group
+      madness::Group make_col_group(const size_type k) const {
+        if(group_cache_)
+          return group_cache_->col_group(k, [=] (const madness::uniqueidT& id)
+              { return this->build_col_group(k, id); });
+        return build_col_group(k, DistEvalImpl_::id());
+      }
+
+      /// Construct a row process group
+
+      /// \param k The broadcast group index
+      /// \param id The object id used to identify the group
+      /// \return A row process group
+      madness::Group build_row_group(const size_type k, const madness::uniqueidT& id) const {
+        const auto map_col =
+            [&](const ProcGrid::size_type col) { return proc_grid_.map_col(col); };
+
+        // A dense column of left_ is sent only where the sparse right_ has
+        // non-zero tiles, which are all the group needs
+        if(left_dense_ && ! right_dense_) {
+          const auto mask = make_dense_row_mask(k);
+          if(! mask[proc_grid_.rank_col()])
+            return madness::Group();
+          return make_group(mask, proc_grid_.proc_cols(), k, k_, map_col, id);
+        }
+
         // Construct the sparse broadcast group
         const size_type right_begin_k = k * proc_grid_.cols();
         const size_type right_end_k = right_begin_k + proc_grid_.cols();
@@ -240,40 +468,68 @@ namespace TiledArray {
         auto result_row_mask_k = make_row_mask(k);
 
         // return empty group if I am not in this group, otherwise make a group
-        if (result_row_mask_k[proc_grid_.rank_col()])
+        if (result_row_mask_k[proc_grid_.rank_col()]) {
+          // The non-zero tiles of a dense right_ do not restrict the group
+          if(right_dense_)
+            return make_group(result_row_mask_k, proc_grid_.proc_cols(), k, k_,
+                              map_col, id);
           return make_group(right_.shape(), result_row_mask_k, right_begin_k, right_end_k,
-                            right_stride_, proc_grid_.proc_cols(), k, k_,
-                            [&](const ProcGrid::size_type col) { return proc_grid_.map_col(col); });
-        else
+                            right_stride_, proc_grid_.proc_cols(), k, k_, map_col, id);
+        } else
           return madness::Group();
       }
 
 
-      /// Column process group factory function
+      /// Construct a column process group
 
       /// \param k The broadcast group index
+      /// \param id The object id used to identify the group
       /// \return A column process group
-      madness::Group make_col_group(const size_type k) const {
+      madness::Group build_col_group(const size_type k, const madness::uniqueidT& id) const {
+        const auto map_row =
+            [&](const ProcGrid::size_type row) { return proc_grid_.map_row(row); };
+
+        // A dense row of right_ is sent only where the sparse left_ has
+        // non-zero tiles, which are all the group needs
+        if(right_dense_ && ! left_dense_) {
+          const auto mask = make_dense_col_mask(k);
+          if(! mask[proc_grid_.rank_row()])
+            return madness::Group();
+          return make_group(mask, proc_grid_.proc_rows(), k, 0ul, map_row, id);
+        }
 
         // make the column mask; using the same mask for all tiles avoids having to compute mask
         // for every tile and use of masked broadcasts
         auto result_col_mask_k = make_col_mask(k);
 
         // return empty group if I am not in this group, otherwise make a group
-        if (result_col_mask_k[proc_grid_.rank_row()])
+        if (result_col_mask_k[proc_grid_.rank_row()]) {
+          // The non-zero tiles of a dense left_ do not restrict the group
+          if(left_dense_)
+            return make_group(result_col_mask_k, proc_grid_.proc_rows(), k, 0ul,
+                              map_row, id);
           return make_group(left_.shape(), result_col_mask_k, k, left_end_, left_stride_,
-                            proc_grid_.proc_rows(), k, 0ul,
-                            [&](const ProcGrid::size_type row) { return proc_grid_.map_row(row); });
-        else
+                            proc_grid_.proc_rows(), k, 0ul, map_row, id);
+        } else
           return madness::Group();
       }
 
+      /// Check for a result tile that is not computed
+
+      /// \param perm_index The permuted index of a result tile
+      /// \return \c true if the tile is zero, or if the result is symmetric
+      /// and the tile is not the representative of its orbit
+      bool is_skipped(const size_type perm_index) const {
+        return TensorImpl_::shape().is_zero(perm_index) ||
+            (symmetry_ && ! symmetry_->is_representative(perm_index));
+      }
+
       /// Makes the row result mask
 
       /// \param k The SUMMA iteration (i.e. contraction tile) index
       /// \return a set object, if \code result[p] == true \endcode the process
       ///         in column \c p of this row has at least 1 result tile for this \c k
-      std::vector<bool> make_row_mask(const size_type k) const {
+      Bitset<> make_row_mask(const size_type k) const {
 
         // "local" A[i][k] (i.e. for all i assigned to my row of processes) will produce C[i][*]
         // for each process in my row of the process grid determine whether there are any
@@ -285,12 +541,14 @@ namespace TiledArray {
         // result shape
         const auto& result_shape = TensorImpl_::shape();
 
-        // if result is dense, include all processors
-        if (result_shape.is_dense())
-          return std::vector<bool>(nproc_cols, true);
-
         // initialize the mask
-        std::vector<bool> mask(nproc_cols, false);
+        Bitset<> mask(nproc_cols);
+
+        // if result is dense, include all processors
+        if (result_shape.is_dense()) {
+          mask.set();
+          return mask;
+        }
 
         // number of tiles in the col dimension of the result
         const auto nj = proc_grid_.cols();
@@ -302,17 +560,18 @@ namespace TiledArray {
         std::tie(i_start, i_fence, i_stride) =
             result_row_range(my_proc_row);
         const auto ik_stride = i_stride * nk;
-        for (size_type i = i_start, ik = i_start * nk + k; i < i_fence;
+        for (size_type i = i_start, ik = i_start * nk + k;
+             (i < i_fence) && (mask.count() != nproc_cols);
              i += i_stride, ik += ik_stride) {
           // ... such that A[i][k] exists ...
           if (!left_.shape().is_zero(ik)) {
             // ... the owner of А[i][k] is always in the group ...
             const auto k_proc_col = k % nproc_cols;
-            mask[k_proc_col] = true;
+            mask.set(k_proc_col);
             // ... loop over processes in my row ...
             for (size_type proc_col = 0; proc_col != nproc_cols; ++proc_col) {
-              // ... that are not the owner of A[i][k] ...
-              if (proc_col != k_proc_col) {
+              // ... that are not already in the group ...
+              if (!mask[proc_col]) {
                 // ... loop over all C[i][j] tiles that belong to this process ...
                 size_type j_start, j_fence, j_stride;
                 std::tie(j_start, j_fence, j_stride) =
@@ -322,8 +581,8 @@ namespace TiledArray {
                      j += j_stride, ij += ij_stride) {
                   // ... if any such C[i][j] exists, update the mask, and move
                   // on to next process
-                  if (!result_shape.is_zero(DistEvalImpl_::perm_index_to_target(ij))) {
-                    mask[proc_col] = true;
+                  if (!is_skipped(DistEvalImpl_::perm_index_to_target(ij))) {
+                    mask.set(proc_col);
                     break;
                   }
                 }
@@ -341,7 +600,7 @@ namespace TiledArray {
       /// \return a set object, if \code result[p] == true \endcode the process
       ///         in row \c p of this column has at least 1 result tile for this
       ///         \c k
-      std::vector<bool> make_col_mask(const size_type k) const {
+      Bitset<> make_col_mask(const size_type k) const {
         // "local" B[k][j] (i.e. for all j assigned to my column of processes)
         // will produce C[*][j]
         // for each process in my column of the process grid determine whether
@@ -354,12 +613,14 @@ namespace TiledArray {
         // result shape
         const auto& result_shape = TensorImpl_::shape();
 
-        // if result is dense, include all processors
-        if (result_shape.is_dense())
-          return std::vector<bool>(nproc_rows, true);
-
         // initialize the mask
-        std::vector<bool> mask(nproc_rows, false);
+        Bitset<> mask(nproc_rows);
+
+        // if result is dense, include all processors
+        if (result_shape.is_dense()) {
+          mask.set();
+          return mask;
+        }
 
         // number of tiles in col dim of the result
         const auto nj = proc_grid_.cols();
@@ -368,17 +629,18 @@ namespace TiledArray {
         size_type j_start, j_fence, j_stride;
         std::tie(j_start, j_fence, j_stride) = result_col_range(my_proc_col);
         const auto kj_stride = j_stride;
-        for (size_type j = j_start, kj = k * nj + j_start; j < j_fence;
+        for (size_type j = j_start, kj = k * nj + j_start;
+             (j < j_fence) && (mask.count() != nproc_rows);
              j += j_stride, kj += kj_stride) {
           // ... such that B[k][j] exists ...
           if (!right_.shape().is_zero(kj)) {
             // ... the owner of B[k][j] is always in the group ...
             auto k_proc_row = k % nproc_rows;
-            mask[k_proc_row] = true;
+            mask.set(k_proc_row);
             // ... loop over processes in my col ...
             for (size_type proc_row = 0; proc_row != nproc_rows; ++proc_row) {
-              // ... that are not the owner of B[k][j] ...
-              if (proc_row != k_proc_row) {
+              // ... that are not already in the group ...
+              if (!mask[proc_row]) {
                 // ... loop over all C[i][j] tiles that belong to this process
                 size_type i_start, i_fence, i_stride;
                 std::tie(i_start, i_fence, i_stride) =
@@ -388,9 +650,9 @@ namespace TiledArray {
                      i += i_stride, ij += ij_stride) {
                   // ... if any such C[i][j] exists, update the mask, and move
                   // on to next process
-                  if (!result_shape.is_zero(
+                  if (!is_skipped(
                           DistEvalImpl_::perm_index_to_target(ij))) {
-                    mask[proc_row] = true;
+                    mask.set(proc_row);
                     break;
                   }
                 }
@@ -402,6 +664,86 @@ namespace TiledArray {
         return mask;
       }
 
+      /// Makes the row mask of a dense left-hand argument
+
+      /// Column \c k of a \c left_ without zero tiles is used by the
+      /// processes of this row that hold a non-zero tile of row \c k of the
+      /// sparse \c right_ that contributes to a computed result tile of this
+      /// row, so only row \c k of \c right_ is scanned.
+      /// \param k The SUMMA iteration (i.e. contraction tile) index
+      /// \return a set object, if \code result[p] == true \endcode the process
+      ///         in column \c p of this row uses column \c k of \c left_ or
+      ///         is the root of its broadcast
+      Bitset<> make_dense_row_mask(const size_type k) const {
+        const auto nproc_cols = proc_grid_.proc_cols();
+        const auto nj = proc_grid_.cols();
+
+        // the owner of A[*][k] is always in the group
+        Bitset<> mask(nproc_cols);
+        mask.set(k % nproc_cols);
+
+        // for each B[k][j] that exists ...
+        size_type i_start, i_fence, i_stride;
+        std::tie(i_start, i_fence, i_stride) =
+            result_row_range(proc_grid_.rank_row());
+        for (size_type j = 0ul, kj = k * nj;
+             (j < nj) && (mask.count() != nproc_cols); ++j, ++kj) {
+          const auto proc_col = j % nproc_cols;
+          if (mask[proc_col] || right_.shape().is_zero(kj)) continue;
+
+          // ... include its owner if it computes a C[i][j] of my rows
+          for (size_type i = i_start, ij = i_start * nj + j; i < i_fence;
+               i += i_stride, ij += i_stride * nj) {
+            if (!is_skipped(DistEvalImpl_::perm_index_to_target(ij))) {
+              mask.set(proc_col);
+              break;
+            }
+          }
+        }
+
+        return mask;
+      }
+
+      /// Makes the column mask of a dense right-hand argument
+
+      /// Row \c k of a \c right_ without zero tiles is used by the processes
+      /// of this column that hold a non-zero tile of column \c k of the
+      /// sparse \c left_ that contributes to a computed result tile of this
+      /// column, so only column \c k of \c left_ is scanned.
+      /// \param k The SUMMA iteration (i.e. contraction tile) index
+      /// \return a set object, if \code result[p] == true \endcode the process
+      ///         in row \c p of this column uses row \c k of \c right_ or is
+      ///         the root of its broadcast
+      Bitset<> make_dense_col_mask(const size_type k) const {
+        const auto nproc_rows = proc_grid_.proc_rows();
+        const auto nj = proc_grid_.cols();
+
+        // the owner of B[k][*] is always in the group
+        Bitset<> mask(nproc_rows);
+        mask.set(k % nproc_rows);
+
+        // for each A[i][k] that exists ...
+        size_type j_start, j_fence, j_stride;
+        std::tie(j_start, j_fence, j_stride) =
+            result_col_range(proc_grid_.rank_col());
+        for (size_type i = 0ul, ik = k; (i < proc_grid_.rows()) &&
+             (mask.count() != nproc_rows); ++i, ik += k_) {
+          const auto proc_row = i % nproc_rows;
+          if (mask[proc_row] || left_.shape().is_zero(ik)) continue;
+
+          // ... include its owner if it computes a C[i][j] of my columns
+          for (size_type j = j_start, ij = i * nj + j_start; j < j_fence;
+               j += j_stride, ij += j_stride) {
+            if (!is_skipped(DistEvalImpl_::perm_index_to_target(ij))) {
+              mask.set(proc_row);
+              break;
+            }
+          }
+        }
+
+        return mask;
+      }
+
       /// computes the result row iteration range for a particular processor
 
       /// \param proc_row the process row in \c this->proc_grid_
@@ -430,6 +772,246 @@ namespace TiledArray {
         return std::make_tuple(start, fence, stride);
       }
 
+      // Memory accounting ----------------------------------------------------
+
+      /// Memory held by the tiles of a SUMMA step
+
+      /// \param k The SUMMA iteration (i.e. contraction tile) index
+      /// \param col The column of left-hand argument tiles for step \c k
+      /// \param row The row of right-hand argument tiles for step \c k
+      /// \return The number of bytes held by the tiles of \c col and \c row
+      std::size_t step_memory(const size_type k, const std::vector<col_datum>& col,
+          const std::vector<row_datum>& row) const
+      {
+        typedef typename numeric_type<typename left_type::eval_type>::type left_numeric_type;
+        typedef typename numeric_type<typename right_type::eval_type>::type right_numeric_type;
+
+        std::size_t left_volume = 0ul;
+        const size_type col_start = left_start_local_ + k;
+        for(const auto& datum : col)
+          left_volume += left_.trange().make_tile_range(col_start
+              + datum.first * left_stride_local_).volume();
+
+        std::size_t right_volume = 0ul;
+        const size_type row_start = k * proc_grid_.cols() + proc_grid_.rank_col();
+        for(const auto& datum : row)
+          right_volume += right_.trange().make_tile_range(row_start
+              + datum.first * right_stride_local_).volume();
+
+        return left_volume * sizeof(left_numeric_type)
+            + right_volume * sizeof(right_numeric_type);
+      }
+
+      /// Record the broadcast overlap of a step
+
+      /// Counts the tiles of \c col and \c row that this process receives
+      /// from other processes, and how many of them have already arrived, in
+      /// \c SummaOverlapStats .
+      /// \param k The iteration index
+      /// \param col The column of tiles from the left-hand argument
+      /// \param row The row of tiles from the right-hand argument
+      void record_overlap(const size_type k, const std::vector<col_datum>& col,
+          const std::vector<row_datum>& row) const
+      {
+        size_type received = 0ul, ready = 0ul;
+        if(! col.empty() && ! left_.is_local(left_start_local_ + k)) {
+          received += col.size();
+          for(const auto& datum : col)
+            if(datum.second.probe())
+              ++ready;
+        }
+        if(! row.empty() && ! right_.is_local(k * proc_grid_.cols() + proc_grid_.rank_col())) {
+          received += row.size();
+          for(const auto& datum : row)
+            if(datum.second.probe())
+              ++ready;
+        }
+        if(received)
+          SummaOverlapStats::record(received, ready);
+      }
+
+      /// Volume of a local result tile
+
+      /// \param reduce_task_index The local index of the result reduce task
+      /// \return The number of elements in the result tile
+      size_type result_tile_volume(const size_type reduce_task_index) const {
+        // Compute the (unpermuted) result tile index
+        const size_type row = proc_grid_.rank_row()
+            + (reduce_task_index / proc_grid_.local_cols()) * proc_grid_.proc_rows();
+        const size_type col = proc_grid_.rank_col()
+            + (reduce_task_index % proc_grid_.local_cols()) * proc_grid_.proc_cols();
+        const size_type index = DistEvalImpl_::perm_index_to_target(
+            row * proc_grid_.cols() + col);
+
+        return TensorImpl_::trange().make_tile_range(index).volume();
+      }
+
+      /// Record the memory of a result tile that receives its first contribution
+
+      /// \param reduce_task_index The local index of the result reduce task
+      void acquire_result_memory(const size_type reduce_task_index) {
+        if(! depth_controller_.active())
+          return;
+        if(batch_ ? bool(batch_added_[reduce_task_index]) :
+            (reduce_tasks_[reduce_task_index].count() != 0))
+          return;
+
+        depth_controller_.acquire_result(result_tile_volume(reduce_task_index)
+            * sizeof(typename numeric_type<value_type>::type));
+      }
+
+#ifdef TILEDARRAY_ENABLE_SUMMA_TIMELINE
+      // Timeline instrumentation ----------------------------------------------
+
+      /// Record a timeline event of this contraction
+
+      /// \param stage The stage name
+      /// \param k The iteration index
+      /// \param begin The start time of the event
+      /// \param bytes The number of bytes received
+      /// \param flops The number of floating point operations
+      void record_timeline(const char* stage, const size_type k, const double begin,
+          const std::size_t bytes = 0ul, const double flops = 0.0) const
+      {
+        SummaTimeline::record(stage, DistEvalImpl_::id().get_obj_id(),
+            TensorImpl_::world().rank(), k, begin, bytes, flops);
+      }
+
+      /// Bytes of the tiles of a step that are received from other processes
+
+      /// \param k The iteration index
+      /// \param col The column of tiles from the left-hand argument
+      /// \param row The row of tiles from the right-hand argument
+      /// \return The number of bytes of the non-local tiles of \c col and \c row
+      std::size_t received_bytes(const size_type k, const std::vector<col_datum>& col,
+          const std::vector<row_datum>& row) const
+      {
+        const bool local_col = col.empty() || left_.is_local(left_start_local_ + k);
+        const bool local_row = row.empty()
+            || right_.is_local(k * proc_grid_.cols() + proc_grid_.rank_col());
+        return step_memory(k, (local_col ? std::vector<col_datum>() : col),
+            (local_row ? std::vector<row_datum>() : row));
+      }
+
+      /// Floating point operations of the tile contractions of a step
+
+      /// The work of each tile pair that contributes to a non-zero result
+      /// tile is \f$ 2mnk = 2 \sqrt{V_l V_r V_c} \f$, where \f$ V_l \f$ ,
+      /// \f$ V_r \f$ , and \f$ V_c \f$ are the volumes of the left, right, and
+      /// result tiles.
+      /// \param k The iteration index
+      /// \param col The column of tiles from the left-hand argument
+      /// \param row The row of tiles from the right-hand argument
+      /// \return The number of floating point operations
+      double step_flops(const size_type k, const std::vector<col_datum>& col,
+          const std::vector<row_datum>& row) const
+      {
+        const size_type col_start = left_start_local_ + k;
+        const size_type row_start = k * proc_grid_.cols() + proc_grid_.rank_col();
+
+        std::vector<double> right_volumes;
+        right_volumes.reserve(row.size());
+        for(const auto& datum : row)
+          right_volumes.push_back(right_.trange().make_tile_range(row_start
+              + datum.first * right_stride_local_).volume());
+
+        double flops = 0.0;
+        for(const auto& datum : col) {
+          const double left_volume = left_.trange().make_tile_range(col_start
+              + datum.first * left_stride_local_).volume();
+          const size_type offset = datum.first * proc_grid_.local_cols();
+          for(size_type j = 0ul; j < row.size(); ++j) {
+            const size_type reduce_task_index = offset + row[j].first;
+            if(! reduce_tasks_[reduce_task_index])
+              continue;
+            flops += 2.0 * std::sqrt(left_volume * right_volumes[j]
+                * double(result_tile_volume(reduce_task_index)));
+          }
+        }
+
+        return flops;
+      }
+
+      /// Record the broadcast of a step, once all of its tiles have arrived
+
+      /// \param k The iteration index
+      /// \param begin The start time of the step
+      /// \param bytes The number of bytes received by this process
+      void bcast_timeline(const size_type k, const double begin, const std::size_t bytes,
+          const std::vector<left_future>&, const std::vector<right_future>&) const
+      {
+        record_timeline("bcast", k, begin, bytes);
+      }
+
+      /// Spawn a task that records the broadcast of a step
+
+      /// \param k The iteration index
+      /// \param begin The start time of the step
+      /// \param col The column of tiles from the left-hand argument
+      /// \param row The row of tiles from the right-hand argument
+      void spawn_bcast_timeline(const size_type k, const double begin,
+          const std::vector<col_datum>& col, const std::vector<row_datum>& row)
+      {
+        std::vector<left_future> left;
+        left.reserve(col.size());
+        for(const auto& datum : col)
+          left.push_back(datum.second);
+        std::vector<right_future> right;
+        right.reserve(row.size());
+        for(const auto& datum : row)
+          right.push_back(datum.second);
+
+        TensorImpl_::world().taskq.add(shared_from_this(), & Summa_::bcast_timeline,
+            k, begin, received_bytes(k, col, row), left, right,
+            task_attributes(TaskClass::step));
+      }
+
+      /// Contraction timeline task
+
+      /// This task runs when the tile contractions of a step are done. It
+      /// records the \c contract event of the step, and then releases the
+      /// task that depends on the contractions.
+      class ContractTimelineTask : public madness::TaskInterface {
+        std::shared_ptr<const Summa_> owner_; ///< The owner of this task
+        madness::TaskInterface* const task_; ///< The task that depends on the contractions
+        const size_type k_; ///< The iteration index
+        const double begin_; ///< The start time of the step
+        const double flops_; ///< The floating point operations of the step
+
+      public:
+        ContractTimelineTask(const std::shared_ptr<const Summa_>& owner,
+            madness::TaskInterface* const task, const size_type k,
+            const double begin, const double flops) :
+#ifdef TILEDARRAY_ENABLE_TASK_DEBUG_TRACE
+          madness::TaskInterface(1, "ContractTimelineTask", task_attributes(TaskClass::step)),
+#else
+          madness::TaskInterface(1, task_attributes(TaskClass::step)),
+#endif
+          owner_(owner), task_(task), k_(k), begin_(begin), flops_(flops)
+        {
+          if(task_) {
+            if (trace_tasks)
+              task_->inc_debug("ContractTimelineTask");
+            else
+              task_->inc();
+          }
+        }
+
+        virtual ~ContractTimelineTask() { }
+
+        virtual void run(const madness::TaskThreadEnv&) {
+          owner_->record_timeline("contract", k_, begin_, 0ul, flops_);
+          if(task_) {
+            if (trace_tasks)
+              task_->notify_debug("ContractTimelineTask");
+            else
+              task_->notify();
+          }
+        }
+
+      }; // class ContractTimelineTask
+#endif // TILEDARRAY_ENABLE_SUMMA_TIMELINE
+
       // Broadcast kernels -----------------------------------------------------
 
       /// Tile conversion task function
@@ -473,10 +1055,51 @@ namespace TiledArray {
         auto convert_tile_fn =
             &Summa_::template convert_tile<typename Arg::value_type>;
         return arg.world().taskq.add(convert_tile_fn, arg.get(index),
-                                     madness::TaskAttributes::hipri());
+                                     task_attributes(TaskClass::broadcast));
       }
 
 
+      /// Estimated time to broadcast a tile
+
+      /// The estimate assumes a latency of 10 microseconds and a bandwidth of
+      /// 1 GB/s for each step of a broadcast.
+      /// \param bytes The size of the tile data
+      /// \return The estimated time, in seconds, to transfer the tile
+      static double transfer_time(const double bytes) {
+        return 1.0e-5 + bytes * 1.0e-9;
+      }
+
+      /// Check that a lazy tile is evaluated by the processes that receive it
+
+      /// This function returns \c false since the tiles of \c arg cannot be
+      /// broadcast before they are evaluated.
+      template <typename Arg>
+      static typename std::enable_if<
+          ! is_recomputable_array_tile<typename Arg::value_type>::value, bool>::type
+      recompute_tile(const Arg&, const typename Arg::size_type) { return false; }
+
+      /// Check that a lazy tile is evaluated by the processes that receive it
+
+      /// A lazy tile is broadcast, and evaluated by the processes that use
+      /// it, when the estimated time to evaluate it (see \c lazy_tile_cost )
+      /// is less than the estimated time to transfer the evaluated tile.
+      /// This decision only depends on the tile range, so all processes
+      /// agree on it.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return \c true if the lazy tile is broadcast
+      template <typename Arg>
+      static typename std::enable_if<
+          is_recomputable_array_tile<typename Arg::value_type>::value, bool>::type
+      recompute_tile(const Arg& arg, const typename Arg::size_type index) {
+        typedef typename Arg::value_type::tile_type tile_type;
+        typedef typename numeric_type<typename Arg::eval_type>::type numeric_type;
+        const auto range = arg.trange().make_tile_range(index);
+        return lazy_tile_cost<tile_type>::eval_time(range) <
+            transfer_time(double(range.volume() * sizeof(numeric_type)));
+      }
+
       /// Collect non-zero tiles from \c arg
 
       /// \tparam Arg The argument type
@@ -496,7 +1119,9 @@ namespace TiledArray {
         if(arg.is_local(index)) {
           for(size_type i = 0ul; index < end; ++i, index += stride) {
             if(arg.shape().is_zero(index)) continue;
-            vec.emplace_back(i, get_tile(arg, index));
+            // A recomputed tile is evaluated when it is broadcast
+            vec.emplace_back(i, (recompute_tile(arg, index) ?
+                Future<typename Arg::eval_type>() : get_tile(arg, index)));
           }
         } else {
           for(size_type i = 0ul; index < end; ++i, index += stride) {
@@ -532,16 +1157,153 @@ namespace TiledArray {
         get_vector(right_, begin, end, right_stride_local_, row);
       }
 
+      /// Two-level broadcast accessor
+
+      /// The two-level broadcast of each group and root is constructed once
+      /// and reused by all broadcasts of this contraction over that group.
+      /// \param group The process group of the broadcast
+      /// \param group_root The root of the broadcast in \c group
+      /// \return The two-level broadcast, or an empty pointer when panels
+      /// are broadcast directly over \c group
+      std::shared_ptr<NodeBcast>
+      get_node_bcast(const madness::Group& group, const ProcessID group_root) const {
+        if(! node_map_)
+          return std::shared_ptr<NodeBcast>();
+
+        World& world = TensorImpl_::world();
+        const size_type nprocs = world.size();
+        const ProcessID root = group.world_rank(group_root);
+        const std::pair<size_type, ProcessID> key(group.id().second, root);
+
+        madness::ScopedMutex<madness::Spinlock> locker(&node_bcast_lock_);
+        auto it = node_bcasts_.find(key);
+        if(it == node_bcasts_.end()) {
+          // Subgroup ids follow the ids of the SUMMA groups, which are less
+          // than 2k, with nprocs + 1 ids for each group and root
+          const size_type index =
+              2ul * k_ + (key.first * nprocs + size_type(root)) * (nprocs + 1ul);
+          it = node_bcasts_.emplace(key, std::make_shared<NodeBcast>(world,
+              *node_map_, group, group_root, DistEvalImpl_::id(), index)).first;
+        }
+        return it->second;
+      }
+
+      /// Record the data moved by the broadcast of a tile
+
+      /// The root of the broadcast sends one copy of the evaluated tile to
+      /// each other process of \c group , which receives it; forwarding by
+      /// the processes of a broadcast tree is not counted.
+      /// \param key_index The broadcast key index of the tile
+      /// \param group The process group of the broadcast
+      /// \param group_root The root of the broadcast in \c group
+      void count_bcast_bytes(const size_type key_index,
+          const madness::Group& group, const ProcessID group_root) const
+      {
+        const std::size_t bytes = tile_bytes(key_index);
+        TiledArray::detail::WorkCounter& counter =
+            TiledArray::detail::WorkCounter::instance();
+        if(group.rank() == group_root)
+          counter.add_bytes_sent(bytes * std::size_t(group.size() - 1));
+        else
+          counter.add_bytes_received(bytes);
+      }
+
+      /// Size of a broadcast tile
+
+      /// \param key_index The broadcast key index of the tile
+      /// \return The number of bytes of the evaluated tile
+      std::size_t tile_bytes(const size_type key_index) const {
+        typedef typename numeric_type<typename left_type::eval_type>::type left_numeric_type;
+        typedef typename numeric_type<typename right_type::eval_type>::type right_numeric_type;
+
+        // Right-hand tile keys follow the keys of the left-hand tiles
+        return (key_index < left_.size() ?
+            left_.trange().make_tile_range(key_index).volume() * sizeof(left_numeric_type) :
+            right_.trange().make_tile_range(key_index - left_.size()).volume()
+              * sizeof(right_numeric_type));
+      }
+
+      /// Broadcast a tile
+
+      /// \tparam T The tile type
+      /// \param key_index The broadcast key index of the tile
+      /// \param tile The tile to be broadcast, which is set on processes other
+      /// than the root
+      /// \param group The process group of the broadcast
+      /// \param group_root The root of the broadcast in \c group
+      /// \param node_bcast The two-level broadcast of \c group, or an empty
+      /// pointer to broadcast directly over \c group
+      template <typename T>
+      void bcast_tile(const size_type key_index, Future<T>& tile,
+          const madness::Group& group, const ProcessID group_root,
+          const std::shared_ptr<NodeBcast>& node_bcast) const
+      {
+        count_bcast_bytes(key_index, group, group_root);
+
+        World& world = TensorImpl_::world();
+        const madness::DistributedID key(DistEvalImpl_::id(), key_index);
+        if(node_bcast) {
+          // Intra-node keys follow the keys of both arguments
+          const madness::DistributedID node_key(DistEvalImpl_::id(),
+              key_index + left_.size() + right_.size());
+          node_bcast->bcast(world, key, node_key, tile);
+        } else {
+          world.gop.bcast(key, tile, group_root, group);
+        }
+      }
+
+      /// Broadcast a lazy tile, which is evaluated by each process
+
+      /// The lazy tile is taken from \c arg on the root of the broadcast.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \param key_index The broadcast key index of the tile
+      /// \param tile The evaluated tile, which is set by this function
+      /// \param group The process group of the broadcast
+      /// \param group_root The root of the broadcast in \c group
+      /// \param node_bcast The two-level broadcast of \c group, or an empty
+      /// pointer to broadcast directly over \c group
+      template <typename Arg>
+      void bcast_lazy_tile(Arg& arg, const size_type index,
+          const size_type key_index, Future<typename Arg::eval_type>& tile,
+          const madness::Group& group, const ProcessID group_root,
+          const std::shared_ptr<NodeBcast>& node_bcast) const
+      {
+        Future<typename Arg::value_type> lazy_tile = (arg.is_local(index) ?
+            arg.get(index) : Future<typename Arg::value_type>());
+        bcast_tile(key_index, lazy_tile, group, group_root, node_bcast);
+        set_lazy_tile(arg, lazy_tile, tile);
+      }
+
+      /// Evaluate a lazy tile
+
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param lazy_tile The lazy tile
+      /// \param tile The evaluated tile, which is set by this function
+      template <typename Arg>
+      static void set_lazy_tile(Arg& arg,
+          const Future<typename Arg::value_type>& lazy_tile,
+          Future<typename Arg::eval_type> tile)
+      {
+        arg.world().taskq.add(
+            [tile] (const typename Arg::value_type& lazy) mutable {
+              tile.set(Summa_::template convert_tile<typename Arg::value_type>(lazy));
+            }, lazy_tile, task_attributes(TaskClass::broadcast));
+      }
+
       /// Broadcast tiles from \c arg
 
+      /// \param[in] arg The owner of the tiles
       /// \param[in] start The index of the first tile to be broadcast
       /// \param[in] stride The stride between tile indices to be broadcast
       /// \param[in] group The process group where the tiles will be broadcast
       /// \param[in] group_root The root process of the broadcast
       /// \param[in] key_offset The broadcast key offset value
       /// \param[out] vec The vector that will hold broadcast tiles
-      template <typename Datum>
-      void bcast(const size_type start, const size_type stride,
+      template <typename Arg, typename Datum>
+      void bcast(Arg& arg, const size_type start, const size_type stride,
           const madness::Group& group, const ProcessID group_root,
           const size_type key_offset, std::vector<Datum>& vec) const
       {
@@ -561,12 +1323,17 @@ namespace TiledArray {
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
 
         // Iterate over tiles to be broadcast
+        TaskTraceScope trace("summa", "bcast");
+        const std::shared_ptr<NodeBcast> node_bcast = get_node_bcast(group, group_root);
         for(typename std::vector<Datum>::iterator it = vec.begin(); it != vec.end(); ++it) {
           const size_type index = it->first * stride + start;
 
           // Broadcast the tile
-          const madness::DistributedID key(DistEvalImpl_::id(), index + key_offset);
-          TensorImpl_::world().gop.bcast(key, it->second, group_root, group);
+          if(recompute_tile(arg, index))
+            bcast_lazy_tile(arg, index, index + key_offset, it->second, group,
+                group_root, node_bcast);
+          else
+            bcast_tile(index + key_offset, it->second, group, group_root, node_bcast);
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
           ss  << index << " ";
@@ -581,13 +1348,211 @@ namespace TiledArray {
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
       }
 
+      // Targeted sends -------------------------------------------------------
+
+      /// Select targeted sends for column \c k of \c left_
+
+      /// Tile <tt>A[i][k]</tt> is used by the processes in this process row
+      /// that hold a non-zero <tt>B[k][j]</tt> with a computed result tile
+      /// <tt>C[i][j]</tt> . The destinations only depend on the shapes, so
+      /// every process of \c row_group computes the same result.
+      /// \param k The column of \c left_
+      /// \param row_group The row group of iteration \c k
+      /// \return The process columns that use each non-zero local tile of
+      /// column \c k , or an empty vector when the column is broadcast over
+      /// \c row_group
+      std::vector<Bitset<> > make_col_dests(const size_type k,
+          const madness::Group& row_group) const
+      {
+        std::vector<Bitset<> > dests;
+        const SummaSendMode mode = summa_send_mode();
+        if((mode == SummaSendMode::group) || TensorImpl_::shape().is_dense())
+          return dests;
+
+        const size_type nj = proc_grid_.cols();
+        const size_type nproc_cols = proc_grid_.proc_cols();
+        const size_type root = k % nproc_cols;
+        std::size_t group_volume = 0ul, targeted_volume = 0ul;
+        for(size_type index = left_start_local_ + k; index < left_end_;
+            index += left_stride_local_)
+        {
+          if(left_.shape().is_zero(index)) continue;
+
+          const size_type i = index / k_;
+          Bitset<> tile_dests(nproc_cols);
+          for(size_type proc_col = 0ul; proc_col != nproc_cols; ++proc_col) {
+            size_type j_start, j_fence, j_stride;
+            std::tie(j_start, j_fence, j_stride) = result_col_range(proc_col);
+            for(size_type j = j_start; j < j_fence; j += j_stride) {
+              if(! right_.shape().is_zero(k * nj + j) &&
+                  ! is_skipped(DistEvalImpl_::perm_index_to_target(i * nj + j)))
+              {
+                tile_dests.set(proc_col);
+                break;
+              }
+            }
+          }
+
+          const std::size_t volume = left_.trange().make_tile_range(index).volume();
+          group_volume += volume * std::size_t(row_group.size() - 1);
+          targeted_volume += volume * (tile_dests.count() - (tile_dests[root] ? 1ul : 0ul));
+          dests.push_back(tile_dests);
+        }
+
+        if((mode == SummaSendMode::automatic) && (targeted_volume >= group_volume))
+          dests.clear();
+        return dests;
+      }
+
+      /// Select targeted sends for row \c k of \c right_
+
+      /// Tile <tt>B[k][j]</tt> is used by the processes in this process
+      /// column that hold a non-zero <tt>A[i][k]</tt> with a computed result
+      /// tile <tt>C[i][j]</tt> .
+      /// \param k The row of \c right_
+      /// \param col_group The column group of iteration \c k
+      /// \return The process rows that use each non-zero local tile of row
+      /// \c k , or an empty vector when the row is broadcast over
+      /// \c col_group
+      std::vector<Bitset<> > make_row_dests(const size_type k,
+          const madness::Group& col_group) const
+      {
+        std::vector<Bitset<> > dests;
+        const SummaSendMode mode = summa_send_mode();
+        if((mode == SummaSendMode::group) || TensorImpl_::shape().is_dense())
+          return dests;
+
+        const size_type nj = proc_grid_.cols();
+        const size_type nproc_rows = proc_grid_.proc_rows();
+        const size_type root = k % nproc_rows;
+        const size_type row_end = (k + 1ul) * nj;
+        std::size_t group_volume = 0ul, targeted_volume = 0ul;
+        for(size_type index = k * nj + proc_grid_.rank_col(); index < row_end;
+            index += right_stride_local_)
+        {
+          if(right_.shape().is_zero(index)) continue;
+
+          const size_type j = index - k * nj;
+          Bitset<> tile_dests(nproc_rows);
+          for(size_type proc_row = 0ul; proc_row != nproc_rows; ++proc_row) {
+            size_type i_start, i_fence, i_stride;
+            std::tie(i_start, i_fence, i_stride) = result_row_range(proc_row);
+            for(size_type i = i_start; i < i_fence; i += i_stride) {
+              if(! left_.shape().is_zero(i * k_ + k) &&
+                  ! is_skipped(DistEvalImpl_::perm_index_to_target(i * nj + j)))
+              {
+                tile_dests.set(proc_row);
+                break;
+              }
+            }
+          }
+
+          const std::size_t volume = right_.trange().make_tile_range(index).volume();
+          group_volume += volume * std::size_t(col_group.size() - 1);
+          targeted_volume += volume * (tile_dests.count() - (tile_dests[root] ? 1ul : 0ul));
+          dests.push_back(tile_dests);
+        }
+
+        if((mode == SummaSendMode::automatic) && (targeted_volume >= group_volume))
+          dests.clear();
+        return dests;
+      }
+
+      /// Send a tile to its destinations
+
+      /// \tparam T The tile type
+      /// \tparam ProcMap The process map operation type
+      /// \param key_index The broadcast key index of the tile
+      /// \param tile The tile to be sent
+      /// \param dests The process rows or columns that use the tile
+      /// \param root The process row or column of the owner of the tile
+      /// \param proc_map The operator that converts a process row or column
+      /// into a process id
+      template <typename T, typename ProcMap>
+      void send_tile(const size_type key_index, const Future<T>& tile,
+          const Bitset<>& dests, const size_type root, const ProcMap& proc_map) const
+      {
+        World& world = TensorImpl_::world();
+        const madness::DistributedID key(DistEvalImpl_::id(), key_index);
+        std::size_t count = 0ul;
+        for(size_type p = 0ul; p < dests.size(); ++p) {
+          if((p == root) || ! dests[p]) continue;
+          world.gop.send(proc_map(p), key, tile);
+          ++count;
+        }
+        TiledArray::detail::WorkCounter::instance().add_bytes_sent(
+            tile_bytes(key_index) * count);
+      }
+
+      /// Send tiles from \c arg to the processes that use them
+
+      /// The owner sends each tile point-to-point to its destinations, which
+      /// receive it; tiles that are not used by this process are removed
+      /// from \c vec .
+      /// \param[in] arg The owner of the tiles
+      /// \param[in] start The index of the first tile to be sent
+      /// \param[in] stride The stride between tile indices to be sent
+      /// \param[in] dests The destinations of each tile of \c vec
+      /// \param[in] root The process row or column of the owner of the tiles
+      /// \param[in] rank The process row or column of this process
+      /// \param[in] proc_map The operator that converts a process row or
+      /// column into a process id
+      /// \param[in] key_offset The broadcast key offset value
+      /// \param[in,out] vec The vector that will hold the tiles
+      template <typename Arg, typename Datum, typename ProcMap>
+      void send(Arg& arg, const size_type start, const size_type stride,
+          const std::vector<Bitset<> >& dests, const size_type root,
+          const size_type rank, const ProcMap& proc_map,
+          const size_type key_offset, std::vector<Datum>& vec) const
+      {
+        TA_ASSERT(dests.size() == vec.size());
+
+        TaskTraceScope trace("summa", "send");
+        World& world = TensorImpl_::world();
+        size_type used = 0ul;
+        for(size_type n = 0ul; n < vec.size(); ++n) {
+          const size_type index = vec[n].first * stride + start;
+          const size_type key_index = index + key_offset;
+          const bool recompute = recompute_tile(arg, index);
+
+          if(rank == root) {
+            if(recompute) {
+              const Future<typename Arg::value_type> lazy_tile = arg.get(index);
+              send_tile(key_index, lazy_tile, dests[n], root, proc_map);
+              if(dests[n][rank])
+                set_lazy_tile(arg, lazy_tile, vec[n].second);
+            } else {
+              send_tile(key_index, vec[n].second, dests[n], root, proc_map);
+            }
+          } else if(dests[n][rank]) {
+            const madness::DistributedID key(DistEvalImpl_::id(), key_index);
+            if(recompute)
+              set_lazy_tile(arg, world.gop.template recv<typename Arg::value_type>(
+                  proc_map(root), key), vec[n].second);
+            else
+              vec[n].second = world.gop.template recv<typename Arg::eval_type>(
+                  proc_map(root), key);
+            TiledArray::detail::WorkCounter::instance().add_bytes_received(
+                tile_bytes(key_index));
+          }
+
+          // Keep the tiles used by this process
+          if(dests[n][rank]) {
+            if(used != n)
+              vec[used] = vec[n];
+            ++used;
+          }
+        }
+        vec.erase(vec.begin() + used, vec.end());
+      }
+
       // Broadcast specialization for left and right arguments -----------------
 
 
       ProcessID get_row_group_root(const size_type k, const madness::Group& row_group) const {
         ProcessID group_root = k % proc_grid_.proc_cols();
         if(! right_.shape().is_dense() && row_group.size() < static_cast<ProcessID>(proc_grid_.proc_cols())) {
-          const ProcessID world_root = proc_grid_.rank_row() * proc_grid_.proc_cols() + group_root;
+          const ProcessID world_root = proc_grid_.map_col(group_root);
           group_root = row_group.rank(world_root);
         }
         return group_root;
@@ -596,12 +1561,29 @@ namespace TiledArray {
       ProcessID get_col_group_root(const size_type k, const madness::Group& col_group) const {
         ProcessID group_root = k % proc_grid_.proc_rows();
         if(! left_.shape().is_dense() && col_group.size() < static_cast<ProcessID>(proc_grid_.proc_rows())) {
-          const ProcessID world_root = group_root * proc_grid_.proc_cols() + proc_grid_.rank_col();
+          const ProcessID world_root = proc_grid_.map_row(group_root);
           group_root = col_group.rank(world_root);
         }
         return group_root;
       }
 
+      /// Evaluate the local recomputed tiles that are not broadcast
+
+      /// \param[in] arg The owner of the tiles
+      /// \param[in] start The index of the first tile
+      /// \param[in] stride The stride between tile indices
+      /// \param[in,out] vec The vector that holds the tiles
+      template <typename Arg, typename Datum>
+      void eval_local_lazy_tiles(Arg& arg, const size_type start,
+          const size_type stride, std::vector<Datum>& vec) const
+      {
+        for(auto& datum : vec) {
+          const size_type index = datum.first * stride + start;
+          if(arg.is_local(index) && recompute_tile(arg, index))
+            set_lazy_tile(arg, arg.get(index), datum.second);
+        }
+      }
+
       /// Broadcast column \c k of \c left_ with a dense right-hand argument
 
       /// \param[in] k The column of \c left_ to be broadcast
@@ -609,9 +1591,21 @@ namespace TiledArray {
       void bcast_col(const size_type k, std::vector<col_datum>& col, const madness::Group& row_group) const {
         // broadcast if I'm part of the broadcast group
         if (!row_group.empty()) {
+          const std::vector<Bitset<> > dests = make_col_dests(k, row_group);
+          if(! dests.empty()) {
+            // Send the tiles of column k of left_ to the processes that use them
+            send(left_, left_start_local_ + k, left_stride_local_, dests,
+                k % proc_grid_.proc_cols(), proc_grid_.rank_col(),
+                [&](const size_type col) { return proc_grid_.map_col(col); }, 0ul, col);
+            return;
+          }
+
           // Broadcast column k of left_.
           ProcessID group_root = get_row_group_root(k, row_group);
-          bcast(left_start_local_ + k, left_stride_local_, row_group, group_root, 0ul, col);
+          bcast(left_, left_start_local_ + k, left_stride_local_, row_group,
+              group_root, 0ul, col);
+        } else {
+          eval_local_lazy_tiles(left_, left_start_local_ + k, left_stride_local_, col);
         }
       }
 
@@ -622,188 +1616,395 @@ namespace TiledArray {
       void bcast_row(const size_type k, std::vector<row_datum>& row, const madness::Group& col_group) const {
         // broadcast if I'm part of the broadcast group
         if (!col_group.empty()) {
+          const std::vector<Bitset<> > dests = make_row_dests(k, col_group);
+          if(! dests.empty()) {
+            // Send the tiles of row k of right_ to the processes that use them
+            send(right_, k * proc_grid_.cols() + proc_grid_.rank_col(),
+                right_stride_local_, dests, k % proc_grid_.proc_rows(),
+                proc_grid_.rank_row(),
+                [&](const size_type row) { return proc_grid_.map_row(row); },
+                left_.size(), row);
+            return;
+          }
+
           // Compute the group root process.
           ProcessID group_root = get_col_group_root(k, col_group);
 
           // Broadcast row k of right_.
-          bcast(k * proc_grid_.cols() + proc_grid_.rank_col(),
+          bcast(right_, k * proc_grid_.cols() + proc_grid_.rank_col(),
                 right_stride_local_, col_group, group_root, left_.size(), row);
+        } else {
+          eval_local_lazy_tiles(right_, k * proc_grid_.cols() + proc_grid_.rank_col(),
+              right_stride_local_, row);
         }
       }
 
-      void bcast_col_range_task(size_type k, const size_type end) const {
-        // Compute the first local row of right
-        const size_type Pcols = proc_grid_.proc_cols();
-        k += (Pcols - ((k + Pcols - proc_grid_.rank_col()) % Pcols)) % Pcols;
-
-        for(; k < end; k += Pcols) {
-
-          // Compute local iteration limits for column k of left_.
-          size_type index = left_start_local_ + k;
-
-          // will create broadcast group only if needed
-          bool have_group = false;
-          madness::Group row_group;
-          ProcessID group_root;
-          bool do_broadcast;
-
-          // Search column k of left for non-zero tiles
-          for(; index < left_end_; index += left_stride_local_) {
-            if(left_.shape().is_zero(index)) continue;
-
-            // Construct broadcast group, if needed
-            if (!have_group) {
-              have_group = true;
-              row_group = make_row_group(k);
-              // broadcast if I am in this group and this group has others
-              do_broadcast = !row_group.empty() && row_group.size() > 1;
-              if (do_broadcast)
-                group_root = get_row_group_root(k, row_group);
+      /// Broadcast the local, non-zero tiles of column \c k of \c left_
+
+      /// This is used for columns that are skipped by the local SUMMA
+      /// iteration but are needed by other processes in this process row.
+      /// \param k The column of \c left_ to be broadcast
+      void bcast_col_tiles(const size_type k) const {
+        // Compute local iteration limits for column k of left_.
+        size_type index = left_start_local_ + k;
+
+        // will create broadcast group only if needed
+        bool have_group = false;
+        madness::Group row_group;
+        ProcessID group_root;
+        std::shared_ptr<NodeBcast> node_bcast;
+        bool do_broadcast;
+
+        // Destinations of targeted sends (empty for broadcasts)
+        std::vector<Bitset<> > dests;
+        size_type n = 0ul;
+        const size_type root = proc_grid_.rank_col();
+        const auto map_col =
+            [&](const size_type col) { return proc_grid_.map_col(col); };
+
+        // Search column k of left for non-zero tiles
+        for(; index < left_end_; index += left_stride_local_) {
+          if(left_.shape().is_zero(index)) continue;
+
+          // Construct broadcast group, if needed
+          if (!have_group) {
+            have_group = true;
+            row_group = make_row_group(k);
+            // broadcast if I am in this group and this group has others
+            do_broadcast = !row_group.empty() && row_group.size() > 1;
+            if (do_broadcast) {
+              dests = make_col_dests(k, row_group);
+              group_root = get_row_group_root(k, row_group);
+              node_bcast = get_node_bcast(row_group, group_root);
             }
+          }
 
-            if(do_broadcast) {
-              // Broadcast the tile
-              const madness::DistributedID key(DistEvalImpl_::id(), index);
-              auto tile = get_tile(left_, index);
-              TensorImpl_::world().gop.bcast(key, tile, group_root, row_group);
-            } else {
-              // Discard the tile
+          if(! dests.empty()) {
+            // Send the tile to the processes that use it
+            const Bitset<>& tile_dests = dests[n++];
+            if(tile_dests.count() == (tile_dests[root] ? 1ul : 0ul)) {
               left_.discard(index);
+            } else if(recompute_tile(left_, index)) {
+              send_tile(index, left_.get(index), tile_dests, root, map_col);
+            } else {
+              send_tile(index, get_tile(left_, index), tile_dests, root, map_col);
+            }
+          } else if(do_broadcast) {
+            // Broadcast the tile, which is not used by this process
+            if(recompute_tile(left_, index)) {
+              auto tile = left_.get(index);
+              bcast_tile(index, tile, row_group, group_root, node_bcast);
+            } else {
+              auto tile = get_tile(left_, index);
+              bcast_tile(index, tile, row_group, group_root, node_bcast);
             }
+          } else {
+            // Discard the tile
+            left_.discard(index);
           }
         }
       }
 
-      void bcast_row_range_task(size_type k, const size_type end) const {
-        // Compute the first local row of right
-        const size_type Prows = proc_grid_.proc_rows();
-        k += (Prows - ((k + Prows - proc_grid_.rank_row()) % Prows)) % Prows;
+      /// Broadcast the local, non-zero tiles of row \c k of \c right_
 
-        for(; k < end; k += Prows) {
-
-          // Compute local iteration limits for row k of right_.
-          size_type index = k * proc_grid_.cols();
-          const size_type row_end = index + proc_grid_.cols();
-          index += proc_grid_.rank_col();
-
-          // will create broadcast group only if needed
-          bool have_group = false;
-          madness::Group col_group;
-          ProcessID group_root;
-          bool do_broadcast;
-
-          // Search for and broadcast non-zero row
-          for(; index < row_end; index += right_stride_local_) {
-            if(right_.shape().is_zero(index)) continue;
-
-            // Construct broadcast group
-            if (!have_group) {
-              have_group = true;
-              col_group = make_col_group(k);
-              // broadcast if I am in this group and this group has others
-              do_broadcast = !col_group.empty() && col_group.size() > 1;
-              if (do_broadcast)
-                group_root = get_col_group_root(k, col_group);
+      /// This is used for rows that are skipped by the local SUMMA iteration
+      /// but are needed by other processes in this process column.
+      /// \param k The row of \c right_ to be broadcast
+      void bcast_row_tiles(const size_type k) const {
+        // Compute local iteration limits for row k of right_.
+        size_type index = k * proc_grid_.cols();
+        const size_type row_end = index + proc_grid_.cols();
+        index += proc_grid_.rank_col();
+
+        // will create broadcast group only if needed
+        bool have_group = false;
+        madness::Group col_group;
+        ProcessID group_root;
+        std::shared_ptr<NodeBcast> node_bcast;
+        bool do_broadcast;
+
+        // Destinations of targeted sends (empty for broadcasts)
+        std::vector<Bitset<> > dests;
+        size_type n = 0ul;
+        const size_type root = proc_grid_.rank_row();
+        const auto map_row =
+            [&](const size_type row) { return proc_grid_.map_row(row); };
+
+        // Search for and broadcast non-zero row
+        for(; index < row_end; index += right_stride_local_) {
+          if(right_.shape().is_zero(index)) continue;
+
+          // Construct broadcast group
+          if (!have_group) {
+            have_group = true;
+            col_group = make_col_group(k);
+            // broadcast if I am in this group and this group has others
+            do_broadcast = !col_group.empty() && col_group.size() > 1;
+            if (do_broadcast) {
+              dests = make_row_dests(k, col_group);
+              group_root = get_col_group_root(k, col_group);
+              node_bcast = get_node_bcast(col_group, group_root);
             }
+          }
 
-            if(do_broadcast) {
-              // Broadcast the tile
-              const madness::DistributedID key(DistEvalImpl_::id(), index + left_.size());
-              auto tile = get_tile(right_, index);
-              TensorImpl_::world().gop.bcast(key, tile, group_root, col_group);
-            } else {
-              // Discard the tile
+          if(! dests.empty()) {
+            // Send the tile to the processes that use it
+            const Bitset<>& tile_dests = dests[n++];
+            if(tile_dests.count() == (tile_dests[root] ? 1ul : 0ul)) {
               right_.discard(index);
+            } else if(recompute_tile(right_, index)) {
+              send_tile(index + left_.size(), right_.get(index), tile_dests,
+                  root, map_row);
+            } else {
+              send_tile(index + left_.size(), get_tile(right_, index),
+                  tile_dests, root, map_row);
             }
+          } else if(do_broadcast) {
+            // Broadcast the tile, which is not used by this process
+            if(recompute_tile(right_, index)) {
+              auto tile = right_.get(index);
+              bcast_tile(index + left_.size(), tile, col_group, group_root, node_bcast);
+            } else {
+              auto tile = get_tile(right_, index);
+              bcast_tile(index + left_.size(), tile, col_group, group_root, node_bcast);
+            }
+          } else {
+            // Discard the tile
+            right_.discard(index);
           }
         }
       }
 
+      void bcast_col_range_task(size_type k, const size_type end) const {
+        TaskTraceScope trace("summa", "bcast skipped");
+        // Compute the first local row of right
+        const size_type Pcols = proc_grid_.proc_cols();
+        k += (Pcols - ((k + Pcols - proc_grid_.rank_col()) % Pcols)) % Pcols;
+
+        for(; k < end; k += Pcols)
+          bcast_col_tiles(k);
+      }
+
+      void bcast_row_range_task(size_type k, const size_type end) const {
+        TaskTraceScope trace("summa", "bcast skipped");
+        // Compute the first local row of right
+        const size_type Prows = proc_grid_.proc_rows();
+        k += (Prows - ((k + Prows - proc_grid_.rank_row()) % Prows)) % Prows;
+
+        for(; k < end; k += Prows)
+          bcast_row_tiles(k);
+      }
+
+      /// Broadcast the local tiles of iterations skipped in the work order
+
+      /// \param pos The first skipped position of \c k_order_
+      /// \param end The end of the skipped positions of \c k_order_
+      void bcast_order_range_task(size_type pos, const size_type end) const {
+        TaskTraceScope trace("summa", "bcast skipped");
+        const size_type Pcols = proc_grid_.proc_cols();
+        const size_type Prows = proc_grid_.proc_rows();
+        for(; pos < end; ++pos) {
+          const size_type k = k_order_[pos];
+          if((k % Pcols) == size_type(proc_grid_.rank_col()))
+            bcast_col_tiles(k);
+          if((k % Prows) == size_type(proc_grid_.rank_row()))
+            bcast_row_tiles(k);
+        }
+      }
 
       // Row and column iteration functions ------------------------------------
 
-      /// Find next non-zero row of \c right_ for a sparse shape
+      /// Check for local non-zero tiles in column \c k of \c left_
+
+      /// \param k The column of \c left_ to check
+      /// \return \c true if this process's row of column \c k contains a
+      /// non-zero tile
+      bool local_col_nonzero(const size_type k) const {
+        for(size_type i = left_start_local_ + k; i < left_end_; i += left_stride_local_)
+          if(! left_.shape().is_zero(i))
+            return true;
+        return false;
+      }
+
+      /// Check for local non-zero tiles in row \c k of \c right_
+
+      /// \param k The row of \c right_ to check
+      /// \return \c true if this process's column of row \c k contains a
+      /// non-zero tile
+      bool local_row_nonzero(const size_type k) const {
+        const size_type end = (k + 1ul) * proc_grid_.cols();
+        for(size_type i = k * proc_grid_.cols() + proc_grid_.rank_col(); i < end; i += right_stride_local_)
+          if(! right_.shape().is_zero(i))
+            return true;
+        return false;
+      }
+
+      /// Inner index of an iteration position
+
+      /// SUMMA iterations are visited in the order given by \c k_order_, or
+      /// in the natural order when no work order is set.
+      /// \param pos The iteration position
+      /// \return The inner (k) index of position \c pos
+      size_type k_at(const size_type pos) const {
+        return (k_order_.empty() ? pos : k_order_[pos]);
+      }
+
+      /// Compute the work-weighted iteration order
+
+      /// The work of iteration \c k is estimated, from the (replicated)
+      /// argument shapes, as the product of the non-zero volume of column
+      /// \c k of \c left_ and row \c k of \c right_ divided by the extent of
+      /// the inner tile. Iterations of this layer are sorted by decreasing
+      /// work, so the largest panels enter the pipeline first, and then
+      /// interleaved by broadcast root column so consecutive iterations are
+      /// rooted on different processes. Every process computes the same
+      /// order, which keeps the order of the broadcasts consistent.
+      void make_work_order() {
+        const size_type M = proc_grid_.rows();
+        const size_type N = proc_grid_.cols();
+
+        // The number of inner dimensions of the (matricized) arguments
+        const unsigned int left_rank = left_.trange().tiles_range().rank();
+        const unsigned int inner_rank = (left_rank
+            + right_.trange().tiles_range().rank()
+            - TensorImpl_::trange().tiles_range().rank()) / 2u;
+
+        // Estimate the work of each iteration of this layer; the work is
+        // negated so the sort below yields decreasing work
+        std::vector<std::pair<double, size_type> > work;
+        work.reserve(k_end_ - k_begin_);
+        for(size_type k = k_begin_; k < k_end_; ++k) {
+          double left_volume = 0.0, right_volume = 0.0;
+          for(size_type i = 0ul; i < M; ++i) {
+            const size_type index = i * k_ + k;
+            if(! left_.shape().is_zero(index))
+              left_volume += left_.trange().make_tile_range(index).volume();
+          }
+          for(size_type j = 0ul; j < N; ++j) {
+            const size_type index = k * N + j;
+            if(! right_.shape().is_zero(index))
+              right_volume += right_.trange().make_tile_range(index).volume();
+          }
+
+          // Compute the extent of inner tile k
+          const auto range = left_.trange().make_tile_range(k);
+          double extent = 1.0;
+          for(unsigned int d = left_rank - inner_rank; d < left_rank; ++d)
+            extent *= range.extent_data()[d];
+
+          work.emplace_back(-(left_volume * right_volume / extent), k);
+        }
+        std::sort(work.begin(), work.end());
 
-      /// Starting at the k-th row of the right-hand argument, find the next row
-      /// that contains at least one non-zero tile. This search only checks for
-      /// non-zero tiles in this processes column.
-      /// \param k The first row to search
-      /// \return The first row, greater than or equal to \c k with non-zero
-      /// tiles, or \c k_ if none is found.
-      size_type iterate_row(size_type k) const {
-        // Iterate over k's until a non-zero tile is found or the end of the
-        // matrix is reached.
-        size_type end = k * proc_grid_.cols();
-        for(; k < k_; ++k) {
-          // Search for non-zero tiles in row k of right
-          size_type i = end + proc_grid_.rank_col();
-          end += proc_grid_.cols();
-          for(; i < end; i += right_stride_local_)
-            if(! right_.shape().is_zero(i))
-              return k;
+        // Group iterations by broadcast root column, in order of decreasing work
+        const size_type Pcols = proc_grid_.proc_cols();
+        std::vector<std::vector<std::pair<double, size_type> > > roots(Pcols);
+        for(const auto& w : work)
+          roots[w.second % Pcols].push_back(w);
+        std::vector<size_type> next(Pcols, 0ul);
+
+        // Positions before this layer are not used, but keep k_order_ indexed
+        // by position
+        k_order_.resize(k_end_);
+        for(size_type pos = 0ul; pos < k_begin_; ++pos)
+          k_order_[pos] = pos;
+
+        // Select the heaviest remaining iteration, skipping the root of the
+        // previous iteration when another root has iterations left
+        size_type last = Pcols;
+        for(size_type pos = k_begin_; pos < k_end_; ++pos) {
+          size_type best = Pcols;
+          for(size_type r = 0ul; r < Pcols; ++r) {
+            if(next[r] == roots[r].size()) continue;
+            if((best == Pcols) || (best == last) ||
+                ((r != last) && (roots[r][next[r]] < roots[best][next[best]])))
+              best = r;
+          }
+          TA_ASSERT(best < Pcols);
+          k_order_[pos] = roots[best][next[best]++].second;
+          last = best;
         }
+      }
 
-        return k;
+      /// Find the iterations with local non-zero tiles
+
+      /// Iteration \c k is set when this process's row of column \c k of
+      /// \c left_ and its column of row \c k of \c right_ both contain
+      /// non-zero tiles. The shapes are scanned once, so the sparse iteration
+      /// only needs to scan the set. An argument without zero tiles is not
+      /// scanned, so the iterations of a sparse-dense contraction are those
+      /// of the sparse argument.
+      void make_local_nonzero_k() {
+        Bitset<> nonzero(k_end_);
+        for(size_type k = k_begin_; k < k_end_; ++k)
+          if((left_dense_ || local_col_nonzero(k)) && (right_dense_ || local_row_nonzero(k)))
+            nonzero.set(k);
+        local_nonzero_k_ = nonzero;
       }
 
-      /// Find the next non-zero column of \c left_ for an arbitrary shape type
+      /// Find the next position in \c k_order_ where the left- and right-hand argument have non-zero tiles
+
+      /// Search the work order for the next k-th column and row of the left-
+      /// and right-hand arguments, respectively, that both contain non-zero
+      /// tiles. This search only checks for non-zero tiles in this process's
+      /// row or column. Local tiles of skipped iterations are broadcast
+      /// immediately.
+      /// \param pos The first position of \c k_order_ to check
+      /// \return The next position of \c k_order_ where the left- and
+      /// right-hand arguments both have non-zero tiles, or \c k_end_ if none
+      /// is found
+      size_type iterate_sparse_ordered(const size_type pos) const {
+        size_type p = pos;
+        for(; p < k_end_; ++p) {
+          const size_type k = k_order_[p];
+          if(local_nonzero_k_[k])
+            break;
+        }
 
-      /// Starting at the k-th column of the left-hand argument, find the next
-      /// column that contains at least one non-zero tile. This search only
-      /// checks for non-zero tiles in this process's row.
-      /// \param k The first column to test for non-zero tiles
-      /// \return The first column, greater than or equal to \c k, that contains
-      /// a non-zero tile. If no non-zero tile is not found, return \c k_.
-      size_type iterate_col(size_type k) const {
-        // Iterate over k's until a non-zero tile is found or the end of the
-        // matrix is reached.
-        for(; k < k_; ++k)
-          // Search row k for non-zero tiles
-          for(size_type i = left_start_local_ + k; i < left_end_; i += left_stride_local_)
-            if(! left_.shape().is_zero(i))
-              return k;
+        if(pos < p) {
+          // Spawn a task to broadcast any local tiles that were skipped
+          TensorImpl_::world().taskq.add(shared_from_this(),
+              & Summa_::bcast_order_range_task, pos, p,
+              task_attributes(TaskClass::broadcast));
+        }
 
-        return k;
+        return p;
       }
 
-
       /// Find the next k where the left- and right-hand argument have non-zero tiles
 
       /// Search for the next k-th column and row of the left- and right-hand
       /// arguments, respectively, that both contain non-zero tiles. This search
       /// only checks for non-zero tiles in this process's row or column. If a
       /// non-zero, local tile is found that does not contribute to local
-      /// contractions, the tiles will be immediately broadcast.
+      /// contractions, the tiles will be immediately broadcast. When a work
+      /// order is set, \c k and the return value are positions in the work
+      /// order (see \c k_at() ).
       /// \param k The first row/column to check
       /// \return The next k-th column and row of the left- and right-hand
       /// arguments, respectively, that both have non-zero tiles
       size_type iterate_sparse(const size_type k) const {
-        // Initial step for k_col and k_row.
-        size_type k_col = iterate_col(k);
-        size_type k_row = iterate_row(k_col);
+        // Iterate in work order, if one has been set
+        if(! k_order_.empty())
+          return iterate_sparse_ordered(k);
 
         // Search for a row and column that both have non-zero tiles
-        while(k_col != k_row) {
-          if(k_col < k_row) {
-            k_col = iterate_col(k_row);
-          } else {
-            k_row = iterate_row(k_col);
-          }
-        }
+        const size_type k_next = (k >= k_end_ ? k :
+            (local_nonzero_k_[k] ? k : local_nonzero_k_.find_next(k)));
 
-        if(k < k_row) {
+        if(k < k_next) {
           // Spawn a task to broadcast any local columns of left that were skipped
           TensorImpl_::world().taskq.add(shared_from_this(),
-              & Summa_::bcast_col_range_task, k, k_row,
-              madness::TaskAttributes::hipri());
+              & Summa_::bcast_col_range_task, k, k_next,
+              task_attributes(TaskClass::broadcast));
 
           // Spawn a task to broadcast any local rows of right that were skipped
           TensorImpl_::world().taskq.add(shared_from_this(),
-              & Summa_::bcast_row_range_task, k, k_col,
-              madness::TaskAttributes::hipri());
+              & Summa_::bcast_row_range_task, k, k_next,
+              task_attributes(TaskClass::broadcast));
         }
 
-        return k_col;
+        return k_next;
       }
 
 
@@ -823,14 +2024,42 @@ namespace TiledArray {
       }
 
 
+      /// Compute the group cache key of this contraction
+
+      /// The broadcast groups depend on the process grid and on the zero
+      /// tiles of the arguments and of the result, visited in the order of
+      /// the contraction (i.e. the result permutation is included). The key
+      /// is the same on all processes.
+      /// \return The group cache key
+      SummaGroupCache::key_type make_group_cache_key() const {
+        std::vector<SummaGroupCache::size_type> dims = { proc_grid_.rows(),
+            proc_grid_.cols(), k_, proc_grid_.proc_rows(), proc_grid_.proc_cols(),
+            proc_grid_.layers(), proc_grid_.layer_size() };
+
+        const size_type result_size = proc_grid_.rows() * proc_grid_.cols();
+        std::vector<bool> zero;
+        zero.reserve(left_.size() + right_.size() + result_size);
+        for(size_type i = 0ul; i < left_.size(); ++i)
+          zero.push_back(left_.shape().is_zero(i));
+        for(size_type i = 0ul; i < right_.size(); ++i)
+          zero.push_back(right_.shape().is_zero(i));
+        for(size_type i = 0ul; i < result_size; ++i)
+          zero.push_back(is_skipped(DistEvalImpl_::perm_index_to_target(i)));
+
+        return SummaGroupCache::key_type(TensorImpl_::world().id(),
+            std::move(dims), std::move(zero));
+      }
+
       // Initialization functions ----------------------------------------------
 
       /// Initialize reduce tasks and construct broadcast groups
-      size_type initialize(const DenseShape&) {
-        // Construct static broadcast groups for dense arguments
-        const madness::DistributedID col_did(DistEvalImpl_::id(), 0ul);
+      size_type initialize(const DenseShape& shape) {
+        // Construct static broadcast groups for dense arguments; groups of
+        // different layers are distinguished by the layer index
+        const size_type layer = proc_grid_.rank_layer();
+        const madness::DistributedID col_did(DistEvalImpl_::id(), layer);
         col_group_ = proc_grid_.make_col_group(col_did);
-        const madness::DistributedID row_did(DistEvalImpl_::id(), k_);
+        const madness::DistributedID row_did(DistEvalImpl_::id(), k_ + layer);
         row_group_ = proc_grid_.make_row_group(row_did);
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
@@ -846,6 +2075,11 @@ namespace TiledArray {
         printf(ss.str().c_str());
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
 
+        // Only the representative result tiles of a symmetric result are
+        // computed
+        if(symmetry_)
+          return initialize_reduce_tasks(shape);
+
         // Allocate memory for the reduce pair tasks.
         std::allocator<ReducePairTask<op_type> > alloc;
         reduce_tasks_ = alloc.allocate(proc_grid_.local_size());
@@ -864,6 +2098,16 @@ namespace TiledArray {
       /// Initialize reduce tasks
       template <typename Shape>
       size_type initialize(const Shape& shape) {
+        return initialize_reduce_tasks(shape);
+      }
+
+      /// Initialize the reduce tasks of the result tiles that are computed
+
+      /// Empty reduce tasks are constructed for the tiles that are skipped
+      /// (see \c is_skipped() ).
+      /// \return The number of local result tiles that are computed
+      template <typename Shape>
+      size_type initialize_reduce_tasks(const Shape&) {
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
         std::stringstream ss;
@@ -895,7 +2139,7 @@ namespace TiledArray {
             // Initialize the reduction task
 
             // Skip zero tiles
-            if(! shape.is_zero(DistEvalImpl_::perm_index_to_target(index))) {
+            if(! is_skipped(DistEvalImpl_::perm_index_to_target(index))) {
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
               ss << index << " ";
@@ -933,8 +2177,255 @@ namespace TiledArray {
       }
 
 
+      /// Add the initial values to the reduce tasks of the local result tiles
+
+      /// Only layer 0 of the process grid adds initial values, since the
+      /// partial results of the other layers are reduced onto it.
+      /// \param shape The shape of the result
+      template <typename Shape>
+      void seed_reduce_tasks(const Shape& shape) {
+        typedef typename numeric_type<value_type>::type result_numeric_type;
+
+        // Initialize iteration variables
+        size_type row_start = proc_grid_.rank_row() * proc_grid_.cols();
+        size_type row_end = row_start + proc_grid_.cols();
+        row_start += proc_grid_.rank_col();
+        const size_type col_stride = // The stride to iterate down a column
+            proc_grid_.proc_rows() * proc_grid_.cols();
+        const size_type row_stride = // The stride to iterate across a row
+            proc_grid_.proc_cols();
+        const size_type end = TensorImpl_::size();
+
+        // Iterate over all local tiles
+        ReducePairTask<op_type>* reduce_task = reduce_tasks_;
+        for(; row_start < end; row_start += col_stride, row_end += col_stride) {
+          for(size_type index = row_start; index < row_end; index += row_stride, ++reduce_task) {
+            if(shape.is_zero(index))
+              continue;
+
+            Future<value_type> tile;
+            if(! result_seed_(index, tile))
+              continue;
+
+            // The initial value is held until the tile is finalized
+            depth_controller_.acquire_result(result_tile_volume(
+                reduce_task - reduce_tasks_) * sizeof(result_numeric_type));
+            reduce_task->seed(tile);
+          }
+        }
+      }
+
+      // Replicated result functions ------------------------------------------
+
+      /// Copy a result tile into a buffer
+
+      /// \param tile The result tile
+      /// \param data The buffer of the tile
+      static void copy_to_buffer(const value_type& tile,
+          replicated_numeric_type* const data, std::true_type)
+      {
+        std::copy(tile.data(), tile.data() + tile.range().volume(), data);
+      }
+
+      static void copy_to_buffer(const value_type&, replicated_numeric_type* const,
+          std::false_type)
+      { TA_ASSERT(false); }
+
+      /// Construct a result tile from a buffer
+
+      /// \param range The range of the tile
+      /// \param data The buffer of the tile, or \c nullptr for a tile of zeros
+      /// \return The result tile
+      static value_type copy_from_buffer(const range_type& range,
+          const replicated_numeric_type* const data, std::true_type)
+      {
+        if(! data)
+          return value_type(range, replicated_numeric_type(0));
+        value_type tile(range);
+        std::copy(data, data + range.volume(), tile.data());
+        return tile;
+      }
+
+      static value_type copy_from_buffer(const range_type&,
+          const replicated_numeric_type* const, std::false_type)
+      {
+        TA_ASSERT(false);
+        return value_type();
+      }
+
+      /// Pack a local partial result into the replicated result buffer
+
+      /// \param perm_index The permuted index of the result tile
+      /// \param tile The local partial result of the tile
+      void pack_replicated(const size_type perm_index, const value_type& tile) {
+        TA_ASSERT(tile.range().volume() ==
+            (replicated_offsets_[perm_index + 1ul] - replicated_offsets_[perm_index]));
+        copy_to_buffer(tile, replicated_buffer_.data() +
+            replicated_offsets_[perm_index], replicable_type());
+        release_replicated();
+      }
+
+      /// Release a reference to the replicated result buffer
+
+      /// The buffer is submitted to the all-reduce when the last local
+      /// partial result is packed.
+      void release_replicated() {
+        if(replicated_pending_.dec_and_test())
+          replicated_local_.set(std::move(replicated_buffer_));
+      }
+
+      /// Construct a tile of the replicated result
+
+      /// \param buffer The reduced buffer of the result tiles
+      /// \param offset The offset of the tile in \c buffer
+      /// \param range The range of the tile
+      /// \return The result tile
+      static value_type unpack_replicated(const replicated_buffer_type& buffer,
+          const size_type offset, const range_type& range)
+      {
+        return copy_from_buffer(range, (buffer.empty() ? nullptr :
+            buffer.data() + offset), replicable_type());
+      }
+
+      /// Start the all-reduce of a replicated result
+
+      /// Every process sets all non-zero result tiles, which are constructed
+      /// from the reduced buffer. The local partial results are packed into
+      /// the buffer of this process when they are finalized; processes
+      /// without local result tiles contribute an empty buffer.
+      /// \return The number of tiles that will be set by this process
+      size_type init_replicated() {
+        World& world = TensorImpl_::world();
+        const size_type size = TensorImpl_::size();
+        const trange_type& trange = TensorImpl_::trange();
+
+        // Find the offset of each non-zero result tile in the buffer
+        size_type tile_count = 0ul;
+        size_type offset = 0ul;
+        replicated_offsets_.resize(size + 1ul);
+        for(size_type i = 0ul; i < size; ++i) {
+          replicated_offsets_[i] = offset;
+          if(! TensorImpl_::is_zero(i)) {
+            offset += trange.make_tile_range(i).volume();
+            ++tile_count;
+          }
+        }
+        replicated_offsets_[size] = offset;
+
+        if(proc_grid_.local_size() > 0ul) {
+          replicated_buffer_.assign(offset, replicated_numeric_type(0));
+          replicated_pending_ = 1;
+        } else {
+          replicated_local_.set(replicated_buffer_type());
+        }
+
+        typedef madness::TaggedKey<madness::uniqueidT, ReplicatedReduceTag> key_type;
+        const Future<replicated_buffer_type> result =
+            world.gop.all_reduce(key_type(DistEvalImpl_::id()), replicated_local_,
+                ReplicatedReduceOp());
+
+        for(size_type i = 0ul; i < size; ++i)
+          if(! TensorImpl_::is_zero(i))
+            DistEvalImpl_::set_tile(i, world.taskq.add(& Summa_::unpack_replicated,
+                result, replicated_offsets_[i], trange.make_tile_range(i),
+                task_attributes(TaskClass::finalize)));
+
+        return tile_count;
+      }
+
       // Finalize functions ----------------------------------------------------
 
+      /// Post-process a result tile accumulated by batch tasks
+
+      /// \param t The local index of the result tile
+      /// \return The result tile
+      value_type batch_result(const size_type t) {
+        value_type result = op_(batch_results_[t]);
+        batch_results_[t] = batch_result_type();
+        return result;
+      }
+
+      /// Check for a local result tile without contributions
+
+      /// \param reduce_task The reduction task for the local partial result
+      /// \return \c true if no tile pairs were contracted for the tile
+      bool local_result_empty(ReducePairTask<op_type>* const reduce_task) const {
+        return (batch_ ? ! batch_added_[reduce_task - reduce_tasks_] :
+            (reduce_task->count() == 0));
+      }
+
+      /// Get the local result tile
+
+      /// \param reduce_task The reduction task for the local partial result
+      /// \return A future to the local result tile
+      Future<value_type> local_result(ReducePairTask<op_type>* const reduce_task) {
+        if(batch_)
+          return TensorImpl_::world().taskq.add(shared_from_this(),
+              & Summa_::batch_result, size_type(reduce_task - reduce_tasks_),
+              task_attributes(TaskClass::finalize));
+        return reduce_task->submit();
+      }
+
+      /// Set a result tile
+
+      /// For a single-layer process grid, the result of \c reduce_task is the
+      /// result tile. Otherwise, processes in layers other than 0 send their
+      /// partial result to the process with the same grid coordinates in
+      /// layer 0, which reduces the partial results and sets the tile.
+      /// \param perm_index The permuted index of the result tile
+      /// \param reduce_task The reduction task for the local partial result
+      void set_result_tile(const size_type perm_index,
+          ReducePairTask<op_type>* const reduce_task)
+      {
+        if(TileTimings::enabled() && (! batch_) && (reduce_task->count() != 0))
+          reduce_task->time_tile(TileTimings::summa, perm_index);
+
+        // Pack the partial result of a replicated result tile
+        if(replicated_) {
+          if(! local_result_empty(reduce_task)) {
+            ++replicated_pending_;
+            TensorImpl_::world().taskq.add(shared_from_this(),
+                & Summa_::pack_replicated, perm_index, local_result(reduce_task),
+                task_attributes(TaskClass::finalize));
+          }
+          return;
+        }
+
+        const size_type layers = proc_grid_.layers();
+        if(layers == 1ul) {
+          DistEvalImpl_::set_tile(perm_index, local_result(reduce_task));
+          return;
+        }
+
+        World& world = TensorImpl_::world();
+        const size_type layer = proc_grid_.rank_layer();
+        if(layer == 0ul) {
+          // Reduce the partial results of all layers
+          ReduceTask<PartialReduceOp<value_type> > layer_reduce_task(world,
+              PartialReduceOp<value_type>());
+          if(! local_result_empty(reduce_task))
+            layer_reduce_task.add(local_result(reduce_task));
+          for(size_type l = 1ul; l < layers; ++l) {
+            const madness::DistributedID key(DistEvalImpl_::id(),
+                l * TensorImpl_::size() + perm_index);
+            layer_reduce_task.add(world.gop.template recv<value_type>(
+                world.rank() + l * proc_grid_.layer_size(), key));
+          }
+
+          DistEvalImpl_::set_tile(perm_index, layer_reduce_task.submit());
+        } else {
+          // Send the partial result to layer 0; keys are offset by the size
+          // of the result to avoid collisions with result tiles
+          const madness::DistributedID key(DistEvalImpl_::id(),
+              layer * TensorImpl_::size() + perm_index);
+          const ProcessID dest = world.rank() - layer * proc_grid_.layer_size();
+          if(! local_result_empty(reduce_task))
+            world.gop.send(dest, key, local_result(reduce_task));
+          else
+            world.gop.send(dest, key, value_type());
+        }
+      }
+
       /// Set the result tiles, destroy reduce tasks, and destroy broadcast groups
       void finalize(const DenseShape&) {
         // Initialize iteration variables
@@ -951,11 +2442,11 @@ namespace TiledArray {
         for(ReducePairTask<op_type>* reduce_task = reduce_tasks_;
             row_start < end; row_start += col_stride, row_end += col_stride) {
           for(size_type index = row_start; index < row_end; index += row_stride, ++reduce_task) {
-
+            const size_type perm_index = DistEvalImpl_::perm_index_to_target(index);
 
             // Set the result tile
-            DistEvalImpl_::set_tile(DistEvalImpl_::perm_index_to_target(index),
-                reduce_task->submit());
+            if(! (symmetry_ && is_skipped(perm_index)))
+              set_result_tile(perm_index, reduce_task);
 
             // Destroy the reduce task
             reduce_task->~ReducePairTask<op_type>();
@@ -969,7 +2460,7 @@ namespace TiledArray {
 
       /// Set the result tiles and destroy reduce tasks
       template <typename Shape>
-      void finalize(const Shape& shape) {
+      void finalize(const Shape&) {
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
         std::stringstream ss;
@@ -994,14 +2485,14 @@ namespace TiledArray {
             const size_type perm_index = DistEvalImpl_::perm_index_to_target(index);
 
             // Skip zero tiles
-            if(! shape.is_zero(perm_index)) {
+            if(! is_skipped(perm_index)) {
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
               ss << index << " ";
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
 
               // Set the result tile
-              DistEvalImpl_::set_tile(perm_index, reduce_task->submit());
+              set_result_tile(perm_index, reduce_task);
             }
 
             // Destroy the reduce task
@@ -1023,9 +2514,20 @@ namespace TiledArray {
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
         printf("finalize: start rank=%i\n", TensorImpl_::world().rank());
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
+#ifdef TILEDARRAY_ENABLE_SUMMA_TIMELINE
+        const double timeline_begin = SummaTimeline::now();
+#endif // TILEDARRAY_ENABLE_SUMMA_TIMELINE
 
         finalize(TensorImpl_::shape());
 
+        // Submit the packed partial results of a replicated result
+        if(replicated_)
+          release_replicated();
+
+#ifdef TILEDARRAY_ENABLE_SUMMA_TIMELINE
+        record_timeline("finalize", k_end_ - k_begin_, timeline_begin);
+#endif // TILEDARRAY_ENABLE_SUMMA_TIMELINE
+
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
         printf("finalize: finish rank=%i\n", TensorImpl_::world().rank());
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
@@ -1040,13 +2542,16 @@ namespace TiledArray {
 
       public:
         FinalizeTask(const std::shared_ptr<Summa_>& owner, const int ndep) :
-          madness::TaskInterface(ndep, madness::TaskAttributes::hipri()),
+          madness::TaskInterface(ndep, task_attributes(TaskClass::finalize)),
           owner_(owner)
         { }
 
         virtual ~FinalizeTask() { }
 
-        virtual void run(const madness::TaskThreadEnv&) { owner_->finalize(); }
+        virtual void run(const madness::TaskThreadEnv&) {
+          TaskTraceScope trace("summa", "finalize");
+          owner_->finalize();
+        }
 
       }; // class FinalizeTask
 
@@ -1074,9 +2579,14 @@ namespace TiledArray {
           for(size_type j = 0ul; j < row.size(); ++j) {
             const size_type reduce_task_index = reduce_task_offset + row[j].first;
 
+            // Skip the tiles of a symmetric result that are not computed
+            if(symmetry_ && ! reduce_tasks_[reduce_task_index])
+              continue;
+
             // Schedule task for contraction pairs
             if(task)
               task->inc();
+            acquire_result_memory(reduce_task_index);
             const left_future left = col[i].second;
             const right_future right = row[j].second;
             reduce_tasks_[reduce_task_index].add(left, right, task);
@@ -1117,6 +2627,7 @@ namespace TiledArray {
               else
                 task->inc();
             }
+            acquire_result_memory(reduce_task_index);
             const left_future left = col[i].second;
             const right_future right = row[j].second;
             reduce_tasks_[reduce_task_index].add(left, right, task);
@@ -1152,7 +2663,7 @@ namespace TiledArray {
           row_shape_values.push_back(right_.shape()[row_start + (row[j].first * right_stride_local_)]);
 
         const size_type col_start = left_start_local_ + k;
-        const float threshold_k = TensorImpl_::shape().threshold() / typename SparseShape<T>::value_type(k_);
+        const float threshold_k = TensorImpl_::shape().zero_threshold() / typename SparseShape<T>::value_type(k_);
         // Iterate over the row
         for(size_type i = 0ul; i != col.size(); ++i) {
           // Compute the local, result-tile offset
@@ -1181,9 +2692,119 @@ namespace TiledArray {
       }
 #endif // TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
 
+      /// Contract the tile pairs of one local row of a SUMMA step
+
+      /// The products are accumulated, in order, into the local result tiles.
+      /// Batch tasks of the same row are chained so that only one task at a
+      /// time updates the result tiles of a row.
+      /// \param left The left-hand tile of this row
+      /// \param right The right-hand tiles
+      /// \param indices The reduce task indices of the result tiles
+      /// \param task The task that depends on this batch
+      /// \return \c true
+      bool batch_task(const bool, const typename left_type::eval_type& left,
+          const std::vector<right_future>& right, const std::vector<size_type>& indices,
+          madness::TaskInterface* const task)
+      {
+        TA_ASSERT(right.size() == indices.size());
+        batch_contract(left, right, indices,
+            std::integral_constant<bool, batched_gemm>());
+
+        if(task) {
+          if (trace_tasks)
+            task->notify_debug("Summa::batch_task");
+          else
+            task->notify();
+        }
+
+        return true;
+      }
+
+      /// Contract the tile pairs of a batch one at a time
+      void batch_contract(const typename left_type::eval_type& left,
+          const std::vector<right_future>& right,
+          const std::vector<size_type>& indices, std::false_type)
+      {
+        for(size_type n = 0ul; n < indices.size(); ++n)
+          op_(batch_results_[indices[n]], left, right[n].get());
+      }
+
+      /// Contract the tile pairs of a batch with one \c gemm_batch call
+      void batch_contract(const typename left_type::eval_type& left,
+          const std::vector<right_future>& right,
+          const std::vector<size_type>& indices, std::true_type)
+      {
+        std::vector<batch_result_type*> results;
+        std::vector<const typename right_type::eval_type*> rights;
+        results.reserve(indices.size());
+        rights.reserve(indices.size());
+        for(size_type n = 0ul; n < indices.size(); ++n) {
+          results.push_back(& batch_results_[indices[n]]);
+          rights.push_back(& right[n].get());
+        }
+        op_(results, left, rights);
+      }
+
+      /// Schedule batched contraction tasks for \c col and \c row tile pairs
+
+      /// Schedule one task for each tile of \c col, that contracts it with all
+      /// tiles of \c row that contribute to non-zero result tiles. A callback
+      /// to \c task will be registered with each batch task.
+      /// \param col A column of tiles from the left-hand argument
+      /// \param row A row of tiles from the right-hand argument
+      /// \param task The task that depends on batch tasks
+      void contract_batch(const std::vector<col_datum>& col,
+          const std::vector<row_datum>& row, madness::TaskInterface* const task)
+      {
+        // Iterate over the row
+        for(size_type i = 0ul; i < col.size(); ++i) {
+          // Compute the local, result-tile offset
+          const size_type reduce_task_offset = col[i].first * proc_grid_.local_cols();
+
+          // Collect the non-zero result tiles of this row
+          std::vector<size_type> indices;
+          std::vector<right_future> right;
+          indices.reserve(row.size());
+          right.reserve(row.size());
+          madness::ScopedMutex<madness::Spinlock> locker(& batch_lock_);
+          for(size_type j = 0ul; j < row.size(); ++j) {
+            const size_type reduce_task_index = reduce_task_offset + row[j].first;
+
+            // Skip zero tiles
+            if(! reduce_tasks_[reduce_task_index])
+              continue;
+
+            acquire_result_memory(reduce_task_index);
+            batch_added_[reduce_task_index] = 1;
+            indices.push_back(reduce_task_index);
+            right.push_back(row[j].second);
+          }
+
+          if(indices.empty())
+            continue;
+
+          // Schedule the batch after the previous batch of this row
+          if(task) {
+            if (trace_tasks)
+              task->inc_debug("Summa::batch_task");
+            else
+              task->inc();
+          }
+          Future<bool>& row_done = batch_rows_[col[i].first];
+          row_done = TensorImpl_::world().taskq.add(shared_from_this(),
+              & Summa_::batch_task, row_done, col[i].second, right, indices,
+              task, task_attributes(TaskClass::compute));
+        }
+      }
+
       void contract(const size_type k, const std::vector<col_datum>& col,
           const std::vector<row_datum>& row, madness::TaskInterface* const task)
-      { contract(TensorImpl_::shape(), k, col, row, task); }
+      {
+        if(batch_)
+          contract_batch(col, row, task);
+        else
+          contract(TensorImpl_::shape(), k, col, row, task);
+      }
 
 
       // SUMMA step task -------------------------------------------------------
@@ -1203,6 +2824,11 @@ namespace TiledArray {
         FinalizeTask* finalize_task_; ///< The SUMMA finalization task
         StepTask* next_step_task_ = nullptr; ///< The next SUMMA step task
         StepTask* tail_step_task_ = nullptr; ///< The last SUMMA step task that currently exists
+        std::size_t step_memory_ = 0ul; ///< Memory of the steps that must be contracted before this task runs
+        bool prefetched_ = false; ///< The broadcasts of this step are posted before it runs
+#ifdef TILEDARRAY_ENABLE_SUMMA_TIMELINE
+        double timeline_begin_ = 0.0; ///< The start time of this step
+#endif // TILEDARRAY_ENABLE_SUMMA_TIMELINE
 
         void get_col(const size_type k) {
           owner_->get_col(k, col_);
@@ -1220,13 +2846,52 @@ namespace TiledArray {
             this->notify();
         }
 
+        void prefetch_col(const size_type k, const madness::Group& row_group) {
+          owner_->get_col(k, col_);
+          owner_->bcast_col(k, col_, row_group);
+          if (trace_tasks)
+            this->notify_debug("StepTask::spawn_col");
+          else
+            this->notify();
+        }
+
+        void prefetch_row(const size_type k, const madness::Group& col_group) {
+          owner_->get_row(k, row_);
+          owner_->bcast_row(k, row_, col_group);
+          if (trace_tasks)
+            this->notify_debug("StepTask::spawn_row");
+          else
+            this->notify();
+        }
+
+        /// Submit the contractions of this step
+
+        /// \param k The iteration index
+        /// \param task The task that depends on the contractions
+        void contract(const size_type k, madness::TaskInterface* const task) {
+#ifdef TILEDARRAY_ENABLE_SUMMA_TIMELINE
+          // Insert a task between the contractions and \c task that records
+          // the completion time of the contractions
+          ContractTimelineTask* const timeline_task = new ContractTimelineTask(
+              owner_, task, k, timeline_begin_, owner_->step_flops(k, col_, row_));
+          owner_->contract(k, col_, row_, timeline_task);
+          world_.taskq.add(timeline_task);
+          if (trace_tasks)
+            timeline_task->notify_debug("ContractTimelineTask");
+          else
+            timeline_task->notify();
+#else
+          owner_->contract(k, col_, row_, task);
+#endif // TILEDARRAY_ENABLE_SUMMA_TIMELINE
+        }
+
       public:
 
         StepTask(const std::shared_ptr<Summa_>& owner, int finalize_ndep) :
 #ifdef TILEDARRAY_ENABLE_TASK_DEBUG_TRACE
-        madness::TaskInterface(0ul, "StepTask 1st ctor", madness::TaskAttributes::hipri()),
+        madness::TaskInterface(0ul, "StepTask 1st ctor", task_attributes(TaskClass::step)),
 #else
-        madness::TaskInterface(0ul, madness::TaskAttributes::hipri()),
+        madness::TaskInterface(0ul, task_attributes(TaskClass::step)),
 #endif
           owner_(owner), world_(owner->world()),
           finalize_task_(new FinalizeTask(owner, finalize_ndep))
@@ -1241,9 +2906,9 @@ namespace TiledArray {
         /// \param ndep The number of dependencies for this task
         StepTask(StepTask* const parent, const int ndep) :
 #ifdef TILEDARRAY_ENABLE_TASK_DEBUG_TRACE
-          madness::TaskInterface(ndep, "StepTask nth ctor", madness::TaskAttributes::hipri()),
+          madness::TaskInterface(ndep, "StepTask nth ctor", task_attributes(TaskClass::step)),
 #else
-          madness::TaskInterface(ndep, madness::TaskAttributes::hipri()),
+          madness::TaskInterface(ndep, task_attributes(TaskClass::step)),
 #endif
           owner_(parent->owner_), world_(parent->world_),
           finalize_task_(parent->finalize_task_)
@@ -1260,22 +2925,57 @@ namespace TiledArray {
             madness::DependencyInterface::inc_debug("StepTask::spawn_col");
           else
             madness::DependencyInterface::inc();
-          world_.taskq.add(this, & StepTask::get_col, k, madness::TaskAttributes::hipri());
+          world_.taskq.add(this, & StepTask::get_col, k, task_attributes(TaskClass::broadcast));
 
           // Submit the task to collect row tiles of right for iteration k
           if (trace_tasks)
             madness::DependencyInterface::inc_debug("StepTask::spawn_row");
           else
             madness::DependencyInterface::inc();
-          world_.taskq.add(this, & StepTask::get_row, k, madness::TaskAttributes::hipri());
+          world_.taskq.add(this, & StepTask::get_row, k, task_attributes(TaskClass::broadcast));
+        }
+
+        /// Spawn tasks that get and broadcast the tiles of iteration \c k
+
+        /// The broadcasts are posted as soon as the tiles and groups are
+        /// available, instead of when this step task runs, so the panels of
+        /// the steps in the pipeline are communicated while earlier steps are
+        /// contracted.
+        /// \tparam GroupType The group type, \c madness::Group or a
+        /// \c Future to it
+        /// \param k The iteration index
+        /// \param row_group The row group used to broadcast the column of left
+        /// \param col_group The column group used to broadcast the row of right
+        template <typename GroupType>
+        void spawn_prefetch_row_col_tasks(const size_type k,
+            const GroupType& row_group, const GroupType& col_group)
+        {
+          prefetched_ = true;
+
+          // Submit the task to collect and broadcast column tiles of left
+          if (trace_tasks)
+            madness::DependencyInterface::inc_debug("StepTask::spawn_col");
+          else
+            madness::DependencyInterface::inc();
+          world_.taskq.add(this, & StepTask::prefetch_col, k, row_group,
+              task_attributes(TaskClass::broadcast));
+
+          // Submit the task to collect and broadcast row tiles of right
+          if (trace_tasks)
+            madness::DependencyInterface::inc_debug("StepTask::spawn_row");
+          else
+            madness::DependencyInterface::inc();
+          world_.taskq.add(this, & StepTask::prefetch_row, k, col_group,
+              task_attributes(TaskClass::broadcast));
         }
 
         template <typename Derived>
         void make_next_step_tasks(Derived* task, size_type depth) {
           TA_ASSERT(depth > 0);
           // Set the depth to be no greater than the maximum number steps
-          if(depth > owner_->k_)
-            depth = owner_->k_;
+          const size_type steps = owner_->k_end_ - owner_->k_begin_;
+          if(depth > steps)
+            depth = steps;
 
           // Spawn n=depth step tasks
           for(; depth > 0ul; --depth) {
@@ -1289,37 +2989,86 @@ namespace TiledArray {
         }
 
         template <typename Derived, typename GroupType>
-        void run(const size_type k, const GroupType& row_group, const GroupType& col_group) {
+        void run(const size_type pos, const GroupType& row_group, const GroupType& col_group) {
+          TaskTraceScope trace("summa", "step");
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
-          printf("step:  start rank=%i k=%lu\n", owner_->world().rank(), k);
+          printf("step:  start rank=%i k=%lu\n", owner_->world().rank(), pos);
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
+#ifdef TILEDARRAY_ENABLE_SUMMA_TIMELINE
+          timeline_begin_ = SummaTimeline::now();
+#endif // TILEDARRAY_ENABLE_SUMMA_TIMELINE
+
+          // The tiles of the steps this task waited for have been contracted
+          if(step_memory_)
+            owner_->depth_controller_.release_step(step_memory_);
 
-          if(k < owner_->k_) {
-            // Initialize next tail task and submit next task
+          if(pos < owner_->k_end_) {
             TA_ASSERT(next_step_task_);
-            next_step_task_->tail_step_task_ =
-                new Derived(static_cast<Derived*>(tail_step_task_), 1);  // <- ndep=1, will control its scheduling by this task
+            TA_ASSERT(tail_step_task_);
+
+            // The inner index of this step
+            const size_type k = owner_->k_at(pos);
+
+            // Record the memory of this step and adjust the pipeline depth
+            const std::size_t step_memory = owner_->step_memory(k, col_, row_);
+            const int adjust = owner_->depth_controller_.update(step_memory);
+            tail_step_task_->step_memory_ += step_memory;
+
+            StepTask* widen_task = nullptr;
+            if(adjust < 0) {
+              // Narrow the pipeline: no new task is added, the current tail
+              // will also wait for the contractions of the next step. The
+              // contractions of this step must be attached to the tail before
+              // the next step can release it.
+              next_step_task_->tail_step_task_ = tail_step_task_;
+              contract(k, tail_step_task_);
+            } else {
+              // Initialize next tail task; when widening, an extra task that
+              // does not wait for any contractions is inserted before it
+              Derived* tail = static_cast<Derived*>(tail_step_task_);
+              if(adjust > 0)
+                widen_task = tail = new Derived(tail, 1);
+              next_step_task_->tail_step_task_ =
+                  new Derived(tail, 1);  // <- ndep=1, will control its scheduling by this task
+            }
+
             // submit next step task ... even if it's same as tail_step_task_ it is safe to submit
             // because its ndep > 0 (see StepTask::make_next_step_tasks)
             TA_ASSERT(tail_step_task_->ndep() > 0);
             world_.taskq.add(next_step_task_);
             next_step_task_ = nullptr;
 
-            // Start broadcast of column and row tiles for this step
-            world_.taskq.add(owner_, & Summa_::bcast_col, k, col_, row_group,
-                             madness::TaskAttributes::hipri());
-            world_.taskq.add(owner_, & Summa_::bcast_row, k, row_, col_group,
-                             madness::TaskAttributes::hipri());
+            // Start broadcast of column and row tiles for this step, unless
+            // they were prefetched
+            if(! prefetched_) {
+              world_.taskq.add(owner_, & Summa_::bcast_col, k, col_, row_group,
+                               task_attributes(TaskClass::broadcast));
+              world_.taskq.add(owner_, & Summa_::bcast_row, k, row_, col_group,
+                               task_attributes(TaskClass::broadcast));
+            }
 
-            // Submit tasks for the contraction of col and row tiles.
-            owner_->contract(k, col_, row_, tail_step_task_);
+            // Count the received tiles that have already arrived
+            owner_->record_overlap(k, col_, row_);
+#ifdef TILEDARRAY_ENABLE_SUMMA_TIMELINE
+            owner_->spawn_bcast_timeline(k, timeline_begin_, col_, row_);
+#endif // TILEDARRAY_ENABLE_SUMMA_TIMELINE
 
-            // Notify task dependencies
-            TA_ASSERT(tail_step_task_);
-            if (trace_tasks)
-              tail_step_task_->notify_debug("StepTask nth ctor");
-            else
-              tail_step_task_->notify();
+            if(adjust >= 0) {
+              // Submit tasks for the contraction of col and row tiles.
+              contract(k, tail_step_task_);
+
+              // Notify task dependencies
+              if (trace_tasks)
+                tail_step_task_->notify_debug("StepTask nth ctor");
+              else
+                tail_step_task_->notify();
+              if(widen_task) {
+                if (trace_tasks)
+                  widen_task->notify_debug("StepTask nth ctor");
+                else
+                  widen_task->notify();
+              }
+            }
             finalize_task_->notify();
 
           } else if(finalize_task_) {
@@ -1343,8 +3092,13 @@ namespace TiledArray {
               tail_step_task_->notify();
           }
 
+#ifdef TILEDARRAY_ENABLE_SUMMA_TIMELINE
+          if(pos < owner_->k_end_)
+            owner_->record_timeline("step", owner_->k_at(pos), timeline_begin_);
+#endif // TILEDARRAY_ENABLE_SUMMA_TIMELINE
+
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
-          printf("step: finish rank=%i k=%lu\n", owner_->world().rank(), k);
+          printf("step: finish rank=%i k=%lu\n", owner_->world().rank(), pos);
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
         }
 
@@ -1355,20 +3109,31 @@ namespace TiledArray {
         const size_type k_;
         using StepTask::owner_;
 
+      private:
+
+        /// Spawn tasks to get, and possibly prefetch, the k-th row and column tiles
+        void spawn_tasks() {
+          if(owner_->prefetch_)
+            StepTask::spawn_prefetch_row_col_tasks(k_, owner_->row_group_,
+                owner_->col_group_);
+          else
+            StepTask::spawn_get_row_col_tasks(k_);
+        }
+
       public:
         DenseStepTask(const std::shared_ptr<Summa_>& owner, const size_type depth) :
-          StepTask(owner, owner->k_ + 1ul), k_(0)
+          StepTask(owner, owner->k_end_ - owner->k_begin_ + 1ul), k_(owner->k_begin_)
         {
           StepTask::make_next_step_tasks(this, depth);
-          StepTask::spawn_get_row_col_tasks(k_);
+          spawn_tasks();
         }
 
         DenseStepTask(DenseStepTask* const parent, const int ndep) :
           StepTask(parent, ndep), k_(parent->k_ + 1ul)
         {
           // Spawn tasks to get k-th row and column tiles
-          if(k_ < owner_->k_)
-            StepTask::spawn_get_row_col_tasks(k_);
+          if(k_ < owner_->k_end_)
+            spawn_tasks();
         }
 
         virtual ~DenseStepTask() { }
@@ -1380,7 +3145,7 @@ namespace TiledArray {
 
       class SparseStepTask : public StepTask {
       protected:
-        Future<size_type> k_{};
+        Future<size_type> k_{}; ///< The iteration position (see \c Summa::k_at() )
         Future<madness::Group> row_group_{};
         Future<madness::Group> col_group_{};
         using StepTask::owner_;
@@ -1391,23 +3156,40 @@ namespace TiledArray {
       private:
 
         /// Spawn task to construct process groups and get tiles.
-        void iterate_task(size_type k, const size_type offset) {
+
+        /// \param pos The position of the previous iteration
+        /// \param offset The offset from \c pos to the first iteration to check
+        void iterate_task(size_type pos, const size_type offset) {
           // Search for the next non-zero row and column
-          k = owner_->iterate_sparse(k + offset);
-          k_.set(k);
+          pos = owner_->iterate_sparse(pos + offset);
+          k_.set(pos);
+
+          if(pos < owner_->k_end_) {
+            const size_type k = owner_->k_at(pos);
 
-          if(k < owner_->k_) {
             // NOTE: The order of task submissions is dependent on the order in
             // which we want the tasks to complete.
 
-            // Spawn tasks to get k-th row and column tiles
-            StepTask::spawn_get_row_col_tasks(k);
+            if(owner_->prefetch_) {
+              // Spawn tasks to construct the row and column broadcast group,
+              // which are needed to post the broadcasts ahead of this step
+              row_group_ = world_.taskq.add(owner_, & Summa_::make_row_group, k,
+                  task_attributes(TaskClass::broadcast));
+              col_group_ = world_.taskq.add(owner_, & Summa_::make_col_group, k,
+                  task_attributes(TaskClass::broadcast));
 
-            // Spawn tasks to construct the row and column broadcast group
-            row_group_ = world_.taskq.add(owner_, & Summa_::make_row_group, k,
-                madness::TaskAttributes::hipri());
-            col_group_ = world_.taskq.add(owner_, & Summa_::make_col_group, k,
-                madness::TaskAttributes::hipri());
+              // Spawn tasks to get and broadcast k-th row and column tiles
+              StepTask::spawn_prefetch_row_col_tasks(k, row_group_, col_group_);
+            } else {
+              // Spawn tasks to get k-th row and column tiles
+              StepTask::spawn_get_row_col_tasks(k);
+
+              // Spawn tasks to construct the row and column broadcast group
+              row_group_ = world_.taskq.add(owner_, & Summa_::make_row_group, k,
+                  task_attributes(TaskClass::broadcast));
+              col_group_ = world_.taskq.add(owner_, & Summa_::make_col_group, k,
+                  task_attributes(TaskClass::broadcast));
+            }
 
             // Increment the finalize task dependency counter, which indicates
             // that this task is not the terminating step task.
@@ -1434,13 +3216,13 @@ namespace TiledArray {
           else
             madness::DependencyInterface::inc();
           world_.taskq.add(this, & SparseStepTask::iterate_task,
-              0ul, 0ul, madness::TaskAttributes::hipri());
+              owner->k_begin_, 0ul, task_attributes(TaskClass::step));
         }
 
         SparseStepTask(SparseStepTask* const parent, const int ndep) :
           StepTask(parent, ndep)
         {
-          if(parent->k_.probe() && (parent->k_.get() >= owner_->k_)) {
+          if(parent->k_.probe() && (parent->k_.get() >= owner_->k_end_)) {
             // Avoid running extra tasks if not needed.
             k_.set(parent->k_.get());
             TA_ASSERT(ndep == 1);  // ensure that this does not get executed immediately
@@ -1451,7 +3233,7 @@ namespace TiledArray {
             else
               madness::DependencyInterface::inc();
             world_.taskq.add(this, & SparseStepTask::iterate_task,
-                parent->k_, 1ul, madness::TaskAttributes::hipri());
+                parent->k_, 1ul, task_attributes(TaskClass::step));
           }
         }
 
@@ -1476,29 +3258,129 @@ namespace TiledArray {
       /// \param op The tile transform operation
       /// \param k The number of tiles in the inner dimension
       /// \param proc_grid The process grid that defines the layout of the tiles
-      ///                  during the contraction evaluation
+      ///                  during the contraction evaluation; if it has more than
+      ///                  one layer the inner dimension is partitioned among
+      ///                  the layers
+      /// \param options The memory and depth limits of the pipeline, and the
+      ///                  optional pipeline features, see \c SummaOptions ; the
+      ///                  tile pairs of each local row of a step are always
+      ///                  contracted in a single task when \c batched_gemm is
+      ///                  \c true [ default = process-wide settings ]
+      /// \param symmetry The permutational symmetry of the result; only the
+      ///                  representative result tiles are computed and set,
+      ///                  except for replicated results
+      ///                  [ default = null, all non-zero tiles are computed ]
       /// \note The trange, shape, and pmap refer to the final,
       ///       permuted, state for the result, NOT to the result during
       ///       the SUMMA evaluation.
       Summa(const left_type& left, const right_type& right,
           World& world, const trange_type trange, const shape_type& shape,
           const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm,
-          const op_type& op, const size_type k, const ProcGrid& proc_grid) :
+          const op_type& op, const size_type k, const ProcGrid& proc_grid,
+          const SummaOptions& options = SummaOptions(),
+          const std::shared_ptr<const symmetry::TileSymmetry>& symmetry = nullptr) :
         DistEvalImpl_(world, trange, shape, pmap, perm),
         left_(left), right_(right), op_(op),
-        row_group_(), col_group_(),
+        row_group_(), col_group_(), group_cache_(),
         k_(k), proc_grid_(proc_grid),
-        reduce_tasks_(NULL),
+        k_begin_(proc_grid.layers() > 1ul ? proc_grid.layer_begin(k) : 0ul),
+        k_end_(proc_grid.layers() > 1ul ? proc_grid.layer_end(k) : k),
+        work_order_(options.work_order), k_order_(), local_nonzero_k_(0ul),
+        left_dense_(left.shape().is_dense() || (left.shape().sparsity() == 0.0f)),
+        right_dense_(right.shape().is_dense() || (right.shape().sparsity() == 0.0f)),
+        mem_limit_(options.max_memory ? options.max_memory : max_memory_),
+        depth_limit_(options.max_depth ? options.max_depth : max_depth_),
+        depth_controller_(),
+        reduce_tasks_(NULL), result_seed_(),
+        batch_(options.batch || batched_gemm), batch_results_(), batch_added_(), batch_rows_(),
+        batch_lock_(),
+        replicated_(pmap->is_replicated() && (world.size() > 1)),
+        replicated_offsets_(), replicated_buffer_(), replicated_pending_(),
+        replicated_local_(),
+        symmetry_(replicated_ ? nullptr : symmetry),
+        prefetch_(options.prefetch), node_bcast_(options.node_bcast),
+        node_map_(), node_bcasts_(), node_bcast_lock_(),
         left_start_local_(proc_grid_.rank_row() * k),
         left_end_(left.size()),
         left_stride_(k),
         left_stride_local_(proc_grid.proc_rows() * k),
         right_stride_(1ul),
         right_stride_local_(proc_grid.proc_cols())
-      { }
+      {
+        replicated_pending_ = 0;
+      }
 
       virtual ~Summa() { }
 
+      /// Set the initial values of the result tiles
+
+      /// The contractions of each result tile are accumulated into the
+      /// initial value given by \c seed , so the result is the sum of the
+      /// initial values and the contraction, e.g. <tt>c += a * b</tt> . The
+      /// shape of this object must include the non-zero initial values.
+      /// \c seed(i, tile) returns \c false if the initial value of tile
+      /// \c i is zero, otherwise it sets \c tile to a future to a tile that
+      /// is not shared with other objects, which is modified by the
+      /// contraction. This function must be called before the evaluation.
+      /// \param seed The initial value function
+      /// \note Initial values are not supported for permuted results or
+      /// batched contractions.
+      void seed_result(const result_seed_type& seed) {
+        TA_ASSERT(! batch_);
+        result_seed_ = seed;
+      }
+
+      /// Memory limit accessor
+
+      /// \return The maximum memory, in bytes, that may be used by SUMMA on
+      /// each node (set with \c TA_SUMMA_MAX_MEMORY ), or zero if unbounded
+      static size_type max_memory() { return max_memory_; }
+
+      /// Depth limit accessor
+
+      /// \return The maximum number of concurrent SUMMA iterations (set with
+      /// \c TA_SUMMA_MAX_DEPTH ), or zero if unbounded
+      static size_type max_depth() { return max_depth_; }
+
+      /// Pipeline depth before the memory bound is applied
+
+      /// The optimal depth is equal to the smallest dimension of the process
+      /// grid, but no less than 2. For sparse contractions it is increased
+      /// with the sparsity of the arguments, since each iteration holds fewer
+      /// tiles.
+      /// \param proc_grid The process grid of the contraction
+      /// \param k_size The number of inner tiles of a layer
+      /// \param dense \c true if the result is dense
+      /// \param left_sparsity The fraction of zero tiles in the left-hand matrix
+      /// \param right_sparsity The fraction of zero tiles in the right-hand matrix
+      /// \param depth_limit The user defined depth bound, or zero if unbounded
+      /// \return The number of concurrent SUMMA iterations
+      static size_type initial_depth(const ProcGrid& proc_grid,
+          const size_type k_size, const bool dense, const float left_sparsity,
+          const float right_sparsity, const size_type depth_limit)
+      {
+        size_type depth = std::max(ProcGrid::size_type(2),
+            std::min(proc_grid.proc_rows(), proc_grid.proc_cols()));
+
+        if(! dense) {
+          // Compute the fraction of non-zero result tiles in a single SUMMA iteration.
+          const float frac_non_zero = (1.0f - std::min(left_sparsity, 0.9f))
+                                    * (1.0f - std::min(right_sparsity, 0.9f));
+
+          // Compute the new depth based on sparsity of the arguments
+          depth = float(depth) * (1.0f - 1.35638f * std::log2(frac_non_zero)) + 0.5f;
+        }
+
+        // We cannot have more iterations than there are blocks in the k
+        // dimension of this layer
+        if(depth > k_size) depth = k_size;
+
+        // Enforce user defined depth bound
+        if(depth_limit) depth = std::min(depth, depth_limit);
+
+        return depth;
+      }
+
       /// Get tile at index \c i
 
       /// \param i The index of the tile
@@ -1517,8 +3399,10 @@ namespace TiledArray {
         // Compute process coordinate of tile in the process grid
         const size_type proc_row = tile_row % proc_grid_.proc_rows();
         const size_type proc_col = tile_col % proc_grid_.proc_cols();
-        // Compute the process that owns tile
-        const ProcessID source = proc_row * proc_grid_.proc_cols() + proc_col;
+        // Compute the process that owns tile; every process sets the tiles
+        // of a replicated result
+        const ProcessID source = (replicated_ ? TensorImpl_::world().rank() :
+            ProcessID(proc_row * proc_grid_.proc_cols() + proc_col));
 
         const madness::DistributedID key(DistEvalImpl_::id(), i);
         return TensorImpl_::world().gop.template recv<value_type>(source, key);
@@ -1545,7 +3429,7 @@ namespace TiledArray {
       size_type mem_bound_depth(size_type depth, const float left_sparsity, const float right_sparsity) {
 
         // Check if a memory bound has been set
-        const size_type available_memory = max_memory_;
+        const size_type available_memory = mem_limit_;
         if(available_memory) {
 
           // Compute the average memory requirement per iteration of this process
@@ -1560,8 +3444,8 @@ namespace TiledArray {
 
           // Compute the maximum number of iterations based on available memory
           const size_type mem_bound_depth =
-              ((local_memory_per_iter_left + local_memory_per_iter_right) /
-              available_memory);
+              (available_memory / std::max<std::size_t>(1ul,
+              local_memory_per_iter_left + local_memory_per_iter_right));
 
           // Check if the memory bounded depth is less than the optimal depth
           if(depth > mem_bound_depth) {
@@ -1605,62 +3489,94 @@ namespace TiledArray {
         printf("eval: finished eval children rank=%i\n", TensorImpl_::world().rank());
 #endif // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
 
+        // Construct the node map for two-level broadcasts; this is collective
+        // the first time it is used with this world.
+        if(node_bcast_ && TensorImpl_::world().size() > 1)
+          node_map_ = NodeMap::instance(TensorImpl_::world());
+
+        // Find the cached broadcast groups of a sparse contraction; this is
+        // done by all processes, including those that do not hold tiles, so
+        // the cache contents stay the same on every process.
+        if(! TensorImpl_::shape().is_dense())
+          group_cache_ = SummaGroupCache::find(make_group_cache_key(),
+              DistEvalImpl_::id(), k_);
+
+        // The tiles of a replicated result are set when the all-reduce is
+        // complete, so the all-reduce is started before the local tasks
+        const size_type replicated_count = (replicated_ ? init_replicated() : 0ul);
+
         size_type tile_count = 0ul;
         if(proc_grid_.local_size() > 0ul) {
           tile_count = initialize();
 
+          // Add the initial values of the result tiles
+          if(result_seed_ && (proc_grid_.rank_layer() == 0ul))
+            seed_reduce_tasks(TensorImpl_::shape());
+
+          // Initialize the result tiles of batch tasks
+          if(batch_) {
+            batch_results_.resize(proc_grid_.local_size());
+            batch_added_.assign(proc_grid_.local_size(), 0);
+            batch_rows_.assign(proc_grid_.local_rows(), Future<bool>(true));
+          }
+
           // depth controls the number of simultaneous SUMMA iterations
           // that are scheduled.
 
-          // The optimal depth is equal to the smallest dimension of the process
-          // grid, but no less than 2
-          size_type depth =
-              std::max(ProcGrid::size_type(2), std::min(proc_grid_.proc_rows(), proc_grid_.proc_cols()));
-
           // Construct the first SUMMA iteration task
           if(TensorImpl_::shape().is_dense()) {
-            // We cannot have more iterations than there are blocks in the k
-            // dimension
-            if(depth > k_) depth = k_;
+            const size_type max_depth = initial_depth(proc_grid_,
+                k_end_ - k_begin_, true, 0.0f, 0.0f, depth_limit_);
+            size_type depth = max_depth;
 
             // Modify the number of concurrent iterations based on the available
             // memory.
             depth = mem_bound_depth(depth, 0.0f, 0.0f);
 
-            // Enforce user defined depth bound
-            if(max_depth_) std::min(depth, max_depth_);
+            // The memory-bound depth is the starting point for the depth
+            // controller, which may widen the pipeline to max_depth when the
+            // memory actually used allows it.
+            depth_controller_.init(mem_limit_, depth, max_depth);
 
             TensorImpl_::world().taskq.add(new DenseStepTask(shared_from_this(),
                                                              depth));
           } else {
-            // Increase the depth based on the amount of sparsity in an iteration.
-
             // Get the sparsity fractions for the left- and right-hand arguments.
             const float left_sparsity = left_.shape().sparsity();
             const float right_sparsity = right_.shape().sparsity();
 
-            // Compute the fraction of non-zero result tiles in a single SUMMA iteration.
-            const float frac_non_zero = (1.0f - std::min(left_sparsity, 0.9f))
-                                      * (1.0f - std::min(right_sparsity, 0.9f));
-
-            // Compute the new depth based on sparsity of the arguments
-            depth = float(depth) * (1.0f - 1.35638f * std::log2(frac_non_zero)) + 0.5f;
-
-            // We cannot have more iterations than there are blocks in the k
-            // dimension
-            if(depth > k_) depth = k_;
+            const size_type max_depth = initial_depth(proc_grid_,
+                k_end_ - k_begin_, false, left_sparsity, right_sparsity,
+                depth_limit_);
+            size_type depth = max_depth;
 
             // Modify the number of concurrent iterations based on the available
             // memory and sparsity of the argument tensors.
             depth = mem_bound_depth(depth, left_sparsity, right_sparsity);
 
-            // Enforce user defined depth bound
-            if(max_depth_) std::min(depth, max_depth_);
+            // The memory-bound depth is the starting point for the depth
+            // controller, which adjusts it using the memory actually held by
+            // in-flight tiles.
+            depth_controller_.init(mem_limit_, depth, max_depth);
+
+            // Find the iterations with local work
+            if(! (left_.shape().is_dense() && right_.shape().is_dense()))
+              make_local_nonzero_k();
+
+            // Visit the heaviest iterations first
+            if(work_order_)
+              make_work_order();
 
             TensorImpl_::world().taskq.add(new SparseStepTask(shared_from_this(),
                                                               depth));
           }
+
+          // Only layer 0 sets result tiles
+          if(proc_grid_.rank_layer() != 0)
+            tile_count = 0ul;
         }
+        if(replicated_)
+          tile_count = replicated_count;
 
 #ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
         printf("eval: start wait children rank=%i\n", TensorImpl_::world().rank());
@@ -1691,6 +3607,9 @@ namespace TiledArray {
     typename Summa<Left, Right, Op, Policy>::size_type
     Summa<Left, Right, Op, Policy>::max_memory_ =
         Summa<Left, Right, Op, Policy>::init_max_memory();
+
+    template <typename Left, typename Right, typename Op, typename Policy>
+    constexpr bool Summa<Left, Right, Op, Policy>::batched_gemm;
   } // namespace detail
 }  // namespace TiledArray
 
@@ -0,0 +1,261 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_DIAGONAL_CONTRACTION_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_DIAGONAL_CONTRACTION_EVAL_H__INCLUDED
+
+#include <TiledArray/dist_eval/dist_eval.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Contraction of a matrix with a diagonal matrix
+
+    /// The product of a diagonal matrix \c D with a matrix \c A , i.e.
+    /// <tt>D * A</tt> or <tt>A * D</tt> , scales the rows or columns of the
+    /// tiles of \c A by the diagonal of \c D . Each result tile is evaluated
+    /// by the process that owns the tile of \c A , from that tile and the
+    /// diagonal tile of \c D in the same tile row (or column); the tiles of
+    /// \c A are not moved, and only the diagonal tiles of \c D are fetched
+    /// (through the remote tile cache of \c D ), instead of broadcasting
+    /// both arguments as in SUMMA. When \c D is a Kronecker delta matrix,
+    /// i.e. an array of <tt>KroneckerDeltaTile<1></tt> , the contraction only
+    /// relabels the indices of \c A : its tiles are neither fetched nor
+    /// instantiated, and the tiles of \c A are only scaled by the factor
+    /// (if it is not 1) and permuted.
+    /// \tparam Arg The distributed evaluator type of \c A
+    /// \tparam Diag The array type of \c D , with \c Tensor or Kronecker
+    /// delta tiles
+    /// \tparam Result The result tile type, a \c Tensor
+    /// \tparam Scalar The scaling factor type
+    /// \tparam Policy The evaluator policy type
+    template <typename Arg, typename Diag, typename Result, typename Scalar,
+        typename Policy>
+    class DiagonalContractionEvalImpl :
+        public DistEvalImpl<Result, Policy>,
+        public std::enable_shared_from_this<
+            DiagonalContractionEvalImpl<Arg, Diag, Result, Scalar, Policy> >
+    {
+    public:
+      typedef DiagonalContractionEvalImpl<Arg, Diag, Result, Scalar, Policy>
+          DiagonalContractionEvalImpl_; ///< This object type
+      typedef DistEvalImpl<Result, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Arg arg_type; ///< The argument tensor type
+      typedef Diag diag_type; ///< The diagonal array type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::range_type range_type; ///< Range type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+
+      /// Constructor
+
+      /// \param arg The matrix argument
+      /// \param diag The diagonal matrix, with the same tiling of the rows
+      /// and columns
+      /// \param left_diagonal \c true for <tt>D * A</tt> , \c false for
+      /// <tt>A * D</tt>
+      /// \param factor The scaling factor
+      /// \param world The world where the tensor lives
+      /// \param trange The tiled range object
+      /// \param shape The tensor shape object
+      /// \param pmap The tile-process map
+      /// \param perm The permutation that is applied to the result
+      DiagonalContractionEvalImpl(const arg_type& arg, const diag_type& diag,
+          const bool left_diagonal, const Scalar factor, World& world,
+          const trange_type& trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm) :
+        DistEvalImpl_(world, trange, shape, pmap, perm),
+        arg_(arg), diag_(diag), left_diagonal_(left_diagonal), factor_(factor),
+        perm_(perm)
+      { }
+
+      /// Virtual destructor
+      virtual ~DiagonalContractionEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+        const size_type source = arg_.owner(DistEvalImpl_::perm_index_to_source(i));
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::world().gop.template recv<value_type>(source, key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      typedef typename eval_trait<typename arg_type::value_type>::type
+          arg_eval_type; ///< The evaluated argument tile type
+      typedef typename is_kronecker_delta<typename diag_type::value_type>::type
+          is_delta; ///< \c std::true_type if \c D is a Kronecker delta matrix
+
+      /// Scale the rows or columns of a tile
+
+      /// \param tile The argument tile
+      /// \param diag The diagonal tile of \c D
+      /// \return The scaled (and permuted) tile
+      value_type scale_tile(const arg_eval_type& tile,
+          const typename diag_type::value_type& diag) const
+      {
+        const size_type m = tile.range().extent(0);
+        const size_type n = tile.range().extent(1);
+        const size_type stride = diag.range().extent(1) + 1ul;
+        value_type result(tile.range());
+        for(size_type i = 0ul; i < m; ++i) {
+          for(size_type j = 0ul; j < n; ++j) {
+            const auto d = diag.data()[(left_diagonal_ ? i : j) * stride];
+            result.data()[i * n + j] = factor_ * d * tile.data()[i * n + j];
+          }
+        }
+        return (perm_ ? result.permute(perm_) : result);
+      }
+
+      /// Relabel a tile
+
+      /// \param tile The argument tile
+      /// \return The scaled (and permuted) tile
+      value_type relabel_tile(const arg_eval_type& tile) const {
+        if(factor_ == Scalar(1))
+          return (perm_ ? value_type(tile.permute(perm_)) : value_type(tile));
+        return (perm_ ? value_type(tile.scale(factor_, perm_)) :
+            value_type(tile.scale(factor_)));
+      }
+
+      /// Task function for evaluating tiles with a Kronecker delta matrix
+
+      /// \param i The result tile index
+      /// \param tile The argument tile
+      void eval_delta_tile(const size_type i,
+          const typename arg_type::value_type& tile)
+      {
+        const arg_eval_type eval_tile = tile;
+        DistEvalImpl_::set_tile(i, relabel_tile(eval_tile));
+      }
+
+      /// Spawn the evaluation of a tile with a Kronecker delta matrix
+
+      /// The tile of \c D is not needed.
+      /// \param self This object
+      /// \param target_index The result tile index
+      /// \param index The argument tile index
+      void spawn_eval_tile(const std::shared_ptr<DiagonalContractionEvalImpl_>& self,
+          const size_type target_index, const size_type index, size_type,
+          std::true_type)
+      {
+        TensorImpl_::world().taskq.add(self,
+            & DiagonalContractionEvalImpl_::eval_delta_tile, target_index,
+            arg_.get(index));
+      }
+
+      /// Spawn the evaluation of a tile with a diagonal matrix
+
+      /// \param self This object
+      /// \param target_index The result tile index
+      /// \param index The argument tile index
+      /// \param diag_index The index of the diagonal tile of \c D
+      void spawn_eval_tile(const std::shared_ptr<DiagonalContractionEvalImpl_>& self,
+          const size_type target_index, const size_type index,
+          const size_type diag_index, std::false_type)
+      {
+        TensorImpl_::world().taskq.add(self,
+            & DiagonalContractionEvalImpl_::eval_tile, target_index,
+            arg_.get(index), diag_.find(diag_index));
+      }
+
+      /// Task function for evaluating tiles
+
+      /// \param i The result tile index
+      /// \param tile The argument tile
+      /// \param diag The diagonal tile of \c D
+      void eval_tile(const size_type i, const typename arg_type::value_type& tile,
+          const typename diag_type::value_type& diag)
+      {
+        const arg_eval_type eval_tile = tile;
+        DistEvalImpl_::set_tile(i, scale_tile(eval_tile, diag));
+      }
+
+      /// Evaluate the tiles of this tensor
+
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        std::shared_ptr<DiagonalContractionEvalImpl_> self =
+            std::enable_shared_from_this<DiagonalContractionEvalImpl_>::shared_from_this();
+
+        arg_.eval();
+
+        // The number of tile columns of the argument
+        const size_type cols = arg_.trange().tiles_range().extent(1);
+        const size_type diag_cols = diag_.trange().tiles_range().extent(1);
+
+        size_type task_count = 0ul;
+        const typename pmap_interface::const_iterator end = arg_.pmap()->end();
+        typename pmap_interface::const_iterator it = arg_.pmap()->begin();
+        for(; it != end; ++it) {
+          const size_type index = *it;
+          if(arg_.is_zero(index))
+            continue;
+
+          const size_type target_index = DistEvalImpl_::perm_index_to_target(index);
+          if(TensorImpl_::is_zero(target_index)) {
+            arg_.discard(index);
+            continue;
+          }
+
+          const size_type k = (left_diagonal_ ? index / cols : index % cols);
+          const size_type diag_index = k * diag_cols + k;
+          if(diag_.is_zero(diag_index)) {
+            // The result shape may be non-zero within its threshold
+            arg_.discard(index);
+            const range_type range = arg_.trange().make_tile_range(index);
+            DistEvalImpl_::set_tile(target_index, (perm_ ?
+                value_type(perm_ * range, typename value_type::value_type(0)) :
+                value_type(range, typename value_type::value_type(0))));
+          } else {
+            spawn_eval_tile(self, target_index, index, diag_index, is_delta());
+          }
+
+          ++task_count;
+        }
+
+        arg_.wait();
+
+        return task_count;
+      }
+
+      arg_type arg_; ///< The matrix argument
+      diag_type diag_; ///< The diagonal matrix
+      const bool left_diagonal_; ///< The diagonal matrix is the left-hand argument
+      const Scalar factor_; ///< The scaling factor
+      const Permutation perm_; ///< The permutation of the result tiles
+    }; // class DiagonalContractionEvalImpl
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_DIAGONAL_CONTRACTION_EVAL_H__INCLUDED
@@ -20,14 +20,93 @@
 #ifndef TILEDARRAY_DIST_EVAL_DIST_EVAL_BASE_H__INCLUDED
 #define TILEDARRAY_DIST_EVAL_DIST_EVAL_BASE_H__INCLUDED
 
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <string>
 #include <TiledArray/tensor_impl.h>
 #include <TiledArray/permutation.h>
 #include <TiledArray/perm_index.h>
+#include <TiledArray/task_priority.h>
+#include <TiledArray/task_trace.h>
+#include <TiledArray/tile_timing.h>
 #include <TiledArray/type_traits.h>
 
 namespace TiledArray {
   namespace detail {
 
+    /// Parse the minimum size of the tile tasks of element-wise evaluators
+
+    /// \param value The value of the \c TA_TILE_TASK_MIN_ELEMENTS
+    /// environment variable, or a null pointer if it is not set
+    /// \return The positive number of elements in \c value , or the default
+    /// of 16384 if \c value is not set, is not a number, or is zero
+    inline std::size_t parse_tile_task_min_elements(const char* value) {
+      const std::size_t default_value = 16384ul;
+      if(! value || ! std::isdigit(static_cast<unsigned char>(*value)))
+        return default_value;
+      errno = 0;
+      char* end = nullptr;
+      const unsigned long result = std::strtoul(value, &end, 10);
+      if((errno != 0) || (*end != '\0') || (result == 0ul))
+        return default_value;
+      return result;
+    }
+
+    /// Minimum size of the tile tasks of element-wise evaluators
+
+    /// \return A reference to the minimum number of elements (see
+    /// \c TileChunker )
+    inline std::size_t& tile_task_min_elements() {
+      static std::size_t min_elements =
+          parse_tile_task_min_elements(getenv("TA_TILE_TASK_MIN_ELEMENTS"));
+      return min_elements;
+    }
+
+    /// Groups the local tiles of an element-wise evaluator into tasks
+
+    /// Element-wise evaluators spawn one task per tile, so many small tiles
+    /// are dominated by the task overhead. Consecutive tiles are added to a
+    /// chunk until it holds \c tile_task_min_elements() elements, which may
+    /// be changed with the \c TA_TILE_TASK_MIN_ELEMENTS environment
+    /// variable, so a large tile is still evaluated by its own task. A
+    /// chunk is also limited to the number of tiles that gives about 8
+    /// tasks per thread, which keeps the threads busy. Each tile of a chunk
+    /// is still set individually.
+    class TileChunker {
+      std::size_t max_tiles_; ///< The maximum number of tiles in a chunk
+      std::size_t tiles_; ///< The number of tiles in the current chunk
+      std::size_t elements_; ///< The number of elements in the current chunk
+
+    public:
+
+      /// Constructor
+
+      /// \param local_size The number of local tiles
+      explicit TileChunker(const std::size_t local_size) :
+        max_tiles_(std::max<std::size_t>(1ul, local_size /
+            (8ul * (madness::ThreadPool::size() + 1ul)))),
+        tiles_(0ul), elements_(0ul)
+      { }
+
+      /// Add a tile to the current chunk
+
+      /// \param volume The number of elements of the tile
+      /// \return \c true if the chunk is complete, in which case the next
+      /// tile starts a new chunk
+      bool add(const std::size_t volume) {
+        ++tiles_;
+        elements_ += volume;
+        if((tiles_ < max_tiles_) && (elements_ < tile_task_min_elements()))
+          return false;
+        tiles_ = 0ul;
+        elements_ = 0ul;
+        return true;
+      }
+
+    }; // class TileChunker
+
     /// Distributed evaluator implementation object
 
     /// This class is used as the base class for other distributed evaluation
@@ -202,6 +281,15 @@ namespace TiledArray {
         }
       }
 
+      /// Test that all tiles are assigned
+
+      /// \return \c true if this object was evaluated and all tiles of the
+      /// local tasks are assigned, otherwise \c false
+      bool probe() const {
+        const int task_count = task_count_;
+        return (task_count >= 0) && (set_counter_ == task_count);
+      }
+
     private:
 
       /// Evaluate the tiles of this tensor
@@ -338,6 +426,15 @@ namespace TiledArray {
       /// \return The tiled range of the tensor
       const trange_type& trange() const { return pimpl_->trange(); }
 
+      /// Release the implementation object
+
+      /// A consumer releases its argument when it has taken all the tiles
+      /// that it needs and the argument is evaluated, so the argument, and
+      /// the evaluators below it, are freed when their pending tasks are
+      /// done instead of when the whole expression is done. This object may
+      /// not be used after it is released.
+      void release() { pimpl_.reset(); }
+
       /// Tile move
 
       /// Tile is removed after it is set.
@@ -365,6 +462,11 @@ namespace TiledArray {
       /// Wait for all local tiles to be evaluated
       void wait() const { pimpl_->wait(); }
 
+      /// Test that all local tiles are evaluated
+
+      /// \return \c true if all local tiles are evaluated
+      bool probe() const { return pimpl_->probe(); }
+
     }; // class DistEval
 
   }  // namespace detail
@@ -0,0 +1,325 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_FUSED_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_FUSED_EVAL_H__INCLUDED
+
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/math/simd.h>
+#include <TiledArray/tile_interface/cast.h>
+#include <tuple>
+#include <utility>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// The maximum number of arguments of a fused element-wise evaluator
+
+    /// The arguments of each tile are passed to a single task, together with
+    /// the tile index and the zero-argument mask.
+    constexpr std::size_t fused_eval_max_args = 7ul;
+
+    /// Fused kernel argument
+
+    /// Reads element \c i of argument \c I . When \c Checked is \c true , a
+    /// zero (null) argument yields zero.
+    /// \tparam I The argument position
+    template <std::size_t I>
+    struct FusedArg {
+      template <bool Checked, typename Ptrs,
+          typename std::enable_if<! Checked>::type* = nullptr>
+      auto eval(const Ptrs& ptrs, const std::size_t i) const {
+        return std::get<I>(ptrs)[i];
+      }
+
+      template <bool Checked, typename Ptrs,
+          typename std::enable_if<Checked>::type* = nullptr>
+      auto eval(const Ptrs& ptrs, const std::size_t i) const {
+        typedef typename std::decay<decltype(std::get<I>(ptrs)[i])>::type value_type;
+        return (std::get<I>(ptrs) ? std::get<I>(ptrs)[i] : value_type(0));
+      }
+    }; // struct FusedArg
+
+    /// Fused kernel sum, <tt>left + right</tt>
+    template <typename Left, typename Right>
+    struct FusedPlus {
+      Left left; ///< Left-hand kernel
+      Right right; ///< Right-hand kernel
+
+      template <bool Checked, typename Ptrs>
+      auto eval(const Ptrs& ptrs, const std::size_t i) const {
+        return left.template eval<Checked>(ptrs, i) +
+            right.template eval<Checked>(ptrs, i);
+      }
+    }; // struct FusedPlus
+
+    /// Fused kernel difference, <tt>left - right</tt>
+    template <typename Left, typename Right>
+    struct FusedMinus {
+      Left left; ///< Left-hand kernel
+      Right right; ///< Right-hand kernel
+
+      template <bool Checked, typename Ptrs>
+      auto eval(const Ptrs& ptrs, const std::size_t i) const {
+        return left.template eval<Checked>(ptrs, i) -
+            right.template eval<Checked>(ptrs, i);
+      }
+    }; // struct FusedMinus
+
+    /// Fused kernel scaling, <tt>arg * factor</tt>
+    template <typename Arg, typename Scalar>
+    struct FusedScal {
+      Arg arg; ///< Argument kernel
+      Scalar factor; ///< Scaling factor
+
+      template <bool Checked, typename Ptrs>
+      auto eval(const Ptrs& ptrs, const std::size_t i) const {
+        return arg.template eval<Checked>(ptrs, i) * factor;
+      }
+    }; // struct FusedScal
+
+    template <typename Left, typename Right>
+    inline FusedPlus<Left, Right> make_fused_plus(const Left& left, const Right& right) {
+      return FusedPlus<Left, Right>{ left, right };
+    }
+
+    template <typename Left, typename Right>
+    inline FusedMinus<Left, Right> make_fused_minus(const Left& left, const Right& right) {
+      return FusedMinus<Left, Right>{ left, right };
+    }
+
+    template <typename Arg, typename Scalar>
+    inline FusedScal<Arg, Scalar> make_fused_scal(const Arg& arg, const Scalar factor) {
+      return FusedScal<Arg, Scalar>{ arg, factor };
+    }
+
+    /// Fused element-wise, distributed tensor evaluator
+
+    /// This object evaluates a tree of element-wise operations (sums,
+    /// differences, and scaling) with a single task per result tile. Each
+    /// task reads every argument tile once and writes the result tile, which
+    /// is the only allocation, with a single pass of \c Kernel over the
+    /// elements.
+    /// \tparam Kernel The element kernel type
+    /// \tparam Result The result tile type
+    /// \tparam Policy The tensor policy class
+    /// \tparam Args The argument distributed evaluator types
+    template <typename Kernel, typename Result, typename Policy, typename... Args>
+    class FusedEvalImpl :
+      public DistEvalImpl<Result, Policy>,
+      public std::enable_shared_from_this<FusedEvalImpl<Kernel, Result, Policy, Args...> >
+    {
+      static_assert(sizeof...(Args) <= fused_eval_max_args,
+          "Too many arguments for a fused evaluator.");
+    public:
+      typedef FusedEvalImpl<Kernel, Result, Policy, Args...> FusedEvalImpl_; ///< This object type
+      typedef DistEvalImpl<Result, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::range_type range_type; ///< Range type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+      typedef Kernel kernel_type; ///< Element kernel type
+      typedef std::tuple<Args...> args_type; ///< Argument evaluators type
+
+      using std::enable_shared_from_this<FusedEvalImpl_>::shared_from_this;
+
+    private:
+
+      args_type args_; ///< Arguments
+      kernel_type kernel_; ///< Element kernel
+
+      template <typename T>
+      using eval_t = typename eval_trait<typename std::decay<T>::type>::type;
+
+    public:
+
+      /// Construct a fused evaluator
+
+      /// \param args The arguments
+      /// \param world The world where the tensor lives
+      /// \param trange The tiled range object
+      /// \param shape The tensor shape object
+      /// \param pmap The tile-process map
+      /// \param kernel The element kernel
+      FusedEvalImpl(const args_type& args, World& world,
+          const trange_type& trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const kernel_type& kernel) :
+        DistEvalImpl_(world, trange, shape, pmap, Permutation()),
+        args_(args), kernel_(kernel)
+      { }
+
+      virtual ~FusedEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+
+        const ProcessID source = std::get<0>(args_).owner(i); // All arguments
+                                                  // have the same owner
+
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::world().gop.template recv<value_type>(source, key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Evaluate an argument tile, or construct an empty tile for a zero argument
+      template <std::size_t I, typename T>
+      static eval_t<T> eval_arg(const unsigned int zero_mask, const T& tile) {
+        return ((zero_mask & (1u << I)) ? eval_t<T>() : eval_t<T>(invoke_cast(tile)));
+      }
+
+      template <std::size_t... Is, typename... Ts>
+      void eval_tile(std::index_sequence<Is...>, const size_type i,
+          const unsigned int zero_mask, const Ts&... tiles)
+      {
+        const auto eval_tiles = std::make_tuple(eval_arg<Is>(zero_mask, tiles)...);
+        const auto ptrs = std::make_tuple(std::get<Is>(eval_tiles).data()...);
+
+        value_type result(TensorImpl_::trange().make_tile_range(i));
+        auto* MADNESS_RESTRICT const result_data = result.data();
+        const std::size_t n = result.size();
+#ifndef NDEBUG
+        const std::size_t sizes[] = { std::get<Is>(eval_tiles).size()... };
+        for(std::size_t size : sizes)
+          TA_ASSERT((size == 0ul) || (size == n));
+#endif // NDEBUG
+
+        if(zero_mask) {
+          for(std::size_t j = 0ul; j < n; ++j)
+            result_data[j] = kernel_.template eval<true>(ptrs, j);
+        } else {
+          TILEDARRAY_PRAGMA_SIMD
+          for(std::size_t j = 0ul; j < n; ++j)
+            result_data[j] = kernel_.template eval<false>(ptrs, j);
+        }
+
+        DistEvalImpl_::set_tile(i, result);
+      }
+
+      /// Task function for evaluating tiles
+
+      /// \param i The tile index
+      /// \param zero_mask Bit \c k is set when argument \c k is zero
+      /// \param tiles The argument tiles
+      void eval_tile(const size_type i, const unsigned int zero_mask,
+          const typename Args::value_type&... tiles)
+      {
+        eval_tile(std::index_sequence_for<Args...>(), i, zero_mask, tiles...);
+      }
+
+      template <std::size_t... Is>
+      void eval_args(std::index_sequence<Is...>) {
+        const int dummy[] = { (std::get<Is>(args_).eval(), 0)... };
+        (void) dummy;
+      }
+
+      template <std::size_t... Is>
+      void wait_args(std::index_sequence<Is...>) {
+        const int dummy[] = { (std::get<Is>(args_).wait(), 0)... };
+        (void) dummy;
+      }
+
+      template <std::size_t... Is>
+      unsigned int zero_mask(std::index_sequence<Is...>, const size_type index) const {
+        unsigned int mask = 0u;
+        const int dummy[] = { (mask |= (std::get<Is>(args_).is_zero(index) ?
+            (1u << Is) : 0u), 0)... };
+        (void) dummy;
+        return mask;
+      }
+
+      template <std::size_t... Is>
+      void discard_args(std::index_sequence<Is...>, const size_type index) const {
+        const int dummy[] = { ((std::get<Is>(args_).is_zero(index) ?
+            void() : std::get<Is>(args_).discard(index)), 0)... };
+        (void) dummy;
+      }
+
+      template <std::size_t... Is>
+      void add_task(std::index_sequence<Is...>, const std::shared_ptr<FusedEvalImpl_>& self,
+          const size_type index, const unsigned int mask) const
+      {
+        void (FusedEvalImpl_::*task)(const size_type, const unsigned int,
+            const typename Args::value_type&...) = & FusedEvalImpl_::eval_tile;
+        TensorImpl_::world().taskq.add(self, task, index, mask,
+            ((mask & (1u << Is)) ?
+                Future<typename Args::value_type>(typename Args::value_type()) :
+                std::get<Is>(args_).get(index))...,
+            task_attributes(TaskClass::tile));
+      }
+
+      /// Evaluate the tiles of this tensor
+
+      /// This function will evaluate the arguments of this distributed
+      /// evaluator and schedule one task for each non-zero local tile. It will
+      /// block until the tasks for the arguments are evaluated (not for the
+      /// tasks of this object).
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        const auto args = std::index_sequence_for<Args...>();
+
+        // Evaluate child tensors
+        eval_args(args);
+
+        size_type task_count = 0ul;
+
+        std::shared_ptr<FusedEvalImpl_> self = shared_from_this();
+        typename pmap_interface::const_iterator it = std::get<0>(args_).pmap()->begin();
+        const typename pmap_interface::const_iterator end = std::get<0>(args_).pmap()->end();
+        for(; it != end; ++it) {
+          const size_type index = *it;
+
+          if(! TensorImpl_::is_zero(index)) {
+            add_task(args, self, index, zero_mask(args, index));
+            ++task_count;
+          } else {
+            // Cleanup unused tiles
+            discard_args(args, index);
+          }
+        }
+
+        // Wait for child tensors to be evaluated, and process tasks while waiting.
+        wait_args(args);
+
+        return task_count;
+      }
+
+    }; // class FusedEvalImpl
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_FUSED_EVAL_H__INCLUDED
@@ -0,0 +1,377 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_FUSED_REDUCE_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_FUSED_REDUCE_H__INCLUDED
+
+#include <TiledArray/dist_eval/fused_eval.h>
+#include <TiledArray/reduce_task.h>
+#include <TiledArray/tile_op/binary_reduction.h>
+#include <TiledArray/tile_op/unary_reduction.h>
+#include <TiledArray/tensor/complex.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Fused kernel pair, the arguments of a binary reduction
+    template <typename Left, typename Right>
+    struct FusedKernelPair {
+      Left left; ///< Left-hand kernel
+      Right right; ///< Right-hand kernel
+    }; // struct FusedKernelPair
+
+    /// Element-wise form of a tile reduction
+
+    /// The primary template describes reductions that can not be computed
+    /// element by element. Specializations define
+    /// <tt>reduce<Checked>(result, kernel, ptrs, i)</tt> , which reduces
+    /// element \c i of the kernel (or kernel pair) into \c result .
+    /// \tparam Op The tile reduction operation type
+    template <typename Op>
+    struct FusedElementReduction {
+      static constexpr bool value = false;
+    }; // struct FusedElementReduction
+
+    template <typename Tile>
+    struct FusedElementReduction<SumReduction<Tile> > {
+      static constexpr bool value = true;
+
+      template <bool Checked, typename Result, typename Kernel, typename Ptrs>
+      static void reduce(Result& result, const Kernel& kernel, const Ptrs& ptrs,
+          const std::size_t i)
+      {
+        result += kernel.template eval<Checked>(ptrs, i);
+      }
+    }; // struct FusedElementReduction<SumReduction>
+
+    template <typename Tile>
+    struct FusedElementReduction<SquaredNormReduction<Tile> > {
+      static constexpr bool value = true;
+
+      template <bool Checked, typename Result, typename Kernel, typename Ptrs>
+      static void reduce(Result& result, const Kernel& kernel, const Ptrs& ptrs,
+          const std::size_t i)
+      {
+        result += TiledArray::detail::norm(kernel.template eval<Checked>(ptrs, i));
+      }
+    }; // struct FusedElementReduction<SquaredNormReduction>
+
+    template <typename Left, typename Right>
+    struct FusedElementReduction<DotReduction<Left, Right> > {
+      static constexpr bool value = true;
+
+      template <bool Checked, typename Result, typename Kernel, typename Ptrs>
+      static void reduce(Result& result, const Kernel& kernel, const Ptrs& ptrs,
+          const std::size_t i)
+      {
+        result += kernel.left.template eval<Checked>(ptrs, i) *
+            kernel.right.template eval<Checked>(ptrs, i);
+      }
+    }; // struct FusedElementReduction<DotReduction>
+
+    template <typename Left, typename Right>
+    struct FusedElementReduction<InnerProductReduction<Left, Right> > {
+      static constexpr bool value = true;
+
+      template <bool Checked, typename Result, typename Kernel, typename Ptrs>
+      static void reduce(Result& result, const Kernel& kernel, const Ptrs& ptrs,
+          const std::size_t i)
+      {
+        result += TiledArray::detail::inner_product(
+            kernel.left.template eval<Checked>(ptrs, i),
+            kernel.right.template eval<Checked>(ptrs, i));
+      }
+    }; // struct FusedElementReduction<InnerProductReduction>
+
+    template <typename Tile>
+    struct FusedElementReduction<CompensatedSumReduction<Tile> > {
+      static constexpr bool value = true;
+
+      template <bool Checked, typename Result, typename Kernel, typename Ptrs>
+      static void reduce(Result& result, const Kernel& kernel, const Ptrs& ptrs,
+          const std::size_t i)
+      {
+        result += typename Result::value_type(
+            kernel.template eval<Checked>(ptrs, i));
+      }
+    }; // struct FusedElementReduction<CompensatedSumReduction>
+
+    template <typename Tile>
+    struct FusedElementReduction<CompensatedSquaredNormReduction<Tile> > {
+      static constexpr bool value = true;
+
+      template <bool Checked, typename Result, typename Kernel, typename Ptrs>
+      static void reduce(Result& result, const Kernel& kernel, const Ptrs& ptrs,
+          const std::size_t i)
+      {
+        result += typename Result::value_type(TiledArray::detail::norm(
+            kernel.template eval<Checked>(ptrs, i)));
+      }
+    }; // struct FusedElementReduction<CompensatedSquaredNormReduction>
+
+    template <typename Left, typename Right>
+    struct FusedElementReduction<CompensatedDotReduction<Left, Right> > {
+      static constexpr bool value = true;
+
+      template <bool Checked, typename Result, typename Kernel, typename Ptrs>
+      static void reduce(Result& result, const Kernel& kernel, const Ptrs& ptrs,
+          const std::size_t i)
+      {
+        result += typename Result::value_type(
+            kernel.left.template eval<Checked>(ptrs, i) *
+            kernel.right.template eval<Checked>(ptrs, i));
+      }
+    }; // struct FusedElementReduction<CompensatedDotReduction>
+
+    /// Reduction of the partial results of the tiles
+
+    /// \tparam Op The tile reduction operation type
+    template <typename Op>
+    class FusedPartialReduction {
+    public:
+      typedef typename Op::result_type result_type; ///< The result type
+      typedef result_type argument_type; ///< The partial result type
+
+    private:
+      Op op_; ///< The tile reduction operation
+
+    public:
+
+      FusedPartialReduction(const Op& op) : op_(op) { }
+
+      // Make an empty result object
+      result_type operator()() const { return op_(); }
+
+      // Post process the result
+      result_type operator()(const result_type& result) const { return op_(result); }
+
+      // Reduce two result objects
+      void operator()(result_type& result, const result_type& arg) const {
+        op_(result, arg);
+      }
+
+    }; // class FusedPartialReduction
+
+    /// Fused element-wise reduction of distributed tensors
+
+    /// This object reduces the elements of a tree of element-wise operations
+    /// (see \c FusedEvalImpl ) without constructing the result tiles. Each
+    /// task reads the argument tiles of one result tile, and reduces the
+    /// elements of \c Kernel into a partial result, which is reduced with
+    /// the partial results of the other local tiles as soon as it is ready.
+    /// The argument tiles are released when the task is done.
+    /// \tparam Kernel The element kernel type, or a \c FusedKernelPair for
+    /// binary reductions
+    /// \tparam Op The tile reduction operation type
+    /// \tparam Policy The tensor policy class
+    /// \tparam Args The argument distributed evaluator types
+    template <typename Kernel, typename Op, typename Policy, typename... Args>
+    class FusedReduceImpl :
+      public std::enable_shared_from_this<FusedReduceImpl<Kernel, Op, Policy, Args...> >
+    {
+      static_assert(sizeof...(Args) <= fused_eval_max_args,
+          "Too many arguments for a fused reduction.");
+      static_assert(FusedElementReduction<Op>::value,
+          "The reduction can not be evaluated element by element.");
+    public:
+      typedef FusedReduceImpl<Kernel, Op, Policy, Args...> FusedReduceImpl_; ///< This object type
+      typedef typename Policy::size_type size_type; ///< Size type
+      typedef typename Policy::trange_type trange_type; ///< Tiled range type
+      typedef typename Policy::shape_type shape_type; ///< Shape type
+      typedef typename Op::result_type result_type; ///< The reduction result type
+      typedef Kernel kernel_type; ///< Element kernel type
+      typedef std::tuple<Args...> args_type; ///< Argument evaluators type
+
+      using std::enable_shared_from_this<FusedReduceImpl_>::shared_from_this;
+
+    private:
+
+      World& world_; ///< The world where the arguments live
+      madness::uniqueidT id_; ///< Globally unique object identifier
+      args_type args_; ///< Arguments
+      trange_type trange_; ///< The tiled range of the arguments
+      shape_type shape_; ///< The shape of the reduced expression
+      kernel_type kernel_; ///< Element kernel
+      Op op_; ///< The tile reduction operation
+
+      template <typename T>
+      using eval_t = typename eval_trait<typename std::decay<T>::type>::type;
+
+    public:
+
+      /// Construct a fused reduction
+
+      /// \param args The arguments
+      /// \param world The world where the arguments live
+      /// \param trange The tiled range of the arguments
+      /// \param shape The shape of the reduced expression
+      /// \param kernel The element kernel
+      /// \param op The tile reduction operation
+      FusedReduceImpl(const args_type& args, World& world,
+          const trange_type& trange, const shape_type& shape,
+          const kernel_type& kernel, const Op& op) :
+        world_(world), id_(world.unique_obj_id()), args_(args), trange_(trange),
+        shape_(shape), kernel_(kernel), op_(op)
+      { }
+
+      /// World accessor
+
+      /// \return A reference to the world where the arguments live
+      World& world() const { return world_; }
+
+      /// Unique object id accessor
+
+      /// \return The unique id of this object, which is the same on all
+      /// processes
+      const madness::uniqueidT& id() const { return id_; }
+
+      /// Reduce the local tiles
+
+      /// This function will evaluate the arguments, and schedule one task
+      /// for each non-zero local tile. It will block until the tasks for the
+      /// arguments are evaluated (not for the tasks of this object).
+      /// \return A future to the reduction of the local tiles
+      Future<result_type> eval() {
+        const auto args = std::index_sequence_for<Args...>();
+
+        // Evaluate child tensors
+        eval_args(args);
+
+        ReduceTask<FusedPartialReduction<Op> > reduce_task(world_,
+            FusedPartialReduction<Op>(op_));
+
+        std::shared_ptr<FusedReduceImpl_> self = shared_from_this();
+        auto it = std::get<0>(args_).pmap()->begin();
+        const auto end = std::get<0>(args_).pmap()->end();
+        for(; it != end; ++it) {
+          const size_type index = *it;
+
+          if(! shape_.is_zero(index)) {
+            reduce_task.add(add_task(args, self, index,
+                zero_mask(args, index)));
+          } else {
+            // Cleanup unused tiles
+            discard_args(args, index);
+          }
+        }
+
+        Future<result_type> result = reduce_task.submit();
+
+        // Wait for child tensors to be evaluated, and process tasks while waiting.
+        wait_args(args);
+
+        return result;
+      }
+
+    private:
+
+      /// Evaluate an argument tile, or construct an empty tile for a zero argument
+      template <std::size_t I, typename T>
+      static eval_t<T> eval_arg(const unsigned int zero_mask, const T& tile) {
+        return ((zero_mask & (1u << I)) ? eval_t<T>() : eval_t<T>(invoke_cast(tile)));
+      }
+
+      template <std::size_t... Is, typename... Ts>
+      result_type reduce_tile(std::index_sequence<Is...>, const size_type i,
+          const unsigned int zero_mask, const Ts&... tiles) const
+      {
+        typedef FusedElementReduction<Op> reduction_type;
+
+        const auto eval_tiles = std::make_tuple(eval_arg<Is>(zero_mask, tiles)...);
+        const auto ptrs = std::make_tuple(std::get<Is>(eval_tiles).data()...);
+
+        const std::size_t n = trange_.make_tile_range(i).volume();
+#ifndef NDEBUG
+        const std::size_t sizes[] = { std::get<Is>(eval_tiles).size()... };
+        for(std::size_t size : sizes)
+          TA_ASSERT((size == 0ul) || (size == n));
+#endif // NDEBUG
+
+        result_type result = op_();
+        if(zero_mask) {
+          for(std::size_t j = 0ul; j < n; ++j)
+            reduction_type::template reduce<true>(result, kernel_, ptrs, j);
+        } else {
+          for(std::size_t j = 0ul; j < n; ++j)
+            reduction_type::template reduce<false>(result, kernel_, ptrs, j);
+        }
+
+        return result;
+      }
+
+      /// Task function for reducing tiles
+
+      /// \param i The tile index
+      /// \param zero_mask Bit \c k is set when argument \c k is zero
+      /// \param tiles The argument tiles
+      /// \return The partial result of tile \c i
+      result_type reduce_tile(const size_type i, const unsigned int zero_mask,
+          const typename Args::value_type&... tiles) const
+      {
+        return reduce_tile(std::index_sequence_for<Args...>(), i, zero_mask, tiles...);
+      }
+
+      template <std::size_t... Is>
+      void eval_args(std::index_sequence<Is...>) {
+        const int dummy[] = { (std::get<Is>(args_).eval(), 0)... };
+        (void) dummy;
+      }
+
+      template <std::size_t... Is>
+      void wait_args(std::index_sequence<Is...>) {
+        const int dummy[] = { (std::get<Is>(args_).wait(), 0)... };
+        (void) dummy;
+      }
+
+      template <std::size_t... Is>
+      unsigned int zero_mask(std::index_sequence<Is...>, const size_type index) const {
+        unsigned int mask = 0u;
+        const int dummy[] = { (mask |= (std::get<Is>(args_).is_zero(index) ?
+            (1u << Is) : 0u), 0)... };
+        (void) dummy;
+        return mask;
+      }
+
+      template <std::size_t... Is>
+      void discard_args(std::index_sequence<Is...>, const size_type index) const {
+        const int dummy[] = { ((std::get<Is>(args_).is_zero(index) ?
+            void() : std::get<Is>(args_).discard(index)), 0)... };
+        (void) dummy;
+      }
+
+      template <std::size_t... Is>
+      Future<result_type> add_task(std::index_sequence<Is...>,
+          const std::shared_ptr<FusedReduceImpl_>& self, const size_type index,
+          const unsigned int mask) const
+      {
+        result_type (FusedReduceImpl_::*task)(const size_type, const unsigned int,
+            const typename Args::value_type&...) const = & FusedReduceImpl_::reduce_tile;
+        return world_.taskq.add(self, task, index, mask,
+            ((mask & (1u << Is)) ?
+                Future<typename Args::value_type>(typename Args::value_type()) :
+                std::get<Is>(args_).get(index))...,
+            task_attributes(TaskClass::tile));
+      }
+
+    }; // class FusedReduceImpl
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_FUSED_REDUCE_H__INCLUDED
@@ -0,0 +1,313 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  local_contraction_eval.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_LOCAL_CONTRACTION_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_LOCAL_CONTRACTION_EVAL_H__INCLUDED
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/task_priority.h>
+#include <TiledArray/type_traits.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Single-process contraction switch
+
+    /// SUMMA contractions in a world with one process are evaluated by
+    /// \c LocalContraction while this is \c true . The initial value is
+    /// \c false when the \c TA_LOCAL_CONTRACTION environment variable is
+    /// \c 0 , and \c true otherwise.
+    /// \return A reference to the switch
+    inline bool& local_contraction_enabled() {
+      static bool enabled = [] () {
+        const char* value = getenv("TA_LOCAL_CONTRACTION");
+        return ! (value && std::string(value) == "0");
+      }();
+      return enabled;
+    }
+
+    /// Single-process contraction evaluator
+
+    /// With one process every tile is local, so the broadcasts, process
+    /// groups, and reductions of SUMMA only add overhead. This evaluator
+    /// spawns one task per non-zero result tile, which depends on the
+    /// argument tiles of that result tile only, and contracts all of its
+    /// tile pairs in sequence, directly on the argument tiles. A result tile
+    /// is contracted as soon as its own argument tiles are evaluated, and no
+    /// reduction tasks or callbacks are created for the tile pairs.
+    /// \tparam Left The left-hand argument evaluator type
+    /// \tparam Right The right-hand argument evaluator type
+    /// \tparam Op The contraction/reduction operation type
+    /// \tparam Policy The tensor policy class
+    /// \note This evaluator may only be used in a world with one process.
+    template <typename Left, typename Right, typename Op, typename Policy>
+    class LocalContraction :
+        public DistEvalImpl<typename Op::result_type, Policy>,
+        public std::enable_shared_from_this<LocalContraction<Left, Right, Op, Policy> >
+    {
+    public:
+      typedef LocalContraction<Left, Right, Op, Policy> LocalContraction_; ///< This object type
+      typedef DistEvalImpl<typename Op::result_type, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Left left_type; ///< The left-hand argument type
+      typedef Right right_type; ///< The right-hand argument type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::range_type range_type; ///< Range type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+      typedef typename DistEvalImpl_::eval_type eval_type; ///< Tile evaluation type
+      typedef Op op_type; ///< Tile evaluation operator type
+
+    private:
+
+      using std::enable_shared_from_this<LocalContraction_>::shared_from_this;
+
+      typedef std::vector<Future<typename left_type::eval_type> > left_futures_type; ///< Left-hand tile futures
+      typedef std::vector<Future<typename right_type::eval_type> > right_futures_type; ///< Right-hand tile futures
+
+      // Arguments and operation
+      left_type left_; ///< The left-hand argument
+      right_type right_; /// < The right-hand argument
+      op_type op_; /// < The operation used to evaluate tile-tile contractions
+
+      // Dimension information
+      const size_type k_; ///< Number of tiles in the inner dimension
+      const size_type rows_; ///< Number of tile rows of the result
+      const size_type cols_; ///< Number of tile columns of the result
+
+      /// Tile conversion task function
+
+      /// \tparam Tile The input tile type
+      /// \param tile The input tile
+      /// \return The evaluated version of the lazy tile
+      template <typename Tile>
+      static auto convert_tile(const Tile& tile) {
+        TiledArray::Cast<typename eval_trait<Tile>::type, Tile> cast;
+        return cast(tile);
+      }
+
+      /// Conversion function
+
+      /// This function does nothing since tile is not a lazy tile.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return \c tile
+      template <typename Arg>
+      static typename std::enable_if<
+          ! is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_tile(Arg& arg, const typename Arg::size_type index) { return arg.get(index); }
+
+      /// Conversion function
+
+      /// This function spawns a task that will convert a lazy tile from the
+      /// tile type to the evaluated tile type.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return A future to the evaluated tile
+      template <typename Arg>
+      static typename std::enable_if<
+          is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_tile(Arg& arg, const typename Arg::size_type index) {
+        auto convert_tile_fn =
+            &LocalContraction_::template convert_tile<typename Arg::value_type>;
+        return arg.world().taskq.add(convert_tile_fn, arg.get(index),
+                                     madness::TaskAttributes::hipri());
+      }
+
+      /// Collect the tiles of an argument
+
+      /// The tiles that are marked in \c used are fetched (and converted),
+      /// the other non-zero tiles are discarded.
+      /// \tparam Arg The argument type
+      /// \param arg The argument
+      /// \param used Flags of the argument tiles that are contracted
+      /// \return The futures to the used tiles, where unused tiles are empty
+      template <typename Arg>
+      static std::vector<Future<typename Arg::eval_type> >
+      fetch(Arg& arg, const std::vector<bool>& used) {
+        std::vector<Future<typename Arg::eval_type> > tiles(arg.size());
+        for(size_type index = 0ul; index < arg.size(); ++index) {
+          if(arg.is_zero(index)) continue;
+          if(used[index])
+            tiles[index] = get_tile(arg, index);
+          else
+            arg.discard(index);
+        }
+        return tiles;
+      }
+
+      /// Contract a result tile
+
+      /// The task of this function depends on the futures of its tile pairs,
+      /// so they are evaluated when it runs.
+      /// \param perm_index The permuted index of the result tile
+      /// \param left_tiles The left-hand tiles of the non-zero tile pairs
+      /// \param right_tiles The right-hand tiles of the non-zero tile pairs
+      void eval_tile(const size_type perm_index, const left_futures_type& left_tiles,
+          const right_futures_type& right_tiles)
+      {
+        TA_ASSERT(left_tiles.size() == right_tiles.size());
+        typename op_type::result_type result = op_();
+        for(size_type p = 0ul; p < left_tiles.size(); ++p)
+          op_(result, left_tiles[p].get(), right_tiles[p].get());
+        DistEvalImpl_::set_tile(perm_index, op_(result));
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param left The left-hand argument evaluator
+      /// \param right The right-hand argument evaluator
+      /// \param world The world where the result lives
+      /// \param trange The tiled range object for the result
+      /// \param shape The tensor shape object for the result
+      /// \param pmap The tile-process map for the result
+      /// \param perm The permutation that is applied to result tile indices
+      /// \param op The tile transform operation
+      /// \param k The number of tiles in the inner dimension
+      /// \note The trange, shape, and pmap refer to the final, permuted, state
+      /// for the result.
+      LocalContraction(const left_type& left, const right_type& right,
+          World& world, const trange_type trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm,
+          const op_type& op, const size_type k) :
+        DistEvalImpl_(world, trange, shape, pmap, perm),
+        left_(left), right_(right), op_(op),
+        k_(k), rows_(left.size() / k), cols_(right.size() / k)
+      {
+        TA_ASSERT(world.size() == 1);
+      }
+
+      virtual ~LocalContraction() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::world().gop.template recv<value_type>(
+            TensorImpl_::owner(i), key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Evaluate the tiles of this tensor
+
+      /// This function will evaluate the children of this distributed evaluator
+      /// and evaluate the tiles for this distributed evaluator. It will block
+      /// until the tasks for the children are evaluated (not for the tasks of
+      /// this object).
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        // Start evaluate child tensors
+        left_.eval();
+        right_.eval();
+
+        // Mark the argument tiles that are contracted into non-zero result
+        // tiles
+        std::vector<bool> left_used(left_.size(), false), right_used(right_.size(), false);
+        for(auto it = TensorImpl_::pmap()->begin(); it != TensorImpl_::pmap()->end(); ++it) {
+          if(TensorImpl_::is_zero(*it)) continue;
+          const size_type index = DistEvalImpl_::perm_index_to_source(*it);
+          const size_type row = index / cols_;
+          const size_type col = index % cols_;
+          for(size_type k = 0ul, left_index = row * k_, right_index = col; k < k_;
+              ++k, ++left_index, right_index += cols_)
+          {
+            if(left_.is_zero(left_index) || right_.is_zero(right_index)) continue;
+            left_used[left_index] = true;
+            right_used[right_index] = true;
+          }
+        }
+
+        // Collect the argument tiles, which are all local
+        const left_futures_type left_futures = fetch(left_, left_used);
+        const right_futures_type right_futures = fetch(right_, right_used);
+
+        // Spawn one task per non-zero result tile, which depends on the
+        // tiles of its non-zero tile pairs
+        std::shared_ptr<LocalContraction_> self = shared_from_this();
+        int tile_count = 0;
+        for(auto it = TensorImpl_::pmap()->begin(); it != TensorImpl_::pmap()->end(); ++it) {
+          const size_type perm_index = *it;
+          if(TensorImpl_::is_zero(perm_index)) continue;
+          const size_type index = DistEvalImpl_::perm_index_to_source(perm_index);
+          const size_type row = index / cols_;
+          const size_type col = index % cols_;
+          left_futures_type left_tiles;
+          right_futures_type right_tiles;
+          for(size_type k = 0ul, left_index = row * k_, right_index = col; k < k_;
+              ++k, ++left_index, right_index += cols_)
+          {
+            if(left_.is_zero(left_index) || right_.is_zero(right_index)) continue;
+            left_tiles.push_back(left_futures[left_index]);
+            right_tiles.push_back(right_futures[right_index]);
+          }
+          TensorImpl_::world().taskq.add(self, & LocalContraction_::eval_tile,
+              perm_index, left_tiles, right_tiles, task_attributes(TaskClass::tile));
+          ++tile_count;
+        }
+
+        // Wait for child tensors to be evaluated, and process tasks while waiting.
+        left_.wait();
+        right_.wait();
+
+        return tile_count;
+      }
+
+    }; // class LocalContraction
+
+  } // namespace detail
+
+  /// Enable or disable the single-process contraction evaluator
+
+  /// \param enabled \c false to evaluate the contractions of a world with
+  /// one process with SUMMA, e.g. to test the SUMMA features
+  inline void set_local_contraction(const bool enabled) {
+    detail::local_contraction_enabled() = enabled;
+  }
+
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_LOCAL_CONTRACTION_EVAL_H__INCLUDED
@@ -0,0 +1,219 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_NODE_BCAST_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_NODE_BCAST_H__INCLUDED
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Map of the processes of a world to compute nodes
+
+    /// Each process is mapped to the lowest ranked process on its node, the
+    /// node leader. By default, processes are placed on the same node when
+    /// they report the same host name. The \c TA_RANKS_PER_NODE environment
+    /// variable overrides the detection, and places consecutive blocks of
+    /// that many ranks on each node.
+    class NodeMap {
+      std::vector<ProcessID> leaders_; ///< The node leader of each process
+
+      static std::mutex& mutex() {
+        static std::mutex mtx;
+        return mtx;
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param world The world of the processes
+      /// \note This is a collective operation unless \c TA_RANKS_PER_NODE is
+      /// set.
+      explicit NodeMap(World& world) : leaders_(world.size()) {
+        const std::size_t nprocs = world.size();
+
+        const char* ranks_per_node = getenv("TA_RANKS_PER_NODE");
+        if(ranks_per_node) {
+          const std::size_t n = std::max<std::size_t>(std::stoul(ranks_per_node), 1ul);
+          for(std::size_t p = 0ul; p < nprocs; ++p)
+            leaders_[p] = (p / n) * n;
+          return;
+        }
+
+        // Collect the host name hash of every process
+        char hostname[256] = { '\0' };
+        gethostname(hostname, sizeof(hostname) - 1ul);
+        std::vector<unsigned long> hashes(nprocs, 0ul);
+        hashes[world.rank()] = std::hash<std::string>()(std::string(hostname));
+        world.gop.sum(hashes.data(), nprocs);
+
+        std::unordered_map<unsigned long, ProcessID> nodes;
+        for(std::size_t p = 0ul; p < nprocs; ++p)
+          leaders_[p] = nodes.emplace(hashes[p], ProcessID(p)).first->second;
+      }
+
+      /// Node map accessor
+
+      /// The map of each world is constructed by the first call for that
+      /// world, which must be made collectively.
+      /// \param world The world of the processes
+      /// \return The node map of \c world
+      static std::shared_ptr<NodeMap> instance(World& world) {
+        static std::map<unsigned long, std::shared_ptr<NodeMap> > maps;
+        {
+          std::lock_guard<std::mutex> lock(mutex());
+          auto it = maps.find(world.id());
+          if(it != maps.end())
+            return it->second;
+        }
+
+        // Construct the map outside the lock, since it may communicate
+        std::shared_ptr<NodeMap> map = std::make_shared<NodeMap>(world);
+        std::lock_guard<std::mutex> lock(mutex());
+        return maps.emplace(world.id(), map).first->second;
+      }
+
+      /// Node leader accessor
+
+      /// \param proc A process of the world
+      /// \return The lowest ranked process on the node of \c proc
+      ProcessID leader(const ProcessID proc) const {
+        TA_ASSERT(std::size_t(proc) < leaders_.size());
+        return leaders_[proc];
+      }
+
+      /// Node size accessor
+
+      /// \param proc A process of the world
+      /// \return The number of processes on the node of \c proc
+      std::size_t node_size(const ProcessID proc) const {
+        return std::count(leaders_.begin(), leaders_.end(), leader(proc));
+      }
+
+    }; // class NodeMap
+
+
+    /// Two-level broadcast over a process group
+
+    /// The broadcast is split into an inter-node broadcast among one leader
+    /// per node, followed by an intra-node broadcast from each leader to the
+    /// other members of the group on its node. The root is the leader of its
+    /// node, and the lowest ranked member is the leader of every other node,
+    /// so each value crosses the network once per node.
+    class NodeBcast {
+      madness::Group leader_group_; ///< The node leaders of the group (empty if this process is not a leader)
+      ProcessID leader_root_; ///< The root of the leader group
+      madness::Group node_group_; ///< The group members on this node (empty if there are none)
+      ProcessID node_root_; ///< The root of the node group
+
+    public:
+
+      /// Constructor
+
+      /// The subgroups are identified by \c id and \c index , which must be
+      /// unique for each combination of group and root.
+      /// \param world The world of the group
+      /// \param node_map The node map of \c world
+      /// \param group The process group of the broadcast
+      /// \param group_root The root of the broadcast in \c group
+      /// \param id The object id used to identify the subgroups
+      /// \param index The first of the \c world.size() + 1 subgroup indices
+      /// reserved for this broadcast
+      NodeBcast(World& world, const NodeMap& node_map, const madness::Group& group,
+          const ProcessID group_root, const madness::uniqueidT& id,
+          const std::size_t index) :
+        leader_group_(), leader_root_(0), node_group_(), node_root_(0)
+      {
+        TA_ASSERT(! group.empty());
+        const ProcessID rank = world.rank();
+        const ProcessID root = group.world_rank(group_root);
+        const ProcessID node = node_map.leader(rank);
+
+        // Select the leader of each node
+        std::vector<ProcessID> members(group.size());
+        for(ProcessID p = 0; p < group.size(); ++p)
+          members[p] = group.world_rank(p);
+        std::sort(members.begin(), members.end());
+        std::map<ProcessID, ProcessID> leaders;
+        for(const ProcessID p : members)
+          leaders.emplace(node_map.leader(p), p);
+        leaders[node_map.leader(root)] = root;
+
+        // Construct the leader group
+        const ProcessID leader = leaders[node];
+        if((leader == rank) && (leaders.size() > 1ul)) {
+          std::vector<ProcessID> procs;
+          procs.reserve(leaders.size());
+          for(const auto& l : leaders)
+            procs.push_back(l.second);
+          std::sort(procs.begin(), procs.end());
+          leader_group_ = madness::Group(world, procs,
+              madness::DistributedID(id, index + world.size()));
+          leader_root_ = leader_group_.rank(root);
+        }
+
+        // Construct the group of this node
+        std::vector<ProcessID> procs;
+        for(const ProcessID p : members)
+          if(node_map.leader(p) == node)
+            procs.push_back(p);
+        if(procs.size() > 1ul) {
+          node_group_ = madness::Group(world, procs,
+              madness::DistributedID(id, index + node));
+          node_root_ = node_group_.rank(leader);
+        }
+      }
+
+      /// Broadcast a value
+
+      /// \tparam T The value type
+      /// \param world The world of the group
+      /// \param key The key of the inter-node broadcast
+      /// \param node_key The key of the intra-node broadcast
+      /// \param value The value to be broadcast, which is set on processes
+      /// other than the root
+      template <typename T>
+      void bcast(World& world, const madness::DistributedID& key,
+          const madness::DistributedID& node_key, Future<T>& value) const
+      {
+        if(! leader_group_.empty())
+          world.gop.bcast(key, value, leader_root_, leader_group_);
+        if(! node_group_.empty())
+          world.gop.bcast(node_key, value, node_root_, node_group_);
+      }
+
+    }; // class NodeBcast
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_NODE_BCAST_H__INCLUDED
@@ -0,0 +1,390 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  outer_product_eval.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_OUTER_PRODUCT_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_OUTER_PRODUCT_EVAL_H__INCLUDED
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/math/outer.h>
+#include <TiledArray/type_traits.h>
+#include <TiledArray/work_counter.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Distributed outer product evaluator
+
+    /// Evaluates \f$ C_{i j} = \alpha A_i B_j \f$ , where \c i and \c j may
+    /// each be several dimensions, i.e. a contraction without inner
+    /// dimensions. Each result tile is the outer product of one tile of each
+    /// argument, so there is nothing to reduce. The larger argument stays in
+    /// place, and each non-zero tile of the smaller argument is sent once to
+    /// every process that holds a tile of the larger argument it is
+    /// multiplied with, i.e. the smaller argument is replicated where it is
+    /// needed. The result tiles are computed with \c math::outer_fill() by
+    /// the processes that hold the tiles of the larger argument.
+    /// \tparam Left The left-hand argument evaluator type
+    /// \tparam Right The right-hand argument evaluator type
+    /// \tparam Result The result tile type, a \c Tensor
+    /// \tparam Scalar The scaling factor type
+    /// \tparam Policy The tensor policy class
+    template <typename Left, typename Right, typename Result, typename Scalar,
+        typename Policy>
+    class OuterProductEvalImpl :
+        public DistEvalImpl<Result, Policy>,
+        public std::enable_shared_from_this<
+            OuterProductEvalImpl<Left, Right, Result, Scalar, Policy> >
+    {
+    public:
+      typedef OuterProductEvalImpl<Left, Right, Result, Scalar, Policy>
+          OuterProductEvalImpl_; ///< This object type
+      typedef DistEvalImpl<Result, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Left left_type; ///< The left-hand argument type
+      typedef Right right_type; ///< The right-hand argument type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::range_type range_type; ///< Range type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+
+    private:
+
+      typedef typename left_type::eval_type left_eval_type; ///< Evaluated left-hand tile type
+      typedef typename right_type::eval_type right_eval_type; ///< Evaluated right-hand tile type
+
+      left_type left_; ///< The left-hand argument
+      right_type right_; ///< The right-hand argument
+      const Scalar factor_; ///< The scaling factor
+      const Permutation perm_; ///< The permutation of the result tiles
+      const bool replicate_left_; ///< The left-hand argument is sent to the right-hand tiles
+      const size_type cols_; ///< The number of right-hand tiles
+
+      /// Tile conversion task function
+
+      /// \tparam Tile The input tile type
+      /// \param tile The input tile
+      /// \return The evaluated version of the lazy tile
+      template <typename Tile>
+      static auto convert_tile(const Tile& tile) {
+        TiledArray::Cast<typename eval_trait<Tile>::type, Tile> cast;
+        return cast(tile);
+      }
+
+      /// Conversion function
+
+      /// This function does nothing since tile is not a lazy tile.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return \c tile
+      template <typename Arg>
+      static typename std::enable_if<
+          ! is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_arg_tile(Arg& arg, const typename Arg::size_type index) { return arg.get(index); }
+
+      /// Conversion function
+
+      /// This function spawns a task that will convert a lazy tile from the
+      /// tile type to the evaluated tile type.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return A future to the evaluated tile
+      template <typename Arg>
+      static typename std::enable_if<
+          is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_arg_tile(Arg& arg, const typename Arg::size_type index) {
+        auto convert_tile_fn =
+            &OuterProductEvalImpl_::template convert_tile<typename Arg::value_type>;
+        return arg.world().taskq.add(convert_tile_fn, arg.get(index),
+                                     madness::TaskAttributes::hipri());
+      }
+
+      /// Key of a replicated tile
+
+      /// Keys of replicated tiles follow the keys of the result tiles.
+      /// \param index The index of the tile in the smaller argument
+      /// \return The message key of the replicated tile
+      madness::DistributedID move_key(const size_type index) const {
+        return madness::DistributedID(DistEvalImpl_::id(),
+            TensorImpl_::size() + index);
+      }
+
+      /// Unpermuted result tile index
+
+      /// \param small The tile index of the smaller argument
+      /// \param large The tile index of the larger argument
+      /// \return The unpermuted index of the product of the tiles
+      size_type result_index(const size_type small, const size_type large) const {
+        return (replicate_left_ ? small * cols_ + large : large * cols_ + small);
+      }
+
+      /// Check that a result tile is needed
+
+      /// \param small The tile index of the smaller argument
+      /// \param large The tile index of the larger argument
+      /// \return \c true if the product of the tiles is a non-zero tile
+      bool is_result_needed(const size_type small, const size_type large) const {
+        return ! TensorImpl_::is_zero(
+            DistEvalImpl_::perm_index_to_target(result_index(small, large)));
+      }
+
+      /// Outer product of two tiles
+
+      /// \param left The left-hand tile
+      /// \param right The right-hand tile
+      /// \return The scaled (and permuted) outer product of \c left and
+      /// \c right
+      value_type outer_tile(const left_eval_type& left, const right_eval_type& right) const {
+        std::vector<std::size_t> lower, upper;
+        lower.reserve(left.range().rank() + right.range().rank());
+        upper.reserve(left.range().rank() + right.range().rank());
+        lower.insert(lower.end(), left.range().lobound_data(),
+            left.range().lobound_data() + left.range().rank());
+        lower.insert(lower.end(), right.range().lobound_data(),
+            right.range().lobound_data() + right.range().rank());
+        upper.insert(upper.end(), left.range().upbound_data(),
+            left.range().upbound_data() + left.range().rank());
+        upper.insert(upper.end(), right.range().upbound_data(),
+            right.range().upbound_data() + right.range().rank());
+
+        value_type result(range_type(lower, upper));
+        const Scalar factor = factor_;
+        math::outer_fill(left.size(), right.size(), left.data(), right.data(),
+            result.data(), [factor] (const typename left_eval_type::value_type l,
+                const typename right_eval_type::value_type r)
+            { return factor * l * r; });
+        WorkCounter::instance().add_flops(2ul * result.size());
+
+        return (perm_ ? result.permute(perm_) : result);
+      }
+
+      /// Task function for evaluating tiles
+
+      /// \param i The result tile index
+      /// \param left The left-hand tile
+      /// \param right The right-hand tile
+      void eval_tile(const size_type i, const left_eval_type& left,
+          const right_eval_type& right)
+      {
+        DistEvalImpl_::set_tile(i, outer_tile(left, right));
+      }
+
+      /// Spawn the evaluation of a tile
+
+      /// \param self This object
+      /// \param index The unpermuted result tile index
+      /// \param left The left-hand tile
+      /// \param right The right-hand tile
+      void spawn_tile(const std::shared_ptr<OuterProductEvalImpl_>& self,
+          const size_type index, const Future<left_eval_type>& left,
+          const Future<right_eval_type>& right)
+      {
+        TensorImpl_::world().taskq.add(self, & OuterProductEvalImpl_::eval_tile,
+            DistEvalImpl_::perm_index_to_target(index), left, right);
+      }
+
+      /// Send the local tiles of the smaller argument
+
+      /// Each non-zero local tile is sent to the processes that own a tile of
+      /// the larger argument it is multiplied with into a non-zero result
+      /// tile.
+      /// \tparam Small The smaller argument type
+      /// \tparam Large The larger argument type
+      /// \param small The smaller argument
+      /// \param large The larger argument
+      /// \param[out] local_tiles The replicated tiles that are used by this
+      /// process
+      template <typename Small, typename Large>
+      void replicate(Small& small, const Large& large,
+          std::unordered_map<size_type, Future<typename Small::eval_type> >& local_tiles)
+      {
+        World& world = TensorImpl_::world();
+        std::vector<ProcessID> dest;
+        for(auto it = small.pmap()->begin(); it != small.pmap()->end(); ++it) {
+          const size_type index = *it;
+          if(small.is_zero(index)) continue;
+
+          dest.clear();
+          for(size_type x = 0ul; x < large.size(); ++x)
+            if(! large.is_zero(x) && is_result_needed(index, x))
+              dest.push_back(large.owner(x));
+          std::sort(dest.begin(), dest.end());
+          dest.erase(std::unique(dest.begin(), dest.end()), dest.end());
+
+          if(dest.empty()) {
+            small.discard(index);
+            continue;
+          }
+
+          const Future<typename Small::eval_type> tile = get_arg_tile(small, index);
+          for(const ProcessID p : dest) {
+            if(p == world.rank())
+              local_tiles.emplace(index, tile);
+            else
+              world.gop.send(p, move_key(index), tile);
+          }
+        }
+      }
+
+      /// Multiply the local tiles of the larger argument
+
+      /// \tparam Small The smaller argument type
+      /// \tparam Large The larger argument type
+      /// \tparam Spawn The task spawning function type
+      /// \param small The smaller argument
+      /// \param large The larger argument
+      /// \param small_tiles The replicated tiles that are used by this process
+      /// \param spawn The function that spawns the evaluation of a result
+      /// tile from its index, a small tile, and a large tile
+      /// \return The number of result tiles evaluated by this process
+      template <typename Small, typename Large, typename Spawn>
+      int multiply(const Small& small, Large& large,
+          std::unordered_map<size_type, Future<typename Small::eval_type> >& small_tiles,
+          const Spawn& spawn)
+      {
+        World& world = TensorImpl_::world();
+        int tile_count = 0;
+        for(auto it = large.pmap()->begin(); it != large.pmap()->end(); ++it) {
+          const size_type index = *it;
+          if(large.is_zero(index)) continue;
+
+          Future<typename Large::eval_type> tile;
+          bool used = false;
+          for(size_type y = 0ul; y < small.size(); ++y) {
+            if(small.is_zero(y) || ! is_result_needed(y, index)) continue;
+
+            if(! used) {
+              tile = get_arg_tile(large, index);
+              used = true;
+            }
+
+            auto small_tile = small_tiles.find(y);
+            if(small_tile == small_tiles.end())
+              small_tile = small_tiles.emplace(y, world.gop.template
+                  recv<typename Small::eval_type>(small.owner(y), move_key(y))).first;
+            spawn(result_index(y, index), small_tile->second, tile);
+            ++tile_count;
+          }
+
+          if(! used)
+            large.discard(index);
+        }
+
+        return tile_count;
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param left The left-hand argument evaluator
+      /// \param right The right-hand argument evaluator
+      /// \param factor The scaling factor
+      /// \param replicate_left If \c true, the left-hand argument is
+      /// replicated; otherwise the right-hand argument is replicated
+      /// \param world The world where the result lives
+      /// \param trange The tiled range object for the result
+      /// \param shape The tensor shape object for the result
+      /// \param pmap The tile-process map for the result
+      /// \param perm The permutation that is applied to the result
+      /// \note The trange, shape, and pmap refer to the final, permuted, state
+      /// for the result.
+      OuterProductEvalImpl(const left_type& left, const right_type& right,
+          const Scalar factor, const bool replicate_left, World& world,
+          const trange_type& trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm) :
+        DistEvalImpl_(world, trange, shape, pmap, perm),
+        left_(left), right_(right), factor_(factor), perm_(perm),
+        replicate_left_(replicate_left), cols_(right.size())
+      { }
+
+      virtual ~OuterProductEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+        const size_type index = DistEvalImpl_::perm_index_to_source(i);
+        const ProcessID source = (replicate_left_ ? right_.owner(index % cols_) :
+            left_.owner(index / cols_));
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::world().gop.template recv<value_type>(source, key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Evaluate the tiles of this tensor
+
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        std::shared_ptr<OuterProductEvalImpl_> self =
+            std::enable_shared_from_this<OuterProductEvalImpl_>::shared_from_this();
+
+        left_.eval();
+        right_.eval();
+
+        int tile_count = 0;
+        if(replicate_left_) {
+          std::unordered_map<size_type, Future<left_eval_type> > left_tiles;
+          replicate(left_, right_, left_tiles);
+          tile_count = multiply(left_, right_, left_tiles,
+              [this,&self] (const size_type index, const Future<left_eval_type>& left,
+                  const Future<right_eval_type>& right)
+              { this->spawn_tile(self, index, left, right); });
+        } else {
+          std::unordered_map<size_type, Future<right_eval_type> > right_tiles;
+          replicate(right_, left_, right_tiles);
+          tile_count = multiply(right_, left_, right_tiles,
+              [this,&self] (const size_type index, const Future<right_eval_type>& right,
+                  const Future<left_eval_type>& left)
+              { this->spawn_tile(self, index, left, right); });
+        }
+
+        left_.wait();
+        right_.wait();
+
+        return tile_count;
+      }
+
+    }; // class OuterProductEvalImpl
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_OUTER_PRODUCT_EVAL_H__INCLUDED
@@ -0,0 +1,64 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_PARTIAL_REDUCE_OP_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_PARTIAL_REDUCE_OP_H__INCLUDED
+
+#include <TiledArray/tile_op/tile_interface.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Partial result reduction operation
+
+    /// Sums the partial results of a result tile that were contracted by
+    /// different processes (e.g. the process grid layers of \c Summa , or
+    /// the holders of the stationary tiles of \c StationaryContraction ).
+    /// Empty partial results, from processes that did not contribute to the
+    /// tile, are skipped.
+    /// \tparam Tile The tile type
+    template <typename Tile>
+    class PartialReduceOp {
+    public:
+      typedef Tile result_type; ///< The result tile type
+      typedef Tile argument_type; ///< The partial result tile type
+
+      /// Create an empty result object
+      result_type operator()() const { return result_type(); }
+
+      /// Post processing step (no operation, passthrough)
+      result_type operator()(const result_type& temp) const { return temp; }
+
+      /// Add the partial result \c arg to \c result
+      void operator()(result_type& result, const argument_type& arg) const {
+        using TiledArray::empty;
+        using TiledArray::add_to;
+        if(empty(arg))
+          return;
+        if(empty(result))
+          result = arg;
+        else
+          add_to(result, arg);
+      }
+    }; // class PartialReduceOp
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_PARTIAL_REDUCE_OP_H__INCLUDED
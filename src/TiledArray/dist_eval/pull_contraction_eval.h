@@ -0,0 +1,401 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  pull_contraction_eval.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_PULL_CONTRACTION_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_PULL_CONTRACTION_EVAL_H__INCLUDED
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/reduce_task.h>
+#include <TiledArray/remote_tile_cache.h>
+#include <TiledArray/type_traits.h>
+#include <TiledArray/work_counter.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Owner-computes distributed contraction evaluator
+
+    /// SUMMA and the operand-stationary contractions move whole panels or
+    /// arguments, which is a poor fit for irregular block sparsity, where
+    /// each result tile needs a small and unpredictable set of argument
+    /// tiles. In this evaluator each process contracts its own non-zero
+    /// result tiles, so nothing is reduced, and receives only the argument
+    /// tiles that these result tiles need. The tiles needed by a process
+    /// follow from the replicated shapes and process maps, so the owner of
+    /// an argument tile knows which processes need it without a request
+    /// message, and sends it once to each of them. Each process fetches its
+    /// argument tiles through a \c RemoteTileCache , so a tile that is used
+    /// by several local result tiles is received once and shared by them.
+    /// \tparam Left The left-hand argument evaluator type
+    /// \tparam Right The right-hand argument evaluator type
+    /// \tparam Op The contraction/reduction operation type
+    /// \tparam Policy The tensor policy class
+    /// \note The arguments and the result may have any distribution.
+    template <typename Left, typename Right, typename Op, typename Policy>
+    class PullContraction :
+        public DistEvalImpl<typename Op::result_type, Policy>
+    {
+    public:
+      typedef PullContraction<Left, Right, Op, Policy> PullContraction_; ///< This object type
+      typedef DistEvalImpl<typename Op::result_type, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Left left_type; ///< The left-hand argument type
+      typedef Right right_type; ///< The right-hand argument type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::range_type range_type; ///< Range type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+      typedef typename DistEvalImpl_::eval_type eval_type; ///< Tile evaluation type
+      typedef Op op_type; ///< Tile evaluation operator type
+
+    private:
+
+      typedef Future<typename right_type::eval_type> right_future; ///< Future to a right-hand argument tile
+      typedef Future<typename left_type::eval_type> left_future; ///< Future to a left-hand argument tile
+      typedef RemoteTileCache<left_future> left_cache_type; ///< Fetched left-hand tiles
+      typedef RemoteTileCache<right_future> right_cache_type; ///< Fetched right-hand tiles
+
+      // Arguments and operation
+      left_type left_; ///< The left-hand argument
+      right_type right_; /// < The right-hand argument
+      op_type op_; /// < The operation used to evaluate tile-tile contractions
+
+      // Dimension information
+      const size_type k_; ///< Number of tiles in the inner dimension
+      const size_type rows_; ///< Number of tile rows of the result
+      const size_type cols_; ///< Number of tile columns of the result
+
+      /// Tile conversion task function
+
+      /// \tparam Tile The input tile type
+      /// \param tile The input tile
+      /// \return The evaluated version of the lazy tile
+      template <typename Tile>
+      static auto convert_tile(const Tile& tile) {
+        TiledArray::Cast<typename eval_trait<Tile>::type, Tile> cast;
+        return cast(tile);
+      }
+
+      /// Conversion function
+
+      /// This function does nothing since tile is not a lazy tile.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return \c tile
+      template <typename Arg>
+      static typename std::enable_if<
+          ! is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_tile(Arg& arg, const typename Arg::size_type index) { return arg.get(index); }
+
+      /// Conversion function
+
+      /// This function spawns a task that will convert a lazy tile from the
+      /// tile type to the evaluated tile type.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return A future to the evaluated tile
+      template <typename Arg>
+      static typename std::enable_if<
+          is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_tile(Arg& arg, const typename Arg::size_type index) {
+        auto convert_tile_fn =
+            &PullContraction_::template convert_tile<typename Arg::value_type>;
+        return arg.world().taskq.add(convert_tile_fn, arg.get(index),
+                                     madness::TaskAttributes::hipri());
+      }
+
+      /// The owner of a result tile
+
+      /// \param row The result tile row
+      /// \param col The result tile column
+      /// \return The owner of the result tile at (\c row, \c col ), or -1 if
+      /// it is zero
+      ProcessID result_owner(const size_type row, const size_type col) const {
+        const size_type perm_index =
+            DistEvalImpl_::perm_index_to_target(row * cols_ + col);
+        return (TensorImpl_::is_zero(perm_index) ? -1 :
+            ProcessID(TensorImpl_::owner(perm_index)));
+      }
+
+      /// Key of a fetched left-hand tile
+
+      /// Keys of fetched tiles follow the keys of the result tiles.
+      /// \param index The index of the tile in the left-hand argument
+      /// \return The message key of the tile
+      madness::DistributedID left_key(const size_type index) const {
+        return madness::DistributedID(DistEvalImpl_::id(),
+            TensorImpl_::size() + index);
+      }
+
+      /// Key of a fetched right-hand tile
+
+      /// Keys of fetched right-hand tiles follow the keys of the left-hand
+      /// tiles.
+      /// \param index The index of the tile in the right-hand argument
+      /// \return The message key of the tile
+      madness::DistributedID right_key(const size_type index) const {
+        return madness::DistributedID(DistEvalImpl_::id(),
+            TensorImpl_::size() + left_.size() + index);
+      }
+
+      /// Size of an argument tile
+
+      /// \tparam Arg The argument type
+      /// \param arg The argument
+      /// \param index The tile index of \c arg
+      /// \return The number of bytes of the evaluated tile
+      template <typename Arg>
+      static size_type tile_bytes(const Arg& arg, const size_type index) {
+        return arg.trange().make_tile_range(index).volume() *
+            sizeof(typename numeric_type<typename Arg::eval_type>::type);
+      }
+
+      /// Send the local tiles of an argument to the processes that need them
+
+      /// Each non-zero local tile is sent once to every other process that
+      /// owns a non-zero result tile it is contracted into. The tiles used
+      /// by this process are inserted in \c cache ; unused tiles are
+      /// discarded. A replicated argument is stored on every process, so its
+      /// tiles are only used by this process.
+      /// \tparam Arg The argument type
+      /// \tparam Dest The destination function type
+      /// \tparam Key The message key function type
+      /// \param arg The argument
+      /// \param dests The function that collects the owners of the result
+      /// tiles that use an argument tile, with possible duplicates
+      /// \param key The function that returns the message key of a tile
+      /// \param cache The argument tiles used by this process
+      template <typename Arg, typename Dest, typename Key>
+      void send(Arg& arg, const Dest& dests, const Key& key,
+          RemoteTileCache<Future<typename Arg::eval_type> >& cache)
+      {
+        World& world = TensorImpl_::world();
+        const bool replicated = arg.pmap()->is_replicated();
+        std::vector<ProcessID> dest;
+        for(auto it = arg.pmap()->begin(); it != arg.pmap()->end(); ++it) {
+          const size_type index = *it;
+          if(arg.is_zero(index)) continue;
+
+          dest.clear();
+          dests(index, dest);
+          if(replicated) {
+            const bool used =
+                std::find(dest.begin(), dest.end(), world.rank()) != dest.end();
+            dest.assign(used ? 1ul : 0ul, world.rank());
+          }
+          std::sort(dest.begin(), dest.end());
+          dest.erase(std::unique(dest.begin(), dest.end()), dest.end());
+
+          if(dest.empty()) {
+            arg.discard(index);
+            continue;
+          }
+
+          const Future<typename Arg::eval_type> tile = get_tile(arg, index);
+          const size_type bytes = tile_bytes(arg, index);
+          size_type sent = 0ul;
+          for(const ProcessID p : dest) {
+            if(p == world.rank()) {
+              cache.find(index, bytes, [&tile] () { return tile; });
+            } else {
+              world.gop.send(p, key(index), tile);
+              ++sent;
+            }
+          }
+          WorkCounter::instance().add_bytes_sent(bytes * sent);
+        }
+      }
+
+      /// Fetch an argument tile
+
+      /// The first request for a tile posts the receive, and later requests
+      /// share its future.
+      /// \tparam Arg The argument type
+      /// \tparam Key The message key function type
+      /// \param arg The argument
+      /// \param index The tile index of \c arg
+      /// \param key The function that returns the message key of a tile
+      /// \param cache The argument tiles used by this process
+      /// \return A future to the tile
+      template <typename Arg, typename Key>
+      Future<typename Arg::eval_type> fetch(const Arg& arg, const size_type index,
+          const Key& key, RemoteTileCache<Future<typename Arg::eval_type> >& cache) const
+      {
+        const size_type bytes = tile_bytes(arg, index);
+        return cache.find(index, bytes, [&] () {
+          WorkCounter::instance().add_bytes_received(bytes);
+          return TensorImpl_::world().gop.template
+              recv<typename Arg::eval_type>(arg.owner(index), key(index));
+        });
+      }
+
+      /// Contract the local result tiles
+
+      /// \param left_tiles The left-hand tiles used by this process
+      /// \param right_tiles The right-hand tiles used by this process
+      /// \return The number of result tiles set by this process
+      int contract(left_cache_type& left_tiles, right_cache_type& right_tiles) {
+        World& world = TensorImpl_::world();
+        const auto left_key_fn = [this] (const size_type index) { return left_key(index); };
+        const auto right_key_fn = [this] (const size_type index) { return right_key(index); };
+
+        int tile_count = 0;
+        for(auto it = TensorImpl_::pmap()->begin(); it != TensorImpl_::pmap()->end(); ++it) {
+          const size_type perm_index = *it;
+          if(TensorImpl_::is_zero(perm_index)) continue;
+          const size_type index = DistEvalImpl_::perm_index_to_source(perm_index);
+          const size_type row = index / cols_;
+          const size_type col = index % cols_;
+
+          ReducePairTask<op_type> reduce_task(world, op_);
+          for(size_type k = 0ul, left_index = row * k_, right_index = col; k < k_;
+              ++k, ++left_index, right_index += cols_)
+          {
+            if(left_.is_zero(left_index) || right_.is_zero(right_index)) continue;
+            reduce_task.add(fetch(left_, left_index, left_key_fn, left_tiles),
+                fetch(right_, right_index, right_key_fn, right_tiles));
+          }
+          DistEvalImpl_::set_tile(perm_index, reduce_task.submit());
+          ++tile_count;
+        }
+
+        return tile_count;
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param left The left-hand argument evaluator
+      /// \param right The right-hand argument evaluator
+      /// \param world The world where the result lives
+      /// \param trange The tiled range object for the result
+      /// \param shape The tensor shape object for the result
+      /// \param pmap The tile-process map for the result
+      /// \param perm The permutation that is applied to result tile indices
+      /// \param op The tile transform operation
+      /// \param k The number of tiles in the inner dimension
+      /// \note The trange, shape, and pmap refer to the final, permuted, state
+      /// for the result.
+      PullContraction(const left_type& left, const right_type& right,
+          World& world, const trange_type trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm,
+          const op_type& op, const size_type k) :
+        DistEvalImpl_(world, trange, shape, pmap, perm),
+        left_(left), right_(right), op_(op),
+        k_(k), rows_(left.size() / k), cols_(right.size() / k)
+      { }
+
+      virtual ~PullContraction() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::world().gop.template recv<value_type>(
+            TensorImpl_::owner(i), key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Evaluate the tiles of this tensor
+
+      /// This function will evaluate the children of this distributed evaluator
+      /// and evaluate the tiles for this distributed evaluator. It will block
+      /// until the tasks for the children are evaluated (not for the tasks of
+      /// this object).
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        // Start evaluate child tensors
+        left_.eval();
+        right_.eval();
+
+        // Every tile is received once, so the caches are not bounded
+        left_cache_type left_tiles;
+        right_cache_type right_tiles;
+        left_tiles.capacity(std::numeric_limits<size_type>::max());
+        right_tiles.capacity(std::numeric_limits<size_type>::max());
+
+        // Send the local argument tiles to the owners of the result tiles
+        // they are contracted into
+        send(left_, [this] (const size_type index, std::vector<ProcessID>& dest) {
+              const size_type row = index / k_;
+              for(size_type col = 0ul, right_index = (index % k_) * cols_;
+                  col < cols_; ++col, ++right_index)
+              {
+                if(right_.is_zero(right_index)) continue;
+                const ProcessID owner = result_owner(row, col);
+                if(owner >= 0)
+                  dest.push_back(owner);
+              }
+            }, [this] (const size_type index) { return left_key(index); }, left_tiles);
+        send(right_, [this] (const size_type index, std::vector<ProcessID>& dest) {
+              const size_type col = index % cols_;
+              for(size_type row = 0ul, left_index = index / cols_; row < rows_;
+                  ++row, left_index += k_)
+              {
+                if(left_.is_zero(left_index)) continue;
+                const ProcessID owner = result_owner(row, col);
+                if(owner >= 0)
+                  dest.push_back(owner);
+              }
+            }, [this] (const size_type index) { return right_key(index); }, right_tiles);
+
+        const int tile_count = contract(left_tiles, right_tiles);
+
+        // Wait for child tensors to be evaluated, and process tasks while waiting.
+        left_.wait();
+        right_.wait();
+
+        return tile_count;
+      }
+
+    }; // class PullContraction
+
+  } // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_PULL_CONTRACTION_EVAL_H__INCLUDED
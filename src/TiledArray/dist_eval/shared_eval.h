@@ -0,0 +1,201 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SHARED_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SHARED_EVAL_H__INCLUDED
+
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <unordered_map>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Source of a distributed evaluator that has several consumers
+
+    /// The tiles of a distributed evaluator can be retrieved only once. This
+    /// object retrieves each local tile of the argument once, and hands it to
+    /// each of \c consumers consumers. A tile is released when the last
+    /// consumer has taken it, so the memory held for the consumers is bounded
+    /// by the tiles that some, but not all, consumers have taken.
+    /// \tparam Tile The tile type
+    /// \tparam Policy The tensor policy class
+    template <typename Tile, typename Policy>
+    class SharedEvalSource {
+    public:
+      typedef DistEval<Tile, Policy> arg_type; ///< Argument type
+      typedef typename arg_type::size_type size_type; ///< Size type
+      typedef typename arg_type::value_type value_type; ///< Tile type
+
+    private:
+
+      /// A tile that was not yet taken by all consumers
+      struct Entry {
+        Future<value_type> tile; ///< The tile
+        unsigned int remaining; ///< The number of consumers that did not take the tile
+      }; // struct Entry
+
+      arg_type arg_; ///< The shared argument
+      const unsigned int consumers_; ///< The number of consumers
+      madness::Spinlock lock_; ///< Protects \c evaluated_ and \c tiles_
+      bool evaluated_; ///< \c true when \c arg_ was evaluated
+      std::unordered_map<size_type, Entry> tiles_; ///< Tiles held for consumers
+
+    public:
+
+      /// Constructor
+
+      /// \param arg The shared argument
+      /// \param consumers The number of consumers of \c arg
+      SharedEvalSource(const arg_type& arg, const unsigned int consumers) :
+        arg_(arg), consumers_(consumers), lock_(), evaluated_(false), tiles_()
+      {
+        TA_ASSERT(consumers_ > 1u);
+      }
+
+      /// Destructor
+
+      /// The consumers release their views as soon as they are evaluated, so
+      /// the argument may still be setting its tiles; wait for it before it
+      /// is freed.
+      ~SharedEvalSource() {
+        if(evaluated_)
+          arg_.wait();
+      }
+
+      /// Argument accessor
+
+      /// \return A const reference to the shared argument
+      const arg_type& arg() const { return arg_; }
+
+      /// Evaluate the argument, if it was not evaluated by another consumer
+      void eval() {
+        bool evaluate = false;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+          evaluate = ! evaluated_;
+          evaluated_ = true;
+        }
+        if(evaluate)
+          arg_.eval();
+      }
+
+      /// Take a tile for a consumer
+
+      /// \param i The index of a local, non-zero tile
+      /// \return A future to tile \c i
+      Future<value_type> get(const size_type i) {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        auto it = tiles_.find(i);
+        if(it == tiles_.end())
+          it = tiles_.emplace(i, Entry{ arg_.get(i), consumers_ }).first;
+
+        Future<value_type> result = it->second.tile;
+        if(--it->second.remaining == 0u)
+          tiles_.erase(it);
+
+        return result;
+      }
+
+    }; // class SharedEvalSource
+
+    /// Consumer view of a shared distributed evaluator
+
+    /// Each consumer of a common subexpression evaluates its own view, which
+    /// sets the tiles of the shared source without copying them.
+    /// \tparam Tile The tile type
+    /// \tparam Policy The tensor policy class
+    template <typename Tile, typename Policy>
+    class SharedEvalImpl :
+      public DistEvalImpl<Tile, Policy>,
+      public std::enable_shared_from_this<SharedEvalImpl<Tile, Policy> >
+    {
+    public:
+      typedef SharedEvalImpl<Tile, Policy> SharedEvalImpl_; ///< This object type
+      typedef DistEvalImpl<Tile, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef SharedEvalSource<Tile, Policy> source_type; ///< The shared source type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+
+    private:
+
+      std::shared_ptr<source_type> source_; ///< The shared source
+
+    public:
+
+      /// Constructor
+
+      /// \param source The shared source
+      SharedEvalImpl(const std::shared_ptr<source_type>& source) :
+        DistEvalImpl_(source->arg().world(), source->arg().trange(),
+            source->arg().shape(), source->arg().pmap(), Permutation()),
+        source_(source)
+      { }
+
+      virtual ~SharedEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::world().gop.template recv<value_type>(
+            TensorImpl_::owner(i), key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Set the local tiles of this view from the shared source
+
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        source_->eval();
+
+        size_type task_count = 0ul;
+        typename pmap_interface::const_iterator it = TensorImpl_::pmap()->begin();
+        const typename pmap_interface::const_iterator end = TensorImpl_::pmap()->end();
+        for(; it != end; ++it) {
+          const size_type index = *it;
+          if(! TensorImpl_::is_zero(index)) {
+            DistEvalImpl_::set_tile(index, source_->get(index));
+            ++task_count;
+          }
+        }
+
+        return task_count;
+      }
+
+    }; // class SharedEvalImpl
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SHARED_EVAL_H__INCLUDED
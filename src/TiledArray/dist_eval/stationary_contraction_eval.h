@@ -0,0 +1,490 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_STATIONARY_CONTRACTION_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_STATIONARY_CONTRACTION_EVAL_H__INCLUDED
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/dist_eval/partial_reduce_op.h>
+#include <TiledArray/reduce_task.h>
+#include <TiledArray/type_traits.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Operand-stationary distributed contraction evaluator
+
+    /// SUMMA keeps the result stationary and moves both arguments. When one
+    /// of the arguments is much larger than the other argument and the
+    /// result, it is cheaper to leave that argument where it is and move the
+    /// other two. In the keep-left mode, each non-zero tile of the right-hand
+    /// argument is sent once to every process that holds a left-hand tile it
+    /// is contracted with; each process contracts its local left-hand tiles
+    /// into partial result tiles, which are then reduced onto the owners of
+    /// the result tiles. The keep-right mode is the same with the roles of
+    /// the arguments exchanged. Only tile pairs that contribute to non-zero
+    /// result tiles are moved and contracted.
+    /// \tparam Left The left-hand argument evaluator type
+    /// \tparam Right The right-hand argument evaluator type
+    /// \tparam Op The contraction/reduction operation type
+    /// \tparam Policy The tensor policy class
+    /// \note The arguments may have any distribution; the tiles of the
+    /// stationary argument are contracted by the process that owns them.
+    template <typename Left, typename Right, typename Op, typename Policy>
+    class StationaryContraction :
+        public DistEvalImpl<typename Op::result_type, Policy>
+    {
+    public:
+      typedef StationaryContraction<Left, Right, Op, Policy> StationaryContraction_; ///< This object type
+      typedef DistEvalImpl<typename Op::result_type, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Left left_type; ///< The left-hand argument type
+      typedef Right right_type; ///< The right-hand argument type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::range_type range_type; ///< Range type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+      typedef typename DistEvalImpl_::eval_type eval_type; ///< Tile evaluation type
+      typedef Op op_type; ///< Tile evaluation operator type
+
+    private:
+
+      typedef Future<typename right_type::eval_type> right_future; ///< Future to a right-hand argument tile
+      typedef Future<typename left_type::eval_type> left_future; ///< Future to a left-hand argument tile
+
+      // Arguments and operation
+      left_type left_; ///< The left-hand argument
+      right_type right_; /// < The right-hand argument
+      op_type op_; /// < The operation used to evaluate tile-tile contractions
+
+      // Dimension information
+      const size_type k_; ///< Number of tiles in the inner dimension
+      const size_type rows_; ///< Number of tile rows of the result
+      const size_type cols_; ///< Number of tile columns of the result
+      const bool keep_left_; ///< Keep the left- (true) or right-hand (false) argument stationary
+
+      /// Tile conversion task function
+
+      /// \tparam Tile The input tile type
+      /// \param tile The input tile
+      /// \return The evaluated version of the lazy tile
+      template <typename Tile>
+      static auto convert_tile(const Tile& tile) {
+        TiledArray::Cast<typename eval_trait<Tile>::type, Tile> cast;
+        return cast(tile);
+      }
+
+      /// Conversion function
+
+      /// This function does nothing since tile is not a lazy tile.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return \c tile
+      template <typename Arg>
+      static typename std::enable_if<
+          ! is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_tile(Arg& arg, const typename Arg::size_type index) { return arg.get(index); }
+
+      /// Conversion function
+
+      /// This function spawns a task that will convert a lazy tile from the
+      /// tile type to the evaluated tile type.
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return A future to the evaluated tile
+      template <typename Arg>
+      static typename std::enable_if<
+          is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_tile(Arg& arg, const typename Arg::size_type index) {
+        auto convert_tile_fn =
+            &StationaryContraction_::template convert_tile<typename Arg::value_type>;
+        return arg.world().taskq.add(convert_tile_fn, arg.get(index),
+                                     madness::TaskAttributes::hipri());
+      }
+
+      /// Check that a result tile is needed
+
+      /// \param row The result tile row
+      /// \param col The result tile column
+      /// \return \c true if the result tile at (\c row, \c col ) is non-zero
+      bool is_result_needed(const size_type row, const size_type col) const {
+        return ! TensorImpl_::is_zero(
+            DistEvalImpl_::perm_index_to_target(row * cols_ + col));
+      }
+
+      /// Key of a moved argument tile
+
+      /// Keys of moved tiles follow the keys of the result tiles.
+      /// \param index The index of the moved tile in its argument
+      /// \return The message key of the moved tile
+      madness::DistributedID move_key(const size_type index) const {
+        return madness::DistributedID(DistEvalImpl_::id(),
+            TensorImpl_::size() + index);
+      }
+
+      /// Key of a partial result tile
+
+      /// Keys of partial results follow the keys of the moved tiles, and
+      /// include the sending process so they are unique on the receiver.
+      /// \param source The process that contracted the partial result
+      /// \param index The (unpermuted) index of the result tile
+      /// \return The message key of the partial result
+      madness::DistributedID partial_key(const ProcessID source,
+          const size_type index) const
+      {
+        const size_type moved_size = (keep_left_ ? right_.size() : left_.size());
+        return madness::DistributedID(DistEvalImpl_::id(), TensorImpl_::size()
+            + moved_size + size_type(source) * TensorImpl_::size() + index);
+      }
+
+      /// Send the local tiles of the right-hand argument (keep-left mode)
+
+      /// Each non-zero local tile is sent to the processes that own a
+      /// left-hand tile it is contracted with into a non-zero result tile.
+      /// \param[out] local_tiles The moved tiles that are used by this process
+      void move_right(std::unordered_map<size_type, right_future>& local_tiles) {
+        World& world = TensorImpl_::world();
+        std::vector<ProcessID> dest;
+        for(auto it = right_.pmap()->begin(); it != right_.pmap()->end(); ++it) {
+          const size_type index = *it;
+          if(right_.is_zero(index)) continue;
+          const size_type k = index / cols_;
+          const size_type col = index % cols_;
+
+          dest.clear();
+          for(size_type row = 0ul, left_index = k; row < rows_; ++row, left_index += k_)
+            if(! left_.is_zero(left_index) && is_result_needed(row, col))
+              dest.push_back(left_.owner(left_index));
+          std::sort(dest.begin(), dest.end());
+          dest.erase(std::unique(dest.begin(), dest.end()), dest.end());
+
+          if(dest.empty()) {
+            right_.discard(index);
+            continue;
+          }
+
+          right_future tile = get_tile(right_, index);
+          for(const ProcessID p : dest) {
+            if(p == world.rank())
+              local_tiles.emplace(index, tile);
+            else
+              world.gop.send(p, move_key(index), tile);
+          }
+        }
+      }
+
+      /// Send the local tiles of the left-hand argument (keep-right mode)
+
+      /// Each non-zero local tile is sent to the processes that own a
+      /// right-hand tile it is contracted with into a non-zero result tile.
+      /// \param[out] local_tiles The moved tiles that are used by this process
+      void move_left(std::unordered_map<size_type, left_future>& local_tiles) {
+        World& world = TensorImpl_::world();
+        std::vector<ProcessID> dest;
+        for(auto it = left_.pmap()->begin(); it != left_.pmap()->end(); ++it) {
+          const size_type index = *it;
+          if(left_.is_zero(index)) continue;
+          const size_type row = index / k_;
+          const size_type k = index % k_;
+
+          dest.clear();
+          for(size_type col = 0ul, right_index = k * cols_; col < cols_; ++col, ++right_index)
+            if(! right_.is_zero(right_index) && is_result_needed(row, col))
+              dest.push_back(right_.owner(right_index));
+          std::sort(dest.begin(), dest.end());
+          dest.erase(std::unique(dest.begin(), dest.end()), dest.end());
+
+          if(dest.empty()) {
+            left_.discard(index);
+            continue;
+          }
+
+          left_future tile = get_tile(left_, index);
+          for(const ProcessID p : dest) {
+            if(p == world.rank())
+              local_tiles.emplace(index, tile);
+            else
+              world.gop.send(p, move_key(index), tile);
+          }
+        }
+      }
+
+      /// Get a moved tile
+
+      /// \tparam Arg The moved argument type
+      /// \param arg The moved argument
+      /// \param index The index of the moved tile
+      /// \param tiles The moved tiles received by this process
+      /// \return A future to the moved tile
+      template <typename Arg>
+      Future<typename Arg::eval_type> moved_tile(const Arg& arg, const size_type index,
+          std::unordered_map<size_type, Future<typename Arg::eval_type> >& tiles) const
+      {
+        auto it = tiles.find(index);
+        if(it == tiles.end())
+          it = tiles.emplace(index, TensorImpl_::world().gop.template
+              recv<typename Arg::eval_type>(arg.owner(index), move_key(index))).first;
+        return it->second;
+      }
+
+      /// Contract the local tiles of the left-hand argument (keep-left mode)
+
+      /// \param right_tiles The right-hand tiles used by this process
+      /// \param[out] reduce_tasks The partial result reduction tasks
+      void contract_left(std::unordered_map<size_type, right_future>& right_tiles,
+          std::unordered_map<size_type, ReducePairTask<op_type> >& reduce_tasks)
+      {
+        World& world = TensorImpl_::world();
+        for(auto it = left_.pmap()->begin(); it != left_.pmap()->end(); ++it) {
+          const size_type index = *it;
+          if(left_.is_zero(index)) continue;
+          const size_type row = index / k_;
+          const size_type k = index % k_;
+
+          left_future tile;
+          bool used = false;
+          for(size_type col = 0ul, right_index = k * cols_; col < cols_; ++col, ++right_index) {
+            if(right_.is_zero(right_index) || ! is_result_needed(row, col)) continue;
+
+            if(! used) {
+              tile = get_tile(left_, index);
+              used = true;
+            }
+
+            auto task = reduce_tasks.find(row * cols_ + col);
+            if(task == reduce_tasks.end())
+              task = reduce_tasks.emplace(row * cols_ + col,
+                  ReducePairTask<op_type>(world, op_)).first;
+            task->second.add(tile, moved_tile(right_, right_index, right_tiles));
+          }
+
+          if(! used)
+            left_.discard(index);
+        }
+      }
+
+      /// Contract the local tiles of the right-hand argument (keep-right mode)
+
+      /// \param left_tiles The left-hand tiles used by this process
+      /// \param[out] reduce_tasks The partial result reduction tasks
+      void contract_right(std::unordered_map<size_type, left_future>& left_tiles,
+          std::unordered_map<size_type, ReducePairTask<op_type> >& reduce_tasks)
+      {
+        World& world = TensorImpl_::world();
+        for(auto it = right_.pmap()->begin(); it != right_.pmap()->end(); ++it) {
+          const size_type index = *it;
+          if(right_.is_zero(index)) continue;
+          const size_type k = index / cols_;
+          const size_type col = index % cols_;
+
+          right_future tile;
+          bool used = false;
+          for(size_type row = 0ul, left_index = k; row < rows_; ++row, left_index += k_) {
+            if(left_.is_zero(left_index) || ! is_result_needed(row, col)) continue;
+
+            if(! used) {
+              tile = get_tile(right_, index);
+              used = true;
+            }
+
+            auto task = reduce_tasks.find(row * cols_ + col);
+            if(task == reduce_tasks.end())
+              task = reduce_tasks.emplace(row * cols_ + col,
+                  ReducePairTask<op_type>(world, op_)).first;
+            task->second.add(moved_tile(left_, left_index, left_tiles), tile);
+          }
+
+          if(! used)
+            right_.discard(index);
+        }
+      }
+
+      /// Collect the processes that contribute to a result tile
+
+      /// \param row The result tile row
+      /// \param col The result tile column
+      /// \param[out] sources The processes that own the stationary tiles
+      /// contracted into the result tile at (\c row, \c col )
+      void contributors(const size_type row, const size_type col,
+          std::vector<ProcessID>& sources) const
+      {
+        sources.clear();
+        for(size_type k = 0ul, left_index = row * k_, right_index = col; k < k_;
+            ++k, ++left_index, right_index += cols_)
+        {
+          if(left_.is_zero(left_index) || right_.is_zero(right_index)) continue;
+          sources.push_back(keep_left_ ? left_.owner(left_index) :
+              right_.owner(right_index));
+        }
+        std::sort(sources.begin(), sources.end());
+        sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+      }
+
+      /// Reduce the partial results onto the owners of the result tiles
+
+      /// \param reduce_tasks The partial result reduction tasks of this process
+      /// \return The number of result tiles set by this process
+      int reduce_partials(std::unordered_map<size_type, ReducePairTask<op_type> >& reduce_tasks) {
+        World& world = TensorImpl_::world();
+        const ProcessID rank = world.rank();
+
+        // Send the partial results to the result tile owners
+        std::unordered_map<size_type, Future<value_type> > local_partials;
+        for(auto& task : reduce_tasks) {
+          const size_type index = task.first;
+          const ProcessID owner =
+              TensorImpl_::owner(DistEvalImpl_::perm_index_to_target(index));
+          if(owner == rank)
+            local_partials.emplace(index, task.second.submit());
+          else
+            world.gop.send(owner, partial_key(rank, index), task.second.submit());
+        }
+
+        // Reduce the partial results of the local result tiles
+        int tile_count = 0;
+        std::vector<ProcessID> sources;
+        for(auto it = TensorImpl_::pmap()->begin(); it != TensorImpl_::pmap()->end(); ++it) {
+          const size_type perm_index = *it;
+          if(TensorImpl_::is_zero(perm_index)) continue;
+          const size_type index = DistEvalImpl_::perm_index_to_source(perm_index);
+          contributors(index / cols_, index % cols_, sources);
+
+          if(sources.size() == 1ul && sources.front() == rank) {
+            // The result tile was contracted locally
+            DistEvalImpl_::set_tile(perm_index, local_partials[index]);
+          } else {
+            ReduceTask<PartialReduceOp<value_type> > reduce_task(world,
+                PartialReduceOp<value_type>());
+            for(const ProcessID source : sources) {
+              if(source == rank)
+                reduce_task.add(local_partials[index]);
+              else
+                reduce_task.add(world.gop.template recv<value_type>(source,
+                    partial_key(source, index)));
+            }
+            DistEvalImpl_::set_tile(perm_index, reduce_task.submit());
+          }
+          ++tile_count;
+        }
+
+        return tile_count;
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param left The left-hand argument evaluator
+      /// \param right The right-hand argument evaluator
+      /// \param world The world where the result lives
+      /// \param trange The tiled range object for the result
+      /// \param shape The tensor shape object for the result
+      /// \param pmap The tile-process map for the result
+      /// \param perm The permutation that is applied to result tile indices
+      /// \param op The tile transform operation
+      /// \param k The number of tiles in the inner dimension
+      /// \param keep_left If \c true, the left-hand argument is stationary;
+      /// otherwise the right-hand argument is stationary
+      /// \note The trange, shape, and pmap refer to the final, permuted, state
+      /// for the result.
+      StationaryContraction(const left_type& left, const right_type& right,
+          World& world, const trange_type trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm,
+          const op_type& op, const size_type k, const bool keep_left) :
+        DistEvalImpl_(world, trange, shape, pmap, perm),
+        left_(left), right_(right), op_(op),
+        k_(k), rows_(left.size() / k), cols_(right.size() / k),
+        keep_left_(keep_left)
+      { }
+
+      virtual ~StationaryContraction() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+        const madness::DistributedID key(DistEvalImpl_::id(), i);
+        return TensorImpl_::world().gop.template recv<value_type>(
+            TensorImpl_::owner(i), key);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Evaluate the tiles of this tensor
+
+      /// This function will evaluate the children of this distributed evaluator
+      /// and evaluate the tiles for this distributed evaluator. It will block
+      /// until the tasks for the children are evaluated (not for the tasks of
+      /// this object).
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        // Start evaluate child tensors
+        left_.eval();
+        right_.eval();
+
+        // Move the non-stationary argument and contract the local tiles of
+        // the stationary argument
+        std::unordered_map<size_type, ReducePairTask<op_type> > reduce_tasks;
+        if(keep_left_) {
+          std::unordered_map<size_type, right_future> right_tiles;
+          move_right(right_tiles);
+          contract_left(right_tiles, reduce_tasks);
+        } else {
+          std::unordered_map<size_type, left_future> left_tiles;
+          move_left(left_tiles);
+          contract_right(left_tiles, reduce_tasks);
+        }
+
+        const int tile_count = reduce_partials(reduce_tasks);
+
+        // Wait for child tensors to be evaluated, and process tasks while waiting.
+        left_.wait();
+        right_.wait();
+
+        return tile_count;
+      }
+
+    }; // class StationaryContraction
+
+  } // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_STATIONARY_CONTRACTION_EVAL_H__INCLUDED
@@ -0,0 +1,201 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_DEPTH_CONTROLLER_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_DEPTH_CONTROLLER_H__INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <TiledArray/error.h>
+#include <TiledArray/tensor/memory_tracker.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Memory-aware controller for the number of concurrent SUMMA iterations
+
+    /// The controller tracks the memory held by the tiles of SUMMA steps that
+    /// are in flight (broadcast but not yet contracted) and by the result
+    /// tiles held in reduce tasks. Each time a step starts, \c update()
+    /// compares the tracked memory with the memory limit and decides whether
+    /// the pipeline should be narrowed by one step, widened by one step, or
+    /// left unchanged; the depth is kept in the range
+    /// <tt>[1, max_depth]</tt>. When the memory limit is zero the depth is
+    /// never changed. The tracked memory is an estimate; when the tensor
+    /// memory of the process has grown more since \c init() (e.g. by
+    /// received broadcast buffers or by concurrent evaluations), the
+    /// measured growth is used instead.
+    class SummaDepthController {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      std::atomic<size_type> step_memory_; ///< Memory held by in-flight step tiles
+      std::atomic<size_type> result_memory_; ///< Memory held by result tiles of reduce tasks
+      size_type max_memory_; ///< The memory limit (zero = no limit)
+      size_type depth_; ///< Current number of concurrent SUMMA iterations
+      size_type max_depth_; ///< Maximum number of concurrent SUMMA iterations
+      size_type steps_; ///< Number of steps that have started
+      size_type avg_step_memory_; ///< Average memory of a step
+      size_type baseline_memory_; ///< Tensor memory of the process at \c init()
+      bool narrowed_; ///< The depth has been below the maximum depth
+
+      static std::atomic<size_type>& narrowed_count() {
+        static std::atomic<size_type> count(0ul);
+        return count;
+      }
+
+      /// Record that the depth is below the maximum depth
+      void set_narrowed() {
+        if(narrowed_)
+          return;
+        narrowed_ = true;
+        narrowed_count().fetch_add(1ul, std::memory_order_relaxed);
+      }
+
+    public:
+
+      /// Default constructor
+
+      /// Constructs an inactive controller with depth 1.
+      SummaDepthController() :
+        step_memory_(0ul), result_memory_(0ul), max_memory_(0ul), depth_(1ul),
+        max_depth_(1ul), steps_(0ul), avg_step_memory_(0ul),
+        baseline_memory_(0ul), narrowed_(false)
+      { }
+
+      SummaDepthController(const SummaDepthController&) = delete;
+      SummaDepthController& operator=(const SummaDepthController&) = delete;
+
+      /// Initialize the controller
+
+      /// \param max_memory The memory limit in bytes, or zero for no limit
+      /// \param depth The initial number of concurrent iterations
+      /// \param max_depth The maximum number of concurrent iterations
+      void init(const size_type max_memory, const size_type depth,
+          const size_type max_depth)
+      {
+        TA_ASSERT(depth >= 1ul);
+        TA_ASSERT(depth <= max_depth);
+        max_memory_ = max_memory;
+        depth_ = depth;
+        max_depth_ = max_depth;
+        steps_ = 0ul;
+        avg_step_memory_ = 0ul;
+        baseline_memory_ = MemoryTracker::instance().live_bytes();
+        narrowed_ = false;
+        if(active() && (depth < max_depth))
+          set_narrowed();
+      }
+
+      /// Narrowed pipeline counter
+
+      /// \return The number of SUMMA pipelines of this process whose depth
+      /// was reduced below the maximum depth by a memory limit, either at
+      /// \c init() or by \c update()
+      static size_type narrowed_pipelines() {
+        return narrowed_count().load(std::memory_order_relaxed);
+      }
+
+      /// Check for an active memory limit
+
+      /// \return \c true if the depth is adjusted to satisfy a memory limit
+      bool active() const { return max_memory_ != 0ul; }
+
+      /// Memory limit accessor
+
+      /// \return The memory limit in bytes, or zero if there is no limit
+      size_type max_memory() const { return max_memory_; }
+
+      /// Current depth accessor
+
+      /// \return The current number of concurrent iterations
+      size_type depth() const { return depth_; }
+
+      /// Maximum depth accessor
+
+      /// \return The maximum number of concurrent iterations
+      size_type max_depth() const { return max_depth_; }
+
+      /// Tracked memory accessor
+
+      /// \return The memory, in bytes, currently held by in-flight step tiles
+      /// and result tiles
+      size_type memory() const { return step_memory_ + result_memory_; }
+
+      /// Measured memory accessor
+
+      /// \return The growth of the tensor memory of this process since
+      /// \c init()
+      size_type measured_memory() const {
+        const size_type live = MemoryTracker::instance().live_bytes();
+        return (live > baseline_memory_ ? live - baseline_memory_ : 0ul);
+      }
+
+      /// Record memory allocated for a result tile
+      void acquire_result(const size_type bytes) { result_memory_ += bytes; }
+
+      /// Release the memory of a step whose tiles have been contracted
+
+      /// \param bytes The memory held by the tiles of the step
+      void release_step(const size_type bytes) {
+        TA_ASSERT(step_memory_ >= bytes);
+        step_memory_ -= bytes;
+      }
+
+      /// Start a step and select the depth of the pipeline
+
+      /// Records the memory of the tiles for the starting step and adjusts the
+      /// depth. The pipeline is narrowed when starting another step of average
+      /// size would exceed the memory limit, and widened when two more steps
+      /// would fit.
+      /// \param bytes The memory held by the tiles of the starting step
+      /// \return -1 if the pipeline should be narrowed by one step, 1 if it
+      /// should be widened by one step, otherwise 0
+      int update(const size_type bytes) {
+        step_memory_ += bytes;
+
+        if(! active())
+          return 0;
+
+        // Update the running average of the step size
+        avg_step_memory_ = (avg_step_memory_ * steps_ + bytes) / (steps_ + 1ul);
+        ++steps_;
+
+        const size_type used = std::max(memory(), measured_memory());
+        if(((used + avg_step_memory_) > max_memory_) && (depth_ > 1ul)) {
+          --depth_;
+          set_narrowed();
+          return -1;
+        }
+        if(((used + 2ul * avg_step_memory_) <= max_memory_) && (depth_ < max_depth_)) {
+          ++depth_;
+          return 1;
+        }
+
+        return 0;
+      }
+
+    }; // class SummaDepthController
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_DEPTH_CONTROLLER_H__INCLUDED
@@ -0,0 +1,289 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_GROUP_CACHE_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_GROUP_CACHE_H__INCLUDED
+
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Cache of the sparse broadcast groups of SUMMA contractions
+
+    /// Constructing the broadcast groups of a sparse SUMMA requires a scan of
+    /// the argument and result shapes for every iteration. Contractions that
+    /// are evaluated repeatedly with the same shapes and process grid, e.g.
+    /// in iterative solvers, produce the same groups each time. This cache
+    /// keeps the groups of recently evaluated contractions of each world,
+    /// keyed on the dimensions and process grid of the contraction and on
+    /// the zero tiles of the arguments and the result (in the order of the
+    /// contraction, i.e. including the permutation), so subsequent
+    /// evaluations reuse them. The full key is stored with an entry and
+    /// compared on lookup, so contractions whose keys have the same hash do
+    /// not share groups.
+    ///
+    /// The groups in an entry are identified by the id of the evaluator that
+    /// created the entry, so all processes must agree on whether an entry is
+    /// found. This holds because entries are looked up and evicted (least
+    /// recently used first) only by the collective evaluation of
+    /// contractions, which every process of the world performs in the same
+    /// order. The entries of each world are cached separately, so the
+    /// contractions of one world do not evict those of another. The number
+    /// of entries per world is set with the \c TA_SUMMA_GROUP_CACHE_SIZE
+    /// environment variable [ default = 16 ]; zero disables the cache.
+    class SummaGroupCache {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+      /// The key of a contraction
+      class Key {
+        unsigned long world_; ///< The id of the world of the contraction
+        std::vector<size_type> dims_; ///< The dimensions and process grid
+        std::vector<bool> zero_; ///< The zero tile flags
+        madness::hashT hash_; ///< The hash of the key
+
+      public:
+
+        /// Constructor
+
+        /// \param world The id of the world of the contraction
+        /// \param dims The dimensions and process grid of the contraction
+        /// \param zero The zero tile flags of the arguments and the result
+        Key(const unsigned long world, std::vector<size_type> dims,
+            std::vector<bool> zero) :
+          world_(world), dims_(std::move(dims)), zero_(std::move(zero)),
+          hash_(0ul)
+        {
+          for(const size_type dim : dims_)
+            madness::hash_combine(hash_, dim);
+          madness::hash_combine(hash_, std::hash<std::vector<bool> >()(zero_));
+        }
+
+        /// World id accessor
+
+        /// \return The id of the world of the contraction
+        unsigned long world() const { return world_; }
+
+        /// Hash accessor
+
+        /// \return The hash of the key
+        madness::hashT hash() const { return hash_; }
+
+        /// Key comparison
+
+        /// \param other The other key
+        /// \return \c true if the keys are equal
+        bool operator==(const Key& other) const {
+          return (hash_ == other.hash_) && (world_ == other.world_) &&
+              (dims_ == other.dims_) && (zero_ == other.zero_);
+        }
+      }; // class Key
+
+      typedef Key key_type; ///< Cache key type
+
+      /// The broadcast groups of one contraction
+      class Entry : private madness::Spinlock {
+        const madness::uniqueidT id_; ///< The id used to identify the groups
+        std::vector<madness::Group> row_groups_; ///< Row groups of each iteration
+        std::vector<madness::Group> col_groups_; ///< Column groups of each iteration
+        std::vector<char> has_row_group_; ///< Flags the row groups that have been constructed
+        std::vector<char> has_col_group_; ///< Flags the column groups that have been constructed
+
+        template <typename Op>
+        madness::Group get(std::vector<madness::Group>& groups,
+            std::vector<char>& flags, const size_type k, const Op& op)
+        {
+          TA_ASSERT(k < groups.size());
+          {
+            madness::ScopedMutex<madness::Spinlock> locker(this);
+            if(flags[k])
+              return groups[k];
+          }
+
+          // Construct the group outside the lock
+          madness::Group group = op(id_);
+
+          madness::ScopedMutex<madness::Spinlock> locker(this);
+          if(! flags[k]) {
+            groups[k] = group;
+            flags[k] = 1;
+          }
+          return groups[k];
+        }
+
+      public:
+
+        /// Constructor
+
+        /// \param id The id used to identify the groups of this entry
+        /// \param k The number of iterations of the contraction
+        Entry(const madness::uniqueidT& id, const size_type k) :
+          madness::Spinlock(), id_(id), row_groups_(k), col_groups_(k),
+          has_row_group_(k, 0), has_col_group_(k, 0)
+        { }
+
+        /// Group id accessor
+
+        /// \return The id that identifies the groups of this entry
+        const madness::uniqueidT& id() const { return id_; }
+
+        /// Get the row group of an iteration
+
+        /// \tparam Op The group factory type
+        /// \param k The iteration index
+        /// \param op The factory that constructs the group from the group id
+        /// when it is not cached
+        /// \return The row group of iteration \c k
+        template <typename Op>
+        madness::Group row_group(const size_type k, const Op& op) {
+          return get(row_groups_, has_row_group_, k, op);
+        }
+
+        /// Get the column group of an iteration
+
+        /// \tparam Op The group factory type
+        /// \param k The iteration index
+        /// \param op The factory that constructs the group from the group id
+        /// when it is not cached
+        /// \return The column group of iteration \c k
+        template <typename Op>
+        madness::Group col_group(const size_type k, const Op& op) {
+          return get(col_groups_, has_col_group_, k, op);
+        }
+      }; // class Entry
+
+    private:
+
+      typedef std::list<std::pair<key_type, std::shared_ptr<Entry> > > list_type;
+
+      static size_type init_capacity() {
+        const char* capacity = getenv("TA_SUMMA_GROUP_CACHE_SIZE");
+        if(capacity)
+          return std::stoul(capacity);
+        return 16ul;
+      }
+
+      static std::mutex& mutex() {
+        static std::mutex mtx;
+        return mtx;
+      }
+
+      static std::map<unsigned long, list_type>& entries() {
+        static std::map<unsigned long, list_type> lists;
+        return lists;
+      }
+
+    public:
+
+      /// Cache capacity accessor
+
+      /// \return The maximum number of cached contractions of a world
+      static size_type capacity() {
+        static const size_type capacity = init_capacity();
+        return capacity;
+      }
+
+      /// Find or insert a cache entry
+
+      /// \param key The key of the contraction
+      /// \param id The id used to identify the groups if a new entry is
+      /// inserted
+      /// \param k The number of iterations of the contraction
+      /// \return The cache entry for \c key, or an empty pointer if the cache
+      /// is disabled
+      static std::shared_ptr<Entry>
+      find(const key_type& key, const madness::uniqueidT& id, const size_type k) {
+        if(capacity() == 0ul)
+          return std::shared_ptr<Entry>();
+
+        std::lock_guard<std::mutex> lock(mutex());
+        list_type& list = entries()[key.world()];
+
+        // Move a cached entry to the front of the list
+        for(auto it = list.begin(); it != list.end(); ++it) {
+          if(it->first == key) {
+            list.splice(list.begin(), list, it);
+            return list.front().second;
+          }
+        }
+
+        // Insert a new entry and evict the least recently used entry
+        list.emplace_front(key, std::make_shared<Entry>(id, k));
+        if(list.size() > capacity())
+          list.pop_back();
+        return list.front().second;
+      }
+
+      /// Remove all cached groups
+
+      /// \note This must be called collectively, since subsequent
+      /// contractions will not find the removed entries.
+      static void clear() {
+        std::lock_guard<std::mutex> lock(mutex());
+        entries().clear();
+      }
+
+      /// Remove the cached groups of a world
+
+      /// \param world The id of the world
+      /// \note This must be called collectively by the processes of the
+      /// world, e.g. before it is destroyed.
+      static void clear(const unsigned long world) {
+        std::lock_guard<std::mutex> lock(mutex());
+        entries().erase(world);
+      }
+
+      /// Number of cached contractions
+
+      /// \return The number of cached contractions of all worlds
+      static size_type size() {
+        std::lock_guard<std::mutex> lock(mutex());
+        size_type result = 0ul;
+        for(const auto& list : entries())
+          result += list.second.size();
+        return result;
+      }
+
+      /// Number of cached contractions of a world
+
+      /// \param world The id of the world
+      /// \return The number of cached contractions of \c world
+      static size_type size(const unsigned long world) {
+        std::lock_guard<std::mutex> lock(mutex());
+        const auto it = entries().find(world);
+        return (it == entries().end() ? 0ul : it->second.size());
+      }
+
+    }; // class SummaGroupCache
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_GROUP_CACHE_H__INCLUDED
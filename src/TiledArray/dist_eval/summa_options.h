@@ -0,0 +1,50 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_OPTIONS_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_OPTIONS_H__INCLUDED
+
+#include <cstddef>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Per-contraction options of \c Summa
+
+    /// The default values select the process-wide settings, i.e. the
+    /// \c TA_SUMMA_MAX_MEMORY and \c TA_SUMMA_MAX_DEPTH limits, with all
+    /// optional pipeline features disabled.
+    struct SummaOptions {
+      SummaOptions() :
+        max_memory(0ul), max_depth(0u), work_order(false), batch(false),
+        prefetch(false), node_bcast(false)
+      { }
+
+      std::size_t max_memory; ///< Memory limit per node in bytes (0 = TA_SUMMA_MAX_MEMORY)
+      unsigned int max_depth; ///< Maximum number of concurrent iterations (0 = TA_SUMMA_MAX_DEPTH)
+      bool work_order; ///< Visit sparse iterations in order of decreasing work
+      bool batch; ///< Contract the tile pairs of each step row in a single task
+      bool prefetch; ///< Post the panel broadcasts before their step runs
+      bool node_bcast; ///< Broadcast panels between nodes, then within each node
+    }; // struct SummaOptions
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_OPTIONS_H__INCLUDED
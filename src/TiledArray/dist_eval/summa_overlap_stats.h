@@ -0,0 +1,95 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_OVERLAP_STATS_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_OVERLAP_STATS_H__INCLUDED
+
+#include <atomic>
+#include <cstddef>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Communication/computation overlap counters of SUMMA
+
+    /// When a SUMMA step starts, the tiles it received from other processes
+    /// are counted, together with the number of those tiles that had already
+    /// arrived. The ratio of the two is the fraction of the panel broadcasts
+    /// that was hidden behind the contractions of earlier steps. The counters
+    /// are accumulated over all contractions of this process until
+    /// \c reset() is called.
+    class SummaOverlapStats {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      static std::atomic<size_type>& received() {
+        static std::atomic<size_type> count(0ul);
+        return count;
+      }
+
+      static std::atomic<size_type>& ready() {
+        static std::atomic<size_type> count(0ul);
+        return count;
+      }
+
+    public:
+
+      /// Record the received tiles of a step
+
+      /// \param received_tiles The number of tiles received by the step
+      /// \param ready_tiles The number of received tiles that had arrived when
+      /// the step started
+      static void record(const size_type received_tiles, const size_type ready_tiles) {
+        received() += received_tiles;
+        ready() += ready_tiles;
+      }
+
+      /// Received tile count accessor
+
+      /// \return The number of tiles received by SUMMA steps
+      static size_type received_tiles() { return received(); }
+
+      /// Ready tile count accessor
+
+      /// \return The number of received tiles that had arrived when their
+      /// step started
+      static size_type ready_tiles() { return ready(); }
+
+      /// Overlap ratio
+
+      /// \return The fraction of received tiles that arrived before their step
+      /// started, or 1 if no tiles were received
+      static double ratio() {
+        const size_type total = received();
+        return (total ? double(ready()) / double(total) : 1.0);
+      }
+
+      /// Reset the counters
+      static void reset() {
+        received() = 0ul;
+        ready() = 0ul;
+      }
+
+    }; // class SummaOverlapStats
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_OVERLAP_STATS_H__INCLUDED
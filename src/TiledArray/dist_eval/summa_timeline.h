@@ -0,0 +1,172 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_TIMELINE_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_TIMELINE_H__INCLUDED
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <TiledArray/error.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Timeline of the stages of SUMMA contractions
+
+    /// When TiledArray is configured with \c TA_TRACE_SUMMA=ON
+    /// ( \c TILEDARRAY_ENABLE_SUMMA_TIMELINE ), \c Summa records an event for
+    /// each stage of each iteration on each process:
+    /// - \c step : the step task that posts the broadcasts and contractions
+    ///   of an iteration
+    /// - \c bcast : from the start of the step until all of its tiles have
+    ///   arrived; \c bytes is the size of the tiles received from other
+    ///   processes
+    /// - \c contract : from the start of the step until its tile contractions
+    ///   (or batches, see \c Expr::set_summa_batch() ) are done; \c flops is
+    ///   the work of those contractions
+    /// - \c finalize : setting the result tiles; \c k is the number of
+    ///   iterations
+    ///
+    /// Otherwise nothing is recorded and the instrumentation is compiled
+    /// out. The events of this process are written in the Chrome trace event
+    /// format (JSON), with the process rank as \c pid , so the files of all
+    /// processes can be loaded together in a trace viewer.
+    class SummaTimeline {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+      /// Timeline event
+      struct Event {
+        const char* stage; ///< The stage name
+        unsigned long contraction; ///< The object id of the contraction evaluator
+        int rank; ///< The rank of the process
+        size_type k; ///< The inner index of the iteration
+        std::size_t thread; ///< The hash of the thread id
+        double begin; ///< The start time, in seconds
+        double end; ///< The end time, in seconds
+        size_type bytes; ///< The number of bytes received
+        double flops; ///< The number of floating point operations
+      }; // struct Event
+
+    private:
+
+      static std::mutex& mutex() {
+        static std::mutex mtx;
+        return mtx;
+      }
+
+      static std::vector<Event>& all_events() {
+        static std::vector<Event> events;
+        return events;
+      }
+
+    public:
+
+      /// Timeline clock
+
+      /// \return The wall time, in seconds
+      static double now() {
+        return std::chrono::duration<double>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+      }
+
+      /// Record an event
+
+      /// \param stage The stage name
+      /// \param contraction The object id of the contraction evaluator
+      /// \param rank The rank of this process
+      /// \param k The inner index of the iteration
+      /// \param begin The start time of the event
+      /// \param bytes The number of bytes received [ default = 0 ]
+      /// \param flops The number of floating point operations [ default = 0 ]
+      static void record(const char* stage, const unsigned long contraction,
+          const int rank, const size_type k, const double begin,
+          const size_type bytes = 0ul, const double flops = 0.0)
+      {
+        const Event event = { stage, contraction, rank, k,
+            std::hash<std::thread::id>()(std::this_thread::get_id()),
+            begin, now(), bytes, flops };
+        std::lock_guard<std::mutex> lock(mutex());
+        all_events().push_back(event);
+      }
+
+      /// Events accessor
+
+      /// \return A copy of the events recorded by this process
+      static std::vector<Event> events() {
+        std::lock_guard<std::mutex> lock(mutex());
+        return all_events();
+      }
+
+      /// Remove all recorded events
+      static void clear() {
+        std::lock_guard<std::mutex> lock(mutex());
+        all_events().clear();
+      }
+
+      /// Write the events in the Chrome trace event format
+
+      /// \param os The output stream
+      static void write(std::ostream& os) {
+        const std::vector<Event> list = events();
+        const std::ios::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << "{\"traceEvents\":[";
+        const char* separator = "\n";
+        for(const Event& event : list) {
+          os << separator << std::fixed << std::setprecision(3)
+             << "{\"name\":\"" << event.stage << "\",\"cat\":\"summa\",\"ph\":\"X\""
+             << ",\"pid\":" << event.rank << ",\"tid\":" << event.thread
+             << ",\"ts\":" << event.begin * 1.0e6
+             << ",\"dur\":" << (event.end - event.begin) * 1.0e6
+             << ",\"args\":{\"contraction\":" << event.contraction
+             << ",\"k\":" << event.k << ",\"bytes\":" << event.bytes
+             << ",\"flops\":" << std::setprecision(0) << event.flops << "}}";
+          separator = ",\n";
+        }
+        os << "\n]}\n";
+        os.flags(flags);
+        os.precision(precision);
+      }
+
+      /// Write the events to a file
+
+      /// \param filename The name of the output file
+      /// \throw TiledArray::Exception When the file cannot be opened
+      static void write(const std::string& filename) {
+        std::ofstream file(filename);
+        if(! file)
+          TA_EXCEPTION("Unable to open the SUMMA timeline file.");
+        write(file);
+      }
+
+    }; // class SummaTimeline
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_TIMELINE_H__INCLUDED
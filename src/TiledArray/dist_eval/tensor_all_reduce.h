@@ -0,0 +1,290 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_TENSOR_ALL_REDUCE_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_TENSOR_ALL_REDUCE_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+#include <TiledArray/task_priority.h>
+#include <TiledArray/math/vector_op.h>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Minimum size of the reduce-scatter all-reduce of all tensor types
+
+    /// \return A reference to the minimum number of elements (see
+    /// \c TensorAllReduce::min_elements() )
+    inline std::size_t& tensor_all_reduce_min_elements() {
+      static std::size_t min_elements = [] () {
+        const char* value = getenv("TA_TENSOR_ALL_REDUCE_MIN_ELEMENTS");
+        return (value ? std::stoul(value) : 65536ul);
+      }();
+      return min_elements;
+    }
+
+    /// All-reduce of large tensors
+
+    /// A tree all-reduce moves the whole tensor through every level of the
+    /// tree. For large tensors, this object instead splits the element range
+    /// into one chunk per process (reduce-scatter): every process sends
+    /// chunk \c p of its local result to process \c p , which reduces the
+    /// chunks it receives and sends the reduced chunk to every process
+    /// (allgather), where the chunks are assembled into the result. Each
+    /// process sends and receives about twice the tensor size, independent
+    /// of the number of processes, and the chunks are reduced concurrently.
+    ///
+    /// The join of the reduction must be element-wise, and the local results
+    /// must have the same range, or be empty. The size of the result is
+    /// agreed on with a scalar all-reduce, and results smaller than
+    /// \c min_elements() are reduced with a tree all-reduce.
+    /// \tparam Tensor The reduction result type, a contiguous tensor
+    /// \tparam Op The reduction operation type, with the interface of the
+    /// tile reductions
+    template <typename Tensor, typename Op>
+    class TensorAllReduce :
+      public std::enable_shared_from_this<TensorAllReduce<Tensor, Op> >
+    {
+    public:
+      typedef TensorAllReduce<Tensor, Op> TensorAllReduce_; ///< This object type
+      typedef Tensor tensor_type; ///< The result tensor type
+      typedef typename Tensor::range_type range_type; ///< The result range type
+      typedef std::pair<range_type, Tensor> chunk_type; ///< The range of the result, and a chunk of its elements
+
+    private:
+
+      struct SizeTag { };
+      struct TreeTag { };
+      struct ScatterTag { };
+      struct GatherTag { };
+
+      typedef madness::TaggedKey<madness::DistributedID, ScatterTag> scatter_key;
+      typedef madness::TaggedKey<madness::DistributedID, GatherTag> gather_key;
+
+      /// Maximum of the local sizes
+      struct MaxSizeOp {
+        typedef std::size_t result_type;
+        typedef std::size_t argument_type;
+
+        result_type operator()() const { return 0ul; }
+        result_type operator()(const result_type& temp) const { return temp; }
+        void operator()(result_type& result, const argument_type& arg) const {
+          result = std::max(result, arg);
+        }
+      }; // struct MaxSizeOp
+
+      World& world_; ///< The world of the reduction
+      madness::uniqueidT id_; ///< The id of the reduction
+      Op op_; ///< The reduction operation
+      Future<chunk_type> gather_self_; ///< The reduced chunk of this process
+      Future<Tensor> result_; ///< The reduced result
+
+      /// The element range of the chunk of a process
+
+      /// \param n The number of elements of the result
+      /// \param p The process
+      /// \return The first and last element of the chunk of \c p
+      std::pair<std::size_t, std::size_t>
+      chunk_bounds(const std::size_t n, const ProcessID p) const {
+        const std::size_t nprocs = world_.size();
+        return std::make_pair(n * p / nprocs, n * (p + 1ul) / nprocs);
+      }
+
+      static std::size_t local_size(const Tensor& local) {
+        return (local.empty() ? 0ul : local.range().volume());
+      }
+
+      /// Copy a chunk of a tensor
+      static chunk_type make_chunk(const Tensor& local,
+          const std::pair<std::size_t, std::size_t>& bounds)
+      {
+        if(local.empty())
+          return chunk_type();
+        const std::size_t n = bounds.second - bounds.first;
+        Tensor chunk((range_type(n)));
+        math::copy_vector(n, local.data() + bounds.first, chunk.data());
+        return chunk_type(local.range(), chunk);
+      }
+
+      /// Scatter the chunks of the local result
+
+      /// Results smaller than \c min_elements() are reduced with a tree
+      /// all-reduce instead.
+      /// \param local The local result
+      /// \param n The number of elements of the result
+      void scatter(const Tensor& local, const std::size_t n) {
+        if(n < min_elements()) {
+          typedef madness::TaggedKey<madness::uniqueidT, TreeTag> key_type;
+          result_.set(world_.gop.all_reduce(key_type(id_), local, op_));
+          return;
+        }
+
+        TA_ASSERT(local.empty() || (local.range().volume() == n));
+        const ProcessID rank = world_.rank();
+        const ProcessID nprocs = world_.size();
+        for(ProcessID i = 1; i < nprocs; ++i) {
+          const ProcessID p = (rank + i) % nprocs;
+          world_.gop.send(p, scatter_key(madness::DistributedID(id_, rank)),
+              make_chunk(local, chunk_bounds(n, p)));
+        }
+
+        // Reduce the chunks of this process, and assemble the result
+        std::vector<Future<chunk_type> > chunks(nprocs);
+        std::vector<Future<chunk_type> > reduced(nprocs);
+        for(ProcessID p = 0; p < nprocs; ++p) {
+          if(p == rank) {
+            chunks[p] = Future<chunk_type>(make_chunk(local, chunk_bounds(n, rank)));
+            reduced[p] = gather_self_;
+          } else {
+            chunks[p] = world_.gop.template recv<chunk_type>(p,
+                scatter_key(madness::DistributedID(id_, p)));
+            reduced[p] = world_.gop.template recv<chunk_type>(p,
+                gather_key(madness::DistributedID(id_, p)));
+          }
+        }
+        std::shared_ptr<TensorAllReduce_> self = this->shared_from_this();
+        world_.taskq.add(& TensorAllReduce_::reduce_task, self, chunks,
+            task_attributes(TaskClass::broadcast));
+        world_.taskq.add(& TensorAllReduce_::assemble_task, self, reduced,
+            task_attributes(TaskClass::broadcast));
+      }
+
+      /// Reduce the chunks of this process and gather them
+
+      /// \param chunks The chunks of this process from every process
+      void reduce_chunks(const std::vector<Future<chunk_type> >& chunks) {
+        chunk_type result;
+        for(const Future<chunk_type>& f : chunks) {
+          const chunk_type& chunk = f.get();
+          if(chunk.second.empty())
+            continue;
+          if(result.second.empty())
+            result = chunk_type(chunk.first, chunk.second.clone());
+          else
+            op_(result.second, chunk.second);
+        }
+
+        const ProcessID rank = world_.rank();
+        const ProcessID nprocs = world_.size();
+        for(ProcessID i = 1; i < nprocs; ++i) {
+          const ProcessID p = (rank + i) % nprocs;
+          world_.gop.send(p, gather_key(madness::DistributedID(id_, rank)),
+              result);
+        }
+        gather_self_.set(result);
+      }
+
+      /// Assemble the reduced chunks
+
+      /// \param chunks The reduced chunks of every process
+      void assemble(const std::vector<Future<chunk_type> >& chunks) {
+        const range_type* range = nullptr;
+        for(const Future<chunk_type>& f : chunks)
+          if(! f.get().second.empty())
+            range = & f.get().first;
+        if(range == nullptr) {
+          result_.set(op_(op_()));
+          return;
+        }
+
+        Tensor result(*range);
+        const std::size_t n = range->volume();
+        for(ProcessID p = 0; p < ProcessID(chunks.size()); ++p) {
+          const chunk_type& chunk = chunks[p].get();
+          TA_ASSERT(chunk.second.empty() || (chunk.first == *range));
+          const auto bounds = chunk_bounds(n, p);
+          if(chunk.second.empty())
+            std::fill(result.data() + bounds.first, result.data() + bounds.second,
+                typename Tensor::value_type(0));
+          else
+            math::copy_vector(bounds.second - bounds.first, chunk.second.data(),
+                result.data() + bounds.first);
+        }
+        result_.set(op_(result));
+      }
+
+      static void scatter_task(const std::shared_ptr<TensorAllReduce_>& self,
+          const Tensor& local, const std::size_t n)
+      { self->scatter(local, n); }
+
+      static void reduce_task(const std::shared_ptr<TensorAllReduce_>& self,
+          const std::vector<Future<chunk_type> >& chunks)
+      { self->reduce_chunks(chunks); }
+
+      static void assemble_task(const std::shared_ptr<TensorAllReduce_>& self,
+          const std::vector<Future<chunk_type> >& chunks)
+      { self->assemble(chunks); }
+
+    public:
+
+      /// Minimum size accessor
+
+      /// Results with fewer elements are reduced with a tree all-reduce. The
+      /// default is 65536 elements, or the value of the
+      /// \c TA_TENSOR_ALL_REDUCE_MIN_ELEMENTS environment variable; the
+      /// value is shared by all tensor and operation types.
+      /// \return A reference to the minimum number of elements
+      static std::size_t& min_elements() { return tensor_all_reduce_min_elements(); }
+
+      TensorAllReduce(World& world, const madness::uniqueidT& id, const Op& op) :
+        world_(world), id_(id), op_(op)
+      { }
+
+      /// Start the all-reduce
+
+      /// This function does not block.
+      /// \param world The world of the reduction
+      /// \param id The id of the reduction, which is the same on every process
+      /// \param local The local result
+      /// \param op The reduction operation
+      /// \return A future to the result on every process
+      static Future<Tensor> all_reduce(World& world, const madness::uniqueidT& id,
+          const Future<Tensor>& local, const Op& op)
+      {
+        if(world.size() == 1) {
+          typedef madness::TaggedKey<madness::uniqueidT, TreeTag> key_type;
+          return world.gop.all_reduce(key_type(id), local, op);
+        }
+
+        std::shared_ptr<TensorAllReduce_> self =
+            std::make_shared<TensorAllReduce_>(world, id, op);
+
+        // Agree on the size of the result
+        typedef madness::TaggedKey<madness::uniqueidT, SizeTag> size_key;
+        const Future<std::size_t> n = world.gop.all_reduce(size_key(id),
+            world.taskq.add(& TensorAllReduce_::local_size, local), MaxSizeOp());
+        world.taskq.add(& TensorAllReduce_::scatter_task, self, local, n,
+            task_attributes(TaskClass::broadcast));
+
+        return self->result_;
+      }
+
+    }; // class TensorAllReduce
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_TENSOR_ALL_REDUCE_H__INCLUDED
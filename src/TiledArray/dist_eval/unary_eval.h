@@ -20,7 +20,9 @@
 #ifndef TILEDARRAY_DIST_EVAL_UNARY_EVAL_H__INCLUDED
 #define TILEDARRAY_DIST_EVAL_UNARY_EVAL_H__INCLUDED
 
+#include <vector>
 #include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/tile_interface/async.h>
 
 namespace TiledArray {
   namespace detail {
@@ -65,6 +67,7 @@ namespace TiledArray {
           const Permutation& perm, const op_type& op) :
         DistEvalImpl_(world, trange, shape, pmap, perm),
         arg_(arg),
+        arg_pmap_(arg.pmap()),
         op_(op)
       { }
 
@@ -80,7 +83,8 @@ namespace TiledArray {
       virtual Future<value_type> get_tile(size_type i) const {
         TA_ASSERT(TensorImpl_::is_local(i));
         TA_ASSERT(! TensorImpl_::is_zero(i));
-        const size_type source = arg_.owner(DistEvalImpl_::perm_index_to_source(i));
+        const size_type source =
+            arg_pmap_->owner(DistEvalImpl_::perm_index_to_source(i));
         const madness::DistributedID key(DistEvalImpl_::id(), i);
         return TensorImpl_::world().gop.template recv<value_type>(source, key);
       }
@@ -105,10 +109,29 @@ namespace TiledArray {
 
       /// Task function for evaluating tiles
 
+      /// Tiles of asynchronous types (see \c async_trait ) are set when their
+      /// kernels complete, without blocking this task.
       /// \param i The tile index
       /// \param tile The tile to be evaluated
       void eval_tile(const size_type i, tile_argument_type tile) {
-        DistEvalImpl_::set_tile(i, op_(tile));
+        TaskTraceScope trace("dist_eval", "unary tile");
+        TileTimerScope timer(TileTimings::unary, i);
+        DistEvalImpl_::set_tile(i, async_invoke(op_, tile));
+      }
+
+      /// Task function for evaluating a chunk of tiles
+
+      /// \param indices The tile indices
+      /// \param tiles The tiles to be evaluated
+      void eval_tiles(const std::vector<size_type>& indices,
+          std::vector<Future<typename arg_type::value_type> > tiles)
+      {
+        TaskTraceScope trace("dist_eval", "unary tiles");
+        for(size_type j = 0ul; j < indices.size(); ++j) {
+          TileTimerScope timer(TileTimings::unary, indices[j]);
+          tile_argument_type tile = tiles[j].get();
+          DistEvalImpl_::set_tile(indices[j], async_invoke(op_, tile));
+        }
       }
 
       /// Evaluate the tiles of this tensor
@@ -126,9 +149,24 @@ namespace TiledArray {
         // Evaluate argument
         arg_.eval();
 
-        // Counter for the number of tasks submitted by this object
+        // Counter for the number of tiles set by this object
         size_type task_count = 0ul;
 
+        // Small tiles are evaluated in chunks
+        TileChunker chunker(arg_.pmap()->local_size());
+        std::vector<size_type> indices;
+        std::vector<Future<typename arg_type::value_type> > tiles;
+        auto submit = [&] () {
+          if(indices.size() == 1ul)
+            TensorImpl_::world().taskq.add(self, & UnaryEvalImpl_::eval_tile,
+                indices.front(), tiles.front(), task_attributes(TaskClass::tile));
+          else
+            TensorImpl_::world().taskq.add(self, & UnaryEvalImpl_::eval_tiles,
+                indices, tiles, task_attributes(TaskClass::tile));
+          indices.clear();
+          tiles.clear();
+        };
+
         // Make sure all local tiles are present.
         const typename pmap_interface::const_iterator end = arg_.pmap()->end();
         typename pmap_interface::const_iterator it = arg_.pmap()->begin();
@@ -141,20 +179,26 @@ namespace TiledArray {
             const size_type target_index = DistEvalImpl_::perm_index_to_target(index);
 
             // Schedule tile evaluation task
-            TensorImpl_::world().taskq.add(self, & UnaryEvalImpl_::eval_tile,
-                target_index, arg_.get(index));
+            indices.push_back(target_index);
+            tiles.push_back(arg_.get(index));
+            if(chunker.add(TensorImpl_::trange().make_tile_range(target_index).volume()))
+              submit();
 
             ++task_count;
           }
         }
+        if(! indices.empty())
+          submit();
 
-        // Wait for local tiles of argument to be evaluated
+        // Wait for local tiles of argument to be evaluated, then release it
         arg_.wait();
+        arg_.release();
 
         return task_count;
       }
 
-      arg_type arg_; ///< Argument
+      arg_type arg_; ///< Argument, which is released when this object is evaluated
+      std::shared_ptr<pmap_interface> arg_pmap_; ///< The process map of the argument
       op_type op_; ///< The unary tile operation
     }; // class UnaryEvalImpl
 
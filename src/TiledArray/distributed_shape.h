@@ -0,0 +1,474 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_DISTRIBUTED_SHAPE_H__INCLUDED
+#define TILEDARRAY_DISTRIBUTED_SHAPE_H__INCLUDED
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <TiledArray/sparse_shape.h>
+#include <TiledArray/pmap/pmap.h>
+
+namespace TiledArray {
+
+  /// Distributed sparse shape
+
+  /// Unlike \c SparseShape , which is replicated on every process, each
+  /// process holds only the (per-element) norms of the tiles it owns,
+  /// according to a process map, plus a cache of the remote norms that it
+  /// has fetched. The memory of the shape on each process is proportional to
+  /// the number of its local non-zero tiles and the size of the cache, so the
+  /// shape scales to tile counts where a replicated shape does not fit on a
+  /// process.
+  ///
+  /// Remote norms are fetched with \c fetch() , which sends one request to
+  /// each owner. \c gemm() fetches only the rows of the left-hand norms and
+  /// the columns of the right-hand norms that contribute to the local tiles
+  /// of the result. \c replicate() gathers the norms into a \c SparseShape ,
+  /// e.g. to construct an array.
+  /// \tparam T The norm value type
+  /// \note This object is derived from \c WorldObject , which means
+  /// the order of construction of object must be the same on all nodes.
+  /// Objects must not be destroyed while other processes may still fetch
+  /// norms from them, e.g. destroy them after a fence.
+  template <typename T>
+  class DistributedShape : public madness::WorldObject<DistributedShape<T> > {
+  public:
+    typedef DistributedShape<T> DistributedShape_; ///< This object type
+    typedef madness::WorldObject<DistributedShape_> WorldObject_; ///< Base object type
+    typedef T value_type; ///< The norm value type
+    typedef typename SparseShape<T>::size_type size_type; ///< Size type
+    typedef Pmap pmap_interface; ///< Process map interface type
+
+  private:
+    typedef detail::CompressedNorms<value_type> compressed_type;
+
+    TiledRange trange_; ///< The tiled range of the tensor
+    std::shared_ptr<pmap_interface> pmap_; ///< The process map of the tiles
+    std::shared_ptr<const compressed_type> local_norms_; ///< The non-zero norms of the local tiles
+    value_type zero_threshold_; ///< The zero threshold of this shape
+    mutable std::mutex mutex_; ///< Protects \c cache_
+    mutable std::unordered_map<size_type, value_type> cache_; ///< Fetched remote norms
+
+    // not allowed
+    DistributedShape(const DistributedShape_&);
+    DistributedShape_& operator=(const DistributedShape_&);
+
+    /// Construct a shape from normalized local norms
+    DistributedShape(World& world, const TiledRange& trange,
+        const std::shared_ptr<pmap_interface>& pmap,
+        std::vector<size_type> ordinals, std::vector<value_type> values,
+        const value_type zero_threshold) :
+      WorldObject_(world), trange_(trange), pmap_(pmap),
+      local_norms_(std::make_shared<compressed_type>(trange.tiles_range(),
+          std::move(ordinals), std::move(values))),
+      zero_threshold_(zero_threshold), mutex_(), cache_()
+    {
+      check_pmap();
+      WorldObject_::process_pending();
+    }
+
+    void check_pmap() const {
+      TA_ASSERT(pmap_);
+      TA_ASSERT(pmap_->size() == trange_.tiles_range().volume());
+      TA_ASSERT(pmap_->rank() == pmap_interface::size_type(WorldObject_::get_world().rank()));
+      TA_ASSERT(pmap_->procs() == pmap_interface::size_type(WorldObject_::get_world().size()));
+    }
+
+    /// Volume of a tile
+
+    /// \param ordinal The ordinal index of the tile
+    /// \return The number of elements in the tile
+    value_type volume(const size_type ordinal) const {
+      return trange_.make_tile_range(ordinal).volume();
+    }
+
+    /// Norms of local tiles
+
+    /// \param ordinals The ordinal indices of local tiles
+    /// \return The norms of the tiles
+    std::vector<value_type> get_handler(const std::vector<size_type>& ordinals) const {
+      std::vector<value_type> values;
+      values.reserve(ordinals.size());
+      for(const size_type ordinal : ordinals)
+        values.push_back(local_norm(ordinal));
+      return values;
+    }
+
+    /// Combine the local, cached, and remote norms
+
+    /// \param self The shape that fetched the norms
+    /// \param values The local and cached norms
+    /// \param requested The ordinal indices requested from each process
+    /// \param positions The positions of the requested norms in \c values
+    /// \param remote The norms received from each process
+    /// \return The fetched norms
+    static std::vector<value_type> merge(const DistributedShape_* const self,
+        std::vector<value_type> values,
+        const std::vector<std::vector<size_type> >& requested,
+        const std::vector<std::vector<size_type> >& positions,
+        const std::vector<Future<std::vector<value_type> > >& remote)
+    {
+      std::lock_guard<std::mutex> lock(self->mutex_);
+      for(std::size_t p = 0ul; p < remote.size(); ++p) {
+        const std::vector<value_type>& remote_values = remote[p].get();
+        TA_ASSERT(remote_values.size() == requested[p].size());
+        for(std::size_t i = 0ul; i < remote_values.size(); ++i) {
+          values[positions[p][i]] = remote_values[i];
+          self->cache_[requested[p][i]] = remote_values[i];
+        }
+      }
+      return values;
+    }
+
+  public:
+
+    /// Constructor
+
+    /// This constructor normalizes the tile norms, where the normalization
+    /// constant for each tile is the inverse of the number of elements in
+    /// the tile. No communication is needed.
+    /// \tparam LocalNormSequence A sequence of
+    /// <tt>std::pair<size_type,value_type></tt> objects
+    /// \param world The world where the shape lives
+    /// \param trange The tiled range of the tensor
+    /// \param pmap The process map of the tiles
+    /// \param local_norms The ordinal indices and Frobenius norms of the
+    /// non-zero local tiles
+    /// \param zero_threshold The zero threshold of this shape
+    ///        [ default = SparseShape<T>::threshold() ]
+    template <typename LocalNormSequence>
+    DistributedShape(World& world, const TiledRange& trange,
+        const std::shared_ptr<pmap_interface>& pmap,
+        const LocalNormSequence& local_norms,
+        const value_type zero_threshold = SparseShape<T>::threshold()) :
+      WorldObject_(world), trange_(trange), pmap_(pmap), local_norms_(),
+      zero_threshold_(zero_threshold), mutex_(), cache_()
+    {
+      check_pmap();
+
+      std::vector<size_type> ordinals;
+      std::vector<value_type> values;
+      for(const auto& ordinal_norm : local_norms) {
+        TA_ASSERT(pmap_->is_local(ordinal_norm.first));
+        const value_type norm = ordinal_norm.second / volume(ordinal_norm.first);
+        if(norm >= zero_threshold_) {
+          ordinals.push_back(ordinal_norm.first);
+          values.push_back(norm);
+        }
+      }
+      local_norms_ = std::make_shared<compressed_type>(trange_.tiles_range(),
+          std::move(ordinals), std::move(values));
+
+      WorldObject_::process_pending();
+    }
+
+    /// Distribute a replicated shape
+
+    /// Only the norms of the local tiles of \c shape are kept. No
+    /// communication is needed.
+    /// \param world The world where the shape lives
+    /// \param shape The replicated shape
+    /// \param trange The tiled range of the tensor
+    /// \param pmap The process map of the tiles
+    DistributedShape(World& world, const SparseShape<T>& shape,
+        const TiledRange& trange, const std::shared_ptr<pmap_interface>& pmap) :
+      WorldObject_(world), trange_(trange), pmap_(pmap), local_norms_(),
+      zero_threshold_(shape.zero_threshold()), mutex_(), cache_()
+    {
+      check_pmap();
+      TA_ASSERT(shape.validate(trange_.tiles_range()));
+
+      std::vector<size_type> ordinals;
+      std::vector<value_type> values;
+      for(const size_type ordinal : *pmap_) {
+        if(! shape.is_zero(ordinal)) {
+          ordinals.push_back(ordinal);
+          values.push_back(shape[ordinal]);
+        }
+      }
+      local_norms_ = std::make_shared<compressed_type>(trange_.tiles_range(),
+          std::move(ordinals), std::move(values));
+
+      WorldObject_::process_pending();
+    }
+
+    virtual ~DistributedShape() { }
+
+    using WorldObject_::get_world;
+
+    /// Tiled range accessor
+
+    /// \return The tiled range of the tensor
+    const TiledRange& trange() const { return trange_; }
+
+    /// Process map accessor
+
+    /// \return The process map of the tiles
+    const std::shared_ptr<pmap_interface>& pmap() const { return pmap_; }
+
+    /// Zero threshold accessor
+
+    /// \return The threshold below which the tiles of this shape are zero
+    value_type zero_threshold() const { return zero_threshold_; }
+
+    /// Local tile query
+
+    /// \param ordinal The ordinal index of a tile
+    /// \return \c true when the tile is owned by this process
+    bool is_local(const size_type ordinal) const { return pmap_->is_local(ordinal); }
+
+    /// Local tile norm accessor
+
+    /// \param ordinal The ordinal index of a local tile
+    /// \return The norm of the tile
+    value_type local_norm(const size_type ordinal) const {
+      TA_ASSERT(is_local(ordinal));
+      return (*local_norms_)[ordinal];
+    }
+
+    /// Check that a local tile is zero
+
+    /// \param ordinal The ordinal index of a local tile
+    /// \return \c true when the tile is zero
+    bool is_zero(const size_type ordinal) const {
+      return local_norm(ordinal) < zero_threshold_;
+    }
+
+    /// Number of local non-zero tiles
+
+    /// \return The number of non-zero tiles owned by this process
+    size_type local_size() const { return local_norms_->size(); }
+
+    /// Number of cached remote norms
+
+    /// \return The number of remote norms held by this process
+    size_type cache_size() const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return cache_.size();
+    }
+
+    /// Remove the cached remote norms
+    void clear_cache() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cache_.clear();
+    }
+
+    /// Fetch tile norms
+
+    /// The norms of local tiles and of cached remote tiles are available
+    /// immediately. The others are requested from their owners, with one
+    /// message per owner, and added to the cache.
+    /// \param ordinals The ordinal indices of the tiles
+    /// \return A future to the norms of the tiles, in the order of
+    /// \c ordinals
+    Future<std::vector<value_type> > fetch(const std::vector<size_type>& ordinals) const {
+      std::vector<value_type> values(ordinals.size(), value_type(0));
+      std::map<ProcessID, std::pair<std::vector<size_type>, std::vector<size_type> > > requests;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for(std::size_t i = 0ul; i < ordinals.size(); ++i) {
+          const size_type ordinal = ordinals[i];
+          TA_ASSERT(trange_.tiles_range().includes(ordinal));
+          if(is_local(ordinal)) {
+            values[i] = local_norm(ordinal);
+          } else {
+            const auto it = cache_.find(ordinal);
+            if(it != cache_.end()) {
+              values[i] = it->second;
+            } else {
+              auto& request = requests[pmap_->owner(ordinal)];
+              request.first.push_back(ordinal);
+              request.second.push_back(i);
+            }
+          }
+        }
+      }
+
+      if(requests.empty())
+        return Future<std::vector<value_type> >(values);
+
+      // Send one request to each owner
+      std::vector<std::vector<size_type> > requested, positions;
+      std::vector<Future<std::vector<value_type> > > remote;
+      requested.reserve(requests.size());
+      positions.reserve(requests.size());
+      remote.reserve(requests.size());
+      for(auto& request : requests) {
+        remote.push_back(WorldObject_::task(request.first,
+            & DistributedShape_::get_handler, request.second.first,
+            madness::TaskAttributes::hipri()));
+        requested.push_back(std::move(request.second.first));
+        positions.push_back(std::move(request.second.second));
+      }
+
+      return get_world().taskq.add(& DistributedShape_::merge,
+          static_cast<const DistributedShape_*>(this), values, requested,
+          positions, remote, madness::TaskAttributes::hipri());
+    }
+
+    /// Contract shapes
+
+    /// Computes the norms of the local tiles of the result of the contraction
+    /// of this shape, the left-hand argument, with \c other , as
+    /// \c SparseShape::gemm() does with the \c GemmEstimate::bound
+    /// estimator. Only the rows of this shape and the columns of \c other
+    /// that contribute to the local result tiles are fetched. This is a
+    /// collective operation, since it constructs a distributed object.
+    /// \tparam Factor The scaling factor type
+    /// \param other The right-hand argument
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction helper; the arguments must not be
+    /// transposed
+    /// \param pmap The process map of the result tiles
+    /// \return The shape of the result, with the tighter of the zero
+    /// thresholds of the arguments
+    template <typename Factor>
+    std::shared_ptr<DistributedShape_>
+    gemm(const DistributedShape_& other, const Factor factor,
+        const math::GemmHelper& gemm_helper,
+        const std::shared_ptr<pmap_interface>& pmap) const
+    {
+      using std::abs;
+      TA_ASSERT(gemm_helper.left_op() == madness::cblas::NoTrans);
+      TA_ASSERT(gemm_helper.right_op() == madness::cblas::NoTrans);
+
+      const value_type abs_factor = static_cast<value_type>(abs(factor));
+      const value_type threshold = std::min(zero_threshold_, other.zero_threshold_);
+      integer M = 0, N = 0, K = 0;
+      gemm_helper.compute_matrix_sizes(M, N, K, trange_.tiles_range(),
+          other.trange_.tiles_range());
+
+      // Construct the result tiled range
+      std::vector<TiledRange1> ranges;
+      for(unsigned int i = gemm_helper.left_outer_begin(); i < gemm_helper.left_outer_end(); ++i)
+        ranges.push_back(trange_.data()[i]);
+      for(unsigned int i = gemm_helper.right_outer_begin(); i < gemm_helper.right_outer_end(); ++i)
+        ranges.push_back(other.trange_.data()[i]);
+      const TiledRange result_trange(ranges.begin(), ranges.end());
+
+      // Compute the sizes of the inner tiles
+      std::vector<value_type> k_sizes(1, value_type(1));
+      for(unsigned int i = gemm_helper.left_inner_begin(); i < gemm_helper.left_inner_end(); ++i) {
+        const TiledRange1& range = trange_.data()[i];
+        std::vector<value_type> sizes;
+        sizes.reserve(k_sizes.size() * (range.tiles_range().second - range.tiles_range().first));
+        for(const value_type size : k_sizes)
+          for(auto it = range.begin(); it != range.end(); ++it)
+            sizes.push_back(size * value_type(it->second - it->first));
+        k_sizes.swap(sizes);
+      }
+      TA_ASSERT(k_sizes.size() == size_type(K));
+
+      // Find the rows and columns of the local result tiles
+      std::vector<size_type> result_ordinals(pmap->begin(), pmap->end());
+      std::sort(result_ordinals.begin(), result_ordinals.end());
+      std::vector<size_type> rows, cols;
+      for(const size_type ordinal : result_ordinals) {
+        if(rows.empty() || (rows.back() != ordinal / N))
+          rows.push_back(ordinal / N);
+        cols.push_back(ordinal % N);
+      }
+      std::sort(cols.begin(), cols.end());
+      cols.erase(std::unique(cols.begin(), cols.end()), cols.end());
+
+      // Fetch the needed rows of this shape and columns of other
+      std::vector<size_type> left_ordinals, right_ordinals;
+      left_ordinals.reserve(rows.size() * K);
+      for(const size_type m : rows)
+        for(integer k = 0; k < K; ++k)
+          left_ordinals.push_back(m * K + k);
+      right_ordinals.reserve(K * cols.size());
+      for(integer k = 0; k < K; ++k)
+        for(const size_type n : cols)
+          right_ordinals.push_back(k * N + n);
+      Future<std::vector<value_type> > left_future = fetch(left_ordinals);
+      Future<std::vector<value_type> > right_future = other.fetch(right_ordinals);
+      const std::vector<value_type>& left = left_future.get();
+      const std::vector<value_type>& right = right_future.get();
+
+      // Collect the non-zero right-hand norms of each row, scaled by the size
+      // of the row
+      std::vector<size_type> right_ptr(K + 1, 0ul);
+      std::vector<std::pair<size_type, value_type> > right_norms;
+      for(integer k = 0; k < K; ++k) {
+        right_ptr[k] = right_norms.size();
+        for(size_type j = 0ul; j < cols.size(); ++j) {
+          const value_type value = right[k * cols.size() + j];
+          if(value != value_type(0))
+            right_norms.emplace_back(j, value * k_sizes[k]);
+        }
+      }
+      right_ptr[K] = right_norms.size();
+
+      // Accumulate the rows of the result, and keep the local tiles
+      std::vector<size_type> ordinals;
+      std::vector<value_type> values;
+      std::vector<value_type> accumulator(cols.size());
+      auto ordinal_it = result_ordinals.cbegin();
+      for(size_type r = 0ul; r < rows.size(); ++r) {
+        std::fill(accumulator.begin(), accumulator.end(), value_type(0));
+        for(integer k = 0; k < K; ++k) {
+          const value_type left_mk = left[r * K + k];
+          if(left_mk == value_type(0))
+            continue;
+          const value_type scaled_left_mk = left_mk * k_sizes[k] * abs_factor;
+          for(size_type i = right_ptr[k]; i < right_ptr[k + 1]; ++i)
+            accumulator[right_norms[i].first] += scaled_left_mk * right_norms[i].second;
+        }
+
+        for(; (ordinal_it != result_ordinals.cend()) && (*ordinal_it / N == rows[r]); ++ordinal_it) {
+          const size_type j = std::lower_bound(cols.begin(), cols.end(),
+              *ordinal_it % N) - cols.begin();
+          if(accumulator[j] >= threshold) {
+            ordinals.push_back(*ordinal_it);
+            values.push_back(accumulator[j]);
+          }
+        }
+      }
+
+      return std::shared_ptr<DistributedShape_>(new DistributedShape_(get_world(),
+          result_trange, pmap, std::move(ordinals), std::move(values), threshold));
+    }
+
+    /// Replicate the shape
+
+    /// Gathers the norms of all processes into a replicated shape. This is a
+    /// collective operation, and the result uses memory proportional to the
+    /// number of tiles on every process.
+    /// \return A \c SparseShape with the norms of this shape
+    SparseShape<T> replicate() const {
+      Tensor<value_type> tile_norms(trange_.tiles_range(), value_type(0));
+      for(size_type i = 0ul; i < local_norms_->size(); ++i) {
+        const size_type ordinal = local_norms_->ordinals()[i];
+        tile_norms[ordinal] = local_norms_->values()[i] * volume(ordinal);
+      }
+      return SparseShape<T>(get_world(), tile_norms, trange_, zero_threshold_);
+    }
+
+  }; // class DistributedShape
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_DISTRIBUTED_SHAPE_H__INCLUDED
@@ -21,6 +21,14 @@
 #define TILEDARRAY_DISTRIBUTED_STORAGE_H__INCLUDED
 
 #include <TiledArray/pmap/pmap.h>
+#include <TiledArray/work_counter.h>
+#include <TiledArray/zero_copy.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
@@ -35,11 +43,25 @@ namespace TiledArray {
     /// is first accessed, though you may manually initialize an element with
     /// the \c insert() function. All elements are stored in \c Future ,
     /// which may be set only once.
+    ///
+    /// Local elements are stored in a concurrent hash map, which locks the
+    /// accessed bucket for every \c get and \c set . When all local elements
+    /// will be stored, e.g. for a dense array, the container may instead
+    /// allocate a dense array of slots, one for each element in the local
+    /// list of the process map. The future of each slot is constructed by the
+    /// constructor, so an element is found by its position in the local list
+    /// and is set through its own future; no bucket is hashed or locked.
     /// \note This object is derived from \c WorldObject , which means
     /// the order of construction of object must be the same on all nodes. This
     /// can easily be achieved by only constructing world objects in the main
     /// thread. DO NOT construct world objects within tasks where the order of
     /// execution is nondeterministic.
+    ///
+    /// Local tasks and callbacks that reference this object, and the
+    /// handlers of messages from other processes, are counted as in-flight
+    /// operations. An object that is no longer used by any process is
+    /// released with \c release() , which deletes it when the last in-flight
+    /// operation completes rather than at a later fence.
     template <typename T>
     class DistributedStorage : public madness::WorldObject<DistributedStorage<T> > {
     public:
@@ -60,14 +82,63 @@ namespace TiledArray {
       const size_type max_size_; ///< The maximum number of elements that can be stored by this container
       std::shared_ptr<pmap_interface> pmap_; ///< The process map that defines the element distribution
       mutable container_type data_; ///< The local data container
+      std::vector<size_type> slot_index_; ///< The sorted indices of the dense slots
+      mutable std::vector<future> slots_; ///< The dense slots of the local elements
+      bool contiguous_; ///< The dense slots hold a contiguous range of indices
+
+      /// Remote requests that are buffered for one process
+      struct Buffer {
+        std::vector<size_type> set_indices; ///< The indices of buffered sets
+        std::vector<value_type> set_values; ///< The values of buffered sets
+        std::vector<size_type> get_indices; ///< The indices of buffered gets
+        std::vector<typename future::remote_refT> get_refs; ///< The results of buffered gets
+      }; // struct Buffer
+
+      size_type buffer_size_; ///< The number of requests per message, or zero
+      mutable std::vector<Buffer> buffers_; ///< The buffered requests of each process
+      mutable madness::Spinlock buffer_lock_; ///< Protects \c buffers_
+
+      mutable std::atomic<size_type> in_flight_; ///< In-flight operations, plus one until \c release()
+      std::function<void()> release_op_; ///< Called by the last operation after \c release()
+
+      /// Count a local operation for the lifetime of this object
+      class OperationScope {
+        const DistributedStorage_& ds_; ///< The counted object
+
+      public:
+        OperationScope(const OperationScope&) = delete;
+        OperationScope& operator=(const OperationScope&) = delete;
+
+        explicit OperationScope(const DistributedStorage_& ds) : ds_(ds)
+        { ds_.begin_operation(); }
+
+        ~OperationScope() { ds_.end_operation(); }
+      }; // class OperationScope
 
       // not allowed
       DistributedStorage(const DistributedStorage_&);
       DistributedStorage_& operator=(const DistributedStorage_&);
 
+      /// Position of a local element in the dense slots
+
+      /// \param i The index of a local element
+      /// \return The position of element \c i in \c slots_
+      size_type slot(const size_type i) const {
+        if(contiguous_)
+          return i - slot_index_.front();
+        const auto it =
+            std::lower_bound(slot_index_.begin(), slot_index_.end(), i);
+        TA_ASSERT((it != slot_index_.end()) && (*it == i));
+        return it - slot_index_.begin();
+      }
+
       future get_local(const size_type i) const {
         TA_ASSERT(pmap_->is_local(i));
 
+        // Return the local element from its dense slot.
+        if(! slots_.empty())
+          return slots_[slot(i)];
+
         // Return the local element.
         const_accessor acc;
         data_.insert(acc, i);
@@ -86,17 +157,244 @@ namespace TiledArray {
         f.set(value);
       }
 
+      /// Record the data of an element that is sent to another process
+      static void count_sent(const value_type& value) {
+        WorkCounter::instance().add_bytes_sent(tile_data_bytes(value));
+      }
+
+      /// Record the data of an element that is received from another process
+      static void count_received(const value_type& value) {
+        WorkCounter::instance().add_bytes_received(tile_data_bytes(value));
+      }
+
+      /// Set a local element with a value sent by another process
+      void remote_set_handler(const size_type i, const value_type& value) {
+        OperationScope operation(*this);
+        count_received(value);
+        set_handler(i, value);
+      }
+
+      /// Reply to an unbuffered get of another process
+
+      /// The reply is counted as sent data; the requesting process does not
+      /// count it as received data.
       void get_handler(const size_type i, const typename future::remote_refT& ref) {
+        OperationScope operation(*this);
         future f = get_local(i);
         future remote_f(ref);
-        remote_f.set(f);
+        if(f.probe()) {
+          count_sent(f.get());
+          remote_f.set(f);
+          return;
+        }
+        get_world().taskq.add([remote_f] (const value_type& value) mutable {
+              count_sent(value);
+              remote_f.set(value);
+            }, f, madness::TaskAttributes::hipri());
       }
 
       void set_remote(const size_type i, const value_type& value) {
-        WorldObject_::task(owner(i), & DistributedStorage_::set_handler,
+        count_sent(value);
+        if(buffer_size_) {
+          buffer_set(owner(i), i, value);
+          return;
+        }
+        WorldObject_::task(owner(i), & DistributedStorage_::remote_set_handler,
             i, value, madness::TaskAttributes::hipri());
       }
 
+      /// Buffer a remote set, and send the buffer when it is full
+      void buffer_set(const ProcessID dest, const size_type i,
+          const value_type& value)
+      {
+        std::vector<size_type> indices;
+        std::vector<value_type> values;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(& buffer_lock_);
+          Buffer& buffer = buffers_[dest];
+          buffer.set_indices.push_back(i);
+          buffer.set_values.push_back(value);
+          if(buffer.set_indices.size() < buffer_size_)
+            return;
+          indices.swap(buffer.set_indices);
+          values.swap(buffer.set_values);
+        }
+        WorldObject_::task(dest, & DistributedStorage_::remote_set_batch_handler,
+            indices, values, madness::TaskAttributes::hipri());
+      }
+
+      /// Buffer a remote get, and send the buffer when it is full
+      void buffer_get(const ProcessID dest, const size_type i,
+          const typename future::remote_refT& ref) const
+      {
+        std::vector<size_type> indices;
+        std::vector<typename future::remote_refT> refs;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(& buffer_lock_);
+          Buffer& buffer = buffers_[dest];
+          buffer.get_indices.push_back(i);
+          buffer.get_refs.push_back(ref);
+          if(buffer.get_indices.size() < buffer_size_)
+            return;
+          indices.swap(buffer.get_indices);
+          refs.swap(buffer.get_refs);
+        }
+        WorldObject_::task(dest, & DistributedStorage_::get_batch_handler,
+            indices, refs, get_world().rank(), madness::TaskAttributes::hipri());
+      }
+
+      void get_batch_handler(const std::vector<size_type>& indices,
+          const std::vector<typename future::remote_refT>& refs,
+          const ProcessID source)
+      {
+        TA_ASSERT(indices.size() == refs.size());
+        OperationScope operation(*this);
+        std::vector<future> futures;
+        futures.reserve(indices.size());
+        for(const size_type i : indices)
+          futures.push_back(get_local(i));
+        get_world().taskq.add(new DelayedGetBatch(*this, source, refs,
+            std::move(futures)));
+      }
+
+      /// Send the data of a local element to a receive buffer
+
+      /// \param world The world of the container
+      /// \param value The element
+      /// \param dest The process that receives the element
+      /// \param tag The message tag
+      static void send_buffer(World* world, const value_type& value,
+          const ProcessID dest, const int tag)
+      {
+        value_type tile = value;
+        count_sent(tile);
+        BufferTransferTask::send(*world, tile_buffer(tile), dest, tag,
+            [tile] () { });
+      }
+
+      void send_buffer_handler(const size_type i, const ProcessID dest,
+          const int tag)
+      {
+        OperationScope operation(*this);
+        get_world().taskq.add(& DistributedStorage_::send_buffer, & get_world(),
+            get_local(i), dest, tag, madness::TaskAttributes::hipri());
+      }
+
+      void get_reply_handler(const std::vector<typename future::remote_refT>& refs,
+          const std::vector<value_type>& values)
+      {
+        TA_ASSERT(refs.size() == values.size());
+        for(size_type i = 0ul; i < refs.size(); ++i) {
+          count_received(values[i]);
+          future f(refs[i]);
+          f.set(values[i]);
+        }
+      }
+
+      void set_batch_handler(const std::vector<size_type>& indices,
+          const std::vector<value_type>& values)
+      {
+        TA_ASSERT(indices.size() == values.size());
+        for(size_type i = 0ul; i < indices.size(); ++i)
+          set_handler(indices[i], values[i]);
+      }
+
+      /// Set local elements with values sent by another process
+      void remote_set_batch_handler(const std::vector<size_type>& indices,
+          const std::vector<value_type>& values)
+      {
+        OperationScope operation(*this);
+        for(const value_type& value : values)
+          count_received(value);
+        set_batch_handler(indices, values);
+      }
+
+      /// Task that sends a batch of elements when they are assigned
+      class DelayedSetBatch : public madness::TaskInterface {
+      private:
+        DistributedStorage_& ds_; ///< A reference to the owning object
+        const ProcessID dest_; ///< The owner of the elements
+        const std::vector<size_type> indices_; ///< The indices of the elements
+        const std::vector<future> futures_; ///< The futures of the elements
+
+      public:
+
+        DelayedSetBatch(DistributedStorage_& ds, const ProcessID dest,
+            std::vector<size_type>&& indices, std::vector<future>&& futures) :
+          madness::TaskInterface(madness::TaskAttributes::hipri()),
+          ds_(ds), dest_(dest), indices_(std::move(indices)),
+          futures_(std::move(futures))
+        {
+          ds_.begin_operation();
+          for(const future& f : futures_) {
+            if(! f.probe()) {
+              madness::DependencyInterface::inc();
+              const_cast<future&>(f).register_callback(this);
+            }
+          }
+        }
+
+        virtual ~DelayedSetBatch() { }
+
+        virtual void run(const madness::TaskThreadEnv&) {
+          std::vector<value_type> values;
+          values.reserve(futures_.size());
+          for(const future& f : futures_)
+            values.push_back(f.get());
+
+          if(dest_ == ds_.get_world().rank()) {
+            ds_.set_batch_handler(indices_, values);
+          } else {
+            for(const value_type& value : values)
+              count_sent(value);
+            ds_.task(dest_, & DistributedStorage_::remote_set_batch_handler,
+                indices_, values, madness::TaskAttributes::hipri());
+          }
+          ds_.end_operation();
+        }
+      }; // class DelayedSetBatch
+
+      /// Task that replies to a batch of gets when the elements are assigned
+      class DelayedGetBatch : public madness::TaskInterface {
+      private:
+        DistributedStorage_& ds_; ///< A reference to the owning object
+        const ProcessID source_; ///< The process that requested the elements
+        const std::vector<typename future::remote_refT> refs_; ///< The results of the gets
+        const std::vector<future> futures_; ///< The futures of the elements
+
+      public:
+
+        DelayedGetBatch(DistributedStorage_& ds, const ProcessID source,
+            const std::vector<typename future::remote_refT>& refs,
+            std::vector<future>&& futures) :
+          madness::TaskInterface(madness::TaskAttributes::hipri()),
+          ds_(ds), source_(source), refs_(refs), futures_(std::move(futures))
+        {
+          ds_.begin_operation();
+          for(const future& f : futures_) {
+            if(! f.probe()) {
+              madness::DependencyInterface::inc();
+              const_cast<future&>(f).register_callback(this);
+            }
+          }
+        }
+
+        virtual ~DelayedGetBatch() { }
+
+        virtual void run(const madness::TaskThreadEnv&) {
+          std::vector<value_type> values;
+          values.reserve(futures_.size());
+          for(const future& f : futures_) {
+            values.push_back(f.get());
+            count_sent(values.back());
+          }
+
+          ds_.task(source_, & DistributedStorage_::get_reply_handler, refs_,
+              values, madness::TaskAttributes::hipri());
+          ds_.end_operation();
+        }
+      }; // class DelayedGetBatch
+
       struct DelayedSet : public madness::CallbackInterface {
       private:
         DistributedStorage_& ds_; ///< A reference to the owning object
@@ -107,13 +405,15 @@ namespace TiledArray {
 
         DelayedSet(DistributedStorage_& ds, size_type i, const future& f) :
             ds_(ds), index_(i), future_(f)
-        { }
+        { ds_.begin_operation(); }
 
         virtual ~DelayedSet() { }
 
         virtual void notify() {
-          ds_.set_remote(index_, future_);
+          DistributedStorage_& ds = ds_;
+          ds.set_remote(index_, future_);
           delete this;
+          ds.end_operation();
         }
       }; // struct DelayedSet
 
@@ -128,17 +428,33 @@ namespace TiledArray {
       /// \param world The world where the distributed container lives
       /// \param max_size The maximum capacity of this container
       /// \param pmap The process map for the container (default = null pointer)
+      /// \param dense Store the local elements in dense slots instead of a
+      /// hash map, e.g. when all local elements will be set
+      /// [ default = false ]
       DistributedStorage(World& world, size_type max_size,
-          const std::shared_ptr<pmap_interface>& pmap) :
+          const std::shared_ptr<pmap_interface>& pmap, const bool dense = false) :
         WorldObject_(world), max_size_(max_size),
         pmap_(pmap),
-        data_((max_size / world.size()) + 11)
+        data_(dense ? 1 : (max_size / world.size()) + 11),
+        slot_index_(), slots_(), contiguous_(false),
+        buffer_size_(0ul), buffers_(), buffer_lock_(), in_flight_(1ul),
+        release_op_()
       {
         // Check that the process map is appropriate for this storage object
         TA_ASSERT(pmap_);
         TA_ASSERT(pmap_->size() == max_size);
         TA_ASSERT(pmap_->rank() == pmap_interface::size_type(world.rank()));
         TA_ASSERT(pmap_->procs() == pmap_interface::size_type(world.size()));
+
+        // Construct the dense slots before pending messages are processed
+        if(dense && ! pmap_->empty()) {
+          slot_index_.assign(pmap_->begin(), pmap_->end());
+          std::sort(slot_index_.begin(), slot_index_.end());
+          contiguous_ = (slot_index_.back() - slot_index_.front() + 1ul) ==
+              slot_index_.size();
+          slots_.resize(slot_index_.size());
+        }
+
         WorldObject_::process_pending();
       }
 
@@ -146,6 +462,45 @@ namespace TiledArray {
 
       using WorldObject_::get_world;
 
+      /// Record the start of an operation that references this object
+
+      /// The object is not deleted by \c release() before the operation ends.
+      void begin_operation() const {
+        in_flight_.fetch_add(1ul, std::memory_order_relaxed);
+      }
+
+      /// Record the end of an operation that references this object
+
+      /// The last operation after \c release() calls the release operation,
+      /// so this object must not be accessed after this function is called.
+      void end_operation() const {
+        if(in_flight_.fetch_sub(1ul, std::memory_order_acq_rel) == 1ul) {
+          std::function<void()> op =
+              std::move(const_cast<DistributedStorage_*>(this)->release_op_);
+          op();
+        }
+      }
+
+      /// Release this object
+
+      /// \c op is called, e.g. to delete this object, as soon as no in-flight
+      /// operation references this object, which may be immediately. This
+      /// function is called once, when no process uses this object anymore.
+      /// \param op The release operation
+      void release(std::function<void()> op) {
+        TA_ASSERT(op);
+        release_op_ = std::move(op);
+        end_operation();
+      }
+
+      /// In-flight operations
+
+      /// \return The number of local operations that reference this object
+      size_type in_flight() const {
+        const size_type count = in_flight_.load(std::memory_order_acquire);
+        return (release_op_ ? count : count - 1ul);
+      }
+
       /// Process map accessor
 
       /// \return A shared pointer to the process map.
@@ -173,12 +528,37 @@ namespace TiledArray {
         return pmap_->is_local(i);
       }
 
+      /// Check that the local elements are stored in dense slots
+
+      /// \return \c true if this container stores all local elements in
+      /// dense slots, otherwise \c false
+      /// \throw nothing
+      bool is_dense() const { return ! slots_.empty(); }
+
       /// Number of local elements
 
       /// No communication.
-      /// \return The number of local elements stored by the container.
+      /// \return The number of local elements stored by the container, which
+      /// is the number of local elements of the process map when the elements
+      /// are stored in dense slots.
       /// \throw nothing
-      size_type size() const { return data_.size(); }
+      size_type size() const {
+        return (slots_.empty() ? data_.size() : slots_.size());
+      }
+
+      /// Remove a local element
+
+      /// No communication. The future of element \c i is released, so it must
+      /// not be needed by pending tasks.
+      /// \param i The local element to remove
+      /// \throw TiledArray::Exception If \c i is not local.
+      void erase(size_type i) {
+        TA_ASSERT(is_local(i));
+        if(slots_.empty())
+          data_.erase(i);
+        else
+          slots_[slot(i)] = future();
+      }
 
       /// Max size accessor
 
@@ -200,6 +580,10 @@ namespace TiledArray {
         } else {
           // Send a request to the owner of i for the element.
           future result;
+          if(buffer_size_) {
+            buffer_get(owner(i), i, result.remote_ref(get_world()));
+            return result;
+          }
           WorldObject_::task(owner(i), & DistributedStorage_::get_handler, i,
               result.remote_ref(get_world()), madness::TaskAttributes::hipri());
 
@@ -207,6 +591,69 @@ namespace TiledArray {
         }
       }
 
+      /// Get several local or remote elements
+
+      /// The requests for the remote elements are sent in one message per
+      /// owner, independent of \c aggregate() , and are not buffered.
+      /// \param indices The elements to get
+      /// \return The futures to the elements, in the order of \c indices
+      /// \throw TiledArray::Exception If an index is greater than or equal
+      /// to \c max_size() .
+      std::vector<future> get_batch(const std::vector<size_type>& indices) const {
+        std::vector<future> result;
+        result.reserve(indices.size());
+        std::unordered_map<ProcessID, std::pair<std::vector<size_type>,
+            std::vector<typename future::remote_refT> > > requests;
+        for(const size_type i : indices) {
+          TA_ASSERT(i < max_size_);
+          if(is_local(i)) {
+            result.push_back(get_local(i));
+          } else {
+            result.push_back(future());
+            auto& request = requests[owner(i)];
+            request.first.push_back(i);
+            request.second.push_back(result.back().remote_ref(get_world()));
+          }
+        }
+
+        for(const auto& request : requests)
+          WorldObject_::task(request.first, & DistributedStorage_::get_batch_handler,
+              request.second.first, request.second.second, get_world().rank(),
+              madness::TaskAttributes::hipri());
+
+        return result;
+      }
+
+      /// Get a remote element into a receive buffer
+
+      /// The data of element \c i is sent from the memory of the element on
+      /// its owner into the memory of \c buffer , with point-to-point
+      /// messages, instead of being serialized (see \c ZeroCopy ).
+      /// \tparam U The element type
+      /// \param i The element to get
+      /// \param buffer An element with the range of element \c i , which
+      /// will hold its data
+      /// \return A future to element \c i
+      /// \throw TiledArray::Exception If \c i is greater than or equal to \c max_size() .
+      template <typename U = value_type,
+          typename std::enable_if<has_tile_buffer<U>::value>::type* = nullptr>
+      future get(size_type i, value_type buffer) const {
+        TA_ASSERT(i < max_size_);
+        if(is_local(i))
+          return get_local(i);
+
+        future result;
+        const int tag = get_world().mpi.unique_tag();
+        BufferTransferTask::recv(get_world(), tile_buffer(buffer), owner(i), tag,
+            [result,buffer] () mutable {
+              count_received(buffer);
+              result.set(buffer);
+            });
+        WorldObject_::task(owner(i), & DistributedStorage_::send_buffer_handler,
+            i, get_world().rank(), tag, madness::TaskAttributes::hipri());
+        return result;
+      }
+
       /// Set element \c i with \c value
 
       /// \param i The element to be set
@@ -232,7 +679,16 @@ namespace TiledArray {
       /// \throw TiledArray::Exception If \c i is greater than or equal to \c max_size() .
       void set(size_type i, const future& f) {
         TA_ASSERT(i < max_size_);
-        if(is_local(i)) {
+        if(is_local(i) && ! slots_.empty()) {
+          future existing_f = slots_[slot(i)];
+
+          // Check that the future has not been set already.
+#ifndef NDEBUG
+          if(existing_f.probe())
+            TA_EXCEPTION("Tile has already been assigned.");
+#endif // NDEBUG
+          existing_f.set(f);
+        } else if(is_local(i)) {
           const_accessor acc;
           if(! data_.insert(acc, typename container_type::datumT(i, f))) {
             // The element was already in the container, so set it with f.
@@ -257,6 +713,75 @@ namespace TiledArray {
         }
       }
 
+      /// Aggregate remote requests
+
+      /// Remote sets and gets are buffered for each destination process,
+      /// and the buffer of a process is sent in one message when it holds
+      /// \c buffer_size requests of either kind, e.g. when a non-owner
+      /// process fills the elements of the container. The buffered requests
+      /// are sent by \c flush() , which must be called before the fence that
+      /// completes them.
+      /// \param buffer_size The number of requests of each message, or zero
+      /// to send each request in its own message
+      /// \note The futures of buffered gets are not assigned until the
+      /// buffer is sent, so a buffered element must not be waited for before
+      /// \c flush() is called. This function must not be called while other
+      /// threads access this container.
+      void aggregate(const size_type buffer_size) {
+        flush();
+        buffer_size_ = buffer_size;
+        buffers_.resize(buffer_size_ ? get_world().size() : 0ul);
+      }
+
+      /// The number of buffered requests in each message
+
+      /// \return The number of remote requests that are sent together, or
+      /// zero if remote requests are not aggregated
+      size_type buffer_size() const { return buffer_size_; }
+
+      /// Send the buffered remote requests
+      void flush() const {
+        for(ProcessID dest = 0; dest < ProcessID(buffers_.size()); ++dest) {
+          Buffer buffer;
+          {
+            madness::ScopedMutex<madness::Spinlock> locker(& buffer_lock_);
+            std::swap(buffer, buffers_[dest]);
+          }
+          if(! buffer.set_indices.empty())
+            WorldObject_::task(dest, & DistributedStorage_::remote_set_batch_handler,
+                buffer.set_indices, buffer.set_values,
+                madness::TaskAttributes::hipri());
+          if(! buffer.get_indices.empty())
+            WorldObject_::task(dest, & DistributedStorage_::get_batch_handler,
+                buffer.get_indices, buffer.get_refs, get_world().rank(),
+                madness::TaskAttributes::hipri());
+        }
+      }
+
+      /// Set several elements that are owned by one process
+
+      /// The elements are sent to \c dest in one message, by a task that runs
+      /// when all of them are assigned, so the values of each message are
+      /// serialized while earlier messages are in transit.
+      /// \param dest The owner of the elements
+      /// \param indices The indices of the elements
+      /// \param futures The futures of the elements
+      /// \throw TiledArray::Exception If an element is not owned by \c dest
+      /// \throw madness::MadnessException If an element has already been set.
+      void set_batch(const ProcessID dest, std::vector<size_type> indices,
+          std::vector<future> futures)
+      {
+        TA_ASSERT(indices.size() == futures.size());
+#ifndef NDEBUG
+        for(const size_type i : indices)
+          TA_ASSERT(owner(i) == dest);
+#endif // NDEBUG
+        if(indices.empty())
+          return;
+        get_world().taskq.add(new DelayedSetBatch(*this, dest,
+            std::move(indices), std::move(futures)));
+      }
+
     }; // class DistributedStorage
 
   }  // namespace detail
@@ -0,0 +1,229 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EVAL_TILE_CACHE_H__INCLUDED
+#define TILEDARRAY_EVAL_TILE_CACHE_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+#include <TiledArray/type_traits.h>
+#include <TiledArray/tile_interface/cast.h>
+#include <TiledArray/tile_interface/clone.h>
+#include <list>
+#include <unordered_map>
+
+namespace TiledArray {
+
+  /// The lazy tiles of an array that are memoized when they are evaluated
+  enum class LazyTileCachePolicy {
+    never,              ///< No tile is cached
+    local,              ///< The local tiles are cached
+    local_and_received  ///< The local tiles, and the remote tiles received by this process, are cached
+  };
+
+  namespace detail {
+
+    /// Lazy tile evaluation trait
+
+    /// \c value is \c true when \c Tile is a lazy tile, other than a
+    /// \c LazyArrayTile , that is evaluated synchronously, i.e. when the
+    /// evaluated tiles of \c Tile may be cached by \c EvalTileCache .
+    /// \tparam Tile The tile type
+    template <typename Tile>
+    struct is_cacheable_lazy_tile :
+        public std::integral_constant<bool, is_non_array_lazy_tile<Tile>::value &&
+            (! eval_trait<Tile>::nonblocking)>
+    { };
+
+    /// Memoizing cache of evaluated lazy tiles
+
+    /// The cache holds the evaluated tiles of the lazy tiles of one array
+    /// (e.g. tiles that compute integrals directly on evaluation), with
+    /// least-recently-used eviction, so a tile that is used by several
+    /// expressions, or in several iterations, is evaluated once. Which
+    /// tiles are cached is selected by a \c LazyTileCachePolicy : the local
+    /// tiles, or also the remote tiles that are received and evaluated by
+    /// this process. The total size of the cached tiles is limited by a
+    /// capacity in bytes. The cached tiles are copied when they are used,
+    /// since the evaluated tiles may be consumed by subsequent operations.
+    /// \note Two tasks that evaluate the same tile at the same time may
+    /// both evaluate it.
+    /// \note The cache must be cleared when the tiles of the array may have
+    /// been modified.
+    /// \tparam Tile The lazy tile type
+    template <typename Tile>
+    class EvalTileCache {
+    public:
+      typedef EvalTileCache<Tile> EvalTileCache_; ///< This object type
+      typedef std::size_t size_type; ///< Size type
+      typedef Tile value_type; ///< The lazy tile type
+      typedef typename eval_trait<Tile>::type eval_type; ///< The evaluated tile type
+
+    private:
+
+      /// A cached tile
+      struct Entry {
+        size_type index; ///< Tile index
+        size_type bytes; ///< The size of the tile data
+        eval_type tile; ///< The evaluated tile
+      }; // struct Entry
+
+      typedef std::list<Entry> list_type; ///< Cached tiles, most recently used first
+
+      mutable madness::Spinlock lock_; ///< Protects all members
+      LazyTileCachePolicy policy_; ///< The tiles that are cached
+      size_type capacity_; ///< The maximum size of the cached tiles, in bytes
+      size_type bytes_; ///< The size of the cached tiles, in bytes
+      list_type list_; ///< The cached tiles in the order of their use
+      std::unordered_map<size_type, typename list_type::iterator> map_; ///< Cached tile lookup
+      size_type hits_; ///< The number of evaluations found in the cache
+      size_type misses_; ///< The number of evaluations not found in the cache
+
+      /// Evict the least recently used tiles until the tiles fit
+
+      /// \param capacity The maximum size of the cached tiles
+      void evict(const size_type capacity) {
+        while(bytes_ > capacity) {
+          const Entry& entry = list_.back();
+          bytes_ -= entry.bytes;
+          map_.erase(entry.index);
+          list_.pop_back();
+        }
+      }
+
+      // Not allowed
+      EvalTileCache(const EvalTileCache_&);
+      EvalTileCache_& operator=(const EvalTileCache_&);
+
+    public:
+
+      /// Construct a disabled cache
+      EvalTileCache() :
+        lock_(), policy_(LazyTileCachePolicy::never), capacity_(0ul),
+        bytes_(0ul), list_(), map_(), hits_(0ul), misses_(0ul)
+      { }
+
+      /// Check that a tile is cached
+
+      /// \param local \c true for a local tile, \c false for a received tile
+      /// \return \c true if the evaluation of the tile uses the cache
+      bool enabled(const bool local) const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return (capacity_ > 0ul) && ((policy_ == LazyTileCachePolicy::local_and_received) ||
+            (local && (policy_ == LazyTileCachePolicy::local)));
+      }
+
+      /// Set the policy and the capacity of the cache
+
+      /// Tiles are evicted until the cached tiles fit in \c capacity .
+      /// \param policy The tiles that are cached
+      /// \param capacity The maximum size of the cached tiles, in bytes
+      void enable(const LazyTileCachePolicy policy, const size_type capacity) {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        policy_ = policy;
+        capacity_ = (policy == LazyTileCachePolicy::never ? 0ul : capacity);
+        evict(capacity_);
+      }
+
+      /// Policy accessor
+
+      /// \return The tiles that are cached
+      LazyTileCachePolicy policy() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return policy_;
+      }
+
+      /// Capacity accessor
+
+      /// \return The maximum size of the cached tiles, in bytes
+      size_type capacity() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return capacity_;
+      }
+
+      /// Evaluate a lazy tile, or find its evaluated tile in the cache
+
+      /// \param index The tile index
+      /// \param tile The lazy tile
+      /// \return The evaluated tile, which is not shared with the cache
+      eval_type evaluate(const size_type index, const value_type& tile) {
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+          const auto it = map_.find(index);
+          if(it != map_.end()) {
+            ++hits_;
+            list_.splice(list_.begin(), list_, it->second);
+            return clone(it->second->tile);
+          }
+          ++misses_;
+        }
+
+        // Evaluate the tile without holding the lock
+        eval_type result = invoke_cast(tile);
+        const size_type bytes = result.size() *
+            sizeof(typename numeric_type<eval_type>::type);
+
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        if((bytes <= capacity_) && (map_.find(index) == map_.end())) {
+          evict(capacity_ - bytes);
+          list_.push_front(Entry{index, bytes, clone(result)});
+          map_.emplace(index, list_.begin());
+          bytes_ += bytes;
+        }
+        return result;
+      }
+
+      /// Remove all tiles from the cache
+
+      /// The hit and miss counters are not reset.
+      void clear() {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        evict(0ul);
+      }
+
+      /// The size of the cached tiles
+
+      /// \return The size of the cached tiles, in bytes
+      size_type bytes() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return bytes_;
+      }
+
+      /// Hit counter accessor
+
+      /// \return The number of evaluations that were found in the cache
+      size_type hits() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return hits_;
+      }
+
+      /// Miss counter accessor
+
+      /// \return The number of evaluations that were not found in the cache
+      size_type misses() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return misses_;
+      }
+
+    }; // class EvalTileCache
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_EVAL_TILE_CACHE_H__INCLUDED
@@ -38,13 +38,44 @@ namespace TiledArray {
     template <typename, typename, typename> class ScalAddExpr;
     template <typename, typename, typename> class AddEngine;
     template <typename, typename, typename, typename> class ScalAddEngine;
+    template <typename, typename, bool> class TsrEngine;
+    template <typename, typename, typename> class MultEngine;
+    template <typename, typename, typename, typename> class ScalMultEngine;
+
+    /// Check that the sum of two engines can be accumulated into an array
+
+    /// The sum of an array and a contraction, e.g. <tt>c("i,j") +
+    /// a("i,k") * b("k,j")</tt> , is evaluated by accumulating the
+    /// contraction into the tiles of the array, when the array, the
+    /// contraction, and the sum have the same tile type.
+    /// \tparam Left The left-hand engine type
+    /// \tparam Right The right-hand engine type
+    /// \tparam Value The result tile type
+    template <typename Left, typename Right, typename Value>
+    struct is_accumulate_add : public std::false_type { };
+
+    template <typename Array, typename R, bool Alias, typename L,
+        typename Rt, typename Result, typename Value>
+    struct is_accumulate_add<TsrEngine<Array, R, Alias>,
+        MultEngine<L, Rt, Result>, Value> :
+      public std::integral_constant<bool,
+          std::is_same<typename std::decay<Array>::type::value_type, Value>::value &&
+          std::is_same<typename EngineTrait<MultEngine<L, Rt, Result> >::value_type,
+              Value>::value>
+    { };
+
+    template <typename Array, typename R, bool Alias, typename L,
+        typename Rt, typename Scalar, typename Result, typename Value>
+    struct is_accumulate_add<TsrEngine<Array, R, Alias>,
+        ScalMultEngine<L, Rt, Scalar, Result>, Value> :
+      public std::integral_constant<bool,
+          std::is_same<typename std::decay<Array>::type::value_type, Value>::value &&
+          std::is_same<typename EngineTrait<MultEngine<L, Rt, Result> >::value_type,
+              Value>::value>
+    { };
 
     template <typename Left, typename Right, typename Result>
     struct EngineTrait<AddEngine<Left, Right, Result> > {
-      static_assert(std::is_same<typename EngineTrait<Left>::policy,
-          typename EngineTrait<Right>::policy>::value,
-          "The left- and right-hand expressions must use the same policy class");
-
       // Argument typedefs
       typedef Left left_type; ///< The left-hand expression type
       typedef Right right_type; ///< The right-hand expression type
@@ -60,7 +91,8 @@ namespace TiledArray {
           value_type; ///< The result tile type
       typedef typename eval_trait<value_type>::type
           eval_type;  ///< Evaluation tile type
-      typedef typename Left::policy policy; ///< The result policy type
+      typedef typename TiledArray::detail::add_policy<typename Left::policy,
+          typename Right::policy>::type policy; ///< The result policy type
       typedef TiledArray::detail::DistEval<value_type, policy>
           dist_eval_type; ///< The distributed evaluator type
 
@@ -78,10 +110,6 @@ namespace TiledArray {
 
     template <typename Left, typename Right, typename Scalar, typename Result>
     struct EngineTrait<ScalAddEngine<Left, Right, Scalar, Result> > {
-      static_assert(std::is_same<typename EngineTrait<Left>::policy,
-          typename EngineTrait<Right>::policy>::value,
-          "The left- and right-hand expressions must use the same policy class");
-
       // Argument typedefs
       typedef Left left_type; ///< The left-hand expression type
       typedef Right right_type; ///< The right-hand expression type
@@ -99,7 +127,8 @@ namespace TiledArray {
           value_type; ///< The result tile type
       typedef typename eval_trait<value_type>::type
           eval_type;  ///< Evaluation tile type
-      typedef typename Left::policy policy; ///< The result policy type
+      typedef typename TiledArray::detail::add_policy<typename Left::policy,
+          typename Right::policy>::type policy; ///< The result policy type
       typedef TiledArray::detail::DistEval<value_type, policy>
           dist_eval_type; ///< The distributed evaluator type
 
@@ -170,7 +199,7 @@ namespace TiledArray {
 
       /// \return The result shape
       shape_type make_shape() const {
-        return BinaryEngine_::left_.shape().add(BinaryEngine_::right_.shape());
+        return BinaryEngine_::left_shape().add(BinaryEngine_::right_shape());
       }
 
       /// Permuting shape factory function
@@ -178,7 +207,7 @@ namespace TiledArray {
       /// \param perm The permutation to be applied to the array
       /// \return The result shape
       shape_type make_shape(const Permutation& perm) const {
-        return BinaryEngine_::left_.shape().add(BinaryEngine_::right_.shape(), perm);
+        return BinaryEngine_::left_shape().add(BinaryEngine_::right_shape(), perm);
       }
 
       /// Non-permuting tile operation factory function
@@ -199,6 +228,37 @@ namespace TiledArray {
       /// \return An expression tag used to identify this expression
       const char* make_tag() const { return "[+] "; }
 
+      /// Construct the distributed evaluator for this expression
+
+      /// The sum of an array and a contraction is evaluated by accumulating
+      /// the contraction into the tiles of the array (see
+      /// \c is_accumulate_add ), if neither the array nor the sum is
+      /// permuted and the contraction is not shared with other
+      /// subexpressions.
+      /// \return The distributed evaluator that will evaluate this expression
+      dist_eval_type make_dist_eval() const {
+        return make_dist_eval(is_accumulate_add<left_type, right_type, value_type>());
+      }
+
+    private:
+
+      dist_eval_type make_dist_eval(std::true_type) const {
+        const left_type& left = BinaryEngine_::left();
+        const right_type& right = BinaryEngine_::right();
+        const CommonSubexprRegistry* const registry =
+            CommonSubexprRegistry::current();
+
+        if((! ExprEngine_::perm()) && (! left.perm()) && right.is_accumulable()
+            && ((registry == nullptr) || (registry->consumers(right.cse_key()) < 2u)))
+          return right.make_accumulate_dist_eval(left.array(), ExprEngine_::shape());
+
+        return BinaryEngine_::make_dist_eval();
+      }
+
+      dist_eval_type make_dist_eval(std::false_type) const {
+        return BinaryEngine_::make_dist_eval();
+      }
+
     }; // class AddEngine
 
 
@@ -272,7 +332,7 @@ namespace TiledArray {
 
       /// \return The result shape
       shape_type make_shape() const {
-        return BinaryEngine_::left_.shape().add(BinaryEngine_::right_.shape(),
+        return BinaryEngine_::left_shape().add(BinaryEngine_::right_shape(),
             factor_);
       }
 
@@ -281,7 +341,7 @@ namespace TiledArray {
       /// \param perm The permutation to be applied to the array
       /// \return The result shape
       shape_type make_shape(const Permutation& perm) const {
-        return BinaryEngine_::left_.shape().add(BinaryEngine_::right_.shape(),
+        return BinaryEngine_::left_shape().add(BinaryEngine_::right_shape(),
             factor_, perm);
       }
 
@@ -301,7 +361,7 @@ namespace TiledArray {
       /// Scaling factor accessor
 
       /// \return The scaling factor
-      scalar_type factor() { return factor_; }
+      scalar_type factor() const { return factor_; }
 
       /// Expression identification tag
 
@@ -314,6 +374,37 @@ namespace TiledArray {
 
     }; // class ScalAddEngine
 
+    /// Fusion interface of \c AddEngine
+    template <typename Left, typename Right, typename Result>
+    struct FusedEngine<AddEngine<Left, Right, Result> > :
+        public FusedBinaryEngine<AddEngine<Left, Right, Result> >
+    {
+      template <std::size_t I>
+      static auto make_kernel(const AddEngine<Left, Right, Result>& engine) {
+        return TiledArray::detail::make_fused_plus(
+            FusedEngine<Left>::template make_kernel<I>(engine.left()),
+            FusedEngine<Right>::template make_kernel<I + FusedEngine<Left>::arity>(
+                engine.right()));
+      }
+    }; // struct FusedEngine<AddEngine>
+
+    /// Fusion interface of \c ScalAddEngine with a numeric scaling factor
+    template <typename Left, typename Right, typename Scalar, typename Result>
+    struct FusedEngine<ScalAddEngine<Left, Right, Scalar, Result>,
+        typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value>::type> :
+        public FusedBinaryEngine<ScalAddEngine<Left, Right, Scalar, Result> >
+    {
+      template <std::size_t I>
+      static auto make_kernel(const ScalAddEngine<Left, Right, Scalar, Result>& engine) {
+        return TiledArray::detail::make_fused_scal(
+            TiledArray::detail::make_fused_plus(
+                FusedEngine<Left>::template make_kernel<I>(engine.left()),
+                FusedEngine<Right>::template make_kernel<I + FusedEngine<Left>::arity>(
+                    engine.right())),
+            engine.factor());
+      }
+    }; // struct FusedEngine<ScalAddEngine>
+
   }  // namespace expressions
 } // namespace TiledArray
 
@@ -28,6 +28,8 @@
 
 #include <TiledArray/expressions/expr_engine.h>
 #include <TiledArray/dist_eval/binary_eval.h>
+#include <TiledArray/expressions/fused_engine.h>
+#include <TiledArray/policies/mixed_policy.h>
 
 namespace TiledArray {
   namespace expressions {
@@ -77,6 +79,22 @@ namespace TiledArray {
       left_type left_; ///< The left-hand argument
       right_type right_; ///< The right-hand argument
 
+      /// The shape of the left-hand argument in the result shape algebra
+
+      /// \return The left-hand argument shape, converted to \c shape_type
+      /// when the arguments have different policies
+      decltype(auto) left_shape() const {
+        return TiledArray::detail::shape_cast<shape_type>(left_);
+      }
+
+      /// The shape of the right-hand argument in the result shape algebra
+
+      /// \return The right-hand argument shape, converted to \c shape_type
+      /// when the arguments have different policies
+      decltype(auto) right_shape() const {
+        return TiledArray::detail::shape_cast<shape_type>(right_);
+      }
+
     public:
 
       template <typename D>
@@ -84,18 +102,51 @@ namespace TiledArray {
         ExprEngine_(expr), left_(expr.left()), right_(expr.right())
       { }
 
-      /// Set the variable list for this expression
+      /// Tile norms of a dense argument of a sparse result
+
+      /// The norms of a binary expression are not computed before it is
+      /// evaluated (see \c detail::ShapeCast ).
+      /// \tparam T The norm type of the shape
+      template <typename T>
+      SparseShape<T> norm_shape() const {
+        static_assert(sizeof(T) == 0ul, "TiledArray::expressions::BinaryEngine: "
+            "a dense product, sum, or contraction must be evaluated into an "
+            "array before it is combined with a sparse array");
+        return SparseShape<T>();
+      }
+
+      /// Estimated number of elements of the result
+
+      /// \return The larger of the estimated number of elements of the
+      /// arguments
+      size_type data_elements() const {
+        return std::max<size_type>(left_.data_elements(), right_.data_elements());
+      }
+
+      /// Estimated cost of a variable list
 
-      /// This function will set the variable list for this expression and its
-      /// children such that the number of permutations is minimized. The final
-      /// variable list may not be set to target, which indicates that the
-      /// result of this expression will be permuted to match \c target_vars.
       /// \param target_vars The target variable list for this expression
-      void perm_vars(const VariableList& target_vars) {
-        TA_ASSERT(permute_tiles_);
-        TA_ASSERT(left_.vars().dim() == target_vars.dim());
-        TA_ASSERT(right_.vars().dim() == target_vars.dim());
+      /// \return The estimated number of elements that are permuted by this
+      /// expression and its children to produce \c target_vars
+      size_type perm_cost(const VariableList& target_vars) const {
+        VariableList vars;
+        return perm_plan(target_vars, vars);
+      }
 
+    private:
+
+      /// Choose the variable list of this expression
+
+      /// The arguments are evaluated with the target variable list, or with
+      /// the variable list of one of the arguments, in which case the result
+      /// is permuted. The variable list that permutes the fewest elements in
+      /// the whole engine tree is chosen, e.g. the permutation is applied to
+      /// the smallest leaf or to the result instead of to both arguments.
+      /// Ties are resolved in favor of the argument with fewer leaves.
+      /// \param target_vars The target variable list for this expression
+      /// \param[out] vars The variable list of the arguments
+      /// \return The estimated number of elements that are permuted
+      size_type perm_plan(const VariableList& target_vars, VariableList& vars) const {
         // Determine the equality of the variable lists
         bool left_target = true, right_target = true, left_right = true;
         for(unsigned int i = 0u; i < target_vars.dim(); ++i) {
@@ -104,21 +155,54 @@ namespace TiledArray {
           left_right = left_right && left_.vars()[i] == right_.vars()[i];
         }
 
-        if(left_right) {
-          vars_ = left_.vars();
-        } else {
-          // Determine which argument will be permuted
-          const bool perm_left = (right_target || ((! (left_target || right_target))
-              && (left_type::leaves <= right_type::leaves)));
-
-          if(perm_left) {
-            vars_ = right_.vars();
-            left_.perm_vars(right_.vars());
-          } else {
-            vars_ = left_.vars();
-            right_.perm_vars(left_.vars());
+        // Select the argument that is permuted if the costs are equal
+        const bool perm_left = (right_target || ((! (left_target || right_target))
+            && (left_type::leaves <= right_type::leaves)));
+        vars = ((left_right || (! perm_left)) ? left_.vars() : right_.vars());
+
+        auto cost = [&] (const VariableList& arg_vars) -> size_type {
+          return left_.perm_cost(arg_vars) + right_.perm_cost(arg_vars) +
+              (arg_vars != target_vars ? ExprEngine_::derived().data_elements() : 0ul);
+        };
+
+        size_type min_cost = cost(vars);
+        for(const VariableList* candidate : { &target_vars, &left_.vars(), &right_.vars() }) {
+          if(*candidate == vars)
+            continue;
+
+          const size_type candidate_cost = cost(*candidate);
+          if(candidate_cost < min_cost) {
+            min_cost = candidate_cost;
+            vars = *candidate;
           }
         }
+
+        return min_cost;
+      }
+
+    public:
+
+      /// Set the variable list for this expression
+
+      /// This function will set the variable list for this expression and its
+      /// children such that the number of permuted elements is minimized (see
+      /// \c perm_plan() ). The final variable list may not be set to target,
+      /// which indicates that the result of this expression will be permuted
+      /// to match \c target_vars.
+      /// \param target_vars The target variable list for this expression
+      void perm_vars(const VariableList& target_vars) {
+        TA_ASSERT(permute_tiles_);
+        TA_ASSERT(left_.vars().dim() == target_vars.dim());
+        TA_ASSERT(right_.vars().dim() == target_vars.dim());
+
+        VariableList vars;
+        perm_plan(target_vars, vars);
+
+        if(left_.vars() != vars)
+          left_.perm_vars(vars);
+        if(right_.vars() != vars)
+          right_.perm_vars(vars);
+        vars_ = vars;
       }
 
       /// Initialize the variable list of this expression
@@ -183,6 +267,32 @@ namespace TiledArray {
         ExprEngine_::init_distribution(world, left_.pmap());
       }
 
+      /// Update this engine with the arrays of an expression
+
+      /// The shapes of the arguments and the result are recomputed from the
+      /// current arrays of \c expr , which must have the same structure as
+      /// the expression this engine was initialized with.
+      /// \tparam D The derived expression type
+      /// \param expr The expression
+      template <typename D>
+      void update(const BinaryExpr<D>& expr) {
+        left_.update(expr.left());
+        right_.update(expr.right());
+        ExprEngine_::derived().update_shape();
+      }
+
+      /// Result tiles that depend on modified argument tiles
+
+      /// \return A flag for each result tile whose left- or right-hand
+      /// argument tile is dirty
+      std::vector<bool> dirty_tiles() const {
+        std::vector<bool> dirty = left_.dirty_tiles();
+        const std::vector<bool> right_dirty = right_.dirty_tiles();
+        for(size_type i = 0ul; i < dirty.size(); ++i)
+          dirty[i] = dirty[i] || right_dirty[i];
+        return ExprEngine_::permute_dirty_tiles(dirty);
+      }
+
       /// Non-permuting tiled range factory function
 
       /// \return The result tiled range
@@ -196,16 +306,40 @@ namespace TiledArray {
         return perm * left_.trange();
       }
 
+      /// Left-hand argument engine accessor
+
+      /// \return A const reference to the left-hand argument engine
+      const left_type& left() const { return left_; }
+
+      /// Right-hand argument engine accessor
+
+      /// \return A const reference to the right-hand argument engine
+      const right_type& right() const { return right_; }
+
       /// Construct the distributed evaluator for this expression
 
+      /// Trees of element-wise operations that are not permuted are evaluated
+      /// with a single fused evaluator (see \c FusedEngine ).
       /// \return The distributed evaluator that will evaluate this expression
       dist_eval_type make_dist_eval() const {
+        return make_dist_eval(is_fused_root<Derived>());
+      }
+
+    private:
+
+      dist_eval_type make_dist_eval(std::true_type) const {
+        if(FusedEngine<Derived>::is_fusable(ExprEngine_::derived()))
+          return make_fused_dist_eval(ExprEngine_::derived());
+        return make_dist_eval(std::false_type());
+      }
+
+      dist_eval_type make_dist_eval(std::false_type) const {
         typedef TiledArray::detail::BinaryEvalImpl<typename left_type::dist_eval_type,
             typename right_type::dist_eval_type, op_type, policy> impl_type;
 
         // Construct left and right distributed evaluators
-        const typename left_type::dist_eval_type left = left_.make_dist_eval();
-        const typename right_type::dist_eval_type right = right_.make_dist_eval();
+        const typename left_type::dist_eval_type left = make_arg_dist_eval(left_);
+        const typename right_type::dist_eval_type right = make_arg_dist_eval(right_);
 
         // Construct the distributed evaluator type
         std::shared_ptr<impl_type> pimpl =
@@ -215,6 +349,44 @@ namespace TiledArray {
         return dist_eval_type(pimpl);
       }
 
+      void cse_visit(CommonSubexprRegistry& registry, std::true_type) const {
+        if(FusedEngine<Derived>::is_fusable(ExprEngine_::derived()))
+          FusedEngine<Derived>::cse_visit(registry, ExprEngine_::derived());
+        else
+          cse_visit(registry, std::false_type());
+      }
+
+      void cse_visit(CommonSubexprRegistry& registry, std::false_type) const {
+        registry.visit(left_);
+        registry.visit(right_);
+      }
+
+    public:
+
+      /// Common subexpression key
+
+      /// \return A string that identifies this expression and its arguments
+      std::string cse_key() const {
+        return ExprEngine_::cse_key() + " (" + left_.cse_key() + ", " +
+            right_.cse_key() + ")";
+      }
+
+      /// Count the consumers of the subexpressions of this expression
+
+      /// \param registry The common subexpressions of the statement
+      void cse_visit(CommonSubexprRegistry& registry) const {
+        cse_visit(registry, is_fused_root<Derived>());
+      }
+
+      /// Number of permuted elements
+
+      /// \return The estimated number of elements that are permuted by this
+      /// expression and its children
+      size_type perm_elements() const {
+        return ExprEngine_::perm_elements() + left_.perm_elements() +
+            right_.perm_elements();
+      }
+
       /// Expression print
 
       /// \param os The output stream
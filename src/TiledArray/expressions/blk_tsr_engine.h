@@ -27,6 +27,7 @@
 #define TILEDARRAY_EXPRESSIONS_BLK_TSR_ENGINE_H__INCLUDED
 
 #include <TiledArray/expressions/leaf_engine.h>
+#include <TiledArray/pmap/block_pmap.h>
 #include <TiledArray/tile_op/shift.h>
 
 namespace TiledArray {
@@ -72,7 +73,10 @@ namespace TiledArray {
       typedef typename policy::pmap_interface
           pmap_interface; ///< Process map interface type
 
-      static constexpr bool consumable = true;
+      // Note: the block tiles are shifted views of the array tiles, which may
+      // be consumed only when the array tiles are consumable.
+      static constexpr bool consumable = (! Alias) ||
+          eval_trait<typename array_type::value_type>::is_consumable;
       static constexpr unsigned int leaves = 1;
     };
 
@@ -170,6 +174,12 @@ namespace TiledArray {
         lower_bound_(expr.lower_bound()), upper_bound_(expr.upper_bound())
       { }
 
+      /// Result tiles that depend on modified array tiles
+
+      /// The tiles of a block are not tracked.
+      /// \return A flag for each result tile, which are all set
+      std::vector<bool> dirty_tiles() const { return ExprEngine_::dirty_tiles(); }
+
       template <typename Array, typename Scalar>
       BlkTsrEngineBase(const ScalBlkTsrExpr<Array, Scalar>& expr) :
         LeafEngine_(expr),
@@ -253,11 +263,47 @@ namespace TiledArray {
       }
 
 
+      /// Initialize the distribution of the block
+
+      /// When no process map is given, e.g. for the stationary argument of a
+      /// contraction, the tiles of the block are evaluated where the array
+      /// tiles are stored (see \c BlockPmap ), so the block is not moved.
+      /// \param world The world where the block will be evaluated
+      /// \param pmap The process map of the block tiles
       void init_distribution(World* world,
           const std::shared_ptr<pmap_interface>& pmap)
       {
-        ExprEngine_::init_distribution(world,
-            (pmap ? pmap : policy::default_pmap(*world, trange_.tiles_range().volume())));
+        if(pmap)
+          ExprEngine_::init_distribution(world, pmap);
+        else if(world == & array_.world())
+          ExprEngine_::init_distribution(world,
+              std::make_shared<TiledArray::detail::BlockPmap>(*world,
+                  array_.pmap(), array_.trange().tiles_range(), lower_bound_,
+                  upper_bound_, perm_));
+        else
+          ExprEngine_::init_distribution(world,
+              policy::default_pmap(*world, trange_.tiles_range().volume()));
+      }
+
+      /// Cached layout factory function
+
+      /// The bounds of a block refer to the index order of the array, so the
+      /// cached layouts of the array are not used.
+      /// \return An uninitialized array
+      array_type make_layout(const VariableList&) const { return array_type(); }
+
+      /// Count the elements of the non-zero tiles of the block
+
+      /// \return The number of elements of the non-zero tiles of the block
+      size_type make_data_elements() const {
+        const auto& tiles_range = array_.trange().tiles_range();
+        size_type result = 0ul;
+        for(const auto& index : Range(lower_bound_, upper_bound_)) {
+          const size_type i = tiles_range.ordinal(index);
+          if(! array_.is_zero(i))
+            result += array_.trange().make_tile_range(i).volume();
+        }
+        return result;
       }
 
       /// Construct the distributed evaluator for array
@@ -370,6 +416,17 @@ namespace TiledArray {
         return array_.shape().block(lower_bound_, upper_bound_, perm);
       }
 
+      /// Tile norms of a dense argument of a sparse result
+
+      /// \tparam T The norm type of the shape
+      /// \return The shape of the tile norms of the result
+      template <typename T>
+      SparseShape<T> norm_shape() const {
+        const SparseShape<T> shape = LeafEngine_::template array_norm_shape<T>();
+        return (perm_ ? shape.block(lower_bound_, upper_bound_, perm_) :
+            shape.block(lower_bound_, upper_bound_));
+      }
+
       /// Non-permuting tile operation factory function
 
       /// \return The tile operation
@@ -510,6 +567,17 @@ namespace TiledArray {
         return array_.shape().block(lower_bound_, upper_bound_, factor_, perm);
       }
 
+      /// Tile norms of a dense argument of a sparse result
+
+      /// \tparam T The norm type of the shape
+      /// \return The shape of the tile norms of the result
+      template <typename T>
+      SparseShape<T> norm_shape() const {
+        const SparseShape<T> shape = LeafEngine_::template array_norm_shape<T>();
+        return (perm_ ? shape.block(lower_bound_, upper_bound_, factor_, perm_) :
+            shape.block(lower_bound_, upper_bound_, factor_));
+      }
+
       /// Non-permuting tile operation factory function
 
       /// \return The tile operation
@@ -298,6 +298,9 @@ namespace TiledArray {
 
       /// Expression plus-assignment operator
 
+      /// The tiles of \c other are added to the array tiles in place (see
+      /// \c Expr::eval_accumulate_to() ). Expressions that choose their own
+      /// distribution, e.g. contractions, are added to a copy of the block.
       /// \tparam D The derived expression type
       /// \param other The expression that will be added to this array
       template <typename D>
@@ -305,11 +308,17 @@ namespace TiledArray {
         static_assert(TiledArray::expressions::is_aliased<D>::value,
             "no_alias() expressions are not allowed on the right-hand side of "
             "the assignment operator.");
+        if(other.derived().eval_accumulate_to(*this, false))
+          return BlkTsrExprBase_::array_;
         return operator=(AddExpr<BlkTsrExpr_, D>(*this, other.derived()));
       }
 
       /// Expression minus-assignment operator
 
+      /// The tiles of \c other are subtracted from the array tiles in place
+      /// (see \c Expr::eval_accumulate_to() ). Expressions that choose their
+      /// own distribution, e.g. contractions, are subtracted from a copy of
+      /// the block.
       /// \tparam D The derived expression type
       /// \param other The expression that will be subtracted from this array
       template <typename D>
@@ -317,6 +326,8 @@ namespace TiledArray {
         static_assert(TiledArray::expressions::is_aliased<D>::value,
             "no_alias() expressions are not allowed on the right-hand side of "
             "the assignment operator.");
+        if(other.derived().eval_accumulate_to(*this, true))
+          return BlkTsrExprBase_::array_;
         return operator=(SubtExpr<BlkTsrExpr_, D>(*this, other.derived()));
       }
 
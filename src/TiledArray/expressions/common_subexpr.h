@@ -0,0 +1,207 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_COMMON_SUBEXPR_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_COMMON_SUBEXPR_H__INCLUDED
+
+#include <TiledArray/dist_eval/shared_eval.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Common subexpressions of an expression statement
+
+    /// While the engines of a statement are constructed, structurally
+    /// identical subexpressions (the same expression types, arrays,
+    /// variables, scaling factors, permutations, and process maps) have the
+    /// same key. Before the distributed evaluators are constructed, the
+    /// registry counts the consumers of each key. A subexpression with more
+    /// than one consumer is then evaluated once, and each consumer receives
+    /// a \c SharedEvalImpl view of the result. Only subexpressions with at
+    /// least two leaves are shared, since array leaves are not evaluated.
+    class CommonSubexprRegistry {
+    private:
+
+      /// A subexpression of the statement
+      struct Entry {
+        unsigned int consumers; ///< The number of consumers
+        std::type_index type; ///< The distributed evaluator type
+        std::shared_ptr<void> source; ///< The shared source
+
+        Entry() : consumers(0u), type(typeid(void)), source() { }
+      }; // struct Entry
+
+      std::map<std::string, Entry> entries_; ///< Subexpressions by key
+      CommonSubexprRegistry* const previous_; ///< The enclosing registry
+
+      static CommonSubexprRegistry*& current_ptr() {
+        static thread_local CommonSubexprRegistry* current = nullptr;
+        return current;
+      }
+
+    public:
+
+      /// Activate a registry for the engine tree of a statement
+
+      /// The registry is active on this thread until it is destroyed.
+      /// \tparam Engine The root engine type
+      /// \param engine The initialized root engine of the statement
+      template <typename Engine>
+      explicit CommonSubexprRegistry(const Engine& engine) :
+        entries_(), previous_(current_ptr())
+      {
+        engine.cse_visit(*this);
+        current_ptr() = this;
+      }
+
+      CommonSubexprRegistry(const CommonSubexprRegistry&) = delete;
+      CommonSubexprRegistry& operator=(const CommonSubexprRegistry&) = delete;
+
+      ~CommonSubexprRegistry() { current_ptr() = previous_; }
+
+      /// The active registry
+
+      /// \return A pointer to the registry of the statement whose
+      /// distributed evaluators are being constructed on this thread, or
+      /// \c nullptr
+      static CommonSubexprRegistry* current() { return current_ptr(); }
+
+      /// Count a consumer of a subexpression
+
+      /// The subexpressions of \c engine are counted only for the first
+      /// consumer, since a shared subexpression is evaluated once.
+      /// \tparam Engine The engine type
+      /// \param engine The engine of a subexpression
+      template <typename Engine>
+      void visit(const Engine& engine) {
+        if(Engine::leaves >= 2u) {
+          Entry& entry = entries_[engine.cse_key()];
+          if(++entry.consumers > 1u)
+            return;
+        }
+        engine.cse_visit(*this);
+      }
+
+      /// The number of consumers of a subexpression
+
+      /// \param key The subexpression key
+      /// \return The number of consumers of \c key
+      unsigned int consumers(const std::string& key) const {
+        auto it = entries_.find(key);
+        return (it != entries_.end() ? it->second.consumers : 0u);
+      }
+
+      /// Construct the distributed evaluator of a subexpression
+
+      /// \tparam Engine The engine type
+      /// \param engine The engine of a subexpression
+      /// \return The distributed evaluator of \c engine , or a view of the
+      /// shared evaluator when \c engine has more than one consumer
+      template <typename Engine>
+      typename Engine::dist_eval_type make_dist_eval(const Engine& engine) {
+        typedef typename Engine::dist_eval_type dist_eval_type;
+        typedef TiledArray::detail::SharedEvalSource<typename dist_eval_type::value_type,
+            typename Engine::policy> source_type;
+        typedef TiledArray::detail::SharedEvalImpl<typename dist_eval_type::value_type,
+            typename Engine::policy> impl_type;
+
+        auto it = entries_.find(engine.cse_key());
+        if((it == entries_.end()) || (it->second.consumers < 2u))
+          return engine.make_dist_eval();
+
+        Entry& entry = it->second;
+        if(! entry.source) {
+          entry.type = std::type_index(typeid(dist_eval_type));
+          entry.source = std::make_shared<source_type>(engine.make_dist_eval(),
+              entry.consumers);
+        } else if(entry.type != std::type_index(typeid(dist_eval_type))) {
+          return engine.make_dist_eval();
+        }
+
+        return dist_eval_type(std::make_shared<impl_type>(
+            std::static_pointer_cast<source_type>(entry.source)));
+      }
+
+    }; // class CommonSubexprRegistry
+
+    /// Construct the distributed evaluator of an argument engine
+
+    /// Engines use this function for their arguments, so that common
+    /// subexpressions are evaluated once.
+    /// \tparam Engine The engine type
+    /// \param engine An argument engine
+    /// \return The distributed evaluator of \c engine
+    template <typename Engine>
+    inline typename Engine::dist_eval_type make_arg_dist_eval(const Engine& engine) {
+      CommonSubexprRegistry* const registry = CommonSubexprRegistry::current();
+      if((Engine::leaves < 2u) || (registry == nullptr))
+        return engine.make_dist_eval();
+      return registry->make_dist_eval(engine);
+    }
+
+    /// Construct the distributed evaluator of an expression statement
+
+    /// The common subexpressions of the statement are evaluated once.
+    /// \tparam Engine The root engine type
+    /// \param engine The initialized root engine of the statement
+    /// \return The distributed evaluator of \c engine
+    template <typename Engine>
+    inline typename Engine::dist_eval_type make_root_dist_eval(const Engine& engine) {
+      CommonSubexprRegistry registry(engine);
+      return engine.make_dist_eval();
+    }
+
+    namespace detail {
+
+      /// Process map fingerprint
+
+      /// The fingerprint is the same on all processes, and it identifies the
+      /// owners of (a sample of) the tiles.
+      /// \tparam Pmap The process map type
+      /// \param pmap The process map
+      /// \return A string that identifies \c pmap
+      template <typename Pmap>
+      inline std::string pmap_key(const std::shared_ptr<Pmap>& pmap) {
+        if(! pmap)
+          return "null";
+
+        std::stringstream ss;
+        ss << typeid(*pmap).name() << ":" << pmap->size() << ":" << pmap->procs() << ":";
+        const std::size_t size = pmap->size();
+        const std::size_t stride = std::max<std::size_t>(1ul, size / 4096ul);
+        std::size_t hash = 0ul;
+        for(std::size_t i = 0ul; i < size; i += stride)
+          hash = hash * 1000003ul + pmap->owner(i);
+        ss << hash;
+        return ss.str();
+      }
+
+    } // namespace detail
+
+  } // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_COMMON_SUBEXPR_H__INCLUDED
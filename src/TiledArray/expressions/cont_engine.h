@@ -27,9 +27,28 @@
 #define TILEDARRAY_EXPRESSIONS_CONT_ENGINE_H__INCLUDED
 
 #include <TiledArray/expressions/binary_engine.h>
+#include <TiledArray/expressions/contraction_plan.h>
+#include <TiledArray/expressions/tsr_engine.h>
+#include <TiledArray/expressions/scal_tsr_engine.h>
 #include <TiledArray/dist_eval/contraction_eval.h>
+#include <TiledArray/dist_eval/stationary_contraction_eval.h>
+#include <TiledArray/dist_eval/diagonal_contraction_eval.h>
+#include <TiledArray/dist_eval/batched_contraction_eval.h>
+#include <TiledArray/dist_eval/outer_product_eval.h>
+#include <TiledArray/dist_eval/pull_contraction_eval.h>
+#include <TiledArray/dist_eval/local_contraction_eval.h>
 #include <TiledArray/tile_op/contract_reduce.h>
+#include <TiledArray/tile_op/batched_contract_reduce.h>
+#include <TiledArray/tile_interface/clone.h>
 #include <TiledArray/proc_grid.h>
+#include <TiledArray/pmap/replicated_pmap.h>
+#include <TiledArray/pmap/balanced_grid_pmap.h>
+#include <TiledArray/pmap/batch_pmap.h>
+#include <TiledArray/pmap/cyclic_pmap.h>
+#include <TiledArray/pmap/fiber_pmap.h>
+#include <map>
+#include <string>
+#include <utility>
 
 namespace TiledArray {
   namespace expressions {
@@ -38,6 +57,33 @@ namespace TiledArray {
     template <typename, typename> class MultExpr;
     template <typename, typename, typename> class ScalMultExpr;
 
+    /// Diagonal argument trait
+
+    /// \c value is \c true when \c Engine is an array of \c Tensor or
+    /// Kronecker delta tiles, which may be a diagonal argument of
+    /// \c DiagonalContractionEvalImpl
+    /// \tparam Engine The argument engine type
+    template <typename Engine>
+    struct is_diagonal_engine : public std::false_type { };
+
+    template <typename Tile, typename Policy, typename Result, bool Alias>
+    struct is_diagonal_engine<TsrEngine<DistArray<Tile, Policy>, Result, Alias> > :
+        public std::integral_constant<bool,
+            TiledArray::detail::is_tensor<Tile>::value ||
+            TiledArray::detail::is_kronecker_delta<Tile>::value>
+    { };
+
+    /// Kronecker delta argument trait
+
+    /// \tparam Engine The argument engine type
+    template <typename Engine>
+    struct is_kronecker_delta_engine : public std::false_type { };
+
+    template <typename Tile, typename Policy, typename Result, bool Alias>
+    struct is_kronecker_delta_engine<TsrEngine<DistArray<Tile, Policy>, Result, Alias> > :
+        public TiledArray::detail::is_kronecker_delta<Tile>
+    { };
+
     /// Multiplication expression engine
 
     /// \tparam Derived The derived engine type
@@ -65,6 +111,10 @@ namespace TiledArray {
           typename eval_trait<typename left_type::value_type>::type,
           typename eval_trait<typename right_type::value_type>::type,
           scalar_type> op_type; ///< The tile operation type
+      typedef TiledArray::detail::BatchedContractReduce<value_type,
+          typename eval_trait<typename left_type::value_type>::type,
+          typename eval_trait<typename right_type::value_type>::type,
+          scalar_type> batched_op_type; ///< The batched tile operation type
       typedef typename EngineTrait<Derived>::policy
           policy; ///< The result policy type
       typedef typename EngineTrait<Derived>::dist_eval_type
@@ -114,7 +164,454 @@ namespace TiledArray {
       op_type op_; ///< Tile operation
       TiledArray::detail::ProcGrid proc_grid_; ///< Process grid for the contraction
       size_type K_; ///< Inner dimension size
+      ContractionMode mode_; ///< The operand that stays in place
+      bool diagonal_left_; ///< The left-hand argument is diagonal (\c diagonal mode)
+      bool outer_left_; ///< The left-hand argument is replicated (\c outer mode)
+      bool conj_left_; ///< The GEMM conjugates the left-hand argument
+      bool conj_right_; ///< The GEMM conjugates the right-hand argument
+      unsigned int batch_rank_; ///< The number of batch dimensions (0 if not batched)
+      batched_op_type batched_op_; ///< Batched tile operation
+
+      /// The left-hand argument may be evaluated as a diagonal matrix
+      static constexpr bool diagonal_left_enabled =
+          is_diagonal_engine<left_type>::value &&
+          TiledArray::detail::is_tensor<value_type>::value &&
+          TiledArray::detail::is_tensor<typename eval_trait<
+              typename right_type::value_type>::type>::value;
+
+      /// The right-hand argument may be evaluated as a diagonal matrix
+      static constexpr bool diagonal_right_enabled =
+          is_diagonal_engine<right_type>::value &&
+          TiledArray::detail::is_tensor<value_type>::value &&
+          TiledArray::detail::is_tensor<typename eval_trait<
+              typename left_type::value_type>::type>::value;
+
+      /// A contraction without inner dimensions may be evaluated as an outer
+      /// product
+      static constexpr bool outer_enabled =
+          TiledArray::detail::is_tensor<value_type,
+              typename eval_trait<typename left_type::value_type>::type,
+              typename eval_trait<typename right_type::value_type>::type>::value &&
+          TiledArray::detail::is_numeric<scalar_type>::value;
+
+      /// The contraction may have batch dimensions
+      static constexpr bool batched_enabled =
+          TiledArray::detail::is_tensor<value_type,
+              typename eval_trait<typename left_type::value_type>::type,
+              typename eval_trait<typename right_type::value_type>::type>::value &&
+          TiledArray::detail::is_numeric<scalar_type>::value;
+
+      /// The conjugation of the left-hand argument may be applied by the GEMM
+      static constexpr bool conj_left_enabled =
+          is_conj_tsr_engine<left_type>::value &&
+          TiledArray::detail::is_tensor<value_type>::value;
+
+      /// The conjugation of the right-hand argument may be applied by the GEMM
+      static constexpr bool conj_right_enabled =
+          is_conj_tsr_engine<right_type>::value &&
+          TiledArray::detail::is_tensor<value_type>::value;
+
+      /// The scaling factor of a conjugated argument
+
+      /// \param arg The argument engine
+      /// \return The scaling factor of the conjugation of \c arg
+      template <typename A>
+      static scalar_type arg_conj_factor(const A& arg, std::true_type) {
+        return scalar_type(conj_factor(arg.factor()));
+      }
+
+      template <typename A>
+      static scalar_type arg_conj_factor(const A&, std::false_type) {
+        return scalar_type(1);
+      }
+
+      /// The scaling factor of the tile GEMM
+
+      /// \return The contraction scaling factor, including the factors of the
+      /// arguments that are conjugated by the GEMM
+      scalar_type gemm_factor() const {
+        scalar_type result = factor_;
+        if(conj_left_)
+          result *= arg_conj_factor(left_,
+              std::integral_constant<bool, conj_left_enabled>());
+        if(conj_right_)
+          result *= arg_conj_factor(right_,
+              std::integral_constant<bool, conj_right_enabled>());
+        return result;
+      }
+
+      /// Call \c op with the left-hand argument evaluator
+
+      /// The tiles of a conjugated argument that is conjugated by the GEMM
+      /// are not conjugated by the argument evaluator.
+      /// \param op The operation that is called with the evaluator
+      /// \return The value returned by \c op
+      template <typename Op>
+      dist_eval_type with_left_dist_eval(const Op& op, std::true_type) const {
+        if(conj_left_)
+          return op(left_.make_unscaled_dist_eval());
+        return op(make_arg_dist_eval(left_));
+      }
+
+      template <typename Op>
+      dist_eval_type with_left_dist_eval(const Op& op, std::false_type) const {
+        return op(make_arg_dist_eval(left_));
+      }
+
+      /// Call \c op with the right-hand argument evaluator
+
+      /// \param op The operation that is called with the evaluator
+      /// \return The value returned by \c op
+      template <typename Op>
+      dist_eval_type with_right_dist_eval(const Op& op, std::true_type) const {
+        if(conj_right_)
+          return op(right_.make_unscaled_dist_eval());
+        return op(make_arg_dist_eval(right_));
+      }
+
+      template <typename Op>
+      dist_eval_type with_right_dist_eval(const Op& op, std::false_type) const {
+        return op(make_arg_dist_eval(right_));
+      }
+
+      /// Call \c op with the argument evaluators
+
+      /// \param op The operation that is called with the left- and right-hand
+      /// argument evaluators
+      /// \return The value returned by \c op
+      template <typename Op>
+      dist_eval_type with_arg_dist_evals(const Op& op) const {
+        return with_left_dist_eval([this, &op] (const auto& left) {
+              return this->with_right_dist_eval([&op, &left] (const auto& right) {
+                    return op(left, right);
+                  }, std::integral_constant<bool, conj_right_enabled>());
+            }, std::integral_constant<bool, conj_left_enabled>());
+      }
+
+
+      /// Initialize the maximum number of automatically selected SUMMA layers
+
+      /// The limit is set with the \c TA_SUMMA_MAX_LAYERS environment
+      /// variable; the default, 1, disables 2.5D SUMMA unless it is requested
+      /// explicitly with \c Expr::set_summa_layers() .
+      static size_type init_max_layers() {
+        const char* max_layers = getenv("TA_SUMMA_MAX_LAYERS");
+        if(max_layers)
+          return std::max<size_type>(std::stoul(max_layers), 1ul);
+        return 1ul;
+      }
+
+      /// Select the number of SUMMA process grid layers
+
+      /// \param world The world where the contraction is evaluated
+      /// \param Mm The number of result element rows
+      /// \param Nn The number of result element columns
+      /// \param Kk The number of inner elements
+      /// \return The number of process grid layers
+      size_type summa_layers(World& world, const size_type Mm,
+          const size_type Nn, const size_type Kk) const
+      {
+        const size_type nprocs = world.size();
+        const size_type max_layers = std::min<size_type>(nprocs, K_);
+
+        // Use the number of layers requested for this expression, reduced to
+        // a divisor of the number of processes
+        if(ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->summa_layers)
+          return TiledArray::detail::ProcGrid::divisor_layers(nprocs,
+              std::min<size_type>(ExprEngine_::override_ptr_->summa_layers, max_layers));
+
+        static const size_type env_max_layers = init_max_layers();
+        if(env_max_layers == 1ul || max_layers == 1ul)
+          return 1ul;
+
+        // Choose the number of layers that minimizes communication, subject to
+        // the memory available for partial results.
+        typedef TiledArray::detail::Summa<typename left_type::dist_eval_type,
+            typename right_type::dist_eval_type, op_type,
+            typename Derived::policy> summa_type;
+        typedef typename TiledArray::detail::numeric_type<value_type>::type
+            numeric_type;
+        const std::size_t max_memory =
+            (ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->summa.max_memory ?
+            ExprEngine_::override_ptr_->summa.max_memory : summa_type::max_memory());
+        return TiledArray::detail::ProcGrid::optimal_layers(nprocs, Mm, Nn,
+            Kk, K_, std::min(env_max_layers, max_layers),
+            max_memory / sizeof(numeric_type));
+      }
+
+      /// Number of elements of the fused tiles of a range of dimensions
+
+      /// \param trange The tiled range
+      /// \param first The first dimension
+      /// \param last The end of the dimensions
+      /// \return The number of elements of each fused tile index of
+      /// dimensions <tt>[first, last)</tt> , in row-major order
+      static std::vector<size_type> fused_weights(const trange_type& trange,
+          const unsigned int first, const unsigned int last)
+      {
+        std::vector<size_type> weights(1ul, 1ul);
+        for(unsigned int d = first; d < last; ++d) {
+          const TiledRange1& tr1 = trange.data()[d];
+          std::vector<size_type> next;
+          next.reserve(weights.size() * tr1.tile_extent());
+          for(const size_type weight : weights)
+            for(size_type t = tr1.tiles_range().first; t < tr1.tiles_range().second; ++t)
+              next.push_back(weight * (tr1.tile(t).second - tr1.tile(t).first));
+          weights.swap(next);
+        }
+        return weights;
+      }
+
+      /// Process maps of a contraction on a balanced grid
+
+      /// The result rows and columns are assigned to the rows and columns of
+      /// the SUMMA process grid by their number of elements (see
+      /// \c BalancedGridPmap ), and the tiles of the arguments are mapped to
+      /// the process rows or columns that use them.
+      struct BalancedGrid {
+        std::shared_ptr<pmap_interface> result; ///< The result process map
+        std::shared_ptr<pmap_interface> left; ///< The left-hand argument process map
+        std::shared_ptr<pmap_interface> right; ///< The right-hand argument process map
+      }; // struct BalancedGrid
+
+      /// Check that a contraction selected for SUMMA uses a balanced grid
+
+      /// This is the case when the mode was selected automatically for more
+      /// than one process, without a result process map, permutation, or
+      /// symmetry, and the balanced grid reduces the imbalance of the
+      /// cyclic grid by \c balanced_grid_threshold() . As a side effect,
+      /// the process grid is set to the default grid of the result.
+      /// \param world The world where the contraction is evaluated
+      /// \param pmap The process map of the result, or \c nullptr
+      /// \param M The number of result tile rows
+      /// \param N The number of result tile columns
+      /// \param m The number of result element rows
+      /// \param n The number of result element columns
+      /// \return \c true if the contraction is evaluated on a balanced grid
+      bool is_balanced_grid(World& world, const std::shared_ptr<pmap_interface>& pmap,
+          const size_type M, const size_type N, const size_type m, const size_type n)
+      {
+        const auto& override_ptr = ExprEngine_::override_ptr_;
+        if(pmap || perm_ || ExprEngine_::symmetry_ || (world.size() == 1) ||
+            (override_ptr && (override_ptr->contraction_mode != ContractionMode::automatic)) ||
+            (override_ptr && override_ptr->summa_layers))
+          return false;
+
+        proc_grid_ = TiledArray::detail::ProcGrid(world, M, N, m, n);
+        return bool(make_balanced_grid(world,
+            TiledArray::detail::balanced_grid_threshold()).result);
+      }
+
+      /// Construct the process maps of a balanced grid
+
+      /// \param world The world where the contraction is evaluated
+      /// \param threshold The factor by which the largest work of a process
+      /// of the cyclic grid must exceed that of the balanced grid
+      /// \return The process maps, which are null when the balanced grid
+      /// does not reduce the imbalance by \c threshold
+      BalancedGrid make_balanced_grid(World& world, const double threshold) const {
+        typedef TiledArray::detail::BalancedGridPmap pmap_type;
+
+        const unsigned int inner_rank = op_.gemm_helper().num_contract_ranks();
+        const unsigned int left_outer_rank = op_.gemm_helper().left_rank() - inner_rank;
+        const std::vector<size_type> row_weights =
+            fused_weights(left_.trange(), 0u, left_outer_rank);
+        const std::vector<size_type> inner_weights =
+            fused_weights(left_.trange(), left_outer_rank, op_.gemm_helper().left_rank());
+        const std::vector<size_type> col_weights =
+            fused_weights(right_.trange(), inner_rank, op_.gemm_helper().right_rank());
+
+        // The work of a process is proportional to the product of the
+        // elements of its rows and columns
+        const size_type Pr = proc_grid_.proc_rows();
+        const size_type Pc = proc_grid_.proc_cols();
+        const double cyclic =
+            double(pmap_type::max_load(row_weights, pmap_type::assign_cyclic(row_weights.size(), Pr), Pr)) *
+            double(pmap_type::max_load(col_weights, pmap_type::assign_cyclic(col_weights.size(), Pc), Pc));
+        const double balanced =
+            double(pmap_type::max_load(row_weights, pmap_type::assign(row_weights, Pr), Pr)) *
+            double(pmap_type::max_load(col_weights, pmap_type::assign(col_weights, Pc), Pc));
+
+        BalancedGrid grid;
+        if((threshold > 0.0) && (cyclic > threshold * balanced)) {
+          grid.result = std::make_shared<pmap_type>(world, row_weights, col_weights, Pr, Pc);
+          grid.left = std::make_shared<pmap_type>(world, row_weights, inner_weights, Pr, Pc);
+          grid.right = std::make_shared<pmap_type>(world, inner_weights, col_weights, Pr, Pc);
+        }
+        return grid;
+      }
+
+      /// Construct the result process map of a contraction with a replicated argument
+
+      /// Each result row (column) is owned by the owner of the first
+      /// non-zero tile of the same row of the left-hand argument (column of
+      /// the right-hand argument), when the other argument is replicated.
+      /// The argument tiles of a row (column) that is stored on one process
+      /// are then contracted without communication.
+      /// \param world The world where the contraction is evaluated
+      /// \param M The number of result tile rows
+      /// \param N The number of result tile columns
+      /// \return The result process map
+      std::shared_ptr<pmap_interface>
+      make_fiber_pmap(World& world, const size_type M, const size_type N) const {
+        const bool by_row = right_.pmap()->is_replicated();
+        std::vector<size_type> owners(by_row ? M : N);
+        for(size_type i = 0ul; i < owners.size(); ++i) {
+          size_type index = (by_row ? i * K_ : i);
+          for(size_type x = 0ul; x < K_; ++x) {
+            const size_type arg_index = (by_row ? i * K_ + x : x * N + i);
+            if(! (by_row ? left_.shape().is_zero(arg_index) :
+                right_.shape().is_zero(arg_index))) {
+              index = arg_index;
+              break;
+            }
+          }
+          owners[i] = (by_row ? left_.pmap()->owner(index) :
+              right_.pmap()->owner(index));
+        }
+
+        return std::make_shared<TiledArray::detail::FiberPmap>(world, M, N,
+            by_row, owners);
+      }
+
+      /// Check for a diagonal argument
+
+      /// A matrix-matrix contraction with an argument that was constructed by
+      /// \c diagonal_array() , which has the same tiling of its rows and
+      /// columns and is not transposed by the contraction, is evaluated by
+      /// scaling the tiles of the other argument, which must not be
+      /// transposed either.
+      /// \param left \c true to check the left-hand argument, \c false to
+      /// check the right-hand argument
+      /// \return \c true if the argument is diagonal
+      bool is_diagonal_arg(const bool left) const {
+        const TiledArray::math::GemmHelper& helper = op_.gemm_helper();
+        if((helper.left_rank() != 2u) || (helper.right_rank() != 2u) ||
+            (helper.num_contract_ranks() != 1u) ||
+            (helper.left_op() != madness::cblas::NoTrans) ||
+            (helper.right_op() != madness::cblas::NoTrans))
+          return false;
+        if(left)
+          return diagonal_left_enabled && left_.is_diagonal() &&
+              (left_.trange().data()[0] == left_.trange().data()[1]);
+        return diagonal_right_enabled && right_.is_diagonal() &&
+            (right_.trange().data()[0] == right_.trange().data()[1]);
+      }
+
+      /// Check that the contraction is an outer product
+
+      /// \return \c true if no dimension is contracted, and the tiles may be
+      /// multiplied by \c math::outer_fill()
+      bool is_outer_product() const {
+        return outer_enabled && (op_.gemm_helper().num_contract_ranks() == 0u) &&
+            (! conj_left_) && (! conj_right_);
+      }
+
+      /// Select the contraction mode
+
+      /// Unless a mode is requested for this expression, an argument is kept
+      /// stationary when its estimated non-zero volume exceeds the combined
+      /// non-zero volume of the other argument and the result, since only the
+      /// other two are then moved; otherwise SUMMA is used. Each non-zero tile
+      /// adds the latency of a message to the volume, in elements (see
+      /// \c ProcGrid::latency_elements() ), so arguments with many small
+      /// tiles are more expensive to move. A result with a
+      /// replicated process map is evaluated in \c replicate_result mode,
+      /// and a contraction with a diagonal argument (see
+      /// \c is_diagonal_arg() ) in \c diagonal mode. If \c diagonal mode is
+      /// requested without a diagonal argument, the mode is selected as for
+      /// \c automatic . An outer product (see \c is_outer_product() ) is
+      /// evaluated in \c outer mode, also with a single process, and if
+      /// \c outer mode is requested for another contraction the mode is
+      /// selected as for \c automatic . The \c pull mode, which suits
+      /// irregular sparsity, is used when it is requested, when an argument
+      /// is replicated, e.g. by \c DistArray::make_replicated() , since
+      /// each process then contracts its result tiles with its own copy of
+      /// that argument, or by \c init_distribution() instead of SUMMA when
+      /// irregular tiles unbalance the cyclic process grid (see
+      /// \c is_balanced_grid() ).
+      /// \param world The world where the contraction is evaluated
+      /// \param pmap The process map of the result, or \c nullptr
+      /// \return The contraction mode
+      ContractionMode select_mode(World& world,
+          const std::shared_ptr<pmap_interface>& pmap) const
+      {
+        ContractionMode mode = (ExprEngine_::override_ptr_ ?
+            ExprEngine_::override_ptr_->contraction_mode : ContractionMode::automatic);
+        if((mode == ContractionMode::replicate_result) ||
+            ((mode == ContractionMode::automatic) && pmap && pmap->is_replicated()))
+          return ContractionMode::replicate_result;
+        if((mode == ContractionMode::automatic) || (mode == ContractionMode::diagonal)) {
+          if(is_diagonal_arg(true) || is_diagonal_arg(false))
+            return ContractionMode::diagonal;
+          mode = ContractionMode::automatic;
+        }
+        if((mode == ContractionMode::automatic) || (mode == ContractionMode::outer)) {
+          if(is_outer_product())
+            return ContractionMode::outer;
+          mode = ContractionMode::automatic;
+        }
+        if(mode != ContractionMode::automatic)
+          return mode;
+        if(world.size() == 1)
+          return ContractionMode::keep_result;
+        if((left_.is_replicated(world) || right_.is_replicated(world)) &&
+            ! (ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->summa_layers))
+          return ContractionMode::pull;
+
+        const double latency = TiledArray::detail::ProcGrid::latency_elements();
+        const double left_volume =
+            (double(left_.trange().elements_range().volume())
+            + latency * double(left_.trange().tiles_range().volume()))
+            * (1.0 - left_.shape().sparsity());
+        const double right_volume =
+            (double(right_.trange().elements_range().volume())
+            + latency * double(right_.trange().tiles_range().volume()))
+            * (1.0 - right_.shape().sparsity());
+        const double result_volume =
+            (double(trange_.elements_range().volume())
+            + latency * double(trange_.tiles_range().volume()))
+            * (1.0 - shape_.sparsity());
+
+        if(left_volume > (right_volume + result_volume))
+          return ContractionMode::keep_left;
+        if(right_volume > (left_volume + result_volume))
+          return ContractionMode::keep_right;
+        return ContractionMode::keep_result;
+      }
+
+      /// The array of an unconjugated leaf argument
+
+      /// \tparam E The argument engine type
+      /// \return A pair of \c false and an empty id, since \c E is not a
+      /// leaf engine of a whole array
+      template <typename E>
+      static std::pair<bool, madness::uniqueidT> leaf_array_id(const E&) {
+        return std::make_pair(false, madness::uniqueidT());
+      }
 
+      /// The array of an unconjugated leaf argument
+
+      /// \param arg The argument engine
+      /// \return A pair of \c true and the id of the array of \c arg
+      template <typename A, typename R, bool Alias>
+      static std::pair<bool, madness::uniqueidT>
+      leaf_array_id(const TsrEngine<A, R, Alias>& arg) {
+        return std::make_pair(true, arg.array().id());
+      }
+
+      /// The array of an unconjugated leaf argument
+
+      /// \param arg The argument engine
+      /// \return A pair of \c true and the id of the array of \c arg , if
+      /// it is scaled by a number, otherwise \c false and an empty id
+      template <typename A, typename S, typename R>
+      static std::pair<bool, madness::uniqueidT>
+      leaf_array_id(const ScalTsrEngine<A, S, R>& arg) {
+        if(! TiledArray::detail::is_numeric<S>::value)
+          return std::make_pair(false, madness::uniqueidT());
+        return std::make_pair(true, arg.array().id());
+      }
 
       static unsigned int
       find(const VariableList& vars, std::string var, unsigned int i, const unsigned int n) {
@@ -126,6 +623,76 @@ namespace TiledArray {
         return i;
       }
 
+      /// The number of contracted dimensions of a batched contraction
+
+      /// \return The number of inner dimensions of the arguments
+      unsigned int batch_inner_rank() const {
+        return (left_vars_.dim() + right_vars_.dim() - vars_.dim() - batch_rank_) >> 1;
+      }
+
+      /// The number of batch tiles of a batched contraction
+
+      /// \return The volume of the tiles range of the batch dimensions
+      size_type batch_tiles() const {
+        const size_type* MADNESS_RESTRICT const extent =
+            left_.trange().tiles_range().extent_data();
+        size_type result = 1ul;
+        for(unsigned int i = 0u; i < batch_rank_; ++i)
+          result *= extent[i];
+        return result;
+      }
+
+      /// Tiled range of a batched contraction
+
+      /// \param perm The permutation to be applied to the result
+      /// \return The result tiled range
+      trange_type make_batched_trange(const Permutation& perm) const {
+        const unsigned int left_outer_end = left_vars_.dim() - batch_inner_rank();
+        typename trange_type::Ranges ranges(vars_.dim());
+        unsigned int i = 0u;
+        for(unsigned int x = 0u; x < left_outer_end; ++x, ++i)
+          ranges[perm ? perm[i] : i] = left_.trange().data()[x];
+        for(unsigned int x = batch_rank_ + batch_inner_rank(); x < right_vars_.dim(); ++x, ++i)
+          ranges[perm ? perm[i] : i] = right_.trange().data()[x];
+
+        // Check that the batch and contracted dimensions have the same tilings
+        for(unsigned int x = 0u; x < batch_rank_; ++x)
+          TA_USER_ASSERT(left_.trange().data()[x] == right_.trange().data()[x],
+              "The batch dimensions of the left- and right-hand arguments do "
+              "not have the same tilings.");
+        for(unsigned int l = left_outer_end, r = batch_rank_; l < left_vars_.dim(); ++l, ++r)
+          TA_USER_ASSERT(left_.trange().data()[l] == right_.trange().data()[r],
+              "The contracted dimensions of the left- and right-hand arguments "
+              "do not have the same tilings.");
+
+        return trange_type(ranges.begin(), ranges.end());
+      }
+
+      /// Construct the evaluator of a batched contraction
+
+      /// \return The batched contraction evaluator
+      dist_eval_type make_batched_dist_eval(std::true_type) const {
+        return with_arg_dist_evals([this] (const auto& left, const auto& right) {
+          typedef TiledArray::detail::BatchedContractionEvalImpl<
+              typename std::decay<decltype(left)>::type,
+              typename std::decay<decltype(right)>::type, batched_op_type,
+              typename Derived::policy> impl_type;
+
+          std::shared_ptr<impl_type> pimpl = std::make_shared<impl_type>(left,
+              right, *world_, trange_, shape_, pmap_, perm_, batched_op_,
+              batch_tiles(), K_);
+
+          return dist_eval_type(pimpl);
+        });
+      }
+
+      dist_eval_type make_batched_dist_eval(std::false_type) const {
+        // init_batched_vars() does not set batch dimensions for these tiles
+        TA_EXCEPTION("Batched contractions require TiledArray::Tensor tiles.");
+        return dist_eval_type(make_summa(make_arg_dist_eval(left_),
+            make_arg_dist_eval(right_), shape_));
+      }
+
     public:
 
       /// Constructor
@@ -137,7 +704,9 @@ namespace TiledArray {
       ContEngine(const MultExpr<L, R>& expr) :
         BinaryEngine_(expr), factor_(1), left_vars_(), right_vars_(),
         left_op_(permute_to_no_trans), right_op_(permute_to_no_trans), op_(),
-        proc_grid_(), K_(1u)
+        proc_grid_(), K_(1u), mode_(ContractionMode::keep_result),
+        diagonal_left_(false), outer_left_(false), conj_left_(false), conj_right_(false),
+        batch_rank_(0u), batched_op_()
       { }
 
       /// Constructor
@@ -150,13 +719,24 @@ namespace TiledArray {
       ContEngine(const ScalMultExpr<L, R, S>& expr) :
         BinaryEngine_(expr), factor_(expr.factor()), left_vars_(), right_vars_(),
         left_op_(permute_to_no_trans), right_op_(permute_to_no_trans), op_(),
-        proc_grid_(), K_(1u)
+        proc_grid_(), K_(1u), mode_(ContractionMode::keep_result),
+        diagonal_left_(false), outer_left_(false), conj_left_(false), conj_right_(false),
+        batch_rank_(0u), batched_op_()
       { }
 
       // Pull base class functions into this class.
       using ExprEngine_::derived;
       using ExprEngine_::vars;
 
+      /// Estimated cost of a variable list
+
+      /// \param target_vars The target variable list for this expression
+      /// \return The estimated number of elements that are permuted to
+      /// produce \c target_vars from the result of the contraction
+      size_type perm_cost(const VariableList& target_vars) const {
+        return (vars_ == target_vars ? 0ul : derived().data_elements());
+      }
+
       /// Set the variable list for this expression
 
       /// This function will set the variable list for this expression and its
@@ -165,6 +745,10 @@ namespace TiledArray {
       /// result of this expression will be permuted to match \c target_vars.
       /// \param target_vars The target variable list for this expression
       void perm_vars(const VariableList& target_vars) {
+        // The batch dimensions of a batched contraction lead the arguments
+        if(batch_rank_)
+          return;
+
         // Only permute if the arguments can be permuted
         if((left_op_ == permute_to_no_trans) || (right_op_ == permute_to_no_trans)) {
 
@@ -352,6 +936,81 @@ namespace TiledArray {
 
       }
 
+      /// Initialize the variable list of a batched contraction
+
+      /// Variables that appear in both arguments and in \c target_vars are
+      /// batch variables, which are not summed: e.g. \c p in
+      /// <tt>c("i,j,p") = a("i,k,p") * b("k,j,p")</tt> . The arguments are
+      /// permuted such that the batch variables lead, followed by the outer
+      /// variables of the left-hand argument and the inner variables, and the
+      /// inner variables and the outer variables of the right-hand argument,
+      /// respectively, in the order of \c target_vars . Each batch of the
+      /// result is then the contraction of the same batch of the arguments.
+      /// \param target_vars The target variable list for this expression
+      /// \return \c true if this is a batched contraction, otherwise
+      /// \c false , in which case nothing is initialized
+      /// \throw TiledArray::Exception When the tiles are not
+      /// \c TiledArray::Tensor objects.
+      /// \note Children must be initialized with \c init_vars() first.
+      bool init_batched_vars(const VariableList& target_vars) {
+        const VariableList& left_vars = left_.vars();
+        const VariableList& right_vars = right_.vars();
+        const unsigned int left_rank = left_vars.dim();
+        const unsigned int right_rank = right_vars.dim();
+        const unsigned int target_rank = target_vars.dim();
+
+        // Partition the target variables
+        std::vector<std::string> batch, left_outer, inner, right_outer;
+        for(unsigned int i = 0u; i < target_rank; ++i) {
+          const std::string& var = target_vars[i];
+          const bool in_left = (find(left_vars, var, 0u, left_rank) < left_rank);
+          const bool in_right = (find(right_vars, var, 0u, right_rank) < right_rank);
+          if(in_left && in_right)
+            batch.push_back(var);
+          else if(in_left)
+            left_outer.push_back(var);
+          else if(in_right)
+            right_outer.push_back(var);
+        }
+        if(batch.empty())
+          return false;
+        if(! batched_enabled)
+          TA_EXCEPTION("Batched contractions require TiledArray::Tensor tiles.");
+
+        for(unsigned int i = 0u; i < left_rank; ++i) {
+          const std::string& var = left_vars[i];
+          if((find(right_vars, var, 0u, right_rank) < right_rank) &&
+              (find(target_vars, var, 0u, target_rank) == target_rank))
+            inner.push_back(var);
+        }
+        TA_USER_ASSERT(left_rank == (batch.size() + left_outer.size() + inner.size()),
+            "The left-hand argument of a batched contraction has variables "
+            "that are not in the result or the right-hand argument.");
+        TA_USER_ASSERT(right_rank == (batch.size() + inner.size() + right_outer.size()),
+            "The right-hand argument of a batched contraction has variables "
+            "that are not in the result or the left-hand argument.");
+
+        // Construct the variable lists
+        std::vector<std::string> vars(batch);
+        vars.insert(vars.end(), left_outer.begin(), left_outer.end());
+        vars.insert(vars.end(), inner.begin(), inner.end());
+        left_vars_ = VariableList(vars.begin(), vars.end());
+        vars.resize(batch.size());
+        vars.insert(vars.end(), inner.begin(), inner.end());
+        vars.insert(vars.end(), right_outer.begin(), right_outer.end());
+        right_vars_ = VariableList(vars.begin(), vars.end());
+        vars.resize(batch.size());
+        vars.insert(vars.end(), left_outer.begin(), left_outer.end());
+        vars.insert(vars.end(), right_outer.begin(), right_outer.end());
+        vars_ = VariableList(vars.begin(), vars.end());
+        batch_rank_ = batch.size();
+
+        left_.perm_vars(left_vars_);
+        right_.perm_vars(right_vars_);
+
+        return true;
+      }
+
       /// Initialize result tensor structure
 
       /// This function will initialize the permutation, tiled range, and shape
@@ -365,30 +1024,133 @@ namespace TiledArray {
         // Initialize the tile operation in this function because it is used to
         // evaluate the tiled range and shape.
 
+        if(batch_rank_) {
+          perm_ = (target_vars != vars_ ? ExprEngine_::make_perm(target_vars) :
+              Permutation());
+          batched_op_ = batched_op_type(factor_, batch_rank_, vars_.dim(),
+              left_vars_.dim(), right_vars_.dim(),
+              (permute_tiles_ ? perm_ : Permutation()));
+          trange_ = ContEngine_::make_trange(perm_);
+          shape_ = (perm_ ? ContEngine_::make_shape(perm_) : ContEngine_::make_shape());
+        } else {
+          init_op_struct(target_vars);
+        }
+
+        if(ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->shape){
+            shape_ = shape_.mask(*ExprEngine_::override_ptr_->shape);
+        } 
+        if(ExprEngine_::override_ptr_ &&
+            (ExprEngine_::override_ptr_->shape_threshold >= 0.0f))
+          shape_ = shape_.with_threshold(ExprEngine_::override_ptr_->shape_threshold);
+      }
+
+    private:
+
+      /// Initialize the tile operation, tiled range, and shape of a contraction
+
+      /// \param target_vars The target variable list for the result tensor
+      void init_op_struct(const VariableList& target_vars) {
+        // A conjugated argument that is transposed is conjugated by the GEMM,
+        // so its tiles are not copied
+        conj_left_ = conj_left_enabled && (left_op_ == trans);
+        conj_right_ = conj_right_enabled && (right_op_ == trans);
         const madness::cblas::CBLAS_TRANSPOSE left_op =
-            (left_op_ == trans ? madness::cblas::Trans : madness::cblas::NoTrans);
+            (left_op_ == trans ? (conj_left_ ? madness::cblas::ConjTrans :
+            madness::cblas::Trans) : madness::cblas::NoTrans);
         const madness::cblas::CBLAS_TRANSPOSE right_op =
-            (right_op_ == trans ? madness::cblas::Trans : madness::cblas::NoTrans);
+            (right_op_ == trans ? (conj_right_ ? madness::cblas::ConjTrans :
+            madness::cblas::Trans) : madness::cblas::NoTrans);
 
 
         if(target_vars != vars_) {
           // Initialize permuted structure
           perm_ = ExprEngine_::make_perm(target_vars);
-          op_ = op_type(left_op, right_op, factor_, vars_.dim(), left_vars_.dim(),
-              right_vars_.dim(), (permute_tiles_ ? perm_ : Permutation()));
+          op_ = op_type(left_op, right_op, gemm_factor(), vars_.dim(),
+              left_vars_.dim(), right_vars_.dim(),
+              (permute_tiles_ ? perm_ : Permutation()));
           trange_ = ContEngine_::make_trange(perm_);
           shape_ = ContEngine_::make_shape(perm_);
         } else {
           // Initialize non-permuted structure
-          op_ = op_type(left_op, right_op, factor_, vars_.dim(), left_vars_.dim(),
-              right_vars_.dim());
+          op_ = op_type(left_op, right_op, gemm_factor(), vars_.dim(),
+              left_vars_.dim(), right_vars_.dim());
           trange_ = ContEngine_::make_trange();
           shape_ = ContEngine_::make_shape();
         }
+      }
 
-        if(ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->shape){
-            shape_ = shape_.mask(*ExprEngine_::override_ptr_->shape);
-        } 
+    public:
+
+      /// Update result tensor shape
+
+      /// The tile operation, contraction mode, and process grid are not
+      /// changed.
+      void update_shape() {
+        shape_ = (perm_ ? ContEngine_::make_shape(perm_) : ContEngine_::make_shape());
+
+        if(ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->shape)
+          shape_ = shape_.mask(*ExprEngine_::override_ptr_->shape);
+        if(ExprEngine_::override_ptr_ &&
+            (ExprEngine_::override_ptr_->shape_threshold >= 0.0f))
+          shape_ = shape_.with_threshold(ExprEngine_::override_ptr_->shape_threshold);
+      }
+
+      /// Permutational symmetry of a self-contraction
+
+      /// A contraction of an array with itself, where the contracted
+      /// variables are at the same positions of both arguments, e.g.
+      /// <tt>c("i,j") = a("i,k") * a("j,k")</tt> , is invariant under the
+      /// exchange of the outer variables of the arguments that are at the
+      /// same positions. When the contraction is evaluated by SUMMA, only the
+      /// representative result tiles, e.g. the upper triangle, are then
+      /// contracted, which halves the flops and the broadcasts of the
+      /// arguments, and the other tiles are permuted copies of their
+      /// representatives (see \c Expr::make_array() ). The arguments must be
+      /// unconjugated arrays, which may be scaled.
+      /// \return The group of the result mode permutations that leave the
+      /// result invariant, or a null pointer when this is not a
+      /// self-contraction that is evaluated by SUMMA
+      std::shared_ptr<const symmetry::PermutationGroup> implied_symmetry() const {
+        typedef std::shared_ptr<const symmetry::PermutationGroup> group_ptr;
+        if(batch_rank_ || ExprEngine_::symmetry_ ||
+            (mode_ != ContractionMode::keep_result) ||
+            ! TiledArray::detail::is_tensor<value_type>::value)
+          return group_ptr();
+
+        const auto left_id = leaf_array_id(left_);
+        const auto right_id = leaf_array_id(right_);
+        if(! left_id.first || ! right_id.first || (left_id.second != right_id.second))
+          return group_ptr();
+
+        // Pair the outer variables at the same positions of the arguments
+        const VariableList& left_vars = left_.vars();
+        const VariableList& right_vars = right_.vars();
+        const unsigned int rank = left_vars.dim();
+        if(right_vars.dim() != rank)
+          return group_ptr();
+        std::map<std::string, std::string> exchange;
+        for(unsigned int i = 0u; i < rank; ++i) {
+          if(left_vars[i] == right_vars[i])
+            continue;
+          if((find(right_vars, left_vars[i], 0u, rank) != rank) ||
+              (find(left_vars, right_vars[i], 0u, rank) != rank))
+            return group_ptr();
+          exchange[left_vars[i]] = right_vars[i];
+          exchange[right_vars[i]] = left_vars[i];
+        }
+        if(exchange.empty())
+          return group_ptr();
+
+        // The exchange as a permutation of the result modes, in the order of
+        // the target variables
+        const VariableList result_vars = (perm_ ? perm_ * vars_ : vars_);
+        const unsigned int result_rank = result_vars.dim();
+        std::vector<symmetry::Permutation::index_type> map(result_rank);
+        for(unsigned int i = 0u; i < result_rank; ++i)
+          map[i] = find(result_vars, exchange.at(result_vars[i]), 0u, result_rank);
+
+        return std::make_shared<const symmetry::PermutationGroup>(
+            std::vector<symmetry::Permutation>(1, symmetry::Permutation(map)));
       }
 
       /// Initialize result tensor distribution
@@ -398,6 +1160,11 @@ namespace TiledArray {
       /// \param world The world were the result will be distributed
       /// \param pmap The process map for the result tensor tiles
       void init_distribution(World* world, std::shared_ptr<pmap_interface> pmap) {
+        if(batch_rank_) {
+          init_batched_distribution(world, pmap);
+          return;
+        }
+
         const unsigned int inner_rank = op_.gemm_helper().num_contract_ranks();
         const unsigned int left_rank = op_.gemm_helper().left_rank();
         const unsigned int right_rank = op_.gemm_helper().right_rank();
@@ -414,25 +1181,146 @@ namespace TiledArray {
             right_.trange().elements_range().extent_data();
 
         // Compute the fused sizes of the contraction
-        size_type M = 1ul, m = 1ul, N = 1ul, n = 1ul;
+        size_type M = 1ul, m = 1ul, N = 1ul, n = 1ul, k = 1ul;
         unsigned int i = 0u;
         for(; i < left_outer_rank; ++i) {
           M *= left_tiles_size[i];
           m *= left_element_size[i];
         }
-        for(; i < left_rank; ++i)
+        for(; i < left_rank; ++i) {
           K_ *= left_tiles_size[i];
+          k *= left_element_size[i];
+        }
         for(i = inner_rank; i < right_rank; ++i) {
           N *= right_tiles_size[i];
           n *= right_element_size[i];
         }
 
-        // Construct the process grid.
-        proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n);
+        mode_ = select_mode(*world, pmap);
+        if(mode_ == ContractionMode::replicate_result) {
+          TA_USER_ASSERT(TiledArray::detail::is_tensor<value_type>::value,
+              "TiledArray::expressions::ContEngine::init_distribution(): "
+              "replicated contraction results require TiledArray::Tensor tiles.");
+
+          // Each layer of the process grid contracts a slice of the inner
+          // dimension; by default every process holds a slice, so the
+          // partial results are accumulated without SUMMA broadcasts.
+          const size_type max_layers = std::min<size_type>(world->size(), K_);
+          const size_type layers = TiledArray::detail::ProcGrid::divisor_layers(
+              world->size(), ((ExprEngine_::override_ptr_ &&
+              ExprEngine_::override_ptr_->summa_layers) ?
+              std::min<size_type>(ExprEngine_::override_ptr_->summa_layers, max_layers) :
+              max_layers));
+          proc_grid_ = (layers > 1ul ?
+              TiledArray::detail::ProcGrid(*world, M, N, m, n, layers) :
+              TiledArray::detail::ProcGrid(*world, M, N, m, n));
+
+          left_.init_distribution(world, proc_grid_.make_row_phase_pmap(K_));
+          right_.init_distribution(world, proc_grid_.make_col_phase_pmap(K_));
+
+          // The partial results are combined on every process
+          if(! (pmap && pmap->is_replicated()))
+            pmap = std::make_shared<TiledArray::detail::ReplicatedPmap>(*world,
+                trange_.tiles_range().volume());
+        } else if(mode_ == ContractionMode::diagonal) {
+          // The result tiles are evaluated where the tiles of the other
+          // argument are, so its process map is also the default result
+          // process map; the diagonal argument keeps its own distribution.
+          diagonal_left_ = is_diagonal_arg(true);
+          proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n);
+          if(diagonal_left_) {
+            left_.init_distribution(world, std::shared_ptr<pmap_interface>());
+            right_.init_distribution(world, pmap);
+            if(! pmap)
+              pmap = right_.pmap();
+          } else {
+            right_.init_distribution(world, std::shared_ptr<pmap_interface>());
+            left_.init_distribution(world, pmap);
+            if(! pmap)
+              pmap = left_.pmap();
+          }
+        } else if(mode_ == ContractionMode::outer) {
+          // The smaller argument is replicated to the tiles of the larger
+          // argument, which are distributed cyclically over the processes,
+          // and the result tiles are evaluated where the larger argument is.
+          // By default, the result tiles are distributed in the same way.
+          const double left_volume =
+              double(left_.trange().elements_range().volume())
+              * (1.0 - left_.shape().sparsity());
+          const double right_volume =
+              double(right_.trange().elements_range().volume())
+              * (1.0 - right_.shape().sparsity());
+          outer_left_ = (left_volume <= right_volume);
+          proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n);
+
+          const size_type P = world->size();
+          if(outer_left_) {
+            const size_type procs = std::min<size_type>(P, N);
+            left_.init_distribution(world, std::shared_ptr<pmap_interface>());
+            right_.init_distribution(world,
+                std::make_shared<TiledArray::detail::CyclicPmap>(*world, 1ul, N,
+                    1ul, procs));
+            if(! pmap)
+              pmap = (perm_ ? policy::default_pmap(*world, M * N) :
+                  std::make_shared<TiledArray::detail::CyclicPmap>(*world, M, N,
+                      1ul, procs));
+          } else {
+            const size_type procs = std::min<size_type>(P, M);
+            left_.init_distribution(world,
+                std::make_shared<TiledArray::detail::CyclicPmap>(*world, M, 1ul,
+                    procs, 1ul));
+            right_.init_distribution(world, std::shared_ptr<pmap_interface>());
+            if(! pmap)
+              pmap = (perm_ ? policy::default_pmap(*world, M * N) :
+                  std::make_shared<TiledArray::detail::CyclicPmap>(*world, M, N,
+                      procs, 1ul));
+          }
+        } else if((mode_ == ContractionMode::keep_result) && is_balanced_grid(*world, pmap, M, N, m, n)) {
+          // The cyclic SUMMA grid is unbalanced by irregular tiles, so the
+          // result is contracted by its owners on a balanced grid, which
+          // keeps the two-dimensional structure of SUMMA
+          mode_ = ContractionMode::pull;
+          const BalancedGrid grid = make_balanced_grid(*world,
+              TiledArray::detail::balanced_grid_threshold());
+          left_.init_distribution(world, grid.left);
+          right_.init_distribution(world, grid.right);
+          pmap = grid.result;
+        } else if(mode_ == ContractionMode::keep_result) {
+          // Construct the process grid.
+          const size_type layers = summa_layers(*world, m, n, k);
+          if(layers > 1ul) {
+            proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n, layers);
+          } else {
+            // Select the grid from the non-zero fractions of the arguments and
+            // the node size, which may leave processes idle
+            const size_type ranks_per_node = (world->size() > 1 ?
+                TiledArray::detail::NodeMap::instance(*world)->node_size(0) : 1ul);
+            proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n, k,
+                1.0 - left_.shape().sparsity(), 1.0 - right_.shape().sparsity(),
+                ranks_per_node);
+          }
 
-        // Initialize children
-        left_.init_distribution(world, proc_grid_.make_row_phase_pmap(K_));
-        right_.init_distribution(world, proc_grid_.make_col_phase_pmap(K_));
+          // Initialize children
+          left_.init_distribution(world, proc_grid_.make_row_phase_pmap(K_));
+          right_.init_distribution(world, proc_grid_.make_col_phase_pmap(K_));
+        } else {
+          // The process grid only defines the default result distribution;
+          // the arguments keep their own distribution.
+          proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n);
+          left_.init_distribution(world, std::shared_ptr<pmap_interface>());
+          right_.init_distribution(world, std::shared_ptr<pmap_interface>());
+
+          // Distribute the result of the owner-computes contraction with
+          // the rows (columns) of the argument that is not replicated, so
+          // only the replicated argument is read, or else on a balanced
+          // grid, if that reduces its imbalance
+          if((mode_ == ContractionMode::pull) && ! pmap && ! perm_) {
+            if(left_.pmap()->is_replicated() != right_.pmap()->is_replicated())
+              pmap = make_fiber_pmap(*world, M, N);
+            else
+              pmap = make_balanced_grid(*world, 1.0).result;
+          }
+        }
 
         // Initialize the process map in not already defined
         if(! pmap)
@@ -440,11 +1328,96 @@ namespace TiledArray {
         ExprEngine_::init_distribution(world, pmap);
       }
 
+      /// Initialize the distribution of a batched contraction
+
+      /// All tiles of a batch of the arguments are mapped to the same process
+      /// (see \c BatchPmap ), which contracts the result tiles of that batch.
+      /// The result tiles are mapped the same way by default, unless the
+      /// permutation of the result moves the batch dimensions.
+      /// \param world The world were the result will be distributed
+      /// \param pmap The process map for the result tensor tiles
+      void init_batched_distribution(World* world, std::shared_ptr<pmap_interface> pmap) {
+        const size_type batches = batch_tiles();
+        const size_type* MADNESS_RESTRICT const left_extent =
+            left_.trange().tiles_range().extent_data();
+        K_ = 1ul;
+        for(unsigned int i = left_vars_.dim() - batch_inner_rank(); i < left_vars_.dim(); ++i)
+          K_ *= left_extent[i];
+
+        left_.init_distribution(world,
+            std::make_shared<TiledArray::detail::BatchPmap>(*world, batches,
+                left_.trange().tiles_range().volume() / batches));
+        right_.init_distribution(world,
+            std::make_shared<TiledArray::detail::BatchPmap>(*world, batches,
+                right_.trange().tiles_range().volume() / batches));
+
+        if(! pmap) {
+          bool batch_fixed = true;
+          for(unsigned int i = 0u; perm_ && (i < batch_rank_); ++i)
+            batch_fixed = batch_fixed && (perm_[i] == i);
+          const size_type size = trange_.tiles_range().volume();
+          if(batch_fixed)
+            pmap = std::make_shared<TiledArray::detail::BatchPmap>(*world,
+                batches, size / batches);
+          else
+            pmap = policy::default_pmap(*world, size);
+        }
+        ExprEngine_::init_distribution(world, pmap);
+      }
+
+      /// Result tiles that depend on modified argument tiles
+
+      /// Result tile <tt>(i,j)</tt> of the contraction depends on the
+      /// argument tiles <tt>(i,k)</tt> and <tt>(k,j)</tt> for which both are
+      /// non-zero, so it is dirty when, for some \c k , a dirty tile of one
+      /// argument meets a non-zero or dirty tile of the other. All tiles of a
+      /// batched contraction are dirty.
+      /// \return A flag for each result tile whose contributing argument
+      /// tiles are dirty
+      std::vector<bool> dirty_tiles() const {
+        if(batch_rank_)
+          return ExprEngine_::dirty_tiles();
+
+        const std::vector<bool> left_dirty = left_.dirty_tiles();
+        const std::vector<bool> right_dirty = right_.dirty_tiles();
+        const unsigned int left_rank = op_.gemm_helper().left_rank();
+        const unsigned int inner_rank = op_.gemm_helper().num_contract_ranks();
+        const size_type* MADNESS_RESTRICT const left_extent =
+            left_.trange().tiles_range().extent_data();
+        size_type K = 1ul;
+        for(unsigned int x = left_rank - inner_rank; x < left_rank; ++x)
+          K *= left_extent[x];
+        const size_type M = left_dirty.size() / K;
+        const size_type N = right_dirty.size() / K;
+
+        std::vector<bool> dirty(M * N, false);
+        for(size_type i = 0ul; i < M; ++i) {
+          for(size_type k = 0ul; k < K; ++k) {
+            const size_type ik = i * K + k;
+            const bool left_nonzero = ! left_.shape().is_zero(ik);
+            if(! (left_dirty[ik] || left_nonzero))
+              continue;
+            for(size_type j = 0ul, kj = k * N; j < N; ++j, ++kj) {
+              if(dirty[i * N + j])
+                continue;
+              if((left_dirty[ik] && (right_dirty[kj] || ! right_.shape().is_zero(kj)))
+                  || (right_dirty[kj] && left_nonzero))
+                dirty[i * N + j] = true;
+            }
+          }
+        }
+
+        return ExprEngine_::permute_dirty_tiles(dirty);
+      }
+
       /// Tiled range factory function
 
       /// \param perm The permutation to be applied to the array
       /// \return The result tiled range
       trange_type make_trange(const Permutation& perm = Permutation()) const {
+        if(batch_rank_)
+          return make_batched_trange(perm);
+
         // Compute iteration limits
         const unsigned int left_rank = op_.gemm_helper().left_rank();
         const unsigned int right_rank = op_.gemm_helper().right_rank();
@@ -500,15 +1473,40 @@ namespace TiledArray {
         return trange_type(ranges.begin(), ranges.end());
       }
 
+      /// Argument shape with the zero threshold of the result
+
+      /// The result shape of a contraction is screened with the tighter of
+      /// the thresholds of the arguments, so a result threshold that is
+      /// tighter than those of the arguments is applied to the arguments
+      /// before the contraction.
+      /// \tparam Shape The argument shape type
+      /// \param shape The shape of an argument
+      /// \return \c shape with a threshold no greater than the one given by
+      /// \c Expr::set_shape_threshold()
+      template <typename Shape>
+      Shape threshold_arg_shape(const Shape& shape) const {
+        if(ExprEngine_::override_ptr_ &&
+            (ExprEngine_::override_ptr_->shape_threshold >= 0.0f) &&
+            (ExprEngine_::override_ptr_->shape_threshold < shape.zero_threshold()))
+          return shape.with_threshold(ExprEngine_::override_ptr_->shape_threshold);
+        return shape;
+      }
+
       /// Non-permuting shape factory function
 
       /// \return The result shape
       shape_type make_shape() const {
+        if(batch_rank_)
+          return threshold_arg_shape(BinaryEngine_::left_shape()).batched_gemm(
+              threshold_arg_shape(BinaryEngine_::right_shape()), factor_,
+              batch_rank_, batch_inner_rank());
+
         const TiledArray::math::GemmHelper
         shape_gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
             op_.gemm_helper().result_rank(), op_.gemm_helper().left_rank(),
             op_.gemm_helper().right_rank());
-        return left_.shape().gemm(right_.shape(), factor_, shape_gemm_helper);
+        return threshold_arg_shape(BinaryEngine_::left_shape()).gemm(
+            threshold_arg_shape(BinaryEngine_::right_shape()), factor_, shape_gemm_helper);
       }
 
       /// Permuting shape factory function
@@ -516,27 +1514,617 @@ namespace TiledArray {
       /// \param perm The permutation to be applied to the array
       /// \return The result shape
       shape_type make_shape(const Permutation& perm) const {
+        if(batch_rank_)
+          return threshold_arg_shape(BinaryEngine_::left_shape()).batched_gemm(
+              threshold_arg_shape(BinaryEngine_::right_shape()), factor_,
+              batch_rank_, batch_inner_rank(), perm);
+
         const TiledArray::math::GemmHelper
         shape_gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
             op_.gemm_helper().result_rank(), op_.gemm_helper().left_rank(),
             op_.gemm_helper().right_rank());
-        return left_.shape().gemm(right_.shape(), factor_, shape_gemm_helper,
-                                  perm);
+        return threshold_arg_shape(BinaryEngine_::left_shape()).gemm(
+            threshold_arg_shape(BinaryEngine_::right_shape()), factor_, shape_gemm_helper, perm);
       }
 
+    private:
+
+      typedef TiledArray::detail::Summa<typename left_type::dist_eval_type,
+          typename right_type::dist_eval_type, op_type,
+          policy> summa_type; ///< SUMMA evaluator type
+
+      /// Construct the SUMMA evaluator for this expression
+
+      /// \tparam L The left-hand distributed evaluator type
+      /// \tparam R The right-hand distributed evaluator type
+      /// \param left The left-hand distributed evaluator
+      /// \param right The right-hand distributed evaluator
+      /// \param shape The shape of the result
+      /// \param symmetry The permutational symmetry of the result (may be
+      /// null)
+      /// \return The SUMMA evaluator
+      template <typename L, typename R>
+      std::shared_ptr<TiledArray::detail::Summa<L, R, op_type, policy> >
+      make_summa(const L& left, const R& right, const shape_type& shape,
+          const std::shared_ptr<const symmetry::TileSymmetry>& symmetry = nullptr) const
+      {
+        // Get the per-expression SUMMA options
+        const auto& override_ptr = ExprEngine_::override_ptr_;
+        return std::make_shared<TiledArray::detail::Summa<L, R, op_type, policy> >(
+            left, right, *world_, trange_, shape, pmap_, perm_, op_, K_, proc_grid_,
+            (override_ptr ? override_ptr->summa : TiledArray::detail::SummaOptions()),
+            symmetry);
+      }
+
+      /// Construct the evaluator of a contraction with a diagonal argument
+
+      /// \tparam D The diagonal argument engine type
+      /// \tparam A The other argument engine type
+      /// \param diag The diagonal argument
+      /// \param arg The other argument
+      /// \return The diagonal contraction evaluator
+      template <typename D, typename A>
+      dist_eval_type make_diagonal_dist_eval(const D& diag, const A& arg,
+          std::true_type) const
+      {
+        typedef TiledArray::detail::DiagonalContractionEvalImpl<
+            typename A::dist_eval_type, typename D::array_type, value_type,
+            scalar_type, policy> impl_type;
+
+        std::shared_ptr<impl_type> pimpl = std::make_shared<impl_type>(
+            make_arg_dist_eval(arg), diag.array(), diagonal_left_, factor_,
+            *world_, trange_, shape_, pmap_, perm_);
+
+        return dist_eval_type(pimpl);
+      }
+
+      template <typename D, typename A>
+      dist_eval_type make_diagonal_dist_eval(const D&, const A&,
+          std::false_type) const
+      {
+        // is_diagonal_arg() is false for this argument
+        TA_EXCEPTION("The argument cannot be evaluated as a diagonal matrix.");
+        return dist_eval_type(make_summa(make_arg_dist_eval(left_),
+            make_arg_dist_eval(right_), shape_));
+      }
+
+      /// Construct the outer product evaluator
+
+      /// \return The outer product evaluator
+      dist_eval_type make_outer_dist_eval(std::true_type) const {
+        typedef typename left_type::dist_eval_type left_dist_eval_type;
+        typedef typename right_type::dist_eval_type right_dist_eval_type;
+        typedef TiledArray::detail::OuterProductEvalImpl<left_dist_eval_type,
+            right_dist_eval_type, value_type, scalar_type, policy> impl_type;
+
+        std::shared_ptr<impl_type> pimpl = std::make_shared<impl_type>(
+            make_arg_dist_eval(left_), make_arg_dist_eval(right_), factor_,
+            outer_left_, *world_, trange_, shape_, pmap_, perm_);
+
+        return dist_eval_type(pimpl);
+      }
+
+      dist_eval_type make_outer_dist_eval(std::false_type) const {
+        // is_outer_product() is false for these arguments
+        TA_EXCEPTION("The contraction cannot be evaluated as an outer product.");
+        return dist_eval_type(make_summa(make_arg_dist_eval(left_),
+            make_arg_dist_eval(right_), shape_));
+      }
+
+    public:
+
       dist_eval_type make_dist_eval() const {
-        // Define the impl type
+        if(batch_rank_)
+          return make_batched_dist_eval(
+              std::integral_constant<bool, batched_enabled>());
+
+        // Multiply the tiles of the larger argument by the replicated tiles
+        // of the smaller argument
+        if(mode_ == ContractionMode::outer)
+          return make_outer_dist_eval(std::integral_constant<bool, outer_enabled>());
+
+        // Scale the tiles of the other argument by the diagonal argument
+        if(mode_ == ContractionMode::diagonal)
+          return (diagonal_left_ ?
+              make_diagonal_dist_eval(left_, right_,
+                  std::integral_constant<bool, diagonal_left_enabled>()) :
+              make_diagonal_dist_eval(right_, left_,
+                  std::integral_constant<bool, diagonal_right_enabled>()));
+
+        return with_arg_dist_evals([this] (const auto& left, const auto& right) {
+          typedef typename std::decay<decltype(left)>::type left_dist_eval_type;
+          typedef typename std::decay<decltype(right)>::type right_dist_eval_type;
+
+          // Construct an operand-stationary evaluator
+          if((mode_ == ContractionMode::keep_left) ||
+              (mode_ == ContractionMode::keep_right)) {
+            typedef TiledArray::detail::StationaryContraction<
+                left_dist_eval_type, right_dist_eval_type, op_type,
+                typename Derived::policy> stationary_type;
+
+            std::shared_ptr<stationary_type> pimpl =
+                std::make_shared<stationary_type>(left, right, *world_, trange_,
+                    shape_, pmap_, perm_, op_, K_,
+                    mode_ == ContractionMode::keep_left);
+
+            return dist_eval_type(pimpl);
+          }
+
+          // Construct an owner-computes evaluator
+          if(mode_ == ContractionMode::pull) {
+            typedef TiledArray::detail::PullContraction<
+                left_dist_eval_type, right_dist_eval_type, op_type,
+                typename Derived::policy> pull_type;
+
+            std::shared_ptr<pull_type> pimpl =
+                std::make_shared<pull_type>(left, right, *world_, trange_,
+                    shape_, pmap_, perm_, op_, K_);
+
+            return dist_eval_type(pimpl);
+          }
+
+          // Contract the local tiles directly when there is one process
+          if(is_local_contraction()) {
+            typedef TiledArray::detail::LocalContraction<
+                left_dist_eval_type, right_dist_eval_type, op_type,
+                typename Derived::policy> local_type;
+
+            std::shared_ptr<local_type> pimpl =
+                std::make_shared<local_type>(left, right, *world_, trange_,
+                    shape_, pmap_, perm_, op_, K_);
+
+            return dist_eval_type(pimpl);
+          }
+
+          // Only the representative tiles of a symmetric result are contracted
+          return dist_eval_type(this->make_summa(left, right, shape_,
+              ExprEngine_::symmetry_));
+        });
+      }
+
+      /// Check that the contraction is evaluated on local tiles
+
+      /// A SUMMA contraction in a world with one process is evaluated by
+      /// \c LocalContraction , which skips the broadcasts and reductions,
+      /// unless the result is symmetric, the tile pairs are batched, or
+      /// \c set_local_contraction() disabled it.
+      /// \return \c true if the contraction is evaluated by
+      /// \c LocalContraction
+      bool is_local_contraction() const {
+        const auto& override_ptr = ExprEngine_::override_ptr_;
+        return (world_->size() == 1) && (mode_ == ContractionMode::keep_result) &&
+            TiledArray::detail::local_contraction_enabled() &&
+            (! ExprEngine_::symmetry_) &&
+            ! (override_ptr && override_ptr->summa.batch) &&
+            ! summa_type::batched_gemm;
+      }
+
+      /// Check that the result can be accumulated into the tiles of an array
+
+      /// \return \c true if the result is evaluated by SUMMA, without a
+      /// permutation and without batched tile contractions
+      bool is_accumulable() const {
+        const auto& override_ptr = ExprEngine_::override_ptr_;
+        return (! batch_rank_) && (mode_ == ContractionMode::keep_result) && (! perm_) &&
+            ! (override_ptr && override_ptr->summa.batch) &&
+            ! summa_type::batched_gemm;
+      }
+
+      /// Construct the distributed evaluator for the sum of an array and this expression
+
+      /// The contraction of each result tile is accumulated into a copy of
+      /// the tile of \c array , i.e. the GEMM of the first tile pair is
+      /// evaluated with <tt>beta = 1</tt> , so the contraction result is
+      /// not held separately from the sum.
+      /// \tparam A The array type
+      /// \param array The array that is added to this expression, which has
+      /// the tiled range and variable list of the result
+      /// \param shape The shape of the sum
+      /// \return The distributed evaluator of <tt>array + this</tt>
+      /// \note \c is_accumulable() must be \c true
+      template <typename A>
+      dist_eval_type make_accumulate_dist_eval(const A& array,
+          const shape_type& shape) const
+      {
+        static_assert(std::is_same<typename A::value_type, value_type>::value,
+            "The array must have the tile type of the result.");
+        TA_ASSERT(is_accumulable());
+        TA_ASSERT(array.trange() == trange_);
+
+        return with_arg_dist_evals([this, &array, &shape] (const auto& left,
+            const auto& right)
+        {
+          auto pimpl = this->make_summa(left, right, shape);
+
+          pimpl->seed_result([array] (const size_type i, Future<value_type>& tile) {
+            if(array.is_zero(i))
+              return false;
+
+            // The tile is cloned since it is modified by the contraction
+            tile = array.world().taskq.add([] (const value_type& arg_tile) -> value_type {
+                  using TiledArray::clone;
+                  return clone(arg_tile);
+                }, array.find(i));
+            return true;
+          });
+
+          return dist_eval_type(pimpl);
+        });
+      }
+
+      /// Contraction plan factory function
+
+      /// Predict the cost of evaluating this contraction from the structure
+      /// and distribution set by \c init_struct() and \c init_distribution() ,
+      /// without evaluating any tiles. For SUMMA, the sparse broadcast groups
+      /// are approximated by the processes that hold a non-zero tile of the
+      /// other argument in the same iteration, and the pipeline memory is the
+      /// largest sum of \c depth consecutive iterations, bounded by the SUMMA
+      /// memory limit.
+      /// \return The contraction plan
+      /// \throw TiledArray::Exception When this is a batched contraction.
+      ContractionPlan make_plan() const {
+        if(batch_rank_)
+          TA_EXCEPTION("A plan is not available for batched contractions.");
+
+        typedef typename TiledArray::detail::numeric_type<
+            typename eval_trait<typename left_type::value_type>::type>::type
+            left_numeric_type;
+        typedef typename TiledArray::detail::numeric_type<
+            typename eval_trait<typename right_type::value_type>::type>::type
+            right_numeric_type;
+        typedef typename TiledArray::detail::numeric_type<value_type>::type
+            result_numeric_type;
         typedef TiledArray::detail::Summa<typename left_type::dist_eval_type,
-            typename right_type::dist_eval_type, op_type, typename Derived::policy> impl_type;
+            typename right_type::dist_eval_type, op_type,
+            typename Derived::policy> summa_type;
 
-        typename left_type::dist_eval_type left = left_.make_dist_eval();
-        typename right_type::dist_eval_type right = right_.make_dist_eval();
+        const unsigned int inner_rank = op_.gemm_helper().num_contract_ranks();
+        const unsigned int left_rank = op_.gemm_helper().left_rank();
+        const unsigned int right_rank = op_.gemm_helper().right_rank();
+        const unsigned int left_outer_rank = left_rank - inner_rank;
+        const size_type M = left_.trange().tiles_range().volume() / K_;
+        const size_type N = right_.trange().tiles_range().volume() / K_;
+        const size_type P = world_->size();
+
+        // Compute the fused element extents of the tile rows, columns, and
+        // inner dimension
+        std::vector<double> m(M, 1.0), k(K_, 1.0), n(N, 1.0);
+        for(size_type i = 0ul; i < M; ++i) {
+          const auto range = left_.trange().make_tile_range(i * K_);
+          for(unsigned int d = 0u; d < left_outer_rank; ++d)
+            m[i] *= range.extent_data()[d];
+        }
+        for(size_type x = 0ul; x < K_; ++x) {
+          const auto range = left_.trange().make_tile_range(x);
+          for(unsigned int d = left_outer_rank; d < left_rank; ++d)
+            k[x] *= range.extent_data()[d];
+        }
+        for(size_type j = 0ul; j < N; ++j) {
+          const auto range = right_.trange().make_tile_range(j);
+          for(unsigned int d = inner_rank; d < right_rank; ++d)
+            n[j] *= range.extent_data()[d];
+        }
+        auto left_bytes = [&] (const size_type i, const size_type x) {
+          return size_type(m[i] * k[x]) * sizeof(left_numeric_type); };
+        auto right_bytes = [&] (const size_type x, const size_type j) {
+          return size_type(k[x] * n[j]) * sizeof(right_numeric_type); };
+        auto result_bytes = [&] (const size_type i, const size_type j) {
+          return size_type(m[i] * n[j]) * sizeof(result_numeric_type); };
+
+        // Map the unpermuted result index to the result tile index
+        TiledArray::detail::PermIndex source_to_target;
+        if(perm_)
+          source_to_target = TiledArray::detail::PermIndex(
+              (-perm_) * trange_.tiles_range(), perm_);
+        auto result_index = [&] (const size_type i, const size_type j) {
+          const size_type index = i * N + j;
+          return (source_to_target ? source_to_target(index) : index); };
+
+        ContractionPlan plan;
+        plan.mode = mode_;
+        plan.comm_bytes.assign(P, 0ul);
+        plan.bcast_memory.assign(P, 0ul);
+
+        // Count the flops of the tile pairs that contribute to non-zero
+        // result tiles
+        std::vector<size_type> rows, cols;
+        rows.reserve(M);
+        cols.reserve(N);
+        for(size_type x = 0ul; x < K_; ++x) {
+          rows.clear();
+          cols.clear();
+          for(size_type i = 0ul; i < M; ++i)
+            if(! left_.shape().is_zero(i * K_ + x))
+              rows.push_back(i);
+          for(size_type j = 0ul; j < N; ++j)
+            if(! right_.shape().is_zero(x * N + j))
+              cols.push_back(j);
+          for(const size_type i : rows)
+            for(const size_type j : cols)
+              if(! shape_.is_zero(result_index(i, j)))
+                plan.flops += 2.0 * m[i] * n[j] * k[x];
+        }
 
-        std::shared_ptr<impl_type> pimpl =
-            std::make_shared<impl_type>(left, right, *world_, trange_, shape_,
-                                        pmap_, perm_, op_, K_, proc_grid_);
+        if((mode_ == ContractionMode::keep_result) ||
+            (mode_ == ContractionMode::replicate_result)) {
+          const size_type Pr = proc_grid_.proc_rows();
+          const size_type Pc = proc_grid_.proc_cols();
+          const size_type layers = proc_grid_.layers();
+          const size_type layer_size = proc_grid_.layer_size();
+          plan.proc_rows = Pr;
+          plan.proc_cols = Pc;
+          plan.layers = layers;
+          plan.idle_procs = P - layers * proc_grid_.proc_size();
+          plan.intra_node_rows = proc_grid_.intra_node_rows();
+
+          const size_type max_depth =
+              (ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->summa.max_depth ?
+              ExprEngine_::override_ptr_->summa.max_depth : summa_type::max_depth());
+          const size_type max_memory =
+              (ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->summa.max_memory ?
+              ExprEngine_::override_ptr_->summa.max_memory : summa_type::max_memory());
+
+          std::vector<char> row_used(Pr), col_used(Pc);
+          std::vector<size_type> iter_memory(layer_size);
+          std::vector<std::vector<size_type> > window(layer_size);
+          std::vector<size_type> window_sum(layer_size);
+          for(size_type l = 0ul; l < layers; ++l) {
+            const size_type k_begin =
+                TiledArray::detail::LayeredCyclicPmap::layer_begin(l, K_, layers);
+            const size_type k_end =
+                TiledArray::detail::LayeredCyclicPmap::layer_begin(l + 1ul, K_, layers);
+            const size_type depth = std::max<size_type>(1ul,
+                summa_type::initial_depth(proc_grid_, k_end - k_begin,
+                    shape_.is_dense(), left_.shape().sparsity(),
+                    right_.shape().sparsity(), max_depth));
+            if(l == 0ul)
+              plan.depth = depth;
+            const size_type layer_offset = l * layer_size;
+            for(auto& w : window)
+              w.assign(depth, 0ul);
+            window_sum.assign(layer_size, 0ul);
+
+            for(size_type x = k_begin; x < k_end; ++x) {
+              // Find the process rows and columns that take part in this
+              // iteration
+              std::fill(row_used.begin(), row_used.end(), 0);
+              std::fill(col_used.begin(), col_used.end(), 0);
+              for(size_type i = 0ul; i < M; ++i)
+                if(! left_.shape().is_zero(i * K_ + x))
+                  row_used[i % Pr] = 1;
+              for(size_type j = 0ul; j < N; ++j)
+                if(! right_.shape().is_zero(x * N + j))
+                  col_used[j % Pc] = 1;
+
+              // Broadcast the left-hand column across process rows and the
+              // right-hand row down process columns
+              std::fill(iter_memory.begin(), iter_memory.end(), 0ul);
+              for(size_type i = 0ul; i < M; ++i) {
+                if(left_.shape().is_zero(i * K_ + x)) continue;
+                const size_type r = i % Pr;
+                const size_type bytes = left_bytes(i, x);
+                for(size_type c = 0ul; c < Pc; ++c) {
+                  if(! col_used[c]) continue;
+                  iter_memory[r * Pc + c] += bytes;
+                  if(c != (x % Pc))
+                    plan.comm_bytes[layer_offset + r * Pc + c] += bytes;
+                }
+              }
+              for(size_type j = 0ul; j < N; ++j) {
+                if(right_.shape().is_zero(x * N + j)) continue;
+                const size_type c = j % Pc;
+                const size_type bytes = right_bytes(x, j);
+                for(size_type r = 0ul; r < Pr; ++r) {
+                  if(! row_used[r]) continue;
+                  iter_memory[r * Pc + c] += bytes;
+                  if(r != (x % Pr))
+                    plan.comm_bytes[layer_offset + r * Pc + c] += bytes;
+                }
+              }
 
-        return dist_eval_type(pimpl);
+              // Track the memory of the iterations in the pipeline
+              const size_type slot = (x - k_begin) % depth;
+              for(size_type p = 0ul; p < layer_size; ++p) {
+                window_sum[p] = window_sum[p] - window[p][slot] + iter_memory[p];
+                window[p][slot] = iter_memory[p];
+                plan.bcast_memory[layer_offset + p] =
+                    std::max(plan.bcast_memory[layer_offset + p], window_sum[p]);
+              }
+            }
+          }
+
+          if(max_memory)
+            for(auto& bytes : plan.bcast_memory)
+              bytes = std::min<size_type>(bytes, max_memory);
+
+          // All-reduce the replicated result, i.e. a reduce-scatter and an
+          // allgather of the non-zero result tiles
+          if(mode_ == ContractionMode::replicate_result) {
+            size_type bytes = 0ul;
+            for(size_type i = 0ul; i < M; ++i)
+              for(size_type j = 0ul; j < N; ++j)
+                if(! shape_.is_zero(result_index(i, j)))
+                  bytes += result_bytes(i, j);
+            for(auto& proc_bytes : plan.comm_bytes)
+              proc_bytes += 2ul * bytes * (P - 1ul) / P;
+          } else {
+            // Reduce the partial results of the layers and move the result
+            // tiles to their owners
+            for(size_type i = 0ul; i < M; ++i) {
+              for(size_type j = 0ul; j < N; ++j) {
+                const size_type index = result_index(i, j);
+                if(shape_.is_zero(index)) continue;
+                const size_type bytes = result_bytes(i, j);
+                const size_type proc = (i % Pr) * Pc + (j % Pc);
+                plan.comm_bytes[proc] += (layers - 1ul) * bytes;
+                if(size_type(pmap_->owner(index)) != proc)
+                  plan.comm_bytes[pmap_->owner(index)] += bytes;
+              }
+            }
+          }
+        } else if(mode_ == ContractionMode::diagonal) {
+          plan.proc_rows = proc_grid_.proc_rows();
+          plan.proc_cols = proc_grid_.proc_cols();
+          plan.layers = 1ul;
+
+          // Each non-zero result tile is a scaled tile of the other argument,
+          // which is evaluated by the owner of that tile with the diagonal
+          // tile of its row (or column). A Kronecker delta argument only
+          // relabels the tiles, which are scaled if the factor is not 1.
+          const bool delta = (diagonal_left_ ?
+              is_kronecker_delta_engine<left_type>::value :
+              is_kronecker_delta_engine<right_type>::value);
+          const double tile_flops = (! delta ? 2.0 :
+              (factor_ != scalar_type(1) ? 1.0 : 0.0));
+          plan.flops = 0.0;
+          std::vector<std::vector<ProcessID> > fetched(K_);
+          for(size_type i = 0ul; i < M; ++i) {
+            for(size_type j = 0ul; j < N; ++j) {
+              const size_type index = result_index(i, j);
+              if(shape_.is_zero(index)) continue;
+              const size_type x = (diagonal_left_ ? i : j);
+              const size_type arg_index = (diagonal_left_ ? x * N + j : i * K_ + x);
+              const size_type diag_index = x * K_ + x;
+              if(diagonal_left_ ? right_.shape().is_zero(arg_index) :
+                  left_.shape().is_zero(arg_index))
+                continue;
+              const ProcessID source = (diagonal_left_ ?
+                  right_.pmap()->owner(arg_index) : left_.pmap()->owner(arg_index));
+              plan.flops += tile_flops * m[i] * n[j];
+
+              // Fetch each diagonal tile once per process
+              const bool diag_zero = (diagonal_left_ ?
+                  left_.shape().is_zero(diag_index) : right_.shape().is_zero(diag_index));
+              if(! delta && ! diag_zero && (std::find(fetched[x].begin(), fetched[x].end(),
+                  source) == fetched[x].end())) {
+                fetched[x].push_back(source);
+                const size_type bytes = (diagonal_left_ ? left_bytes(x, x) :
+                    right_bytes(x, x));
+                plan.bcast_memory[source] += bytes;
+                if(source != (diagonal_left_ ? left_.pmap()->owner(diag_index) :
+                    right_.pmap()->owner(diag_index)))
+                  plan.comm_bytes[source] += bytes;
+              }
+
+              // Move the result tile to its owner
+              if(size_type(pmap_->owner(index)) != size_type(source))
+                plan.comm_bytes[pmap_->owner(index)] += result_bytes(i, j);
+            }
+          }
+        } else if(mode_ == ContractionMode::pull) {
+          plan.proc_rows = proc_grid_.proc_rows();
+          plan.proc_cols = proc_grid_.proc_cols();
+          plan.layers = 1ul;
+
+          // Each non-zero argument tile is received once by every other
+          // process that owns a non-zero result tile it is contracted into
+          std::vector<ProcessID> dest;
+          for(size_type x = 0ul; x < K_; ++x) {
+            for(size_type i = 0ul; i < M; ++i) {
+              if(left_.shape().is_zero(i * K_ + x)) continue;
+              dest.clear();
+              for(size_type j = 0ul; j < N; ++j)
+                if(! right_.shape().is_zero(x * N + j) && ! shape_.is_zero(result_index(i, j)))
+                  dest.push_back(pmap_->owner(result_index(i, j)));
+              std::sort(dest.begin(), dest.end());
+              dest.erase(std::unique(dest.begin(), dest.end()), dest.end());
+              for(const ProcessID p : dest) {
+                plan.bcast_memory[p] += left_bytes(i, x);
+                if(! left_.pmap()->is_replicated() &&
+                    (p != ProcessID(left_.pmap()->owner(i * K_ + x))))
+                  plan.comm_bytes[p] += left_bytes(i, x);
+              }
+            }
+            for(size_type j = 0ul; j < N; ++j) {
+              if(right_.shape().is_zero(x * N + j)) continue;
+              dest.clear();
+              for(size_type i = 0ul; i < M; ++i)
+                if(! left_.shape().is_zero(i * K_ + x) && ! shape_.is_zero(result_index(i, j)))
+                  dest.push_back(pmap_->owner(result_index(i, j)));
+              std::sort(dest.begin(), dest.end());
+              dest.erase(std::unique(dest.begin(), dest.end()), dest.end());
+              for(const ProcessID p : dest) {
+                plan.bcast_memory[p] += right_bytes(x, j);
+                if(! right_.pmap()->is_replicated() &&
+                    (p != ProcessID(right_.pmap()->owner(x * N + j))))
+                  plan.comm_bytes[p] += right_bytes(x, j);
+              }
+            }
+          }
+        } else {
+          // An outer product is evaluated as a stationary contraction
+          // without reduction, where the larger argument is kept in place
+          const bool keep_left = (mode_ == ContractionMode::keep_left) ||
+              ((mode_ == ContractionMode::outer) && ! outer_left_);
+          plan.proc_rows = proc_grid_.proc_rows();
+          plan.proc_cols = proc_grid_.proc_cols();
+          plan.layers = 1ul;
+          plan.idle_procs = P - proc_grid_.proc_size();
+
+          // Move each non-zero tile of the moving argument to the processes
+          // that hold a stationary tile it is contracted with
+          std::vector<ProcessID> dest;
+          for(size_type x = 0ul; x < K_; ++x) {
+            const size_type outer = (keep_left ? N : M);
+            for(size_type y = 0ul; y < outer; ++y) {
+              const size_type index = (keep_left ? x * N + y : y * K_ + x);
+              if(keep_left ? right_.shape().is_zero(index) : left_.shape().is_zero(index))
+                continue;
+              const ProcessID source = (keep_left ? right_.pmap()->owner(index) :
+                  left_.pmap()->owner(index));
+
+              dest.clear();
+              const size_type inner = (keep_left ? M : N);
+              for(size_type z = 0ul; z < inner; ++z) {
+                const size_type i = (keep_left ? z : y);
+                const size_type j = (keep_left ? y : z);
+                if(shape_.is_zero(result_index(i, j))) continue;
+                if(keep_left) {
+                  if(! left_.shape().is_zero(i * K_ + x))
+                    dest.push_back(left_.pmap()->owner(i * K_ + x));
+                } else {
+                  if(! right_.shape().is_zero(x * N + j))
+                    dest.push_back(right_.pmap()->owner(x * N + j));
+                }
+              }
+              std::sort(dest.begin(), dest.end());
+              dest.erase(std::unique(dest.begin(), dest.end()), dest.end());
+
+              const size_type bytes = (keep_left ? right_bytes(x, y) : left_bytes(y, x));
+              for(const ProcessID p : dest) {
+                plan.bcast_memory[p] += bytes;
+                if(p != source)
+                  plan.comm_bytes[p] += bytes;
+              }
+            }
+          }
+
+          // Reduce the partial results onto the result tile owners
+          std::vector<ProcessID> sources;
+          for(size_type i = 0ul; i < M; ++i) {
+            for(size_type j = 0ul; j < N; ++j) {
+              const size_type index = result_index(i, j);
+              if(shape_.is_zero(index)) continue;
+              sources.clear();
+              for(size_type x = 0ul; x < K_; ++x) {
+                if(left_.shape().is_zero(i * K_ + x) || right_.shape().is_zero(x * N + j))
+                  continue;
+                sources.push_back(keep_left ? left_.pmap()->owner(i * K_ + x) :
+                    right_.pmap()->owner(x * N + j));
+              }
+              std::sort(sources.begin(), sources.end());
+              sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+
+              const ProcessID owner = pmap_->owner(index);
+              for(const ProcessID p : sources)
+                if(p != owner)
+                  plan.comm_bytes[owner] += result_bytes(i, j);
+            }
+          }
+        }
+
+        return plan;
       }
 
       /// Expression identification tag
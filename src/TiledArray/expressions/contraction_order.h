@@ -0,0 +1,389 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_CONTRACTION_ORDER_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_CONTRACTION_ORDER_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/expressions/variable_list.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    template <typename> struct ExprTrait;
+    template <typename> class Expr;
+    template <typename, bool> class TsrExpr;
+    template <typename, typename> class MultExpr;
+
+    /// Association of a product of three operands, <tt>a * b * c</tt>
+    enum class ProductOrder {
+      ab_c, ///< <tt>(a * b) * c</tt>
+      ac_b, ///< <tt>(a * c) * b</tt>
+      a_bc  ///< <tt>a * (b * c)</tt>
+    };
+
+    /// Cost model of a contraction operand
+
+    /// An operand is described by its variables, the number of elements and
+    /// tiles spanned by each variable, and the fraction of non-zero tiles.
+    struct ContractionOperand {
+      std::vector<std::string> vars; ///< Variables of the operand
+      std::vector<double> extents; ///< Number of elements of each variable
+      std::vector<double> tiles; ///< Number of tiles of each variable
+      double density; ///< Fraction of non-zero tiles
+
+      ContractionOperand() : vars(), extents(), tiles(), density(1.0) { }
+
+      /// Find a variable
+
+      /// \param var The variable to find
+      /// \return The position of \c var , or the number of variables when
+      /// \c var is not a variable of this operand
+      std::size_t find(const std::string& var) const {
+        return std::find(vars.begin(), vars.end(), var) - vars.begin();
+      }
+
+      /// \param var The variable to find
+      /// \return \c true if \c var is a variable of this operand
+      bool includes(const std::string& var) const {
+        return find(var) != vars.size();
+      }
+    }; // struct ContractionOperand
+
+    namespace detail {
+
+      /// Check that a product of two operands is a pure contraction
+
+      /// \param x The left-hand operand
+      /// \param y The right-hand operand
+      /// \return \c true if \c x and \c y share at least one variable and the
+      /// product is not a Hadamard product
+      inline bool is_pure_contraction(const ContractionOperand& x,
+          const ContractionOperand& y)
+      {
+        std::size_t shared = 0ul;
+        for(const auto& var : x.vars)
+          if(y.includes(var))
+            ++shared;
+        return (shared != 0ul) &&
+            ! ((shared == x.vars.size()) && (shared == y.vars.size()));
+      }
+
+      /// Predict a pairwise contraction
+
+      /// The variables of the result are the variables that appear in only one
+      /// of the operands, so that the shared variables are summed. A result
+      /// tile is zero only if every one of its tile products is zero, so the
+      /// density of the result is estimated as \f$ 1 - (1 - d_x d_y)^K \f$ ,
+      /// where \f$ K \f$ is the number of tiles in the contracted dimensions.
+      /// \param x The left-hand operand
+      /// \param y The right-hand operand
+      /// \param[out] flops The predicted floating point operations
+      /// \return The result of the contraction
+      inline ContractionOperand contract(const ContractionOperand& x,
+          const ContractionOperand& y, double& flops)
+      {
+        ContractionOperand result;
+        flops = 2.0 * x.density * y.density;
+        double k_tiles = 1.0;
+        for(std::size_t i = 0ul; i < x.vars.size(); ++i) {
+          flops *= x.extents[i];
+          if(y.includes(x.vars[i])) {
+            k_tiles *= x.tiles[i];
+          } else {
+            result.vars.push_back(x.vars[i]);
+            result.extents.push_back(x.extents[i]);
+            result.tiles.push_back(x.tiles[i]);
+          }
+        }
+        for(std::size_t i = 0ul; i < y.vars.size(); ++i) {
+          if(! x.includes(y.vars[i])) {
+            flops *= y.extents[i];
+            result.vars.push_back(y.vars[i]);
+            result.extents.push_back(y.extents[i]);
+            result.tiles.push_back(y.tiles[i]);
+          }
+        }
+
+        const double pair_density = x.density * y.density;
+        result.density = (pair_density >= 1.0 ? 1.0 :
+            1.0 - std::pow(1.0 - pair_density, k_tiles));
+
+        return result;
+      }
+
+      /// Predict the cost of <tt>(x * y) * z</tt>
+
+      /// \return The predicted floating point operations, or infinity if one
+      /// of the products is not a pure contraction
+      inline double product_cost(const ContractionOperand& x,
+          const ContractionOperand& y, const ContractionOperand& z)
+      {
+        if(! is_pure_contraction(x, y))
+          return std::numeric_limits<double>::infinity();
+        double xy_flops = 0.0, xyz_flops = 0.0;
+        const ContractionOperand xy = contract(x, y, xy_flops);
+        if(! is_pure_contraction(xy, z))
+          return std::numeric_limits<double>::infinity();
+        contract(xy, z, xyz_flops);
+        return xy_flops + xyz_flops;
+      }
+
+    } // namespace detail
+
+    /// Select the cheapest association of a product of three operands
+
+    /// Every association of <tt>a * b * c = target</tt> computes the same
+    /// result when each variable appears in exactly two of \c a , \c b ,
+    /// \c c , and \c target , i.e. when the product is a chain of pure
+    /// contractions. The cost of each association is the sum of the
+    /// predicted flops of its two pairwise contractions, where the
+    /// intermediate has the variables that are not summed by the first
+    /// contraction. Associations in which either product is a Hadamard or
+    /// outer product are not considered.
+    /// \param a The first operand
+    /// \param b The second operand
+    /// \param c The third operand
+    /// \param target The variables of the result
+    /// \param current The association given by the expression
+    /// \param allowed Flags that enable each association, indexed by
+    /// \c ProductOrder
+    /// \return The cheapest association, or \c current when the product
+    /// cannot be reordered or when \c current is among the cheapest
+    inline ProductOrder optimal_product_order(const ContractionOperand& a,
+        const ContractionOperand& b, const ContractionOperand& c,
+        const VariableList& target, const ProductOrder current,
+        const bool* allowed = nullptr)
+    {
+      // Check that the product is a chain of contractions
+      const ContractionOperand* const operands[3] = { &a, &b, &c };
+      for(const ContractionOperand* op : operands) {
+        for(const auto& var : op->vars) {
+          const int count = int(a.includes(var)) + int(b.includes(var)) +
+              int(c.includes(var)) +
+              int(std::find(target.begin(), target.end(), var) != target.end());
+          if(count != 2)
+            return current;
+        }
+      }
+      for(const auto& var : target)
+        if(! (a.includes(var) || b.includes(var) || c.includes(var)))
+          return current;
+
+      const double cost[3] = {
+          detail::product_cost(a, b, c),
+          detail::product_cost(a, c, b),
+          detail::product_cost(b, c, a) };
+
+      ProductOrder result = current;
+      double min_cost = cost[static_cast<int>(current)];
+      for(int i = 0; i < 3; ++i) {
+        if((allowed && ! allowed[i]) || ! (cost[i] < min_cost))
+          continue;
+        min_cost = cost[i];
+        result = static_cast<ProductOrder>(i);
+      }
+
+      return result;
+    }
+
+    /// Construct the cost model of an array operand
+
+    /// \tparam A The array type
+    /// \tparam Alias Tile alias flag
+    /// \param expr An initialized array expression
+    /// \return The cost model of \c expr
+    template <typename A, bool Alias>
+    inline ContractionOperand
+    make_contraction_operand(const TsrExpr<A, Alias>& expr) {
+      ContractionOperand result;
+      const VariableList vars(expr.vars());
+      const auto& trange = expr.array().trange();
+      result.vars = vars.data();
+      for(unsigned int i = 0u; i < vars.dim(); ++i) {
+        result.extents.push_back(trange.elements_range().extent(i));
+        result.tiles.push_back(trange.tiles_range().extent(i));
+      }
+      result.density = 1.0 - expr.array().shape().sparsity();
+      return result;
+    }
+
+    /// Contraction order optimizer
+
+    /// The primary template evaluates the expression as given.
+    /// \tparam E The expression type
+    template <typename E>
+    struct ContractionOrder {
+
+      /// Evaluate \c expr and assign it to \c tsr
+
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param expr The expression to evaluate
+      /// \param tsr The tensor to be assigned
+      template <typename A, bool Alias>
+      static void eval_to(const E& expr, TsrExpr<A, Alias>& tsr) {
+        static_cast<const Expr<E>&>(expr).eval_to(tsr);
+      }
+
+    }; // struct ContractionOrder
+
+    namespace detail {
+
+      /// Reassociate and evaluate a product of three array expressions
+
+      /// \tparam Ta The first array expression type
+      /// \tparam Tb The second array expression type
+      /// \tparam Tc The third array expression type
+      template <typename Ta, typename Tb, typename Tc>
+      struct ProductReorder {
+        typedef MultExpr<MultExpr<Ta, Tb>, Tc> ab_c_type;
+        typedef MultExpr<MultExpr<Ta, Tc>, Tb> ac_b_type;
+        typedef MultExpr<Ta, MultExpr<Tb, Tc> > a_bc_type;
+
+        template <typename E>
+        using eval_t = typename ExprTrait<E>::result_type;
+
+        /// Flags of the associations that produce the same tile type as \c E
+        template <typename E>
+        static const bool* allowed() {
+          static const bool flags[3] = {
+              std::is_same<eval_t<ab_c_type>, eval_t<E> >::value,
+              std::is_same<eval_t<ac_b_type>, eval_t<E> >::value,
+              std::is_same<eval_t<a_bc_type>, eval_t<E> >::value };
+          return flags;
+        }
+
+        template <typename X, typename A, bool Alias>
+        static void eval(const X& expr, TsrExpr<A, Alias>& tsr, std::true_type) {
+          static_cast<const Expr<X>&>(expr).eval_to(tsr);
+        }
+
+        template <typename X, typename A, bool Alias>
+        static void eval(const X&, TsrExpr<A, Alias>&, std::false_type) {
+          TA_ASSERT(false);
+        }
+
+        /// Evaluate <tt>a * b * c</tt> in the given association
+
+        /// \tparam E The expression type of the original product
+        template <typename E, typename A, bool Alias>
+        static void eval_to(const Ta& a, const Tb& b, const Tc& c,
+            const ProductOrder order, TsrExpr<A, Alias>& tsr)
+        {
+          switch(order) {
+            case ProductOrder::ab_c:
+              eval(ab_c_type(MultExpr<Ta, Tb>(a, b), c), tsr,
+                  std::is_same<eval_t<ab_c_type>, eval_t<E> >());
+              break;
+            case ProductOrder::ac_b:
+              eval(ac_b_type(MultExpr<Ta, Tc>(a, c), b), tsr,
+                  std::is_same<eval_t<ac_b_type>, eval_t<E> >());
+              break;
+            case ProductOrder::a_bc:
+              eval(a_bc_type(a, MultExpr<Tb, Tc>(b, c)), tsr,
+                  std::is_same<eval_t<a_bc_type>, eval_t<E> >());
+              break;
+          }
+        }
+
+        /// Select the association of <tt>a * b * c</tt>
+
+        /// \tparam E The expression type of the original product
+        /// \return The cheapest association, or \c current when any of the
+        /// expressions has overridden engine parameters or an uninitialized
+        /// array
+        template <typename E, typename A, bool Alias>
+        static ProductOrder order(const E& expr, const Ta& a, const Tb& b,
+            const Tc& c, const ProductOrder current, const TsrExpr<A, Alias>& tsr)
+        {
+          if(expr.is_overridden() || a.is_overridden() || b.is_overridden() ||
+              c.is_overridden())
+            return current;
+          if(! (a.array().is_initialized() && b.array().is_initialized() &&
+              c.array().is_initialized()))
+            return current;
+
+          return optimal_product_order(make_contraction_operand(a),
+              make_contraction_operand(b), make_contraction_operand(c),
+              VariableList(tsr.vars()), current, allowed<E>());
+        }
+
+      }; // struct ProductReorder
+
+    } // namespace detail
+
+    /// Contraction order optimizer for <tt>(a * b) * c</tt>
+    template <typename A1, bool L1, typename A2, bool L2, typename A3, bool L3>
+    struct ContractionOrder<MultExpr<MultExpr<TsrExpr<A1, L1>, TsrExpr<A2, L2> >,
+        TsrExpr<A3, L3> > >
+    {
+      typedef MultExpr<MultExpr<TsrExpr<A1, L1>, TsrExpr<A2, L2> >,
+          TsrExpr<A3, L3> > expr_type;
+      typedef detail::ProductReorder<TsrExpr<A1, L1>, TsrExpr<A2, L2>,
+          TsrExpr<A3, L3> > reorder_type;
+
+      template <typename A, bool Alias>
+      static void eval_to(const expr_type& expr, TsrExpr<A, Alias>& tsr) {
+        const auto& a = expr.left().left();
+        const auto& b = expr.left().right();
+        const auto& c = expr.right();
+        const ProductOrder order = reorder_type::order(expr, a, b, c,
+            ProductOrder::ab_c, tsr);
+        if(order == ProductOrder::ab_c)
+          static_cast<const Expr<expr_type>&>(expr).eval_to(tsr);
+        else
+          reorder_type::template eval_to<expr_type>(a, b, c, order, tsr);
+      }
+    }; // struct ContractionOrder
+
+    /// Contraction order optimizer for <tt>a * (b * c)</tt>
+    template <typename A1, bool L1, typename A2, bool L2, typename A3, bool L3>
+    struct ContractionOrder<MultExpr<TsrExpr<A1, L1>,
+        MultExpr<TsrExpr<A2, L2>, TsrExpr<A3, L3> > > >
+    {
+      typedef MultExpr<TsrExpr<A1, L1>,
+          MultExpr<TsrExpr<A2, L2>, TsrExpr<A3, L3> > > expr_type;
+      typedef detail::ProductReorder<TsrExpr<A1, L1>, TsrExpr<A2, L2>,
+          TsrExpr<A3, L3> > reorder_type;
+
+      template <typename A, bool Alias>
+      static void eval_to(const expr_type& expr, TsrExpr<A, Alias>& tsr) {
+        const auto& a = expr.left();
+        const auto& b = expr.right().left();
+        const auto& c = expr.right().right();
+        const ProductOrder order = reorder_type::order(expr, a, b, c,
+            ProductOrder::a_bc, tsr);
+        if(order == ProductOrder::a_bc)
+          static_cast<const Expr<expr_type>&>(expr).eval_to(tsr);
+        else
+          reorder_type::template eval_to<expr_type>(a, b, c, order, tsr);
+      }
+    }; // struct ContractionOrder
+
+  } // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_CONTRACTION_ORDER_H__INCLUDED
@@ -0,0 +1,125 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_CONTRACTION_PLAN_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_CONTRACTION_PLAN_H__INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Contraction evaluation modes
+
+    /// The mode selects which of the arguments and the result of a
+    /// contraction stay in place while the other two are moved.
+    enum class ContractionMode {
+      automatic,   ///< Keep the largest of the arguments and result stationary
+      keep_result, ///< Keep the result stationary (SUMMA)
+      keep_left,   ///< Keep the left-hand argument stationary
+      keep_right,  ///< Keep the right-hand argument stationary
+      replicate_result, ///< Replicate the result on every process (layered SUMMA with an all-reduce)
+      diagonal,    ///< Scale the tiles of the other argument by a diagonal argument
+      outer,       ///< Outer product with a replicated smaller argument
+      pull         ///< Keep the result stationary and fetch only the argument tiles each result tile needs
+    };
+
+    /// Predicted cost of a contraction
+
+    /// A plan is computed from the structure and distribution of a
+    /// contraction expression (tiled ranges, shapes, and process maps)
+    /// without evaluating any tiles. The flop count is exact for the shape
+    /// of the result, i.e. it includes every tile pair that contributes to a
+    /// non-zero result tile. Communication and memory are predicted from the
+    /// tiles that the selected algorithm moves between processes.
+    struct ContractionPlan {
+      typedef std::size_t size_type; ///< Size type
+
+      ContractionMode mode; ///< The selected contraction mode
+      size_type proc_rows; ///< Number of process grid rows
+      size_type proc_cols; ///< Number of process grid columns
+      size_type layers; ///< Number of process grid layers
+      size_type idle_procs; ///< Number of processes that are not in the SUMMA process grid
+      bool intra_node_rows; ///< The process rows are contained in nodes
+      size_type depth; ///< SUMMA pipeline depth (0 for operand-stationary modes)
+      double flops; ///< Floating point operations of the tile contractions
+      std::vector<size_type> comm_bytes; ///< Bytes received by each process
+      std::vector<size_type> bcast_memory; ///< Peak bytes of received argument tiles held by each process
+
+      ContractionPlan() :
+        mode(ContractionMode::keep_result), proc_rows(0ul), proc_cols(0ul),
+        layers(0ul), idle_procs(0ul), intra_node_rows(false), depth(0ul), flops(0.0), comm_bytes(), bcast_memory()
+      { }
+
+      /// Total communication
+
+      /// \return The number of bytes received by all processes
+      size_type total_comm_bytes() const {
+        return std::accumulate(comm_bytes.begin(), comm_bytes.end(), size_type(0ul));
+      }
+
+      /// Maximum communication
+
+      /// \return The largest number of bytes received by a process
+      size_type max_comm_bytes() const {
+        return (comm_bytes.empty() ? 0ul :
+            *std::max_element(comm_bytes.begin(), comm_bytes.end()));
+      }
+
+      /// Peak broadcast memory
+
+      /// \return The largest number of bytes of received argument tiles held
+      /// at once by a process
+      size_type peak_bcast_memory() const {
+        return (bcast_memory.empty() ? 0ul :
+            *std::max_element(bcast_memory.begin(), bcast_memory.end()));
+      }
+
+    }; // struct ContractionPlan
+
+    /// Contraction plan output operator
+
+    /// The plan is written as a single line of \c key=value pairs.
+    /// \param os The output stream
+    /// \param plan The contraction plan
+    /// \return \c os
+    inline std::ostream& operator<<(std::ostream& os, const ContractionPlan& plan) {
+      static const char* const modes[] =
+          { "automatic", "keep_result", "keep_left", "keep_right",
+            "replicate_result", "diagonal", "outer", "pull" };
+      os << "mode=" << modes[static_cast<int>(plan.mode)]
+         << " grid=" << plan.proc_rows << "x" << plan.proc_cols << "x" << plan.layers
+         << " idle=" << plan.idle_procs
+         << " intra_node_rows=" << (plan.intra_node_rows ? "yes" : "no")
+         << " depth=" << plan.depth
+         << " flops=" << plan.flops
+         << " comm_bytes=" << plan.total_comm_bytes()
+         << " max_comm_bytes=" << plan.max_comm_bytes()
+         << " peak_bcast_memory=" << plan.peak_bcast_memory();
+      return os;
+    }
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_CONTRACTION_PLAN_H__INCLUDED
@@ -0,0 +1,96 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EVAL_HANDLE_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EVAL_HANDLE_H__INCLUDED
+
+#include <functional>
+#include <initializer_list>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Completion handle of an asynchronous expression statement
+
+    /// An asynchronous assignment, e.g.
+    /// <tt>c("i,j").assign_async(a("i,k") * b("k,j"))</tt>, stores futures
+    /// to the result tiles in the result array and returns without waiting
+    /// for them. Consumers of the result array, including other expression
+    /// statements, wait only for the tiles that they use. The handle waits
+    /// for all local tiles of the statement on this process, e.g. before
+    /// the arguments of the statement are modified in place.
+    /// \note The handle is not a fence: remote tasks of the statement may
+    /// still be running when \c wait() returns.
+    class EvalHandle {
+    private:
+
+      std::function<bool()> probe_; ///< Test that the local tiles are set
+      std::function<void()> wait_; ///< Wait for the local tiles
+
+    public:
+
+      /// Construct the handle of a completed statement
+      EvalHandle() = default;
+      EvalHandle(const EvalHandle&) = default;
+      EvalHandle(EvalHandle&&) = default;
+      ~EvalHandle() = default;
+      EvalHandle& operator=(const EvalHandle&) = default;
+      EvalHandle& operator=(EvalHandle&&) = default;
+
+      /// Construct the handle of an evaluated statement
+
+      /// \tparam DistEval The distributed evaluator type
+      /// \param dist_eval The evaluated root distributed evaluator of the
+      /// statement, which is kept alive by the handle until it is complete
+      template <typename DistEval>
+      explicit EvalHandle(const DistEval& dist_eval) :
+        probe_([dist_eval] () { return dist_eval.probe(); }),
+        wait_([dist_eval] () { dist_eval.wait(); })
+      { }
+
+      /// Test that the statement is complete
+
+      /// \return \c true if all local tiles of the statement are set
+      bool probe() const { return (! probe_) || probe_(); }
+
+      /// Wait for the local tiles of the statement
+
+      /// Tasks are executed by this thread while it waits.
+      void wait() {
+        if(wait_) {
+          wait_();
+          probe_ = nullptr;
+          wait_ = nullptr;
+        }
+      }
+
+    }; // class EvalHandle
+
+    /// Wait for the local tiles of several statements
+
+    /// \param handles The handles of the statements
+    inline void wait_all(std::initializer_list<EvalHandle> handles) {
+      for(EvalHandle handle : handles)
+        handle.wait();
+    }
+
+  } // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_EVAL_HANDLE_H__INCLUDED
@@ -27,13 +27,31 @@
 #define TILEDARRAY_EXPRESSIONS_EXPR_H__INCLUDED
 
 #include "expr_engine.h"
+#include "eval_handle.h"
+#include "contraction_plan.h"
+#include "expr_prediction.h"
+#include "expr_slice.h"
+#include "fused_engine.h"
 #include "../reduce_task.h"
+#include "../reduction_batch.h"
+#include "../dist_eval/summa_options.h"
+#include "../dist_eval/tensor_all_reduce.h"
+#include "../shape.h"
+#include "../tensor/memory_tracker.h"
+#include "../work_counter.h"
+#include "../runtime_telemetry.h"
 #include "../tile_interface/cast.h"
 #include "../tile_interface/scale.h"
+#include "../tile_interface/add.h"
+#include "../tile_interface/clone.h"
+#include "../tile_interface/permute.h"
+#include "../pmap/block_pmap.h"
+#include "../tile_op/tile_interface.h"
 #include "../tile_op/shift.h"
 #include "../tile_op/unary_wrapper.h"
 #include "../tile_op/unary_reduction.h"
 #include "../tile_op/binary_reduction.h"
+#include "../tile_op/multi_reduction.h"
 #include "../tile_op/reduce_wrapper.h"
 
 namespace TiledArray {
@@ -48,7 +66,10 @@ namespace TiledArray {
     template <typename Engine>
     struct EngineParamOverride {
 
-      EngineParamOverride() : world(nullptr), pmap(), shape(nullptr) {}
+      EngineParamOverride() : world(nullptr), pmap(), shape(nullptr),
+        summa_layers(0u), summa(), contraction_mode(ContractionMode::automatic),
+        shape_threshold(-1.0f), truncate(false), symmetry(),
+        reuse_storage(false), batch_max_memory(0ul), batch_var() {}
 
       typedef typename EngineTrait<Engine>::policy policy; ///< The result policy type
       typedef typename EngineTrait<Engine>::shape_type shape_type; ///< Tensor shape type
@@ -57,6 +78,15 @@ namespace TiledArray {
        World* world;
        std::shared_ptr<pmap_interface> pmap;
        const shape_type* shape;
+       unsigned int summa_layers; ///< Number of SUMMA process grid layers (0 = automatic)
+       TiledArray::detail::SummaOptions summa; ///< SUMMA pipeline options, forwarded to \c Summa
+       ContractionMode contraction_mode; ///< The operand that stays in place in a contraction
+       float shape_threshold; ///< Zero threshold of the result shape (negative = from the arguments)
+       bool truncate; ///< Drop result tiles whose computed norm is below the zero threshold
+       std::shared_ptr<const symmetry::PermutationGroup> symmetry; ///< Permutational symmetry of the result (null = none)
+       bool reuse_storage; ///< Write the result into the tiles of the result array
+       std::size_t batch_max_memory; ///< Memory limit per process in bytes that batches the evaluation (0 = no batches)
+       std::string batch_var; ///< The result variable whose tiles are batched (empty = the one with the most tiles)
     };
 
     /// \brief type trait checks if T has array() member
@@ -135,6 +165,234 @@ namespace TiledArray {
         }
         return derived();
       }
+      /// \param layers the number of process grid layers used to evaluate a
+      /// contraction with 2.5D SUMMA; 1 selects the 2D algorithm and 0 lets
+      /// the number of layers be chosen automatically. A number of layers
+      /// that does not divide the number of processes is reduced to the
+      /// largest divisor. This parameter only affects contraction
+      /// expressions.
+      Expr<Derived>& set_summa_layers(const unsigned int layers) {
+        if (override_ptr_) {
+          override_ptr_->summa_layers = layers;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->summa_layers = layers;
+        }
+        return derived();
+      }
+      /// \param max_memory the memory, in bytes, that may be used on each node
+      /// by the tiles of in-flight SUMMA iterations and result tiles; the
+      /// number of concurrent iterations is adjusted at runtime to stay within
+      /// this limit. This parameter only affects contraction expressions and
+      /// overrides \c TA_SUMMA_MAX_MEMORY .
+      Expr<Derived>& set_summa_max_memory(const std::size_t max_memory) {
+        if (override_ptr_) {
+          override_ptr_->summa.max_memory = max_memory;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->summa.max_memory = max_memory;
+        }
+        return derived();
+      }
+      /// \param max_depth the maximum number of concurrent SUMMA iterations.
+      /// This parameter only affects contraction expressions and overrides
+      /// \c TA_SUMMA_MAX_DEPTH .
+      Expr<Derived>& set_summa_max_depth(const unsigned int max_depth) {
+        if (override_ptr_) {
+          override_ptr_->summa.max_depth = max_depth;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->summa.max_depth = max_depth;
+        }
+        return derived();
+      }
+      /// \param work_order if \c true, the iterations of a sparse contraction
+      /// are visited in order of decreasing estimated work (the product of
+      /// the non-zero volumes of the paired argument column and row), so the
+      /// heaviest panels enter the pipeline first. This parameter only
+      /// affects contraction expressions with sparse arguments.
+      Expr<Derived>& set_summa_work_order(const bool work_order) {
+        if (override_ptr_) {
+          override_ptr_->summa.work_order = work_order;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->summa.work_order = work_order;
+        }
+        return derived();
+      }
+      /// \param batch if \c true, the tile pairs of each SUMMA step that
+      /// share a left-hand tile are contracted in a single task instead of one
+      /// task per pair. This reduces the task overhead of contractions with
+      /// small tiles. This parameter only affects contraction expressions.
+      Expr<Derived>& set_summa_batch(const bool batch) {
+        if (override_ptr_) {
+          override_ptr_->summa.batch = batch;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->summa.batch = batch;
+        }
+        return derived();
+      }
+      /// \param prefetch if \c true, the row and column panels of the SUMMA
+      /// steps in the pipeline are broadcast as soon as their tiles and
+      /// broadcast groups are available, so communication overlaps the
+      /// contraction of earlier steps. The fraction of received tiles that
+      /// arrived before their step started is accumulated in
+      /// \c detail::SummaOverlapStats . This parameter only affects
+      /// contraction expressions.
+      Expr<Derived>& set_summa_prefetch(const bool prefetch) {
+        if (override_ptr_) {
+          override_ptr_->summa.prefetch = prefetch;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->summa.prefetch = prefetch;
+        }
+        return derived();
+      }
+      /// \param node_bcast if \c true, SUMMA panels are broadcast in two
+      /// levels: first among one process per node, then from that process to
+      /// the others on its node, so each tile crosses the network once per
+      /// node. Nodes are detected from the host names of the processes, or
+      /// set with \c TA_RANKS_PER_NODE . This parameter only affects
+      /// contraction expressions.
+      Expr<Derived>& set_summa_node_bcast(const bool node_bcast) {
+        if (override_ptr_) {
+          override_ptr_->summa.node_bcast = node_bcast;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->summa.node_bcast = node_bcast;
+        }
+        return derived();
+      }
+      /// \param mode the contraction mode, which selects whether the result
+      /// (SUMMA), the left-hand argument, or the right-hand argument stays in
+      /// place while the other two are moved. The automatic mode keeps an
+      /// argument stationary when its non-zero volume exceeds that of the
+      /// other argument and the result combined. In \c replicate_result mode,
+      /// which is also selected by the automatic mode when the result array
+      /// has a replicated process map, every process contracts a slice of
+      /// the inner dimension and the partial results are combined onto every
+      /// process by one all-reduce. This parameter only affects contraction
+      /// expressions.
+      Expr<Derived>& set_contraction_mode(const ContractionMode mode) {
+        if (override_ptr_) {
+          override_ptr_->contraction_mode = mode;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->contraction_mode = mode;
+        }
+        return derived();
+      }
+      /// \param threshold the zero threshold of the result shape, which is
+      /// used instead of the tighter of the thresholds of the arguments.
+      /// Result tiles with a norm below \c threshold are not computed, and
+      /// the result array keeps \c threshold as the threshold of its shape.
+      /// A contraction screens its result at \c threshold directly; other
+      /// expressions do not recover tiles that the arguments screened with a
+      /// looser threshold. This parameter only affects sparse expressions.
+      Expr<Derived>& set_shape_threshold(const float threshold) {
+        TA_ASSERT(threshold >= 0.0f);
+        if (override_ptr_) {
+          override_ptr_->shape_threshold = threshold;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->shape_threshold = threshold;
+        }
+        return derived();
+      }
+      /// \param truncate if \c true, the norm of each result tile is computed
+      /// as soon as the tile is evaluated, and the shape of the result array
+      /// is constructed from the computed norms, with a single reduction
+      /// after the evaluation. Tiles whose norm is below the zero threshold
+      /// are not stored. This is equivalent to, but cheaper than, calling
+      /// \c truncate() on the result. This parameter only affects sparse
+      /// expressions assigned to whole arrays.
+      Expr<Derived>& set_truncate(const bool truncate) {
+        if (override_ptr_) {
+          override_ptr_->truncate = truncate;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->truncate = truncate;
+        }
+        return derived();
+      }
+
+      /// \param group the group of permutations of the result modes, in the
+      /// order of the variables of the result, that leave the result
+      /// invariant. Only the representative tiles of the orbits of the
+      /// result tiles (see \c symmetry::TileSymmetry ) are evaluated, and the
+      /// result array stores only those tiles (see
+      /// \c DistArray::set_tile_symmetry() ); the other tiles are permuted
+      /// copies of their representatives. A contraction skips the tile
+      /// products of the other tiles, except when its result is replicated
+      /// or an argument stays in place. The expression must actually have
+      /// this symmetry. This parameter only affects expressions assigned to
+      /// whole arrays, and it cannot be combined with \c set_truncate() .
+      Expr<Derived>& set_symmetry(const symmetry::PermutationGroup& group) {
+        if (! override_ptr_)
+          override_ptr_ = std::make_shared<override_type>();
+        override_ptr_->symmetry =
+            std::make_shared<const symmetry::PermutationGroup>(group);
+        return derived();
+      }
+
+      /// \param reuse if \c true, and the result array has the tiled range,
+      /// the process map, and the world of the result, the result array is
+      /// updated in place instead of being replaced by a new array: the data
+      /// of each result tile is copied into the memory of the tile that it
+      /// replaces, when no other tile shares that memory, so repeated
+      /// assignments to the same array do not allocate new tiles or hold two
+      /// copies of the array. All shallow copies of the result array share
+      /// the result. The result array is replaced as usual when the
+      /// expression reads it, or when the result is truncated or symmetric.
+      /// This parameter only affects expressions assigned to whole arrays
+      /// with \c operator= .
+      Expr<Derived>& set_reuse_storage(const bool reuse) {
+        if (override_ptr_) {
+          override_ptr_->reuse_storage = reuse;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->reuse_storage = reuse;
+        }
+        return derived();
+      }
+
+      /// \param max_memory the memory, in bytes, that may be used on each
+      /// process by the result and intermediate tiles of the expression.
+      /// When the tiles predicted from the shapes exceed \c max_memory , the
+      /// expression is evaluated in batches: the result variable with the
+      /// most tiles (see \c set_batch_var() ) is split into ranges of whole
+      /// tiles, and for each range the slice of the expression (see
+      /// \c slice_expr() ), in which the arguments are blocks, is evaluated,
+      /// its tiles are moved into the result, and its intermediate tiles are
+      /// freed before the next batch. The number of batches is the predicted
+      /// memory divided by \c max_memory . 0 disables batches. This parameter
+      /// only affects expressions of tensors and blocks, and their sums,
+      /// differences, products, and scaled forms, that are assigned to whole
+      /// arrays without a shape, process map, symmetry, or reused storage.
+      Expr<Derived>& set_batch_max_memory(const std::size_t max_memory) {
+        if (override_ptr_) {
+          override_ptr_->batch_max_memory = max_memory;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->batch_max_memory = max_memory;
+        }
+        return derived();
+      }
+
+      /// \param var the result variable whose tiles are split into batches
+      /// (see \c set_batch_max_memory() ), which must denote the same
+      /// dimension wherever it appears in the expression. By default, the
+      /// result variable with the most tiles is split.
+      Expr<Derived>& set_batch_var(const std::string& var) {
+        if (override_ptr_) {
+          override_ptr_->batch_var = var;
+        } else {
+          override_ptr_ = std::make_shared<override_type>();
+          override_ptr_->batch_var = var;
+        }
+        return derived();
+      }
 
     private:
 
@@ -259,6 +517,244 @@ namespace TiledArray {
         array.set(index, array.world().taskq.add(eval_tile_fn_ptr, tile, op));
       }
 
+      /// Evaluate a lazy tile
+
+      /// \tparam R The result tile type
+      /// \tparam T The lazy tile type
+      /// \param world The world where the task is spawned
+      /// \param tile The lazy tile
+      /// \return A future to the evaluated tile
+      template <typename R, typename T,
+          typename std::enable_if<! std::is_same<R, T>::value>::type* = nullptr>
+      static Future<R> cast_tile(World& world, const Future<T>& tile) {
+        return world.taskq.add(TiledArray::Cast<R, T>(), tile);
+      }
+
+      /// Evaluate a tile
+
+      /// \tparam R The result tile type
+      /// \param tile The tile
+      /// \return \c tile
+      template <typename R>
+      static const Future<R>& cast_tile(World&, const Future<R>& tile) {
+        return tile;
+      }
+
+      /// Task function used to compute the norm of a result tile
+
+      /// \tparam N The norm type
+      /// \tparam T The tile type
+      /// \param tile The tile
+      /// \return The norm of \c tile
+      template <typename N, typename T>
+      static N tile_norm(const T& tile) { return N(tile.norm()); }
+
+      /// Construct the result array of a distributed evaluator
+
+      /// \tparam A The array type
+      /// \tparam DistEval The distributed evaluator type
+      /// \param dist_eval The distributed evaluator
+      /// \param wait If \c true , wait for the local tiles of \c dist_eval
+      /// \param symmetry The permutational symmetry of the result; only the
+      /// representative tiles are evaluated by \c dist_eval (may be null)
+      /// \param materialize If \c true , the other tiles of a symmetric result
+      /// are set with permuted copies of their representatives, otherwise
+      /// only the representative tiles are stored [ default = false ]
+      /// \return An array with the tiles and the shape of \c dist_eval
+      template <typename A, typename DistEval>
+      A make_array(DistEval& dist_eval, const bool wait = true,
+          const std::shared_ptr<const symmetry::TileSymmetry>& symmetry = nullptr,
+          const bool materialize = false) const
+      {
+        // Create the result array
+        A result(dist_eval.world(), dist_eval.trange(),
+            dist_eval.shape(), dist_eval.pmap());
+        if(symmetry && ! materialize)
+          result.set_tile_symmetry(symmetry->group());
+
+        // Move the data from dist_eval into the result array. There is no
+        // communication in this step.
+        for(const auto index : *dist_eval.pmap()) {
+          if(dist_eval.is_zero(index))
+            continue;
+          if(symmetry && ! symmetry->is_representative(index))
+            continue;
+          set_tile(result, index, dist_eval.get(index));
+        }
+
+        // Set the other tiles with the transposes of their representatives,
+        // when the representatives are assigned
+        if(symmetry && materialize) {
+          for(const auto index : *dist_eval.pmap()) {
+            if(dist_eval.is_zero(index) || symmetry->is_representative(index))
+              continue;
+            const auto rep = symmetry->representative(index);
+            result.set(index, result.world().taskq.add(
+                TiledArray::tile_interface::Permute<typename A::value_type,
+                    typename A::value_type>(),
+                result.find(rep.first), rep.second));
+          }
+        }
+
+        // Wait for child expressions of dist_eval
+        if(wait)
+          dist_eval.wait();
+
+        return result;
+      }
+
+      /// Construct the truncated result array of a distributed evaluator
+
+      /// Dense results are not truncated.
+      /// \tparam A The array type
+      /// \tparam DistEval The distributed evaluator type
+      /// \param dist_eval The distributed evaluator
+      /// \return An array with the tiles and the shape of \c dist_eval
+      template <typename A, typename DistEval,
+          typename std::enable_if<
+              TiledArray::is_dense<typename DistEval::shape_type>::value
+          >::type* = nullptr>
+      A make_truncated_array(DistEval& dist_eval) const {
+        return make_array<A>(dist_eval);
+      }
+
+      /// Construct the truncated result array of a distributed evaluator
+
+      /// The norm of each tile is computed by a task as soon as the tile is
+      /// evaluated. After the evaluation, the shape of the result is
+      /// constructed from the computed norms, which reduces them across all
+      /// processes, and the tiles that are not zero in that shape are stored.
+      /// \tparam A The array type
+      /// \tparam DistEval The distributed evaluator type
+      /// \param dist_eval The distributed evaluator
+      /// \return An array with the tiles of \c dist_eval , where the tiles
+      /// whose norm is below the zero threshold are dropped
+      template <typename A, typename DistEval,
+          typename std::enable_if<
+              ! TiledArray::is_dense<typename DistEval::shape_type>::value
+          >::type* = nullptr>
+      A make_truncated_array(DistEval& dist_eval) const {
+        typedef typename A::value_type value_type;
+        typedef typename A::shape_type shape_type;
+        typedef typename shape_type::value_type norm_type;
+        World& world = dist_eval.world();
+
+        // Compute the norms of the local tiles as they are evaluated
+        std::vector<std::pair<std::size_t, Future<value_type> > > tiles;
+        std::vector<Future<norm_type> > norms;
+        for(const auto index : *dist_eval.pmap()) {
+          if(dist_eval.is_zero(index))
+            continue;
+          const Future<value_type> tile =
+              cast_tile<value_type>(world, dist_eval.get(index));
+          norms.push_back(world.taskq.add(
+              & Expr_::template tile_norm<norm_type, value_type>, tile));
+          tiles.emplace_back(index, tile);
+        }
+
+        // Wait for child expressions of dist_eval
+        dist_eval.wait();
+
+        // Construct the result shape from the computed norms
+        Tensor<norm_type> tile_norms(dist_eval.trange().tiles_range(), norm_type(0));
+        for(std::size_t i = 0ul; i < tiles.size(); ++i)
+          tile_norms[tiles[i].first] = norms[i].get();
+        const shape_type shape(world, tile_norms, dist_eval.trange(),
+            dist_eval.shape().zero_threshold());
+
+        // Store the tiles that are not zero
+        A result(world, dist_eval.trange(), shape, dist_eval.pmap());
+        for(const auto& tile : tiles) {
+          if(! result.is_zero(tile.first))
+            result.set(tile.first, tile.second);
+        }
+
+        return result;
+      }
+
+      /// Task function used to write a result tile into an array tile
+
+      /// \tparam T The tile type
+      /// \param target The array tile that is overwritten, whose memory is
+      /// not shared with any other tile
+      /// \param tile The result tile, which has the range of \c target
+      /// \return \c target , which holds the elements of \c tile
+      template <typename T>
+      static T overwrite_tile(const T& target, const T& tile) {
+        T result = target;
+        TA_ASSERT(result.range() == tile.range());
+        std::copy(std::begin(tile), std::end(tile), std::begin(result));
+        return result;
+      }
+
+      /// Check that result tiles can be written into the tiles of an array
+
+      /// \tparam A The array type
+      /// \tparam DistEval The distributed evaluator type
+      template <typename A, typename DistEval>
+      using is_overwritable = std::integral_constant<bool,
+          std::is_same<typename DistEval::value_type, typename A::value_type>::value &&
+          TiledArray::detail::has_member_function_begin_anyreturn<
+              typename A::value_type>::value>;
+
+      /// Assign the result of a distributed evaluator to an array in place
+
+      /// This version is used for tiles that cannot be overwritten.
+      /// \return \c false
+      template <typename A, typename DistEval,
+          typename std::enable_if<! is_overwritable<A, DistEval>::value>::type* = nullptr>
+      bool assign_in_place(A&, DistEval&, const engine_type&) const {
+        return false;
+      }
+
+      /// Assign the result of a distributed evaluator to an array in place
+
+      /// When \c array has the tiled range, the process map, and the world of
+      /// the result, and is not read by the expression, its shape and tiles
+      /// are replaced (see \c DistArray::reassign() ). A result tile is
+      /// written into the memory of the tile that it replaces when no other
+      /// tile shares that memory; otherwise the result tile is stored. The
+      /// decision on the array is the same on all processes.
+      /// \tparam A The array type
+      /// \tparam DistEval The distributed evaluator type
+      /// \param array The result array
+      /// \param dist_eval The evaluated distributed evaluator
+      /// \param engine The engine of \c dist_eval
+      /// \return \c true if \c array was assigned, otherwise \c false
+      template <typename A, typename DistEval,
+          typename std::enable_if<is_overwritable<A, DistEval>::value>::type* = nullptr>
+      bool assign_in_place(A& array, DistEval& dist_eval, const engine_type& engine) const {
+        typedef typename A::value_type value_type;
+
+        if(! array.is_initialized() || array.tile_symmetry() || engine.symmetry()
+            || (& array.world() != & dist_eval.world())
+            || (array.pmap() != dist_eval.pmap())
+            || (array.trange() != dist_eval.trange()))
+          return false;
+
+        // The tiles of the array cannot be overwritten while the expression
+        // reads them.
+        std::stringstream key;
+        key << " #" << array.id();
+        if(engine.cse_key().find(key.str()) != std::string::npos)
+          return false;
+
+        World& world = array.world();
+        array.reassign(dist_eval.shape(),
+            [&] (const std::size_t index, const Future<value_type>& old) {
+              const Future<value_type> tile = dist_eval.get(index);
+              if(old.probe() && TiledArray::is_unique(old.get()))
+                return world.taskq.add(& Expr_::template overwrite_tile<value_type>,
+                    old, tile);
+              return tile;
+            });
+
+        // Wait for child expressions of dist_eval
+        dist_eval.wait();
+
+        return true;
+      }
+
      public:
 
       // Compiler generated functions
@@ -275,16 +771,20 @@ namespace TiledArray {
       /// Cast this object to its derived type
       const derived_type& derived() const { return *static_cast<const derived_type*>(this); }
 
-      /// Evaluate this object and assign it to \c tsr
+      /// Check for overridden engine parameters
+
+      /// \return \c true if any engine parameter of this expression was set,
+      /// e.g. with \c set_world() or \c set_shape()
+      bool is_overridden() const { return static_cast<bool>(override_ptr_); }
+
+      /// Initialize an engine of this object for the assignment to \c tsr
 
-      /// This expression is evaluated in parallel in distributed environments,
-      /// where the content of \c tsr will be replaced by the results of the
-      /// evaluated tensor expression.
       /// \tparam A The array type
       /// \tparam Alias Tile alias flag
-      /// \param tsr The tensor to be assigned
+      /// \param engine The engine of this expression
+      /// \param tsr The tensor that will be assigned
       template <typename A, bool Alias>
-      void eval_to(TsrExpr<A, Alias>& tsr) const {
+      void init_engine(engine_type& engine, TsrExpr<A, Alias>& tsr) const {
         static_assert(! is_lazy_tile<typename A::value_type>::value,
             "Assignment to an array of lazy tiles is not supported.");
 
@@ -307,33 +807,155 @@ namespace TiledArray {
         // Get result variable list.
         VariableList target_vars(tsr.vars());
 
-        // Construct the expression engine
-        engine_type engine(derived());
+        // Initialize the expression engine
         engine.init(world, pmap, target_vars);
 
+        if(override_ptr_ && override_ptr_->symmetry) {
+          TA_USER_ASSERT(! override_ptr_->truncate,
+              "Expr::init_engine(): symmetric results cannot be truncated.");
+          engine.init_symmetry(*override_ptr_->symmetry);
+        } else if(! (override_ptr_ && override_ptr_->truncate)) {
+          // Only the representative tiles of a symmetric result are
+          // evaluated; the result array still holds every tile
+          const auto group = engine.implied_symmetry();
+          if(group)
+            engine.init_symmetry(*group, true);
+        }
+      }
+
+      /// Evaluate an initialized engine of this object and assign it to \c tsr
+
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param engine The engine of this expression, initialized by
+      /// \c init_engine()
+      /// \param tsr The tensor to be assigned
+      template <typename A, bool Alias>
+      void eval_engine_to(const engine_type& engine, TsrExpr<A, Alias>& tsr) const {
         // Create the distributed evaluator from this expression
-        typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
+        typename engine_type::dist_eval_type dist_eval = make_root_dist_eval(engine);
         dist_eval.eval();
 
+        // Write the result into the existing result array
+        if(override_ptr_ && override_ptr_->reuse_storage && ! override_ptr_->truncate
+            && assign_in_place(tsr.array(), dist_eval, engine))
+          return;
+
         // Create the result array
-        A result(dist_eval.world(), dist_eval.trange(),
-            dist_eval.shape(), dist_eval.pmap());
+        A result = ((override_ptr_ && override_ptr_->truncate) ?
+            make_truncated_array<A>(dist_eval) :
+            make_array<A>(dist_eval, true, engine.symmetry(),
+                engine.is_symmetry_implied()));
 
-        // Move the data from dist_eval into the result array. There is no
-        // communication in this step.
-        for(const auto index : *dist_eval.pmap()) {
-          if(! dist_eval.is_zero(index))
-            set_tile(result, index, dist_eval.get(index));
+        // Swap the new array with the result array object.
+        result.swap(tsr.array());
+      }
+
+      /// Expression trace of an initialized engine on one line
+
+      /// \param engine The engine of this expression, initialized by
+      /// \c init_engine()
+      /// \param target_vars The target variable list of this expression
+      /// \return The expression trace, e.g. for \c RuntimeStatement::label
+      static std::string trace_label(const engine_type& engine,
+          const VariableList& target_vars)
+      {
+        std::stringstream ss;
+        ss << target_vars << " =";
+        ExprOStream os(ss);
+        engine.print(os, target_vars);
+
+        // Join the lines of the trace
+        std::string label;
+        bool space = false;
+        for(const char c : ss.str()) {
+          if((c == '\n') || (c == ' ')) {
+            space = true;
+          } else {
+            if(space)
+              label.push_back(' ');
+            label.push_back(c);
+            space = false;
+          }
         }
+        return label;
+      }
 
-        // Wait for child expressions of dist_eval
-        dist_eval.wait();
+      /// Evaluate this object and assign it to \c tsr
 
-        // Swap the new array with the result array object.
-        result.swap(tsr.array());
+      /// This expression is evaluated in parallel in distributed environments,
+      /// where the content of \c tsr will be replaced by the results of the
+      /// evaluated tensor expression. The high-water mark of the tensor
+      /// memory of this process during the evaluation is recorded (see
+      /// \c MemoryStatistics::eval_peak_bytes ), as are the flops, the bytes
+      /// moved, and the wall time of the evaluation (see
+      /// \c last_eval_statistics() ). When the runtime is sampled (see
+      /// \c start_runtime_telemetry() ), the evaluation is recorded as a
+      /// statement of the telemetry. An expression with a memory limit (see
+      /// \c set_batch_max_memory() ) may be evaluated in batches.
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param tsr The tensor to be assigned
+      template <typename A, bool Alias>
+      void eval_to(TsrExpr<A, Alias>& tsr) const {
+        if(override_ptr_ && (override_ptr_->batch_max_memory > 0ul) &&
+            eval_batched_to(tsr, is_sliceable_expr<Derived>()))
+          return;
+
+        MemoryScope memory_scope;
+        const WorkStatistics work_begin = work_statistics();
+        const double start = madness::wall_time();
+
+        // Construct the expression engine
+        engine_type engine(derived());
+        init_engine(engine, tsr);
+        {
+          TiledArray::detail::RuntimeTelemetryScope telemetry_scope([&] () {
+              return trace_label(engine, VariableList(tsr.vars())); });
+          eval_engine_to(engine, tsr);
+        }
+
+        TiledArray::detail::MemoryTracker::instance().eval_peak_bytes(
+            memory_scope.end());
+        TiledArray::detail::WorkCounter::instance().record_eval(work_begin,
+            madness::wall_time() - start);
       }
 
 
+      /// Evaluate this object and assign it to \c tsr without waiting
+
+      /// The content of \c tsr is replaced by futures to the tiles of this
+      /// expression, which are evaluated by tasks after this function
+      /// returns. Truncated results (see \c set_truncate() ) are complete
+      /// when they are assigned, since the shape of the result depends on the
+      /// norms of the tiles.
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param tsr The tensor to be assigned
+      /// \return The completion handle of the assignment
+      template <typename A, bool Alias>
+      EvalHandle eval_async_to(TsrExpr<A, Alias>& tsr) const {
+        // Construct the expression engine
+        engine_type engine(derived());
+        init_engine(engine, tsr);
+
+        if(override_ptr_ && override_ptr_->truncate) {
+          eval_engine_to(engine, tsr);
+          return EvalHandle();
+        }
+
+        // Create the distributed evaluator from this expression
+        typename engine_type::dist_eval_type dist_eval = make_root_dist_eval(engine);
+        dist_eval.eval();
+
+        // Create the result array, and swap it with the result array object
+        A result = make_array<A>(dist_eval, false, engine.symmetry(),
+            engine.is_symmetry_implied());
+        result.swap(tsr.array());
+
+        return EvalHandle(dist_eval);
+      }
+
       /// Evaluate this object and assign it to \c tsr
 
       /// This expression is evaluated in parallel in distributed environments,
@@ -380,7 +1002,7 @@ namespace TiledArray {
         engine.init(world, pmap, target_vars);
 
         // Create the distributed evaluator from this expression
-        typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
+        typename engine_type::dist_eval_type dist_eval = make_root_dist_eval(engine);
         dist_eval.eval();
 
         // Create the result array
@@ -428,6 +1050,156 @@ namespace TiledArray {
         result.swap(tsr.array());
       }
 
+      /// Task function that accumulates a block tile into an array tile
+
+      /// \tparam T The array tile type
+      /// \tparam Arg The block tile type
+      /// \tparam Op The shift operation type
+      /// \param result The array tile, which is modified in place
+      /// \param arg The block tile
+      /// \param op The operation that shifts \c arg to the range of \c result
+      /// \param subtract If \c true , \c arg is subtracted from \c result
+      /// \return \c result
+      template <typename T, typename Arg, typename Op>
+      static T accumulate_tile(T result, const Arg& arg,
+          const std::shared_ptr<Op>& op, const bool subtract)
+      {
+        using TiledArray::add_to;
+        using TiledArray::subt_to;
+        const T shifted = (*op)(arg);
+        if(subtract)
+          subt_to(result, shifted);
+        else
+          add_to(result, shifted);
+        return result;
+      }
+
+      /// Task function that copies a block tile into a new array tile
+
+      /// \tparam T The array tile type
+      /// \tparam Arg The block tile type
+      /// \tparam Op The shift operation type
+      /// \param arg The block tile
+      /// \param op The operation that shifts \c arg to the array tile range
+      /// \param subtract If \c true , the copy is negated
+      /// \return The shifted copy of \c arg
+      template <typename T, typename Arg, typename Op>
+      static T copy_tile(const Arg& arg, const std::shared_ptr<Op>& op,
+          const bool subtract)
+      {
+        using TiledArray::clone;
+        using TiledArray::neg;
+        const T shifted = (*op)(arg);
+        return (subtract ? T(neg(shifted)) : T(clone(shifted)));
+      }
+
+      /// Evaluate this object and accumulate it into \c tsr
+
+      /// The tiles of this expression are evaluated where the corresponding
+      /// array tiles are stored (see \c BlockPmap ), and are added to, or
+      /// subtracted from, the array tiles in place, so neither the array tiles
+      /// nor the block tiles are copied or moved. Only the norms of the block
+      /// tiles are updated in the array shape. The tiles outside the block are
+      /// shared with the original array. Since the array tiles are modified in
+      /// place, shallow copies of the array, and tiles that were obtained from
+      /// it, also see the update.
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param tsr The tensor block to be updated
+      /// \param subtract If \c true , this expression is subtracted from
+      /// \c tsr
+      /// \return \c true if this expression was accumulated into \c tsr , or
+      /// \c false if the expression chose a distribution of its own, e.g. for
+      /// a contraction, in which case \c tsr is not modified
+      template <typename A, bool Alias>
+      bool eval_accumulate_to(BlkTsrExpr<A, Alias>& tsr, const bool subtract) const {
+        typedef TiledArray::detail::Shift<typename std::decay<A>::type::value_type,
+            typename EngineTrait<engine_type>::eval_type, false> shift_op_type;
+        typedef TiledArray::detail::UnaryWrapper<shift_op_type> op_type;
+        typedef typename A::value_type value_type;
+        static_assert(! is_lazy_tile<value_type>::value,
+            "Assignment to an array of lazy tiles is not supported.");
+        TA_USER_ASSERT(tsr.array().is_initialized(),
+            "Assignment to an uninitialized array sub-block is not supported.");
+
+        A& array = tsr.array();
+        World& world = array.world();
+        const auto& tiles_range = array.trange().tiles_range();
+
+        // Evaluate the block tiles where the array tiles are stored
+        std::shared_ptr<typename A::pmap_interface> pmap =
+            std::make_shared<TiledArray::detail::BlockPmap>(world, array.pmap(),
+                tiles_range, tsr.lower_bound(), tsr.upper_bound());
+
+        // Construct the expression engine
+        engine_type engine(derived());
+        engine.init(world, pmap, VariableList(tsr.vars()));
+        if(engine.pmap() != pmap)
+          return false;
+
+        // Create the distributed evaluator from this expression
+        typename engine_type::dist_eval_type dist_eval = make_root_dist_eval(engine);
+        dist_eval.eval();
+
+        // The expression may read the array tiles, on this process or on
+        // others, so they are modified only after every process has evaluated
+        // its block tiles.
+        dist_eval.wait();
+        world.gop.fence();
+
+        // The norms of the block tiles are bounded by the sum of the norms of
+        // the array tiles and the expression tiles.
+        A result(world, array.trange(),
+            array.shape().update_block(tsr.lower_bound(), tsr.upper_bound(),
+            array.shape().block(tsr.lower_bound(), tsr.upper_bound()).add(
+            dist_eval.shape())), array.pmap());
+
+        // Share the tiles outside the block with the original array.
+        const BlockRange blk_range(tiles_range, tsr.lower_bound(),
+            tsr.upper_bound());
+        for(const auto index : *array.pmap()) {
+          if(! array.is_zero(index))
+            if(! blk_range.includes(tiles_range.idx(index)))
+              result.set(index, array.find(index));
+        }
+
+        // Accumulate the block tiles into the array tiles. All tiles are
+        // local, so there is no communication in this step.
+        const std::vector<long> shift =
+            array.trange().make_tile_range(tsr.lower_bound()).lobound();
+        std::shared_ptr<op_type> shift_op =
+            std::make_shared<op_type>(shift_op_type(shift));
+        for(const auto index : *pmap) {
+          const auto array_index = blk_range.ordinal(index);
+          if(result.is_zero(array_index))
+            continue;
+          if(dist_eval.is_zero(index)) {
+            if(! array.is_zero(array_index))
+              result.set(array_index, array.find(array_index));
+          } else if(array.is_zero(array_index)) {
+            // The tile is copied, unless it is a temporary, since the array
+            // tile may be accumulated into later.
+            if(subtract || ! EngineTrait<engine_type>::consumable)
+              result.set(array_index, world.taskq.add(
+                  & Expr_::template copy_tile<value_type,
+                      typename EngineTrait<engine_type>::eval_type, op_type>,
+                  dist_eval.get(index), shift_op, subtract));
+            else
+              set_tile(result, array_index, dist_eval.get(index), shift_op);
+          } else {
+            result.set(array_index, world.taskq.add(
+                & Expr_::template accumulate_tile<value_type,
+                    typename EngineTrait<engine_type>::eval_type, op_type>,
+                array.find(array_index), dist_eval.get(index), shift_op,
+                subtract));
+          }
+        }
+
+        // Swap the new array with the result array object.
+        result.swap(array);
+        return true;
+      }
+
       /// Expression print
 
       /// \param os The output stream
@@ -438,10 +1210,209 @@ namespace TiledArray {
         engine.init_vars(target_vars);
         engine.init_struct(target_vars);
         engine.print(os, target_vars);
+        os << "[permuted elements " << engine.perm_elements() << "]\n";
+      }
+
+      /// Predict the result of this expression
+
+      /// Only the tiled ranges, shapes, and process maps are propagated
+      /// through the expression engines; no tiles are allocated and no tile
+      /// tasks are run.
+      /// \param target_vars The target variable list of the result
+      /// \param world The world where the expression would be evaluated
+      /// \return The predicted result shape and the non-zero tiles of the
+      /// result on each process
+      ExprPrediction<typename engine_type::shape_type>
+      predict(const std::string& target_vars,
+          World& world = TiledArray::get_default_world()) const
+      {
+        return predict(VariableList(target_vars), world);
+      }
+
+      /// Predict the result of this expression
+
+      /// The result has the natural variable order of this expression.
+      /// \param world The world where the expression would be evaluated
+      /// \return The predicted result shape and the non-zero tiles of the
+      /// result on each process
+      ExprPrediction<typename engine_type::shape_type>
+      predict(World& world = TiledArray::get_default_world()) const {
+        return predict(VariableList(), world);
       }
 
     private:
 
+      /// Evaluate an expression that cannot be sliced in batches
+
+      /// \return \c false
+      template <typename A, bool Alias>
+      bool eval_batched_to(TsrExpr<A, Alias>&, std::false_type) const {
+        return false;
+      }
+
+      /// Evaluate this expression in batches and assign it to \c tsr
+
+      /// The result and intermediate tiles of this expression are predicted
+      /// from the shapes, and, when they exceed the memory limit on some
+      /// process, the tiles of the batched result variable are split into
+      /// ranges with about the same number of elements. The slice of this
+      /// expression for each range is evaluated into a temporary array, its
+      /// tiles are moved, as shifted views, to the process that owns them in
+      /// the result, and the evaluation is completed before the next batch,
+      /// so the intermediate tiles of one batch at a time are held.
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param tsr The tensor to be assigned
+      /// \return \c true if the result was assigned, or \c false if the
+      /// expression fits in memory or cannot be batched
+      template <typename A, bool Alias>
+      bool eval_batched_to(TsrExpr<A, Alias>& tsr, std::true_type) const {
+        typedef typename A::value_type value_type;
+        typedef typename A::shape_type shape_type;
+        typedef TiledArray::detail::Shift<value_type, value_type, false> shift_op_type;
+
+        if(override_ptr_->pmap || override_ptr_->shape || override_ptr_->symmetry
+            || override_ptr_->reuse_storage)
+          return false;
+
+        // Predict the memory of the result and the intermediate tiles
+        engine_type engine(derived());
+        init_engine(engine, tsr);
+        World& world = *engine.world();
+        std::vector<std::size_t> bytes(world.size(), 0ul);
+        detail::add_intermediate_bytes(engine, bytes);
+        const std::size_t max_bytes = *std::max_element(bytes.begin(), bytes.end());
+        const std::size_t max_memory = override_ptr_->batch_max_memory;
+        if(max_bytes <= max_memory)
+          return false;
+
+        // Select the batched variable
+        const VariableList target_vars(tsr.vars());
+        const auto& trange = engine.trange();
+        const auto* MADNESS_RESTRICT const extent = trange.tiles_range().extent_data();
+        unsigned int dim = 0u;
+        if(override_ptr_->batch_var.empty()) {
+          for(unsigned int i = 1u; i < target_vars.dim(); ++i)
+            if(extent[i] > extent[dim])
+              dim = i;
+        } else {
+          while((dim < target_vars.dim()) && (target_vars[dim] != override_ptr_->batch_var))
+            ++dim;
+          TA_USER_ASSERT(dim < target_vars.dim(), "Expr::eval_to(): the batched "
+              "variable is not a variable of the result.");
+        }
+        if(extent[dim] < 2ul)
+          return false;
+
+        // Split the tiles of the batched dimension into ranges with about the
+        // same number of elements
+        const std::size_t batches = std::min<std::size_t>(extent[dim],
+            (max_bytes + max_memory - 1ul) / max_memory);
+        const TiledRange1& trange1 = trange.data()[dim];
+        const std::size_t first_tile = trange1.tiles_range().first;
+        const std::size_t elements = trange1.elements_range().second -
+            trange1.elements_range().first;
+        std::vector<std::size_t> bounds(1, 0ul);
+        for(std::size_t t = 0ul, count = 0ul; t < extent[dim]; ++t) {
+          const auto tile = trange1.tile(first_tile + t);
+          count += tile.second - tile.first;
+          if(count * batches >= bounds.size() * elements)
+            bounds.push_back(t + 1ul);
+        }
+        if(bounds.back() != extent[dim])
+          bounds.push_back(extent[dim]);
+
+        // Evaluate the batches, and keep their tiles that are owned by this
+        // process in the result
+        shape_type shape = engine.shape();
+        std::vector<std::pair<std::size_t, Future<value_type> > > tiles;
+        const auto& tiles_range = trange.tiles_range();
+        for(std::size_t b = 1ul; b < bounds.size(); ++b) {
+          std::vector<std::size_t> lower(tiles_range.lobound_data(),
+              tiles_range.lobound_data() + tiles_range.rank());
+          std::vector<std::size_t> upper(tiles_range.upbound_data(),
+              tiles_range.upbound_data() + tiles_range.rank());
+          lower[dim] += bounds[b - 1ul];
+          upper[dim] = lower[dim] + (bounds[b] - bounds[b - 1ul]);
+
+          A batch;
+          TsrExpr<A, Alias> batch_tsr(batch, tsr.vars());
+          auto batch_expr = slice_expr(derived(), target_vars[dim],
+              bounds[b - 1ul], bounds[b]);
+          batch_expr.set_world(world)
+              .set_summa_layers(override_ptr_->summa_layers)
+              .set_summa_max_memory(override_ptr_->summa.max_memory)
+              .set_summa_max_depth(override_ptr_->summa.max_depth)
+              .set_summa_work_order(override_ptr_->summa.work_order)
+              .set_summa_batch(override_ptr_->summa.batch)
+              .set_summa_prefetch(override_ptr_->summa.prefetch)
+              .set_summa_node_bcast(override_ptr_->summa.node_bcast)
+              .set_contraction_mode(override_ptr_->contraction_mode)
+              .set_truncate(override_ptr_->truncate);
+          if(override_ptr_->shape_threshold >= 0.0f)
+            batch_expr.set_shape_threshold(override_ptr_->shape_threshold);
+          batch_expr.eval_to(batch_tsr);
+          shape = shape.update_block(lower, upper, batch.shape());
+
+          const shift_op_type shift_op(trange.make_tile_range(lower).lobound());
+          for(const auto index : *engine.pmap()) {
+            auto batch_index = tiles_range.idx(index);
+            if((batch_index[dim] < lower[dim]) || (batch_index[dim] >= upper[dim]))
+              continue;
+            for(unsigned int i = 0u; i < batch_index.size(); ++i)
+              batch_index[i] -= tiles_range.lobound_data()[i];
+            batch_index[dim] -= bounds[b - 1ul];
+            if(batch.is_zero(batch_index))
+              continue;
+            tiles.emplace_back(index, world.taskq.add(
+                [shift_op] (const value_type& tile) { return shift_op(tile); },
+                batch.find(batch_index)));
+          }
+
+          // Free the intermediate tiles of the batch
+          world.gop.fence();
+        }
+
+        A result(world, trange, shape, engine.pmap());
+        for(const auto& index_tile : tiles)
+          if(! result.is_zero(index_tile.first))
+            result.set(index_tile.first, index_tile.second);
+        result.swap(tsr.array());
+
+        return true;
+      }
+
+      ExprPrediction<typename engine_type::shape_type>
+      predict(const VariableList& target_vars, World& world) const {
+        typedef typename TiledArray::detail::numeric_type<
+            typename engine_type::value_type>::type numeric_type;
+
+        // Construct and initialize the expression engine
+        engine_type engine(derived());
+        engine.init(world, std::shared_ptr<typename engine_type::pmap_interface>(),
+            target_vars);
+
+        ExprPrediction<typename engine_type::shape_type> prediction;
+        prediction.trange = engine.trange();
+        prediction.shape = engine.shape();
+        prediction.tile_count.resize(engine.world()->size(), 0ul);
+        prediction.tile_bytes.resize(engine.world()->size(), 0ul);
+
+        // Accumulate the non-zero tiles of the result by owner
+        const auto& pmap = *engine.pmap();
+        const std::size_t n = prediction.trange.tiles_range().volume();
+        for(std::size_t index = 0ul; index < n; ++index) {
+          if(! prediction.shape.is_zero(index)) {
+            const auto owner = pmap.owner(index);
+            ++prediction.tile_count[owner];
+            prediction.tile_bytes[owner] += sizeof(numeric_type) *
+                prediction.trange.make_tile_range(index).volume();
+          }
+        }
+
+        return prediction;
+      }
+
       struct ExpressionReduceTag { };
 
       template <typename D, typename Enabler = void>
@@ -460,13 +1431,270 @@ namespace TiledArray {
         return default_world_helper<Derived>(this->derived()).get();
       }
 
-    public:
+      /// Check that the reduction of an engine can be fused
 
+      /// \return \c true if the tiles of \c engine are not permuted and
+      /// the arguments can be fused
       template <typename Op>
+      static bool can_fuse_reduce(const engine_type& engine, const Op&, std::true_type) {
+        return FusedEngine<engine_type>::is_fusable(engine);
+      }
+
+      template <typename Op>
+      static bool can_fuse_reduce(const engine_type&, const Op&, std::false_type) {
+        return false;
+      }
+
+      template <typename R, typename Op>
+      static bool can_fuse_reduce(const engine_type& left, const R& right,
+          const Op&, std::true_type)
+      {
+        return (left.trange() == right.trange()) &&
+            FusedEngine<engine_type>::is_fusable(left) &&
+            FusedEngine<R>::is_fusable(right);
+      }
+
+      template <typename R, typename Op>
+      static bool can_fuse_reduce(const engine_type&, const R&, const Op&,
+          std::false_type)
+      {
+        return false;
+      }
+
+      /// Check that a reduction pairs the tiles of an array with permuted strides
+
+      /// Dot and inner products of numeric tensor tiles, where the
+      /// right-hand expression is an array, may be reduced with the tiles
+      /// of the array in their own layout (see \c permuted_reduce() ).
+      template <typename D, typename Op>
+      struct is_permuted_reduce : public std::false_type { };
+
+      template <typename A, bool Alias, typename L, typename R>
+      struct is_permuted_reduce<TsrExpr<A, Alias>, DotReduction<L, R> > :
+          public std::integral_constant<bool,
+              TiledArray::detail::is_contiguous_tensor<L>::value &&
+              TiledArray::detail::is_contiguous_tensor<R>::value &&
+              TiledArray::detail::is_numeric<typename L::value_type>::value &&
+              TiledArray::detail::is_numeric<typename R::value_type>::value &&
+              std::is_same<typename std::remove_const<A>::type::value_type, R>::value>
+      { };
+
+      template <typename A, bool Alias, typename L, typename R>
+      struct is_permuted_reduce<TsrExpr<A, Alias>, InnerProductReduction<L, R> > :
+          public is_permuted_reduce<TsrExpr<A, Alias>, DotReduction<L, R> >
+      { };
+
+      /// Check that the right-hand array of a reduction is permuted
+
+      /// \param left The initialized left-hand engine
+      /// \param right The right-hand array expression
+      /// \param world The world where the reduction is evaluated
+      /// \return \c true if the variables of \c right are a permutation of
+      /// the variables of \c left , and the array of \c right is in
+      /// \c world
+      template <typename D>
+      static bool can_permute_reduce(const engine_type& left, const D& right,
+          World& world, std::true_type)
+      {
+        const VariableList right_vars(right.vars());
+        return (& right.array().world() == & world) &&
+            (right_vars != left.vars()) && right_vars.is_permutation(left.vars()) &&
+            (right.array().trange() ==
+                (right_vars.permutation(left.vars()) * left.trange()));
+      }
+
+      template <typename D>
+      static bool can_permute_reduce(const engine_type&, const D&, World&,
+          std::false_type)
+      {
+        return false;
+      }
+
+      /// Reduce the element pairs of an expression and a permuted array
+
+      /// The right-hand array tiles are not permuted into the layout of the
+      /// left-hand expression. Instead, each local left-hand tile is reduced
+      /// with the matching array tile, which is read from its owner, by
+      /// walking the array tile with permuted strides (see
+      /// \c detail::permute_reduce() ), so no permuted copies are made.
+      /// \tparam D The right-hand array expression type
+      /// \tparam Op The tile reduction operation type
+      /// \tparam Finish The type of the operation that reduces the local
+      /// result on all processes
+      /// \param left The initialized left-hand engine
+      /// \param right The right-hand array expression
+      /// \param op The tile reduction operation
+      /// \param world The world where the reduction is evaluated
+      /// \param finish The operation that reduces the local result
+      /// \return A future to the result of the reduction on all processes
+      template <typename D, typename Op, typename Finish>
       Future<typename Op::result_type>
-      reduce(const Op& op, World& world) const {
+      permuted_reduce(engine_type& left, const D& right, const Op& op,
+          World& world, const Finish& finish, std::true_type) const
+      {
+        typedef typename std::remove_const<typename D::array_type>::type array_type;
+        typedef TiledArray::math::BinaryReduceWrapper<typename engine_type::value_type,
+            typename array_type::value_type, PermutedReduction<Op> > reduction_op_type;
+
+        const array_type& array = right.array();
+        const Permutation perm = VariableList(right.vars()).permutation(left.vars());
+
+        typename engine_type::dist_eval_type dist_eval = make_root_dist_eval(left);
+        dist_eval.eval();
+
+        reduction_op_type wrapped_op(PermutedReduction<Op>(op, perm));
+        TiledArray::detail::ReducePairTask<reduction_op_type>
+            local_reduce_task(world, wrapped_op);
+
+        const auto& left_range = dist_eval.trange().tiles_range();
+        const auto& right_range = array.trange().tiles_range();
+        for(const auto index : *dist_eval.pmap()) {
+          if(dist_eval.is_zero(index))
+            continue;
+          const auto right_index = right_range.ordinal(perm * left_range.idx(index));
+          if(array.is_zero(right_index)) {
+            dist_eval.get(index);
+            continue;
+          }
+          local_reduce_task.add(dist_eval.get(index), array.find(right_index));
+        }
+
+        auto result = finish(dist_eval.id(), local_reduce_task.submit());
+        dist_eval.wait();
+        return result;
+      }
+
+      template <typename D, typename Op, typename Finish>
+      Future<typename Op::result_type>
+      permuted_reduce(engine_type&, const D&, const Op&, World&, const Finish&,
+          std::false_type) const
+      {
+        TA_ASSERT(false); // The right-hand array is not permuted
+        return Future<typename Op::result_type>();
+      }
+
+      /// Reduce the elements of a fused tree
+
+      /// Each result tile is reduced by the task that reads its argument
+      /// tiles, so the result tiles are not constructed.
+      /// \tparam Op The tile reduction operation type
+      /// \tparam Finish The type of the operation that reduces the local
+      /// result on all processes
+      /// \param engine The initialized root engine of a fused tree
+      /// \param op The tile reduction operation
+      /// \param finish The operation that reduces the local result
+      /// \return A future to the result of the reduction on all processes
+      template <typename Op, typename Finish>
+      static Future<typename Op::result_type>
+      fused_reduce(const engine_type& engine, const Op& op,
+          const Finish& finish, std::true_type)
+      {
+        return fused_reduce_impl(make_fused_reduce(engine, op), finish);
+      }
+
+      template <typename Op, typename Finish>
+      static Future<typename Op::result_type>
+      fused_reduce(const engine_type&, const Op&, const Finish&, std::false_type) {
+        TA_ASSERT(false); // The reduction can not be fused
+        return Future<typename Op::result_type>();
+      }
+
+      /// Reduce the element pairs of two fused trees
+
+      /// \tparam R The right-hand engine type
+      /// \tparam Op The tile reduction operation type
+      /// \param left The initialized left-hand engine
+      /// \param right The initialized right-hand engine
+      /// \param op The tile reduction operation
+      /// \param finish The operation that reduces the local result
+      /// \return A future to the result of the reduction on all processes
+      template <typename R, typename Op, typename Finish>
+      static Future<typename Op::result_type>
+      fused_reduce(const engine_type& left, const R& right, const Op& op,
+          const Finish& finish, std::true_type)
+      {
+        return fused_reduce_impl(make_fused_reduce(left, right, op), finish);
+      }
+
+      template <typename R, typename Op, typename Finish>
+      static Future<typename Op::result_type>
+      fused_reduce(const engine_type&, const R&, const Op&, const Finish&,
+          std::false_type)
+      {
+        TA_ASSERT(false); // The reduction can not be fused
+        return Future<typename Op::result_type>();
+      }
+
+      template <typename Impl, typename Finish>
+      static auto fused_reduce_impl(const std::shared_ptr<Impl>& pimpl,
+          const Finish& finish)
+      {
+        return finish(pimpl->id(), pimpl->eval());
+      }
+
+      /// Reduce a local result on all processes with an all-reduce
+
+      /// Tensor results are reduced with \c TensorAllReduce , which uses a
+      /// reduce-scatter/allgather pipeline for large tensors.
+      template <typename Op>
+      class AllReduce {
+        typedef typename Op::result_type result_type;
+
+        World& world_;
+        const Op& op_;
+
+        Future<result_type>
+        all_reduce(const madness::uniqueidT& id,
+            const Future<result_type>& local, std::false_type) const
+        {
+          typedef madness::TaggedKey<madness::uniqueidT, ExpressionReduceTag> key_type;
+          return world_.gop.all_reduce(key_type(id), local, op_);
+        }
+
+        Future<result_type>
+        all_reduce(const madness::uniqueidT& id,
+            const Future<result_type>& local, std::true_type) const
+        {
+          return TiledArray::detail::TensorAllReduce<result_type,
+              Op>::all_reduce(world_, id, local, op_);
+        }
+
+      public:
+        AllReduce(World& world, const Op& op) : world_(world), op_(op) { }
+
+        Future<result_type>
+        operator()(const madness::uniqueidT& id,
+            const Future<result_type>& local) const
+        {
+          return all_reduce(id, local, std::integral_constant<bool,
+              TiledArray::detail::is_tensor<result_type>::value &&
+              TiledArray::detail::is_contiguous_tensor<result_type>::value>());
+        }
+      }; // class AllReduce
+
+      /// Defer the reduction of a local result to a \c ReductionBatch
+      template <typename Op>
+      class BatchReduce {
+        ReductionBatch<typename Op::result_type>& batch_;
+        const Op& op_;
+
+      public:
+        BatchReduce(ReductionBatch<typename Op::result_type>& batch, const Op& op) :
+          batch_(batch), op_(op)
+        { }
+
+        Future<typename Op::result_type>
+        operator()(const madness::uniqueidT&,
+            const Future<typename Op::result_type>& local) const
+        {
+          return batch_.reduce(local, op_);
+        }
+      }; // class BatchReduce
+
+      template <typename Op, typename Finish>
+      Future<typename Op::result_type>
+      reduce_impl(const Op& op, World& world, const Finish& finish) const {
         // Typedefs
-        typedef madness::TaggedKey<madness::uniqueidT, ExpressionReduceTag> key_type;
         typedef TiledArray::math::UnaryReduceWrapper<typename engine_type::value_type,
             Op> reduction_op_type;
 
@@ -475,8 +1703,14 @@ namespace TiledArray {
         engine.init(world, std::shared_ptr<typename engine_type::pmap_interface>(),
             VariableList());
 
+        // Reduce the elements of element-wise expressions without
+        // constructing the result tiles
+        typedef is_fused_reduce<engine_type, Op> fused_type;
+        if(can_fuse_reduce(engine, op, fused_type()))
+          return fused_reduce(engine, op, finish, fused_type());
+
         // Create the distributed evaluator from this expression
-        typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
+        typename engine_type::dist_eval_type dist_eval = make_root_dist_eval(engine);
         dist_eval.eval();
 
         // Create a local reduction task
@@ -493,28 +1727,21 @@ namespace TiledArray {
             reduce_task.add(dist_eval.get(*it));
 
         // All reduce the result of the expression
-        auto result = world.gop.all_reduce(key_type(dist_eval.id()), reduce_task.submit(), op);
+        auto result = finish(dist_eval.id(), reduce_task.submit());
         dist_eval.wait();
         return result;
       }
 
-      template <typename Op>
+      template <typename D, typename Op, typename Finish>
       Future<typename Op::result_type>
-      reduce(const Op& op) const {
-        return reduce(op, default_world());
-      }
-
-      template <typename D, typename Op>
-      Future<typename Op::result_type>
-      reduce(const Expr<D>& right_expr, const Op& op,
-             World& world) const
+      reduce_impl(const Expr<D>& right_expr, const Op& op, World& world,
+          const Finish& finish) const
       {
         static_assert(is_aliased<D>::value,
             "no_alias() expressions are not allowed on the right-hand side of "
             "the assignment operator.");
 
         // Typedefs
-        typedef madness::TaggedKey<madness::uniqueidT, ExpressionReduceTag> key_type;
         typedef TiledArray::math::BinaryReduceWrapper<typename engine_type::value_type,
             typename D::engine_type::value_type, Op> reduction_op_type;
 
@@ -523,18 +1750,32 @@ namespace TiledArray {
         left_engine.init(world, std::shared_ptr<typename engine_type::pmap_interface>(),
             VariableList());
 
-        // Create the distributed evaluator for this expression
-        typename engine_type::dist_eval_type left_dist_eval =
-            left_engine.make_dist_eval();
-        left_dist_eval.eval();
+        // Reduce with the tiles of a permuted array in their own layout
+        typedef is_permuted_reduce<D, Op> permuted_type;
+        if(can_permute_reduce(left_engine, right_expr.derived(), world, permuted_type()))
+          return permuted_reduce(left_engine, right_expr.derived(), op, world,
+              finish, permuted_type());
 
         // Evaluate the right-hand expression
         typename D::engine_type right_engine(right_expr.derived());
         right_engine.init(world, left_engine.pmap(), left_engine.vars());
 
+        // Reduce the element pairs of element-wise expressions without
+        // constructing the result tiles
+        typedef is_fused_binary_reduce<engine_type, typename D::engine_type, Op>
+            fused_type;
+        if(can_fuse_reduce(left_engine, right_engine, op, fused_type()))
+          return fused_reduce(left_engine, right_engine, op, finish,
+              fused_type());
+
+        // Create the distributed evaluator for this expression
+        typename engine_type::dist_eval_type left_dist_eval =
+            make_root_dist_eval(left_engine);
+        left_dist_eval.eval();
+
         // Create the distributed evaluator for the right-hand expression
         typename D::engine_type::dist_eval_type right_dist_eval =
-            right_engine.make_dist_eval();
+            make_root_dist_eval(right_engine);
         right_dist_eval.eval();
 
 #ifndef NDEBUG
@@ -573,19 +1814,74 @@ namespace TiledArray {
           }
         }
 
-        auto result = world.gop.all_reduce(key_type(left_dist_eval.id()),
-            local_reduce_task.submit(), op);
+        auto result = finish(left_dist_eval.id(), local_reduce_task.submit());
         left_dist_eval.wait();
         right_dist_eval.wait();
         return result;
       }
 
+    public:
+
+      template <typename Op>
+      Future<typename Op::result_type>
+      reduce(const Op& op, World& world) const {
+        return reduce_impl(op, world, AllReduce<Op>(world, op));
+      }
+
+      template <typename Op>
+      Future<typename Op::result_type>
+      reduce(const Op& op) const {
+        return reduce(op, default_world());
+      }
+
+      /// Reduce the elements with a deferred all-reduce
+
+      /// The local result is added to \c batch , which combines it with the
+      /// other reductions of the batch in one all-reduce when it is flushed.
+      /// \tparam Op The tile reduction operation type
+      /// \param op The tile reduction operation
+      /// \param batch The reduction batch
+      /// \return A future to the result of the reduction, which is set after
+      /// \c batch is flushed
+      template <typename Op>
+      Future<typename Op::result_type>
+      reduce(const Op& op, ReductionBatch<typename Op::result_type>& batch) const {
+        return reduce_impl(op, batch.world(), BatchReduce<Op>(batch, op));
+      }
+
+      template <typename D, typename Op>
+      Future<typename Op::result_type>
+      reduce(const Expr<D>& right_expr, const Op& op,
+             World& world) const
+      {
+        return reduce_impl(right_expr, op, world, AllReduce<Op>(world, op));
+      }
+
       template <typename D, typename Op>
       Future<typename Op::result_type>
       reduce(const Expr<D>& right_expr, const Op& op) const {
         return reduce(right_expr, op, default_world());
       }
 
+      /// Reduce the element pairs with a deferred all-reduce
+
+      /// \tparam D The right-hand expression type
+      /// \tparam Op The tile reduction operation type
+      /// \param right_expr The right-hand expression
+      /// \param op The tile reduction operation
+      /// \param batch The reduction batch
+      /// \return A future to the result of the reduction, which is set after
+      /// \c batch is flushed
+      /// \sa reduce(const Op&, ReductionBatch<typename Op::result_type>&)
+      template <typename D, typename Op>
+      Future<typename Op::result_type>
+      reduce(const Expr<D>& right_expr, const Op& op,
+          ReductionBatch<typename Op::result_type>& batch) const
+      {
+        return reduce_impl(right_expr, op, batch.world(),
+            BatchReduce<Op>(batch, op));
+      }
+
       Future<typename TiledArray::TraceReduction<
           typename EngineTrait<engine_type>::eval_type>::result_type>
       trace(World& world) const {
@@ -612,6 +1908,12 @@ namespace TiledArray {
         return sum(default_world());
       }
 
+      template <typename T>
+      Future<T> sum(ReductionBatch<T>& batch) const {
+        typedef typename EngineTrait<engine_type>::eval_type value_type;
+        return reduce(TiledArray::SumReduction<value_type>(), batch);
+      }
+
       Future<typename TiledArray::ProductReduction<
           typename EngineTrait<engine_type>::eval_type>::result_type>
       product(World& world) const {
@@ -639,6 +1941,12 @@ namespace TiledArray {
         return squared_norm(default_world());
       }
 
+      template <typename T>
+      Future<T> squared_norm(ReductionBatch<T>& batch) const {
+        typedef typename EngineTrait<engine_type>::eval_type value_type;
+        return reduce(TiledArray::SquaredNormReduction<value_type>(), batch);
+      }
+
     private:
 
       template <typename T>
@@ -755,6 +2063,14 @@ namespace TiledArray {
         return dot(right_expr, default_world());
       }
 
+      template <typename D, typename T>
+      Future<T> dot(const Expr<D>& right_expr, ReductionBatch<T>& batch) const {
+        typedef typename EngineTrait<engine_type>::eval_type left_value_type;
+        typedef typename EngineTrait<typename D::engine_type>::eval_type right_value_type;
+        return reduce(right_expr, TiledArray::DotReduction<left_value_type,
+            right_value_type>(), batch);
+      }
+
       template <typename D>
       Future<typename TiledArray::InnerProductReduction<
           typename EngineTrait<engine_type>::eval_type,
@@ -774,6 +2090,141 @@ namespace TiledArray {
         return inner_product(right_expr, default_world());
       }
 
+      template <typename D, typename T>
+      Future<T> inner_product(const Expr<D>& right_expr,
+          ReductionBatch<T>& batch) const
+      {
+        typedef typename EngineTrait<engine_type>::eval_type left_value_type;
+        typedef typename EngineTrait<typename D::engine_type>::eval_type right_value_type;
+        return reduce(right_expr, TiledArray::InnerProductReduction<
+            left_value_type, right_value_type>(), batch);
+      }
+
+      /// Compensated sum of the elements
+
+      /// The rounding errors of the sum are carried in the correction term of
+      /// the result, within tiles, across tiles, and across processes.
+      /// \param world The world where the expression is evaluated
+      /// \return A future to the \c math::CompensatedSum of the elements
+      Future<typename TiledArray::CompensatedSumReduction<
+          typename EngineTrait<engine_type>::eval_type>::result_type>
+      compensated_sum(World& world) const {
+        typedef typename EngineTrait<engine_type>::eval_type value_type;
+        return reduce(TiledArray::CompensatedSumReduction<value_type>(), world);
+      }
+
+      Future<typename TiledArray::CompensatedSumReduction<
+          typename EngineTrait<engine_type>::eval_type>::result_type>
+      compensated_sum() const {
+        return compensated_sum(default_world());
+      }
+
+      /// Compensated squared vector 2-norm
+
+      /// \param world The world where the expression is evaluated
+      /// \return A future to the \c math::CompensatedSum of the squared
+      /// elements
+      /// \sa compensated_sum
+      Future<typename TiledArray::CompensatedSquaredNormReduction<
+          typename EngineTrait<engine_type>::eval_type>::result_type>
+      compensated_squared_norm(World& world) const {
+        typedef typename EngineTrait<engine_type>::eval_type value_type;
+        return reduce(TiledArray::CompensatedSquaredNormReduction<value_type>(),
+            world);
+      }
+
+      Future<typename TiledArray::CompensatedSquaredNormReduction<
+          typename EngineTrait<engine_type>::eval_type>::result_type>
+      compensated_squared_norm() const {
+        return compensated_squared_norm(default_world());
+      }
+
+      /// Compensated vector dot product
+
+      /// \param right_expr The right-hand expression
+      /// \param world The world where the expression is evaluated
+      /// \return A future to the \c math::CompensatedSum of the element
+      /// products
+      /// \sa compensated_sum
+      template <typename D>
+      Future<typename TiledArray::CompensatedDotReduction<
+          typename EngineTrait<engine_type>::eval_type,
+          typename EngineTrait<typename D::engine_type>::eval_type>::result_type>
+      compensated_dot(const Expr<D>& right_expr, World& world) const {
+        typedef typename EngineTrait<engine_type>::eval_type left_value_type;
+        typedef typename EngineTrait<typename D::engine_type>::eval_type right_value_type;
+        return reduce(right_expr, TiledArray::CompensatedDotReduction<
+            left_value_type, right_value_type>(), world);
+      }
+
+      template <typename D>
+      Future<typename TiledArray::CompensatedDotReduction<
+          typename EngineTrait<engine_type>::eval_type,
+          typename EngineTrait<typename D::engine_type>::eval_type>::result_type>
+      compensated_dot(const Expr<D>& right_expr) const {
+        return compensated_dot(right_expr, default_world());
+      }
+
+      /// Evaluate several reductions in one traversal
+
+      /// The tiles are evaluated once, each tile is reduced by all \c ops ,
+      /// and the results are combined in a single all-reduce. For example:
+      /// \code
+      /// typedef TArrayD::value_type tile_type;
+      /// auto results = r("i,j").multi_reduce(std::make_tuple(
+      ///     TiledArray::SquaredNormReduction<tile_type>(),
+      ///     TiledArray::MaxReduction<tile_type>(),
+      ///     TiledArray::MinReduction<tile_type>()));
+      /// const double norm2 = std::get<0>(results).get();
+      /// \endcode
+      /// \tparam Ops The unary tile reduction types
+      /// \param ops The tile reductions
+      /// \param world The world where the reductions are evaluated
+      /// \return A future to the result of each reduction
+      template <typename... Ops>
+      std::tuple<Future<typename Ops::result_type>...>
+      multi_reduce(const std::tuple<Ops...>& ops, World& world) const {
+        return TiledArray::detail::split_multi_reduction(world,
+            reduce(TiledArray::MultiReduction<Ops...>(ops), world),
+            std::make_index_sequence<sizeof...(Ops)>());
+      }
+
+      template <typename... Ops>
+      std::tuple<Future<typename Ops::result_type>...>
+      multi_reduce(const std::tuple<Ops...>& ops) const {
+        return multi_reduce(ops, default_world());
+      }
+
+      /// Evaluate several reductions of tile pairs in one traversal
+
+      /// Binary reductions, e.g. \c DotReduction , reduce the tile pairs of
+      /// this expression and \c right_expr ; unary reductions reduce the
+      /// tiles of this expression.
+      /// \tparam D The right-hand expression type
+      /// \tparam Ops The tile reduction types
+      /// \param right_expr The right-hand expression
+      /// \param ops The tile reductions
+      /// \param world The world where the reductions are evaluated
+      /// \return A future to the result of each reduction
+      template <typename D, typename... Ops>
+      std::tuple<Future<typename Ops::result_type>...>
+      multi_reduce(const Expr<D>& right_expr, const std::tuple<Ops...>& ops,
+          World& world) const
+      {
+        typedef typename EngineTrait<engine_type>::eval_type left_value_type;
+        typedef typename EngineTrait<typename D::engine_type>::eval_type right_value_type;
+        return TiledArray::detail::split_multi_reduction(world,
+            reduce(right_expr, TiledArray::BinaryMultiReduction<left_value_type,
+                right_value_type, Ops...>(ops), world),
+            std::make_index_sequence<sizeof...(Ops)>());
+      }
+
+      template <typename D, typename... Ops>
+      std::tuple<Future<typename Ops::result_type>...>
+      multi_reduce(const Expr<D>& right_expr, const std::tuple<Ops...>& ops) const {
+        return multi_reduce(right_expr, ops, default_world());
+      }
+
     }; // class Expr
 
   } // namespace expressions
@@ -0,0 +1,269 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EXPR_BATCH_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EXPR_BATCH_H__INCLUDED
+
+#include <TiledArray/expressions/tsr_expr.h>
+#include <TiledArray/expressions/eval_handle.h>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    namespace detail {
+
+      /// Collect the arrays of a tensor expression
+
+      /// \param expr The tensor expression
+      /// \param[out] arrays The arrays read by the expression
+      template <typename A, bool Alias>
+      inline void collect_arrays(const TsrExpr<A, Alias>& expr,
+          std::vector<const void*>& arrays)
+      { arrays.push_back(&expr.array()); }
+
+      /// Collect the arrays of a scaled tensor expression
+
+      /// \param expr The scaled tensor expression
+      /// \param[out] arrays The arrays read by the expression
+      template <typename A, typename Scalar>
+      inline void collect_arrays(const ScalTsrExpr<A, Scalar>& expr,
+          std::vector<const void*>& arrays)
+      { arrays.push_back(&expr.array()); }
+
+      /// Collect the arrays of a block expression
+
+      /// \param expr The block expression
+      /// \param[out] arrays The arrays read by the expression
+      template <typename D>
+      inline void collect_arrays(const BlkTsrExprBase<D>& expr,
+          std::vector<const void*>& arrays)
+      { arrays.push_back(&expr.array()); }
+
+      /// Collect the arrays of a unary expression
+
+      /// \param expr The unary expression
+      /// \param[out] arrays The arrays read by the expression
+      template <typename D>
+      inline void collect_arrays(const UnaryExpr<D>& expr,
+          std::vector<const void*>& arrays)
+      { collect_arrays(expr.arg(), arrays); }
+
+      /// Collect the arrays of a binary expression
+
+      /// \param expr The binary expression
+      /// \param[out] arrays The arrays read by the expression
+      template <typename D>
+      inline void collect_arrays(const BinaryExpr<D>& expr,
+          std::vector<const void*>& arrays)
+      {
+        collect_arrays(expr.left(), arrays);
+        collect_arrays(expr.right(), arrays);
+      }
+
+    } // namespace detail
+
+    /// Batch of expression statements
+
+    /// The statements of a batch, e.g. the terms of the amplitude equations
+    /// of one iteration, are evaluated together. A statement depends on an
+    /// earlier statement of the batch when it reads the array written by
+    /// the earlier statement, or when it writes an array that is read or
+    /// written by the earlier statement. Each statement is assigned a level,
+    /// which is one more than the largest level of the statements that it
+    /// depends on. The statements are issued asynchronously (see
+    /// \c TsrExpr::assign_async() ) in the order of their levels, so the
+    /// tasks of independent statements run concurrently on the task queue,
+    /// and dependent statements wait only for the tiles that they read.
+    ///
+    /// The levels depend only on the statements, so all processes issue the
+    /// statements in the same order, as required for collective contraction
+    /// setup. Contractions with the same process grid and shapes share
+    /// their SUMMA broadcast groups through \c detail::SummaGroupCache .
+    ///
+    /// A statement may read an array that is still being evaluated by an
+    /// earlier statement, e.g. \c t in <tt>t = a * b; r = t * c;</tt> , since
+    /// the tiles of an array are futures in its distributed storage: each
+    /// task of the later statement waits only for the tiles of \c t that it
+    /// uses, so the statements overlap and no fence is needed between them.
+    /// Arrays that are only needed by the batch, like \c t , may be declared
+    /// temporary (see \c add_temporary() ). They are released as soon as the
+    /// last statement that uses them has been issued, so their tiles are held
+    /// only by the evaluators of the statements that read them, and the
+    /// memory of \c t is freed when its last reader is complete instead of
+    /// at the end of the batch.
+    /// \note The arrays of the statements must not be destroyed before the
+    /// batch is evaluated.
+    class ExprBatch {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+
+      /// A statement of the batch
+      struct Statement {
+        std::vector<const void*> reads; ///< Arrays read by the statement
+        const void* write; ///< The array written by the statement
+        std::function<EvalHandle()> eval; ///< Issue the statement
+      }; // struct Statement
+
+      /// A temporary array of the batch
+      struct Temporary {
+        const void* array; ///< The temporary array
+        std::function<void()> release; ///< Release the temporary array
+      }; // struct Temporary
+
+      std::vector<Statement> statements_; ///< The statements of the batch
+      std::vector<Temporary> temporaries_; ///< The temporary arrays of the batch
+
+      /// Check that a statement uses an array
+
+      /// \param statement The statement
+      /// \param array The array
+      /// \return \c true if \c statement reads or writes \c array
+      static bool uses(const Statement& statement, const void* array) {
+        return (statement.write == array) ||
+            (std::find(statement.reads.begin(), statement.reads.end(), array)
+             != statement.reads.end());
+      }
+
+      /// Check that a statement depends on an earlier statement
+
+      /// \param first The earlier statement
+      /// \param second The later statement
+      /// \return \c true if \c second must be issued after \c first
+      static bool depends(const Statement& first, const Statement& second) {
+        auto reads = [] (const Statement& s, const void* array) {
+          return std::find(s.reads.begin(), s.reads.end(), array) != s.reads.end();
+        };
+        return (first.write == second.write) || reads(second, first.write) ||
+            reads(first, second.write);
+      }
+
+    public:
+
+      ExprBatch() = default;
+      ExprBatch(const ExprBatch&) = delete;
+      ExprBatch(ExprBatch&&) = default;
+      ExprBatch& operator=(const ExprBatch&) = delete;
+      ExprBatch& operator=(ExprBatch&&) = default;
+
+      /// Add a statement to this batch
+
+      /// \tparam A The result array type
+      /// \tparam Alias Tile alias flag of the result
+      /// \tparam E The expression type
+      /// \param result The result of the statement
+      /// \param expr The expression that will be assigned to \c result
+      template <typename A, bool Alias, typename E>
+      void add(const TsrExpr<A, Alias>& result, const Expr<E>& expr) {
+        static_assert(TiledArray::expressions::is_aliased<E>::value,
+            "no_alias() expressions are not allowed on the right-hand side of "
+            "the assignment operator.");
+        Statement statement;
+        detail::collect_arrays(expr.derived(), statement.reads);
+        statement.write = & result.array();
+        TsrExpr<A, Alias> res(result);
+        E e(expr.derived());
+        statement.eval = [res, e] () mutable { return res.assign_async(e); };
+        statements_.push_back(std::move(statement));
+      }
+
+      /// Declare a temporary array
+
+      /// \c array is released, i.e. replaced by an empty array, right after
+      /// the last statement of the batch that reads or writes it has been
+      /// issued. The statements that read \c array keep its tiles alive until
+      /// they are complete, and the data of \c array is freed after the
+      /// readers on all processes are complete.
+      /// \tparam A The array type
+      /// \param array The temporary array, which must not be used after the
+      /// batch is evaluated
+      template <typename A>
+      void add_temporary(A& array) {
+        temporaries_.push_back(Temporary{ & array, [&array] () { array = A(); } });
+      }
+
+      /// The number of statements
+
+      /// \return The number of statements in this batch
+      size_type size() const { return statements_.size(); }
+
+      /// The dependency levels of the statements
+
+      /// \return The level of each statement, in the order they were added
+      std::vector<size_type> levels() const {
+        const size_type n = statements_.size();
+        std::vector<size_type> result(n, 0ul);
+        for(size_type j = 0ul; j < n; ++j)
+          for(size_type i = 0ul; i < j; ++i)
+            if(depends(statements_[i], statements_[j]))
+              result[j] = std::max(result[j], result[i] + 1ul);
+        return result;
+      }
+
+      /// Issue the statements without waiting for them
+
+      /// \return The completion handles of the statements, in the order they
+      /// were added
+      std::vector<EvalHandle> eval_async() {
+        const std::vector<size_type> level = levels();
+        std::vector<size_type> order(statements_.size());
+        std::iota(order.begin(), order.end(), 0ul);
+        std::stable_sort(order.begin(), order.end(),
+            [&level] (const size_type l, const size_type r)
+            { return level[l] < level[r]; });
+
+        // The position of the last statement that uses each temporary
+        std::vector<size_type> last_use(temporaries_.size(), 0ul);
+        for(size_type t = 0ul; t < temporaries_.size(); ++t)
+          for(size_type p = 0ul; p < order.size(); ++p)
+            if(uses(statements_[order[p]], temporaries_[t].array))
+              last_use[t] = p;
+
+        std::vector<EvalHandle> handles(statements_.size());
+        for(size_type p = 0ul; p < order.size(); ++p) {
+          handles[order[p]] = statements_[order[p]].eval();
+          for(size_type t = 0ul; t < temporaries_.size(); ++t)
+            if(last_use[t] == p)
+              temporaries_[t].release();
+        }
+        if(order.empty())
+          for(const Temporary& temporary : temporaries_)
+            temporary.release();
+        return handles;
+      }
+
+      /// Evaluate the statements
+
+      /// Wait for the local tiles of all statements.
+      void eval() {
+        for(EvalHandle& handle : eval_async())
+          handle.wait();
+      }
+
+    }; // class ExprBatch
+
+  } // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_EXPR_BATCH_H__INCLUDED
@@ -28,6 +28,9 @@
 
 #include <TiledArray/madness.h>
 #include <TiledArray/expressions/expr_trace.h>
+#include <TiledArray/expressions/common_subexpr.h>
+#include <TiledArray/symm/tile_symmetry.h>
+#include <vector>
 
 namespace TiledArray {
   namespace expressions {
@@ -68,6 +71,8 @@ namespace TiledArray {
       shape_type shape_; ///< The shape of the result tensor
       std::shared_ptr<pmap_interface> pmap_; ///< The process map for the result tensor
       std::shared_ptr<EngineParamOverride<Derived> > override_ptr_; ///< The engine params overriding the default
+      std::shared_ptr<const symmetry::TileSymmetry> symmetry_; ///< The permutational symmetry of the result of a statement (may be null)
+      bool symmetry_implied_; ///< The symmetry was found by the engine, not requested
 
     public:
 
@@ -77,7 +82,8 @@ namespace TiledArray {
       template <typename D>
       ExprEngine(const Expr<D> &expr) :
         world_(NULL), vars_(), permute_tiles_(true), perm_(), trange_(), shape_(),
-        pmap_(), override_ptr_(expr.override_ptr_)
+        pmap_(), override_ptr_(expr.override_ptr_), symmetry_(),
+        symmetry_implied_(false)
       { }
 
       /// Construct and initialize the expression engine
@@ -139,6 +145,25 @@ namespace TiledArray {
 
         if(override_ptr_ && override_ptr_->shape)
           shape_ = shape_.mask(*override_ptr_->shape);
+        if(override_ptr_ && (override_ptr_->shape_threshold >= 0.0f))
+          shape_ = shape_.with_threshold(override_ptr_->shape_threshold);
+      }
+
+      /// Update result tensor shape
+
+      /// This function will recompute the shape of the result tensor of an
+      /// initialized engine, after the shapes of its arguments have been
+      /// updated. The permutation, tiled range, and distribution are not
+      /// changed. Derived classes that customize the shape initialization in
+      /// \c init_struct() must also provide their own implementation of this
+      /// function.
+      void update_shape() {
+        shape_ = (perm_ ? derived().make_shape(perm_) : derived().make_shape());
+
+        if(override_ptr_ && override_ptr_->shape)
+          shape_ = shape_.mask(*override_ptr_->shape);
+        if(override_ptr_ && (override_ptr_->shape_threshold >= 0.0f))
+          shape_ = shape_.with_threshold(override_ptr_->shape_threshold);
       }
 
       /// Initialize result tensor distribution
@@ -218,11 +243,119 @@ namespace TiledArray {
       /// \return A const reference to the process map
       const std::shared_ptr<pmap_interface>& pmap() const { return pmap_; }
 
+      /// Result symmetry accessor
+
+      /// \return The permutational symmetry of the result, or a null pointer
+      const std::shared_ptr<const symmetry::TileSymmetry>& symmetry() const {
+        return symmetry_;
+      }
+
+      /// Initialize the permutational symmetry of the result
+
+      /// This function is called for the root engine of a statement, after
+      /// \c init() , when the result is invariant under the mode permutations
+      /// of \c group . Engines that support it only evaluate the
+      /// representative result tiles (see \c symmetry::TileSymmetry ). The
+      /// result shape is made symmetric, see \c symmetrize_shape() .
+      /// \param group The group of permutations of the result modes
+      /// \param implied \c true when the symmetry was found by
+      /// \c implied_symmetry() ; the result array then stores every tile
+      /// [ default = false ]
+      void init_symmetry(const symmetry::PermutationGroup& group,
+          const bool implied = false)
+      {
+        symmetry_ = std::make_shared<const symmetry::TileSymmetry>(group, trange_);
+        symmetry_implied_ = implied;
+        symmetrize_shape();
+      }
+
+      /// Check that the result symmetry was found by the engine
+
+      /// \return \c true if the symmetry of the result was not requested but
+      /// found by \c implied_symmetry()
+      bool is_symmetry_implied() const { return symmetry_implied_; }
+
+      /// Permutational symmetry implied by the expression
+
+      /// Engines that recognize a symmetric result without a requested
+      /// symmetry, e.g. the contraction of an array with itself, return its
+      /// group; this engine returns a null pointer.
+      /// \return The group of permutations of the result modes that leave
+      /// the result invariant, or a null pointer
+      std::shared_ptr<const symmetry::PermutationGroup> implied_symmetry() const {
+        return std::shared_ptr<const symmetry::PermutationGroup>();
+      }
+
+      /// Make the result shape symmetric
+
+      /// A tile is zero when any tile of its orbit is zero in the computed
+      /// shape, so that a tile and its representative are both zero or both
+      /// non-zero. This function must be called after the shape is updated.
+      void symmetrize_shape() {
+        if(! symmetry_)
+          return;
+
+        const shape_type shape = shape_;
+        for(const auto& g : symmetry_->group()) {
+          const Permutation perm = symmetry_->mode_permutation(g);
+          if(perm != perm.identity())
+            shape_ = shape_.mask(shape.perm(perm));
+        }
+      }
+
+      /// Result tiles that depend on modified argument tiles
+
+      /// After \c update() , the result tiles that may differ from those of
+      /// the previous evaluation are those that depend on an argument tile
+      /// that was modified since then (see \c DistArray::tile_version() ).
+      /// Derived classes that track the dependencies of their tiles provide
+      /// their own implementation; this engine reports every tile.
+      /// \return A flag for each result tile, in the order of the tiled
+      /// range of the result
+      std::vector<bool> dirty_tiles() const {
+        return std::vector<bool>(trange_.tiles_range().volume(), true);
+      }
+
+      /// Map the dirty tiles of the unpermuted result to the result
+
+      /// \param dirty A flag for each tile of the result before it is
+      /// permuted
+      /// \return A flag for each result tile
+      std::vector<bool> permute_dirty_tiles(const std::vector<bool>& dirty) const {
+        if(! perm_)
+          return dirty;
+
+        const Range& range = trange_.tiles_range();
+        const Range source_range = perm_.inv() * range;
+        std::vector<bool> result(dirty.size(), false);
+        for(size_type i = 0ul; i < dirty.size(); ++i)
+          if(dirty[i])
+            result[range.ordinal(perm_ * source_range.idx(i))] = true;
+        return result;
+      }
+
+      /// Restrict the result to a set of tiles
+
+      /// The tiles that are zero in \c mask are zero in the result shape,
+      /// so they are not evaluated. The shape is recomputed by the next
+      /// \c update() .
+      /// \param mask The shape of the tiles that are evaluated
+      void mask_shape(const shape_type& mask) { shape_ = shape_.mask(mask); }
+
       /// Set the permute tiles flag
 
       /// \param status The new status for permute tiles (true == permtue result tiles)
       void permute_tiles(const bool status) { permute_tiles_ = status; }
 
+      /// Number of permuted elements
+
+      /// Derived classes add the elements permuted by their arguments.
+      /// \return The estimated number of elements that are permuted by this
+      /// expression
+      size_type perm_elements() const {
+        return ((perm_ && permute_tiles_) ? derived().data_elements() : 0ul);
+      }
+
       /// Expression print
 
       /// \param os The output stream
@@ -230,17 +363,50 @@ namespace TiledArray {
       void print(ExprOStream& os, const VariableList& target_vars) const {
         if(perm_) {
           os << "[P " << target_vars << "]" << (permute_tiles_ ? " " : " [no permute tiles] ")
-              << derived().make_tag() << vars_ << "\n";
+              << derived().make_tag() << vars_ << " (" << derived().data_elements()
+              << " elements)\n";
         } else {
           os << derived().make_tag() << vars_ << "\n";
         }
       }
 
+      /// Diagonal expression query
+
+      /// \return \c true if only the diagonal elements of the result are
+      /// known to be non-zero; see \c DistArray::is_diagonal()
+      bool is_diagonal() const { return false; }
+
+      /// Replicated expression query
+
+      /// \param world The world where the expression is evaluated
+      /// \return \c true if every tile of the result is stored on every
+      /// process of \c world before the expression is evaluated
+      bool is_replicated(const World& world) const { return false; }
+
       /// Expression identification tag
 
       /// \return An expression tag used to identify this expression
       const char* make_tag() const { return ""; }
 
+      /// Common subexpression key
+
+      /// Derived classes append the keys of their arguments.
+      /// \return A string that identifies the operation, variables,
+      /// permutation, and process map of this expression
+      std::string cse_key() const {
+        std::stringstream ss;
+        ss << derived().make_tag() << vars_ << " [P " << perm_
+           << (permute_tiles_ ? "" : " no permute tiles") << "] ["
+           << detail::pmap_key(pmap_) << "]";
+        return ss.str();
+      }
+
+      /// Count the consumers of the subexpressions of this expression
+
+      /// This expression has no subexpressions; derived classes visit their
+      /// arguments.
+      void cse_visit(CommonSubexprRegistry&) const { }
+
     }; // class ExprEngine
 
   }  // namespace expressions
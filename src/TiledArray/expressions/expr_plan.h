@@ -0,0 +1,194 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
+
+#include <TiledArray/expressions/tsr_expr.h>
+#include <TiledArray/dense_shape.h>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Reusable evaluation plan of an expression statement
+
+    /// A plan holds the expression and the result of an assignment, e.g.
+    /// <tt>c("i,j") = a("i,k") * b("k,j")</tt>, together with the expression
+    /// engine of the statement. The engine is initialized by the first call
+    /// to \c eval() , which computes the variable lists, permutations,
+    /// tiled ranges, process maps, and the GEMM helpers and process grids of
+    /// contractions. Later calls only update the engine with the current
+    /// arrays of the expression (their shapes), and then evaluate the tiles.
+    /// The arrays of the expression may be reassigned between evaluations,
+    /// but their tiled ranges must not change.
+    ///
+    /// When the arrays of a sparse expression are modified in place between
+    /// evaluations (see \c DistArray::mark_modified() and
+    /// \c DistArray::update_shape() ), only the result tiles that depend on
+    /// modified tiles are recomputed, and the other tiles are taken from the
+    /// previous result. The dependencies of a contraction are given by the
+    /// shapes of its arguments. Dense expressions, symmetric results, and
+    /// expressions whose arrays, or result array, were reassigned are
+    /// evaluated in full.
+    /// \note The contraction mode (see \c ContractionMode) is selected when
+    /// the plan is initialized, and products of three arrays are evaluated
+    /// in the order they are written.
+    /// \tparam E The expression type
+    /// \tparam A The result array type
+    /// \tparam Alias Tile alias flag of the result
+    template <typename E, typename A, bool Alias>
+    class ExprPlan {
+    public:
+      typedef ExprPlan<E, A, Alias> ExprPlan_; ///< This class type
+      typedef E expr_type; ///< The expression type
+      typedef TsrExpr<A, Alias> result_type; ///< The result expression type
+      typedef typename E::engine_type engine_type; ///< The expression engine type
+
+    private:
+
+      expr_type expr_; ///< The expression
+      result_type result_; ///< The result of the expression
+      std::unique_ptr<engine_type> engine_; ///< The expression engine
+      A previous_; ///< The result of the previous evaluation
+
+    public:
+
+      /// Constructor
+
+      /// \param result The result of the expression, which references the
+      /// array that will be assigned
+      /// \param expr The expression, which references its arrays
+      ExprPlan(const result_type& result, const Expr<E>& expr) :
+        expr_(expr.derived()), result_(result), engine_(), previous_()
+      { }
+
+      ExprPlan(const ExprPlan_&) = delete;
+      ExprPlan(ExprPlan_&&) = default;
+      ExprPlan_& operator=(const ExprPlan_&) = delete;
+      ExprPlan_& operator=(ExprPlan_&&) = delete;
+
+      /// Check that the engine of this plan is initialized
+
+      /// \return \c true if \c eval() was called
+      bool is_initialized() const { return static_cast<bool>(engine_); }
+
+    private:
+
+      /// Evaluate the dirty tiles of a dense expression
+
+      /// Dense expressions are evaluated in full.
+      /// \return \c false
+      bool eval_dirty(std::true_type) { return false; }
+
+      /// Evaluate the dirty tiles of a sparse expression
+
+      /// The shape of the engine is masked by the dirty tiles, the masked
+      /// expression is evaluated, and the clean tiles of the previous result
+      /// are added to it.
+      /// \return \c true if the result array was assigned, or \c false if
+      /// the expression must be evaluated in full
+      bool eval_dirty(std::false_type) {
+        typedef typename A::shape_type shape_type;
+
+        if(engine_->symmetry() || (! previous_.is_initialized()) ||
+            (! result_.array().is_initialized()) ||
+            (result_.array().id() != previous_.id()))
+          return false;
+
+        const std::vector<bool> dirty = engine_->dirty_tiles();
+        if(std::all_of(dirty.begin(), dirty.end(), [] (const bool d) { return d; }))
+          return false;
+        if(std::none_of(dirty.begin(), dirty.end(), [] (const bool d) { return d; }))
+          return true;
+
+        const auto& trange = engine_->trange();
+        Tensor<float> dirty_norms(trange.tiles_range(), 0.0f);
+        Tensor<float> clean_norms(trange.tiles_range(), 0.0f);
+        for(std::size_t i = 0ul; i < dirty.size(); ++i)
+          (dirty[i] ? dirty_norms[i] : clean_norms[i]) = std::numeric_limits<float>::max();
+        engine_->mask_shape(shape_type(dirty_norms, trange));
+
+        A dirty_array;
+        TsrExpr<A, Alias> dirty_result(dirty_array, result_.vars());
+        expr_.eval_engine_to(*engine_, dirty_result);
+
+        const shape_type shape = dirty_array.shape().add(
+            previous_.shape().mask(shape_type(clean_norms, trange)));
+        A result(previous_.world(), trange, shape, previous_.pmap());
+        for(const auto i : *result.pmap())
+          if(! result.is_zero(i))
+            result.set(i, (dirty[i] ? dirty_array.find(i) : previous_.find(i)));
+        result.swap(result_.array());
+
+        return true;
+      }
+
+    public:
+
+      /// Evaluate the expression and assign it to the result array
+      void eval() {
+        bool evaluated = false;
+        if(engine_) {
+          engine_->update(expr_);
+          engine_->symmetrize_shape();
+          evaluated = eval_dirty(std::is_same<typename A::shape_type, DenseShape>());
+        } else {
+          engine_.reset(new engine_type(expr_));
+          expr_.init_engine(*engine_, result_);
+        }
+
+        if(! evaluated)
+          expr_.eval_engine_to(*engine_, result_);
+        previous_ = result_.array();
+      }
+
+      /// Discard the engine of this plan
+
+      /// The next call to \c eval() will initialize a new engine, e.g. after
+      /// the tiled ranges of the arrays have changed.
+      void reset() {
+        engine_.reset();
+        previous_ = A();
+      }
+
+    }; // class ExprPlan
+
+    /// Construct a reusable plan of an expression statement
+
+    /// \tparam A The result array type
+    /// \tparam Alias Tile alias flag of the result
+    /// \tparam E The expression type
+    /// \param result The result of the expression
+    /// \param expr The expression
+    /// \return A plan that evaluates <tt>result = expr</tt>
+    template <typename A, bool Alias, typename E>
+    inline ExprPlan<E, A, Alias>
+    make_plan(const TsrExpr<A, Alias>& result, const Expr<E>& expr) {
+      return ExprPlan<E, A, Alias>(result, expr);
+    }
+
+  } // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_EXPR_PLAN_H__INCLUDED
@@ -0,0 +1,100 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EXPR_PREDICTION_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EXPR_PREDICTION_H__INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <numeric>
+#include <vector>
+#include <TiledArray/tiled_range.h>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Predicted result of an expression
+
+    /// A prediction is computed by propagating only the tiled ranges, shapes,
+    /// and process maps through the expression engines, so no tiles are
+    /// allocated or evaluated. The shape is the one the result array would be
+    /// constructed with, and the tile counts and bytes are those of its
+    /// non-zero tiles on each process.
+    /// \tparam Shape The shape type of the result
+    template <typename Shape>
+    struct ExprPrediction {
+      typedef std::size_t size_type; ///< Size type
+      typedef Shape shape_type; ///< Shape type
+
+      TiledRange trange; ///< The tiled range of the result
+      shape_type shape; ///< The shape of the result
+      std::vector<size_type> tile_count; ///< Number of non-zero tiles owned by each process
+      std::vector<size_type> tile_bytes; ///< Bytes of the non-zero tiles owned by each process
+
+      ExprPrediction() : trange(), shape(), tile_count(), tile_bytes() { }
+
+      /// Total number of non-zero tiles
+
+      /// \return The number of non-zero tiles of the result
+      size_type total_tile_count() const {
+        return std::accumulate(tile_count.begin(), tile_count.end(), size_type(0ul));
+      }
+
+      /// Total tile memory
+
+      /// \return The number of bytes of the non-zero tiles of the result
+      size_type total_tile_bytes() const {
+        return std::accumulate(tile_bytes.begin(), tile_bytes.end(), size_type(0ul));
+      }
+
+      /// Maximum tile memory
+
+      /// \return The largest number of bytes of result tiles owned by a
+      /// process
+      size_type max_tile_bytes() const {
+        return (tile_bytes.empty() ? 0ul :
+            *std::max_element(tile_bytes.begin(), tile_bytes.end()));
+      }
+
+    }; // struct ExprPrediction
+
+    /// Expression prediction output operator
+
+    /// The prediction is written as a single line of \c key=value pairs.
+    /// \tparam Shape The shape type of the result
+    /// \param os The output stream
+    /// \param prediction The expression prediction
+    /// \return \c os
+    template <typename Shape>
+    inline std::ostream& operator<<(std::ostream& os,
+        const ExprPrediction<Shape>& prediction)
+    {
+      os << "tiles=" << prediction.trange.tiles_range().volume()
+         << " sparsity=" << prediction.shape.sparsity()
+         << " tile_count=" << prediction.total_tile_count()
+         << " tile_bytes=" << prediction.total_tile_bytes()
+         << " max_tile_bytes=" << prediction.max_tile_bytes();
+      return os;
+    }
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_EXPR_PREDICTION_H__INCLUDED
@@ -0,0 +1,377 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  expr_slice.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EXPR_SLICE_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EXPR_SLICE_H__INCLUDED
+
+#include <TiledArray/expressions/variable_list.h>
+#include <TiledArray/error.h>
+#include <TiledArray/type_traits.h>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    // Forward declarations
+    template <typename> struct EngineTrait;
+    template <typename> class ExprEngine;
+    template <typename> class LeafEngine;
+    template <typename> class UnaryEngine;
+    template <typename> class BinaryEngine;
+    template <typename, bool> class TsrExpr;
+    template <typename, bool> class BlkTsrExpr;
+    template <typename, typename> class ScalTsrExpr;
+    template <typename, typename> class ScalBlkTsrExpr;
+    template <typename, typename> class ScalExpr;
+    template <typename, typename> class AddExpr;
+    template <typename, typename, typename> class ScalAddExpr;
+    template <typename, typename> class SubtExpr;
+    template <typename, typename, typename> class ScalSubtExpr;
+    template <typename, typename> class MultExpr;
+    template <typename, typename, typename> class ScalMultExpr;
+
+    namespace detail {
+
+      /// Restrict the tile bounds of an array to a slice
+
+      /// The bounds of the dimensions of \c vars that are annotated with
+      /// \c var are restricted to the tiles <tt>[first, last)</tt> , relative
+      /// to their lower bound.
+      /// \param vars The annotation of the array
+      /// \param var The sliced variable
+      /// \param first The first tile of the slice
+      /// \param last The end of the slice
+      /// \param[in,out] lower The lower bound of the tiles of the array
+      /// \param[in,out] upper The upper bound of the tiles of the array
+      inline void slice_bounds(const std::string& vars, const std::string& var,
+          const std::size_t first, const std::size_t last,
+          std::vector<std::size_t>& lower, std::vector<std::size_t>& upper)
+      {
+        const VariableList var_list(vars);
+        for(unsigned int i = 0u; i < var_list.dim(); ++i) {
+          if(var_list[i] == var) {
+            TA_ASSERT((lower[i] + last) <= upper[i]);
+            upper[i] = lower[i] + last;
+            lower[i] += first;
+          }
+        }
+      }
+
+      /// Tile bounds of an array
+
+      /// \param array The array
+      /// \return The lower and upper bounds of the tiles of \c array
+      template <typename A>
+      inline std::pair<std::vector<std::size_t>, std::vector<std::size_t> >
+      array_bounds(const A& array) {
+        const auto& range = array.trange().tiles_range();
+        return std::make_pair(
+            std::vector<std::size_t>(range.lobound_data(), range.lobound_data() + range.rank()),
+            std::vector<std::size_t>(range.upbound_data(), range.upbound_data() + range.rank()));
+      }
+
+      /// Add the bytes of the non-zero result tiles of an engine
+
+      /// \param engine An initialized expression engine
+      /// \param[in,out] bytes The bytes of each process
+      template <typename D>
+      inline void add_tile_bytes(const ExprEngine<D>& engine,
+          std::vector<std::size_t>& bytes)
+      {
+        typedef typename TiledArray::detail::numeric_type<
+            typename EngineTrait<D>::eval_type>::type numeric_type;
+        const auto& trange = engine.trange();
+        const auto& shape = engine.shape();
+        const auto& pmap = engine.pmap();
+        const std::size_t n = trange.tiles_range().volume();
+        for(std::size_t index = 0ul; index < n; ++index)
+          if(! shape.is_zero(index))
+            bytes[pmap ? pmap->owner(index) : index % bytes.size()] +=
+                sizeof(numeric_type) * trange.make_tile_range(index).volume();
+      }
+
+      /// Add the bytes of the intermediate tiles of a leaf engine
+
+      /// The tiles of leaves are those of their arrays, so none are added.
+      template <typename D>
+      inline void add_intermediate_bytes(const LeafEngine<D>&,
+          std::vector<std::size_t>&)
+      { }
+
+      /// Add the bytes of the intermediate tiles of a unary engine
+
+      /// \param engine An initialized expression engine
+      /// \param[in,out] bytes The bytes of each process
+      template <typename D>
+      inline void add_intermediate_bytes(const UnaryEngine<D>& engine,
+          std::vector<std::size_t>& bytes)
+      {
+        add_intermediate_bytes(engine.arg(), bytes);
+        add_tile_bytes(engine, bytes);
+      }
+
+      /// Add the bytes of the intermediate tiles of a binary engine
+
+      /// \param engine An initialized expression engine
+      /// \param[in,out] bytes The bytes of each process
+      template <typename D>
+      inline void add_intermediate_bytes(const BinaryEngine<D>& engine,
+          std::vector<std::size_t>& bytes)
+      {
+        add_intermediate_bytes(engine.left(), bytes);
+        add_intermediate_bytes(engine.right(), bytes);
+        add_tile_bytes(engine, bytes);
+      }
+
+    }  // namespace detail
+
+    /// Slice of a tensor expression
+
+    /// The slices of expressions restrict the dimensions that are annotated
+    /// with a variable to a range of tiles, so an expression can be
+    /// evaluated in batches of the tiles of a result dimension (see
+    /// \c Expr::set_batch_max_memory() ). The variable must denote the same
+    /// dimension wherever it appears in the expression.
+    /// \param expr The tensor expression
+    /// \param var The sliced variable
+    /// \param first The first tile of the slice
+    /// \param last The end of the slice
+    /// \return A block expression of the tiles of the slice
+    template <typename A, bool Alias>
+    inline BlkTsrExpr<const typename std::remove_const<A>::type, true>
+    slice_expr(const TsrExpr<A, Alias>& expr, const std::string& var,
+        const std::size_t first, const std::size_t last)
+    {
+      auto bounds = detail::array_bounds(expr.array());
+      detail::slice_bounds(expr.vars(), var, first, last, bounds.first, bounds.second);
+      return BlkTsrExpr<const typename std::remove_const<A>::type, true>(
+          expr.array(), expr.vars(), bounds.first, bounds.second);
+    }
+
+    /// Slice of a scaled tensor expression
+
+    /// \param expr The scaled tensor expression
+    /// \param var The sliced variable
+    /// \param first The first tile of the slice
+    /// \param last The end of the slice
+    /// \return A scaled block expression of the tiles of the slice
+    template <typename A, typename Scalar>
+    inline ScalBlkTsrExpr<A, Scalar>
+    slice_expr(const ScalTsrExpr<A, Scalar>& expr, const std::string& var,
+        const std::size_t first, const std::size_t last)
+    {
+      auto bounds = detail::array_bounds(expr.array());
+      detail::slice_bounds(expr.vars(), var, first, last, bounds.first, bounds.second);
+      return ScalBlkTsrExpr<A, Scalar>(expr.array(), expr.vars(), expr.factor(),
+          bounds.first, bounds.second);
+    }
+
+    /// Slice of a block expression
+
+    /// \param expr The block expression
+    /// \param var The sliced variable
+    /// \param first The first tile of the slice, relative to the block
+    /// \param last The end of the slice, relative to the block
+    /// \return A block expression of the tiles of the slice
+    template <typename A, bool Alias>
+    inline BlkTsrExpr<const typename std::remove_const<A>::type, true>
+    slice_expr(const BlkTsrExpr<A, Alias>& expr, const std::string& var,
+        const std::size_t first, const std::size_t last)
+    {
+      std::vector<std::size_t> lower = expr.lower_bound();
+      std::vector<std::size_t> upper = expr.upper_bound();
+      detail::slice_bounds(expr.vars(), var, first, last, lower, upper);
+      return BlkTsrExpr<const typename std::remove_const<A>::type, true>(
+          expr.array(), expr.vars(), lower, upper);
+    }
+
+    /// Slice of a scaled block expression
+
+    /// \param expr The scaled block expression
+    /// \param var The sliced variable
+    /// \param first The first tile of the slice, relative to the block
+    /// \param last The end of the slice, relative to the block
+    /// \return A scaled block expression of the tiles of the slice
+    template <typename A, typename Scalar>
+    inline ScalBlkTsrExpr<A, Scalar>
+    slice_expr(const ScalBlkTsrExpr<A, Scalar>& expr, const std::string& var,
+        const std::size_t first, const std::size_t last)
+    {
+      std::vector<std::size_t> lower = expr.lower_bound();
+      std::vector<std::size_t> upper = expr.upper_bound();
+      detail::slice_bounds(expr.vars(), var, first, last, lower, upper);
+      return ScalBlkTsrExpr<A, Scalar>(expr.array(), expr.vars(), expr.factor(),
+          lower, upper);
+    }
+
+    /// Slice of a scaled expression
+
+    /// \param expr The scaled expression
+    /// \param var The sliced variable
+    /// \param first The first tile of the slice
+    /// \param last The end of the slice
+    /// \return The scaled slice of the argument
+    template <typename Arg, typename Scalar>
+    inline auto slice_expr(const ScalExpr<Arg, Scalar>& expr, const std::string& var,
+        const std::size_t first, const std::size_t last)
+        -> ScalExpr<decltype(slice_expr(expr.arg(), var, first, last)), Scalar>
+    {
+      return ScalExpr<decltype(slice_expr(expr.arg(), var, first, last)), Scalar>(
+          slice_expr(expr.arg(), var, first, last), expr.factor());
+    }
+
+    /// Slice of a sum expression
+
+    /// \param expr The sum expression
+    /// \param var The sliced variable
+    /// \param first The first tile of the slice
+    /// \param last The end of the slice
+    /// \return The sum of the slices of the arguments
+    template <typename Left, typename Right>
+    inline auto slice_expr(const AddExpr<Left, Right>& expr, const std::string& var,
+        const std::size_t first, const std::size_t last)
+        -> AddExpr<decltype(slice_expr(expr.left(), var, first, last)),
+            decltype(slice_expr(expr.right(), var, first, last))>
+    {
+      return AddExpr<decltype(slice_expr(expr.left(), var, first, last)),
+          decltype(slice_expr(expr.right(), var, first, last))>(
+          slice_expr(expr.left(), var, first, last),
+          slice_expr(expr.right(), var, first, last));
+    }
+
+    /// Slice of a scaled sum expression
+
+    /// \param expr The scaled sum expression
+    /// \param var The sliced variable
+    /// \param first The first tile of the slice
+    /// \param last The end of the slice
+    /// \return The scaled sum of the slices of the arguments
+    template <typename Left, typename Right, typename Scalar>
+    inline auto slice_expr(const ScalAddExpr<Left, Right, Scalar>& expr,
+        const std::string& var, const std::size_t first, const std::size_t last)
+        -> ScalAddExpr<decltype(slice_expr(expr.left(), var, first, last)),
+            decltype(slice_expr(expr.right(), var, first, last)), Scalar>
+    {
+      return ScalAddExpr<decltype(slice_expr(expr.left(), var, first, last)),
+          decltype(slice_expr(expr.right(), var, first, last)), Scalar>(
+          slice_expr(expr.left(), var, first, last),
+          slice_expr(expr.right(), var, first, last), expr.factor());
+    }
+
+    /// Slice of a difference expression
+
+    /// \param expr The difference expression
+    /// \param var The sliced variable
+    /// \param first The first tile of the slice
+    /// \param last The end of the slice
+    /// \return The difference of the slices of the arguments
+    template <typename Left, typename Right>
+    inline auto slice_expr(const SubtExpr<Left, Right>& expr, const std::string& var,
+        const std::size_t first, const std::size_t last)
+        -> SubtExpr<decltype(slice_expr(expr.left(), var, first, last)),
+            decltype(slice_expr(expr.right(), var, first, last))>
+    {
+      return SubtExpr<decltype(slice_expr(expr.left(), var, first, last)),
+          decltype(slice_expr(expr.right(), var, first, last))>(
+          slice_expr(expr.left(), var, first, last),
+          slice_expr(expr.right(), var, first, last));
+    }
+
+    /// Slice of a scaled difference expression
+
+    /// \param expr The scaled difference expression
+    /// \param var The sliced variable
+    /// \param first The first tile of the slice
+    /// \param last The end of the slice
+    /// \return The scaled difference of the slices of the arguments
+    template <typename Left, typename Right, typename Scalar>
+    inline auto slice_expr(const ScalSubtExpr<Left, Right, Scalar>& expr,
+        const std::string& var, const std::size_t first, const std::size_t last)
+        -> ScalSubtExpr<decltype(slice_expr(expr.left(), var, first, last)),
+            decltype(slice_expr(expr.right(), var, first, last)), Scalar>
+    {
+      return ScalSubtExpr<decltype(slice_expr(expr.left(), var, first, last)),
+          decltype(slice_expr(expr.right(), var, first, last)), Scalar>(
+          slice_expr(expr.left(), var, first, last),
+          slice_expr(expr.right(), var, first, last), expr.factor());
+    }
+
+    /// Slice of a product expression
+
+    /// \param expr The product expression
+    /// \param var The sliced variable
+    /// \param first The first tile of the slice
+    /// \param last The end of the slice
+    /// \return The product of the slices of the arguments
+    template <typename Left, typename Right>
+    inline auto slice_expr(const MultExpr<Left, Right>& expr, const std::string& var,
+        const std::size_t first, const std::size_t last)
+        -> MultExpr<decltype(slice_expr(expr.left(), var, first, last)),
+            decltype(slice_expr(expr.right(), var, first, last))>
+    {
+      return MultExpr<decltype(slice_expr(expr.left(), var, first, last)),
+          decltype(slice_expr(expr.right(), var, first, last))>(
+          slice_expr(expr.left(), var, first, last),
+          slice_expr(expr.right(), var, first, last));
+    }
+
+    /// Slice of a scaled product expression
+
+    /// \param expr The scaled product expression
+    /// \param var The sliced variable
+    /// \param first The first tile of the slice
+    /// \param last The end of the slice
+    /// \return The scaled product of the slices of the arguments
+    template <typename Left, typename Right, typename Scalar>
+    inline auto slice_expr(const ScalMultExpr<Left, Right, Scalar>& expr,
+        const std::string& var, const std::size_t first, const std::size_t last)
+        -> ScalMultExpr<decltype(slice_expr(expr.left(), var, first, last)),
+            decltype(slice_expr(expr.right(), var, first, last)), Scalar>
+    {
+      return ScalMultExpr<decltype(slice_expr(expr.left(), var, first, last)),
+          decltype(slice_expr(expr.right(), var, first, last)), Scalar>(
+          slice_expr(expr.left(), var, first, last),
+          slice_expr(expr.right(), var, first, last), expr.factor());
+    }
+
+    /// Check that an expression can be sliced
+
+    /// Expressions of tensors, blocks, and their sums, differences,
+    /// products, and scaled forms can be sliced (see \c slice_expr() ).
+    /// \tparam E The expression type
+    template <typename E, typename = void>
+    struct is_sliceable_expr : public std::false_type { };
+
+    template <typename E>
+    struct is_sliceable_expr<E, decltype(slice_expr(std::declval<const E&>(),
+        std::declval<const std::string&>(), std::size_t(0), std::size_t(0)), void())> :
+        public std::true_type
+    { };
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_EXPR_SLICE_H__INCLUDED
@@ -0,0 +1,300 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_FUSED_ENGINE_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_FUSED_ENGINE_H__INCLUDED
+
+#include <TiledArray/dist_eval/fused_eval.h>
+#include <TiledArray/dist_eval/fused_reduce.h>
+#include <TiledArray/expressions/common_subexpr.h>
+#include <TiledArray/tensor/type_traits.h>
+
+namespace TiledArray {
+  namespace expressions {
+
+    template <typename> struct EngineTrait;
+
+    /// Check that a tile can be read or written by a fused element kernel
+
+    /// \tparam Tile The tile type
+    template <typename Tile>
+    struct is_fused_kernel_tile : public std::integral_constant<bool,
+        TiledArray::detail::is_tensor<Tile>::value &&
+        TiledArray::detail::is_numeric<TiledArray::detail::numeric_t<Tile> >::value>
+    { };
+
+    /// Element-wise fusion interface of an expression engine
+
+    /// Trees of element-wise engines (sums, differences, and scaling of
+    /// tensors with numeric elements) are evaluated by a single
+    /// \c FusedEvalImpl , whose arguments are the distributed evaluators of
+    /// the leaves of the tree. The primary template describes an engine that
+    /// is a leaf of a fused tree: its distributed evaluator is an argument of
+    /// the fused evaluator. Fusable engines specialize this class.
+    /// \tparam Engine The expression engine type
+    template <typename Engine, typename Enabler = void>
+    struct FusedEngine {
+      typedef typename EngineTrait<Engine>::eval_type eval_type; ///< Evaluation tile type
+
+      /// \c true if the engine is an element-wise node of a fused tree
+      static constexpr bool is_node = false;
+      /// \c true if all tiles read and written by the tree are tensors of numbers
+      static constexpr bool is_kernel_tile = is_fused_kernel_tile<eval_type>::value;
+      /// The number of arguments of the fused evaluator
+      static constexpr std::size_t arity = 1ul;
+      /// The number of element-wise operations that are fused
+      static constexpr unsigned int operations = 0u;
+
+      /// \return \c true if the engine can be evaluated as part of a fused tree
+      static bool is_fusable(const Engine&) { return true; }
+
+      /// \return The arguments of the fused evaluator
+      static std::tuple<typename Engine::dist_eval_type>
+      make_args(const Engine& engine) {
+        return std::make_tuple(make_arg_dist_eval(engine));
+      }
+
+      /// Count the consumers of the arguments of the fused evaluator
+      static void cse_visit(CommonSubexprRegistry& registry, const Engine& engine) {
+        registry.visit(engine);
+      }
+
+      /// \tparam I The position of the first argument of this engine
+      /// \return The element kernel of this engine
+      template <std::size_t I>
+      static TiledArray::detail::FusedArg<I> make_kernel(const Engine&) {
+        return TiledArray::detail::FusedArg<I>();
+      }
+    }; // struct FusedEngine
+
+    /// Fusion interface of a binary element-wise engine
+
+    /// Derived classes define \c make_kernel() .
+    /// \tparam Engine The expression engine type
+    template <typename Engine>
+    struct FusedBinaryEngine {
+      typedef typename EngineTrait<Engine>::left_type left_type; ///< The left-hand engine type
+      typedef typename EngineTrait<Engine>::right_type right_type; ///< The right-hand engine type
+      typedef typename EngineTrait<Engine>::eval_type eval_type; ///< Evaluation tile type
+
+      static constexpr bool is_node = true;
+      static constexpr bool is_kernel_tile =
+          FusedEngine<left_type>::is_kernel_tile &&
+          FusedEngine<right_type>::is_kernel_tile &&
+          is_fused_kernel_tile<eval_type>::value;
+      static constexpr std::size_t arity =
+          FusedEngine<left_type>::arity + FusedEngine<right_type>::arity;
+      static constexpr unsigned int operations = 1u +
+          FusedEngine<left_type>::operations + FusedEngine<right_type>::operations;
+
+      /// \return \c true if the tiles of this engine are not permuted and the
+      /// arguments can be fused
+      static bool is_fusable(const Engine& engine) {
+        return (! engine.perm()) &&
+            FusedEngine<left_type>::is_fusable(engine.left()) &&
+            FusedEngine<right_type>::is_fusable(engine.right());
+      }
+
+      static auto make_args(const Engine& engine) {
+        return std::tuple_cat(FusedEngine<left_type>::make_args(engine.left()),
+            FusedEngine<right_type>::make_args(engine.right()));
+      }
+
+      static void cse_visit(CommonSubexprRegistry& registry, const Engine& engine) {
+        FusedEngine<left_type>::cse_visit(registry, engine.left());
+        FusedEngine<right_type>::cse_visit(registry, engine.right());
+      }
+    }; // struct FusedBinaryEngine
+
+    /// Fusion interface of a unary element-wise engine
+
+    /// Derived classes define \c make_kernel() .
+    /// \tparam Engine The expression engine type
+    template <typename Engine>
+    struct FusedUnaryEngine {
+      typedef typename EngineTrait<Engine>::argument_type argument_type; ///< The argument engine type
+      typedef typename EngineTrait<Engine>::eval_type eval_type; ///< Evaluation tile type
+
+      static constexpr bool is_node = true;
+      static constexpr bool is_kernel_tile =
+          FusedEngine<argument_type>::is_kernel_tile &&
+          is_fused_kernel_tile<eval_type>::value;
+      static constexpr std::size_t arity = FusedEngine<argument_type>::arity;
+      static constexpr unsigned int operations = 1u +
+          FusedEngine<argument_type>::operations;
+
+      static bool is_fusable(const Engine& engine) {
+        return (! engine.perm()) &&
+            FusedEngine<argument_type>::is_fusable(engine.arg());
+      }
+
+      static auto make_args(const Engine& engine) {
+        return FusedEngine<argument_type>::make_args(engine.arg());
+      }
+
+      static void cse_visit(CommonSubexprRegistry& registry, const Engine& engine) {
+        FusedEngine<argument_type>::cse_visit(registry, engine.arg());
+      }
+    }; // struct FusedUnaryEngine
+
+    /// Check that an engine is the root of a fused tree
+
+    /// A tree is fused when it combines at least two element-wise
+    /// operations on tensors of numbers, and the number of arguments can be
+    /// passed to a single task.
+    /// \tparam Engine The expression engine type
+    template <typename Engine>
+    struct is_fused_root : public std::integral_constant<bool,
+        FusedEngine<Engine>::is_node && FusedEngine<Engine>::is_kernel_tile &&
+        (FusedEngine<Engine>::operations >= 2u) &&
+        (FusedEngine<Engine>::arity <= TiledArray::detail::fused_eval_max_args)>
+    { };
+
+    /// Check that the reduction of an engine can be fused
+
+    /// The elements of a fused tree are reduced without constructing the
+    /// result tiles, when the reduction can be computed element by element.
+    /// 	param Engine The expression engine type
+    /// 	param Op The tile reduction operation type
+    template <typename Engine, typename Op>
+    struct is_fused_reduce : public std::integral_constant<bool,
+        is_fused_root<Engine>::value &&
+        TiledArray::detail::FusedElementReduction<Op>::value>
+    { };
+
+    /// Check that the binary reduction of two engines can be fused
+
+    /// The arguments of both engines are reduced by a single task per tile.
+    /// At least one of the engines must be the root of a fused tree.
+    /// 	param Left The left-hand engine type
+    /// 	param Right The right-hand engine type
+    /// 	param Op The tile reduction operation type
+    template <typename Left, typename Right, typename Op>
+    struct is_fused_binary_reduce : public std::integral_constant<bool,
+        (is_fused_root<Left>::value || is_fused_root<Right>::value) &&
+        FusedEngine<Left>::is_kernel_tile && FusedEngine<Right>::is_kernel_tile &&
+        ((FusedEngine<Left>::arity + FusedEngine<Right>::arity) <=
+            TiledArray::detail::fused_eval_max_args) &&
+        TiledArray::detail::FusedElementReduction<Op>::value>
+    { };
+
+    namespace detail {
+
+      template <typename Kernel, typename Result, typename Policy, typename Args>
+      struct fused_eval_impl;
+
+      template <typename Kernel, typename Result, typename Policy, typename... Args>
+      struct fused_eval_impl<Kernel, Result, Policy, std::tuple<Args...> > {
+        typedef TiledArray::detail::FusedEvalImpl<Kernel, Result, Policy, Args...> type;
+      };
+
+      template <typename Kernel, typename Op, typename Policy, typename Args>
+      struct fused_reduce_impl;
+
+      template <typename Kernel, typename Op, typename Policy, typename... Args>
+      struct fused_reduce_impl<Kernel, Op, Policy, std::tuple<Args...> > {
+        typedef TiledArray::detail::FusedReduceImpl<Kernel, Op, Policy, Args...> type;
+      };
+
+    } // namespace detail
+
+    /// Construct the fused distributed evaluator of an engine
+
+    /// \tparam Engine The expression engine type
+    /// \param engine The initialized root engine of a fused tree
+    /// \return The distributed evaluator of \c engine
+    template <typename Engine>
+    typename Engine::dist_eval_type make_fused_dist_eval(const Engine& engine) {
+      typedef decltype(FusedEngine<Engine>::make_args(engine)) args_type;
+      typedef decltype(FusedEngine<Engine>::template make_kernel<0ul>(engine)) kernel_type;
+      typedef typename detail::fused_eval_impl<kernel_type,
+          typename Engine::value_type, typename Engine::policy, args_type>::type
+          impl_type;
+
+      std::shared_ptr<impl_type> pimpl =
+          std::make_shared<impl_type>(FusedEngine<Engine>::make_args(engine),
+              *engine.world(), engine.trange(), engine.shape(), engine.pmap(),
+              FusedEngine<Engine>::template make_kernel<0ul>(engine));
+
+      return typename Engine::dist_eval_type(pimpl);
+    }
+
+    /// Construct the fused reduction of an engine
+
+    /// 	param Engine The expression engine type
+    /// 	param Op The tile reduction operation type
+    /// \param engine The initialized root engine of a fused tree
+    /// \param op The tile reduction operation
+    /// \return The fused reduction of the elements of \c engine
+    template <typename Engine, typename Op>
+    auto make_fused_reduce(const Engine& engine, const Op& op) {
+      typedef decltype(FusedEngine<Engine>::make_args(engine)) args_type;
+      typedef decltype(FusedEngine<Engine>::template make_kernel<0ul>(engine)) kernel_type;
+      typedef typename detail::fused_reduce_impl<kernel_type, Op,
+          typename Engine::policy, args_type>::type impl_type;
+
+      CommonSubexprRegistry registry(engine);
+      return std::make_shared<impl_type>(FusedEngine<Engine>::make_args(engine),
+          *engine.world(), engine.trange(), engine.shape(),
+          FusedEngine<Engine>::template make_kernel<0ul>(engine), op);
+    }
+
+    /// Construct the fused binary reduction of two engines
+
+    /// 	param Left The left-hand engine type
+    /// 	param Right The right-hand engine type
+    /// 	param Op The tile reduction operation type
+    /// \param left The initialized left-hand engine
+    /// \param right The initialized right-hand engine, which has the process
+    /// map and tiled range of \c left
+    /// \param op The tile reduction operation
+    /// \return The fused reduction of the element pairs of \c left and
+    /// \c right
+    template <typename Left, typename Right, typename Op>
+    auto make_fused_reduce(const Left& left, const Right& right, const Op& op) {
+      constexpr std::size_t right_first = FusedEngine<Left>::arity;
+      typedef decltype(std::tuple_cat(FusedEngine<Left>::make_args(left),
+          FusedEngine<Right>::make_args(right))) args_type;
+      typedef TiledArray::detail::FusedKernelPair<
+          decltype(FusedEngine<Left>::template make_kernel<0ul>(left)),
+          decltype(FusedEngine<Right>::template make_kernel<right_first>(right))>
+          kernel_type;
+      typedef typename detail::fused_reduce_impl<kernel_type, Op,
+          typename Left::policy, args_type>::type impl_type;
+
+      // The common subexpressions of each argument are evaluated once
+      auto left_args = [&] () {
+        CommonSubexprRegistry registry(left);
+        return FusedEngine<Left>::make_args(left);
+      };
+      auto right_args = [&] () {
+        CommonSubexprRegistry registry(right);
+        return FusedEngine<Right>::make_args(right);
+      };
+
+      return std::make_shared<impl_type>(std::tuple_cat(left_args(), right_args()),
+          *left.world(), left.trange(), left.shape().mask(right.shape()),
+          kernel_type{ FusedEngine<Left>::template make_kernel<0ul>(left),
+              FusedEngine<Right>::template make_kernel<right_first>(right) }, op);
+    }
+
+  } // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_FUSED_ENGINE_H__INCLUDED
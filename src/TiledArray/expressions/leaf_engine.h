@@ -28,6 +28,9 @@
 
 #include <TiledArray/expressions/expr_engine.h>
 #include <TiledArray/dist_eval/array_eval.h>
+#include <TiledArray/conversions/dense_to_sparse.h>
+#include <cstdint>
+#include <vector>
 
 namespace TiledArray {
   namespace expressions {
@@ -72,6 +75,15 @@ namespace TiledArray {
       using ExprEngine_::permute_tiles_;
 
       array_type array_; ///< The array object
+      Permutation layout_perm_; ///< The permutation of the cached layout
+                                ///< that is used in place of the array
+      mutable size_type data_elements_; ///< The number of elements of the
+                                        ///< non-zero tiles, or zero if unknown
+      std::uint64_t version_; ///< The version of the array at the previous
+                              ///< evaluation (see \c DistArray::version() )
+      std::vector<bool> dirty_; ///< The result tiles that depend on tiles
+                                ///< that were modified since the previous
+                                ///< evaluation, or empty if unknown
 
     public:
 
@@ -81,7 +93,8 @@ namespace TiledArray {
       template <typename D>
       LeafEngine(const Expr<D>& expr) :
         ExprEngine_(expr),
-        array_(expr.derived().array())
+        array_(expr.derived().array()), layout_perm_(), data_elements_(0ul),
+        version_(array_.is_initialized() ? array_.version() : 0ul), dirty_()
       {
         vars_ = VariableList(expr.derived().vars());
       }
@@ -89,6 +102,70 @@ namespace TiledArray {
       // Import base class variables to this scope
       using ExprEngine_::derived;
 
+      /// Number of elements of the leaf
+
+      /// \return The number of elements of the non-zero tiles of the array
+      size_type data_elements() const {
+        if(data_elements_ == 0ul)
+          data_elements_ = derived().make_data_elements();
+        return data_elements_;
+      }
+
+      /// Count the elements of the non-zero tiles of the array
+
+      /// \return The number of elements of the non-zero tiles of the array
+      size_type make_data_elements() const {
+        if(array_.is_dense())
+          return array_.trange().elements_range().volume();
+
+        size_type result = 0ul;
+        const size_type n = array_.trange().tiles_range().volume();
+        for(size_type i = 0ul; i < n; ++i)
+          if(! array_.is_zero(i))
+            result += array_.trange().make_tile_range(i).volume();
+        return result;
+      }
+
+      /// Estimated cost of a variable list
+
+      /// \param target_vars The target variable list for this expression
+      /// \return The number of elements that are permuted to produce
+      /// \c target_vars
+      size_type perm_cost(const VariableList& target_vars) const {
+        if((vars_ == target_vars) || derived().make_layout(target_vars).is_initialized())
+          return 0ul;
+        return data_elements();
+      }
+
+      /// Cached layout factory function
+
+      /// \param target_vars The target variable list for this expression
+      /// \return The permuted layout of the array that has the index order of
+      /// \c target_vars (see \c DistArray::cache_layout() ), or an
+      /// uninitialized array if it is not cached
+      array_type make_layout(const VariableList& target_vars) const {
+        if((vars_ == target_vars) || ! target_vars.is_permutation(vars_))
+          return array_type();
+        return array_.layout(target_vars.permutation(vars_));
+      }
+
+      /// Initialize result tensor structure
+
+      /// When the array has a cached layout with the index order of
+      /// \c target_vars , the layout is used in place of the array, so its
+      /// tiles are not permuted.
+      /// \param target_vars The target variable list for this expression
+      void init_struct(const VariableList& target_vars) {
+        const array_type layout = derived().make_layout(target_vars);
+        if(layout.is_initialized()) {
+          layout_perm_ = target_vars.permutation(vars_);
+          array_ = layout;
+          vars_ = target_vars;
+          data_elements_ = 0ul;
+        }
+        ExprEngine_::init_struct(target_vars);
+      }
+
       /// Set the variable list for this expression
 
       /// This function is a noop since the variable list is fixed.
@@ -119,12 +196,76 @@ namespace TiledArray {
       /// This function is a noop since the variable list is fixed.
       void init_vars() { }
 
+      /// Initialize the distribution of the array tiles
+
+      /// When no process map is given, the tiles are evaluated where the
+      /// array tiles are stored. When the expression is evaluated in another
+      /// world than the array, e.g. in a subworld of the array world, the
+      /// tiles are distributed with the default process map of that world,
+      /// and read from the array world.
+      /// \param world The world where the array tiles will be evaluated
+      /// \param pmap The process map of the tiles
       void init_distribution(World* world,
           const std::shared_ptr<pmap_interface>& pmap)
       {
-        ExprEngine_::init_distribution(world, (pmap ? pmap : array_.pmap()));
+        if(pmap)
+          ExprEngine_::init_distribution(world, pmap);
+        else if(world == & array_.world())
+          ExprEngine_::init_distribution(world, array_.pmap());
+        else
+          ExprEngine_::init_distribution(world,
+              policy::default_pmap(*world, trange_.tiles_range().volume()));
+      }
+
+      /// Replicated expression query
+
+      /// \param world The world where the expression is evaluated
+      /// \return \c true if the array is replicated in \c world , e.g. by
+      /// \c DistArray::make_replicated()
+      bool is_replicated(const World& world) const {
+        return (& world == & array_.world()) && array_.pmap()->is_replicated();
+      }
+
+      /// Update this engine with the array of an expression
+
+      /// The shape of the result is recomputed from the current array of
+      /// \c expr , which must have the same tiled range as the array this
+      /// engine was initialized with. When this engine uses a cached layout,
+      /// the array of \c expr must have the same layout. The tiles of the
+      /// array that were modified since the previous evaluation are
+      /// recorded (see \c dirty_tiles() ); all tiles are modified when the
+      /// array is not the same array, or a cached layout is used.
+      /// \tparam D The derived expression type
+      /// \param expr The expression
+      template <typename D>
+      void update(const Expr<D>& expr) {
+        const array_type array = (layout_perm_ ?
+            expr.derived().array().layout(layout_perm_) :
+            array_type(expr.derived().array()));
+        TA_USER_ASSERT(array.is_initialized(), "LeafEngine::update() -- "
+            "The array does not have the layout of the expression.");
+        TA_ASSERT(array.trange() == array_.trange());
+        if((! layout_perm_) && (array.id() == array_.id())) {
+          std::vector<bool> dirty(array.size(), false);
+          for(size_type i = 0ul; i < dirty.size(); ++i)
+            dirty[i] = (array.tile_version(i) > version_);
+          dirty_ = ExprEngine_::permute_dirty_tiles(dirty);
+        } else {
+          dirty_.clear();
+        }
+        version_ = array.version();
+        array_ = array;
+        data_elements_ = 0ul;
+        ExprEngine_::derived().update_shape();
       }
 
+      /// Result tiles that depend on modified array tiles
+
+      /// \return A flag for each result tile that was modified since the
+      /// previous evaluation (see \c update() )
+      std::vector<bool> dirty_tiles() const {
+        return (dirty_.empty() ? ExprEngine_::dirty_tiles() : dirty_);
+      }
 
       /// Non-permuting tiled range factory function
 
@@ -151,6 +292,33 @@ namespace TiledArray {
       shape_type
       make_shape(const Permutation& perm) { return array_.shape().perm(perm); }
 
+      /// Tile norms of the dense array
+
+      /// The norms of the local tiles are computed by tasks and summed over
+      /// the world of the array, so this must be called on all processes of
+      /// that world.
+      /// \tparam T The norm type of the shape
+      /// \return The shape of the tile norms of the array
+      template <typename T>
+      SparseShape<T> array_norm_shape() const {
+        Tensor<float> tile_norms(array_.trange().tiles_range(), 0.0f);
+        TiledArray::detail::local_tile_norms(array_, tile_norms);
+        return SparseShape<T>(array_.world(),
+            Tensor<T>(tile_norms.range(), tile_norms.begin()), array_.trange());
+      }
+
+      /// Tile norms of a dense argument of a sparse result
+
+      /// A dense argument of a sparse product or contraction is given the
+      /// shape of its tile norms (see \c detail::ShapeCast ).
+      /// \tparam T The norm type of the shape
+      /// \return The shape of the tile norms of the result
+      template <typename T>
+      SparseShape<T> norm_shape() const {
+        const SparseShape<T> shape = array_norm_shape<T>();
+        return (perm_ ? shape.perm(perm_) : shape);
+      }
+
 
       /// Construct the distributed evaluator for array
       dist_eval_type make_dist_eval() const {
@@ -165,6 +333,20 @@ namespace TiledArray {
         return dist_eval_type(pimpl);
       }
 
+      /// Array accessor
+
+      /// \return A const reference to the array of this expression
+      const array_type& array() const { return array_; }
+
+      /// Common subexpression key
+
+      /// \return A string that identifies this expression and its array
+      std::string cse_key() const {
+        std::stringstream ss;
+        ss << ExprEngine_::cse_key() << " #" << array_.id();
+        return ss.str();
+      }
+
     }; // class LeafEngine
 
   }  // namespace expressions
@@ -42,10 +42,6 @@ namespace TiledArray {
 
     template <typename Left, typename Right, typename Result>
     struct EngineTrait<MultEngine<Left, Right, Result> > {
-      static_assert(std::is_same<typename EngineTrait<Left>::policy,
-          typename EngineTrait<Right>::policy>::value,
-          "The left- and right-hand expressions must use the same policy class");
-
       // Argument typedefs
       typedef Left left_type; ///< The left-hand expression type
       typedef Right right_type; ///< The right-hand expression type
@@ -64,7 +60,8 @@ namespace TiledArray {
           eval_type;  ///< Evaluation tile type
       typedef typename TiledArray::detail::numeric_type<value_type>::type
           scalar_type; ///< Tile scalar type
-      typedef typename Left::policy policy; ///< The result policy type
+      typedef typename TiledArray::detail::mult_policy<typename Left::policy,
+          typename Right::policy>::type policy; ///< The result policy type
       typedef TiledArray::detail::DistEval<value_type, policy>
           dist_eval_type; ///< The distributed evaluator type
 
@@ -82,10 +79,6 @@ namespace TiledArray {
 
     template <typename Left, typename Right, typename Scalar, typename Result>
     struct EngineTrait<ScalMultEngine<Left, Right, Scalar, Result> > {
-      static_assert(std::is_same<typename EngineTrait<Left>::policy,
-          typename EngineTrait<Right>::policy>::value,
-          "The left- and right-hand expressions must use the same policy class");
-
       // Argument typedefs
       typedef Left left_type; ///< The left-hand expression type
       typedef Right right_type; ///< The right-hand expression type
@@ -103,7 +96,8 @@ namespace TiledArray {
           value_type; ///< The result tile type
       typedef typename eval_trait<value_type>::type
           eval_type;  ///< Evaluation tile type
-      typedef typename Left::policy policy; ///< The result policy type
+      typedef typename TiledArray::detail::mult_policy<typename Left::policy,
+          typename Right::policy>::type policy; ///< The result policy type
       typedef TiledArray::detail::DistEval<value_type, policy>
           dist_eval_type; ///< The distributed evaluator type
 
@@ -188,6 +182,16 @@ namespace TiledArray {
       { }
 
 
+      /// Estimated cost of a variable list
+
+      /// \param target_vars The target variable list for this expression
+      /// \return The estimated number of elements that are permuted to
+      /// produce \c target_vars
+      size_type perm_cost(const VariableList& target_vars) const {
+        return (contract_ ? ContEngine_::perm_cost(target_vars) :
+            BinaryEngine_::perm_cost(target_vars));
+      }
+
       /// Set the variable list for this expression
 
       /// This function will set the variable list for this expression and its
@@ -213,9 +217,13 @@ namespace TiledArray {
         if(BinaryEngine_::left_.vars().is_permutation(BinaryEngine_::right_.vars())) {
           BinaryEngine_::perm_vars(target_vars);
         } else {
+          // Variables of both arguments that are also in the result are
+          // batch variables (see ContEngine::init_batched_vars() )
           contract_ = true;
-          ContEngine_::init_vars();
-          ContEngine_::perm_vars(target_vars);
+          if(! ContEngine_::init_batched_vars(target_vars)) {
+            ContEngine_::init_vars();
+            ContEngine_::perm_vars(target_vars);
+          }
         }
       }
 
@@ -247,6 +255,32 @@ namespace TiledArray {
           BinaryEngine_::init_struct(target_vars);
       }
 
+      /// Update result tensor shape
+      void update_shape() {
+        if(contract_)
+          ContEngine_::update_shape();
+        else
+          BinaryEngine_::update_shape();
+      }
+
+      /// Check that the result can be accumulated into the tiles of an array
+
+      /// \return \c true if this is a contraction that can be accumulated
+      /// (see \c ContEngine::is_accumulable() )
+      bool is_accumulable() const {
+        return contract_ && ContEngine_::is_accumulable();
+      }
+
+      /// Permutational symmetry of a self-contraction
+
+      /// \return The symmetry of a contraction (see
+      /// \c ContEngine::implied_symmetry() ), or a null pointer
+      std::shared_ptr<const symmetry::PermutationGroup> implied_symmetry() const {
+        if(contract_)
+          return ContEngine_::implied_symmetry();
+        return std::shared_ptr<const symmetry::PermutationGroup>();
+      }
+
       /// Initialize result tensor distribution
 
       /// This function will initialize the world and process map for the result
@@ -260,6 +294,15 @@ namespace TiledArray {
           BinaryEngine_::init_distribution(world, pmap);
       }
 
+      /// Result tiles that depend on modified argument tiles
+
+      /// \return A flag for each result tile whose contributing argument
+      /// tiles are dirty
+      std::vector<bool> dirty_tiles() const {
+        return (contract_ ? ContEngine_::dirty_tiles() :
+            BinaryEngine_::dirty_tiles());
+      }
+
       /// Non-permuting tiled range factory function
 
       /// \return The result tiled range object
@@ -285,7 +328,7 @@ namespace TiledArray {
 
       /// \return The result shape
       shape_type make_shape() const {
-        return BinaryEngine_::left_.shape().mult(BinaryEngine_::right_.shape());
+        return BinaryEngine_::left_shape().mult(BinaryEngine_::right_shape());
       }
 
       /// Permuting shape factory function
@@ -293,7 +336,7 @@ namespace TiledArray {
       /// \param perm The permutation to be applied to the array
       /// \return The result shape
       shape_type make_shape(const Permutation& perm) const {
-        return BinaryEngine_::left_.shape().mult(BinaryEngine_::right_.shape(), perm);
+        return BinaryEngine_::left_shape().mult(BinaryEngine_::right_shape(), perm);
       }
 
       /// Non-permuting tile operation factory function
@@ -317,6 +360,17 @@ namespace TiledArray {
           return BinaryEngine_::make_dist_eval();
       }
 
+      /// Construct the contraction plan for this expression
+
+      /// \return The predicted cost of evaluating the contraction
+      /// \throw TiledArray::Exception When this expression is not a
+      /// contraction.
+      ContractionPlan make_plan() const {
+        if(! contract_)
+          TA_EXCEPTION("A plan is only available for contraction expressions.");
+        return ContEngine_::make_plan();
+      }
+
       /// Expression identification tag
 
       /// \return An expression tag used to identify this expression
@@ -404,6 +458,16 @@ namespace TiledArray {
       template <typename L, typename R, typename S>
       ScalMultEngine(const ScalMultExpr<L, R, S>& expr) : ContEngine_(expr), contract_(false) { }
 
+      /// Estimated cost of a variable list
+
+      /// \param target_vars The target variable list for this expression
+      /// \return The estimated number of elements that are permuted to
+      /// produce \c target_vars
+      size_type perm_cost(const VariableList& target_vars) const {
+        return (contract_ ? ContEngine_::perm_cost(target_vars) :
+            BinaryEngine_::perm_cost(target_vars));
+      }
+
       /// Set the variable list for this expression
 
       /// This function will set the variable list for this expression and its
@@ -429,9 +493,13 @@ namespace TiledArray {
         if(BinaryEngine_::left_.vars().is_permutation(BinaryEngine_::right_.vars())) {
           BinaryEngine_::perm_vars(target_vars);
         } else {
+          // Variables of both arguments that are also in the result are
+          // batch variables (see ContEngine::init_batched_vars() )
           contract_ = true;
-          ContEngine_::init_vars();
-          ContEngine_::perm_vars(target_vars);
+          if(! ContEngine_::init_batched_vars(target_vars)) {
+            ContEngine_::init_vars();
+            ContEngine_::perm_vars(target_vars);
+          }
         }
       }
 
@@ -463,6 +531,32 @@ namespace TiledArray {
           BinaryEngine_::init_struct(target_vars);
       }
 
+      /// Update result tensor shape
+      void update_shape() {
+        if(contract_)
+          ContEngine_::update_shape();
+        else
+          BinaryEngine_::update_shape();
+      }
+
+      /// Check that the result can be accumulated into the tiles of an array
+
+      /// \return \c true if this is a contraction that can be accumulated
+      /// (see \c ContEngine::is_accumulable() )
+      bool is_accumulable() const {
+        return contract_ && ContEngine_::is_accumulable();
+      }
+
+      /// Permutational symmetry of a self-contraction
+
+      /// \return The symmetry of a contraction (see
+      /// \c ContEngine::implied_symmetry() ), or a null pointer
+      std::shared_ptr<const symmetry::PermutationGroup> implied_symmetry() const {
+        if(contract_)
+          return ContEngine_::implied_symmetry();
+        return std::shared_ptr<const symmetry::PermutationGroup>();
+      }
+
       /// Initialize result tensor distribution
 
       /// This function will initialize the world and process map for the result
@@ -486,6 +580,26 @@ namespace TiledArray {
           return BinaryEngine_::make_dist_eval();
       }
 
+      /// Construct the contraction plan for this expression
+
+      /// \return The predicted cost of evaluating the contraction
+      /// \throw TiledArray::Exception When this expression is not a
+      /// contraction.
+      ContractionPlan make_plan() const {
+        if(! contract_)
+          TA_EXCEPTION("A plan is only available for contraction expressions.");
+        return ContEngine_::make_plan();
+      }
+
+      /// Result tiles that depend on modified argument tiles
+
+      /// \return A flag for each result tile whose contributing argument
+      /// tiles are dirty
+      std::vector<bool> dirty_tiles() const {
+        return (contract_ ? ContEngine_::dirty_tiles() :
+            BinaryEngine_::dirty_tiles());
+      }
+
       /// Non-permuting tiled range factory function
 
       /// \return The result tiled range object
@@ -511,7 +625,7 @@ namespace TiledArray {
 
       /// \return The result shape
       shape_type make_shape() const {
-        return BinaryEngine_::left_.shape().mult(BinaryEngine_::right_.shape(),
+        return BinaryEngine_::left_shape().mult(BinaryEngine_::right_shape(),
             ContEngine_::factor_);
       }
 
@@ -520,7 +634,7 @@ namespace TiledArray {
       /// \param perm The permutation to be applied to the array
       /// \return The result shape
       shape_type make_shape(const Permutation& perm) const {
-        return BinaryEngine_::left_.shape().mult(BinaryEngine_::right_.shape(),
+        return BinaryEngine_::left_shape().mult(BinaryEngine_::right_shape(),
             ContEngine_::factor_, perm);
       }
 
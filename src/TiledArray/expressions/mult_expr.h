@@ -28,6 +28,7 @@
 
 #include <TiledArray/expressions/binary_expr.h>
 #include <TiledArray/expressions/mult_engine.h>
+#include <TiledArray/expressions/contraction_order.h>
 
 namespace TiledArray {
   namespace expressions {
@@ -107,6 +108,21 @@ namespace TiledArray {
         BinaryExpr_(left, right)
       { }
 
+      using BinaryExpr_::eval_to;
+
+      /// Evaluate this object and assign it to \c tsr
+
+      /// A product of three arrays is evaluated in the association with the
+      /// fewest predicted flops (see \c optimal_product_order() ); other
+      /// expressions are evaluated as given.
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param tsr The tensor to be assigned
+      template <typename A, bool Alias>
+      void eval_to(TsrExpr<A, Alias>& tsr) const {
+        ContractionOrder<MultExpr_>::eval_to(*this, tsr);
+      }
+
 
       /// Dot product
 
@@ -133,6 +149,39 @@ namespace TiledArray {
         return BinaryExpr_::left().dot(BinaryExpr_::right());
       }
 
+      /// Contraction plan
+
+      /// Predict the cost of evaluating this contraction without evaluating
+      /// any tiles.
+      /// \param target_vars The target variable list of the result
+      /// \param world The world where the contraction would be evaluated
+      /// \return The predicted cost of the contraction
+      /// \throw TiledArray::Exception When this expression is not a
+      /// contraction.
+      ContractionPlan plan(const std::string& target_vars,
+          World& world = TiledArray::get_default_world()) const
+      {
+        engine_type engine(*this);
+        engine.init(world, std::shared_ptr<typename engine_type::pmap_interface>(),
+            VariableList(target_vars));
+        return engine.make_plan();
+      }
+
+      /// Contraction plan
+
+      /// Predict the cost of evaluating this contraction, with the natural
+      /// variable order of the result, without evaluating any tiles.
+      /// \param world The world where the contraction would be evaluated
+      /// \return The predicted cost of the contraction
+      /// \throw TiledArray::Exception When this expression is not a
+      /// contraction.
+      ContractionPlan plan(World& world = TiledArray::get_default_world()) const {
+        engine_type engine(*this);
+        engine.init(world, std::shared_ptr<typename engine_type::pmap_interface>(),
+            VariableList());
+        return engine.make_plan();
+      }
+
     }; // class MultExpr
 
 
@@ -177,6 +226,39 @@ namespace TiledArray {
       /// \return The scaling factor
       scalar_type factor() const { return factor_; }
 
+      /// Contraction plan
+
+      /// Predict the cost of evaluating this contraction without evaluating
+      /// any tiles.
+      /// \param target_vars The target variable list of the result
+      /// \param world The world where the contraction would be evaluated
+      /// \return The predicted cost of the contraction
+      /// \throw TiledArray::Exception When this expression is not a
+      /// contraction.
+      ContractionPlan plan(const std::string& target_vars,
+          World& world = TiledArray::get_default_world()) const
+      {
+        engine_type engine(*this);
+        engine.init(world, std::shared_ptr<typename engine_type::pmap_interface>(),
+            VariableList(target_vars));
+        return engine.make_plan();
+      }
+
+      /// Contraction plan
+
+      /// Predict the cost of evaluating this contraction, with the natural
+      /// variable order of the result, without evaluating any tiles.
+      /// \param world The world where the contraction would be evaluated
+      /// \return The predicted cost of the contraction
+      /// \throw TiledArray::Exception When this expression is not a
+      /// contraction.
+      ContractionPlan plan(World& world = TiledArray::get_default_world()) const {
+        engine_type engine(*this);
+        engine.init(world, std::shared_ptr<typename engine_type::pmap_interface>(),
+            VariableList());
+        return engine.make_plan();
+      }
+
     }; // class ScalMultExpr
 
 
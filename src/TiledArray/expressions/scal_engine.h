@@ -128,6 +128,17 @@ namespace TiledArray {
         return UnaryEngine_::arg_.shape().scale(factor_, perm);
       }
 
+      /// Tile norms of a dense argument of a sparse result
+
+      /// \tparam T The norm type of the shape
+      /// \return The shape of the tile norms of the result
+      template <typename T>
+      SparseShape<T> norm_shape() const {
+        const SparseShape<T> shape = UnaryEngine_::arg_.template norm_shape<T>();
+        return (UnaryEngine_::perm_ ? shape.scale(factor_, UnaryEngine_::perm_) :
+            shape.scale(factor_));
+      }
+
       /// Non-permuting tile operation factory function
 
       /// \return The tile operation
@@ -139,6 +150,11 @@ namespace TiledArray {
       /// \return The tile operation
       op_type make_tile_op(const Permutation& perm) const { return op_type(perm, factor_); }
 
+      /// Scaling factor accessor
+
+      /// \return The scaling factor
+      scalar_type factor() const { return factor_; }
+
       /// Expression identification tag
 
       /// \return An expression tag used to identify this expression
@@ -150,6 +166,20 @@ namespace TiledArray {
 
     }; // class ScalEngine
 
+    /// Fusion interface of \c ScalEngine with a numeric scaling factor
+    template <typename Arg, typename Scalar, typename Result>
+    struct FusedEngine<ScalEngine<Arg, Scalar, Result>,
+        typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value>::type> :
+        public FusedUnaryEngine<ScalEngine<Arg, Scalar, Result> >
+    {
+      template <std::size_t I>
+      static auto make_kernel(const ScalEngine<Arg, Scalar, Result>& engine) {
+        return TiledArray::detail::make_fused_scal(
+            FusedEngine<Arg>::template make_kernel<I>(engine.arg()),
+            engine.factor());
+      }
+    }; // struct FusedEngine<ScalEngine>
+
 
   }  // namespace expressions
 } // namespace TiledArray
@@ -27,6 +27,8 @@
 #define TILEDARRAY_EXPRESSIONS_SCAL_TSR_ENGINE_H__INCLUDED
 
 #include <TiledArray/expressions/leaf_engine.h>
+#include <TiledArray/expressions/fused_engine.h>
+#include <TiledArray/tile_op/noop.h>
 #include <TiledArray/tile_op/scal.h>
 #include <TiledArray/tile_op/unary_wrapper.h>
 
@@ -98,8 +100,25 @@ namespace TiledArray {
       typedef typename EngineTrait<ScalTsrEngine_>::shape_type shape_type; ///< Tensor shape type
       typedef typename EngineTrait<ScalTsrEngine_>::pmap_interface pmap_interface; ///< Process map interface type
 
+      // Unscaled tile typedefs
+      typedef TiledArray::detail::Noop<typename array_type::eval_type,
+          typename array_type::eval_type, true>
+          unscaled_op_base_type; ///< Unscaled tile base operation type
+      typedef TiledArray::detail::UnaryWrapper<unscaled_op_base_type>
+          unscaled_op_type; ///< Unscaled tile operation type
+      typedef TiledArray::detail::DistEval<TiledArray::detail::LazyArrayTile<
+          typename array_type::value_type, unscaled_op_type>, policy>
+          unscaled_dist_eval_type; ///< Unscaled distributed evaluator type
+
     private:
 
+      using LeafEngine_::world_;
+      using LeafEngine_::perm_;
+      using LeafEngine_::trange_;
+      using LeafEngine_::shape_;
+      using LeafEngine_::pmap_;
+      using LeafEngine_::permute_tiles_;
+
       scalar_type factor_; ///< The scaling factor
 
     public:
@@ -122,6 +141,16 @@ namespace TiledArray {
         return LeafEngine_::array_.shape().scale(factor_, perm);
       }
 
+      /// Tile norms of a dense argument of a sparse result
+
+      /// \tparam T The norm type of the shape
+      /// \return The shape of the tile norms of the result
+      template <typename T>
+      SparseShape<T> norm_shape() const {
+        const SparseShape<T> shape = LeafEngine_::template array_norm_shape<T>();
+        return (perm_ ? shape.scale(factor_, perm_) : shape.scale(factor_));
+      }
+
       /// Non-permuting tile operation factory function
 
       /// \return The tile operation
@@ -137,6 +166,31 @@ namespace TiledArray {
         return op_type(op_base_type(factor_), perm);
       }
 
+      /// Scaling factor accessor
+
+      /// \return The scaling factor
+      scalar_type factor() const { return factor_; }
+
+      /// Construct the distributed evaluator of the unscaled array tiles
+
+      /// This evaluator is used when the scaling is applied by a fused
+      /// element-wise kernel.
+      /// \return The distributed evaluator of the unscaled, possibly permuted,
+      /// array tiles
+      unscaled_dist_eval_type make_unscaled_dist_eval() const {
+        typedef TiledArray::detail::ArrayEvalImpl<array_type, unscaled_op_type,
+            policy> impl_type;
+
+        const unscaled_op_type op = (perm_ && permute_tiles_ ?
+            unscaled_op_type(unscaled_op_base_type(), perm_) :
+            unscaled_op_type(unscaled_op_base_type()));
+        std::shared_ptr<impl_type> pimpl =
+            std::make_shared<impl_type>(LeafEngine_::array_, *world_, trange_,
+                shape_, pmap_, perm_, op);
+
+        return unscaled_dist_eval_type(pimpl);
+      }
+
       /// Expression identification tag
 
       /// \return An expression tag used to identify this expression
@@ -148,6 +202,86 @@ namespace TiledArray {
 
     }; // class ScalTsrEngine
 
+    /// Fusion interface of \c ScalTsrEngine with a numeric scaling factor
+
+    /// The scaling factor is applied by the fused kernel to the unscaled
+    /// array tiles.
+    template <typename Array, typename Scalar, typename Result>
+    struct FusedEngine<ScalTsrEngine<Array, Scalar, Result>,
+        typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value>::type>
+    {
+      typedef ScalTsrEngine<Array, Scalar, Result> engine_type; ///< The engine type
+
+      static constexpr bool is_node = false;
+      static constexpr bool is_kernel_tile =
+          is_fused_kernel_tile<typename Array::eval_type>::value &&
+          is_fused_kernel_tile<typename EngineTrait<engine_type>::eval_type>::value;
+      static constexpr std::size_t arity = 1ul;
+      static constexpr unsigned int operations = 1u;
+
+      static bool is_fusable(const engine_type&) { return true; }
+
+      static void cse_visit(CommonSubexprRegistry&, const engine_type&) { }
+
+      static std::tuple<typename engine_type::unscaled_dist_eval_type>
+      make_args(const engine_type& engine) {
+        return std::make_tuple(engine.make_unscaled_dist_eval());
+      }
+
+      template <std::size_t I>
+      static auto make_kernel(const engine_type& engine) {
+        return TiledArray::detail::make_fused_scal(
+            TiledArray::detail::FusedArg<I>(), engine.factor());
+      }
+    }; // struct FusedEngine<ScalTsrEngine>
+
+    /// Check for a conjugated tensor engine
+
+    /// The conjugation of a conjugated tensor (see \c ConjTsrExpr and
+    /// \c ScalConjTsrExpr ) may be deferred to the operation that consumes
+    /// its tiles, e.g. the GEMM of a contraction (see \c ContEngine ), when
+    /// the tiles are tensors and the conjugated tiles have the type of the
+    /// array tiles.
+    /// \tparam Engine The engine type
+    template <typename Engine>
+    struct is_conj_tsr_engine : public std::false_type { };
+
+    template <typename Array, typename S, typename Result>
+    struct is_conj_tsr_engine<ScalTsrEngine<Array,
+        TiledArray::detail::ComplexConjugate<S>, Result> > :
+      public std::integral_constant<bool,
+          TiledArray::detail::is_tensor<typename Array::eval_type>::value &&
+          std::is_same<typename Array::eval_type, typename EngineTrait<
+              ScalTsrEngine<Array, TiledArray::detail::ComplexConjugate<S>,
+              Result> >::eval_type>::value>
+    { };
+
+    /// The scaling factor of a conjugation operator
+
+    /// \tparam S The scaling factor type
+    /// \param op The conjugation operator
+    /// \return The factor that scales the conjugated value
+    template <typename S>
+    inline S conj_factor(const TiledArray::detail::ComplexConjugate<S>& op) {
+      return op.factor();
+    }
+
+    /// The scaling factor of a conjugation operator
+
+    /// \return 1
+    inline int conj_factor(const TiledArray::detail::ComplexConjugate<void>&) {
+      return 1;
+    }
+
+    /// The scaling factor of a negated conjugation operator
+
+    /// \return -1
+    inline int conj_factor(const TiledArray::detail::ComplexConjugate<
+        TiledArray::detail::ComplexNegTag>&)
+    {
+      return -1;
+    }
+
   }  // namespace expressions
 } // namespace TiledArray
 
@@ -41,10 +41,6 @@ namespace TiledArray {
 
     template <typename Left, typename Right, typename Result>
     struct EngineTrait<SubtEngine<Left, Right, Result> > {
-      static_assert(std::is_same<typename EngineTrait<Left>::policy,
-          typename EngineTrait<Right>::policy>::value,
-          "The left- and right-hand expressions must use the same policy class");
-
       // Argument typedefs
       typedef Left left_type; ///< The left-hand expression type
       typedef Right right_type; ///< The right-hand expression type
@@ -61,7 +57,8 @@ namespace TiledArray {
           value_type; ///< The result tile type
       typedef typename eval_trait<value_type>::type
           eval_type;  ///< Evaluation tile type
-      typedef typename Left::policy policy; ///< The result policy type
+      typedef typename TiledArray::detail::add_policy<typename Left::policy,
+          typename Right::policy>::type policy; ///< The result policy type
       typedef TiledArray::detail::DistEval<value_type, policy>
           dist_eval_type; ///< The distributed evaluator type
 
@@ -79,10 +76,6 @@ namespace TiledArray {
 
     template <typename Left, typename Right, typename Scalar, typename Result>
     struct EngineTrait<ScalSubtEngine<Left, Right, Scalar, Result> > {
-      static_assert(std::is_same<typename EngineTrait<Left>::policy,
-          typename EngineTrait<Right>::policy>::value,
-          "The left- and right-hand expressions must use the same policy class");
-
       // Argument typedefs
       typedef Left left_type; ///< The left-hand expression type
       typedef Right right_type; ///< The right-hand expression type
@@ -100,7 +93,8 @@ namespace TiledArray {
           value_type; ///< The result tile type
       typedef typename eval_trait<value_type>::type
           eval_type;  ///< Evaluation tile type
-      typedef typename Left::policy policy; ///< The result policy type
+      typedef typename TiledArray::detail::add_policy<typename Left::policy,
+          typename Right::policy>::type policy; ///< The result policy type
       typedef TiledArray::detail::DistEval<value_type, policy>
           dist_eval_type; ///< The distributed evaluator type
 
@@ -172,7 +166,7 @@ namespace TiledArray {
 
       /// \return The result shape
       shape_type make_shape() const {
-        return BinaryEngine_::left_.shape().subt(BinaryEngine_::right_.shape());
+        return BinaryEngine_::left_shape().subt(BinaryEngine_::right_shape());
       }
 
       /// Permuting shape factory function
@@ -180,7 +174,7 @@ namespace TiledArray {
       /// \param perm The permutation to be applied to the array
       /// \return The result shape
       shape_type make_shape(const Permutation& perm) const {
-        return BinaryEngine_::left_.shape().subt(BinaryEngine_::right_.shape(), perm);
+        return BinaryEngine_::left_shape().subt(BinaryEngine_::right_shape(), perm);
       }
 
       /// Non-permuting tile operation factory function
@@ -272,7 +266,7 @@ namespace TiledArray {
 
       /// \return The result shape
       shape_type make_shape() const {
-        return BinaryEngine_::left_.shape().subt(BinaryEngine_::right_.shape(),
+        return BinaryEngine_::left_shape().subt(BinaryEngine_::right_shape(),
             factor_);
       }
 
@@ -281,7 +275,7 @@ namespace TiledArray {
       /// \param perm The permutation to be applied to the array
       /// \return The result shape
       shape_type make_shape(const Permutation& perm) const {
-        return BinaryEngine_::left_.shape().subt(BinaryEngine_::right_.shape(),
+        return BinaryEngine_::left_shape().subt(BinaryEngine_::right_shape(),
             factor_, perm);
       }
 
@@ -298,6 +292,11 @@ namespace TiledArray {
         return op_type(op_base_type(factor_), perm);
       }
 
+      /// Scaling factor accessor
+
+      /// \return The scaling factor
+      scalar_type factor() const { return factor_; }
+
       /// Expression identification tag
 
       /// \return An expression tag used to identify this expression
@@ -309,6 +308,37 @@ namespace TiledArray {
 
     }; // class ScalSubtEngine
 
+    /// Fusion interface of \c SubtEngine
+    template <typename Left, typename Right, typename Result>
+    struct FusedEngine<SubtEngine<Left, Right, Result> > :
+        public FusedBinaryEngine<SubtEngine<Left, Right, Result> >
+    {
+      template <std::size_t I>
+      static auto make_kernel(const SubtEngine<Left, Right, Result>& engine) {
+        return TiledArray::detail::make_fused_minus(
+            FusedEngine<Left>::template make_kernel<I>(engine.left()),
+            FusedEngine<Right>::template make_kernel<I + FusedEngine<Left>::arity>(
+                engine.right()));
+      }
+    }; // struct FusedEngine<SubtEngine>
+
+    /// Fusion interface of \c ScalSubtEngine with a numeric scaling factor
+    template <typename Left, typename Right, typename Scalar, typename Result>
+    struct FusedEngine<ScalSubtEngine<Left, Right, Scalar, Result>,
+        typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value>::type> :
+        public FusedBinaryEngine<ScalSubtEngine<Left, Right, Scalar, Result> >
+    {
+      template <std::size_t I>
+      static auto make_kernel(const ScalSubtEngine<Left, Right, Scalar, Result>& engine) {
+        return TiledArray::detail::make_fused_scal(
+            TiledArray::detail::make_fused_minus(
+                FusedEngine<Left>::template make_kernel<I>(engine.left()),
+                FusedEngine<Right>::template make_kernel<I + FusedEngine<Left>::arity>(
+                    engine.right())),
+            engine.factor());
+      }
+    }; // struct FusedEngine<ScalSubtEngine>
+
   }  // namespace expressions
 } // namespace TiledArray
 
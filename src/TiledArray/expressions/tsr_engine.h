@@ -118,6 +118,16 @@ namespace TiledArray {
       template <typename A>
       TsrEngine(const TsrExpr<A, Alias>& expr) : LeafEngine_(expr) { }
 
+      /// Diagonal expression query
+
+      /// \return \c true if the array is diagonal, which an array of
+      /// Kronecker delta tiles always is
+      bool is_diagonal() const {
+        return TiledArray::detail::is_kronecker_delta<
+            typename array_type::value_type>::value ||
+            LeafEngine_::array_.is_diagonal();
+      }
+
       /// Non-permuting tile operation factory function
 
       /// \return The tile operation
@@ -131,6 +131,23 @@ namespace TiledArray {
         return array_;
       }
 
+      /// Asynchronous expression assignment
+
+      /// The array is assigned futures to the tiles of \c other , which are
+      /// evaluated by tasks after this function returns, so independent
+      /// statements are evaluated concurrently. Consumers of the tiles,
+      /// including other expressions, wait only for the tiles that they use.
+      /// \tparam D The derived expression type
+      /// \param other The expression that will be assigned to this array
+      /// \return The completion handle of the assignment
+      template <typename D>
+      EvalHandle assign_async(const Expr<D>& other) {
+        static_assert(TiledArray::expressions::is_aliased<D>::value,
+            "no_alias() expressions are not allowed on the right-hand side of "
+            "the assignment operator.");
+        return other.derived().eval_async_to(*this);
+      }
+
       /// Expression plus-assignment operator
 
       /// \tparam D The derived expression type
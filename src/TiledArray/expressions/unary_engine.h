@@ -28,6 +28,7 @@
 
 #include <TiledArray/expressions/expr_engine.h>
 #include <TiledArray/dist_eval/unary_eval.h>
+#include <TiledArray/expressions/fused_engine.h>
 
 namespace TiledArray {
   namespace expressions {
@@ -38,7 +39,7 @@ namespace TiledArray {
 
 
     template <typename Derived>
-    class UnaryEngine : ExprEngine<Derived> {
+    class UnaryEngine : public ExprEngine<Derived> {
     public:
       // Class hierarchy typedefs
       typedef UnaryEngine<Derived> UnaryEngine_; ///< This class type
@@ -93,6 +94,21 @@ namespace TiledArray {
       using ExprEngine_::derived;
       using ExprEngine_::vars;
 
+      /// Estimated number of elements of the result
+
+      /// \return The estimated number of elements of the argument
+      size_type data_elements() const { return arg_.data_elements(); }
+
+      /// Estimated cost of a variable list
+
+      /// The permutation of this expression is applied to its argument.
+      /// \param target_vars The target variable list for this expression
+      /// \return The estimated number of elements that are permuted by this
+      /// expression and its children to produce \c target_vars
+      size_type perm_cost(const VariableList& target_vars) const {
+        return arg_.perm_cost(target_vars);
+      }
+
       /// Set the variable list for this expression
 
       /// This function will set the variable list for this expression and its
@@ -144,6 +160,26 @@ namespace TiledArray {
         ExprEngine_::init_distribution(world, arg_.pmap());
       }
 
+      /// Update this engine with the arrays of an expression
+
+      /// The shapes of the argument and the result are recomputed from the
+      /// current arrays of \c expr , which must have the same structure as
+      /// the expression this engine was initialized with.
+      /// \tparam D The derived expression type
+      /// \param expr The expression
+      template <typename D>
+      void update(const UnaryExpr<D>& expr) {
+        arg_.update(expr.arg());
+        derived().update_shape();
+      }
+
+      /// Result tiles that depend on modified argument tiles
+
+      /// \return A flag for each result tile whose argument tile is dirty
+      std::vector<bool> dirty_tiles() const {
+        return ExprEngine_::permute_dirty_tiles(arg_.dirty_tiles());
+      }
+
       /// Non-permuting tiled range factory function
 
       /// \return The result tiled range
@@ -157,15 +193,34 @@ namespace TiledArray {
         return perm ^ arg_.trange();
       }
 
+      /// Argument engine accessor
+
+      /// \return A const reference to the argument engine
+      const argument_type& arg() const { return arg_; }
+
       /// Construct the distributed evaluator for this expression
 
+      /// Trees of element-wise operations that are not permuted are evaluated
+      /// with a single fused evaluator (see \c FusedEngine ).
       /// \return The distributed evaluator that will evaluate this expression
       dist_eval_type make_dist_eval() const {
+        return make_dist_eval(is_fused_root<Derived>());
+      }
+
+    private:
+
+      dist_eval_type make_dist_eval(std::true_type) const {
+        if(FusedEngine<Derived>::is_fusable(derived()))
+          return make_fused_dist_eval(derived());
+        return make_dist_eval(std::false_type());
+      }
+
+      dist_eval_type make_dist_eval(std::false_type) const {
         typedef TiledArray::detail::UnaryEvalImpl<typename argument_type::dist_eval_type,
             typename Derived::op_type, typename dist_eval_type::policy> impl_type;
 
         // Construct left and right distributed evaluators
-        const typename argument_type::dist_eval_type arg = arg_.make_dist_eval();
+        const typename argument_type::dist_eval_type arg = make_arg_dist_eval(arg_);
 
         // Construct the distributed evaluator type
         std::shared_ptr<impl_type> pimpl =
@@ -175,6 +230,41 @@ namespace TiledArray {
         return dist_eval_type(pimpl);
       }
 
+      void cse_visit(CommonSubexprRegistry& registry, std::true_type) const {
+        if(FusedEngine<Derived>::is_fusable(derived()))
+          FusedEngine<Derived>::cse_visit(registry, derived());
+        else
+          cse_visit(registry, std::false_type());
+      }
+
+      void cse_visit(CommonSubexprRegistry& registry, std::false_type) const {
+        registry.visit(arg_);
+      }
+
+    public:
+
+      /// Common subexpression key
+
+      /// \return A string that identifies this expression and its argument
+      std::string cse_key() const {
+        return ExprEngine_::cse_key() + " (" + arg_.cse_key() + ")";
+      }
+
+      /// Count the consumers of the subexpressions of this expression
+
+      /// \param registry The common subexpressions of the statement
+      void cse_visit(CommonSubexprRegistry& registry) const {
+        cse_visit(registry, is_fused_root<Derived>());
+      }
+
+      /// Number of permuted elements
+
+      /// \return The estimated number of elements that are permuted by this
+      /// expression and its argument
+      size_type perm_elements() const {
+        return ExprEngine_::perm_elements() + arg_.perm_elements();
+      }
+
       /// Expression print
 
       /// \param os The output stream
@@ -0,0 +1,381 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  cuda.h
+ *
+ */
+
+#ifndef TILEDARRAY_EXTERNAL_CUDA_H__INCLUDED
+#define TILEDARRAY_EXTERNAL_CUDA_H__INCLUDED
+
+#include <TiledArray/config.h>
+
+#ifdef TILEDARRAY_HAS_CUDA
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <cuda_runtime.h>
+#include <cublas_v2.h>
+#include <cstddef>
+#include <utility>
+
+namespace TiledArray {
+  namespace cuda {
+
+    /// Check the status of a CUDA runtime call
+
+    /// \param error The status returned by the call
+    /// \throw TiledArray::Exception if \c error is not \c cudaSuccess
+    inline void check(const cudaError_t error) {
+      if(error != cudaSuccess) {
+        TiledArray::exception_break();
+        throw TiledArray::Exception(cudaGetErrorString(error));
+      }
+    }
+
+    /// Check the status of a cuBLAS call
+
+    /// \param status The status returned by the call
+    /// \throw TiledArray::Exception if \c status is not
+    /// \c CUBLAS_STATUS_SUCCESS
+    inline void check(const cublasStatus_t status) {
+      if(status != CUBLAS_STATUS_SUCCESS)
+        TA_EXCEPTION("cuBLAS call failed");
+    }
+
+    /// The cuBLAS handle and the stream of a thread
+
+    /// Each thread that runs device operations gets its own stream and a
+    /// cuBLAS handle that is bound to it, so the tasks that run on different
+    /// threads do not serialize on the default stream. The operations of
+    /// \c CudaTensor synchronize the stream of the calling thread before
+    /// they return, so a tile that is returned by a task is ready to be used
+    /// by a task on any other thread.
+    class ThreadContext {
+      cudaStream_t stream_; ///< The stream of this thread
+      cublasHandle_t handle_; ///< The cuBLAS handle of this thread
+      void* host_buffer_; ///< Pinned host staging buffer
+      std::size_t host_buffer_size_; ///< The size of \c host_buffer_ , in bytes
+      void** pointers_; ///< Device array of pointers for batched cuBLAS calls
+      std::size_t pointers_size_; ///< The number of elements of \c pointers_
+      bool deferred_; ///< Operations return before their kernels complete
+
+      ThreadContext() :
+        stream_(nullptr), handle_(nullptr), host_buffer_(nullptr),
+        host_buffer_size_(0ul), pointers_(nullptr), pointers_size_(0ul),
+        deferred_(false)
+      {
+        check(cudaStreamCreateWithFlags(& stream_, cudaStreamNonBlocking));
+        check(cublasCreate(& handle_));
+        check(cublasSetStream(handle_, stream_));
+        check(cublasSetPointerMode(handle_, CUBLAS_POINTER_MODE_HOST));
+      }
+
+      ~ThreadContext() {
+        cudaFreeHost(host_buffer_);
+        cudaFree(pointers_);
+        cublasDestroy(handle_);
+        cudaStreamDestroy(stream_);
+      }
+
+      ThreadContext(const ThreadContext&);
+      ThreadContext& operator=(const ThreadContext&);
+
+    public:
+
+      /// The context of the calling thread
+
+      /// \return The context of the calling thread, which is created on
+      /// first use
+      static ThreadContext& instance() {
+        static thread_local ThreadContext context;
+        return context;
+      }
+
+      /// Stream accessor
+
+      /// \return The stream of this thread
+      cudaStream_t stream() const { return stream_; }
+
+      /// cuBLAS handle accessor
+
+      /// \return The cuBLAS handle of this thread
+      cublasHandle_t handle() const { return handle_; }
+
+      /// Wait for the operations that were queued by this thread
+      void synchronize() const { check(cudaStreamSynchronize(stream_)); }
+
+      /// Complete an operation
+
+      /// The stream is synchronized, unless synchronization is deferred.
+      void complete() const {
+        if(! deferred_)
+          synchronize();
+      }
+
+      /// Defer the synchronization of operations
+
+      /// While synchronization is deferred, the operations of this thread
+      /// return as soon as their kernels are queued, and the caller is
+      /// responsible for waiting for the stream (see \c when_complete ).
+      /// \param defer The new state
+      /// \return The previous state
+      bool defer_synchronization(const bool defer) {
+        const bool previous = deferred_;
+        deferred_ = defer;
+        return previous;
+      }
+
+      /// Pinned host staging buffer
+
+      /// Copies between pinned host memory and the device are asynchronous,
+      /// so a transfer on the stream of this thread overlaps with the
+      /// kernels that run on the streams of other threads. The buffer is
+      /// reused by the next call, so the data must be consumed first.
+      /// \param bytes The minimum size of the buffer, in bytes
+      /// \return A pointer to a pinned host buffer of at least \c bytes
+      void* host_buffer(const std::size_t bytes) {
+        if(bytes > host_buffer_size_) {
+          check(cudaFreeHost(host_buffer_));
+          host_buffer_ = nullptr;
+          host_buffer_size_ = 0ul;
+          check(cudaMallocHost(& host_buffer_, bytes));
+          host_buffer_size_ = bytes;
+        }
+        return host_buffer_;
+      }
+
+      /// Device array of pointers
+
+      /// The array holds the matrix pointers of batched cuBLAS calls. It is
+      /// reused by the next call, so the stream must be synchronized first.
+      /// \param n The minimum number of elements of the array
+      /// \return A device array of at least \c n pointers
+      void** pointers(const std::size_t n) {
+        if(n > pointers_size_) {
+          check(cudaFree(pointers_));
+          pointers_ = nullptr;
+          pointers_size_ = 0ul;
+          check(cudaMalloc(reinterpret_cast<void**>(& pointers_), n * sizeof(void*)));
+          pointers_size_ = n;
+        }
+        return pointers_;
+      }
+
+    }; // class ThreadContext
+
+    namespace detail {
+
+      /// A value that is waiting for the completion of a stream
+      template <typename T>
+      struct PendingValue {
+        Future<T> future; ///< The future that is set with \c value
+        T value; ///< The value
+      };
+
+      /// Set the future of a completed value
+      template <typename T>
+      void set_pending_value(PendingValue<T>* const pending) {
+        pending->future.set(std::move(pending->value));
+        delete pending;
+      }
+
+      /// Host function called by a stream when it reaches a value
+
+      /// CUDA calls are not allowed in stream host functions, so the future
+      /// is set by a task, in which the callbacks of the future may use the
+      /// device.
+      template <typename T>
+      void CUDART_CB stream_reached(void* const pending) {
+        TiledArray::get_default_world().taskq.add(& set_pending_value<T>,
+            static_cast<PendingValue<T>*>(pending));
+      }
+
+    } // namespace detail
+
+    /// Wait for the completion of the operations queued by this thread
+
+    /// This function does not block.
+    /// \tparam T The value type
+    /// \param value The value that is produced by the queued operations
+    /// \return A future that is set with \c value when the operations that
+    /// were queued on the stream of the calling thread have completed
+    template <typename T>
+    inline Future<T> when_complete(T value) {
+      auto* const pending =
+          new detail::PendingValue<T>{Future<T>(), std::move(value)};
+      Future<T> result = pending->future;
+      const cudaError_t error =
+          cudaLaunchHostFunc(ThreadContext::instance().stream(),
+          & detail::stream_reached<T>, pending);
+      if(error != cudaSuccess) {
+        delete pending;
+        check(error);
+      }
+      return result;
+    }
+
+    /// Allocator of device memory
+
+    /// The memory is only accessible from the device; it is allocated with
+    /// \c cudaMalloc .
+    /// \tparam T The element type
+    template <typename T>
+    class device_allocator {
+    public:
+      typedef T value_type;
+
+      /// Device memory is not accessible from the host
+      static constexpr bool host_accessible = false;
+
+      device_allocator() = default;
+      template <typename U>
+      device_allocator(const device_allocator<U>&) { }
+
+      template <typename U>
+      struct rebind { typedef device_allocator<U> other; };
+
+      T* allocate(const std::size_t n) {
+        void* ptr = nullptr;
+        check(cudaMalloc(& ptr, n * sizeof(T)));
+        return static_cast<T*>(ptr);
+      }
+
+      void deallocate(T* ptr, std::size_t) { cudaFree(ptr); }
+
+    }; // class device_allocator
+
+    /// Allocator of unified memory
+
+    /// The memory is allocated with \c cudaMallocManaged , so it migrates
+    /// between the host and the device on demand and it is accessible from
+    /// both.
+    /// \tparam T The element type
+    template <typename T>
+    class um_allocator {
+    public:
+      typedef T value_type;
+
+      /// Unified memory is accessible from the host
+      static constexpr bool host_accessible = true;
+
+      um_allocator() = default;
+      template <typename U>
+      um_allocator(const um_allocator<U>&) { }
+
+      template <typename U>
+      struct rebind { typedef um_allocator<U> other; };
+
+      T* allocate(const std::size_t n) {
+        void* ptr = nullptr;
+        check(cudaMallocManaged(& ptr, n * sizeof(T)));
+        return static_cast<T*>(ptr);
+      }
+
+      void deallocate(T* ptr, std::size_t) { cudaFree(ptr); }
+
+    }; // class um_allocator
+
+    template <typename T, typename U>
+    inline bool operator==(const device_allocator<T>&, const device_allocator<U>&) { return true; }
+    template <typename T, typename U>
+    inline bool operator!=(const device_allocator<T>&, const device_allocator<U>&) { return false; }
+    template <typename T, typename U>
+    inline bool operator==(const um_allocator<T>&, const um_allocator<U>&) { return true; }
+    template <typename T, typename U>
+    inline bool operator!=(const um_allocator<T>&, const um_allocator<U>&) { return false; }
+
+    // cuBLAS functions, overloaded on the element type
+
+    inline void gemm(cublasHandle_t handle, cublasOperation_t op_a,
+        cublasOperation_t op_b, int m, int n, int k, float alpha, const float* a,
+        int lda, const float* b, int ldb, float beta, float* c, int ldc)
+    { check(cublasSgemm(handle, op_a, op_b, m, n, k, &alpha, a, lda, b, ldb, &beta, c, ldc)); }
+
+    inline void gemm(cublasHandle_t handle, cublasOperation_t op_a,
+        cublasOperation_t op_b, int m, int n, int k, double alpha, const double* a,
+        int lda, const double* b, int ldb, double beta, double* c, int ldc)
+    { check(cublasDgemm(handle, op_a, op_b, m, n, k, &alpha, a, lda, b, ldb, &beta, c, ldc)); }
+
+    inline void axpy(cublasHandle_t handle, int n, float alpha, const float* x, float* y)
+    { check(cublasSaxpy(handle, n, &alpha, x, 1, y, 1)); }
+
+    inline void axpy(cublasHandle_t handle, int n, double alpha, const double* x, double* y)
+    { check(cublasDaxpy(handle, n, &alpha, x, 1, y, 1)); }
+
+    inline void scal(cublasHandle_t handle, int n, float alpha, float* x)
+    { check(cublasSscal(handle, n, &alpha, x, 1)); }
+
+    inline void scal(cublasHandle_t handle, int n, double alpha, double* x)
+    { check(cublasDscal(handle, n, &alpha, x, 1)); }
+
+    inline float dot(cublasHandle_t handle, int n, const float* x, const float* y) {
+      float result = 0.0f;
+      check(cublasSdot(handle, n, x, 1, y, 1, &result));
+      return result;
+    }
+
+    inline double dot(cublasHandle_t handle, int n, const double* x, const double* y) {
+      double result = 0.0;
+      check(cublasDdot(handle, n, x, 1, y, 1, &result));
+      return result;
+    }
+
+    inline float nrm2(cublasHandle_t handle, int n, const float* x) {
+      float result = 0.0f;
+      check(cublasSnrm2(handle, n, x, 1, &result));
+      return result;
+    }
+
+    inline double nrm2(cublasHandle_t handle, int n, const double* x) {
+      double result = 0.0;
+      check(cublasDnrm2(handle, n, x, 1, &result));
+      return result;
+    }
+
+    inline void gemm_batched(cublasHandle_t handle, cublasOperation_t op_a,
+        cublasOperation_t op_b, int m, int n, int k, float alpha,
+        const float* const a[], int lda, const float* const b[], int ldb,
+        float beta, float* const c[], int ldc, int count)
+    {
+      check(cublasSgemmBatched(handle, op_a, op_b, m, n, k, &alpha, a, lda,
+          b, ldb, &beta, c, ldc, count));
+    }
+
+    inline void gemm_batched(cublasHandle_t handle, cublasOperation_t op_a,
+        cublasOperation_t op_b, int m, int n, int k, double alpha,
+        const double* const a[], int lda, const double* const b[], int ldb,
+        double beta, double* const c[], int ldc, int count)
+    {
+      check(cublasDgemmBatched(handle, op_a, op_b, m, n, k, &alpha, a, lda,
+          b, ldb, &beta, c, ldc, count));
+    }
+
+    /// <tt>c[i] = x[i] * a[i]</tt>, for vectors of \c n elements
+    inline void dgmm(cublasHandle_t handle, int n, const float* a, const float* x, float* c)
+    { check(cublasSdgmm(handle, CUBLAS_SIDE_LEFT, n, 1, a, n, x, 1, c, n)); }
+
+    /// <tt>c[i] = x[i] * a[i]</tt>, for vectors of \c n elements
+    inline void dgmm(cublasHandle_t handle, int n, const double* a, const double* x, double* c)
+    { check(cublasDdgmm(handle, CUBLAS_SIDE_LEFT, n, 1, a, n, x, 1, c, n)); }
+
+  }  // namespace cuda
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_HAS_CUDA
+
+#endif // TILEDARRAY_EXTERNAL_CUDA_H__INCLUDED
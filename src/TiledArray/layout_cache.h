@@ -0,0 +1,184 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  layout_cache.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_LAYOUT_CACHE_H__INCLUDED
+#define TILEDARRAY_LAYOUT_CACHE_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+#include <TiledArray/permutation.h>
+#include <list>
+#include <memory>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Cache of permuted copies of an array
+
+    /// Each layout is a copy of the array whose tile indices and tile data
+    /// have been permuted once, so expressions that use the array in that
+    /// index order read the copy instead of permuting the tiles again. The
+    /// total size of the layouts is limited by a capacity in bytes, where
+    /// the oldest layouts are evicted first; a capacity of zero disables the
+    /// cache.
+    /// \note Expressions select a layout on every process, so the cache must
+    /// hold the same layouts on all processes: the layouts are added,
+    /// evicted, and cleared by collective operations only, and their sizes
+    /// are computed from the shape of the array, not from the local tiles.
+    /// \tparam Impl The array implementation type
+    template <typename Impl>
+    class LayoutCache {
+    public:
+      typedef LayoutCache<Impl> LayoutCache_; ///< This object type
+      typedef std::size_t size_type; ///< Size type
+      typedef Impl impl_type; ///< Array implementation type
+
+    private:
+
+      /// A cached layout
+      struct Entry {
+        Permutation perm; ///< The permutation from the array to the layout
+        std::shared_ptr<impl_type> layout; ///< The permuted array
+        size_type bytes; ///< The size of the layout data per process
+      }; // struct Entry
+
+      typedef std::list<Entry> list_type; ///< Cached layouts, newest first
+
+      mutable madness::Spinlock lock_; ///< Protects all members
+      size_type capacity_; ///< The maximum size of the layouts, in bytes
+      size_type bytes_; ///< The size of the layouts, in bytes
+      list_type list_; ///< The cached layouts
+
+      /// Evict the oldest layouts until the layouts fit
+
+      /// \param capacity The maximum size of the layouts
+      void evict(const size_type capacity) {
+        while(bytes_ > capacity) {
+          bytes_ -= list_.back().bytes;
+          list_.pop_back();
+        }
+      }
+
+      // Not allowed
+      LayoutCache(const LayoutCache_&);
+      LayoutCache_& operator=(const LayoutCache_&);
+
+    public:
+
+      /// Construct a disabled cache
+      LayoutCache() : lock_(), capacity_(0ul), bytes_(0ul), list_() { }
+
+      /// Check that the cache is enabled
+
+      /// \return \c true if the capacity of the cache is not zero
+      bool enabled() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return capacity_ > 0ul;
+      }
+
+      /// Set the capacity of the cache
+
+      /// Layouts are evicted until the cached layouts fit in \c capacity .
+      /// \param capacity The maximum size of the layouts, in bytes, or zero to
+      /// disable the cache
+      void capacity(const size_type capacity) {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        capacity_ = capacity;
+        evict(capacity_);
+      }
+
+      /// Capacity accessor
+
+      /// \return The maximum size of the layouts, in bytes
+      size_type capacity() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return capacity_;
+      }
+
+      /// Add a layout to the cache
+
+      /// A layout with the same permutation is replaced.
+      /// \param perm The permutation from the array to \c layout
+      /// \param layout The permuted array
+      /// \param bytes The size of the layout data per process
+      /// \return \c true if the layout was added, or \c false if it does not
+      /// fit in the capacity of the cache
+      bool insert(const Permutation& perm,
+          const std::shared_ptr<impl_type>& layout, const size_type bytes)
+      {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        for(auto it = list_.begin(); it != list_.end(); ++it) {
+          if(it->perm == perm) {
+            bytes_ -= it->bytes;
+            list_.erase(it);
+            break;
+          }
+        }
+        if(bytes > capacity_)
+          return false;
+
+        evict(capacity_ - bytes);
+        list_.push_front(Entry{perm, layout, bytes});
+        bytes_ += bytes;
+        return true;
+      }
+
+      /// Find a layout
+
+      /// \param perm The permutation from the array to the layout
+      /// \return The permuted array, or a null pointer if it is not cached
+      std::shared_ptr<impl_type> find(const Permutation& perm) const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        for(const Entry& entry : list_)
+          if(entry.perm == perm)
+            return entry.layout;
+        return std::shared_ptr<impl_type>();
+      }
+
+      /// Remove all layouts from the cache
+      void clear() {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        evict(0ul);
+      }
+
+      /// The size of the cached layouts
+
+      /// \return The size of the layout data per process, in bytes
+      size_type bytes() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return bytes_;
+      }
+
+      /// The number of cached layouts
+
+      /// \return The number of layouts in the cache
+      size_type size() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return list_.size();
+      }
+
+    }; // class LayoutCache
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_LAYOUT_CACHE_H__INCLUDED
@@ -0,0 +1,111 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  machine_calibration.h
+ *
+ */
+
+#ifndef TILEDARRAY_MACHINE_CALIBRATION_H__INCLUDED
+#define TILEDARRAY_MACHINE_CALIBRATION_H__INCLUDED
+
+#include <TiledArray/block_size_tuner.h>
+#include <TiledArray/dist_eval/tensor_all_reduce.h>
+#include <TiledArray/proc_grid.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace TiledArray {
+
+  /// Apply a machine model to the cost models of the runtime
+
+  /// The model sets:
+  /// - the machine balance of the SUMMA process grid selection
+  ///   ( \c ProcGrid::set_machine_balance() ): the flops per element sent,
+  ///   from the peak tile GEMM rate of a process and the bandwidth, and the
+  ///   message latency in elements;
+  /// - the contraction mode selection, through the message latency, which
+  ///   is charged per moved tile;
+  /// - the size above which large reduction results are reduced in chunks
+  ///   with a reduce-scatter/allgather instead of a tree (see
+  ///   \c detail::TensorAllReduce::min_elements() ), at the crossover of
+  ///   \f$ 2 \log_2 P (\alpha + 8n/\beta) \f$ and
+  ///   \f$ 2 (P - 1) (\alpha + 8n/(P\beta)) \f$ .
+  ///
+  /// Nothing is changed when the model has no network parameters (e.g. for
+  /// one process).
+  /// \param world The world of the model
+  /// \param model The machine model
+  /// \note This function is not thread safe; it should be called by all
+  /// processes with the same model, before expressions are evaluated.
+  inline void apply_machine_model(World& world,
+      const BlockSizeTuner::MachineModel& model)
+  {
+    double peak_rate = 0.0;
+    for(const auto& rate : model.gemm_rate)
+      peak_rate = std::max(peak_rate, rate.second);
+    peak_rate *= double(std::max<std::size_t>(madness::ThreadPool::size(), 1ul));
+    if((model.bandwidth <= 0.0) || (peak_rate <= 0.0))
+      return;
+
+    // The time to send one element
+    const double element_time = 8.0 / model.bandwidth;
+    detail::ProcGrid::set_machine_balance(peak_rate * element_time,
+        detail::ProcGrid::intra_node_speedup(), model.latency / element_time);
+
+    const double nprocs = world.size();
+    const double levels = std::ceil(std::log2(nprocs));
+    const double bandwidth_factor = levels - (nprocs - 1.0) / nprocs;
+    if(bandwidth_factor <= 0.0) {
+      detail::tensor_all_reduce_min_elements() = std::numeric_limits<std::size_t>::max();
+    } else {
+      const double crossover = model.latency * (nprocs - 1.0 - levels)
+          / (element_time * bandwidth_factor);
+      detail::tensor_all_reduce_min_elements() =
+          std::size_t(std::max(crossover, 0.0));
+    }
+  }
+
+  /// Calibrate the machine and apply the results to the cost models
+
+  /// The BLAS rate, the message latency, and the bandwidth are measured with
+  /// \c BlockSizeTuner , or read from its per-machine cache file when they
+  /// were measured before with the same number of processes and threads,
+  /// and applied with \c apply_machine_model() . Call this once at startup,
+  /// after \c initialize() :
+  /// \code
+  /// TiledArray::World& world = TiledArray::initialize(argc, argv);
+  /// TiledArray::calibrate_machine(world);
+  /// \endcode
+  /// \param world The world of the processes
+  /// \param cache_file The cache file name
+  /// [ default = \c BlockSizeTuner::default_cache_file() ]
+  /// \return The machine model
+  /// \note This function is collective.
+  inline BlockSizeTuner::MachineModel calibrate_machine(World& world,
+      const std::string& cache_file = BlockSizeTuner::default_cache_file())
+  {
+    BlockSizeTuner tuner(world, cache_file);
+    const BlockSizeTuner::MachineModel model = tuner.model();
+    apply_machine_model(world, model);
+    return model;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MACHINE_CALIBRATION_H__INCLUDED
@@ -26,6 +26,8 @@
 #endif // WORLD_INSTANTIATE_STATIC_TEMPLATES
 
 #include <memory>
+#include <mutex>
+#include <vector>
 #if defined(__GNUC__)
 #pragma GCC diagnostic push
 #pragma GCC system_header
@@ -69,6 +71,51 @@ namespace TiledArray {
         return world_;
       }
     };
+
+    /// The rank-local worlds of the threads of this process
+
+    /// Each thread that calls \c get() owns a world over \c MPI_COMM_SELF ,
+    /// which is created on the first call and kept until \c release() , so
+    /// the worlds are only created once per thread. Since the world objects of
+    /// a world are registered without synchronization, a world is not shared
+    /// between threads.
+    struct local_world {
+      static World& get() {
+        thread_local World* world_ = nullptr;
+        thread_local unsigned long generation_ = 0ul;
+        if(!world_ || (generation_ != generation())) {
+          TA_USER_ASSERT(madness::initialized(),
+                         "TiledArray::detail::local_world::get() called "
+                         "before madness::initialize()");
+          std::lock_guard<std::mutex> lock(mutex());
+          worlds().emplace_back(new World(SafeMPI::Intracomm(MPI_COMM_SELF)));
+          world_ = worlds().back().get();
+          generation_ = generation();
+        }
+        return *world_;
+      }
+      /// Delete the worlds of all threads
+      static void release() {
+        std::lock_guard<std::mutex> lock(mutex());
+        for(auto& world : worlds())
+          world->gop.fence();
+        worlds().clear();
+        ++generation();
+      }
+     private:
+      static std::mutex& mutex() {
+        static std::mutex mutex_;
+        return mutex_;
+      }
+      static std::vector<std::unique_ptr<World> >& worlds() {
+        static std::vector<std::unique_ptr<World> > worlds_;
+        return worlds_;
+      }
+      static unsigned long& generation() {
+        static unsigned long generation_ = 0ul;
+        return generation_;
+      }
+    };
   }  // namespace detail
 
   /// \brief Sets the default World to \c world .
@@ -97,6 +144,33 @@ namespace TiledArray {
     return detail::default_world::set(nullptr);
   }
 
+  /// Accesses the rank-local World of this thread
+
+  /// The rank-local world spans only this process, so arrays and
+  /// expressions in this world are private to the calling process and
+  /// support the full expression interface without collective
+  /// synchronization: the process map and shape of an array are constructed
+  /// locally, and the reductions of sparse shapes and the lazy deletion
+  /// involve only this process. This is intended for temporary arrays inside
+  /// tasks:
+  /// \code
+  /// world.taskq.add([=] () {
+  ///   TA::World& local = TA::get_local_world();
+  ///   TA::TArrayD tmp(local, trange);
+  ///   tmp.fill(1.0);
+  ///   TA::TArrayD result;
+  ///   result("i,j") = tmp("i,k") * tmp("k,j");
+  ///   return result("i,j").norm().get();
+  /// });
+  /// \endcode
+  /// \note The world is created on the first call in each thread, and
+  /// belongs to the calling thread; arrays in the world must be constructed
+  /// and evaluated by that thread, and destroyed before \c finalize() .
+  /// \return The rank-local world of this thread
+  static World& get_local_world() {
+    return detail::local_world::get();
+  }
+
   namespace {
   auto world_resetter = [](World* w) { set_default_world(*w); };
   }  // namespace detail
@@ -145,6 +219,7 @@ namespace TiledArray {
   }
 
   inline void finalize() {
+    detail::local_world::release();
     madness::finalize();
     TiledArray::reset_default_world();
   }
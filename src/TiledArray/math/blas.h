@@ -28,14 +28,206 @@
 
 #include <madness/tensor/cblas.h>
 #include <TiledArray/type_traits.h>
+#include <TiledArray/math/blas_threads.h>
 #include <TiledArray/math/eigen.h>
+#include <algorithm>
+#include <complex>
+#include <cstdlib>
+#include <vector>
 
 namespace TiledArray {
   namespace math {
 
+    /// Mixed-precision GEMM check
+
+    /// \c value is \c true when the result type \c T3 has a BLAS GEMM and the
+    /// argument types \c T1 and \c T2 are convertible to it, but are not both
+    /// \c T3 (e.g. \c float arguments accumulated in \c double ).
+    template <typename T1, typename T2, typename T3>
+    struct is_mixed_precision_gemm :
+        public std::integral_constant<bool,
+            (std::is_same<T3, float>::value || std::is_same<T3, double>::value
+            || std::is_same<T3, std::complex<float> >::value
+            || std::is_same<T3, std::complex<double> >::value)
+            && detail::is_numeric<T1>::value && detail::is_numeric<T2>::value
+            && std::is_convertible<T1, T3>::value
+            && std::is_convertible<T2, T3>::value
+            && ! (std::is_same<T1, T3>::value && std::is_same<T2, T3>::value)>
+    { };
+
+    /// The maximum number of elements in the mixed-precision GEMM buffers
+    constexpr std::size_t mixed_gemm_buffer_size() { return 1ul << 18; }
+
+    /// Extent bound of the small-matrix GEMM kernels
+
+    /// A GEMM with <tt>m * n * k</tt> no larger than the cube of this extent
+    /// is evaluated by the small-matrix kernels ( \c small_gemm() ) instead
+    /// of BLAS, whose per-call overhead dominates the arithmetic of tiny
+    /// tiles. The default is 32, or the value of the
+    /// \c TA_SMALL_GEMM_MAX_EXTENT environment variable; zero disables the
+    /// small-matrix kernels.
+    /// \return A reference to the extent bound
+    inline integer& small_gemm_max_extent() {
+      static integer extent = [] () {
+        const char* value = getenv("TA_SMALL_GEMM_MAX_EXTENT");
+        return integer(value ? std::atol(value) : 32);
+      }();
+      return extent;
+    }
+
+    /// Element of an operand of a small-matrix GEMM
+
+    /// \tparam Op The operation applied to the operand
+    /// \tparam T The element type
+    template <madness::cblas::CBLAS_TRANSPOSE Op, typename T>
+    struct SmallGemmElement {
+      static T get(const T x) { return x; }
+    }; // struct SmallGemmElement
+
+    template <typename T>
+    struct SmallGemmElement<madness::cblas::ConjTrans, std::complex<T> > {
+      static std::complex<T> get(const std::complex<T> x) { return std::conj(x); }
+    }; // struct SmallGemmElement
+
+    /// Small-matrix GEMM kernel for a panel of columns
+
+    /// Computes columns <tt>[first, last)</tt> of
+    /// <tt>c = alpha * op(a) * op(b) + beta * c</tt>, \c NB columns at a
+    /// time, where the \c NB partial sums of a row are kept in registers.
+    /// \tparam T The element type
+    /// \tparam OpA The operation applied to \c a
+    /// \tparam OpB The operation applied to \c b
+    /// \tparam NB The number of columns computed at a time, which must
+    /// divide <tt>last - first</tt>
+    template <typename T, madness::cblas::CBLAS_TRANSPOSE OpA,
+        madness::cblas::CBLAS_TRANSPOSE OpB, integer NB>
+    inline void small_gemm_panel(const integer m, const integer first,
+        const integer last, const integer k, const T alpha, const T* a,
+        const integer lda, const T* b, const integer ldb, const T beta, T* c,
+        const integer ldc)
+    {
+      for(integer i = 0; i < m; ++i) {
+        T* const c_i = c + i * ldc;
+        for(integer j = first; j < last; j += NB) {
+          T acc[NB];
+          for(integer jj = 0; jj < NB; ++jj)
+            acc[jj] = T(0);
+          for(integer p = 0; p < k; ++p) {
+            const T a_ip = SmallGemmElement<OpA, T>::get(
+                OpA == madness::cblas::NoTrans ? a[i * lda + p] : a[p * lda + i]);
+            for(integer jj = 0; jj < NB; ++jj)
+              acc[jj] += a_ip * SmallGemmElement<OpB, T>::get(
+                  OpB == madness::cblas::NoTrans ? b[p * ldb + j + jj] : b[(j + jj) * ldb + p]);
+          }
+          if(beta == T(0))
+            for(integer jj = 0; jj < NB; ++jj)
+              c_i[j + jj] = alpha * acc[jj];
+          else
+            for(integer jj = 0; jj < NB; ++jj)
+              c_i[j + jj] = alpha * acc[jj] + beta * c_i[j + jj];
+        }
+      }
+    }
+
+    /// Small-matrix GEMM kernel
+
+    /// The columns are computed in panels of 8, 4, and 1 columns.
+    /// \tparam T The element type
+    /// \tparam OpA The operation applied to \c a
+    /// \tparam OpB The operation applied to \c b
+    template <typename T, madness::cblas::CBLAS_TRANSPOSE OpA,
+        madness::cblas::CBLAS_TRANSPOSE OpB>
+    void small_gemm_kernel(const integer m, const integer n, const integer k,
+        const T alpha, const T* a, const integer lda, const T* b,
+        const integer ldb, const T beta, T* c, const integer ldc)
+    {
+      const integer n8 = n - (n % 8);
+      const integer n4 = n8 + ((n - n8) / 4) * 4;
+      small_gemm_panel<T, OpA, OpB, 8>(m, 0, n8, k, alpha, a, lda, b, ldb, beta, c, ldc);
+      small_gemm_panel<T, OpA, OpB, 4>(m, n8, n4, k, alpha, a, lda, b, ldb, beta, c, ldc);
+      small_gemm_panel<T, OpA, OpB, 1>(m, n4, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    }
+
+    /// Small-matrix GEMM kernel table
+
+    /// The kernels are specialized for each pair of operations at compile
+    /// time and looked up by the operations, so dispatch is a table load.
+    /// \tparam T The element type
+    template <typename T>
+    struct SmallGemmKernels {
+      typedef void (*kernel_type)(const integer, const integer, const integer,
+          const T, const T*, const integer, const T*, const integer, const T,
+          T*, const integer); ///< Kernel function type
+
+      /// Kernel lookup
+
+      /// \param op_a The operation applied to \c a
+      /// \param op_b The operation applied to \c b
+      /// \return The kernel for \c op_a and \c op_b
+      static kernel_type get(const madness::cblas::CBLAS_TRANSPOSE op_a,
+          const madness::cblas::CBLAS_TRANSPOSE op_b)
+      {
+        using madness::cblas::NoTrans;
+        using madness::cblas::Trans;
+        using madness::cblas::ConjTrans;
+        static_assert((NoTrans == 0) && (Trans == 1) && (ConjTrans == 2),
+            "TiledArray::math::SmallGemmKernels: the kernel table is indexed "
+            "by the CBLAS_TRANSPOSE values");
+        static const kernel_type kernels[3][3] = {
+          { & small_gemm_kernel<T, NoTrans, NoTrans>,
+            & small_gemm_kernel<T, NoTrans, Trans>,
+            & small_gemm_kernel<T, NoTrans, ConjTrans> },
+          { & small_gemm_kernel<T, Trans, NoTrans>,
+            & small_gemm_kernel<T, Trans, Trans>,
+            & small_gemm_kernel<T, Trans, ConjTrans> },
+          { & small_gemm_kernel<T, ConjTrans, NoTrans>,
+            & small_gemm_kernel<T, ConjTrans, Trans>,
+            & small_gemm_kernel<T, ConjTrans, ConjTrans> } };
+        return kernels[op_a][op_b];
+      }
+    }; // struct SmallGemmKernels
+
+    /// Check that a GEMM is evaluated by the small-matrix kernels
+
+    /// The product is computed in floating point, so it does not overflow
+    /// \c integer for large matrices.
+    /// \param m The number of rows of the result
+    /// \param n The number of columns of the result
+    /// \param k The inner dimension
+    /// \return \c true if <tt>m * n * k</tt> is within the cube of
+    /// \c small_gemm_max_extent()
+    inline bool is_small_gemm(const integer m, const integer n, const integer k) {
+      const integer extent = small_gemm_max_extent();
+      if(extent <= 0)
+        return false;
+      const double bound = double(extent);
+      return (double(m) * double(n) * double(k)) <= (bound * bound * bound);
+    }
+
+    /// Small-matrix GEMM
+
+    /// Computes <tt>c = alpha * op(a) * op(b) + beta * c</tt> with the
+    /// compile-time specialized kernel for \c op_a and \c op_b when
+    /// <tt>m * n * k</tt> is within the cube of \c small_gemm_max_extent() .
+    /// \return \c true if the product was computed, or \c false if the
+    /// matrices are too large, in which case \c c is unchanged
+    template <typename T>
+    inline bool small_gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const T alpha, const T* a, const integer lda,
+        const T* b, const integer ldb, const T beta, T* c, const integer ldc)
+    {
+      if(! is_small_gemm(m, n, k))
+        return false;
+      SmallGemmKernels<T>::get(op_a, op_b)(m, n, k, alpha, a, lda, b,
+          ldb, beta, c, ldc);
+      return true;
+    }
+
     // BLAS _GEMM wrapper functions
 
-    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    template <typename S1, typename T1, typename T2, typename S2, typename T3,
+        typename std::enable_if<! is_mixed_precision_gemm<T1, T2, T3>::value>::type* = nullptr>
     inline void gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
         madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
         const integer k, const S1 alpha, const T1* a, const integer lda,
@@ -134,6 +326,9 @@ namespace TiledArray {
         const integer k, const float alpha, const float* a, const integer lda,
         const float* b, const integer ldb, const float beta, float* c, const integer ldc)
     {
+      if(small_gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc))
+        return;
+      BlasThreadScope threads(m, n, k);
       madness::cblas::gemm(op_b, op_a, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
     }
 
@@ -142,6 +337,9 @@ namespace TiledArray {
         const integer k, const double alpha, const double* a, const integer lda,
         const double* b, const integer ldb, const double beta, double* c, const integer ldc)
     {
+      if(small_gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc))
+        return;
+      BlasThreadScope threads(m, n, k);
       madness::cblas::gemm(op_b, op_a, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
     }
 
@@ -151,6 +349,9 @@ namespace TiledArray {
         const integer lda, const std::complex<float>* b, const integer ldb,
         const std::complex<float> beta, std::complex<float>* c, const integer ldc)
     {
+      if(small_gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc))
+        return;
+      BlasThreadScope threads(m, n, k);
       madness::cblas::gemm(op_b, op_a, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
     }
 
@@ -160,9 +361,151 @@ namespace TiledArray {
         const integer lda, const std::complex<double>* b, const integer ldb,
         const std::complex<double> beta, std::complex<double>* c, const integer ldc)
     {
+      if(small_gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc))
+        return;
+      BlasThreadScope threads(m, n, k);
       madness::cblas::gemm(op_b, op_a, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
     }
 
+    /// Mixed-precision GEMM
+
+    /// Computes <tt>c = alpha * op(a) * op(b) + beta * c</tt> where \c a and
+    /// \c b are converted to the type of \c c on the fly. Panels of \c k
+    /// columns of \c op(a) and rows of \c op(b) are copied into thread-local
+    /// buffers of at most \c mixed_gemm_buffer_size() elements, which are
+    /// multiplied by the \c T3 BLAS GEMM, so the products are accumulated in
+    /// the precision of the result without converting the whole arguments.
+    template <typename S1, typename T1, typename T2, typename S2, typename T3,
+        typename std::enable_if<is_mixed_precision_gemm<T1, T2, T3>::value>::type* = nullptr>
+    inline void gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const S1 alpha, const T1* a, const integer lda,
+        const T2* b, const integer ldb, const S2 beta, T3* c, const integer ldc)
+    {
+      if((m == 0) || (n == 0))
+        return;
+      if(k == 0) {
+        // Only scale the result
+        for(integer i = 0; i < m; ++i)
+          for(integer j = 0; j < n; ++j)
+            c[i * ldc + j] = (beta != static_cast<S2>(0) ? T3(beta) * c[i * ldc + j] : T3(0));
+        return;
+      }
+
+      static thread_local std::vector<T3> buffer;
+
+      // Select the panel size such that both panels fit in the buffer
+      const integer panel = std::max<integer>(1,
+          std::min<integer>(k, mixed_gemm_buffer_size() / (m + n)));
+      if(buffer.size() < std::size_t((m + n) * panel))
+        buffer.resize((m + n) * panel);
+      T3* MADNESS_RESTRICT const a_panel = buffer.data();
+      T3* MADNESS_RESTRICT const b_panel = a_panel + m * panel;
+
+      const T3 alpha3 = alpha;
+      T3 beta3 = beta;
+      for(integer k0 = 0; k0 < k; k0 += panel) {
+        const integer kb = std::min(panel, k - k0);
+
+        // Convert a panel of op(a) and op(b), preserving their layout
+        const integer ld_a = (op_a == madness::cblas::NoTrans ? kb : m);
+        if(op_a == madness::cblas::NoTrans) {
+          for(integer i = 0; i < m; ++i)
+            for(integer p = 0; p < kb; ++p)
+              a_panel[i * kb + p] = a[i * lda + k0 + p];
+        } else {
+          for(integer p = 0; p < kb; ++p)
+            for(integer i = 0; i < m; ++i)
+              a_panel[p * m + i] = a[(k0 + p) * lda + i];
+        }
+        const integer ld_b = (op_b == madness::cblas::NoTrans ? n : kb);
+        if(op_b == madness::cblas::NoTrans) {
+          for(integer p = 0; p < kb; ++p)
+            for(integer j = 0; j < n; ++j)
+              b_panel[p * n + j] = b[(k0 + p) * ldb + j];
+        } else {
+          for(integer j = 0; j < n; ++j)
+            for(integer p = 0; p < kb; ++p)
+              b_panel[j * kb + p] = b[j * ldb + k0 + p];
+        }
+
+        gemm(op_a, op_b, m, n, kb, alpha3, a_panel, ld_a, b_panel, ld_b,
+            beta3, c, ldc);
+        beta3 = T3(1);
+      }
+    }
+
+    /// The number of rows of the blocks of \c syrk()
+    constexpr integer syrk_block_size() { return 64; }
+
+    /// Symmetric product of a matrix with its transpose
+
+    /// Computes <tt>c = alpha * op(a) * op(a)^T + beta * c</tt> , where
+    /// <tt>op(a)</tt> is an \c n by \c k matrix, so the product is a
+    /// symmetric \c n by \c n matrix. The rows of the product are split
+    /// into blocks of about \c syrk_block_size() rows; the blocks on and
+    /// above the diagonal are computed by GEMM, and the blocks below the
+    /// diagonal are the transposes of those above, which almost halves the
+    /// flops of a single GEMM. \c c need not be symmetric.
+    /// \param op_a \c NoTrans if \c a is an \c n by \c k matrix, or \c Trans
+    /// if \c a is a \c k by \c n matrix
+    /// \param n The number of rows and columns of the product
+    /// \param k The number of columns of <tt>op(a)</tt>
+    /// \param alpha The scaling factor of the product
+    /// \param a The elements of the row-major matrix \c a
+    /// \param lda The leading dimension of \c a
+    /// \param beta The scaling factor of \c c
+    /// \param c The elements of the row-major matrix \c c
+    /// \param ldc The leading dimension of \c c
+    template <typename S1, typename T1, typename S2, typename T3>
+    inline void syrk(madness::cblas::CBLAS_TRANSPOSE op_a, const integer n,
+        const integer k, const S1 alpha, const T1* a, const integer lda,
+        const S2 beta, T3* c, const integer ldc)
+    {
+      const madness::cblas::CBLAS_TRANSPOSE op_b =
+          (op_a == madness::cblas::NoTrans ? madness::cblas::Trans : madness::cblas::NoTrans);
+      const integer blocks = n / syrk_block_size();
+      if(blocks < 2) {
+        gemm(op_a, op_b, n, n, k, alpha, a, lda, a, lda, beta, c, ldc);
+        return;
+      }
+      const integer nb = (n + blocks - 1) / blocks;
+
+      // The first element of row i of op(a)
+      auto row = [=] (const integer i) {
+        return (op_a == madness::cblas::NoTrans ? a + i * lda : a + i);
+      };
+
+      static thread_local std::vector<T3> buffer;
+      if(buffer.size() < std::size_t(nb * nb))
+        buffer.resize(nb * nb);
+      T3* MADNESS_RESTRICT const block = buffer.data();
+
+      for(integer i = 0; i < n; i += nb) {
+        const integer mi = std::min(nb, n - i);
+        gemm(op_a, op_b, mi, mi, k, alpha, row(i), lda, row(i), lda, beta,
+            c + i * ldc + i, ldc);
+        for(integer j = i + nb; j < n; j += nb) {
+          const integer nj = std::min(nb, n - j);
+          gemm(op_a, op_b, mi, nj, k, alpha, row(i), lda, row(j), lda, T3(0),
+              block, nj);
+          for(integer r = 0; r < mi; ++r) {
+            for(integer q = 0; q < nj; ++q) {
+              T3& upper = c[(i + r) * ldc + j + q];
+              T3& lower = c[(j + q) * ldc + i + r];
+              if(beta == S2(0)) {
+                upper = block[r * nj + q];
+                lower = block[r * nj + q];
+              } else {
+                upper = T3(beta) * upper + block[r * nj + q];
+                lower = T3(beta) * lower + block[r * nj + q];
+              }
+            }
+          }
+        }
+      }
+    }
+
 
     // BLAS _SCAL wrapper functions
 
@@ -0,0 +1,201 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  blas_threads.h
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_BLAS_THREADS_H__INCLUDED
+#define TILEDARRAY_MATH_BLAS_THREADS_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <madness/tensor/cblas.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#ifdef HAVE_INTEL_MKL
+#include <mkl_service.h>
+#endif // HAVE_INTEL_MKL
+
+namespace TiledArray {
+
+  /// Policies for the threads of BLAS calls made by tile tasks
+  enum class BlasThreadPolicy {
+    unmanaged, ///< BLAS uses its own thread count
+    single,    ///< Every call is single-threaded
+    adaptive   ///< Calls use idle cores of the shared budget (see \c math::BlasThreads )
+  };
+
+  namespace math {
+
+    /// Thread budget of the BLAS calls of a process
+
+    /// Tile GEMMs run inside MADNESS tasks, so a threaded BLAS that uses all
+    /// cores in every call oversubscribes them when all workers are busy,
+    /// while a single-threaded BLAS leaves cores idle when few large tiles
+    /// remain (e.g. in the last steps of SUMMA). With the \c adaptive
+    /// policy each call uses one thread, plus the cores of the budget (the
+    /// number of MADNESS threads) that are neither used by other BLAS calls
+    /// nor needed by the queued tasks, when its flops are large enough to
+    /// keep them busy ( \c min_flops_per_thread() ). The policy is
+    /// selected with \c set_blas_thread_policy() , or with the
+    /// \c TA_BLAS_THREADS environment variable (\c unmanaged , \c single ,
+    /// or \c adaptive ). The thread count is only set for BLAS libraries
+    /// with a per-thread setting, i.e. MKL; otherwise BLAS is unmanaged.
+    class BlasThreads {
+      static std::atomic<int>& policy_flag() {
+        static std::atomic<int> policy(int(init_policy()));
+        return policy;
+      }
+
+      static BlasThreadPolicy init_policy() {
+        const char* env = getenv("TA_BLAS_THREADS");
+        if(env) {
+          if(std::strcmp(env, "unmanaged") == 0)
+            return BlasThreadPolicy::unmanaged;
+          if(std::strcmp(env, "single") == 0)
+            return BlasThreadPolicy::single;
+        }
+        return BlasThreadPolicy::adaptive;
+      }
+
+      static std::atomic<double>& min_flops() {
+        static std::atomic<double> flops(1.0e7);
+        return flops;
+      }
+
+    public:
+
+      /// \return The threads used by the BLAS calls in progress
+      static std::atomic<int>& in_use() {
+        static std::atomic<int> threads(0);
+        return threads;
+      }
+
+      /// \return The policy
+      static BlasThreadPolicy policy() {
+        return BlasThreadPolicy(policy_flag().load(std::memory_order_relaxed));
+      }
+
+      /// Set the policy
+      static void policy(const BlasThreadPolicy p) {
+        policy_flag().store(int(p), std::memory_order_relaxed);
+      }
+
+      /// \return The smallest number of flops per thread of a call
+      static double min_flops_per_thread() {
+        return min_flops().load(std::memory_order_relaxed);
+      }
+
+      /// Set the smallest number of flops per thread of a call
+      static void min_flops_per_thread(const double flops) {
+        min_flops().store(flops, std::memory_order_relaxed);
+      }
+
+      /// \return The number of threads shared by the BLAS calls
+      static int budget() {
+        return std::max<int>(madness::ThreadPool::size(), 1);
+      }
+
+      /// Number of threads of a call
+
+      /// \param flops The flops of the call
+      /// \param in_use The threads used by the other calls
+      /// \param queued The number of queued tasks
+      /// \return The number of threads of the call
+      static int threads(const double flops, const int in_use,
+          const std::size_t queued)
+      {
+        if(policy() != BlasThreadPolicy::adaptive)
+          return 1;
+        // The idle cores include the core of the calling task
+        const int idle = budget() - in_use - int(std::min<std::size_t>(queued,
+            std::size_t(budget())));
+        const double useful = std::min(flops / min_flops_per_thread(), double(budget()));
+        return std::max(1, std::min(idle, int(useful)));
+      }
+
+    }; // class BlasThreads
+
+    /// Set the BLAS thread count of a call
+
+    /// The scope reserves the threads of a BLAS call in the budget of
+    /// \c BlasThreads , and sets the BLAS thread count of the calling thread
+    /// until it is destroyed.
+    class BlasThreadScope {
+      int threads_ = 0; ///< The reserved threads, or 0 if unmanaged
+#ifdef HAVE_INTEL_MKL
+      int previous_ = 0; ///< The previous thread-local MKL thread count
+#endif // HAVE_INTEL_MKL
+
+    public:
+      BlasThreadScope(const BlasThreadScope&) = delete;
+      BlasThreadScope& operator=(const BlasThreadScope&) = delete;
+
+      /// Constructor
+
+      /// \param m The rows of the product
+      /// \param n The columns of the product
+      /// \param k The inner dimension of the product
+      BlasThreadScope(const integer m, const integer n, const integer k) {
+#ifdef HAVE_INTEL_MKL
+        if(BlasThreads::policy() == BlasThreadPolicy::unmanaged)
+          return;
+        const double flops = 2.0 * double(m) * double(n) * double(k);
+        std::atomic<int>& in_use = BlasThreads::in_use();
+        int used = in_use.load(std::memory_order_relaxed);
+        do {
+          threads_ = BlasThreads::threads(flops, used,
+              madness::ThreadPool::queue_size());
+        } while(! in_use.compare_exchange_weak(used, used + threads_,
+            std::memory_order_relaxed));
+        previous_ = mkl_set_num_threads_local(threads_);
+#endif // HAVE_INTEL_MKL
+      }
+
+      ~BlasThreadScope() {
+#ifdef HAVE_INTEL_MKL
+        if(threads_) {
+          mkl_set_num_threads_local(previous_);
+          BlasThreads::in_use().fetch_sub(threads_, std::memory_order_relaxed);
+        }
+#endif // HAVE_INTEL_MKL
+      }
+
+      /// \return The threads of the call, or 0 if the count is not managed
+      int threads() const { return threads_; }
+
+    }; // class BlasThreadScope
+
+  } // namespace math
+
+  /// Set the policy for the threads of the BLAS calls of tile tasks
+
+  /// \param policy The policy
+  /// \param min_flops_per_thread The smallest number of flops per thread of
+  /// a multithreaded call [ default = 1e7 ]
+  inline void set_blas_thread_policy(const BlasThreadPolicy policy,
+      const double min_flops_per_thread = 1.0e7)
+  {
+    math::BlasThreads::policy(policy);
+    math::BlasThreads::min_flops_per_thread(min_flops_per_thread);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_BLAS_THREADS_H__INCLUDED
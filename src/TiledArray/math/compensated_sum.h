@@ -0,0 +1,137 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_COMPENSATED_SUM_H__INCLUDED
+#define TILEDARRAY_MATH_COMPENSATED_SUM_H__INCLUDED
+
+#include <ostream>
+
+namespace TiledArray {
+  namespace math {
+
+    /// Error-free sum of two values
+
+    /// Computes <tt>sum = fl(a + b)</tt> and the rounding error \c err , so
+    /// that <tt>a + b == sum + err</tt> exactly (Knuth's TwoSum). It has no
+    /// branches, so loops that use it are vectorized.
+    /// \note The error is lost if the compiler is allowed to reassociate
+    /// floating-point arithmetic (e.g. with \c -ffast-math ).
+    /// \tparam T The value type
+    /// \param[in] a The first value
+    /// \param[in] b The second value
+    /// \param[out] sum The rounded sum
+    /// \param[out] err The rounding error of \c sum
+    template <typename T>
+    inline void two_sum(const T a, const T b, T& sum, T& err) {
+      sum = a + b;
+      const T b_virtual = sum - a;
+      err = (a - (sum - b_virtual)) + (b - b_virtual);
+    }
+
+    /// Compensated sum
+
+    /// Accumulates a sum with an additional correction term that holds the
+    /// rounding error of the sum. The correction is added to the next term,
+    /// as in Kahan summation, so the error of the result does not grow with
+    /// the number of terms. This is the result type of the compensated
+    /// reductions, e.g. \c Tensor::compensated_squared_norm() and
+    /// \c CompensatedSquaredNormReduction .
+    /// \tparam T The value type
+    template <typename T>
+    class CompensatedSum {
+    public:
+      typedef T value_type; ///< The value type
+
+    private:
+      T sum_; ///< The rounded sum
+      T correction_; ///< The accumulated rounding errors of \c sum_
+
+    public:
+
+      CompensatedSum() : sum_(0), correction_(0) { }
+
+      /// Construct a sum from a value
+
+      /// \param value The initial value
+      CompensatedSum(const T value) : sum_(value), correction_(0) { }
+
+      /// Construct a sum from a rounded sum and its error
+
+      /// \param sum The rounded sum
+      /// \param correction The error of \c sum
+      CompensatedSum(const T sum, const T correction) :
+        sum_(sum), correction_(correction)
+      { }
+
+      /// Add a term
+
+      /// \param value The term to be added
+      /// \return A reference to this object
+      CompensatedSum& operator+=(const T value) {
+        two_sum(sum_, value + correction_, sum_, correction_);
+        return *this;
+      }
+
+      /// Join another sum
+
+      /// \param other The sum to be added
+      /// \return A reference to this object
+      CompensatedSum& operator+=(const CompensatedSum& other) {
+        T err;
+        two_sum(sum_, other.sum_, sum_, err);
+        correction_ += err + other.correction_;
+        return *this;
+      }
+
+      /// Value accessor
+
+      /// \return The compensated value of the sum
+      T value() const { return sum_ + correction_; }
+
+      /// Conversion to the value type
+
+      /// \return The compensated value of the sum
+      operator T() const { return value(); }
+
+      /// Rounded sum accessor
+
+      /// \return The sum without the correction
+      const T& sum() const { return sum_; }
+
+      /// Correction accessor
+
+      /// \return The accumulated rounding errors of \c sum()
+      const T& correction() const { return correction_; }
+
+      template <typename Archive>
+      void serialize(Archive& ar) { ar & sum_ & correction_; }
+
+    }; // class CompensatedSum
+
+    template <typename T>
+    inline std::ostream& operator<<(std::ostream& os, const CompensatedSum<T>& s)
+    {
+      os << s.value();
+      return os;
+    }
+
+  } // namespace math
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_COMPENSATED_SUM_H__INCLUDED
@@ -272,6 +272,28 @@ namespace TiledArray {
 
       madness::cblas::CBLAS_TRANSPOSE left_op() const { return left_op_; }
       madness::cblas::CBLAS_TRANSPOSE right_op() const { return right_op_; }
+
+      /// Transposed product helper
+
+      /// The transpose of the product, \f$ (A B)^T = B^T A^T \f$, is
+      /// evaluated by swapping the arguments and their transpose operations.
+      /// The outer dimensions of the right-hand argument then come first in
+      /// the result.
+      /// \return The gemm helper of the transposed product, where the
+      /// right-hand argument of this product is the left-hand argument
+      GemmHelper transposed() const {
+        return GemmHelper(flip(right_op_), flip(left_op_), result_rank_,
+            right_.rank, left_.rank);
+      }
+
+    private:
+
+      static madness::cblas::CBLAS_TRANSPOSE
+      flip(const madness::cblas::CBLAS_TRANSPOSE op) {
+        return (op == madness::cblas::NoTrans ? madness::cblas::Trans :
+            madness::cblas::NoTrans);
+      }
+
     }; // class GemmHelper
 
   }  // namespace math
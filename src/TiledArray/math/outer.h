@@ -164,7 +164,7 @@ namespace TiledArray {
     typedef OuterVectorOpUnwind<TILEDARRAY_LOOP_UNWIND - 1> OuterVectorOpUnwindN;
 
 
-    /// Compute and store outer of \c x and \c y in \c a
+    /// Compute and store outer of \c x and \c y in \c a with one thread
 
     /// <tt>a[i][j] = op(x[i], y[j])</tt>.
     /// \tparam X The left-hand vector element type
@@ -177,7 +177,7 @@ namespace TiledArray {
     /// \param[out] a The result matrix of size \c m*n
     /// \param[in] op The operation that will compute the outer product elements
     template <typename X, typename Y, typename A, typename Op>
-    void outer_fill(const std::size_t m, const std::size_t n,
+    void outer_fill_serial(const std::size_t m, const std::size_t n,
         const X* const x, const Y* const y, A* a, const Op& op)
     {
       std::size_t i = 0ul;
@@ -230,7 +230,7 @@ namespace TiledArray {
       }
     }
 
-    /// Compute the outer of \c x and \c y to modify \c a
+    /// Compute the outer of \c x and \c y to modify \c a with one thread
 
     /// Compute <tt>op(a[i][j], x[i], y[j])</tt> for each \c i and \c j pair,
     /// where \c a[i][j] is modified by \c op.
@@ -245,7 +245,7 @@ namespace TiledArray {
     /// \param[in,out] a The result matrix of size \c m*n
     /// \param[in] op The operation used to generate the result
     template <typename X, typename Y, typename A, typename Op>
-    void outer(const std::size_t m, const std::size_t n,
+    void outer_serial(const std::size_t m, const std::size_t n,
         const X* const x, const Y* const y, A* a, const Op& op)
     {
       std::size_t i = 0ul;
@@ -303,7 +303,7 @@ namespace TiledArray {
     }
 
 
-    /// Compute the outer of \c x, \c y, and \c a, and store the result in \c b
+    /// Compute the outer of \c x, \c y, and \c a, and store the result in \c b with one thread
 
     /// Store a modified copy of \c a in \c b, where modified elements are
     /// generated using the following algorithm:
@@ -326,7 +326,7 @@ namespace TiledArray {
     /// \param[out] b The output matrix of size \c m*n
     /// \param[in] op The operation that will compute the outer product elements
     template <typename X, typename Y, typename A, typename B, typename Op>
-    void outer_fill(const std::size_t m, const std::size_t n,
+    void outer_fill_serial(const std::size_t m, const std::size_t n,
         const X* MADNESS_RESTRICT const x, const Y* MADNESS_RESTRICT const y,
         const A* MADNESS_RESTRICT a, B* MADNESS_RESTRICT b, const Op& op)
     {
@@ -411,6 +411,165 @@ namespace TiledArray {
       }
     }
 
+    /// Vectorized outer product fill
+
+    /// <tt>a[i][j] = op(x[i], y[j])</tt>, where each row is computed with a
+    /// loop that the compiler vectorizes. This is used for arithmetic element
+    /// types.
+    template <typename X, typename Y, typename A, typename Op>
+    TILEDARRAY_SIMD_DISPATCH void
+    outer_fill_simd(const std::size_t m, const std::size_t n,
+        const X* MADNESS_RESTRICT const x, const Y* MADNESS_RESTRICT const y,
+        A* MADNESS_RESTRICT const a, const Op& op)
+    {
+      for(std::size_t i = 0ul; i < m; ++i) {
+        const X x_i = x[i];
+        A* MADNESS_RESTRICT const a_i = a + (i * n);
+        TILEDARRAY_PRAGMA_SIMD
+        for(std::size_t j = 0ul; j < n; ++j)
+          a_i[j] = op(x_i, y[j]);
+      }
+    }
+
+    /// Vectorized outer product update
+
+    /// <tt>op(a[i][j], x[i], y[j])</tt>.
+    template <typename X, typename Y, typename A, typename Op>
+    TILEDARRAY_SIMD_DISPATCH void
+    outer_simd(const std::size_t m, const std::size_t n,
+        const X* MADNESS_RESTRICT const x, const Y* MADNESS_RESTRICT const y,
+        A* MADNESS_RESTRICT const a, const Op& op)
+    {
+      for(std::size_t i = 0ul; i < m; ++i) {
+        const X x_i = x[i];
+        A* MADNESS_RESTRICT const a_i = a + (i * n);
+        TILEDARRAY_PRAGMA_SIMD
+        for(std::size_t j = 0ul; j < n; ++j)
+          op(a_i[j], x_i, y[j]);
+      }
+    }
+
+    /// Vectorized outer product of a copy
+
+    /// <tt>b[i][j] = a[i][j]</tt> modified by <tt>op(b[i][j], x[i], y[j])</tt>.
+    template <typename X, typename Y, typename A, typename B, typename Op>
+    TILEDARRAY_SIMD_DISPATCH void
+    outer_fill_simd(const std::size_t m, const std::size_t n,
+        const X* MADNESS_RESTRICT const x, const Y* MADNESS_RESTRICT const y,
+        const A* MADNESS_RESTRICT const a, B* MADNESS_RESTRICT const b, const Op& op)
+    {
+      for(std::size_t i = 0ul; i < m; ++i) {
+        const X x_i = x[i];
+        const A* MADNESS_RESTRICT const a_i = a + (i * n);
+        B* MADNESS_RESTRICT const b_i = b + (i * n);
+        TILEDARRAY_PRAGMA_SIMD
+        for(std::size_t j = 0ul; j < n; ++j) {
+          A a_ij = a_i[j];
+          op(a_ij, x_i, y[j]);
+          b_i[j] = a_ij;
+        }
+      }
+    }
+
+    /// Compute and store outer of \c x and \c y in \c a
+
+    /// <tt>a[i][j] = op(x[i], y[j])</tt>. Arithmetic element types are
+    /// computed with vectorized loops over the rows; matrices with at least
+    /// \c parallel_matrix_min_size elements are split into blocks of rows,
+    /// which are computed by separate threads.
+    /// \tparam X The left-hand vector element type
+    /// \tparam Y The right-hand vector element type
+    /// \tparam A The a matrix element type
+    /// \param[in] m The size of the left-hand vector
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] x The left-hand vector
+    /// \param[in] y The right-hand vector
+    /// \param[out] a The result matrix of size \c m*n
+    /// \param[in] op The operation that will compute the outer product elements
+    template <typename X, typename Y, typename A, typename Op>
+    void outer_fill(const std::size_t m, const std::size_t n,
+        const X* const x, const Y* const y, A* a, const Op& op)
+    {
+      for_each_block_range(m, (m * n) >= parallel_matrix_min_size,
+          [=,&op] (const std::size_t first, const std::size_t last) {
+            if(is_simd_vectorizable<X, Y, A>::value)
+              outer_fill_simd(last - first, n, x + first, y, a + (first * n), op);
+            else
+              outer_fill_serial(last - first, n, x + first, y, a + (first * n), op);
+          });
+    }
+
+    /// Compute the outer of \c x and \c y to modify \c a
+
+    /// Compute <tt>op(a[i][j], x[i], y[j])</tt> for each \c i and \c j pair,
+    /// where \c a[i][j] is modified by \c op. Arithmetic element types are
+    /// computed with vectorized loops over the rows; matrices with at least
+    /// \c parallel_matrix_min_size elements are split into blocks of rows,
+    /// which are computed by separate threads.
+    /// \tparam X The left hand vector element type
+    /// \tparam Y The right-hand vector element type
+    /// \tparam A The a matrix element type
+    /// \tparam Op The operation that will compute outer product elements
+    /// \param[in] m The size of the left-hand vector
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] x The left-hand vector
+    /// \param[in] y The right-hand vector
+    /// \param[in,out] a The result matrix of size \c m*n
+    /// \param[in] op The operation used to generate the result
+    template <typename X, typename Y, typename A, typename Op>
+    void outer(const std::size_t m, const std::size_t n,
+        const X* const x, const Y* const y, A* a, const Op& op)
+    {
+      for_each_block_range(m, (m * n) >= parallel_matrix_min_size,
+          [=,&op] (const std::size_t first, const std::size_t last) {
+            if(is_simd_vectorizable<X, Y, A>::value)
+              outer_simd(last - first, n, x + first, y, a + (first * n), op);
+            else
+              outer_serial(last - first, n, x + first, y, a + (first * n), op);
+          });
+    }
+
+    /// Compute the outer of \c x, \c y, and \c a, and store the result in \c b
+
+    /// Store a modified copy of \c a in \c b, where modified elements are
+    /// generated using the following algorithm:
+    /// \code
+    /// A temp = a[i][j];
+    /// op(temp, x[i], y[j]);
+    /// b[i][j] = temp;
+    /// \endcode
+    /// for each unique pair of \c i and \c j. Arithmetic element types are
+    /// computed with vectorized loops over the rows; matrices with at least
+    /// \c parallel_matrix_min_size elements are split into blocks of rows,
+    /// which are computed by separate threads.
+    /// \tparam X The left hand vector element type
+    /// \tparam Y The right-hand vector element type
+    /// \tparam A The a matrix element type
+    /// \tparam B The b matrix element type
+    /// \tparam Op The operation that will compute outer product elements
+    /// \param[in] m The size of the left-hand vector
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] x The left-hand vector
+    /// \param[in] y The right-hand vector
+    /// \param[in] a The input matrix of size \c m*n
+    /// \param[out] b The output matrix of size \c m*n
+    /// \param[in] op The operation that will compute the outer product elements
+    template <typename X, typename Y, typename A, typename B, typename Op>
+    void outer_fill(const std::size_t m, const std::size_t n,
+        const X* MADNESS_RESTRICT const x, const Y* MADNESS_RESTRICT const y,
+        const A* MADNESS_RESTRICT a, B* MADNESS_RESTRICT b, const Op& op)
+    {
+      for_each_block_range(m, (m * n) >= parallel_matrix_min_size,
+          [=,&op] (const std::size_t first, const std::size_t last) {
+            if(is_simd_vectorizable<X, Y, A, B>::value)
+              outer_fill_simd(last - first, n, x + first, y, a + (first * n),
+                  b + (first * n), op);
+            else
+              outer_fill_serial(last - first, n, x + first, y, a + (first * n),
+                  b + (first * n), op);
+          });
+    }
+
   } // namespace math
 } // namespace TiledArray
 
@@ -27,143 +27,230 @@
 #define TILEDARRAY_PARALLEL_GEMM_H__INCLUDED
 
 #include <TiledArray/madness.h>
-#include <TiledArray/vector_op.h>
-#include <TiledArray/blas.h>
-
-#define TILEDARRAY_DYNAMIC_BLOCK_SIZE std::numeric_limits<std::size_t>::max();
+#include <TiledArray/math/blas.h>
+#include <TiledArray/math/blas_threads.h>
+#include <TiledArray/tensor/complex.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <type_traits>
 
 namespace TiledArray {
-  namespace math {
-
-//#ifdef HAVE_INTEL_TBB
-
-
-    template <typename T, integer Size>
-    class MatrixBlockTask : public tbb::task {
-
-      const integer rows_;
-      const integer cols_;
-      T* data_;
-      const integer ld_;
-      std::shared_ptr<T> result_;
-
-      /// Copy a \c Size^2 block from \c data to \c result
-
-      /// \param[out] result A pointer to the first element of the result block
-      /// \param[in] data A pointer to the first element of the block to be copied
-      /// \param[in] ld The leading dimension stride for the \c data block
-      void copy_block(T* result, const T* data, const integer ld) {
-        const T* const block_end = result + (TILEDARRAY_LOOP_UNWIND * Size);
-        for(; result < block_end; result += Size, data += ld)
-          TiledArray::math::copy_block(result, data);
+  namespace detail {
+
+    /// Squared Frobenius norm of a row-major matrix
+
+    /// \param m The number of rows
+    /// \param n The number of columns
+    /// \param c The matrix elements
+    /// \param ldc The leading dimension of \c c
+    /// \return The squared norm of \c c
+    template <typename T>
+    inline typename scalar_type<T>::type
+    matrix_squared_norm(const integer m, const integer n, const T* const c,
+        const integer ldc)
+    {
+      typename scalar_type<T>::type result(0);
+      for(integer i = 0; i < m; ++i) {
+        const T* MADNESS_RESTRICT const row = c + i * ldc;
+        for(integer j = 0; j < n; ++j)
+          result += norm(row[j]);
       }
-
-      /// Copy a rectangular \c m*n block from \c data to \c result
-
-      /// \param[in] m The number of rows to copy
-      /// \param[in] n The number of columns to copy
-      /// \param[out] result A pointer to the first element of the result block
-      /// \param[in] data A pointer to the first element of the block to be copied
-      /// \param[in] ld The leading dimension stride for the \c data block
-      void copy_block(const integer m, const integer n, T* result,
-          const T* data, const integer ld)
-      {
-        const T* const block_end = result + (m * Size);
-        for(; result < block_end; result += Size, data += ld)
-          TiledArray::math::copy_block(n, result, data);
+      return result;
+    }
+
+    /// The blocks of a parallel GEMM
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    struct ParallelGemmBlocks {
+      madness::cblas::CBLAS_TRANSPOSE op_a, op_b;
+      integer m, n, k;
+      S1 alpha;
+      const T1* a;
+      integer lda;
+      const T2* b;
+      integer ldb;
+      S2 beta;
+      T3* c;
+      integer ldc;
+      integer block_rows; ///< The number of blocks of rows
+      integer block_cols; ///< The number of blocks of columns
+      std::unique_ptr<typename scalar_type<T3>::type[]> norms; ///< The squared norms of the blocks, or null
+      std::atomic<integer> next; ///< The next block to be computed
+      std::atomic<integer> done; ///< The number of computed blocks
+
+      /// Compute the blocks that are not taken by other threads
+      void run() {
+        const integer nblocks = block_rows * block_cols;
+        for(integer block = next++; block < nblocks; block = next++) {
+          const integer bi = block / block_cols, bj = block % block_cols;
+          const integer i0 = m * bi / block_rows, i1 = m * (bi + 1) / block_rows;
+          const integer j0 = n * bj / block_cols, j1 = n * (bj + 1) / block_cols;
+          // Matrices are row-major; transposed arguments store the rows of
+          // op(a) and the columns of op(b) as columns.
+          const T1* const a_block = (op_a == madness::cblas::NoTrans ? a + i0 * lda : a + i0);
+          const T2* const b_block = (op_b == madness::cblas::NoTrans ? b + j0 : b + j0 * ldb);
+          T3* const c_block = c + i0 * ldc + j0;
+          math::gemm(op_a, op_b, i1 - i0, j1 - j0, k, alpha, a_block, lda,
+              b_block, ldb, beta, c_block, ldc);
+          // The block was just written, so its norm is computed from cache
+          if(norms)
+            norms[block] = matrix_squared_norm(i1 - i0, j1 - j0, c_block, ldc);
+          ++done;
+        }
       }
+    }; // struct ParallelGemmBlocks
+
+    /// Helper task of a parallel GEMM
+    template <typename Blocks>
+    class ParallelGemmTask : public madness::PoolTaskInterface {
+      std::shared_ptr<Blocks> blocks_; ///< The blocks of the product
 
     public:
-      MatrixBlockTask(const integer rows, const integer cols,
-          const T* const data, const integer ld) :
-        rows_(rows), cols_(cols), data_(data), ld_(ld)
+      ParallelGemmTask(const std::shared_ptr<Blocks>& blocks) :
+        madness::PoolTaskInterface(madness::TaskAttributes::hipri()),
+        blocks_(blocks)
       { }
 
-      /// Task body
-      virtual tbb::task* execut() {
-
-        // Compute block iteration limit
-        constexpr integer index_mask = ~integer(TILEDARRAY_LOOP_UNWIND - 1ul);
-        const integer mx = rows_ & index_mask; // = rows - rows % TILEDARRAY_LOOP_UNWIND
-        const integer nx = cols_ & index_mask; // = cols - cols % TILEDARRAY_LOOP_UNWIND
-        const integer m_tail = rows_ - mx;
-        const integer n_tail = cols_ - nx;
-
-        // Copy data into block_
-        integer i = 0ul;
-        T* result_i = result_.get();
-        const T* data_i = data_;
-        for(; i < mx; i += TILEDARRAY_LOOP_UNWIND, result_i += Size, data_i += ld_) {
-
-          integer j = 0ul;
-          for(; j < nx; j += TILEDARRAY_LOOP_UNWIND)
-            copy_block(result_i + j, data_i + j);
-
-          if(n_tail)
-            copy_block(TILEDARRAY_LOOP_UNWIND, n_tail, result_i + j, data_i + j);
-        }
-
-        if(m_tail) {
-
-          integer j = 0ul;
-          for(; j < nx; j += TILEDARRAY_LOOP_UNWIND)
-            copy_block(m_tail, TILEDARRAY_LOOP_UNWIND, result_i + j, data_i + j);
+      virtual void run(const madness::TaskThreadEnv&) { blocks_->run(); }
+    }; // class ParallelGemmTask
 
-          if(n_tail)
-            copy_block(m_tail, n_tail, result_i + j, data_i + j);
+  } // namespace detail
 
-        }
+  namespace math {
 
-        return nullptr;
+    /// Intra-tile parallel GEMM
+
+    /// A product whose working set (the arguments and the result) exceeds
+    /// the cache budget of a core is split into a grid of blocks of the
+    /// result, about two per thread, which are computed by the calling
+    /// thread and by helper tasks on the MADNESS thread pool. The threads
+    /// are taken from the budget of \c BlasThreads , so a product only runs
+    /// in parallel when cores are idle, e.g. when a few huge tiles are left
+    /// at the end of a contraction; otherwise it is a single BLAS call.
+    /// Blocks only split the rows and columns of the result, so they do not
+    /// share data that is written. With MKL, whose threads are set per call,
+    /// BLAS parallelizes the product instead (see \c BlasThreadScope ).
+    class ParallelGemm {
+      static std::atomic<std::size_t>& cache() {
+        static std::atomic<std::size_t> bytes(1ul << 20);
+        return bytes;
       }
 
-      std::shared_ptr<T> result() {
-        constexpr integer size = Size * Size;
-        constexpr integer bytes = size * sizeof(T);
-
-        T* result_ptr = nullptr;
-        if(! posix_memalign(result_ptr, TILEARRAY_ALIGNMENT, bytes))
-          throw std::bad_alloc();
+    public:
 
-        result_.reset(result_ptr);
+      /// \return The cache budget of a core, in bytes
+      static std::size_t cache_bytes() { return cache().load(std::memory_order_relaxed); }
 
-        return result_;
+      /// Set the cache budget of a core, in bytes
+      static void cache_bytes(const std::size_t bytes) {
+        cache().store(bytes, std::memory_order_relaxed);
       }
 
-    }; // class MatrixBlockTask
-
-
-    template <integer Size, typename C, typename A = C, typename B = C, typename Alpha = C, typename Beta = C>
-    class GemmTask : public tbb::task {
-      const madness::cblas::CBLAS_TRANSPOSE op_a_, op_b_;
-      const integer m_, n_, k_;
-      const Alpha alpha_;
-      std::shared_ptr<A> a_;
-      constexpr integer lda_ = Size;
-      std::shared_ptr<B> b_;
-      const Beta beta_;
-      std::shared_ptr<C> c_;
-      const integer ldc_;
+      /// Number of threads of a product
 
-    public:
-
-
-      GemmTask(madness::cblas::CBLAS_TRANSPOSE op_a,
-          madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
-          const integer k, const Alpha alpha, const std::shared_ptr<A>& a,
-          const std::shared_ptr<B>& b, const Beta beta,
-          const std::shared_ptr<C>& c, const integer ldc) :
-            op_a_(op_a), op_b_(op_b), m_(m), n_(n), k_(k), alpha_(alpha), a_(a),
-            b_(b), beta_(beta), c_(c), ldc_(c)
-      { }
-
-      virtual tbb::task execute() {
-        gemm(op_a_, op_b_, m_, n_, k_, alpha_, a_.get(), Size, b_.get(), Size, c_, ldc_);
+      /// \param m The rows of the product
+      /// \param n The columns of the product
+      /// \param k The inner dimension of the product
+      /// \param element_size The size of an element, in bytes
+      /// \return The number of threads used for the product
+      static int threads(const integer m, const integer n, const integer k,
+          const std::size_t element_size)
+      {
+#ifdef HAVE_INTEL_MKL
+        // BLAS is multithreaded per call (see BlasThreadScope)
+        return 1;
+#endif // HAVE_INTEL_MKL
+        if(BlasThreads::policy() != BlasThreadPolicy::adaptive)
+          return 1;
+        const double bytes = (double(m) * double(k) + double(k) * double(n) +
+            double(m) * double(n)) * double(element_size);
+        if(bytes <= double(cache_bytes()))
+          return 1;
+        const int threads = BlasThreads::threads(2.0 * double(m) * double(n) * double(k),
+            BlasThreads::in_use().load(std::memory_order_relaxed),
+            madness::ThreadPool::queue_size());
+        return std::min<int>(threads, m * n);
       }
 
-    }; // class GemmTask
-
-//#endif // HAVE_INTEL_TBB
+    }; // class ParallelGemm
+
+    /// GEMM that splits large products among idle threads
+
+    /// Computes <tt>c = alpha * op(a) * op(b) + beta * c</tt> , as \c gemm() ,
+    /// in parallel when the product is larger than the cache budget of a
+    /// core and there are idle threads (see \c ParallelGemm ). When
+    /// \c squared_norm is given, the squared Frobenius norm of \c c is
+    /// computed block by block, right after each block of the product is
+    /// written, instead of by a separate pass over the result. The product
+    /// of a matrix with its own transpose, computed by one thread, is
+    /// evaluated by \c syrk() .
+    /// \param squared_norm The squared norm of the result \c c , or null
+    /// [ default = null ]
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    inline void parallel_gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const S1 alpha, const T1* a, const integer lda,
+        const T2* b, const integer ldb, const S2 beta, T3* c, const integer ldc,
+        typename TiledArray::detail::scalar_type<T3>::type* squared_norm = nullptr)
+    {
+      std::atomic<int>& in_use = BlasThreads::in_use();
+      const int threads = ParallelGemm::threads(m, n, k, sizeof(T3));
+      if(threads <= 1) {
+        // The product of a matrix with its own transpose is symmetric
+        if(std::is_same<T1, T2>::value && (static_cast<const void*>(a) == static_cast<const void*>(b))
+            && (m == n) && (op_a != op_b) && (lda == ldb))
+          syrk(op_a, n, k, alpha, a, lda, beta, c, ldc);
+        else
+          gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        if(squared_norm)
+          *squared_norm = TiledArray::detail::matrix_squared_norm(m, n, c, ldc);
+        return;
+      }
+      in_use.fetch_add(threads, std::memory_order_relaxed);
+
+      // Split the result into about two blocks per thread, with the aspect
+      // ratio of the result
+      typedef TiledArray::detail::ParallelGemmBlocks<S1, T1, T2, S2, T3> blocks_type;
+      std::shared_ptr<blocks_type> blocks = std::make_shared<blocks_type>();
+      const double nblocks = 2.0 * threads;
+      blocks->block_rows = std::max<integer>(1, std::min<integer>(m,
+          integer(std::lround(std::sqrt(nblocks * double(m) / double(n))))));
+      blocks->block_cols = std::max<integer>(1, std::min<integer>(n,
+          integer(std::ceil(nblocks / double(blocks->block_rows)))));
+      blocks->op_a = op_a; blocks->op_b = op_b;
+      blocks->m = m; blocks->n = n; blocks->k = k;
+      blocks->alpha = alpha; blocks->a = a; blocks->lda = lda;
+      blocks->b = b; blocks->ldb = ldb;
+      blocks->beta = beta; blocks->c = c; blocks->ldc = ldc;
+      blocks->next = 0; blocks->done = 0;
+      const integer total = blocks->block_rows * blocks->block_cols;
+      if(squared_norm)
+        blocks->norms.reset(new typename TiledArray::detail::scalar_type<T3>::type[total]);
+
+      // Helpers that start after all blocks are taken return immediately
+      for(int t = 1; t < threads; ++t)
+        madness::ThreadPool::add(new TiledArray::detail::ParallelGemmTask<blocks_type>(blocks));
+      blocks->run();
+      while(blocks->done.load() < total)
+        std::this_thread::yield();
+      if(squared_norm)
+        *squared_norm = std::accumulate(blocks->norms.get(),
+            blocks->norms.get() + total,
+            typename TiledArray::detail::scalar_type<T3>::type(0));
+
+      in_use.fetch_sub(threads, std::memory_order_relaxed);
+    }
+
+    /// Set the cache budget of a core for the parallel GEMM
+
+    /// \param bytes The data of a product, in bytes, above which it may be
+    /// split among threads [ default = 1 MiB ]
+    inline void set_parallel_gemm_cache_bytes(const std::size_t bytes) {
+      ParallelGemm::cache_bytes(bytes);
+    }
 
   }  // namespace math
 } // namespace TiledArray
@@ -187,8 +187,7 @@ namespace TiledArray {
     typedef PartialReduceUnwind<TILEDARRAY_LOOP_UNWIND - 1> PartialReduceUnwindN;
 
 
-    //TODO reduce_op
-    /// Reduce the rows of a matrix
+    /// Reduce the rows of a matrix with one thread
 
     /// <tt>op(result[i], left[i][j], right[j])</tt>.
     /// \tparam Left The left-hand matrix element type
@@ -201,7 +200,7 @@ namespace TiledArray {
     /// \param[out] result The result vector of size m
     /// \param[in] op The operation that will reduce the rows of left
     template <typename Left, typename Right, typename Result, typename Op>
-    void row_reduce(const std::size_t m, const std::size_t n,
+    void row_reduce_serial(const std::size_t m, const std::size_t n,
         const Left* MADNESS_RESTRICT const left, const Right* MADNESS_RESTRICT const right,
         Result* MADNESS_RESTRICT const result, const Op& op)
     {
@@ -259,7 +258,7 @@ namespace TiledArray {
     }
 
 
-    /// Reduce the rows of a matrix
+    /// Reduce the rows of a matrix with one thread
 
     /// <tt>op(result[i], arg[i][j])</tt>.
     /// \tparam Arg The left-hand vector element type
@@ -271,7 +270,7 @@ namespace TiledArray {
     /// \param[out] result The result vector of size m
     /// \param[in] op The operation that will reduce the rows of left
     template <typename Arg, typename Result, typename Op>
-    void row_reduce(const std::size_t m, const std::size_t n,
+    void row_reduce_serial(const std::size_t m, const std::size_t n,
         const Arg* MADNESS_RESTRICT const arg,  Result* MADNESS_RESTRICT const result, const Op& op)
     {
       std::size_t i = 0ul;
@@ -319,7 +318,7 @@ namespace TiledArray {
       }
     }
 
-    /// Reduce the columns of a matrix
+    /// Reduce the columns of a matrix with one thread
 
     /// <tt>op(result[j], left[i][j], right[i])</tt>.
     /// \tparam Left The left-hand vector element type
@@ -333,7 +332,7 @@ namespace TiledArray {
     /// \param[out] result The result vector of size n
     /// \param[in] op The operation that will reduce the columns of left
     template <typename Left, typename Right, typename Result, typename Op>
-    void col_reduce(const std::size_t m, const std::size_t n,
+    void col_reduce_serial(const std::size_t m, const std::size_t n,
         const Left* MADNESS_RESTRICT const left, const Right* MADNESS_RESTRICT const right,
         Result* MADNESS_RESTRICT const result, const Op& op)
     {
@@ -393,7 +392,7 @@ namespace TiledArray {
       }
     }
 
-    /// Reduce the columns of a matrix
+    /// Reduce the columns of a matrix with one thread
 
     /// <tt>op(result[j], arg[i][j])</tt>.
     /// \tparam Arg The argument vector element type
@@ -405,7 +404,7 @@ namespace TiledArray {
     /// \param[out] result The result vector of size n
     /// \param[in] op The operation that will reduce the columns of left
     template <typename Arg, typename Result, typename Op>
-    void col_reduce(const std::size_t m, const std::size_t n,
+    void col_reduce_serial(const std::size_t m, const std::size_t n,
         const Arg* MADNESS_RESTRICT const arg, Result* MADNESS_RESTRICT const result, const Op& op)
     {
       std::size_t i = 0ul;
@@ -456,6 +455,168 @@ namespace TiledArray {
       }
     }
 
+    /// Vectorized column reduction of a matrix block
+
+    /// <tt>op(result[j], left[i * stride + j], right[i])</tt>. The rows are
+    /// visited in order and each row is reduced with a loop that the compiler
+    /// vectorizes, since the result elements are independent. This is used
+    /// for arithmetic element types.
+    /// \param[in] m The number of rows in left
+    /// \param[in] n The number of columns of the block
+    /// \param[in] stride The row stride of left
+    /// \param[in] left An m*stride matrix
+    /// \param[in] right A vector of size m
+    /// \param[in,out] result The result vector of size n
+    /// \param[in] op The operation that will reduce the columns of left
+    template <typename Left, typename Right, typename Result, typename Op>
+    TILEDARRAY_SIMD_DISPATCH void
+    col_reduce_simd(const std::size_t m, const std::size_t n, const std::size_t stride,
+        const Left* MADNESS_RESTRICT const left, const Right* MADNESS_RESTRICT const right,
+        Result* MADNESS_RESTRICT const result, const Op& op)
+    {
+      for(std::size_t i = 0ul; i < m; ++i) {
+        const Left* MADNESS_RESTRICT const left_i = left + (i * stride);
+        const Right right_i = right[i];
+        TILEDARRAY_PRAGMA_SIMD
+        for(std::size_t j = 0ul; j < n; ++j)
+          op(result[j], left_i[j], right_i);
+      }
+    }
+
+    /// Vectorized column reduction of a matrix block
+
+    /// <tt>op(result[j], arg[i * stride + j])</tt>.
+    /// \param[in] m The number of rows in arg
+    /// \param[in] n The number of columns of the block
+    /// \param[in] stride The row stride of arg
+    /// \param[in] arg An m*stride matrix
+    /// \param[in,out] result The result vector of size n
+    /// \param[in] op The operation that will reduce the columns of arg
+    template <typename Arg, typename Result, typename Op>
+    TILEDARRAY_SIMD_DISPATCH void
+    col_reduce_simd(const std::size_t m, const std::size_t n, const std::size_t stride,
+        const Arg* MADNESS_RESTRICT const arg, Result* MADNESS_RESTRICT const result,
+        const Op& op)
+    {
+      for(std::size_t i = 0ul; i < m; ++i) {
+        const Arg* MADNESS_RESTRICT const arg_i = arg + (i * stride);
+        TILEDARRAY_PRAGMA_SIMD
+        for(std::size_t j = 0ul; j < n; ++j)
+          op(result[j], arg_i[j]);
+      }
+    }
+
+    /// Reduce the rows of a matrix
+
+    /// <tt>op(result[i], left[i][j], right[j])</tt>. Matrices with at least
+    /// \c parallel_matrix_min_size elements are split into blocks of rows,
+    /// which are reduced by separate threads.
+    /// \tparam Left The left-hand matrix element type
+    /// \tparam Right The right-hand vector element type
+    /// \tparam Result The result vector element type
+    /// \param[in] m The number of rows in left
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] left An m*n matrix
+    /// \param[in] right A vector of size n
+    /// \param[out] result The result vector of size m
+    /// \param[in] op The operation that will reduce the rows of left
+    template <typename Left, typename Right, typename Result, typename Op>
+    void row_reduce(const std::size_t m, const std::size_t n,
+        const Left* MADNESS_RESTRICT const left, const Right* MADNESS_RESTRICT const right,
+        Result* MADNESS_RESTRICT const result, const Op& op)
+    {
+      for_each_block_range(m, (m * n) >= parallel_matrix_min_size,
+          [=,&op] (const std::size_t first, const std::size_t last) {
+            row_reduce_serial(last - first, n, left + (first * n), right,
+                result + first, op);
+          });
+    }
+
+    /// Reduce the rows of a matrix
+
+    /// <tt>op(result[i], arg[i][j])</tt>. Matrices with at least
+    /// \c parallel_matrix_min_size elements are split into blocks of rows,
+    /// which are reduced by separate threads.
+    /// \tparam Arg The left-hand vector element type
+    /// \tparam Result The a matrix element type
+    /// \tparam Op The operator type
+    /// \param[in] m The number of rows in left
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] arg An m*n matrix
+    /// \param[out] result The result vector of size m
+    /// \param[in] op The operation that will reduce the rows of left
+    template <typename Arg, typename Result, typename Op>
+    void row_reduce(const std::size_t m, const std::size_t n,
+        const Arg* MADNESS_RESTRICT const arg,  Result* MADNESS_RESTRICT const result, const Op& op)
+    {
+      for_each_block_range(m, (m * n) >= parallel_matrix_min_size,
+          [=,&op] (const std::size_t first, const std::size_t last) {
+            row_reduce_serial(last - first, n, arg + (first * n), result + first, op);
+          });
+    }
+
+    /// Reduce the columns of a matrix
+
+    /// <tt>op(result[j], left[i][j], right[i])</tt>. Arithmetic element
+    /// types are reduced with vectorized loops over the columns; matrices
+    /// with at least \c parallel_matrix_min_size elements are split into
+    /// blocks of columns, which are reduced by separate threads.
+    /// \tparam Left The left-hand vector element type
+    /// \tparam Right The right-hand vector element type
+    /// \tparam Result The a matrix element type
+    /// \tparam Op The operator type
+    /// \param[in] m The number of rows in left
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] left An m*n matrix
+    /// \param[in] right A vector of size m
+    /// \param[out] result The result vector of size n
+    /// \param[in] op The operation that will reduce the columns of left
+    template <typename Left, typename Right, typename Result, typename Op>
+    void col_reduce(const std::size_t m, const std::size_t n,
+        const Left* MADNESS_RESTRICT const left, const Right* MADNESS_RESTRICT const right,
+        Result* MADNESS_RESTRICT const result, const Op& op)
+    {
+      if(! is_simd_vectorizable<Left, Right, Result>::value) {
+        col_reduce_serial(m, n, left, right, result, op);
+        return;
+      }
+
+      for_each_block_range(n, (m * n) >= parallel_matrix_min_size,
+          [=,&op] (const std::size_t first, const std::size_t last) {
+            col_reduce_simd(m, last - first, n, left + first, right,
+                result + first, op);
+          });
+    }
+
+    /// Reduce the columns of a matrix
+
+    /// <tt>op(result[j], arg[i][j])</tt>. Arithmetic element types are
+    /// reduced with vectorized loops over the columns; matrices with at
+    /// least \c parallel_matrix_min_size elements are split into blocks of
+    /// columns, which are reduced by separate threads.
+    /// \tparam Arg The argument vector element type
+    /// \tparam Result The a matrix element type
+    /// \tparam Op The operator type
+    /// \param[in] m The number of rows in left
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] arg An m*n matrix
+    /// \param[out] result The result vector of size n
+    /// \param[in] op The operation that will reduce the columns of left
+    template <typename Arg, typename Result, typename Op>
+    void col_reduce(const std::size_t m, const std::size_t n,
+        const Arg* MADNESS_RESTRICT const arg, Result* MADNESS_RESTRICT const result, const Op& op)
+    {
+      if(! is_simd_vectorizable<Arg, Result>::value) {
+        col_reduce_serial(m, n, arg, result, op);
+        return;
+      }
+
+      for_each_block_range(n, (m * n) >= parallel_matrix_min_size,
+          [=,&op] (const std::size_t first, const std::size_t last) {
+            col_reduce_simd(m, last - first, n, arg + first, result + first, op);
+          });
+    }
+
   }  // namespace math
 } // namespace TiledArray
 
@@ -0,0 +1,135 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  random.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_RANDOM_H__INCLUDED
+#define TILEDARRAY_MATH_RANDOM_H__INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <TiledArray/madness.h>
+#include <TiledArray/math/simd.h>
+
+namespace TiledArray {
+  namespace math {
+
+    /// Counter-based uniform random number
+
+    /// Returns the first 53 bits of the Philox4x32-10 block of \c counter
+    /// with key \c seed , as a number in <tt>[0, 1)</tt> . The number only
+    /// depends on \c seed and \c counter , so any set of counters may be
+    /// generated in any order, by any thread, with the same result.
+    /// \param seed The key of the generator
+    /// \param counter The counter, e.g. the ordinal of an element
+    /// \return A uniform random number in <tt>[0, 1)</tt>
+    inline double philox_uniform(const std::uint64_t seed, const std::uint64_t counter) {
+      std::uint32_t c0 = std::uint32_t(counter), c1 = std::uint32_t(counter >> 32),
+          c2 = 0u, c3 = 0u;
+      std::uint32_t k0 = std::uint32_t(seed), k1 = std::uint32_t(seed >> 32);
+      for(unsigned int round = 0u; round < 10u; ++round) {
+        const std::uint64_t p0 = std::uint64_t(0xD2511F53u) * c0;
+        const std::uint64_t p1 = std::uint64_t(0xCD9E8D57u) * c2;
+        const std::uint32_t x0 = std::uint32_t(p1 >> 32) ^ c1 ^ k0;
+        const std::uint32_t x2 = std::uint32_t(p0 >> 32) ^ c3 ^ k1;
+        c1 = std::uint32_t(p1);
+        c3 = std::uint32_t(p0);
+        c0 = x0;
+        c2 = x2;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+      }
+      const std::uint64_t bits = (std::uint64_t(c0) << 32) | std::uint64_t(c1);
+      return double(bits >> 11) * (1.0 / 9007199254740992.0); // 2^-53
+    }
+
+    /// Fill a vector with counter-based uniform random numbers
+
+    /// <tt>a[i] = philox_uniform(seed, first + i)</tt> , for \c i in
+    /// <tt>[0, n)</tt> .
+    /// \tparam T The element type
+    /// \param n The size of \c a
+    /// \param seed The key of the generator
+    /// \param first The counter of the first element
+    /// \param[out] a The vector to be filled
+    template <typename T>
+    TILEDARRAY_SIMD_DISPATCH void
+    random_fill(const std::size_t n, const std::uint64_t seed,
+        const std::uint64_t first, T* MADNESS_RESTRICT const a)
+    {
+      TILEDARRAY_PRAGMA_SIMD
+      for(std::size_t i = 0ul; i < n; ++i)
+        a[i] = T(philox_uniform(seed, first + i));
+    }
+
+    /// Fill a tensor with counter-based uniform random numbers
+
+    /// Each element of \c tensor is filled with the random number of its
+    /// ordinal in \c elements , the element range of the array (see
+    /// \c philox_uniform() ), so the elements of an array do not depend on
+    /// the tiling, the process map, or the number of threads. Each row of
+    /// \c tensor is a contiguous range of ordinals, which is filled by
+    /// \c random_fill() .
+    /// \tparam Tensor The tensor type, with contiguous row-major data
+    /// \tparam Range The element range type
+    /// \param[in,out] tensor The tensor to be filled
+    /// \param elements The element range of the array
+    /// \param seed The key of the generator
+    template <typename Tensor, typename Range>
+    inline void random_fill(Tensor& tensor, const Range& elements,
+        const std::uint64_t seed)
+    {
+      const auto& range = tensor.range();
+      const unsigned int rank = range.rank();
+      if(! rank || ! range.volume())
+        return;
+      const auto* MADNESS_RESTRICT const lower = range.lobound_data();
+      const auto* MADNESS_RESTRICT const upper = range.upbound_data();
+      const std::size_t cols = range.extent_data()[rank - 1u];
+
+      std::vector<std::size_t> index(lower, lower + rank);
+      auto* MADNESS_RESTRICT data = tensor.data();
+      for(std::size_t offset = 0ul; offset < range.volume(); offset += cols) {
+        random_fill(cols, seed, std::uint64_t(elements.ordinal(index)), data + offset);
+
+        // Go to the first element of the next row
+        for(unsigned int d = rank - 1u; d > 0u; --d) {
+          if(++index[d - 1u] < std::size_t(upper[d - 1u]))
+            break;
+          index[d - 1u] = lower[d - 1u];
+        }
+      }
+    }
+
+    /// Seed of the next random fill
+
+    /// \return 0, 1, 2, ... on successive calls, which are the same on
+    /// every process when arrays are filled in the same order
+    inline std::uint64_t next_random_seed() {
+      static std::atomic<std::uint64_t> seed(0ul);
+      return seed.fetch_add(1ul);
+    }
+
+  }  // namespace math
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_RANDOM_H__INCLUDED
@@ -0,0 +1,113 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_SIMD_H__INCLUDED
+#define TILEDARRAY_MATH_SIMD_H__INCLUDED
+
+#include <TiledArray/config.h>
+#include <cstddef>
+#include <type_traits>
+
+/* TILEDARRAY_PRAGMA_SIMD asserts that the following loop has no loop-carried
+   dependencies, so that it is vectorized for the target ISA. */
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define TILEDARRAY_PRAGMA_SIMD _Pragma("omp simd")
+#elif defined(__INTEL_COMPILER)
+#define TILEDARRAY_PRAGMA_SIMD _Pragma("simd")
+#elif defined(__clang__)
+#define TILEDARRAY_PRAGMA_SIMD _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+#define TILEDARRAY_PRAGMA_SIMD _Pragma("GCC ivdep")
+#else
+#define TILEDARRAY_PRAGMA_SIMD
+#endif
+
+/* TILEDARRAY_SIMD_DISPATCH compiles a function for AVX-512, AVX2/FMA, and the
+   baseline ISA, and selects one of them when the program is loaded. It is
+   enabled by configuring with TA_SIMD_DISPATCH on x86-64 with GCC. */
+#if defined(TILEDARRAY_ENABLE_SIMD_DISPATCH) && defined(__x86_64__) && \
+    defined(__ELF__) && defined(__GNUC__) && (__GNUC__ >= 6) && \
+    ! defined(__clang__) && ! defined(__INTEL_COMPILER)
+#define TILEDARRAY_SIMD_DISPATCH \
+    __attribute__((target_clones("arch=skylake-avx512", "arch=haswell", "default")))
+#define TILEDARRAY_HAS_SIMD_DISPATCH 1
+#else
+#define TILEDARRAY_SIMD_DISPATCH
+#endif
+
+namespace TiledArray {
+  namespace math {
+
+    /// SIMD instruction sets
+    enum class SimdIsa { generic, sse2, avx2, avx512 };
+
+    /// Compile-time instruction set
+
+    /// \return The widest instruction set that the baseline code is compiled
+    /// for
+    constexpr SimdIsa compiled_simd_isa() {
+#if defined(__AVX512F__)
+      return SimdIsa::avx512;
+#elif defined(__AVX2__)
+      return SimdIsa::avx2;
+#elif defined(__SSE2__) || defined(__ARM_NEON)
+      return SimdIsa::sse2;
+#else
+      return SimdIsa::generic;
+#endif
+    }
+
+    /// Run-time instruction set
+
+    /// With \c TA_SIMD_DISPATCH , this is the instruction set of the kernels
+    /// selected on this processor, otherwise it is \c compiled_simd_isa() .
+    /// \return The instruction set used by the vector kernels
+    inline SimdIsa simd_isa() {
+#ifdef TILEDARRAY_HAS_SIMD_DISPATCH
+      __builtin_cpu_init();
+      if(__builtin_cpu_supports("avx512f"))
+        return SimdIsa::avx512;
+      if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SimdIsa::avx2;
+      return compiled_simd_isa();
+#else
+      return compiled_simd_isa();
+#endif // TILEDARRAY_HAS_SIMD_DISPATCH
+    }
+
+    /// Check that the vector kernels may be applied element-wise
+
+    /// \c value is \c true when all types are arithmetic, so a loop over the
+    /// elements can be vectorized without copying through \c Block .
+    template <typename... Ts>
+    struct is_simd_vectorizable;
+
+    template <>
+    struct is_simd_vectorizable<> : public std::true_type { };
+
+    template <typename T, typename... Ts>
+    struct is_simd_vectorizable<T, Ts...> :
+        public std::integral_constant<bool, std::is_arithmetic<T>::value &&
+            is_simd_vectorizable<Ts...>::value>
+    { };
+
+  } // namespace math
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_SIMD_H__INCLUDED
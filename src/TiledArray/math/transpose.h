@@ -28,6 +28,7 @@
 
 #include <TiledArray/error.h>
 #include <TiledArray/math/vector_op.h>
+#include <algorithm>
 
 namespace TiledArray {
   namespace math {
@@ -155,10 +156,18 @@ namespace TiledArray {
       }
     }
 
-    /// Matrix transpose and initialization
+    /// The edge length of the cache blocks of \c transpose
+
+    /// A cache block of the argument and of the result matrix together fit in
+    /// the L1 cache.
+    typedef std::integral_constant<std::size_t, TILEDARRAY_LOOP_UNWIND * 4ul> TransposeTile;
+
+    /// Matrix transpose and initialization without cache blocking
 
     /// This function will transpose and transform argument matrices into an
-    /// uninitialized block of memory
+    /// uninitialized block of memory, one row of
+    /// <tt>TILEDARRAY_LOOP_UNWIND</tt>-by-<tt>TILEDARRAY_LOOP_UNWIND</tt>
+    /// blocks at a time.
     /// \tparam InputOp The input transform operation type
     /// \tparam OutputOp The output transform operation type
     /// \tparam Result The result element type
@@ -173,7 +182,7 @@ namespace TiledArray {
     /// \param[in] args A pointer to the first element of the argument matrix
     /// \note The data layout is expected to be row-major.
     template <typename InputOp, typename OutputOp, typename Result, typename... Args>
-    void transpose(InputOp&& input_op, OutputOp&& output_op,
+    void transpose_panel(InputOp&& input_op, OutputOp&& output_op,
         const std::size_t m, const std::size_t n,
         const std::size_t result_stride, Result* result,
         const std::size_t arg_stride, const Args* const... args)
@@ -222,6 +231,44 @@ namespace TiledArray {
       }
     }
 
+
+    /// Matrix transpose and initialization
+
+    /// This function will transpose and transform argument matrices into an
+    /// uninitialized block of memory. The matrices are transposed in
+    /// \c TransposeTile blocks, so the argument rows and result rows of a
+    /// block stay in cache while it is transposed.
+    /// \tparam InputOp The input transform operation type
+    /// \tparam OutputOp The output transform operation type
+    /// \tparam Result The result element type
+    /// \tparam Args The argument element type
+    /// \param[in] input_op The transformation operation applied to input arguments
+    /// \param[in] output_op The transformation operation used to set the result
+    /// \param[in] m The number of rows in the argument matrix
+    /// \param[in] n The number of columns in the argument matrix
+    /// \param[in] result_stride THe stride between result rows
+    /// \param[out] result A pointer to the first element of the result matrix
+    /// \param[in] arg_stride The stride between argument rows
+    /// \param[in] args A pointer to the first element of the argument matrix
+    /// \note The data layout is expected to be row-major.
+    template <typename InputOp, typename OutputOp, typename Result, typename... Args>
+    void transpose(InputOp&& input_op, OutputOp&& output_op,
+        const std::size_t m, const std::size_t n,
+        const std::size_t result_stride, Result* result,
+        const std::size_t arg_stride, const Args* const... args)
+    {
+      constexpr std::size_t tile = TransposeTile::value;
+
+      for(std::size_t j = 0ul; j < n; j += tile) {
+        const std::size_t n_j = std::min(tile, n - j);
+        Result* const result_j = result + (j * result_stride);
+        for(std::size_t i = 0ul; i < m; i += tile)
+          transpose_panel(input_op, output_op, std::min(tile, m - i), n_j,
+              result_stride, result_j + i, arg_stride,
+              (args + (i * arg_stride + j))...);
+      }
+    }
+
   }  // namespace math
 } // namespace TiledArray
 
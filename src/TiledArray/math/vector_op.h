@@ -29,6 +29,10 @@
 #include <TiledArray/type_traits.h>
 #include <TiledArray/madness.h>
 #include <TiledArray/config.h>
+#include <TiledArray/math/simd.h>
+#include <TiledArray/math/compensated_sum.h>
+#include <TiledArray/tensor/complex.h>
+#include <cstring>
 
 #define TILEDARRAY_LOOP_UNWIND ::TiledArray::math::LoopUnwind::value
 
@@ -216,12 +220,20 @@ namespace TiledArray {
     }
 
     template <typename Result, typename Arg>
-    TILEDARRAY_FORCE_INLINE void
+    TILEDARRAY_FORCE_INLINE typename std::enable_if<! (std::is_same<Result, Arg>::value &&
+        std::is_scalar<Arg>::value)>::type
     copy_block(Result* const result, const Arg* const arg) {
       for_each_block([] (Result& lhs, param_type<Arg> rhs) { lhs = rhs; },
           result, arg);
     }
 
+    template <typename T>
+    TILEDARRAY_FORCE_INLINE typename std::enable_if<std::is_scalar<T>::value>::type
+    copy_block(T* const result, const T* const arg) {
+      // A fixed-size copy is emitted as full-width vector loads and stores
+      std::memcpy(result, arg, TILEDARRAY_LOOP_UNWIND * sizeof(T));
+    }
+
     template <typename Arg, typename Result>
     TILEDARRAY_FORCE_INLINE void
     copy_block_n(std::size_t n, Result* const result, const Arg* const arg) {
@@ -338,12 +350,75 @@ namespace TiledArray {
 
 #endif
 
+    /// The smallest matrix that is split across threads by the matrix kernels
+
+    /// The partial reductions of \c partial_reduce.h and the outer products
+    /// of \c outer.h split matrices with at least this many elements into
+    /// blocks of rows or columns, which are evaluated by separate threads.
+    static constexpr std::size_t parallel_matrix_min_size = 65536ul;
+
+    /// The smallest vector that is split across threads by the array kernels
+
+    /// The element-wise operations and reductions of \c SizeArray and
+    /// \c ValArray split vectors with at least this many elements into
+    /// blocks, which are evaluated by separate threads; smaller vectors are
+    /// evaluated by the calling thread.
+    static constexpr std::size_t parallel_vector_min_size = 65536ul;
+
+    /// Apply an operation to the blocks of a range
+
+    /// With TBB, and when \c parallel is \c true , the range is split into
+    /// blocks whose boundaries are multiples of \c TILEDARRAY_LOOP_UNWIND ,
+    /// and \c op is called for the blocks by several threads; otherwise
+    /// \c op is called once for the whole range.
+    /// \tparam Op The block operation type
+    /// \param n The size of the range
+    /// \param parallel Split the range across threads
+    /// \param op The block operation, which is called as
+    /// <tt>op(first, last)</tt> for each block <tt>[first, last)</tt>
+    template <typename Op>
+    inline void for_each_block_range(const std::size_t n, const bool parallel,
+        const Op& op)
+    {
+#ifdef HAVE_INTEL_TBB
+      if(parallel) {
+        tbb::parallel_for(SizeTRange(0ul, n), [&op] (const SizeTRange& range)
+            { op(range.begin(), range.end()); }, tbb::auto_partitioner());
+        return;
+      }
+#else
+      (void)parallel;
+#endif // HAVE_INTEL_TBB
+      op(0ul, n);
+    }
+
+    /// Vectorized in-place vector operation
+
+    /// Applies \c op to each element with a loop that the compiler vectorizes
+    /// for the target ISA, or for each ISA of \c TILEDARRAY_SIMD_DISPATCH .
+    /// This is used for arithmetic element types, which do not need to be
+    /// copied through \c Block .
+    template <typename Op, typename Result, typename... Args>
+    TILEDARRAY_SIMD_DISPATCH void
+    inplace_vector_op_simd(Op&& op, const std::size_t n,
+        Result* MADNESS_RESTRICT const result, const Args* MADNESS_RESTRICT const... args)
+    {
+      TILEDARRAY_PRAGMA_SIMD
+      for(std::size_t i = 0ul; i < n; ++i)
+        op(result[i], args[i]...);
+    }
+
     template <typename Op, typename Result, typename... Args,
         typename std::enable_if<std::is_void<typename std::result_of<Op(Result&,
         Args...)>::type>::value>::type* = nullptr>
     void inplace_vector_op_serial(Op&& op, const std::size_t n, Result* const result,
         const Args* const... args)
     {
+      if(is_simd_vectorizable<Result, Args...>::value) {
+        inplace_vector_op_simd(op, n, result, args...);
+        return;
+      }
+
       std::size_t i = 0ul;
 
       // Compute block iteration limit
@@ -425,6 +500,11 @@ namespace TiledArray {
       auto wrapper_op = [&op] (Result& res, param_type<Args>... a)
           { res = op(a...); };
 
+      if(is_simd_vectorizable<Result, Args...>::value) {
+        inplace_vector_op_simd(wrapper_op, n, result, args...);
+        return;
+      }
+
       std::size_t i = 0ul;
 
       // Compute block iteration limit
@@ -563,6 +643,75 @@ namespace TiledArray {
       #endif
     }
 
+    /// Vector operation that computes the squared norm of the result
+
+    /// As \c vector_ptr_op_serial() , but the squared Frobenius norm of each
+    /// block of \c TILEDARRAY_LOOP_UNWIND result elements is accumulated
+    /// right after the block is written, while it is still in registers or
+    /// L1 cache, instead of by a separate pass over the result.
+    /// \return The squared norm of the \c n result elements
+    template <typename Op, typename Result, typename... Args>
+    typename TiledArray::detail::scalar_type<Result>::type
+    vector_ptr_op_norm_serial(Op&& op, const std::size_t n,
+        Result* const result, const Args* const... args)
+    {
+      typedef typename TiledArray::detail::scalar_type<Result>::type scalar_type;
+
+      TILEDARRAY_ALIGNED_STORAGE scalar_type sum[TILEDARRAY_LOOP_UNWIND];
+      for(std::size_t j = 0ul; j < TILEDARRAY_LOOP_UNWIND; ++j)
+        sum[j] = scalar_type(0);
+
+      std::size_t i = 0ul;
+      const std::size_t nx = n & index_mask::value;
+      for(; i < nx; i += TILEDARRAY_LOOP_UNWIND) {
+        for_each_block_ptr(op, result + i, Block<Args>(args + i)...);
+        for(std::size_t j = 0ul; j < TILEDARRAY_LOOP_UNWIND; ++j)
+          sum[j] += TiledArray::detail::norm(result[i + j]);
+      }
+      for_each_block_ptr_n(op, n - i, result + i, (args + i)...);
+
+      scalar_type result_norm = scalar_type(0);
+      for(; i < n; ++i)
+        result_norm += TiledArray::detail::norm(result[i]);
+      for(std::size_t j = 0ul; j < TILEDARRAY_LOOP_UNWIND; ++j)
+        result_norm += sum[j];
+      return result_norm;
+    }
+
+    /// Vector operation that computes the squared norm of the result
+
+    /// Applies \c op as \c vector_ptr_op() , and returns the squared
+    /// Frobenius norm of the result, which is computed while the result is
+    /// written (see \c vector_ptr_op_norm_serial() ).
+    /// \tparam Op The element operation type
+    /// \tparam Result The result element type
+    /// \tparam Args The argument element types
+    /// \param op The element operation, which is called as
+    /// <tt>op(result + i, args[i]...)</tt>
+    /// \param n The number of elements
+    /// \param result The result elements
+    /// \param args The argument elements
+    /// \return The squared norm of the \c n result elements
+    template <typename Op, typename Result, typename... Args>
+    typename TiledArray::detail::scalar_type<Result>::type
+    vector_ptr_op_norm(Op&& op, const std::size_t n, Result* const result,
+        const Args* const... args)
+    {
+      typedef typename TiledArray::detail::scalar_type<Result>::type scalar_type;
+#ifdef HAVE_INTEL_TBB
+      return tbb::parallel_reduce(SizeTRange(0ul, n), scalar_type(0),
+          [&] (const SizeTRange& range, const scalar_type partial) {
+            const std::size_t offset = range.begin();
+            return partial + vector_ptr_op_norm_serial(op, range.size(),
+                result + offset, (args + offset)...);
+          },
+          [] (const scalar_type left, const scalar_type right)
+          { return left + right; }, tbb::auto_partitioner());
+#else
+      return vector_ptr_op_norm_serial(op, n, result, args...);
+#endif // HAVE_INTEL_TBB
+    }
+
     template <typename Op, typename Result, typename... Args>
     void reduce_op_serial(Op&& op, const std::size_t n, Result& result,
         const Args* const... args)
@@ -582,6 +731,48 @@ namespace TiledArray {
       reduce_block_n(op, n - i, result, (args + i)...);
     }
 
+    /// Vectorized reduction
+
+    /// The elements are reduced into \c TILEDARRAY_LOOP_UNWIND independent
+    /// partial results, which the compiler vectorizes for the target ISA, or
+    /// for each ISA of \c TILEDARRAY_SIMD_DISPATCH . The partial results are
+    /// then joined into \c result .
+    template <typename ReduceOp, typename JoinOp, typename Result, typename... Args>
+    TILEDARRAY_SIMD_DISPATCH void
+    reduce_op_simd(ReduceOp&& reduce_op, JoinOp&& join_op, const Result& identity,
+        const std::size_t n, Result& result, const Args* MADNESS_RESTRICT const... args)
+    {
+      TILEDARRAY_ALIGNED_STORAGE Result partial[TILEDARRAY_LOOP_UNWIND];
+      for(std::size_t j = 0ul; j < TILEDARRAY_LOOP_UNWIND; ++j)
+        partial[j] = identity;
+
+      std::size_t i = 0ul;
+      const std::size_t nx = n & index_mask::value;
+      for(; i < nx; i += TILEDARRAY_LOOP_UNWIND) {
+        TILEDARRAY_PRAGMA_SIMD
+        for(std::size_t j = 0ul; j < TILEDARRAY_LOOP_UNWIND; ++j)
+          reduce_op(partial[j], args[i + j]...);
+      }
+
+      for(std::size_t j = 0ul; j < TILEDARRAY_LOOP_UNWIND; ++j)
+        join_op(result, partial[j]);
+      reduce_block_n(reduce_op, n - i, result, (args + i)...);
+    }
+
+    /// Serial reduction
+
+    /// Arithmetic reductions are vectorized with \c reduce_op_simd , which
+    /// changes the order in which the elements are reduced.
+    template <typename ReduceOp, typename JoinOp, typename Result, typename... Args>
+    void reduce_op_serial(ReduceOp&& reduce_op, JoinOp&& join_op, const Result& identity,
+        const std::size_t n, Result& result, const Args* const... args)
+    {
+      if(is_simd_vectorizable<Result, Args...>::value)
+        reduce_op_simd(reduce_op, join_op, identity, n, result, args...);
+      else
+        reduce_op_serial(reduce_op, n, result, args...);
+    }
+
 #ifdef HAVE_INTEL_TBB
     /// Helper class for composing TBB parallel reductions. Meets the \c Body concept used
     /// for the imperative form of \c tbb::parallel_reduce .
@@ -610,7 +801,8 @@ namespace TiledArray {
       void helper(SizeTRange& range, const std::index_sequence<Is...>&  ) {
         std::size_t offset = range.begin();
         std::size_t n_range = range.size();
-        reduce_op_serial(reduce_op_, n_range, result_, (std::get<Is>(args_)+offset)...);
+        reduce_op_serial(reduce_op_, join_op_, identity_, n_range, result_,
+            (std::get<Is>(args_)+offset)...);
       }
 
       void operator()(SizeTRange& range) {
@@ -650,10 +842,132 @@ namespace TiledArray {
 
         result = apply_reduce_op.result();
 #else
-        reduce_op_serial(reduce_op,n,result,args...);
+        reduce_op_serial(reduce_op, join_op, identity, n, result, args...);
 #endif
     }
 
+    /// Vectorized compensated reduction
+
+    /// The terms are summed into \c TILEDARRAY_LOOP_UNWIND independent
+    /// partial sums, each with its own error term, which the compiler
+    /// vectorizes for the target ISA, or for each ISA of
+    /// \c TILEDARRAY_SIMD_DISPATCH . The partial sums are then joined into
+    /// \c result .
+    template <typename TermOp, typename T, typename... Args>
+    TILEDARRAY_SIMD_DISPATCH void
+    compensated_reduce_op_simd(TermOp&& term_op, const std::size_t n,
+        CompensatedSum<T>& result, const Args* MADNESS_RESTRICT const... args)
+    {
+      TILEDARRAY_ALIGNED_STORAGE T sum[TILEDARRAY_LOOP_UNWIND];
+      TILEDARRAY_ALIGNED_STORAGE T correction[TILEDARRAY_LOOP_UNWIND];
+      for(std::size_t j = 0ul; j < TILEDARRAY_LOOP_UNWIND; ++j) {
+        sum[j] = T(0);
+        correction[j] = T(0);
+      }
+
+      std::size_t i = 0ul;
+      const std::size_t nx = n & index_mask::value;
+      for(; i < nx; i += TILEDARRAY_LOOP_UNWIND) {
+        TILEDARRAY_PRAGMA_SIMD
+        for(std::size_t j = 0ul; j < TILEDARRAY_LOOP_UNWIND; ++j)
+          two_sum(sum[j], T(term_op(args[i + j]...)) + correction[j], sum[j],
+              correction[j]);
+      }
+
+      for(std::size_t j = 0ul; j < TILEDARRAY_LOOP_UNWIND; ++j)
+        result += CompensatedSum<T>(sum[j], correction[j]);
+      for(; i < n; ++i)
+        result += T(term_op(args[i]...));
+    }
+
+    /// Serial compensated reduction
+
+    /// Adds <tt>term_op(args[i]...)</tt> to \c result for each \c i in
+    /// <tt>[0, n)</tt>. Arithmetic reductions are vectorized with
+    /// \c compensated_reduce_op_simd , which changes the order in which the
+    /// terms are added.
+    template <typename TermOp, typename T, typename... Args>
+    void compensated_reduce_op_serial(TermOp&& term_op, const std::size_t n,
+        CompensatedSum<T>& result, const Args* const... args)
+    {
+      if(is_simd_vectorizable<T, Args...>::value) {
+        compensated_reduce_op_simd(term_op, n, result, args...);
+      } else {
+        for(std::size_t i = 0ul; i < n; ++i)
+          result += T(term_op(args[i]...));
+      }
+    }
+
+#ifdef HAVE_INTEL_TBB
+    /// Helper class for composing TBB parallel compensated reductions. Meets
+    /// the \c Body concept used for the imperative form of
+    /// \c tbb::parallel_reduce .
+    template<typename TermOp, typename T, typename... Args>
+    class ApplyCompensatedReduceOp {
+
+    public:
+      ApplyCompensatedReduceOp(TermOp& term_op, const Args* const... args) :
+        term_op_(term_op), result_(), args_(args...)
+      { }
+
+      ApplyCompensatedReduceOp(ApplyCompensatedReduceOp& rhs, tbb::split) :
+        term_op_(rhs.term_op_), result_(), args_(rhs.args_)
+      { }
+
+      template<std::size_t... Is>
+      void helper(SizeTRange& range, const std::index_sequence<Is...>&) {
+        std::size_t offset = range.begin();
+        std::size_t n_range = range.size();
+        compensated_reduce_op_serial(term_op_, n_range, result_,
+            (std::get<Is>(args_) + offset)...);
+      }
+
+      void operator()(SizeTRange& range) {
+        helper(range, std::make_index_sequence<sizeof...(Args)>());
+      }
+
+      void join(const ApplyCompensatedReduceOp& rhs) { result_ += rhs.result_; }
+
+      const CompensatedSum<T>& result() const { return result_; }
+
+    private:
+
+      TermOp& term_op_;
+      CompensatedSum<T> result_;
+      std::tuple<const Args * const ...> args_;
+
+    }; // class ApplyCompensatedReduceOp
+#endif // HAVE_INTEL_TBB
+
+    /// Compensated reduction
+
+    /// Adds <tt>term_op(args[i]...)</tt> to \c result for each \c i in
+    /// <tt>[0, n)</tt>, so the rounding errors of the sum are carried in the
+    /// correction term of \c result . With TBB the range is split across
+    /// threads, and the partial sums are joined in an undefined order.
+    /// \tparam TermOp The term operation type
+    /// \tparam T The value type of the sum
+    /// \tparam Args The argument types
+    /// \param term_op The term operation, which returns the term of the
+    /// elements of \c args
+    /// \param n The number of elements
+    /// \param result The sum to which the terms are added
+    /// \param args The argument pointers
+    template <typename TermOp, typename T, typename... Args>
+    void compensated_reduce_op(TermOp&& term_op, const std::size_t n,
+        CompensatedSum<T>& result, const Args* const... args)
+    {
+#ifdef HAVE_INTEL_TBB
+      SizeTRange range(0, n);
+      ApplyCompensatedReduceOp<TermOp, T, Args...> apply_reduce_op(term_op,
+          args...);
+      tbb::parallel_reduce(range, apply_reduce_op, tbb::auto_partitioner());
+      result += apply_reduce_op.result();
+#else
+      compensated_reduce_op_serial(term_op, n, result, args...);
+#endif // HAVE_INTEL_TBB
+    }
+
     template <typename Arg, typename Result>
     typename std::enable_if<! (std::is_same<Arg, Result>::value && std::is_scalar<Arg>::value)>::type
     copy_vector(const std::size_t n, const Arg* const arg,
@@ -0,0 +1,184 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  node_shared.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_NODE_SHARED_H__INCLUDED
+#define TILEDARRAY_NODE_SHARED_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/error.h>
+#include <TiledArray/dist_eval/node_bcast.h>
+#include <TiledArray/pmap/replicated_pmap.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// Map a node-shared memory segment
+
+    /// The node leader creates the POSIX shared memory object \c name ,
+    /// and the other processes of the node open it, after the leader (see
+    /// \c make_node_shared() ). The object is unlinked by the leader once
+    /// every process has mapped it, so the memory is released with the last
+    /// mapping.
+    /// \param name The name of the shared memory object
+    /// \param bytes The size of the segment
+    /// \param create \c true if the object is created by this process
+    /// \return The owner of the mapping, which points to its first byte
+    /// \throw TiledArray::Exception When the segment cannot be mapped
+    inline std::shared_ptr<void>
+    map_node_shared(const std::string& name, const std::size_t bytes,
+        const bool create)
+    {
+      const int fd = (create ?
+          ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600) :
+          ::shm_open(name.c_str(), O_RDWR, 0600));
+      if(fd < 0)
+        TA_EXCEPTION("Unable to open the node-shared memory segment");
+      if(create && (::ftruncate(fd, bytes) != 0)) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        TA_EXCEPTION("Unable to allocate the node-shared memory segment");
+      }
+      void* const address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+          MAP_SHARED, fd, 0);
+      ::close(fd);
+      if(address == MAP_FAILED)
+        TA_EXCEPTION("Unable to map the node-shared memory segment");
+
+      return std::shared_ptr<void>(address,
+          [bytes] (void* p) { ::munmap(p, bytes); });
+    }
+
+  }  // namespace detail
+
+  /// Replicate an array with one copy per node
+
+  /// The tiles of the result are held once per node, in a POSIX shared
+  /// memory segment that is mapped by every process of the node (see
+  /// \c detail::NodeMap ), and the tiles of each process are \c Tensor
+  /// views of the segment, so a replicated array costs the memory of one
+  /// copy per node instead of one per process. Each tile is copied into
+  /// the segment of a node by one process of the node: by its owner, when
+  /// the owner is on the node, or else by a process of the node, in turn,
+  /// that fetches it, so each tile crosses the network once per node. The
+  /// segment is released when the last tile of the node is destroyed. The
+  /// tiles are shared by the processes of a node and must not be modified.
+  /// This is a collective operation.
+  /// \tparam T The element type of the tiles
+  /// \tparam A The allocator type of the tiles
+  /// \tparam Policy The policy type of the array
+  /// \param array The distributed array
+  /// \return The replicated array
+  /// \throw TiledArray::Exception When the segment cannot be mapped
+  template <typename T, typename A, typename Policy>
+  inline DistArray<Tensor<T, A>, Policy>
+  make_node_shared(const DistArray<Tensor<T, A>, Policy>& array) {
+    static_assert(std::is_scalar<T>::value,
+        "TiledArray::make_node_shared(): the tile elements must be scalars");
+    typedef DistArray<Tensor<T, A>, Policy> array_type;
+    typedef typename array_type::value_type tile_type;
+    constexpr std::size_t alignment = 64ul;
+
+    World& world = array.world();
+    const std::size_t ntiles = array.size();
+    const ProcessID rank = world.rank();
+    const std::shared_ptr<detail::NodeMap> node_map = detail::NodeMap::instance(world);
+    const ProcessID leader = node_map->leader(rank);
+    std::vector<ProcessID> members;
+    for(ProcessID p = 0; p < world.size(); ++p)
+      if(node_map->leader(p) == leader)
+        members.push_back(p);
+
+    // The non-zero tiles are placed in ordinal order at aligned offsets
+    std::vector<std::size_t> offsets(ntiles + 1ul, 0ul);
+    for(std::size_t ord = 0ul; ord < ntiles; ++ord) {
+      const std::size_t bytes = (array.is_zero(ord) ? 0ul :
+          array.trange().make_tile_range(ord).volume() * sizeof(T));
+      offsets[ord + 1ul] = offsets[ord] + ((bytes + alignment - 1ul) / alignment) * alignment;
+    }
+    const std::size_t bytes = std::max(offsets.back(), alignment);
+
+    // The name of the segment is made unique by the process id of the
+    // leader and the object id of the operation
+    std::vector<long> pids(world.size(), 0l);
+    pids[rank] = ::getpid();
+    world.gop.sum(pids.data(), pids.size());
+    const std::string name = "/ta_node_shared_" + std::to_string(pids[leader])
+        + "_" + std::to_string(world.unique_obj_id().get_obj_id());
+
+    std::shared_ptr<void> mapping;
+    if(leader == rank)
+      mapping = detail::map_node_shared(name, bytes, true);
+    world.gop.barrier();
+    if(leader != rank)
+      mapping = detail::map_node_shared(name, bytes, false);
+    world.gop.barrier();
+    if(leader == rank)
+      ::shm_unlink(name.c_str());
+    char* const base = static_cast<char*>(mapping.get());
+
+    // Copy the tiles that are written by this process into the segment
+    madness::AtomicInt counter; counter = 0;
+    int task_count = 0;
+    auto copy_tile = [base,&offsets,&counter] (const std::size_t ord,
+        const tile_type& tile)
+    {
+      std::memcpy(base + offsets[ord], tile.data(), tile.size() * sizeof(T));
+      ++counter;
+    };
+    for(std::size_t ord = 0ul; ord < ntiles; ++ord) {
+      if(array.is_zero(ord))
+        continue;
+      const ProcessID owner = array.owner(ord);
+      const ProcessID writer = (node_map->leader(owner) == leader ? owner :
+          members[ord % members.size()]);
+      if(writer != rank)
+        continue;
+      world.taskq.add(copy_tile, ord, array.find(ord));
+      ++task_count;
+    }
+    if(task_count > 0)
+      world.await([&counter,task_count] () -> bool { return counter == task_count; });
+    world.gop.barrier();
+
+    // Make views of all tiles
+    array_type result(world, array.trange(), array.shape(),
+        std::make_shared<detail::ReplicatedPmap>(world, ntiles));
+    for(std::size_t ord = 0ul; ord < ntiles; ++ord)
+      if(! array.is_zero(ord))
+        result.set(ord, tile_type(array.trange().make_tile_range(ord), mapping,
+            reinterpret_cast<T*>(base + offsets[ord])));
+    return result;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_NODE_SHARED_H__INCLUDED
@@ -0,0 +1,137 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_NORM_CODEC_H__INCLUDED
+#define TILEDARRAY_NORM_CODEC_H__INCLUDED
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <TiledArray/error.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Log-scale encoding of norms
+
+    /// Non-negative norms are encoded as unsigned integer codes on a
+    /// logarithmic scale, with \c levels() codes per factor of two starting
+    /// at <tt>2^min_log2()</tt>. Code zero is an exact zero. Encoding rounds
+    /// up, so a decoded norm is never smaller than the encoded one and
+    /// screening with decoded norms never drops a non-zero tile: norms below
+    /// the smallest code are encoded as the smallest code, and norms above
+    /// the largest finite code saturate to the largest value of the norm
+    /// type. With 8-bit codes the relative error is at most 19%, with 16-bit
+    /// codes at most 0.14%.
+    /// \tparam Code The code type, \c std::uint8_t or \c std::uint16_t
+    template <typename Code>
+    class LogNormCodec {
+      static_assert(std::is_same<Code, std::uint8_t>::value ||
+          std::is_same<Code, std::uint16_t>::value,
+          "LogNormCodec code type must be std::uint8_t or std::uint16_t");
+
+    public:
+      typedef Code code_type; ///< The code type
+
+      /// Codes per factor of two
+
+      /// \return The number of codes per factor of two
+      static constexpr int levels() { return (sizeof(Code) == 1ul ? 4 : 512); }
+
+      /// Smallest exponent
+
+      /// \return The base-2 logarithm of the smallest non-zero code value
+      static constexpr int min_log2() { return (sizeof(Code) == 1ul ? -40 : -64); }
+
+      /// Largest code
+
+      /// \return The code of saturated norms
+      static constexpr Code max_code() { return std::numeric_limits<Code>::max(); }
+
+      /// Decode a norm
+
+      /// \tparam T The norm type
+      /// \param code The encoded norm
+      /// \return The norm value of \c code
+      template <typename T>
+      static T decode(const Code code) {
+        if(code == Code(0))
+          return T(0);
+        if(code == max_code())
+          return std::numeric_limits<T>::max();
+        return std::exp2(T(min_log2()) + T(code - 1) / T(levels()));
+      }
+
+      /// Encode a norm
+
+      /// \tparam T The norm type
+      /// \param norm The non-negative norm
+      /// \return The smallest code whose value is not less than \c norm
+      template <typename T>
+      static Code encode(const T norm) {
+        TA_ASSERT(norm >= T(0));
+        if(norm == T(0))
+          return Code(0);
+
+        const double scaled =
+            (std::log2(double(norm)) - double(min_log2())) * double(levels());
+        if(scaled >= double(max_code() - 1))
+          return max_code();
+        Code code = (scaled <= 0.0 ? Code(1) : Code(std::ceil(scaled) + 1.0));
+
+        // Correct the rounding of log2 and exp2
+        while((code < max_code()) && (decode<T>(code) < norm))
+          ++code;
+        return code;
+      }
+
+      /// Encode a sequence of norms
+
+      /// \tparam T The norm type
+      /// \param norms A pointer to the norms
+      /// \param n The number of norms
+      /// \return The codes of the norms
+      template <typename T>
+      static std::vector<Code> encode(const T* const norms, const std::size_t n) {
+        std::vector<Code> codes(n);
+        for(std::size_t i = 0ul; i < n; ++i)
+          codes[i] = encode(norms[i]);
+        return codes;
+      }
+
+      /// Decode a sequence of norms
+
+      /// \tparam T The norm type
+      /// \param codes The encoded norms
+      /// \param norms A pointer to the result, with room for
+      /// <tt>codes.size()</tt> norms
+      template <typename T>
+      static void decode(const std::vector<Code>& codes, T* const norms) {
+        for(std::size_t i = 0ul; i < codes.size(); ++i)
+          norms[i] = decode<T>(codes[i]);
+      }
+
+    }; // class LogNormCodec
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_NORM_CODEC_H__INCLUDED
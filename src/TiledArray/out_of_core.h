@@ -0,0 +1,503 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_OUT_OF_CORE_H__INCLUDED
+#define TILEDARRAY_OUT_OF_CORE_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+#include <madness/world/binary_fstream_archive.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// A tile that is managed by a \c TileStore
+    class StoredTile {
+    public:
+      virtual ~StoredTile() { }
+
+      /// Write the tile data to its file, if needed, and release it
+      virtual void spill() = 0;
+    }; // class StoredTile
+
+  }  // namespace detail
+
+  /// Node-local storage of out-of-core tiles
+
+  /// The store keeps the data of recently used tiles in memory, up to a
+  /// residency limit in bytes, and spills the least recently used tiles to
+  /// files in a node-local directory, e.g. on an NVMe device. A spilled tile
+  /// is written only once, since the tiles are not modified, and it is read
+  /// back when it is used. The residency limit is the policy: zero keeps no
+  /// tile in memory after it is used, and a limit larger than memory keeps
+  /// every tile resident. The store reports the volume and the bandwidth of
+  /// its reads and writes.
+  /// \note Each process uses its own file names, so several processes may
+  /// share a directory.
+  class TileStore {
+  public:
+    typedef std::size_t size_type; ///< Size type
+
+  private:
+
+    /// A resident tile
+    struct Entry {
+      const detail::StoredTile* key; ///< The lookup key of the tile
+      std::weak_ptr<detail::StoredTile> tile; ///< The tile
+      size_type bytes; ///< The size of the tile data
+    }; // struct Entry
+
+    typedef std::list<Entry> list_type; ///< Resident tiles, most recently used first
+
+    World& world_; ///< The world of the store
+    const std::string path_; ///< The directory of the spill files
+    size_type max_resident_bytes_; ///< The residency limit
+    mutable madness::Spinlock lock_; ///< Protects the members below
+    list_type list_; ///< The resident tiles in the order of their use
+    std::unordered_map<const detail::StoredTile*,
+        typename list_type::iterator> map_; ///< Resident tile lookup
+    size_type resident_bytes_; ///< The size of the resident tiles
+    size_type files_; ///< The number of spill files that were created
+    size_type bytes_written_; ///< The number of bytes written to files
+    size_type bytes_read_; ///< The number of bytes read from files
+    double write_time_; ///< The time spent writing files, in seconds
+    double read_time_; ///< The time spent reading files, in seconds
+
+    /// Evict the least recently used tiles until the tiles fit
+
+    /// \param[out] victims The evicted tiles, which must be spilled after
+    /// the lock is released
+    void evict(std::vector<std::shared_ptr<detail::StoredTile> >& victims) {
+      while(resident_bytes_ > max_resident_bytes_) {
+        const Entry& entry = list_.back();
+        resident_bytes_ -= entry.bytes;
+        std::shared_ptr<detail::StoredTile> victim = entry.tile.lock();
+        if(victim)
+          victims.push_back(std::move(victim));
+        map_.erase(entry.key);
+        list_.pop_back();
+      }
+    }
+
+    /// Spill the evicted tiles
+
+    /// \param victims The evicted tiles
+    static void spill(const std::vector<std::shared_ptr<detail::StoredTile> >& victims) {
+      for(const auto& victim : victims)
+        victim->spill();
+    }
+
+    // Not allowed
+    TileStore(const TileStore&);
+    TileStore& operator=(const TileStore&);
+
+  public:
+
+    /// Construct a tile store
+
+    /// \param world The world of the tiles
+    /// \param path The node-local directory of the spill files
+    /// \param max_resident_bytes The maximum size of the resident tile data
+    /// of this process, in bytes
+    TileStore(World& world, const std::string& path,
+        const size_type max_resident_bytes) :
+      world_(world), path_(path), max_resident_bytes_(max_resident_bytes),
+      lock_(), list_(), map_(), resident_bytes_(0ul), files_(0ul),
+      bytes_written_(0ul), bytes_read_(0ul), write_time_(0.0), read_time_(0.0)
+    { }
+
+    /// World accessor
+
+    /// \return A reference to the world of the store
+    World& world() const { return world_; }
+
+    /// Residency limit accessor
+
+    /// \return The maximum size of the resident tile data, in bytes
+    size_type max_resident_bytes() const {
+      madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+      return max_resident_bytes_;
+    }
+
+    /// Set the residency limit
+
+    /// Tiles are spilled until the resident tiles fit in the new limit.
+    /// \param max_resident_bytes The maximum size of the resident tile data
+    void max_resident_bytes(const size_type max_resident_bytes) {
+      std::vector<std::shared_ptr<detail::StoredTile> > victims;
+      {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        max_resident_bytes_ = max_resident_bytes;
+        evict(victims);
+      }
+      spill(victims);
+    }
+
+    /// Make a new spill file name
+
+    /// \return The name of a file that is not used by this store
+    std::string make_file() {
+      size_type file = 0ul;
+      {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        file = files_++;
+      }
+      return path_ + "/ta_tile_" + std::to_string(world_.rank()) + "_" +
+          std::to_string(reinterpret_cast<std::uintptr_t>(this)) + "_" +
+          std::to_string(file) + ".bin";
+    }
+
+    /// Mark a tile as resident and most recently used
+
+    /// Less recently used tiles are spilled when the resident tiles exceed
+    /// the residency limit, which may include \c tile itself.
+    /// \param tile The resident tile
+    /// \param bytes The size of the tile data
+    void touch(const std::shared_ptr<detail::StoredTile>& tile, const size_type bytes) {
+      std::vector<std::shared_ptr<detail::StoredTile> > victims;
+      {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        const auto it = map_.find(tile.get());
+        if(it != map_.end()) {
+          list_.splice(list_.begin(), list_, it->second);
+        } else {
+          list_.push_front(Entry{tile.get(), tile, bytes});
+          map_.emplace(tile.get(), list_.begin());
+          resident_bytes_ += bytes;
+        }
+        evict(victims);
+      }
+      spill(victims);
+    }
+
+    /// Remove a tile from the resident tiles
+
+    /// \param tile The tile that is destroyed or spilled
+    void erase(const detail::StoredTile* tile) {
+      madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+      const auto it = map_.find(tile);
+      if(it != map_.end()) {
+        resident_bytes_ -= it->second->bytes;
+        list_.erase(it->second);
+        map_.erase(it);
+      }
+    }
+
+    /// Record a file write
+
+    /// \param bytes The number of bytes written
+    /// \param seconds The duration of the write
+    void record_write(const size_type bytes, const double seconds) {
+      madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+      bytes_written_ += bytes;
+      write_time_ += seconds;
+    }
+
+    /// Record a file read
+
+    /// \param bytes The number of bytes read
+    /// \param seconds The duration of the read
+    void record_read(const size_type bytes, const double seconds) {
+      madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+      bytes_read_ += bytes;
+      read_time_ += seconds;
+    }
+
+    /// The size of the resident tiles
+
+    /// \return The size of the resident tile data of this process, in bytes
+    size_type resident_bytes() const {
+      madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+      return resident_bytes_;
+    }
+
+    /// The number of bytes written to the spill files
+
+    /// \return The number of bytes written by this process
+    size_type bytes_written() const {
+      madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+      return bytes_written_;
+    }
+
+    /// The number of bytes read from the spill files
+
+    /// \return The number of bytes read by this process
+    size_type bytes_read() const {
+      madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+      return bytes_read_;
+    }
+
+    /// Write bandwidth
+
+    /// \return The average bandwidth of the writes of this process, in
+    /// bytes per second, or zero if nothing was written
+    double write_bandwidth() const {
+      madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+      return (write_time_ > 0.0 ? double(bytes_written_) / write_time_ : 0.0);
+    }
+
+    /// Read bandwidth
+
+    /// \return The average bandwidth of the reads of this process, in bytes
+    /// per second, or zero if nothing was read
+    double read_bandwidth() const {
+      madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+      return (read_time_ > 0.0 ? double(bytes_read_) / read_time_ : 0.0);
+    }
+
+  }; // class TileStore
+
+
+  /// Out-of-core tile
+
+  /// A lazy tile (see \c eval_trait ) whose data is kept by a \c TileStore ,
+  /// which spills the data to a node-local file when it is not used. An
+  /// array of out-of-core tiles, e.g. a four-virtual integral array, is
+  /// used in expressions like any other array; its tiles are evaluated to
+  /// \c Tile when they are needed. The evaluation reads a spilled tile in a
+  /// task, so the reads of a contraction are issued in the order of the
+  /// SUMMA iterations and, when the SUMMA broadcasts are prefetched, ahead
+  /// of the iterations that use them.
+  /// \tparam Tile The tile type, e.g. \c Tensor<double>
+  /// \note Out-of-core tiles are read-only. A tile that is sent to another
+  /// process is received as a resident tile that is not stored.
+  template <typename Tile>
+  class OutOfCoreTile {
+  public:
+    typedef OutOfCoreTile<Tile> OutOfCoreTile_; ///< This object type
+    typedef Tile eval_type; ///< The evaluated tile type
+    typedef typename Tile::range_type range_type; ///< Tile range type
+    typedef std::size_t size_type; ///< Size type
+
+  private:
+
+    /// The shared state of an out-of-core tile
+    class Record : public detail::StoredTile,
+        public std::enable_shared_from_this<Record>
+    {
+    private:
+      std::shared_ptr<TileStore> store_; ///< The store of the tile
+      range_type range_; ///< The tile range
+      size_type bytes_; ///< The size of the tile data
+      mutable madness::Spinlock lock_; ///< Protects the members below
+      std::shared_ptr<Tile> tile_; ///< The resident tile data
+      std::string file_; ///< The spill file, or empty if it is not written
+
+      typedef std::chrono::steady_clock clock_type;
+
+      static double seconds(const clock_type::time_point begin) {
+        return std::chrono::duration<double>(clock_type::now() - begin).count();
+      }
+
+    public:
+
+      Record(const std::shared_ptr<TileStore>& store, const Tile& tile) :
+        store_(store), range_(tile.range()),
+        bytes_(tile.range().volume() * sizeof(typename Tile::value_type)),
+        lock_(), tile_(std::make_shared<Tile>(tile)), file_()
+      { }
+
+      /// Construct a resident record that is not stored
+      explicit Record(const Tile& tile) :
+        store_(), range_(tile.range()),
+        bytes_(tile.range().volume() * sizeof(typename Tile::value_type)),
+        lock_(), tile_(std::make_shared<Tile>(tile)), file_()
+      { }
+
+      virtual ~Record() {
+        if(store_) {
+          store_->erase(this);
+          if(! file_.empty())
+            std::remove(file_.c_str());
+        }
+      }
+
+      const range_type& range() const { return range_; }
+
+      size_type bytes() const { return bytes_; }
+
+      const std::shared_ptr<TileStore>& store() const { return store_; }
+
+      /// Check that the tile data is in memory
+      bool is_resident() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return bool(tile_);
+      }
+
+      /// The resident tile data, or a null pointer
+      std::shared_ptr<Tile> resident() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return tile_;
+      }
+
+      virtual void spill() {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        if(! tile_)
+          return;
+        if(file_.empty()) {
+          const clock_type::time_point begin = clock_type::now();
+          file_ = store_->make_file();
+          madness::archive::BinaryFstreamOutputArchive ar(file_.c_str());
+          ar & *tile_;
+          ar.close();
+          store_->record_write(bytes_, seconds(begin));
+        }
+        tile_.reset();
+      }
+
+      /// Read the tile data, if needed, and mark it as used
+
+      /// \return The tile data
+      Tile load() {
+        std::shared_ptr<Tile> tile;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+          if(! tile_) {
+            TA_ASSERT(! file_.empty());
+            const clock_type::time_point begin = clock_type::now();
+            tile_ = std::make_shared<Tile>();
+            madness::archive::BinaryFstreamInputArchive ar(file_.c_str());
+            ar & *tile_;
+            ar.close();
+            store_->record_read(bytes_, seconds(begin));
+          }
+          tile = tile_;
+        }
+        if(store_)
+          store_->touch(Record::shared_from_this(), bytes_);
+        return *tile;
+      }
+
+    }; // class Record
+
+    std::shared_ptr<Record> record_; ///< The shared state of the tile
+
+    static Tile load_task(const std::shared_ptr<Record>& record) {
+      return record->load();
+    }
+
+  public:
+
+    /// Construct an empty tile
+    OutOfCoreTile() = default;
+    OutOfCoreTile(const OutOfCoreTile_&) = default;
+    OutOfCoreTile(OutOfCoreTile_&&) = default;
+    ~OutOfCoreTile() = default;
+    OutOfCoreTile_& operator=(const OutOfCoreTile_&) = default;
+    OutOfCoreTile_& operator=(OutOfCoreTile_&&) = default;
+
+    /// Construct an out-of-core tile
+
+    /// The tile is resident until the store spills it.
+    /// \param store The store of the tile
+    /// \param tile The tile data
+    OutOfCoreTile(const std::shared_ptr<TileStore>& store, const Tile& tile) :
+      record_(std::make_shared<Record>(store, tile))
+    {
+      TA_ASSERT(store);
+      store->touch(record_, record_->bytes());
+    }
+
+    /// Check that the tile is empty
+
+    /// \return \c true if this tile has no data
+    bool empty() const { return ! record_; }
+
+    /// Tile range accessor
+
+    /// \return The range of the tile
+    const range_type& range() const {
+      TA_ASSERT(record_);
+      return record_->range();
+    }
+
+    /// Check that the tile data is in memory
+
+    /// \return \c true if the data of this tile is resident
+    bool is_resident() const { return record_ && record_->is_resident(); }
+
+    /// Evaluate the tile
+
+    /// A resident tile is returned immediately; a spilled tile is read by a
+    /// task.
+    /// \return A future to the tile data
+    explicit operator Future<eval_type>() const {
+      TA_ASSERT(record_);
+      std::shared_ptr<Tile> tile = record_->resident();
+      if(tile) {
+        if(record_->store())
+          record_->store()->touch(record_, record_->bytes());
+        return Future<eval_type>(*tile);
+      }
+      return record_->store()->world().taskq.add(& OutOfCoreTile_::load_task,
+          record_, madness::TaskAttributes::hipri());
+    }
+
+    /// Serialize the tile data
+
+    /// The data of the tile is sent, and the received tile is resident and
+    /// is not stored.
+    /// \tparam Archive The archive type
+    /// \param ar The archive
+    template <typename Archive,
+        typename std::enable_if<madness::archive::is_output_archive<Archive>::value>::type* = nullptr>
+    void serialize(const Archive& ar) {
+      TA_ASSERT(record_);
+      Tile tile = record_->load();
+      ar & tile;
+    }
+
+    /// Deserialize the tile data
+
+    /// \tparam Archive The archive type
+    /// \param ar The archive
+    template <typename Archive,
+        typename std::enable_if<madness::archive::is_input_archive<Archive>::value>::type* = nullptr>
+    void serialize(const Archive& ar) {
+      Tile tile;
+      ar & tile;
+      record_ = std::make_shared<Record>(tile);
+    }
+
+  }; // class OutOfCoreTile
+
+  /// Make an out-of-core tile
+
+  /// \tparam Tile The tile type
+  /// \param store The store of the tile
+  /// \param tile The tile data
+  /// \return An out-of-core tile with the data of \c tile
+  template <typename Tile>
+  inline OutOfCoreTile<Tile>
+  make_out_of_core(const std::shared_ptr<TileStore>& store, const Tile& tile) {
+    return OutOfCoreTile<Tile>(store, tile);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_OUT_OF_CORE_H__INCLUDED
@@ -27,6 +27,7 @@
 #define TILEDARRAY_PERM_INDEX_H__INCLUDED
 
 #include <TiledArray/range.h>
+#include <array>
 
 namespace TiledArray {
   namespace detail {
@@ -40,6 +41,31 @@ namespace TiledArray {
       std::size_t* weights_; ///< A pointer that stores both the input and
                              ///< output weights (or strides).
       unsigned int ndim_; ///< The number of dimensions in the coordinate index space
+      /// The weights of permutations of up to \c Permutation::max_inline_dim
+      /// dimensions, which are not allocated
+      std::array<std::size_t, 2u * Permutation::max_inline_dim> small_weights_;
+
+      /// Allocate the weights
+
+      /// \param ndim The number of dimensions
+      void allocate(const unsigned int ndim) {
+        ndim_ = ndim;
+        if(ndim_ <= Permutation::max_inline_dim) {
+          weights_ = small_weights_.data();
+        } else {
+          weights_ = static_cast<std::size_t*>(malloc((ndim_ + ndim_) * sizeof(std::size_t)));
+          if(! weights_)
+            throw std::bad_alloc();
+        }
+      }
+
+      /// Deallocate the weights
+      void deallocate() {
+        if(weights_ != small_weights_.data())
+          free(weights_);
+        weights_ = NULL;
+        ndim_ = 0u;
+      }
 
     public:
 
@@ -48,24 +74,21 @@ namespace TiledArray {
 
       /// Construct permuting functor
 
+      /// Permutations of up to \c Permutation::max_inline_dim dimensions do
+      /// not allocate memory.
       /// \param range The input range of ordinal indices
       PermIndex(const Range& range, const Permutation& perm) :
-        weights_(NULL), ndim_(perm.dim())
+        weights_(NULL), ndim_(0)
       {
-        if(ndim_ > 0) {
+        if(perm.dim() > 0) {
           // Check the input data
           TA_ASSERT(range.rank() == perm.dim());
 
-          // Construct the inverse permutation
-          const Permutation inv_perm_ = -perm;
-
-          // Allocate memory for this object
-          weights_ = static_cast<std::size_t*>(malloc((ndim_ + ndim_) * sizeof(std::size_t)));
-          if(! weights_)
-            throw std::bad_alloc();
+          allocate(perm.dim());
 
-          // Construct MADNESS_RESTRICTed pointers to the input data
-          const auto* MADNESS_RESTRICT const inv_perm = & inv_perm_.data().front();
+          // Construct MADNESS_RESTRICTed pointers to the input data, and the
+          // inverse permutation, which is stored with the permutation
+          const auto* MADNESS_RESTRICT const inv_perm = perm.inv_data().begin();
           const auto* MADNESS_RESTRICT const range_size = range.extent_data();
           const auto* MADNESS_RESTRICT const range_weight = range.stride_data();
 
@@ -90,44 +113,32 @@ namespace TiledArray {
       }
 
       PermIndex(const PermIndex& other) :
-        weights_(NULL), ndim_(other.ndim_)
+        weights_(NULL), ndim_(0)
       {
-        if(ndim_) {
-          // Allocate memory for this object
-          weights_ = static_cast<std::size_t*>(malloc((ndim_ + ndim_) * sizeof(std::size_t)));
-          if(! weights_)
-            throw std::bad_alloc();
+        if(other.ndim_) {
+          allocate(other.ndim_);
 
           // Copy data
           memcpy(weights_, other.weights_, (ndim_ + ndim_) * sizeof(std::size_t));
         }
       }
 
-      ~PermIndex() {
-        free(weights_);
-        weights_ = NULL;
-      }
+      ~PermIndex() { deallocate(); }
 
       PermIndex& operator=(const PermIndex& other) {
-        // Deallocate memory
-        if(ndim_ && (ndim_ != other.ndim_)) {
-          free(weights_);
-          weights_ = NULL;
-        }
-
-        const std::size_t bytes = (other.ndim_ + other.ndim_) * sizeof(std::size_t);
+        if(this != &other) {
+          // Reallocate memory
+          if(ndim_ != other.ndim_) {
+            deallocate();
+            if(other.ndim_)
+              allocate(other.ndim_);
+          }
 
-        if(! weights_ && bytes) {
-          // Allocate new memory
-          weights_ = static_cast<std::size_t*>(malloc(bytes));
-          if(! weights_)
-            throw std::bad_alloc();
+          // copy the data (safe if ndim_ == 0)
+          if(ndim_)
+            memcpy(weights_, other.weights_, (ndim_ + ndim_) * sizeof(std::size_t));
         }
 
-        // copy the data (safe if ndim_ == 0)
-        ndim_ = other.ndim_;
-        memcpy(weights_, other.weights_, bytes);
-
         return *this;
       }
 
@@ -23,8 +23,20 @@
 #include <TiledArray/error.h>
 #include <TiledArray/type_traits.h>
 #include <TiledArray/utility.h>
+#include <algorithm>
 #include <array>
 #include <numeric>
+#include <vector>
+
+// Forward declaration of MADNESS archive type traits
+namespace madness {
+  namespace archive {
+
+    template <typename> struct is_output_archive;
+    template <typename> struct is_input_archive;
+
+  }  // namespace archive
+}  // namespace madness
 
 namespace TiledArray {
 
@@ -120,12 +132,83 @@ namespace TiledArray {
   public:
     typedef Permutation Permutation_;
     typedef unsigned int index_type;
-    typedef std::vector<index_type>::const_iterator const_iterator;
+    typedef const index_type* const_iterator;
+
+    /// The largest domain size of permutations that do not allocate memory
+    static constexpr unsigned int max_inline_dim = 8u;
+
+    /// Read-only view of the elements of a permutation
+    class Indices {
+      const index_type* first_; ///< The first element
+      const index_type* last_; ///< One past the last element
+
+    public:
+      typedef index_type value_type;
+      typedef const index_type* const_iterator;
+
+      Indices(const index_type* first, const index_type* last) :
+        first_(first), last_(last)
+      { }
+
+      const_iterator begin() const { return first_; }
+      const_iterator end() const { return last_; }
+      const_iterator cbegin() const { return first_; }
+      const_iterator cend() const { return last_; }
+      std::size_t size() const { return last_ - first_; }
+      bool empty() const { return first_ == last_; }
+      index_type operator[](const std::size_t i) const { return first_[i]; }
+      const index_type& front() const { TA_ASSERT(! empty()); return *first_; }
+      const index_type& back() const { TA_ASSERT(! empty()); return *(last_ - 1); }
+
+      /// \return A copy of the elements
+      operator std::vector<index_type>() const {
+        return std::vector<index_type>(first_, last_);
+      }
+    }; // class Indices
 
   private:
 
-    /// One-line representation of permutation
-    std::vector<index_type> p_;
+    /// The one-line representation of the permutation followed by that of
+    /// its inverse, for domains of up to \c max_inline_dim elements
+    std::array<index_type, 2u * max_inline_dim> small_{};
+    /// The one-line representation of the permutation followed by that of
+    /// its inverse, for larger domains
+    std::vector<index_type> large_;
+    unsigned int dim_ = 0u; ///< The domain size
+
+    /// \return A pointer to the one-line representation
+    const index_type* p_() const {
+      return (dim_ <= max_inline_dim ? small_.data() : large_.data());
+    }
+
+    /// \return A pointer to the one-line representation of the inverse
+    const index_type* inv_() const { return p_() + dim_; }
+
+    /// Set the domain size
+
+    /// \param n The domain size
+    /// \return A pointer to the storage of the one-line representation of
+    /// the permutation and of its inverse
+    index_type* resize_(const unsigned int n) {
+      dim_ = n;
+      if(n <= max_inline_dim) {
+        large_.clear();
+        return small_.data();
+      }
+      large_.resize(2u * n);
+      return large_.data();
+    }
+
+    /// Store a permutation and compute its inverse
+    template <typename InIter>
+    void assign_(InIter first, InIter last) {
+      index_type* const p = resize_(std::distance(first, last));
+      index_type* const inv = p + dim_;
+      std::copy(first, last, p);
+      for(index_type i = 0u; i < dim_; ++i)
+        if(p[i] < dim_)
+          inv[p[i]] = i;
+    }
 
     /// Validate input permutation
     /// \return \c false if each element of [first, last) is non-negative, unique and less than the size of the domain.
@@ -164,10 +247,9 @@ namespace TiledArray {
     /// duplicate elements.
     template <typename InIter,
         typename std::enable_if<detail::is_input_iterator<InIter>::value>::type* = nullptr>
-    Permutation(InIter first, InIter last) :
-        p_(first, last)
-    {
+    Permutation(InIter first, InIter last) {
       TA_ASSERT( valid_permutation(first, last) );
+      assign_(first, last);
     }
 
     /// Array constructor
@@ -182,13 +264,11 @@ namespace TiledArray {
 
     /// std::vector move constructor
 
-    /// Move the content of the std::vector into this permutation
-    /// \param a The permutation array to be moved
+    /// Construct a permutation from the content of a std::vector
+    /// \param a The permutation array
     explicit Permutation(std::vector<index_type>&& a) :
-        p_(std::move(a))
-    {
-      TA_ASSERT( valid_permutation(p_.begin(), p_.end()) );
-    }
+        Permutation(a.begin(), a.end())
+    { }
 
     /// Construct permutation with an initializer list
 
@@ -203,33 +283,33 @@ namespace TiledArray {
     /// Domain size accessor
 
     /// \return The domain size
-    index_type dim() const { return p_.size(); }
+    index_type dim() const { return dim_; }
 
     /// Begin element iterator factory function
 
     /// \return An iterator that points to the beginning of the element range
-    const_iterator begin() const { return p_.begin(); }
+    const_iterator begin() const { return p_(); }
 
     /// Begin element iterator factory function
 
     /// \return An iterator that points to the beginning of the element range
-    const_iterator cbegin() const { return p_.cbegin(); }
+    const_iterator cbegin() const { return p_(); }
 
     /// End element iterator factory function
 
     /// \return An iterator that points to the end of the element range
-    const_iterator end() const { return p_.end(); }
+    const_iterator end() const { return p_() + dim_; }
 
     /// End element iterator factory function
 
     /// \return An iterator that points to the end of the element range
-    const_iterator cend() const { return p_.cend(); }
+    const_iterator cend() const { return p_() + dim_; }
 
     /// Element accessor
 
     /// \param i The element index
     /// \return The i-th element
-    index_type operator[](unsigned int i) const { return p_[i]; }
+    index_type operator[](unsigned int i) const { return p_()[i]; }
 
     /// Cycles decomposition
 
@@ -249,20 +329,21 @@ namespace TiledArray {
 
       std::vector<std::vector<index_type>> result;
 
-      std::vector<bool> placed_in_cycle(p_.size(), false);
+      const index_type* const p = p_();
+      std::vector<bool> placed_in_cycle(dim_, false);
 
       // 1. for each i compute its orbit
       // 2. if the orbit is longer than 1, sort and add to the list of cycles
-      for(index_type i=0; i!= p_.size(); ++i) {
+      for(index_type i=0; i!= dim_; ++i) {
         if (not placed_in_cycle[i]) {
           std::vector<index_type> cycle(1,i);
           placed_in_cycle[i] = true;
 
-          index_type next_i = p_[i];
+          index_type next_i = p[i];
           while (next_i != i) {
             cycle.push_back(next_i);
             placed_in_cycle[next_i] = true;
-            next_i = p_[next_i];
+            next_i = p[next_i];
           }
 
           if (cycle.size() != 1) {
@@ -282,31 +363,33 @@ namespace TiledArray {
     /// \return An identity permutation for \c dim elements
     static Permutation identity(const unsigned int dim) {
       Permutation result;
-      result.p_.reserve(dim);
+      index_type* const p = result.resize_(dim);
       for(unsigned int i = 0u; i < dim; ++i)
-        result.p_.emplace_back(i);
+        p[i] = p[dim + i] = i;
       return result;
     }
 
     /// Identity permutation factory function
 
     /// \return An identity permutation
-    Permutation identity() const { return identity(p_.size()); }
+    Permutation identity() const { return identity(dim_); }
 
     /// Product of this permutation by \c other
 
     /// \param other a Permutation
     /// \return \c other * \c this, i.e. this applied first, then other
     Permutation mult(const Permutation& other) const {
-      const unsigned int n = p_.size();
-      TA_ASSERT(n == other.p_.size());
+      const unsigned int n = dim_;
+      TA_ASSERT(n == other.dim_);
       Permutation result;
-      result.p_.reserve(n);
+      index_type* const result_p = result.resize_(n);
+      const index_type* const p = p_();
+      const index_type* const other_p = other.p_();
 
       for(unsigned int i = 0u; i < n; ++i) {
-        const index_type p_i = p_[i];
-        const index_type result_i = other.p_[p_i];
-        result.p_.emplace_back(result_i);
+        const index_type result_i = other_p[p[i]];
+        result_p[i] = result_i;
+        result_p[n + result_i] = i;
       }
 
       return result;
@@ -315,16 +398,14 @@ namespace TiledArray {
     /// Construct the inverse of this permutation
 
     /// The inverse of the permutation is defined as \f$ P \times P^{-1} = I \f$,
-    /// where \f$ I \f$ is the identity permutation.
+    /// where \f$ I \f$ is the identity permutation. The inverse is computed
+    /// when the permutation is constructed, so this is a copy.
     /// \return The inverse of this permutation
     Permutation inv() const {
-      const index_type n = p_.size();
       Permutation result;
-      result.p_.resize(n, 0ul);
-      for(index_type i = 0ul; i < n; ++i) {
-        const index_type pi = p_[i];
-        result.p_[pi] = i;
-      }
+      index_type* const result_p = result.resize_(dim_);
+      std::copy(inv_(), inv_() + dim_, result_p);
+      std::copy(p_(), p_() + dim_, result_p + dim_);
       return result;
     }
 
@@ -346,7 +427,7 @@ namespace TiledArray {
         power = n;
       }
 
-      Permutation result = identity(p_.size());
+      Permutation result = identity(dim_);
 
       // Compute the power of value with the exponentiation by squaring.
       while(power) {
@@ -362,26 +443,47 @@ namespace TiledArray {
     /// Bool conversion
 
     /// \return \c true if the permutation is not empty, otherwise \c false.
-    operator bool() const { return ! p_.empty(); }
+    operator bool() const { return dim_ != 0u; }
 
     /// Not operator
 
     /// \return \c true if the permutation is empty, otherwise \c false.
-    bool operator!() const { return p_.empty(); }
+    bool operator!() const { return dim_ == 0u; }
 
     /// Permutation data accessor
 
-    /// \return A reference to the array of permutation elements
-    const std::vector<index_type>& data() const { return p_; }
+    /// \return A view of the array of permutation elements
+    Indices data() const { return Indices(p_(), p_() + dim_); }
+
+    /// Inverse permutation data accessor
+
+    /// \return A view of the array of the elements of the inverse
+    /// permutation, which is stored with the permutation
+    Indices inv_data() const { return Indices(inv_(), inv_() + dim_); }
 
     /// Serialize permutation
 
     /// MADNESS compatible serialization function
     /// \tparam Archive The serialization archive type
     /// \param[in,out] ar The serialization archive
-    template <typename Archive>
+    template <typename Archive,
+        typename std::enable_if<madness::archive::is_output_archive<Archive>::value>::type* = nullptr>
+    void serialize(Archive& ar) const {
+      const std::vector<index_type> p(begin(), end());
+      ar & p;
+    }
+
+    /// Deserialize permutation
+
+    /// MADNESS compatible serialization function
+    /// \tparam Archive The serialization archive type
+    /// \param[in,out] ar The serialization archive
+    template <typename Archive,
+        typename std::enable_if<madness::archive::is_input_archive<Archive>::value>::type* = nullptr>
     void serialize(Archive& ar) {
-      ar & p_;
+      std::vector<index_type> p;
+      ar & p;
+      assign_(p.begin(), p.end());
     }
 
   }; // class Permutation
@@ -0,0 +1,200 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  balanced_grid_pmap.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_BALANCED_GRID_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_BALANCED_GRID_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Imbalance of the cyclic SUMMA grid that selects a balanced grid
+
+    /// A contraction that would be evaluated by SUMMA is evaluated on a
+    /// \c BalancedGridPmap when the largest work of a process in the cyclic
+    /// grid exceeds that of the balanced grid by this factor. The default
+    /// is 1.25, or the value of the \c TA_BALANCED_GRID_THRESHOLD
+    /// environment variable; zero disables balanced grids.
+    /// \return A reference to the threshold
+    inline double& balanced_grid_threshold() {
+      static double threshold = [] () {
+        const char* value = getenv("TA_BALANCED_GRID_THRESHOLD");
+        return (value ? std::stod(value) : 1.25);
+      }();
+      return threshold;
+    }
+
+    /// A two-dimensional process map balanced by row and column weights
+
+    /// Like \c CyclicPmap , the tiles of a matrix are mapped to a grid of
+    /// processes, where all tiles of a row are in the same process row and
+    /// all tiles of a column are in the same process column, but the rows
+    /// (columns) are assigned to the process rows (columns) by weight
+    /// instead of cyclically. Each row is assigned, from the heaviest to the
+    /// lightest, to the process row with the smallest total weight (greedy
+    /// longest-processing-time assignment), and the columns likewise. With
+    /// the number of elements of the rows and columns as weights, the work
+    /// of each process of a contraction, which is proportional to the
+    /// product of its row and column weights, is balanced for irregular
+    /// tilings, where the cyclic assignment may leave some processes with
+    /// much more work than others.
+    class BalancedGridPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const size_type cols_; ///< Number of tile columns to be mapped
+      const size_type proc_cols_; ///< Number of process columns
+      const std::vector<size_type> row_procs_; ///< The process row of each row
+      const std::vector<size_type> col_procs_; ///< The process column of each column
+
+    public:
+      typedef Pmap::size_type size_type; ///< Key type
+
+      /// Assign weighted items to bins
+
+      /// \param weights The weight of each item
+      /// \param bins The number of bins
+      /// \return The bin of each item
+      static std::vector<size_type>
+      assign(const std::vector<size_type>& weights, const size_type bins) {
+        TA_ASSERT(bins > 0ul);
+        std::vector<size_type> order(weights.size());
+        std::iota(order.begin(), order.end(), 0ul);
+        std::stable_sort(order.begin(), order.end(),
+            [&weights] (const size_type a, const size_type b) { return weights[a] > weights[b]; });
+
+        std::vector<size_type> result(weights.size(), 0ul);
+        std::vector<size_type> loads(bins, 0ul);
+        std::vector<size_type> counts(bins, 0ul);
+        for(const size_type item : order) {
+          // Ties are broken by the number of items, so zero weights are
+          // also spread over the bins
+          size_type bin = 0ul;
+          for(size_type b = 1ul; b < bins; ++b)
+            if((loads[b] < loads[bin]) || ((loads[b] == loads[bin]) && (counts[b] < counts[bin])))
+              bin = b;
+          result[item] = bin;
+          loads[bin] += weights[item];
+          ++counts[bin];
+        }
+
+        return result;
+      }
+
+      /// Assign weighted items to bins cyclically
+
+      /// \param size The number of items
+      /// \param bins The number of bins
+      /// \return The bin of each item
+      static std::vector<size_type>
+      assign_cyclic(const size_type size, const size_type bins) {
+        std::vector<size_type> result(size);
+        for(size_type i = 0ul; i < size; ++i)
+          result[i] = i % bins;
+        return result;
+      }
+
+      /// The largest total weight of a bin
+
+      /// \param weights The weight of each item
+      /// \param bins The bin of each item
+      /// \param nbins The number of bins
+      /// \return The largest total weight of the items of a bin
+      static size_type max_load(const std::vector<size_type>& weights,
+          const std::vector<size_type>& bins, const size_type nbins)
+      {
+        std::vector<size_type> loads(nbins, 0ul);
+        for(size_type i = 0ul; i < weights.size(); ++i)
+          loads[bins[i]] += weights[i];
+        return *std::max_element(loads.begin(), loads.end());
+      }
+
+      /// Construct process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param row_weights The weight of each tile row, which must be the
+      /// same on all processes
+      /// \param col_weights The weight of each tile column, which must be
+      /// the same on all processes
+      /// \param proc_rows The number of process rows in the map
+      /// \param proc_cols The number of process columns in the map
+      BalancedGridPmap(World& world, const std::vector<size_type>& row_weights,
+          const std::vector<size_type>& col_weights, const size_type proc_rows,
+          const size_type proc_cols) :
+        Pmap(world, row_weights.size() * col_weights.size()),
+        cols_(col_weights.size()), proc_cols_(proc_cols),
+        row_procs_(assign(row_weights, proc_rows)),
+        col_procs_(assign(col_weights, proc_cols))
+      {
+        TA_ASSERT((proc_rows * proc_cols) <= procs_);
+
+        // Initialize local tile list
+        if(rank_ < (proc_rows * proc_cols)) {
+          const size_type rank_row = rank_ / proc_cols_;
+          const size_type rank_col = rank_ % proc_cols_;
+          for(size_type i = 0ul; i < row_procs_.size(); ++i) {
+            if(row_procs_[i] != rank_row) continue;
+            for(size_type j = 0ul; j < cols_; ++j)
+              if(col_procs_[j] == rank_col)
+                local_.push_back(i * cols_ + j);
+          }
+        }
+      }
+
+      virtual ~BalancedGridPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return row_procs_[tile / cols_] * proc_cols_ + col_procs_[tile % cols_];
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return (BalancedGridPmap::owner(tile) == rank_);
+      }
+
+    }; // class BalancedGridPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_BALANCED_GRID_PMAP_H__INCLUDED
@@ -0,0 +1,97 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  batch_pmap.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_BATCH_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_BATCH_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Maps the batches of a tile array cyclically onto processes
+
+    /// The tiles are grouped into \c batches consecutive blocks of
+    /// \c batch_size tiles, i.e. the batch of a tile is given by the leading
+    /// dimensions of its index, and all tiles of a batch are owned by the same
+    /// process. Arrays with the same number of batches, e.g. the arguments and
+    /// the result of a batched contraction, are mapped such that the tiles of
+    /// each batch are on the same process.
+    class BatchPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const size_type batch_size_; ///< The number of tiles in each batch
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// Construct batch map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param batches The number of batches
+      /// \param batch_size The number of tiles in each batch
+      BatchPmap(World& world, const size_type batches, const size_type batch_size) :
+        Pmap(world, batches * batch_size), batch_size_(batch_size)
+      {
+        TA_ASSERT(batch_size_ > 0ul);
+
+        // Construct a map of all local tiles
+        for(size_type b = rank_; b < batches; b += procs_) {
+          const size_type first = b * batch_size_;
+          for(size_type i = first; i < (first + batch_size_); ++i)
+            local_.push_back(i);
+        }
+      }
+
+      virtual ~BatchPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return (tile / batch_size_) % procs_;
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return (BatchPmap::owner(tile) == rank_);
+      }
+
+    }; // class BatchPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_BATCH_PMAP_H__INCLUDED
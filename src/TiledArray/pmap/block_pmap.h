@@ -0,0 +1,182 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  block_pmap.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_BLOCK_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_BLOCK_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <TiledArray/range.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Process map of a sub-block of an array
+
+    /// Each tile of a sub-block, whose tile index may be permuted, is mapped
+    /// to the owner of the corresponding tile of the array, so the tiles of
+    /// the sub-block are evaluated where the array tiles are stored instead
+    /// of being moved to a new distribution.
+    class BlockPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      std::shared_ptr<const Pmap> pmap_; ///< The process map of the array
+      size_type offset_; ///< The array ordinal of the first tile of the block
+      std::vector<size_type> extent_; ///< The extents of the (permuted) block
+      std::vector<size_type> stride_; ///< The strides of the (permuted) block
+      std::vector<size_type> weight_; ///< The array stride of each block dimension
+
+      /// Compute the number of tiles in a block
+
+      /// \param lower_bound The lower bound of the block
+      /// \param upper_bound The upper bound of the block
+      /// \return The number of tiles in the block
+      static size_type volume(const std::vector<std::size_t>& lower_bound,
+          const std::vector<std::size_t>& upper_bound)
+      {
+        TA_ASSERT(lower_bound.size() == upper_bound.size());
+        size_type result = 1ul;
+        for(std::size_t d = 0ul; d < lower_bound.size(); ++d) {
+          TA_ASSERT(lower_bound[d] <= upper_bound[d]);
+          result *= upper_bound[d] - lower_bound[d];
+        }
+        return result;
+      }
+
+      /// Convert a block ordinal into an array ordinal
+
+      /// \param tile The ordinal index of a tile of the block
+      /// \return The ordinal index of the corresponding array tile
+      size_type array_ordinal(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        size_type result = offset_;
+        for(std::size_t r = 0ul; r < extent_.size(); ++r)
+          result += ((tile / stride_[r]) % extent_[r]) * weight_[r];
+        return result;
+      }
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// Construct a block process map
+
+      /// \param world The world where the tiles are mapped
+      /// \param pmap The process map of the array
+      /// \param array_range The tile range of the array
+      /// \param lower_bound The lower bound of the block
+      /// \param upper_bound The upper bound of the block
+      /// \param perm The permutation that is applied to the block tile
+      /// indices [ default = no permutation ]
+      BlockPmap(World& world, const std::shared_ptr<const Pmap>& pmap,
+          const Range& array_range, const std::vector<std::size_t>& lower_bound,
+          const std::vector<std::size_t>& upper_bound,
+          const Permutation& perm = Permutation()) :
+        Pmap(world, volume(lower_bound, upper_bound)), pmap_(pmap), offset_(0ul),
+        extent_(lower_bound.size()), stride_(lower_bound.size()),
+        weight_(lower_bound.size())
+      {
+        const unsigned int rank = lower_bound.size();
+        TA_ASSERT(pmap_);
+        TA_ASSERT(array_range.rank() == rank);
+        TA_ASSERT((! perm) || (perm.dim() == rank));
+        const auto* MADNESS_RESTRICT const lobound = array_range.lobound_data();
+        const auto* MADNESS_RESTRICT const array_extent = array_range.extent_data();
+        const auto* MADNESS_RESTRICT const array_stride = array_range.stride_data();
+
+        // Dimension d of the array is dimension perm[d] of the block
+        for(unsigned int d = 0u; d < rank; ++d) {
+          const unsigned int r = (perm ? perm[d] : d);
+          extent_[r] = upper_bound[d] - lower_bound[d];
+          weight_[r] = array_stride[d];
+          offset_ += (lower_bound[d] - lobound[d]) * array_stride[d];
+        }
+        size_type stride = 1ul;
+        for(unsigned int r = rank; r > 0u; --r) {
+          stride_[r - 1u] = stride;
+          stride *= extent_[r - 1u];
+        }
+
+        // The local tiles of the block are the local array tiles that are
+        // included in the block
+        for(const size_type tile : *pmap_) {
+          size_type ordinal = 0ul;
+          unsigned int d = 0u;
+          for(; d < rank; ++d) {
+            const size_type i = (tile / array_stride[d]) % array_extent[d] + lobound[d];
+            if((i < lower_bound[d]) || (i >= upper_bound[d]))
+              break;
+            ordinal += (i - lower_bound[d]) * stride_[perm ? perm[d] : d];
+          }
+          if(d == rank)
+            local_.push_back(ordinal);
+        }
+        if(perm)
+          std::sort(local_.begin(), local_.end());
+      }
+
+      virtual ~BlockPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        return pmap_->owner(array_ordinal(tile));
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return pmap_->is_local(array_ordinal(tile));
+      }
+
+      /// Replicated array status
+
+      /// \return \c true if the array process map is replicated
+      virtual bool is_replicated() const { return pmap_->is_replicated(); }
+
+      /// NUMA node of a tile
+
+      /// \param tile The tile to be queried
+      /// \return The NUMA node of the corresponding array tile
+      virtual int numa_node(const size_type tile) const {
+        return pmap_->numa_node(array_ordinal(tile));
+      }
+
+    }; // class BlockPmap
+
+  } // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_BLOCK_PMAP_H__INCLUDED
@@ -0,0 +1,104 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  fiber_pmap.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_FIBER_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_FIBER_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Maps whole rows, or whole columns, of a tile matrix to processes
+
+    /// All tiles of a row (column) of a \c rows by \c cols matrix of tiles
+    /// are owned by the process given for that row (column). The result of
+    /// a contraction with a replicated argument is mapped this way, so each
+    /// result tile is owned by the process that holds the row (column) of
+    /// the other argument.
+    class FiberPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const size_type cols_; ///< Number of tile columns to be mapped
+      const bool by_row_; ///< The owners are given for the rows
+      const std::vector<size_type> owners_; ///< The owner of each row (column)
+
+    public:
+      typedef Pmap::size_type size_type; ///< Key type
+
+      /// Construct fiber map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param rows The number of tile rows to be mapped
+      /// \param cols The number of tile columns to be mapped
+      /// \param by_row \c true if \c owners are the owners of the rows,
+      /// \c false if they are the owners of the columns
+      /// \param owners The owner of each row or column, which must be the
+      /// same on all processes
+      FiberPmap(World& world, const size_type rows, const size_type cols,
+          const bool by_row, const std::vector<size_type>& owners) :
+        Pmap(world, rows * cols), cols_(cols), by_row_(by_row), owners_(owners)
+      {
+        TA_ASSERT(owners_.size() == (by_row_ ? rows : cols));
+
+        // Construct a map of all local tiles
+        for(size_type i = 0ul; i < size_; ++i)
+          if(FiberPmap::owner(i) == rank_)
+            local_.push_back(i);
+      }
+
+      virtual ~FiberPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        const size_type owner = owners_[by_row_ ? tile / cols_ : tile % cols_];
+        TA_ASSERT(owner < procs_);
+        return owner;
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return (FiberPmap::owner(tile) == rank_);
+      }
+
+    }; // class FiberPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_FIBER_PMAP_H__INCLUDED
@@ -0,0 +1,212 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  layered_cyclic_pmap.h
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Maps cyclically a matrix of indices onto a stack of 2-d process grids
+
+    /// The process set is divided into \c layers contiguous blocks of
+    /// \c layer_size processes, each of which is organized into a
+    /// \f$ P_{\rm row} \times P_{\rm col} \f$ process grid. One dimension of
+    /// the tile matrix (the layered dimension) is partitioned into \c layers
+    /// contiguous blocks of near equal size; tiles in block \f$ l \f$ are
+    /// mapped cyclically, as with \c CyclicPmap, onto the process grid of
+    /// layer \f$ l \f$. With one layer this map is identical to \c CyclicPmap.
+    ///
+    /// \note This class is used to map the tiles of the arguments of a layered
+    /// (2.5D) SUMMA contraction, where the layered dimension is the inner
+    /// (contracted) dimension.
+    class LayeredCyclicPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const size_type rows_; ///< Number of tile rows to be mapped
+      const size_type cols_; ///< Number of tile columns to be mapped
+      const size_type proc_rows_; ///< Number of process rows in each layer
+      const size_type proc_cols_; ///< Number of process columns in each layer
+      const size_type layers_; ///< Number of process grid layers
+      const size_type layer_size_; ///< Rank stride between layers
+      const bool layer_cols_; ///< \c true if columns are layered, \c false if rows are
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// First index of a layer block
+
+      /// \param layer The layer index
+      /// \param extent The extent of the layered dimension
+      /// \param layers The number of layers
+      /// \return The first index of the layered dimension assigned to \c layer
+      static size_type layer_begin(const size_type layer, const size_type extent,
+          const size_type layers)
+      {
+        TA_ASSERT(layer <= layers);
+        return (layer * extent) / layers;
+      }
+
+      /// Layer that holds an index
+
+      /// \param index An index of the layered dimension
+      /// \param extent The extent of the layered dimension
+      /// \param layers The number of layers
+      /// \return The layer that contains \c index
+      static size_type layer_of(const size_type index, const size_type extent,
+          const size_type layers)
+      {
+        TA_ASSERT(index < extent);
+        return ((index + 1ul) * layers - 1ul) / extent;
+      }
+
+      /// Construct process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param rows The number of tile rows to be mapped
+      /// \param cols The number of tile columns to be mapped
+      /// \param proc_rows The number of process rows in each layer
+      /// \param proc_cols The number of process columns in each layer
+      /// \param layers The number of process grid layers
+      /// \param layer_size The rank stride between layers
+      /// \param layer_cols If \c true, columns are partitioned among layers,
+      /// otherwise rows are
+      /// \throw TiledArray::Exception When <tt>proc_rows * proc_cols > layer_size</tt>
+      /// \throw TiledArray::Exception When <tt>layers * layer_size > world.size()</tt>
+      /// \throw TiledArray::Exception When \c layers is larger than the extent
+      /// of the layered dimension
+      LayeredCyclicPmap(World& world, size_type rows, size_type cols,
+          size_type proc_rows, size_type proc_cols, size_type layers,
+          size_type layer_size, bool layer_cols) :
+        Pmap(world, rows * cols), rows_(rows), cols_(cols),
+        proc_rows_(proc_rows), proc_cols_(proc_cols), layers_(layers),
+        layer_size_(layer_size), layer_cols_(layer_cols)
+      {
+        // Check that the size is non-zero
+        TA_ASSERT(rows_ >= 1ul);
+        TA_ASSERT(cols_ >= 1ul);
+
+        // Check limits of process rows, columns, and layers
+        TA_ASSERT(proc_rows_ >= 1ul);
+        TA_ASSERT(proc_cols_ >= 1ul);
+        TA_ASSERT(layers_ >= 1ul);
+        TA_ASSERT((proc_rows_ * proc_cols_) <= layer_size_);
+        TA_ASSERT((layers_ * layer_size_) <= procs_);
+        TA_ASSERT(layers_ <= (layer_cols_ ? cols_ : rows_));
+
+        // Initialize local tile list
+        const size_type layer = rank_ / layer_size_;
+        const size_type layer_rank = rank_ % layer_size_;
+        if((layer < layers_) && (layer_rank < (proc_rows_ * proc_cols_))) {
+          // Compute rank coordinates
+          const size_type rank_row = layer_rank / proc_cols_;
+          const size_type rank_col = layer_rank % proc_cols_;
+
+          // Compute the block of the layered dimension held by this layer
+          const size_type extent = (layer_cols_ ? cols_ : rows_);
+          const size_type begin = layer_begin(layer, extent, layers_);
+          const size_type end = layer_begin(layer + 1ul, extent, layers_);
+
+          // Compute the first local row and column
+          size_type row_begin = rank_row, row_end = rows_,
+              col_begin = rank_col, col_end = cols_;
+          if(layer_cols_) {
+            col_begin = begin + ((proc_cols_ - (begin % proc_cols_) + rank_col) % proc_cols_);
+            col_end = end;
+          } else {
+            row_begin = begin + ((proc_rows_ - (begin % proc_rows_) + rank_row) % proc_rows_);
+            row_end = end;
+          }
+
+          // Iterate over local tiles
+          for(size_type i = row_begin; i < row_end; i += proc_rows_) {
+            for(size_type j = col_begin; j < col_end; j += proc_cols_) {
+              const size_type tile = i * cols_ + j;
+              TA_ASSERT(LayeredCyclicPmap::owner(tile) == rank_);
+              local_.push_back(tile);
+            }
+          }
+        }
+      }
+
+      virtual ~LayeredCyclicPmap() { }
+
+      /// Access number of rows in the tile index matrix
+      size_type nrows() const { return rows_; }
+      /// Access number of columns in the tile index matrix
+      size_type ncols() const { return cols_; }
+      /// Access number of rows in the process matrix of each layer
+      size_type nrows_proc() const { return proc_rows_; }
+      /// Access number of columns in the process matrix of each layer
+      size_type ncols_proc() const { return proc_cols_; }
+      /// Access number of process grid layers
+      size_type nlayers() const { return layers_; }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        // Compute tile coordinate in tile grid
+        const size_type tile_row = tile / cols_;
+        const size_type tile_col = tile % cols_;
+        // Compute the layer that holds the tile
+        const size_type layer = (layer_cols_ ?
+            layer_of(tile_col, cols_, layers_) :
+            layer_of(tile_row, rows_, layers_));
+        // Compute process coordinate of tile in the process grid
+        const size_type proc_row = tile_row % proc_rows_;
+        const size_type proc_col = tile_col % proc_cols_;
+        // Compute the process that owns tile
+        const size_type proc = layer * layer_size_ + proc_row * proc_cols_ + proc_col;
+
+        TA_ASSERT(proc < procs_);
+
+        return proc;
+      }
+
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return (LayeredCyclicPmap::owner(tile) == rank_);
+      }
+
+    }; // class LayeredCyclicPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+
+#endif // TILEDARRAY_PMAP_LAYERED_CYCLIC_PMAP_H__INCLUDED
@@ -0,0 +1,170 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_MORTON_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_MORTON_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/weighted_pmap.h>
+#include <TiledArray/range.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// A space-filling-curve process map
+
+    /// The tiles of an N-dimensional tile range are ordered along the Morton
+    /// (Z-order) curve, which visits the tiles of each power-of-two sub-box
+    /// before it leaves the box. The curve is split into contiguous blocks of
+    /// approximately equal size, or weight (see \c WeightedPmap ), one for
+    /// each process. Neighboring tiles, e.g. the tiles near the diagonal of a
+    /// banded matrix, are therefore owned by the same or by few processes.
+    /// The owner of each tile is stored, so this map requires O(N) memory on
+    /// each process.
+    class MortonPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      std::vector<unsigned int> owners_; ///< The owner of each tile
+
+      /// Compare the most significant bits of two integers
+
+      /// \return \c true if the most significant bit of \c x is less than the
+      /// most significant bit of \c y
+      static bool less_msb(const size_type x, const size_type y) {
+        return (x < y) && (x < (x ^ y));
+      }
+
+    public:
+      typedef Pmap::size_type size_type; ///< Key type
+
+      /// Order the tiles of a range along the Morton curve
+
+      /// Two tiles are ordered by the dimension in which their coordinates
+      /// differ in the most significant bit, so the Morton codes are not
+      /// constructed and the rank of the range is not limited. The first
+      /// dimension is the most significant.
+      /// \param range The tile range
+      /// \return The ordinal indices of the tiles in the Morton order
+      static std::vector<size_type> order(const Range& range) {
+        const unsigned int rank = range.rank();
+        const size_type size = range.volume();
+        const size_type* MADNESS_RESTRICT const lobound = range.lobound_data();
+
+        // Tile coordinates relative to the lower bound of the range
+        std::vector<size_type> coords;
+        coords.reserve(size * rank);
+        for(const auto& index : range)
+          for(unsigned int d = 0u; d < rank; ++d)
+            coords.push_back(index[d] - lobound[d]);
+
+        std::vector<size_type> result(size);
+        std::iota(result.begin(), result.end(), 0ul);
+        std::stable_sort(result.begin(), result.end(),
+            [&coords,rank] (const size_type l, const size_type r) {
+              const size_type* MADNESS_RESTRICT const x = coords.data() + l * rank;
+              const size_type* MADNESS_RESTRICT const y = coords.data() + r * rank;
+              unsigned int dim = 0u;
+              size_type msb = 0ul;
+              for(unsigned int d = 0u; d < rank; ++d) {
+                const size_type diff = x[d] ^ y[d];
+                if(less_msb(msb, diff)) {
+                  dim = d;
+                  msb = diff;
+                }
+              }
+              return x[dim] < y[dim];
+            });
+
+        return result;
+      }
+
+      /// Construct Morton map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param range The tile range
+      MortonPmap(World& world, const Range& range) :
+        MortonPmap(world, range, std::vector<size_type>(range.volume(), 1ul))
+      { }
+
+      /// Construct weighted Morton map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param range The tile range
+      /// \param weights The weight of each tile, e.g. its volume or zero for
+      /// a zero tile, which must be the same on all processes
+      MortonPmap(World& world, const Range& range,
+          const std::vector<size_type>& weights) :
+        Pmap(world, range.volume()), owners_(range.volume(), 0u)
+      {
+        TA_ASSERT(weights.size() == size_);
+        const std::vector<size_type> curve = order(range);
+
+        // Partition the tiles along the curve
+        std::vector<size_type> curve_weights(size_);
+        for(size_type i = 0ul; i < size_; ++i)
+          curve_weights[i] = weights[curve[i]];
+        const std::vector<size_type> first =
+            WeightedPmap::partition(curve_weights, procs_);
+
+        for(size_type p = 0ul; p < procs_; ++p)
+          for(size_type i = first[p]; i < first[p + 1ul]; ++i)
+            owners_[curve[i]] = p;
+
+        // Construct a sorted list of the local tiles
+        local_.assign(curve.begin() + first[rank_],
+            curve.begin() + first[rank_ + 1ul]);
+        std::sort(local_.begin(), local_.end());
+      }
+
+      virtual ~MortonPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return owners_[tile];
+      }
+
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return MortonPmap::owner(tile) == rank_;
+      }
+    }; // class MortonPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+
+#endif // TILEDARRAY_PMAP_MORTON_PMAP_H__INCLUDED
@@ -112,6 +112,17 @@ namespace TiledArray {
     /// \return \c true if the array is replicated, and false otherwise
     virtual bool is_replicated() const { return false; }
 
+    /// NUMA affinity of a local tile
+
+    /// Process maps that know which socket will consume a tile may override
+    /// this function; the data of tiles that are initialized by the array
+    /// (e.g. with \c DistArray::init_tiles ) is then allocated in a
+    /// \c NumaScope of this node.
+    /// \param tile The tile to be queried
+    /// \return The NUMA node on which the data of \c tile should be placed,
+    /// or \c -1 if there is no preference
+    virtual int numa_node(const size_type tile) const { return -1; }
+
     /// Begin local element iterator
 
     /// \return An iterator that points to the beginning of the local element set
@@ -0,0 +1,183 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  pmap_diagnostics.h
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_PMAP_DIAGNOSTICS_H__INCLUDED
+#define TILEDARRAY_PMAP_PMAP_DIAGNOSTICS_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Load statistics of a distribution
+
+  /// The statistics are computed from the owners of all tiles, so they are
+  /// the same on every process. The SUMMA estimate treats the array as the
+  /// left argument of a contraction whose first half of the dimensions
+  /// (at least one) are the outer dimensions, i.e. as a matrix of tile rows
+  /// and tile columns, on a \c proc_rows x \c proc_cols process grid. Tile
+  /// row \c r is consumed by the processes of grid row
+  /// <tt>r % proc_rows</tt> , so each non-zero tile is sent by its owner to
+  /// those processes, except itself.
+  struct PmapDiagnostics {
+    std::size_t proc_rows = 0ul; ///< The rows of the SUMMA process grid
+    std::size_t proc_cols = 0ul; ///< The columns of the SUMMA process grid
+    std::vector<std::size_t> tiles; ///< The number of tiles of each process
+    std::vector<std::size_t> nonzero_tiles; ///< The number of non-zero tiles of each process
+    std::vector<std::size_t> nonzero_bytes; ///< The non-zero data of each process, in bytes
+    std::vector<std::size_t> summa_bytes; ///< The data each process sends in a SUMMA product, in bytes
+    double tile_imbalance = 1.0; ///< The largest number of tiles of a process over the average
+    double imbalance = 1.0; ///< The largest non-zero data of a process over the average
+    double summa_imbalance = 1.0; ///< The largest SUMMA data of a process over the average
+    double locality = 1.0; ///< The fraction of the non-zero data that is owned by a consumer
+
+    /// Print the statistics
+
+    /// \param os The output stream
+    void print(std::ostream& os) const {
+      const std::ios::fmtflags flags = os.flags();
+      const std::streamsize precision = os.precision();
+      os << std::setprecision(3) << "Distribution: imbalance (max/avg) tiles "
+         << tile_imbalance << ", non-zero bytes " << imbalance << ", SUMMA bytes "
+         << summa_imbalance << "; locality " << locality << " ("
+         << proc_rows << "x" << proc_cols << " grid)\n";
+      for(std::size_t p = 0ul; p < tiles.size(); ++p)
+        os << "rank " << p << ": " << tiles[p] << " tiles, " << nonzero_tiles[p]
+           << " non-zero, " << nonzero_bytes[p] << " bytes, SUMMA sends "
+           << summa_bytes[p] << " bytes\n";
+      os.flags(flags);
+      os.precision(precision);
+    }
+  }; // struct PmapDiagnostics
+
+  namespace detail {
+
+    /// \return The largest value of \c values over their average, or 1 if
+    /// they are all zero
+    inline double max_over_average(const std::vector<std::size_t>& values) {
+      double sum = 0.0, max = 0.0;
+      for(const std::size_t value : values) {
+        sum += double(value);
+        max = std::max(max, double(value));
+      }
+      return (sum > 0.0 ? max * double(values.size()) / sum : 1.0);
+    }
+
+  } // namespace detail
+
+  /// Compute the load statistics of a process map
+
+  /// \tparam Trange The tiled range type
+  /// \tparam Shape The shape type
+  /// \param pmap The process map
+  /// \param trange The tiled range of the array
+  /// \param shape The shape of the array
+  /// \param element_size The size of an element, in bytes [ default = 8 ]
+  /// \param proc_rows The rows of the SUMMA process grid; the default is the
+  /// largest divisor of the number of processes that is not larger than its
+  /// square root [ default = 0 ]
+  /// \return The load statistics of \c pmap
+  template <typename Trange, typename Shape>
+  inline PmapDiagnostics pmap_diagnostics(const Pmap& pmap,
+      const Trange& trange, const Shape& shape,
+      const std::size_t element_size = sizeof(double),
+      std::size_t proc_rows = 0ul)
+  {
+    TA_USER_ASSERT(pmap.size() == trange.tiles_range().volume(),
+        "pmap_diagnostics(): The size of the process map does not match the tiled range.");
+    const std::size_t procs = pmap.procs();
+    if(proc_rows == 0ul) {
+      proc_rows = std::sqrt(double(procs));
+      while(procs % proc_rows)
+        --proc_rows;
+    }
+    TA_USER_ASSERT((proc_rows <= procs) && (procs % proc_rows == 0ul),
+        "pmap_diagnostics(): The process grid rows must divide the number of processes.");
+
+    PmapDiagnostics result;
+    result.proc_rows = proc_rows;
+    result.proc_cols = procs / proc_rows;
+    result.tiles.assign(procs, 0ul);
+    result.nonzero_tiles.assign(procs, 0ul);
+    result.nonzero_bytes.assign(procs, 0ul);
+    result.summa_bytes.assign(procs, 0ul);
+
+    // Fold the tile range into a matrix of tile rows and columns
+    const auto& tiles_range = trange.tiles_range();
+    const std::size_t rank = tiles_range.rank();
+    std::size_t cols = 1ul;
+    for(std::size_t d = std::max<std::size_t>(rank / 2ul, 1ul); d < rank; ++d)
+      cols *= tiles_range.extent(d);
+
+    double total = 0.0, local = 0.0;
+    for(std::size_t t = 0ul; t < pmap.size(); ++t) {
+      const std::size_t owner = pmap.owner(t);
+      ++result.tiles[owner];
+      if(shape.is_zero(t))
+        continue;
+
+      const std::size_t bytes = trange.make_tile_range(t).volume() * element_size;
+      ++result.nonzero_tiles[owner];
+      result.nonzero_bytes[owner] += bytes;
+
+      const std::size_t grid_row = (t / cols) % proc_rows;
+      const bool consumer = (owner / result.proc_cols == grid_row);
+      result.summa_bytes[owner] += bytes * (result.proc_cols - (consumer ? 1ul : 0ul));
+      total += double(bytes);
+      if(consumer)
+        local += double(bytes);
+    }
+
+    result.tile_imbalance = detail::max_over_average(result.tiles);
+    result.imbalance = detail::max_over_average(result.nonzero_bytes);
+    result.summa_imbalance = detail::max_over_average(result.summa_bytes);
+    if(total > 0.0)
+      result.locality = local / total;
+    return result;
+  }
+
+  /// Compute the load statistics of the distribution of an array
+
+  /// \code
+  /// const auto diagnostics = TiledArray::pmap_diagnostics(a);
+  /// if(world.rank() == 0)
+  ///   diagnostics.print(std::cout);
+  /// \endcode
+  /// \tparam Array The array type
+  /// \param array The array
+  /// \param proc_rows The rows of the SUMMA process grid [ default = 0 ]
+  /// \return The load statistics of the process map of \c array
+  template <typename Array>
+  inline PmapDiagnostics pmap_diagnostics(const Array& array,
+      const std::size_t proc_rows = 0ul)
+  {
+    return pmap_diagnostics(*array.pmap(), array.trange(), array.shape(),
+        sizeof(typename Array::element_type), proc_rows);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_PMAP_DIAGNOSTICS_H__INCLUDED
@@ -0,0 +1,163 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_WEIGHTED_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_WEIGHTED_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <algorithm>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// A weighted, blocked process map
+
+    /// Map N tiles among P processes into contiguous blocks of approximately
+    /// equal weight, where the weight of a tile is e.g. the number of its
+    /// elements, or zero for a zero tile. The weight of each block differs
+    /// from the average by at most the weight of one tile, so a block-sparse
+    /// array is distributed by its non-zero data instead of by the number of
+    /// tiles. The owner of a tile is found by a binary search of the first
+    /// tiles of the blocks, i.e. in O(log P).
+    /// \note The result of a contraction is distributed by the process grid
+    /// of SUMMA, which requires a two-dimensional cyclic map. This process map
+    /// may be used for the arguments of a contraction, which SUMMA broadcasts
+    /// from their owners, and for the other expressions.
+    class WeightedPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const std::vector<size_type> first_; ///< The first tile of each block, and the number of tiles
+
+      template <typename Trange, typename Shape>
+      static std::vector<size_type>
+      make_weights(const Trange& trange, const Shape& shape) {
+        const size_type size = trange.tiles_range().volume();
+        std::vector<size_type> weights(size, 0ul);
+        for(size_type i = 0ul; i < size; ++i)
+          if(! shape.is_zero(i))
+            weights[i] = trange.make_tile_range(i).volume();
+        return weights;
+      }
+
+    public:
+      typedef Pmap::size_type size_type; ///< Key type
+
+      /// Partition weighted tiles into contiguous blocks
+
+      /// Tile \c t , with weight \f$ w_t \f$ and the total weight
+      /// \f$ c_t \f$ of the preceding tiles, is assigned to block
+      /// \f$ \lfloor (c_t + w_t / 2) P / W \rfloor \f$ , where \f$ W \f$ is the
+      /// total weight. Tiles are counted when all weights are zero.
+      /// \param weights The weight of each tile
+      /// \param procs The number of blocks
+      /// \return The first tile of each block, followed by the number of tiles
+      static std::vector<size_type>
+      partition(const std::vector<size_type>& weights, const size_type procs) {
+        TA_ASSERT(procs > 0ul);
+        const size_type size = weights.size();
+        double total = 0.0;
+        for(const size_type weight : weights)
+          total += weight;
+
+        std::vector<size_type> first(procs + 1ul, size);
+        first[0] = 0ul;
+        double preceding = 0.0;
+        size_type block = 0ul;
+        for(size_type t = 0ul; t < size; ++t) {
+          const double weight = (total > 0.0 ? double(weights[t]) : 1.0);
+          const double scale = (total > 0.0 ? total : double(size));
+          const size_type block_t = std::min<size_type>(procs - 1ul,
+              size_type((preceding + 0.5 * weight) * double(procs) / scale));
+          for(; block < block_t; ++block)
+            first[block + 1ul] = t;
+          preceding += weight;
+        }
+
+        return first;
+      }
+
+      /// Construct weighted map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param weights The weight of each tile, which must be the same on
+      /// all processes
+      WeightedPmap(World& world, const std::vector<size_type>& weights) :
+          Pmap(world, weights.size()),
+          first_(partition(weights, procs_))
+      {
+        const size_type local_first = first_[rank_];
+        const size_type local_last = first_[rank_ + 1ul];
+        local_.reserve(local_last - local_first);
+
+        // Construct a map of all local processes
+        for(size_type first = local_first; first < local_last; ++first) {
+          TA_ASSERT(WeightedPmap::owner(first) == rank_);
+          local_.push_back(first);
+        }
+      }
+
+      /// Construct a map weighted by the non-zero tiles of a shape
+
+      /// The weight of a tile is its volume, or zero if it is a zero tile.
+      /// \tparam Trange The tiled range type
+      /// \tparam Shape The shape type
+      /// \param world The world where the tiles will be mapped
+      /// \param trange The tiled range of the array
+      /// \param shape The shape of the array
+      template <typename Trange, typename Shape>
+      WeightedPmap(World& world, const Trange& trange, const Shape& shape) :
+          WeightedPmap(world, make_weights(trange, shape))
+      { }
+
+      virtual ~WeightedPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return std::upper_bound(first_.begin(), first_.end(), tile) -
+            first_.begin() - 1l;
+      }
+
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return ((tile >= first_[rank_]) && (tile < first_[rank_ + 1ul]));
+      }
+    }; // class WeightedPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+
+#endif // TILEDARRAY_PMAP_WEIGHTED_PMAP_H__INCLUDED
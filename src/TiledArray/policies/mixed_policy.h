@@ -0,0 +1,148 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  mixed_policy.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_POLICIES_MIXED_POLICY_H__INCLUDED
+#define TILEDARRAY_POLICIES_MIXED_POLICY_H__INCLUDED
+
+#include <TiledArray/policies/dense_policy.h>
+#include <TiledArray/policies/sparse_policy.h>
+#include <type_traits>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// The policy of the sum of two arrays
+
+    /// The sum, or difference, of arrays with the same policy has that
+    /// policy. The sum of a dense and a sparse array is dense, since every
+    /// tile of the dense argument is non-zero.
+    /// \tparam Left The policy of the left-hand argument
+    /// \tparam Right The policy of the right-hand argument
+    template <typename Left, typename Right>
+    struct add_policy {
+      static_assert(std::is_same<Left, Right>::value,
+          "The left- and right-hand expressions must use the same policy class");
+      typedef Left type; ///< The result policy
+    }; // struct add_policy
+
+    template <>
+    struct add_policy<DensePolicy, SparsePolicy> {
+      typedef DensePolicy type; ///< The result policy
+    }; // struct add_policy<DensePolicy, SparsePolicy>
+
+    template <>
+    struct add_policy<SparsePolicy, DensePolicy> {
+      typedef DensePolicy type; ///< The result policy
+    }; // struct add_policy<SparsePolicy, DensePolicy>
+
+    /// The policy of the product of two arrays
+
+    /// The Hadamard product, or contraction, of arrays with the same policy
+    /// has that policy. The product of a dense and a sparse array is sparse,
+    /// since the zero tiles of the sparse argument screen the result.
+    /// \tparam Left The policy of the left-hand argument
+    /// \tparam Right The policy of the right-hand argument
+    template <typename Left, typename Right>
+    struct mult_policy {
+      static_assert(std::is_same<Left, Right>::value,
+          "The left- and right-hand expressions must use the same policy class");
+      typedef Left type; ///< The result policy
+    }; // struct mult_policy
+
+    template <>
+    struct mult_policy<DensePolicy, SparsePolicy> {
+      typedef SparsePolicy type; ///< The result policy
+    }; // struct mult_policy<DensePolicy, SparsePolicy>
+
+    template <>
+    struct mult_policy<SparsePolicy, DensePolicy> {
+      typedef SparsePolicy type; ///< The result policy
+    }; // struct mult_policy<SparsePolicy, DensePolicy>
+
+    /// Convert the shape of an argument to the shape type of the result
+
+    /// Shapes of the result type are used as is.
+    /// \tparam Result The shape type of the result
+    /// \tparam Arg The shape type of the argument
+    template <typename Result, typename Arg>
+    struct ShapeCast {
+      static_assert(std::is_same<Result, Arg>::value,
+          "The argument shape cannot be converted to the result shape type");
+
+      /// \tparam Engine The engine type of the argument
+      /// \param engine The engine of the argument
+      /// \return The shape of \c engine
+      template <typename Engine>
+      static const Result& cast(const Engine& engine) { return engine.shape(); }
+    }; // struct ShapeCast
+
+    /// Sparse shape of a dense argument
+
+    /// In the shape algebra of a sparse result, a dense argument is given
+    /// the shape of the actual norms of its tiles (see
+    /// \c LeafEngine::norm_shape() ), so the norms of the result are upper
+    /// bounds and the zero tiles of the sparse argument are zero in the
+    /// result. A per-element norm that is not computed from the data, e.g.
+    /// one, would not be a bound for tiles with larger elements, and could
+    /// screen non-zero result tiles. The norms are computed collectively,
+    /// but the dense array is not converted. Dense arguments that are
+    /// products, sums, or contractions of arrays must be evaluated into an
+    /// array first.
+    /// \tparam T The norm type of the result shape
+    template <typename T>
+    struct ShapeCast<SparseShape<T>, DenseShape> {
+
+      /// \tparam Engine The engine type of the argument
+      /// \param engine The engine of the argument
+      /// \return The shape of the tile norms of \c engine
+      template <typename Engine>
+      static SparseShape<T> cast(const Engine& engine) {
+        return engine.template norm_shape<T>();
+      }
+    }; // struct ShapeCast<SparseShape<T>, DenseShape>
+
+    /// Dense shape of a sparse argument
+
+    /// \tparam T The norm type of the argument shape
+    template <typename T>
+    struct ShapeCast<DenseShape, SparseShape<T> > {
+
+      /// \return A dense shape
+      template <typename Engine>
+      static DenseShape cast(const Engine&) { return DenseShape(); }
+    }; // struct ShapeCast<DenseShape, SparseShape<T> >
+
+    /// Convert the shape of an argument to the shape type of the result
+
+    /// \tparam Result The shape type of the result
+    /// \tparam Engine The engine type of the argument
+    /// \param engine The engine of the argument
+    /// \return The shape of \c engine , or its conversion to \c Result
+    template <typename Result, typename Engine>
+    inline decltype(auto) shape_cast(const Engine& engine) {
+      return ShapeCast<Result, typename Engine::shape_type>::cast(engine);
+    }
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_POLICIES_MIXED_POLICY_H__INCLUDED
@@ -27,7 +27,11 @@
 #define TILEDARRAY_GRID_H__INCLUDED
 
 #include <TiledArray/pmap/cyclic_pmap.h>
+#include <TiledArray/pmap/layered_cyclic_pmap.h>
 #include <TiledArray/math/eigen.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
@@ -56,6 +60,19 @@ namespace TiledArray {
     /// \f]
     /// where the positive, real root of \f$P_{\rm{row}}\f$ give the optimal
     /// optimal communication time.
+    ///
+    /// The process grid may also be replicated in \f$c\f$ layers (2.5D
+    /// SUMMA), in which case the processes are divided into \f$c\f$
+    /// contiguous blocks of \f$P/c\f$ processes and the 2D grid above is
+    /// constructed for each block. The inner (contracted) dimension is
+    /// partitioned among the layers; each layer computes a partial result that
+    /// is reduced onto layer 0, which holds the result tiles.
+    ///
+    /// Alternatively, the grid may be selected with a cost model that
+    /// accounts for the non-zero fractions of the arguments, the node
+    /// boundaries, and unused processes (see \c model_cost() ). Every grid
+    /// with at most \f$P\f$ processes is a candidate, so processes are left
+    /// idle when that lowers the predicted time.
     class ProcGrid {
     public:
       typedef uint_fast32_t size_type;
@@ -74,6 +91,23 @@ namespace TiledArray {
       size_type local_rows_; ///< The number of local element rows
       size_type local_cols_; ///< The number of local element columns
       size_type local_size_; ///< Number of local elements
+      size_type layers_; ///< Number of process grid layers
+      size_type layer_size_; ///< Number of processes in each layer (rank stride between layers)
+      ProcessID rank_layer_; ///< This process's layer, or -1 if not in any layer
+      size_type ranks_per_node_; ///< Number of processes on each node, or 0 if unknown
+      double cost_; ///< The predicted time of the grid, or 0 if the cost model was not used
+
+      /// Cost model parameters
+      struct MachineBalance {
+        double flops_per_element = 100.0; ///< Flops per element sent between nodes
+        double intra_node_speedup = 4.0; ///< Bandwidth of intra-node over inter-node messages
+        double latency_elements = 0.0; ///< Elements sent between nodes in the latency of a message
+      }; // struct MachineBalance
+
+      static MachineBalance& machine_balance() {
+        static MachineBalance balance;
+        return balance;
+      }
 
 
       /// Compute the number of process rows that minimizes communication
@@ -231,21 +265,110 @@ namespace TiledArray {
                 min_proc_rows, max_proc_rows);
           }
 
-          proc_size_ = proc_rows_ * proc_cols_;
+          init_local(rank);
+        }
+      }
 
-          if(rank < proc_size_) {
-            // Set this process rank
-            rank_row_ = rank / proc_cols_;
-            rank_col_ = rank % proc_cols_;
+      /// Layered member variable initialization
 
-            // Set local counts
-            local_rows_ = (rows_ / proc_rows_) + (size_type(rank_row_) < (rows_ % proc_rows_) ? 1u : 0u);
-            local_cols_ = (cols_ / proc_cols_) + (size_type(rank_col_) < (cols_ % proc_cols_) ? 1u : 0u);
-            local_size_ = local_rows_ * local_cols_;
+      /// This function assigns \c rank to a layer and initializes the 2D grid
+      /// of that layer.
+      void init_layers(const size_type rank, const size_type nprocs,
+          const std::size_t row_size, const std::size_t col_size)
+      {
+        TA_ASSERT(layers_ >= 1u);
+        TA_ASSERT(layers_ <= nprocs);
+        layer_size_ = nprocs / layers_;
+
+        if(rank < (layers_ * layer_size_)) {
+          rank_layer_ = rank / layer_size_;
+          init(rank % layer_size_, layer_size_, row_size, col_size);
+        } else {
+          // This process does not belong to any layer, but the grid
+          // dimensions are still needed
+          init(0u, layer_size_, row_size, col_size);
+          rank_layer_ = -1;
+          rank_row_ = -1;
+          rank_col_ = -1;
+          local_rows_ = 0u;
+          local_cols_ = 0u;
+          local_size_ = 0u;
+        }
+      }
+
+      /// Initialize the position and local counts of a process
+
+      /// \param rank The rank of the process
+      void init_local(const size_type rank) {
+        proc_size_ = proc_rows_ * proc_cols_;
+
+        if(rank < proc_size_) {
+          // Set this process rank
+          rank_row_ = rank / proc_cols_;
+          rank_col_ = rank % proc_cols_;
+
+          // Set local counts
+          local_rows_ = (rows_ / proc_rows_) + (size_type(rank_row_) < (rows_ % proc_rows_) ? 1u : 0u);
+          local_cols_ = (cols_ / proc_cols_) + (size_type(rank_col_) < (cols_ % proc_cols_) ? 1u : 0u);
+          local_size_ = local_rows_ * local_cols_;
+        }
+      }
+
+      /// Cost model member variable initialization
+
+      /// This function initializes the member variables with the grid that
+      /// minimizes \c model_cost() . For each number of process rows, the
+      /// largest number of process columns is tested, as well as the largest
+      /// divisor and multiple of the node size, which keep row groups within
+      /// or aligned to the nodes.
+      void init_model(const size_type rank, const size_type nprocs,
+          const std::size_t row_size, const std::size_t col_size,
+          const std::size_t inner_size, const double left_density,
+          const double right_density)
+      {
+        // The divisors of the node size, in increasing order
+        std::vector<size_type> divisors;
+        for(size_type d = 1u; d <= ranks_per_node_; ++d)
+          if((ranks_per_node_ % d) == 0u)
+            divisors.push_back(d);
+
+        cost_ = std::numeric_limits<double>::max();
+        std::vector<size_type> candidates;
+        candidates.reserve(3u);
+        const size_type max_proc_rows = std::min<size_type>(nprocs, rows_);
+        for(size_type pr = 1u; pr <= max_proc_rows; ++pr) {
+          const size_type max_pc = std::min<size_type>(nprocs / pr, cols_);
+
+          candidates.clear();
+          candidates.push_back(max_pc);
+          if(ranks_per_node_ > 1u) {
+            const auto it =
+                std::upper_bound(divisors.begin(), divisors.end(), max_pc);
+            candidates.push_back(*(it - 1));
+            if(max_pc >= ranks_per_node_)
+              candidates.push_back((max_pc / ranks_per_node_) * ranks_per_node_);
+          }
+
+          for(const size_type pc : candidates) {
+            const double cost = model_cost(pr, pc, rows_, cols_, row_size,
+                col_size, inner_size, left_density, right_density,
+                ranks_per_node_);
+            // Prefer the earlier candidate, which uses more processes, unless
+            // the cost is lower by more than round-off
+            if(cost < cost_ * (1.0 - 1.0e-9)) {
+              cost_ = cost;
+              proc_rows_ = pr;
+              proc_cols_ = pc;
+            }
           }
         }
+
+        init_local(rank);
       }
 
+      /// Rank offset of this process's layer
+      size_type layer_offset() const { return rank_layer_ * layer_size_; }
+
     public:
       /// Default constructor
 
@@ -253,7 +376,8 @@ namespace TiledArray {
       ProcGrid() :
         world_(NULL), rows_(0u), cols_(0u), size_(0u), proc_rows_(0u),
         proc_cols_(0u), proc_size_(0u), rank_row_(0), rank_col_(0),
-        local_rows_(0u), local_cols_(0u), local_size_(0u)
+        local_rows_(0u), local_cols_(0u), local_size_(0u), layers_(1u),
+        layer_size_(0u), rank_layer_(0), ranks_per_node_(0u), cost_(0.0)
       { }
 
       /// Construct a process grid
@@ -271,7 +395,9 @@ namespace TiledArray {
         world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
         proc_rows_(0ul), proc_cols_(0ul), proc_size_(0ul),
         rank_row_(-1), rank_col_(-1),
-        local_rows_(0ul), local_cols_(0ul), local_size_(0ul)
+        local_rows_(0ul), local_cols_(0ul), local_size_(0ul), layers_(1ul),
+        layer_size_(world.size()), rank_layer_(0), ranks_per_node_(0u),
+        cost_(0.0)
       {
         // Check for non-zero sizes
         TA_ASSERT(rows_ >= 1u);
@@ -282,6 +408,79 @@ namespace TiledArray {
         init(world_->rank(), world_->size(), row_size, col_size);
       }
 
+      /// Construct a layered process grid
+
+      /// The processes of \c world are divided into \c layers blocks, and a
+      /// process grid is constructed for each block as with the 2D
+      /// constructor.
+      /// \param world The world where the process grid will live
+      /// \param rows The number of tile rows
+      /// \param cols The number of tile columns
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      /// \param layers The number of process grid layers
+      /// \throw TiledArray::Exception When \c layers is zero or greater than
+      /// the number of processes in \c world
+      ProcGrid(World& world, const size_type rows, const size_type cols,
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type layers) :
+        world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
+        proc_rows_(0ul), proc_cols_(0ul), proc_size_(0ul),
+        rank_row_(-1), rank_col_(-1),
+        local_rows_(0ul), local_cols_(0ul), local_size_(0ul), layers_(layers),
+        layer_size_(0ul), rank_layer_(-1), ranks_per_node_(0u), cost_(0.0)
+      {
+        // Check for non-zero sizes
+        TA_ASSERT(rows_ >= 1u);
+        TA_ASSERT(cols_ >= 1u);
+        TA_ASSERT(row_size >= 1ul);
+        TA_ASSERT(col_size >= 1ul);
+        TA_ASSERT(layers_ >= 1u);
+        TA_ASSERT(layers_ <= size_type(world_->size()));
+
+        init_layers(world_->rank(), world_->size(), row_size, col_size);
+      }
+
+      /// Construct a process grid with the cost model
+
+      /// The grid minimizes \c model_cost() among all grids with at most
+      /// <tt>world.size()</tt> processes.
+      /// \param world The world where the process grid will live
+      /// \param rows The number of tile rows
+      /// \param cols The number of tile columns
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      /// \param inner_size The number of inner (contracted) elements
+      /// \param left_density The fraction of non-zero tiles of the left-hand
+      /// argument
+      /// \param right_density The fraction of non-zero tiles of the
+      /// right-hand argument
+      /// \param ranks_per_node The number of processes on each node, or zero
+      /// if unknown
+      ProcGrid(World& world, const size_type rows, const size_type cols,
+          const std::size_t row_size, const std::size_t col_size,
+          const std::size_t inner_size, const double left_density,
+          const double right_density, const size_type ranks_per_node) :
+        world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
+        proc_rows_(0ul), proc_cols_(0ul), proc_size_(0ul),
+        rank_row_(-1), rank_col_(-1),
+        local_rows_(0ul), local_cols_(0ul), local_size_(0ul), layers_(1ul),
+        layer_size_(world.size()), rank_layer_(0),
+        ranks_per_node_(ranks_per_node), cost_(0.0)
+      {
+        // Check for non-zero sizes
+        TA_ASSERT(rows_ >= 1u);
+        TA_ASSERT(cols_ >= 1u);
+        TA_ASSERT(row_size >= 1ul);
+        TA_ASSERT(col_size >= 1ul);
+        TA_ASSERT(inner_size >= 1ul);
+        TA_ASSERT((left_density >= 0.0) && (left_density <= 1.0));
+        TA_ASSERT((right_density >= 0.0) && (right_density <= 1.0));
+
+        init_model(world_->rank(), world_->size(), row_size, col_size,
+            inner_size, left_density, right_density);
+      }
+
 #ifdef TILEDARRAY_ENABLE_TEST_PROC_GRID
       // Note: The following function is here for testing purposes only. It
       // has the same functionality as the default constructor above, except the
@@ -305,7 +504,9 @@ namespace TiledArray {
           const std::size_t row_size, const std::size_t col_size) :
         world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
         proc_rows_(0u), proc_cols_(0u), proc_size_(0u), rank_row_(-1),
-        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u)
+        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u),
+        layers_(1u), layer_size_(test_nprocs), rank_layer_(0),
+        ranks_per_node_(0u), cost_(0.0)
       {
         // Check for non-zero sizes
         TA_ASSERT(rows >= 1u);
@@ -316,6 +517,77 @@ namespace TiledArray {
 
         init(test_rank, test_nprocs, row_size, col_size);
       }
+
+      /// Construct a layered process grid
+
+      /// \param world The world where the process grid will live
+      /// \param test_rank Test rank
+      /// \param test_nprocs Test number of procs
+      /// \param rows The number of tile rows
+      /// \param cols The number of tile columns
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      /// \param layers The number of process grid layers
+      ProcGrid(World& world, const size_type test_rank, size_type test_nprocs,
+          const size_type rows, const size_type cols,
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type layers) :
+        world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
+        proc_rows_(0u), proc_cols_(0u), proc_size_(0u), rank_row_(-1),
+        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u),
+        layers_(layers), layer_size_(0u), rank_layer_(-1),
+        ranks_per_node_(0u), cost_(0.0)
+      {
+        // Check for non-zero sizes
+        TA_ASSERT(rows >= 1u);
+        TA_ASSERT(cols >= 1u);
+        TA_ASSERT(row_size >= 1u);
+        TA_ASSERT(col_size >= 1u);
+        TA_ASSERT(test_rank < test_nprocs);
+        TA_ASSERT(layers >= 1u);
+        TA_ASSERT(layers <= test_nprocs);
+
+        init_layers(test_rank, test_nprocs, row_size, col_size);
+      }
+
+      /// Construct a process grid with the cost model
+
+      /// \param world The world where the process grid will live
+      /// \param test_rank Test rank
+      /// \param test_nprocs Test number of procs
+      /// \param rows The number of tile rows
+      /// \param cols The number of tile columns
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      /// \param inner_size The number of inner (contracted) elements
+      /// \param left_density The fraction of non-zero tiles of the left-hand
+      /// argument
+      /// \param right_density The fraction of non-zero tiles of the
+      /// right-hand argument
+      /// \param ranks_per_node The number of processes on each node, or zero
+      /// if unknown
+      ProcGrid(World& world, const size_type test_rank, size_type test_nprocs,
+          const size_type rows, const size_type cols,
+          const std::size_t row_size, const std::size_t col_size,
+          const std::size_t inner_size, const double left_density,
+          const double right_density, const size_type ranks_per_node) :
+        world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
+        proc_rows_(0u), proc_cols_(0u), proc_size_(0u), rank_row_(-1),
+        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u),
+        layers_(1u), layer_size_(test_nprocs), rank_layer_(0),
+        ranks_per_node_(ranks_per_node), cost_(0.0)
+      {
+        // Check for non-zero sizes
+        TA_ASSERT(rows >= 1u);
+        TA_ASSERT(cols >= 1u);
+        TA_ASSERT(row_size >= 1u);
+        TA_ASSERT(col_size >= 1u);
+        TA_ASSERT(inner_size >= 1u);
+        TA_ASSERT(test_rank < test_nprocs);
+
+        init_model(test_rank, test_nprocs, row_size, col_size, inner_size,
+            left_density, right_density);
+      }
 #endif // TILEDARRAY_ENABLE_TEST_PROC_GRID
 
       /// Copy constructor
@@ -330,7 +602,9 @@ namespace TiledArray {
         proc_cols_(other.proc_cols_), proc_size_(other.proc_size_),
         rank_row_(other.rank_row_), rank_col_(other.rank_col_),
         local_rows_(other.local_rows_), local_cols_(other.local_cols_),
-        local_size_(other.local_size_)
+        local_size_(other.local_size_), layers_(other.layers_),
+        layer_size_(other.layer_size_), rank_layer_(other.rank_layer_),
+        ranks_per_node_(other.ranks_per_node_), cost_(other.cost_)
       { }
 
       /// Copy assignment operator
@@ -349,6 +623,11 @@ namespace TiledArray {
         local_rows_ = other.local_rows_;
         local_cols_ = other.local_cols_;
         local_size_ = other.local_size_;
+        layers_ = other.layers_;
+        layer_size_ = other.layer_size_;
+        rank_layer_ = other.rank_layer_;
+        ranks_per_node_ = other.ranks_per_node_;
+        cost_ = other.cost_;
 
         return *this;
       }
@@ -409,6 +688,230 @@ namespace TiledArray {
       /// less than the number of process in world).
       size_type proc_size() const { return proc_size_; }
 
+      /// Layer count accessor
+
+      /// \return The number of process grid layers
+      size_type layers() const { return layers_; }
+
+      /// Layer size accessor
+
+      /// \return The number of processes assigned to each layer, which is the
+      /// rank stride between layers
+      size_type layer_size() const { return layer_size_; }
+
+      /// Rank layer accessor
+
+      /// \return The layer of this process, or -1 if this process is not
+      /// included in any layer
+      ProcessID rank_layer() const { return rank_layer_; }
+
+      /// First inner index of this process's layer
+
+      /// \param inner_size The number of tiles in the inner dimension
+      /// \return The first inner (contracted) tile index assigned to the layer
+      /// of this process
+      size_type layer_begin(const size_type inner_size) const {
+        TA_ASSERT(rank_layer_ >= 0);
+        return LayeredCyclicPmap::layer_begin(rank_layer_, inner_size, layers_);
+      }
+
+      /// End of the inner index range of this process's layer
+
+      /// \param inner_size The number of tiles in the inner dimension
+      /// \return The end of the inner (contracted) tile index range assigned
+      /// to the layer of this process
+      size_type layer_end(const size_type inner_size) const {
+        TA_ASSERT(rank_layer_ >= 0);
+        return LayeredCyclicPmap::layer_begin(rank_layer_ + 1, inner_size, layers_);
+      }
+
+      /// Node size accessor
+
+      /// \return The number of processes on each node, or zero if the grid
+      /// was not selected with the cost model or the node size is unknown
+      size_type ranks_per_node() const { return ranks_per_node_; }
+
+      /// Intra-node row group query
+
+      /// \return \c true if every process row is contained in one node, so
+      /// the broadcasts of the left-hand argument do not leave the node
+      bool intra_node_rows() const {
+        return ranks_per_node_ && proc_cols_ && ((ranks_per_node_ % proc_cols_) == 0u);
+      }
+
+      /// Predicted time accessor
+
+      /// \return The predicted time of the grid (see \c model_cost() ), or
+      /// zero if the grid was not selected with the cost model
+      double cost() const { return cost_; }
+
+      /// Set the machine balance of the cost model
+
+      /// \param flops_per_element The number of floating point operations
+      /// that take as long as sending one element between nodes
+      /// [ default = 100 ]
+      /// \param intra_node_speedup The ratio of the intra-node to the
+      /// inter-node bandwidth [ default = 4 ]
+      /// \param latency_elements The number of elements that could be sent
+      /// between nodes in the latency of one message [ default = 0 ]
+      /// \note This function is not thread safe; it should be called before
+      /// contractions are evaluated, with the same values on all processes.
+      static void set_machine_balance(const double flops_per_element = 100.0,
+          const double intra_node_speedup = 4.0, const double latency_elements = 0.0)
+      {
+        TA_ASSERT(flops_per_element > 0.0);
+        TA_ASSERT(intra_node_speedup >= 1.0);
+        TA_ASSERT(latency_elements >= 0.0);
+        machine_balance().flops_per_element = flops_per_element;
+        machine_balance().intra_node_speedup = intra_node_speedup;
+        machine_balance().latency_elements = latency_elements;
+      }
+
+      /// \return The number of flops that take as long as sending one element
+      /// between nodes (see \c set_machine_balance() )
+      static double flops_per_element() { return machine_balance().flops_per_element; }
+
+      /// \return The ratio of the intra-node to the inter-node bandwidth
+      static double intra_node_speedup() { return machine_balance().intra_node_speedup; }
+
+      /// \return The number of elements that could be sent between nodes in
+      /// the latency of one message
+      static double latency_elements() { return machine_balance().latency_elements; }
+
+      /// Predict the time of a SUMMA process grid
+
+      /// The time, in units of the time to send an element between nodes, is
+      /// estimated by
+      /// \f[
+      ///   T = \frac{2 \hat{M}m \hat{N}n Kk \rho_L \rho_R}{\gamma}
+      ///     + \frac{\hat{M}m Kk \rho_L}{s_{\rm{row}}} \frac{P_{\rm{col}} - 1}{P_{\rm{col}}}
+      ///     + \frac{Kk \hat{N}n \rho_R}{s_{\rm{col}}} \frac{P_{\rm{row}} - 1}{P_{\rm{row}}}
+      /// \f]
+      /// where \f$\hat{M}m\f$ and \f$\hat{N}n\f$ are the fractions of the
+      /// element rows and columns held by the most loaded process;
+      /// \f$\rho_L\f$ and \f$\rho_R\f$ are the non-zero fractions of the
+      /// arguments; \f$\gamma\f$ is the number of flops per element sent;
+      /// and \f$s_{\rm{row}}\f$ ( \f$s_{\rm{col}}\f$ ) is the intra-node
+      /// speedup when each process row (column) is contained in one node, or
+      /// one otherwise. The terms are the local flops and the elements of the
+      /// arguments received by the most loaded process.
+      /// \param proc_rows The number of process rows
+      /// \param proc_cols The number of process columns
+      /// \param rows The number of tile rows
+      /// \param cols The number of tile columns
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      /// \param inner_size The number of inner elements
+      /// \param left_density The fraction of non-zero tiles of the left-hand
+      /// argument
+      /// \param right_density The fraction of non-zero tiles of the
+      /// right-hand argument
+      /// \param ranks_per_node The number of processes on each node, or zero
+      /// if unknown
+      /// \return The predicted time
+      static double model_cost(const size_type proc_rows,
+          const size_type proc_cols, const size_type rows, const size_type cols,
+          const std::size_t row_size, const std::size_t col_size,
+          const std::size_t inner_size, const double left_density,
+          const double right_density, const size_type ranks_per_node)
+      {
+        TA_ASSERT(proc_rows >= 1u);
+        TA_ASSERT(proc_cols >= 1u);
+        const MachineBalance& balance = machine_balance();
+
+        // The fractions of the rows and columns of the most loaded process
+        const double row_fraction =
+            double((rows + proc_rows - 1u) / proc_rows) / double(rows);
+        const double col_fraction =
+            double((cols + proc_cols - 1u) / proc_cols) / double(cols);
+        const double Mm = double(row_size) * row_fraction;
+        const double Nn = double(col_size) * col_fraction;
+        const double Kk = inner_size;
+
+        const double flops = 2.0 * Mm * Nn * Kk * left_density * right_density;
+        double left = Mm * Kk * left_density
+            * double(proc_cols - 1u) / double(proc_cols);
+        double right = Kk * Nn * right_density
+            * double(proc_rows - 1u) / double(proc_rows);
+
+        // Process rows are contiguous blocks of ranks, and process columns
+        // span the grid
+        if(ranks_per_node && ((ranks_per_node % proc_cols) == 0u))
+          left /= balance.intra_node_speedup;
+        if(ranks_per_node && ((proc_rows * proc_cols) <= ranks_per_node))
+          right /= balance.intra_node_speedup;
+
+        return flops / balance.flops_per_element + left + right;
+      }
+
+      /// Limit a number of layers to the layers that use every process
+
+      /// A layered SUMMA evaluator requires every process to belong to a
+      /// layer, so the number of layers must divide the number of processes.
+      /// \param nprocs The number of processes
+      /// \param max_layers The maximum number of layers
+      /// \return The largest divisor of \c nprocs that is not greater than
+      /// \c max_layers , or 1
+      static size_type divisor_layers(const size_type nprocs, const size_type max_layers) {
+        size_type layers = std::max<size_type>(std::min(max_layers, nprocs), 1u);
+        while(nprocs % layers)
+          --layers;
+        return layers;
+      }
+
+      /// Compute the number of layers that minimizes communication
+
+      /// The communication time of a layered SUMMA with \f$c\f$ layers is
+      /// estimated by
+      /// \f[
+      ///   T(c) = \frac{Kk(Mm + Nn)}{\sqrt{cP}} + \frac{c(c - 1)MmNn}{P}
+      /// \f]
+      /// where the first term is the broadcast volume within a layer and the
+      /// second is the reduction of partial results onto layer 0. The number of
+      /// layers is bound by \c max_layers, the number of inner tiles, and the
+      /// memory required to hold a partial result on each process, and it
+      /// divides \c nprocs , so every process belongs to a layer.
+      /// \param nprocs The number of processes
+      /// \param row_size The number of result element rows (Mm)
+      /// \param col_size The number of result element columns (Nn)
+      /// \param inner_size The number of inner elements (Kk)
+      /// \param inner_tiles The number of inner tiles (K)
+      /// \param max_layers The maximum number of layers
+      /// \param max_memory The memory available to each process for partial
+      /// results, in elements, or zero for no bound
+      /// \return The number of layers that minimizes communication time
+      static size_type optimal_layers(const size_type nprocs,
+          const std::size_t row_size, const std::size_t col_size,
+          const std::size_t inner_size, const size_type inner_tiles,
+          const size_type max_layers, const std::size_t max_memory = 0ul)
+      {
+        const size_type max_c =
+            std::min(std::min(max_layers, inner_tiles), nprocs);
+        const double MmNn = double(row_size) * double(col_size);
+        const double KkMmNn = double(inner_size) * (double(row_size) + double(col_size));
+
+        size_type layers = 1u;
+        double min_cost = std::numeric_limits<double>::max();
+        for(size_type c = 1u; c <= max_c; ++c) {
+          // Only layer counts that use every process are considered
+          if(nprocs % c)
+            continue;
+          const double P = nprocs;
+
+          // Check that the partial result fits in memory
+          if((c > 1u) && max_memory && ((c * MmNn / P) > double(max_memory)))
+            break;
+
+          const double cost = KkMmNn / std::sqrt(c * P) + (c * (c - 1u)) * MmNn / P;
+          if(cost < min_cost) {
+            min_cost = cost;
+            layers = c;
+          }
+        }
+
+        return layers;
+      }
+
 
       /// Construct a row group
 
@@ -425,7 +928,7 @@ namespace TiledArray {
           proc_list.reserve(proc_cols_);
 
           // Populate the row process list
-          size_type p = rank_row_ * proc_cols_;
+          size_type p = layer_offset() + rank_row_ * proc_cols_;
           const size_type row_end = p + proc_cols_;
           for(; p < row_end; ++p)
             proc_list.push_back(p);
@@ -452,8 +955,9 @@ namespace TiledArray {
           proc_list.reserve(proc_rows_);
 
           // Populate the column process list
+          const size_type offset = layer_offset();
           for(size_type p = rank_col_; p < proc_size_; p += proc_cols_)
-            proc_list.push_back(p);
+            proc_list.push_back(p + offset);
 
           // Construct the group
           if(proc_list.size() != 0)
@@ -469,7 +973,7 @@ namespace TiledArray {
       /// \return The process the corresponds to the process coordinate \c (row,rank_col)
       ProcessID map_row(const size_type row) const {
         TA_ASSERT(row < proc_rows_);
-        return rank_col_ + row * proc_cols_;
+        return layer_offset() + rank_col_ + row * proc_cols_;
       }
 
       /// Map a column to the process in this process's row
@@ -478,12 +982,13 @@ namespace TiledArray {
       /// \return The process the corresponds to the process coordinate \c (rank_row,col)
       ProcessID map_col(const size_type col) const {
         TA_ASSERT(col < proc_cols_);
-        return rank_row_ * proc_cols_ + col;
+        return layer_offset() + rank_row_ * proc_cols_ + col;
       }
 
       /// Construct a cyclic process
 
       /// Construct a cyclic process map with the same phase as the process grid.
+      /// For a layered grid, the map covers the processes of layer 0.
       /// \return Cyclic process map
       std::shared_ptr<Pmap> make_pmap() const {
         TA_ASSERT(world_);
@@ -494,24 +999,32 @@ namespace TiledArray {
       /// Construct column phased a cyclic process
 
       /// Construct a cyclic process map where the column phase of the process
-      /// matches that of this process grid.
+      /// matches that of this process grid. For a layered grid, the rows are
+      /// partitioned among the layers.
       /// \param rows The number of rows in the process map
       /// \return Cyclic process map with matching column phase
       std::shared_ptr<Pmap> make_col_phase_pmap(const size_type rows) const {
         TA_ASSERT(world_);
 
+        if(layers_ > 1u)
+          return std::make_shared<LayeredCyclicPmap>(*world_, rows, cols_,
+              proc_rows_, proc_cols_, layers_, layer_size_, false);
         return std::make_shared<CyclicPmap>(*world_, rows, cols_, proc_rows_, proc_cols_);
       }
 
       /// Construct row phased a cyclic process
 
       /// Construct a cyclic process map where the column phase of the process
-      /// matches that of this process grid.
+      /// matches that of this process grid. For a layered grid, the columns
+      /// are partitioned among the layers.
       /// \param cols The number of columns in the process map
       /// \return Cyclic process map with matching column phase
       std::shared_ptr<Pmap> make_row_phase_pmap(const size_type cols) const {
         TA_ASSERT(world_);
 
+        if(layers_ > 1u)
+          return std::make_shared<LayeredCyclicPmap>(*world_, rows_, cols,
+              proc_rows_, proc_cols_, layers_, layer_size_, true);
         return std::make_shared<CyclicPmap>(*world_, rows_, cols, proc_rows_, proc_cols_);
       }
     }; // class Grid
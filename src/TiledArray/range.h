@@ -26,6 +26,50 @@
 
 namespace TiledArray {
 
+  namespace detail {
+
+    /// Compile-time rank
+
+    /// \c value is the rank of a fixed-rank kernel, or \c 0 for a kernel of
+    /// arbitrary rank.
+    template <unsigned int N>
+    using static_rank = std::integral_constant<unsigned int, N>;
+
+    /// Rank of a fixed-rank kernel
+
+    /// \tparam N The compile-time rank, or \c 0
+    /// \param rank The run-time rank
+    /// \return \c N if it is not zero, otherwise \c rank
+    template <unsigned int N>
+    constexpr unsigned int kernel_rank(static_rank<N>, const unsigned int rank) {
+      return (N ? N : rank);
+    }
+
+    /// Dispatch a kernel to its fixed-rank specialization
+
+    /// \c op is called with \c static_rank<rank>() for ranks 1 to 4, where
+    /// loops over the dimensions that are bounded by \c kernel_rank() have a
+    /// compile-time trip count and are unrolled; otherwise it is called with
+    /// \c static_rank<0>() .
+    /// \tparam Op The kernel type
+    /// \param rank The rank of the range
+    /// \param op The kernel
+    /// \return The value returned by \c op
+    template <typename Op>
+    inline auto rank_dispatch(const unsigned int rank, Op&& op)
+        -> decltype(op(static_rank<0u>()))
+    {
+      switch(rank) {
+        case 1u: return op(static_rank<1u>());
+        case 2u: return op(static_rank<2u>());
+        case 3u: return op(static_rank<3u>());
+        case 4u: return op(static_rank<4u>());
+        default: return op(static_rank<0u>());
+      }
+    }
+
+  } // namespace detail
+
   /// \brief A (hyperrectangular) interval on \f$ Z^n \f$, space of integer n-indices
 
   /// This object represents an n-dimensional, hyperrectangular array
@@ -63,6 +107,63 @@ namespace TiledArray {
     size_type volume_ = 0ul; ///< Total number of elements
     unsigned int rank_ = 0u; ///< The rank (or number of dimensions) in the range
 
+    /// The largest rank whose dimension information is stored inline
+    static constexpr unsigned int small_rank_ = 4u;
+
+    size_type small_data_[small_rank_ << 2]; ///< Inline storage for \c data_ of small ranks
+
+    /// Allocate the dimension information array
+
+    /// \param rank The rank of the range
+    /// \return A pointer to the inline storage if \c rank is not greater than
+    /// \c small_rank_ , otherwise a heap-allocated array of <tt>4*rank</tt>
+    /// elements
+    /// \throw std::bad_alloc When memory allocation fails.
+    size_type* allocate_data(const unsigned int rank) {
+      return (rank <= small_rank_ ? small_data_ : new size_type[rank << 2]);
+    }
+
+    /// Free the dimension information array
+    void free_data() {
+      if(data_ != small_data_)
+        delete [] data_;
+      data_ = nullptr;
+    }
+
+    /// Reallocate the dimension information array for a new rank
+
+    /// \param rank The new rank of the range
+    /// \post \c rank_ is equal to \c rank
+    /// \throw std::bad_alloc When memory allocation fails.
+    void reallocate_data(const unsigned int rank) {
+      if(rank_ != rank) {
+        free_data();
+        data_ = (rank > 0u ? allocate_data(rank) : nullptr);
+        rank_ = rank;
+      }
+    }
+
+    /// Move the dimension information of another range
+
+    /// \param other The range to be moved, which is left empty
+    /// \pre This range has no dimension information array
+    void move_data(Range& other) {
+      if(other.data_ == other.small_data_) {
+        data_ = small_data_;
+        memcpy(data_, other.data_, (sizeof(size_type) << 2) * other.rank_);
+      } else {
+        data_ = other.data_;
+      }
+      offset_ = other.offset_;
+      volume_ = other.volume_;
+      rank_ = other.rank_;
+
+      other.data_ = nullptr;
+      other.offset_ = 0ul;
+      other.volume_ = 0ul;
+      other.rank_ = 0u;
+    }
+
   private:
 
     /// Initialize range data from sequences of lower and upper bounds
@@ -309,7 +410,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
+        data_ = allocate_data(n);
         rank_ = n;
         init_range_data(lower_bound, upper_bound);
       }
@@ -333,7 +434,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
+        data_ = allocate_data(n);
         rank_ = n;
         init_range_data(lower_bound, upper_bound);
       }
@@ -353,7 +454,7 @@ namespace TiledArray {
       const size_type n = detail::size(extent);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
+        data_ = allocate_data(n);
         rank_ = n;
         init_range_data(extent);
       }
@@ -371,7 +472,7 @@ namespace TiledArray {
       const size_type n = detail::size(extent);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
+        data_ = allocate_data(n);
         rank_ = n;
         init_range_data(extent);
       }
@@ -393,7 +494,7 @@ namespace TiledArray {
       const size_type n = detail::size(bounds);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
+        data_ = allocate_data(n);
         rank_ = n;
         init_range_data(bounds);
       }
@@ -413,7 +514,7 @@ namespace TiledArray {
       const size_type n = detail::size(bounds);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
+        data_ = allocate_data(n);
         rank_ = n;
         init_range_data(bounds);
       }
@@ -450,7 +551,7 @@ namespace TiledArray {
     /// \throw std::bad_alloc When memory allocation fails.
     Range(const Range_& other) {
       if(other.rank_ > 0ul) {
-        data_ = new size_type[other.rank_ << 2];
+        data_ = allocate_data(other.rank_);
         offset_ = other.offset_;
         volume_ = other.volume_;
         rank_ = other.rank_;
@@ -458,19 +559,11 @@ namespace TiledArray {
       }
     }
 
-    /// Copy Constructor
+    /// Move Constructor
 
-    /// \param other The range to be copied
-    /// \throw std::bad_alloc When memory allocation fails.
-    Range(Range_&& other) :
-      data_(other.data_), offset_(other.offset_), volume_(other.volume_),
-      rank_(other.rank_)
-    {
-      other.data_ = nullptr;
-      other.offset_ = 0ul;
-      other.volume_ = 0ul;
-      other.rank_ = 0u;
-    }
+    /// \param other The range to be moved
+    /// \throw nothing
+    Range(Range_&& other) { move_data(other); }
 
     /// Permuting copy constructor
 
@@ -481,7 +574,7 @@ namespace TiledArray {
       TA_ASSERT(perm.dim() == other.rank_);
 
       if(other.rank_ > 0ul) {
-        data_ = new size_type[other.rank_ << 2];
+        data_ = allocate_data(other.rank_);
         rank_ = other.rank_;
 
         if(perm) {
@@ -496,7 +589,7 @@ namespace TiledArray {
     }
 
     /// Destructor
-    ~Range() { delete [] data_; }
+    ~Range() { free_data(); }
 
     /// Copy assignment operator
 
@@ -504,11 +597,7 @@ namespace TiledArray {
     /// \return A reference to this object
     /// \throw std::bad_alloc When memory allocation fails.
     Range_& operator=(const Range_& other) {
-      if(rank_ != other.rank_) {
-        delete [] data_;
-        data_ = (other.rank_ > 0ul ? new size_type[other.rank_ << 2] : nullptr);
-        rank_ = other.rank_;
-      }
+      reallocate_data(other.rank_);
       memcpy(data_, other.data_, (sizeof(size_type) << 2) * rank_);
       offset_ = other.offset_;
       volume_ = other.volume_;
@@ -522,15 +611,10 @@ namespace TiledArray {
     /// \return A reference to this object
     /// \throw nothing
     Range_& operator=(Range_&& other) {
-      data_ = other.data_;
-      offset_ = other.offset_;
-      volume_ = other.volume_;
-      rank_ = other.rank_;
-
-      other.data_ = nullptr;
-      other.offset_ = 0ul;
-      other.volume_ = 0ul;
-      other.rank_ = 0u;
+      if(this != &other) {
+        free_data();
+        move_data(other);
+      }
 
       return *this;
     }
@@ -685,20 +769,23 @@ namespace TiledArray {
         typename std::enable_if<! std::is_integral<Index>::value, bool>::type* = nullptr>
     bool includes(const Index& index) const {
       TA_ASSERT(detail::size(index) == rank_);
-      const size_type* MADNESS_RESTRICT const lower  = data_;
-      const size_type* MADNESS_RESTRICT const upper = lower + rank_;
-
-      bool result = (rank_ > 0u);
-      using std::cbegin;
-      auto it = cbegin(index);
-      for(unsigned int i = 0u; result && (i < rank_); ++i, ++it) {
-        const size_type index_i = *it;
-        const size_type lower_i = lower[i];
-        const size_type upper_i = upper[i];
-        result = result && (index_i >= lower_i) && (index_i < upper_i);
-      }
+      return detail::rank_dispatch(rank_, [&] (auto r) {
+        const unsigned int n = detail::kernel_rank(r, rank_);
+        const size_type* MADNESS_RESTRICT const lower  = data_;
+        const size_type* MADNESS_RESTRICT const upper = lower + n;
+
+        bool result = (n > 0u);
+        using std::cbegin;
+        auto it = cbegin(index);
+        for(unsigned int i = 0u; i < n; ++i, ++it) {
+          const size_type index_i = *it;
+          const size_type lower_i = lower[i];
+          const size_type upper_i = upper[i];
+          result = result && (index_i >= lower_i) && (index_i < upper_i);
+        }
 
-      return result;
+        return result;
+      });
     }
 
     /// Check the coordinate to make sure it is within the range.
@@ -761,11 +848,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
 
       // Reallocate memory for range arrays
-      if(rank_ != n) {
-        delete [] data_;
-        data_ = (n > 0ul ? new size_type[n << 2] : nullptr);
-        rank_ = n;
-      }
+      reallocate_data(n);
       if(n > 0ul)
         init_range_data(lower_bound, upper_bound);
       else
@@ -846,17 +929,20 @@ namespace TiledArray {
       TA_ASSERT(detail::size(index) == rank_);
       TA_ASSERT(includes(index));
 
-      size_type* MADNESS_RESTRICT const stride = data_ + rank_ + rank_ + rank_;
+      return detail::rank_dispatch(rank_, [&] (auto r) {
+        const unsigned int n = detail::kernel_rank(r, rank_);
+        const size_type* MADNESS_RESTRICT const stride = data_ + n + n + n;
 
-      size_type result = 0ul;
-      using std::cbegin;
-      auto index_it = cbegin(index);
-      for(unsigned int i = 0u; i < rank_; ++i, ++index_it) {
-        const size_type stride_i = stride[i];
-        result += *(index_it) * stride_i;
-      }
+        size_type result = 0ul;
+        using std::cbegin;
+        auto index_it = cbegin(index);
+        for(unsigned int i = 0u; i < n; ++i, ++index_it) {
+          const size_type stride_i = stride[i];
+          result += *(index_it) * stride_i;
+        }
 
-      return result - offset_;
+        return result - offset_;
+      });
     }
 
     /// calculate the ordinal index of \c index
@@ -888,23 +974,27 @@ namespace TiledArray {
       // Construct result coordinate index object and allocate its memory.
       Range_::index result(rank_, 0);
 
-      // Get pointers to the data
-      size_type * MADNESS_RESTRICT const result_data = result.data();
-      size_type const * MADNESS_RESTRICT const lower = data_;
-      size_type const * MADNESS_RESTRICT const size = data_ + rank_ + rank_;
+      detail::rank_dispatch(rank_, [&] (auto r) {
+        const unsigned int n = detail::kernel_rank(r, rank_);
 
-      // Compute the coordinate index of index in range.
-      for(int i = int(rank_) - 1; i >= 0; --i) {
-        const size_type lower_i = lower[i];
-        const size_type size_i = size[i];
+        // Get pointers to the data
+        size_type * MADNESS_RESTRICT const result_data = result.data();
+        size_type const * MADNESS_RESTRICT const lower = data_;
+        size_type const * MADNESS_RESTRICT const size = data_ + n + n;
 
-        // Compute result index element i
-        const size_type result_i = (index % size_i) + lower_i;
-        index /= size_i;
+        // Compute the coordinate index of index in range.
+        for(int i = int(n) - 1; i >= 0; --i) {
+          const size_type lower_i = lower[i];
+          const size_type size_i = size[i];
 
-        // Store result
-        result_data[i] = result_i;
-      }
+          // Compute result index element i
+          const size_type result_i = (index % size_i) + lower_i;
+          index /= size_i;
+
+          // Store result
+          result_data[i] = result_i;
+        }
+      });
 
       return result;
     }
@@ -931,11 +1021,7 @@ namespace TiledArray {
 
       // Reallocate the array
       const unsigned int four_x_rank = rank << 2;
-      if(rank_ != rank) {
-        delete [] data_;
-        data_ = (rank > 0u ? new size_type[four_x_rank] : nullptr);
-        rank_ = rank;
-      }
+      reallocate_data(rank);
 
       // Get range data
       ar & madness::archive::wrap(data_, four_x_rank) & offset_ & volume_;
@@ -948,11 +1034,9 @@ namespace TiledArray {
     }
 
     void swap(Range_& other) {
-      // Get temp data
-      std::swap(data_, other.data_);
-      std::swap(offset_, other.offset_);
-      std::swap(volume_, other.volume_);
-      std::swap(rank_, other.rank_);
+      Range_ temp(std::move(other));
+      other = std::move(*this);
+      *this = std::move(temp);
     }
 
   private:
@@ -985,24 +1069,27 @@ namespace TiledArray {
     void increment(index& i) const {
       TA_ASSERT(includes(i));
 
-      size_type const * MADNESS_RESTRICT const lower = data_;
-      size_type const * MADNESS_RESTRICT const upper = data_ + rank_;
+      detail::rank_dispatch(rank_, [&] (auto r) {
+        const unsigned int n = detail::kernel_rank(r, rank_);
+        size_type const * MADNESS_RESTRICT const lower = data_;
+        size_type const * MADNESS_RESTRICT const upper = data_ + n;
 
-      for(int d = int(rank_) - 1; d >= 0; --d) {
-        // increment coordinate
-        ++i[d];
+        for(int d = int(n) - 1; d >= 0; --d) {
+          // increment coordinate
+          ++i[d];
 
-        // break if done
-        if(i[d] < upper[d])
-          return;
+          // break if done
+          if(i[d] < upper[d])
+            return;
 
-        // Reset current index to lower bound.
-        i[d] = lower[d];
-      }
+          // Reset current index to lower bound.
+          i[d] = lower[d];
+        }
 
-      // if the current location was set to lower then it was at the end and
-      // needs to be reset to equal upper.
-      std::copy(upper, upper + rank_, i.begin());
+        // if the current location was set to lower then it was at the end and
+        // needs to be reset to equal upper.
+        std::copy(upper, upper + n, i.begin());
+      });
     }
 
     /// Advance the coordinate index \c i by \c n in this range
@@ -1039,14 +1126,17 @@ namespace TiledArray {
     TA_ASSERT(perm.dim() == rank_);
     if(rank_ > 1ul) {
       // Copy the lower and upper bound data into a temporary array
-      size_type* MADNESS_RESTRICT const temp_lower = new size_type[rank_ << 1];
+      size_type small_temp[small_rank_ << 1];
+      size_type* MADNESS_RESTRICT const temp_lower =
+          (rank_ <= small_rank_ ? small_temp : new size_type[rank_ << 1]);
       const size_type* MADNESS_RESTRICT const temp_upper = temp_lower + rank_;
       std::memcpy(temp_lower, data_, (sizeof(size_type) << 1) * rank_);
 
       init_range_data(perm, temp_lower, temp_upper);
 
       // Cleanup old memory.
-      delete[] temp_lower;
+      if(temp_lower != small_temp)
+        delete[] temp_lower;
     }
     return *this;
   }
@@ -23,8 +23,65 @@
 #include <TiledArray/config.h>
 #include <TiledArray/error.h>
 #include <TiledArray/madness.h>
+#include <TiledArray/task_priority.h>
+#include <TiledArray/task_trace.h>
+#include <TiledArray/tile_timing.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <thread>
 
 namespace TiledArray {
+
+  /// Deterministic reduction mode
+
+  /// By default, \c detail::ReduceTask reduces its arguments as they become
+  /// ready, so the result of a floating-point reduction, e.g. a SUMMA
+  /// result tile or \c Expr::reduce() , may differ in the last bits from run
+  /// to run. In deterministic mode, the arguments of each reduction are
+  /// reduced in the order in which they were added, which is the order of
+  /// the inner (k) index for SUMMA and the order of the local tiles for
+  /// \c Expr::reduce() , so the results are bitwise reproducible for a given
+  /// number of processes and process grid, independent of the number of
+  /// threads and of the message arrival order.
+  ///
+  /// The deterministic mode is intended for validation runs. Its overhead
+  /// is that the arguments of one reduction are reduced sequentially, by one
+  /// task at a time, instead of concurrently, and an argument that is ready
+  /// before its predecessors is held, with its memory, until they have been
+  /// reduced. The time of a contraction whose result tiles have many
+  /// contributions may increase accordingly, as may the peak memory of the
+  /// SUMMA pipeline.
+  /// The mode is enabled by default when the \c TA_DETERMINISTIC_REDUCTION
+  /// environment variable is set.
+  class DeterministicReduction {
+  private:
+
+    static bool& enabled_ref() {
+      static bool enabled = (getenv("TA_DETERMINISTIC_REDUCTION") != nullptr);
+      return enabled;
+    }
+
+  public:
+
+    /// Enable or disable the deterministic mode
+
+    /// \param enabled \c true to reduce the arguments in order
+    /// \note The mode applies to the reductions constructed after this call;
+    /// it should be set to the same value on all processes.
+    static void set(const bool enabled) { enabled_ref() = enabled; }
+
+    /// Deterministic mode accessor
+
+    /// \return \c true if arguments are reduced in order
+    static bool enabled() { return enabled_ref(); }
+
+  }; // class DeterministicReduction
+
   namespace detail {
 
     template <typename T>
@@ -126,7 +183,13 @@ namespace TiledArray {
     /// order. This is much faster than a simple binary tree reduction since the
     /// reduction tasks do not have to wait for specific pairs of data. Though
     /// data that is not stored in a future can be used, it may not be the best
-    /// choice in that case.
+    /// choice in that case. When \c DeterministicReduction is enabled, the
+    /// arguments are instead reduced in the order in which they were added.
+    ///
+    /// Ready arguments are reduced into one partial result per thread lane,
+    /// without a lock, and the partial results are combined when the task
+    /// runs, so many arguments that become ready at once, e.g. the SUMMA
+    /// contributions to a result tile, are reduced concurrently.
     ///
     /// The reduction operation must have the following form:
     /// \code
@@ -218,6 +281,12 @@ namespace TiledArray {
           typename ArgumentHelper<argument_type>::type arg_; ///< The reduction argument
           madness::CallbackInterface* callback_; ///< Reduction callback
           madness::AtomicInt count_; ///< Dependency counter
+          std::size_t ordinal_; ///< The position of the argument in the reduction
+
+        public:
+          ReduceObject* next_; ///< The next object of the ready stack
+
+        private:
 
           /// Register a future as a dependency
 
@@ -257,9 +326,12 @@ namespace TiledArray {
           /// \param parent The owner of this object
           /// \param arg The reduction argument
           /// \param callback The callback to invoke when this argument has been reduced
+          /// \param ordinal The position of the argument in the reduction
           template <typename Arg>
-          ReduceObject(ReduceTaskImpl* parent, const Arg& arg, madness::CallbackInterface* callback) :
-          parent_(parent), arg_(arg), callback_(callback)
+          ReduceObject(ReduceTaskImpl* parent, const Arg& arg,
+              madness::CallbackInterface* callback, const std::size_t ordinal) :
+          parent_(parent), arg_(arg), callback_(callback), ordinal_(ordinal),
+          next_(nullptr)
           {
             TA_ASSERT(parent_);
             register_callbacks(arg_);
@@ -275,6 +347,11 @@ namespace TiledArray {
           /// \return A const reference to the reduction argument
           const argument_type& arg() const { return arg_; }
 
+          /// Ordinal accessor
+
+          /// \return The position of the argument in the reduction
+          std::size_t ordinal() const { return ordinal_; }
+
           /// Destroy the \c object
 
           /// This function will invoke the callback and delete object.
@@ -302,97 +379,144 @@ namespace TiledArray {
           return PoolTaskInterface::make_id(id, *this);
         }
 
-        /// Check for ready reduce arguments and reduce them
-
-        /// This function will check for and reduce data that is ready until
-        /// there is no more data to be reduced. Once there is no more data
-        /// that is ready to be reduced, result will be placed in the ready
-        /// state.
-        /// \param result The result object that will be used to reduce
-        /// other data
-        void reduce(std::shared_ptr<result_type>& result) {
-          while(result) {
-            lock_.lock(); // <<< Begin critical section
-            if(ready_object_) {
-              // Get the ready argument
-              ReduceObject* ready_object = const_cast<ReduceObject*>(ready_object_);
-              ready_object_ = nullptr;
-              lock_.unlock(); // <<< End critical section
-
-              // Reduce the argument that was held by ready_object_
-              op_(*result, ready_object->arg());
-
-              // cleanup the argument
-              ReduceObject::destroy(ready_object);
-              this->dec();
-            } else if(ready_result_) {
-              // Get the ready result
-              std::shared_ptr<result_type> ready_result = ready_result_;
-              ready_result_.reset();
-              lock_.unlock(); // <<< End critical section
+        /// A partial reduction
+
+        /// Ready arguments are pushed onto a lock-free stack. The first
+        /// argument that is pushed onto an empty lane submits a task that
+        /// reduces the arguments of the stack into the partial result of the
+        /// lane, until no arguments are pending, so at most one task reduces
+        /// each lane at a time.
+        struct Lane {
+          std::atomic<ReduceObject*> head; ///< The stack of ready arguments
+          std::atomic<std::size_t> pending; ///< The number of arguments pushed but not reduced
+          std::shared_ptr<result_type> partial; ///< The partial result of the lane
+
+          Lane() : head(nullptr), pending(0ul), partial() { }
+        }; // struct Lane
+
+        /// Reduce the ready arguments of a lane
+
+        /// \param l The lane index
+        void drain(const std::size_t l) {
+          TaskTraceScope trace("reduce", "drain");
+          Lane& lane = lanes_[l];
+          if(! lane.partial)
+            lane.partial = std::make_shared<result_type>(op_());
+
+          while(true) {
+            // Take all arguments on the stack. An argument is counted as
+            // pending before it is pushed, so the stack may be empty while
+            // the push completes.
+            const double begin = begin_timing();
+            ReduceObject* object = lane.head.exchange(nullptr, std::memory_order_acquire);
+            std::size_t n = 0ul;
+            while(object) {
+              ReduceObject* const next = object->next_;
+              op_(*lane.partial, object->arg());
+              ReduceObject::destroy(object);
+              object = next;
+              ++n;
+            }
+            end_timing(begin);
 
-              // Reduce the result that was held by ready_result_
-              op_(*result, *ready_result);
+            const std::size_t remaining =
+                lane.pending.fetch_sub(n, std::memory_order_acq_rel) - n;
 
-              // cleanup the result
-              ready_result.reset();
-            } else {
-              // Nothing is ready, so place result in the ready state.
-              ready_result_ = result;
-              result.reset();
-              lock_.unlock(); // <<< End critical section
-            }
+            // Decrement the dependency counter for the arguments. This must
+            // be done after the lane is released, since the task may run and
+            // be deleted after the last argument has been reduced.
+            for(; n; --n)
+              this->dec();
+            if(remaining == 0ul)
+              break;
           }
         }
 
-        /// Reduce an argument
+        /// Take the next argument of an ordered reduction, if it is ready
 
-        /// \param result The target of the reduction
-        /// \param object The reduction argument to be reduced
-        void reduce_result_object(std::shared_ptr<result_type> result, const ReduceObject* object) {
-          // Reduce the argument
-          op_(*result, object->arg());
+        /// \return The next argument, or \c nullptr if it is not ready, in
+        /// which case the reduction is no longer draining
+        ReduceObject* next_ordered() {
+          madness::ScopedMutex<madness::Spinlock> locker(& ordered_lock_);
+          const auto it = ordered_.find(next_ordinal_);
+          if(it == ordered_.end()) {
+            ordered_draining_ = false;
+            return nullptr;
+          }
+          ReduceObject* const object = it->second;
+          ordered_.erase(it);
+          ++next_ordinal_;
+          return object;
+        }
 
-          // Cleanup the argument
-          ReduceObject::destroy(object);
+        /// Reduce the arguments of an ordered reduction in order
+
+        /// The arguments are reduced into the partial result of the first
+        /// lane until the next argument is not ready.
+        void drain_ordered() {
+          TaskTraceScope trace("reduce", "drain ordered");
+          Lane& lane = lanes_[0];
+          if(! lane.partial)
+            lane.partial = std::make_shared<result_type>(op_());
+
+          ReduceObject* object = next_ordered();
+          while(object) {
+            const double begin = begin_timing();
+            op_(*lane.partial, object->arg());
+            ReduceObject::destroy(object);
+            end_timing(begin);
+
+            // Take the next argument before the dependency counter is
+            // decremented, since the task may run and be deleted after the
+            // last argument has been reduced.
+            ReduceObject* const next = next_ordered();
+            this->dec();
+            object = next;
+          }
+        }
 
-          // Check for more reductions
-          reduce(result);
+        /// Start timing a reduction step
 
-          // Decrement the dependency counter for the argument. This must
-          // be done after the reduce call to avoid a race condition.
-          this->dec();
+        /// \return The start time, or a negative value if tile timing is
+        /// disabled
+        static double begin_timing() {
+          return (TileTimings::enabled() ? TileTimings::now() : -1.0);
         }
 
-        /// Reduce two reduction arguments
-        void reduce_object_object(const ReduceObject* object1, const ReduceObject* object2) {
-          // Construct an empty result object
-          auto result = std::make_shared<result_type>(op_());
-
-          // Reduce the two arguments
-          op_(*result, object1->arg());
-          op_(*result, object2->arg());
+        /// Add the time of a reduction step to the busy time of this task
 
-          // Cleanup arguments
-          ReduceObject::destroy(object1);
-          ReduceObject::destroy(object2);
+        /// This must be called before the dependency counter is decremented,
+        /// since the task may run and be deleted afterward.
+        /// \param begin The start time of the step
+        void end_timing(const double begin) {
+          if(begin >= 0.0)
+            busy_ns_.fetch_add(std::uint64_t((TileTimings::now() - begin) * 1.0e9),
+                std::memory_order_relaxed);
+        }
 
-          // Check for more reductions
-          reduce(result);
+        /// Set the initial value of the reduction
 
-          // Decrement the dependency counter for the two arguments. This
-          // must be done after the reduce call to avoid a race condition.
-          this->dec();
+        /// \param seed The initial value
+        void set_seed(const result_type& seed) {
+          seed_ = std::make_shared<result_type>(seed);
           this->dec();
         }
 
         World& world_; ///< The world that owns this task
         opT op_; ///< The reduction operation
-        std::shared_ptr<result_type> ready_result_; ///< Result object that is ready to be reduced
-        volatile ReduceObject* ready_object_; ///< Reduction argument that is ready to be reduced
+        std::shared_ptr<result_type> seed_; ///< The initial value of the reduction
+        std::size_t nlanes_; ///< The number of lanes
+        std::unique_ptr<Lane[]> lanes_; ///< The partial reductions
+        const bool ordered_mode_; ///< Arguments are reduced in order
+        madness::Spinlock ordered_lock_; ///< Protects the ordered arguments
+        std::map<std::size_t, ReduceObject*> ordered_; ///< Ready arguments of an ordered reduction
+        std::size_t next_ordinal_; ///< The ordinal of the next argument to be reduced
+        bool ordered_draining_; ///< A task is reducing the ordered arguments
         Future<result_type> result_; ///< The result of the reduction task
-        madness::Spinlock lock_; ///< Task lock
         madness::CallbackInterface* callback_; ///< The completion callback
+        std::atomic<std::uint64_t> busy_ns_; ///< The time spent reducing, in nanoseconds
+        TileTimings::Source timing_source_; ///< The evaluator of the timed tile
+        std::size_t timing_index_; ///< The index of the timed tile, or -1 if not timed
 
       public:
 
@@ -403,48 +527,105 @@ namespace TiledArray {
         /// \param callback The callback that will be invoked when this task
         /// has completed
         ReduceTaskImpl(World& world, opT op, madness::CallbackInterface* callback) :
-          madness::TaskInterface(1, TaskAttributes::hipri()),
-          world_(world), op_(op), ready_result_(std::make_shared<result_type>(op())),
-          ready_object_(nullptr), result_(), lock_(), callback_(callback)
+          madness::TaskInterface(1, task_attributes(TaskClass::compute)),
+          world_(world), op_(op), seed_(),
+          nlanes_(std::max<int>(madness::ThreadPool::size(), 1) + 1ul),
+          lanes_(new Lane[nlanes_]),
+          ordered_mode_(DeterministicReduction::enabled()), ordered_lock_(),
+          ordered_(), next_ordinal_(0ul), ordered_draining_(false), result_(),
+          callback_(callback), busy_ns_(0ul), timing_source_(TileTimings::summa),
+          timing_index_(std::numeric_limits<std::size_t>::max())
         { }
 
         virtual ~ReduceTaskImpl() { }
 
         /// Task function
+
+        /// The partial results of the lanes are combined into the result.
         virtual void run(const madness::TaskThreadEnv&) {
-          TA_ASSERT(ready_result_);
-          result_.set(op_(*ready_result_));
+          TaskTraceScope trace("reduce", "reduce");
+          const double begin = begin_timing();
+          std::shared_ptr<result_type> result = seed_;
+          for(std::size_t l = 0ul; l < nlanes_; ++l) {
+            if(! lanes_[l].partial)
+              continue;
+            if(result)
+              op_(*result, *lanes_[l].partial);
+            else
+              result = lanes_[l].partial;
+          }
+          if(! result)
+            result = std::make_shared<result_type>(op_());
+          result_type value = op_(*result);
+          end_timing(begin);
+          if(timing_index_ != std::numeric_limits<std::size_t>::max() && begin >= 0.0)
+            TileTimings::record(timing_source_, timing_index_,
+                double(busy_ns_.load(std::memory_order_relaxed)) * 1.0e-9);
+          result_.set(std::move(value));
           if(callback_)
             callback_->notify();
         }
 
         /// Callback function invoked by \c ReductionObject
 
-        /// This function will place \c object in the ready state. If
-        /// another object is already in the ready state, then both objects
-        /// are used to spawn a task
+        /// This function pushes \c object onto the stack of the lane of the
+        /// calling thread, and submits a task to reduce the lane if no task
+        /// is reducing it.
         /// \param object The reduction object that is ready to be reduced
         void ready(ReduceObject* object) {
           TA_ASSERT(object);
-          lock_.lock(); // <<< Begin critical section
-          if(ready_result_) {
-            std::shared_ptr<result_type> ready_result = ready_result_;
-            ready_result_.reset();
-            lock_.unlock(); // <<< End critical section
-            TA_ASSERT(ready_result);
-            world_.taskq.add(this, & ReduceTaskImpl::reduce_result_object,
-                ready_result, object, TaskAttributes::hipri());
-          } else if(ready_object_) {
-            ReduceObject* ready_object = const_cast<ReduceObject*>(ready_object_);
-            ready_object_ = nullptr;
-            lock_.unlock(); // <<< End critical section
-            TA_ASSERT(ready_object);
-            world_.taskq.add(this, & ReduceTaskImpl::reduce_object_object,
-                object, ready_object, TaskAttributes::hipri());
-          } else {
-            ready_object_ = object;
-            lock_.unlock(); // <<< End critical section
+          if(ordered_mode_) {
+            // Start a task when the next argument in order becomes ready
+            bool drain = false;
+            {
+              madness::ScopedMutex<madness::Spinlock> locker(& ordered_lock_);
+              ordered_.emplace(object->ordinal(), object);
+              if((! ordered_draining_) && (object->ordinal() == next_ordinal_)) {
+                ordered_draining_ = true;
+                drain = true;
+              }
+            }
+            if(drain)
+              world_.taskq.add(this, & ReduceTaskImpl::drain_ordered,
+                  task_attributes(TaskClass::compute));
+            return;
           }
+
+          const std::size_t l =
+              std::hash<std::thread::id>()(std::this_thread::get_id()) % nlanes_;
+          Lane& lane = lanes_[l];
+
+          const bool idle =
+              (lane.pending.fetch_add(1ul, std::memory_order_acq_rel) == 0ul);
+          object->next_ = lane.head.load(std::memory_order_relaxed);
+          while(! lane.head.compare_exchange_weak(object->next_, object,
+              std::memory_order_release, std::memory_order_relaxed)) ;
+
+          if(idle)
+            world_.taskq.add(this, & ReduceTaskImpl::drain, l,
+                task_attributes(TaskClass::compute));
+        }
+
+        /// Set the initial value of the reduction
+
+        /// The partial results are reduced into \c seed when the task runs.
+        /// \param seed The initial value of the reduction
+        void seed(const Future<result_type>& seed) {
+          TA_ASSERT(! seed_);
+          // The seed is counted as the first argument
+          next_ordinal_ = 1ul;
+          this->inc();
+          world_.taskq.add(this, & ReduceTaskImpl::set_seed, seed,
+              task_attributes(TaskClass::compute));
+        }
+
+        /// Record the busy time of this task as the time of a tile
+
+        /// \param source The evaluator of the tile
+        /// \param index The ordinal index of the tile
+        void time_tile(const TileTimings::Source source, const std::size_t index) {
+          timing_source_ = source;
+          timing_index_ = index;
         }
 
         /// Task result accessor
@@ -524,7 +705,24 @@ namespace TiledArray {
       int add(const Arg& arg, madness::CallbackInterface* callback = nullptr) {
         TA_ASSERT(pimpl_);
         pimpl_->inc();
-        new typename ReduceTaskImpl::ReduceObject(pimpl_, arg, callback);
+        new typename ReduceTaskImpl::ReduceObject(pimpl_, arg, callback, count_);
+        return ++count_;
+      }
+
+      /// Set the initial value of the reduction
+
+      /// The arguments are reduced into \c seed instead of an empty result
+      /// object, which avoids a separate sum with \c seed after the
+      /// reduction. This function must be called before any argument is
+      /// added, and \c seed must not be shared with other objects, since it
+      /// is modified by the reduction. The initial value is counted as an
+      /// argument by \c count().
+      /// \param seed The initial value of the reduction
+      /// \return The total number of arguments added to this task
+      int seed(const Future<result_type>& seed) {
+        TA_ASSERT(pimpl_);
+        TA_ASSERT(count_ == 0ul);
+        pimpl_->seed(seed);
         return ++count_;
       }
 
@@ -533,6 +731,19 @@ namespace TiledArray {
       /// \return The total number of arguments added to this task
       int count() const { return count_; }
 
+      /// Record the time of this reduction as the time of a tile
+
+      /// When tile timing is enabled (see \c set_tile_timing() ), the time
+      /// spent reducing the arguments and the partial results is recorded
+      /// as the time of tile \c index when the reduction completes. This
+      /// function must be called before \c submit().
+      /// \param source The evaluator of the tile
+      /// \param index The ordinal index of the tile
+      void time_tile(const TileTimings::Source source, const std::size_t index) {
+        TA_ASSERT(pimpl_);
+        pimpl_->time_tile(source, index);
+      }
+
       /// Submit the reduction task to the task queue
 
       /// \return The result of the reduction
@@ -0,0 +1,264 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_REDUCTION_BATCH_H__INCLUDED
+#define TILEDARRAY_REDUCTION_BATCH_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Batch of deferred scalar all-reductions
+
+  /// Each all-reduce of a small value, e.g. \c Expr::dot() , costs a
+  /// latency-bound message tree. A reduction batch collects the local
+  /// values of many reductions and combines them with a single all-reduce
+  /// of a packed buffer when it is flushed, so a group of reductions costs
+  /// the latency of one. For example:
+  /// \code
+  /// TiledArray::ReductionBatch<double> batch(world);
+  /// auto e1 = a("i,j").dot(b("i,j"), batch);
+  /// auto e2 = c("i,j").squared_norm(batch);
+  /// auto e3 = batch.sum(local_energy);
+  /// batch.flush(); // one all-reduce for e1, e2, and e3
+  /// const double energy = e1.get() + e2.get() + e3.get();
+  /// \endcode
+  /// The futures returned by the batch are set after \c flush() ; waiting
+  /// on one of them before the batch is flushed will deadlock.
+  /// \c flush() is collective, and every process must add the same
+  /// reductions to the batch in the same order. The batch is flushed when
+  /// it is destroyed.
+  /// \tparam T The value type of the reductions
+  template <typename T>
+  class ReductionBatch {
+  public:
+    typedef ReductionBatch<T> ReductionBatch_; ///< This object type
+    typedef T value_type; ///< The value type of the reductions
+    typedef std::vector<T> buffer_type; ///< The packed buffer type
+
+  private:
+
+    typedef std::function<void(T&, const T&)> join_type;
+    typedef std::function<T(const T&)> post_type;
+
+    /// Packing state of a flushed batch
+    struct PackState {
+      buffer_type buffer; ///< The local values
+      std::atomic<std::size_t> remaining; ///< Values that are not packed yet
+      Future<buffer_type> packed; ///< The packed buffer
+
+      PackState(const std::size_t n) : buffer(n), remaining(n), packed() { }
+    }; // struct PackState
+
+    /// All-reduce operation of the packed buffers
+
+    /// The values are joined element-wise with the join operation of each
+    /// reduction.
+    class BatchReduceOp {
+      std::shared_ptr<const std::vector<join_type> > joins_;
+
+    public:
+      typedef buffer_type result_type; ///< The result buffer type
+      typedef buffer_type argument_type; ///< The partial result buffer type
+
+      BatchReduceOp(const std::shared_ptr<const std::vector<join_type> >& joins) :
+        joins_(joins)
+      { }
+
+      /// Create an empty result object
+      result_type operator()() const { return result_type(); }
+
+      /// Post processing step (no operation, passthrough)
+      result_type operator()(const result_type& temp) const { return temp; }
+
+      /// Join the partial result \c arg to \c result
+      void operator()(result_type& result, const argument_type& arg) const {
+        if(arg.empty())
+          return;
+        if(result.empty()) {
+          result = arg;
+        } else {
+          TA_ASSERT(result.size() == arg.size());
+          TA_ASSERT(result.size() == joins_->size());
+          for(std::size_t i = 0ul; i < result.size(); ++i)
+            (*joins_)[i](result[i], arg[i]);
+        }
+      }
+    }; // class BatchReduceOp
+
+    /// Key tag of the batch all-reduce
+    struct ReductionBatchTag { };
+
+    World& world_; ///< The world of the reductions
+    std::vector<Future<T> > locals_; ///< The local values of the pending reductions
+    std::vector<join_type> joins_; ///< The join operations of the pending reductions
+    std::vector<post_type> posts_; ///< The post-processing operations
+    std::vector<Future<T> > results_; ///< The results of the pending reductions
+
+    static void pack(const std::shared_ptr<PackState>& state,
+        const std::size_t i, const T& value)
+    {
+      state->buffer[i] = value;
+      if(--state->remaining == 0ul)
+        state->packed.set(std::move(state->buffer));
+    }
+
+    /// Results of a flushed batch
+    struct UnpackState {
+      std::vector<post_type> posts; ///< The post-processing operations
+      std::vector<Future<T> > results; ///< The result futures
+    }; // struct UnpackState
+
+    static void unpack(const buffer_type& buffer,
+        const std::shared_ptr<UnpackState>& state)
+    {
+      TA_ASSERT(buffer.size() == state->results.size());
+      for(std::size_t i = 0ul; i < buffer.size(); ++i)
+        state->results[i].set(state->posts[i](buffer[i]));
+    }
+
+  public:
+
+    /// Construct an empty batch
+
+    /// \param world The world of the reductions
+    explicit ReductionBatch(World& world) : world_(world) { }
+
+    ReductionBatch(const ReductionBatch_&) = delete;
+    ReductionBatch_& operator=(const ReductionBatch_&) = delete;
+
+    /// Flush the pending reductions
+    ~ReductionBatch() { flush(); }
+
+    /// World accessor
+
+    /// \return A reference to the world of the reductions
+    World& world() const { return world_; }
+
+    /// Pending reduction count
+
+    /// \return The number of reductions that have not been flushed
+    std::size_t size() const { return locals_.size(); }
+
+    /// Check for pending reductions
+
+    /// \return \c true if there are no reductions to be flushed
+    bool empty() const { return locals_.empty(); }
+
+    /// Add a reduction
+
+    /// \tparam Op The reduction operation type, which meets the interface
+    /// of the tile reductions: <tt>op(result, arg)</tt> joins two results,
+    /// and <tt>op(result)</tt> post-processes the reduced result.
+    /// \param local The local value of the reduction
+    /// \param op The reduction operation
+    /// \return A future to the reduced value, which is set when the batch
+    /// is flushed
+    template <typename Op>
+    Future<T> reduce(const Future<T>& local, const Op& op) {
+      locals_.push_back(local);
+      joins_.push_back([op] (T& result, const T& arg) { op(result, arg); });
+      posts_.push_back([op] (const T& result) { return T(op(result)); });
+      results_.push_back(Future<T>());
+      return results_.back();
+    }
+
+    /// Add a sum reduction
+
+    /// \param local The local value of the sum
+    /// \return A future to the sum, which is set when the batch is flushed
+    Future<T> sum(const Future<T>& local) {
+      return reduce_elements(local,
+          [] (T& result, const T& arg) { result += arg; });
+    }
+
+    /// Add a maximum reduction
+
+    /// \param local The local value
+    /// \return A future to the maximum, which is set when the batch is flushed
+    Future<T> max(const Future<T>& local) {
+      return reduce_elements(local,
+          [] (T& result, const T& arg) { result = std::max(result, arg); });
+    }
+
+    /// Add a minimum reduction
+
+    /// \param local The local value
+    /// \return A future to the minimum, which is set when the batch is flushed
+    Future<T> min(const Future<T>& local) {
+      return reduce_elements(local,
+          [] (T& result, const T& arg) { result = std::min(result, arg); });
+    }
+
+    /// Reduce the pending reductions on all processes
+
+    /// The local values are packed into one buffer as they become ready,
+    /// which is combined with a single non-blocking all-reduce. This
+    /// function does not wait for the local values or the all-reduce.
+    void flush() {
+      if(locals_.empty())
+        return;
+
+      const std::size_t n = locals_.size();
+      std::shared_ptr<PackState> state = std::make_shared<PackState>(n);
+      for(std::size_t i = 0ul; i < n; ++i)
+        world_.taskq.add(& ReductionBatch_::pack, state, i, locals_[i],
+            madness::TaskAttributes::hipri());
+
+      typedef madness::TaggedKey<madness::uniqueidT, ReductionBatchTag> key_type;
+      const Future<buffer_type> result = world_.gop.all_reduce(
+          key_type(world_.unique_obj_id()), state->packed,
+          BatchReduceOp(std::make_shared<const std::vector<join_type> >(
+          std::move(joins_))));
+      // The result futures are held by pointer, so the task does not
+      // depend on them
+      std::shared_ptr<UnpackState> results = std::make_shared<UnpackState>();
+      results->posts = std::move(posts_);
+      results->results = std::move(results_);
+      world_.taskq.add(& ReductionBatch_::unpack, result, results,
+          madness::TaskAttributes::hipri());
+
+      locals_.clear();
+      joins_.clear();
+      posts_.clear();
+      results_.clear();
+    }
+
+  private:
+
+    template <typename Join>
+    Future<T> reduce_elements(const Future<T>& local, const Join& join) {
+      locals_.push_back(local);
+      joins_.push_back(join);
+      posts_.push_back([] (const T& result) { return result; });
+      results_.push_back(Future<T>());
+      return results_.back();
+    }
+
+  }; // class ReductionBatch
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_REDUCTION_BATCH_H__INCLUDED
@@ -0,0 +1,215 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_REMOTE_TILE_CACHE_H__INCLUDED
+#define TILEDARRAY_REMOTE_TILE_CACHE_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+#include <list>
+#include <unordered_map>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Read cache of remote tiles
+
+    /// The cache holds the futures of recently requested remote tiles, with
+    /// least-recently-used eviction, so repeated requests for a remote tile
+    /// share one message. A future is cached when it is requested, so
+    /// concurrent requests for a tile that is still in transit also share
+    /// the message. The total size of the cached tiles is limited by a
+    /// capacity in bytes; a capacity of zero disables the cache.
+    /// \note The cache does not know when the owner of a tile modifies it,
+    /// so it must be cleared when the tiles of the array may have been
+    /// modified, e.g. after a fence that follows the modification.
+    /// \tparam Future The tile future type
+    template <typename Future>
+    class RemoteTileCache {
+    public:
+      typedef RemoteTileCache<Future> RemoteTileCache_; ///< This object type
+      typedef std::size_t size_type; ///< Size type
+      typedef Future future; ///< Tile future type
+
+    private:
+
+      /// A cached tile
+      struct Entry {
+        size_type index; ///< Tile index
+        size_type bytes; ///< The size of the tile data
+        future tile; ///< The tile future
+      }; // struct Entry
+
+      typedef std::list<Entry> list_type; ///< Cached tiles, most recently used first
+
+      mutable madness::Spinlock lock_; ///< Protects all members
+      size_type capacity_; ///< The maximum size of the cached tiles, in bytes
+      size_type bytes_; ///< The size of the cached tiles, in bytes
+      list_type list_; ///< The cached tiles in the order of their use
+      std::unordered_map<size_type, typename list_type::iterator> map_; ///< Cached tile lookup
+      size_type hits_; ///< The number of requests found in the cache
+      size_type misses_; ///< The number of requests not found in the cache
+
+      /// Evict the least recently used tiles until the tiles fit
+
+      /// \param capacity The maximum size of the cached tiles
+      void evict(const size_type capacity) {
+        while(bytes_ > capacity) {
+          const Entry& entry = list_.back();
+          bytes_ -= entry.bytes;
+          map_.erase(entry.index);
+          list_.pop_back();
+        }
+      }
+
+      // Not allowed
+      RemoteTileCache(const RemoteTileCache_&);
+      RemoteTileCache_& operator=(const RemoteTileCache_&);
+
+    public:
+
+      /// Construct a disabled cache
+      RemoteTileCache() :
+        lock_(), capacity_(0ul), bytes_(0ul), list_(), map_(),
+        hits_(0ul), misses_(0ul)
+      { }
+
+      /// Check that the cache is enabled
+
+      /// \return \c true if the capacity of the cache is not zero
+      bool enabled() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return capacity_ > 0ul;
+      }
+
+      /// Set the capacity of the cache
+
+      /// Tiles are evicted until the cached tiles fit in \c capacity .
+      /// \param capacity The maximum size of the cached tiles, in bytes, or
+      /// zero to disable the cache
+      void capacity(const size_type capacity) {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        capacity_ = capacity;
+        evict(capacity_);
+      }
+
+      /// Capacity accessor
+
+      /// \return The maximum size of the cached tiles, in bytes
+      size_type capacity() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return capacity_;
+      }
+
+      /// Find a tile in the cache, or request it
+
+      /// \tparam Op The request function type
+      /// \param index The tile index
+      /// \param bytes The size of the tile data
+      /// \param op The request function, which returns the future of the
+      /// remote tile
+      /// \return The future of tile \c index
+      template <typename Op>
+      future find(const size_type index, const size_type bytes, const Op& op) {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        const auto it = map_.find(index);
+        if(it != map_.end()) {
+          ++hits_;
+          list_.splice(list_.begin(), list_, it->second);
+          return it->second->tile;
+        }
+
+        ++misses_;
+        const future tile = op();
+        if(bytes <= capacity_) {
+          evict(capacity_ - bytes);
+          list_.push_front(Entry{index, bytes, tile});
+          map_.emplace(index, list_.begin());
+          bytes_ += bytes;
+        }
+        return tile;
+      }
+
+      /// Check that a tile is in the cache
+
+      /// \param index The tile index
+      /// \return \c true if tile \c index is cached
+      bool contains(const size_type index) const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return map_.find(index) != map_.end();
+      }
+
+      /// Add a requested tile to the cache
+
+      /// Unlike \c find() , the hit and miss counters are not changed, so
+      /// prefetched tiles are counted when they are found.
+      /// \param index The tile index
+      /// \param bytes The size of the tile data
+      /// \param tile The future of the remote tile
+      /// \return \c true if the tile was added, \c false if it was already
+      /// cached or does not fit in the cache
+      bool insert(const size_type index, const size_type bytes, const future& tile) {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        if((bytes > capacity_) || (map_.find(index) != map_.end()))
+          return false;
+        evict(capacity_ - bytes);
+        list_.push_front(Entry{index, bytes, tile});
+        map_.emplace(index, list_.begin());
+        bytes_ += bytes;
+        return true;
+      }
+
+      /// Remove all tiles from the cache
+
+      /// The hit and miss counters are not reset.
+      void clear() {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        evict(0ul);
+      }
+
+      /// The size of the cached tiles
+
+      /// \return The size of the cached tiles, in bytes
+      size_type bytes() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return bytes_;
+      }
+
+      /// Hit counter accessor
+
+      /// \return The number of requests that were found in the cache
+      size_type hits() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return hits_;
+      }
+
+      /// Miss counter accessor
+
+      /// \return The number of requests that were not found in the cache
+      size_type misses() const {
+        madness::ScopedMutex<madness::Spinlock> locker(& lock_);
+        return misses_;
+      }
+
+    }; // class RemoteTileCache
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_REMOTE_TILE_CACHE_H__INCLUDED
@@ -21,6 +21,7 @@
 #define TILEDARRAY_REPLICATOR_H__INCLUDED
 
 #include <TiledArray/madness.h>
+#include <TiledArray/dist_eval/node_bcast.h>
 
 namespace TiledArray {
   namespace detail {
@@ -28,7 +29,14 @@ namespace TiledArray {
     /// Replicate a \c Array object
 
     /// This object will create a replicated \c Array from a distributed
-    /// \c Array.
+    /// \c Array. The tiles are exchanged with a node-aware ring allgather:
+    /// each process sends its local tiles to its node leader (see
+    /// \c NodeMap ), the leaders pass the tiles around a ring of leaders,
+    /// and each leader sends the tiles that it receives to the other
+    /// processes on its node. The tiles are sent in batches of about
+    /// \c message_elements elements, which are forwarded as soon as they
+    /// arrive, so the ring is pipelined. Each node receives each tile once
+    /// over the network.
     /// \tparam A The array type
     /// Homeworld = M7R-227
     template <typename A>
@@ -37,11 +45,21 @@ namespace TiledArray {
       typedef Replicator<A> Replicator_; ///< This object type
       typedef madness::WorldObject<Replicator_> wobj_type; ///< The base object type
       typedef std::stack<madness::CallbackInterface*, std::vector<madness::CallbackInterface*> > callback_type; ///< Callback interface
+      typedef typename A::size_type size_type; ///< Size type
+      typedef std::vector<size_type> index_list; ///< A batch of tile indices
+      typedef std::vector<Future<typename A::value_type> > data_list; ///< A batch of tiles
 
       A destination_; ///< The replicated array
-      std::vector<typename A::size_type> indices_; ///< List of local tile indices
-      std::vector<Future<typename A::value_type> > data_; ///< List of local tiles
-      madness::AtomicInt sent_; ///< The number of nodes the data has been sent to
+      std::vector<size_type> indices_; ///< List of local tile indices
+      data_list data_; ///< List of local tiles
+      std::vector<std::size_t> batches_; ///< The first local tile of each batch, and the end
+      ProcessID leader_; ///< The leader of the node of this process
+      ProcessID next_leader_; ///< The next leader in the ring of leaders
+      std::size_t nodes_; ///< The number of nodes
+      std::vector<ProcessID> members_; ///< The other processes on this node (leaders only)
+      std::size_t expected_; ///< The number of remote tiles to be received
+      std::size_t received_; ///< The number of remote tiles that have been received
+      bool sent_; ///< The local tiles have been sent
       World& world_;
       volatile callback_type callbacks_; ///< A callback stack
       volatile mutable bool probe_; ///< Cache for local data probe
@@ -55,6 +73,9 @@ namespace TiledArray {
         }
       }
 
+      /// \note Assume object is already locked
+      bool is_done() const { return sent_ && (received_ == expected_); }
+
       /// Task that will call send when all local tiles are ready to be sent
       class DelaySend : public madness::TaskInterface {
       private:
@@ -67,10 +88,8 @@ namespace TiledArray {
           madness::TaskInterface(madness::TaskAttributes::hipri()),
           parent_(parent)
         {
-          typename std::vector<Future<typename A::value_type> >::iterator it =
-              parent_.data_.begin();
-          typename std::vector<Future<typename A::value_type> >::iterator end =
-              parent_.data_.end();
+          typename data_list::iterator it = parent_.data_.begin();
+          typename data_list::iterator end = parent_.data_.end();
           for(; it != end; ++it) {
             if(! it->probe()) {
               madness::DependencyInterface::inc();
@@ -94,10 +113,8 @@ namespace TiledArray {
         madness::ScopedMutex<madness::Spinlock> locker(this);
 
         if(! probe_) {
-          typename std::vector<Future<typename A::value_type> >::const_iterator it =
-              data_.begin();
-          typename std::vector<Future<typename A::value_type> >::const_iterator end =
-              data_.end();
+          typename data_list::const_iterator it = data_.begin();
+          typename data_list::const_iterator end = data_.end();
           for(; it != end; ++it)
             if(! it->probe())
               break;
@@ -108,11 +125,11 @@ namespace TiledArray {
         return probe_;
       }
 
-      /// Send data to the next node when it is ready
+      /// Send the local data when it is ready
       void delay_send() {
         if(probe()) {
           // The data is ready so send it now.
-          send(); // Replication is done
+          send();
         } else {
           // The local data is not ready to be sent, so create a task that will
           // send it when it is ready.
@@ -121,66 +138,151 @@ namespace TiledArray {
         }
       }
 
-      /// Send all local data to the next node
+      /// Send a batch of tiles around the ring and to the node members
+
+      /// \param hops The number of leaders that have not received the batch
+      /// \param exclude A node member that already holds the batch, or -1
+      /// \param indices The tile indices of the batch
+      /// \param data The tiles of the batch
+      void forward(const std::size_t hops, const ProcessID exclude,
+          const index_list& indices, const data_list& data)
+      {
+        if(hops)
+          wobj_type::task(next_leader_, & Replicator_::ring_handler, hops,
+              indices, data, madness::TaskAttributes::hipri());
+        for(const ProcessID member : members_)
+          if(member != exclude)
+            wobj_type::task(member, & Replicator_::node_handler, indices, data,
+                madness::TaskAttributes::hipri());
+      }
+
+      /// Send all local data
       void send() {
-        const long sent = ++sent_;
-        const ProcessID dest = (world_.rank() + sent) % world_.size();
+        for(std::size_t b = 0ul; (b + 1ul) < batches_.size(); ++b) {
+          const index_list indices(indices_.begin() + batches_[b],
+              indices_.begin() + batches_[b + 1ul]);
+          const data_list data(data_.begin() + batches_[b],
+              data_.begin() + batches_[b + 1ul]);
+          if(leader_ == world_.rank())
+            forward(nodes_ - 1ul, -1, indices, data);
+          else
+            wobj_type::task(leader_, & Replicator_::gather_handler,
+                world_.rank(), indices, data, madness::TaskAttributes::hipri());
+        }
 
-        if(dest != world_.rank()) {
-          wobj_type::task(dest, &  Replicator_::send_handler, indices_, data_,
-              madness::TaskAttributes::hipri());
-        } else
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        sent_ = true;
+        if(is_done())
           do_callbacks(); // Replication is done
       }
 
-      void send_handler(const std::vector<typename A::size_type>& indices,
-          const std::vector<Future<typename A::value_type> >& data)
-      {
-        typename std::vector<typename A::size_type>::const_iterator index_it =
-            indices.begin();
-        typename std::vector<Future<typename A::value_type> >::const_iterator data_it =
-            data.begin();
-        typename std::vector<Future<typename A::value_type> >::const_iterator data_end =
-            data.end();
+      /// Store a batch of remote tiles
 
+      /// \param indices The tile indices of the batch
+      /// \param data The tiles of the batch
+      void store(const index_list& indices, const data_list& data) {
+        typename index_list::const_iterator index_it = indices.begin();
+        typename data_list::const_iterator data_it = data.begin();
+        typename data_list::const_iterator data_end = data.end();
         for(; data_it != data_end; ++data_it, ++index_it)
           destination_.set(*index_it, data_it->get());
 
-        delay_send();
+        madness::ScopedMutex<madness::Spinlock> locker(this);
+        received_ += indices.size();
+        TA_ASSERT(received_ <= expected_);
+        if(is_done())
+          do_callbacks(); // Replication is done
+      }
+
+      /// Receive a batch of tiles of a node member (leaders only)
+      void gather_handler(const ProcessID source, const index_list& indices,
+          const data_list& data)
+      {
+        forward(nodes_ - 1ul, source, indices, data);
+        store(indices, data);
+      }
+
+      /// Receive a batch of tiles of another node (leaders only)
+      void ring_handler(const std::size_t hops, const index_list& indices,
+          const data_list& data)
+      {
+        forward(hops - 1ul, -1, indices, data);
+        store(indices, data);
+      }
+
+      /// Receive a batch of tiles from the node leader
+      void node_handler(const index_list& indices, const data_list& data) {
+        store(indices, data);
       }
 
     public:
 
-      Replicator(const A& source, const A destination) :
+      /// Constructor
+
+      /// \param source The distributed array
+      /// \param destination The replicated array
+      /// \param message_elements The approximate number of elements in each
+      /// message [ default = 1048576 ]
+      /// \note This constructor is collective.
+      Replicator(const A& source, const A destination,
+          const std::size_t message_elements = 1048576ul) :
         wobj_type(source.world()), madness::Spinlock(),
-        destination_(destination), indices_(), data_(), sent_(),
+        destination_(destination), indices_(), data_(), batches_(1ul, 0ul),
+        leader_(source.world().rank()), next_leader_(source.world().rank()),
+        nodes_(1ul), members_(), expected_(0ul), received_(0ul), sent_(false),
         world_(source.world()), callbacks_(), probe_(false)
       {
-        sent_ = 0;
-
-        // Generate a list of local tiles from other.
+        // Generate a list of local tiles from other, divided into batches
         typename A::pmap_interface::const_iterator end = source.pmap()->end();
         typename A::pmap_interface::const_iterator it = source.pmap()->begin();
         indices_.reserve(source.pmap()->local_size());
         data_.reserve(source.pmap()->local_size());
-        if(source.is_dense()) {
-          // When dense, all tiles are present
-          for(; it != end; ++it) {
+        std::size_t elements = 0ul;
+        for(; it != end; ++it) {
+          // When sparse, only the non-zero tiles are sent
+          if(source.is_dense() || (! source.is_zero(*it))) {
+            const std::size_t volume = source.trange().make_tile_range(*it).volume();
+            if(elements && ((elements + volume) > message_elements)) {
+              batches_.push_back(indices_.size());
+              elements = 0ul;
+            }
+            elements += volume;
             indices_.push_back(*it);
             data_.push_back(source.find(*it));
             destination_.set(*it, data_.back());
           }
-        } else {
-          // When sparse, we need to generate a list
-          for(; it != end; ++it)
-            if(! source.is_zero(*it)) {
-              indices_.push_back(*it);
-              data_.push_back(source.find(*it));
-              destination_.set(*it, data_.back());
-            }
+        }
+        if(! indices_.empty())
+          batches_.push_back(indices_.size());
+
+        // Count the remote tiles
+        for(size_type i = 0ul; i < source.size(); ++i)
+          if((source.is_dense() || (! source.is_zero(i)))
+              && (! source.is_local(i)))
+            ++expected_;
+
+        // Find the ring of node leaders and the members of this node
+        const std::shared_ptr<NodeMap> node_map = NodeMap::instance(world_);
+        const ProcessID rank = world_.rank();
+        const ProcessID nprocs = world_.size();
+        leader_ = node_map->leader(rank);
+        nodes_ = 0ul;
+        for(ProcessID p = 0; p < nprocs; ++p) {
+          if(node_map->leader(p) == p)
+            ++nodes_;
+          else if((leader_ == rank) && (node_map->leader(p) == rank))
+            members_.push_back(p);
+        }
+        next_leader_ = leader_;
+        for(ProcessID p = 1; p < nprocs; ++p) {
+          const ProcessID q = (leader_ + p) % nprocs;
+          if(node_map->leader(q) == q) {
+            next_leader_ = q;
+            break;
+          }
         }
 
-        /// Send the data to the first node
+        /// Send the data to the node leader, or to the ring of leaders
         delay_send();
 
         // Process any pending messages
@@ -189,22 +291,23 @@ namespace TiledArray {
 
       /// Check that the replication is complete
 
-      /// \return \c true when all data has been transfered.
+      /// \return \c true when the local data has been sent and all remote
+      /// data has been received.
       bool done() {
         madness::ScopedMutex<madness::Spinlock> locker(this);
-        return sent_ == world_.size();
+        return is_done();
       }
 
 
       /// Add a callback
 
-      /// The callback is called when the local data has been sent to all
-      /// nodes. If the data has already been sent to all nodes, the callback
-      /// is notified immediately.
+      /// The callback is called when the local data has been sent and all
+      /// remote data has been received. If that has already happened, the
+      /// callback is notified immediately.
       /// \param callback The callback object
       void register_callback(madness::CallbackInterface* callback) {
           madness::ScopedMutex<madness::Spinlock> locker(this);
-          if(sent_ == world_.size())
+          if(is_done())
             callback->notify();
           else
             const_cast<callback_type&>(callbacks_).push(callback);
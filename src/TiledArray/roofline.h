@@ -0,0 +1,185 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  roofline.h
+ *
+ */
+
+#ifndef TILEDARRAY_ROOFLINE_H__INCLUDED
+#define TILEDARRAY_ROOFLINE_H__INCLUDED
+
+#include <TiledArray/block_size_tuner.h>
+#include <TiledArray/work_counter.h>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace TiledArray {
+
+  /// Efficiency of an expression evaluation relative to the machine peaks
+
+  /// The counts of the evaluation (see \c last_eval_statistics() ) of the
+  /// most loaded process give three lower bounds of its time: the tile GEMM
+  /// time at the peak flop rate, the transfer time of the received data at
+  /// the peak broadcast bandwidth, and the latency of the received messages.
+  /// The evaluation is classified by the largest bound, except that a
+  /// compute-bound evaluation whose flops are unevenly distributed among the
+  /// processes is imbalance-bound.
+  struct RooflineReport {
+    /// The resource that bounds the evaluation
+    enum Bound { compute, bandwidth, latency, imbalance };
+
+    double wall_time = 0.0; ///< The time of the evaluation on the slowest process, in seconds
+    double flop_rate = 0.0; ///< The flop rate of all processes
+    double peak_fraction = 0.0; ///< \c flop_rate over the peak flop rate of all processes
+    double bandwidth_rate = 0.0; ///< The receive bandwidth of the most loaded process
+    double bandwidth_fraction = 0.0; ///< \c bandwidth_rate over the peak bandwidth
+    double flop_imbalance = 1.0; ///< The largest flops of a process over the average
+    double compute_time = 0.0; ///< The compute bound, in seconds
+    double transfer_time = 0.0; ///< The bandwidth bound, in seconds
+    double latency_time = 0.0; ///< The latency bound, in seconds
+    Bound bound = compute; ///< The classification of the evaluation
+
+    /// \return The name of \c b
+    static const char* name(const Bound b) {
+      static const char* names[] = { "compute-bound", "bandwidth-bound",
+          "latency-bound", "imbalance-bound" };
+      return names[b];
+    }
+
+    /// Print the report on one line
+
+    /// \param os The output stream
+    /// \param label The label of the statement [ default = "" ]
+    void print(std::ostream& os, const std::string& label = "") const {
+      const std::ios::fmtflags flags = os.flags();
+      const std::streamsize precision = os.precision();
+      if(! label.empty())
+        os << label << ": ";
+      os << std::setprecision(3) << flop_rate / 1.0e9 << " GFLOP/s ("
+         << 100.0 * peak_fraction << "% of peak), " << bandwidth_rate / 1.0e9
+         << " GB/s received (" << 100.0 * bandwidth_fraction
+         << "% of peak), flop imbalance " << flop_imbalance << ", "
+         << wall_time << " s -> " << name(bound) << " (bounds: compute "
+         << compute_time << " s, bandwidth " << transfer_time << " s, latency "
+         << latency_time << " s)\n";
+      os.flags(flags);
+      os.precision(precision);
+    }
+  }; // struct RooflineReport
+
+  /// Calibrated machine peaks
+
+  /// The peaks are those of the \c BlockSizeTuner machine model, which is
+  /// calibrated once per machine and cached on disk. The peak flop rate of
+  /// a process is the fastest single-thread tile GEMM rate times the
+  /// number of threads.
+  /// \param world The world of the processes
+  /// \return The machine model of \c world
+  /// \note This function is collective on the first call for a world.
+  inline const BlockSizeTuner::MachineModel& machine_peaks(World& world) {
+    static std::mutex mtx;
+    static std::map<unsigned long, BlockSizeTuner::MachineModel> peaks;
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      auto it = peaks.find(world.id());
+      if(it != peaks.end())
+        return it->second;
+    }
+
+    BlockSizeTuner tuner(world);
+    const BlockSizeTuner::MachineModel model = tuner.model();
+    std::lock_guard<std::mutex> lock(mtx);
+    return peaks.emplace(world.id(), model).first->second;
+  }
+
+  /// Compare the last expression evaluation with the machine peaks
+
+  /// \param world The world of the evaluation
+  /// \param peaks The machine peaks
+  /// \param imbalance_threshold The flop imbalance above which a
+  /// compute-bound evaluation is imbalance-bound [ default = 1.25 ]
+  /// \return The efficiency and classification of the last evaluation
+  /// \note This function is collective.
+  inline RooflineReport roofline_report(World& world,
+      const BlockSizeTuner::MachineModel& peaks,
+      const double imbalance_threshold = 1.25)
+  {
+    const WorkStatistics stats = last_eval_statistics();
+    double sums[1] = { double(stats.flops) };
+    double maxs[4] = { double(stats.flops), double(stats.bytes_received),
+        double(stats.messages_received), stats.wall_time };
+    world.gop.sum(sums, 1);
+    world.gop.max(maxs, 4);
+
+    double peak_rate = 0.0;
+    for(const auto& rate : peaks.gemm_rate)
+      peak_rate = std::max(peak_rate, rate.second);
+    peak_rate *= double(std::max<std::size_t>(madness::ThreadPool::size(), 1ul));
+
+    RooflineReport report;
+    const double nprocs = world.size();
+    report.wall_time = maxs[3];
+    if(report.wall_time > 0.0) {
+      report.flop_rate = sums[0] / report.wall_time;
+      report.bandwidth_rate = maxs[1] / report.wall_time;
+    }
+    if(peak_rate > 0.0) {
+      report.peak_fraction = report.flop_rate / (peak_rate * nprocs);
+      report.compute_time = maxs[0] / peak_rate;
+    }
+    if(peaks.bandwidth > 0.0) {
+      report.bandwidth_fraction = report.bandwidth_rate / peaks.bandwidth;
+      report.transfer_time = maxs[1] / peaks.bandwidth;
+    }
+    report.latency_time = maxs[2] * peaks.latency;
+    if(sums[0] > 0.0)
+      report.flop_imbalance = maxs[0] * nprocs / sums[0];
+
+    if(report.transfer_time > report.compute_time &&
+        report.transfer_time >= report.latency_time)
+      report.bound = RooflineReport::bandwidth;
+    else if(report.latency_time > report.compute_time)
+      report.bound = RooflineReport::latency;
+    else if(report.flop_imbalance > imbalance_threshold)
+      report.bound = RooflineReport::imbalance;
+    else
+      report.bound = RooflineReport::compute;
+    return report;
+  }
+
+  /// Compare the last expression evaluation with the calibrated machine peaks
+
+  /// \code
+  /// c("i,j") = a("i,k") * b("k,j");
+  /// const auto report = TiledArray::roofline_report(world);
+  /// if(world.rank() == 0)
+  ///   report.print(std::cout, "c = a * b");
+  /// \endcode
+  /// \param world The world of the evaluation
+  /// \return The efficiency and classification of the last evaluation
+  /// \note This function is collective.
+  inline RooflineReport roofline_report(World& world) {
+    return roofline_report(world, machine_peaks(world));
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ROOFLINE_H__INCLUDED
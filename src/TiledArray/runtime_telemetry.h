@@ -0,0 +1,363 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  runtime_telemetry.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_RUNTIME_TELEMETRY_H__INCLUDED
+#define TILEDARRAY_RUNTIME_TELEMETRY_H__INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <TiledArray/task_trace.h>
+
+namespace TiledArray {
+
+  /// Sample of the MADNESS runtime of a process
+  struct RuntimeSample {
+    double time; ///< The wall time of the sample, in seconds (see \c detail::TaskTrace::now() )
+    std::size_t statement; ///< The index of the statement that was evaluated
+    std::size_t queued_tasks; ///< The number of tasks in the task queue
+    double active_threads; ///< The average number of busy threads since the previous sample
+    double idle_fraction; ///< The idle fraction of the threads since the previous sample
+    std::uint64_t messages_sent; ///< Active messages sent since the previous sample
+    std::uint64_t bytes_sent; ///< Bytes of active messages sent since the previous sample
+    std::uint64_t messages_received; ///< Active messages received since the previous sample
+    std::uint64_t bytes_received; ///< Bytes of active messages received since the previous sample
+  }; // struct RuntimeSample
+
+  /// Expression statement evaluated while the runtime was sampled
+  struct RuntimeStatement {
+    std::size_t index; ///< The index of the statement, starting at 1
+    std::string label; ///< The expression trace of the statement, on one line
+    double begin; ///< The start time of the evaluation, in seconds
+    double end; ///< The end time of the evaluation, in seconds (zero while evaluated)
+  }; // struct RuntimeStatement
+
+  namespace detail {
+
+    /// Sampled telemetry of the MADNESS runtime
+
+    /// While telemetry is started (see \c start_runtime_telemetry() ), a
+    /// thread samples the runtime of this process at a fixed interval, as
+    /// long as an expression statement is evaluated (see
+    /// \c RuntimeTelemetryScope ). Each sample records the length of the task
+    /// queue, the number of busy threads and the idle fraction of the
+    /// threads, and the number and size of the active messages sent and
+    /// received since the previous sample. MADNESS does not expose the state
+    /// of its threads, so the busy threads are measured as the CPU time of
+    /// the process per wall time, and the idle fraction is relative to the
+    /// threads of the pool and the main thread. Samples carry the index of
+    /// the statement that was evaluated last.
+    class RuntimeTelemetry {
+      mutable std::mutex mutex_; ///< Protects the members below
+      std::condition_variable cv_; ///< Wakes the sampling thread
+      std::thread thread_; ///< The sampling thread
+      bool running_; ///< The sampling thread is running
+      double interval_; ///< The sampling interval, in seconds
+      std::size_t active_; ///< The number of statements that are evaluated
+      std::vector<RuntimeStatement> statements_; ///< The evaluated statements
+      std::vector<RuntimeSample> samples_; ///< The samples
+
+      RuntimeTelemetry() : running_(false), interval_(0.01), active_(0ul) { }
+
+      /// Process CPU time
+
+      /// \return The CPU time of all threads of this process, in seconds
+      static double cpu_time() { return double(std::clock()) / double(CLOCKS_PER_SEC); }
+
+      /// Sampling loop
+      void sample_loop() {
+        double last_time = TaskTrace::now();
+        double last_cpu = cpu_time();
+        madness::RMIStats last_rmi = madness::RMI::get_stats();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while(running_) {
+          cv_.wait_for(lock, std::chrono::duration<double>(interval_));
+          if(! running_)
+            break;
+
+          const double time = TaskTrace::now();
+          const double cpu = cpu_time();
+          const madness::RMIStats rmi = madness::RMI::get_stats();
+          if(active_ && (time > last_time)) {
+            const double threads = double(madness::ThreadPool::size() + 1ul);
+            const double active_threads = std::max(cpu - last_cpu, 0.0) / (time - last_time);
+            const RuntimeSample sample = { time, statements_.back().index,
+                madness::ThreadPool::queue_size(), active_threads,
+                std::min(std::max(1.0 - active_threads / threads, 0.0), 1.0),
+                rmi.nmsg_sent - last_rmi.nmsg_sent, rmi.nbyte_sent - last_rmi.nbyte_sent,
+                rmi.nmsg_recv - last_rmi.nmsg_recv, rmi.nbyte_recv - last_rmi.nbyte_recv };
+            samples_.push_back(sample);
+          }
+
+          last_time = time;
+          last_cpu = cpu;
+          last_rmi = rmi;
+        }
+      }
+
+      /// Write a string as a JSON string
+
+      /// \param os The output stream
+      /// \param str The string
+      static void write_string(std::ostream& os, const std::string& str) {
+        os << '"';
+        for(const char c : str) {
+          if((c == '"') || (c == '\\'))
+            os << '\\';
+          os << c;
+        }
+        os << '"';
+      }
+
+    public:
+
+      RuntimeTelemetry(const RuntimeTelemetry&) = delete;
+      RuntimeTelemetry& operator=(const RuntimeTelemetry&) = delete;
+
+      ~RuntimeTelemetry() { stop(); }
+
+      /// The telemetry of this process
+      static RuntimeTelemetry& instance() {
+        static RuntimeTelemetry telemetry;
+        return telemetry;
+      }
+
+      /// Start sampling
+
+      /// If sampling is already started, only the interval is changed.
+      /// \param interval The sampling interval, in seconds
+      void start(const double interval) {
+        TA_USER_ASSERT(interval > 0.0,
+            "RuntimeTelemetry::start(): the sampling interval must be positive.");
+        std::lock_guard<std::mutex> lock(mutex_);
+        interval_ = interval;
+        if(! running_) {
+          running_ = true;
+          thread_ = std::thread([this] () { this->sample_loop(); });
+        }
+      }
+
+      /// Stop sampling
+
+      /// The samples and statements are kept.
+      void stop() {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          running_ = false;
+        }
+        cv_.notify_all();
+        if(thread_.joinable())
+          thread_.join();
+      }
+
+      /// Sampling flag
+
+      /// \return \c true if the runtime is sampled
+      bool enabled() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return running_;
+      }
+
+      /// Record the start of a statement
+
+      /// \param label The expression trace of the statement
+      /// \return The index of the statement
+      std::size_t begin_statement(const std::string& label) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::size_t index = statements_.size() + 1ul;
+        statements_.push_back(RuntimeStatement{ index, label, TaskTrace::now(), 0.0 });
+        ++active_;
+        return index;
+      }
+
+      /// Record the end of a statement
+
+      /// \param index The index of the statement
+      void end_statement(const std::size_t index) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        TA_ASSERT((index > 0ul) && (index <= statements_.size()));
+        statements_[index - 1ul].end = TaskTrace::now();
+        --active_;
+      }
+
+      /// \return A copy of the samples of this process
+      std::vector<RuntimeSample> samples() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return samples_;
+      }
+
+      /// \return A copy of the statements of this process
+      std::vector<RuntimeStatement> statements() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return statements_;
+      }
+
+      /// Remove all samples, and the statements that are not evaluated
+
+      /// Statements that are evaluated keep their index.
+      void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        samples_.clear();
+        if(! active_)
+          statements_.clear();
+      }
+
+      /// Write the telemetry in the Chrome trace event format
+
+      /// Statements are written as async events of the \c statement
+      /// category, and samples as counter events, one object per line with
+      /// \c rank as the process id. The events follow those of
+      /// \c TaskTrace::write() , which opens the event array.
+      /// \param os The output stream
+      /// \param rank The rank of this process
+      void write(std::ostream& os, const int rank) const {
+        const std::vector<RuntimeStatement> statements = this->statements();
+        const std::vector<RuntimeSample> samples = this->samples();
+        const std::ios::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << std::fixed << std::setprecision(3);
+        for(const RuntimeStatement& statement : statements) {
+          if(statement.end == 0.0) continue;
+          os << "{\"name\":";
+          write_string(os, statement.label);
+          os << ",\"cat\":\"statement\",\"ph\":\"b\",\"id\":" << statement.index
+             << ",\"pid\":" << rank << ",\"ts\":" << statement.begin * 1.0e6 << "},\n";
+          os << "{\"name\":";
+          write_string(os, statement.label);
+          os << ",\"cat\":\"statement\",\"ph\":\"e\",\"id\":" << statement.index
+             << ",\"pid\":" << rank << ",\"ts\":" << statement.end * 1.0e6 << "},\n";
+        }
+        for(const RuntimeSample& sample : samples) {
+          const double ts = sample.time * 1.0e6;
+          os << "{\"name\":\"tasks\",\"ph\":\"C\",\"pid\":" << rank << ",\"ts\":" << ts
+             << ",\"args\":{\"queued\":" << sample.queued_tasks
+             << ",\"statement\":" << sample.statement << "}},\n";
+          os << "{\"name\":\"threads\",\"ph\":\"C\",\"pid\":" << rank << ",\"ts\":" << ts
+             << ",\"args\":{\"active\":" << sample.active_threads
+             << ",\"idle_fraction\":" << sample.idle_fraction << "}},\n";
+          os << "{\"name\":\"active messages\",\"ph\":\"C\",\"pid\":" << rank
+             << ",\"ts\":" << ts << ",\"args\":{\"sent\":" << sample.messages_sent
+             << ",\"received\":" << sample.messages_received << "}},\n";
+          os << "{\"name\":\"active message bytes\",\"ph\":\"C\",\"pid\":" << rank
+             << ",\"ts\":" << ts << ",\"args\":{\"sent\":" << sample.bytes_sent
+             << ",\"received\":" << sample.bytes_received << "}},\n";
+        }
+        os.flags(flags);
+        os.precision(precision);
+      }
+
+    }; // class RuntimeTelemetry
+
+    /// Record the evaluation of a statement for the runtime telemetry
+
+    /// Nothing is recorded when the runtime is not sampled.
+    class RuntimeTelemetryScope {
+      std::size_t index_; ///< The index of the statement, or zero
+
+    public:
+
+      RuntimeTelemetryScope(const RuntimeTelemetryScope&) = delete;
+      RuntimeTelemetryScope& operator=(const RuntimeTelemetryScope&) = delete;
+
+      /// Constructor
+
+      /// \tparam Label The label function type
+      /// \param label A function that returns the label of the statement,
+      /// which is only called when the runtime is sampled
+      template <typename Label>
+      explicit RuntimeTelemetryScope(const Label& label) :
+        index_(RuntimeTelemetry::instance().enabled() ?
+            RuntimeTelemetry::instance().begin_statement(label()) : 0ul)
+      { }
+
+      ~RuntimeTelemetryScope() {
+        if(index_)
+          RuntimeTelemetry::instance().end_statement(index_);
+      }
+
+    }; // class RuntimeTelemetryScope
+
+  }  // namespace detail
+
+  /// Start sampling the MADNESS runtime of this process
+
+  /// The runtime is sampled every \c interval seconds while an expression is
+  /// assigned (see \c detail::RuntimeTelemetry ).
+  /// \param interval The sampling interval, in seconds [ default = 0.01 ]
+  inline void start_runtime_telemetry(const double interval = 0.01) {
+    detail::RuntimeTelemetry::instance().start(interval);
+  }
+
+  /// Stop sampling the MADNESS runtime of this process
+  inline void stop_runtime_telemetry() {
+    detail::RuntimeTelemetry::instance().stop();
+  }
+
+  /// Runtime samples of this process
+
+  /// \return The samples since the last \c write_runtime_telemetry()
+  inline std::vector<RuntimeSample> runtime_samples() {
+    return detail::RuntimeTelemetry::instance().samples();
+  }
+
+  /// Write the task trace and the runtime telemetry of each process to a file
+
+  /// Each process writes its task trace (see \c write_task_trace() ),
+  /// followed by its statements and runtime samples, to
+  /// <tt>prefix.rank.json</tt> ; the files are merged in the same way as
+  /// those of \c write_task_trace() . The samples are plotted as counters
+  /// of the process, and the statements as spans, so the runtime state can
+  /// be read against the tasks and the statement that was evaluated.
+  /// \param world The world of the processes
+  /// \param prefix The prefix of the file names
+  /// \param clear Remove the events and samples that are written
+  /// [ default = true ]
+  /// \throw TiledArray::Exception When a file cannot be opened
+  /// \note This function is collective.
+  inline void write_runtime_telemetry(World& world, const std::string& prefix,
+      const bool clear = true)
+  {
+    std::stringstream filename;
+    filename << prefix << "." << std::setfill('0') << std::setw(5)
+        << world.rank() << ".json";
+    std::ofstream file(filename.str());
+    if(! file)
+      TA_EXCEPTION("Unable to open the runtime telemetry file.");
+    detail::TaskTrace::write(file, world.rank());
+    detail::RuntimeTelemetry::instance().write(file, world.rank());
+    if(clear) {
+      detail::TaskTrace::clear();
+      detail::RuntimeTelemetry::instance().clear();
+    }
+    world.gop.fence();
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_RUNTIME_TELEMETRY_H__INCLUDED
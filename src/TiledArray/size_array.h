@@ -41,6 +41,32 @@ namespace TiledArray {
       T* first_ = nullptr; ///< First element of the array
       T* last_ = nullptr; ///< Last element of the array
 
+      /// Apply an in-place operation to blocks of the array
+
+      /// Arrays with at least \c math::parallel_vector_min_size elements are
+      /// split across threads.
+      /// \param op The block operation, <tt>op(first, last)</tt>
+      template <typename Op>
+      void for_each_block(const Op& op) const {
+        const std::size_t n = last_ - first_;
+        math::for_each_block_range(n, n >= math::parallel_vector_min_size, op);
+      }
+
+      /// Reduce the array
+
+      /// Arrays with at least \c math::parallel_vector_min_size elements are
+      /// split across threads.
+      template <typename ReduceOp, typename JoinOp, typename Result, typename... Args>
+      void reduce_vector(const ReduceOp& reduce_op, const JoinOp& join_op,
+          const Result& identity, Result& result, const Args* const... args) const
+      {
+        const std::size_t n = last_ - first_;
+        if(n >= math::parallel_vector_min_size)
+          math::reduce_op(reduce_op, join_op, identity, n, result, args...);
+        else
+          math::reduce_op_serial(reduce_op, join_op, identity, n, result, args...);
+      }
+
     public:
       // type definitions
       typedef T              value_type;
@@ -220,7 +246,10 @@ namespace TiledArray {
       /// \param op The binary operation
       template <typename Arg, typename Op>
       void binary(const Arg* const arg, const Op& op) {
-        math::vector_op(op, last_ - first_, first_, arg);
+        T* const result = first_;
+        for_each_block([=,&op] (const std::size_t first, const std::size_t last) {
+          math::inplace_vector_op_serial(op, last - first, result + first, arg + first);
+        });
       }
 
       /// Binary vector operation
@@ -236,7 +265,11 @@ namespace TiledArray {
       /// \param op The binary operation
       template <typename Left, typename Right, typename Op>
       void binary(const Left* const left, const Right* const right, const Op& op) {
-        math::vector_op(op, last_ - first_, first_, left, right);
+        T* const result = first_;
+        for_each_block([=,&op] (const std::size_t first, const std::size_t last) {
+          math::vector_op_serial(op, last - first, result + first, left + first,
+              right + first);
+        });
       }
 
       /// Unary vector operation
@@ -247,7 +280,10 @@ namespace TiledArray {
       /// \param op The binary operation
       template <typename Op>
       void unary(const Op& op) {
-        math::vector_op(op, last_ - first_, first_);
+        T* const result = first_;
+        for_each_block([=,&op] (const std::size_t first, const std::size_t last) {
+          math::inplace_vector_op_serial(op, last - first, result + first);
+        });
       }
 
       /// Unary vector operation
@@ -261,7 +297,10 @@ namespace TiledArray {
       /// \param op The unary, element operation
       template <typename Arg, typename Op>
       void unary(const Arg* const arg, const Op& op) {
-        math::vector_op(op, last_ - first_, first_, arg);
+        T* const result = first_;
+        for_each_block([=,&op] (const std::size_t first, const std::size_t last) {
+          math::vector_op_serial(op, last - first, result + first, arg + first);
+        });
       }
 
       /// Binary reduction operation
@@ -269,19 +308,22 @@ namespace TiledArray {
       /// Perform an element-wise binary reduction of the data of \c this and \c arg by
       /// executing <tt>join_op(result, reduce_op(*this[i], arg[i]))</tt> for each
       /// \c i in the index range of \c this . \c result is initialized to \c identity .
-      /// If HAVE_INTEL_TBB is defined the reduction will
-      /// be executed in an undefined order, otherwise will execute in the order of increasing \c i .
+      /// The reduction is vectorized, and large arrays are split across threads
+      /// when HAVE_INTEL_TBB is defined, so the elements are reduced in an
+      /// undefined order.
       /// \tparam Arg The right-hand argument type
       /// \tparam Result The reduction result type
       /// \tparam ReduceOp The binary reduction operation type
       /// \tparam JoinOp The join operation type
       /// \param arg The right-hand argument
-      /// \param result The initial value of the reduction
-      /// \param op The binary reduction operation
+      /// \param identity The identity of the reduction
+      /// \param reduce_op The binary reduction operation
+      /// \param join_op The operation that joins partial results
       /// \return The reduced value
       template <typename Arg, typename Result, typename ReduceOp, typename JoinOp>
-      Result reduce(const Arg* const arg, Result result, const ReduceOp& reduce_op, const JoinOp& join_op) const {
-        math::reduce_op(reduce_op, join_op, last_ - first_, result, first_, arg);
+      Result reduce(const Arg* const arg, const Result& identity, const ReduceOp& reduce_op, const JoinOp& join_op) const {
+        Result result = identity;
+        reduce_vector(reduce_op, join_op, identity, result, first_, arg);
         return result;
       }
 
@@ -290,17 +332,20 @@ namespace TiledArray {
       /// Perform an element-wise unary reduction of the data by
       /// executing <tt>join_op(result, reduce_op(*this[i]))</tt> for each
       /// \c i in the index range of \c this . \c result is initialized to \c identity .
-      /// If HAVE_INTEL_TBB is defined the reduction will
-      /// be executed in an undefined order, otherwise will execute in the order of increasing \c i .
+      /// The reduction is vectorized, and large arrays are split across threads
+      /// when HAVE_INTEL_TBB is defined, so the elements are reduced in an
+      /// undefined order.
       /// \tparam Result The reduction result type
       /// \tparam ReduceOp The binary reduction operation type
       /// \tparam JoinOp The join operation type
-      /// \param result The initial value of the reduction
-      /// \param op The unary reduction operation
+      /// \param identity The identity of the reduction
+      /// \param reduce_op The unary reduction operation
+      /// \param join_op The operation that joins partial results
       /// \return The reduced value
       template <typename Result, typename ReduceOp, typename JoinOp>
-      Result reduce(Result result, const ReduceOp& reduce_op, const JoinOp& join_op) const {
-        math::reduce_op(reduce_op, join_op, last_ - first_, result, first_);
+      Result reduce(const Result& identity, const ReduceOp& reduce_op, const JoinOp& join_op) const {
+        Result result = identity;
+        reduce_vector(reduce_op, join_op, identity, result, first_);
         return result;
       }
 
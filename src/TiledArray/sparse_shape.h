@@ -26,12 +26,20 @@
 #ifndef TILEDARRAY_SPARSE_SHAPE_H__INCLUDED
 #define TILEDARRAY_SPARSE_SHAPE_H__INCLUDED
 
+#include <TiledArray/compressed_norms.h>
+#include <TiledArray/norm_codec.h>
 #include <TiledArray/tensor.h>
 #include <TiledArray/tiled_range.h>
 #include <TiledArray/val_array.h>
 #include <TiledArray/tensor/shift_wrapper.h>
 #include <TiledArray/tensor/tensor_interface.h>
+#include <functional>
 #include <typeinfo>
+#ifdef HAVE_INTEL_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#endif // HAVE_INTEL_TBB
 
 namespace TiledArray {
 
@@ -47,6 +55,17 @@ namespace TiledArray {
   /// where \f$ij...\f$ are tile indices, \f$\|A_{ij}\|\f$ is norm of tile
   /// \f$ij...\f$, and \f$N_i N_j ...\f$ is the product of tile \f$ij...\f$ in
   /// each dimension.
+  /// The norms are stored either as a dense \c Tensor over the tile range,
+  /// or, for very large tile ranges, in a compressed form that holds only the
+  /// non-zero norms (see \c SparseShape::compress() ). The shape operations
+  /// (\c is_zero , \c perm , \c block , \c scale , \c add , \c mult ,
+  /// \c gemm , etc.) work on the compressed norms directly, so their memory
+  /// and time scale with the number of non-zero tiles. The results of
+  /// operations on compressed shapes are compressed.
+  /// Each shape has its own zero threshold (see \c zero_threshold() ), which
+  /// is the default \c threshold() when the shape is constructed. Unary
+  /// operations keep the threshold of the shape, and binary operations use
+  /// the tighter of the thresholds of their arguments.
   /// \tparam T The sparse element value type
   /// \note Scaling operations, such as SparseShape<T>::scale , SparseShape<T>::gemm , etc.
   ///       accept generic scaling factors; internally (modulus of) the scaling factor is first
@@ -60,6 +79,12 @@ namespace TiledArray {
                   "SparseShape<T> only supports scalar numeric types for T");
     typedef typename Tensor<value_type>::size_type size_type;  ///< Size type
 
+    /// Estimators of the norms of contractions
+    enum class GemmEstimate {
+      bound, ///< An upper bound, the sum of the norm products over the inner tiles
+      quadrature ///< The root of the sum of the squared norm products over the inner tiles
+    };
+
    private:
 
     // T must be a numeric type
@@ -68,11 +93,15 @@ namespace TiledArray {
 
     // Internal typedefs
     typedef detail::ValArray<value_type> vector_type;
+    typedef detail::CompressedNorms<value_type> compressed_type;
 
-    Tensor<value_type> tile_norms_; ///< Tile magnitude data
+    Tensor<value_type> tile_norms_; ///< Tile magnitude data (empty when compressed)
+    std::shared_ptr<const compressed_type> compressed_norms_; ///< Compressed tile magnitude data
     std::shared_ptr<vector_type> size_vectors_; ///< Tile size information; size_vectors_[d][i] reports the size of i-th tile in dimension d
     size_type zero_tile_count_; ///< Number of zero tiles
-    static value_type threshold_; ///< The zero threshold
+    value_type zero_threshold_; ///< The zero threshold of this shape
+    static value_type threshold_; ///< The default zero threshold
+    static GemmEstimate gemm_estimate_; ///< The estimator used by \c gemm
 
     template <typename Op>
     static vector_type
@@ -100,6 +129,63 @@ namespace TiledArray {
       return result;
     }
 
+    /// The number of norms processed by each task of the parallel passes
+
+    /// \return The smallest number of norms handled by a parallel task
+    static constexpr std::size_t parallel_grain_size() { return 4096ul; }
+
+    /// Apply an operation to blocks of rows of a matrix
+
+    /// The rows are split among threads when TBB is available.
+    /// \tparam Op The operation type
+    /// \param m The number of rows
+    /// \param n The number of columns
+    /// \param op The operation, <tt>op(i, rows)</tt> processes the \c rows
+    /// rows that start at row \c i
+    template <typename Op>
+    static void parallel_rows(const std::size_t m, const std::size_t n, const Op& op) {
+#ifdef HAVE_INTEL_TBB
+      const std::size_t grain = std::max<std::size_t>(1ul,
+          parallel_grain_size() / std::max<std::size_t>(n, 1ul));
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0ul, m, grain),
+          [&op] (const tbb::blocked_range<std::size_t>& range) {
+            op(range.begin(), range.size());
+          });
+#else
+      if(m > 0ul)
+        op(0ul, m);
+#endif // HAVE_INTEL_TBB
+    }
+
+    /// Count the zero norms
+
+    /// The counting loop has no branches, so it is vectorized, and the norms
+    /// are split among threads when TBB is available.
+    /// \param norms The norms
+    /// \param n The number of norms
+    /// \param threshold The zero threshold
+    /// \return The number of norms less than \c threshold
+    static size_type count_zeros(const value_type* const norms, const size_type n,
+        const value_type threshold)
+    {
+      auto count = [norms, threshold] (const size_type first, const size_type last) {
+        size_type result = 0ul;
+        for(size_type i = first; i < last; ++i)
+          result += size_type(norms[i] < threshold);
+        return result;
+      };
+
+#ifdef HAVE_INTEL_TBB
+      return tbb::parallel_reduce(
+          tbb::blocked_range<size_type>(0ul, n, parallel_grain_size()), size_type(0ul),
+          [&count] (const tbb::blocked_range<size_type>& range, const size_type init) {
+            return init + count(range.begin(), range.end());
+          }, std::plus<size_type>());
+#else
+      return count(0ul, n);
+#endif // HAVE_INTEL_TBB
+    }
+
 
     /// Normalize tile norms
 
@@ -107,20 +193,15 @@ namespace TiledArray {
     /// tile. If the normalized norm is less than threshold, the value is set to
     /// zero.
     void normalize() {
-      const value_type threshold = threshold_;
+      const value_type threshold = zero_threshold_;
       const unsigned int dim = tile_norms_.range().rank();
       const vector_type* MADNESS_RESTRICT const size_vectors = size_vectors_.get();
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
 
       if(dim == 1u) {
-        auto normalize_op = [threshold, &zero_tile_count] (value_type& norm, const value_type size) {
+        auto normalize_op = [threshold] (value_type& norm, const value_type size) {
           TA_ASSERT(norm >= value_type(0));
           norm /= size;
-          if(norm < threshold) {
-            norm = value_type(0);
-            ++zero_tile_count;
-          }
+          norm = (norm < threshold ? value_type(0) : norm);
         };
 
         // This is the easy case where the data is a vector and can be
@@ -143,22 +224,24 @@ namespace TiledArray {
         const vector_type left = recursive_outer_product(size_vectors, middle, inv_vec_op);
         const vector_type right = recursive_outer_product(size_vectors + middle, dim - middle, inv_vec_op);
 
-        auto normalize_op = [threshold, &zero_tile_count] (value_type& norm,
+        auto normalize_op = [threshold] (value_type& norm,
             const value_type x, const value_type y)
         {
           TA_ASSERT(norm >= value_type(0));
           norm *= x * y;
-          if(norm < threshold) {
-            norm = value_type(0);
-            ++zero_tile_count;
-          }
+          norm = (norm < threshold ? value_type(0) : norm);
         };
 
-        math::outer(left.size(), right.size(), left.data(), right.data(),
-            tile_norms_.data(), normalize_op);
+        const std::size_t n = right.size();
+        value_type* const data = tile_norms_.data();
+        parallel_rows(left.size(), n,
+            [&] (const std::size_t i, const std::size_t m) {
+              math::outer(m, n, left.data() + i, right.data(), data + i * n,
+                  normalize_op);
+            });
       }
 
-      zero_tile_count_ = zero_tile_count;
+      zero_tile_count_ = count_zeros(tile_norms_.data(), tile_norms_.size(), threshold);
     }
 
     static std::shared_ptr<vector_type>
@@ -181,7 +264,7 @@ namespace TiledArray {
     }
 
     std::shared_ptr<vector_type> perm_size_vectors(const Permutation& perm) const {
-      const unsigned int n = tile_norms_.range().rank();
+      const unsigned int n = norms_range().rank();
 
       // Allocate memory for the contracted size vectors
       std::shared_ptr<vector_type> result_size_vectors(new vector_type[n],
@@ -197,17 +280,76 @@ namespace TiledArray {
     }
 
     SparseShape(const Tensor<T>& tile_norms, const std::shared_ptr<vector_type>& size_vectors,
-        const size_type zero_tile_count) :
-      tile_norms_(tile_norms), size_vectors_(size_vectors),
-      zero_tile_count_(zero_tile_count)
+        const size_type zero_tile_count, const value_type zero_threshold) :
+      tile_norms_(tile_norms), compressed_norms_(), size_vectors_(size_vectors),
+      zero_tile_count_(zero_tile_count), zero_threshold_(zero_threshold)
     { }
 
+    SparseShape(const Tensor<T>& tile_norms, const std::shared_ptr<vector_type>& size_vectors,
+        const value_type zero_threshold) :
+      tile_norms_(tile_norms), compressed_norms_(), size_vectors_(size_vectors),
+      zero_tile_count_(count_zeros(tile_norms.data(), tile_norms.size(), zero_threshold)),
+      zero_threshold_(zero_threshold)
+    { }
+
+    SparseShape(const std::shared_ptr<const compressed_type>& compressed_norms,
+        const std::shared_ptr<vector_type>& size_vectors,
+        const value_type zero_threshold) :
+      tile_norms_(), compressed_norms_(compressed_norms), size_vectors_(size_vectors),
+      zero_tile_count_(compressed_norms->range().volume() - compressed_norms->size()),
+      zero_threshold_(zero_threshold)
+    { }
+
+    /// The zero threshold of the result of a binary operation
+
+    /// \param other The other argument of the operation
+    /// \return The tighter of the zero thresholds of this shape and \c other
+    value_type result_threshold(const SparseShape_& other) const {
+      return std::min(zero_threshold_, other.zero_threshold_);
+    }
+
+    /// The range of the tile norms
+    const Range& norms_range() const {
+      return (compressed_norms_ ? compressed_norms_->range() : tile_norms_.range());
+    }
+
+    /// The compressed tile norms of this shape
+
+    /// \return The compressed norms, which are constructed from the dense
+    /// norms if this shape is not compressed
+    std::shared_ptr<const compressed_type> compressed_norms() const {
+      if(compressed_norms_)
+        return compressed_norms_;
+      return std::make_shared<compressed_type>(tile_norms_);
+    }
+
+    /// Compute the volume of a tile
+
+    /// \param range The tile range
+    /// \param size_vectors The size vectors of \c range
+    /// \param ordinal The ordinal index of the tile in \c range
+    /// \return The number of elements in the tile
+    static value_type tile_volume(const Range& range,
+        const vector_type* MADNESS_RESTRICT const size_vectors, const size_type ordinal)
+    {
+      const unsigned int rank = range.rank();
+      const auto* MADNESS_RESTRICT const extent = range.extent_data();
+      const auto* MADNESS_RESTRICT const stride = range.stride_data();
+      value_type volume = 1;
+      for(unsigned int d = 0u; d < rank; ++d)
+        volume *= size_vectors[d].data()[(ordinal / stride[d]) % extent[d]];
+      return volume;
+    }
+
   public:
 
     /// Default constructor
 
     /// Construct a shape with no data.
-    SparseShape() : tile_norms_(), size_vectors_(), zero_tile_count_(0ul) { }
+    SparseShape() :
+      tile_norms_(), compressed_norms_(), size_vectors_(), zero_tile_count_(0ul),
+      zero_threshold_(threshold_)
+    { }
 
     /// "Dense" Constructor
 
@@ -215,10 +357,14 @@ namespace TiledArray {
     /// \param tile_norm the value of the (per-element) norm for every tile
     /// \param trange The tiled range of the tensor
     /// \note this ctor does not normalize tile norms
+    /// \param zero_threshold The zero threshold of this shape
+    ///        [ default = threshold() ]
     /// \note if @c tile_norm is less than the threshold then all tile norms are set to zero
-    SparseShape(const value_type& tile_norm, const TiledRange& trange) :
-        tile_norms_(trange.tiles_range(), (tile_norm < threshold_ ? 0 : tile_norm)), size_vectors_(initialize_size_vectors(trange)),
-        zero_tile_count_(tile_norm < threshold_ ? trange.tiles_range().area() : 0ul)
+    SparseShape(const value_type& tile_norm, const TiledRange& trange,
+        const value_type zero_threshold = threshold_) :
+        tile_norms_(trange.tiles_range(), (tile_norm < zero_threshold ? 0 : tile_norm)), size_vectors_(initialize_size_vectors(trange)),
+        zero_tile_count_(tile_norm < zero_threshold ? trange.tiles_range().area() : 0ul),
+        zero_threshold_(zero_threshold)
     {
     }
 
@@ -229,9 +375,12 @@ namespace TiledArray {
     /// tile.
     /// \param tile_norms The Frobenius norm of tiles
     /// \param trange The tiled range of the tensor
-    SparseShape(const Tensor<value_type>& tile_norms, const TiledRange& trange) :
+    /// \param zero_threshold The zero threshold of this shape
+    ///        [ default = threshold() ]
+    SparseShape(const Tensor<value_type>& tile_norms, const TiledRange& trange,
+        const value_type zero_threshold = threshold_) :
       tile_norms_(tile_norms.clone()), size_vectors_(initialize_size_vectors(trange)),
-      zero_tile_count_(0ul)
+      zero_tile_count_(0ul), zero_threshold_(zero_threshold)
     {
       TA_ASSERT(! tile_norms_.empty());
       TA_ASSERT(tile_norms_.range() == trange.tiles_range());
@@ -245,21 +394,33 @@ namespace TiledArray {
     /// represented as a sequence of {index,value_type} data.
     /// The tile norms are normalized to per-element norms by dividing each
     /// norm by the number of elements in the corresponding tile.
+    /// When \c compressed is \c true , only the non-zero norms are stored,
+    /// so the memory of the shape is proportional to the size of
+    /// \c tile_norms instead of the number of tiles in \c trange .
     /// \tparam SparseNormSequence the sequence of \c std::pair<index,value_type> objects,
     ///         where \c index is a directly-addressable sequence indices.
     /// \param tile_norms The Frobenius norm of tiles
     /// \param trange The tiled range of the tensor
+    /// \param compressed Store the norms in compressed form [ default = false ]
+    /// \param zero_threshold The zero threshold of this shape
+    ///        [ default = threshold() ]
     template <typename SparseNormSequence,
               typename = std::enable_if_t<
                   TiledArray::detail::has_member_function_begin_anyreturn<
                       std::decay_t<SparseNormSequence>>::value &&
                   TiledArray::detail::has_member_function_end_anyreturn<
                       std::decay_t<SparseNormSequence>>::value>>
-    SparseShape(const SparseNormSequence& tile_norms, const TiledRange& trange)
-        : tile_norms_(trange.tiles_range(), value_type(0)),
+    SparseShape(const SparseNormSequence& tile_norms, const TiledRange& trange,
+        const bool compressed = false, const value_type zero_threshold = threshold_)
+        : tile_norms_(compressed ? Tensor<value_type>() :
+              Tensor<value_type>(trange.tiles_range(), value_type(0))),
+          compressed_norms_(),
           size_vectors_(initialize_size_vectors(trange)),
-          zero_tile_count_(trange.tiles_range().volume()) {
-      const auto dim = tile_norms_.range().rank();
+          zero_tile_count_(trange.tiles_range().volume()),
+          zero_threshold_(zero_threshold) {
+      const auto dim = trange.tiles_range().rank();
+      std::vector<size_type> ordinals;
+      std::vector<value_type> values;
       for (const auto& pair_idx_norm : tile_norms) {
         auto compute_tile_volume = [dim, this, pair_idx_norm]() -> uint64_t {
           uint64_t tile_volume = 1;
@@ -268,11 +429,22 @@ namespace TiledArray {
           return tile_volume;
         };
         auto norm_per_element = pair_idx_norm.second / compute_tile_volume();
-        if (norm_per_element >= threshold()) {
-          tile_norms_[pair_idx_norm.first] = norm_per_element;
-          --zero_tile_count_;
+        if (norm_per_element >= zero_threshold_) {
+          if (compressed) {
+            ordinals.push_back(trange.tiles_range().ordinal(pair_idx_norm.first));
+            values.push_back(norm_per_element);
+          } else {
+            tile_norms_[pair_idx_norm.first] = norm_per_element;
+            --zero_tile_count_;
+          }
         }
       }
+
+      if (compressed) {
+        compressed_norms_ = std::make_shared<compressed_type>(trange.tiles_range(),
+            std::move(ordinals), std::move(values));
+        zero_tile_count_ -= compressed_norms_->size();
+      }
     }
 
     /// Collective "dense" constructor
@@ -285,10 +457,13 @@ namespace TiledArray {
     /// \param world The world where the shape will live
     /// \param tile_norms The Frobenius norm of tiles
     /// \param trange The tiled range of the tensor
+    /// \param zero_threshold The zero threshold of this shape
+    ///        [ default = threshold() ]
     SparseShape(World& world, const Tensor<value_type>& tile_norms,
-                const TiledRange& trange) :
+                const TiledRange& trange,
+                const value_type zero_threshold = threshold_) :
       tile_norms_(tile_norms.clone()), size_vectors_(initialize_size_vectors(trange)),
-      zero_tile_count_(0ul)
+      zero_tile_count_(0ul), zero_threshold_(zero_threshold)
     {
       TA_ASSERT(! tile_norms_.empty());
       TA_ASSERT(tile_norms_.range() == trange.tiles_range());
@@ -299,6 +474,40 @@ namespace TiledArray {
       normalize();
     }
 
+    /// Collective constructor with encoded norm reduction
+
+    /// This constructor differs from the collective constructor above in how
+    /// the norms are reduced: they are encoded with \c codec , rounding up,
+    /// and the codes are max-reduced across all processors, which reduces
+    /// the communication volume by a factor of <tt>sizeof(T) /
+    /// sizeof(Code)</tt>. The norm of each tile must be given by at most one
+    /// processor, with the other processors giving zero, as is the case when
+    /// each processor gives the norms of its local tiles.
+    /// \tparam Code The norm code type
+    /// \param world The world where the shape will live
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param trange The tiled range of the tensor
+    /// \param codec The norm encoding
+    /// \param zero_threshold The zero threshold of this shape
+    ///        [ default = threshold() ]
+    template <typename Code>
+    SparseShape(World& world, const Tensor<value_type>& tile_norms,
+                const TiledRange& trange, const detail::LogNormCodec<Code>& codec,
+                const value_type zero_threshold = threshold_) :
+      tile_norms_(tile_norms.range()), size_vectors_(initialize_size_vectors(trange)),
+      zero_tile_count_(0ul), zero_threshold_(zero_threshold)
+    {
+      TA_ASSERT(! tile_norms_.empty());
+      TA_ASSERT(tile_norms_.range() == trange.tiles_range());
+
+      // reduce encoded norm data from all processors
+      std::vector<Code> codes = codec.encode(tile_norms.data(), tile_norms.size());
+      world.gop.max(codes.data(), codes.size());
+      codec.decode(codes, tile_norms_.data());
+
+      normalize();
+    }
+
     /// Collective "sparse" constructor
 
     /// This constructor uses tile norms given as a sparse tensor,
@@ -324,8 +533,9 @@ namespace TiledArray {
     /// Shallow copy of \c other.
     /// \param other The other shape object to be copied
     SparseShape(const SparseShape<T>& other) :
-      tile_norms_(other.tile_norms_), size_vectors_(other.size_vectors_),
-      zero_tile_count_(other.zero_tile_count_)
+      tile_norms_(other.tile_norms_), compressed_norms_(other.compressed_norms_),
+      size_vectors_(other.size_vectors_), zero_tile_count_(other.zero_tile_count_),
+      zero_threshold_(other.zero_threshold_)
     { }
 
     /// Copy assignment operator
@@ -335,8 +545,10 @@ namespace TiledArray {
     /// \return A reference to this object.
     SparseShape<T>& operator=(const SparseShape<T>& other) {
       tile_norms_ = other.tile_norms_;
+      compressed_norms_ = other.compressed_norms_;
       size_vectors_ = other.size_vectors_;
       zero_tile_count_ = other.zero_tile_count_;
+      zero_threshold_ = other.zero_threshold_;
       return *this;
     }
 
@@ -344,9 +556,9 @@ namespace TiledArray {
 
     /// \return \c true when range matches the range of this shape
     bool validate(const Range& range) const {
-      if(tile_norms_.empty())
+      if(empty())
         return false;
-      return (range == tile_norms_.range());
+      return (range == norms_range());
     }
 
     /// Check that a tile is zero
@@ -355,8 +567,7 @@ namespace TiledArray {
     /// \return false
     template <typename Index>
     bool is_zero(const Index& i) const {
-      TA_ASSERT(! tile_norms_.empty());
-      return tile_norms_[i] < threshold_;
+      return (*this)[i] < zero_threshold_;
     }
 
     /// Check density
@@ -368,20 +579,65 @@ namespace TiledArray {
 
     /// \return The fraction of tiles that are zero.
     float sparsity() const {
-      TA_ASSERT(! tile_norms_.empty());
-      return float(zero_tile_count_) / float(tile_norms_.size());
+      TA_ASSERT(! empty());
+      return float(zero_tile_count_) / float(norms_range().volume());
     }
 
-    /// Threshold accessor
+    /// Default threshold accessor
 
-    /// \return The current threshold
+    /// \return The zero threshold given to new shapes
     static value_type threshold() { return threshold_; }
 
-    /// Set threshold to \c thresh
+    /// Set the default threshold to \c thresh
 
-    /// \param thresh The new threshold
+    /// The zero threshold of existing shapes is not changed.
+    /// \param thresh The new default threshold
     static void threshold(const value_type thresh) { threshold_ = thresh; }
 
+    /// Contraction estimator accessor
+
+    /// \return The estimator of the result norms used by \c gemm
+    static GemmEstimate gemm_estimate() { return gemm_estimate_; }
+
+    /// Set the contraction estimator
+
+    /// The default, \c GemmEstimate::bound , is a rigorous upper bound of the
+    /// result norms, which overestimates them when many inner tiles
+    /// contribute to a result tile. \c GemmEstimate::quadrature sums the
+    /// contributions of the inner tiles in quadrature, as if they were
+    /// orthogonal, which predicts fewer non-zero result tiles but may
+    /// underestimate the norms of strongly correlated contributions.
+    /// \param estimate The new estimator
+    static void gemm_estimate(const GemmEstimate estimate) { gemm_estimate_ = estimate; }
+
+    /// Zero threshold accessor
+
+    /// \return The threshold below which the tiles of this shape are zero
+    value_type zero_threshold() const { return zero_threshold_; }
+
+    /// Change the zero threshold
+
+    /// \param thresh The new zero threshold
+    /// \return A copy of this shape with the zero threshold \c thresh , where
+    /// the norms that are less than \c thresh are set to zero
+    /// \note Tiles that are already zero are not recovered by a smaller
+    /// threshold.
+    SparseShape_ with_threshold(const value_type thresh) const {
+      TA_ASSERT(! empty());
+
+      if(compressed_norms_)
+        return SparseShape_(compressed_norms_->unary(
+            [thresh] (const value_type value, const size_type) {
+              return (value < thresh ? value_type(0) : value);
+            }), size_vectors_, thresh);
+
+      auto op = [thresh] (const value_type value) {
+        return (value < thresh ? value_type(0) : value);
+      };
+
+      return SparseShape_(tile_norms_.unary(op), size_vectors_, thresh);
+    }
+
     /// Tile norm accessor
 
     /// \tparam Index The index type
@@ -389,7 +645,9 @@ namespace TiledArray {
     /// \return The norm of the tile at \c index
     template <typename Index>
     value_type operator[](const Index& index) const {
-      TA_ASSERT(! tile_norms_.empty());
+      TA_ASSERT(! empty());
+      if(compressed_norms_)
+        return (*compressed_norms_)[compressed_norms_->range().ordinal(index)];
       return tile_norms_[index];
     }
 
@@ -405,63 +663,94 @@ namespace TiledArray {
     template<typename Op>
     SparseShape_ transform(Op &&op) const { 
 
-        Tensor<T> new_norms = op(tile_norms_);
-        madness::AtomicInt zero_tile_count;
-        zero_tile_count = 0;
+        Tensor<T> new_norms = op(data());
 
-        const value_type threshold = threshold_;
-        auto apply_threshold = [threshold, &zero_tile_count](value_type &norm){
+        const value_type threshold = zero_threshold_;
+        auto apply_threshold = [threshold](value_type &norm){
             TA_ASSERT(norm >= value_type(0));
-            if(norm < threshold){
-                norm = value_type(0);
-                ++zero_tile_count;
-            }
+            norm = (norm < threshold ? value_type(0) : norm);
         };
 
         math::inplace_vector_op(apply_threshold, new_norms.range().volume(), 
                 new_norms.data());
 
-        return SparseShape_(std::move(new_norms), size_vectors_, 
-                            zero_tile_count); 
+        if(compressed_norms_)
+          return SparseShape_(std::make_shared<compressed_type>(new_norms),
+              size_vectors_, zero_threshold_);
+
+        return SparseShape_(std::move(new_norms), size_vectors_,
+                            zero_threshold_);
     }
 
     /// Data accessor
 
     /// \return A reference to the \c Tensor object that stores shape data
-    const Tensor<value_type>& data() const { return tile_norms_; }
+    /// \note For a compressed shape, the dense norms are constructed on the
+    /// first call and kept for the lifetime of the compressed norms.
+    const Tensor<value_type>& data() const {
+      return (compressed_norms_ ? compressed_norms_->dense() : tile_norms_);
+    }
 
     /// Initialization check
 
     /// \return \c true when this shape has been initialized.
-    bool empty() const { return tile_norms_.empty(); }
+    bool empty() const { return tile_norms_.empty() && ! compressed_norms_; }
+
+    /// Compression check
+
+    /// \return \c true when the norms of this shape are stored in compressed
+    /// form
+    bool is_compressed() const { return bool(compressed_norms_); }
+
+    /// Compress the tile norms
+
+    /// \return A copy of this shape that stores only the non-zero norms
+    SparseShape_ compress() const {
+      TA_ASSERT(! empty());
+      if(compressed_norms_)
+        return *this;
+      return SparseShape_(compressed_norms(), size_vectors_, zero_threshold_);
+    }
+
+    /// Uncompress the tile norms
+
+    /// \return A copy of this shape that stores the norms of all tiles
+    SparseShape_ uncompress() const {
+      TA_ASSERT(! empty());
+      if(! compressed_norms_)
+        return *this;
+      return SparseShape_(compressed_norms_->to_tensor(), size_vectors_,
+          zero_tile_count_, zero_threshold_);
+    }
 
     /// Compute union of two shapes
 
     /// \param mask The input shape, hard zeros are used to mask the output.
     /// \return A shape that is masked by the mask.
     SparseShape_ mask(const SparseShape_ &mask_shape) const {
-      TA_ASSERT(!tile_norms_.empty());
+      TA_ASSERT(!empty());
       TA_ASSERT(!mask_shape.empty());
-      TA_ASSERT(tile_norms_.range() == mask_shape.tile_norms_.range());
+      TA_ASSERT(norms_range() == mask_shape.norms_range());
 
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = zero_tile_count_;
-      auto op = [threshold, &zero_tile_count] (value_type left,
+      const value_type mask_threshold = mask_shape.zero_threshold_;
+
+      if(compressed_norms_ || mask_shape.compressed_norms_)
+        return SparseShape_(compressed_norms()->binary_intersection(
+            *mask_shape.compressed_norms(),
+            [mask_threshold] (const value_type left, const value_type right, const size_type) {
+              return (right < mask_threshold ? value_type(0) : left);
+            }), size_vectors_, zero_threshold_);
+
+      auto op = [mask_threshold] (const value_type left,
           const value_type right)
       {
-        if(left >= threshold && right < threshold) {
-          left = value_type(0);
-          ++zero_tile_count;
-        }
-
-        return left;
+        return (right < mask_threshold ? value_type(0) : left);
       };
 
       Tensor<value_type> result_tile_norms =
           tile_norms_.binary(mask_shape.tile_norms_, op);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_threshold_);
     }
 
     /// Update sub-block of shape
@@ -477,25 +766,98 @@ namespace TiledArray {
     SparseShape update_block(const Index& lower_bound, const Index& upper_bound,
         const SparseShape& other) const
     {
+      if(compressed_norms_ || other.compressed_norms_)
+        return SparseShape_(compressed_norms()->update_block(lower_bound,
+            upper_bound, *other.compressed_norms()), size_vectors_,
+            zero_threshold_);
+
       Tensor<value_type> result_tile_norms = tile_norms_.clone();
 
       auto result_tile_norms_blk = result_tile_norms.block(lower_bound, upper_bound);
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = zero_tile_count_;
       result_tile_norms_blk.inplace_binary(other.tile_norms_,
-          [threshold,&zero_tile_count] (value_type& l, const value_type r) {
-            // Update the zero tile count for the result
-            if((l < threshold) && (r >= threshold))
-              ++zero_tile_count;
-            else if((l >= threshold) && (r < threshold))
-              --zero_tile_count;
-
-            // Update the tile norm value
-            l = r;
-          });
+          [] (value_type& l, const value_type r) { l = r; });
+
+      return SparseShape_(result_tile_norms, size_vectors_, zero_threshold_);
+    }
+
+    /// Update the norms of a set of tiles
+
+    /// This collective function merges the norms of the tiles that were
+    /// modified on each process into a copy of this shape. The changes of all
+    /// processes are gathered, so the communication and the computation scale
+    /// with the number of modified tiles. As in the collective constructors,
+    /// the norms that several processes give for the same tile are summed.
+    /// Modified tiles with a per-element norm below the zero threshold become
+    /// zero.
+    /// \tparam SparseNormSequence A sequence of
+    /// <tt>std::pair<size_type,value_type></tt> objects, where \c first is the
+    /// ordinal index of a tile and \c second is its Frobenius norm
+    /// \param world The world where the shape lives
+    /// \param tile_norms The Frobenius norms of the tiles modified by this
+    /// process
+    /// \return A copy of this shape with the norms of the modified tiles
+    /// \note The norms of uncompressed shapes are copied.
+    template <typename SparseNormSequence>
+    SparseShape_ update(World& world, const SparseNormSequence& tile_norms) const {
+      TA_ASSERT(! empty());
+      typedef std::pair<size_type, value_type> ordinal_norm_type;
+
+      const Range& range = norms_range();
+      const vector_type* MADNESS_RESTRICT const size_vectors = size_vectors_.get();
+
+      // Convert the local norms to per-element norms
+      std::vector<ordinal_norm_type> changes;
+      for(const auto& ordinal_norm : tile_norms) {
+        TA_ASSERT(size_type(ordinal_norm.first) < range.volume());
+        changes.emplace_back(ordinal_norm.first, ordinal_norm.second /
+            tile_volume(range, size_vectors, ordinal_norm.first));
+      }
+
+      // Gather the changes of all processes
+      if(world.size() > 1) {
+        size_type count = changes.size();
+        world.gop.sum(count);
+        changes = world.gop.concat0(changes,
+            (count + 1ul) * sizeof(ordinal_norm_type) + 1024ul);
+        world.gop.broadcast_serializable(changes, 0);
+      }
+
+      // Sum the changes of each tile and apply the zero threshold
+      std::stable_sort(changes.begin(), changes.end(),
+          [] (const ordinal_norm_type& l, const ordinal_norm_type& r)
+          { return l.first < r.first; });
+      std::vector<size_type> ordinals;
+      std::vector<value_type> values;
+      ordinals.reserve(changes.size());
+      values.reserve(changes.size());
+      for(const ordinal_norm_type& change : changes) {
+        if(! ordinals.empty() && (ordinals.back() == change.first)) {
+          values.back() += change.second;
+        } else {
+          ordinals.push_back(change.first);
+          values.push_back(change.second);
+        }
+      }
+      for(value_type& value : values)
+        value = (value < zero_threshold_ ? value_type(0) : value);
+
+      if(compressed_norms_)
+        return SparseShape_(compressed_norms_->update(ordinals, values),
+            size_vectors_, zero_threshold_);
+
+      Tensor<value_type> result_tile_norms = tile_norms_.clone();
+      size_type zero_tile_count = zero_tile_count_;
+      for(size_type i = 0ul; i < ordinals.size(); ++i) {
+        value_type& result = result_tile_norms[ordinals[i]];
+        if(result < zero_threshold_)
+          --zero_tile_count;
+        if(values[i] < zero_threshold_)
+          ++zero_tile_count;
+        result = values[i];
+      }
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count,
+          zero_threshold_);
     }
 
   private:
@@ -508,8 +870,8 @@ namespace TiledArray {
     template <typename Index>
     std::shared_ptr<vector_type>
     block_range(const Index& lower_bound, const Index& upper_bound) const {
-      TA_ASSERT(detail::size(lower_bound) == tile_norms_.range().rank());
-      TA_ASSERT(detail::size(upper_bound) == tile_norms_.range().rank());
+      TA_ASSERT(detail::size(lower_bound) == norms_range().rank());
+      TA_ASSERT(detail::size(upper_bound) == norms_range().rank());
 
       // Get the number dimensions of the shape
       const auto rank = detail::size(lower_bound);
@@ -527,7 +889,7 @@ namespace TiledArray {
 
         // Check that the input indices are in range
         TA_ASSERT(lower_i < upper_i);
-        TA_ASSERT(upper_i <= tile_norms_.range().upbound(i));
+        TA_ASSERT(upper_i <= norms_range().upbound(i));
 
         // Construct the size vector for rank i
         size_vectors.get()[i] = vector_type(extent_i,
@@ -548,26 +910,24 @@ namespace TiledArray {
       std::shared_ptr<vector_type> size_vectors =
           block_range(lower_bound, upper_bound);
 
+      if(compressed_norms_)
+        return SparseShape(compressed_norms_->block(lower_bound, upper_bound),
+            size_vectors, zero_threshold_);
+
       // Copy the data from arg to result
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto copy_op = [threshold,&zero_tile_count] (value_type& MADNESS_RESTRICT result,
+      auto copy_op = [] (value_type& MADNESS_RESTRICT result,
           const value_type arg)
       {
         result = arg;
-        if(arg < threshold)
-          ++zero_tile_count;
       };
 
-
       // Construct the result norms tensor
       TensorConstView<value_type> block_view =
           tile_norms_.block(lower_bound, upper_bound);
       Tensor<value_type> result_norms((Range(block_view.range().extent())));
       result_norms.inplace_binary(shift(block_view), copy_op);
 
-      return SparseShape(result_norms, size_vectors, zero_tile_count);
+      return SparseShape(result_norms, size_vectors, zero_threshold_);
     }
 
 
@@ -587,17 +947,20 @@ namespace TiledArray {
           block_range(lower_bound, upper_bound);
 
       // Copy the data from arg to result
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto copy_op = [abs_factor,threshold,&zero_tile_count] (value_type& MADNESS_RESTRICT result,
+      const value_type threshold = zero_threshold_;
+
+      if(compressed_norms_)
+        return SparseShape(compressed_norms_->block(lower_bound, upper_bound)->unary(
+            [abs_factor,threshold] (value_type value, const size_type) {
+              value *= abs_factor;
+              return (value < threshold ? value_type(0) : value);
+            }), size_vectors, zero_threshold_);
+
+      auto copy_op = [abs_factor,threshold] (value_type& MADNESS_RESTRICT result,
               const value_type arg)
       {
         result = arg * abs_factor;
-        if(result < threshold) {
-          ++zero_tile_count;
-          result = value_type(0);
-        }
+        result = (result < threshold ? value_type(0) : result);
       };
 
       // Construct the result norms tensor
@@ -606,7 +969,7 @@ namespace TiledArray {
       Tensor<value_type> result_norms((Range(block_view.range().extent())));
       result_norms.inplace_binary(shift(block_view), copy_op);
 
-      return SparseShape(result_norms, size_vectors, zero_tile_count);
+      return SparseShape(result_norms, size_vectors, zero_threshold_);
     }
 
     /// Create a copy of a sub-block of the shape
@@ -639,8 +1002,12 @@ namespace TiledArray {
     /// \param perm The permutation to be applied
     /// \return A new, permuted shape
     SparseShape_ perm(const Permutation& perm) const {
+      if(compressed_norms_)
+        return SparseShape_(compressed_norms_->permute(perm), perm_size_vectors(perm),
+            zero_threshold_);
+
       return SparseShape_(tile_norms_.permute(perm), perm_size_vectors(perm),
-          zero_tile_count_);
+          zero_tile_count_, zero_threshold_);
     }
 
     /// Scale shape
@@ -655,23 +1022,26 @@ namespace TiledArray {
     /// \return A new, scaled shape
     template <typename Factor>
     SparseShape_ scale(const Factor factor) const {
-      TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
+      TA_ASSERT(! empty());
+      const value_type threshold = zero_threshold_;
       const value_type abs_factor = to_abs_factor(factor);
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count, abs_factor] (value_type value) {
+
+      if(compressed_norms_)
+        return SparseShape_(compressed_norms_->unary(
+            [threshold, abs_factor] (value_type value, const size_type) {
+              value *= abs_factor;
+              return (value < threshold ? value_type(0) : value);
+            }), size_vectors_, zero_threshold_);
+
+      auto op = [threshold, abs_factor] (value_type value) {
         value *= abs_factor;
-        if(value < threshold) {
-          value = value_type(0);
-          ++zero_tile_count;
-        }
+        value = (value < threshold ? value_type(0) : value);
         return value;
       };
 
       Tensor<value_type> result_tile_norms = tile_norms_.unary(op);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_threshold_);
     }
 
     /// Scale and permute shape
@@ -687,24 +1057,22 @@ namespace TiledArray {
     /// \return A new, scaled-and-permuted shape
     template <typename Factor>
     SparseShape_ scale(const Factor factor, const Permutation& perm) const {
+      if(compressed_norms_)
+        return scale(factor).perm(perm);
+
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
+      const value_type threshold = zero_threshold_;
       const value_type abs_factor = to_abs_factor(factor);
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count, abs_factor] (value_type value) {
+      auto op = [threshold, abs_factor] (value_type value) {
         value *= abs_factor;
-        if(value < threshold) {
-          value = value_type(0);
-          ++zero_tile_count;
-        }
+        value = (value < threshold ? value_type(0) : value);
         return value;
       };
 
       Tensor<value_type> result_tile_norms = tile_norms_.unary(op, perm);
 
       return SparseShape_(result_tile_norms, perm_size_vectors(perm),
-          zero_tile_count);
+          zero_threshold_);
     }
 
     /// Add shapes
@@ -716,25 +1084,28 @@ namespace TiledArray {
     /// \param other The shape to be added to this shape
     /// \return A sum of shapes
     SparseShape_ add(const SparseShape_& other) const {
-      TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count] (value_type left,
+      TA_ASSERT(! empty());
+      const value_type threshold = result_threshold(other);
+
+      if(compressed_norms_ || other.compressed_norms_)
+        return SparseShape_(compressed_norms()->binary_union(*other.compressed_norms(),
+            [threshold] (value_type left, const value_type right) {
+              left += right;
+              return (left < threshold ? value_type(0) : left);
+            }), size_vectors_, threshold);
+
+      auto op = [threshold] (value_type left,
           const value_type right)
       {
         left += right;
-        if(left < threshold) {
-          left = value_type(0);
-          ++zero_tile_count;
-        }
+        left = (left < threshold ? value_type(0) : left);
         return left;
       };
 
       Tensor<value_type> result_tile_norms =
           tile_norms_.binary(other.tile_norms_, op);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, threshold);
     }
 
     /// Add and permute shapes
@@ -747,18 +1118,16 @@ namespace TiledArray {
     /// \param perm The permutation that is applied to the result
     /// \return the new shape, equals \c this + \c other
     SparseShape_ add(const SparseShape_& other, const Permutation& perm) const {
+      if(compressed_norms_ || other.compressed_norms_)
+        return add(other).perm(perm);
+
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count] (value_type left,
+      const value_type threshold = result_threshold(other);
+      auto op = [threshold] (value_type left,
           const value_type right)
       {
         left += right;
-        if(left < threshold) {
-          left = value_type(0);
-          ++zero_tile_count;
-        }
+        left = (left < threshold ? value_type(0) : left);
         return left;
       };
 
@@ -766,7 +1135,7 @@ namespace TiledArray {
           tile_norms_.binary(other.tile_norms_, op, perm);
 
       return SparseShape_(result_tile_norms, perm_size_vectors(perm),
-          zero_tile_count);
+          threshold);
     }
 
     /// Add and scale shapes
@@ -782,27 +1151,31 @@ namespace TiledArray {
     /// \return A scaled sum of shapes
     template <typename Factor>
     SparseShape_ add(const SparseShape_& other, const Factor factor) const {
-      TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
+      TA_ASSERT(! empty());
+      const value_type threshold = result_threshold(other);
       const value_type abs_factor = to_abs_factor(factor);
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count, abs_factor] (value_type left,
+
+      if(compressed_norms_ || other.compressed_norms_)
+        return SparseShape_(compressed_norms()->binary_union(*other.compressed_norms(),
+            [threshold, abs_factor] (value_type left, const value_type right) {
+              left += right;
+              left *= abs_factor;
+              return (left < threshold ? value_type(0) : left);
+            }), size_vectors_, threshold);
+
+      auto op = [threshold, abs_factor] (value_type left,
           const value_type right)
       {
         left += right;
         left *= abs_factor;
-        if(left < threshold) {
-          left = value_type(0);
-          ++zero_tile_count;
-        }
+        left = (left < threshold ? value_type(0) : left);
         return left;
       };
 
       Tensor<value_type> result_tile_norms =
           tile_norms_.binary(other.tile_norms_, op);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, threshold);
     }
 
     /// Add, scale, and permute shapes
@@ -821,20 +1194,18 @@ namespace TiledArray {
     SparseShape_ add(const SparseShape_& other, const Factor factor,
         const Permutation& perm) const
     {
+      if(compressed_norms_ || other.compressed_norms_)
+        return add(other, factor).perm(perm);
+
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
+      const value_type threshold = result_threshold(other);
       const value_type abs_factor = to_abs_factor(factor);
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count, abs_factor]
+      auto op = [threshold, abs_factor]
                  (value_type left, const value_type right)
       {
         left += right;
         left *= abs_factor;
-        if(left < threshold) {
-          left = value_type(0);
-          ++zero_tile_count;
-        }
+        left = (left < threshold ? value_type(0) : left);
         return left;
       };
 
@@ -842,14 +1213,17 @@ namespace TiledArray {
           tile_norms_.binary(other.tile_norms_, op, perm);
 
       return SparseShape_(result_tile_norms, perm_size_vectors(perm),
-          zero_tile_count);
+          threshold);
     }
 
     SparseShape_ add(value_type value) const {
+      // Adding a constant makes every tile non-zero, so there is nothing to
+      // gain from working on the compressed norms
+      if(compressed_norms_)
+        return uncompress().add(value).compress();
+
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
+      const value_type threshold = zero_threshold_;
 
       Tensor<T> result_tile_norms(tile_norms_.range());
 
@@ -858,15 +1232,11 @@ namespace TiledArray {
       const vector_type* MADNESS_RESTRICT const size_vectors = size_vectors_.get();
 
       if(dim == 1u) {
-        auto add_const_op = [threshold, &zero_tile_count, value] (value_type norm,
+        auto add_const_op = [threshold, value] (value_type norm,
             const value_type size)
         {
           norm += value / std::sqrt(size);
-          if(norm < threshold) {
-            norm = 0;
-            ++zero_tile_count;
-          }
-          return norm;
+          return (norm < threshold ? value_type(0) : norm);
         };
 
         // This is the easy case where the data is a vector and can be
@@ -889,20 +1259,22 @@ namespace TiledArray {
         const vector_type left = recursive_outer_product(size_vectors, middle, inv_sqrt_vec_op);
         const vector_type right = recursive_outer_product(size_vectors + middle, dim - middle, inv_sqrt_vec_op);
 
-        math::outer_fill(left.size(), right.size(), left.data(), right.data(),
-            tile_norms_.data(), result_tile_norms.data(),
-            [threshold, &zero_tile_count, value] (value_type& norm,
-                const value_type x, const value_type y)
-            {
-              norm += value * x * y;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
-              }
+        auto add_const_op = [threshold, value] (value_type& norm,
+            const value_type x, const value_type y)
+        {
+          norm += value * x * y;
+          norm = (norm < threshold ? value_type(0) : norm);
+        };
+        const std::size_t n = right.size();
+        parallel_rows(left.size(), n,
+            [&] (const std::size_t i, const std::size_t m) {
+              math::outer_fill(m, n, left.data() + i, right.data(),
+                  tile_norms_.data() + i * n, result_tile_norms.data() + i * n,
+                  add_const_op);
             });
       }
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_threshold_);
     }
 
     SparseShape_ add(const value_type value, const Permutation& perm) const {
@@ -942,23 +1314,18 @@ namespace TiledArray {
   private:
 
     static size_type scale_by_size(Tensor<T>& tile_norms,
-        const vector_type* MADNESS_RESTRICT const size_vectors)
+        const vector_type* MADNESS_RESTRICT const size_vectors,
+        const value_type threshold)
     {
       const unsigned int dim = tile_norms.range().rank();
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
 
       if(dim == 1u) {
         // This is the easy case where the data is a vector and can be
         // normalized directly.
         math::inplace_vector_op(
-            [threshold, &zero_tile_count] (value_type& norm, const value_type size) {
+            [threshold] (value_type& norm, const value_type size) {
               norm *= size;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
-              }
+              norm = (norm < threshold ? value_type(0) : norm);
             },
             size_vectors[0].size(), tile_norms.data(), size_vectors[0].data());
       } else {
@@ -975,62 +1342,172 @@ namespace TiledArray {
         const vector_type left = recursive_outer_product(size_vectors, middle, noop);
         const vector_type right = recursive_outer_product(size_vectors + middle, dim - middle, noop);
 
-        math::outer(left.size(), right.size(), left.data(), right.data(), tile_norms.data(),
-            [threshold, &zero_tile_count] (value_type& norm, const value_type x,
-                const value_type y)
-            {
-              norm *= x * y;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
-              }
+        auto scale_op = [threshold] (value_type& norm, const value_type x,
+            const value_type y)
+        {
+          norm *= x * y;
+          norm = (norm < threshold ? value_type(0) : norm);
+        };
+        const std::size_t n = right.size();
+        value_type* const data = tile_norms.data();
+        parallel_rows(left.size(), n,
+            [&] (const std::size_t i, const std::size_t m) {
+              math::outer(m, n, left.data() + i, right.data(), data + i * n, scale_op);
             });
       }
 
+      return count_zeros(tile_norms.data(), tile_norms.size(), threshold);
+    }
+
+    /// The density below which \c gemm uses a sparse norm product
+
+    /// \return The largest fraction of non-zero tile pairs, the product of
+    /// the densities of the arguments, for which the norms of a contraction
+    /// are computed with \c sparse_gemm() instead of a dense matrix product
+    static constexpr float sparse_gemm_density() { return 0.1f; }
+
+    /// Sparse product of the norms
+
+    /// Computes the \c M x \c N matrix product of the \c M x \c K \c left
+    /// and \c K x \c N \c right norms, where each product with inner index
+    /// \c k is scaled by <tt>k_sizes[k] * k_sizes[k]</tt> . Only the pairs of
+    /// non-zero norms are visited. The rows of the result are computed in
+    /// parallel when TBB is available.
+    /// \param M The number of rows of \c left and the result
+    /// \param N The number of columns of \c right and the result
+    /// \param K The number of columns of \c left and rows of \c right
+    /// \param left The left-hand norms
+    /// \param right The right-hand norms
+    /// \param k_sizes The sizes of the inner index
+    /// \param factor The scaling factor of the result
+    /// \param threshold The zero threshold of the result
+    /// \param result The result norms, which must be zero on entry
+    /// \return The number of zero result norms
+    static size_type sparse_gemm(const integer M, const integer N, const integer K,
+        const value_type* const left, const value_type* const right,
+        const value_type* const k_sizes, const value_type factor,
+        const value_type threshold, value_type* const result)
+    {
+      // Collect the non-zero right-hand norms of each row, scaled by the size
+      // of the row
+      std::vector<size_type> right_ptr(K + 1, 0ul);
+      std::vector<std::pair<integer, value_type> > right_norms;
+      for(integer k = 0; k < K; ++k) {
+        right_ptr[k] = right_norms.size();
+        const value_type* const right_k = right + k * N;
+        for(integer n = 0; n < N; ++n)
+          if(right_k[n] != value_type(0))
+            right_norms.emplace_back(n, right_k[n] * k_sizes[k]);
+      }
+      right_ptr[K] = right_norms.size();
+
+      madness::AtomicInt zero_tile_count;
+      zero_tile_count = 0;
+      auto gemm_rows = [=,&right_ptr,&right_norms,&zero_tile_count]
+          (const integer first, const integer last)
+      {
+        int zero_count = 0;
+        for(integer m = first; m < last; ++m) {
+          const value_type* MADNESS_RESTRICT const left_m = left + m * K;
+          value_type* MADNESS_RESTRICT const result_m = result + m * N;
+          for(integer k = 0; k < K; ++k) {
+            if(left_m[k] == value_type(0))
+              continue;
+            const value_type left_mk = left_m[k] * k_sizes[k] * factor;
+            for(size_type r = right_ptr[k]; r < right_ptr[k + 1]; ++r)
+              result_m[right_norms[r].first] += left_mk * right_norms[r].second;
+          }
+
+          // Hard zero tiles that are below the zero threshold.
+          for(integer n = 0; n < N; ++n) {
+            if(result_m[n] < threshold) {
+              result_m[n] = value_type(0);
+              ++zero_count;
+            }
+          }
+        }
+        zero_tile_count += zero_count;
+      };
+
+#ifdef HAVE_INTEL_TBB
+      tbb::parallel_for(tbb::blocked_range<integer>(0, M),
+          [&gemm_rows] (const tbb::blocked_range<integer>& range) {
+            gemm_rows(range.begin(), range.end());
+          });
+#else
+      gemm_rows(0, M);
+#endif // HAVE_INTEL_TBB
+
       return zero_tile_count;
     }
 
   public:
 
     SparseShape_ mult(const SparseShape_& other) const {
+      if(compressed_norms_ || other.compressed_norms_)
+        return mult(other, value_type(1));
+
       // TODO: Optimize this function so that the tensor arithmetic and
       // scale_by_size operations are performed in one step instead of two.
 
       TA_ASSERT(! tile_norms_.empty());
+      const value_type threshold = result_threshold(other);
       Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_);
       const size_type zero_tile_count =
-          scale_by_size(result_tile_norms, size_vectors_.get());
+          scale_by_size(result_tile_norms, size_vectors_.get(), threshold);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count, threshold);
     }
 
     SparseShape_ mult(const SparseShape_& other, const Permutation& perm) const {
+      if(compressed_norms_ || other.compressed_norms_)
+        return mult(other, value_type(1)).perm(perm);
+
       // TODO: Optimize this function so that the tensor arithmetic and
       // scale_by_size operations are performed in one step instead of two.
 
       TA_ASSERT(! tile_norms_.empty());
+      const value_type threshold = result_threshold(other);
       Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_, perm);
       std::shared_ptr<vector_type> result_size_vector = perm_size_vectors(perm);
       const size_type zero_tile_count =
-                scale_by_size(result_tile_norms, result_size_vector.get());
+                scale_by_size(result_tile_norms, result_size_vector.get(), threshold);
 
-      return SparseShape_(result_tile_norms, result_size_vector, zero_tile_count);
+      return SparseShape_(result_tile_norms, result_size_vector, zero_tile_count, threshold);
     }
 
     /// \tparam Factor The scaling factor type
     /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
     template <typename Factor>
     SparseShape_ mult(const SparseShape_& other, const Factor factor) const {
+      const value_type abs_factor = to_abs_factor(factor);
+
+      if(compressed_norms_ || other.compressed_norms_) {
+        // Only the tiles that are non-zero in both shapes are visited
+        const value_type threshold = result_threshold(other);
+        const Range& range = norms_range();
+        const vector_type* const size_vectors = size_vectors_.get();
+        return SparseShape_(compressed_norms()->binary_intersection(
+            *other.compressed_norms(),
+            [threshold, abs_factor, &range, size_vectors] (const value_type left,
+                const value_type right, const size_type ordinal)
+            {
+              const value_type norm = left * right * abs_factor
+                  * tile_volume(range, size_vectors, ordinal);
+              return (norm < threshold ? value_type(0) : norm);
+            }), size_vectors_, threshold);
+      }
+
       // TODO: Optimize this function so that the tensor arithmetic and
       // scale_by_size operations are performed in one step instead of two.
 
       TA_ASSERT(! tile_norms_.empty());
-      const value_type abs_factor = to_abs_factor(factor);
+      const value_type threshold = result_threshold(other);
       Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_, abs_factor);
       const size_type zero_tile_count =
-          scale_by_size(result_tile_norms, size_vectors_.get());
+          scale_by_size(result_tile_norms, size_vectors_.get(), threshold);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count, threshold);
     }
 
     /// \tparam Factor The scaling factor type
@@ -1039,17 +1516,21 @@ namespace TiledArray {
     SparseShape_ mult(const SparseShape_& other, const Factor factor,
         const Permutation& perm) const
     {
+      if(compressed_norms_ || other.compressed_norms_)
+        return mult(other, factor).perm(perm);
+
       // TODO: Optimize this function so that the tensor arithmetic and
       // scale_by_size operations are performed in one step instead of two.
 
       TA_ASSERT(! tile_norms_.empty());
+      const value_type threshold = result_threshold(other);
       const value_type abs_factor = to_abs_factor(factor);
       Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_, abs_factor, perm);
       std::shared_ptr<vector_type> result_size_vector = perm_size_vectors(perm);
       const size_type zero_tile_count =
-          scale_by_size(result_tile_norms, result_size_vector.get());
+          scale_by_size(result_tile_norms, result_size_vector.get(), threshold);
 
-      return SparseShape_(result_tile_norms, result_size_vector, zero_tile_count);
+      return SparseShape_(result_tile_norms, result_size_vector, zero_tile_count, threshold);
     }
 
     /// \tparam Factor The scaling factor type
@@ -1058,15 +1539,135 @@ namespace TiledArray {
     SparseShape_ gemm(const SparseShape_& other, const Factor factor,
         const math::GemmHelper& gemm_helper) const
     {
-      TA_ASSERT(! tile_norms_.empty());
+      TA_ASSERT(! empty());
 
       const value_type abs_factor = to_abs_factor(factor);
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      integer M = 0, N = 0, K = 0;
-      gemm_helper.compute_matrix_sizes(M, N, K, tile_norms_.range(), other.tile_norms_.range());
+      if((gemm_estimate_ == GemmEstimate::quadrature) &&
+          (gemm_helper.left_inner_end() > gemm_helper.left_inner_begin()))
+        return quadrature_gemm(other, abs_factor, gemm_helper);
+
+      return bound_gemm(other, abs_factor, gemm_helper);
+    }
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    template <typename Factor>
+    SparseShape_ gemm(const SparseShape_& other, const Factor factor,
+        const math::GemmHelper& gemm_helper, const Permutation& perm) const
+    {
+      return gemm(other, factor, gemm_helper).perm(perm);
+    }
 
+    /// Batched contraction of shapes
+
+    /// The leading \c batch_rank dimensions of this shape, \c other , and
+    /// the result are batch dimensions, which are not summed; this shape is
+    /// ordered as (batch, left outer, inner) and \c other as (batch, inner,
+    /// right outer). Each batch of the result is bounded as a contraction
+    /// of the same batch of the arguments.
+    /// \tparam Factor The scaling factor type
+    /// \param other The right-hand argument
+    /// \param factor The scaling factor
+    /// \param batch_rank The number of batch dimensions
+    /// \param inner_rank The number of contracted dimensions
+    /// \return The shape of the result, ordered as (batch, left outer, right
+    /// outer)
+    template <typename Factor>
+    SparseShape_ batched_gemm(const SparseShape_& other, const Factor factor,
+        const unsigned int batch_rank, const unsigned int inner_rank) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+
+      const value_type abs_factor = to_abs_factor(factor);
+      const value_type threshold = result_threshold(other);
+      const unsigned int left_rank = norms_range().rank();
+      const unsigned int right_rank = other.norms_range().rank();
+      const unsigned int left_outer_end = left_rank - inner_rank;
+      const unsigned int right_outer_begin = batch_rank + inner_rank;
+      const unsigned int result_rank = left_outer_end + right_rank - right_outer_begin;
+
+      // Compute the fused extents of the batch, outer, and inner dimensions
+      const auto* MADNESS_RESTRICT const left_extent = norms_range().extent_data();
+      const auto* MADNESS_RESTRICT const right_extent = other.norms_range().extent_data();
+      size_type B = 1ul, M = 1ul, K = 1ul, N = 1ul;
+      std::vector<size_type> result_extent;
+      result_extent.reserve(result_rank);
+      for(unsigned int i = 0u; i < left_outer_end; ++i) {
+        (i < batch_rank ? B : M) *= left_extent[i];
+        result_extent.push_back(left_extent[i]);
+      }
+      for(unsigned int i = left_outer_end; i < left_rank; ++i)
+        K *= left_extent[i];
+      for(unsigned int i = right_outer_begin; i < right_rank; ++i) {
+        N *= right_extent[i];
+        result_extent.push_back(right_extent[i]);
+      }
+
+      // Compute the sizes of the inner tiles
+      const vector_type k_sizes = (inner_rank > 0u ?
+          recursive_outer_product(size_vectors_.get() + left_outer_end, inner_rank,
+              [] (const vector_type& size_vector) -> const vector_type&
+              { return size_vector; }) :
+          vector_type(1ul, value_type(1)));
+
+      // Contract the norms of each batch
+      const Tensor<value_type>& left_norms = data();
+      const Tensor<value_type>& right_norms = other.data();
+      Tensor<value_type> result_norms(Range(result_extent), 0);
+      size_type zero_count = 0ul;
+      for(size_type b = 0ul; b < B; ++b) {
+        const value_type* const left = left_norms.data() + b * M * K;
+        const value_type* const right = right_norms.data() + b * K * N;
+        value_type* const result = result_norms.data() + b * M * N;
+        for(size_type m = 0ul; m < M; ++m) {
+          for(size_type k = 0ul; k < K; ++k) {
+            const value_type left_mk = left[m * K + k] * k_sizes[k] * abs_factor;
+            if(left_mk == value_type(0)) continue;
+            for(size_type n = 0ul; n < N; ++n)
+              result[m * N + n] += left_mk * right[k * N + n];
+          }
+          for(size_type n = 0ul; n < N; ++n) {
+            if(result[m * N + n] < threshold) {
+              result[m * N + n] = value_type(0);
+              ++zero_count;
+            }
+          }
+        }
+      }
+
+      // The result size vectors are the batch and left outer size vectors of
+      // this shape, and the right outer size vectors of other
+      std::shared_ptr<vector_type> result_size_vectors(new vector_type[result_rank],
+          std::default_delete<vector_type[]>());
+      unsigned int x = 0u;
+      for(unsigned int i = 0u; i < left_outer_end; ++i, ++x)
+        result_size_vectors.get()[x] = size_vectors_.get()[i];
+      for(unsigned int i = right_outer_begin; i < right_rank; ++i, ++x)
+        result_size_vectors.get()[x] = other.size_vectors_.get()[i];
+
+      return SparseShape_(result_norms, result_size_vectors, zero_count, threshold);
+    }
+
+    /// \tparam Factor The scaling factor type
+    template <typename Factor>
+    SparseShape_ batched_gemm(const SparseShape_& other, const Factor factor,
+        const unsigned int batch_rank, const unsigned int inner_rank,
+        const Permutation& perm) const
+    {
+      return batched_gemm(other, factor, batch_rank, inner_rank).perm(perm);
+    }
+
+  private:
+
+    /// Size vectors of the result of a contraction
+
+    /// \param other The right-hand argument
+    /// \param gemm_helper The contraction helper
+    /// \return The size vectors of the outer dimensions of this shape and
+    /// \c other
+    std::shared_ptr<vector_type>
+    gemm_size_vectors(const SparseShape_& other, const math::GemmHelper& gemm_helper) const {
       // Allocate memory for the contracted size vectors
       std::shared_ptr<vector_type> result_size_vectors(new vector_type[gemm_helper.result_rank()],
           std::default_delete<vector_type[]>());
@@ -1078,9 +1679,98 @@ namespace TiledArray {
       for(unsigned int i = gemm_helper.right_outer_begin(); i < gemm_helper.right_outer_end(); ++i, ++x)
         result_size_vectors.get()[x] = other.size_vectors_.get()[i];
 
+      return result_size_vectors;
+    }
+
+    /// Apply an operation to the norms and the size vectors
+
+    /// \tparam Op The operation type
+    /// \param op The operation, which must map zero to zero and preserve
+    /// the order of values
+    /// \param size_vectors The size vectors of the result
+    /// \return A shape with the norms, size vectors, and zero threshold
+    /// of this shape transformed by \c op
+    template <typename Op>
+    SparseShape_ map_norms(const Op& op, const std::shared_ptr<vector_type>& size_vectors) const {
+      if(compressed_norms_)
+        return SparseShape_(compressed_norms_->unary(
+            [&op] (const value_type value, const size_type) { return op(value); }),
+            size_vectors, op(zero_threshold_));
+
+      return SparseShape_(tile_norms_.unary(op), size_vectors, zero_tile_count_,
+          op(zero_threshold_));
+    }
+
+    /// Quadrature estimate of a contraction
+
+    /// The norms of the result are estimated as the square root of the sum
+    /// of the squares of the norm products over the inner tiles, instead of
+    /// their sum. This is exact when the contributions of the inner tiles
+    /// are orthogonal, and is computed as the bound of the contraction of the
+    /// squared norms, with squared tile sizes.
+    /// \param other The right-hand argument
+    /// \param abs_factor The absolute value of the scaling factor
+    /// \param gemm_helper The contraction helper
+    /// \return The estimated shape of the result
+    SparseShape_ quadrature_gemm(const SparseShape_& other, const value_type abs_factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      auto square_op = [] (const value_type value) { return value * value; };
+      auto square_size_vectors = [&] (const SparseShape_& shape) {
+        const unsigned int n = shape.norms_range().rank();
+        std::shared_ptr<vector_type> size_vectors(new vector_type[n],
+            std::default_delete<vector_type[]>());
+        for(unsigned int i = 0u; i < n; ++i)
+          size_vectors.get()[i] = vector_type(shape.size_vectors_.get()[i], square_op);
+        return size_vectors;
+      };
+
+      const SparseShape_ left = map_norms(square_op, square_size_vectors(*this));
+      const SparseShape_ right = other.map_norms(square_op, square_size_vectors(other));
+      const SparseShape_ result =
+          left.bound_gemm(right, abs_factor * abs_factor, gemm_helper);
+
+      using std::sqrt;
+      return result.map_norms([] (const value_type value) { return sqrt(value); },
+          gemm_size_vectors(other, gemm_helper));
+    }
+
+    /// Upper bound of a contraction
+
+    /// The norms of the result are bounded by the sum of the norm products
+    /// over the inner tiles.
+    /// \param other The right-hand argument
+    /// \param abs_factor The absolute value of the scaling factor
+    /// \param gemm_helper The contraction helper
+    /// \return The shape of the result
+    SparseShape_ bound_gemm(const SparseShape_& other, const value_type abs_factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      const value_type threshold = result_threshold(other);
+      integer M = 0, N = 0, K = 0;
+      gemm_helper.compute_matrix_sizes(M, N, K, norms_range(), other.norms_range());
+
+      std::shared_ptr<vector_type> result_size_vectors =
+          gemm_size_vectors(other, gemm_helper);
+
       // Compute the number of inner ranks
       const unsigned int k_rank = gemm_helper.left_inner_end() - gemm_helper.left_inner_begin();
 
+      if(compressed_norms_ || other.compressed_norms_) {
+        // Only the pairs of non-zero tiles are visited
+        std::vector<value_type> k_sizes;
+        if(k_rank > 0u) {
+          const vector_type sizes =
+              recursive_outer_product(size_vectors_.get() + gemm_helper.left_inner_begin(),
+                  k_rank, [] (const vector_type& size_vector) -> const vector_type&
+                  { return size_vector; });
+          k_sizes.assign(sizes.data(), sizes.data() + sizes.size());
+        }
+
+        return SparseShape_(compressed_norms()->gemm(*other.compressed_norms(),
+            gemm_helper, k_sizes, abs_factor, threshold), result_size_vectors, threshold);
+      }
+
       // Construct the result norm tensor
       Tensor<value_type> result_norms(gemm_helper.make_result_range<typename Tensor<T>::range_type>(
           tile_norms_.range(), other.tile_norms_.range()), 0);
@@ -1093,6 +1783,18 @@ namespace TiledArray {
                 k_rank, [] (const vector_type& size_vector) -> const vector_type&
                 { return size_vector; });
 
+        // When few pairs of tiles are non-zero, only those pairs are visited
+        if((gemm_helper.left_op() == madness::cblas::NoTrans) &&
+            (gemm_helper.right_op() == madness::cblas::NoTrans) &&
+            ((1.0f - sparsity()) * (1.0f - other.sparsity()) < sparse_gemm_density()))
+        {
+          const size_type zero_count = sparse_gemm(M, N, K, tile_norms_.data(),
+              other.tile_norms_.data(), k_sizes.data(), abs_factor, threshold,
+              result_norms.data());
+          return SparseShape_(result_norms, result_size_vectors, zero_count,
+              threshold);
+        }
+
         // TODO: Make this faster. It can be done without using temporaries
         // for the arguments, but requires a custom matrix multiply.
 
@@ -1115,42 +1817,29 @@ namespace TiledArray {
 
         // Hard zero tiles that are below the zero threshold.
         result_norms.inplace_unary(
-            [threshold, &zero_tile_count] (value_type& value) {
-              if(value < threshold) {
-                value = value_type(0);
-                ++zero_tile_count;
-              }
+            [threshold] (value_type& value) {
+              value = (value < threshold ? value_type(0) : value);
             });
 
       } else {
 
         // This is an outer product, so the inputs can be used directly
-        math::outer_fill(M, N, tile_norms_.data(), other.tile_norms_.data(), result_norms.data(),
-            [threshold, &zero_tile_count, abs_factor] (const value_type left,
-                const value_type right)
-            {
-              value_type norm = left * right * abs_factor;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
-              }
-              return norm;
-            });
+        auto outer_op = [threshold, abs_factor] (const value_type left,
+            const value_type right)
+        {
+          const value_type norm = left * right * abs_factor;
+          return (norm < threshold ? value_type(0) : norm);
+        };
+        const value_type* const left = tile_norms_.data();
+        const value_type* const right = other.tile_norms_.data();
+        value_type* const result = result_norms.data();
+        parallel_rows(M, N, [=] (const std::size_t i, const std::size_t m) {
+          math::outer_fill(m, N, left + i, right, result + i * N, outer_op);
+        });
       }
 
-      return SparseShape_(result_norms, result_size_vectors, zero_tile_count);
+      return SparseShape_(result_norms, result_size_vectors, threshold);
     }
-
-    /// \tparam Factor The scaling factor type
-    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
-    template <typename Factor>
-    SparseShape_ gemm(const SparseShape_& other, const Factor factor,
-        const math::GemmHelper& gemm_helper, const Permutation& perm) const
-    {
-      return gemm(other, factor, gemm_helper).perm(perm);
-    }
-
-  private:
     template <typename Factor>
     static value_type to_abs_factor(const Factor factor) {
       using std::abs;
@@ -1164,6 +1853,9 @@ namespace TiledArray {
   // Static member initialization
   template <typename T>
   typename SparseShape<T>::value_type SparseShape<T>::threshold_ = std::numeric_limits<T>::epsilon();
+  template <typename T>
+  typename SparseShape<T>::GemmEstimate SparseShape<T>::gemm_estimate_ =
+      SparseShape<T>::GemmEstimate::bound;
 
   /// Add the shape to an output stream
 
@@ -142,6 +142,7 @@ DistArray<Tensor<T>,DensePolicy> dense_diagonal_array(World &world,
     DistArray<Tensor<T>, DensePolicy> A(world, trange);
 
     detail::write_tiles_to_array(A, val);
+    A.set_diagonal();
 
     world.gop.fence();
     return A;
@@ -165,6 +166,7 @@ DistArray<Tensor<T>, SparsePolicy> sparse_diagonal_array(World &world,
     DistArray<Tensor<T>, SparsePolicy> A(world, trange, shape);
 
     detail::write_tiles_to_array(A, val);
+    A.set_diagonal();
 
     world.gop.fence();
     return A;
@@ -20,6 +20,7 @@
 #ifndef TILEDARRAY_SPECIAL_KRONECKER_DELTA_H__INCLUDED
 #define TILEDARRAY_SPECIAL_KRONECKER_DELTA_H__INCLUDED
 
+#include <algorithm>
 #include <tuple>
 #include <memory>
 
@@ -108,7 +109,7 @@ template<unsigned _N = 1>
         auto lobound = range.lobound_data();
         auto upbound = range.upbound_data();
         for(auto i=0; i!=2*N && not empty; i+=2)
-          empty = (upbound[i] > lobound[i+1] && upbound[i+1] > lobound[i]) ? true : false; // assumes extents > 0
+          empty = (upbound[i] > lobound[i+1] && upbound[i+1] > lobound[i]) ? false : true; // assumes extents > 0
         return empty;
       }
 
@@ -185,8 +186,117 @@ template<typename T, unsigned N>
 
 // Contraction operation
 
+namespace TiledArray {
+  namespace detail {
+
+    /// The diagonal of a pair of dimensions of a Kronecker delta tile
+
+    /// \param range The range of the Kronecker delta tile
+    /// \param d The first dimension of the pair
+    /// \return The first and last (exclusive) global index for which
+    /// dimensions \c d and \c d+1 of the tile are equal
+    inline std::pair<std::size_t, std::size_t>
+    kronecker_delta_diagonal(const TiledArray::Range& range, const unsigned int d) {
+      const auto* lobound = range.lobound_data();
+      const auto* upbound = range.upbound_data();
+      return std::make_pair(std::max(lobound[d], lobound[d + 1u]),
+          std::min(upbound[d], upbound[d + 1u]));
+    }
+
+    /// Accumulate the outer product of a Kronecker delta tile and a tensor
+
+    /// The tensor is copied to the blocks of the result on the diagonals of
+    /// the Kronecker delta tile.
+    /// \param result The result data, in the outer product range
+    /// \param range The range of the Kronecker delta tile
+    /// \param pair The first delta pair that is not yet indexed
+    /// \param offset The ordinal of the block of the result for the delta
+    /// pairs that are already indexed
+    /// \param arg The tensor argument
+    /// \param factor The scaling factor
+    template <typename T>
+    void kronecker_delta_outer(T* const result, const TiledArray::Range& range,
+        const unsigned int pair, const std::size_t offset,
+        const TiledArray::Tensor<T>& arg,
+        const typename TiledArray::Tensor<T>::numeric_type factor)
+    {
+      if(2u * pair == range.rank()) {
+        T* MADNESS_RESTRICT const block = result + offset * arg.size();
+        const T* MADNESS_RESTRICT const arg_data = arg.data();
+        for(std::size_t x = 0ul; x < arg.size(); ++x)
+          block[x] += factor * arg_data[x];
+        return;
+      }
+
+      const unsigned int d = 2u * pair;
+      const auto diagonal = kronecker_delta_diagonal(range, d);
+      const auto* lobound = range.lobound_data();
+      const auto* extent = range.extent_data();
+      for(std::size_t g = diagonal.first; g < diagonal.second; ++g)
+        kronecker_delta_outer(result, range, pair + 1u,
+            (offset * extent[d] + (g - lobound[d])) * extent[d + 1u]
+            + (g - lobound[d + 1u]), arg, factor);
+    }
+
+    /// Accumulate the contraction of a Kronecker delta tile with a tensor
+
+    /// The contraction of <tt>delta(i,k)</tt> with a tensor over \c k
+    /// relabels index \c k of the tensor as \c i , so the rows (or columns)
+    /// of the tensor whose global index is on the diagonal of the Kronecker
+    /// delta tile are copied to the result; no multiplications are done,
+    /// except by \c factor .
+    /// \param[in,out] result The result tile
+    /// \param delta The Kronecker delta tile
+    /// \param arg The tensor argument
+    /// \param factor The scaling factor
+    /// \param gemm_config The contraction configuration
+    /// \param delta_left \c true if \c delta is the left-hand argument
+    /// \note Only the contraction of an ordinary Kronecker delta (i.e.
+    /// <tt>N == 1</tt> ) is implemented.
+    template <typename T, unsigned N>
+    void kronecker_delta_contract(TiledArray::Tensor<T>& result,
+        const KroneckerDeltaTile<N>& delta, const TiledArray::Tensor<T>& arg,
+        const typename TiledArray::Tensor<T>::numeric_type factor,
+        const TiledArray::math::GemmHelper& gemm_config, const bool delta_left)
+    {
+      TA_ASSERT(N == 1u);
+      TA_ASSERT(gemm_config.num_contract_ranks() == 1u);
+
+      // The contracted dimension of each argument
+      const bool delta_no_trans = ((delta_left ? gemm_config.left_op() :
+          gemm_config.right_op()) == madness::cblas::NoTrans);
+      const bool arg_no_trans = ((delta_left ? gemm_config.right_op() :
+          gemm_config.left_op()) == madness::cblas::NoTrans);
+      const unsigned int delta_k = (delta_left == delta_no_trans ? 1u : 0u);
+      const unsigned int delta_outer = 1u - delta_k;
+      const bool arg_k_first = (delta_left == arg_no_trans);
+      const unsigned int arg_k = (arg_k_first ? 0u : arg.range().rank() - 1u);
+
+      const auto diagonal = kronecker_delta_diagonal(delta.range(), 0u);
+      const std::size_t outer_lobound = delta.range().lobound_data()[delta_outer];
+      const std::size_t outer_extent = delta.range().extent_data()[delta_outer];
+      const std::size_t k_lobound = arg.range().lobound_data()[arg_k];
+      const std::size_t k_extent = arg.range().extent_data()[arg_k];
+      const std::size_t arg_outer = arg.size() / k_extent;
+
+      T* MADNESS_RESTRICT const result_data = result.data();
+      const T* MADNESS_RESTRICT const arg_data = arg.data();
+      for(std::size_t g = diagonal.first; g < diagonal.second; ++g) {
+        const std::size_t o = g - outer_lobound;
+        const std::size_t k = g - k_lobound;
+        for(std::size_t x = 0ul; x < arg_outer; ++x)
+          result_data[delta_left ? o * arg_outer + x : x * outer_extent + o] +=
+              factor * arg_data[arg_k_first ? k * arg_outer + x : x * k_extent + k];
+      }
+    }
+
+  }  // namespace detail
+}  // namespace TiledArray
+
 // GEMM operation with fused indices as defined by gemm_config:
 // dense_result[i,j] = dense_arg1[i,k] * sparse_arg2[k,j]
+// An outer product copies arg2 to the diagonals of arg1; a contraction of
+// KroneckerDeltaTile<1> over one index relabels the contracted index of arg2.
 template<typename T, unsigned N>
   TiledArray::Tensor<T>
   gemm (
@@ -194,54 +304,10 @@ template<typename T, unsigned N>
       const TiledArray::Tensor<T>& arg2,
       const typename TiledArray::Tensor<T>::numeric_type factor,
       const TiledArray::math::GemmHelper& gemm_config) {
-
-  // preconditions:
-  // 1. implemented only outer product
-  assert(gemm_config.result_rank() == gemm_config.left_rank() + gemm_config.right_rank());
-
-  auto arg1_range = arg1.range();
-  auto arg2_range = arg2.range();
   auto result_range = gemm_config.make_result_range<TiledArray::Range> (
-      arg1_range, arg2_range);
-  TiledArray::Tensor<T> result (result_range, 0);
-
-  auto result_data = result.data();
-  auto arg1_extents = arg1_range.extent_data();
-  auto arg2_data = arg2.data();
-  auto arg2_volume = arg2_range.volume();
-
-  if (not arg1.empty ()) {
-    switch (N) {
-      case 1: {
-        auto i0_range = std::min (arg1_extents[0], arg1_extents[1]);
-        for (decltype(i0_range) i0 = 0; i0 != i0_range; ++i0) {
-          auto result_i0i0_ptr = result_data
-              + (i0 * arg1_extents[1] + i0) * arg2_volume;
-          std::copy (arg2_data, arg2_data + arg2_volume, result_i0i0_ptr);
-        }
-      }
-        break;
-      case 2: {
-        auto i0_range = std::min (arg1_extents[0], arg1_extents[1]);
-        auto i1_range = std::min (arg1_extents[2], arg1_extents[3]);
-        auto ndim23 = arg1_extents[2] * arg1_extents[3];
-        for (decltype(i0_range) i0 = 0; i0 != i0_range; ++i0) {
-          auto result_i0i0i1i1_ptr_offset = result_data
-              + (i0 * arg1_extents[1] + i0) * ndim23 * arg2_volume;
-          for (decltype(i1_range) i1 = 0; i1 != i1_range; ++i1) {
-            auto result_i0i0i1i1_ptr = result_i0i0i1i1_ptr_offset
-                + (i1 * arg1_extents[3] + i1) * arg2_volume;
-            std::copy (arg2_data, arg2_data + arg2_volume, result_i0i0i1i1_ptr);
-          }
-        }
-      }
-        break;
-
-      default:
-        abort (); // not implemented
-    }
-  }
-
+      arg1.range(), arg2.range());
+  TiledArray::Tensor<T> result (result_range, T(0));
+  gemm(result, arg1, arg2, factor, gemm_config);
   return result;
 }
 // GEMM operation with fused indices as defined by gemm_config:
@@ -254,7 +320,49 @@ template<typename T, unsigned N>
       const TiledArray::Tensor<T>& arg2,
       const typename TiledArray::Tensor<T>::numeric_type factor,
       const TiledArray::math::GemmHelper& gemm_config) {
-  abort();
+  if (arg1.empty ())
+    return;
+
+  if (gemm_config.num_contract_ranks() == 0u) {
+    TiledArray::detail::kronecker_delta_outer(result.data(), arg1.range(), 0u,
+        0ul, arg2, factor);
+  } else {
+    TiledArray::detail::kronecker_delta_contract(result, arg1, arg2, factor,
+        gemm_config, true);
   }
+}
+
+// GEMM operation with fused indices as defined by gemm_config:
+// dense_result[i,j] = dense_arg1[i,k] * sparse_arg2[k,j]
+template<typename T>
+  TiledArray::Tensor<T>
+  gemm (
+      const TiledArray::Tensor<T>& arg1,
+      const KroneckerDeltaTile<1>& arg2,
+      const typename TiledArray::Tensor<T>::numeric_type factor,
+      const TiledArray::math::GemmHelper& gemm_config) {
+  auto result_range = gemm_config.make_result_range<TiledArray::Range> (
+      arg1.range(), arg2.range());
+  TiledArray::Tensor<T> result (result_range, T(0));
+  gemm(result, arg1, arg2, factor, gemm_config);
+  return result;
+}
+// GEMM operation with fused indices as defined by gemm_config:
+// dense_result[i,j] += dense_arg1[i,k] * sparse_arg2[k,j]
+template<typename T>
+  void
+  gemm (
+      TiledArray::Tensor<T>& result,
+      const TiledArray::Tensor<T>& arg1,
+      const KroneckerDeltaTile<1>& arg2,
+      const typename TiledArray::Tensor<T>::numeric_type factor,
+      const TiledArray::math::GemmHelper& gemm_config) {
+  // preconditions:
+  // 1. implemented only contraction over one index
+  TA_ASSERT(gemm_config.num_contract_ranks() == 1u);
+  if (not arg2.empty ())
+    TiledArray::detail::kronecker_delta_contract(result, arg2, arg1, factor,
+        gemm_config, false);
+}
 
 #endif // TILEDARRAY_TEST_SPARSE_TILE_H__INCLUDED
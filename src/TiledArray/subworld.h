@@ -0,0 +1,233 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  subworld.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_SUBWORLD_H__INCLUDED
+#define TILEDARRAY_SUBWORLD_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Split a world into subworlds
+
+  /// The processes of \c parent with the same \c color form a subworld, and
+  /// keep their relative order.
+  /// \param parent The world to be split
+  /// \param color The subworld of this process
+  /// \return The subworld of this process
+  /// \note This function is collective in \c parent .
+  inline std::unique_ptr<World> split_world(World& parent, const int color) {
+    return std::unique_ptr<World>(
+        new World(parent.mpi.comm().Split(color, parent.rank())));
+  }
+
+  /// Copy an array into a subworld
+
+  /// The tiles of the copy are read from \c array , so the world of
+  /// \c array must include the processes of \c world . Tiles that are stored
+  /// on the same process in both arrays are shared, not copied.
+  /// \tparam Tile The tile type of the array
+  /// \tparam Policy The policy type of the array
+  /// \param array The array to be copied
+  /// \param world The world of the copy, e.g. a subworld of the array world
+  /// \param pmap The process map of the copy [ default = the policy default ]
+  /// \return A copy of \c array in \c world
+  /// \note This function is collective in \c world .
+  template <typename Tile, typename Policy>
+  inline DistArray<Tile, Policy>
+  copy_to_world(const DistArray<Tile, Policy>& array, World& world,
+      const std::shared_ptr<typename DistArray<Tile, Policy>::pmap_interface>& pmap =
+          std::shared_ptr<typename DistArray<Tile, Policy>::pmap_interface>())
+  {
+    DistArray<Tile, Policy> result(world, array.trange(), array.shape(), pmap);
+    for(const auto index : *result.pmap())
+      if(! result.is_zero(index))
+        result.set(index, array.find(index));
+    return result;
+  }
+
+  /// Evaluate independent statements on disjoint subworlds
+
+  /// Contractions that are too small to scale to all processes are
+  /// evaluated concurrently: the processes of the parent world are split
+  /// into \c n subworlds of consecutive ranks, and each statement is
+  /// evaluated by the processes of one subworld. Statements are assigned in
+  /// order of decreasing cost to the subworld with the smallest total cost,
+  /// so the subworlds finish at about the same time. The arguments of the
+  /// statements are read from the parent world, and the results are sent to
+  /// arrays of the parent world, in one message per destination process:
+  /// \code
+  /// TA::SubworldScheduler scheduler(world, 4);
+  /// for(std::size_t i = 0; i < n; ++i)
+  ///   scheduler.add(c[i], "i,j", [&,i] () { return a[i]("i,k") * b[i]("k,j"); });
+  /// scheduler.run();
+  /// \endcode
+  /// \note The statements must be added in the same order on all processes,
+  /// and must not read the results of other statements.
+  class SubworldScheduler {
+  public:
+    typedef std::size_t size_type; ///< Size type
+
+  private:
+
+    /// A statement of the scheduler
+    struct Statement {
+      double cost; ///< The estimated cost of the statement
+      std::function<void(World&)> eval; ///< Evaluate the statement in a subworld
+      std::function<void()> assign; ///< Assign the result in the parent world
+    }; // struct Statement
+
+    World* parent_; ///< The parent world
+    unsigned int size_; ///< The number of subworlds
+    unsigned int color_; ///< The subworld of this process
+    std::unique_ptr<World> subworld_; ///< The subworld of this process
+    std::vector<Statement> statements_; ///< The statements to be evaluated
+    size_type message_elements_; ///< The number of elements of each result message
+
+    /// The subworld of a process
+
+    /// \param rank The rank of a process in the parent world
+    /// \return The subworld of process \c rank
+    unsigned int color(const ProcessID rank) const {
+      return (size_type(rank) * size_) / size_type(parent_->size());
+    }
+
+  public:
+
+    /// Constructor
+
+    /// \param parent The world that is split into subworlds
+    /// \param n The number of subworlds
+    /// \param message_elements The number of elements that are sent in each
+    /// message of the results [ default = 2^20 ]
+    /// \note This function is collective in \c parent .
+    SubworldScheduler(World& parent, const unsigned int n,
+        const size_type message_elements = 1048576ul) :
+      parent_(&parent), size_(n), color_(0u), subworld_(), statements_(),
+      message_elements_(message_elements)
+    {
+      TA_USER_ASSERT((n > 0u) && (n <= unsigned(parent.size())),
+          "SubworldScheduler::SubworldScheduler() -- The number of subworlds "
+          "must be positive and may not exceed the number of processes.");
+      color_ = color(parent.rank());
+      subworld_ = split_world(parent, color_);
+    }
+
+    ~SubworldScheduler() {
+      if(subworld_)
+        subworld_->gop.fence();
+    }
+
+    /// The number of subworlds
+
+    /// \return The number of subworlds
+    unsigned int size() const { return size_; }
+
+    /// The subworld of this process
+
+    /// \return A reference to the subworld of this process
+    World& subworld() const { return *subworld_; }
+
+    /// The index of the subworld of this process
+
+    /// \return The index of the subworld of this process
+    unsigned int subworld_index() const { return color_; }
+
+    /// Add a statement
+
+    /// The result tiled range and shape are predicted from the expression
+    /// in the parent world, so the result array is created by all processes
+    /// without communication. Expressions whose shape depends on the tile
+    /// data, i.e. truncated expressions, are not supported.
+    /// \tparam Tile The tile type of the result
+    /// \tparam Policy The policy type of the result
+    /// \tparam Op The expression generator type
+    /// \param result The array that is assigned by \c run()
+    /// \param vars The variable list of \c result
+    /// \param op The expression generator, where <tt>op()</tt> returns the
+    /// expression that is assigned to \c result
+    /// \param cost The estimated cost of the statement [ default = the size
+    /// of the result ]
+    template <typename Tile, typename Policy, typename Op>
+    void add(DistArray<Tile, Policy>& result, const std::string& vars,
+        const Op& op, const double cost = -1.0)
+    {
+      typedef DistArray<Tile, Policy> array_type;
+
+      const auto prediction = op().predict(vars, *parent_);
+      array_type target(*parent_, prediction.trange, prediction.shape);
+      const size_type message_elements = message_elements_;
+
+      Statement statement;
+      statement.cost = (cost < 0.0 ? double(prediction.total_tile_bytes()) : cost);
+      statement.eval = [=] (World& world) mutable {
+        array_type local;
+        auto expr = op();
+        local(vars) = expr.set_world(world);
+        local.redistribute(target, message_elements);
+      };
+      statement.assign = [&result,target] () { result = target; };
+      statements_.push_back(std::move(statement));
+    }
+
+    /// Evaluate the statements
+
+    /// Each process evaluates the statements of its subworld, then waits for
+    /// the results of all statements, which are assigned to their arrays.
+    /// \note This function is collective in the parent world.
+    void run() {
+      // Assign the statements to the subworlds, largest first
+      std::vector<size_type> order(statements_.size());
+      std::iota(order.begin(), order.end(), 0ul);
+      std::stable_sort(order.begin(), order.end(),
+          [this] (const size_type left, const size_type right) {
+            return statements_[left].cost > statements_[right].cost;
+          });
+      std::vector<double> load(size_, 0.0);
+      for(const size_type s : order) {
+        const unsigned int c =
+            std::min_element(load.begin(), load.end()) - load.begin();
+        load[c] += statements_[s].cost;
+        if(c == color_)
+          statements_[s].eval(*subworld_);
+      }
+
+      // Wait for the results of all subworlds
+      subworld_->gop.fence();
+      parent_->gop.fence();
+
+      for(Statement& statement : statements_)
+        statement.assign();
+      statements_.clear();
+    }
+
+  }; // class SubworldScheduler
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_SUBWORLD_H__INCLUDED
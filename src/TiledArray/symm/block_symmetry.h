@@ -0,0 +1,213 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  block_symmetry.h
+ *
+ */
+
+#ifndef TILEDARRAY_SYMM_BLOCK_SYMMETRY_H__INCLUDED
+#define TILEDARRAY_SYMM_BLOCK_SYMMETRY_H__INCLUDED
+
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <TiledArray/error.h>
+#include <TiledArray/sparse_shape.h>
+#include <TiledArray/tiled_range.h>
+
+namespace TiledArray {
+  namespace symmetry {
+
+    /**
+     * \addtogroup symmetry
+     * @{
+     */
+
+    /// Block structure of an array from conserved tile labels
+
+    /// Each tile of a labeled mode carries a label, e.g. the irrep of an
+    /// abelian point group or the spin of the orbitals of the tile. Labels are
+    /// combined with bitwise XOR, which is the product of the irreps of
+    /// \f$ D_{2h} \f$ and its subgroups in the usual bit encoding, and also
+    /// compares two spin labels. A conservation law requires that the product
+    /// of the labels of a set of modes is equal to a target label, e.g. the
+    /// totally symmetric irrep 0. The tiles that violate a law are zero by
+    /// symmetry, so they are known before any tile norm is computed: use
+    /// \c mask() to remove them from a shape, or \c shape() as the argument
+    /// of \c Expr::set_shape() to skip them in an expression, including the
+    /// SUMMA iterations of a contraction.
+    /// \code
+    /// // <pq|rs> with irrep and spin labels of the occupied and virtual tiles
+    /// BlockSymmetry symm(trange);
+    /// symm.conserve({0, 1, 2, 3}, {irrep_o, irrep_o, irrep_v, irrep_v})
+    ///     .conserve({0, 2}, {spin_o, spin_v})
+    ///     .conserve({1, 3}, {spin_o, spin_v});
+    /// \endcode
+    class BlockSymmetry {
+    public:
+      typedef unsigned int label_type; ///< Tile label type
+      typedef std::vector<label_type> labels_type; ///< The labels of the tiles of a mode
+      typedef TiledRange::range_type range_type; ///< Tile range type
+      typedef range_type::size_type size_type; ///< Size type
+
+    private:
+
+      /// Conservation law of the labels of a set of modes
+      struct law_type {
+        std::vector<unsigned int> modes; ///< The modes of the law
+        std::vector<labels_type> labels; ///< The tile labels of each mode
+        label_type target; ///< The product of the labels of the allowed tiles
+      }; // struct law_type
+
+      TiledRange trange_; ///< The tiled range of the array
+      std::vector<law_type> laws_; ///< The conservation laws
+
+    public:
+
+      BlockSymmetry() = delete;
+      BlockSymmetry(const BlockSymmetry&) = default;
+      BlockSymmetry(BlockSymmetry&&) = default;
+      BlockSymmetry& operator=(const BlockSymmetry&) = default;
+      BlockSymmetry& operator=(BlockSymmetry&&) = default;
+
+      /// Constructor
+
+      /// \param trange The tiled range of the array; all tiles are allowed
+      /// until a conservation law is added
+      explicit BlockSymmetry(const TiledRange& trange) :
+        trange_(trange), laws_()
+      { }
+
+      /// Tile labels of a mode
+
+      /// \param tr1 The tiling of the mode
+      /// \param element_labels The labels of the elements of the mode, e.g.
+      /// the irreps of the orbitals
+      /// \return The labels of the tiles of \c tr1
+      /// \throw TiledArray::Exception When \c element_labels does not cover
+      /// \c tr1 , or the elements of a tile have different labels
+      static labels_type tile_labels(const TiledRange1& tr1,
+          const labels_type& element_labels)
+      {
+        TA_USER_ASSERT(tr1.elements_range().second <= element_labels.size(),
+            "BlockSymmetry::tile_labels(): The element labels do not cover the tiled range.");
+        labels_type result;
+        result.reserve(tr1.tiles_range().second - tr1.tiles_range().first);
+        for(const auto& tile : tr1) {
+          const label_type label = element_labels[tile.first];
+          for(auto i = tile.first; i < tile.second; ++i)
+            TA_USER_ASSERT(element_labels[i] == label,
+                "BlockSymmetry::tile_labels(): The elements of a tile must have the same label.");
+          result.push_back(label);
+        }
+        return result;
+      }
+
+      /// Add a conservation law
+
+      /// \param modes The modes of the law
+      /// \param labels The tile labels of each mode of \c modes
+      /// \param target The product of the labels of the allowed tiles
+      /// [ default = 0 ]
+      /// \return A reference to this object
+      /// \throw TiledArray::Exception When a mode is not in the tiled range,
+      /// or its labels do not match its number of tiles
+      BlockSymmetry& conserve(const std::vector<unsigned int>& modes,
+          const std::vector<labels_type>& labels, const label_type target = 0u)
+      {
+        TA_USER_ASSERT(modes.size() == labels.size(),
+            "BlockSymmetry::conserve(): Each mode of the law must have labels.");
+        for(unsigned int m = 0u; m < modes.size(); ++m) {
+          TA_USER_ASSERT(modes[m] < trange_.rank(),
+              "BlockSymmetry::conserve(): The modes are not in the tiled range.");
+          const auto& tiles = trange_.dim(modes[m]).tiles_range();
+          TA_USER_ASSERT(labels[m].size() == tiles.second - tiles.first,
+              "BlockSymmetry::conserve(): There must be one label for each tile of a mode.");
+        }
+        laws_.push_back(law_type{modes, labels, target});
+        return *this;
+      }
+
+      /// Tiled range accessor
+
+      /// \return The tiled range of the array
+      const TiledRange& trange() const { return trange_; }
+
+      /// Check for an allowed tile
+
+      /// \tparam Index The tile index type
+      /// \param index The index of a tile
+      /// \return \c true if tile \c index satisfies all conservation laws
+      template <typename Index,
+          typename = std::enable_if_t<! std::is_integral<Index>::value>>
+      bool is_allowed(const Index& index) const {
+        const auto& lobound = trange_.tiles_range().lobound();
+        for(const auto& law : laws_) {
+          label_type product = 0u;
+          for(unsigned int m = 0u; m < law.modes.size(); ++m) {
+            const unsigned int mode = law.modes[m];
+            product ^= law.labels[m][index[mode] - lobound[mode]];
+          }
+          if(product != law.target)
+            return false;
+        }
+        return true;
+      }
+
+      /// Check for an allowed tile
+
+      /// \param ordinal The ordinal index of a tile
+      /// \return \c true if tile \c ordinal satisfies all conservation laws
+      bool is_allowed(const size_type ordinal) const {
+        return is_allowed(trange_.tiles_range().idx(ordinal));
+      }
+
+      /// Block structure shape
+
+      /// \tparam T The norm type
+      /// \return A shape in which the tiles forbidden by symmetry are zero;
+      /// the norms of the allowed tiles are only meaningful as a mask, e.g.
+      /// for \c Expr::set_shape()
+      template <typename T = float>
+      SparseShape<T> shape() const {
+        const auto& tiles_range = trange_.tiles_range();
+        Tensor<T> tile_norms(tiles_range, T(0));
+        for(size_type ord = 0ul; ord < tiles_range.volume(); ++ord)
+          if(is_allowed(ord))
+            tile_norms[ord] = std::numeric_limits<T>::max();
+        return SparseShape<T>(tile_norms, trange_);
+      }
+
+      /// Remove the tiles forbidden by symmetry from a shape
+
+      /// \tparam T The norm type
+      /// \param shape A shape of an array with the tiled range of this object
+      /// \return \c shape with the tiles forbidden by symmetry set to zero
+      template <typename T>
+      SparseShape<T> mask(const SparseShape<T>& shape) const {
+        return shape.mask(this->shape<T>());
+      }
+
+    }; // class BlockSymmetry
+
+    /** @}*/
+
+  } // namespace symmetry
+} // namespace TiledArray
+
+#endif // TILEDARRAY_SYMM_BLOCK_SYMMETRY_H__INCLUDED
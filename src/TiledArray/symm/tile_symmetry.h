@@ -0,0 +1,156 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_symmetry.h
+ *
+ */
+
+#ifndef TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
+#define TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
+
+#include <utility>
+#include <vector>
+
+#include <TiledArray/error.h>
+#include <TiledArray/permutation.h>
+#include <TiledArray/tiled_range.h>
+#include <TiledArray/symm/permutation_group.h>
+
+namespace TiledArray {
+  namespace symmetry {
+
+    /**
+     * \addtogroup symmetry
+     * @{
+     */
+
+    /// Permutational symmetry of the tiles of an array
+
+    /// The elements of an array with this symmetry are invariant under the
+    /// permutations of the modes in a \c PermutationGroup , so the tiles of
+    /// the array form orbits under the action of the group on the tile
+    /// indices. Only the representative of each orbit, the lexicographically
+    /// smallest tile index (see \c is_lexicographically_smallest ), needs to
+    /// be stored; any other tile of the orbit is a permutation of its
+    /// representative.
+    class TileSymmetry {
+    public:
+      typedef TiledRange::range_type range_type; ///< Tile range type
+      typedef range_type::size_type size_type; ///< Size type
+      typedef range_type::index index; ///< Tile index type
+
+    private:
+
+      PermutationGroup group_; ///< The symmetry group of the modes
+      range_type tiles_range_; ///< The range of the tile indices
+
+    public:
+
+      TileSymmetry() = delete;
+      TileSymmetry(const TileSymmetry&) = default;
+      TileSymmetry(TileSymmetry&&) = default;
+      TileSymmetry& operator=(const TileSymmetry&) = default;
+      TileSymmetry& operator=(TileSymmetry&&) = default;
+
+      /// Constructor
+
+      /// \param group The group of mode permutations that leave the array
+      /// invariant
+      /// \param trange The tiled range of the array
+      /// \throw TiledArray::Exception When a permutation of \c group acts on
+      /// a mode that is not in \c trange , or maps a mode onto a mode with a
+      /// different tiling
+      TileSymmetry(const PermutationGroup& group, const TiledRange& trange) :
+        group_(group), tiles_range_(trange.tiles_range())
+      {
+        const auto rank = trange.rank();
+        for(const auto& g : group_)
+          for(unsigned int i = 0u; i < rank; ++i) {
+            TA_USER_ASSERT(g[i] < rank,
+                "TileSymmetry::TileSymmetry(): The permutation group acts on modes that are not in the tiled range.");
+            TA_USER_ASSERT(trange.dim(g[i]) == trange.dim(i),
+                "TileSymmetry::TileSymmetry(): Symmetric modes must have the same tiling.");
+          }
+      }
+
+      /// Symmetry group accessor
+
+      /// \return The group of mode permutations
+      const PermutationGroup& group() const { return group_; }
+
+      /// Mode permutation of a group element
+
+      /// \param g An element of the symmetry group
+      /// \return The permutation of the modes of a tile by \c g , in the form
+      /// used to permute tiles
+      TiledArray::Permutation mode_permutation(const PermutationGroup::Permutation& g) const {
+        const auto rank = tiles_range_.rank();
+        std::vector<unsigned int> perm(rank);
+        for(unsigned int i = 0u; i < rank; ++i)
+          perm[i] = g[i];
+        return TiledArray::Permutation(std::move(perm));
+      }
+
+      /// Check for an orbit representative
+
+      /// \param ordinal The ordinal index of a tile
+      /// \return \c true if tile \c ordinal is the representative of its orbit
+      bool is_representative(const size_type ordinal) const {
+        return is_lexicographically_smallest(tiles_range_.idx(ordinal), group_);
+      }
+
+      /// Orbit representative of a tile
+
+      /// Tile \c ordinal is equal to <tt>permute(tile(first), second)</tt> .
+      /// \param ordinal The ordinal index of a tile
+      /// \return A pair of the ordinal index of the representative of the
+      /// orbit of \c ordinal and the permutation that maps it to tile
+      /// \c ordinal ; the permutation is empty when \c ordinal is a
+      /// representative.
+      std::pair<size_type, TiledArray::Permutation>
+      representative(const size_type ordinal) const {
+        const index idx = tiles_range_.idx(ordinal);
+        const auto rank = idx.size();
+
+        // Find the lexicographically smallest image of idx
+        index smallest = idx, candidate(rank);
+        const PermutationGroup::Permutation* smallest_g = nullptr;
+        for(const auto& g : group_) {
+          for(unsigned int i = 0u; i < rank; ++i)
+            candidate[i] = idx[g[i]];
+          if(candidate < smallest) {
+            smallest.swap(candidate);
+            smallest_g = &g;
+          }
+        }
+
+        if(! smallest_g)
+          return std::make_pair(ordinal, TiledArray::Permutation());
+
+        // Mode i of the representative tile is mode g[i] of this tile
+        return std::make_pair(tiles_range_.ordinal(smallest),
+            mode_permutation(*smallest_g));
+      }
+
+    }; // class TileSymmetry
+
+    /** @}*/
+
+  } // namespace symmetry
+} // namespace TiledArray
+
+#endif // TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
@@ -0,0 +1,120 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  task_priority.h
+ *
+ */
+
+#ifndef TILEDARRAY_TASK_PRIORITY_H__INCLUDED
+#define TILEDARRAY_TASK_PRIORITY_H__INCLUDED
+
+#include <atomic>
+#include <TiledArray/madness.h>
+
+namespace TiledArray {
+
+  /// Classes of the tasks of the distributed evaluators
+  enum class TaskClass : unsigned int {
+    broadcast = 0u, ///< Tasks that get, convert, and broadcast argument tiles, and all-reduce communication
+    step = 1u,      ///< SUMMA step tasks, which issue the broadcasts and contractions of a step
+    compute = 2u,   ///< Tile contractions and reductions
+    tile = 3u,      ///< The tile tasks of the unary, binary, and array evaluators
+    finalize = 4u   ///< The assembly of result tiles, and cleanup
+  };
+
+  /// Task priorities
+
+  /// The MADNESS task queue has two priorities: high priority tasks are run
+  /// before the queued normal priority tasks.
+  enum class TaskPriority { normal, high };
+
+  namespace detail {
+
+    /// Priorities of the task classes
+
+    /// By default communication is never starved by compute: the
+    /// \c broadcast and \c step tasks have high priority, which puts the
+    /// broadcasts of upcoming steps ahead of queued tile contractions, and
+    /// the other classes have normal priority. Since there are only two
+    /// priorities, finalization is not below compute.
+    class TaskPriorities {
+      static constexpr unsigned int default_mask =
+          (1u << unsigned(TaskClass::broadcast)) | (1u << unsigned(TaskClass::step));
+
+      static std::atomic<unsigned int>& mask() {
+        static std::atomic<unsigned int> high(default_mask);
+        return high;
+      }
+
+    public:
+
+      /// \return The priority of the tasks of class \c c
+      static TaskPriority get(const TaskClass c) {
+        return ((mask().load(std::memory_order_relaxed) >> unsigned(c)) & 1u ?
+            TaskPriority::high : TaskPriority::normal);
+      }
+
+      /// Set the priority of the tasks of class \c c
+      static void set(const TaskClass c, const TaskPriority priority) {
+        const unsigned int bit = 1u << unsigned(c);
+        if(priority == TaskPriority::high)
+          mask().fetch_or(bit, std::memory_order_relaxed);
+        else
+          mask().fetch_and(~bit, std::memory_order_relaxed);
+      }
+
+      /// Restore the default priorities
+      static void reset() { mask().store(default_mask, std::memory_order_relaxed); }
+
+    }; // class TaskPriorities
+
+    /// Task attributes of a task class
+
+    /// \param c The class of the task
+    /// \return The task attributes with the priority of \c c
+    inline madness::TaskAttributes task_attributes(const TaskClass c) {
+      return (TaskPriorities::get(c) == TaskPriority::high ?
+          madness::TaskAttributes::hipri() : madness::TaskAttributes());
+    }
+
+  }  // namespace detail
+
+  /// Set the priority of a class of tasks
+
+  /// The priorities apply to the tasks that are submitted after the call,
+  /// e.g. to give tile contractions high priority as well:
+  /// \code
+  /// TiledArray::set_task_priority(TiledArray::TaskClass::compute,
+  ///     TiledArray::TaskPriority::high);
+  /// \endcode
+  /// \param c The task class
+  /// \param priority The new priority of the tasks of \c c
+  inline void set_task_priority(const TaskClass c, const TaskPriority priority) {
+    detail::TaskPriorities::set(c, priority);
+  }
+
+  /// \return The priority of the tasks of class \c c
+  inline TaskPriority task_priority(const TaskClass c) {
+    return detail::TaskPriorities::get(c);
+  }
+
+  /// Restore the default task priorities
+  inline void reset_task_priorities() { detail::TaskPriorities::reset(); }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TASK_PRIORITY_H__INCLUDED
@@ -0,0 +1,237 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  task_trace.h
+ *
+ */
+
+#ifndef TILEDARRAY_TASK_TRACE_H__INCLUDED
+#define TILEDARRAY_TASK_TRACE_H__INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <TiledArray/config.h>
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Trace of the tasks of a process
+
+    /// When TiledArray is configured with \c TA_TRACE_TASKS=ON
+    /// ( \c TILEDARRAY_ENABLE_TASK_DEBUG_TRACE ), the tasks of TiledArray
+    /// record a begin/end event (see \c TaskTraceScope ) in these categories:
+    /// - \c dist_eval : the tile tasks of unary and binary evaluators
+    /// - \c summa : SUMMA steps, the posting of broadcasts, and finalization
+    /// - \c reduce : reduction tasks, and the draining of their arguments
+    /// - \c kernel : tile contractions
+    ///
+    /// Otherwise nothing is recorded and the instrumentation is compiled out.
+    /// Events carry the thread that ran them; the rank is added when they are
+    /// written (see \c write_task_trace() ).
+    class TaskTrace {
+    public:
+
+      /// Trace event
+      struct Event {
+        const char* category; ///< The event category
+        const char* name; ///< The event name
+        unsigned int thread; ///< The index of the thread
+        double begin; ///< The start time, in seconds
+        double end; ///< The end time, in seconds
+      }; // struct Event
+
+      /// Tracing flag
+      static constexpr const bool enabled =
+#ifdef TILEDARRAY_ENABLE_TASK_DEBUG_TRACE
+          true
+#else
+          false
+#endif
+      ;
+
+    private:
+
+      static std::mutex& mutex() {
+        static std::mutex mtx;
+        return mtx;
+      }
+
+      static std::vector<Event>& all_events() {
+        static std::vector<Event> events;
+        return events;
+      }
+
+    public:
+
+      /// Trace clock
+
+      /// \return The wall time, in seconds
+      static double now() {
+        return std::chrono::duration<double>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+      }
+
+      /// Index of the calling thread
+
+      /// Threads are numbered in the order of their first event.
+      /// \return The index of the calling thread
+      static unsigned int thread() {
+        static std::atomic<unsigned int> count(0u);
+        thread_local const unsigned int index = count.fetch_add(1u);
+        return index;
+      }
+
+      /// Record an event
+
+      /// \param category The event category
+      /// \param name The event name
+      /// \param begin The start time of the event
+      static void record(const char* category, const char* name,
+          const double begin)
+      {
+        const Event event = { category, name, thread(), begin, now() };
+        std::lock_guard<std::mutex> lock(mutex());
+        all_events().push_back(event);
+      }
+
+      /// Events accessor
+
+      /// \return A copy of the events recorded by this process
+      static std::vector<Event> events() {
+        std::lock_guard<std::mutex> lock(mutex());
+        return all_events();
+      }
+
+      /// Remove all recorded events
+      static void clear() {
+        std::lock_guard<std::mutex> lock(mutex());
+        all_events().clear();
+      }
+
+      /// Write the events in the Chrome trace event format
+
+      /// The events are written in the JSON array format, one per line, with
+      /// \c rank as the process id. Only the output of the first process
+      /// opens the array, and the closing bracket is omitted, so the output
+      /// of all processes can be concatenated into one trace.
+      /// \param os The output stream
+      /// \param rank The rank of this process
+      static void write(std::ostream& os, const int rank) {
+        const std::vector<Event> list = events();
+        const std::ios::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        if(rank == 0)
+          os << "[\n";
+        os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+           << ",\"args\":{\"name\":\"rank " << rank << "\"}},\n";
+        for(const Event& event : list) {
+          os << std::fixed << std::setprecision(3)
+             << "{\"name\":\"" << event.name << "\",\"cat\":\""
+             << event.category << "\",\"ph\":\"X\",\"pid\":" << rank
+             << ",\"tid\":" << event.thread
+             << ",\"ts\":" << event.begin * 1.0e6
+             << ",\"dur\":" << (event.end - event.begin) * 1.0e6 << "},\n";
+        }
+        os.flags(flags);
+        os.precision(precision);
+      }
+
+    }; // class TaskTrace
+
+    /// Record the execution of a scope as a trace event
+
+    /// The event begins when this object is constructed and ends when it is
+    /// destroyed. This object is empty when tracing is disabled.
+    /// \code
+    /// void eval_tile(const size_type i, tile_argument_type tile) {
+    ///   TaskTraceScope trace("dist_eval", "unary tile");
+    ///   ...
+    /// }
+    /// \endcode
+    class TaskTraceScope {
+#ifdef TILEDARRAY_ENABLE_TASK_DEBUG_TRACE
+      const char* category_; ///< The event category
+      const char* name_; ///< The event name
+      double begin_; ///< The start time of the event
+#endif // TILEDARRAY_ENABLE_TASK_DEBUG_TRACE
+
+    public:
+
+      TaskTraceScope(const TaskTraceScope&) = delete;
+      TaskTraceScope& operator=(const TaskTraceScope&) = delete;
+
+      /// Constructor
+
+      /// \param category The event category, which must be a string literal
+      /// \param name The event name, which must be a string literal
+#ifdef TILEDARRAY_ENABLE_TASK_DEBUG_TRACE
+      TaskTraceScope(const char* category, const char* name) :
+        category_(category), name_(name), begin_(TaskTrace::now())
+      { }
+
+      ~TaskTraceScope() { TaskTrace::record(category_, name_, begin_); }
+#else
+      TaskTraceScope(const char*, const char*) { }
+#endif // TILEDARRAY_ENABLE_TASK_DEBUG_TRACE
+
+    }; // class TaskTraceScope
+
+  }  // namespace detail
+
+  /// Write the task trace of each process to a file
+
+  /// Each process writes its events to <tt>prefix.rank.json</tt>, in the
+  /// Chrome trace event format, with the rank of the process as the process
+  /// id and the index of the thread as the thread id. The files of all
+  /// processes are merged into one trace by concatenation, in rank order,
+  /// e.g. <tt>cat prefix.*.json > trace.json</tt> (rank 0 first), which can
+  /// be loaded into Perfetto or \c chrome://tracing . Nothing is written
+  /// when tracing is disabled (see \c detail::TaskTrace ).
+  /// \param world The world of the processes
+  /// \param prefix The prefix of the file names
+  /// \param clear Remove the events that are written [ default = true ]
+  /// \throw TiledArray::Exception When a file cannot be opened
+  /// \note This function is collective.
+  inline void write_task_trace(World& world, const std::string& prefix,
+      const bool clear = true)
+  {
+    if(detail::TaskTrace::enabled) {
+      std::stringstream filename;
+      filename << prefix << "." << std::setfill('0') << std::setw(5)
+          << world.rank() << ".json";
+      std::ofstream file(filename.str());
+      if(! file)
+        TA_EXCEPTION("Unable to open the task trace file.");
+      detail::TaskTrace::write(file, world.rank());
+      if(clear)
+        detail::TaskTrace::clear();
+    }
+    world.gop.fence();
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TASK_TRACE_H__INCLUDED
@@ -0,0 +1,236 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_COMPRESSION_H__INCLUDED
+#define TILEDARRAY_TENSOR_COMPRESSION_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <madness/world/buffer_archive.h>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Compression of serialized tensor data
+
+  /// The data of floating-point tensors that are sent to other processes,
+  /// e.g. by SUMMA broadcasts and by the remote tile transfers of
+  /// \c DistributedStorage , may be compressed when it is larger than a threshold. The bytes of the
+  /// elements are shuffled, so that the sign and exponent bytes of all
+  /// elements are adjacent, and runs of zero bytes are encoded by their
+  /// length. Zero and near-zero elements, which are common in amplitude
+  /// tiles, compress well; other data is sent uncompressed when encoding it
+  /// does not reduce its size. The lossy mode also replaces the elements
+  /// whose magnitude is below a tolerance, e.g. the sparse threshold, with
+  /// zero, which bounds the absolute error of each element.
+  /// Only the buffer archives of MADNESS messages are compressed (see
+  /// \c detail::is_transfer_archive ); other archives, e.g. files and
+  /// checkpoints, hold the plain data.
+  /// \note The settings apply to the process that serializes a tensor; the
+  /// encoding is recorded in the serialized data, so the settings of the
+  /// processes may differ.
+  class TensorCompression {
+  public:
+    /// Compression modes
+    enum Mode {
+      none, ///< Send the raw data
+      lossless, ///< Send the exact data, compressed
+      lossy ///< Send the data with small elements set to zero, compressed
+    }; // enum Mode
+
+  private:
+
+    struct Settings {
+      Mode mode = none; ///< The compression mode
+      std::size_t min_bytes = 4096ul; ///< The smallest data that is compressed
+      double tolerance = 0.0; ///< The largest magnitude of dropped elements
+    }; // struct Settings
+
+    static Settings& settings() {
+      static Settings settings;
+      return settings;
+    }
+
+  public:
+
+    /// Set the compression settings
+
+    /// \param mode The compression mode
+    /// \param min_bytes The size, in bytes, of the smallest tensor data that
+    /// is compressed [ default = 4096 ]
+    /// \param tolerance Elements with a magnitude less than \c tolerance are
+    /// set to zero in \c lossy mode [ default = 0 ]
+    /// \note This function is not thread safe; it should be called before
+    /// tensors are sent.
+    static void set(const Mode mode, const std::size_t min_bytes = 4096ul,
+        const double tolerance = 0.0)
+    {
+      TA_ASSERT(tolerance >= 0.0);
+      settings().mode = mode;
+      settings().min_bytes = min_bytes;
+      settings().tolerance = tolerance;
+    }
+
+    /// Compression mode accessor
+
+    /// \return The compression mode
+    static Mode mode() { return settings().mode; }
+
+    /// Compression size threshold accessor
+
+    /// \return The size, in bytes, of the smallest data that is compressed
+    static std::size_t min_bytes() { return settings().min_bytes; }
+
+    /// Lossy compression tolerance accessor
+
+    /// \return The largest magnitude of the elements that are set to zero
+    static double tolerance() { return settings().tolerance; }
+
+    /// Check that data will be compressed
+
+    /// \param bytes The size of the data
+    /// \return \c true if data of size \c bytes is compressed
+    static bool compress(const std::size_t bytes) {
+      return (settings().mode != none) && (bytes >= settings().min_bytes);
+    }
+
+  }; // class TensorCompression
+
+  namespace detail {
+
+    /// Archives of the messages that transfer data between processes
+
+    /// Tensor data is compressed only in these archives, so the serialized
+    /// format of tensors in other archives does not depend on
+    /// \c TensorCompression .
+    /// \tparam Archive The archive type
+    template <typename Archive>
+    struct is_transfer_archive : public std::false_type { };
+
+    template <>
+    struct is_transfer_archive<madness::archive::BufferOutputArchive> :
+        public std::true_type { };
+
+    template <>
+    struct is_transfer_archive<madness::archive::BufferInputArchive> :
+        public std::true_type { };
+
+    /// Encode floating-point data by byte shuffling and zero-run encoding
+
+    /// A zero byte of the shuffled data is followed by the number of zero
+    /// bytes of its run, as a base-128 variable length integer; other bytes
+    /// are copied.
+    /// \tparam T The element type
+    /// \param data The data to be encoded
+    /// \param n The number of elements
+    /// \param tolerance Elements with a magnitude less than \c tolerance are
+    /// encoded as zero
+    /// \return The encoded data
+    template <typename T>
+    inline std::vector<unsigned char>
+    shuffle_encode(const T* const data, const std::size_t n, const T tolerance) {
+      const std::size_t size = sizeof(T);
+      std::vector<unsigned char> result;
+      result.reserve(n * size / 2ul);
+
+      // Append the pending run of zero bytes
+      std::size_t run = 0ul;
+      auto flush = [&result,&run] () {
+        if(run) {
+          result.push_back(0u);
+          for(; run >= 128ul; run >>= 7)
+            result.push_back((unsigned char)((run & 127ul) | 128ul));
+          result.push_back((unsigned char)(run));
+          run = 0ul;
+        }
+      };
+
+      // Drop the small elements
+      std::vector<T> dropped;
+      if(tolerance > T(0)) {
+        dropped.assign(data, data + n);
+        for(T& value : dropped)
+          if(std::abs(value) < tolerance)
+            value = T(0);
+      }
+      const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(
+          dropped.empty() ? data : dropped.data());
+
+      // Shuffled bytes are produced one byte plane at a time
+      for(std::size_t b = 0ul; b < size; ++b) {
+        for(std::size_t i = 0ul; i < n; ++i) {
+          const unsigned char byte = bytes[i * size + b];
+          if(byte == 0u) {
+            ++run;
+          } else {
+            flush();
+            result.push_back(byte);
+          }
+        }
+      }
+      flush();
+
+      return result;
+    }
+
+    /// Decode data of \c shuffle_encode
+
+    /// \tparam T The element type
+    /// \param code The encoded data
+    /// \param bytes The size of the encoded data
+    /// \param[out] data The decoded elements
+    /// \param n The number of elements
+    template <typename T>
+    inline void shuffle_decode(const unsigned char* const code,
+        const std::size_t bytes, T* const data, const std::size_t n)
+    {
+      const std::size_t size = sizeof(T);
+      unsigned char* const out = reinterpret_cast<unsigned char*>(data);
+      std::size_t pos = 0ul; // Position in the shuffled data
+      auto put = [out,n,size] (const std::size_t p, const unsigned char c) {
+        out[(p % n) * size + p / n] = c;
+      };
+
+      for(std::size_t c = 0ul; c < bytes; ++c) {
+        if(code[c] == 0u) {
+          std::size_t run = 0ul;
+          unsigned int shift = 0u;
+          do {
+            ++c;
+            TA_ASSERT(c < bytes);
+            run |= std::size_t(code[c] & 127u) << shift;
+            shift += 7u;
+          } while(code[c] & 128u);
+          TA_ASSERT(pos + run <= n * size);
+          for(; run; --run)
+            put(pos++, 0u);
+        } else {
+          TA_ASSERT(pos < n * size);
+          put(pos++, code[c]);
+        }
+      }
+      TA_ASSERT(pos == n * size);
+    }
+
+  }  // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_COMPRESSION_H__INCLUDED
@@ -0,0 +1,725 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_FIXED_TENSOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_FIXED_TENSOR_H__INCLUDED
+
+#include <TiledArray/tensor/tensor.h>
+#include <TiledArray/math/gemm_helper.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <ostream>
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// The volume of a compile-time tile shape
+    template <std::size_t... Extents>
+    constexpr std::size_t fixed_volume() {
+      const std::size_t extents[] = { Extents... };
+      std::size_t result = 1ul;
+      for(std::size_t i = 0ul; i < sizeof...(Extents); ++i)
+        result *= extents[i];
+      return result;
+    }
+
+    /// The integer square root of \c n
+
+    /// \return The square root of \c n , or 0 if \c n is not a perfect square
+    constexpr std::size_t fixed_sqrt(const std::size_t n) {
+      std::size_t s = 0ul;
+      while(s * s < n)
+        ++s;
+      return (s * s == n ? s : 0ul);
+    }
+
+  } // namespace detail
+
+  /// Fixed-extent tile
+
+  /// A tile whose extents are compile-time constants, e.g.
+  /// <tt>FixedTensor<double, 4, 4></tt> or
+  /// <tt>FixedTensor<double, 8, 8, 8></tt> , for arrays with tiny, uniform
+  /// tiles. The elements and the lower bound of the tile are stored inline,
+  /// so a tile does not allocate memory, and the loops of its kernels have
+  /// constant trip counts that the compiler unrolls. This tile type
+  /// implements the intrusive tile interface, so it can be used as the tile
+  /// of a \c DistArray whose tiled range has the same tile extents.
+  ///
+  /// Unlike \c Tensor , this is a value type: copies are deep, which is
+  /// cheap for tiles of a few cache lines. Wrap it with \c Tile to share the
+  /// elements of copies.
+  ///
+  /// Since the result of a tile operation has the type of its arguments,
+  /// \c permute and \c gemm require the extents of their results to equal
+  /// \c Extents , e.g. cubic tiles, or square matrices; \c gemm then
+  /// multiplies square \f$ s \times s \f$ matrices, where \f$ s^2 \f$ is the
+  /// volume of the tile.
+  /// \tparam T The element type
+  /// \tparam Extents The extents of the tile
+  template <typename T, std::size_t... Extents>
+  class FixedTensor {
+    static_assert(sizeof...(Extents) > 0ul,
+        "FixedTensor requires at least one extent");
+
+  public:
+    typedef FixedTensor<T, Extents...> FixedTensor_; ///< This object type
+    typedef Range range_type; ///< Tensor range type
+    typedef typename range_type::size_type size_type; ///< Size type
+    typedef T value_type; ///< Element type
+    typedef value_type& reference; ///< Element reference type
+    typedef const value_type& const_reference; ///< Element reference type
+    typedef value_type* pointer; ///< Element pointer type
+    typedef const value_type* const_pointer; ///< Element pointer type
+    typedef pointer iterator; ///< Element iterator type
+    typedef const_pointer const_iterator; ///< Element iterator type
+    typedef typename detail::numeric_type<T>::type numeric_type; ///< Numeric type
+    typedef typename detail::scalar_type<T>::type scalar_type; ///< Scalar type
+
+    static constexpr unsigned int rank = sizeof...(Extents); ///< The rank of the tile
+    static constexpr size_type volume = detail::fixed_volume<Extents...>(); ///< The number of elements
+    static constexpr size_type matrix_size = detail::fixed_sqrt(volume); ///< The size of the square matrix of \c gemm
+
+    /// \param dim A dimension
+    /// \return The extent of dimension \c dim
+    static constexpr size_type extent(const unsigned int dim) {
+      const size_type extents[] = { Extents... };
+      return extents[dim];
+    }
+
+  private:
+
+    std::array<value_type, volume> data_; ///< The elements
+    std::array<size_type, rank> lobound_; ///< The lower bound of the tile
+    bool initialized_ = false; ///< The tile has a range
+
+    /// Copy the lower bound of \c range
+    void set_lobound(const range_type& range) {
+      TA_ASSERT(range.rank() == rank);
+      for(unsigned int i = 0u; i < rank; ++i) {
+        TA_ASSERT(range.extent(i) == extent(i));
+        lobound_[i] = range.lobound(i);
+      }
+      initialized_ = true;
+    }
+
+    /// Construct a tile with the lower bound of \c other
+    static FixedTensor_ make_like(const FixedTensor_& other) {
+      TA_ASSERT(! other.empty());
+      FixedTensor_ result;
+      result.lobound_ = other.lobound_;
+      result.initialized_ = true;
+      return result;
+    }
+
+    template <typename Op>
+    FixedTensor_ unary(Op&& op) const {
+      FixedTensor_ result = make_like(*this);
+      for(size_type i = 0ul; i < volume; ++i)
+        result.data_[i] = op(data_[i]);
+      return result;
+    }
+
+    template <typename Op>
+    FixedTensor_& inplace_unary(Op&& op) {
+      TA_ASSERT(! empty());
+      for(size_type i = 0ul; i < volume; ++i)
+        op(data_[i]);
+      return *this;
+    }
+
+    template <typename Op>
+    FixedTensor_ binary(const FixedTensor_& right, Op&& op) const {
+      TA_ASSERT(lobound_ == right.lobound_);
+      FixedTensor_ result = make_like(*this);
+      for(size_type i = 0ul; i < volume; ++i)
+        result.data_[i] = op(data_[i], right.data_[i]);
+      return result;
+    }
+
+    template <typename Op>
+    FixedTensor_& inplace_binary(const FixedTensor_& right, Op&& op) {
+      TA_ASSERT(! empty());
+      TA_ASSERT(lobound_ == right.lobound_);
+      for(size_type i = 0ul; i < volume; ++i)
+        op(data_[i], right.data_[i]);
+      return *this;
+    }
+
+    template <typename Op>
+    value_type reduce(Op&& op, value_type identity) const {
+      TA_ASSERT(! empty());
+      for(size_type i = 0ul; i < volume; ++i)
+        op(identity, data_[i]);
+      return identity;
+    }
+
+    /// <tt>c += alpha * op(a) * op(b)</tt> , of square matrices
+    template <bool TransA, bool TransB>
+    static void gemm_kernel(const value_type alpha,
+        const value_type* MADNESS_RESTRICT const a,
+        const value_type* MADNESS_RESTRICT const b,
+        value_type* MADNESS_RESTRICT const c)
+    {
+      constexpr size_type s = matrix_size;
+      for(size_type i = 0ul; i < s; ++i) {
+        value_type* MADNESS_RESTRICT const c_i = c + i * s;
+        for(size_type p = 0ul; p < s; ++p) {
+          const value_type a_ip = alpha * (TransA ? a[p * s + i] : a[i * s + p]);
+          for(size_type j = 0ul; j < s; ++j)
+            c_i[j] += a_ip * (TransB ? b[j * s + p] : b[p * s + j]);
+        }
+      }
+    }
+
+    /// Add <tt>alpha * op(left) * op(right)</tt> to the elements of this tile
+    void gemm_to(const FixedTensor_& left, const FixedTensor_& right,
+        const value_type alpha, const math::GemmHelper& gemm_helper)
+    {
+      static_assert(matrix_size != 0ul,
+          "FixedTensor::gemm requires a square matricization of the tile");
+      TA_ASSERT(! left.empty());
+      TA_ASSERT(! right.empty());
+      TA_ASSERT(gemm_helper.result_rank() == rank);
+      TA_ASSERT(gemm_helper.left_rank() == rank);
+      TA_ASSERT(gemm_helper.right_rank() == rank);
+#ifndef NDEBUG
+      // The result extents must equal the extents of this tile type
+      unsigned int d = 0u;
+      for(unsigned int i = gemm_helper.left_outer_begin(); i < gemm_helper.left_outer_end(); ++i, ++d)
+        TA_ASSERT(extent(i) == extent(d));
+      for(unsigned int i = gemm_helper.right_outer_begin(); i < gemm_helper.right_outer_end(); ++i, ++d)
+        TA_ASSERT(extent(i) == extent(d));
+      size_type m = 1ul;
+      for(unsigned int i = gemm_helper.left_outer_begin(); i < gemm_helper.left_outer_end(); ++i)
+        m *= extent(i);
+      TA_ASSERT(m == matrix_size);
+#endif // NDEBUG
+
+      const bool trans_a = (gemm_helper.left_op() != madness::cblas::NoTrans);
+      const bool trans_b = (gemm_helper.right_op() != madness::cblas::NoTrans);
+      const value_type* const a = left.data_.data();
+      const value_type* const b = right.data_.data();
+      if(trans_a) {
+        if(trans_b)
+          gemm_kernel<true, true>(alpha, a, b, data_.data());
+        else
+          gemm_kernel<true, false>(alpha, a, b, data_.data());
+      } else {
+        if(trans_b)
+          gemm_kernel<false, true>(alpha, a, b, data_.data());
+        else
+          gemm_kernel<false, false>(alpha, a, b, data_.data());
+      }
+    }
+
+  public:
+
+    /// Construct an empty tile
+    FixedTensor() = default;
+    FixedTensor(const FixedTensor_&) = default;
+    FixedTensor_& operator=(const FixedTensor_&) = default;
+
+    /// Construct an uninitialized tile
+
+    /// \param range The range of the tile, which must have the extents
+    /// \c Extents
+    explicit FixedTensor(const range_type& range) { set_lobound(range); }
+
+    /// Construct a tile filled with a value
+
+    /// \param range The range of the tile
+    /// \param value The value of the elements
+    FixedTensor(const range_type& range, const value_type value) {
+      set_lobound(range);
+      data_.fill(value);
+    }
+
+    /// Construct a tile from a sequence of elements
+
+    /// \param range The range of the tile
+    /// \param it An iterator to the first element
+    template <typename InIter,
+        typename std::enable_if<TiledArray::detail::is_input_iterator<InIter>::value>::type* = nullptr>
+    FixedTensor(const range_type& range, InIter it) {
+      set_lobound(range);
+      for(size_type i = 0ul; i < volume; ++i)
+        data_[i] = *it++;
+    }
+
+    /// Copy a dense tile
+
+    /// \param tensor A dense tile with the extents \c Extents
+    explicit FixedTensor(const Tensor<T>& tensor) {
+      if(! tensor.empty()) {
+        set_lobound(tensor.range());
+        std::copy(tensor.data(), tensor.data() + volume, data_.begin());
+      }
+    }
+
+    /// Dense tile conversion
+
+    /// \return A dense copy of this tile
+    explicit operator Tensor<T>() const {
+      return (empty() ? Tensor<T>() : Tensor<T>(range(), data_.data()));
+    }
+
+    /// Range accessor
+
+    /// \return The range of the tile
+    range_type range() const {
+      if(empty())
+        return range_type();
+      std::array<size_type, rank> upbound;
+      for(unsigned int i = 0u; i < rank; ++i)
+        upbound[i] = lobound_[i] + extent(i);
+      return range_type(lobound_, upbound);
+    }
+
+    /// \return The lower bound of the tile
+    const std::array<size_type, rank>& lobound() const { return lobound_; }
+
+    /// \return The number of elements of the tile
+    size_type size() const { return volume; }
+
+    /// \return \c true if the tile is not initialized
+    bool empty() const { return ! initialized_; }
+
+    const_pointer data() const { return data_.data(); }
+    pointer data() { return data_.data(); }
+    const_iterator begin() const { return data_.data(); }
+    iterator begin() { return data_.data(); }
+    const_iterator end() const { return data_.data() + volume; }
+    iterator end() { return data_.data() + volume; }
+
+    /// \param i The ordinal index of an element, relative to the lower bound
+    /// \return The element
+    const_reference operator[](const size_type i) const {
+      TA_ASSERT(i < volume);
+      return data_[i];
+    }
+
+    /// \param i The ordinal index of an element, relative to the lower bound
+    /// \return The element
+    reference operator[](const size_type i) {
+      TA_ASSERT(i < volume);
+      return data_[i];
+    }
+
+    /// \return A copy of this tile
+    FixedTensor_ clone() const { return *this; }
+
+    template <typename Archive>
+    void serialize(Archive& ar) {
+      ar & initialized_ & madness::archive::wrap(lobound_.data(), rank)
+         & madness::archive::wrap(data_.data(), volume);
+    }
+
+    // Permutation and shift ---------------------------------------------------
+
+    /// Permute this tile
+
+    /// \param perm The permutation, which must map the extents of the tile
+    /// to themselves
+    /// \return The permuted tile
+    FixedTensor_ permute(const Permutation& perm) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(perm.dim() == rank);
+
+      // The strides of the result, in the order of the dimensions of this tile
+      std::array<size_type, rank> stride;
+      FixedTensor_ result;
+      size_type result_stride = 1ul;
+      for(unsigned int d = rank; d > 0u; --d) {
+        TA_ASSERT(extent(perm[d - 1u]) == extent(d - 1u));
+        result.lobound_[perm[d - 1u]] = lobound_[d - 1u];
+      }
+      for(unsigned int d = rank; d > 0u; --d) {
+        for(unsigned int i = 0u; i < rank; ++i)
+          if(perm[i] == d - 1u)
+            stride[i] = result_stride;
+        result_stride *= extent(d - 1u);
+      }
+      result.initialized_ = true;
+
+      // Walk this tile in order, and scatter its elements to the result
+      std::array<size_type, rank> index;
+      index.fill(0ul);
+      size_type r = 0ul;
+      for(size_type i = 0ul; i < volume; ++i) {
+        result.data_[r] = data_[i];
+        for(unsigned int d = rank; d > 0u; --d) {
+          r += stride[d - 1u];
+          if(++index[d - 1u] < extent(d - 1u))
+            break;
+          r -= stride[d - 1u] * extent(d - 1u);
+          index[d - 1u] = 0ul;
+        }
+      }
+      return result;
+    }
+
+    /// \param bound_shift The shift of the lower and upper bounds
+    /// \return A copy of this tile with a shifted range
+    template <typename Index>
+    FixedTensor_ shift(const Index& bound_shift) const {
+      FixedTensor_ result(*this);
+      result.shift_to(bound_shift);
+      return result;
+    }
+
+    /// \param bound_shift The shift of the lower and upper bounds
+    /// \return A reference to this tile
+    template <typename Index>
+    FixedTensor_& shift_to(const Index& bound_shift) {
+      TA_ASSERT(! empty());
+      unsigned int i = 0u;
+      for(const auto shift_i : bound_shift)
+        lobound_[i++] += shift_i;
+      TA_ASSERT(i == rank);
+      return *this;
+    }
+
+    // Scaling -----------------------------------------------------------------
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_ scale(const Scalar factor) const {
+      return unary([factor] (const value_type x) -> value_type { return x * factor; });
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_ scale(const Scalar factor, const Permutation& perm) const {
+      return scale(factor).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_& scale_to(const Scalar factor) {
+      return inplace_unary([factor] (value_type& x) { x *= factor; });
+    }
+
+    FixedTensor_ neg() const {
+      return unary([] (const value_type x) { return -x; });
+    }
+    FixedTensor_ neg(const Permutation& perm) const { return neg().permute(perm); }
+    FixedTensor_& neg_to() {
+      return inplace_unary([] (value_type& x) { x = -x; });
+    }
+
+    // Addition and subtraction ------------------------------------------------
+
+    FixedTensor_ add(const FixedTensor_& right) const {
+      return binary(right, [] (const value_type l, const value_type r)
+          { return l + r; });
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_ add(const FixedTensor_& right, const Scalar factor) const {
+      return binary(right, [factor] (const value_type l, const value_type r)
+          -> value_type { return (l + r) * factor; });
+    }
+
+    FixedTensor_ add(const FixedTensor_& right, const Permutation& perm) const {
+      return add(right).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_ add(const FixedTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return add(right, factor).permute(perm);
+    }
+
+    /// Add a constant to the elements
+    FixedTensor_ add(const value_type value) const {
+      return unary([value] (const value_type x) { return x + value; });
+    }
+
+    FixedTensor_ add(const value_type value, const Permutation& perm) const {
+      return add(value).permute(perm);
+    }
+
+    FixedTensor_& add_to(const FixedTensor_& right) {
+      return inplace_binary(right, [] (value_type& l, const value_type r)
+          { l += r; });
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_& add_to(const FixedTensor_& right, const Scalar factor) {
+      return inplace_binary(right, [factor] (value_type& l, const value_type r)
+          { (l += r) *= factor; });
+    }
+
+    FixedTensor_& add_to(const value_type value) {
+      return inplace_unary([value] (value_type& x) { x += value; });
+    }
+
+    FixedTensor_ subt(const FixedTensor_& right) const {
+      return binary(right, [] (const value_type l, const value_type r)
+          { return l - r; });
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_ subt(const FixedTensor_& right, const Scalar factor) const {
+      return binary(right, [factor] (const value_type l, const value_type r)
+          -> value_type { return (l - r) * factor; });
+    }
+
+    FixedTensor_ subt(const FixedTensor_& right, const Permutation& perm) const {
+      return subt(right).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_ subt(const FixedTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return subt(right, factor).permute(perm);
+    }
+
+    /// Subtract a constant from the elements
+    FixedTensor_ subt(const value_type value) const { return add(-value); }
+
+    FixedTensor_ subt(const value_type value, const Permutation& perm) const {
+      return add(-value, perm);
+    }
+
+    FixedTensor_& subt_to(const FixedTensor_& right) {
+      return inplace_binary(right, [] (value_type& l, const value_type r)
+          { l -= r; });
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_& subt_to(const FixedTensor_& right, const Scalar factor) {
+      return inplace_binary(right, [factor] (value_type& l, const value_type r)
+          { (l -= r) *= factor; });
+    }
+
+    FixedTensor_& subt_to(const value_type value) { return add_to(-value); }
+
+    // Element-wise multiplication ---------------------------------------------
+
+    FixedTensor_ mult(const FixedTensor_& right) const {
+      return binary(right, [] (const value_type l, const value_type r)
+          { return l * r; });
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_ mult(const FixedTensor_& right, const Scalar factor) const {
+      return binary(right, [factor] (const value_type l, const value_type r)
+          -> value_type { return (l * r) * factor; });
+    }
+
+    FixedTensor_ mult(const FixedTensor_& right, const Permutation& perm) const {
+      return mult(right).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_ mult(const FixedTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return mult(right, factor).permute(perm);
+    }
+
+    FixedTensor_& mult_to(const FixedTensor_& right) {
+      return inplace_binary(right, [] (value_type& l, const value_type r)
+          { l *= r; });
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    FixedTensor_& mult_to(const FixedTensor_& right, const Scalar factor) {
+      return inplace_binary(right, [factor] (value_type& l, const value_type r)
+          { (l *= r) *= factor; });
+    }
+
+    // Contraction -------------------------------------------------------------
+
+    /// Contract this tile with \c other
+
+    /// \param other The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return <tt>factor * op(*this) * op(other)</tt>
+    template <typename Scalar>
+    FixedTensor_ gemm(const FixedTensor_& other, const Scalar factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      FixedTensor_ result;
+      unsigned int d = 0u;
+      for(unsigned int i = gemm_helper.left_outer_begin(); i < gemm_helper.left_outer_end(); ++i)
+        result.lobound_[d++] = lobound_[i];
+      for(unsigned int i = gemm_helper.right_outer_begin(); i < gemm_helper.right_outer_end(); ++i)
+        result.lobound_[d++] = other.lobound_[i];
+      result.initialized_ = true;
+      result.data_.fill(value_type(0));
+      result.gemm_to(*this, other, value_type(factor), gemm_helper);
+      return result;
+    }
+
+    /// Contract two tiles and add the result to this tile
+
+    /// \param left The left-hand tile
+    /// \param right The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return A reference to this tile
+    template <typename Scalar>
+    FixedTensor_& gemm(const FixedTensor_& left, const FixedTensor_& right,
+        const Scalar factor, const math::GemmHelper& gemm_helper)
+    {
+      if(empty())
+        return (*this = left.gemm(right, factor, gemm_helper));
+      gemm_to(left, right, value_type(factor), gemm_helper);
+      return *this;
+    }
+
+    // Reductions --------------------------------------------------------------
+
+    value_type sum() const {
+      return reduce([] (value_type& res, const value_type x) { res += x; },
+          value_type(0));
+    }
+
+    value_type product() const {
+      return reduce([] (value_type& res, const value_type x) { res *= x; },
+          value_type(1));
+    }
+
+    /// \return The sum of the hyper-diagonal elements
+    value_type trace() const {
+      TA_ASSERT(! empty());
+      size_type stride = 0ul, n = extent(0u);
+      for(unsigned int d = 0u; d < rank; ++d) {
+        stride = stride * extent(d) + 1ul;
+        n = std::min(n, extent(d));
+      }
+      value_type result(0);
+      for(size_type i = 0ul; i < n; ++i)
+        result += data_[i * stride];
+      return result;
+    }
+
+    scalar_type squared_norm() const {
+      TA_ASSERT(! empty());
+      scalar_type result(0);
+      for(size_type i = 0ul; i < volume; ++i)
+        result += detail::norm(data_[i]);
+      return result;
+    }
+
+    scalar_type norm() const { return std::sqrt(squared_norm()); }
+
+    scalar_type min() const {
+      TA_ASSERT(! empty());
+      return *std::min_element(data_.begin(), data_.end());
+    }
+
+    scalar_type max() const {
+      TA_ASSERT(! empty());
+      return *std::max_element(data_.begin(), data_.end());
+    }
+
+    scalar_type abs_min() const {
+      TA_ASSERT(! empty());
+      scalar_type result = std::abs(data_[0]);
+      for(size_type i = 1ul; i < volume; ++i)
+        result = std::min<scalar_type>(result, std::abs(data_[i]));
+      return result;
+    }
+
+    scalar_type abs_max() const {
+      TA_ASSERT(! empty());
+      scalar_type result = std::abs(data_[0]);
+      for(size_type i = 1ul; i < volume; ++i)
+        result = std::max<scalar_type>(result, std::abs(data_[i]));
+      return result;
+    }
+
+    /// \param other The other tile
+    /// \return The dot product of the elements of this tile and \c other
+    value_type dot(const FixedTensor_& other) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      value_type result(0);
+      for(size_type i = 0ul; i < volume; ++i)
+        result += data_[i] * other.data_[i];
+      return result;
+    }
+
+    numeric_type inner_product(const FixedTensor_& other) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      numeric_type result(0);
+      for(size_type i = 0ul; i < volume; ++i)
+        result += detail::inner_product(data_[i], other.data_[i]);
+      return result;
+    }
+
+    auto compensated_sum() const -> decltype(Tensor<T>().compensated_sum()) {
+      return Tensor<T>(*this).compensated_sum();
+    }
+
+    auto compensated_squared_norm() const ->
+        decltype(Tensor<T>().compensated_squared_norm())
+    {
+      return Tensor<T>(*this).compensated_squared_norm();
+    }
+
+    auto compensated_dot(const FixedTensor_& other) const ->
+        decltype(Tensor<T>().compensated_dot(Tensor<T>()))
+    {
+      return Tensor<T>(*this).compensated_dot(Tensor<T>(other));
+    }
+
+  }; // class FixedTensor
+
+  template <typename T, std::size_t... Extents>
+  constexpr unsigned int FixedTensor<T, Extents...>::rank;
+
+  template <typename T, std::size_t... Extents>
+  constexpr typename FixedTensor<T, Extents...>::size_type
+  FixedTensor<T, Extents...>::volume;
+
+  template <typename T, std::size_t... Extents>
+  constexpr typename FixedTensor<T, Extents...>::size_type
+  FixedTensor<T, Extents...>::matrix_size;
+
+  template <typename T, std::size_t... Extents>
+  inline std::ostream& operator<<(std::ostream& os,
+      const FixedTensor<T, Extents...>& tile)
+  {
+    os << Tensor<T>(tile);
+    return os;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_FIXED_TENSOR_H__INCLUDED
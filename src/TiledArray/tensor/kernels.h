@@ -307,9 +307,12 @@ namespace TiledArray {
       const auto stride = inner_size(result, tensors...);
       const auto volume = result.range().volume();
 
-      for(decltype(result.range().volume()) i = 0ul; i < volume; i += stride)
-        math::inplace_vector_op(op, stride, result.data() + result.range().ordinal(i),
-          (tensors.data() + tensors.range().ordinal(i))...);
+      RangeRuns<sizeof...(Ts) + 1> runs(stride, result.range(), tensors.range()...);
+      for(decltype(result.range().volume()) i = 0ul; i < volume; i += stride, runs.next())
+        runs.apply([&] (typename TR::pointer const result_data,
+            typename Ts::const_pointer const... tensors_data)
+            { math::inplace_vector_op(op, stride, result_data, tensors_data...); },
+            result.data(), tensors.data()...);
     }
 
     /// In-place tensor of tensors operations with non-contiguous data
@@ -340,9 +343,9 @@ namespace TiledArray {
               inplace_tensor_op(op, result_data[i], tensors_data[i]...);
           };
 
-      for(decltype(result.range().volume()) i = 0ul; i < volume; i += stride)
-        inplace_tensor_range(result.data() + result.range().ordinal(i),
-            (tensors.data() + tensors.range().ordinal(i))...);
+      RangeRuns<sizeof...(Ts) + 1> runs(stride, result.range(), tensors.range()...);
+      for(decltype(result.range().volume()) i = 0ul; i < volume; i += stride, runs.next())
+        runs.apply(inplace_tensor_range, result.data(), tensors.data()...);
     }
 
     // -------------------------------------------------------------------------
@@ -376,6 +379,37 @@ namespace TiledArray {
       math::vector_ptr_op(wrapper_op, volume, result.data(), tensors.data()...);
     }
 
+    /// Initialize tensor with contiguous tensor arguments and compute its norm
+
+    /// This function initializes the \c i -th element of \c result with the
+    /// result of \c op(tensors[i]...) , as \c tensor_init() , and computes
+    /// the squared Frobenius norm of \c result while it is written.
+    /// \pre The memory of \c result has been allocated but not initialized.
+    /// \tparam Op The element initialization operation type
+    /// \tparam TR The result tensor type
+    /// \tparam Ts The argument tensor types
+    /// \param[in] op The result tensor element initialization operation
+    /// \param[out] result The result tensor
+    /// \param[in] tensors The argument tensors
+    /// \return The squared norm of \c result
+    template <typename Op, typename TR, typename... Ts,
+        typename std::enable_if<is_tensor<TR, Ts...>::value
+               && is_contiguous_tensor<TR, Ts...>::value>::type* = nullptr>
+    inline typename scalar_type<typename TR::value_type>::type
+    tensor_init_norm(Op&& op, TR& result, const Ts&... tensors) {
+      TA_ASSERT(! empty(result, tensors...));
+      TA_ASSERT(is_range_set_congruent(result, tensors...));
+
+      const auto volume = result.range().volume();
+
+      auto wrapper_op = [=] (typename TR::pointer MADNESS_RESTRICT result,
+              typename Ts::const_reference MADNESS_RESTRICT... ts)
+          { new(result) typename TR::value_type(op(ts...)); };
+
+      return math::vector_ptr_op_norm(wrapper_op, volume, result.data(),
+          tensors.data()...);
+    }
+
     /// Initialize tensor of tensors with contiguous tensor arguments
 
     /// This function initializes the \c i -th element of \c result with the result of
@@ -503,10 +537,13 @@ namespace TiledArray {
               const typename Ts::value_type... values)
           { new(result_ptr) typename T1::value_type(op(value1, values...)); };
 
-      for(decltype(tensor1.range().volume()) i = 0ul; i < volume; i += stride)
-        math::vector_ptr_op(wrapper_op, stride, result.data() + i,
-            (tensor1.data() + tensor1.range().ordinal(i)),
-            (tensors.data() + tensors.range().ordinal(i))...);
+      RangeRuns<sizeof...(Ts) + 1> runs(stride, tensor1.range(), tensors.range()...);
+      for(decltype(tensor1.range().volume()) i = 0ul; i < volume; i += stride, runs.next())
+        runs.apply([&] (typename T1::const_pointer const tensor1_data,
+            typename Ts::const_pointer const... tensors_data)
+            { math::vector_ptr_op(wrapper_op, stride, result.data() + i,
+                tensor1_data, tensors_data...); },
+            tensor1.data(), tensors.data()...);
     }
 
     /// Initialize tensor with one or more non-contiguous tensor arguments
@@ -546,10 +583,12 @@ namespace TiledArray {
                       tensor1_data[i], tensors_data[i]...));
           };
 
-      for(decltype(volume) i = 0ul; i < volume; i += stride)
-        inplace_tensor_range(result.data() + i,
-            (tensor1.data() + tensor1.range().ordinal(i)),
-            (tensors.data() + tensors.range().ordinal(i))...);
+      RangeRuns<sizeof...(Ts) + 1> runs(stride, tensor1.range(), tensors.range()...);
+      for(decltype(volume) i = 0ul; i < volume; i += stride, runs.next())
+        runs.apply([&] (typename T1::const_pointer const tensor1_data,
+            typename Ts::const_pointer const... tensors_data)
+            { inplace_tensor_range(result.data() + i, tensor1_data, tensors_data...); },
+            tensor1.data(), tensors.data()...);
     }
 
 
@@ -661,11 +700,14 @@ namespace TiledArray {
       const auto volume = tensor1.range().volume();
 
       Scalar result = identity;
-      for(decltype(tensor1.range().volume()) i = 0ul; i < volume; i += stride) {
+      RangeRuns<sizeof...(Ts) + 1> runs(stride, tensor1.range(), tensors.range()...);
+      for(decltype(tensor1.range().volume()) i = 0ul; i < volume; i += stride, runs.next()) {
         Scalar temp = identity;
-        math::reduce_op(reduce_op,join_op, identity, stride, temp,
-            tensor1.data() + tensor1.range().ordinal(i),
-            (tensors.data() + tensors.range().ordinal(i))...);
+        runs.apply([&] (typename T1::const_pointer const tensor1_data,
+            typename Ts::const_pointer const... tensors_data)
+            { math::reduce_op(reduce_op, join_op, identity, stride, temp,
+                tensor1_data, tensors_data...); },
+            tensor1.data(), tensors.data()...);
         join_op(result, temp);
       }
 
@@ -716,16 +758,81 @@ namespace TiledArray {
           };
 
       Scalar result = identity;
-      for(decltype(tensor1.range().volume()) i = 0ul; i < volume; i += stride) {
-        Scalar temp = tensor_reduce_range(result,
-            tensor1.data() + tensor1.range().ordinal(i),
-            (tensors.data() + tensors.range().ordinal(i))...);
-        join_op(result, temp);
+      RangeRuns<sizeof...(Ts) + 1> runs(stride, tensor1.range(), tensors.range()...);
+      for(decltype(tensor1.range().volume()) i = 0ul; i < volume; i += stride, runs.next()) {
+        runs.apply([&] (typename T1::const_pointer const tensor1_data,
+            typename Ts::const_pointer const... tensors_data)
+            {
+              Scalar temp = tensor_reduce_range(result, tensor1_data, tensors_data...);
+              join_op(result, temp);
+            },
+            tensor1.data(), tensors.data()...);
       }
 
       return identity;
     }
 
+    /// Compensated reduction operation for contiguous tensors
+
+    /// Sum <tt>term_op(tensor1[i], tensors[i]...)</tt> for each \c i in the
+    /// index range of \c tensor1 with \c math::compensated_reduce_op , so
+    /// the rounding errors of the sum are carried in its correction term.
+    /// \tparam TermOp The element-wise term operation type
+    /// \tparam Scalar The scalar type of the sum
+    /// \tparam T1 The first argument tensor type
+    /// \tparam Ts The argument tensor types
+    /// \param term_op The element-wise term operation
+    /// \param result The sum to which the terms are added
+    /// \param tensor1 The first tensor to be reduced
+    /// \param tensors The other tensors to be reduced
+    template <typename TermOp, typename Scalar, typename T1, typename... Ts,
+        typename std::enable_if<is_tensor<T1, Ts...>::value
+            && is_contiguous_tensor<T1, Ts...>::value>::type* = nullptr>
+    void tensor_compensated_reduce(TermOp&& term_op,
+        math::CompensatedSum<Scalar>& result, const T1& tensor1,
+        const Ts&... tensors)
+    {
+      TA_ASSERT(! empty(tensor1, tensors...));
+      TA_ASSERT(is_range_set_congruent(tensor1, tensors...));
+
+      math::compensated_reduce_op(term_op, tensor1.range().volume(), result,
+          tensor1.data(), tensors.data()...);
+    }
+
+    /// Compensated reduction operation for non-contiguous tensors
+
+    /// Sum <tt>term_op(tensor1[i], tensors[i]...)</tt> for each \c i in the
+    /// index range of \c tensor1 , one contiguous block at a time.
+    /// \tparam TermOp The element-wise term operation type
+    /// \tparam Scalar The scalar type of the sum
+    /// \tparam T1 The first argument tensor type
+    /// \tparam Ts The argument tensor types
+    /// \param term_op The element-wise term operation
+    /// \param result The sum to which the terms are added
+    /// \param tensor1 The first tensor to be reduced
+    /// \param tensors The other tensors to be reduced
+    template <typename TermOp, typename Scalar, typename T1, typename... Ts,
+        typename std::enable_if<is_tensor<T1, Ts...>::value
+            && ! is_contiguous_tensor<T1, Ts...>::value>::type* = nullptr>
+    void tensor_compensated_reduce(TermOp&& term_op,
+        math::CompensatedSum<Scalar>& result, const T1& tensor1,
+        const Ts&... tensors)
+    {
+      TA_ASSERT(! empty(tensor1, tensors...));
+      TA_ASSERT(is_range_set_congruent(tensor1, tensors...));
+
+      const auto stride = inner_size(tensor1, tensors...);
+      const auto volume = tensor1.range().volume();
+
+      RangeRuns<sizeof...(Ts) + 1> runs(stride, tensor1.range(), tensors.range()...);
+      for(decltype(tensor1.range().volume()) i = 0ul; i < volume; i += stride, runs.next())
+        runs.apply([&] (typename T1::const_pointer const tensor1_data,
+            typename Ts::const_pointer const... tensors_data)
+            { math::compensated_reduce_op(term_op, stride, result,
+                tensor1_data, tensors_data...); },
+            tensor1.data(), tensors.data()...);
+    }
+
   }  // namespace detail
 } // namespace TiledArray
 
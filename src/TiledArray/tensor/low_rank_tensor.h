@@ -0,0 +1,678 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_LOW_RANK_TENSOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_LOW_RANK_TENSOR_H__INCLUDED
+
+#include <TiledArray/tensor/tensor.h>
+#include <TiledArray/math/eigen.h>
+#include <TiledArray/math/gemm_helper.h>
+#include <Eigen/SVD>
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <utility>
+
+namespace TiledArray {
+
+  /// Low-rank matrix tile
+
+  /// Stores a matrix tile \f$ A \f$ as the product of two factors,
+  /// \f$ A = U V^T \f$ , where \f$ U \f$ is \f$ m \times r \f$ and \f$ V \f$
+  /// is \f$ n \times r \f$ , when that is cheaper than the dense tile, i.e.
+  /// when <tt>r * (m + n) < m * n</tt> ; otherwise the tile is stored as a
+  /// dense \c Tensor . The rank is chosen adaptively with a truncated SVD,
+  /// which drops the singular values that are smaller than \c tolerance()
+  /// times the largest one. This tile type implements the intrusive tile
+  /// interface, so it can be used as the tile of a \c DistArray , e.g. for
+  /// off-diagonal integral and amplitude blocks that are numerically
+  /// low-rank:
+  /// \li \c gemm multiplies the factors, e.g.
+  ///     \f$ U_a (V_a^T U_b) V_b^T \f$ , without forming a dense tile;
+  /// \li \c add and \c subt concatenate the factors and recompress them
+  ///     with QR decompositions of the factors and an SVD of the small core;
+  /// \li \c scale , \c neg , \c permute (transpose), \c sum , \c norm , and
+  ///     \c dot operate on the factors;
+  /// \li the remaining operations are evaluated with the dense tile.
+  /// Results that involve a dense tile are dense.
+  /// \tparam T The element type
+  template <typename T>
+  class LowRankTensor {
+  public:
+    typedef LowRankTensor<T> LowRankTensor_; ///< This object type
+    typedef Tensor<T> tensor_type; ///< The dense tensor type
+    typedef typename tensor_type::range_type range_type; ///< Tensor range type
+    typedef typename tensor_type::size_type size_type; ///< Size type
+    typedef T value_type; ///< Element type
+    typedef typename tensor_type::numeric_type numeric_type; ///< Numeric type
+    typedef typename tensor_type::scalar_type scalar_type; ///< Scalar type
+
+  private:
+
+    typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> matrix_type;
+    typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+        row_matrix_type;
+
+    range_type range_; ///< The range of the tile
+    tensor_type dense_; ///< The dense tile, if the tile is not low-rank
+    tensor_type u_; ///< The left factor, m x r
+    tensor_type v_; ///< The right factor, n x r
+    size_type rank_ = 0ul; ///< The rank of the factors
+
+    size_type rows() const { return range_.extent(0); }
+    size_type cols() const { return range_.extent(1); }
+
+    static Eigen::Map<const row_matrix_type>
+    map(const tensor_type& tensor, const size_type m, const size_type n) {
+      return Eigen::Map<const row_matrix_type>(tensor.data(), m, n);
+    }
+
+    static tensor_type make_tensor(const matrix_type& matrix) {
+      tensor_type result(range_type(matrix.rows(), matrix.cols()));
+      Eigen::Map<row_matrix_type>(result.data(), matrix.rows(),
+          matrix.cols()) = matrix;
+      return result;
+    }
+
+    /// The rank of a truncated singular value decomposition
+    template <typename SingularValues>
+    static size_type truncated_rank(const SingularValues& s) {
+      if((s.size() == 0) || (s[0] == scalar_type(0)))
+        return 0ul;
+      const scalar_type threshold = tolerance() * s[0];
+      size_type r = 0ul;
+      while((r < size_type(s.size())) && (s[r] > threshold))
+        ++r;
+      return r;
+    }
+
+    /// Construct a low-rank tile from its factors
+    LowRankTensor(const range_type& range, const matrix_type& u,
+        const matrix_type& v) :
+      range_(range), dense_(), u_(), v_(), rank_(u.cols())
+    {
+      TA_ASSERT(u.cols() == v.cols());
+      if(rank_) {
+        u_ = make_tensor(u);
+        v_ = make_tensor(v);
+      }
+    }
+
+    /// Construct a dense tile
+    LowRankTensor(const range_type& range, const tensor_type& dense, int) :
+      range_(range), dense_(dense), u_(), v_(), rank_(0ul)
+    { }
+
+    /// Compress a dense matrix
+
+    /// \return The low-rank tile, or the dense tile when it is cheaper
+    static LowRankTensor_ compress(const range_type& range, const matrix_type& a) {
+      const size_type m = a.rows(), n = a.cols();
+      Eigen::JacobiSVD<matrix_type> svd(a, Eigen::ComputeThinU | Eigen::ComputeThinV);
+      const size_type r = truncated_rank(svd.singularValues());
+      if(r * (m + n) >= m * n)
+        return LowRankTensor_(range, make_tensor(a), 0);
+      return LowRankTensor_(range,
+          svd.matrixU().leftCols(r) * svd.singularValues().head(r).
+          template cast<T>().asDiagonal(), svd.matrixV().leftCols(r));
+    }
+
+    /// Recompress a pair of factors
+
+    /// The factors are orthogonalized with QR decompositions,
+    /// \f$ U = Q_u R_u \f$ and \f$ V = Q_v R_v \f$ , and the core
+    /// \f$ R_u R_v^T \f$ is truncated with an SVD.
+    /// \return The recompressed low-rank tile, or the dense tile when it is
+    /// cheaper
+    static LowRankTensor_ recompress(const range_type& range,
+        const matrix_type& u, const matrix_type& v)
+    {
+      const size_type m = u.rows(), n = v.rows(), r = u.cols();
+      if(r == 0ul)
+        return LowRankTensor_(range, u, v);
+
+      Eigen::HouseholderQR<matrix_type> qr_u(u), qr_v(v);
+      const size_type ku = std::min(m, r), kv = std::min(n, r);
+      const matrix_type q_u = qr_u.householderQ() * matrix_type::Identity(m, ku);
+      const matrix_type q_v = qr_v.householderQ() * matrix_type::Identity(n, kv);
+      const matrix_type r_u = qr_u.matrixQR().topRows(ku).
+          template triangularView<Eigen::Upper>();
+      const matrix_type r_v = qr_v.matrixQR().topRows(kv).
+          template triangularView<Eigen::Upper>();
+
+      Eigen::JacobiSVD<matrix_type> svd(r_u * r_v.transpose(),
+          Eigen::ComputeThinU | Eigen::ComputeThinV);
+      const size_type k = truncated_rank(svd.singularValues());
+      const matrix_type u_k = q_u * svd.matrixU().leftCols(k) *
+          svd.singularValues().head(k).template cast<T>().asDiagonal();
+      const matrix_type v_k = q_v * svd.matrixV().leftCols(k);
+      if(k * (m + n) >= m * n)
+        return LowRankTensor_(range, make_tensor(u_k * v_k.transpose()), 0);
+      return LowRankTensor_(range, u_k, v_k);
+    }
+
+    /// The (possibly transposed) factors of this tile
+    std::pair<matrix_type, matrix_type>
+    factors(const madness::cblas::CBLAS_TRANSPOSE op) const {
+      if(op == madness::cblas::NoTrans)
+        return std::make_pair(u(), v());
+      return std::make_pair(v(), u());
+    }
+
+    /// The (possibly transposed) dense matrix of this tile
+    matrix_type matrix(const madness::cblas::CBLAS_TRANSPOSE op) const {
+      if(op == madness::cblas::NoTrans)
+        return matrix();
+      return matrix().transpose();
+    }
+
+    /// Linear combination of two tiles
+
+    /// \return <tt>lf * (*this) + rf * right</tt>
+    LowRankTensor_ combine(const LowRankTensor_& right, const T lf, const T rf) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! right.empty());
+      TA_ASSERT(range_ == right.range_);
+      if(is_dense() || right.is_dense()) {
+        const matrix_type a = lf * matrix() + rf * right.matrix();
+        return LowRankTensor_(range_, make_tensor(a), 0);
+      }
+
+      matrix_type u_lr(rows(), rank_ + right.rank_), v_lr(cols(), rank_ + right.rank_);
+      u_lr << lf * u(), rf * right.u();
+      v_lr << v(), right.v();
+      return recompress(range_, u_lr, v_lr);
+    }
+
+  public:
+
+    /// Truncation tolerance accessor
+
+    /// The singular values that are smaller than the tolerance times the
+    /// largest singular value of a tile are dropped. The default is 1e-8.
+    /// \return A reference to the relative truncation tolerance
+    static scalar_type& tolerance() {
+      static scalar_type tolerance = 1.0e-8;
+      return tolerance;
+    }
+
+    LowRankTensor() : range_(), dense_(), u_(), v_(), rank_(0ul) { }
+    LowRankTensor(const LowRankTensor_&) = default;
+    LowRankTensor(LowRankTensor_&&) = default;
+    LowRankTensor_& operator=(const LowRankTensor_&) = default;
+    LowRankTensor_& operator=(LowRankTensor_&&) = default;
+
+    /// Construct a zero tile
+
+    /// \param range The range of the tile
+    explicit LowRankTensor(const range_type& range) :
+      range_(range), dense_(), u_(), v_(), rank_(0ul)
+    { TA_ASSERT(range.rank() == 2u); }
+
+    /// Construct a tile filled with a value
+
+    /// \param range The range of the tile
+    /// \param value The value of the elements
+    LowRankTensor(const range_type& range, const value_type value) :
+      range_(range), dense_(), u_(), v_(), rank_(0ul)
+    {
+      TA_ASSERT(range.rank() == 2u);
+      if(value != value_type(0)) {
+        // A constant matrix is value * 1 * 1^T
+        *this = LowRankTensor_(range,
+            matrix_type::Constant(rows(), 1, value),
+            matrix_type::Constant(cols(), 1, value_type(1)));
+      }
+    }
+
+    /// Compress a dense tile
+
+    /// \param tensor A matrix tile
+    explicit LowRankTensor(const tensor_type& tensor) :
+      LowRankTensor()
+    {
+      if(! tensor.empty()) {
+        TA_ASSERT(tensor.range().rank() == 2u);
+        *this = compress(tensor.range(), map(tensor, tensor.range().extent(0),
+            tensor.range().extent(1)));
+      }
+    }
+
+    /// Dense tile conversion
+
+    /// \return The dense tile
+    explicit operator tensor_type() const { return to_dense(); }
+
+    /// Range accessor
+
+    /// \return The range of the tile
+    const range_type& range() const { return range_; }
+
+    /// \return The number of elements of the tile
+    size_type size() const { return range_.volume(); }
+
+    /// \return \c true if the tile is not initialized
+    bool empty() const { return range_.rank() == 0u; }
+
+    /// \return \c true if the tile is stored as a dense tensor
+    bool is_dense() const { return ! dense_.empty(); }
+
+    /// Rank accessor
+
+    /// \return The rank of the factors, or the smaller dimension of a dense
+    /// tile
+    size_type rank() const {
+      return (is_dense() ? std::min(rows(), cols()) : rank_);
+    }
+
+    /// \return The left factor, an <tt>m x r</tt> matrix
+    matrix_type u() const {
+      TA_ASSERT(! is_dense());
+      return (rank_ ? matrix_type(map(u_, rows(), rank_)) : matrix_type(rows(), 0));
+    }
+
+    /// \return The right factor, an <tt>n x r</tt> matrix
+    matrix_type v() const {
+      TA_ASSERT(! is_dense());
+      return (rank_ ? matrix_type(map(v_, cols(), rank_)) : matrix_type(cols(), 0));
+    }
+
+    /// \return The dense matrix of the tile
+    matrix_type matrix() const {
+      if(is_dense())
+        return map(dense_, rows(), cols());
+      if(rank_ == 0ul)
+        return matrix_type::Zero(rows(), cols());
+      return u() * v().transpose();
+    }
+
+    /// \return The dense tile
+    tensor_type to_dense() const {
+      if(empty())
+        return tensor_type();
+      if(is_dense())
+        return dense_;
+      tensor_type result(range_);
+      Eigen::Map<row_matrix_type>(result.data(), rows(), cols()) = matrix();
+      return result;
+    }
+
+    /// \return A deep copy of this tile
+    LowRankTensor_ clone() const {
+      LowRankTensor_ result(*this);
+      result.dense_ = dense_.clone();
+      result.u_ = u_.clone();
+      result.v_ = v_.clone();
+      return result;
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar) { ar & range_ & dense_ & u_ & v_ & rank_; }
+
+    // Permutation and shift ---------------------------------------------------
+
+    /// Permute (transpose) this tile
+
+    /// \param perm The permutation, of rank 2
+    /// \return The permuted tile
+    LowRankTensor_ permute(const Permutation& perm) const {
+      TA_ASSERT(perm.dim() == 2u);
+      if(perm[0] == 0u)
+        return *this;
+      LowRankTensor_ result(*this);
+      result.range_ = perm * range_;
+      if(is_dense()) {
+        result.dense_ = dense_.permute(perm);
+      } else {
+        result.u_ = v_;
+        result.v_ = u_;
+      }
+      return result;
+    }
+
+    /// \param bound_shift The shift of the lower and upper bounds
+    /// \return A copy of this tile with a shifted range
+    template <typename Index>
+    LowRankTensor_ shift(const Index& bound_shift) const {
+      LowRankTensor_ result(*this);
+      result.shift_to(bound_shift);
+      return result;
+    }
+
+    /// \param bound_shift The shift of the lower and upper bounds
+    /// \return A reference to this tile
+    template <typename Index>
+    LowRankTensor_& shift_to(const Index& bound_shift) {
+      range_.inplace_shift(bound_shift);
+      if(is_dense())
+        dense_ = dense_.shift(bound_shift);
+      return *this;
+    }
+
+    // Scaling -----------------------------------------------------------------
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ scale(const Scalar factor) const {
+      LowRankTensor_ result(*this);
+      if(is_dense())
+        result.dense_ = dense_.scale(factor);
+      else if(rank_)
+        result.u_ = u_.scale(factor);
+      return result;
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ scale(const Scalar factor, const Permutation& perm) const {
+      return scale(factor).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_& scale_to(const Scalar factor) {
+      return (*this = scale(factor));
+    }
+
+    LowRankTensor_ neg() const { return scale(value_type(-1)); }
+    LowRankTensor_ neg(const Permutation& perm) const {
+      return scale(value_type(-1), perm);
+    }
+    LowRankTensor_& neg_to() { return scale_to(value_type(-1)); }
+
+    // Addition and subtraction ------------------------------------------------
+
+    LowRankTensor_ add(const LowRankTensor_& right) const {
+      return combine(right, value_type(1), value_type(1));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ add(const LowRankTensor_& right, const Scalar factor) const {
+      return combine(right, value_type(factor), value_type(factor));
+    }
+
+    LowRankTensor_ add(const LowRankTensor_& right, const Permutation& perm) const {
+      return add(right).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ add(const LowRankTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return add(right, factor).permute(perm);
+    }
+
+    /// Add a constant to the elements
+    LowRankTensor_ add(const value_type value) const {
+      return add(LowRankTensor_(range_, value));
+    }
+
+    LowRankTensor_ add(const value_type value, const Permutation& perm) const {
+      return add(value).permute(perm);
+    }
+
+    LowRankTensor_& add_to(const LowRankTensor_& right) {
+      return (*this = add(right));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_& add_to(const LowRankTensor_& right, const Scalar factor) {
+      return (*this = add(right, factor));
+    }
+
+    LowRankTensor_& add_to(const value_type value) {
+      return (*this = add(value));
+    }
+
+    LowRankTensor_ subt(const LowRankTensor_& right) const {
+      return combine(right, value_type(1), value_type(-1));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ subt(const LowRankTensor_& right, const Scalar factor) const {
+      return combine(right, value_type(factor), value_type(-factor));
+    }
+
+    LowRankTensor_ subt(const LowRankTensor_& right, const Permutation& perm) const {
+      return subt(right).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ subt(const LowRankTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return subt(right, factor).permute(perm);
+    }
+
+    /// Subtract a constant from the elements
+    LowRankTensor_ subt(const value_type value) const { return add(-value); }
+
+    LowRankTensor_ subt(const value_type value, const Permutation& perm) const {
+      return add(-value, perm);
+    }
+
+    LowRankTensor_& subt_to(const LowRankTensor_& right) {
+      return (*this = subt(right));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_& subt_to(const LowRankTensor_& right, const Scalar factor) {
+      return (*this = subt(right, factor));
+    }
+
+    LowRankTensor_& subt_to(const value_type value) { return add_to(-value); }
+
+    // Element-wise multiplication ---------------------------------------------
+
+    /// Element-wise product, which is compressed from the dense product
+    LowRankTensor_ mult(const LowRankTensor_& right) const {
+      TA_ASSERT(range_ == right.range_);
+      return compress(range_, matrix().cwiseProduct(right.matrix()));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ mult(const LowRankTensor_& right, const Scalar factor) const {
+      return mult(right).scale(factor);
+    }
+
+    LowRankTensor_ mult(const LowRankTensor_& right, const Permutation& perm) const {
+      return mult(right).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ mult(const LowRankTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return mult(right, factor).permute(perm);
+    }
+
+    LowRankTensor_& mult_to(const LowRankTensor_& right) {
+      return (*this = mult(right));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_& mult_to(const LowRankTensor_& right, const Scalar factor) {
+      return (*this = mult(right, factor));
+    }
+
+    // Contraction -------------------------------------------------------------
+
+    /// Contract this tile with \c other
+
+    /// Low-rank factors are multiplied without forming a dense tile; the
+    /// product has the smaller of the ranks of the arguments.
+    /// \param other The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data, of matrices
+    /// \return <tt>factor * op(*this) * op(other)</tt>
+    template <typename Scalar>
+    LowRankTensor_ gemm(const LowRankTensor_& other, const Scalar factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(gemm_helper.left_rank() == 2u);
+      TA_ASSERT(gemm_helper.right_rank() == 2u);
+      TA_ASSERT(gemm_helper.result_rank() == 2u);
+
+      const range_type range =
+          gemm_helper.make_result_range<range_type>(range_, other.range_);
+      const value_type alpha(factor);
+
+      if(is_dense() && other.is_dense()) {
+        const matrix_type c = alpha * (matrix(gemm_helper.left_op()) *
+            other.matrix(gemm_helper.right_op()));
+        return LowRankTensor_(range, make_tensor(c), 0);
+      }
+
+      if(is_dense()) {
+        // A Ub Vb^T
+        const auto b = other.factors(gemm_helper.right_op());
+        return LowRankTensor_(range,
+            alpha * (matrix(gemm_helper.left_op()) * b.first), b.second);
+      }
+
+      const auto a = factors(gemm_helper.left_op());
+      if(other.is_dense()) {
+        // Ua (B^T Va)^T
+        return LowRankTensor_(range, alpha * a.first,
+            other.matrix(gemm_helper.right_op()).transpose() * a.second);
+      }
+
+      // Ua (Va^T Ub) Vb^T
+      const auto b = other.factors(gemm_helper.right_op());
+      const matrix_type core = a.second.transpose() * b.first;
+      if(a.first.cols() <= b.first.cols())
+        return LowRankTensor_(range, alpha * a.first,
+            b.second * core.transpose());
+      return LowRankTensor_(range, alpha * (a.first * core), b.second);
+    }
+
+    /// Contract two tiles and add the result to this tile
+
+    /// \param left The left-hand tile
+    /// \param right The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data, of matrices
+    /// \return A reference to this tile
+    template <typename Scalar>
+    LowRankTensor_& gemm(const LowRankTensor_& left, const LowRankTensor_& right,
+        const Scalar factor, const math::GemmHelper& gemm_helper)
+    {
+      const LowRankTensor_ product = left.gemm(right, factor, gemm_helper);
+      if(empty())
+        *this = product;
+      else
+        add_to(product);
+      return *this;
+    }
+
+    // Reductions --------------------------------------------------------------
+
+    /// \return The sum of the elements, <tt>(1^T U) (V^T 1)</tt>
+    value_type sum() const {
+      if(is_dense())
+        return dense_.sum();
+      if(rank_ == 0ul)
+        return value_type(0);
+      return u().colwise().sum().dot(v().colwise().sum());
+    }
+
+    /// \return The squared Frobenius norm, <tt>tr((U^T U) (V^T V))</tt>
+    scalar_type squared_norm() const {
+      if(is_dense())
+        return dense_.squared_norm();
+      if(rank_ == 0ul)
+        return scalar_type(0);
+      const matrix_type uu = u().transpose() * u();
+      const matrix_type vv = v().transpose() * v();
+      return std::abs(uu.cwiseProduct(vv).sum());
+    }
+
+    /// \return The Frobenius norm
+    scalar_type norm() const { return std::sqrt(squared_norm()); }
+
+    /// \param other The other tile
+    /// \return The dot product of the elements of this tile and \c other
+    value_type dot(const LowRankTensor_& other) const {
+      TA_ASSERT(range_ == other.range_);
+      if(is_dense() && other.is_dense())
+        return dense_.dot(other.dense_);
+      if(is_dense())
+        return other.dot(*this);
+      if(rank_ == 0ul)
+        return value_type(0);
+      if(other.is_dense())
+        return (other.matrix() * v()).cwiseProduct(u()).sum();
+      if(other.rank_ == 0ul)
+        return value_type(0);
+      const matrix_type uu = u().transpose() * other.u();
+      const matrix_type vv = v().transpose() * other.v();
+      return uu.cwiseProduct(vv).sum();
+    }
+
+    value_type inner_product(const LowRankTensor_& other) const {
+      return to_dense().inner_product(other.to_dense());
+    }
+
+    value_type trace() const { return matrix().trace(); }
+    value_type product() const { return to_dense().product(); }
+    scalar_type min() const { return to_dense().min(); }
+    scalar_type max() const { return to_dense().max(); }
+    scalar_type abs_min() const { return to_dense().abs_min(); }
+    scalar_type abs_max() const { return to_dense().abs_max(); }
+
+    auto compensated_sum() const -> decltype(tensor_type().compensated_sum()) {
+      return to_dense().compensated_sum();
+    }
+
+    auto compensated_squared_norm() const ->
+        decltype(tensor_type().compensated_squared_norm())
+    {
+      return to_dense().compensated_squared_norm();
+    }
+
+    auto compensated_dot(const LowRankTensor_& other) const ->
+        decltype(tensor_type().compensated_dot(tensor_type()))
+    {
+      return to_dense().compensated_dot(other.to_dense());
+    }
+
+  }; // class LowRankTensor
+
+  template <typename T>
+  inline std::ostream& operator<<(std::ostream& os, const LowRankTensor<T>& tile) {
+    if(! tile.empty() && ! tile.is_dense())
+      os << "rank " << tile.rank() << ": ";
+    os << tile.to_dense();
+    return os;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_LOW_RANK_TENSOR_H__INCLUDED
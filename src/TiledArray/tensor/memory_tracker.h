@@ -0,0 +1,272 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  memory_tracker.h
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_MEMORY_TRACKER_H__INCLUDED
+#define TILEDARRAY_TENSOR_MEMORY_TRACKER_H__INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+#include <TiledArray/madness.h>
+
+namespace TiledArray {
+
+  /// Tensor memory statistics of a process
+  struct MemoryStatistics {
+    std::size_t live_bytes; ///< The number of bytes of live tensor data
+    std::size_t peak_bytes; ///< The high-water mark of \c live_bytes (in the innermost \c MemoryScope , if any)
+    std::size_t live_allocations; ///< The number of live tensor data buffers
+    std::size_t allocations; ///< The total number of tensor data allocations
+    std::size_t eval_peak_bytes; ///< The high-water mark of \c live_bytes during the last expression evaluation
+  }; // struct MemoryStatistics
+
+  /// Memory of the local tiles of an array
+  struct ArrayMemoryUsage {
+    std::size_t bytes; ///< The number of bytes of the data of the local tiles
+    std::size_t tiles; ///< The number of local tiles that are assigned
+    std::size_t pending; ///< The number of local, non-zero tiles that are not assigned yet
+  }; // struct ArrayMemoryUsage
+
+  namespace detail {
+
+    /// Accounting of the tensor data of a process
+
+    /// \c Tensor records the allocation and the release of its data here,
+    /// independent of its allocator. The high-water mark may be scoped (see
+    /// \c MemoryScope ), e.g. to the evaluation of an expression.
+    class MemoryTracker {
+      std::atomic<std::size_t> live_bytes_; ///< Bytes of live data
+      std::atomic<std::size_t> peak_bytes_; ///< High-water mark of the current scope
+      std::atomic<std::size_t> live_allocations_; ///< Number of live buffers
+      std::atomic<std::size_t> allocations_; ///< Total number of allocations
+      std::atomic<std::size_t> eval_peak_bytes_; ///< High-water mark of the last evaluation
+
+      MemoryTracker() :
+        live_bytes_(0ul), peak_bytes_(0ul), live_allocations_(0ul),
+        allocations_(0ul), eval_peak_bytes_(0ul)
+      { }
+
+      /// Raise \c peak_bytes_ to \c bytes
+      void raise_peak(const std::size_t bytes) {
+        std::size_t peak = peak_bytes_.load(std::memory_order_relaxed);
+        while((peak < bytes) && ! peak_bytes_.compare_exchange_weak(peak,
+            bytes, std::memory_order_relaxed))
+        { }
+      }
+
+    public:
+
+      MemoryTracker(const MemoryTracker&) = delete;
+      MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+      /// The tracker of this process
+      static MemoryTracker& instance() {
+        static MemoryTracker tracker;
+        return tracker;
+      }
+
+      /// Record an allocation
+
+      /// \param bytes The size of the allocated buffer
+      void allocate(const std::size_t bytes) {
+        const std::size_t live =
+            live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        live_allocations_.fetch_add(1ul, std::memory_order_relaxed);
+        allocations_.fetch_add(1ul, std::memory_order_relaxed);
+        raise_peak(live);
+      }
+
+      /// Record a deallocation
+
+      /// \param bytes The size of the released buffer
+      void deallocate(const std::size_t bytes) {
+        live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+        live_allocations_.fetch_sub(1ul, std::memory_order_relaxed);
+      }
+
+      /// Live data accessor
+
+      /// \return The number of bytes of live tensor data
+      std::size_t live_bytes() const {
+        return live_bytes_.load(std::memory_order_relaxed);
+      }
+
+      /// Begin a high-water mark scope
+
+      /// \return The high-water mark of the enclosing scope, which must be
+      /// passed to \c end_scope()
+      std::size_t begin_scope() {
+        return peak_bytes_.exchange(live_bytes(), std::memory_order_relaxed);
+      }
+
+      /// End a high-water mark scope
+
+      /// \param outer_peak The value returned by \c begin_scope()
+      /// \return The high-water mark of the ending scope
+      std::size_t end_scope(const std::size_t outer_peak) {
+        const std::size_t peak = peak_bytes_.load(std::memory_order_relaxed);
+        raise_peak(outer_peak);
+        return peak;
+      }
+
+      /// High-water mark accessor
+
+      /// \return The high-water mark of the innermost scope
+      std::size_t peak_bytes() const {
+        return peak_bytes_.load(std::memory_order_relaxed);
+      }
+
+      /// Record the high-water mark of an expression evaluation
+      void eval_peak_bytes(const std::size_t bytes) {
+        eval_peak_bytes_.store(bytes, std::memory_order_relaxed);
+      }
+
+      /// Statistics accessor
+
+      /// \return The memory statistics of this process
+      MemoryStatistics statistics() const {
+        return MemoryStatistics{ live_bytes(), peak_bytes(),
+            live_allocations_.load(std::memory_order_relaxed),
+            allocations_.load(std::memory_order_relaxed),
+            eval_peak_bytes_.load(std::memory_order_relaxed) };
+      }
+
+      /// Reset the high-water mark of the innermost scope to the live bytes
+      void reset_peak() {
+        peak_bytes_.store(live_bytes(), std::memory_order_relaxed);
+      }
+
+    }; // class MemoryTracker
+
+  } // namespace detail
+
+  /// Scoped high-water mark of tensor memory
+
+  /// While the scope exists, the peak memory of the process is measured
+  /// from the live memory at its construction; when it ends, the peak of the
+  /// enclosing scope includes the peak of this scope. Scopes must be
+  /// strictly nested, e.g. constructed by the main thread.
+  class MemoryScope {
+    std::size_t baseline_bytes_; ///< The live bytes at the beginning of the scope
+    std::size_t outer_peak_; ///< The high-water mark of the enclosing scope
+    std::size_t peak_bytes_; ///< The high-water mark of this scope, once it ended
+    bool active_; ///< The scope has not ended
+
+  public:
+
+    MemoryScope() :
+      baseline_bytes_(detail::MemoryTracker::instance().live_bytes()),
+      outer_peak_(detail::MemoryTracker::instance().begin_scope()),
+      peak_bytes_(0ul), active_(true)
+    { }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+    ~MemoryScope() { end(); }
+
+    /// End the scope
+
+    /// \return The high-water mark of this scope, in bytes
+    std::size_t end() {
+      if(active_) {
+        peak_bytes_ = detail::MemoryTracker::instance().end_scope(outer_peak_);
+        active_ = false;
+      }
+      return peak_bytes_;
+    }
+
+    /// Baseline accessor
+
+    /// \return The live bytes when the scope began
+    std::size_t baseline_bytes() const { return baseline_bytes_; }
+
+    /// High-water mark accessor
+
+    /// \return The high-water mark of the live bytes of this process during
+    /// this scope, so far
+    std::size_t peak_bytes() const {
+      return (active_ ? detail::MemoryTracker::instance().peak_bytes() :
+          peak_bytes_);
+    }
+
+  }; // class MemoryScope
+
+  /// Tensor memory statistics of this process
+
+  /// \return The memory statistics of the tensor data of this process
+  inline MemoryStatistics memory_statistics() {
+    return detail::MemoryTracker::instance().statistics();
+  }
+
+  /// Reset the high-water mark of the tensor memory of this process
+  inline void reset_memory_peak() {
+    detail::MemoryTracker::instance().reset_peak();
+  }
+
+  /// Print the tensor memory statistics of all processes
+
+  /// The statistics of each process, and their totals, are printed by
+  /// process 0.
+  /// \param world The world of the processes
+  /// \param os The output stream
+  /// \note This function is collective.
+  inline void memory_report(World& world, std::ostream& os) {
+    constexpr std::size_t fields = 5ul;
+    const MemoryStatistics stats = memory_statistics();
+    std::vector<double> data(fields * world.size(), 0.0);
+    double* const local = data.data() + fields * world.rank();
+    local[0] = double(stats.live_bytes);
+    local[1] = double(stats.peak_bytes);
+    local[2] = double(stats.eval_peak_bytes);
+    local[3] = double(stats.live_allocations);
+    local[4] = double(stats.allocations);
+    world.gop.sum(data.data(), data.size());
+
+    if(world.rank() == 0) {
+      constexpr double mib = 1024.0 * 1024.0;
+      std::vector<double> total(fields, 0.0);
+      os << "TiledArray tensor memory (MiB):\n"
+         << std::setw(8) << "rank" << std::setw(14) << "live"
+         << std::setw(14) << "peak" << std::setw(14) << "eval peak"
+         << std::setw(14) << "buffers" << std::setw(14) << "allocations" << "\n";
+      os << std::fixed << std::setprecision(2);
+      for(ProcessID p = 0; p < world.size(); ++p) {
+        const double* const row = data.data() + fields * p;
+        os << std::setw(8) << p << std::setw(14) << row[0] / mib
+           << std::setw(14) << row[1] / mib << std::setw(14) << row[2] / mib
+           << std::setw(14) << std::size_t(row[3])
+           << std::setw(14) << std::size_t(row[4]) << "\n";
+        for(std::size_t f = 0ul; f < fields; ++f)
+          total[f] += row[f];
+      }
+      os << std::setw(8) << "total" << std::setw(14) << total[0] / mib
+         << std::setw(14) << total[1] / mib << std::setw(14) << total[2] / mib
+         << std::setw(14) << std::size_t(total[3])
+         << std::setw(14) << std::size_t(total[4]) << std::endl;
+    }
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_MEMORY_TRACKER_H__INCLUDED
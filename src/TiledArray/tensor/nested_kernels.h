@@ -0,0 +1,411 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  nested_kernels.h
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_NESTED_KERNELS_H__INCLUDED
+#define TILEDARRAY_TENSOR_NESTED_KERNELS_H__INCLUDED
+
+#include <TiledArray/math/blas.h>
+#include <TiledArray/math/eigen.h>
+#include <TiledArray/math/gemm_helper.h>
+#include <TiledArray/math/vector_op.h>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Construct a tensor of tensors with contiguous inner data
+
+    /// The data of all inner tensors is allocated from one buffer, which is
+    /// released when the last inner tensor that uses it is destroyed. The
+    /// inner tensor data are not initialized.
+    /// \tparam ToT The tensor of tensors type
+    /// \tparam InnerRangeOp The inner range operation type
+    /// \param range The range of the outer tensor
+    /// \param inner_range_op The inner range operation, where
+    /// <tt>inner_range_op(i)</tt> returns the range of the inner tensor at
+    /// ordinal \c i ; inner tensors with an empty range are left empty
+    /// \return A tensor of tensors with the given ranges
+    template <typename ToT, typename InnerRangeOp>
+    ToT make_nested_tensor(const typename ToT::range_type& range,
+        InnerRangeOp&& inner_range_op)
+    {
+      typedef typename ToT::value_type inner_type;
+      typedef typename inner_type::value_type value_type;
+      typedef typename inner_type::allocator_type allocator_type;
+      typedef typename ToT::size_type size_type;
+
+      // Inner tensors start on an alignment boundary
+      constexpr size_type align = (EIGEN_MAX_ALIGN_BYTES > sizeof(value_type) ?
+          EIGEN_MAX_ALIGN_BYTES / sizeof(value_type) : 1ul);
+
+      // Compute the inner ranges and the size of the buffer
+      const size_type n = range.volume();
+      std::vector<typename inner_type::range_type> inner_ranges;
+      inner_ranges.reserve(n);
+      size_type volume = 0ul;
+      for(size_type i = 0ul; i < n; ++i) {
+        inner_ranges.emplace_back(inner_range_op(i));
+        volume += (inner_ranges.back().volume() + align - 1ul) / align * align;
+      }
+
+      ToT result(range);
+      if(volume == 0ul)
+        return result;
+
+      allocator_type allocator;
+      value_type* const buffer = allocator.allocate(volume);
+      const std::shared_ptr<void> owner(buffer, [volume] (value_type* const p) {
+        allocator_type allocator;
+        allocator.deallocate(p, volume);
+      });
+
+      for(size_type i = 0ul, offset = 0ul; i < n; ++i) {
+        const size_type inner_volume = inner_ranges[i].volume();
+        if(inner_volume == 0ul)
+          continue;
+        result.data()[i] = inner_type(inner_ranges[i], owner, buffer + offset);
+        offset += (inner_volume + align - 1ul) / align * align;
+      }
+
+      return result;
+    }
+
+    /// Hadamard product of tensors of tensors
+
+    /// Each inner tensor of the result is the scaled element-wise product of
+    /// the corresponding inner tensors of \c left and \c right , or empty if
+    /// either of them is empty. The result inner tensors are allocated from
+    /// one buffer.
+    /// \tparam ToT The result tensor type
+    /// \tparam Left The left-hand tensor of tensors type
+    /// \tparam Right The right-hand tensor of tensors type
+    /// \tparam Scalar The scaling factor type
+    /// \param left The left-hand argument
+    /// \param right The right-hand argument
+    /// \param factor The scaling factor
+    /// \return <tt>factor * left * right</tt>
+    template <typename ToT, typename Left, typename Right, typename Scalar>
+    ToT nested_mult(const Left& left, const Right& right, const Scalar factor) {
+      TA_ASSERT(! left.empty());
+      TA_ASSERT(! right.empty());
+      TA_ASSERT(left.range() == right.range());
+
+      const auto* MADNESS_RESTRICT const left_data = left.data();
+      const auto* MADNESS_RESTRICT const right_data = right.data();
+
+      ToT result = make_nested_tensor<ToT>(left.range(),
+          [=] (const std::size_t i) -> typename ToT::value_type::range_type {
+            if(left_data[i].empty() || right_data[i].empty())
+              return typename ToT::value_type::range_type();
+            TA_ASSERT(left_data[i].range() == right_data[i].range());
+            return left_data[i].range();
+          });
+
+      typedef typename ToT::value_type::value_type value_type;
+      typedef typename Left::value_type::value_type left_value_type;
+      typedef typename Right::value_type::value_type right_value_type;
+      const auto op = [factor] (const left_value_type l, const right_value_type r)
+          -> value_type { return l * r * factor; };
+
+      auto* MADNESS_RESTRICT const result_data = result.data();
+      for(std::size_t i = 0ul; i < result.size(); ++i) {
+        if(result_data[i].empty())
+          continue;
+        math::vector_op(op, result_data[i].size(), result_data[i].data(),
+            left_data[i].data(), right_data[i].data());
+      }
+
+      return result;
+    }
+
+    /// Outer contraction meta data of a tensor of tensors GEMM
+
+    /// The outer tensors are viewed as \c m by \c k and \c k by \c n matrices
+    /// of inner tensors.
+    struct NestedGemmIndex {
+      integer m; ///< Outer rows of left and result
+      integer n; ///< Outer columns of right and result
+      integer k; ///< Outer contracted dimension
+
+      madness::cblas::CBLAS_TRANSPOSE left_op; ///< Left-hand outer operation
+      madness::cblas::CBLAS_TRANSPOSE right_op; ///< Right-hand outer operation
+
+      template <typename Left, typename Right>
+      NestedGemmIndex(const Left& left, const Right& right,
+          const math::GemmHelper& gemm_helper) :
+        m(1), n(1), k(1), left_op(gemm_helper.left_op()),
+        right_op(gemm_helper.right_op())
+      {
+        TA_ASSERT(gemm_helper.left_right_congruent(left.range().extent_data(),
+            right.range().extent_data()));
+        gemm_helper.compute_matrix_sizes(m, n, k, left.range(), right.range());
+      }
+
+      /// \return The ordinal of left-hand element (i, p)
+      std::size_t left(const integer i, const integer p) const {
+        return (left_op == madness::cblas::NoTrans ? i * k + p : p * m + i);
+      }
+
+      /// \return The ordinal of right-hand element (p, j)
+      std::size_t right(const integer p, const integer j) const {
+        return (right_op == madness::cblas::NoTrans ? p * n + j : j * k + p);
+      }
+    }; // struct NestedGemmIndex
+
+    /// Inner Hadamard products of a tensor of tensors GEMM
+
+    /// \param[in,out] result The result tensor
+    /// \param left The left-hand argument
+    /// \param right The right-hand argument
+    /// \param factor The scaling factor
+    /// \param index The outer GEMM meta data
+    /// \param accumulate If \c true , the products are added to the non-empty
+    /// inner tensors of \c result , otherwise the non-empty inner tensors are
+    /// uninitialized and are overwritten
+    template <typename ToT, typename Left, typename Right, typename Scalar>
+    void nested_gemm_accumulate(ToT& result, const Left& left,
+        const Right& right, const Scalar factor, const NestedGemmIndex& index,
+        const bool accumulate)
+    {
+      typedef typename ToT::value_type::value_type value_type;
+      typedef typename Left::value_type::value_type left_value_type;
+      typedef typename Right::value_type::value_type right_value_type;
+      const auto init_op = [factor] (const left_value_type l,
+          const right_value_type r) -> value_type { return l * r * factor; };
+      const auto add_op = [factor] (value_type& MADNESS_RESTRICT c,
+          const left_value_type l, const right_value_type r)
+          { c += l * r * factor; };
+
+      const auto* MADNESS_RESTRICT const left_data = left.data();
+      const auto* MADNESS_RESTRICT const right_data = right.data();
+      auto* MADNESS_RESTRICT const result_data = result.data();
+      for(integer i = 0, ij = 0; i < index.m; ++i) {
+        for(integer j = 0; j < index.n; ++j, ++ij) {
+          auto& c = result_data[ij];
+          if(c.empty() && ! accumulate)
+            continue;
+
+          bool first = c.empty() || ! accumulate;
+          for(integer p = 0; p < index.k; ++p) {
+            const auto& l = left_data[index.left(i, p)];
+            const auto& r = right_data[index.right(p, j)];
+            if(l.empty() || r.empty())
+              continue;
+            TA_ASSERT(l.range() == r.range());
+
+            if(first) {
+              if(c.empty())
+                c = typename ToT::value_type(l.range());
+              TA_ASSERT(l.range() == c.range());
+              math::vector_op(init_op, c.size(), c.data(), l.data(), r.data());
+            } else {
+              TA_ASSERT(l.range() == c.range());
+              math::inplace_vector_op(add_op, c.size(), c.data(), l.data(), r.data());
+            }
+            first = false;
+          }
+        }
+      }
+    }
+
+    /// Contract tensors of tensors with an inner Hadamard product
+
+    /// Computes
+    /// \f$ C_{ij} = \alpha \sum_p A_{ip} \circ B_{pj} \f$ over the outer
+    /// indices, where \f$ \circ \f$ is the element-wise product of the inner
+    /// tensors. Products with an empty inner tensor are skipped. The result
+    /// inner tensors are allocated from one buffer, and the products are
+    /// accumulated in place.
+    /// \tparam ToT The result tensor type
+    /// \tparam Left The left-hand tensor of tensors type
+    /// \tparam Right The right-hand tensor of tensors type
+    /// \tparam Scalar The scaling factor type
+    /// \param left The left-hand argument
+    /// \param right The right-hand argument
+    /// \param factor The scaling factor
+    /// \param gemm_helper The outer GEMM meta data
+    /// \return The contraction of \c left and \c right
+    template <typename ToT, typename Left, typename Right, typename Scalar>
+    ToT nested_gemm(const Left& left, const Right& right, const Scalar factor,
+        const math::GemmHelper& gemm_helper)
+    {
+      TA_ASSERT(! left.empty());
+      TA_ASSERT(! right.empty());
+
+      const NestedGemmIndex index(left, right, gemm_helper);
+      const auto* MADNESS_RESTRICT const left_data = left.data();
+      const auto* MADNESS_RESTRICT const right_data = right.data();
+
+      ToT result = make_nested_tensor<ToT>(
+          gemm_helper.make_result_range<typename ToT::range_type>(left.range(),
+          right.range()),
+          [&] (const std::size_t ij) -> typename ToT::value_type::range_type {
+            const integer i = ij / index.n, j = ij % index.n;
+            for(integer p = 0; p < index.k; ++p) {
+              const auto& l = left_data[index.left(i, p)];
+              const auto& r = right_data[index.right(p, j)];
+              if(! (l.empty() || r.empty()))
+                return l.range();
+            }
+            return typename ToT::value_type::range_type();
+          });
+
+      nested_gemm_accumulate(result, left, right, factor, index, false);
+
+      return result;
+    }
+
+    /// Contract tensors of tensors with an inner Hadamard product and accumulate
+
+    /// Adds \f$ \alpha \sum_p A_{ip} \circ B_{pj} \f$ to the inner tensors
+    /// of \c result . Empty inner tensors of \c result that receive a
+    /// contribution are allocated.
+    /// \tparam ToT The result tensor type
+    /// \tparam Left The left-hand tensor of tensors type
+    /// \tparam Right The right-hand tensor of tensors type
+    /// \tparam Scalar The scaling factor type
+    /// \param[in,out] result The result tensor
+    /// \param left The left-hand argument
+    /// \param right The right-hand argument
+    /// \param factor The scaling factor
+    /// \param gemm_helper The outer GEMM meta data
+    template <typename ToT, typename Left, typename Right, typename Scalar>
+    void nested_gemm_to(ToT& result, const Left& left, const Right& right,
+        const Scalar factor, const math::GemmHelper& gemm_helper)
+    {
+      TA_ASSERT(! result.empty());
+      TA_ASSERT(! left.empty());
+      TA_ASSERT(! right.empty());
+
+      const NestedGemmIndex index(left, right, gemm_helper);
+      TA_ASSERT(integer(result.size()) == index.m * index.n);
+      nested_gemm_accumulate(result, left, right, factor, index, true);
+    }
+
+    /// Contract tensors of tensors with an inner contraction
+
+    /// Computes
+    /// \f$ C_{ij} = \alpha \sum_p A_{ip} B_{pj} \f$ over the outer indices,
+    /// where the inner tensors are contracted as given by \c inner_helper .
+    /// Products with an empty inner tensor are skipped. The GEMM sizes of the
+    /// inner tensors are computed once for each argument element, the result
+    /// inner tensors are allocated from one buffer, and the inner GEMMs that
+    /// contribute to a result element accumulate directly into it.
+    /// \tparam ToT The result tensor type
+    /// \tparam Left The left-hand tensor of tensors type
+    /// \tparam Right The right-hand tensor of tensors type
+    /// \tparam Scalar The scaling factor type
+    /// \param left The left-hand argument
+    /// \param right The right-hand argument
+    /// \param factor The scaling factor
+    /// \param gemm_helper The outer GEMM meta data
+    /// \param inner_helper The inner GEMM meta data
+    /// \return The contraction of \c left and \c right
+    template <typename ToT, typename Left, typename Right, typename Scalar>
+    ToT nested_gemm(const Left& left, const Right& right, const Scalar factor,
+        const math::GemmHelper& gemm_helper, const math::GemmHelper& inner_helper)
+    {
+      TA_ASSERT(! left.empty());
+      TA_ASSERT(! right.empty());
+
+      const NestedGemmIndex index(left, right, gemm_helper);
+      const auto* MADNESS_RESTRICT const left_data = left.data();
+      const auto* MADNESS_RESTRICT const right_data = right.data();
+
+      // Compute the fused inner sizes of each argument element once
+      auto fused_size = [] (const std::size_t* MADNESS_RESTRICT const extent,
+          const unsigned int first, const unsigned int last) {
+        integer size = 1;
+        for(unsigned int x = first; x < last; ++x)
+          size *= extent[x];
+        return size;
+      };
+      std::vector<integer> left_m(left.size(), 0), left_k(left.size(), 0);
+      for(std::size_t x = 0ul; x < left.size(); ++x) {
+        if(left_data[x].empty())
+          continue;
+        TA_ASSERT(left_data[x].range().rank() == inner_helper.left_rank());
+        const auto* const extent = left_data[x].range().extent_data();
+        left_m[x] = fused_size(extent, inner_helper.left_outer_begin(),
+            inner_helper.left_outer_end());
+        left_k[x] = fused_size(extent, inner_helper.left_inner_begin(),
+            inner_helper.left_inner_end());
+      }
+      std::vector<integer> right_n(right.size(), 0);
+      for(std::size_t x = 0ul; x < right.size(); ++x) {
+        if(right_data[x].empty())
+          continue;
+        TA_ASSERT(right_data[x].range().rank() == inner_helper.right_rank());
+        right_n[x] = fused_size(right_data[x].range().extent_data(),
+            inner_helper.right_outer_begin(), inner_helper.right_outer_end());
+      }
+
+      ToT result = make_nested_tensor<ToT>(
+          gemm_helper.make_result_range<typename ToT::range_type>(left.range(),
+          right.range()),
+          [&] (const std::size_t ij) -> typename ToT::value_type::range_type {
+            const integer i = ij / index.n, j = ij % index.n;
+            for(integer p = 0; p < index.k; ++p) {
+              const auto& l = left_data[index.left(i, p)];
+              const auto& r = right_data[index.right(p, j)];
+              if(! (l.empty() || r.empty()))
+                return inner_helper.make_result_range<
+                    typename ToT::value_type::range_type>(l.range(), r.range());
+            }
+            return typename ToT::value_type::range_type();
+          });
+
+      typedef typename ToT::value_type::value_type value_type;
+      const bool left_no_trans = (inner_helper.left_op() == madness::cblas::NoTrans);
+      const bool right_no_trans = (inner_helper.right_op() == madness::cblas::NoTrans);
+
+      auto* MADNESS_RESTRICT const result_data = result.data();
+      for(integer i = 0, ij = 0; i < index.m; ++i) {
+        for(integer j = 0; j < index.n; ++j, ++ij) {
+          auto& c = result_data[ij];
+          if(c.empty())
+            continue;
+
+          value_type beta(0);
+          for(integer p = 0; p < index.k; ++p) {
+            const std::size_t l = index.left(i, p), r = index.right(p, j);
+            if(left_data[l].empty() || right_data[r].empty())
+              continue;
+
+            const integer m = left_m[l], n = right_n[r], k = left_k[l];
+            TA_ASSERT(m * n == integer(c.size()));
+            TA_ASSERT(k * n == integer(right_data[r].size()));
+            math::gemm(inner_helper.left_op(), inner_helper.right_op(), m, n, k,
+                factor, left_data[l].data(), (left_no_trans ? k : m),
+                right_data[r].data(), (right_no_trans ? n : k), beta, c.data(), n);
+            beta = value_type(1);
+          }
+        }
+      }
+
+      return result;
+    }
+
+  }  // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_NESTED_KERNELS_H__INCLUDED
@@ -0,0 +1,342 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_NUMA_ALLOCATOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_NUMA_ALLOCATOR_H__INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <TiledArray/math/eigen.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define TILEDARRAY_HAS_PAGE_ALLOCATOR 1
+#endif // defined(__linux__)
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// Page-granular allocation of tile buffers
+
+    /// Buffers of at least \c min_bytes() are mapped directly from the
+    /// operating system, so that their pages may be placed on a NUMA node;
+    /// buffers of at least \c huge_page_bytes() are aligned to and padded to
+    /// huge pages, and are backed by transparent huge pages, or by explicit
+    /// (\c hugetlbfs ) huge pages when enabled and available. Smaller buffers,
+    /// and all buffers on systems other than Linux, are allocated as by
+    /// \c Eigen::aligned_allocator .
+    class PageAllocator {
+    public:
+      /// Smallest mapped buffer
+
+      /// \return The number of bytes of the smallest buffer that is mapped
+      static constexpr std::size_t min_bytes() { return 1ul << 16; }
+
+      /// Base page size
+
+      /// \return The number of bytes of a base page
+      static constexpr std::size_t page_bytes() { return 1ul << 12; }
+
+      /// Huge page size
+
+      /// \return The number of bytes of a huge page
+      static constexpr std::size_t huge_page_bytes() { return 1ul << 21; }
+
+      /// Mapped size of a buffer
+
+      /// \param bytes The number of bytes requested
+      /// \return The number of bytes that are mapped for \c bytes
+      static std::size_t mapped_bytes(const std::size_t bytes) {
+        const std::size_t page =
+            (bytes >= huge_page_bytes() ? huge_page_bytes() : page_bytes());
+        return (bytes + page - 1ul) / page * page;
+      }
+
+      /// Explicit huge page flag
+
+      /// \return A reference to the flag that selects explicit huge pages
+      /// for buffers of at least \c huge_page_bytes()
+      static std::atomic<bool>& explicit_huge_pages() {
+        static std::atomic<bool> flag(false);
+        return flag;
+      }
+
+      /// NUMA node of the calling thread
+
+      /// \return The NUMA node of the processor that runs the calling thread,
+      /// or \c -1 if it is not known
+      static int current_node() {
+#if defined(TILEDARRAY_HAS_PAGE_ALLOCATOR) && defined(SYS_getcpu)
+        unsigned int cpu = 0u, node = 0u;
+        if(syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+          return int(node);
+#endif // defined(TILEDARRAY_HAS_PAGE_ALLOCATOR) && defined(SYS_getcpu)
+        return -1;
+      }
+
+      /// Allocate a buffer
+
+      /// \param bytes The number of bytes
+      /// \param node The preferred NUMA node of the buffer pages, or \c -1
+      /// to place the pages where they are first touched
+      /// \return A pointer to an aligned buffer of at least \c bytes
+      /// \throw std::bad_alloc When the memory cannot be allocated
+      static void* allocate(const std::size_t bytes, const int node) {
+#ifdef TILEDARRAY_HAS_PAGE_ALLOCATOR
+        if(bytes >= min_bytes()) {
+          const std::size_t size = mapped_bytes(bytes);
+          void* buffer = (size >= huge_page_bytes() ?
+              map_huge(size) : map(size, 0));
+          if(buffer == nullptr)
+            throw std::bad_alloc();
+          if(node >= 0)
+            bind(buffer, size, node);
+          return buffer;
+        }
+#endif // TILEDARRAY_HAS_PAGE_ALLOCATOR
+        return Eigen::internal::aligned_malloc(bytes);
+      }
+
+      /// Deallocate a buffer
+
+      /// \param buffer A buffer returned by \c allocate
+      /// \param bytes The number of bytes that was given to \c allocate
+      static void deallocate(void* const buffer, const std::size_t bytes) {
+#ifdef TILEDARRAY_HAS_PAGE_ALLOCATOR
+        if(bytes >= min_bytes()) {
+          munmap(buffer, mapped_bytes(bytes));
+          return;
+        }
+#endif // TILEDARRAY_HAS_PAGE_ALLOCATOR
+        Eigen::internal::aligned_free(buffer);
+      }
+
+    private:
+
+#ifdef TILEDARRAY_HAS_PAGE_ALLOCATOR
+      /// Map anonymous memory
+
+      /// \param size The number of bytes, a multiple of \c page_bytes()
+      /// \param flags Additional \c mmap flags
+      /// \return The mapped memory, or \c nullptr if it cannot be mapped
+      static void* map(const std::size_t size, const int flags) {
+        void* const buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+        return (buffer == MAP_FAILED ? nullptr : buffer);
+      }
+
+      /// Map memory backed by huge pages
+
+      /// Explicit huge pages are used when they are enabled and available.
+      /// Otherwise the mapping is aligned to \c huge_page_bytes() by trimming
+      /// a larger mapping, and is advised to use transparent huge pages.
+      /// \param size The number of bytes, a multiple of \c huge_page_bytes()
+      /// \return The mapped memory, or \c nullptr if it cannot be mapped
+      static void* map_huge(const std::size_t size) {
+#ifdef MAP_HUGETLB
+        if(explicit_huge_pages()) {
+          void* const buffer = map(size, MAP_HUGETLB);
+          if(buffer)
+            return buffer;
+        }
+#endif // MAP_HUGETLB
+
+        char* const buffer =
+            static_cast<char*>(map(size + huge_page_bytes(), 0));
+        if(buffer == nullptr)
+          return nullptr;
+        const std::size_t head = (huge_page_bytes() -
+            reinterpret_cast<std::uintptr_t>(buffer) % huge_page_bytes()) %
+            huge_page_bytes();
+        if(head)
+          munmap(buffer, head);
+        if(huge_page_bytes() - head)
+          munmap(buffer + head + size, huge_page_bytes() - head);
+#ifdef MADV_HUGEPAGE
+        madvise(buffer + head, size, MADV_HUGEPAGE);
+#endif // MADV_HUGEPAGE
+        return buffer + head;
+      }
+
+      /// Place the pages of a buffer on a NUMA node
+
+      /// The pages are preferably allocated on \c node when they are first
+      /// touched. Failures (e.g. a kernel without NUMA support) are ignored.
+      /// \param buffer The mapped buffer
+      /// \param size The mapped size of \c buffer
+      /// \param node The preferred NUMA node
+      static void bind(void* const buffer, const std::size_t size, const int node) {
+#ifdef SYS_mbind
+        const unsigned long mpol_preferred = 1ul;
+        const unsigned long bits = sizeof(unsigned long) * 8ul;
+        if(std::size_t(node) + 1ul >= bits)
+          return;
+        const unsigned long mask = 1ul << node;
+        syscall(SYS_mbind, buffer, size, mpol_preferred, &mask, bits, 0u);
+#endif // SYS_mbind
+      }
+#endif // TILEDARRAY_HAS_PAGE_ALLOCATOR
+
+    }; // class PageAllocator
+
+    /// NUMA node of the calling thread's allocation scope
+
+    /// \return A reference to the NUMA node on which \c NumaAllocator places
+    /// the buffers that are allocated by the calling thread, or \c -1
+    inline int& numa_scope_node() {
+      static thread_local int node = -1;
+      return node;
+    }
+
+  } // namespace detail
+
+  /// Scoped NUMA placement of tile data
+
+  /// While a \c NumaScope object exists, buffers that \c NumaAllocator
+  /// allocates on the constructing thread are placed on the given NUMA node.
+  /// Scopes may be nested; the previous node is restored on destruction.
+  /// \code
+  /// {
+  ///   TiledArray::NumaScope scope(array.pmap()->numa_node(index));
+  ///   TiledArray::Tensor<double, TiledArray::NumaAllocator<double> > tile(range);
+  /// }
+  /// \endcode
+  class NumaScope {
+    int previous_; ///< The node of the enclosing scope
+
+  public:
+    /// Place buffers on a NUMA node
+
+    /// \param node The NUMA node, or \c -1 to place the pages where they are
+    /// first touched
+    explicit NumaScope(const int node) :
+      previous_(detail::numa_scope_node())
+    {
+      detail::numa_scope_node() = node;
+    }
+
+    NumaScope(const NumaScope&) = delete;
+    NumaScope& operator=(const NumaScope&) = delete;
+
+    ~NumaScope() { detail::numa_scope_node() = previous_; }
+
+    /// NUMA node of the calling thread
+
+    /// \return The NUMA node that runs the calling thread, or \c -1 if it is
+    /// not known
+    static int local() { return detail::PageAllocator::current_node(); }
+
+    /// Current node accessor
+
+    /// \return The NUMA node of the innermost scope on the calling thread,
+    /// or \c -1 if there is none
+    static int node() { return detail::numa_scope_node(); }
+
+  }; // class NumaScope
+
+  /// NUMA- and huge-page-aware allocator for tile data
+
+  /// Large buffers are mapped directly with page granularity: they are placed
+  /// on the NUMA node of the enclosing \c NumaScope , and buffers of at least
+  /// \c detail::PageAllocator::huge_page_bytes() are backed by huge pages
+  /// (see \c set_explicit_huge_pages() ). This allocator may be used as the
+  /// allocator of \c Tensor ; it is the default allocator when TiledArray is
+  /// configured with \c TA_NUMA_ALLOCATOR .
+  /// \tparam T The element type
+  template <typename T>
+  class NumaAllocator {
+  public:
+    typedef T value_type; ///< Element type
+    typedef T* pointer; ///< Element pointer type
+    typedef const T* const_pointer; ///< Element const pointer type
+    typedef T& reference; ///< Element reference type
+    typedef const T& const_reference; ///< Element const reference type
+    typedef std::size_t size_type; ///< Size type
+    typedef std::ptrdiff_t difference_type; ///< Difference type
+
+    template <typename U>
+    struct rebind { typedef NumaAllocator<U> other; };
+
+    NumaAllocator() noexcept { }
+    NumaAllocator(const NumaAllocator&) noexcept { }
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U>&) noexcept { }
+
+    /// Allocate elements
+
+    /// \param n The number of elements
+    /// \return A pointer to uninitialized memory for \c n elements
+    /// \throw std::bad_alloc When the memory cannot be allocated
+    pointer allocate(const size_type n, const void* = nullptr) {
+      if(n == 0ul)
+        return nullptr;
+      if(n > max_size())
+        throw std::bad_alloc();
+      return static_cast<pointer>(detail::PageAllocator::allocate(n * sizeof(T),
+          detail::numa_scope_node()));
+    }
+
+    /// Deallocate elements
+
+    /// \param p A pointer returned by \c allocate
+    /// \param n The number of elements given to \c allocate
+    void deallocate(const pointer p, const size_type n) {
+      if(p)
+        detail::PageAllocator::deallocate(p, n * sizeof(T));
+    }
+
+    size_type max_size() const noexcept {
+      return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+      ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    void destroy(U* p) { p->~U(); }
+
+    /// Select explicit huge pages
+
+    /// \param enable If \c true , buffers of at least
+    /// \c detail::PageAllocator::huge_page_bytes() are backed by explicit
+    /// (\c hugetlbfs ) huge pages when some are available; otherwise they use
+    /// transparent huge pages
+    static void set_explicit_huge_pages(const bool enable) {
+      detail::PageAllocator::explicit_huge_pages() = enable;
+    }
+
+  }; // class NumaAllocator
+
+  template <typename T, typename U>
+  inline bool operator==(const NumaAllocator<T>&, const NumaAllocator<U>&) { return true; }
+
+  template <typename T, typename U>
+  inline bool operator!=(const NumaAllocator<T>&, const NumaAllocator<U>&) { return false; }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_NUMA_ALLOCATOR_H__INCLUDED
@@ -0,0 +1,615 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_PACKED_TENSOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_PACKED_TENSOR_H__INCLUDED
+
+#include <TiledArray/tensor/tensor.h>
+#include <TiledArray/math/gemm_helper.h>
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Tile that is antisymmetric in pairs of modes
+
+  /// A tile on the diagonal of an array that is antisymmetric in a pair of
+  /// modes \c (p,q) , i.e. <tt>t(..., i, ..., j, ...) == -t(..., j, ..., i, ...)</tt> ,
+  /// is determined by its elements with <tt>i < j</tt> ; the elements with
+  /// <tt>i == j</tt> are zero. This tile stores only those elements, in
+  /// row-major order, for each of its antisymmetric pairs, so the memory and
+  /// the communication volume of the tile are about halved per pair. The
+  /// modes of a pair must have the same lower bound and extent. This tile
+  /// type implements the intrusive tile interface, so it can be used as the
+  /// tile of a \c DistArray :
+  /// \li \c scale , \c neg , \c add , \c subt , \c norm , \c dot , \c sum ,
+  ///     and \c abs_max operate on the packed elements;
+  /// \li \c gemm unpacks its packed arguments into temporaries for the
+  ///     duration of the contraction, and returns a dense \c Tensor since the
+  ///     product is not antisymmetric in general; the free \c gemm functions
+  ///     also accept a dense \c Tensor argument;
+  /// \li \c permute maps the antisymmetric pairs to the result modes;
+  /// \li the remaining operations are evaluated with the dense tile.
+  /// \tparam T The element type
+  template <typename T>
+  class PackedTensor {
+  public:
+    typedef PackedTensor<T> PackedTensor_; ///< This object type
+    typedef Tensor<T> tensor_type; ///< The dense tensor type
+    typedef typename tensor_type::range_type range_type; ///< Tensor range type
+    typedef typename tensor_type::size_type size_type; ///< Size type
+    typedef std::pair<unsigned int, unsigned int> pair_type; ///< Antisymmetric mode pair type
+    typedef std::vector<pair_type> pairs_type; ///< Antisymmetric mode pair list type
+    typedef T value_type; ///< Element type
+    typedef typename tensor_type::numeric_type numeric_type; ///< Numeric type
+    typedef typename tensor_type::scalar_type scalar_type; ///< Scalar type
+
+  private:
+
+    range_type range_; ///< The range of the tile
+    pairs_type pairs_; ///< The antisymmetric mode pairs, with <tt>first < second</tt>
+    tensor_type data_; ///< The packed elements
+
+    /// Normalize and validate antisymmetric mode pairs
+
+    /// \param range The range of the tile
+    /// \param pairs The antisymmetric mode pairs
+    /// \return \c pairs with the modes of each pair in increasing order,
+    /// sorted by their first mode
+    /// \throw TiledArray::Exception When the pairs are not disjoint, or the
+    /// modes of a pair are not in \c range or have different bounds
+    static pairs_type normalize(const range_type& range, pairs_type pairs) {
+      const unsigned int rank = range.rank();
+      std::vector<bool> used(rank, false);
+      for(auto& pair : pairs) {
+        if(pair.second < pair.first)
+          std::swap(pair.first, pair.second);
+        TA_USER_ASSERT(pair.second < rank,
+            "PackedTensor: The antisymmetric modes are not in the range of the tile.");
+        TA_USER_ASSERT((pair.first != pair.second) && ! used[pair.first]
+            && ! used[pair.second],
+            "PackedTensor: The antisymmetric pairs of modes must be disjoint.");
+        TA_USER_ASSERT((range.lobound(pair.first) == range.lobound(pair.second))
+            && (range.extent(pair.first) == range.extent(pair.second)),
+            "PackedTensor: The antisymmetric modes must have the same bounds.");
+        used[pair.first] = used[pair.second] = true;
+      }
+      std::sort(pairs.begin(), pairs.end());
+      return pairs;
+    }
+
+    /// Visit the elements of the tile in row-major order
+
+    /// \tparam Op The visitor type
+    /// \param op The visitor, called with the ordinal index of each element
+    /// and its index relative to the lower bound of the tile
+    template <typename Op>
+    void for_each_index(Op&& op) const {
+      const unsigned int rank = range_.rank();
+      const size_type volume = range_.volume();
+      std::vector<size_type> idx(rank, 0ul);
+      for(size_type ord = 0ul; ord < volume; ++ord) {
+        op(ord, idx);
+        for(unsigned int d = rank; d > 0u; --d) {
+          if(++idx[d - 1u] < range_.extent(d - 1u))
+            break;
+          idx[d - 1u] = 0ul;
+        }
+      }
+    }
+
+    /// \return \c true if the element at \c idx is stored
+    bool is_packed(const std::vector<size_type>& idx) const {
+      for(const auto& pair : pairs_)
+        if(idx[pair.first] >= idx[pair.second])
+          return false;
+      return true;
+    }
+
+    /// \return The number of stored elements
+    size_type packed_size() const {
+      size_type result = 0ul;
+      for_each_index([&] (const size_type, const std::vector<size_type>& idx) {
+        if(is_packed(idx))
+          ++result;
+      });
+      return result;
+    }
+
+    /// \return The number of copies of each stored element in the dense tile
+    scalar_type multiplicity() const {
+      return scalar_type(1ul << pairs_.size());
+    }
+
+    /// Linear combination of two tiles with the same antisymmetric pairs
+
+    /// \return <tt>lf * (*this) + rf * right</tt>
+    PackedTensor_ combine(const PackedTensor_& right, const value_type lf,
+        const value_type rf) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! right.empty());
+      TA_ASSERT(range_ == right.range_);
+      TA_ASSERT(pairs_ == right.pairs_);
+      PackedTensor_ result(*this);
+      if(! data_.empty())
+        result.data_ = tensor_type(data_, right.data_,
+            [lf, rf] (const value_type l, const value_type r)
+            { return lf * l + rf * r; });
+      return result;
+    }
+
+    /// Unpack the arguments of a contraction
+    static tensor_type operand(const PackedTensor_& tile) { return tile.to_dense(); }
+
+    static const tensor_type& operand(const tensor_type& tensor) { return tensor; }
+
+  public:
+
+    PackedTensor() : range_(), pairs_(), data_() { }
+    PackedTensor(const PackedTensor_&) = default;
+    PackedTensor(PackedTensor_&&) = default;
+    PackedTensor_& operator=(const PackedTensor_&) = default;
+    PackedTensor_& operator=(PackedTensor_&&) = default;
+
+    /// Construct a zero tile
+
+    /// \param range The range of the tile
+    /// \param pairs The antisymmetric mode pairs
+    PackedTensor(const range_type& range, const pairs_type& pairs) :
+      range_(range), pairs_(normalize(range, pairs)), data_()
+    {
+      const size_type size = packed_size();
+      if(size)
+        data_ = tensor_type(Range(size), value_type(0));
+    }
+
+    /// Pack a dense tile
+
+    /// Only the elements with <tt>i < j</tt> in the modes of each pair are
+    /// read; \c tensor is assumed to be antisymmetric.
+    /// \param tensor The dense tile
+    /// \param pairs The antisymmetric mode pairs
+    PackedTensor(const tensor_type& tensor, const pairs_type& pairs) :
+      PackedTensor()
+    {
+      if(! tensor.empty()) {
+        range_ = tensor.range();
+        pairs_ = normalize(range_, pairs);
+        const size_type size = packed_size();
+        if(size) {
+          data_ = tensor_type(Range(size));
+          size_type e = 0ul;
+          for_each_index([&] (const size_type ord, const std::vector<size_type>& idx) {
+            if(is_packed(idx))
+              data_[e++] = tensor[ord];
+          });
+        }
+      }
+    }
+
+    /// Dense tile conversion
+
+    /// \return The dense tile
+    explicit operator tensor_type() const { return to_dense(); }
+
+    /// Range accessor
+
+    /// \return The range of the tile
+    const range_type& range() const { return range_; }
+
+    /// Antisymmetric mode pairs accessor
+
+    /// \return The antisymmetric mode pairs, with the modes of each pair in
+    /// increasing order
+    const pairs_type& pairs() const { return pairs_; }
+
+    /// Packed elements accessor
+
+    /// \return The stored elements, in row-major order
+    const tensor_type& packed() const { return data_; }
+
+    /// \return The number of elements of the tile
+    size_type size() const { return range_.volume(); }
+
+    /// \return \c true if the tile is not initialized
+    bool empty() const { return range_.rank() == 0u; }
+
+    /// \return The dense tile
+    tensor_type to_dense() const {
+      if(empty())
+        return tensor_type();
+      tensor_type result(range_, value_type(0));
+      if(data_.empty())
+        return result;
+
+      // Copy the stored elements, then fill in their images under the
+      // antisymmetric transpositions
+      size_type e = 0ul;
+      for_each_index([&] (const size_type ord, const std::vector<size_type>& idx) {
+        if(is_packed(idx))
+          result[ord] = data_[e++];
+      });
+      std::vector<size_type> stored;
+      for_each_index([&] (const size_type ord, const std::vector<size_type>& idx) {
+        if(is_packed(idx))
+          return;
+        stored = idx;
+        bool odd = false;
+        for(const auto& pair : pairs_) {
+          if(idx[pair.first] == idx[pair.second])
+            return;
+          if(idx[pair.first] > idx[pair.second]) {
+            std::swap(stored[pair.first], stored[pair.second]);
+            odd = ! odd;
+          }
+        }
+        size_type stored_ord = 0ul;
+        for(unsigned int d = 0u; d < stored.size(); ++d)
+          stored_ord += stored[d] * range_.stride(d);
+        result[ord] = (odd ? -result[stored_ord] : result[stored_ord]);
+      });
+      return result;
+    }
+
+    /// \return A deep copy of this tile
+    PackedTensor_ clone() const {
+      PackedTensor_ result(*this);
+      result.data_ = data_.clone();
+      return result;
+    }
+
+    /// Only the packed elements are serialized
+    template <typename Archive>
+    void serialize(Archive& ar) { ar & range_ & pairs_ & data_; }
+
+    // Permutation and shift ---------------------------------------------------
+
+    /// Permute this tile
+
+    /// \param perm The permutation
+    /// \return The permuted tile, which is antisymmetric in the permuted
+    /// mode pairs
+    PackedTensor_ permute(const Permutation& perm) const {
+      TA_ASSERT(perm.dim() == range_.rank());
+      pairs_type pairs = pairs_;
+      for(auto& pair : pairs)
+        pair = pair_type(perm[pair.first], perm[pair.second]);
+      return PackedTensor_(to_dense().permute(perm), pairs);
+    }
+
+    /// \param bound_shift The shift of the lower and upper bounds
+    /// \return A copy of this tile with a shifted range
+    template <typename Index>
+    PackedTensor_ shift(const Index& bound_shift) const {
+      PackedTensor_ result(*this);
+      result.shift_to(bound_shift);
+      return result;
+    }
+
+    /// \param bound_shift The shift of the lower and upper bounds
+    /// \return A reference to this tile
+    template <typename Index>
+    PackedTensor_& shift_to(const Index& bound_shift) {
+      range_.inplace_shift(bound_shift);
+      return *this;
+    }
+
+    // Scaling -----------------------------------------------------------------
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    PackedTensor_ scale(const Scalar factor) const {
+      PackedTensor_ result(*this);
+      if(! data_.empty())
+        result.data_ = data_.scale(factor);
+      return result;
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    PackedTensor_ scale(const Scalar factor, const Permutation& perm) const {
+      return scale(factor).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    PackedTensor_& scale_to(const Scalar factor) {
+      return (*this = scale(factor));
+    }
+
+    PackedTensor_ neg() const { return scale(value_type(-1)); }
+    PackedTensor_ neg(const Permutation& perm) const {
+      return scale(value_type(-1), perm);
+    }
+    PackedTensor_& neg_to() { return scale_to(value_type(-1)); }
+
+    // Addition and subtraction ------------------------------------------------
+
+    PackedTensor_ add(const PackedTensor_& right) const {
+      return combine(right, value_type(1), value_type(1));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    PackedTensor_ add(const PackedTensor_& right, const Scalar factor) const {
+      return combine(right, value_type(factor), value_type(factor));
+    }
+
+    PackedTensor_ add(const PackedTensor_& right, const Permutation& perm) const {
+      return add(right).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    PackedTensor_ add(const PackedTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return add(right, factor).permute(perm);
+    }
+
+    PackedTensor_& add_to(const PackedTensor_& right) {
+      return (*this = add(right));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    PackedTensor_& add_to(const PackedTensor_& right, const Scalar factor) {
+      return (*this = add(right, factor));
+    }
+
+    PackedTensor_ subt(const PackedTensor_& right) const {
+      return combine(right, value_type(1), value_type(-1));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    PackedTensor_ subt(const PackedTensor_& right, const Scalar factor) const {
+      return combine(right, value_type(factor), value_type(-factor));
+    }
+
+    PackedTensor_ subt(const PackedTensor_& right, const Permutation& perm) const {
+      return subt(right).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    PackedTensor_ subt(const PackedTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return subt(right, factor).permute(perm);
+    }
+
+    PackedTensor_& subt_to(const PackedTensor_& right) {
+      return (*this = subt(right));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    PackedTensor_& subt_to(const PackedTensor_& right, const Scalar factor) {
+      return (*this = subt(right, factor));
+    }
+
+    // Element-wise multiplication ---------------------------------------------
+
+    /// Element-wise product
+
+    /// The product of two antisymmetric tiles is symmetric in their common
+    /// pairs, so it is returned as a dense tile.
+    /// \return The dense tile <tt>(*this) * right</tt>
+    tensor_type mult(const PackedTensor_& right) const {
+      return to_dense().mult(right.to_dense());
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    tensor_type mult(const PackedTensor_& right, const Scalar factor) const {
+      return to_dense().mult(right.to_dense(), factor);
+    }
+
+    tensor_type mult(const PackedTensor_& right, const Permutation& perm) const {
+      return to_dense().mult(right.to_dense(), perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    tensor_type mult(const PackedTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return to_dense().mult(right.to_dense(), factor, perm);
+    }
+
+    // Contraction -------------------------------------------------------------
+
+    /// Contract two tiles and add the result to a dense tile
+
+    /// Packed arguments are unpacked for the duration of the contraction.
+    /// \tparam Left The left-hand tile type, \c PackedTensor or \c Tensor
+    /// \tparam Right The right-hand tile type, \c PackedTensor or \c Tensor
+    /// \param[in,out] result The result tile; if it is empty, it is
+    /// initialized
+    /// \param left The left-hand tile
+    /// \param right The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return A reference to \c result
+    template <typename Left, typename Right, typename Scalar>
+    static tensor_type& contract(tensor_type& result, const Left& left,
+        const Right& right, const Scalar factor,
+        const math::GemmHelper& gemm_helper)
+    {
+      const tensor_type& a = operand(left);
+      const tensor_type& b = operand(right);
+      TA_ASSERT(! a.empty());
+      TA_ASSERT(! b.empty());
+      if(result.empty())
+        result = a.gemm(b, factor, gemm_helper);
+      else
+        result.gemm(a, b, factor, gemm_helper);
+      return result;
+    }
+
+    /// Contract this tile with \c other
+
+    /// \param other The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return The dense tile <tt>factor * op(*this) * op(other)</tt>
+    template <typename Scalar>
+    tensor_type gemm(const PackedTensor_& other, const Scalar factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      tensor_type result;
+      return contract(result, *this, other, factor, gemm_helper);
+    }
+
+    /// Contract this tile with a dense tile
+
+    /// \param other The right-hand dense tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return The dense tile <tt>factor * op(*this) * op(other)</tt>
+    template <typename Scalar>
+    tensor_type gemm(const tensor_type& other, const Scalar factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      tensor_type result;
+      return contract(result, *this, other, factor, gemm_helper);
+    }
+
+    // Reductions --------------------------------------------------------------
+
+    /// \return The sum of the elements, which is zero
+    value_type sum() const { return value_type(0); }
+
+    /// \return The squared Frobenius norm
+    scalar_type squared_norm() const {
+      return (data_.empty() ? scalar_type(0) :
+          multiplicity() * data_.squared_norm());
+    }
+
+    /// \return The Frobenius norm
+    scalar_type norm() const { return std::sqrt(squared_norm()); }
+
+    /// \param other The other tile, with the same antisymmetric pairs
+    /// \return The dot product of the elements of this tile and \c other
+    value_type dot(const PackedTensor_& other) const {
+      TA_ASSERT(range_ == other.range_);
+      TA_ASSERT(pairs_ == other.pairs_);
+      return (data_.empty() ? value_type(0) :
+          value_type(multiplicity()) * data_.dot(other.data_));
+    }
+
+    /// \return The maximum absolute value of the elements
+    scalar_type abs_max() const {
+      return (data_.empty() ? scalar_type(0) : data_.abs_max());
+    }
+
+    value_type inner_product(const PackedTensor_& other) const {
+      return to_dense().inner_product(other.to_dense());
+    }
+
+    value_type trace() const { return to_dense().trace(); }
+    value_type product() const { return to_dense().product(); }
+    scalar_type min() const { return to_dense().min(); }
+    scalar_type max() const { return to_dense().max(); }
+    scalar_type abs_min() const { return to_dense().abs_min(); }
+
+    auto compensated_sum() const -> decltype(tensor_type().compensated_sum()) {
+      return to_dense().compensated_sum();
+    }
+
+    auto compensated_squared_norm() const ->
+        decltype(tensor_type().compensated_squared_norm())
+    {
+      return to_dense().compensated_squared_norm();
+    }
+
+    auto compensated_dot(const PackedTensor_& other) const ->
+        decltype(tensor_type().compensated_dot(tensor_type()))
+    {
+      return to_dense().compensated_dot(other.to_dense());
+    }
+
+  }; // class PackedTensor
+
+  /// Contract a dense tile with a packed tile
+
+  /// \param left The left-hand dense tile
+  /// \param right The right-hand packed tile
+  /// \param factor The scaling factor
+  /// \param gemm_helper The *GEMM operation meta data
+  /// \return The dense tile <tt>factor * op(left) * op(right)</tt>
+  template <typename T, typename Scalar,
+      typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline Tensor<T> gemm(const Tensor<T>& left, const PackedTensor<T>& right,
+      const Scalar factor, const math::GemmHelper& gemm_helper)
+  {
+    Tensor<T> result;
+    return PackedTensor<T>::contract(result, left, right, factor, gemm_helper);
+  }
+
+  /// Contract two packed tiles and add them to a dense tile
+
+  /// \return <tt>result += factor * op(left) * op(right)</tt>
+  template <typename T, typename Scalar,
+      typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline Tensor<T>& gemm(Tensor<T>& result, const PackedTensor<T>& left,
+      const PackedTensor<T>& right, const Scalar factor,
+      const math::GemmHelper& gemm_helper)
+  {
+    return PackedTensor<T>::contract(result, left, right, factor, gemm_helper);
+  }
+
+  /// Contract a packed tile with a dense tile and add it to a dense tile
+
+  /// \return <tt>result += factor * op(left) * op(right)</tt>
+  template <typename T, typename Scalar,
+      typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline Tensor<T>& gemm(Tensor<T>& result, const PackedTensor<T>& left,
+      const Tensor<T>& right, const Scalar factor,
+      const math::GemmHelper& gemm_helper)
+  {
+    return PackedTensor<T>::contract(result, left, right, factor, gemm_helper);
+  }
+
+  /// Contract a dense tile with a packed tile and add it to a dense tile
+
+  /// \return <tt>result += factor * op(left) * op(right)</tt>
+  template <typename T, typename Scalar,
+      typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline Tensor<T>& gemm(Tensor<T>& result, const Tensor<T>& left,
+      const PackedTensor<T>& right, const Scalar factor,
+      const math::GemmHelper& gemm_helper)
+  {
+    return PackedTensor<T>::contract(result, left, right, factor, gemm_helper);
+  }
+
+  template <typename T>
+  inline std::ostream& operator<<(std::ostream& os, const PackedTensor<T>& tile) {
+    os << tile.to_dense();
+    return os;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_PACKED_TENSOR_H__INCLUDED
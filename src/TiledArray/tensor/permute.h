@@ -28,10 +28,45 @@
 
 #include <TiledArray/perm_index.h>
 #include <TiledArray/math/transpose.h>
+#ifdef HAVE_INTEL_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif // HAVE_INTEL_TBB
 
 namespace TiledArray {
   namespace detail {
 
+    /// The number of elements copied by each task of a parallel permutation
+
+    /// \return The smallest number of elements permuted by a parallel task
+    constexpr std::size_t permute_grain_size() { return 16384ul; }
+
+    /// Apply a permutation operation to a range of work items
+
+    /// The work items are split among threads when TBB is available and the
+    /// tensor is large enough.
+    /// \tparam Op The operation type
+    /// \param n The number of work items
+    /// \param item_volume The number of elements in each work item
+    /// \param op The operation, <tt>op(first, last)</tt> permutes the items in
+    /// the range <tt>[first, last)</tt>
+    template <typename Op>
+    inline void permute_items(const std::size_t n, const std::size_t item_volume,
+        const Op& op)
+    {
+#ifdef HAVE_INTEL_TBB
+      const std::size_t grain = std::max<std::size_t>(1ul,
+          permute_grain_size() / std::max<std::size_t>(item_volume, 1ul));
+      if(n > grain) {
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0ul, n, grain),
+            [&op] (const tbb::blocked_range<std::size_t>& range) {
+              op(range.begin(), range.end());
+            });
+        return;
+      }
+#endif // HAVE_INTEL_TBB
+      op(0ul, n);
+    }
 
     /// Compute the fused dimensions for permutation
 
@@ -151,13 +186,17 @@ namespace TiledArray {
         { output_op(result, input_op(a0, as...)); };
 
         // Permute the data
-        for(typename Result::size_type index = 0ul; index < volume; index += block_size) {
-          const typename Result::size_type perm_index = perm_index_op(index);
-
-          // Copy the block
-          math::vector_ptr_op(op, block_size, result.data() + perm_index,
-              arg0.data() + index, (args.data() + index)...);
-        }
+        permute_items(volume / block_size, block_size,
+            [&] (const std::size_t first, const std::size_t last) {
+              for(std::size_t block = first; block < last; ++block) {
+                const typename Result::size_type index = block * block_size;
+                const typename Result::size_type perm_index = perm_index_op(index);
+
+                // Copy the block
+                math::vector_ptr_op(op, block_size, result.data() + perm_index,
+                    arg0.data() + index, (args.data() + index)...);
+              }
+            });
 
       } else {
         // This is the more complicated case. Here we permute in terms of matrix
@@ -187,23 +226,129 @@ namespace TiledArray {
           result_outer_stride *= result_extent[i];
 
         // Copy data from the input to the output matrix via a series of matrix
-        // transposes.
-        for(typename Result::size_type i = 0ul; i < other_fused_size[0]; ++i) {
-          typename Result::size_type index = i * other_fused_weight[0];
-          for(typename Result::size_type j = 0ul; j < other_fused_size[2]; ++j, index += other_fused_weight[2]) {
-            // Compute the ordinal index of the input and output matrices.
-            typename Result::size_type perm_index = perm_index_op(index);
-
-            math::transpose(input_op, output_op,
-                other_fused_size[1], other_fused_size[3],
-                result_outer_stride, result.data() + perm_index,
-                other_fused_weight[1], arg0.data() + index, (args.data() + index)...);
+        // transposes. Each work item is a panel of up to
+        // math::TransposeTile::value rows of one matrix, so that large
+        // matrices are also split among threads.
+        const std::size_t panel_size = math::TransposeTile::value;
+        const std::size_t m = other_fused_size[1];
+        const std::size_t n = other_fused_size[3];
+        const std::size_t panels = (m + panel_size - 1ul) / panel_size;
+        const std::size_t matrices = other_fused_size[0] * other_fused_size[2];
+
+        permute_items(matrices * panels, panel_size * n,
+            [&] (const std::size_t first, const std::size_t last) {
+              for(std::size_t item = first; item < last; ++item) {
+                const std::size_t matrix = item / panels;
+                const std::size_t row = (item % panels) * panel_size;
+
+                // Compute the ordinal index of the input and output panels.
+                const typename Result::size_type index =
+                    (matrix / other_fused_size[2]) * other_fused_weight[0] +
+                    (matrix % other_fused_size[2]) * other_fused_weight[2] +
+                    row * other_fused_weight[1];
+                const typename Result::size_type perm_index = perm_index_op(index);
+
+                math::transpose(input_op, output_op,
+                    std::min(panel_size, m - row), n,
+                    result_outer_stride, result.data() + perm_index,
+                    other_fused_weight[1], arg0.data() + index, (args.data() + index)...);
+              }
+            });
+      }
+    }
+
+    /// Reduce the element pairs of a tensor and a permuted tensor
+
+    /// Each element of \c left is reduced with the element of \c right at
+    /// the permuted index, i.e. the elements of <tt>permute(left, perm)</tt>
+    /// and \c right are paired, without constructing a permuted copy. As in
+    /// \c permute() , the elements are visited in contiguous blocks when the
+    /// last dimension is not permuted, and otherwise in square blocks of
+    /// the fused matrices that are stored row-major in \c left and
+    /// column-major in \c right , so both tensors are read from cache.
+    /// The expected signature of the reduction operation is:
+    /// \code
+    /// void op(const Left::value_type, const Right::value_type)
+    /// \endcode
+    /// \tparam Op The reduction operation type
+    /// \tparam Left The left-hand tensor type
+    /// \tparam Right The right-hand tensor type
+    /// \param op The operation that reduces an element pair
+    /// \param left The left-hand tensor
+    /// \param perm The permutation that maps the indices of \c left to those
+    /// of \c right
+    /// \param right The right-hand tensor, which has the range
+    /// <tt>perm * left.range()</tt>
+    template <typename Op, typename Left, typename Right>
+    inline void permute_reduce(Op&& op, const Left& left, const Permutation& perm,
+        const Right& right)
+    {
+      detail::PermIndex perm_index_op(left.range(), perm);
+
+      // Cache constants
+      const unsigned int ndim = left.range().rank();
+      const unsigned int ndim1 = ndim - 1;
+      const typename Left::size_type volume = left.range().volume();
+      const auto* MADNESS_RESTRICT const left_extent = left.range().extent_data();
+      const auto* MADNESS_RESTRICT const left_data = left.data();
+      const auto* MADNESS_RESTRICT const right_data = right.data();
+
+      if(perm[ndim1] == ndim1) {
+        // The last dimension is not permuted, so the element pairs are
+        // reduced in contiguous blocks
+        typename Left::size_type block_size = left_extent[ndim1];
+        for(int i = int(ndim1) - 1 ; i >= 0; --i) {
+          if(int(perm[i]) != i)
+            break;
+          block_size *= left_extent[i];
+        }
+
+        for(typename Left::size_type index = 0ul; index < volume; index += block_size) {
+          const typename Left::size_type perm_index = perm_index_op(index);
+          for(typename Left::size_type i = 0ul; i < block_size; ++i)
+            op(left_data[index + i], right_data[perm_index + i]);
+        }
+
+      } else {
+        // The fused matrices of left are transposed in right (see permute())
+        typename Left::size_type fused_size[4];
+        typename Left::size_type fused_weight[4];
+        fuse_dimensions(fused_size, fused_weight, left_extent, perm);
+
+        const auto* MADNESS_RESTRICT const right_extent = right.range().extent_data();
+        typename Left::size_type right_outer_stride = 1ul;
+        for(unsigned int i = perm[ndim1] + 1u; i < ndim; ++i)
+          right_outer_stride *= right_extent[i];
+
+        const std::size_t tile = math::TransposeTile::value;
+        const std::size_t m = fused_size[1];
+        const std::size_t n = fused_size[3];
+        const std::size_t matrices = fused_size[0] * fused_size[2];
+        for(std::size_t matrix = 0ul; matrix < matrices; ++matrix) {
+          const typename Left::size_type matrix_index =
+              (matrix / fused_size[2]) * fused_weight[0] +
+              (matrix % fused_size[2]) * fused_weight[2];
+          const typename Left::size_type matrix_perm_index =
+              perm_index_op(matrix_index);
+
+          for(std::size_t i0 = 0ul; i0 < m; i0 += tile) {
+            const std::size_t i1 = std::min(m, i0 + tile);
+            for(std::size_t j0 = 0ul; j0 < n; j0 += tile) {
+              const std::size_t j1 = std::min(n, j0 + tile);
+              for(std::size_t i = i0; i < i1; ++i) {
+                const auto* MADNESS_RESTRICT const left_row =
+                    left_data + matrix_index + i * fused_weight[1];
+                const auto* MADNESS_RESTRICT const right_col =
+                    right_data + matrix_perm_index + i;
+                for(std::size_t j = j0; j < j1; ++j)
+                  op(left_row[j], right_col[j * right_outer_stride]);
+              }
+            }
           }
         }
       }
     }
 
-
   }  // namespace detail
 } // namespace TiledArray
 
@@ -0,0 +1,385 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <TiledArray/math/eigen.h>
+
+namespace TiledArray {
+
+  /// Tile pool statistics
+  struct PoolStatistics {
+    std::size_t hits; ///< The number of allocations served by the pool
+    std::size_t misses; ///< The number of allocations served by the system
+    std::size_t bytes_held; ///< The number of bytes held by the pool
+
+    /// Hit rate accessor
+
+    /// \return The fraction of allocations that were served by the pool
+    double hit_rate() const {
+      const std::size_t total = hits + misses;
+      return (total ? double(hits) / double(total) : 0.0);
+    }
+  }; // struct PoolStatistics
+
+  namespace detail {
+
+    /// Size-class pool of tile buffers
+
+    /// Buffers are rounded up to one of four size classes per power of two,
+    /// from \c min_bytes() up to \c max_bytes(); larger buffers are passed
+    /// through to the system allocator. Freed buffers are first kept in a
+    /// cache of the freeing thread, which is used without locking. When the
+    /// thread cache is full, or when the thread exits, buffers are returned
+    /// to a global pool that is shared by all threads. Buffers that exceed
+    /// the capacity of the global pool are freed. All buffers are aligned
+    /// as by \c Eigen::aligned_allocator .
+    class TilePool {
+    public:
+      /// Smallest size class
+
+      /// \return The number of bytes of the smallest size class
+      static constexpr std::size_t min_bytes() { return 64ul; }
+
+      /// Largest size class
+
+      /// \return The number of bytes of the largest size class
+      static constexpr std::size_t max_bytes() { return 1ul << 26; }
+
+    private:
+      static constexpr unsigned int min_log2_ = 6u;
+      static constexpr unsigned int max_log2_ = 26u;
+      static constexpr std::size_t classes_ = (max_log2_ - min_log2_) * 4ul + 1ul;
+
+      typedef std::vector<void*> free_list_type;
+
+      /// Per-thread cache of free buffers
+      struct ThreadCache {
+        free_list_type free_lists[classes_]; ///< Free buffers of each size class
+        std::size_t bytes = 0ul; ///< The number of bytes held by this cache
+
+        ~ThreadCache() {
+          TilePool& pool = TilePool::instance();
+          for(std::size_t c = 0ul; c < classes_; ++c)
+            for(void* const buffer : free_lists[c])
+              pool.push_global(c, buffer);
+          thread_cache_alive() = false;
+        }
+      }; // struct ThreadCache
+
+      std::mutex mutex_; ///< Protects the global pool
+      free_list_type free_lists_[classes_]; ///< Global free buffers of each size class
+      std::size_t global_bytes_; ///< The number of bytes held by the global pool
+      std::atomic<std::size_t> thread_limit_; ///< Capacity of each thread cache in bytes
+      std::atomic<std::size_t> global_limit_; ///< Capacity of the global pool in bytes
+      std::atomic<std::size_t> hits_; ///< Allocations served by the pool
+      std::atomic<std::size_t> misses_; ///< Allocations served by the system
+      std::atomic<std::size_t> bytes_held_; ///< Bytes held by the caches and the global pool
+
+      TilePool() :
+        mutex_(), free_lists_(), global_bytes_(0ul), thread_limit_(1ul << 26),
+        global_limit_(1ul << 30), hits_(0ul), misses_(0ul), bytes_held_(0ul)
+      { }
+
+      TilePool(const TilePool&) = delete;
+      TilePool& operator=(const TilePool&) = delete;
+
+      /// Size class of a buffer
+
+      /// \param bytes The number of bytes requested, not greater than
+      /// \c max_bytes()
+      /// \return The size class of a buffer of \c bytes
+      static std::size_t size_class(const std::size_t bytes) {
+        if(bytes <= min_bytes())
+          return 0ul;
+        const std::size_t last = bytes - 1ul;
+        unsigned int log2 = min_log2_;
+        while((last >> (log2 + 1u)) != 0ul)
+          ++log2;
+        const std::size_t quarter = (last - (1ul << log2)) >> (log2 - 2u);
+        return (log2 - min_log2_) * 4ul + quarter + 1ul;
+      }
+
+      /// Size of a size class
+
+      /// \param c The size class
+      /// \return The number of bytes of the buffers in size class \c c
+      static std::size_t class_bytes(const std::size_t c) {
+        if(c == 0ul)
+          return min_bytes();
+        const unsigned int log2 = min_log2_ + (c - 1ul) / 4ul;
+        return (1ul << log2) + (((c - 1ul) % 4ul) + 1ul) * (1ul << (log2 - 2u));
+      }
+
+      /// Thread cache state
+
+      /// \return \c false once the thread cache of the calling thread has been
+      /// destroyed
+      static bool& thread_cache_alive() {
+        static thread_local bool alive = true;
+        return alive;
+      }
+
+      /// Thread cache accessor
+
+      /// \return The cache of the calling thread, or \c nullptr if it has been
+      /// destroyed
+      static ThreadCache* thread_cache() {
+        if(! thread_cache_alive())
+          return nullptr;
+        static thread_local ThreadCache cache;
+        return & cache;
+      }
+
+      /// Return a buffer to the global pool
+
+      /// \param c The size class of \c buffer
+      /// \param buffer The buffer
+      void push_global(const std::size_t c, void* const buffer) {
+        const std::size_t bytes = class_bytes(c);
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if(global_bytes_ + bytes <= global_limit_) {
+            free_lists_[c].push_back(buffer);
+            global_bytes_ += bytes;
+            return;
+          }
+        }
+        bytes_held_ -= bytes;
+        Eigen::internal::aligned_free(buffer);
+      }
+
+      /// Take a buffer from the global pool
+
+      /// \param c The size class
+      /// \return A buffer of size class \c c , or \c nullptr if there is none
+      void* pop_global(const std::size_t c) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(free_lists_[c].empty())
+          return nullptr;
+        void* const buffer = free_lists_[c].back();
+        free_lists_[c].pop_back();
+        global_bytes_ -= class_bytes(c);
+        return buffer;
+      }
+
+    public:
+
+      /// Pool accessor
+
+      /// The pool is never destroyed, so tensors that are destroyed during
+      /// program termination may still return their buffers.
+      /// \return The tile pool
+      static TilePool& instance() {
+        static TilePool* const pool = new TilePool();
+        return *pool;
+      }
+
+      /// Allocate a buffer
+
+      /// \param bytes The number of bytes
+      /// \return A pointer to an aligned buffer of at least \c bytes
+      /// \throw std::bad_alloc When the system allocator fails
+      void* allocate(const std::size_t bytes) {
+        if(bytes > max_bytes()) {
+          ++misses_;
+          return Eigen::internal::aligned_malloc(bytes);
+        }
+
+        const std::size_t c = size_class(bytes);
+        ThreadCache* const cache = thread_cache();
+        if(cache && ! cache->free_lists[c].empty()) {
+          void* const buffer = cache->free_lists[c].back();
+          cache->free_lists[c].pop_back();
+          cache->bytes -= class_bytes(c);
+          bytes_held_ -= class_bytes(c);
+          ++hits_;
+          return buffer;
+        }
+
+        void* const buffer = pop_global(c);
+        if(buffer) {
+          bytes_held_ -= class_bytes(c);
+          ++hits_;
+          return buffer;
+        }
+
+        ++misses_;
+        return Eigen::internal::aligned_malloc(class_bytes(c));
+      }
+
+      /// Deallocate a buffer
+
+      /// \param buffer A buffer returned by \c allocate
+      /// \param bytes The number of bytes that was given to \c allocate
+      void deallocate(void* const buffer, const std::size_t bytes) {
+        if(bytes > max_bytes()) {
+          Eigen::internal::aligned_free(buffer);
+          return;
+        }
+
+        const std::size_t c = size_class(bytes);
+        bytes_held_ += class_bytes(c);
+        ThreadCache* const cache = thread_cache();
+        if(cache && (cache->bytes + class_bytes(c) <= thread_limit_)) {
+          cache->free_lists[c].push_back(buffer);
+          cache->bytes += class_bytes(c);
+        } else {
+          push_global(c, buffer);
+        }
+      }
+
+      /// Set the pool capacities
+
+      /// \param thread_bytes The capacity of each thread cache in bytes
+      /// \param global_bytes The capacity of the global pool in bytes
+      /// \note Buffers that are already held are not released.
+      void set_limits(const std::size_t thread_bytes, const std::size_t global_bytes) {
+        thread_limit_ = thread_bytes;
+        global_limit_ = global_bytes;
+      }
+
+      /// Statistics accessor
+
+      /// \return The allocation statistics of the pool
+      PoolStatistics statistics() const {
+        return PoolStatistics{ hits_.load(), misses_.load(), bytes_held_.load() };
+      }
+
+      /// Reset the hit and miss counts
+      void reset_statistics() {
+        hits_ = 0ul;
+        misses_ = 0ul;
+      }
+
+      /// Release the held buffers
+
+      /// The buffers in the cache of the calling thread and in the global pool
+      /// are freed. The caches of other threads are not modified.
+      void release() {
+        ThreadCache* const cache = thread_cache();
+        if(cache) {
+          for(std::size_t c = 0ul; c < classes_; ++c) {
+            for(void* const buffer : cache->free_lists[c])
+              Eigen::internal::aligned_free(buffer);
+            cache->free_lists[c].clear();
+          }
+          bytes_held_ -= cache->bytes;
+          cache->bytes = 0ul;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for(std::size_t c = 0ul; c < classes_; ++c) {
+          for(void* const buffer : free_lists_[c])
+            Eigen::internal::aligned_free(buffer);
+          free_lists_[c].clear();
+        }
+        bytes_held_ -= global_bytes_;
+        global_bytes_ = 0ul;
+      }
+
+    }; // class TilePool
+
+  } // namespace detail
+
+  /// Pooling allocator for tile data
+
+  /// Allocates from the size-class pool \c detail::TilePool , which recycles
+  /// buffers per thread and returns them to a global pool. This allocator may
+  /// be used as the allocator of \c Tensor ; it is the default allocator when
+  /// TiledArray is configured with \c TA_POOL_ALLOCATOR .
+  /// \tparam T The element type
+  template <typename T>
+  class PoolAllocator {
+  public:
+    typedef T value_type; ///< Element type
+    typedef T* pointer; ///< Element pointer type
+    typedef const T* const_pointer; ///< Element const pointer type
+    typedef T& reference; ///< Element reference type
+    typedef const T& const_reference; ///< Element const reference type
+    typedef std::size_t size_type; ///< Size type
+    typedef std::ptrdiff_t difference_type; ///< Difference type
+
+    template <typename U>
+    struct rebind { typedef PoolAllocator<U> other; };
+
+    PoolAllocator() noexcept { }
+    PoolAllocator(const PoolAllocator&) noexcept { }
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+    /// Allocate elements
+
+    /// \param n The number of elements
+    /// \return A pointer to uninitialized memory for \c n elements
+    /// \throw std::bad_alloc When the memory cannot be allocated
+    pointer allocate(const size_type n, const void* = nullptr) {
+      if(n == 0ul)
+        return nullptr;
+      if(n > max_size())
+        throw std::bad_alloc();
+      return static_cast<pointer>(detail::TilePool::instance().allocate(n * sizeof(T)));
+    }
+
+    /// Deallocate elements
+
+    /// \param p A pointer returned by \c allocate
+    /// \param n The number of elements given to \c allocate
+    void deallocate(const pointer p, const size_type n) {
+      if(p)
+        detail::TilePool::instance().deallocate(p, n * sizeof(T));
+    }
+
+    size_type max_size() const noexcept {
+      return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+      ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    void destroy(U* p) { p->~U(); }
+
+    /// Pool statistics accessor
+
+    /// \return The allocation statistics of the tile pool
+    static PoolStatistics statistics() {
+      return detail::TilePool::instance().statistics();
+    }
+
+  }; // class PoolAllocator
+
+  template <typename T, typename U>
+  inline bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) { return true; }
+
+  template <typename T, typename U>
+  inline bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) { return false; }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
@@ -0,0 +1,856 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_SPARSE_TENSOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_SPARSE_TENSOR_H__INCLUDED
+
+#include <TiledArray/tensor/tensor.h>
+#include <TiledArray/math/gemm_helper.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Element-sparse tile
+
+  /// Stores the non-zero elements of a tile, and their ordinal indices in
+  /// increasing order, when the fraction of non-zero elements (the fill) is
+  /// no more than \c fill_threshold() ; otherwise the tile is stored as a
+  /// dense \c Tensor . The representation is chosen whenever a tile is
+  /// constructed from a dense tile or computed, so tiles convert
+  /// automatically in both directions as their fill changes. Since the
+  /// indices are ordinals of the row-major tile, the elements are a
+  /// compressed sparse row (CSR) matrix for any matricization of the tile,
+  /// e.g. the one used by \c gemm . This tile type implements the intrusive
+  /// tile interface, so it can be used as the tile of a \c DistArray , e.g.
+  /// for tiles that are mostly zero after truncation:
+  /// \li \c gemm multiplies sparse-sparse, sparse-dense, and dense-sparse
+  ///     arguments, touching only the non-zero elements of the sparse ones;
+  ///     the free \c gemm functions also accept a dense \c Tensor argument;
+  /// \li \c add , \c subt , and \c mult merge the non-zero elements;
+  /// \li \c permute , \c scale , \c neg , \c sum , \c norm , and \c dot
+  ///     operate on the non-zero elements;
+  /// \li the remaining operations are evaluated with the dense tile.
+  /// \tparam T The element type
+  template <typename T>
+  class SparseTensor {
+  public:
+    typedef SparseTensor<T> SparseTensor_; ///< This object type
+    typedef Tensor<T> tensor_type; ///< The dense tensor type
+    typedef typename tensor_type::range_type range_type; ///< Tensor range type
+    typedef typename tensor_type::size_type size_type; ///< Size type
+    typedef Tensor<size_type> index_tensor_type; ///< The ordinal index tensor type
+    typedef T value_type; ///< Element type
+    typedef typename tensor_type::numeric_type numeric_type; ///< Numeric type
+    typedef typename tensor_type::scalar_type scalar_type; ///< Scalar type
+
+  private:
+
+    /// A sparse matrix in compressed sparse row format
+    struct csr_matrix {
+      std::vector<size_type> row_ptr; ///< The offsets of the rows, of size rows + 1
+      std::vector<size_type> col; ///< The column indices of the elements
+      std::vector<value_type> val; ///< The values of the elements
+    }; // struct csr_matrix
+
+    range_type range_; ///< The range of the tile
+    tensor_type dense_; ///< The dense tile, if the tile is not sparse
+    index_tensor_type indices_; ///< The ordinal indices of the non-zero elements
+    tensor_type values_; ///< The non-zero elements
+    size_type nnz_ = 0ul; ///< The number of non-zero elements
+
+    /// \return \c true if \c nnz elements of \c volume are stored sparse
+    static bool is_sparse_fill(const size_type nnz, const size_type volume) {
+      return scalar_type(nnz) <= fill_threshold() * scalar_type(volume);
+    }
+
+    /// Construct a dense tile
+    SparseTensor(const range_type& range, const tensor_type& dense, int) :
+      range_(range), dense_(dense), indices_(), values_(), nnz_(0ul)
+    { }
+
+    /// Construct a tile from its non-zero elements
+
+    /// \param range The range of the tile
+    /// \param indices The ordinal indices of the elements, in increasing order
+    /// \param values The elements
+    /// \return The sparse tile, or the dense tile when the fill is larger
+    /// than \c fill_threshold()
+    static SparseTensor_ make(const range_type& range,
+        const std::vector<size_type>& indices,
+        const std::vector<value_type>& values)
+    {
+      TA_ASSERT(indices.size() == values.size());
+      const size_type nnz = indices.size();
+      if(! is_sparse_fill(nnz, range.volume())) {
+        tensor_type dense(range, value_type(0));
+        for(size_type e = 0ul; e < nnz; ++e)
+          dense[indices[e]] = values[e];
+        return SparseTensor_(range, dense, 0);
+      }
+
+      SparseTensor_ result(range);
+      if(nnz) {
+        result.indices_ = index_tensor_type(Range(nnz), indices.data());
+        result.values_ = tensor_type(Range(nnz), values.data());
+        result.nnz_ = nnz;
+      }
+      return result;
+    }
+
+    /// Wrap a dense contraction argument
+    static SparseTensor_ operand(const tensor_type& tensor) {
+      return SparseTensor_(tensor.range(), tensor, 0);
+    }
+
+    static const SparseTensor_& operand(const SparseTensor_& tile) {
+      return tile;
+    }
+
+    /// The (possibly transposed) CSR matrix of this tile
+
+    /// \param op The transpose operation of the matrix
+    /// \param rows The number of rows of <tt>op(matrix)</tt>
+    /// \param cols The number of columns of <tt>op(matrix)</tt>
+    /// \return <tt>op(matrix)</tt> , in CSR format
+    csr_matrix csr(const madness::cblas::CBLAS_TRANSPOSE op,
+        const size_type rows, const size_type cols) const
+    {
+      TA_ASSERT(! is_dense());
+      TA_ASSERT(rows * cols == size());
+      csr_matrix result;
+      result.row_ptr.assign(rows + 1ul, 0ul);
+      result.col.resize(nnz_);
+      result.val.resize(nnz_);
+      if(op == madness::cblas::NoTrans) {
+        for(size_type e = 0ul; e < nnz_; ++e) {
+          ++result.row_ptr[indices_[e] / cols + 1ul];
+          result.col[e] = indices_[e] % cols;
+          result.val[e] = values_[e];
+        }
+        std::partial_sum(result.row_ptr.begin(), result.row_ptr.end(),
+            result.row_ptr.begin());
+      } else {
+        // The stored matrix is cols x rows; a counting sort by the stored
+        // column keeps the columns of op(matrix) in increasing order.
+        for(size_type e = 0ul; e < nnz_; ++e)
+          ++result.row_ptr[indices_[e] % rows + 1ul];
+        std::partial_sum(result.row_ptr.begin(), result.row_ptr.end(),
+            result.row_ptr.begin());
+        std::vector<size_type> next(result.row_ptr.begin(), result.row_ptr.end() - 1);
+        for(size_type e = 0ul; e < nnz_; ++e) {
+          const size_type f = next[indices_[e] % rows]++;
+          result.col[f] = indices_[e] / rows;
+          result.val[f] = values_[e];
+        }
+      }
+      return result;
+    }
+
+    /// <tt>c += alpha * a * op(b)</tt> , where \c a is sparse and \c b is dense
+    static void csr_dense(const csr_matrix& a, const value_type* const b,
+        const madness::cblas::CBLAS_TRANSPOSE op_b, const size_type m,
+        const size_type n, const size_type k, const value_type alpha,
+        value_type* const c)
+    {
+      for(size_type i = 0ul; i < m; ++i) {
+        value_type* const c_i = c + i * n;
+        for(size_type e = a.row_ptr[i]; e < a.row_ptr[i + 1ul]; ++e) {
+          const size_type p = a.col[e];
+          const value_type a_ip = alpha * a.val[e];
+          if(op_b == madness::cblas::NoTrans) {
+            const value_type* const b_p = b + p * n;
+            for(size_type j = 0ul; j < n; ++j)
+              c_i[j] += a_ip * b_p[j];
+          } else {
+            for(size_type j = 0ul; j < n; ++j)
+              c_i[j] += a_ip * b[j * k + p];
+          }
+        }
+      }
+    }
+
+    /// <tt>c += alpha * op(a) * b</tt> , where \c a is dense and \c b is sparse
+    static void dense_csr(const value_type* const a,
+        const madness::cblas::CBLAS_TRANSPOSE op_a, const csr_matrix& b,
+        const size_type m, const size_type n, const size_type k,
+        const value_type alpha, value_type* const c)
+    {
+      for(size_type p = 0ul; p < k; ++p) {
+        for(size_type e = b.row_ptr[p]; e < b.row_ptr[p + 1ul]; ++e) {
+          const size_type j = b.col[e];
+          const value_type b_pj = alpha * b.val[e];
+          if(op_a == madness::cblas::NoTrans) {
+            for(size_type i = 0ul; i < m; ++i)
+              c[i * n + j] += a[i * k + p] * b_pj;
+          } else {
+            const value_type* const a_p = a + p * m;
+            for(size_type i = 0ul; i < m; ++i)
+              c[i * n + j] += a_p[i] * b_pj;
+          }
+        }
+      }
+    }
+
+    /// <tt>c += alpha * a * b</tt> , where \c a and \c b are sparse
+    static void csr_csr(const csr_matrix& a, const csr_matrix& b,
+        const size_type m, const size_type n, const value_type alpha,
+        value_type* const c)
+    {
+      for(size_type i = 0ul; i < m; ++i) {
+        value_type* const c_i = c + i * n;
+        for(size_type e = a.row_ptr[i]; e < a.row_ptr[i + 1ul]; ++e) {
+          const size_type p = a.col[e];
+          const value_type a_ip = alpha * a.val[e];
+          for(size_type f = b.row_ptr[p]; f < b.row_ptr[p + 1ul]; ++f)
+            c_i[b.col[f]] += a_ip * b.val[f];
+        }
+      }
+    }
+
+    /// Linear combination of two tiles
+
+    /// \return <tt>lf * (*this) + rf * right</tt>
+    SparseTensor_ combine(const SparseTensor_& right, const value_type lf,
+        const value_type rf) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! right.empty());
+      TA_ASSERT(range_ == right.range_);
+      if(is_dense() || right.is_dense())
+        return SparseTensor_(tensor_type(to_dense(), right.to_dense(),
+            [lf, rf] (const value_type l, const value_type r)
+            { return lf * l + rf * r; }));
+
+      std::vector<size_type> indices;
+      std::vector<value_type> values;
+      indices.reserve(nnz_ + right.nnz_);
+      values.reserve(nnz_ + right.nnz_);
+      auto push = [&] (const size_type index, const value_type value) {
+        if(value != value_type(0)) {
+          indices.push_back(index);
+          values.push_back(value);
+        }
+      };
+      size_type e = 0ul, f = 0ul;
+      while((e < nnz_) && (f < right.nnz_)) {
+        if(indices_[e] < right.indices_[f]) {
+          push(indices_[e], lf * values_[e]);
+          ++e;
+        } else if(right.indices_[f] < indices_[e]) {
+          push(right.indices_[f], rf * right.values_[f]);
+          ++f;
+        } else {
+          push(indices_[e], lf * values_[e] + rf * right.values_[f]);
+          ++e;
+          ++f;
+        }
+      }
+      for(; e < nnz_; ++e)
+        push(indices_[e], lf * values_[e]);
+      for(; f < right.nnz_; ++f)
+        push(right.indices_[f], rf * right.values_[f]);
+      return make(range_, indices, values);
+    }
+
+  public:
+
+    /// Fill threshold accessor
+
+    /// Tiles whose fraction of non-zero elements is no more than the
+    /// threshold are stored sparse. The default is 0.25.
+    /// \return A reference to the fill threshold
+    static scalar_type& fill_threshold() {
+      static scalar_type threshold = 0.25;
+      return threshold;
+    }
+
+    SparseTensor() : range_(), dense_(), indices_(), values_(), nnz_(0ul) { }
+    SparseTensor(const SparseTensor_&) = default;
+    SparseTensor(SparseTensor_&&) = default;
+    SparseTensor_& operator=(const SparseTensor_&) = default;
+    SparseTensor_& operator=(SparseTensor_&&) = default;
+
+    /// Construct a zero tile
+
+    /// \param range The range of the tile
+    explicit SparseTensor(const range_type& range) :
+      range_(range), dense_(), indices_(), values_(), nnz_(0ul)
+    { }
+
+    /// Compress a dense tile
+
+    /// \param tensor The dense tile
+    explicit SparseTensor(const tensor_type& tensor) :
+      SparseTensor()
+    {
+      if(! tensor.empty()) {
+        const size_type volume = tensor.size();
+        const size_type nnz = volume - std::count(tensor.data(),
+            tensor.data() + volume, value_type(0));
+        if(is_sparse_fill(nnz, volume)) {
+          range_ = tensor.range();
+          if(nnz) {
+            indices_ = index_tensor_type(Range(nnz));
+            values_ = tensor_type(Range(nnz));
+            for(size_type i = 0ul; i < volume; ++i) {
+              if(tensor[i] != value_type(0)) {
+                indices_[nnz_] = i;
+                values_[nnz_] = tensor[i];
+                ++nnz_;
+              }
+            }
+          }
+        } else {
+          *this = SparseTensor_(tensor.range(), tensor, 0);
+        }
+      }
+    }
+
+    /// Dense tile conversion
+
+    /// \return The dense tile
+    explicit operator tensor_type() const { return to_dense(); }
+
+    /// Range accessor
+
+    /// \return The range of the tile
+    const range_type& range() const { return range_; }
+
+    /// \return The number of elements of the tile
+    size_type size() const { return range_.volume(); }
+
+    /// \return \c true if the tile is not initialized
+    bool empty() const { return range_.rank() == 0u; }
+
+    /// \return \c true if the tile is stored as a dense tensor
+    bool is_dense() const { return ! dense_.empty(); }
+
+    /// \return The number of stored elements, i.e. the non-zero elements of
+    /// a sparse tile or all elements of a dense tile
+    size_type nnz() const { return (is_dense() ? size() : nnz_); }
+
+    /// \return The fraction of the elements that are stored
+    scalar_type fill() const {
+      return (size() ? scalar_type(nnz()) / scalar_type(size()) : scalar_type(0));
+    }
+
+    /// \return The ordinal indices of the non-zero elements of a sparse tile,
+    /// in increasing order
+    const index_tensor_type& indices() const { return indices_; }
+
+    /// \return The non-zero elements of a sparse tile
+    const tensor_type& values() const { return values_; }
+
+    /// \return The dense tile
+    tensor_type to_dense() const {
+      if(empty())
+        return tensor_type();
+      if(is_dense())
+        return dense_;
+      tensor_type result(range_, value_type(0));
+      for(size_type e = 0ul; e < nnz_; ++e)
+        result[indices_[e]] = values_[e];
+      return result;
+    }
+
+    /// \return A deep copy of this tile
+    SparseTensor_ clone() const {
+      SparseTensor_ result(*this);
+      result.dense_ = dense_.clone();
+      result.indices_ = indices_.clone();
+      result.values_ = values_.clone();
+      return result;
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar) { ar & range_ & dense_ & indices_ & values_ & nnz_; }
+
+    // Permutation and shift ---------------------------------------------------
+
+    /// Permute this tile
+
+    /// The indices of the non-zero elements are permuted and sorted.
+    /// \param perm The permutation
+    /// \return The permuted tile
+    SparseTensor_ permute(const Permutation& perm) const {
+      TA_ASSERT(perm.dim() == range_.rank());
+      if(is_dense())
+        return SparseTensor_(perm * range_, dense_.permute(perm), 0);
+      SparseTensor_ result(perm * range_);
+      if(nnz_ == 0ul)
+        return result;
+
+      const unsigned int rank = range_.rank();
+      std::vector<size_type> stride(rank);
+      for(unsigned int i = 0u; i < rank; ++i)
+        stride[i] = result.range_.stride(perm[i]);
+
+      std::vector<std::pair<size_type, value_type> > elements(nnz_);
+      for(size_type e = 0ul; e < nnz_; ++e) {
+        size_type index = indices_[e], result_index = 0ul;
+        for(unsigned int i = rank; i > 0u; --i) {
+          const size_type extent = range_.extent(i - 1u);
+          result_index += (index % extent) * stride[i - 1u];
+          index /= extent;
+        }
+        elements[e] = std::make_pair(result_index, values_[e]);
+      }
+      std::sort(elements.begin(), elements.end(),
+          [] (const std::pair<size_type, value_type>& l,
+              const std::pair<size_type, value_type>& r)
+          { return l.first < r.first; });
+
+      result.indices_ = index_tensor_type(Range(nnz_));
+      result.values_ = tensor_type(Range(nnz_));
+      for(size_type e = 0ul; e < nnz_; ++e) {
+        result.indices_[e] = elements[e].first;
+        result.values_[e] = elements[e].second;
+      }
+      result.nnz_ = nnz_;
+      return result;
+    }
+
+    /// \param bound_shift The shift of the lower and upper bounds
+    /// \return A copy of this tile with a shifted range
+    template <typename Index>
+    SparseTensor_ shift(const Index& bound_shift) const {
+      SparseTensor_ result(*this);
+      result.shift_to(bound_shift);
+      return result;
+    }
+
+    /// \param bound_shift The shift of the lower and upper bounds
+    /// \return A reference to this tile
+    template <typename Index>
+    SparseTensor_& shift_to(const Index& bound_shift) {
+      range_.inplace_shift(bound_shift);
+      if(is_dense())
+        dense_ = dense_.shift(bound_shift);
+      return *this;
+    }
+
+    // Scaling -----------------------------------------------------------------
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_ scale(const Scalar factor) const {
+      SparseTensor_ result(*this);
+      if(is_dense())
+        result.dense_ = dense_.scale(factor);
+      else if(nnz_)
+        result.values_ = values_.scale(factor);
+      return result;
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_ scale(const Scalar factor, const Permutation& perm) const {
+      return scale(factor).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_& scale_to(const Scalar factor) {
+      return (*this = scale(factor));
+    }
+
+    SparseTensor_ neg() const { return scale(value_type(-1)); }
+    SparseTensor_ neg(const Permutation& perm) const {
+      return scale(value_type(-1), perm);
+    }
+    SparseTensor_& neg_to() { return scale_to(value_type(-1)); }
+
+    // Addition and subtraction ------------------------------------------------
+
+    SparseTensor_ add(const SparseTensor_& right) const {
+      return combine(right, value_type(1), value_type(1));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_ add(const SparseTensor_& right, const Scalar factor) const {
+      return combine(right, value_type(factor), value_type(factor));
+    }
+
+    SparseTensor_ add(const SparseTensor_& right, const Permutation& perm) const {
+      return add(right).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_ add(const SparseTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return add(right, factor).permute(perm);
+    }
+
+    /// Add a constant to the elements
+    SparseTensor_ add(const value_type value) const {
+      return SparseTensor_(to_dense().add(value));
+    }
+
+    SparseTensor_ add(const value_type value, const Permutation& perm) const {
+      return add(value).permute(perm);
+    }
+
+    SparseTensor_& add_to(const SparseTensor_& right) {
+      return (*this = add(right));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_& add_to(const SparseTensor_& right, const Scalar factor) {
+      return (*this = add(right, factor));
+    }
+
+    SparseTensor_& add_to(const value_type value) {
+      return (*this = add(value));
+    }
+
+    SparseTensor_ subt(const SparseTensor_& right) const {
+      return combine(right, value_type(1), value_type(-1));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_ subt(const SparseTensor_& right, const Scalar factor) const {
+      return combine(right, value_type(factor), value_type(-factor));
+    }
+
+    SparseTensor_ subt(const SparseTensor_& right, const Permutation& perm) const {
+      return subt(right).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_ subt(const SparseTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return subt(right, factor).permute(perm);
+    }
+
+    /// Subtract a constant from the elements
+    SparseTensor_ subt(const value_type value) const { return add(-value); }
+
+    SparseTensor_ subt(const value_type value, const Permutation& perm) const {
+      return add(-value, perm);
+    }
+
+    SparseTensor_& subt_to(const SparseTensor_& right) {
+      return (*this = subt(right));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_& subt_to(const SparseTensor_& right, const Scalar factor) {
+      return (*this = subt(right, factor));
+    }
+
+    SparseTensor_& subt_to(const value_type value) { return add_to(-value); }
+
+    // Element-wise multiplication ---------------------------------------------
+
+    /// Element-wise product, which is sparse if either argument is sparse
+    SparseTensor_ mult(const SparseTensor_& right) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! right.empty());
+      TA_ASSERT(range_ == right.range_);
+      if(is_dense() && right.is_dense())
+        return SparseTensor_(dense_.mult(right.dense_));
+      if(is_dense())
+        return right.mult(*this);
+
+      std::vector<size_type> indices;
+      std::vector<value_type> values;
+      indices.reserve(nnz_);
+      values.reserve(nnz_);
+      size_type f = 0ul;
+      for(size_type e = 0ul; e < nnz_; ++e) {
+        value_type value(0);
+        if(right.is_dense()) {
+          value = values_[e] * right.dense_[indices_[e]];
+        } else {
+          while((f < right.nnz_) && (right.indices_[f] < indices_[e]))
+            ++f;
+          if((f < right.nnz_) && (right.indices_[f] == indices_[e]))
+            value = values_[e] * right.values_[f];
+        }
+        if(value != value_type(0)) {
+          indices.push_back(indices_[e]);
+          values.push_back(value);
+        }
+      }
+      return make(range_, indices, values);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_ mult(const SparseTensor_& right, const Scalar factor) const {
+      return mult(right).scale(factor);
+    }
+
+    SparseTensor_ mult(const SparseTensor_& right, const Permutation& perm) const {
+      return mult(right).permute(perm);
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_ mult(const SparseTensor_& right, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return mult(right, factor).permute(perm);
+    }
+
+    SparseTensor_& mult_to(const SparseTensor_& right) {
+      return (*this = mult(right));
+    }
+
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    SparseTensor_& mult_to(const SparseTensor_& right, const Scalar factor) {
+      return (*this = mult(right, factor));
+    }
+
+    // Contraction -------------------------------------------------------------
+
+    /// Contract two tiles and add the result to a dense tile
+
+    /// Either argument may be a sparse tile or a dense \c Tensor ; only the
+    /// non-zero elements of the sparse arguments are multiplied.
+    /// \tparam Left The left-hand tile type, \c SparseTensor or \c Tensor
+    /// \tparam Right The right-hand tile type, \c SparseTensor or \c Tensor
+    /// \param[in,out] result The result tile; if it is empty, it is
+    /// initialized to zero
+    /// \param left The left-hand tile
+    /// \param right The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return A reference to \c result
+    template <typename Left, typename Right, typename Scalar>
+    static tensor_type& contract(tensor_type& result, const Left& left,
+        const Right& right, const Scalar factor,
+        const math::GemmHelper& gemm_helper)
+    {
+      const SparseTensor_& a = operand(left);
+      const SparseTensor_& b = operand(right);
+      TA_ASSERT(! a.empty());
+      TA_ASSERT(! b.empty());
+
+      if(a.is_dense() && b.is_dense()) {
+        if(result.empty())
+          result = a.dense_.gemm(b.dense_, factor, gemm_helper);
+        else
+          result.gemm(a.dense_, b.dense_, factor, gemm_helper);
+        return result;
+      }
+
+      integer m = 1, n = 1, k = 1;
+      gemm_helper.compute_matrix_sizes(m, n, k, a.range_, b.range_);
+      if(result.empty())
+        result = tensor_type(gemm_helper.make_result_range<range_type>(a.range_,
+            b.range_), value_type(0));
+      TA_ASSERT(result.size() == size_type(m * n));
+
+      const value_type alpha(factor);
+      if(a.is_dense())
+        dense_csr(a.dense_.data(), gemm_helper.left_op(),
+            b.csr(gemm_helper.right_op(), k, n), m, n, k, alpha, result.data());
+      else if(b.is_dense())
+        csr_dense(a.csr(gemm_helper.left_op(), m, k), b.dense_.data(),
+            gemm_helper.right_op(), m, n, k, alpha, result.data());
+      else
+        csr_csr(a.csr(gemm_helper.left_op(), m, k),
+            b.csr(gemm_helper.right_op(), k, n), m, n, alpha, result.data());
+      return result;
+    }
+
+    /// Contract this tile with \c other
+
+    /// \param other The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return <tt>factor * op(*this) * op(other)</tt> , which is stored
+    /// sparse if its fill is small enough
+    template <typename Scalar>
+    SparseTensor_ gemm(const SparseTensor_& other, const Scalar factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      tensor_type result;
+      return SparseTensor_(contract(result, *this, other, factor, gemm_helper));
+    }
+
+    /// Contract this tile with a dense tile
+
+    /// \param other The right-hand dense tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return The dense tile <tt>factor * op(*this) * op(other)</tt>
+    template <typename Scalar>
+    tensor_type gemm(const tensor_type& other, const Scalar factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      tensor_type result;
+      return contract(result, *this, other, factor, gemm_helper);
+    }
+
+    /// Contract two tiles and add the result to this tile
+
+    /// \param left The left-hand tile
+    /// \param right The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data
+    /// \return A reference to this tile
+    template <typename Scalar>
+    SparseTensor_& gemm(const SparseTensor_& left, const SparseTensor_& right,
+        const Scalar factor, const math::GemmHelper& gemm_helper)
+    {
+      if(empty())
+        return (*this = left.gemm(right, factor, gemm_helper));
+      tensor_type result = to_dense().clone();
+      *this = SparseTensor_(contract(result, left, right, factor, gemm_helper));
+      return *this;
+    }
+
+    // Reductions --------------------------------------------------------------
+
+    /// \return The sum of the elements
+    value_type sum() const {
+      if(is_dense())
+        return dense_.sum();
+      return (nnz_ ? values_.sum() : value_type(0));
+    }
+
+    /// \return The squared Frobenius norm
+    scalar_type squared_norm() const {
+      if(is_dense())
+        return dense_.squared_norm();
+      return (nnz_ ? values_.squared_norm() : scalar_type(0));
+    }
+
+    /// \return The Frobenius norm
+    scalar_type norm() const { return std::sqrt(squared_norm()); }
+
+    /// \param other The other tile
+    /// \return The dot product of the elements of this tile and \c other
+    value_type dot(const SparseTensor_& other) const {
+      TA_ASSERT(range_ == other.range_);
+      if(is_dense() && other.is_dense())
+        return dense_.dot(other.dense_);
+      if(is_dense())
+        return other.dot(*this);
+      value_type result(0);
+      size_type f = 0ul;
+      for(size_type e = 0ul; e < nnz_; ++e) {
+        if(other.is_dense()) {
+          result += values_[e] * other.dense_[indices_[e]];
+        } else {
+          while((f < other.nnz_) && (other.indices_[f] < indices_[e]))
+            ++f;
+          if((f < other.nnz_) && (other.indices_[f] == indices_[e]))
+            result += values_[e] * other.values_[f];
+        }
+      }
+      return result;
+    }
+
+    value_type inner_product(const SparseTensor_& other) const {
+      return to_dense().inner_product(other.to_dense());
+    }
+
+    value_type trace() const { return to_dense().trace(); }
+    value_type product() const { return to_dense().product(); }
+    scalar_type min() const { return to_dense().min(); }
+    scalar_type max() const { return to_dense().max(); }
+    scalar_type abs_min() const { return to_dense().abs_min(); }
+    scalar_type abs_max() const { return to_dense().abs_max(); }
+
+    auto compensated_sum() const -> decltype(tensor_type().compensated_sum()) {
+      return to_dense().compensated_sum();
+    }
+
+    auto compensated_squared_norm() const ->
+        decltype(tensor_type().compensated_squared_norm())
+    {
+      return to_dense().compensated_squared_norm();
+    }
+
+    auto compensated_dot(const SparseTensor_& other) const ->
+        decltype(tensor_type().compensated_dot(tensor_type()))
+    {
+      return to_dense().compensated_dot(other.to_dense());
+    }
+
+  }; // class SparseTensor
+
+  /// Contract a dense tile with a sparse tile
+
+  /// \param left The left-hand dense tile
+  /// \param right The right-hand sparse tile
+  /// \param factor The scaling factor
+  /// \param gemm_helper The *GEMM operation meta data
+  /// \return The dense tile <tt>factor * op(left) * op(right)</tt>
+  template <typename T, typename Scalar,
+      typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline Tensor<T> gemm(const Tensor<T>& left, const SparseTensor<T>& right,
+      const Scalar factor, const math::GemmHelper& gemm_helper)
+  {
+    Tensor<T> result;
+    return SparseTensor<T>::contract(result, left, right, factor, gemm_helper);
+  }
+
+  /// Contract a sparse tile with a dense tile and add it to a dense tile
+
+  /// \return <tt>result += factor * op(left) * op(right)</tt>
+  template <typename T, typename Scalar,
+      typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline Tensor<T>& gemm(Tensor<T>& result, const SparseTensor<T>& left,
+      const Tensor<T>& right, const Scalar factor,
+      const math::GemmHelper& gemm_helper)
+  {
+    return SparseTensor<T>::contract(result, left, right, factor, gemm_helper);
+  }
+
+  /// Contract a dense tile with a sparse tile and add it to a dense tile
+
+  /// \return <tt>result += factor * op(left) * op(right)</tt>
+  template <typename T, typename Scalar,
+      typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline Tensor<T>& gemm(Tensor<T>& result, const Tensor<T>& left,
+      const SparseTensor<T>& right, const Scalar factor,
+      const math::GemmHelper& gemm_helper)
+  {
+    return SparseTensor<T>::contract(result, left, right, factor, gemm_helper);
+  }
+
+  template <typename T>
+  inline std::ostream& operator<<(std::ostream& os, const SparseTensor<T>& tile) {
+    if(! tile.empty() && ! tile.is_dense())
+      os << "nnz " << tile.nnz() << ": ";
+    os << tile.to_dense();
+    return os;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_SPARSE_TENSOR_H__INCLUDED
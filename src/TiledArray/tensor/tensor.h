@@ -22,8 +22,15 @@
 
 #include <TiledArray/math/gemm_helper.h>
 #include <TiledArray/math/blas.h>
+#include <TiledArray/math/parallel_gemm.h>
 #include <TiledArray/tensor/kernels.h>
+#include <TiledArray/tensor/nested_kernels.h>
 #include <TiledArray/tensor/complex.h>
+#include <TiledArray/tensor/compression.h>
+#include <TiledArray/tensor/memory_tracker.h>
+#include <TiledArray/tensor/numa_allocator.h>
+#include <TiledArray/tensor/pool_allocator.h>
+#include <tiledarray_fwd.h>
 
 namespace TiledArray {
 
@@ -31,7 +38,7 @@ namespace TiledArray {
 
   /// \tparam T the value type of this tensor
   /// \tparam A The allocator type for the data
-  template <typename T, typename A = Eigen::aligned_allocator<T> >
+  template <typename T, typename A = default_allocator<T> >
   class Tensor {
   public:
     typedef Tensor<T, A> Tensor_; ///< This class type
@@ -73,7 +80,7 @@ namespace TiledArray {
       explicit Impl(const range_type& range) :
         allocator_type(), range_(range), data_(NULL)
       {
-        data_ = allocator_type::allocate(range.volume());
+        data_ = allocate_data(range.volume());
       }
 
       /// Construct with rvalue range
@@ -82,17 +89,51 @@ namespace TiledArray {
       explicit Impl(range_type&& range) :
         allocator_type(), range_(range), data_(NULL)
       {
-        data_ = allocator_type::allocate(range.volume());
+        data_ = allocate_data(range_.volume());
       }
 
+      /// Construct with range and shared data
+
+      /// \param range The N-dimensional range for this tensor
+      /// \param owner The owner of the memory that holds the data
+      /// \param data The tensor data, which is kept alive by \c owner
+      Impl(const range_type& range, const std::shared_ptr<void>& owner,
+          const pointer data) :
+        allocator_type(), range_(range), data_(data), owner_(owner)
+      { }
+
       ~Impl() {
-        math::destroy_vector(range_.volume(), data_);
-        allocator_type::deallocate(data_, range_.volume());
+        if(! owner_ && data_) {
+          math::destroy_vector(range_.volume(), data_);
+          deallocate_data(data_, range_.volume());
+        }
         data_ = NULL;
       }
 
+      /// Allocate data, and record it in the memory accounting of this process
+
+      /// \param n The number of elements
+      /// \return A pointer to uninitialized memory for \c n elements
+      pointer allocate_data(const size_type n) {
+        const pointer data = allocator_type::allocate(n);
+        if(n)
+          detail::MemoryTracker::instance().allocate(n * sizeof(value_type));
+        return data;
+      }
+
+      /// Release data that was allocated by \c allocate_data()
+
+      /// \param data The data to be released
+      /// \param n The number of elements of \c data
+      void deallocate_data(const pointer data, const size_type n) {
+        allocator_type::deallocate(data, n);
+        if(n)
+          detail::MemoryTracker::instance().deallocate(n * sizeof(value_type));
+      }
+
       range_type range_; ///< Tensor size info
       pointer data_; ///< Tensor data
+      std::shared_ptr<void> owner_; ///< Owner of shared tensor data
     }; // class Impl
 
     template <typename... Ts>
@@ -140,6 +181,22 @@ namespace TiledArray {
     }
 
 
+    /// Construct a tensor in shared memory
+
+    /// The tensor is a view of the <tt>range.volume()</tt> elements at
+    /// \c data , which are not initialized. The memory is released by
+    /// \c owner when the last tensor that shares it is destroyed, so many
+    /// small tensors can be allocated from one buffer.
+    /// \param range The range of the tensor
+    /// \param owner The owner of the memory that holds \c data
+    /// \param data A pointer to the first element of the tensor
+    template <typename U = value_type,
+        typename std::enable_if<std::is_scalar<U>::value>::type* = nullptr>
+    Tensor(const range_type& range, const std::shared_ptr<void>& owner,
+        const pointer data) :
+      pimpl_(std::make_shared<Impl>(range, owner, data))
+    { }
+
     /// Construct a tensor with a fill value
 
     /// \param range An array with the size of of each dimension
@@ -426,6 +483,105 @@ namespace TiledArray {
     /// data), otherwise \c false.
     bool empty() const { return !pimpl_; }
 
+    /// Test if this tensor is the sole owner of its data
+
+    /// Tensors are shallow copies of each other, so a tensor may be modified
+    /// in place without a defensive \c clone() only when no other tensor
+    /// refers to the same data. The data of a tensor in shared memory (e.g.
+    /// a shifted view) is also referenced by its owner.
+    /// \return \c true if this tensor is not empty and no other tensor
+    /// refers to its data, otherwise \c false.
+    bool is_unique() const {
+      return pimpl_ && (pimpl_.use_count() == 1l) &&
+          ((! pimpl_->owner_) || (pimpl_->owner_.use_count() == 1l));
+    }
+
+  private:
+
+    /// Store the elements of a tensor
+
+    /// \tparam Archive The output archive type
+    /// \param ar The output archive
+    /// \param data The elements
+    /// \param n The number of elements
+    template <typename Archive, typename U = value_type,
+        typename std::enable_if<! (std::is_floating_point<U>::value &&
+            detail::is_transfer_archive<Archive>::value)>::type* = nullptr>
+    static void store_data(Archive& ar, const value_type* data, const size_type n) {
+      ar & madness::archive::wrap(data, n);
+    }
+
+    /// Store the elements of a floating-point tensor in a message
+
+    /// The elements are compressed when \c TensorCompression is enabled and
+    /// the compressed data is smaller. A codec byte records the encoding.
+    /// \tparam Archive The output archive type
+    /// \param ar The output archive
+    /// \param data The elements
+    /// \param n The number of elements
+    template <typename Archive, typename U = value_type,
+        typename std::enable_if<std::is_floating_point<U>::value &&
+            detail::is_transfer_archive<Archive>::value>::type* = nullptr>
+    static void store_data(Archive& ar, const value_type* data, const size_type n) {
+      std::uint8_t codec = 0u;
+      std::vector<unsigned char> code;
+      if(TensorCompression::compress(n * sizeof(value_type))) {
+        const value_type tolerance =
+            (TensorCompression::mode() == TensorCompression::lossy ?
+            value_type(TensorCompression::tolerance()) : value_type(0));
+        code = detail::shuffle_encode(data, n, tolerance);
+        if(code.size() < n * sizeof(value_type))
+          codec = 1u;
+      }
+
+      ar & codec;
+      if(codec) {
+        ar & code.size();
+        ar & madness::archive::wrap(code.data(), code.size());
+      } else {
+        ar & madness::archive::wrap(data, n);
+      }
+    }
+
+    /// Load the elements of a tensor
+
+    /// \tparam Archive The input archive type
+    /// \param ar The input archive
+    /// \param[out] data The elements
+    /// \param n The number of elements
+    template <typename Archive, typename U = value_type,
+        typename std::enable_if<! (std::is_floating_point<U>::value &&
+            detail::is_transfer_archive<Archive>::value)>::type* = nullptr>
+    static void load_data(Archive& ar, value_type* data, const size_type n) {
+      ar & madness::archive::wrap(data, n);
+    }
+
+    /// Load the elements of a floating-point tensor from a message
+
+    /// \tparam Archive The input archive type
+    /// \param ar The input archive
+    /// \param[out] data The elements
+    /// \param n The number of elements
+    template <typename Archive, typename U = value_type,
+        typename std::enable_if<std::is_floating_point<U>::value &&
+            detail::is_transfer_archive<Archive>::value>::type* = nullptr>
+    static void load_data(Archive& ar, value_type* data, const size_type n) {
+      std::uint8_t codec = 0u;
+      ar & codec;
+      if(codec) {
+        TA_ASSERT(codec == 1u);
+        std::size_t bytes = 0ul;
+        ar & bytes;
+        std::vector<unsigned char> code(bytes);
+        ar & madness::archive::wrap(code.data(), bytes);
+        detail::shuffle_decode(code.data(), bytes, data, n);
+      } else {
+        ar & madness::archive::wrap(data, n);
+      }
+    }
+
+  public:
+
     /// Output serialization function
 
     /// This function enables serialization within MADNESS
@@ -437,7 +593,7 @@ namespace TiledArray {
     void serialize(Archive& ar) {
       if(pimpl_) {
         ar & pimpl_->range_.volume();
-        ar & madness::archive::wrap(pimpl_->data_, pimpl_->range_.volume());
+        store_data(ar, pimpl_->data_, pimpl_->range_.volume());
         ar & pimpl_->range_;
       } else {
         ar & size_type(0ul);
@@ -457,7 +613,7 @@ namespace TiledArray {
       ar & n;
       if(n) {
         std::shared_ptr<Impl> temp = std::make_shared<Impl>();
-        temp->data_ = temp->allocate(n);
+        temp->data_ = temp->allocate_data(n);
         try {
           // need to construct elements of data_ using placement new in case its default ctor is not trivial
           // N.B. for fundamental types and standard alloc this incurs no overhead (Eigen::aligned_alloc OK also)
@@ -465,10 +621,11 @@ namespace TiledArray {
           for(size_type i=0; i!=n; ++i, ++data_ptr)
             new(static_cast<void*>(data_ptr)) value_type;
 
-          ar & madness::archive::wrap(temp->data_, n);
+          load_data(ar, temp->data_, n);
           ar & temp->range_;
         } catch(...) {
-          temp->deallocate(temp->data_, n);
+          temp->deallocate_data(temp->data_, n);
+          temp->data_ = NULL;
           throw;
         }
 
@@ -553,6 +710,24 @@ namespace TiledArray {
       return result;
     }
 
+    /// Shift the lower and upper bound of a view of this tensor
+
+    /// The result shares the data of this tensor, so only the range is
+    /// constructed. The result is not unique (see \c is_unique() ) while this
+    /// tensor refers to the data.
+    /// \tparam Index The shift array type
+    /// \param bound_shift The shift to be applied to the tensor range
+    /// \return A shifted view of this tensor
+    template <typename Index>
+    Tensor_ shift_view(const Index& bound_shift) const {
+      TA_ASSERT(pimpl_);
+      Tensor_ result;
+      result.pimpl_ = std::make_shared<Impl>(pimpl_->range_, pimpl_,
+          pimpl_->data_);
+      result.shift_to(bound_shift);
+      return result;
+    }
+
     // Generic vector operations
 
     /// Use a binary, element wise operation to construct a new tensor
@@ -584,6 +759,26 @@ namespace TiledArray {
       return Tensor_(*this, right, op, perm);
     }
 
+    /// Use a binary, element wise operation to construct a new tensor and compute its norm
+
+    /// The squared norm of the result is accumulated while the result is
+    /// written, so it does not need a second pass over the result.
+    /// \tparam Right The right-hand tensor type
+    /// \tparam Op The binary operation type
+    /// \param right The right-hand argument in the binary operation
+    /// \param op The binary, element-wise operation
+    /// \param[out] squared_norm The squared norm of the result
+    /// \return A tensor where element \c i of the new tensor is equal to
+    /// \c op(*this[i],other[i])
+    template <typename Right, typename Op,
+        typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
+    Tensor_ binary(const Right& right, Op&& op, scalar_type& squared_norm) const {
+      Tensor_ result;
+      result.pimpl_ = std::make_shared<Impl>(detail::clone_range(*this));
+      squared_norm = detail::tensor_init_norm(op, result, *this, right);
+      return result;
+    }
+
     /// Use a binary, element wise operation to modify this tensor
 
     /// \tparam Right The right-hand tensor type
@@ -629,6 +824,24 @@ namespace TiledArray {
       return Tensor_(*this, op, perm);
     }
 
+    /// Use a unary, element wise operation to construct a new tensor and compute its norm
+
+    /// The squared norm of the result is accumulated while the result is
+    /// written, so it does not need a second pass over the result.
+    /// \tparam Op The unary operation type
+    /// \param op The unary, element-wise operation
+    /// \param[out] squared_norm The squared norm of the result
+    /// \return A tensor where element \c i of the new tensor is equal to
+    /// \c op(*this[i])
+    /// \throw TiledArray::Exception When this tensor is empty.
+    template <typename Op>
+    Tensor_ unary(Op&& op, scalar_type& squared_norm) const {
+      Tensor_ result;
+      result.pimpl_ = std::make_shared<Impl>(detail::clone_range(*this));
+      squared_norm = detail::tensor_init_norm(op, result, *this);
+      return result;
+    }
+
     /// Use a unary, element wise operation to modify this tensor
 
     /// \tparam Op The unary operation type
@@ -937,13 +1150,27 @@ namespace TiledArray {
     /// \return A new tensor where the elements are the product of the elements
     /// of \c this and \c right
     template <typename Right,
-        typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
+        typename std::enable_if<is_tensor<Right>::value &&
+        ! detail::is_nested_tensor<Tensor_, Right>::value>::type* = nullptr>
     Tensor_ mult(const Right& right) const {
       return binary(right, [] (const numeric_type l,
           const numeric_t<Right> r)
           -> numeric_type { return l * r; });
     }
 
+    /// Multiply this tensor of tensors by \c right to create a new tensor
+
+    /// The inner tensors of the result are allocated from one buffer.
+    /// \tparam Right The right-hand tensor of tensors type
+    /// \param right The tensor that will be multiplied by this tensor
+    /// \return A new tensor where the inner tensors are the element-wise
+    /// product of the inner tensors of \c this and \c right
+    template <typename Right,
+        typename std::enable_if<detail::is_nested_tensor<Tensor_, Right>::value>::type* = nullptr>
+    Tensor_ mult(const Right& right) const {
+      return detail::nested_mult<Tensor_>(*this, right, numeric_type(1));
+    }
+
     /// Multiply this by \c right to create a new, permuted tensor
 
     /// \tparam Right The right-hand tensor type
@@ -969,6 +1196,7 @@ namespace TiledArray {
     /// of \c this and \c right, scaled by \c factor
     template <typename Right, typename Scalar,
         typename std::enable_if<is_tensor<Right>::value &&
+        ! detail::is_nested_tensor<Tensor_, Right>::value &&
         detail::is_numeric<Scalar>::value>::type* = nullptr>
     Tensor_ mult(const Right& right, const Scalar factor) const {
       return binary(right, [=] (const numeric_type l,
@@ -976,6 +1204,23 @@ namespace TiledArray {
           -> numeric_type { return (l * r) * factor; });
     }
 
+    /// Scale and multiply this tensor of tensors by \c right to create a new tensor
+
+    /// The inner tensors of the result are allocated from one buffer.
+    /// \tparam Right The right-hand tensor of tensors type
+    /// \tparam Scalar A scalar type
+    /// \param right The tensor that will be multiplied by this tensor
+    /// \param factor The scaling factor
+    /// \return A new tensor where the inner tensors are the element-wise
+    /// product of the inner tensors of \c this and \c right, scaled by
+    /// \c factor
+    template <typename Right, typename Scalar,
+        typename std::enable_if<detail::is_nested_tensor<Tensor_, Right>::value &&
+        detail::is_numeric<Scalar>::value>::type* = nullptr>
+    Tensor_ mult(const Right& right, const Scalar factor) const {
+      return detail::nested_mult<Tensor_>(*this, right, factor);
+    }
+
     /// Scale and multiply this by \c right to create a new, permuted tensor
 
     /// \tparam Right The right-hand tensor type
@@ -1127,13 +1372,16 @@ namespace TiledArray {
     /// \param other The tensor that will be contracted with this tensor
     /// \param factor Multiply the result by this constant
     /// \param gemm_helper The *GEMM operation meta data
+    /// \param[out] squared_norm The squared norm of the result, which is
+    /// computed while the result is in cache, or null [ default = null ]
     /// \return A new tensor which is the result of contracting this tensor with
     /// \c other and scaled by \c factor
     template <typename U, typename AU, typename V,
               typename std::enable_if<!detail::is_tensor_of_tensor<
                   Tensor_, Tensor<U, AU>>::value>::type* = nullptr>
     Tensor_ gemm(const Tensor<U, AU>& other, const V factor,
-                 const math::GemmHelper& gemm_helper) const {
+                 const math::GemmHelper& gemm_helper,
+                 scalar_type* const squared_norm = nullptr) const {
       // Check that this tensor is not empty and has the correct rank
       TA_ASSERT(pimpl_);
       TA_ASSERT(pimpl_->range_.rank() == gemm_helper.left_rank());
@@ -1159,12 +1407,40 @@ namespace TiledArray {
       const integer lda = (gemm_helper.left_op() == madness::cblas::NoTrans ? k : m);
       const integer ldb = (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
 
-      math::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
-          pimpl_->data_, lda, other.data(), ldb, numeric_type(0), result.data(), n);
+      math::parallel_gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
+          pimpl_->data_, lda, other.data(), ldb, numeric_type(0), result.data(), n,
+          squared_norm);
 
       return result;
     }
 
+    /// Contract this tensor of tensors with \c other
+
+    /// The outer tensors are contracted as given by \c gemm_helper , and the
+    /// inner tensors of each pair of outer elements are multiplied
+    /// element-wise. The inner tensors of the result are allocated from one
+    /// buffer.
+    /// \tparam U The other tensor element type
+    /// \tparam AU The other tensor allocator type
+    /// \tparam V The type of \c factor scalar
+    /// \param other The tensor that will be contracted with this tensor
+    /// \param factor Multiply the result by this constant
+    /// \param gemm_helper The *GEMM operation meta data of the outer tensors
+    /// \return A new tensor which is the result of contracting this tensor with
+    /// \c other and scaled by \c factor
+    template <typename U, typename AU, typename V,
+              typename std::enable_if<detail::is_nested_tensor<
+                  Tensor_, Tensor<U, AU>>::value>::type* = nullptr>
+    Tensor_ gemm(const Tensor<U, AU>& other, const V factor,
+                 const math::GemmHelper& gemm_helper) const {
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(pimpl_->range_.rank() == gemm_helper.left_rank());
+      TA_ASSERT(!other.empty());
+      TA_ASSERT(other.range().rank() == gemm_helper.right_rank());
+
+      return detail::nested_gemm<Tensor_>(*this, other, factor, gemm_helper);
+    }
+
     /// Contract two tensors and accumulate the scaled result to this tensor
 
     /// GEMM is limited to matrix like contractions. For example, the following
@@ -1203,13 +1479,17 @@ namespace TiledArray {
     /// \param right The right-hand tensor that will be contracted
     /// \param factor The contraction result will be scaling by this value, then accumulated into \c this
     /// \param gemm_helper The *GEMM operation meta data
+    /// \param[out] squared_norm The squared norm of the accumulated result,
+    /// which is computed while the result is in cache, or null [ default =
+    /// null ]
     /// \return A reference to \c this
     template <
         typename U, typename AU, typename V, typename AV, typename W,
         typename std::enable_if<!detail::is_tensor_of_tensor<
             Tensor_, Tensor<U, AU>, Tensor<V, AV>>::value>::type* = nullptr>
     Tensor_& gemm(const Tensor<U, AU>& left, const Tensor<V, AV>& right,
-                  const W factor, const math::GemmHelper& gemm_helper) {
+                  const W factor, const math::GemmHelper& gemm_helper,
+                  scalar_type* const squared_norm = nullptr) {
       // Check that this tensor is not empty and has the correct rank
       TA_ASSERT(pimpl_);
       TA_ASSERT(pimpl_->range_.rank() == gemm_helper.result_rank());
@@ -1256,8 +1536,42 @@ namespace TiledArray {
       const integer ldb =
           (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
 
-      math::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
-          left.data(), lda, right.data(), ldb, numeric_type(1), pimpl_->data_, n);
+      math::parallel_gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
+          left.data(), lda, right.data(), ldb, numeric_type(1), pimpl_->data_, n,
+          squared_norm);
+
+      return *this;
+    }
+
+    /// Contract two tensors of tensors and accumulate the scaled result to this tensor
+
+    /// The outer tensors are contracted as given by \c gemm_helper , and the
+    /// inner tensors of each pair of outer elements are multiplied
+    /// element-wise and added to the inner tensors of \c this .
+    /// \tparam U The left-hand tensor element type
+    /// \tparam AU The left-hand tensor allocator type
+    /// \tparam V The right-hand tensor element type
+    /// \tparam AV The right-hand tensor allocator type
+    /// \tparam W The type of the scaling factor
+    /// \param left The left-hand tensor that will be contracted
+    /// \param right The right-hand tensor that will be contracted
+    /// \param factor The contraction result will be scaling by this value, then accumulated into \c this
+    /// \param gemm_helper The *GEMM operation meta data of the outer tensors
+    /// \return A reference to \c this
+    template <
+        typename U, typename AU, typename V, typename AV, typename W,
+        typename std::enable_if<detail::is_nested_tensor<
+            Tensor_, Tensor<U, AU>, Tensor<V, AV>>::value>::type* = nullptr>
+    Tensor_& gemm(const Tensor<U, AU>& left, const Tensor<V, AV>& right,
+                  const W factor, const math::GemmHelper& gemm_helper) {
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(pimpl_->range_.rank() == gemm_helper.result_rank());
+      TA_ASSERT(!left.empty());
+      TA_ASSERT(left.range().rank() == gemm_helper.left_rank());
+      TA_ASSERT(!right.empty());
+      TA_ASSERT(right.range().rank() == gemm_helper.right_rank());
+
+      detail::nested_gemm_to(*this, left, right, factor, gemm_helper);
 
       return *this;
     }
@@ -1476,6 +1790,94 @@ namespace TiledArray {
       return reduce(other, mult_add_op, add_op, numeric_type(0));
     }
 
+    /// Vector dot product with a permuted tensor
+
+    /// \tparam Right The right-hand tensor type
+    /// \param other The right-hand tensor to be reduced, which has the range
+    /// <tt>perm * range()</tt>
+    /// \param perm The permutation that maps the indices of this tensor to
+    /// those of \c other
+    /// \return The dot product of <tt>permute(*this, perm)</tt> and \c other ,
+    /// which is computed without a permuted copy
+    /// \sa detail::permute_reduce()
+    template <typename Right,
+        typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
+    numeric_type dot(const Right& other, const Permutation& perm) const {
+      if(! perm)
+        return dot(other);
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(other.range() == (perm * pimpl_->range_));
+      numeric_type result(0);
+      detail::permute_reduce([&result] (const numeric_type l, const numeric_t<Right> r)
+          { result += l * r; }, *this, perm, other);
+      return result;
+    }
+
+    /// Vector inner product with a permuted tensor
+
+    /// \tparam Right The right-hand tensor type
+    /// \param other The right-hand tensor to be reduced, which has the range
+    /// <tt>perm * range()</tt>
+    /// \param perm The permutation that maps the indices of this tensor to
+    /// those of \c other
+    /// \return The inner product of <tt>permute(*this, perm)</tt> and
+    /// \c other , which is computed without a permuted copy
+    /// \sa detail::permute_reduce()
+    template <typename Right,
+        typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
+    numeric_type inner_product(const Right& other, const Permutation& perm) const {
+      if(! perm)
+        return inner_product(other);
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(other.range() == (perm * pimpl_->range_));
+      numeric_type result(0);
+      detail::permute_reduce([&result] (const numeric_type l, const numeric_t<Right> r)
+          { result += TiledArray::detail::inner_product(l, r); }, *this, perm, other);
+      return result;
+    }
+
+    /// Compensated sum of elements
+
+    /// The rounding errors of the sum are accumulated in a correction term,
+    /// so the error does not grow with the number of elements.
+    /// \return The compensated sum of all elements of this tensor
+    math::CompensatedSum<numeric_type> compensated_sum() const {
+      auto term_op = [] (const numeric_type arg) { return arg; };
+      math::CompensatedSum<numeric_type> result;
+      detail::tensor_compensated_reduce(term_op, result, *this);
+      return result;
+    }
+
+    /// Compensated square of vector 2-norm
+
+    /// \return The compensated sum of the squared elements of this tensor
+    /// \sa Tensor::compensated_sum
+    math::CompensatedSum<scalar_type> compensated_squared_norm() const {
+      auto square_op = [] (const numeric_type arg)
+              { return scalar_type(TiledArray::detail::norm(arg)); };
+      math::CompensatedSum<scalar_type> result;
+      detail::tensor_compensated_reduce(square_op, result, *this);
+      return result;
+    }
+
+    /// Compensated vector dot product
+
+    /// \tparam Right The right-hand tensor type
+    /// \param other The right-hand tensor to be reduced
+    /// \return The compensated dot product of this and \c other
+    /// \sa Tensor::compensated_sum
+    template <typename Right,
+        typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
+    math::CompensatedSum<numeric_type> compensated_dot(const Right& other) const {
+      auto mult_op = [] (const numeric_type l, const numeric_t<Right> r)
+              { return numeric_type(l * r); };
+      math::CompensatedSum<numeric_type> result;
+      detail::tensor_compensated_reduce(mult_op, result, *this, other);
+      return result;
+    }
+
   }; // class Tensor
 
   template <typename T, typename A>
@@ -1519,17 +1921,17 @@ namespace TiledArray {
 #ifndef TILEDARRAY_HEADER_ONLY
 
   extern template
-  class Tensor<double, Eigen::aligned_allocator<double> >;
+  class Tensor<double, default_allocator<double> >;
   extern template
-  class Tensor<float, Eigen::aligned_allocator<float> >;
+  class Tensor<float, default_allocator<float> >;
   extern template
-  class Tensor<int, Eigen::aligned_allocator<int> >;
+  class Tensor<int, default_allocator<int> >;
   extern template
-  class Tensor<long, Eigen::aligned_allocator<long> >;
+  class Tensor<long, default_allocator<long> >;
 //  extern template
-//  class Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >;
+//  class Tensor<std::complex<double>, default_allocator<std::complex<double> > >;
 //  extern template
-//  class Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >;
+//  class Tensor<std::complex<float>, default_allocator<std::complex<float> > >;
 
 #endif // TILEDARRAY_HEADER_ONLY
 
@@ -28,13 +28,7 @@
 
 #include <TiledArray/tensor/kernels.h>
 #include <TiledArray/tensor/complex.h>
-
-namespace Eigen {
-
-  // Forward declarations
-  template <typename> class aligned_allocator;
-
-} // namespace Eigen
+#include <tiledarray_fwd.h>
 
 namespace TiledArray {
 
@@ -97,7 +91,7 @@ namespace TiledArray {
       typedef typename detail::scalar_type<value_type>::type
           scalar_type; ///< the scalar type that supports T
 
-      typedef Tensor<T, Eigen::aligned_allocator<T> > result_tensor;
+      typedef Tensor<T, default_allocator<T> > result_tensor;
              ///< Tensor type used as the return type from arithmetic operations
 
     private:
@@ -145,6 +145,29 @@ namespace TiledArray {
                                  && is_contiguous_tensor<T2, Ts...>::value;
     };
 
+    // Test if the tensor is a tensor of tensors where the outer and inner
+    // tensors are Tensor objects, so that the inner data are contiguous
+
+    template <typename T>
+    struct is_nested_tensor_helper : public std::false_type { };
+
+    template <typename T, typename AT, typename A>
+    struct is_nested_tensor_helper<Tensor<Tensor<T, AT>, A> > :
+        public std::true_type { };
+
+    template <typename...Ts> struct is_nested_tensor;
+
+    template <> struct is_nested_tensor<> : public std::false_type { };
+
+    template <typename T>
+    struct is_nested_tensor<T> : public is_nested_tensor_helper<T> { };
+
+    template <typename T1, typename T2, typename... Ts>
+    struct is_nested_tensor<T1, T2, Ts...> {
+      static constexpr bool value = is_nested_tensor_helper<T1>::value
+                                 && is_nested_tensor<T2, Ts...>::value;
+    };
+
     // Test if the tensor is shifted
 
     template <typename T>
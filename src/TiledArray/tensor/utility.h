@@ -31,6 +31,10 @@
 #include <TiledArray/block_range.h>
 #include <TiledArray/size_array.h>
 #include <TiledArray/tensor/type_traits.h>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
@@ -365,6 +369,93 @@ namespace TiledArray {
     }
 
 
+    /// Offsets of the contiguous runs of congruent ranges
+
+    /// The elements of a strided range (e.g. the range of a
+    /// \c TensorInterface view) are visited, in row-major order, as runs of
+    /// \c run_size elements with unit stride, where \c run_size is the
+    /// product of the extents of the innermost dimensions, e.g. the
+    /// result of \c inner_size() . The offset of the current run in the data
+    /// of each of the \c N ranges is updated incrementally with the strides
+    /// of the outer dimensions, instead of being computed from an ordinal
+    /// index with a division per dimension, so the kernels loop over the
+    /// elements of each run with vector operations.
+    /// \code
+    /// RangeRuns<2> runs(stride, result.range(), arg.range());
+    /// for(std::size_t i = 0ul; i < volume; i += stride, runs.next())
+    ///   runs.apply([=] (auto* r, const auto* a)
+    ///       { math::inplace_vector_op(op, stride, r, a); },
+    ///       result.data(), arg.data());
+    /// \endcode
+    /// \tparam N The number of ranges
+    template <std::size_t N>
+    class RangeRuns {
+      typedef std::size_t size_type;
+
+      unsigned int outer_ = 0u; ///< The number of dimensions outside the runs
+      const size_type* extent_ = nullptr; ///< The extents of the ranges
+      std::array<const size_type*, N> stride_; ///< The strides of each range
+      std::array<size_type, N> offset_; ///< The offsets of the current run
+      std::vector<size_type> index_; ///< The outer index of the current run
+
+      template <typename Op, typename... Ptrs, std::size_t... Is>
+      void apply_(Op&& op, std::index_sequence<Is...>, Ptrs... ptrs) const {
+        op((ptrs + offset_[Is])...);
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \tparam Ranges The range types
+      /// \param run_size The number of elements of each run
+      /// \param ranges The congruent ranges
+      template <typename... Ranges>
+      RangeRuns(const size_type run_size, const Ranges&... ranges) :
+        stride_{{ ranges.stride_data()... }}, offset_{{ ranges.ordinal(size_type(0))... }}
+      {
+        static_assert(sizeof...(Ranges) == N, "RangeRuns: wrong number of ranges");
+        const auto& range0 = std::get<0>(std::tie(ranges...));
+        extent_ = range0.extent_data();
+        outer_ = range0.rank();
+        for(size_type size = 1ul; (outer_ > 0u) && (size < run_size); )
+          size *= extent_[--outer_];
+        index_.assign(outer_, 0ul);
+      }
+
+      /// Advance to the next run
+      void next() {
+        for(unsigned int d = outer_; d > 0u; ) {
+          --d;
+          for(std::size_t k = 0ul; k < N; ++k)
+            offset_[k] += stride_[k][d];
+          if(++index_[d] < extent_[d])
+            return;
+          for(std::size_t k = 0ul; k < N; ++k)
+            offset_[k] -= extent_[d] * stride_[k][d];
+          index_[d] = 0ul;
+        }
+      }
+
+      /// \param k The index of a range
+      /// \return The offset of the current run in the data of range \c k
+      size_type offset(const std::size_t k) const { return offset_[k]; }
+
+      /// Apply an operation to the current run
+
+      /// \tparam Op The operation type
+      /// \tparam Ptrs The data pointer types
+      /// \param op The operation, called with the pointers to the current run
+      /// \param ptrs The pointers to the data of the ranges
+      template <typename Op, typename... Ptrs>
+      void apply(Op&& op, Ptrs... ptrs) const {
+        static_assert(sizeof...(Ptrs) == N, "RangeRuns: wrong number of pointers");
+        apply_(std::forward<Op>(op), std::make_index_sequence<N>(), ptrs...);
+      }
+
+    }; // class RangeRuns
+
+
     /// Test for empty tensors in an empty list
 
     /// This function is used as the termination step for the recursive empty()
@@ -49,7 +49,7 @@ namespace TiledArray {
     private:
       World& world_; ///< World that contains
       const trange_type trange_; ///< Tiled range type
-      const shape_type shape_; ///< Tensor shape
+      shape_type shape_; ///< Tensor shape
       std::shared_ptr<pmap_interface> pmap_; ///< Process map for tiles
 
     public:
@@ -155,6 +155,19 @@ namespace TiledArray {
       /// \throw TiledArray::Exception When this tensor is dense
       const shape_type& shape() const { return shape_; }
 
+    protected:
+
+      /// Replace the tensor shape
+
+      /// \param shape The new shape of this tensor
+      /// \note No task that uses the shape may be running.
+      void shape(const shape_type& shape) {
+        TA_ASSERT(shape.validate(trange_.tiles_range()));
+        shape_ = shape;
+      }
+
+    public:
+
       /// Tiled range accessor
 
       /// \return The tiled range of the tensor
@@ -22,6 +22,7 @@
 
 #include <TiledArray/tile_op/tile_interface.h>
 #include <TiledArray/tile_interface/cast.h>
+#include <TiledArray/tile_interface/clone.h>
 #include <memory>
 
 // Forward declaration of MADNESS archive type traits
@@ -72,6 +73,9 @@ namespace TiledArray {
   /// \li \c abs_min
   /// \li \c abs_max
   /// \li \c dot
+  /// \li \c compensated_sum
+  /// \li \c compensated_squared_norm
+  /// \li \c compensated_dot
   /// as for the intrusive or non-instrusive interface. See the
   /// \ref NonIntrusiveTileInterface "non-intrusive tile interface"
   /// documentation for more details.
@@ -144,6 +148,11 @@ namespace TiledArray {
       return not bool(pimpl_);
     }
 
+    bool is_unique() const {
+      return pimpl_ && (pimpl_.use_count() == 1l) &&
+          TiledArray::is_unique(*pimpl_);
+    }
+
     // Tile accessor -----------------------------------------------------------
 
     tensor_type& tensor() { return *pimpl_; }
@@ -348,6 +357,18 @@ namespace TiledArray {
     return arg;
   }
 
+  /// Shift the range of a view of \c arg
+
+  /// \tparam Arg The tensor argument type
+  /// \tparam Index An array type
+  /// \param arg The tile argument to be shifted
+  /// \param range_shift The offset to be applied to the argument range
+  /// \return A tile with a new range that shares the data of \c arg
+  template <typename Arg, typename Index>
+  inline decltype(auto)
+  shift_view(const Tile<Arg>& arg, const Index& range_shift)
+  { return detail::make_tile(shift_view(arg.tensor(), range_shift)); }
+
 
   // Addition operations -------------------------------------------------------
 
@@ -977,6 +998,38 @@ namespace TiledArray {
   inline decltype(auto) dot(const Tile<Left>& left, const Tile<Right>& right)
   { return dot(left.tensor(), right.tensor()); }
 
+  /// Compensated sum of the elements of a tile
+
+  /// \tparam Arg The tile argument type
+  /// \param arg The argument to be summed
+  /// \return A \c math::CompensatedSum that is equal to <tt>sum_i arg[i]</tt>
+  template <typename Arg>
+  inline decltype(auto) compensated_sum(const Tile<Arg>& arg)
+  { return compensated_sum(arg.tensor()); }
+
+  /// Compensated squared vector 2-norm of the elements of a tile
+
+  /// \tparam Arg The tile argument type
+  /// \param arg The argument to be multiplied and summed
+  /// \return A \c math::CompensatedSum that is equal to
+  /// <tt>sum_i arg[i] * arg[i]</tt>
+  template <typename Arg>
+  inline decltype(auto) compensated_squared_norm(const Tile<Arg>& arg)
+  { return compensated_squared_norm(arg.tensor()); }
+
+  /// Compensated vector dot product of two tiles
+
+  /// \tparam Left The left-hand argument type
+  /// \tparam Right The right-hand argument type
+  /// \param left The left-hand argument tile
+  /// \param right The right-hand argument tile
+  /// \return A \c math::CompensatedSum that is equal to
+  /// <tt>sum_i left[i] * right[i]</tt>
+  template <typename Left, typename Right>
+  inline decltype(auto) compensated_dot(const Tile<Left>& left,
+      const Tile<Right>& right)
+  { return compensated_dot(left.tensor(), right.tensor()); }
+
   // Tile arithmetic operators -------------------------------------------------
 
 
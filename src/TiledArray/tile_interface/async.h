@@ -0,0 +1,87 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  async.h
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_INTERFACE_ASYNC_H__INCLUDED
+#define TILEDARRAY_TILE_INTERFACE_ASYNC_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <type_traits>
+#include <utility>
+
+namespace TiledArray {
+
+  /// Asynchronous tile operation trait
+
+  /// The operations of an asynchronous tile type may return before their
+  /// kernels complete, e.g. after queuing them on a device stream. The
+  /// distributed evaluators then do not wait for the kernels; the result
+  /// tile is published as a future that is set once it is ready, and the
+  /// worker thread picks up other tasks in the meantime. A tile type opts
+  /// in by specializing this class with:
+  /// \li <tt>static constexpr bool is_async = true;</tt>
+  /// \li \c scope_type , a default constructible guard; the operations that
+  ///     run on the calling thread while it exists may return before their
+  ///     kernels complete
+  /// \li <tt>static Future<T> when_ready(T&& tile)</tt> , which returns
+  ///     without blocking a future that is set with \c tile once the
+  ///     kernels that produce it have completed
+  ///
+  /// Tile operations may also return \c Future<T> directly; such results
+  /// are used as they are.
+  /// The default implementation is used by synchronous tiles.
+  /// \tparam T The tile type
+  template <typename T, typename Enabler = void>
+  struct async_trait {
+    static constexpr bool is_async = false;
+  }; // struct async_trait
+
+  namespace detail {
+
+    /// Invoke a tile operation that returns a future or a synchronous tile
+
+    /// \return The result of <tt>op(args...)</tt>
+    template <typename Op, typename... Args,
+        typename Result = decltype(std::declval<Op&>()(std::declval<Args>()...)),
+        typename std::enable_if<madness::is_future<Result>::value ||
+            ! async_trait<Result>::is_async>::type* = nullptr>
+    inline Result async_invoke(Op& op, Args&&... args) {
+      return op(std::forward<Args>(args)...);
+    }
+
+    /// Invoke a tile operation of an asynchronous tile type
+
+    /// The operation is evaluated within the asynchronous scope of the
+    /// result tile type, so it returns once its kernels are issued.
+    /// \return A future to the result of <tt>op(args...)</tt> , which is set
+    /// when the result is ready
+    template <typename Op, typename... Args,
+        typename Result = decltype(std::declval<Op&>()(std::declval<Args>()...)),
+        typename std::enable_if<! madness::is_future<Result>::value &&
+            async_trait<Result>::is_async>::type* = nullptr>
+    inline Future<Result> async_invoke(Op& op, Args&&... args) {
+      typename async_trait<Result>::scope_type scope;
+      return async_trait<Result>::when_ready(op(std::forward<Args>(args)...));
+    }
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_INTERFACE_ASYNC_H__INCLUDED
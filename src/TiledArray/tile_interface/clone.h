@@ -27,6 +27,7 @@
 #define TILEDARRAY_TILE_INTERFACE_CLONE_H__INCLUDED
 
 #include "../type_traits.h"
+#include "../tile_interface/cast.h"
 
 namespace TiledArray {
 
@@ -41,6 +42,42 @@ namespace TiledArray {
     return arg.clone();
   }
 
+  namespace detail {
+
+    GENERATE_HAS_MEMBER_FUNCTION_ANYRETURN(is_unique)
+
+  } // namespace detail
+
+  /// Check that \c arg is the sole owner of its data
+
+  /// A tile that does not share its data with any other tile may be modified
+  /// in place instead of being cloned. This version is used for tile types
+  /// that provide an \c is_unique() member function.
+  /// \tparam Arg The tile argument type
+  /// \param arg The tile argument to be checked
+  /// \return \c arg.is_unique()
+  template <typename Arg,
+      typename std::enable_if<
+          detail::has_member_function_is_unique_anyreturn<const Arg>::value
+      >::type* = nullptr>
+  inline bool is_unique(const Arg& arg) {
+    return arg.is_unique();
+  }
+
+  /// Check that \c arg is the sole owner of its data
+
+  /// Tile types without an \c is_unique() member function are assumed to
+  /// share their data.
+  /// \tparam Arg The tile argument type
+  /// \return \c false
+  template <typename Arg,
+      typename std::enable_if<
+          ! detail::has_member_function_is_unique_anyreturn<const Arg>::value
+      >::type* = nullptr>
+  inline bool is_unique(const Arg&) {
+    return false;
+  }
+
   namespace tile_interface {
 
     using TiledArray::clone;
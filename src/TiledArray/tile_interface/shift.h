@@ -55,6 +55,45 @@ namespace TiledArray {
   { return arg.shift_to(range_shift); }
 
 
+  namespace detail {
+
+    GENERATE_HAS_MEMBER_FUNCTION_ANYRETURN(shift_view)
+
+  } // namespace detail
+
+  /// Shift the range of a view of \c arg
+
+  /// The result shares the data of \c arg . This version is used for tile
+  /// types that provide a \c shift_view() member function.
+  /// \tparam Arg The tile argument type
+  /// \tparam Index An array type
+  /// \param arg The tile argument to be shifted
+  /// \param range_shift The offset to be applied to the argument range
+  /// \return A view of \c arg with a new range
+  template <typename Arg, typename Index,
+      typename std::enable_if<
+          detail::has_member_function_shift_view_anyreturn<const Arg,
+              const Index&>::value
+      >::type* = nullptr>
+  inline auto shift_view(const Arg& arg, const Index& range_shift)
+  { return arg.shift_view(range_shift); }
+
+  /// Shift the range of a copy of \c arg
+
+  /// Tile types without a \c shift_view() member function are copied.
+  /// \tparam Arg The tile argument type
+  /// \tparam Index An array type
+  /// \param arg The tile argument to be shifted
+  /// \param range_shift The offset to be applied to the argument range
+  /// \return A copy of \c arg with a new range
+  template <typename Arg, typename Index,
+      typename std::enable_if<
+          ! detail::has_member_function_shift_view_anyreturn<const Arg,
+              const Index&>::value
+      >::type* = nullptr>
+  inline auto shift_view(const Arg& arg, const Index& range_shift)
+  { return shift(arg, range_shift); }
+
   namespace tile_interface {
 
     using TiledArray::shift;
@@ -0,0 +1,258 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  batched_contract_reduce.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_OP_BATCHED_CONTRACT_REDUCE_H__INCLUDED
+#define TILEDARRAY_TILE_OP_BATCHED_CONTRACT_REDUCE_H__INCLUDED
+
+#include <TiledArray/permutation.h>
+#include <TiledArray/math/blas.h>
+#include <TiledArray/tile_op/tile_interface.h>
+#include "../tile_interface/add.h"
+#include "../tile_interface/permute.h"
+#include <TiledArray/task_trace.h>
+#include <TiledArray/work_counter.h>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Batched contract and (sum) reduce operation
+
+    /// Contracts tensors whose leading (batch) dimensions are shared by both
+    /// arguments and the result, but are not summed, i.e.
+    /// \f$ C_{b m n} = \alpha \sum_k A_{b m k} B_{b k n} \f$ where \c b , \c m ,
+    /// \c n , and \c k may each be several dimensions. The left-hand tiles
+    /// are laid out as (batch, left outer, inner), the right-hand tiles as
+    /// (batch, inner, right outer), and the result tiles as (batch, left
+    /// outer, right outer), so each batch element of a tile pair is one
+    /// contiguous GEMM. This operation has the interface of
+    /// \c ContractReduce and may be used with \c ReducePairTask .
+    /// \tparam Result The result tile type, a \c Tensor
+    /// \tparam Left The left-hand tile type, a \c Tensor
+    /// \tparam Right The right-hand tile type, a \c Tensor
+    /// \tparam Scalar The scaling factor type
+    template <typename Result, typename Left, typename Right, typename Scalar>
+    class BatchedContractReduce {
+    public:
+      typedef BatchedContractReduce<Result, Left, Right, Scalar>
+          BatchedContractReduce_; ///< This class type
+      typedef const Left& first_argument_type; ///< The left tile type
+      typedef const Right& second_argument_type; ///< The right tile type
+      typedef Result result_type; ///< The result tile type
+      typedef Scalar scalar_type; ///< The scaling factor type
+
+    private:
+
+      struct Impl {
+        Impl(const scalar_type alpha, const unsigned int batch_rank,
+            const unsigned int result_rank, const unsigned int left_rank,
+            const unsigned int right_rank, const Permutation& perm) :
+          alpha_(alpha), batch_rank_(batch_rank), result_rank_(result_rank),
+          left_rank_(left_rank), right_rank_(right_rank),
+          inner_rank_((left_rank + right_rank - result_rank - batch_rank) >> 1),
+          perm_(perm)
+        {
+          TA_ASSERT(batch_rank_ > 0u);
+          TA_ASSERT((left_rank + right_rank) >= (result_rank + batch_rank));
+        }
+
+        scalar_type alpha_; ///< Scaling factor of the contraction
+        unsigned int batch_rank_; ///< The number of batch dimensions
+        unsigned int result_rank_; ///< The rank of the result tiles
+        unsigned int left_rank_; ///< The rank of the left-hand tiles
+        unsigned int right_rank_; ///< The rank of the right-hand tiles
+        unsigned int inner_rank_; ///< The number of contracted dimensions
+        Permutation perm_; ///< Permutation that is applied to the final result
+      };
+
+      std::shared_ptr<Impl> pimpl_;
+
+      /// Product of a range of extents
+
+      /// \param extent The extents of a tile range
+      /// \param first The first dimension
+      /// \param last The last dimension + 1
+      /// \return The product of the extents of dimensions [first, last)
+      template <typename Extent>
+      static integer volume(const Extent* const extent,
+          const unsigned int first, const unsigned int last)
+      {
+        integer result = 1;
+        for(unsigned int i = first; i < last; ++i)
+          result *= extent[i];
+        return result;
+      }
+
+      /// Construct a zero result tile for a tile pair
+
+      /// \param left The left-hand tile
+      /// \param right The right-hand tile
+      /// \return A zero tile with the range of the product of \c left and
+      /// \c right
+      result_type make_result(const Left& left, const Right& right) const {
+        const unsigned int left_outer_end = left.range().rank() - pimpl_->inner_rank_;
+        std::vector<std::size_t> lower, upper;
+        lower.reserve(pimpl_->result_rank_);
+        upper.reserve(pimpl_->result_rank_);
+        for(unsigned int i = 0u; i < left_outer_end; ++i) {
+          lower.push_back(left.range().lobound_data()[i]);
+          upper.push_back(left.range().upbound_data()[i]);
+        }
+        for(unsigned int i = pimpl_->batch_rank_ + pimpl_->inner_rank_;
+            i < pimpl_->right_rank_; ++i)
+        {
+          lower.push_back(right.range().lobound_data()[i]);
+          upper.push_back(right.range().upbound_data()[i]);
+        }
+        return result_type(typename result_type::range_type(lower, upper),
+            typename result_type::numeric_type(0));
+      }
+
+    public:
+
+      // Compiler generated defaults are fine. N.B. this is shallow-copy.
+
+      BatchedContractReduce() = default;
+      BatchedContractReduce(const BatchedContractReduce_&) = default;
+      BatchedContractReduce(BatchedContractReduce_&&) = default;
+      ~BatchedContractReduce() = default;
+      BatchedContractReduce_& operator=(const BatchedContractReduce_&) = default;
+      BatchedContractReduce_& operator=(BatchedContractReduce_&&) = default;
+
+      /// Construct batched contract/reduce functor
+
+      /// \param alpha The scaling factor applied to the contracted tiles
+      /// \param batch_rank The number of batch dimensions
+      /// \param result_rank The rank of the result tensor
+      /// \param left_rank The rank of the left-hand tensor
+      /// \param right_rank The rank of the right-hand tensor
+      /// \param perm The permutation to be applied to the result tensor
+      /// (default = no permute)
+      BatchedContractReduce(const scalar_type alpha, const unsigned int batch_rank,
+          const unsigned int result_rank, const unsigned int left_rank,
+          const unsigned int right_rank, const Permutation& perm = Permutation()) :
+        pimpl_(std::make_shared<Impl>(alpha, batch_rank, result_rank, left_rank,
+            right_rank, perm))
+      { }
+
+      /// Permutation accessor
+
+      /// \return A const reference to the permutation for this operation
+      const Permutation& perm() const {
+        TA_ASSERT(pimpl_);
+        return pimpl_->perm_;
+      }
+
+      /// Scaling factor accessor
+
+      /// \return The scaling factor for this operation
+      scalar_type factor() const {
+        TA_ASSERT(pimpl_);
+        return pimpl_->alpha_;
+      }
+
+      /// Batch rank accessor
+
+      /// \return The number of batch dimensions
+      unsigned int batch_rank() const {
+        TA_ASSERT(pimpl_);
+        return pimpl_->batch_rank_;
+      }
+
+      /// Create a result type object
+
+      /// Initialize a result object for subsequent reductions
+      result_type operator()() const { return result_type(); }
+
+      /// Post processing step
+      result_type operator()(const result_type& temp) const {
+        using TiledArray::empty;
+        TA_ASSERT(! empty(temp));
+
+        if(! pimpl_->perm_)
+          return temp;
+
+        TiledArray::Permute<result_type, result_type> permute;
+        return permute(temp, pimpl_->perm_);
+      }
+
+      /// Reduce two result objects
+
+      /// Add \c arg to \c result .
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] arg The argument that will be added to \c result
+      void operator()(result_type& result, const result_type& arg) const {
+        using TiledArray::add_to;
+        add_to(result, arg);
+      }
+
+      /// Contract a pair of tiles and add to a target tile
+
+      /// Each batch element of \c left is contracted with the same batch
+      /// element of \c right , and added to that of \c result .
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] left The left-hand tile to be contracted
+      /// \param[in] right The right-hand tile to be contracted
+      void operator()(result_type& result, first_argument_type left,
+          second_argument_type right) const
+      {
+        using TiledArray::empty;
+        TA_ASSERT(pimpl_);
+        TA_ASSERT(left.range().rank() == pimpl_->left_rank_);
+        TA_ASSERT(right.range().rank() == pimpl_->right_rank_);
+        TaskTraceScope trace("kernel", "batched contract");
+
+        if(empty(result))
+          result = make_result(left, right);
+
+        const unsigned int batch_rank = pimpl_->batch_rank_;
+        const unsigned int left_outer_end = pimpl_->left_rank_ - pimpl_->inner_rank_;
+        const auto* MADNESS_RESTRICT const left_extent = left.range().extent_data();
+        const auto* MADNESS_RESTRICT const right_extent = right.range().extent_data();
+        TA_ASSERT(std::equal(left_extent, left_extent + batch_rank, right_extent));
+
+        const integer batches = volume(left_extent, 0u, batch_rank);
+        const integer m = volume(left_extent, batch_rank, left_outer_end);
+        const integer k = volume(left_extent, left_outer_end, pimpl_->left_rank_);
+        const integer n = volume(right_extent, batch_rank + pimpl_->inner_rank_,
+            pimpl_->right_rank_);
+        TA_ASSERT(integer(result.range().volume()) == batches * m * n);
+
+        const auto* MADNESS_RESTRICT a = left.data();
+        const auto* MADNESS_RESTRICT b = right.data();
+        auto* MADNESS_RESTRICT c = result.data();
+        for(integer x = 0; x < batches; ++x, a += m * k, b += k * n, c += m * n) {
+          math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, m, n, k,
+              pimpl_->alpha_, a, k, b, n, typename result_type::numeric_type(1),
+              c, n);
+          count_gemm_flops<typename result_type::numeric_type>(m, n, k);
+        }
+      }
+
+    }; // class BatchedContractReduce
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_OP_BATCHED_CONTRACT_REDUCE_H__INCLUDED
@@ -27,6 +27,7 @@
 #define TILEDARRAY_TILE_OP_BINARY_REDUCTION_H__INCLUDED
 
 #include <TiledArray/tile_op/tile_interface.h>
+#include <TiledArray/math/compensated_sum.h>
 
 namespace TiledArray {
 
@@ -66,6 +67,44 @@ namespace TiledArray {
 
   }; // class DotReduction
 
+  /// Compensated vector dot product tile reduction
+
+  /// This reduction operation computes the vector dot product of a tile. The
+  /// rounding errors of the sum are kept in the correction term of the
+  /// \c math::CompensatedSum result, within and across tiles.
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  template <typename Left, typename Right>
+  class CompensatedDotReduction {
+  public:
+    // typedefs
+    using result_type = decltype(compensated_dot(std::declval<Left>(),
+        std::declval<Right>()));
+    typedef Left first_argument_type;
+    typedef Right second_argument_type;
+
+    // Reduction functions
+
+    // Make an empty result object
+    result_type operator()() const { return result_type(); }
+
+    // Post process the result
+    const result_type& operator()(const result_type& result) const { return result; }
+
+    // Reduce two result objects
+    void operator()(result_type& result, const result_type& arg) const {
+      result += arg;
+    }
+
+    // Reduce an argument pair
+    void operator()(result_type& result, const first_argument_type& left,
+        const second_argument_type& right) const {
+      using TiledArray::compensated_dot;
+      result += compensated_dot(left, right);
+    }
+
+  }; // class CompensatedDotReduction
+
   /// Vector inner product tile reduction
 
   /// This reduction operation computes the vector inner product of a tile.
@@ -102,6 +141,59 @@ namespace TiledArray {
 
   }; // class InnerProductReduction
 
+  /// Tile reduction of a tile and a permuted tile
+
+  /// The element pairs of a left-hand tile and a right-hand tile, which
+  /// holds the elements of <tt>permute(left, perm)</tt> , are reduced as by
+  /// \c Op , without permuting either tile (see \c Tensor::dot() ).
+  /// \tparam Op The reduction of unpermuted tiles, which is
+  /// \c DotReduction or \c InnerProductReduction
+  template <typename Op>
+  class PermutedReduction : public Op {
+  public:
+    // typedefs
+    typedef typename Op::result_type result_type;
+    typedef typename Op::first_argument_type first_argument_type;
+    typedef typename Op::second_argument_type second_argument_type;
+
+  private:
+
+    Permutation perm_; ///< The permutation from left-hand to right-hand indices
+
+    template <typename Left, typename Right>
+    result_type reduce_pair(const DotReduction<Left, Right>&, const Left& left,
+        const Right& right) const
+    { return left.dot(right, perm_); }
+
+    template <typename Left, typename Right>
+    result_type reduce_pair(const InnerProductReduction<Left, Right>&,
+        const Left& left, const Right& right) const
+    { return left.inner_product(right, perm_); }
+
+  public:
+
+    PermutedReduction() : Op(), perm_() { }
+
+    /// Constructor
+
+    /// \param op The reduction of unpermuted tiles
+    /// \param perm The permutation that maps the indices of the left-hand
+    /// tiles to those of the right-hand tiles
+    PermutedReduction(const Op& op, const Permutation& perm) :
+      Op(op), perm_(perm)
+    { }
+
+    // Reduction functions
+    using Op::operator();
+
+    // Reduce an argument pair
+    void operator()(result_type& result, const first_argument_type& left,
+        const second_argument_type& right) const {
+      result += reduce_pair(static_cast<const Op&>(*this), left, right);
+    }
+
+  }; // class PermutedReduction
+
 } // namespace TiledArray
 
 #endif // TILEDARRAY_TILE_OP_BINARY_REDUCTION_H__INCLUDED
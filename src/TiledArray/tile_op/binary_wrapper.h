@@ -27,7 +27,9 @@
 #define TILEDARRAY_TILE_OP_BINARY_WRAPPER_H__INCLUDED
 
 #include <TiledArray/tile_op/tile_interface.h>
+#include <TiledArray/tile_interface/clone.h>
 #include <TiledArray/permutation.h>
+#include <TiledArray/work_counter.h>
 #include <TiledArray/zero_tensor.h>
 
 namespace TiledArray {
@@ -142,6 +144,8 @@ namespace TiledArray {
       /// \param right The right-hand argument
       /// \return The result tile from the binary operation applied to the
       /// \c left and \c right arguments.
+      /// \note One flop is counted for each element of the result (see
+      /// \c work_statistics() ).
       template <typename L, typename R,
                 std::enable_if_t<!(is_lazy_tile_v<L> || is_lazy_tile_v<R>)>* =
                     nullptr>
@@ -150,10 +154,15 @@ namespace TiledArray {
                       "BinaryWrapper::operator()(L&&,R&&): invalid argument type L");
         static_assert(std::is_same<std::decay_t<R>, right_type>::value,
                       "BinaryWrapper::operator()(L&&,R&&): invalid argument type R");
-        if (perm_)
-          return op_(std::forward<L>(left), std::forward<R>(right), perm_);
-
-        return op_(std::forward<L>(left), std::forward<R>(right));
+        if (perm_) {
+          auto result = op_(std::forward<L>(left), std::forward<R>(right), perm_);
+          count_elementwise_flops(result);
+          return result;
+        }
+
+        auto result = op_(std::forward<L>(left), std::forward<R>(right));
+        count_elementwise_flops(result);
+        return result;
       }
 
       /// Evaluate a zero tile to a non-zero tiles and possibly permute
@@ -296,9 +305,11 @@ namespace TiledArray {
           return op_.consume_right(_left, _right);
         };
         // Override consumable
-        if(is_consumable_tile<eval_t<L> >::value && left.is_consumable())
+        if(is_consumable_tile<eval_t<L> >::value &&
+            (left.is_consumable() || is_unique(eval_left)))
           return invoke(op_left, eval_left, eval_right);
-        if(is_consumable_tile<eval_t<R> >::value && right.is_consumable())
+        if(is_consumable_tile<eval_t<R> >::value &&
+            (right.is_consumable() || is_unique(eval_right)))
           return invoke(op_right, eval_left, eval_right);
 
         return invoke(op_, eval_left, eval_right);
@@ -316,7 +327,8 @@ namespace TiledArray {
           return op_(eval_left, std::forward<R>(right), perm_);
 
         // Override consumable
-        if(is_consumable_tile<eval_t<L> >::value && left.is_consumable())
+        if(is_consumable_tile<eval_t<L> >::value &&
+            (left.is_consumable() || is_unique(eval_left)))
           return op_.consume_left(eval_left, std::forward<R>(right));
 
         return op_(eval_left, std::forward<R>(right));
@@ -334,7 +346,8 @@ namespace TiledArray {
           return op_(eval_left, eval_right, perm_);
 
         // Override consumable
-        if(is_consumable_tile<eval_t<L> >::value && left.is_consumable())
+        if(is_consumable_tile<eval_t<L> >::value &&
+            (left.is_consumable() || is_unique(eval_left)))
           return op_.consume_left(eval_left, eval_right);
 
         return op_(eval_left, eval_right);
@@ -351,7 +364,8 @@ namespace TiledArray {
           return op_(std::forward<L>(left), eval_right, perm_);
 
         // Override consumable
-        if(is_consumable_tile<eval_t<R> >::value && right.is_consumable())
+        if(is_consumable_tile<eval_t<R> >::value &&
+            (right.is_consumable() || is_unique(eval_right)))
           return op_.consume_right(std::forward<L>(left), eval_right);
 
         return op_(std::forward<L>(left), eval_right);
@@ -369,7 +383,8 @@ namespace TiledArray {
           return op_(eval_left, eval_right, perm_);
 
         // Override consumable
-        if(is_consumable_tile<eval_t<R> >::value && right.is_consumable())
+        if(is_consumable_tile<eval_t<R> >::value &&
+            (right.is_consumable() || is_unique(eval_right)))
           return op_.consume_right(eval_left, eval_right);
 
         return op_(eval_left, eval_right);
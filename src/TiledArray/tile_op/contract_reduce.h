@@ -32,10 +32,38 @@
 #include "../tile_interface/add.h"
 #include "../tile_interface/permute.h"
 #include <TiledArray/tensor/complex.h>
+#include <TiledArray/tensor/type_traits.h>
+#include <TiledArray/task_trace.h>
+#include <TiledArray/work_counter.h>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
 
+    /// Detect tiles that contract many tile pairs in one call
+
+    /// \c value is \c true when
+    /// <tt>gemm_batch(results, lefts, rights, factor, gemm_helper)</tt> is
+    /// defined for vectors of pointers to \c Result , \c Left , and \c Right
+    /// tiles. Such tiles (e.g. device tiles that map the pairs onto batched
+    /// BLAS calls) are contracted one SUMMA row at a time.
+    /// \tparam Result The result tile type
+    /// \tparam Left The left-hand tile type
+    /// \tparam Right The right-hand tile type
+    /// \tparam Scalar The scaling factor type
+    template <typename Result, typename Left, typename Right, typename Scalar,
+        typename Enabler = void>
+    struct has_gemm_batch : public std::false_type { };
+
+    template <typename Result, typename Left, typename Right, typename Scalar>
+    struct has_gemm_batch<Result, Left, Right, Scalar,
+        void_t<decltype(gemm_batch(std::declval<const std::vector<Result*>&>(),
+            std::declval<const std::vector<const Left*>&>(),
+            std::declval<const std::vector<const Right*>&>(),
+            std::declval<Scalar>(), std::declval<const math::GemmHelper&>()))> > :
+        public std::true_type
+    { };
+
     /// Contract and (sum) reduce base
 
     /// This implementation class is used to provide shallow copy semantics for ContractReduce.
@@ -56,6 +84,9 @@ namespace TiledArray {
 
     private:
 
+      /// Arguments of the same type may be swapped in the tile GEMM
+      static constexpr bool swappable = std::is_same<Left, Right>::value;
+
       struct Impl {
         Impl(const madness::cblas::CBLAS_TRANSPOSE left_op,
             const madness::cblas::CBLAS_TRANSPOSE right_op,
@@ -63,14 +94,51 @@ namespace TiledArray {
             const unsigned int left_rank, const unsigned int right_rank,
             const Permutation& perm = Permutation()) :
           gemm_helper_(left_op, right_op, result_rank, left_rank, right_rank),
-          alpha_(alpha), perm_(perm)
-        { }
+          tile_gemm_helper_(gemm_helper_), alpha_(alpha), perm_(perm),
+          perm_in_gemm_(swappable && (left_op != madness::cblas::ConjTrans) &&
+              (right_op != madness::cblas::ConjTrans) &&
+              is_outer_swap(perm, gemm_helper_))
+        {
+          if(perm_in_gemm_)
+            tile_gemm_helper_ = gemm_helper_.transposed();
+        }
+
+        /// Check for a permutation that exchanges the outer dimensions
+
+        /// \param perm The result permutation
+        /// \param gemm_helper The gemm helper of the contraction
+        /// \return \c true if \c perm moves the right-hand outer dimensions,
+        /// in order, in front of the left-hand outer dimensions
+        static bool is_outer_swap(const Permutation& perm,
+            const math::GemmHelper& gemm_helper)
+        {
+          if(! perm)
+            return false;
+
+          const unsigned int result_rank = gemm_helper.result_rank();
+          const unsigned int left_outer_rank = gemm_helper.left_rank() -
+              gemm_helper.num_contract_ranks();
+          const unsigned int right_outer_rank = result_rank - left_outer_rank;
+          if((left_outer_rank == 0u) || (right_outer_rank == 0u))
+            return false;
+
+          for(unsigned int i = 0u; i < result_rank; ++i) {
+            const unsigned int pi = (i < left_outer_rank ?
+                i + right_outer_rank : i - left_outer_rank);
+            if(perm[i] != pi)
+              return false;
+          }
+
+          return true;
+        }
 
         math::GemmHelper gemm_helper_; ///< Gemm helper object
+        math::GemmHelper tile_gemm_helper_; ///< Gemm helper used for the tiles
         scalar_type alpha_; ///< Scaling factor applied to the contraction of
             ///< the left- and right-hand arguments
         Permutation perm_; ///< Permutation that is applied to the final result
             ///< tensor
+        bool perm_in_gemm_; ///< The tile GEMM evaluates the permuted result
       };
 
       std::shared_ptr<Impl> pimpl_;
@@ -123,6 +191,19 @@ namespace TiledArray {
       }
 
 
+      /// Check if the result permutation is evaluated by the tile GEMM
+
+      /// When \c perm() only exchanges the left- and right-hand outer
+      /// dimensions, the permuted result is the transpose of the product, so
+      /// the tiles are contracted as \f$ B^T A^T \f$ and are never permuted.
+      /// This is not done when the GEMM conjugates an argument, since the
+      /// transpose of a conjugate-transposed argument is not a GEMM operation.
+      /// \return \c true if the contraction evaluates the permuted result
+      bool perm_in_gemm() const {
+        TA_ASSERT(pimpl_);
+        return pimpl_->perm_in_gemm_;
+      }
+
       /// Scaling factor accessor
 
       /// \return The scaling factor for this operation
@@ -131,6 +212,145 @@ namespace TiledArray {
         return pimpl_->alpha_;
       }
 
+    protected:
+
+      /// Contract a pair of tiles and add to a target tile
+
+      /// \tparam Factor The scaling factor type
+      /// \param[in,out] result The result object that will be the reduction
+      /// target
+      /// \param[in] left The left-hand tile to be contracted
+      /// \param[in] right The right-hand tile to be contracted
+      /// \param[in] factor The scaling factor applied to the product
+      template <typename R, typename Factor>
+      void contract(R& result, first_argument_type left,
+          second_argument_type right, const Factor factor) const
+      {
+        TA_ASSERT(pimpl_);
+        TaskTraceScope trace("kernel", "contract");
+        contract(result, left, right, factor,
+            std::integral_constant<bool, swappable>());
+      }
+
+      /// Contract tile pairs and add to the target tiles
+
+      /// Pair \c i is contracted as <tt>*results[i] += left * *rights[i] *
+      /// factor</tt> with a single \c gemm_batch call.
+      /// \tparam Factor The scaling factor type
+      /// \param[in,out] results The result tiles, which must be distinct
+      /// \param[in] left The left-hand tile to be contracted
+      /// \param[in] rights The right-hand tiles to be contracted
+      /// \param[in] factor The scaling factor applied to the products
+      template <typename Factor>
+      void contract_batch(const std::vector<result_type*>& results,
+          first_argument_type left, const std::vector<const Right*>& rights,
+          const Factor factor) const
+      {
+        TA_ASSERT(pimpl_);
+        TA_ASSERT(results.size() == rights.size());
+        TaskTraceScope trace("kernel", "contract batch");
+        for(const Right* right : rights)
+          count_flops(left, *right, 0);
+        const std::vector<const Left*> lefts(rights.size(), &left);
+        contract_batch(results, lefts, rights, factor,
+            std::integral_constant<bool, swappable>());
+      }
+
+    private:
+
+      /// Record the flops of the contraction of a tile pair
+
+      /// The matrix sizes of the product are computed with the tile
+      /// \c GemmHelper , so tiles without a range (e.g. lazy tiles) are not
+      /// counted.
+      template <typename L, typename Rt>
+      auto count_flops(const L& left, const Rt& right, int) const ->
+          decltype(left.range(), right.range(), void())
+      {
+        integer m = 1, n = 1, k = 1;
+        pimpl_->tile_gemm_helper_.compute_matrix_sizes(m, n, k, left.range(),
+            right.range());
+        TiledArray::detail::count_gemm_flops<
+            typename TiledArray::detail::numeric_type<Result>::type>(m, n, k);
+      }
+
+      template <typename L, typename Rt>
+      void count_flops(const L&, const Rt&, long) const { }
+
+      template <typename Factor>
+      void contract_batch(const std::vector<result_type*>& results,
+          const std::vector<const Left*>& lefts,
+          const std::vector<const Right*>& rights, const Factor factor,
+          std::true_type) const
+      {
+        if(pimpl_->perm_in_gemm_)
+          gemm_batch(results, rights, lefts, factor, pimpl_->tile_gemm_helper_);
+        else
+          gemm_batch(results, lefts, rights, factor, pimpl_->tile_gemm_helper_);
+      }
+
+      template <typename Factor>
+      void contract_batch(const std::vector<result_type*>& results,
+          const std::vector<const Left*>& lefts,
+          const std::vector<const Right*>& rights, const Factor factor,
+          std::false_type) const
+      {
+        gemm_batch(results, lefts, rights, factor, pimpl_->tile_gemm_helper_);
+      }
+
+      template <typename R, typename Factor>
+      void contract(R& result, first_argument_type left,
+          second_argument_type right, const Factor factor, std::true_type) const
+      {
+        if(pimpl_->perm_in_gemm_)
+          contract(result, right, left, factor, std::false_type());
+        else
+          contract(result, left, right, factor, std::false_type());
+      }
+
+      template <typename R, typename L, typename Rt, typename Factor>
+      void contract(R& result, const L& left, const Rt& right,
+          const Factor factor, std::false_type) const
+      {
+        using TiledArray::empty;
+        using TiledArray::gemm;
+        typedef decltype(gemm(left, right, factor, pimpl_->tile_gemm_helper_))
+            gemm_result_type;
+        count_flops(left, right, 0);
+        if(empty(result))
+          initialize(result, left, right, factor, std::integral_constant<bool,
+              TiledArray::detail::is_tensor<R, L, Rt>::value &&
+              ! std::is_same<R, gemm_result_type>::value>());
+        else
+          gemm(result, left, right, factor, pimpl_->tile_gemm_helper_);
+      }
+
+      template <typename R, typename L, typename Rt, typename Factor>
+      void initialize(R& result, const L& left, const Rt& right,
+          const Factor factor, std::false_type) const
+      {
+        using TiledArray::gemm;
+        result = gemm(left, right, factor, pimpl_->tile_gemm_helper_);
+      }
+
+      /// Contract into a result tensor with a different element type
+
+      /// The product is accumulated directly in the precision of \c R (e.g.
+      /// \c float arguments into a \c double result), instead of being
+      /// computed in the argument type and converted.
+      template <typename R, typename L, typename Rt, typename Factor>
+      void initialize(R& result, const L& left, const Rt& right,
+          const Factor factor, std::true_type) const
+      {
+        using TiledArray::gemm;
+        result = R(pimpl_->tile_gemm_helper_.template
+            make_result_range<typename R::range_type>(left.range(), right.range()),
+            typename R::numeric_type(0));
+        gemm(result, left, right, factor, pimpl_->tile_gemm_helper_);
+      }
+
+    public:
+
       //-------------- these are only used for unit tests -----------------
       
       /// Compute the number of contracted ranks
@@ -231,7 +451,7 @@ namespace TiledArray {
         using TiledArray::empty;
         TA_ASSERT(! empty(temp));
 
-        if(! ContractReduceBase_::perm())
+        if(! ContractReduceBase_::perm() || ContractReduceBase_::perm_in_gemm())
           return temp;
 
         TiledArray::Permute<result_type, result_type> permute;
@@ -259,14 +479,23 @@ namespace TiledArray {
       void operator()(result_type& result, first_argument_type left,
           second_argument_type right) const
       {
-        using TiledArray::empty;
-        using TiledArray::gemm;
-        if(empty(result))
-          result = gemm(left, right, ContractReduceBase_::factor(),
-              ContractReduceBase_::gemm_helper());
-        else
-          gemm(result, left, right, ContractReduceBase_::factor(),
-              ContractReduceBase_::gemm_helper());
+        ContractReduceBase_::contract(result, left, right,
+            ContractReduceBase_::factor());
+      }
+
+      /// Contract tile pairs and add to the target tiles
+
+      /// Contract \c left with each of \c rights and add the products to
+      /// the corresponding \c results . This is only available for tiles
+      /// that satisfy \c has_gemm_batch .
+      /// \param[in,out] results The result tiles, which must be distinct
+      /// \param[in] left The left-hand tile to be contracted
+      /// \param[in] rights The right-hand tiles to be contracted
+      void operator()(const std::vector<result_type*>& results,
+          first_argument_type left, const std::vector<const Right*>& rights) const
+      {
+        ContractReduceBase_::contract_batch(results, left, rights,
+            ContractReduceBase_::factor());
       }
 
     }; // class ContractReduce
@@ -341,7 +570,7 @@ namespace TiledArray {
         using TiledArray::empty;
         TA_ASSERT(! empty(temp));
 
-        if(! ContractReduceBase_::perm()) {
+        if(! ContractReduceBase_::perm() || ContractReduceBase_::perm_in_gemm()) {
           using TiledArray::conj_to;
           return conj_to(temp);
         }
@@ -371,12 +600,7 @@ namespace TiledArray {
       void operator()(result_type& result, first_argument_type left,
           second_argument_type right) const
       {
-        using TiledArray::empty;
-        using TiledArray::gemm;
-        if(empty(result))
-          result = gemm(left, right, 1, ContractReduceBase_::gemm_helper());
-        else
-          gemm(result, left, right, 1, ContractReduceBase_::gemm_helper());
+        ContractReduceBase_::contract(result, left, right, 1);
       }
 
     }; // class ContractReduce
@@ -452,7 +676,7 @@ namespace TiledArray {
         using TiledArray::empty;
         TA_ASSERT(! empty(temp));
 
-        if(! ContractReduceBase_::perm()) {
+        if(! ContractReduceBase_::perm() || ContractReduceBase_::perm_in_gemm()) {
           using TiledArray::conj_to;
           return conj_to(temp, ContractReduceBase_::factor().factor());
         }
@@ -483,12 +707,7 @@ namespace TiledArray {
       void operator()(result_type& result, first_argument_type left,
           second_argument_type right) const
       {
-        using TiledArray::empty;
-        using TiledArray::gemm;
-        if(empty(result))
-          result = gemm(left, right, 1, ContractReduceBase_::gemm_helper());
-        else
-          gemm(result, left, right, 1, ContractReduceBase_::gemm_helper());
+        ContractReduceBase_::contract(result, left, right, 1);
       }
 
     }; // class ContractReduce
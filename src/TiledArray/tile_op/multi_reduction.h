@@ -0,0 +1,264 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2014  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_OP_MULTI_REDUCTION_H__INCLUDED
+#define TILEDARRAY_TILE_OP_MULTI_REDUCTION_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace TiledArray {
+
+  /// The results of a bundle of reductions
+
+  /// \tparam Results The result types of the reductions
+  template <typename... Results>
+  struct MultiReductionResult {
+    std::tuple<Results...> values; ///< The result of each reduction
+
+    MultiReductionResult() : values() { }
+    explicit MultiReductionResult(const std::tuple<Results...>& v) : values(v) { }
+
+    /// Serialize the results
+
+    /// \tparam Archive The archive type
+    /// \param ar The archive
+    template <typename Archive>
+    void serialize(Archive& ar) {
+      serialize(ar, std::make_index_sequence<sizeof...(Results)>());
+    }
+
+  private:
+
+    template <typename Archive, std::size_t... Is>
+    void serialize(Archive& ar, const std::index_sequence<Is...>&) {
+      int expand[] = { 0, ((void)(ar & std::get<Is>(values)), 0)... };
+      (void)expand;
+    }
+  }; // struct MultiReductionResult
+
+  namespace detail {
+
+    /// Reduce an argument pair with a binary reduction
+
+    /// \return \c void
+    template <typename Op, typename Result, typename Left, typename Right>
+    inline auto reduce_pair(const Op& op, Result& result, const Left& left,
+        const Right& right, int) -> decltype(op(result, left, right), void())
+    { op(result, left, right); }
+
+    /// Reduce the left-hand argument of a pair with a unary reduction
+    template <typename Op, typename Result, typename Left, typename Right>
+    inline void reduce_pair(const Op& op, Result& result, const Left& left,
+        const Right&, long)
+    { op(result, left); }
+
+  }  // namespace detail
+
+  namespace detail {
+
+    /// The result functions of a bundle of reductions
+
+    /// \tparam Ops The tile reduction types
+    template <typename... Ops>
+    class MultiReductionBase {
+    public:
+      typedef MultiReductionResult<typename Ops::result_type...> result_type;
+
+    protected:
+      std::tuple<Ops...> ops_; ///< The reductions
+
+      typedef std::make_index_sequence<sizeof...(Ops)> indices;
+
+    private:
+
+      template <std::size_t... Is>
+      result_type make(const std::index_sequence<Is...>&) const {
+        return result_type(std::make_tuple(std::get<Is>(ops_)()...));
+      }
+
+      template <std::size_t... Is>
+      result_type post(const result_type& result, const std::index_sequence<Is...>&) const {
+        return result_type(std::make_tuple(typename Ops::result_type(
+            std::get<Is>(ops_)(std::get<Is>(result.values)))...));
+      }
+
+      template <std::size_t... Is>
+      void combine(result_type& result, const result_type& arg,
+          const std::index_sequence<Is...>&) const
+      {
+        int expand[] = { 0, ((void)std::get<Is>(ops_)(std::get<Is>(result.values),
+            std::get<Is>(arg.values)), 0)... };
+        (void)expand;
+      }
+
+    public:
+
+      MultiReductionBase() : ops_() { }
+      explicit MultiReductionBase(const std::tuple<Ops...>& ops) : ops_(ops) { }
+
+      // Make an empty result object
+      result_type operator()() const { return make(indices()); }
+
+      // Post process the result
+      result_type operator()(const result_type& result) const {
+        return post(result, indices());
+      }
+
+      // Reduce two result objects
+      void operator()(result_type& result, const result_type& arg) const {
+        combine(result, arg, indices());
+      }
+
+    }; // class MultiReductionBase
+
+  }  // namespace detail
+
+  /// A bundle of tile reductions that are evaluated in one traversal
+
+  /// Each tile is reduced by every reduction of the bundle, and the results
+  /// are combined in one message by the all-reduce of \c Expr::reduce() (see
+  /// also \c Expr::multi_reduce() ).
+  /// \tparam Ops The unary tile reduction types, which have the same
+  /// argument type
+  template <typename... Ops>
+  class MultiReduction : public detail::MultiReductionBase<Ops...> {
+    typedef detail::MultiReductionBase<Ops...> base_type;
+  public:
+    typedef typename base_type::result_type result_type;
+    typedef typename std::tuple_element<0, std::tuple<Ops...> >::type::argument_type
+        argument_type;
+
+  private:
+    using base_type::ops_;
+
+    template <std::size_t... Is>
+    void reduce(result_type& result, const argument_type& arg,
+        const std::index_sequence<Is...>&) const
+    {
+      int expand[] = { 0, ((void)std::get<Is>(ops_)(std::get<Is>(result.values),
+          arg), 0)... };
+      (void)expand;
+    }
+
+  public:
+
+    MultiReduction() : base_type() { }
+    explicit MultiReduction(const std::tuple<Ops...>& ops) : base_type(ops) { }
+
+    using base_type::operator();
+
+    // Reduce an argument
+    void operator()(result_type& result, const argument_type& arg) const {
+      reduce(result, arg, typename base_type::indices());
+    }
+
+  }; // class MultiReduction
+
+  /// A bundle of tile pair reductions that are evaluated in one traversal
+
+  /// Binary reductions, e.g. \c DotReduction , reduce each tile pair, and
+  /// unary reductions, e.g. \c SquaredNormReduction , reduce the left-hand
+  /// tile of each pair.
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \tparam Ops The tile reduction types
+  template <typename Left, typename Right, typename... Ops>
+  class BinaryMultiReduction : public detail::MultiReductionBase<Ops...> {
+    typedef detail::MultiReductionBase<Ops...> base_type;
+  public:
+    typedef typename base_type::result_type result_type;
+    typedef Left first_argument_type;
+    typedef Right second_argument_type;
+
+  private:
+    using base_type::ops_;
+
+    template <std::size_t... Is>
+    void reduce(result_type& result, const first_argument_type& left,
+        const second_argument_type& right, const std::index_sequence<Is...>&) const
+    {
+      int expand[] = { 0, ((void)detail::reduce_pair(std::get<Is>(ops_),
+          std::get<Is>(result.values), left, right, 0), 0)... };
+      (void)expand;
+    }
+
+  public:
+
+    BinaryMultiReduction() : base_type() { }
+    explicit BinaryMultiReduction(const std::tuple<Ops...>& ops) : base_type(ops) { }
+
+    using base_type::operator();
+
+    // Reduce an argument pair
+    void operator()(result_type& result, const first_argument_type& left,
+        const second_argument_type& right) const
+    {
+      reduce(result, left, right, typename base_type::indices());
+    }
+
+  }; // class BinaryMultiReduction
+
+  /// Bundle unary tile reductions
+
+  /// \tparam Ops The tile reduction types
+  /// \param ops The tile reductions
+  /// \return A reduction that evaluates all \c ops
+  template <typename... Ops>
+  inline MultiReduction<Ops...> make_multi_reduction(const Ops&... ops) {
+    return MultiReduction<Ops...>(std::make_tuple(ops...));
+  }
+
+  namespace detail {
+
+    /// Result accessor of a bundle of reductions
+
+    /// \tparam I The index of the reduction
+    /// \tparam Results The result types of the reductions
+    /// \param result The results of the bundle
+    /// \return The result of reduction \c I
+    template <std::size_t I, typename... Results>
+    inline typename std::tuple_element<I, std::tuple<Results...> >::type
+    multi_reduction_element(const MultiReductionResult<Results...>& result) {
+      return std::get<I>(result.values);
+    }
+
+    /// Split the result of a bundle of reductions
+
+    /// \tparam Results The result types of the reductions
+    /// \param world The world that owns the result
+    /// \param result The results of the bundle
+    /// \return A future to the result of each reduction
+    template <typename... Results, std::size_t... Is>
+    inline std::tuple<Future<Results>...>
+    split_multi_reduction(World& world,
+        const Future<MultiReductionResult<Results...> >& result,
+        const std::index_sequence<Is...>&)
+    {
+      return std::make_tuple(world.taskq.add(
+          & multi_reduction_element<Is, Results...>, result)...);
+    }
+
+  }  // namespace detail
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_OP_MULTI_REDUCTION_H__INCLUDED
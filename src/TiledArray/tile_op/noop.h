@@ -106,6 +106,10 @@ namespace TiledArray {
         return Noop_::template eval<can_consume>(arg);
       }
 
+      /// Serialize (nothing to do)
+      template <typename Archive>
+      void serialize(Archive&) { }
+
     }; // class Noop
 
   } // namespace detail
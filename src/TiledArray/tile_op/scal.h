@@ -29,6 +29,7 @@
 #include <type_traits>
 #include "../tile_interface/scale.h"
 #include <TiledArray/tile_op/tile_interface.h>
+#include <TiledArray/work_counter.h>
 
 namespace TiledArray {
   namespace detail {
@@ -59,11 +60,14 @@ namespace TiledArray {
 
       // Permuting tile evaluation function
       // These operations cannot consume the argument tile since this operation
-      // requires temporary storage space.
+      // requires temporary storage space. All evaluation functions count one
+      // flop per element of the result.
 
       result_type eval(const Arg& arg, const Permutation& perm) const {
         using TiledArray::scale;
-        return scale(arg, factor_, perm);
+        result_type result = scale(arg, factor_, perm);
+        TiledArray::detail::count_elementwise_flops(result);
+        return result;
       }
 
       // Non-permuting tile evaluation functions
@@ -73,13 +77,17 @@ namespace TiledArray {
       template <bool C, typename std::enable_if<!C>::type* = nullptr>
       result_type eval(const argument_type& arg) const {
         using TiledArray::scale;
-        return scale(arg, factor_);
+        result_type result = scale(arg, factor_);
+        TiledArray::detail::count_elementwise_flops(result);
+        return result;
       }
 
       template <bool C, typename std::enable_if<C>::type* = nullptr>
       result_type eval(argument_type& arg) const {
         using TiledArray::scale_to;
-        return scale_to(arg, factor_);
+        result_type result = scale_to(arg, factor_);
+        TiledArray::detail::count_elementwise_flops(result);
+        return result;
       }
 
     public:
@@ -91,6 +99,12 @@ namespace TiledArray {
       Scal_& operator=(const Scal_&) = default;
       Scal_& operator=(Scal_&&) = default;
 
+      /// Default constructor
+
+      /// Construct an identity scaling operation, which is the state of an
+      /// operation that is deserialized
+      Scal() : factor_(1) { }
+
       /// Constructor
 
       /// Construct a scaling operation that scales the result tensor
@@ -127,6 +141,13 @@ namespace TiledArray {
         return Scal_::template eval<can_consume>(arg);
       }
 
+      /// Serialize the scaling factor
+
+      /// \tparam Archive The archive type
+      /// \param ar The archive
+      template <typename Archive>
+      void serialize(Archive& ar) { ar & factor_; }
+
     }; // class Scal
 
   } // namespace detail
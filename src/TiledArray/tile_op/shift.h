@@ -35,7 +35,9 @@ namespace TiledArray {
     /// Tile shift operation
 
     /// This tile operation will shift the range of the tile and/or apply a
-    /// permutation to the result tensor.
+    /// permutation to the result tensor. Tiles that cannot be consumed are
+    /// shifted as views that share the data of the argument (see
+    /// \c TiledArray::shift_view ), so a block of tiles is not copied.
     /// \tparam Result The tile result type
     /// \tparam Arg The argument type
     /// \tparam Consumable If `true`, the tile is a temporary and may be
@@ -76,6 +78,16 @@ namespace TiledArray {
 
       template <bool C, typename = void>
       auto eval(const argument_type& arg) const {
+        return eval_view(arg, std::is_same<result_type, argument_type>());
+      }
+
+      // Shift a view of the argument, which shares the argument data
+      result_type eval_view(const argument_type& arg, std::true_type) const {
+        using TiledArray::shift_view;
+        return shift_view(arg, range_shift_);
+      }
+
+      result_type eval_view(const argument_type& arg, std::false_type) const {
         TiledArray::Shift<result_type, argument_type> shift;
         return shift(arg, range_shift_);
       }
@@ -760,6 +760,37 @@ namespace TiledArray {
   inline auto inner_product(const Left& left, const Right& right)
   { return left.inner_product(right); }
 
+  /// Compensated sum of the elements of a tile
+
+  /// \tparam Arg The tile argument type
+  /// \param arg The argument to be summed
+  /// \return A \c math::CompensatedSum that is equal to <tt>sum_i arg[i]</tt>
+  template <typename Arg>
+  inline auto compensated_sum(const Arg& arg)
+  { return arg.compensated_sum(); }
+
+  /// Compensated squared vector 2-norm of the elements of a tile
+
+  /// \tparam Arg The tile argument type
+  /// \param arg The argument to be multiplied and summed
+  /// \return A \c math::CompensatedSum that is equal to
+  /// <tt>sum_i arg[i] * arg[i]</tt>
+  template <typename Arg>
+  inline auto compensated_squared_norm(const Arg& arg)
+  { return arg.compensated_squared_norm(); }
+
+  /// Compensated vector dot product of two tiles
+
+  /// \tparam Left The left-hand argument tile type
+  /// \tparam Right The right-hand argument tile type
+  /// \param left The left-hand argument tile
+  /// \param right The right-hand argument tile
+  /// \return A \c math::CompensatedSum that is equal to
+  /// <tt>sum_i left[i] * right[i]</tt>
+  template <typename Left, typename Right>
+  inline auto compensated_dot(const Left& left, const Right& right)
+  { return left.compensated_dot(right); }
+
   template <typename T>
   using result_of_trace_t = decltype(mult(std::declval<T>()));
 
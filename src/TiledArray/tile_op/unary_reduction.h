@@ -27,6 +27,7 @@
 #define TILEDARRAY_TILE_OP_UNARY_REDUCTION_H__INCLUDED
 
 #include <TiledArray/tile_op/tile_interface.h>
+#include <TiledArray/math/compensated_sum.h>
 
 namespace TiledArray {
 
@@ -161,6 +162,77 @@ namespace TiledArray {
 
   }; // class SquaredNormReduction
 
+  /// Compensated sum tile reduction
+
+  /// This reduction operation is used to sum all elements of a tile. The
+  /// rounding errors of the sum are kept in the correction term of the
+  /// \c math::CompensatedSum result, within and across tiles.
+  /// \tparam Tile The tile type
+  template <typename Tile>
+  class CompensatedSumReduction {
+  public:
+    // typedefs
+    using result_type = decltype(compensated_sum(std::declval<Tile>()));
+    typedef Tile argument_type;
+
+    // Reduction functions
+
+    // Make an empty result object
+    result_type operator()() const { return result_type(); }
+
+    // Post process the result
+    const result_type& operator()(const result_type& result) const { return result; }
+
+    // Reduce two result objects
+    void operator()(result_type& result, const result_type& arg) const {
+      result += arg;
+    }
+
+    // Reduce an argument
+    void operator()(result_type& result, const argument_type& arg) const {
+      using TiledArray::compensated_sum;
+      result += compensated_sum(arg);
+    }
+
+  }; // class CompensatedSumReduction
+
+  /// Compensated squared norm tile reduction
+
+  /// This reduction operation is used to sum the square of all elements of a
+  /// tile. The rounding errors of the sum are kept in the correction term of
+  /// the \c math::CompensatedSum result, so single precision tiles may be
+  /// reduced without loss of accuracy for large arrays.
+  /// \tparam Tile The tile type
+  template <typename Tile>
+  class CompensatedSquaredNormReduction {
+  public:
+    // typedefs
+    using result_type = decltype(compensated_squared_norm(std::declval<Tile>()));
+    typedef Tile argument_type;
+
+    // Reduction functions
+
+    // Make an empty result object
+    result_type operator()() const { return result_type(); }
+
+    // Post process the result
+    const result_type& operator()(const result_type& result) const {
+      return result;
+    }
+
+    // Reduce two result objects
+    void operator()(result_type& result, const result_type& arg) const {
+      result += arg;
+    }
+
+    // Reduce an argument
+    void operator()(result_type& result, const argument_type& arg) const {
+      using TiledArray::compensated_squared_norm;
+      result += compensated_squared_norm(arg);
+    }
+
+  }; // class CompensatedSquaredNormReduction
+
   /// Minimum tile reduction
 
   /// This reduction operation is used to find the minimum value of elements in a Tile.
@@ -27,6 +27,7 @@
 #define TILEDARRAY_TILE_OP_UNARY_WRAPPER_H__INCLUDED
 
 #include <TiledArray/tile_op/tile_interface.h>
+#include <TiledArray/tile_interface/clone.h>
 #include <TiledArray/permutation.h>
 #include <TiledArray/zero_tensor.h>
 
@@ -115,6 +116,10 @@ namespace TiledArray {
       UnaryWrapper_& operator=(const UnaryWrapper_&) = default;
       UnaryWrapper_& operator=(UnaryWrapper_&&) = default;
 
+      /// Default constructor, which is defined when \c Op is default
+      /// constructible, e.g. to deserialize a wrapper
+      UnaryWrapper() = default;
+
       UnaryWrapper(const Op& op, const Permutation& perm) : op_(op), perm_(perm) { }
 
       UnaryWrapper(const Op& op) : op_(op), perm_() { }
@@ -183,7 +188,7 @@ namespace TiledArray {
         };
         using TiledArray::meta::invoke;
         return (perm_ ? invoke(op_, std::move(cast_arg), perm_)
-                      : (arg.is_consumable()
+                      : ((arg.is_consumable() || is_unique(cast_arg))
                              ? invoke(op_consume, cast_arg)
                              : invoke(op_, std::move(cast_arg))));
       }
@@ -216,6 +221,13 @@ namespace TiledArray {
                       : op_.consume(std::forward<A>(arg)));
       }
 
+      /// Serialize the operation and the permutation
+
+      /// \tparam Archive The archive type
+      /// \param ar The archive
+      template <typename Archive>
+      void serialize(Archive& ar) { ar & op_ & perm_; }
+
     }; // class UnaryWrapper
 
   } // namespace detail
@@ -0,0 +1,297 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_timing.h
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_TIMING_H__INCLUDED
+#define TILEDARRAY_TILE_TIMING_H__INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Execution times of the result tiles of a process
+
+    /// When enabled (see \c set_tile_timing() ), the time that a process
+    /// spends computing each result tile is recorded:
+    /// - \c unary and \c binary : the tile task of the unary and binary
+    ///   evaluators
+    /// - \c summa : the reductions of the tile contractions of a SUMMA result
+    ///   tile, summed over the reduction tasks of the tile; the tiles of
+    ///   batched SUMMA steps, which share tasks, are not timed
+    ///
+    /// Otherwise the cost of the instrumentation is one relaxed atomic load
+    /// per tile. Tile indices are the ordinal indices of the result tiles.
+    class TileTimings {
+    public:
+
+      /// The evaluator of a tile
+      enum Source : unsigned int { unary = 0u, binary = 1u, summa = 2u };
+
+      /// Tile time record
+      struct Record {
+        Source source; ///< The evaluator of the tile
+        std::size_t index; ///< The ordinal index of the tile
+        double time; ///< The execution time, in seconds
+      }; // struct Record
+
+    private:
+
+      static std::atomic<bool>& flag() {
+        static std::atomic<bool> enabled(getenv("TA_TILE_TIMING") != nullptr);
+        return enabled;
+      }
+
+      static std::mutex& mutex() {
+        static std::mutex mtx;
+        return mtx;
+      }
+
+      static std::vector<Record>& all_records() {
+        static std::vector<Record> records;
+        return records;
+      }
+
+    public:
+
+      /// \return \c true if tile times are recorded
+      static bool enabled() { return flag().load(std::memory_order_relaxed); }
+
+      /// Enable or disable the recording of tile times
+      static void enable(const bool value) {
+        flag().store(value, std::memory_order_relaxed);
+      }
+
+      /// Timing clock
+
+      /// \return The time, in seconds
+      static double now() {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      /// Record the time of a tile
+
+      /// \param source The evaluator of the tile
+      /// \param index The ordinal index of the tile
+      /// \param time The execution time of the tile
+      static void record(const Source source, const std::size_t index,
+          const double time)
+      {
+        std::lock_guard<std::mutex> lock(mutex());
+        all_records().push_back(Record{ source, index, time });
+      }
+
+      /// \return A copy of the records of this process
+      static std::vector<Record> records() {
+        std::lock_guard<std::mutex> lock(mutex());
+        return all_records();
+      }
+
+      /// Remove all records
+      static void clear() {
+        std::lock_guard<std::mutex> lock(mutex());
+        all_records().clear();
+      }
+
+      /// \return The name of \c source
+      static const char* name(const Source source) {
+        static const char* names[] = { "unary", "binary", "summa" };
+        return names[source];
+      }
+
+    }; // class TileTimings
+
+    /// Record the execution time of a scope as the time of a tile
+
+    /// Nothing is recorded when tile timing is disabled.
+    class TileTimerScope {
+      TileTimings::Source source_; ///< The evaluator of the tile
+      std::size_t index_; ///< The ordinal index of the tile
+      double begin_; ///< The start time, or a negative value when disabled
+
+    public:
+
+      TileTimerScope(const TileTimerScope&) = delete;
+      TileTimerScope& operator=(const TileTimerScope&) = delete;
+
+      /// Constructor
+
+      /// \param source The evaluator of the tile
+      /// \param index The ordinal index of the tile
+      TileTimerScope(const TileTimings::Source source, const std::size_t index) :
+        source_(source), index_(index),
+        begin_(TileTimings::enabled() ? TileTimings::now() : -1.0)
+      { }
+
+      ~TileTimerScope() {
+        if(begin_ >= 0.0)
+          TileTimings::record(source_, index_, TileTimings::now() - begin_);
+      }
+
+    }; // class TileTimerScope
+
+  }  // namespace detail
+
+  /// Enable or disable the recording of result tile times
+
+  /// Tile timing is enabled by default when the \c TA_TILE_TIMING environment
+  /// variable is set.
+  /// \param enable The new state
+  inline void set_tile_timing(const bool enable) {
+    detail::TileTimings::enable(enable);
+  }
+
+  /// Remove the tile times recorded by this process
+  inline void reset_tile_timing() { detail::TileTimings::clear(); }
+
+  /// Summary of the tile times of all processes
+
+  /// \c histograms[p][b] is the number of tiles of process \c p whose time
+  /// is at most \c bin_edges[b] (and more than <tt>bin_edges[b-1]</tt> ); the
+  /// last bin counts the tiles that are slower than every edge.
+  struct TileTimingReport {
+    /// A slow tile
+    struct Outlier {
+      detail::TileTimings::Source source; ///< The evaluator of the tile
+      std::size_t index; ///< The ordinal index of the tile
+      double time; ///< The execution time, in seconds
+    }; // struct Outlier
+
+    std::vector<double> bin_edges; ///< The upper bounds of the bins, in seconds
+    std::vector<std::vector<std::size_t> > histograms; ///< The histogram of each process
+    std::vector<std::size_t> counts; ///< The number of tiles of each process
+    std::vector<double> totals; ///< The sum of the tile times of each process
+    std::vector<double> max_times; ///< The slowest tile time of each process
+    std::vector<std::vector<Outlier> > outliers; ///< The slowest tiles of each process, slowest first
+    double imbalance = 1.0; ///< The largest total over the average total
+
+    /// Print the report
+
+    /// \param os The output stream
+    void print(std::ostream& os) const {
+      const std::ios::fmtflags flags = os.flags();
+      const std::streamsize precision = os.precision();
+      os << "Tile times: imbalance (max/avg total) = " << std::setprecision(3)
+         << imbalance << "\n";
+      for(std::size_t p = 0ul; p < counts.size(); ++p) {
+        os << "rank " << p << ": " << counts[p] << " tiles, total "
+           << totals[p] << " s, mean "
+           << (counts[p] ? totals[p] / double(counts[p]) : 0.0) << " s, max "
+           << max_times[p] << " s\n  histogram (<= s: count):";
+        for(std::size_t b = 0ul; b < histograms[p].size(); ++b) {
+          if(histograms[p][b] == 0ul)
+            continue;
+          if(b < bin_edges.size())
+            os << " " << bin_edges[b] << ": " << histograms[p][b];
+          else
+            os << " >" << bin_edges.back() << ": " << histograms[p][b];
+        }
+        os << "\n  slowest:";
+        for(const Outlier& o : outliers[p])
+          os << " " << detail::TileTimings::name(o.source) << "[" << o.index
+             << "]=" << o.time;
+        os << "\n";
+      }
+      os.flags(flags);
+      os.precision(precision);
+    }
+  }; // struct TileTimingReport
+
+  /// Summarize the tile times of all processes
+
+  /// The bins of the histograms are powers of two from 1 microsecond to
+  /// about 8 seconds.
+  /// \param world The world of the processes
+  /// \param top_n The number of slowest tiles of each process [ default = 5 ]
+  /// \return The summary of the tile times recorded since the last
+  /// \c reset_tile_timing()
+  /// \note This function is collective.
+  inline TileTimingReport tile_timing_report(World& world,
+      const std::size_t top_n = 5ul)
+  {
+    typedef detail::TileTimings::Record Record;
+    const std::size_t nprocs = world.size(), nbins = 24ul;
+
+    TileTimingReport report;
+    for(std::size_t b = 0ul; b < nbins; ++b)
+      report.bin_edges.push_back(1.0e-6 * double(1ul << b));
+
+    // Summarize the local times; each process fills its slice of the
+    // buffer:  count, total, max, histogram, and top_n (source, index, time)
+    std::vector<Record> records = detail::TileTimings::records();
+    const std::size_t stride = 3ul + (nbins + 1ul) + 3ul * top_n;
+    std::vector<double> buffer(nprocs * stride, 0.0);
+    double* const local = buffer.data() + world.rank() * stride;
+    local[0] = double(records.size());
+    for(const Record& r : records) {
+      local[1] += r.time;
+      local[2] = std::max(local[2], r.time);
+      const std::size_t bin = std::lower_bound(report.bin_edges.begin(),
+          report.bin_edges.end(), r.time) - report.bin_edges.begin();
+      local[3ul + bin] += 1.0;
+    }
+    const std::size_t n = std::min(top_n, records.size());
+    std::partial_sort(records.begin(), records.begin() + n, records.end(),
+        [] (const Record& l, const Record& r) { return l.time > r.time; });
+    for(std::size_t i = 0ul; i < n; ++i) {
+      double* const outlier = local + 4ul + nbins + 3ul * i;
+      outlier[0] = double(records[i].source);
+      outlier[1] = double(records[i].index);
+      outlier[2] = records[i].time;
+    }
+    world.gop.sum(buffer.data(), buffer.size());
+
+    // Unpack the summaries
+    double sum = 0.0, max = 0.0;
+    for(std::size_t p = 0ul; p < nprocs; ++p) {
+      const double* const data = buffer.data() + p * stride;
+      report.counts.push_back(std::size_t(data[0]));
+      report.totals.push_back(data[1]);
+      report.max_times.push_back(data[2]);
+      report.histograms.emplace_back(data + 3ul, data + 4ul + nbins);
+      report.outliers.emplace_back();
+      for(std::size_t i = 0ul; i < std::min<std::size_t>(top_n, data[0]); ++i) {
+        const double* const outlier = data + 4ul + nbins + 3ul * i;
+        report.outliers.back().push_back(TileTimingReport::Outlier{
+            detail::TileTimings::Source(std::size_t(outlier[0])),
+            std::size_t(outlier[1]), outlier[2] });
+      }
+      sum += data[1];
+      max = std::max(max, data[1]);
+    }
+    if(sum > 0.0)
+      report.imbalance = max * double(nprocs) / sum;
+    return report;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_TIMING_H__INCLUDED
@@ -22,40 +22,148 @@
 
 #include <TiledArray/tiled_range1.h>
 #include <TiledArray/range.h>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace TiledArray {
 
+  namespace detail {
+
+    /// Immutable data of a tiled range
+
+    /// The data is shared by all \c TiledRange objects with the same tiling.
+    struct TiledRangeData {
+      Range tiles_range; ///< The range of the tile indices
+      Range elements_range; ///< The range of the element indices
+      std::vector<TiledRange1> ranges; ///< The tilings of the dimensions
+      std::size_t hash; ///< The hash of the tile boundaries
+
+      /// \param r The tilings of the dimensions
+      /// \param h The hash of the tile boundaries
+      TiledRangeData(std::vector<TiledRange1>&& r, const std::size_t h) :
+        tiles_range(), elements_range(), ranges(std::move(r)), hash(h)
+      {
+        const std::size_t rank = ranges.size();
+        std::vector<std::size_t> start, finish, start_element, finish_element;
+        start.reserve(rank);
+        finish.reserve(rank);
+        start_element.reserve(rank);
+        finish_element.reserve(rank);
+        for(const TiledRange1& r1 : ranges) {
+          start.push_back(r1.tiles_range().first);
+          finish.push_back(r1.tiles_range().second);
+          start_element.push_back(r1.elements_range().first);
+          finish_element.push_back(r1.elements_range().second);
+        }
+        Range(start, finish).swap(tiles_range);
+        Range(start_element, finish_element).swap(elements_range);
+      }
+    }; // struct TiledRangeData
+
+    /// Table of the tiled range data in use
+
+    /// Tiled ranges are hash-consed: constructing a tiled range whose
+    /// tiling is identical to that of a live tiled range shares its data,
+    /// so copies of tiled ranges, e.g. by arrays, expression engines, and
+    /// shapes, do not allocate, and comparisons of identical tiled ranges
+    /// are constant time. The table only holds weak references, so the
+    /// data is freed with the last tiled range that uses it.
+    class TiledRangeTable {
+      typedef std::unordered_multimap<std::size_t,
+          std::weak_ptr<const TiledRangeData> > table_type;
+
+      std::mutex mutex_; ///< Protects the table
+      table_type table_; ///< The data in use, by hash
+      std::size_t purge_size_ = 64ul; ///< The table size at which expired entries are removed
+
+      static void hash_combine(std::size_t& seed, const std::size_t value) {
+        seed ^= std::hash<std::size_t>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      }
+
+      static std::size_t hash(const std::vector<TiledRange1>& ranges) {
+        std::size_t seed = ranges.size();
+        for(const TiledRange1& r1 : ranges) {
+          hash_combine(seed, r1.tile_extent());
+          hash_combine(seed, r1.elements_range().first);
+          for(const auto& tile : r1)
+            hash_combine(seed, tile.second);
+        }
+        return seed;
+      }
+
+      void purge() {
+        for(auto it = table_.begin(); it != table_.end(); )
+          it = (it->second.expired() ? table_.erase(it) : std::next(it));
+        purge_size_ = std::max<std::size_t>(64ul, 2ul * table_.size());
+      }
+
+    public:
+
+      /// \return The table of this process
+      static TiledRangeTable& instance() {
+        static TiledRangeTable table;
+        return table;
+      }
+
+      /// Find or insert the data of a tiling
+
+      /// \param ranges The tilings of the dimensions
+      /// \return The shared data of the tiled range
+      std::shared_ptr<const TiledRangeData> intern(std::vector<TiledRange1>&& ranges) {
+        const std::size_t h = hash(ranges);
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto match = table_.equal_range(h);
+        for(auto it = match.first; it != match.second; ++it) {
+          std::shared_ptr<const TiledRangeData> data = it->second.lock();
+          if(data && std::equal(data->ranges.begin(), data->ranges.end(),
+              ranges.begin(), ranges.end()))
+            return data;
+        }
+
+        std::shared_ptr<const TiledRangeData> data =
+            std::make_shared<const TiledRangeData>(std::move(ranges), h);
+        if(table_.size() >= purge_size_)
+          purge();
+        table_.emplace(h, data);
+        return data;
+      }
+
+      /// \return The number of entries of the table, including expired ones
+      std::size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return table_.size();
+      }
+
+    }; // class TiledRangeTable
+
+  } // namespace detail
+
   /// Range data of a tiled array
 
-  /// TiledRange is a direct (Cartesian) product of 1-dimensional tiled ranges (TiledRange1)
+  /// TiledRange is a direct (Cartesian) product of 1-dimensional tiled ranges (TiledRange1).
+  /// The data of a tiled range is immutable and shared with all tiled ranges
+  /// with the same tiling (see \c detail::TiledRangeTable ), so copies are
+  /// cheap.
   class TiledRange {
   private:
 
     /// Constructed with a set of ranges pointed to by [ first, last ).
-    void init() {
-      const std::size_t rank = this->rank();
-
-      // Indices used to store range start and finish.
-      std::vector<size_type> start;
-      std::vector<size_type> finish;
-      std::vector<size_type> start_element;
-      std::vector<size_type> finish_element;
-
-      start.reserve(rank);
-      finish.reserve(rank);
-      start_element.reserve(rank);
-      finish_element.reserve(rank);
-
-      // Find the start and finish of the over all tiles and element ranges.
-      for(unsigned int i = 0; i < rank; ++i) {
-        start.push_back(ranges_[i].tiles_range().first);
-        finish.push_back(ranges_[i].tiles_range().second);
-
-        start_element.push_back(ranges_[i].elements_range().first);
-        finish_element.push_back(ranges_[i].elements_range().second);
-      }
-      range_type(start, finish).swap(range_);
-      range_type(start_element, finish_element).swap(elements_range_);
+    template <typename InIter>
+    static std::shared_ptr<const detail::TiledRangeData>
+    make_data(InIter first, InIter last) {
+      return detail::TiledRangeTable::instance().intern(
+          std::vector<TiledRange1>(first, last));
+    }
+
+    /// \return The data of the default tiled range
+    static const std::shared_ptr<const detail::TiledRangeData>& empty_data() {
+      static const std::shared_ptr<const detail::TiledRangeData> data =
+          std::make_shared<const detail::TiledRangeData>(std::vector<TiledRange1>(), 0ul);
+      return data;
     }
 
   public:
@@ -68,50 +176,40 @@ namespace TiledArray {
     typedef std::vector<TiledRange1> Ranges;
 
     /// Default constructor
-    TiledRange() : range_(), elements_range_(), ranges_() { }
+    TiledRange() : data_(empty_data()) { }
 
     /// Constructed with a set of ranges pointed to by [ first, last ).
     template <typename InIter>
     TiledRange(InIter first, InIter last) :
-      range_(), elements_range_(), ranges_(first, last)
-    {
-      init();
-    }
+      data_(make_data(first, last))
+    { }
 
     /// Constructed with a set of ranges pointed to by [ first, last ).
     TiledRange(const std::initializer_list<std::initializer_list<size_type> >& list) :
-      range_(), elements_range_(), ranges_(list.begin(), list.end())
-    {
-      init();
-    }
+      data_(make_data(list.begin(), list.end()))
+    { }
 
     /// Constructed with an initializer_list of TiledRange1's
     TiledRange(const std::initializer_list<TiledRange1>& list) :
-      range_(), elements_range_(), ranges_(list.begin(), list.end())
-    {
-      init();
-    }
+      data_(make_data(list.begin(), list.end()))
+    { }
 
     /// Copy constructor
-    TiledRange(const TiledRange_& other) :
-        range_(other.range_), elements_range_(other.elements_range_), ranges_(other.ranges_)
-    { }
+
+    /// The data is shared with \c other .
+    TiledRange(const TiledRange_& other) = default;
 
     /// TiledRange assignment operator
 
     /// \return A reference to this object
-    TiledRange_& operator =(const TiledRange_& other) {
-      if(this != &other)
-        TiledRange_(other).swap(*this);
-      return *this;
-    }
+    TiledRange_& operator =(const TiledRange_& other) = default;
 
     /// In place permutation of this range.
 
     /// \return A reference to this object
     TiledRange_& operator *=(const Permutation& p) {
-      TA_ASSERT(p.dim() == range_.rank());
-      Ranges temp = p * ranges_;
+      TA_ASSERT(p.dim() == rank());
+      Ranges temp = p * data_->ranges;
       TiledRange(temp.begin(), temp.end()).swap(*this);
       return *this;
     }
@@ -120,7 +218,7 @@ namespace TiledArray {
 
     /// \return A const reference to the tile range object
     const range_type& tiles_range() const {
-      return range_;
+      return data_->tiles_range;
     }
 
     /// Access the tile range
@@ -135,7 +233,7 @@ namespace TiledArray {
 
     /// \return A const reference to the element range object
     const range_type& elements_range() const {
-      return elements_range_;
+      return data_->elements_range;
     }
 
     /// Access the element range
@@ -189,9 +287,9 @@ namespace TiledArray {
     template <typename Index>
     typename std::enable_if<! std::is_integral<Index>::value, range_type>::type
     make_tile_range(const Index& index) const {
-      const auto rank = range_.rank();
+      const auto rank = tiles_range().rank();
       TA_ASSERT(index.size() == rank);
-      TA_ASSERT(range_.includes(index));
+      TA_ASSERT(tiles_range().includes(index));
       typename range_type::index lower;
       typename range_type::index upper;
       lower.reserve(rank);
@@ -238,11 +336,11 @@ namespace TiledArray {
     template <typename Index>
     typename std::enable_if<! std::is_integral<Index>::value, typename range_type::index>::type
     element_to_tile(const Index& index) const {
-      const unsigned int rank = range_.rank();
+      const unsigned int rank = this->rank();
       typename range_type::index result;
       result.reserve(rank);
       for(size_type i = 0; i < rank; ++i)
-        result.push_back(ranges_[i].element_to_tile(index[i]));
+        result.push_back(data_->ranges[i].element_to_tile(index[i]));
 
       return result;
     }
@@ -250,7 +348,7 @@ namespace TiledArray {
     /// The rank accessor
 
     /// \return the rank (=number of dimensions) of this object
-    std::size_t rank() const { return ranges_.size(); }
+    std::size_t rank() const { return data_->ranges.size(); }
 
     /// Accessor of the tiled range for one of the dimensions
 
@@ -258,26 +356,28 @@ namespace TiledArray {
     /// \return TIledRange1 object for dimension \c d
     const TiledRange1& dim(std::size_t d) const {
       TA_ASSERT(d < rank());
-      return ranges_[d];
+      return data_->ranges[d];
     }
 
     /// Tile dimension boundary array accessor
 
     /// \return A reference to the array of Range1 objects.
     /// \throw nothing
-    const Ranges& data() const { return ranges_; }
+    const Ranges& data() const { return data_->ranges; }
+
+    /// Test for shared data
 
+    /// \param other Another tiled range
+    /// \return \c true if this and \c other share their data, which is
+    /// the case for identical live tiled ranges
+    bool shares_data(const TiledRange_& other) const { return data_ == other.data_; }
 
     void swap(TiledRange_& other) {
-      range_.swap(other.range_);
-      elements_range_.swap(other.elements_range_);
-      std::swap(ranges_, other.ranges_);
+      std::swap(data_, other.data_);
     }
 
   private:
-    range_type range_; ///< Stores information on tile indexing for the range.
-    range_type elements_range_; ///< Stores information on element indexing for the range.
-    Ranges ranges_; ///< Stores tile boundaries for each dimension.
+    std::shared_ptr<const detail::TiledRangeData> data_; ///< The shared tile and element ranges, and tile boundaries
   };
 
   /// TiledRange permutation operator.
@@ -297,6 +397,8 @@ namespace TiledArray {
 
   /// Returns true when all tile and element ranges are the same.
   inline bool operator ==(const TiledRange& r1, const TiledRange& r2) {
+    if(r1.shares_data(r2))
+      return true;
     return (r1.tiles_range().rank() == r2.tiles_range().rank()) &&
         (r1.tiles_range() == r2.tiles_range()) && (r1.elements_range() == r2.elements_range()) &&
         std::equal(r1.data().begin(), r1.data().end(), r2.data().begin());
@@ -0,0 +1,197 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  top_k.h
+ *  October 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_TOP_K_H__INCLUDED
+#define TILEDARRAY_TOP_K_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/dense_shape.h>
+#include <TiledArray/sparse_shape.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// Order of the elements selected by \c top_k()
+
+    /// \return \c true if \c a has a larger magnitude than \c b , or the same
+    /// magnitude and a smaller ordinal index
+    template <typename T>
+    inline bool top_k_before(const std::pair<std::size_t, T>& a,
+        const std::pair<std::size_t, T>& b)
+    {
+      const auto abs_a = std::abs(a.second);
+      const auto abs_b = std::abs(b.second);
+      return (abs_a > abs_b) || ((abs_a == abs_b) && (a.first < b.first));
+    }
+
+    /// Merge of the partial selections of \c top_k()
+
+    /// The selections are sorted by \c top_k_before() , and the merged
+    /// selection holds the \c k first elements of both.
+    /// \tparam T The element type
+    template <typename T>
+    class TopKReduceOp {
+    public:
+      typedef std::vector<std::pair<std::size_t, T> > result_type; ///< The selection type
+      typedef result_type argument_type; ///< The partial selection type
+
+    private:
+      std::size_t k_; ///< The number of selected elements
+
+    public:
+      TopKReduceOp() : k_(0ul) { }
+      explicit TopKReduceOp(const std::size_t k) : k_(k) { }
+
+      result_type operator()() const { return result_type(); }
+      result_type operator()(const result_type& temp) const { return temp; }
+      void operator()(result_type& result, const argument_type& arg) const {
+        if(arg.empty())
+          return;
+        result_type merged;
+        merged.reserve(std::min(k_, result.size() + arg.size()));
+        auto it = result.begin();
+        auto arg_it = arg.begin();
+        while((merged.size() < k_) && ((it != result.end()) || (arg_it != arg.end()))) {
+          if((arg_it == arg.end()) ||
+              ((it != result.end()) && top_k_before(*it, *arg_it)))
+            merged.push_back(*it++);
+          else
+            merged.push_back(*arg_it++);
+        }
+        result.swap(merged);
+      }
+    }; // class TopKReduceOp
+
+    /// Key tag of the \c top_k all-reduce
+    struct TopKTag { };
+
+    /// Bound on the magnitude of the elements of a tile of a dense array
+
+    /// \return No bound, since dense shapes carry no norms
+    inline double top_k_tile_bound(const DenseShape&, const TiledRange&,
+        const std::size_t)
+    { return std::numeric_limits<double>::max(); }
+
+    /// Bound on the magnitude of the elements of a tile of a sparse array
+
+    /// The magnitude of an element is at most the Frobenius norm of its
+    /// tile, which is the shape norm times the tile volume. The bound is
+    /// widened slightly, since the shape norms are rounded.
+    /// \param shape The shape of the array
+    /// \param trange The tiled range of the array
+    /// \param index The ordinal index of the tile
+    /// \return The largest magnitude of an element of tile \c index
+    template <typename T>
+    inline double top_k_tile_bound(const SparseShape<T>& shape,
+        const TiledRange& trange, const std::size_t index)
+    {
+      return double(shape[index]) * double(trange.make_tile_range(index).volume())
+          * (1.0 + 1.0e-5);
+    }
+
+  }  // namespace detail
+
+  /// Largest-magnitude elements of an array
+
+  /// Each process selects the \c k largest-magnitude elements of its local
+  /// tiles, and the selections are merged by a tree all-reduce. The local
+  /// tiles are visited in order of decreasing shape norm, and, once \c k
+  /// elements are selected, the tiles whose norm is smaller than the
+  /// magnitude of the <tt>k</tt>-th element are skipped without being
+  /// read, since none of their elements can be selected. Elements of equal
+  /// magnitude are ordered by their index. This function is collective and
+  /// blocks until the result is available.
+  /// \tparam Tile The tile type of the array
+  /// \tparam Policy The policy type of the array
+  /// \param array The array
+  /// \param k The number of elements to select
+  /// \return The index and value of the (at most) \c k largest-magnitude
+  /// elements, in order of decreasing magnitude
+  template <typename Tile, typename Policy>
+  inline std::vector<std::pair<Range::index, typename DistArray<Tile,Policy>::element_type> >
+  top_k(const DistArray<Tile,Policy>& array, const std::size_t k) {
+    typedef typename DistArray<Tile,Policy>::element_type element_type;
+    typedef std::pair<std::size_t, element_type> selected_type;
+    World& world = array.world();
+    const TiledRange& trange = array.trange();
+    const Range& elements_range = trange.elements_range();
+
+    // Order the local tiles by the bound on their elements
+    std::vector<std::pair<double, std::size_t> > tiles;
+    for(const auto index : *array.pmap()) {
+      if(array.is_zero(index))
+        continue;
+      tiles.emplace_back(detail::top_k_tile_bound(array.shape(), trange, index), index);
+    }
+    std::stable_sort(tiles.begin(), tiles.end(),
+        [] (const std::pair<double, std::size_t>& a, const std::pair<double, std::size_t>& b)
+        { return a.first > b.first; });
+
+    // Select the local elements, where the front of the heap is the
+    // smallest selected element
+    std::vector<selected_type> local;
+    if(k > 0ul) {
+      local.reserve(k);
+      for(const auto& bound_index : tiles) {
+        if((local.size() == k) && (bound_index.first < double(std::abs(local.front().second))))
+          break;
+
+        const auto tile = array.find(bound_index.second).get();
+        for(std::size_t i = 0ul; i < tile.size(); ++i) {
+          const element_type value = tile[i];
+          if((local.size() == k) && (std::abs(value) < std::abs(local.front().second)))
+            continue;
+          const selected_type selected(elements_range.ordinal(tile.range().idx(i)), value);
+          if(local.size() < k) {
+            local.push_back(selected);
+            std::push_heap(local.begin(), local.end(), & detail::top_k_before<element_type>);
+          } else if(detail::top_k_before(selected, local.front())) {
+            std::pop_heap(local.begin(), local.end(), & detail::top_k_before<element_type>);
+            local.back() = selected;
+            std::push_heap(local.begin(), local.end(), & detail::top_k_before<element_type>);
+          }
+        }
+      }
+      std::sort_heap(local.begin(), local.end(), & detail::top_k_before<element_type>);
+    }
+
+    typedef madness::TaggedKey<madness::uniqueidT, detail::TopKTag> key_type;
+    const std::vector<selected_type> selected =
+        world.gop.all_reduce(key_type(world.unique_obj_id()), local,
+        detail::TopKReduceOp<element_type>(k)).get();
+
+    std::vector<std::pair<Range::index, element_type> > result;
+    result.reserve(selected.size());
+    for(const auto& element : selected)
+      result.emplace_back(elements_range.idx(element.first), element.second);
+    return result;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TOP_K_H__INCLUDED
@@ -24,6 +24,7 @@
 #include <iterator>
 #include <madness/world/type_traits.h>
 #include <complex>
+#include <limits>
 #include <utility>
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -37,6 +38,8 @@ namespace Eigen {
 
 } // namespace Eigen
 
+template <unsigned> class KroneckerDeltaTile;
+
 namespace TiledArray {
   template <typename> class Tile;
   class DensePolicy;
@@ -255,6 +258,10 @@ namespace TiledArray {
   GENERATE_HAS_MEMBER_FUNCTION_ANYRETURN(crend)
   GENERATE_HAS_MEMBER_FUNCTION(crend)
 
+  /////////////////////////////
+  // tile traits
+  GENERATE_HAS_MEMBER_FUNCTION_ANYRETURN(permute)
+
   /////////////////////////////
   // standard iterator traits
   // GENERATE_HAS_MEMBER_TYPE(value_type)
@@ -410,6 +417,35 @@ namespace TiledArray {
   template <>
   struct is_consumable_tile<ZeroTensor> : public std::false_type { };
 
+  /// Lazy tile evaluation cost
+
+  /// SUMMA broadcasts the evaluated tiles of the lazy tiles of its arguments,
+  /// unless the estimated time to evaluate a tile is less than the estimated
+  /// time to transfer the evaluated tile. In that case the lazy tile is
+  /// broadcast instead, and each process that uses it evaluates it. Users
+  /// may specialize this class for cheap lazy tile types, e.g.
+  /// \code
+  /// template <>
+  /// struct lazy_tile_cost<MyTile> {
+  ///   template <typename Range>
+  ///   static double eval_time(const Range& range) { return range.volume() * 1.0e-9; }
+  /// };
+  /// \endcode
+  /// \tparam T The lazy tile type
+  template <typename T>
+  struct lazy_tile_cost {
+    /// Estimated evaluation time
+
+    /// \tparam Range The tile range type
+    /// \return The estimated time, in seconds, to evaluate a tile with
+    /// range \c range ; lazy tiles are never evaluated by the processes
+    /// that receive them by default
+    template <typename Range>
+    static double eval_time(const Range&) {
+      return std::numeric_limits<double>::infinity();
+    }
+  };
+
 
 
   /** @}*/
@@ -423,6 +459,16 @@ namespace TiledArray {
     template <typename T>
     struct is_complex<std::complex<T> > : public std::true_type { };
 
+    /// Kronecker delta tile trait
+
+    /// \c value is \c true for the tiles of a Kronecker delta matrix,
+    /// <tt>KroneckerDeltaTile<1></tt> (see \c special/kronecker_delta.h )
+    template <typename T>
+    struct is_kronecker_delta : public std::false_type { };
+
+    template <>
+    struct is_kronecker_delta<KroneckerDeltaTile<1u> > : public std::true_type { };
+
     template <typename T>
     struct is_numeric : public std::is_arithmetic<T> { };
 
@@ -467,6 +513,22 @@ namespace TiledArray {
         public std::integral_constant<bool, is_lazy_tile<T>::value && (! is_array_tile<T>::value)>
     { }; // struct is_non_array_lazy_tile
 
+    /// Recomputable array tile trait
+
+    /// \c value is \c true when \c T is a \c LazyArrayTile that may be
+    /// broadcast and evaluated by the receiving processes, i.e. when the
+    /// array tiles are lazy tiles that are evaluated synchronously, and the
+    /// operation may be deserialized.
+    /// \tparam T The tile type
+    template <typename T>
+    struct is_recomputable_array_tile : public std::false_type { };
+
+    template <typename Tile, typename Op>
+    struct is_recomputable_array_tile<LazyArrayTile<Tile, Op> > :
+        public std::integral_constant<bool, is_non_array_lazy_tile<Tile>::value &&
+            (! eval_trait<Tile>::nonblocking) && std::is_default_constructible<Op>::value>
+    { }; // struct is_recomputable_array_tile
+
 
     /// Type trait for extracting the numeric type of tensors and arrays.
 
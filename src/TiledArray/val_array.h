@@ -287,19 +287,24 @@ namespace TiledArray {
 
       /// Binary reduction operation where this object is the left-hand
       /// argument type. The reduced result is computed by
-      /// <tt>op(result, *this[i], arg[i])</tt>.
+      /// <tt>reduce_op(result, *this[i], arg[i])</tt>, and partial results
+      /// are joined by <tt>join_op(result, partial)</tt>.
       /// \tparam U The element type of \c arg
       /// \tparam Result The result type of the reduction
-      /// \tparam Op The reduction operation.
+      /// \tparam ReduceOp The reduction operation
+      /// \tparam JoinOp The join operation
       /// \param arg The right-hand array argument
-      /// \param result The initial value of the reduction
-      /// \param op The binary reduction operation
+      /// \param identity The identity of the reduction
+      /// \param reduce_op The binary reduction operation
+      /// \param join_op The operation that joins partial results
       /// \return The reduced value
       /// \throw TiledArray::Exception When <tt>arg.size() != size()</tt>.
-      template <typename U, typename Result, typename Op>
-      Result reduce(const ValArray<U>& arg, Result& result, const Op& op) {
+      template <typename U, typename Result, typename ReduceOp, typename JoinOp>
+      Result reduce(const ValArray<U>& arg, const Result& identity,
+          const ReduceOp& reduce_op, const JoinOp& join_op) const
+      {
         TA_ASSERT(arg.size() == SizeArray<T>::size());
-        return SizeArray<T>::reduce(arg.data(), result, op);
+        return SizeArray<T>::reduce(arg.data(), identity, reduce_op, join_op);
       }
 
       /// Reduce row operation
@@ -0,0 +1,227 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  work_counter.h
+ *
+ */
+
+#ifndef TILEDARRAY_WORK_COUNTER_H__INCLUDED
+#define TILEDARRAY_WORK_COUNTER_H__INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <type_traits>
+#include <TiledArray/madness.h>
+#include <TiledArray/type_traits.h>
+
+namespace TiledArray {
+
+  /// Work and communication counts of a process
+  struct WorkStatistics {
+    std::uint64_t flops; ///< Floating point operations of tile contractions and element-wise operations
+    std::uint64_t bytes_sent; ///< Bytes of tile data sent to other processes
+    std::uint64_t bytes_received; ///< Bytes of tile data received from other processes
+    double wall_time; ///< Wall time of the evaluation, in seconds (zero for process totals)
+    std::uint64_t messages_received; ///< Tile messages received from other processes
+  }; // struct WorkStatistics
+
+  namespace detail {
+
+    /// Work and communication counters of a process
+
+    /// Tile contractions (\c ContractReduce ) add \f$ 2mnk \f$ flops
+    /// (\f$ 8mnk \f$ for complex elements), and element-wise operations one
+    /// flop per result element. The tiles that \c Summa broadcasts are counted
+    /// once per receiving process, as sent by the root of the broadcast and
+    /// received by the other processes; the elements of \c DistributedStorage
+    /// are counted when they are sent to, or received from, another process,
+    /// except for the replies to unbuffered gets, which are only counted by
+    /// the sender. Each received tile, or batch of tiles, is one received
+    /// message.
+    /// Counts are process totals; each expression evaluation also records its
+    /// own counts (see \c last_eval_statistics() ).
+    class WorkCounter {
+      std::atomic<std::uint64_t> flops_; ///< Floating point operations
+      std::atomic<std::uint64_t> bytes_sent_; ///< Bytes sent
+      std::atomic<std::uint64_t> bytes_received_; ///< Bytes received
+      std::atomic<std::uint64_t> messages_received_; ///< Messages received
+      WorkStatistics last_eval_; ///< The counts of the last evaluation
+
+      WorkCounter() :
+        flops_(0ul), bytes_sent_(0ul), bytes_received_(0ul),
+        messages_received_(0ul), last_eval_{ 0ul, 0ul, 0ul, 0.0, 0ul }
+      { }
+
+    public:
+
+      WorkCounter(const WorkCounter&) = delete;
+      WorkCounter& operator=(const WorkCounter&) = delete;
+
+      /// The counter of this process
+      static WorkCounter& instance() {
+        static WorkCounter counter;
+        return counter;
+      }
+
+      /// Record floating point operations
+      void add_flops(const std::uint64_t flops) {
+        flops_.fetch_add(flops, std::memory_order_relaxed);
+      }
+
+      /// Record sent data
+      void add_bytes_sent(const std::uint64_t bytes) {
+        bytes_sent_.fetch_add(bytes, std::memory_order_relaxed);
+      }
+
+      /// Record a received message
+      void add_bytes_received(const std::uint64_t bytes) {
+        bytes_received_.fetch_add(bytes, std::memory_order_relaxed);
+        messages_received_.fetch_add(1ul, std::memory_order_relaxed);
+      }
+
+      /// Statistics accessor
+
+      /// \return The counts of this process
+      WorkStatistics statistics() const {
+        return WorkStatistics{ flops_.load(std::memory_order_relaxed),
+            bytes_sent_.load(std::memory_order_relaxed),
+            bytes_received_.load(std::memory_order_relaxed), 0.0,
+            messages_received_.load(std::memory_order_relaxed) };
+      }
+
+      /// Record the counts of an expression evaluation
+
+      /// \param begin The counts when the evaluation started
+      /// \param wall_time The wall time of the evaluation
+      void record_eval(const WorkStatistics& begin, const double wall_time) {
+        const WorkStatistics end = statistics();
+        last_eval_ = WorkStatistics{ end.flops - begin.flops,
+            end.bytes_sent - begin.bytes_sent,
+            end.bytes_received - begin.bytes_received, wall_time,
+            end.messages_received - begin.messages_received };
+      }
+
+      /// \return The counts of the last expression evaluation
+      const WorkStatistics& last_eval() const { return last_eval_; }
+
+      /// Reset the counts
+      void reset() {
+        flops_.store(0ul, std::memory_order_relaxed);
+        bytes_sent_.store(0ul, std::memory_order_relaxed);
+        bytes_received_.store(0ul, std::memory_order_relaxed);
+        messages_received_.store(0ul, std::memory_order_relaxed);
+        last_eval_ = WorkStatistics{ 0ul, 0ul, 0ul, 0.0, 0ul };
+      }
+
+    }; // class WorkCounter
+
+    /// Record the flops of a tile contraction
+
+    /// \tparam Numeric The element type of the product
+    /// \param m The number of rows of the product
+    /// \param n The number of columns of the product
+    /// \param k The contracted dimension of the product
+    template <typename Numeric, typename Integer>
+    inline void count_gemm_flops(const Integer m, const Integer n, const Integer k) {
+      WorkCounter::instance().add_flops((is_complex<Numeric>::value ? 8ul : 2ul)
+          * std::uint64_t(m) * std::uint64_t(n) * std::uint64_t(k));
+    }
+
+    /// Size of the data of a tile
+
+    /// \param tile The tile
+    /// \return The number of bytes of the elements of \c tile
+    template <typename T,
+        typename std::enable_if<has_member_function_size_anyreturn<T>::value>::type* = nullptr>
+    inline std::size_t tile_data_bytes(const T& tile) {
+      return tile.size() * sizeof(typename numeric_type<T>::type);
+    }
+
+    /// Size of the data of a tile that has no size (e.g. a lazy tile)
+
+    /// \return Zero
+    template <typename T,
+        typename std::enable_if<! has_member_function_size_anyreturn<T>::value>::type* = nullptr>
+    inline std::size_t tile_data_bytes(const T&) { return 0ul; }
+
+    /// Record the flops of an element-wise operation
+
+    /// \param result The result tile of the operation
+    template <typename T,
+        typename std::enable_if<has_member_function_size_anyreturn<T>::value>::type* = nullptr>
+    inline void count_elementwise_flops(const T& result) {
+      WorkCounter::instance().add_flops(result.size());
+    }
+
+    template <typename T,
+        typename std::enable_if<! has_member_function_size_anyreturn<T>::value>::type* = nullptr>
+    inline void count_elementwise_flops(const T&) { }
+
+  } // namespace detail
+
+  /// Work and communication counts of this process
+
+  /// \return The counts since the start of the program, or the last
+  /// \c reset_work_statistics()
+  inline WorkStatistics work_statistics() {
+    return detail::WorkCounter::instance().statistics();
+  }
+
+  /// Work and communication counts of the last expression evaluation
+
+  /// The counts of this process between the start and the end of the last
+  /// expression that was assigned with \c operator= ; concurrent evaluations
+  /// (e.g. with \c eval_async() ) are included in the counts.
+  /// \return The counts of the last evaluation, and its wall time
+  inline WorkStatistics last_eval_statistics() {
+    return detail::WorkCounter::instance().last_eval();
+  }
+
+  /// Reset the work and communication counts of this process
+  inline void reset_work_statistics() {
+    detail::WorkCounter::instance().reset();
+  }
+
+  /// Print the counts of the last expression evaluation
+
+  /// The counts of all processes are summed, and printed by process 0 as
+  /// <tt>N GFLOP, M GB moved, T seconds (R GFLOP/s)</tt> , where the moved
+  /// data are the bytes sent and the time is that of the slowest process.
+  /// \param world The world of the processes
+  /// \param os The output stream
+  /// \note This function is collective.
+  inline void eval_report(World& world, std::ostream& os) {
+    const WorkStatistics stats = last_eval_statistics();
+    double sums[2] = { double(stats.flops), double(stats.bytes_sent) };
+    double wall_time = stats.wall_time;
+    world.gop.sum(sums, 2);
+    world.gop.max(wall_time);
+
+    if(world.rank() == 0) {
+      const double gflop = sums[0] / 1.0e9;
+      os << std::setprecision(6) << gflop << " GFLOP, " << sums[1] / 1.0e9
+         << " GB moved, " << wall_time << " seconds ("
+         << (wall_time > 0.0 ? gflop / wall_time : 0.0) << " GFLOP/s)" << std::endl;
+    }
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_WORK_COUNTER_H__INCLUDED
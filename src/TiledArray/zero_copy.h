@@ -0,0 +1,201 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TILEDARRAY_ZERO_COPY_H__INCLUDED
+#define TILEDARRAY_ZERO_COPY_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Zero-copy transfer of large tiles
+
+  /// Remote tiles whose data is at least \c min_bytes() bytes are received
+  /// directly into the data of a tile that is allocated by the receiver,
+  /// and are sent directly from the data of the tile of the owner, with MPI
+  /// point-to-point messages. The range of the tile is known to both
+  /// processes, so only the element data is sent. Smaller tiles are
+  /// serialized into active messages, which copy the data into and out of
+  /// the message buffers.
+  class ZeroCopy {
+  private:
+
+    static std::size_t& min_bytes_ref() {
+      static std::size_t min_bytes = 0ul;
+      return min_bytes;
+    }
+
+  public:
+
+    /// Set the size threshold of zero-copy transfers
+
+    /// \param min_bytes The size, in bytes, of the smallest tile data that
+    /// is sent without a copy, or zero to disable zero-copy transfers
+    /// \note This must be set to the same value on all processes, before
+    /// tiles are sent.
+    static void set(const std::size_t min_bytes) { min_bytes_ref() = min_bytes; }
+
+    /// Size threshold accessor
+
+    /// \return The size, in bytes, of the smallest tile data that is sent
+    /// without a copy, or zero if zero-copy transfers are disabled
+    static std::size_t min_bytes() { return min_bytes_ref(); }
+
+    /// Check that a tile is sent without a copy
+
+    /// \param bytes The size of the tile data
+    /// \return \c true if tile data of size \c bytes is sent without a copy
+    static bool enabled(const std::size_t bytes) {
+      return min_bytes_ref() && (bytes >= min_bytes_ref());
+    }
+
+  }; // class ZeroCopy
+
+  namespace detail {
+
+    /// The contiguous data of a tensor
+
+    /// \tparam T The tensor type
+    /// \param tensor The tensor
+    /// \return The address and the size, in bytes, of the data of \c tensor
+    template <typename T,
+        typename std::enable_if<std::is_trivially_copyable<
+            typename T::value_type>::value>::type* = nullptr>
+    inline auto tile_buffer(T& tensor) ->
+        decltype(tensor.data(), std::pair<void*, std::size_t>())
+    {
+      return std::pair<void*, std::size_t>(
+          const_cast<void*>(static_cast<const void*>(tensor.data())),
+          tensor.range().volume() * sizeof(typename T::value_type));
+    }
+
+    /// The contiguous data of a tile
+
+    /// \tparam T The tile type
+    /// \param tile The tile, which holds a tensor
+    /// \return The address and the size, in bytes, of the data of \c tile
+    template <typename T>
+    inline auto tile_buffer(T& tile) -> decltype(tile_buffer(tile.tensor()))
+    { return tile_buffer(tile.tensor()); }
+
+    /// Detect tiles that can be sent without a copy
+    template <typename T, typename Enabler = void>
+    struct has_tile_buffer : public std::false_type { };
+
+    template <typename T>
+    struct has_tile_buffer<T, decltype(void(tile_buffer(std::declval<T&>())))> :
+        public std::true_type
+    { };
+
+    /// Task that waits for point-to-point messages
+
+    /// The requests are tested each time the task runs; when a request is
+    /// still pending, a new task is added to the task queue, so that other
+    /// tasks run between the tests.
+    class BufferTransferTask : public madness::TaskInterface {
+    private:
+      World& world_; ///< The world of the messages
+      std::vector<SafeMPI::Request> requests_; ///< The pending requests
+      std::function<void()> done_; ///< Called when all requests are complete
+
+    public:
+
+      BufferTransferTask(World& world, std::vector<SafeMPI::Request>&& requests,
+          std::function<void()>&& done) :
+        madness::TaskInterface(madness::TaskAttributes::hipri()),
+        world_(world), requests_(std::move(requests)), done_(std::move(done))
+      { }
+
+      virtual ~BufferTransferTask() { }
+
+      virtual void run(const madness::TaskThreadEnv&) {
+        requests_.erase(std::remove_if(requests_.begin(), requests_.end(),
+            [] (SafeMPI::Request& request) { return request.Test(); }),
+            requests_.end());
+        if(requests_.empty())
+          done_();
+        else
+          world_.taskq.add(new BufferTransferTask(world_, std::move(requests_),
+              std::move(done_)));
+      }
+
+      /// The largest message of a transfer
+
+      /// \return The number of bytes in each message of a transfer
+      static std::size_t chunk_bytes() {
+        return std::size_t(std::numeric_limits<int>::max()) & ~std::size_t(4095);
+      }
+
+      /// Send a buffer
+
+      /// The buffer is sent in messages of at most \c chunk_bytes() bytes,
+      /// which are received in order, since they have the same tag.
+      /// \param world The world of the messages
+      /// \param buffer The buffer
+      /// \param dest The receiving process
+      /// \param tag The message tag
+      /// \param done Called when the buffer may be released
+      static void send(World& world, const std::pair<void*, std::size_t>& buffer,
+          const ProcessID dest, const int tag, std::function<void()>&& done)
+      {
+        std::vector<SafeMPI::Request> requests;
+        const char* data = static_cast<const char*>(buffer.first);
+        for(std::size_t offset = 0ul; offset < buffer.second; offset += chunk_bytes()) {
+          const int count = std::min(chunk_bytes(), buffer.second - offset);
+          requests.push_back(world.mpi.Isend(data + offset, count, MPI_BYTE,
+              dest, tag));
+        }
+        world.taskq.add(new BufferTransferTask(world, std::move(requests),
+            std::move(done)));
+      }
+
+      /// Receive a buffer
+
+      /// \param world The world of the messages
+      /// \param buffer The buffer
+      /// \param source The sending process
+      /// \param tag The message tag
+      /// \param done Called when the buffer has been received
+      static void recv(World& world, const std::pair<void*, std::size_t>& buffer,
+          const ProcessID source, const int tag, std::function<void()>&& done)
+      {
+        std::vector<SafeMPI::Request> requests;
+        char* data = static_cast<char*>(buffer.first);
+        for(std::size_t offset = 0ul; offset < buffer.second; offset += chunk_bytes()) {
+          const int count = std::min(chunk_bytes(), buffer.second - offset);
+          requests.push_back(world.mpi.Irecv(data + offset, count, MPI_BYTE,
+              source, tag));
+        }
+        world.taskq.add(new BufferTransferTask(world, std::move(requests),
+            std::move(done)));
+      }
+
+    }; // class BufferTransferTask
+
+  }  // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ZERO_COPY_H__INCLUDED
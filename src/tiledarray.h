@@ -35,29 +35,68 @@
 // Expression functionality
 #include <TiledArray/expressions/scal_expr.h>
 #include <TiledArray/expressions/tsr_expr.h>
+#include <TiledArray/expressions/expr_batch.h>
+#include <TiledArray/expressions/expr_plan.h>
+#include <TiledArray/array_batch.h>
+#include <TiledArray/subworld.h>
 #include <TiledArray/conversions/sparse_to_dense.h>
 #include <TiledArray/conversions/dense_to_sparse.h>
 #include <TiledArray/conversions/to_new_tile_type.h>
 #include <TiledArray/conversions/truncate.h>
 #include <TiledArray/conversions/foreach.h>
 #include <TiledArray/conversions/make_array.h>
+#include <TiledArray/conversions/rebalance.h>
+#include <TiledArray/conversions/retile.h>
+#include <TiledArray/conversions/block_cyclic.h>
 
 // Special Arrays
 #include <TiledArray/special/diagonal_array.h>
 
+// Out-of-core tiles
+#include <TiledArray/out_of_core.h>
+
+// Parallel checkpoint files
+#include <TiledArray/checkpoint.h>
+
+// Node-shared replicated arrays
+#include <TiledArray/node_shared.h>
+
+// Arrays compressed at rest
+#include <TiledArray/compressed_array.h>
+
 // Process maps
+#include <TiledArray/pmap/balanced_grid_pmap.h>
+#include <TiledArray/pmap/fiber_pmap.h>
 #include <TiledArray/pmap/hash_pmap.h>
+#include <TiledArray/pmap/morton_pmap.h>
+#include <TiledArray/pmap/pmap_diagnostics.h>
 #include <TiledArray/pmap/replicated_pmap.h>
+#include <TiledArray/pmap/weighted_pmap.h>
 
 // Utility functionality
 #include <TiledArray/conversions/eigen.h>
+#include <TiledArray/block_size_tuner.h>
+#include <TiledArray/roofline.h>
+#include <TiledArray/machine_calibration.h>
+#include <TiledArray/task_priority.h>
+#include <TiledArray/top_k.h>
 
 // Linear algebra
+#include <TiledArray/algebra/cholesky.h>
 #include <TiledArray/algebra/conjgrad.h>
+#include <TiledArray/algebra/davidson.h>
+#include <TiledArray/algebra/gmres.h>
+#include <TiledArray/algebra/matrix_functions.h>
+#include <TiledArray/algebra/randomized_svd.h>
+#include <TiledArray/algebra/threshold_schedule.h>
 #include "TiledArray/dist_array.h"
 
 #ifdef TILEDARRAY_HAS_ELEMENTAL
 #include <TiledArray/elemental.h> 
 #endif
 
+#ifdef TILEDARRAY_HAS_CUDA
+#include <TiledArray/cuda/cuda_tensor.h>
+#endif
+
 #endif // TILEDARRAY_H__INCLUDED
@@ -21,6 +21,7 @@
 #define TILEDARRAY_FWD_H__INCLUDED
 
 #include <complex>
+#include <TiledArray/config.h>
 
 namespace Eigen { // fwd define Eigen's aligned allocator for TiledArray::Tensor
   template<class>
@@ -41,12 +42,34 @@ namespace TiledArray {
   template<typename, typename>
   class Tensor;
 
-  typedef Tensor<double, Eigen::aligned_allocator<double> > TensorD;
-  typedef Tensor<int, Eigen::aligned_allocator<int> > TensorI;
-  typedef Tensor<float, Eigen::aligned_allocator<float> > TensorF;
-  typedef Tensor<long, Eigen::aligned_allocator<long> > TensorL;
-  typedef Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > > TensorZ;
-  typedef Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > > TensorC;
+  // Tile allocators
+  template <typename>
+  class PoolAllocator;
+  template <typename>
+  class NumaAllocator;
+
+  /// The default allocator of \c Tensor data
+
+  /// \c NumaAllocator when TiledArray is configured with \c TA_NUMA_ALLOCATOR ,
+  /// \c PoolAllocator when it is configured with \c TA_POOL_ALLOCATOR ,
+  /// otherwise \c Eigen::aligned_allocator .
+#if defined(TILEDARRAY_USE_NUMA_ALLOCATOR)
+  template <typename T>
+  using default_allocator = NumaAllocator<T>;
+#elif defined(TILEDARRAY_USE_POOL_ALLOCATOR)
+  template <typename T>
+  using default_allocator = PoolAllocator<T>;
+#else
+  template <typename T>
+  using default_allocator = Eigen::aligned_allocator<T>;
+#endif // defined(TILEDARRAY_USE_NUMA_ALLOCATOR)
+
+  typedef Tensor<double, default_allocator<double> > TensorD;
+  typedef Tensor<int, default_allocator<int> > TensorI;
+  typedef Tensor<float, default_allocator<float> > TensorF;
+  typedef Tensor<long, default_allocator<long> > TensorL;
+  typedef Tensor<std::complex<double>, default_allocator<std::complex<double> > > TensorZ;
+  typedef Tensor<std::complex<float>, default_allocator<std::complex<float> > > TensorC;
 
   // TiledArray Arrays
   template <typename, typename> class DistArray;
@@ -54,7 +77,7 @@ namespace TiledArray {
 
   // Dense Array Typedefs
   template <typename T>
-  using TArray = DistArray<Tensor<T, Eigen::aligned_allocator<T> >, DensePolicy>;
+  using TArray = DistArray<Tensor<T, default_allocator<T> >, DensePolicy>;
   typedef TArray<double>                  TArrayD;
   typedef TArray<int>                     TArrayI;
   typedef TArray<float>                   TArrayF;
@@ -64,7 +87,7 @@ namespace TiledArray {
 
   // Sparse Array Typedefs
   template <typename T>
-  using TSpArray = DistArray<Tensor<T, Eigen::aligned_allocator<T> >, SparsePolicy>;
+  using TSpArray = DistArray<Tensor<T, default_allocator<T> >, SparsePolicy>;
   typedef TSpArray<double>                TSpArrayD;
   typedef TSpArray<int>                   TSpArrayI;
   typedef TSpArray<float>                 TSpArrayF;
@@ -73,7 +96,7 @@ namespace TiledArray {
   typedef TSpArray<std::complex<float> >  TSpArrayC;
 
   // type alias for backward compatibility: the old Array has static type, DistArray is rank-polymorphic
-  template <typename T, unsigned int = 0, typename Tile = Tensor<T, Eigen::aligned_allocator<T> >, typename Policy = DensePolicy>
+  template <typename T, unsigned int = 0, typename Tile = Tensor<T, default_allocator<T> >, typename Policy = DensePolicy>
   using Array = DistArray<Tile, Policy>;
 
 } // namespace TiledArray
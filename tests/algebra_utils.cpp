@@ -0,0 +1,136 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  algebra_utils.cpp
+ *  October 15, 2026
+ *
+ */
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include "TiledArray/algebra/utils.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct AlgebraUtilsFixture {
+
+  AlgebraUtilsFixture() :
+    bounds({{0, 4, 9, 15}}), n(bounds.back()), matrices()
+  {
+    // Each matrix has a different block of zero tiles, so the sparse arrays
+    // have different shapes
+    for(std::size_t m = 0ul; m < 4ul; ++m) {
+      EigenMatrixXd matrix(n, n);
+      for(std::size_t i = 0ul; i < n; ++i)
+        for(std::size_t j = 0ul; j < n; ++j)
+          matrix(i,j) = std::sin(double(7ul * m + 3ul * i + j + 1ul));
+      if(m < 3ul)
+        matrix.block(bounds[m], bounds[2ul - m], bounds[m + 1ul] - bounds[m],
+            bounds[3ul - m] - bounds[2ul - m]).setZero();
+      matrices.push_back(matrix);
+    }
+  }
+
+  TArrayD make_array(const EigenMatrixXd& m) const {
+    const TiledRange1 tr1(bounds.begin(), bounds.end());
+    const std::array<TiledRange1, 2> dims = {{ tr1, tr1 }};
+    return eigen_to_array<TArrayD>(*GlobalFixture::world,
+        TiledRange(dims.begin(), dims.end()), m, true);
+  }
+
+  /// Convert an array to an Eigen matrix on every process
+  template <typename Array>
+  static EigenMatrixXd to_matrix(const Array& array) {
+    EigenMatrixXd result = EigenMatrixXd::Zero(
+        array.trange().elements_range().extent(0),
+        array.trange().elements_range().extent(1));
+    for(std::size_t t = 0ul; t < array.size(); ++t) {
+      if(array.is_zero(t))
+        continue;
+      const typename Array::value_type tile = array.find(t).get();
+      for(auto it = tile.range().begin(); it != tile.range().end(); ++it)
+        result((*it)[0], (*it)[1]) = tile[*it];
+    }
+    return result;
+  }
+
+  /// Compare dot_products and linear_combination with element-wise
+  /// references
+  template <typename Array>
+  void check(const std::vector<Array>& arrays) const {
+    std::vector<const Array*> x;
+    for(const Array& array : arrays)
+      x.push_back(&array);
+
+    // Dot products of the first array with all arrays, including itself
+    const std::vector<double> dots = dot_products(arrays.front(), x);
+    BOOST_REQUIRE_EQUAL(dots.size(), arrays.size());
+    for(std::size_t k = 0ul; k < arrays.size(); ++k)
+      BOOST_CHECK_SMALL(dots[k] - matrices.front().cwiseProduct(matrices[k]).sum(),
+          1.0e-10);
+
+    // Linear combination into a new array, and into one of its terms
+    const std::vector<double> c = { 1.5, -2.0, 0.25, 3.0 };
+    EigenMatrixXd expected = EigenMatrixXd::Zero(n, n);
+    for(std::size_t k = 0ul; k < arrays.size(); ++k)
+      expected += c[k] * matrices[k];
+
+    Array y;
+    linear_combination(y, c, x);
+    BOOST_CHECK_SMALL((to_matrix(y) - expected).norm(), 1.0e-12);
+
+    Array z = arrays[1];
+    x[1] = &z;
+    linear_combination(z, c, x);
+    BOOST_CHECK_SMALL((to_matrix(z) - expected).norm(), 1.0e-12);
+    BOOST_CHECK_SMALL((to_matrix(arrays[1]) - matrices[1]).norm(), 1.0e-12);
+  }
+
+  const std::array<std::size_t, 4> bounds;
+  const std::size_t n;
+  std::vector<EigenMatrixXd> matrices;
+}; // AlgebraUtilsFixture
+
+BOOST_FIXTURE_TEST_SUITE( algebra_utils_suite, AlgebraUtilsFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  std::vector<TArrayD> arrays;
+  for(const EigenMatrixXd& matrix : matrices)
+    arrays.push_back(make_array(matrix));
+  check(arrays);
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  std::vector<TSpArrayD> arrays;
+  for(const EigenMatrixXd& matrix : matrices)
+    arrays.push_back(to_sparse(make_array(matrix)));
+  BOOST_CHECK(arrays[0].is_zero(2ul));
+  BOOST_CHECK(arrays[1].is_zero(4ul));
+  BOOST_CHECK(arrays[2].is_zero(6ul));
+  check(arrays);
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
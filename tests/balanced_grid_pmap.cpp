@@ -0,0 +1,172 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/balanced_grid_pmap.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct BalancedGridPmapFixture {
+
+  BalancedGridPmapFixture() { }
+
+  static std::vector<std::size_t> make_weights(const std::size_t tiles) {
+    // The tile sizes grow with the index, so the cyclic assignment puts
+    // the larger tiles on the last process rows and columns
+    std::vector<std::size_t> weights(tiles);
+    for(std::size_t tile = 0ul; tile < tiles; ++tile)
+      weights[tile] = (tile + 1ul) * (tile + 1ul);
+    return weights;
+  }
+
+  static std::size_t proc_rows() {
+    const std::size_t procs = GlobalFixture::world->size();
+    std::size_t rows = std::sqrt(double(procs));
+    while(procs % rows) --rows;
+    return rows;
+  }
+
+};
+
+// =============================================================================
+// BalancedGridPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( balanced_grid_pmap_suite, BalancedGridPmapFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  const std::size_t p_rows = proc_rows();
+  const std::size_t p_cols = GlobalFixture::world->size() / p_rows;
+  for(std::size_t x = 1ul; x < 10ul; ++x) {
+    for(std::size_t y = 1ul; y < 10ul; ++y) {
+      BOOST_REQUIRE_NO_THROW(TiledArray::detail::BalancedGridPmap pmap(* GlobalFixture::world,
+          make_weights(x), make_weights(y), p_rows, p_cols));
+      TiledArray::detail::BalancedGridPmap pmap(* GlobalFixture::world,
+          make_weights(x), make_weights(y), p_rows, p_cols);
+      BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+      BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+      BOOST_CHECK_EQUAL(pmap.size(), x * y);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( assign )
+{
+  typedef TiledArray::detail::BalancedGridPmap pmap_type;
+
+  for(std::size_t bins = 1ul; bins < 6ul; ++bins) {
+    for(std::size_t items = 1ul; items < 30ul; ++items) {
+      const std::vector<std::size_t> weights = make_weights(items);
+      const std::vector<std::size_t> assignment = pmap_type::assign(weights, bins);
+      BOOST_REQUIRE_EQUAL(assignment.size(), items);
+      for(const std::size_t bin : assignment)
+        BOOST_CHECK_LT(bin, bins);
+
+      // The greedy assignment is never worse than the cyclic assignment
+      // by more than the largest item, and the largest load exceeds the
+      // average load by at most the largest item
+      const std::size_t balanced = pmap_type::max_load(weights, assignment, bins);
+      const std::size_t cyclic = pmap_type::max_load(weights,
+          pmap_type::assign_cyclic(items, bins), bins);
+      const std::size_t total = std::accumulate(weights.begin(), weights.end(), 0ul);
+      BOOST_CHECK_LE(balanced, cyclic + weights.back());
+      BOOST_CHECK_LE(double(balanced), double(total) / double(bins) + double(weights.back()));
+    }
+  }
+
+  // Zero weights are spread over the bins
+  const std::vector<std::size_t> assignment =
+      pmap_type::assign(std::vector<std::size_t>(8ul, 0ul), 4ul);
+  const std::vector<std::size_t> counts = { 2ul, 2ul, 2ul, 2ul };
+  std::vector<std::size_t> bin_counts(4ul, 0ul);
+  for(const std::size_t bin : assignment)
+    ++bin_counts[bin];
+  BOOST_CHECK_EQUAL_COLLECTIONS(bin_counts.begin(), bin_counts.end(),
+      counts.begin(), counts.end());
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t rank = GlobalFixture::world->rank();
+  const std::size_t size = GlobalFixture::world->size();
+  const std::size_t p_rows = proc_rows();
+  const std::size_t p_cols = size / p_rows;
+
+  ProcessID* p_owner = new ProcessID[size];
+
+  for(std::size_t x = 1ul; x < 10ul; ++x) {
+    for(std::size_t y = 1ul; y < 10ul; ++y) {
+      TiledArray::detail::BalancedGridPmap pmap(* GlobalFixture::world,
+          make_weights(x), make_weights(y), p_rows, p_cols);
+
+      for(std::size_t tile = 0; tile < x * y; ++tile) {
+        std::fill_n(p_owner, size, 0);
+        p_owner[rank] = pmap.owner(tile);
+        // check that the value is in range
+        BOOST_CHECK_LT(p_owner[rank], size);
+        GlobalFixture::world->gop.sum(p_owner, size);
+
+        // Make sure everyone agrees on who owns what.
+        for(std::size_t p = 0ul; p < size; ++p)
+          BOOST_CHECK_EQUAL(p_owner[p], p_owner[rank]);
+
+        // Tiles of a row are in one process row, and tiles of a column in
+        // one process column
+        BOOST_CHECK_EQUAL(pmap.owner(tile) / p_cols, pmap.owner((tile / y) * y) / p_cols);
+        BOOST_CHECK_EQUAL(pmap.owner(tile) % p_cols, pmap.owner(tile % y) % p_cols);
+      }
+    }
+  }
+
+  delete [] p_owner;
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[100];
+  const std::size_t p_rows = proc_rows();
+  const std::size_t p_cols = GlobalFixture::world->size() / p_rows;
+
+  for(std::size_t x = 1ul; x < 10ul; ++x) {
+    for(std::size_t y = 1ul; y < 10ul; ++y) {
+      TiledArray::detail::BalancedGridPmap pmap(* GlobalFixture::world,
+          make_weights(x), make_weights(y), p_rows, p_cols);
+
+      // Check that all local elements map to this rank
+      for(detail::BalancedGridPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+        BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+      }
+
+      std::fill_n(tile_owners, x * y, 0);
+      for(detail::BalancedGridPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+        tile_owners[*it] += GlobalFixture::world->rank();
+      }
+
+      GlobalFixture::world->gop.sum(tile_owners, x * y);
+      for(std::size_t tile = 0; tile < x * y; ++tile) {
+        BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -675,6 +675,34 @@ BOOST_AUTO_TEST_CASE( bit_count )
   BOOST_CHECK_EQUAL(set.count(), count);
 }
 
+BOOST_AUTO_TEST_CASE( find )
+{
+  // Check that an empty bitset has no set bits
+  BOOST_CHECK_EQUAL(set.find_first(), size);
+
+  // Fill bitset with random data
+  std::size_t n = size * 0.25;
+  GlobalFixture::world->srand(27);
+  for(std::size_t i = 0; i < n; ++i)
+    set.set(std::size_t(GlobalFixture::world->rand()) % size);
+
+  // Check that find visits the set bits in order
+  std::size_t i = set.find_first();
+  for(std::size_t ii = 0ul; ii < size; ++ii) {
+    if(set[ii]) {
+      BOOST_CHECK_EQUAL(i, ii);
+      i = set.find_next(i);
+    }
+  }
+  BOOST_CHECK_EQUAL(i, size);
+
+  // Check that the bits of the tail are not found
+  set.reset();
+  set.flip();
+  set.reset(size - 1ul);
+  BOOST_CHECK_EQUAL(set.find_next(size - 2ul), size);
+}
+
 BOOST_AUTO_TEST_CASE( operator_bool )
 {
   // Check that a bitset full of zeros returns false
@@ -0,0 +1,87 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  block_pmap.cpp
+ *  October 15, 2026
+ *
+ */
+
+#include "TiledArray/pmap/block_pmap.h"
+#include "TiledArray/pmap/hash_pmap.h"
+#include "unit_test_config.h"
+
+struct BlockPmapFixture {
+
+  BlockPmapFixture() :
+    range(std::vector<std::size_t>{ 5, 6, 7 }),
+    lower{ 1, 2, 3 }, upper{ 4, 6, 5 },
+    pmap(std::make_shared<TiledArray::detail::HashPmap>(* GlobalFixture::world,
+        range.volume()))
+  { }
+
+  TiledArray::Range range;
+  std::vector<std::size_t> lower;
+  std::vector<std::size_t> upper;
+  std::shared_ptr<TiledArray::detail::Pmap> pmap;
+}; // Fixture
+
+BOOST_FIXTURE_TEST_SUITE( block_pmap_suite, BlockPmapFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  BOOST_REQUIRE_NO_THROW(TiledArray::detail::BlockPmap block_pmap(* GlobalFixture::world,
+      pmap, range, lower, upper));
+  TiledArray::detail::BlockPmap block_pmap(* GlobalFixture::world, pmap, range,
+      lower, upper);
+  BOOST_CHECK_EQUAL(block_pmap.rank(), GlobalFixture::world->rank());
+  BOOST_CHECK_EQUAL(block_pmap.procs(), GlobalFixture::world->size());
+  BOOST_CHECK_EQUAL(block_pmap.size(), 3ul * 4ul * 2ul);
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const TiledArray::Range block(lower, upper);
+  for(const TiledArray::Permutation& perm : { TiledArray::Permutation(),
+      TiledArray::Permutation({ 2, 0, 1 }) })
+  {
+    TiledArray::detail::BlockPmap block_pmap(* GlobalFixture::world, pmap,
+        range, lower, upper, perm);
+    const std::vector<std::size_t> extent{ 3, 4, 2 };
+    const TiledArray::Range perm_block(perm ? perm * extent : extent);
+
+    // Check that the block tiles are owned by the owner of the array tiles
+    std::size_t local_size = 0ul;
+    for(const auto& index : block) {
+      std::vector<std::size_t> block_index(index.size());
+      for(std::size_t d = 0ul; d < index.size(); ++d)
+        block_index[d] = index[d] - lower[d];
+      const std::size_t tile = perm_block.ordinal(perm ? perm * block_index : block_index);
+      BOOST_CHECK_EQUAL(block_pmap.owner(tile), pmap->owner(range.ordinal(index)));
+      BOOST_CHECK_EQUAL(block_pmap.is_local(tile), pmap->is_local(range.ordinal(index)));
+      if(block_pmap.is_local(tile))
+        ++local_size;
+    }
+
+    // Check the local tiles
+    BOOST_CHECK_EQUAL(block_pmap.local_size(), local_size);
+    for(TiledArray::detail::BlockPmap::const_iterator it = block_pmap.begin();
+        it != block_pmap.end(); ++it)
+      BOOST_CHECK_EQUAL(block_pmap.owner(*it), GlobalFixture::world->rank());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
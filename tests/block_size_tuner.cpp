@@ -0,0 +1,83 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  block_size_tuner.cpp
+ *
+ */
+
+#include "TiledArray/block_size_tuner.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include <cstdio>
+
+using namespace TiledArray;
+
+struct BlockSizeTunerFixture {
+
+  BlockSizeTunerFixture() : cache_file("block_size_tuner_test.txt") {
+    if(GlobalFixture::world->rank() == 0)
+      std::remove(cache_file.c_str());
+    GlobalFixture::world->gop.fence();
+  }
+
+  ~BlockSizeTunerFixture() {
+    GlobalFixture::world->gop.fence();
+    if(GlobalFixture::world->rank() == 0)
+      std::remove(cache_file.c_str());
+  }
+
+  std::string cache_file;
+}; // BlockSizeTunerFixture
+
+BOOST_FIXTURE_TEST_SUITE( block_size_tuner_suite, BlockSizeTunerFixture )
+
+BOOST_AUTO_TEST_CASE( make_trange1 )
+{
+  const TiledRange1 tr1 = BlockSizeTuner::make_trange1(10ul, 4ul);
+  BOOST_CHECK_EQUAL(tr1, TiledRange1(0, 4, 8, 10));
+  BOOST_CHECK_EQUAL(BlockSizeTuner::make_trange1(8ul, 4ul), TiledRange1(0, 4, 8));
+}
+
+BOOST_AUTO_TEST_CASE( recommend )
+{
+  World& world = *GlobalFixture::world;
+  BlockSizeTuner tuner(world, cache_file);
+  tuner.set_candidates({ 8ul, 16ul, 32ul });
+
+  const BlockSizeTuner::Recommendation rec = tuner.recommend(48ul, 48ul, 48ul, 2ul);
+  BOOST_CHECK(rec.measured);
+  BOOST_CHECK(! rec.cached);
+  BOOST_CHECK(rec.block == 8ul || rec.block == 16ul || rec.block == 32ul);
+  BOOST_CHECK_GT(rec.time, 0.0);
+  BOOST_CHECK_EQUAL(tuner.model().gemm_rate.size(), 3ul);
+
+  // A second tuner reads the calibration and the recommendation from the
+  // cache file
+  BlockSizeTuner cached(world, cache_file);
+  cached.set_candidates({ 8ul, 16ul, 32ul });
+  const BlockSizeTuner::Recommendation again = cached.recommend(48ul, 48ul, 48ul, 2ul);
+  BOOST_CHECK(again.cached);
+  BOOST_CHECK_EQUAL(again.block, rec.block);
+  BOOST_CHECK_EQUAL(cached.model().gemm_rate.size(), 3ul);
+
+  // Candidates larger than the problem are not considered
+  const BlockSizeTuner::Recommendation small = cached.recommend(12ul, 12ul, 12ul);
+  BOOST_CHECK(! small.measured);
+  BOOST_CHECK_EQUAL(small.block, 8ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -262,6 +262,37 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(to_btas_subtensor, bTensor, tensor_types) {
 
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(views, bTensor, tensor_types) {
+  using range_type = typename bTensor::range_type;
+  bTensor src = make_rand_tile<bTensor>(range_type({4,5}));
+
+  // TiledArray view of a btas::Tensor shares its data
+  auto ta_view = make_ta_view(src);
+  using std::data;
+  BOOST_CHECK_EQUAL(ta_view.data(), data(src));
+  for(const auto& i: ta_view.range())
+    BOOST_CHECK_EQUAL(ta_view(i), src(i));
+
+  // BTAS view of a TiledArray::Tensor shares its data
+  Tensor<double> t(TiledArray::Range({1,1}, {3,4}));
+  btas_subtensor_to_tensor(src, t);
+  auto btas_view = make_btas_view(t);
+  btas_view(1,2) = -1.0;
+  BOOST_CHECK_EQUAL(t(1,2), -1.0);
+  for(const auto& i: t.range())
+    BOOST_CHECK_EQUAL(btas_view(i), t(i));
+
+  // Conversions with matching ranges
+  Tensor<double> dst(TiledArray::Range({4,5}));
+  btas_subtensor_to_tensor(src, dst);
+  for(const auto& i: dst.range())
+    BOOST_CHECK_EQUAL(dst(i), src(i));
+  bTensor src_copy(range_type({4,5}), 0.0);
+  tensor_to_btas_subtensor(dst, src_copy);
+  for(const auto& i: dst.range())
+    BOOST_CHECK_EQUAL(src_copy(i), dst(i));
+}
+
 BOOST_AUTO_TEST_CASE_TEMPLATE(dense_array_conversion, bTensor, tensor_types) {
   // make random btas::Tensor on World rank 0, and replicate
   const auto root = 0;
@@ -0,0 +1,159 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/checkpoint.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "range_fixture.h"
+
+using namespace TiledArray;
+
+struct CheckpointFixture : public TiledRangeFixture {
+
+  CheckpointFixture() :
+    world(*GlobalFixture::world), filename("checkpoint_test.ta")
+  { }
+
+  template <typename Array>
+  void fill(Array& array) {
+    for(const auto ord : *array.pmap()) {
+      if(array.is_zero(ord))
+        continue;
+      typename Array::value_type tile(array.trange().make_tile_range(ord));
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        tile[i] = double(ord * 1000ul + i + 1ul);
+      array.set(ord, tile);
+    }
+  }
+
+  template <typename Array>
+  static void check_equal(const Array& expected, const Array& result) {
+    BOOST_REQUIRE(expected.trange() == result.trange());
+    for(const auto ord : *result.pmap()) {
+      BOOST_CHECK_EQUAL(expected.is_zero(ord), result.is_zero(ord));
+      if(result.is_zero(ord))
+        continue;
+      const auto tile0 = expected.find(ord).get();
+      const auto tile = result.find(ord).get();
+      BOOST_REQUIRE_EQUAL(tile0.range(), tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile0[i], tile[i]);
+    }
+  }
+
+  World& world;
+  const std::string filename;
+};
+
+BOOST_FIXTURE_TEST_SUITE( checkpoint_suite, CheckpointFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  TArrayD a(world, tr);
+  fill(a);
+
+  write_array(a, filename).wait();
+
+  // Restart with a different process map
+  std::shared_ptr<TArrayD::pmap_interface> pmap =
+      std::make_shared<detail::HashPmap>(world, tr.tiles_range().volume());
+  TArrayD b;
+  BOOST_REQUIRE_NO_THROW(b = read_array<TArrayD>(world, filename, pmap));
+  BOOST_CHECK(b.pmap() == pmap);
+  check_equal(a, b);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( exact_with_compression )
+{
+  // Lossy compression of messages does not apply to checkpoints; the
+  // tolerance drops every element
+  TensorCompression::set(TensorCompression::lossy, 0ul, 1.0e+12);
+
+  TArrayD a(world, tr);
+  fill(a);
+  write_array(a, filename).wait();
+  const TArrayD b = read_array<TArrayD>(world, filename);
+
+  TensorCompression::set(TensorCompression::none);
+  check_equal(a, b);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  // Every other tile is zero
+  Tensor<float> norms(tr.tiles_range(), 0.0f);
+  for(std::size_t i = 0ul; i < norms.size(); i += 2ul)
+    norms[i] = std::numeric_limits<float>::max();
+  TSpArrayD a(world, tr, SparseShape<float>(norms, tr));
+  fill(a);
+
+  CheckpointWrite request = write_array(a, filename);
+  request.wait();
+
+  const TSpArrayD b = read_array<TSpArrayD>(world, filename);
+  check_equal(a, b);
+
+  // A sparse checkpoint may be read into a dense array
+  const TArrayD c = read_array<TArrayD>(world, filename);
+  for(const auto ord : *c.pmap()) {
+    if(! a.is_zero(ord))
+      continue;
+    const auto tile = c.find(ord).get();
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], 0.0);
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( mapped )
+{
+  Tensor<float> norms(tr.tiles_range(), 0.0f);
+  for(std::size_t i = 1ul; i < norms.size(); i += 2ul)
+    norms[i] = std::numeric_limits<float>::max();
+  TSpArrayD a(world, tr, SparseShape<float>(norms, tr));
+  fill(a);
+
+  write_mapped_array(a, filename).wait();
+  world.gop.fence();
+
+  const TSpArrayD b = map_array<TSpArrayD>(world, filename);
+  check_equal(a, b);
+
+  // The local tiles are views of the mapped file
+  for(const auto ord : *b.pmap()) {
+    if(b.is_zero(ord))
+      continue;
+    const auto tile = b.find(ord).get();
+    const auto tile0 = a.find(ord).get();
+    BOOST_CHECK(tile.data() != tile0.data());
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(tile.data()) % 64ul, 0ul);
+  }
+
+  // A serialized checkpoint file cannot be mapped
+  const std::string serialized_filename = filename + ".serialized";
+  write_array(a, serialized_filename).wait();
+  world.gop.fence();
+  BOOST_CHECK_THROW(map_array<TSpArrayD>(world, serialized_filename),
+      TiledArray::Exception);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
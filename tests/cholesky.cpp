@@ -0,0 +1,109 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <array>
+#include <cmath>
+#include "TiledArray/algebra/cholesky.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct CholeskyFixture {
+  CholeskyFixture() :
+    bounds({{0, 3, 7, 12, 15}}), rhs_bounds({{0, 2, 5}}),
+    rows(bounds.begin(), bounds.end()), cols(rhs_bounds.begin(), rhs_bounds.end()),
+    n(bounds.back()), a(n, n), b(n, rhs_bounds.back())
+  {
+    // A well-conditioned symmetric positive definite matrix
+    EigenMatrixXd m(n, n);
+    for(std::size_t i = 0ul; i < n; ++i)
+      for(std::size_t j = 0ul; j < n; ++j)
+        m(i,j) = std::sin(double(i + 2ul * j + 1ul));
+    a = m * m.transpose() + double(n) * EigenMatrixXd::Identity(n, n);
+
+    for(std::size_t i = 0ul; i < n; ++i)
+      for(std::size_t j = 0ul; j < rhs_bounds.back(); ++j)
+        b(i,j) = std::cos(double(3ul * i + j));
+  }
+
+  /// Convert an array to an Eigen matrix on every process
+  static EigenMatrixXd to_matrix(const TArrayD& array) {
+    EigenMatrixXd result(array.trange().elements_range().extent(0),
+        array.trange().elements_range().extent(1));
+    for(std::size_t t = 0ul; t < array.size(); ++t) {
+      const TArrayD::value_type tile = array.find(t).get();
+      for(auto it = tile.range().begin(); it != tile.range().end(); ++it)
+        result((*it)[0], (*it)[1]) = tile[*it];
+    }
+    return result;
+  }
+
+  const std::array<std::size_t, 5> bounds;
+  const std::array<std::size_t, 3> rhs_bounds;
+  TiledRange1 rows;
+  TiledRange1 cols;
+  const std::size_t n;
+  EigenMatrixXd a;
+  EigenMatrixXd b;
+}; // CholeskyFixture
+
+BOOST_FIXTURE_TEST_SUITE( cholesky_suite , CholeskyFixture )
+
+BOOST_AUTO_TEST_CASE( factorize )
+{
+  const std::array<TiledRange1, 2> dims = {{ rows, rows }};
+  TArrayD A = eigen_to_array<TArrayD>(*GlobalFixture::world,
+      TiledRange(dims.begin(), dims.end()), a, true);
+
+  TArrayD L;
+  BOOST_REQUIRE_NO_THROW(L = cholesky(A));
+  const EigenMatrixXd l = to_matrix(L);
+
+  // L is lower triangular and reproduces A
+  for(std::size_t i = 0ul; i < n; ++i)
+    for(std::size_t j = i + 1ul; j < n; ++j)
+      BOOST_CHECK_EQUAL(l(i,j), 0.0);
+  BOOST_CHECK_SMALL((l * l.transpose() - a).norm(), 1.0e-10 * a.norm());
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( solve )
+{
+  const std::array<TiledRange1, 2> a_dims = {{ rows, rows }};
+  const std::array<TiledRange1, 2> b_dims = {{ rows, cols }};
+  TArrayD A = eigen_to_array<TArrayD>(*GlobalFixture::world,
+      TiledRange(a_dims.begin(), a_dims.end()), a, true);
+  TArrayD B = eigen_to_array<TArrayD>(*GlobalFixture::world,
+      TiledRange(b_dims.begin(), b_dims.end()), b, true);
+
+  // Solve A X = B with L (L^T X) = B
+  TArrayD L = cholesky(A);
+  TArrayD Y = triangular_solve(L, B);
+  TArrayD X = triangular_solve(L, Y, true);
+
+  const EigenMatrixXd l = to_matrix(L);
+  BOOST_CHECK_SMALL((l * to_matrix(Y) - b).norm(), 1.0e-10 * b.norm());
+  BOOST_CHECK_SMALL((a * to_matrix(X) - b).norm(), 1.0e-10 * b.norm());
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
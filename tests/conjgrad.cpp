@@ -0,0 +1,170 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  conjgrad.cpp
+ *  October 15, 2026
+ *
+ */
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include "TiledArray/algebra/conjgrad.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct ConjGradFixture {
+
+  /// Matrix-vector product
+  template <typename Array>
+  struct Multiply {
+    Array A;
+    void operator()(const Array& x, Array& result) const {
+      result("i,k") = A("i,j") * x("j,k");
+    }
+  }; // struct Multiply
+
+  /// Block-Jacobi tile operation, which multiplies each tile by the inverse
+  /// of the corresponding diagonal block of the matrix
+  struct BlockJacobi {
+    std::vector<EigenMatrixXd> inverses;
+    typedef TArrayD::value_type tile_type;
+    tile_type operator()(const tile_type& r, const std::size_t index) const {
+      tile_type z(r.range());
+      Eigen::Map<Eigen::VectorXd>(z.data(), z.size()) = inverses[index] *
+          Eigen::Map<const Eigen::VectorXd>(r.data(), r.size());
+      return z;
+    }
+  }; // struct BlockJacobi
+
+  ConjGradFixture() :
+    bounds({{0, 5, 11, 20}}), rhs_bounds({{0, 1}}), n(bounds.back()),
+    a(n, n), b(n, 1), jacobi()
+  {
+    // A banded, symmetric, diagonally dominant matrix, whose corner tiles
+    // are zero
+    for(std::size_t i = 0ul; i < n; ++i) {
+      for(std::size_t j = 0ul; j < n; ++j) {
+        const std::size_t d = (i > j ? i - j : j - i);
+        a(i,j) = (d <= 6ul ? 0.5 * std::cos(double(i + j)) : 0.0);
+      }
+      a(i,i) += double(n);
+      b(i,0) = std::sin(double(i + 1ul));
+    }
+
+    for(std::size_t t = 0ul; t + 1ul < bounds.size(); ++t) {
+      const std::size_t first = bounds[t], extent = bounds[t + 1ul] - first;
+      jacobi.inverses.push_back(a.block(first, first, extent, extent).inverse());
+    }
+  }
+
+  TArrayD make_array(const EigenMatrixXd& m, const bool square) const {
+    const TiledRange1 rows(bounds.begin(), bounds.end());
+    const TiledRange1 cols(rhs_bounds.begin(), rhs_bounds.end());
+    const std::array<TiledRange1, 2> dims = {{ rows, (square ? rows : cols) }};
+    return eigen_to_array<TArrayD>(*GlobalFixture::world,
+        TiledRange(dims.begin(), dims.end()), m, true);
+  }
+
+  /// Convert an array to an Eigen matrix on every process
+  template <typename Array>
+  static EigenMatrixXd to_matrix(const Array& array) {
+    EigenMatrixXd result = EigenMatrixXd::Zero(
+        array.trange().elements_range().extent(0),
+        array.trange().elements_range().extent(1));
+    for(std::size_t t = 0ul; t < array.size(); ++t) {
+      if(array.is_zero(t))
+        continue;
+      const typename Array::value_type tile = array.find(t).get();
+      for(auto it = tile.range().begin(); it != tile.range().end(); ++it)
+        result((*it)[0], (*it)[1]) = tile[*it];
+    }
+    return result;
+  }
+
+  const std::array<std::size_t, 4> bounds;
+  const std::array<std::size_t, 2> rhs_bounds;
+  const std::size_t n;
+  EigenMatrixXd a;
+  EigenMatrixXd b;
+  BlockJacobi jacobi;
+}; // ConjGradFixture
+
+BOOST_FIXTURE_TEST_SUITE( conjgrad_suite, ConjGradFixture )
+
+BOOST_AUTO_TEST_CASE( block_diagonal_preconditioner )
+{
+  const TArrayD B = make_array(b, false);
+  const auto preconditioner = make_block_diagonal_preconditioner<TArrayD>(jacobi);
+
+  TArrayD Z;
+  preconditioner(B, Z);
+  const EigenMatrixXd z = to_matrix(Z);
+  for(std::size_t t = 0ul; t < jacobi.inverses.size(); ++t) {
+    const std::size_t first = bounds[t], extent = bounds[t + 1ul] - first;
+    BOOST_CHECK_SMALL((z.block(first, 0, extent, 1) - jacobi.inverses[t] *
+        b.block(first, 0, extent, 1)).norm(), 1.0e-12);
+  }
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( pipelined_dense )
+{
+  const EigenMatrixXd reference = a.ldlt().solve(b);
+
+  // Dense arrays use the fused vector updates
+  Multiply<TArrayD> multiply{ make_array(a, true) };
+  const TArrayD B = make_array(b, false);
+  const auto preconditioner = make_block_diagonal_preconditioner<TArrayD>(jacobi);
+  PipelinedConjugateGradientSolver<TArrayD, Multiply<TArrayD>,
+      decltype(preconditioner)> solver;
+  TArrayD X;
+  BOOST_REQUIRE_NO_THROW(solver(multiply, B, X, preconditioner, 1.0e-12));
+  BOOST_CHECK(X.is_dense());
+
+  const EigenMatrixXd x = to_matrix(X);
+  BOOST_CHECK_SMALL((x - reference).norm(), 1.0e-9 * reference.norm());
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( pipelined_sparse )
+{
+  const EigenMatrixXd reference = a.ldlt().solve(b);
+
+  // Sparse arrays use the vector updates with expressions
+  Multiply<TSpArrayD> multiply{ to_sparse(make_array(a, true)) };
+  BOOST_CHECK(multiply.A.is_zero(2ul));
+  BOOST_CHECK(multiply.A.is_zero(6ul));
+  const TSpArrayD B = to_sparse(make_array(b, false));
+  const auto preconditioner = make_block_diagonal_preconditioner<TSpArrayD>(jacobi);
+  PipelinedConjugateGradientSolver<TSpArrayD, Multiply<TSpArrayD>,
+      decltype(preconditioner)> solver;
+  TSpArrayD X;
+  BOOST_REQUIRE_NO_THROW(solver(multiply, B, X, preconditioner, 1.0e-12));
+  BOOST_CHECK(! X.is_dense());
+
+  const EigenMatrixXd x = to_matrix(X);
+  BOOST_CHECK_SMALL((x - reference).norm(), 1.0e-9 * reference.norm());
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
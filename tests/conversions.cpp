@@ -23,6 +23,7 @@
  *
  */
 
+#include <atomic>
 #include "range_fixture.h"
 #include "tiledarray.h"
 #include "unit_test_config.h"
@@ -147,6 +148,27 @@ BOOST_AUTO_TEST_CASE(policy_conversions) {
 
 }
 
+BOOST_AUTO_TEST_CASE(move_to_sparse) {
+  TArrayI dense = to_dense(a_sparse);
+  TSpArrayI b_sparse;
+  BOOST_CHECK_NO_THROW(b_sparse = to_sparse(std::move(dense)));
+
+  BOOST_CHECK_EQUAL(a_sparse.shape().data(), b_sparse.shape().data());
+
+  // check correctness
+  for (std::size_t i = 0; i < a_sparse.size(); i++) {
+    if (!a_sparse.is_zero(i)) {
+      TSpArrayI::value_type a_tile = a_sparse.find(i).get();
+      TSpArrayI::value_type b_tile = b_sparse.find(i).get();
+
+      for (std::size_t j = 0ul; j < a_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(a_tile[j], b_tile[j]);
+    } else {
+      BOOST_CHECK(b_sparse.is_zero(i));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(tile_element_conversions) {
   // convert int to float
   TSpArrayF a_f_sparse;
@@ -172,6 +194,29 @@ BOOST_AUTO_TEST_CASE(tile_element_conversions) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(tile_wrap_conversions) {
+  // wrap the tiles of a (shallow) copy of a_sparse, consuming the copy
+  TSpArrayI a_copy = a_sparse;
+  DistArray<Tile<TensorI>, SparsePolicy> a_wrapped =
+      to_new_tile_type(std::move(a_copy), [] (TensorI&& tile) {
+        return Tile<TensorI>(std::move(tile));
+      });
+
+  for (std::size_t i = 0; i < a_sparse.size(); i++) {
+    if (!a_sparse.is_zero(i)) {
+      if (!a_wrapped.is_local(i))
+        continue;
+      TensorI a_tile = a_sparse.find(i).get();
+      Tile<TensorI> b_tile = a_wrapped.find(i).get();
+
+      // the tile data is not copied
+      BOOST_CHECK_EQUAL(a_tile.data(), b_tile.tensor().data());
+    } else {
+      BOOST_CHECK(a_wrapped.is_zero(i));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(make_array_test) {
   // make dense array
   BOOST_CHECK_NO_THROW(auto b_dense =
@@ -184,4 +229,191 @@ BOOST_AUTO_TEST_CASE(make_array_test) {
                                             &this->init_rand_tile<TensorI>));
 }
 
+BOOST_AUTO_TEST_CASE(make_array_batched_test) {
+  World& world = *GlobalFixture::world;
+  auto dense_op = [] (TensorI& tile, const Range& range, std::vector<int>& scratch) {
+    scratch.assign(range.volume(), 1);
+    tile = TensorI(range, scratch.begin());
+  };
+  auto sparse_op = [] (TensorI& tile, const Range& range, std::vector<int>& scratch) -> float {
+    // Only the tiles on the diagonal are non-zero
+    if(range.lobound()[0] != range.lobound()[1])
+      return 0.0f;
+    scratch.assign(range.volume(), 2);
+    tile = TensorI(range, scratch.begin());
+    return tile.norm();
+  };
+
+  for(std::size_t batch_size : { 0ul, 1ul, 3ul }) {
+    TArrayI a = make_array_batched<TArrayI>(world, this->tr,
+        TArrayI::policy_type::default_pmap(world, this->tr.tiles_range().volume()),
+        dense_op, batch_size);
+    TSpArrayI b = make_array_batched<TSpArrayI>(world, this->tr,
+        TSpArrayI::policy_type::default_pmap(world, this->tr.tiles_range().volume()),
+        sparse_op, batch_size);
+
+    for(const auto index : *a.pmap()) {
+      const TensorI tile = a.find(index).get();
+      for(const auto value : tile)
+        BOOST_CHECK_EQUAL(value, 1);
+    }
+    for(const auto index : *b.pmap()) {
+      const auto range = this->tr.make_tile_range(index);
+      BOOST_CHECK_EQUAL(b.is_zero(index), range.lobound()[0] != range.lobound()[1]);
+      if(b.is_zero(index))
+        continue;
+      const TensorI tile = b.find(index).get();
+      for(const auto value : tile)
+        BOOST_CHECK_EQUAL(value, 2);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(make_array_view_test) {
+  World& world = *GlobalFixture::world;
+  auto pmap = TSpArrayI::policy_type::default_pmap(world, this->tr.tiles_range().volume());
+
+  // One buffer per tile, where only the tiles on the diagonal are non-zero
+  std::vector<std::vector<int> > buffers(this->tr.tiles_range().volume());
+  for(const auto index : *pmap) {
+    const auto range = this->tr.make_tile_range(index);
+    if(range.lobound()[0] == range.lobound()[1])
+      buffers[index].assign(range.volume(), int(index));
+  }
+
+  std::atomic<bool> released(false);
+  {
+    TSpArrayI a = make_array_view<TSpArrayI>(world, this->tr, pmap,
+        [&buffers] (const std::size_t index) -> int* {
+          return (buffers[index].empty() ? nullptr : buffers[index].data());
+        }, [&released] () { released = true; });
+
+    for(const auto index : *pmap) {
+      BOOST_CHECK_EQUAL(a.is_zero(index), buffers[index].empty());
+      if(a.is_zero(index))
+        continue;
+
+      // The tile is a view of the buffer
+      const TensorI tile = a.find(index).get();
+      BOOST_CHECK_EQUAL(tile.data(), buffers[index].data());
+      for(const auto value : tile)
+        BOOST_CHECK_EQUAL(value, int(index));
+    }
+    world.gop.fence();
+  }
+
+  // The buffers are released when the array is deleted
+  world.gop.fence();
+  world.await([&released] () { return released.load(); });
+  BOOST_CHECK(released.load());
+}
+
+BOOST_AUTO_TEST_CASE(block_cyclic_test) {
+  World& world = *GlobalFixture::world;
+  const std::size_t proc_cols = std::min<std::size_t>(world.size(), 2ul);
+  const BlockCyclicLayout layout(world, 11ul, 7ul, 3ul, 2ul, 1ul, proc_cols);
+  auto value = [] (const std::size_t i, const std::size_t j) { return int(i * 100ul + j); };
+  auto init = [&value] (TensorI& tile, const Range& range) {
+    tile = TensorI(range);
+    for(const auto& index : range)
+      tile[index] = value(index[0], index[1]);
+  };
+
+  // The local matrix of the layout
+  std::vector<int> expected(layout.local_size(), 0);
+  const std::size_t proc_col = world.rank() % proc_cols;
+  if(std::size_t(world.rank()) < proc_cols)
+    for(std::size_t j = 0ul; j < layout.local_cols(); ++j)
+      for(std::size_t i = 0ul; i < layout.local_rows(); ++i)
+        expected[i + j * layout.lld()] =
+            value(i, ((j / 2ul) * proc_cols + proc_col) * 2ul + j % 2ul);
+
+  // Arrays with the layout are copied locally, others are redistributed
+  const TArrayI a = make_array<TArrayI>(world, layout.trange(), layout.pmap(world), init);
+  const TiledRange trange{ TiledRange1{0, 5, 11}, TiledRange1{0, 4, 7} };
+  const TArrayI b = make_array<TArrayI>(world, trange, init);
+  BOOST_CHECK(layout.is_layout_of(a));
+  BOOST_CHECK(! layout.is_layout_of(b));
+  for(const TArrayI* array : { &a, &b }) {
+    std::vector<int> local(layout.local_size(), -1);
+    array_to_block_cyclic(*array, layout, local.data());
+    BOOST_CHECK(local == expected);
+  }
+
+  // Copy the local matrix back
+  const TArrayI c = block_cyclic_to_array<TArrayI>(world, layout, expected.data(), trange);
+  BOOST_CHECK(c.trange() == trange);
+  for(const auto index : *c.pmap()) {
+    const TensorI tile = c.find(index).get();
+    for(const auto& i : tile.range())
+      BOOST_CHECK_EQUAL(tile[i], value(i[0], i[1]));
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE(retile_test) {
+  // Tiles of 3 elements, which straddle the tiles of tr
+  std::vector<TiledRange1> tr1s;
+  for(const auto& tr1 : this->tr.data()) {
+    std::vector<std::size_t> bounds;
+    for(std::size_t i = tr1.elements_range().first; i < tr1.elements_range().second; i += 3ul)
+      bounds.push_back(i);
+    bounds.push_back(tr1.elements_range().second);
+    tr1s.emplace_back(bounds.begin(), bounds.end());
+  }
+  const TiledRange tr3(tr1s.begin(), tr1s.end());
+
+  TSpArrayI b = retile(a_sparse, tr3);
+  BOOST_CHECK(b.trange() == tr3);
+
+  // Retiling back restores the data and the shape of the original array
+  TSpArrayI c = retile(b, this->tr);
+  for(const auto index : *c.pmap()) {
+    BOOST_CHECK_EQUAL(c.is_zero(index), a_sparse.is_zero(index));
+    if(c.is_zero(index))
+      continue;
+    const TensorI tile0 = a_sparse.find(index).get();
+    const TensorI tile = c.find(index).get();
+    BOOST_REQUIRE_EQUAL(tile0.range(), tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile0[i], tile[i]);
+  }
+
+  const TArrayI dense = to_dense(a_sparse);
+  TArrayI d = retile(retile(dense, tr3), this->tr);
+  for(const auto index : *d.pmap()) {
+    const TensorI tile0 = dense.find(index).get();
+    const TensorI tile = d.find(index).get();
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile0[i], tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(threshold_schedule) {
+  ThresholdSchedule<float> schedule(1.0e-8f, 1.0e-2f, 0.1f);
+  BOOST_CHECK_EQUAL(schedule.threshold(), 1.0e-2f);
+
+  // The threshold follows the residual norm, but never loosens
+  BOOST_CHECK_EQUAL(schedule.update(1.0), 1.0e-2f);
+  BOOST_CHECK_CLOSE(schedule.update(1.0e-3), 1.0e-4f, 1.0e-4);
+  BOOST_CHECK_CLOSE(schedule.update(1.0), 1.0e-4f, 1.0e-4);
+  BOOST_CHECK(! schedule.is_tight());
+
+  // The threshold is carried by the truncated array
+  TSpArrayI b = clone(a_sparse);
+  BOOST_REQUIRE_NO_THROW(schedule.truncate(b));
+  BOOST_CHECK_EQUAL(b.shape().zero_threshold(), schedule.threshold());
+  for(std::size_t i = 0ul; i < b.size(); ++i)
+    BOOST_CHECK_EQUAL(b.is_zero(i), a_sparse.is_zero(i));
+
+  // Every tile is below a threshold that is larger than any element
+  BOOST_REQUIRE_NO_THROW(b.truncate(1000.0f));
+  BOOST_CHECK_EQUAL(b.shape().zero_threshold(), 1000.0f);
+  for(std::size_t i = 0ul; i < b.size(); ++i)
+    BOOST_CHECK(b.is_zero(i));
+
+  BOOST_CHECK_EQUAL(schedule.update(1.0e-12), 1.0e-8f);
+  BOOST_CHECK(schedule.is_tight());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
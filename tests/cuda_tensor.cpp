@@ -0,0 +1,225 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <TiledArray/config.h>
+
+#ifdef TILEDARRAY_HAS_CUDA
+
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "range_fixture.h"
+
+using namespace TiledArray;
+
+struct CudaTensorFixture : public TiledRangeFixture {
+  typedef CudaTensor<double> DeviceTensor;
+
+  CudaTensorFixture() : t(Range(4, 3)), u(Range(4, 3)) {
+    for(std::size_t i = 0ul; i < t.size(); ++i) {
+      t[i] = double(i + 1);
+      u[i] = double(2 * i) - 5.0;
+    }
+  }
+
+  // Copy a device tensor to the host
+  static TensorD host(const DeviceTensor& tensor) {
+    return static_cast<TensorD>(tensor);
+  }
+
+  static void check_equal(const TensorD& expected, const TensorD& actual) {
+    BOOST_REQUIRE_EQUAL(expected.range(), actual.range());
+    for(std::size_t i = 0ul; i < expected.size(); ++i)
+      BOOST_CHECK_CLOSE(expected[i], actual[i], 1.0e-10);
+  }
+
+  TensorD t;
+  TensorD u;
+}; // CudaTensorFixture
+
+BOOST_FIXTURE_TEST_SUITE( cuda_tensor_suite, CudaTensorFixture )
+
+BOOST_AUTO_TEST_CASE( host_round_trip )
+{
+  const DeviceTensor d(t);
+  BOOST_CHECK(! d.empty());
+  BOOST_CHECK_EQUAL(d.range(), t.range());
+  check_equal(t, host(d));
+
+  // clone is a deep copy
+  DeviceTensor c = d.clone();
+  c.scale_to(2.0);
+  check_equal(t, host(d));
+  check_equal(t.scale(2.0), host(c));
+
+  const DeviceTensor z(t.range(), 3.0);
+  check_equal(TensorD(t.range(), 3.0), host(z));
+}
+
+BOOST_AUTO_TEST_CASE( arithmetic )
+{
+  const DeviceTensor dt(t), du(u);
+  const Permutation perm({1, 0});
+
+  check_equal(t.add(u), host(dt.add(du)));
+  check_equal(t.add(u, 2.0, perm), host(dt.add(du, 2.0, perm)));
+  check_equal(t.subt(u, perm), host(dt.subt(du, perm)));
+  check_equal(t.mult(u, 0.5), host(dt.mult(du, 0.5)));
+  check_equal(t.scale(-3.0, perm), host(dt.scale(-3.0, perm)));
+  check_equal(t.neg(), host(dt.neg()));
+  check_equal(t.add(1.5), host(dt.add(1.5)));
+  check_equal(t.permute(perm), host(dt.permute(perm)));
+
+  DeviceTensor r = dt.clone();
+  r.add_to(du, 2.0);
+  check_equal(t.add(u, 2.0), host(r));
+
+  BOOST_CHECK_CLOSE(dt.squared_norm(), t.squared_norm(), 1.0e-10);
+  BOOST_CHECK_CLOSE(dt.norm(), t.norm(), 1.0e-10);
+  BOOST_CHECK_CLOSE(dt.dot(du), t.dot(u), 1.0e-10);
+  BOOST_CHECK_CLOSE(dt.sum(), t.sum(), 1.0e-10);
+}
+
+BOOST_AUTO_TEST_CASE( permute_rank3 )
+{
+  TensorD a(Range(2, 3, 4));
+  for(std::size_t i = 0ul; i < a.size(); ++i)
+    a[i] = double(i);
+  const Permutation perm({2, 0, 1});
+  check_equal(a.permute(perm), host(DeviceTensor(a).permute(perm)));
+}
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  const DeviceTensor dt(t), du(u);
+
+  // t(i,k) u(j,k)
+  const math::GemmHelper nt(madness::cblas::NoTrans, madness::cblas::Trans,
+      2u, 2u, 2u);
+  check_equal(t.gemm(u, 2.0, nt), host(dt.gemm(du, 2.0, nt)));
+
+  // t(k,i) u(k,j), accumulated
+  const math::GemmHelper tn(madness::cblas::Trans, madness::cblas::NoTrans,
+      2u, 2u, 2u);
+  TensorD r = t.gemm(u, 1.0, tn);
+  DeviceTensor dr(r);
+  r.gemm(t, u, -1.5, tn);
+  dr.gemm(dt, du, -1.5, tn);
+  check_equal(r, host(dr));
+}
+
+BOOST_AUTO_TEST_CASE( gemm_batch )
+{
+  const DeviceTensor dt(t), du(u);
+  TensorD v(Range(4, 5));
+  for(std::size_t i = 0ul; i < v.size(); ++i)
+    v[i] = double(i) * 0.5;
+  const DeviceTensor dv(v);
+
+  // t(k,i) u(k,j) and t(k,i) v(k,j); the second result is accumulated
+  const math::GemmHelper tn(madness::cblas::Trans, madness::cblas::NoTrans,
+      2u, 2u, 2u);
+  TensorD r1 = t.gemm(u, 2.0, tn);
+  TensorD r2 = t.gemm(v, 1.0, tn);
+  DeviceTensor dr1, dr2(r2);
+  r2.gemm(t, v, 2.0, tn);
+
+  std::vector<DeviceTensor*> results = { &dr1, &dr2 };
+  std::vector<const DeviceTensor*> lefts = { &dt, &dt };
+  std::vector<const DeviceTensor*> rights = { &du, &dv };
+  TiledArray::gemm_batch(results, lefts, rights, 2.0, tn);
+  check_equal(r1, host(dr1));
+  check_equal(r2, host(dr2));
+
+  BOOST_CHECK((detail::has_gemm_batch<DeviceTensor, DeviceTensor,
+      DeviceTensor, double>::value));
+  BOOST_CHECK((! detail::has_gemm_batch<TensorD, TensorD, TensorD,
+      double>::value));
+}
+
+BOOST_AUTO_TEST_CASE( async_invoke )
+{
+  BOOST_CHECK(async_trait<DeviceTensor>::is_async);
+  BOOST_CHECK(! async_trait<TensorD>::is_async);
+
+  // The operation returns before its kernels complete
+  const DeviceTensor dt(t), du(u);
+  auto op = [&du] (const DeviceTensor& arg) { return arg.add(du, 2.0); };
+  Future<DeviceTensor> result = detail::async_invoke(op, dt);
+  check_equal(t.add(u, 2.0), host(result.get()));
+
+  // Synchronous tiles are not wrapped in a future
+  auto host_op = [this] (const TensorD& arg) { return arg.add(u); };
+  const TensorD host_result = detail::async_invoke(host_op, t);
+  check_equal(t.add(u), host_result);
+}
+
+BOOST_AUTO_TEST_CASE( serialize )
+{
+  const DeviceTensor d(t);
+  const std::size_t buf_size = t.size() * sizeof(double) * 2ul + 1024ul;
+  std::vector<unsigned char> buf(buf_size);
+  madness::archive::BufferOutputArchive oar(buf.data(), buf_size);
+  oar & d;
+  const std::size_t nbyte = oar.size();
+  oar.close();
+
+  DeviceTensor r;
+  madness::archive::BufferInputArchive iar(buf.data(), nbyte);
+  iar & r;
+  iar.close();
+  check_equal(t, host(r));
+}
+
+BOOST_AUTO_TEST_CASE( array_expressions )
+{
+  World& world = *GlobalFixture::world;
+  TArrayD a(world, tr), b(world, tr);
+  a.fill_random();
+  b.fill_random();
+
+  TArrayD c;
+  c("a,b,c") = 2.0 * (a("a,b,c") + b("c,b,a"));
+
+  auto da = to_device(a);
+  auto db = to_device(b);
+  DistArray<DeviceTensor, DensePolicy> dc;
+  dc("a,b,c") = 2.0 * (da("a,b,c") + db("c,b,a"));
+  const TArrayD hc = to_host(dc);
+
+  for(const auto index : *c.pmap()) {
+    const TensorD expected = c.find(index).get();
+    check_equal(expected, hc.find(index).get());
+  }
+
+  // Contraction on the device
+  TArrayD e;
+  e("a,c") = a("a,b,d") * b("c,b,d");
+  DistArray<DeviceTensor, DensePolicy> de;
+  de("a,c") = da("a,b,d") * db("c,b,d");
+  const TArrayD he = to_host(de);
+
+  for(const auto index : *e.pmap()) {
+    const TensorD expected = e.find(index).get();
+    check_equal(expected, he.find(index).get());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif // TILEDARRAY_HAS_CUDA
@@ -0,0 +1,134 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  davidson.cpp
+ *  October 15, 2026
+ *
+ */
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include "TiledArray/algebra/davidson.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct DavidsonFixture {
+
+  /// Matrix-vector product, which counts the vectors it is applied to
+  struct Multiply {
+    TArrayD A;
+    unsigned int count;
+    void operator()(const TArrayD& x, TArrayD& result) {
+      result("i,k") = A("i,j") * x("j,k");
+      ++count;
+    }
+  }; // struct Multiply
+
+  /// Diagonal preconditioner, <tt>(diag(A) - theta)^-1 r</tt>
+  struct Diagonal {
+    const DavidsonFixture* fixture;
+    void operator()(const double theta, const TArrayD& r, TArrayD& z) const {
+      EigenMatrixXd t = to_matrix(r);
+      for(std::size_t i = 0ul; i < fixture->n; ++i) {
+        const double d = fixture->a(i,i) - theta;
+        t(i,0) /= (std::abs(d) > 1.0e-8 ? d : 1.0e-8);
+      }
+      z = fixture->make_array(t, false);
+    }
+  }; // struct Diagonal
+
+  DavidsonFixture() :
+    bounds({{0, 7, 15, 22, 30}}), rhs_bounds({{0, 1}}), n(bounds.back()),
+    a(n, n)
+  {
+    // A symmetric, diagonally dominant matrix with distinct diagonal
+    // elements
+    for(std::size_t i = 0ul; i < n; ++i) {
+      for(std::size_t j = 0ul; j < n; ++j)
+        a(i,j) = 0.1 * std::cos(double(i + j + 1ul));
+      a(i,i) = double(i + 1ul);
+    }
+  }
+
+  TArrayD make_array(const EigenMatrixXd& m, const bool square) const {
+    const TiledRange1 rows(bounds.begin(), bounds.end());
+    const TiledRange1 cols(rhs_bounds.begin(), rhs_bounds.end());
+    const std::array<TiledRange1, 2> dims = {{ rows, (square ? rows : cols) }};
+    return eigen_to_array<TArrayD>(*GlobalFixture::world,
+        TiledRange(dims.begin(), dims.end()), m, true);
+  }
+
+  /// Convert an array to an Eigen matrix on every process
+  static EigenMatrixXd to_matrix(const TArrayD& array) {
+    EigenMatrixXd result(array.trange().elements_range().extent(0),
+        array.trange().elements_range().extent(1));
+    for(std::size_t t = 0ul; t < array.size(); ++t) {
+      const TArrayD::value_type tile = array.find(t).get();
+      for(auto it = tile.range().begin(); it != tile.range().end(); ++it)
+        result((*it)[0], (*it)[1]) = tile[*it];
+    }
+    return result;
+  }
+
+  const std::array<std::size_t, 5> bounds;
+  const std::array<std::size_t, 2> rhs_bounds;
+  const std::size_t n;
+  EigenMatrixXd a;
+}; // DavidsonFixture
+
+BOOST_FIXTURE_TEST_SUITE( davidson_suite, DavidsonFixture )
+
+BOOST_AUTO_TEST_CASE( lowest_roots )
+{
+  const unsigned int nroots = 3u, max_subspace = 2u * nroots;
+  Eigen::SelfAdjointEigenSolver<EigenMatrixXd> reference(a);
+
+  // The unit vectors of the lowest diagonal elements are the guesses
+  std::vector<TArrayD> x;
+  for(unsigned int k = 0u; k < nroots; ++k) {
+    EigenMatrixXd guess = EigenMatrixXd::Zero(n, 1);
+    guess(k, 0) = 1.0;
+    x.push_back(make_array(guess, false));
+  }
+
+  Multiply multiply{ make_array(a, true), 0u };
+  Diagonal diagonal{ this };
+  DavidsonSolver<TArrayD> solver(nroots, max_subspace, 1.0e-8);
+  DavidsonSolver<TArrayD>::EigenVectorX theta;
+  BOOST_REQUIRE_NO_THROW(theta = solver(multiply, diagonal, x));
+
+  // More vectors were added than fit in the subspace, so it was collapsed
+  BOOST_CHECK_GT(multiply.count, max_subspace);
+  BOOST_CHECK_LE(solver.subspace_size(), max_subspace);
+
+  BOOST_REQUIRE_EQUAL(std::size_t(theta.size()), std::size_t(nroots));
+  BOOST_REQUIRE_EQUAL(x.size(), std::size_t(nroots));
+  for(unsigned int k = 0u; k < nroots; ++k) {
+    BOOST_CHECK_SMALL(theta[k] - reference.eigenvalues()[k], 1.0e-8);
+    const EigenMatrixXd v = to_matrix(x[k]);
+    BOOST_CHECK_SMALL(v.norm() - 1.0, 1.0e-10);
+    BOOST_CHECK_SMALL(std::abs(v.col(0).dot(reference.eigenvectors().col(k))) - 1.0,
+        1.0e-7);
+  }
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
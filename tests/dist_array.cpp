@@ -166,6 +166,34 @@ BOOST_AUTO_TEST_CASE( find_remote )
   }
 }
 
+BOOST_AUTO_TEST_CASE( prefetch )
+{
+  std::vector<ArrayN::index> indices(a.range().begin(), a.range().end());
+
+  // Nothing is requested while the cache is disabled
+  BOOST_REQUIRE_NO_THROW(a.prefetch(indices));
+  BOOST_CHECK_EQUAL(a.remote_cache_misses(), 0ul);
+
+  a.enable_remote_cache(1ul << 30);
+  a.prefetch(indices);
+
+  // The remote tiles are found in the cache
+  std::size_t remote = 0ul;
+  for(const auto& index : indices) {
+    if(a.is_local(index))
+      continue;
+    ++remote;
+    const ArrayN::value_type tile = a.find(index).get();
+    for(ArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+      BOOST_CHECK_EQUAL(*it, a.owner(index) + 1);
+  }
+  BOOST_CHECK_EQUAL(a.remote_cache_hits(), remote);
+  BOOST_CHECK_EQUAL(a.remote_cache_misses(), 0ul);
+
+  a.enable_remote_cache(0ul);
+  world.gop.fence();
+}
+
 BOOST_AUTO_TEST_CASE( fill_tiles )
 {
   ArrayN a(world, tr);
@@ -280,6 +308,206 @@ BOOST_AUTO_TEST_CASE( make_replicated )
   }
 }
 
+BOOST_AUTO_TEST_CASE( make_replicated_batches )
+{
+  std::shared_ptr<ArrayN::pmap_interface> distributed_pmap = a.pmap();
+
+  // Use a small message size so that each process sends several batches
+  BOOST_REQUIRE_NO_THROW(a.make_replicated(10ul));
+  GlobalFixture::world->gop.fence();
+
+  for(std::size_t i = 0; i < a.size(); ++i) {
+    BOOST_CHECK(a.is_local(i));
+    Future<ArrayN::value_type> tile = a.find(i);
+    BOOST_CHECK_EQUAL(tile.get().range(), a.trange().make_tile_range(i));
+    for(ArrayN::value_type::const_iterator it = tile.get().begin(); it != tile.get().end(); ++it)
+      BOOST_CHECK_EQUAL(*it, distributed_pmap->owner(i) + 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( make_node_shared )
+{
+  ArrayN r;
+  BOOST_REQUIRE_NO_THROW(r = TiledArray::make_node_shared(a));
+  BOOST_CHECK(r.pmap()->is_replicated());
+  BOOST_CHECK_EQUAL(r.trange(), a.trange());
+
+  for(std::size_t i = 0; i < r.size(); ++i) {
+    BOOST_CHECK(r.is_local(i));
+    const ArrayN::value_type tile = r.find(i).get();
+    BOOST_CHECK_EQUAL(tile.range(), a.trange().make_tile_range(i));
+    for(ArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+      BOOST_CHECK_EQUAL(*it, a.owner(i) + 1);
+  }
+
+  // Only the non-zero tiles of a sparse array are stored
+  SpArrayN s(world, tr, TiledArray::SparseShape<float>(shape_tensor, tr));
+  for(const auto i : *s.pmap())
+    if(! s.is_zero(i))
+      s.set(i, world.rank() + 1);
+  SpArrayN rs;
+  BOOST_REQUIRE_NO_THROW(rs = TiledArray::make_node_shared(s));
+  for(std::size_t i = 0; i < rs.size(); ++i) {
+    BOOST_CHECK_EQUAL(rs.is_zero(i), s.is_zero(i));
+    if(rs.is_zero(i))
+      continue;
+    const SpArrayN::value_type tile = rs.find(i).get();
+    for(SpArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+      BOOST_CHECK_EQUAL(*it, s.owner(i) + 1);
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( redistribute )
+{
+  std::shared_ptr<ArrayN::pmap_interface> pmap =
+      std::make_shared<detail::MortonPmap>(world, tr.tiles_range());
+
+  // Use a small message size so that each process sends several messages
+  ArrayN r;
+  BOOST_REQUIRE_NO_THROW(r = a.redistribute(pmap, 10ul));
+
+  BOOST_CHECK_EQUAL(r.trange(), a.trange());
+  BOOST_CHECK_EQUAL(r.pmap(), pmap);
+
+  // Check that the tiles are owned by the new process map
+  for(std::size_t i = 0; i < r.size(); ++i) {
+    BOOST_CHECK_EQUAL(r.owner(i), pmap->owner(i));
+    if(! r.is_local(i))
+      continue;
+
+    const ArrayN::value_type tile = r.find(i).get();
+    BOOST_CHECK_EQUAL(tile.range(), tr.make_tile_range(i));
+    for(ArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+      BOOST_CHECK_EQUAL(*it, a.owner(i) + 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( rebalance )
+{
+  // The work is concentrated in the tiles of the first process
+  std::vector<std::size_t> work(a.size(), 0ul);
+  for(std::size_t i = 0; i < a.size(); ++i)
+    if(a.is_local(i))
+      work[i] = (a.owner(i) == 0 ? 100ul : 1ul);
+
+  ArrayN r = TiledArray::clone(a);
+  const bool migrated = TiledArray::rebalance(r, 0.1, work);
+  BOOST_CHECK_EQUAL(migrated, world.size() > 1);
+
+  // Check that the tiles are unchanged
+  for(std::size_t i = 0; i < r.size(); ++i) {
+    if(! r.is_local(i))
+      continue;
+    const ArrayN::value_type tile = r.find(i).get();
+    for(ArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+      BOOST_CHECK_EQUAL(*it, a.owner(i) + 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( update_shape )
+{
+  SpArrayN as(world, tr, TiledArray::SparseShape<float>(shape_tensor, tr));
+  for(SpArrayN::iterator it = as.begin(); it != as.end(); ++it)
+    *it = SpArrayN::value_type(as.trange().make_tile_range(it.ordinal()), 1);
+  world.gop.fence();
+
+  // Zero the local tiles with i % 3 == 1 in place, and give non-zero norms to
+  // the local zero tiles with i % 6 == 0
+  std::vector<std::pair<size_type, float> > tile_norms;
+  for(std::size_t i = 0; i < as.size(); ++i) {
+    if(! as.is_local(i))
+      continue;
+    if(i % 3 == 1) {
+      SpArrayN::value_type tile = as.find(i).get();
+      std::fill(tile.begin(), tile.end(), 0);
+      tile_norms.emplace_back(i, 0.0f);
+    } else if(i % 6 == 0) {
+      tile_norms.emplace_back(i,
+          std::sqrt(float(as.trange().make_tile_range(i).volume())));
+    }
+  }
+
+  BOOST_REQUIRE_NO_THROW(as.update_shape(tile_norms));
+  for(std::size_t i = 0; i < as.size(); i += 6)
+    if(as.is_local(i))
+      as.set(i, 1);
+  world.gop.fence();
+
+  for(std::size_t i = 0; i < as.size(); ++i) {
+    BOOST_CHECK_EQUAL(as.is_zero(i), (i % 3 == 1) || (i % 6 == 3));
+    if(as.is_local(i) && ! as.is_zero(i)) {
+      SpArrayN::value_type tile = as.find(i).get();
+      for(SpArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+        BOOST_CHECK_EQUAL(*it, 1);
+    }
+  }
+
+  // Dense arrays are not changed
+  BOOST_REQUIRE_NO_THROW(a.update_shape(std::vector<std::pair<size_type, float> >()));
+  BOOST_CHECK(a.is_dense());
+}
+
+BOOST_AUTO_TEST_CASE( completion )
+{
+  // The tiles of the fixture are set
+  BOOST_CHECK(a.is_local_complete());
+  BOOST_CHECK(a.local_completion().get());
+  BOOST_CHECK(a.completion().get());
+
+  // The local tiles of a new array are pending until they are set
+  ArrayN c(world, tr);
+  BOOST_CHECK(c.is_local_complete() == (c.pmap()->local_size() == 0ul));
+  Future<bool> done = c.completion();
+  for(std::size_t i = 0; i < c.size(); ++i)
+    if(c.is_local(i))
+      c.set(i, 2);
+  BOOST_CHECK(c.is_local_complete());
+  BOOST_CHECK(done.get());
+
+  // Wait for the result of an expression without a fence
+  ArrayN b;
+  b("a,b,c") = 2 * a("a,b,c");
+  BOOST_REQUIRE_NO_THROW(b.wait_complete());
+  BOOST_CHECK(b.is_local_complete());
+  for(std::size_t i = 0; i < b.size(); ++i) {
+    if(! b.is_local(i))
+      continue;
+    const ArrayN::value_type tile = b.find(i).get();
+    for(ArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+      BOOST_CHECK_EQUAL(*it, 2 * (a.owner(i) + 1));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_world )
+{
+  TiledArray::World& local = TiledArray::get_local_world();
+  BOOST_CHECK_EQUAL(local.size(), 1);
+  BOOST_CHECK_EQUAL(& local, & TiledArray::get_local_world());
+
+  // Each process evaluates private arrays in a task, without any
+  // collective operation in the parent world
+  const int rank = world.rank();
+  const TiledArray::TiledRange trange = tr;
+  Future<std::size_t> sum = world.taskq.add([rank,trange] () {
+    ArrayN x(TiledArray::get_local_world(), trange);
+    x.fill(rank + 1);
+    ArrayN y;
+    y("a,b,c") = 2 * x("a,b,c") + x("a,b,c");
+    y.wait_complete();
+
+    std::size_t sum = 0ul;
+    for(std::size_t i = 0ul; i < y.size(); ++i) {
+      const ArrayN::value_type tile = y.find(i).get();
+      for(ArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+        sum += std::size_t(*it);
+    }
+    return sum;
+  });
+
+  BOOST_CHECK_EQUAL(sum.get(), 3ul * std::size_t(rank + 1) * tr.elements_range().volume());
+}
+
 BOOST_AUTO_TEST_CASE( serialization )
 {
   decltype(a) acopy(a.world(), a.trange(), a.shape());
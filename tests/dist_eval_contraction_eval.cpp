@@ -26,6 +26,7 @@
 #include "array_fixture.h"
 
 #include "../src/TiledArray/dist_eval/contraction_eval.h"
+#include "../src/TiledArray/dist_eval/local_contraction_eval.h"
 #include "../src/tiledarray.h"
 #include "unit_test_config.h"
 #include "sparse_shape_fixture.h"
@@ -362,6 +363,41 @@ BOOST_AUTO_TEST_CASE( perm_eval )
 
 }
 
+BOOST_AUTO_TEST_CASE( local_eval )
+{
+  if(GlobalFixture::world->size() != 1)
+    return;
+
+  Permutation perm({1,0});
+  typedef ContractReduce<TensorI, TensorI, TensorI, int> op_type;
+  typedef detail::LocalContraction<array_eval_type, array_eval_type, op_type,
+      DensePolicy> impl_type;
+  typedef detail::DistEval<TensorI, DensePolicy> dist_eval_type;
+
+  const std::size_t K = left_arg.size() / left_arg.range().extent(0);
+  dist_eval_type contract(std::make_shared<impl_type>(left_arg, right_arg,
+      *GlobalFixture::world, perm * result_tr, DenseShape(), pmap, perm,
+      make_contract(2u, left_arg.trange().tiles_range().rank(),
+      right_arg.trange().tiles_range().rank(), perm), K));
+
+  // Check evaluation
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+
+  // Compute the reference contraction
+  const matrix_type l = copy_to_matrix(left, 1),
+                    r = copy_to_matrix(right, GlobalFixture::dim - 1);
+  const matrix_type reference = (l * r).transpose();
+
+  for(auto index : *contract.pmap()) {
+    const dist_eval_type::eval_type eval_tile = contract.get(index).get();
+    BOOST_REQUIRE(! eval_tile.empty());
+    BOOST_CHECK_EQUAL(eval_tile.range(), contract.trange().make_tile_range(index));
+    BOOST_CHECK(eigen_map(eval_tile) == reference.block(eval_tile.range().lobound(0),
+        eval_tile.range().lobound(1), eval_tile.range().extent(0), eval_tile.range().extent(1)));
+  }
+}
+
 BOOST_AUTO_TEST_CASE( sparse_eval )
 {
   auto do_sparse_eval = [&](bool force_shape) -> void {
@@ -445,8 +481,16 @@ BOOST_AUTO_TEST_CASE( sparse_eval )
     }
   };
 
-  do_sparse_eval(false);
-  do_sparse_eval(true);
+  // Check each send mode of the sparse iterations
+  const detail::SummaSendMode mode = detail::summa_send_mode();
+  for(auto send_mode : { detail::SummaSendMode::group,
+      detail::SummaSendMode::targeted, detail::SummaSendMode::automatic })
+  {
+    detail::summa_send_mode() = send_mode;
+    do_sparse_eval(false);
+    do_sparse_eval(true);
+  }
+  detail::summa_send_mode() = mode;
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -23,6 +23,7 @@
  *
  */
 
+#include <limits>
 #include <array_fixture.h>
 
 #include "TiledArray/dist_eval/unary_eval.h"
@@ -221,6 +222,46 @@ BOOST_AUTO_TEST_CASE( double_eval )
 
 }
 
+BOOST_AUTO_TEST_CASE( parse_min_elements )
+{
+  // Invalid values fall back to the default
+  const std::size_t default_value = detail::parse_tile_task_min_elements(nullptr);
+  BOOST_CHECK_EQUAL(default_value, 16384ul);
+  BOOST_CHECK_EQUAL(detail::parse_tile_task_min_elements("4096"), 4096ul);
+  BOOST_CHECK_EQUAL(detail::parse_tile_task_min_elements("0"), default_value);
+  BOOST_CHECK_EQUAL(detail::parse_tile_task_min_elements(""), default_value);
+  BOOST_CHECK_EQUAL(detail::parse_tile_task_min_elements("-1"), default_value);
+  BOOST_CHECK_EQUAL(detail::parse_tile_task_min_elements("16k"), default_value);
+  BOOST_CHECK_EQUAL(detail::parse_tile_task_min_elements(
+      "99999999999999999999999999"), default_value);
+}
+
+BOOST_AUTO_TEST_CASE( chunked_eval )
+{
+  // Evaluate several tiles per task
+  const std::size_t min_elements = detail::tile_task_min_elements();
+  detail::tile_task_min_elements() = std::numeric_limits<std::size_t>::max();
+  BOOST_CHECK(! detail::TileChunker(16ul * (madness::ThreadPool::size() + 1ul)).add(1ul));
+
+  auto dist_eval = make_unary_eval(arg, arg.world(),
+      DenseShape(), arg.pmap(), Permutation(), make_scal0(3));
+  auto dist_eval2 = make_unary_eval(dist_eval,
+      dist_eval.world(), DenseShape(), dist_eval.pmap(),
+      Permutation(), make_scal1(5));
+
+  BOOST_REQUIRE_NO_THROW(dist_eval2.eval());
+  BOOST_REQUIRE_NO_THROW(dist_eval2.wait());
+  detail::tile_task_min_elements() = min_elements;
+
+  for(auto index : * dist_eval2.pmap()) {
+    const TensorI array_tile = array.find(index);
+    const TensorI eval_tile = dist_eval2.get(index).get();
+    BOOST_CHECK_EQUAL(eval_tile.range(), array_tile.range());
+    for(std::size_t i = 0ul; i < eval_tile.size(); ++i)
+      BOOST_CHECK_EQUAL(eval_tile[i], 5 * 3 * array_tile[i]);
+  }
+}
+
 BOOST_AUTO_TEST_CASE( perm_eval )
 {
   // Create permutation to be applied in the array evaluations
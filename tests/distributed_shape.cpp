@@ -0,0 +1,164 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/distributed_shape.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "sparse_shape_fixture.h"
+
+using namespace TiledArray;
+
+struct DistributedShapeFixture : public SparseShapeFixture {
+  typedef DistributedShape<float> Shape;
+  typedef Shape::size_type size_type;
+
+  DistributedShapeFixture() :
+    world(* GlobalFixture::world),
+    pmap(new detail::BlockedPmap(world, tr.tiles_range().volume()))
+  { }
+
+  ~DistributedShapeFixture() {
+    world.gop.fence();
+  }
+
+  TiledArray::World& world;
+  std::shared_ptr<Pmap> pmap;
+};
+
+BOOST_FIXTURE_TEST_SUITE( distributed_shape_suite, DistributedShapeFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  Shape shape(world, sparse_shape, tr, pmap);
+
+  BOOST_CHECK_EQUAL(& shape.get_world(), GlobalFixture::world);
+  BOOST_CHECK_EQUAL(shape.pmap(), pmap);
+  BOOST_CHECK_EQUAL(shape.trange(), tr);
+  BOOST_CHECK_EQUAL(shape.zero_threshold(), sparse_shape.zero_threshold());
+  BOOST_CHECK_EQUAL(shape.cache_size(), 0ul);
+
+  size_type local_size = 0ul;
+  for(const size_type i : *pmap) {
+    BOOST_CHECK(shape.is_local(i));
+    BOOST_CHECK_EQUAL(shape.is_zero(i), sparse_shape.is_zero(i));
+    BOOST_CHECK_CLOSE(shape.local_norm(i), sparse_shape[i], tolerance);
+    if(! sparse_shape.is_zero(i))
+      ++local_size;
+  }
+  BOOST_CHECK_EQUAL(shape.local_size(), local_size);
+}
+
+BOOST_AUTO_TEST_CASE( norm_constructor )
+{
+  // Construct the shape from the Frobenius norms of the local tiles
+  Tensor<float> tile_norms = make_norm_tensor(tr, 0.5, 42);
+  std::vector<std::pair<size_type, float> > local_norms;
+  for(const size_type i : *pmap)
+    local_norms.emplace_back(i, tile_norms[i]);
+
+  Shape shape(world, tr, pmap, local_norms);
+
+  for(const size_type i : *pmap) {
+    const float expected = tile_norms[i] / float(tr.make_tile_range(i).volume());
+    if(expected < SparseShape<float>::threshold()) {
+      BOOST_CHECK(shape.is_zero(i));
+      BOOST_CHECK_EQUAL(shape.local_norm(i), 0.0f);
+    } else {
+      BOOST_CHECK(! shape.is_zero(i));
+      BOOST_CHECK_CLOSE(shape.local_norm(i), expected, tolerance);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( fetch )
+{
+  Shape shape(world, sparse_shape, tr, pmap);
+
+  std::vector<size_type> ordinals;
+  size_type remote = 0ul;
+  for(size_type i = 0ul; i < tr.tiles_range().volume(); ++i) {
+    ordinals.push_back(i);
+    if(! shape.is_local(i))
+      ++remote;
+  }
+
+  std::vector<float> norms;
+  BOOST_REQUIRE_NO_THROW(norms = shape.fetch(ordinals).get());
+  BOOST_REQUIRE_EQUAL(norms.size(), ordinals.size());
+  for(size_type i = 0ul; i < ordinals.size(); ++i)
+    BOOST_CHECK_CLOSE(norms[i], sparse_shape[i], tolerance);
+
+  // Remote norms are cached
+  BOOST_CHECK_EQUAL(shape.cache_size(), remote);
+  BOOST_REQUIRE_NO_THROW(norms = shape.fetch(ordinals).get());
+  for(size_type i = 0ul; i < ordinals.size(); ++i)
+    BOOST_CHECK_CLOSE(norms[i], sparse_shape[i], tolerance);
+  BOOST_CHECK_EQUAL(shape.cache_size(), remote);
+
+  shape.clear_cache();
+  BOOST_CHECK_EQUAL(shape.cache_size(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  Shape left_shape(world, left, tr, pmap);
+  Shape right_shape(world, right, tr, pmap);
+
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  const SparseShape<float> expected = left.gemm(right, -7.2, gemm_helper);
+
+  std::shared_ptr<Pmap> result_pmap(new detail::BlockedPmap(world,
+      expected.data().range().volume()));
+  std::shared_ptr<Shape> result;
+  BOOST_REQUIRE_NO_THROW(result = left_shape.gemm(right_shape, -7.2, gemm_helper,
+      result_pmap));
+
+  BOOST_CHECK_EQUAL(result->trange().tiles_range(), expected.data().range());
+  for(const size_type i : *result_pmap) {
+    BOOST_CHECK_EQUAL(result->is_zero(i), expected.is_zero(i));
+    BOOST_CHECK_CLOSE(result->local_norm(i), expected[i], tolerance);
+  }
+
+  // Only the norms needed by the local result tiles are fetched
+  BOOST_CHECK(left_shape.cache_size() <= tr.tiles_range().volume());
+  BOOST_CHECK(right_shape.cache_size() <= tr.tiles_range().volume());
+
+  // The replicated result is consistent with the replicated contraction
+  SparseShape<float> replicated = result->replicate();
+  for(size_type i = 0ul; i < expected.data().size(); ++i)
+    BOOST_CHECK_CLOSE(replicated[i], expected[i], tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( replicate )
+{
+  Shape shape(world, sparse_shape, tr, pmap);
+
+  SparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = shape.replicate());
+
+  BOOST_CHECK_EQUAL(result.zero_threshold(), sparse_shape.zero_threshold());
+  BOOST_CHECK_CLOSE(result.sparsity(), sparse_shape.sparsity(), tolerance);
+  for(size_type i = 0ul; i < tr.tiles_range().volume(); ++i) {
+    BOOST_CHECK_EQUAL(result.is_zero(i), sparse_shape.is_zero(i));
+    BOOST_CHECK_CLOSE(result[i], sparse_shape[i], tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -69,6 +69,79 @@ BOOST_AUTO_TEST_CASE( constructor )
 
 }
 
+BOOST_AUTO_TEST_CASE( dense_slots )
+{
+  Storage s(world, 10, pmap, true);
+
+  BOOST_CHECK(s.is_dense() == (! pmap->empty()));
+  BOOST_CHECK_EQUAL(s.size(), pmap->local_size());
+
+  // Set the local elements through their slots
+  for(std::size_t i = 0; i < s.max_size(); ++i)
+    if(s.is_local(i))
+      s.set(i, int(i));
+
+  // Get all elements
+  for(std::size_t i = 0; i < s.max_size(); ++i)
+    BOOST_CHECK_EQUAL(s.get(i).get(), int(i));
+
+#ifdef TA_EXCEPTION_ERROR
+  // Check that a slot may be set only once
+  for(std::size_t i = 0; i < s.max_size(); ++i)
+    if(s.is_local(i))
+      BOOST_CHECK_THROW(s.set(i, 0), TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( aggregate )
+{
+  t.aggregate(3ul);
+  BOOST_CHECK_EQUAL(t.buffer_size(), 3ul);
+
+  // Set all elements from the first process
+  if(world.rank() == 0)
+    for(std::size_t i = 0; i < t.max_size(); ++i)
+      t.set(i, int(i));
+
+  // Get all elements
+  std::vector<Storage::future> elements;
+  for(std::size_t i = 0; i < t.max_size(); ++i)
+    elements.push_back(t.get(i));
+
+  t.flush();
+  world.gop.fence();
+
+  for(std::size_t i = 0; i < t.max_size(); ++i)
+    BOOST_CHECK_EQUAL(elements[i].get(), int(i));
+
+  t.aggregate(0ul);
+  BOOST_CHECK_EQUAL(t.buffer_size(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( release )
+{
+  Storage* s = new Storage(world, 10, pmap);
+  BOOST_CHECK_EQUAL(s->in_flight(), 0ul);
+
+  // A pending set of a local element keeps the storage alive
+  Storage::future f;
+  if(! pmap->empty())
+    s->set_batch(world.rank(), std::vector<size_type>(1, *pmap->begin()),
+        std::vector<Storage::future>(1, f));
+  BOOST_CHECK_EQUAL(s->in_flight(), (pmap->empty() ? 0ul : 1ul));
+
+  std::atomic<bool> released(false);
+  s->release([s, &released] () { delete s; released = true; });
+  BOOST_CHECK_EQUAL(released.load(), pmap->empty());
+
+  // The storage is deleted when the set is done, without a fence
+  f.set(3);
+  world.await([&released] () { return released.load(); });
+  BOOST_CHECK(released.load());
+}
+
 BOOST_AUTO_TEST_CASE( get_world )
 {
   BOOST_CHECK_EQUAL(& t.get_world(), GlobalFixture::world);
@@ -205,6 +205,32 @@ BOOST_AUTO_TEST_CASE( vector_to_array ) {
   }
 }
 
+BOOST_AUTO_TEST_CASE( scatter_gather ) {
+  // Only the matrix of process 0 is used
+  if(GlobalFixture::world->rank() == 0)
+    matrix = decltype(matrix)::Random(matrix.rows(), matrix.cols());
+
+  BOOST_CHECK_NO_THROW((array = scatter_eigen_to_array<TArrayI>(*GlobalFixture::world,
+      trange, matrix)));
+  BOOST_CHECK(! array.pmap()->is_replicated());
+
+  Eigen::MatrixXi result;
+  BOOST_CHECK_NO_THROW(result = gather_array_to_eigen(array));
+  if(GlobalFixture::world->rank() == 0) {
+    BOOST_CHECK_EQUAL(result.rows(), matrix.rows());
+    BOOST_CHECK_EQUAL(result.cols(), matrix.cols());
+    BOOST_CHECK(result == matrix);
+  } else {
+    BOOST_CHECK_EQUAL(result.size(), 0);
+  }
+
+  // Gather to another process
+  const ProcessID root = GlobalFixture::world->size() - 1;
+  BOOST_CHECK_NO_THROW(result = gather_array_to_eigen(array, root));
+  if(GlobalFixture::world->rank() == root)
+    BOOST_CHECK_EQUAL(result.rows(), matrix.rows());
+}
+
 BOOST_AUTO_TEST_CASE( array_to_matrix ) {
   auto a_to_e_rowmajor = [](const TArrayI& array) -> EigenMatrixXi {
     return array_to_eigen<Tensor<int>, DensePolicy, Eigen::RowMajor>(array);
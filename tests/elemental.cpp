@@ -114,6 +114,93 @@ BOOST_AUTO_TEST_CASE(elem_to_array_test) {
 
 BOOST_AUTO_TEST_SUITE_END()
 
+#elif HAVE_EL_H
+
+#include "TiledArray/elemental.h"
+#include "unit_test_config.h"
+#include "range_fixture.h"
+
+using namespace TiledArray;
+
+struct ElFixture : public TiledRangeFixture {
+  ElFixture() :
+    trange(dims.begin(), dims.begin() + 2),
+    array(*GlobalFixture::world, trange)
+  {
+    for(TArrayD::iterator it = array.begin(); it != array.end(); ++it) {
+      TensorD tile(array.trange().make_tile_range(it.index()));
+      for(const auto& idx : tile.range())
+        tile[idx] = value(idx[0], idx[1]);
+      *it = tile;
+    }
+    GlobalFixture::world->gop.fence();
+  }
+
+  // The value of the element of the matrix at (m, n)
+  static double value(const std::size_t m, const std::size_t n) {
+    return 1000.0 * double(m) + double(n);
+  }
+
+  // Check that the local elements of matrix have the values of array
+  static void check_matrix(const El::AbstractDistMatrix<double>& matrix) {
+    for(El::Int j = 0; j < matrix.LocalWidth(); ++j)
+      for(El::Int i = 0; i < matrix.LocalHeight(); ++i)
+        BOOST_CHECK_EQUAL(matrix.GetLocal(i, j),
+            value(matrix.GlobalRow(i), matrix.GlobalCol(j)));
+  }
+
+  // Check that the local tiles of result are equal to the tiles of array
+  void check_array(const TArrayD& result) const {
+    BOOST_CHECK_EQUAL(result.trange(), array.trange());
+    for(TArrayD::const_iterator it = result.begin(); it != result.end(); ++it) {
+      const TensorD tile = *it;
+      const TensorD ref_tile = array.find(it.index()).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  }
+
+  TiledRange trange;
+  TArrayD array;
+};
+
+BOOST_FIXTURE_TEST_SUITE(el_suite, ElFixture)
+
+BOOST_AUTO_TEST_CASE(round_trip) {
+  const std::size_t nrows = trange.elements_range().extent(0);
+  const std::size_t ncols = trange.elements_range().extent(1);
+
+  // Exchange the tiles in the default rounds, in one round per tile, and in
+  // a single round
+  for(std::size_t max_round_elements : { std::size_t(0ul), std::size_t(1ul),
+      trange.elements_range().volume() })
+  {
+    El::DistMatrix<double> matrix;
+    BOOST_REQUIRE_NO_THROW(matrix = array_to_el(array, El::Grid::Default(),
+        TensorFlattening(), max_round_elements));
+    BOOST_CHECK_EQUAL(matrix.Height(), El::Int(nrows));
+    BOOST_CHECK_EQUAL(matrix.Width(), El::Int(ncols));
+    check_matrix(matrix);
+
+    TArrayD result;
+    BOOST_REQUIRE_NO_THROW(result = el_to_array(matrix, *GlobalFixture::world,
+        trange, TensorFlattening(), max_round_elements));
+    check_array(result);
+  }
+
+  // Matrices with other distributions are copied to [MC,MR] first
+  El::DistMatrix<double> matrix = array_to_el(array);
+  El::DistMatrix<double, El::STAR, El::STAR> rep_matrix(matrix);
+  check_matrix(rep_matrix);
+  check_array(el_to_array(rep_matrix, *GlobalFixture::world, trange,
+      TensorFlattening(), 1ul));
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 #else // HAVE_ELEMENTAL_H
 
 # warning "TA<->Elemental conversions have not been reimplemented for recent Elemental API; check back soon"
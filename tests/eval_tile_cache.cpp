@@ -0,0 +1,130 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/eval_tile_cache.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+// A lazy tile that counts its evaluations
+struct CountingTile {
+  typedef TensorI eval_type;
+
+  CountingTile() : value(0), evaluations(nullptr) { }
+  CountingTile(const int v, std::size_t* e) : value(v), evaluations(e) { }
+
+  explicit operator eval_type() const {
+    ++(*evaluations);
+    return eval_type(Range(2, 2), value);
+  }
+
+  template <typename Archive>
+  void serialize(Archive&) { }
+
+  int value;
+  std::size_t* evaluations;
+};
+
+struct EvalTileCacheFixture {
+  typedef detail::EvalTileCache<CountingTile> Cache;
+
+  EvalTileCacheFixture() : cache(), evaluations(0ul) { }
+
+  // Evaluate tile i
+  TensorI evaluate(const std::size_t i) {
+    return cache.evaluate(i, CountingTile(int(i), &evaluations));
+  }
+
+  Cache cache;
+  std::size_t evaluations;
+};
+
+BOOST_FIXTURE_TEST_SUITE( eval_tile_cache_suite, EvalTileCacheFixture )
+
+BOOST_AUTO_TEST_CASE( traits )
+{
+  BOOST_CHECK(detail::is_cacheable_lazy_tile<CountingTile>::value);
+  BOOST_CHECK(! detail::is_cacheable_lazy_tile<TensorI>::value);
+}
+
+BOOST_AUTO_TEST_CASE( policy )
+{
+  BOOST_CHECK(! cache.enabled(true));
+  BOOST_CHECK(! cache.enabled(false));
+
+  cache.enable(LazyTileCachePolicy::local, 1000ul);
+  BOOST_CHECK(cache.enabled(true));
+  BOOST_CHECK(! cache.enabled(false));
+
+  cache.enable(LazyTileCachePolicy::local_and_received, 1000ul);
+  BOOST_CHECK(cache.enabled(true));
+  BOOST_CHECK(cache.enabled(false));
+
+  cache.enable(LazyTileCachePolicy::never, 1000ul);
+  BOOST_CHECK(! cache.enabled(true));
+  BOOST_CHECK_EQUAL(cache.capacity(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( memoize )
+{
+  const std::size_t bytes = 4ul * sizeof(int);
+  cache.enable(LazyTileCachePolicy::local, 2ul * bytes);
+
+  TensorI t1 = evaluate(1ul);
+  BOOST_CHECK_EQUAL(evaluations, 1ul);
+  BOOST_CHECK_EQUAL(cache.bytes(), bytes);
+
+  // The evaluated tile is not shared with the cache
+  t1[0] = 42;
+  const TensorI t2 = evaluate(1ul);
+  BOOST_CHECK_EQUAL(evaluations, 1ul);
+  BOOST_CHECK_EQUAL(t2[0], 1);
+  BOOST_CHECK_EQUAL(cache.hits(), 1ul);
+  BOOST_CHECK_EQUAL(cache.misses(), 1ul);
+}
+
+BOOST_AUTO_TEST_CASE( lru_eviction )
+{
+  const std::size_t bytes = 4ul * sizeof(int);
+  cache.enable(LazyTileCachePolicy::local_and_received, 2ul * bytes);
+
+  evaluate(1ul);
+  evaluate(2ul);
+  evaluate(1ul); // Tile 2 is now the least recently used
+  evaluate(3ul); // Evicts tile 2
+  BOOST_CHECK_EQUAL(evaluations, 3ul);
+
+  evaluate(1ul);
+  evaluate(3ul);
+  BOOST_CHECK_EQUAL(evaluations, 3ul);
+  evaluate(2ul);
+  BOOST_CHECK_EQUAL(evaluations, 4ul);
+
+  // Reducing the capacity evicts tiles
+  cache.enable(LazyTileCachePolicy::local_and_received, bytes);
+  BOOST_CHECK_EQUAL(cache.bytes(), bytes);
+
+  cache.clear();
+  BOOST_CHECK_EQUAL(cache.bytes(), 0ul);
+  evaluate(2ul);
+  BOOST_CHECK_EQUAL(evaluations, 5ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -78,6 +78,18 @@ struct ExpressionsFixture : public TiledRangeFixture {
     return tile;
   }
 
+  // Check that the local tiles of result are equal to the tiles of ref
+  static void check_tiles(const TArrayI& result, const TArrayI& ref) {
+    BOOST_CHECK_EQUAL(result.trange(), ref.trange());
+    for(TArrayI::const_iterator it = result.begin(); it != result.end(); ++it) {
+      const TArrayI::value_type tile = *it;
+      const TArrayI::value_type ref_tile = ref.find(it.index()).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  }
+
   template <typename M, typename A>
   static void rand_fill_matrix_and_array(M& matrix, A& array, int seed = 42) {
     TA_ASSERT(std::size_t(matrix.size()) == array.trange().elements_range().volume());
@@ -462,6 +474,48 @@ BOOST_AUTO_TEST_CASE( complex_mult_factories )
 
 }
 
+BOOST_AUTO_TEST_CASE( complex_conj_cont )
+{
+  TArrayZ x(*GlobalFixture::world, tr);
+  TArrayZ y(*GlobalFixture::world, tr);
+  random_fill(x);
+  random_fill(y);
+
+  // Conjugate the arguments before the contraction
+  TArrayZ xc, yc;
+  xc("a,b,c") = conj(x("a,b,c"));
+  yc("a,b,c") = conj(y("a,b,c"));
+
+  TArrayZ z, z_ref;
+  auto check = [&] () {
+    for(std::size_t i = 0ul; i < z.size(); ++i) {
+      if(! z.is_local(i)) continue;
+      auto z_tile = z.find(i).get();
+      auto z_ref_tile = z_ref.find(i).get();
+      for(std::size_t j = 0ul; j < z_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(z_tile[j], z_ref_tile[j]);
+    }
+  };
+
+  // The conjugation is applied by the GEMM when the argument is transposed
+  BOOST_REQUIRE_NO_THROW(z("a,b") = conj(x("c,d,a")) * y("c,d,b"));
+  z_ref("a,b") = xc("c,d,a") * y("c,d,b");
+  check();
+
+  BOOST_REQUIRE_NO_THROW(z("a,b") = x("a,c,d") * conj(y("b,c,d")));
+  z_ref("a,b") = x("a,c,d") * yc("b,c,d");
+  check();
+
+  BOOST_REQUIRE_NO_THROW(z("a,b") = -conj(2.0 * x("c,d,a")) * conj(y("b,c,d")));
+  z_ref("a,b") = -2.0 * xc("c,d,a") * yc("b,c,d");
+  check();
+
+  // Arguments that are not transposed are conjugated before the contraction
+  BOOST_REQUIRE_NO_THROW(z("a,b") = conj(x("a,c,d")) * y("c,d,b"));
+  z_ref("a,b") = xc("a,c,d") * y("c,d,b");
+  check();
+}
+
 BOOST_AUTO_TEST_CASE( permute )
 {
   Permutation perm({2, 1, 0});
@@ -480,6 +534,78 @@ BOOST_AUTO_TEST_CASE( permute )
   }
 }
 
+BOOST_AUTO_TEST_CASE( permute_layout_cache )
+{
+  Permutation perm({2, 1, 0});
+
+  // The cache is disabled by default
+  BOOST_CHECK(! b.cache_layout("c,b,a", "a,b,c"));
+  BOOST_CHECK_EQUAL(b.layout_count(), 0ul);
+
+  b.enable_layout_cache(1ul << 30);
+  BOOST_CHECK(b.cache_layout("c,b,a", "a,b,c"));
+  BOOST_CHECK_EQUAL(b.layout_count(), 1ul);
+  BOOST_CHECK(b.layout(perm).is_initialized());
+  BOOST_CHECK_EQUAL(b.layout(perm).trange(), perm * b.trange());
+
+  // The expression reads the cached layout
+  BOOST_REQUIRE_NO_THROW(a("a,b,c") = 2 * b("c,b,a"));
+
+  for(std::size_t i = 0ul; i < b.size(); ++i) {
+    const std::size_t perm_index = a.range().ordinal(perm * b.range().idx(i));
+    if(a.is_local(perm_index)) {
+      TArrayI::value_type a_tile = a.find(perm_index).get();
+      TArrayI::value_type perm_b_tile = perm * b.find(i).get();
+
+      BOOST_CHECK_EQUAL(a_tile.range(), perm_b_tile.range());
+      for(std::size_t j = 0ul; j < a_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(a_tile[j], 2 * perm_b_tile[j]);
+    }
+  }
+
+  // Layouts that do not fit are not cached
+  b.enable_layout_cache(1ul);
+  BOOST_CHECK_EQUAL(b.layout_count(), 0ul);
+  BOOST_CHECK(! b.cache_layout("c,b,a", "a,b,c"));
+
+  // Assignment drops the layouts
+  b.enable_layout_cache(1ul << 30);
+  BOOST_CHECK(b.cache_layout("c,b,a", "a,b,c"));
+  b("a,b,c") = a("a,b,c");
+  BOOST_CHECK_EQUAL(b.layout_count(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( reuse_storage )
+{
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = a("a,b,c") + b("a,b,c"));
+  const auto id = c.id();
+  std::map<std::size_t, const int*> data;
+  for(std::size_t i = 0ul; i < c.size(); ++i)
+    if(c.is_local(i))
+      data[i] = c.find(i).get().data();
+
+  // The result is written into the tiles of c
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") =
+      (2 * a("a,b,c") - b("a,b,c")).set_reuse_storage(true));
+  BOOST_CHECK(c.id() == id);
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    if(! c.is_local(i))
+      continue;
+    TArrayI::value_type c_tile = c.find(i).get();
+    TArrayI::value_type a_tile = a.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    BOOST_CHECK_EQUAL(c_tile.data(), data[i]);
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], 2 * a_tile[j] - b_tile[j]);
+  }
+
+  // An expression that reads c replaces it
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") =
+      (c("a,b,c") + a("a,b,c")).set_reuse_storage(true));
+  BOOST_CHECK(c.id() != id);
+}
+
 BOOST_AUTO_TEST_CASE( scale_permute )
 {
   Permutation perm({2, 1, 0});
@@ -530,6 +656,40 @@ BOOST_AUTO_TEST_CASE( block )
   }
 }
 
+BOOST_AUTO_TEST_CASE( block_view )
+{
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = a("a,b,c").block({3,3,3}, {5,5,5}));
+
+  BlockRange block_range(a.trange().tiles_range(), {3,3,3}, {5,5,5});
+
+  // The tiles of a block are shifted views of the array tiles
+  for(std::size_t index = 0ul; index < block_range.volume(); ++index) {
+    const std::size_t arg_index = block_range.ordinal(index);
+    if(c.is_local(index) && a.is_local(arg_index)) {
+      Tensor<int> arg_tile = a.find(arg_index).get();
+      Tensor<int> result_tile = c.find(index).get();
+      BOOST_CHECK_EQUAL(result_tile.data(), arg_tile.data());
+    }
+  }
+
+  // The tiles of the array are not modified by an expression of blocks
+  TArrayI x = a.clone();
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = a("a,b,c").block({3,3,3}, {5,5,5})
+      + a("a,b,c").block({3,3,3}, {5,5,5}));
+
+  for(std::size_t index = 0ul; index < block_range.volume(); ++index) {
+    const std::size_t arg_index = block_range.ordinal(index);
+    Tensor<int> arg_tile = a.find(arg_index).get();
+    Tensor<int> x_tile = x.find(arg_index).get();
+    Tensor<int> result_tile = c.find(index).get();
+
+    for(std::size_t j = 0ul; j < result_tile.range().volume(); ++j) {
+      BOOST_CHECK_EQUAL(arg_tile[j], x_tile[j]);
+      BOOST_CHECK_EQUAL(result_tile[j], 2 * arg_tile[j]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( const_block )
 {
   const TArrayI& ca = a;
@@ -613,6 +773,32 @@ BOOST_AUTO_TEST_CASE( assign_sub_block )
     }
   }
 }
+
+BOOST_AUTO_TEST_CASE( accumulate_sub_block )
+{
+  c("a,b,c") = b("a,b,c");
+
+  BOOST_REQUIRE_NO_THROW(c("a,b,c").block({3,3,3}, {5,5,5}) += 2 * a("a,b,c").block({3,3,3}, {5,5,5}));
+  BOOST_REQUIRE_NO_THROW(c("a,b,c").block({3,3,3}, {5,5,5}) -= a("a,b,c").block({3,3,3}, {5,5,5}));
+
+  BlockRange block_range(a.trange().tiles_range(), {3,3,3}, {5,5,5});
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    if(! c.is_local(i))
+      continue;
+    Tensor<int> a_tile = a.find(i).get();
+    Tensor<int> b_tile = b.find(i).get();
+    Tensor<int> result_tile = c.find(i).get();
+    const bool in_block = block_range.includes(c.trange().tiles_range().idx(i));
+
+    BOOST_CHECK_EQUAL(result_tile.range(), b_tile.range());
+
+    for(std::size_t j = 0ul; j < result_tile.range().volume(); ++j) {
+      BOOST_CHECK_EQUAL(result_tile[j], b_tile[j] + (in_block ? a_tile[j] : 0));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(assign_subblock_block_contract)
 {
   w.fill_local(0.0);
@@ -785,6 +971,119 @@ BOOST_AUTO_TEST_CASE( scale_add )
   }
 }
 
+BOOST_AUTO_TEST_CASE( fused_add_subt )
+{
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = 2 * a("a,b,c") + b("a,b,c") - 3 * (a("a,b,c") - b("a,b,c")));
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    TArrayI::value_type a_tile = a.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], 2 * a_tile[j] + b_tile[j] - 3 * (a_tile[j] - b_tile[j]));
+  }
+
+  // Permuted leaves are fused, the argument tiles are permuted when read
+  Permutation perm({2, 1, 0});
+
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = 2 * a("c,b,a") + b("a,b,c") - a("c,b,a"));
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    const size_t perm_index = c.range().ordinal(perm * a.range().idx(i));
+    TArrayI::value_type a_tile = perm * a.find(perm_index).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], 2 * a_tile[j] + b_tile[j] - a_tile[j]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( common_subexpr )
+{
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = a("a,b,c") * b("a,b,c") + a("a,b,c") * b("a,b,c"));
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    TArrayI::value_type a_tile = a.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], 2 * a_tile[j] * b_tile[j]);
+  }
+
+  // The shared subexpression is an argument of a fused tree
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = 2 * (a("a,b,c") * b("a,b,c")) + b("a,b,c")
+      - a("a,b,c") * b("a,b,c"));
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    TArrayI::value_type a_tile = a.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], a_tile[j] * b_tile[j] + b_tile[j]);
+  }
+
+  // Different permutations of the same arrays are not shared
+  Permutation perm({2, 1, 0});
+
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = a("c,b,a") * b("c,b,a") + a("a,b,c") * b("a,b,c"));
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    const size_t perm_index = c.range().ordinal(perm * a.range().idx(i));
+    TArrayI::value_type pa_tile = perm * a.find(perm_index).get();
+    TArrayI::value_type pb_tile = perm * b.find(perm_index).get();
+    TArrayI::value_type a_tile = a.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], pa_tile[j] * pb_tile[j] + a_tile[j] * b_tile[j]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( release_shared_arguments )
+{
+  // Consumers release their arguments as soon as they are evaluated, which
+  // must not free an array, or a shared subexpression, that another
+  // consumer is still reading
+  TArrayI a0(*GlobalFixture::world, a.trange());
+  a0("a,b,c") = a("a,b,c");
+
+  for(int repeat = 0; repeat < 4; ++repeat) {
+    {
+      // The temporary array is read by a unary and a binary consumer, and
+      // the shared subexpression by consumers at different depths
+      TArrayI t(*GlobalFixture::world, a.trange());
+      t("a,b,c") = a("a,b,c") + b("a,b,c");
+      BOOST_REQUIRE_NO_THROW(c("a,b,c") = 2 * t("a,b,c") + (t("a,b,c") - a("a,b,c"))
+          + 3 * (a("a,b,c") * b("a,b,c")) - (a("a,b,c") * b("a,b,c")));
+    }
+
+    // The temporary array is gone, and the result is still valid
+    GlobalFixture::world->gop.fence();
+    for(std::size_t i = 0ul; i < c.size(); ++i) {
+      TArrayI::value_type c_tile = c.find(i).get();
+      TArrayI::value_type a_tile = a.find(i).get();
+      TArrayI::value_type b_tile = b.find(i).get();
+
+      for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(c_tile[j], 2 * a_tile[j] + 3 * b_tile[j]
+            + 2 * a_tile[j] * b_tile[j]);
+    }
+
+    // The arguments are unchanged, and can be used in the next statement
+    BOOST_REQUIRE_NO_THROW(c("a,b,c") = a("a,b,c") - a0("a,b,c"));
+    for(std::size_t i = 0ul; i < c.size(); ++i) {
+      TArrayI::value_type c_tile = c.find(i).get();
+      for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(c_tile[j], 0);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( scale_add_permute )
 {
   Permutation perm({2, 1, 0});
@@ -1244,6 +1543,403 @@ BOOST_AUTO_TEST_CASE( cont )
   }
 }
 
+BOOST_AUTO_TEST_CASE( cont_layers )
+{
+  TArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Check that the layered (2.5D) SUMMA gives the same result as 2D SUMMA.
+  // Layer counts that do not divide the number of processes, including
+  // counts above it, are reduced so that every process belongs to a layer.
+  const unsigned int max_layers = std::min<unsigned int>(
+      GlobalFixture::world->size() + 1u, a.trange().tiles_range().extent(1)
+      * a.trange().tiles_range().extent(2));
+  for(unsigned int layers = 1u; layers <= max_layers; ++layers) {
+    BOOST_REQUIRE_NO_THROW(w("i,j") =
+        (a("i,b,c") * b("j,b,c")).set_summa_layers(layers));
+    check_tiles(w, ref);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_depth_control )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  TArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // A memory limit of the largest possible step of a process is below the
+  // footprint of two steps, so the SUMMA pipeline must be narrowed
+  const auto& tiles = a.trange().tiles_range();
+  std::size_t max_tile_volume = 0ul;
+  for(std::size_t t = 0ul; t < tiles.volume(); ++t)
+    max_tile_volume = std::max(max_tile_volume,
+        a.trange().make_tile_range(t).volume());
+  const std::size_t max_step_memory = 2ul * tiles.extent(0) * max_tile_volume
+      * sizeof(TArrayI::element_type);
+
+  // Check that a tight memory limit and a depth limit give the same result
+  typedef TiledArray::detail::SummaDepthController controller_type;
+  const std::size_t narrowed = controller_type::narrowed_pipelines();
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_summa_max_memory(max_step_memory));
+  std::size_t count = controller_type::narrowed_pipelines() - narrowed;
+  GlobalFixture::world->gop.sum(count);
+  BOOST_CHECK_GT(count, 0ul);
+  check_tiles(w, ref);
+
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_summa_max_depth(1u));
+  check_tiles(w, ref);
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_batch )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  TArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Check that batched tile contractions give the same result
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_summa_batch(true));
+  check_tiles(w, ref);
+
+  // Check batched contractions with a permuted result
+  BOOST_REQUIRE_NO_THROW(ref("j,i") = a("i,b,c") * b("j,b,c"));
+  BOOST_REQUIRE_NO_THROW(w("j,i") =
+      (a("i,b,c") * b("j,b,c")).set_summa_batch(true));
+  check_tiles(w, ref);
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_hadamard )
+{
+  // Gather the elements of a and b
+  const Range& range = a.trange().elements_range();
+  std::vector<int> left(range.volume(), 0), right(range.volume(), 0);
+  for(TArrayI::const_iterator it = a.begin(); it != a.end(); ++it) {
+    const TArrayI::value_type tile = *it;
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      left[range.ordinal(tile.range().idx(i))] = tile[i];
+  }
+  for(TArrayI::const_iterator it = b.begin(); it != b.end(); ++it) {
+    const TArrayI::value_type tile = *it;
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      right[range.ordinal(tile.range().idx(i))] = tile[i];
+  }
+  GlobalFixture::world->gop.sum(left.data(), left.size());
+  GlobalFixture::world->gop.sum(right.data(), right.size());
+
+  // p is shared by the arguments and the result, and is not summed
+  const std::size_t n = range.extent(1);
+  BOOST_REQUIRE_NO_THROW(c("i,j,p") = a("i,k,p") * b("k,j,p"));
+  for(TArrayI::const_iterator it = c.begin(); it != c.end(); ++it) {
+    const TArrayI::value_type tile = *it;
+    for(std::size_t x = 0ul; x < tile.size(); ++x) {
+      const auto idx = tile.range().idx(x);
+      int expected = 0;
+      for(std::size_t k = 0ul; k < n; ++k)
+        expected += left[range.ordinal(std::array<std::size_t, 3>{{idx[0], k, idx[2]}})]
+            * right[range.ordinal(std::array<std::size_t, 3>{{k, idx[1], idx[2]}})];
+      BOOST_CHECK_EQUAL(tile[x], expected);
+    }
+  }
+
+  // The batch variable may be anywhere in the result
+  TArrayI ref, result;
+  BOOST_REQUIRE_NO_THROW(ref("i,p,j") = c("i,j,p"));
+  BOOST_REQUIRE_NO_THROW(result("i,p,j") = 2 * (a("i,k,p") * b("k,j,p")));
+  for(TArrayI::const_iterator it = result.begin(); it != result.end(); ++it) {
+    const TArrayI::value_type tile = *it;
+    const TArrayI::value_type ref_tile = ref.find(it.index()).get();
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], 2 * ref_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_prefetch )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  TArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Check that prefetched broadcasts give the same result
+  TiledArray::detail::SummaOverlapStats::reset();
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_summa_prefetch(true));
+  check_tiles(w, ref);
+
+  // Check the overlap counters
+  BOOST_CHECK_LE(TiledArray::detail::SummaOverlapStats::ready_tiles(),
+      TiledArray::detail::SummaOverlapStats::received_tiles());
+  BOOST_CHECK_GE(TiledArray::detail::SummaOverlapStats::ratio(), 0.0);
+  BOOST_CHECK_LE(TiledArray::detail::SummaOverlapStats::ratio(), 1.0);
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_node_bcast )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  TArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Check that two-level broadcasts give the same result
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_summa_node_bcast(true));
+  check_tiles(w, ref);
+
+  // Check with prefetched broadcasts
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_summa_node_bcast(true).set_summa_prefetch(true));
+  check_tiles(w, ref);
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_stationary )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  using TiledArray::expressions::ContractionMode;
+
+  TArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+  TArrayI ref_perm;
+  BOOST_REQUIRE_NO_THROW(ref_perm("j,i") = a("i,b,c") * b("j,b,c"));
+
+  // Check that each operand-stationary mode gives the same result as SUMMA
+  for(ContractionMode mode : { ContractionMode::keep_left, ContractionMode::keep_right }) {
+    BOOST_REQUIRE_NO_THROW(w("i,j") =
+        (a("i,b,c") * b("j,b,c")).set_contraction_mode(mode));
+    check_tiles(w, ref);
+
+    // Check with a permuted result
+    BOOST_REQUIRE_NO_THROW(w("j,i") =
+        (a("i,b,c") * b("j,b,c")).set_contraction_mode(mode));
+    check_tiles(w, ref_perm);
+  }
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_diagonal )
+{
+  using TiledArray::expressions::ContractionMode;
+
+  TArrayI m;
+  BOOST_REQUIRE_NO_THROW(m("i,j") = a("i,b,c") * b("j,b,c"));
+  const TiledArray::TiledRange1 rows = m.trange().data()[0];
+  const TiledArray::TiledRange1 cols = m.trange().data()[1];
+  TArrayI dl = diagonal_array<int, DensePolicy>(*GlobalFixture::world,
+      TiledRange{rows, rows}, 3);
+  TArrayI dr = diagonal_array<int, DensePolicy>(*GlobalFixture::world,
+      TiledRange{cols, cols}, 3);
+  BOOST_CHECK(dl.is_diagonal());
+  BOOST_CHECK(! m.is_diagonal());
+
+  // Every tile of the result is 3 times the tile of ref
+  auto check = [] (const TArrayI& result, const TArrayI& ref) {
+    for(TArrayI::const_iterator it = result.begin(); it != result.end(); ++it) {
+      const TArrayI::value_type tile = *it;
+      const TArrayI::value_type ref_tile = ref.find(it.index()).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], 3 * ref_tile[i]);
+    }
+  };
+
+  TArrayI w;
+  BOOST_REQUIRE_NO_THROW(w("i,j") = dl("i,k") * m("k,j"));
+  check(w, m);
+  BOOST_REQUIRE_NO_THROW(w("i,j") = m("i,k") * dr("k,j"));
+  check(w, m);
+
+  TArrayI mt;
+  BOOST_REQUIRE_NO_THROW(mt("j,i") = m("i,j"));
+  BOOST_REQUIRE_NO_THROW(w("j,i") = dl("i,k") * m("k,j"));
+  check(w, mt);
+
+  auto cont = dl("i,k") * m("k,j");
+  TiledArray::expressions::ContractionPlan plan;
+  BOOST_REQUIRE_NO_THROW(plan = cont.plan("i,j", *GlobalFixture::world));
+  BOOST_CHECK(plan.mode == ContractionMode::diagonal);
+  BOOST_CHECK_EQUAL(plan.flops, 2.0 * double(m.trange().elements_range().volume()));
+}
+
+BOOST_AUTO_TEST_CASE( cont_replicated )
+{
+  using TiledArray::expressions::ContractionMode;
+
+  TArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Check that every process holds all tiles of the result
+  auto check = [&ref] (const TArrayI& result) {
+    BOOST_CHECK(result.pmap()->is_replicated());
+    for(std::size_t index = 0ul; index < ref.size(); ++index) {
+      BOOST_CHECK(result.is_local(index));
+      const TArrayI::value_type tile = result.find(index).get();
+      const TArrayI::value_type ref_tile = ref.find(index).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  };
+
+  // The mode is selected from the process map of the result array
+  TArrayI r(*GlobalFixture::world, ref.trange(),
+      std::make_shared<TiledArray::detail::ReplicatedPmap>(*GlobalFixture::world,
+          ref.size()));
+  BOOST_REQUIRE_NO_THROW(r("i,j") = a("i,b,c") * b("j,b,c"));
+  check(r);
+
+  // The mode is requested explicitly
+  TArrayI q;
+  BOOST_REQUIRE_NO_THROW(q("i,j") = (a("i,b,c") * b("j,b,c")).set_contraction_mode(
+      ContractionMode::replicate_result));
+  check(q);
+
+  auto cont = a("i,b,c") * b("j,b,c");
+  cont.set_contraction_mode(ContractionMode::replicate_result);
+  TiledArray::expressions::ContractionPlan plan;
+  BOOST_REQUIRE_NO_THROW(plan = cont.plan("i,j", *GlobalFixture::world));
+  BOOST_CHECK(plan.mode == ContractionMode::replicate_result);
+  BOOST_CHECK_EQUAL(plan.layers, std::min<std::size_t>(GlobalFixture::world->size(),
+      a.trange().tiles_range().extent(1) * a.trange().tiles_range().extent(2)));
+}
+
+BOOST_AUTO_TEST_CASE( cont_replicated_arg )
+{
+  using TiledArray::expressions::ContractionMode;
+
+  TArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+  TArrayI rb;
+  BOOST_REQUIRE_NO_THROW(rb("j,b,c") = b("j,b,c"));
+  rb.make_replicated();
+
+  // The rows of the result are owned by the owners of the rows of a
+  TArrayI w;
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * rb("j,b,c"));
+  check_tiles(w, ref);
+  if(GlobalFixture::world->size() > 1)
+    BOOST_CHECK(std::dynamic_pointer_cast<const TiledArray::detail::FiberPmap>(w.pmap()));
+
+  // A replicated left-hand argument, with a permuted result
+  BOOST_REQUIRE_NO_THROW(w("i,j") = rb("j,b,c") * a("i,b,c"));
+  check_tiles(w, ref);
+
+  auto cont = a("i,b,c") * rb("j,b,c");
+  TiledArray::expressions::ContractionPlan plan;
+  BOOST_REQUIRE_NO_THROW(plan = cont.plan("i,j", *GlobalFixture::world));
+  if(GlobalFixture::world->size() > 1)
+    BOOST_CHECK(plan.mode == ContractionMode::pull);
+}
+
+BOOST_AUTO_TEST_CASE( cont_plan )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  const std::size_t m = a.trange().elements_range().extent(0);
+  const std::size_t k = a.trange().elements_range().extent(1) * a.trange().elements_range().extent(2);
+  const std::size_t n = b.trange().elements_range().extent(0);
+
+  TiledArray::expressions::ContractionPlan plan;
+  BOOST_REQUIRE_NO_THROW(plan =
+      (a("i,b,c") * b("j,b,c")).plan("i,j", *GlobalFixture::world));
+
+  BOOST_CHECK_CLOSE(plan.flops, 2.0 * double(m) * double(n) * double(k), 1.0e-8);
+  BOOST_CHECK(plan.mode != TiledArray::expressions::ContractionMode::automatic);
+  BOOST_CHECK_EQUAL(plan.comm_bytes.size(), std::size_t(GlobalFixture::world->size()));
+  BOOST_CHECK_EQUAL(plan.bcast_memory.size(), std::size_t(GlobalFixture::world->size()));
+  BOOST_CHECK_LT(plan.idle_procs, std::size_t(GlobalFixture::world->size()));
+  if(GlobalFixture::world->size() == 1)
+    BOOST_CHECK_EQUAL(plan.total_comm_bytes(), 0ul);
+
+  // Check that the plan does not evaluate the expression, and that it agrees
+  // with a permuted and scaled plan
+  TiledArray::expressions::ContractionPlan scaled_plan;
+  BOOST_REQUIRE_NO_THROW(scaled_plan =
+      (2 * (a("i,b,c") * b("j,b,c"))).plan("j,i", *GlobalFixture::world));
+  BOOST_CHECK_CLOSE(scaled_plan.flops, plan.flops, 1.0e-8);
+
+  // Plans are only defined for contractions
+  BOOST_CHECK_THROW((a("i,b,c") * b("i,b,c")).plan(*GlobalFixture::world),
+      TiledArray::Exception);
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_order )
+{
+  // Construct the tiled ranges of a 10x40 * 40x40 * 40x2 matrix chain
+  std::array<std::size_t, 3> tiling_m = {{ 0, 5, 10 }};
+  std::array<std::size_t, 5> tiling_k = {{ 0, 10, 20, 30, 40 }};
+  std::array<std::size_t, 2> tiling_n = {{ 0, 2 }};
+  TiledRange1 tr1_m(tiling_m.begin(), tiling_m.end());
+  TiledRange1 tr1_k(tiling_k.begin(), tiling_k.end());
+  TiledRange1 tr1_n(tiling_n.begin(), tiling_n.end());
+
+  TArrayI x(*GlobalFixture::world, TiledRange({ tr1_m, tr1_k }));
+  TArrayI y(*GlobalFixture::world, TiledRange({ tr1_k, tr1_k }));
+  TArrayI z(*GlobalFixture::world, TiledRange({ tr1_k, tr1_n }));
+
+  TiledArray::EigenMatrixXi x_ref(10, 40);
+  TiledArray::EigenMatrixXi y_ref(40, 40);
+  TiledArray::EigenMatrixXi z_ref(40, 2);
+  rand_fill_matrix_and_array(x_ref, x, 23);
+  rand_fill_matrix_and_array(y_ref, y, 42);
+  rand_fill_matrix_and_array(z_ref, z, 13);
+
+  // Check that the cheaper association is selected
+  using TiledArray::expressions::ProductOrder;
+  using TiledArray::expressions::make_contraction_operand;
+  using TiledArray::expressions::optimal_product_order;
+  using TiledArray::expressions::VariableList;
+  BOOST_CHECK(optimal_product_order(make_contraction_operand(x("i,j")),
+      make_contraction_operand(y("j,k")), make_contraction_operand(z("k,l")),
+      VariableList("i,l"), ProductOrder::ab_c) == ProductOrder::a_bc);
+  BOOST_CHECK(optimal_product_order(make_contraction_operand(z("k,l")),
+      make_contraction_operand(y("j,k")), make_contraction_operand(x("i,j")),
+      VariableList("l,i"), ProductOrder::ab_c) == ProductOrder::ab_c);
+
+  // Hadamard products are not reordered
+  BOOST_CHECK(optimal_product_order(make_contraction_operand(x("i,j")),
+      make_contraction_operand(x("i,j")), make_contraction_operand(z("j,l")),
+      VariableList("i,l"), ProductOrder::ab_c) == ProductOrder::ab_c);
+
+  // Check that both associations give the same result
+  const TiledArray::EigenMatrixXi result_ref = x_ref * y_ref * z_ref;
+
+  TArrayI result_left, result_right;
+  BOOST_REQUIRE_NO_THROW(result_left("i,l") = x("i,j") * y("j,k") * z("k,l"));
+  BOOST_REQUIRE_NO_THROW(result_right("l,i") = x("i,j") * (y("j,k") * z("k,l")));
+
+  for(TArrayI::iterator it = result_left.begin(); it != result_left.end(); ++it) {
+    const TArrayI::value_type tile = *it;
+    for(Range::const_iterator rit = tile.range().begin(); rit != tile.range().end(); ++rit)
+      BOOST_CHECK_EQUAL(result_ref((*rit)[0], (*rit)[1]), tile[*rit]);
+  }
+  for(TArrayI::iterator it = result_right.begin(); it != result_right.end(); ++it) {
+    const TArrayI::value_type tile = *it;
+    for(Range::const_iterator rit = tile.range().begin(); rit != tile.range().end(); ++rit)
+      BOOST_CHECK_EQUAL(result_ref((*rit)[1], (*rit)[0]), tile[*rit]);
+  }
+}
+
 BOOST_AUTO_TEST_CASE( cont_permute )
 {
   const std::size_t m = a.trange().elements_range().extent(0);
@@ -1808,6 +2504,332 @@ BOOST_AUTO_TEST_CASE( outer_product )
   BOOST_CHECK_EQUAL(ew, ew_test);
 }
 
+BOOST_AUTO_TEST_CASE( outer_product_mode )
+{
+  using TiledArray::expressions::ContractionMode;
+
+  auto outer = u("i") * v("j");
+  TiledArray::expressions::ContractionPlan plan;
+  BOOST_REQUIRE_NO_THROW(plan = outer.plan("i,j", *GlobalFixture::world));
+  BOOST_CHECK(plan.mode == ContractionMode::outer);
+
+  // Higher-rank and permuted outer products match the SUMMA result
+  TArrayI ref, result;
+  BOOST_REQUIRE_NO_THROW(ref("i,a,b,c") = (u("i") * a("a,b,c")).set_contraction_mode(
+      ContractionMode::keep_result));
+  BOOST_REQUIRE_NO_THROW(result("i,a,b,c") = u("i") * a("a,b,c"));
+  BOOST_CHECK_EQUAL(result.trange(), ref.trange());
+  for(std::size_t index = 0ul; index < ref.size(); ++index) {
+    if(! ref.is_local(index)) continue;
+    const TArrayI::value_type tile = result.find(index).get();
+    const TArrayI::value_type ref_tile = ref.find(index).get();
+    BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+
+  BOOST_REQUIRE_NO_THROW(ref("j,i") = (3 * (u("i") * v("j"))).set_contraction_mode(
+      ContractionMode::keep_result));
+  BOOST_REQUIRE_NO_THROW(result("j,i") = 3 * (u("i") * v("j")));
+  for(std::size_t index = 0ul; index < ref.size(); ++index) {
+    if(! ref.is_local(index)) continue;
+    const TArrayI::value_type tile = result.find(index).get();
+    const TArrayI::value_type ref_tile = ref.find(index).get();
+    BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( outer_product_accumulate )
+{
+  // Generate Eigen matrices from input arrays.
+  EigenMatrixXi ev = make_matrix(v);
+  EigenMatrixXi eu = make_matrix(u);
+
+  // Generate the expected result
+  EigenMatrixXi ew_test = 3 * eu * ev.transpose();
+
+  BOOST_REQUIRE_NO_THROW(w("i,j") = u("i") * v("j"));
+  TArrayI x = w;
+
+  // The contractions are accumulated into the tiles of w
+  BOOST_REQUIRE_NO_THROW(w("i,j") += 2 * (u("i") * v("j")));
+
+  GlobalFixture::world->gop.fence();
+
+  EigenMatrixXi ew = make_matrix(w);
+
+  BOOST_CHECK_EQUAL(ew, ew_test);
+
+  // The tiles of the previous array are not modified
+  EigenMatrixXi ex = make_matrix(x);
+  BOOST_CHECK_EQUAL(ex, EigenMatrixXi(eu * ev.transpose()));
+}
+
+BOOST_AUTO_TEST_CASE( assign_async )
+{
+  TArrayI x, y;
+  expressions::EvalHandle hx, hy;
+  BOOST_REQUIRE_NO_THROW(hx = x("a,b,c").assign_async(a("a,b,c") + b("a,b,c")));
+  BOOST_REQUIRE_NO_THROW(hy = y("a,b,c").assign_async(2 * a("a,b,c")));
+
+  // A statement that uses x waits only for the tiles of x that it uses
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = x("a,b,c") - y("a,b,c"));
+
+  BOOST_REQUIRE_NO_THROW(expressions::wait_all({ hx, hy }));
+  BOOST_CHECK(hx.probe());
+  BOOST_CHECK(hy.probe());
+  BOOST_CHECK(expressions::EvalHandle().probe());
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    TArrayI::value_type x_tile = x.find(i).get();
+    TArrayI::value_type a_tile = a.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j) {
+      BOOST_CHECK_EQUAL(x_tile[j], a_tile[j] + b_tile[j]);
+      BOOST_CHECK_EQUAL(c_tile[j], b_tile[j] - a_tile[j]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( expr_batch )
+{
+  TArrayI x, y, z;
+  expressions::ExprBatch batch;
+  batch.add(x("a,b,c"), a("a,b,c") + b("a,b,c"));
+  batch.add(z("a,b,c"), 2 * x("a,b,c"));
+  batch.add(y("a,b,c"), a("a,b,c") - b("a,b,c"));
+  batch.add(c("a,b,c"), z("a,b,c") - y("a,b,c"));
+  BOOST_CHECK_EQUAL(batch.size(), 4ul);
+
+  // Statements are ordered by the arrays they read and write
+  const std::vector<std::size_t> levels = batch.levels();
+  const std::vector<std::size_t> expected_levels = { 0ul, 1ul, 0ul, 2ul };
+  BOOST_CHECK_EQUAL_COLLECTIONS(levels.begin(), levels.end(),
+      expected_levels.begin(), expected_levels.end());
+
+  BOOST_REQUIRE_NO_THROW(batch.eval());
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    TArrayI::value_type a_tile = a.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], a_tile[j] + 3 * b_tile[j]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( expr_batch_temporary )
+{
+  // r reads t while t is evaluated, and t is released after it is read
+  TArrayI t, r;
+  expressions::ExprBatch batch;
+  batch.add(t("a,b,c"), a("a,b,c") + b("a,b,c"));
+  batch.add(r("a,b,c"), 2 * t("c,b,a"));
+  batch.add_temporary(t);
+
+  BOOST_REQUIRE_NO_THROW(batch.eval());
+  BOOST_CHECK(! t.is_initialized());
+
+  TArrayI r_ref;
+  r_ref("a,b,c") = 2 * (a("c,b,a") + b("c,b,a"));
+  for(std::size_t i = 0ul; i < r.size(); ++i) {
+    if(! r.is_local(i))
+      continue;
+    TArrayI::value_type r_tile = r.find(i).get();
+    TArrayI::value_type r_ref_tile = r_ref.find(i).get();
+    for(std::size_t j = 0ul; j < r_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(r_tile[j], r_ref_tile[j]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( array_batch )
+{
+  ArrayBatch<TArrayI::value_type, DensePolicy> batch(* GlobalFixture::world,
+      a.trange(), 3ul);
+  BOOST_CHECK_EQUAL(batch.size(), 3ul);
+
+  // The members share the tiling and the process map of the batch
+  for(const TArrayI& member : batch) {
+    BOOST_CHECK(member.trange().shares_data(batch.trange()));
+    BOOST_CHECK(member.pmap() == batch.pmap());
+  }
+
+  BOOST_REQUIRE_NO_THROW(batch.assign("a,b,c",
+      [this] (const std::size_t i) { return (int(i) + 1) * a("a,b,c") + b("a,b,c"); }));
+
+  for(std::size_t i = 0ul; i < batch.size(); ++i) {
+    BOOST_CHECK(batch[i].pmap() == batch.pmap());
+    for(std::size_t t = 0ul; t < a.size(); ++t) {
+      if(! a.is_local(t))
+        continue;
+      TArrayI::value_type tile = batch[i].find(t).get();
+      TArrayI::value_type a_tile = a.find(t).get();
+      TArrayI::value_type b_tile = b.find(t).get();
+
+      for(std::size_t j = 0ul; j < tile.size(); ++j)
+        BOOST_CHECK_EQUAL(tile[j], (int(i) + 1) * a_tile[j] + b_tile[j]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( subworld_scheduler )
+{
+  const unsigned int n = std::min(2, GlobalFixture::world->size());
+  SubworldScheduler scheduler(* GlobalFixture::world, n);
+  BOOST_CHECK_EQUAL(scheduler.size(), n);
+  BOOST_CHECK_LT(scheduler.subworld_index(), n);
+  BOOST_CHECK_GT(scheduler.subworld().size(), 0);
+  BOOST_CHECK_LE(scheduler.subworld().size(), GlobalFixture::world->size());
+
+  std::vector<TArrayI> results(3);
+  for(std::size_t i = 0ul; i < results.size(); ++i)
+    scheduler.add(results[i], "a,b,c",
+        [this,i] () { return (int(i) + 1) * a("a,b,c") + b("a,b,c"); });
+  TArrayI contraction;
+  scheduler.add(contraction, "a,b",
+      [this] () { return a("a,c,d") * b("b,c,d"); });
+  BOOST_REQUIRE_NO_THROW(scheduler.run());
+
+  // The results live in the parent world
+  for(std::size_t i = 0ul; i < results.size(); ++i) {
+    BOOST_CHECK(& results[i].world() == GlobalFixture::world);
+    for(std::size_t t = 0ul; t < a.size(); ++t) {
+      if(! results[i].is_local(t))
+        continue;
+      TArrayI::value_type tile = results[i].find(t).get();
+      TArrayI::value_type a_tile = a.find(t).get();
+      TArrayI::value_type b_tile = b.find(t).get();
+
+      for(std::size_t j = 0ul; j < tile.size(); ++j)
+        BOOST_CHECK_EQUAL(tile[j], (int(i) + 1) * a_tile[j] + b_tile[j]);
+    }
+  }
+
+  TArrayI reference;
+  reference("a,b") = a("a,c,d") * b("b,c,d");
+  for(std::size_t t = 0ul; t < reference.size(); ++t) {
+    if(! contraction.is_local(t))
+      continue;
+    TArrayI::value_type tile = contraction.find(t).get();
+    TArrayI::value_type reference_tile = reference.find(t).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), reference_tile.range());
+    for(std::size_t j = 0ul; j < tile.size(); ++j)
+      BOOST_CHECK_EQUAL(tile[j], reference_tile[j]);
+  }
+
+  // Copy an array into the subworld
+  TArrayI sub_a = copy_to_world(a, scheduler.subworld());
+  BOOST_CHECK(& sub_a.world() == & scheduler.subworld());
+  for(const auto t : *sub_a.pmap()) {
+    TArrayI::value_type tile = sub_a.find(t).get();
+    TArrayI::value_type a_tile = a.find(t).get();
+    for(std::size_t j = 0ul; j < tile.size(); ++j)
+      BOOST_CHECK_EQUAL(tile[j], a_tile[j]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( expr_plan )
+{
+  auto plan = expressions::make_plan(c("a,b,c"), a("a,b,c") - 2 * b("a,b,c"));
+  BOOST_CHECK(! plan.is_initialized());
+
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  BOOST_CHECK(plan.is_initialized());
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    TArrayI::value_type a_tile = a.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], a_tile[j] - 2 * b_tile[j]);
+  }
+
+  // The arrays of the expression may be reassigned between evaluations
+  TArrayI x(*GlobalFixture::world, tr);
+  random_fill(x);
+  GlobalFixture::world->gop.fence();
+  a = x;
+
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    TArrayI::value_type x_tile = x.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], x_tile[j] - 2 * b_tile[j]);
+  }
+
+  // The result may be an argument of the expression
+  auto update = expressions::make_plan(c("a,b,c"), c("a,b,c") + b("a,b,c"));
+  BOOST_REQUIRE_NO_THROW(update.eval());
+  BOOST_REQUIRE_NO_THROW(update.eval());
+
+  for(std::size_t i = 0ul; i < c.size(); ++i) {
+    TArrayI::value_type c_tile = c.find(i).get();
+    TArrayI::value_type x_tile = x.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(c_tile[j], x_tile[j]);
+  }
+
+  // Contractions keep their process grid
+  auto outer = expressions::make_plan(w("i,j"), u("i") * v("j"));
+  BOOST_REQUIRE_NO_THROW(outer.eval());
+
+  TArrayI y(*GlobalFixture::world, trange1);
+  random_fill(y);
+  GlobalFixture::world->gop.fence();
+  v = y;
+
+  BOOST_REQUIRE_NO_THROW(outer.eval());
+  GlobalFixture::world->gop.fence();
+
+  EigenMatrixXi ew = make_matrix(w);
+  EigenMatrixXi ew_test = make_matrix(u) * make_matrix(y).transpose();
+  BOOST_CHECK_EQUAL(ew, ew_test);
+}
+
+BOOST_AUTO_TEST_CASE( batch_max_memory )
+{
+  TArrayI reference;
+  reference("a,b") = a("a,i,j") * b("b,i,j");
+
+  // Evaluate with the largest number of batches
+  BOOST_REQUIRE_NO_THROW(w("a,b") = (a("a,i,j") * b("b,i,j")).set_batch_max_memory(1ul));
+  BOOST_CHECK_EQUAL(w.trange(), reference.trange());
+  for(std::size_t i = 0ul; i < w.size(); ++i) {
+    if(! w.is_local(i)) continue;
+    TArrayI::value_type w_tile = w.find(i).get();
+    TArrayI::value_type ref_tile = reference.find(i).get();
+    BOOST_CHECK_EQUAL(w_tile.range(), ref_tile.range());
+    for(std::size_t j = 0ul; j < w_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(w_tile[j], ref_tile[j]);
+  }
+
+  // Batch a chosen variable of a permuted, scaled sum
+  TArrayI reference_sum;
+  reference_sum("b,a") = 2 * (a("a,i,j") * b("b,i,j")) + reference("a,b");
+  BOOST_REQUIRE_NO_THROW(w("b,a") = (2 * (a("a,i,j") * b("b,i,j")) + reference("a,b"))
+      .set_batch_max_memory(1ul).set_batch_var("a"));
+  for(std::size_t i = 0ul; i < w.size(); ++i) {
+    if(! w.is_local(i)) continue;
+    TArrayI::value_type w_tile = w.find(i).get();
+    TArrayI::value_type ref_tile = reference_sum.find(i).get();
+    for(std::size_t j = 0ul; j < w_tile.size(); ++j)
+      BOOST_CHECK_EQUAL(w_tile[j], ref_tile[j]);
+  }
+}
+
 BOOST_AUTO_TEST_CASE( dot )
 {
   // Test the dot expression function
@@ -1832,6 +2854,142 @@ BOOST_AUTO_TEST_CASE( dot )
   BOOST_CHECK_EQUAL(result, expected);
 }
 
+BOOST_AUTO_TEST_CASE( tensor_result_reduce )
+{
+  // Sums the elements of the tiles, by the remainder of the element index
+  struct StripedSumReduction {
+    typedef TensorI result_type;
+    typedef TArrayI::value_type argument_type;
+
+    result_type operator()() const { return result_type(); }
+    const result_type& operator()(const result_type& result) const { return result; }
+    void operator()(result_type& result, const result_type& arg) const {
+      if(result.empty())
+        result = arg.clone();
+      else
+        result.add_to(arg);
+    }
+    void operator()(result_type& result, const argument_type& arg) const {
+      if(result.empty())
+        result = result_type(Range(1000ul), 0);
+      for(std::size_t i = 0ul; i < arg.size(); ++i)
+        result[i % 1000ul] += arg[i];
+    }
+  };
+
+  TensorI expected(Range(1000ul), 0);
+  for(std::size_t i = 0ul; i < a.size(); ++i) {
+    TArrayI::value_type tile = a.find(i).get();
+    for(std::size_t j = 0ul; j < tile.size(); ++j)
+      expected[j % 1000ul] += tile[j];
+  }
+
+  // Reduce with the tree all-reduce and with the reduce-scatter pipeline
+  typedef detail::TensorAllReduce<TensorI, StripedSumReduction> all_reduce_type;
+  const std::size_t min_elements = all_reduce_type::min_elements();
+  for(std::size_t threshold : { 1000000ul, 0ul }) {
+    all_reduce_type::min_elements() = threshold;
+    TensorI result;
+    BOOST_REQUIRE_NO_THROW(result = a("a,b,c").reduce(StripedSumReduction()).get());
+    BOOST_CHECK_EQUAL(result.range(), expected.range());
+    BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+        expected.begin(), expected.end());
+  }
+  all_reduce_type::min_elements() = min_elements;
+}
+
+BOOST_AUTO_TEST_CASE( reduction_batch )
+{
+  const int dot_expected = a("a,b,c").dot(b("a,b,c")).get();
+  const int squared_norm_expected = (a("a,b,c") - b("a,b,c")).squared_norm().get();
+  const int sum_expected = c("a,b,c").sum().get();
+  const int rank_sum_expected = int(GlobalFixture::world->size() *
+      (GlobalFixture::world->size() - 1ul) / 2ul);
+
+  TiledArray::ReductionBatch<int> batch(*GlobalFixture::world);
+  Future<int> dot, squared_norm, sum, rank_sum, rank_max;
+  BOOST_REQUIRE_NO_THROW(dot = a("a,b,c").dot(b("a,b,c"), batch));
+  BOOST_REQUIRE_NO_THROW(squared_norm =
+      (a("a,b,c") - b("a,b,c")).squared_norm(batch));
+  BOOST_REQUIRE_NO_THROW(sum = c("a,b,c").sum(batch));
+  rank_sum = batch.sum(Future<int>(int(GlobalFixture::world->rank())));
+  rank_max = batch.max(Future<int>(int(GlobalFixture::world->rank())));
+  BOOST_CHECK_EQUAL(batch.size(), 5ul);
+
+  batch.flush();
+  BOOST_CHECK(batch.empty());
+
+  BOOST_CHECK_EQUAL(dot.get(), dot_expected);
+  BOOST_CHECK_EQUAL(squared_norm.get(), squared_norm_expected);
+  BOOST_CHECK_EQUAL(sum.get(), sum_expected);
+  BOOST_CHECK_EQUAL(rank_sum.get(), rank_sum_expected);
+  BOOST_CHECK_EQUAL(rank_max.get(), int(GlobalFixture::world->size()) - 1);
+}
+
+BOOST_AUTO_TEST_CASE( compensated_reduce )
+{
+  int dot = 0, squared_norm = 0;
+  BOOST_REQUIRE_NO_THROW(dot = a("a,b,c").compensated_dot(b("a,b,c")).get());
+  BOOST_REQUIRE_NO_THROW(squared_norm =
+      (a("a,b,c") - 2 * b("a,b,c")).compensated_squared_norm().get());
+
+  int dot_expected = 0, squared_norm_expected = 0;
+  for(std::size_t i = 0ul; i < a.size(); ++i) {
+    TArrayI::value_type a_tile = a.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+
+    for(std::size_t j = 0ul; j < a_tile.size(); ++j) {
+      dot_expected += a_tile[j] * b_tile[j];
+      const int diff = a_tile[j] - 2 * b_tile[j];
+      squared_norm_expected += diff * diff;
+    }
+  }
+
+  BOOST_CHECK_EQUAL(dot, dot_expected);
+  BOOST_CHECK_EQUAL(squared_norm, squared_norm_expected);
+}
+
+BOOST_AUTO_TEST_CASE( fused_reduce )
+{
+  // The reductions of element-wise expressions are evaluated without
+  // constructing the result tiles
+  int squared_norm = 0;
+  BOOST_REQUIRE_NO_THROW(squared_norm =
+      (a("a,b,c") - 2 * b("a,b,c")).squared_norm().get());
+  int sum = 0;
+  BOOST_REQUIRE_NO_THROW(sum = (a("a,b,c") + b("a,b,c") - c("a,b,c")).sum().get());
+  int result = 0;
+  BOOST_REQUIRE_NO_THROW(result =
+      (a("a,b,c") - b("a,b,c")).dot(a("a,b,c") + 3 * c("a,b,c")).get());
+  int leaf_result = 0;
+  BOOST_REQUIRE_NO_THROW(leaf_result =
+      a("a,b,c").dot(b("a,b,c") - c("a,b,c")).get());
+
+  // Compute the expected values
+  int squared_norm_expected = 0;
+  int sum_expected = 0;
+  int expected = 0;
+  int leaf_expected = 0;
+  for(std::size_t i = 0ul; i < a.size(); ++i) {
+    TArrayI::value_type a_tile = a.find(i).get();
+    TArrayI::value_type b_tile = b.find(i).get();
+    TArrayI::value_type c_tile = c.find(i).get();
+
+    for(std::size_t j = 0ul; j < a_tile.size(); ++j) {
+      const int diff = a_tile[j] - 2 * b_tile[j];
+      squared_norm_expected += diff * diff;
+      sum_expected += a_tile[j] + b_tile[j] - c_tile[j];
+      expected += (a_tile[j] - b_tile[j]) * (a_tile[j] + 3 * c_tile[j]);
+      leaf_expected += a_tile[j] * (b_tile[j] - c_tile[j]);
+    }
+  }
+
+  BOOST_CHECK_EQUAL(squared_norm, squared_norm_expected);
+  BOOST_CHECK_EQUAL(sum, sum_expected);
+  BOOST_CHECK_EQUAL(result, expected);
+  BOOST_CHECK_EQUAL(leaf_result, leaf_expected);
+}
+
 BOOST_AUTO_TEST_CASE( dot_permute )
 {
   Permutation perm({2, 1, 0});
@@ -1884,6 +3042,93 @@ BOOST_AUTO_TEST_CASE( dot_contr )
     BOOST_REQUIRE_NO_THROW( (a("a,b,c") * b("d,b,c")).dot(b("d,e,f")*a("a,e,f")) );
 }
 
+BOOST_AUTO_TEST_CASE( multi_reduce )
+{
+  typedef TArrayI::value_type tile_type;
+
+  // Evaluate the sum, minimum, and maximum of a in one traversal
+  std::tuple<Future<int>, Future<int>, Future<int> > results;
+  BOOST_REQUIRE_NO_THROW(results = a("a,b,c").multi_reduce(std::make_tuple(
+      TiledArray::SumReduction<tile_type>(),
+      TiledArray::MinReduction<tile_type>(),
+      TiledArray::MaxReduction<tile_type>())));
+
+  // Compute the expected values
+  int sum = 0;
+  int min = std::numeric_limits<int>::max();
+  int max = std::numeric_limits<int>::min();
+  for(std::size_t i = 0ul; i < a.size(); ++i) {
+    tile_type a_tile = a.find(i).get();
+    for(std::size_t j = 0ul; j < a_tile.size(); ++j) {
+      sum += a_tile[j];
+      min = std::min(min, a_tile[j]);
+      max = std::max(max, a_tile[j]);
+    }
+  }
+
+  BOOST_CHECK_EQUAL(std::get<0>(results).get(), sum);
+  BOOST_CHECK_EQUAL(std::get<1>(results).get(), min);
+  BOOST_CHECK_EQUAL(std::get<2>(results).get(), max);
+
+  // Evaluate a dot product and a squared norm in one traversal
+  std::tuple<Future<int>, Future<int> > pair_results;
+  BOOST_REQUIRE_NO_THROW(pair_results = a("a,b,c").multi_reduce(b("a,b,c"),
+      std::make_tuple(TiledArray::DotReduction<tile_type, tile_type>(),
+      TiledArray::SquaredNormReduction<tile_type>())));
+
+  BOOST_CHECK_EQUAL(std::get<0>(pair_results).get(),
+      a("a,b,c").dot(b("a,b,c")).get());
+  BOOST_CHECK_EQUAL(std::get<1>(pair_results).get(),
+      a("a,b,c").squared_norm().get());
+}
+
+BOOST_AUTO_TEST_CASE( many_mixed_tiles )
+{
+  // Many small tiles of different sizes, which are evaluated several per
+  // task, and one large tile, which has its own task
+  std::vector<std::size_t> row_bounds(1, 0ul);
+  for(std::size_t t = 0ul; t < 1200ul; ++t)
+    row_bounds.push_back(row_bounds.back() + (t % 3ul == 0ul ? 1ul : 2ul * (t % 3ul)));
+  row_bounds.push_back(row_bounds.back() + 5000ul);
+  const std::array<std::size_t, 2> col_bounds = {{ 0ul, 4ul }};
+  const std::array<TiledRange1, 2> dims = {{
+      TiledRange1(row_bounds.begin(), row_bounds.end()),
+      TiledRange1(col_bounds.begin(), col_bounds.end()) }};
+  const TiledRange trange(dims.begin(), dims.end());
+
+  TArrayI x(*GlobalFixture::world, trange), y(*GlobalFixture::world, trange);
+  auto value = [] (const std::size_t i, const std::size_t j, const std::size_t f)
+      { return int((f * i + 3ul * j) % 101ul); };
+  for(auto it = x.begin(); it != x.end(); ++it) {
+    TArrayI::value_type x_tile(x.trange().make_tile_range(it.index()));
+    TArrayI::value_type y_tile(x_tile.range());
+    for(auto idx_it = x_tile.range().begin(); idx_it != x_tile.range().end(); ++idx_it) {
+      x_tile[*idx_it] = value((*idx_it)[0], (*idx_it)[1], 7ul);
+      y_tile[*idx_it] = value((*idx_it)[0], (*idx_it)[1], 5ul);
+    }
+    *it = x_tile;
+    y.set(it.index(), y_tile);
+  }
+  if(x.pmap()->local_size() >= 16ul * (madness::ThreadPool::size() + 1ul))
+    BOOST_CHECK(! detail::TileChunker(x.pmap()->local_size()).add(1ul));
+
+  TArrayI z, t;
+  BOOST_REQUIRE_NO_THROW(z("i,j") = 2 * x("i,j") + y("i,j"));
+  BOOST_REQUIRE_NO_THROW(t("j,i") = -x("i,j"));
+
+  for(auto it = z.begin(); it != z.end(); ++it) {
+    const TArrayI::value_type tile = *it;
+    for(auto idx_it = tile.range().begin(); idx_it != tile.range().end(); ++idx_it)
+      BOOST_CHECK_EQUAL(tile[*idx_it], 2 * value((*idx_it)[0], (*idx_it)[1], 7ul)
+          + value((*idx_it)[0], (*idx_it)[1], 5ul));
+  }
+  for(auto it = t.begin(); it != t.end(); ++it) {
+    const TArrayI::value_type tile = *it;
+    for(auto idx_it = tile.range().begin(); idx_it != tile.range().end(); ++idx_it)
+      BOOST_CHECK_EQUAL(tile[*idx_it], -value((*idx_it)[1], (*idx_it)[0], 7ul));
+  }
+}
+
 BOOST_AUTO_TEST_CASE( inner_product )
 {
   // Test the inner_product expression function
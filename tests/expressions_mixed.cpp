@@ -242,4 +242,166 @@ BOOST_AUTO_TEST_CASE( outer_product_factories )
   }
 }
 
+BOOST_AUTO_TEST_CASE( kronecker_delta_tile_contraction )
+{
+  // delta(i,k) with i in [2,5) and k in [0,4)
+  const KroneckerDeltaTile<1> delta(Range(std::vector<std::size_t>{2, 0},
+      std::vector<std::size_t>{5, 4}));
+  BOOST_CHECK(! delta.empty());
+  TensorD t(Range(4, 3));
+  for(std::size_t i = 0ul; i < t.size(); ++i)
+    t[i] = double(i + 1);
+
+  const math::GemmHelper nn(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, 2u, 2u);
+  const TensorD r = gemm(delta, t, 2.0, nn);
+  BOOST_CHECK_EQUAL(r.range(), Range(std::vector<std::size_t>{2, 0},
+      std::vector<std::size_t>{5, 3}));
+  for(std::size_t i = 2ul; i < 5ul; ++i)
+    for(std::size_t j = 0ul; j < 3ul; ++j)
+      BOOST_CHECK_EQUAL(r(i, j), (i < 4ul ? 2.0 * t(i, j) : 0.0));
+
+  // t(j,k) delta(k,i) with the Kronecker delta transposed
+  const math::GemmHelper nt(madness::cblas::Trans, madness::cblas::Trans,
+      2u, 2u, 2u);
+  const TensorD s = gemm(t, delta, 1.0, nt);
+  for(std::size_t j = 0ul; j < 3ul; ++j)
+    for(std::size_t i = 2ul; i < 5ul; ++i)
+      BOOST_CHECK_EQUAL(s(j, i), (i < 4ul ? t(i, j) : 0.0));
+
+  const KroneckerDeltaTile<1> off(Range(std::vector<std::size_t>{0, 4},
+      std::vector<std::size_t>{4, 8}));
+  BOOST_CHECK(off.empty());
+}
+
+BOOST_AUTO_TEST_CASE( kronecker_delta_contraction )
+{
+  // The contraction relabels the indices of e2, so the Kronecker delta tiles
+  // are not moved and no flops are done
+  TArrayD r;
+  auto check = [this] (const TArrayD& result) {
+    for(auto it = result.begin(); it != result.end(); ++it) {
+      const TensorD tile = *it;
+      const TensorD ref_tile = e2.find(it.index()).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  };
+  BOOST_REQUIRE_NO_THROW(r("a,c") = delta1e("a,b") * e2("b,c"));
+  check(r);
+  BOOST_REQUIRE_NO_THROW(r("a,c") = e2("a,b") * delta1e("b,c"));
+  check(r);
+
+  auto cont = delta1e("a,b") * e2("b,c");
+  expressions::ContractionPlan plan;
+  BOOST_REQUIRE_NO_THROW(plan = cont.plan("a,c", *GlobalFixture::world));
+  BOOST_CHECK(plan.mode == expressions::ContractionMode::diagonal);
+  BOOST_CHECK_EQUAL(plan.flops, 0.0);
+  BOOST_CHECK_EQUAL(plan.total_comm_bytes(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( mixed_policy_expressions )
+{
+  // A sparse array where every other tile is zero
+  Tensor<float> norms(trange2.tiles_range(), 0.0f);
+  for(const auto& index : trange2.tiles_range())
+    if((index[0] + index[1]) % 2ul == 0ul)
+      norms[index] = trange2.make_tile_range(index).volume();
+  TSpArrayD s(*GlobalFixture::world, trange2,
+      SparseShape<float>(*GlobalFixture::world, norms, trange2));
+  for(const auto index : *s.pmap())
+    if(! s.is_zero(index))
+      s.set(index, make_rand_tile<TSpArrayD>(s.trange().make_tile_range(index)));
+  const TSpArrayD u_sparse = to_sparse(u);
+
+  auto check = [] (const TArrayD& result, const TArrayD& reference) {
+    for(auto it = result.begin(); it != result.end(); ++it) {
+      const TensorD tile = *it;
+      const TensorD ref_tile = reference.find(it.index()).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  };
+
+  // The sum of a dense and a sparse array is dense
+  TArrayD d;
+  TSpArrayD ref;
+  BOOST_REQUIRE_NO_THROW(d("a,b") = u("a,b") + s("a,b"));
+  ref("a,b") = u_sparse("a,b") + s("a,b");
+  check(d, to_dense(ref));
+  BOOST_REQUIRE_NO_THROW(d("a,b") = s("a,b") - 2 * u("a,b"));
+  ref("a,b") = s("a,b") - 2 * u_sparse("a,b");
+  check(d, to_dense(ref));
+
+  // The product of a dense and a sparse array is screened by the sparse
+  // array, without converting the dense array
+  TSpArrayD r;
+  BOOST_REQUIRE_NO_THROW(r("a,b") = u("a,b") * s("a,b"));
+  for(std::size_t i = 0ul; i < r.size(); ++i)
+    BOOST_CHECK_EQUAL(r.is_zero(i), s.is_zero(i));
+  ref("a,b") = u_sparse("a,b") * s("a,b");
+  check(to_dense(r), to_dense(ref));
+
+  BOOST_REQUIRE_NO_THROW(r("a,c") = u("a,b") * s("c,b"));
+  ref("a,c") = u_sparse("a,b") * s("c,b");
+  check(to_dense(r), to_dense(ref));
+
+  BOOST_REQUIRE_NO_THROW(r("a,c") = s("a,b") * u("c,b"));
+  ref("a,c") = s("a,b") * u_sparse("c,b");
+  check(to_dense(r), to_dense(ref));
+}
+
+BOOST_AUTO_TEST_CASE( mixed_policy_norm_bound )
+{
+  // The shape of a dense argument is its tile norms, which bound the norms
+  // of the result when the dense elements are larger than one. With a unit
+  // per-element norm, the scaled product below would be screened.
+  const float threshold = SparseShape<float>::threshold();
+  SparseShape<float>::threshold(1.0e-2f);
+
+  const TiledRange1 tr1{0, 4, 8, 12};
+  const TiledRange tr{ tr1, tr1 };
+  TArrayD d(*GlobalFixture::world, tr);
+  d.fill(100.0);
+  TArrayD x(*GlobalFixture::world, tr);
+  for(const auto index : *x.pmap())
+    x.set(index, TensorD(tr.make_tile_range(index),
+        ((index % 2ul) == 0ul ? 1.0 : 0.0)));
+  const TSpArrayD s = to_sparse(x);
+  for(std::size_t i = 0ul; i < s.size(); ++i)
+    BOOST_CHECK_EQUAL(s.is_zero(i), (i % 2ul) != 0ul);
+
+  TSpArrayD r;
+  BOOST_REQUIRE_NO_THROW(r("a,b") = 1.0e-2 * (d("a,b") * s("a,b")));
+  for(std::size_t i = 0ul; i < r.size(); ++i) {
+    BOOST_CHECK_EQUAL(r.is_zero(i), s.is_zero(i));
+    if(r.is_zero(i))
+      continue;
+    const TensorD tile = r.find(i).get();
+    for(std::size_t j = 0ul; j < tile.size(); ++j)
+      BOOST_CHECK_CLOSE(tile[j], 1.0, 1.0e-10);
+    BOOST_CHECK_GE(r.shape()[i] * tile.size() * (1.0 + 1.0e-5), tile.norm());
+  }
+
+  // Contraction with a permuted dense argument
+  const TSpArrayD d_sparse = to_sparse(d);
+  TSpArrayD ref;
+  BOOST_REQUIRE_NO_THROW(r("a,c") = 1.0e-2 * (s("a,b") * d("c,b")));
+  ref("a,c") = 1.0e-2 * (s("a,b") * d_sparse("c,b"));
+  for(std::size_t i = 0ul; i < r.size(); ++i) {
+    BOOST_CHECK_EQUAL(r.is_zero(i), ref.is_zero(i));
+    if(ref.is_zero(i))
+      continue;
+    const TensorD tile = r.find(i).get();
+    const TensorD ref_tile = ref.find(i).get();
+    for(std::size_t j = 0ul; j < tile.size(); ++j)
+      BOOST_CHECK_CLOSE(tile[j], ref_tile[j], 1.0e-10);
+    BOOST_CHECK_GE(r.shape()[i] * tile.size() * (1.0 + 1.0e-5), tile.norm());
+  }
+
+  SparseShape<float>::threshold(threshold);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -86,6 +86,25 @@ struct ExpressionsSparseFixture : public TiledRangeFixture {
     return tile;
   }
 
+  // Check that result has the shape of ref, that no zero tiles are stored,
+  // and that the local tiles of result are equal to the tiles of ref
+  static void check_tiles(const TSpArrayI& result, const TSpArrayI& ref) {
+    BOOST_CHECK_EQUAL(result.trange(), ref.trange());
+    for (std::size_t i = 0ul; i < ref.size(); ++i) {
+      BOOST_CHECK_EQUAL(result.is_zero(i), ref.is_zero(i));
+      BOOST_CHECK_CLOSE(result.shape()[i], ref.shape()[i], 1.0e-4);
+    }
+    for (TSpArrayI::const_iterator it = result.begin(); it != result.end();
+         ++it) {
+      BOOST_CHECK(!ref.is_zero(it.index()));
+      const TSpArrayI::value_type tile = *it;
+      const TSpArrayI::value_type ref_tile = ref.find(it.index()).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for (std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  }
+
   // make a tile with 0 data
   template <typename A>
   static typename A::value_type make_zero_tile(
@@ -541,6 +560,49 @@ BOOST_AUTO_TEST_CASE(permute) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(permute_plan) {
+  // A sparse array with a single non-zero tile
+  Tensor<float> norms(tr.tiles_range(), 0.0);
+  norms[0] = 1.0;
+  TSpArrayI x(*GlobalFixture::world, tr, SparseShape<float>(norms, tr));
+  random_fill(x);
+  GlobalFixture::world->gop.fence();
+
+  std::size_t b_elements = 0ul;
+  for (std::size_t i = 0ul; i < b.size(); ++i)
+    if (!b.is_zero(i)) b_elements += tr.make_tile_range(i).volume();
+  const std::size_t x_elements = tr.make_tile_range(0).volume();
+
+  // Both arguments are permuted to the target variable list, instead of
+  // permuting b to the variable list of x and then permuting the result.
+  std::stringstream ss;
+  BOOST_REQUIRE_NO_THROW(ss << c("a,b,c") << (b("c,b,a") + x("b,a,c")));
+  if (GlobalFixture::world->rank() == 0) {
+    std::stringstream plan;
+    plan << "[permuted elements " << b_elements + x_elements << "]";
+    BOOST_CHECK(ss.str().find(plan.str()) != std::string::npos);
+  }
+
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = b("c,b,a") + x("b,a,c"));
+
+  // Compute the expected result with separate permutations
+  TSpArrayI perm_b, perm_x, expected;
+  perm_b("a,b,c") = b("c,b,a");
+  perm_x("a,b,c") = x("b,a,c");
+  expected("a,b,c") = perm_b("a,b,c") + perm_x("a,b,c");
+
+  for (std::size_t i = 0ul; i < c.size(); ++i) {
+    BOOST_CHECK_EQUAL(c.is_zero(i), expected.is_zero(i));
+    if (c.is_local(i) && !c.is_zero(i)) {
+      TSpArrayI::value_type c_tile = c.find(i).get();
+      TSpArrayI::value_type expected_tile = expected.find(i).get();
+
+      for (std::size_t j = 0ul; j < c_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(c_tile[j], expected_tile[j]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(scale_permute) {
   Permutation perm({2, 1, 0});
   BOOST_REQUIRE_NO_THROW(a("a,b,c") = 2 * b("c,b,a"));
@@ -1596,6 +1658,250 @@ BOOST_AUTO_TEST_CASE(cont) {
   }
 }
 
+BOOST_AUTO_TEST_CASE( cont_work_order )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  TSpArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Check that visiting the SUMMA iterations in work order gives the same
+  // result as the natural order
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_summa_work_order(true));
+  check_tiles(w, ref);
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_repeat )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  TSpArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Check that repeated contractions, which reuse the cached broadcast
+  // groups, give the same result
+  for(int repeat = 0; repeat < 3; ++repeat) {
+    BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c"));
+    check_tiles(w, ref);
+  }
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_batch )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  TSpArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Check that batched tile contractions give the same result
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_summa_batch(true));
+  check_tiles(w, ref);
+
+  // Check batched contractions with a permuted result
+  BOOST_REQUIRE_NO_THROW(ref("j,i") = a("i,b,c") * b("j,b,c"));
+  BOOST_REQUIRE_NO_THROW(w("j,i") =
+      (a("i,b,c") * b("j,b,c")).set_summa_batch(true));
+  check_tiles(w, ref);
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_prefetch )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  TSpArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Check that prefetched broadcasts give the same result
+  TiledArray::detail::SummaOverlapStats::reset();
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_summa_prefetch(true));
+  check_tiles(w, ref);
+
+  // Check the overlap counters
+  BOOST_CHECK_LE(TiledArray::detail::SummaOverlapStats::ready_tiles(),
+      TiledArray::detail::SummaOverlapStats::received_tiles());
+  BOOST_CHECK_GE(TiledArray::detail::SummaOverlapStats::ratio(), 0.0);
+  BOOST_CHECK_LE(TiledArray::detail::SummaOverlapStats::ratio(), 1.0);
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_node_bcast )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  TSpArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+
+  // Check that two-level broadcasts give the same result
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_summa_node_bcast(true));
+  check_tiles(w, ref);
+
+  // Check with prefetched broadcasts
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_summa_node_bcast(true).set_summa_prefetch(true));
+  check_tiles(w, ref);
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_stationary )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  using TiledArray::expressions::ContractionMode;
+
+  TSpArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = a("i,b,c") * b("j,b,c"));
+  TSpArrayI ref_perm;
+  BOOST_REQUIRE_NO_THROW(ref_perm("j,i") = a("i,b,c") * b("j,b,c"));
+
+  // Check that the operand-stationary and owner-computes modes give the
+  // same result as SUMMA
+  for(ContractionMode mode : { ContractionMode::keep_left, ContractionMode::keep_right,
+      ContractionMode::pull }) {
+    BOOST_REQUIRE_NO_THROW(w("i,j") =
+        (a("i,b,c") * b("j,b,c")).set_contraction_mode(mode));
+    check_tiles(w, ref);
+
+    // Check with a permuted result
+    BOOST_REQUIRE_NO_THROW(w("j,i") =
+        (a("i,b,c") * b("j,b,c")).set_contraction_mode(mode));
+    check_tiles(w, ref_perm);
+  }
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_sparse_dense )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  using TiledArray::expressions::ContractionMode;
+
+  // An array without zero tiles
+  TSpArrayI d(*GlobalFixture::world, tr,
+      SparseShape<float>(Tensor<float>(tr.tiles_range(), 1.0f), tr));
+  random_fill(d);
+  GlobalFixture::world->gop.fence();
+
+  // Check that SUMMA with one dense argument gives the same result as the
+  // operand-stationary mode
+  TSpArrayI ref;
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = (a("i,b,c") * d("j,b,c"))
+      .set_contraction_mode(ContractionMode::keep_right));
+  BOOST_REQUIRE_NO_THROW(w("i,j") = (a("i,b,c") * d("j,b,c"))
+      .set_contraction_mode(ContractionMode::keep_result));
+  check_tiles(w, ref);
+
+  // Check with a dense left-hand argument
+  BOOST_REQUIRE_NO_THROW(ref("i,j") = (d("i,b,c") * b("j,b,c"))
+      .set_contraction_mode(ContractionMode::keep_left));
+  BOOST_REQUIRE_NO_THROW(w("i,j") = (d("i,b,c") * b("j,b,c"))
+      .set_contraction_mode(ContractionMode::keep_result));
+  check_tiles(w, ref);
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( cont_plan )
+{
+  // Evaluate with SUMMA, also with one process
+  set_local_contraction(false);
+
+  const std::size_t m = a.trange().elements_range().extent(0);
+  const std::size_t k = a.trange().elements_range().extent(1) * a.trange().elements_range().extent(2);
+  const std::size_t n = b.trange().elements_range().extent(0);
+
+  TiledArray::expressions::ContractionPlan plan;
+  BOOST_REQUIRE_NO_THROW(plan =
+      (a("i,b,c") * b("j,b,c")).plan("i,j", *GlobalFixture::world));
+
+  // The sparse flop count is bound by the dense flop count
+  BOOST_CHECK_GT(plan.flops, 0.0);
+  BOOST_CHECK_LE(plan.flops, 2.0 * double(m) * double(n) * double(k));
+  BOOST_CHECK(plan.mode != TiledArray::expressions::ContractionMode::automatic);
+  BOOST_CHECK_EQUAL(plan.comm_bytes.size(), std::size_t(GlobalFixture::world->size()));
+  BOOST_CHECK_EQUAL(plan.bcast_memory.size(), std::size_t(GlobalFixture::world->size()));
+  if(GlobalFixture::world->size() == 1)
+    BOOST_CHECK_EQUAL(plan.total_comm_bytes(), 0ul);
+
+  // Check that the plan does not evaluate the expression, and that it agrees
+  // with a permuted and scaled plan
+  TiledArray::expressions::ContractionPlan scaled_plan;
+  BOOST_REQUIRE_NO_THROW(scaled_plan =
+      (2 * (a("i,b,c") * b("j,b,c"))).plan("j,i", *GlobalFixture::world));
+  BOOST_CHECK_CLOSE(scaled_plan.flops, plan.flops, 1.0e-8);
+
+  // Plans are only defined for contractions
+  BOOST_CHECK_THROW((a("i,b,c") * b("i,b,c")).plan(*GlobalFixture::world),
+      TiledArray::Exception);
+
+  set_local_contraction(true);
+}
+
+BOOST_AUTO_TEST_CASE( predict )
+{
+  typedef TiledArray::expressions::ExprPrediction<SparseShape<float> > prediction_type;
+  const std::size_t rank = GlobalFixture::world->rank();
+
+  // Check a prediction against the evaluated result
+  auto check = [rank] (const prediction_type& prediction, const TSpArrayI& result) {
+    BOOST_CHECK(prediction.trange == result.trange());
+    BOOST_REQUIRE_EQUAL(prediction.tile_count.size(), std::size_t(GlobalFixture::world->size()));
+    BOOST_REQUIRE_EQUAL(prediction.tile_bytes.size(), std::size_t(GlobalFixture::world->size()));
+
+    std::size_t tile_count = 0ul, tile_bytes = 0ul;
+    for (std::size_t i = 0ul; i < result.size(); ++i) {
+      BOOST_CHECK_EQUAL(prediction.shape.is_zero(i), result.is_zero(i));
+      if (!result.is_zero(i) && result.is_local(i)) {
+        ++tile_count;
+        tile_bytes += sizeof(int) * result.trange().make_tile_range(i).volume();
+      }
+    }
+    BOOST_CHECK_EQUAL(prediction.tile_count[rank], tile_count);
+    BOOST_CHECK_EQUAL(prediction.tile_bytes[rank], tile_bytes);
+    BOOST_CHECK_LE(prediction.max_tile_bytes(), prediction.total_tile_bytes());
+  };
+
+  prediction_type prediction;
+  BOOST_REQUIRE_NO_THROW(prediction =
+      (a("i,b,c") * b("j,b,c")).predict("i,j", *GlobalFixture::world));
+  w("i,j") = a("i,b,c") * b("j,b,c");
+  check(prediction, w);
+
+  BOOST_REQUIRE_NO_THROW(prediction =
+      (a("a,b,c") + 2 * b("a,b,c")).predict("c,b,a", *GlobalFixture::world));
+  c("c,b,a") = a("a,b,c") + 2 * b("a,b,c");
+  check(prediction, c);
+
+  BOOST_REQUIRE_NO_THROW(prediction =
+      (a("a,b,c") * b("a,b,c")).predict(*GlobalFixture::world));
+  c("a,b,c") = a("a,b,c") * b("a,b,c");
+  check(prediction, c);
+
+  BOOST_REQUIRE_NO_THROW(prediction =
+      a("a,b,c").block({3, 3, 3}, {5, 5, 5}).predict(*GlobalFixture::world));
+  c("a,b,c") = a("a,b,c").block({3, 3, 3}, {5, 5, 5});
+  check(prediction, c);
+}
+
 BOOST_AUTO_TEST_CASE( cont_permute )
 {
   const std::size_t m = a.trange().elements_range().extent(0);
@@ -2260,4 +2566,114 @@ BOOST_AUTO_TEST_CASE(dot_contr) {
         (a("a,b,c") * b("d,b,c")).dot(b("d,e,f") * a("a,e,f")));
 }
 
+BOOST_AUTO_TEST_CASE(shape_threshold) {
+  TSpArrayI reference;
+  reference("a,b") = a("a,i,j") * b("b,i,j");
+
+  // Screen the result with half of the largest tile norm
+  float threshold = 0.0f;
+  for (std::size_t i = 0ul; i < reference.size(); ++i)
+    threshold = std::max(threshold, reference.shape()[i]);
+  threshold *= 0.5f;
+
+  BOOST_REQUIRE_NO_THROW(
+      w("a,b") = (a("a,i,j") * b("b,i,j")).set_shape_threshold(threshold));
+  BOOST_CHECK_EQUAL(w.shape().zero_threshold(), threshold);
+
+  const SparseShape<float> expected = reference.shape().with_threshold(threshold);
+  for (std::size_t i = 0ul; i < w.size(); ++i) {
+    BOOST_CHECK_EQUAL(w.is_zero(i), expected.is_zero(i));
+    if (!w.is_zero(i) && w.is_local(i)) {
+      TSpArrayI::value_type w_tile = w.find(i).get();
+      TSpArrayI::value_type ref_tile = reference.find(i).get();
+      for (std::size_t j = 0ul; j < w_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(w_tile[j], ref_tile[j]);
+    }
+  }
+
+  // The threshold of other expressions is set in the same way
+  BOOST_REQUIRE_NO_THROW(
+      c("a,b,c") = (a("a,b,c") + b("a,b,c")).set_shape_threshold(threshold));
+  BOOST_CHECK_EQUAL(c.shape().zero_threshold(), threshold);
+  const SparseShape<float> expected_sum =
+      a.shape().add(b.shape()).with_threshold(threshold);
+  for (std::size_t i = 0ul; i < c.size(); ++i)
+    BOOST_CHECK_EQUAL(c.is_zero(i), expected_sum.is_zero(i));
+}
+
+BOOST_AUTO_TEST_CASE(truncate) {
+  TSpArrayI reference;
+  reference("a,b") = a("a,i,j") * b("b,i,j");
+  const TSpArrayI::shape_type predicted = reference.shape();
+  reference.truncate();
+
+  // Check that the result is truncated during the evaluation
+  BOOST_REQUIRE_NO_THROW(
+      w("a,b") = (a("a,i,j") * b("b,i,j")).set_truncate(true));
+  BOOST_CHECK_EQUAL(w.shape().zero_threshold(), reference.shape().zero_threshold());
+  BOOST_CHECK_GE(w.shape().sparsity(), predicted.sparsity());
+  for (std::size_t i = 0ul; i < w.size(); ++i) {
+    BOOST_CHECK_EQUAL(w.is_zero(i), reference.is_zero(i));
+    if (!w.is_zero(i)) {
+      BOOST_CHECK(!predicted.is_zero(i));
+      BOOST_CHECK_CLOSE(w.shape()[i], reference.shape()[i], 0.0001);
+      if (w.is_local(i)) {
+        TSpArrayI::value_type w_tile = w.find(i).get();
+        TSpArrayI::value_type ref_tile = reference.find(i).get();
+        for (std::size_t j = 0ul; j < w_tile.size(); ++j)
+          BOOST_CHECK_EQUAL(w_tile[j], ref_tile[j]);
+      }
+    }
+  }
+
+  // Check a truncated expression with a permuted result
+  BOOST_REQUIRE_NO_THROW(
+      c("c,b,a") = (a("a,b,c") - b("a,b,c")).set_truncate(true));
+  TSpArrayI reference_diff;
+  reference_diff("c,b,a") = a("a,b,c") - b("a,b,c");
+  reference_diff.truncate();
+  for (std::size_t i = 0ul; i < c.size(); ++i)
+    BOOST_CHECK_EQUAL(c.is_zero(i), reference_diff.is_zero(i));
+}
+
+BOOST_AUTO_TEST_CASE(expr_plan_modified_tiles) {
+  auto plan = expressions::make_plan(w("a,b"), a("a,i,j") * b("b,i,j"));
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  const std::uint64_t a_version = a.version();
+
+  // An evaluation without modified tiles keeps the result
+  const TSpArrayI previous = w;
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  BOOST_CHECK_EQUAL(w.id(), previous.id());
+
+  // Modify a non-zero tile of a in place
+  std::vector<std::size_t> modified;
+  for (const auto i : *a.pmap()) {
+    if (!a.is_zero(i)) {
+      TSpArrayI::value_type tile = a.find(i).get();
+      for (std::size_t j = 0ul; j < tile.size(); ++j) tile[j] *= 2;
+      modified.push_back(i);
+      break;
+    }
+  }
+  BOOST_REQUIRE_NO_THROW(a.mark_modified(modified));
+  BOOST_CHECK_GT(a.version(), a_version);
+  for (const auto i : modified) BOOST_CHECK_EQUAL(a.tile_version(i), a.version());
+
+  BOOST_REQUIRE_NO_THROW(plan.eval());
+  TSpArrayI reference;
+  reference("a,b") = a("a,i,j") * b("b,i,j");
+  GlobalFixture::world->gop.fence();
+
+  for (std::size_t i = 0ul; i < w.size(); ++i) {
+    BOOST_CHECK_EQUAL(w.is_zero(i), reference.is_zero(i));
+    if (!w.is_zero(i) && w.is_local(i)) {
+      TSpArrayI::value_type w_tile = w.find(i).get();
+      TSpArrayI::value_type ref_tile = reference.find(i).get();
+      for (std::size_t j = 0ul; j < w_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(w_tile[j], ref_tile[j]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,145 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/tensor/fixed_tensor.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct FixedTensorFixture {
+  typedef FixedTensor<double, 4, 4> tile_type;
+  typedef FixedTensor<double, 2, 2, 2> cube_type;
+
+  FixedTensorFixture() : a(Range({4, 4}, {8, 8})), b(Range({4, 4}, {8, 8})),
+    c(Range({0, 0, 2}, {2, 2, 4}))
+  {
+    for(std::size_t i = 0ul; i < a.size(); ++i) {
+      a[i] = double(i % 7) - 2.5;
+      b[i] = 0.25 * double((i * 5) % 11) + 1.0;
+    }
+    for(std::size_t i = 0ul; i < c.size(); ++i)
+      c[i] = double(i) + 1.0;
+  }
+
+  static void check_equal(const Tensor<double>& x, const Tensor<double>& y) {
+    BOOST_REQUIRE_EQUAL(x.range(), y.range());
+    for(std::size_t i = 0ul; i < x.size(); ++i)
+      BOOST_CHECK_SMALL(x[i] - y[i], 1.0e-12);
+  }
+
+  Tensor<double> a;
+  Tensor<double> b;
+  Tensor<double> c;
+};
+
+BOOST_FIXTURE_TEST_SUITE( fixed_tensor_suite, FixedTensorFixture )
+
+BOOST_AUTO_TEST_CASE( constructors )
+{
+  BOOST_CHECK(tile_type().empty());
+  BOOST_CHECK_EQUAL(tile_type::volume, 16ul);
+  BOOST_CHECK_EQUAL(tile_type::matrix_size, 4ul);
+  BOOST_CHECK_EQUAL(cube_type::matrix_size, 0ul);
+
+  const tile_type fa(a);
+  BOOST_CHECK(! fa.empty());
+  BOOST_CHECK_EQUAL(fa.range(), a.range());
+  check_equal(Tensor<double>(fa), a);
+
+  const tile_type fv(a.range(), 3.0);
+  BOOST_CHECK_EQUAL(fv.sum(), 48.0);
+
+  // Copies are deep
+  tile_type fc = fa;
+  fc.scale_to(2.0);
+  check_equal(Tensor<double>(fa), a);
+  check_equal(Tensor<double>(fc), a.scale(2.0));
+}
+
+BOOST_AUTO_TEST_CASE( arithmetic )
+{
+  const tile_type fa(a), fb(b);
+  check_equal(Tensor<double>(fa.add(fb)), a.add(b));
+  check_equal(Tensor<double>(fa.subt(fb, 2.0)), a.subt(b, 2.0));
+  check_equal(Tensor<double>(fa.mult(fb)), a.mult(b));
+  check_equal(Tensor<double>(fa.neg()), a.neg());
+
+  tile_type fc = fa;
+  fc.add_to(fb, 3.0);
+  check_equal(Tensor<double>(fc), a.add(b, 3.0));
+
+  BOOST_CHECK_CLOSE(fa.dot(fb), a.dot(b), 1.0e-12);
+  BOOST_CHECK_CLOSE(fa.norm(), a.norm(), 1.0e-12);
+  BOOST_CHECK_EQUAL(fa.abs_max(), a.abs_max());
+  BOOST_CHECK_EQUAL(fa.trace(), a.trace());
+}
+
+BOOST_AUTO_TEST_CASE( permute )
+{
+  // The transpose of a square tile, and the permutations of a cubic tile
+  const tile_type fa(a);
+  const Permutation transpose({1, 0});
+  check_equal(Tensor<double>(fa.permute(transpose)), a.permute(transpose));
+
+  const cube_type fc(c);
+  const Permutation p({2, 0, 1});
+  check_equal(Tensor<double>(fc.permute(p)), c.permute(p));
+  check_equal(Tensor<double>(fc.add(fc, p)), c.add(c, p));
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  const tile_type fa(a), fb(b);
+  for(auto left_op : { madness::cblas::NoTrans, madness::cblas::Trans })
+    for(auto right_op : { madness::cblas::NoTrans, madness::cblas::Trans }) {
+      const math::GemmHelper helper(left_op, right_op, 2u, 2u, 2u);
+      const Tensor<double> expected = a.gemm(b, 2.0, helper);
+      const tile_type result = fa.gemm(fb, 2.0, helper);
+      check_equal(Tensor<double>(result), expected);
+
+      // Accumulation
+      tile_type acc = result;
+      acc.gemm(fa, fb, 1.0, helper);
+      check_equal(Tensor<double>(acc), expected.scale(1.5));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( array_expressions )
+{
+  World& world = *GlobalFixture::world;
+  const TiledRange tr{ TiledRange1{0, 4, 8, 12}, TiledRange1{0, 4, 8, 12} };
+  TArrayD x(world, tr), y(world, tr);
+  x.fill_random();
+  y.fill_random();
+
+  auto to_fixed = [] (const Tensor<double>& tile) { return tile_type(tile); };
+  DistArray<tile_type, DensePolicy> fx = to_new_tile_type(x, to_fixed);
+  DistArray<tile_type, DensePolicy> fy = to_new_tile_type(y, to_fixed);
+
+  TArrayD z;
+  z("i,j") = x("i,k") * y("j,k") + 2.0 * x("j,i");
+  DistArray<tile_type, DensePolicy> fz;
+  fz("i,j") = fx("i,k") * fy("j,k") + 2.0 * fx("j,i");
+
+  for(const auto index : *z.pmap())
+    check_equal(Tensor<double>(fz.find(index).get()), z.find(index).get());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -140,6 +140,33 @@ BOOST_AUTO_TEST_CASE( foreach_unary_sparse )
 }
 
 
+BOOST_AUTO_TEST_CASE( foreach_unary_sparse_threshold )
+{
+  // Tiles with odd indices are zeroed, so they are dropped from the result
+  const float threshold = 1.0e-2;
+  TSpArrayI result = foreach(c, [] (TensorI& result, const TensorI& arg) -> float {
+    result = arg.scale((arg.range().lobound()[0] % 2) ? 0 : 2);
+    return result.norm();
+  }, threshold);
+
+  BOOST_CHECK_EQUAL(result.shape().zero_threshold(), threshold);
+  for(auto index : * result.pmap()) {
+    const auto range = result.trange().make_tile_range(index);
+    if(c.is_zero(index) || (range.lobound()[0] % 2)) {
+      BOOST_CHECK(result.is_zero(index));
+      continue;
+    }
+    if(result.is_zero(index))
+      continue;
+
+    TensorI tile0 = c.find(index).get();
+    TensorI tile = result.find(index).get();
+    for(std::size_t i = 0; i < tile.size(); ++i) {
+      BOOST_CHECK_EQUAL(tile[i], 2 * tile0[i]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( foreach_unary_to_double )
 {
   TArrayD result = foreach<TensorD>(a, [] (TensorD& result, const TensorI& arg) {
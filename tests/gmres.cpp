@@ -0,0 +1,101 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <array>
+#include <cmath>
+#include "TiledArray/algebra/gmres.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct GMRESFixture {
+
+  /// Matrix-vector product
+  struct Multiply {
+    TArrayD A;
+    void operator()(const TArrayD& x, TArrayD& result) const {
+      result("i,k") = A("i,j") * x("j,k");
+    }
+  }; // struct Multiply
+
+  /// Identity preconditioner
+  struct Identity {
+    void operator()(const TArrayD& r, TArrayD& z) const { z("i,k") = r("i,k"); }
+  }; // struct Identity
+
+  GMRESFixture() :
+    bounds({{0, 5, 11, 20}}), rhs_bounds({{0, 1}}), n(bounds.back()),
+    a(n, n), b(n, 1)
+  {
+    // A non-symmetric, diagonally dominant matrix
+    for(std::size_t i = 0ul; i < n; ++i) {
+      for(std::size_t j = 0ul; j < n; ++j)
+        a(i,j) = std::sin(double(3ul * i + j + 1ul)) + (j > i ? 0.5 : 0.0);
+      a(i,i) += double(n);
+      b(i,0) = std::cos(double(i));
+    }
+  }
+
+  TArrayD make_array(const EigenMatrixXd& m, const bool square) const {
+    const TiledRange1 rows(bounds.begin(), bounds.end());
+    const TiledRange1 cols(rhs_bounds.begin(), rhs_bounds.end());
+    const std::array<TiledRange1, 2> dims = {{ rows, (square ? rows : cols) }};
+    return eigen_to_array<TArrayD>(*GlobalFixture::world,
+        TiledRange(dims.begin(), dims.end()), m, true);
+  }
+
+  /// Convert an array to an Eigen matrix on every process
+  static EigenMatrixXd to_matrix(const TArrayD& array) {
+    EigenMatrixXd result(array.trange().elements_range().extent(0),
+        array.trange().elements_range().extent(1));
+    for(std::size_t t = 0ul; t < array.size(); ++t) {
+      const TArrayD::value_type tile = array.find(t).get();
+      for(auto it = tile.range().begin(); it != tile.range().end(); ++it)
+        result((*it)[0], (*it)[1]) = tile[*it];
+    }
+    return result;
+  }
+
+  const std::array<std::size_t, 4> bounds;
+  const std::array<std::size_t, 2> rhs_bounds;
+  const std::size_t n;
+  EigenMatrixXd a;
+  EigenMatrixXd b;
+}; // GMRESFixture
+
+BOOST_FIXTURE_TEST_SUITE( gmres_suite, GMRESFixture )
+
+BOOST_AUTO_TEST_CASE( solve )
+{
+  Multiply multiply{ make_array(a, true) };
+  const TArrayD B = make_array(b, false);
+
+  // A small restart forces several restart cycles
+  GMRESSolver<TArrayD, Multiply, Identity> solver(4u, 200u);
+  TArrayD X;
+  BOOST_REQUIRE_NO_THROW(solver(multiply, B, X, Identity(), 1.0e-12));
+
+  const EigenMatrixXd x = to_matrix(X);
+  BOOST_CHECK_SMALL((a * x - b).norm(), 1.0e-10 * b.norm());
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,159 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/layered_cyclic_pmap.h"
+#include "TiledArray/pmap/cyclic_pmap.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct LayeredCyclicPmapFixture {
+
+  LayeredCyclicPmapFixture() { }
+
+};
+
+
+// =============================================================================
+// LayeredCyclicPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( layered_cyclic_pmap_suite, LayeredCyclicPmapFixture )
+
+BOOST_AUTO_TEST_CASE( layer_partition )
+{
+  for(std::size_t extent = 1ul; extent < 20ul; ++extent) {
+    for(std::size_t layers = 1ul; layers <= extent; ++layers) {
+      BOOST_CHECK_EQUAL(detail::LayeredCyclicPmap::layer_begin(0ul, extent, layers), 0ul);
+      BOOST_CHECK_EQUAL(detail::LayeredCyclicPmap::layer_begin(layers, extent, layers), extent);
+
+      for(std::size_t l = 0ul; l < layers; ++l) {
+        const std::size_t begin = detail::LayeredCyclicPmap::layer_begin(l, extent, layers);
+        const std::size_t end = detail::LayeredCyclicPmap::layer_begin(l + 1ul, extent, layers);
+
+        // Each layer is non-empty and balanced
+        BOOST_CHECK_LT(begin, end);
+        BOOST_CHECK_LE(end - begin, (extent + layers - 1ul) / layers);
+
+        for(std::size_t i = begin; i < end; ++i)
+          BOOST_CHECK_EQUAL(detail::LayeredCyclicPmap::layer_of(i, extent, layers), l);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( single_layer )
+{
+  const std::size_t size = GlobalFixture::world->size();
+
+  // One layer is equivalent to a cyclic process map
+  for(std::size_t x = 1ul; x < 10ul; ++x) {
+    for(std::size_t y = 1ul; y < 10ul; ++y) {
+      const std::size_t p_rows = std::max<std::size_t>(1ul, std::min(x, size));
+      const std::size_t p_cols = std::max<std::size_t>(1ul, std::min(y, size / p_rows));
+
+      detail::CyclicPmap cyclic_pmap(* GlobalFixture::world, x, y, p_rows, p_cols);
+      detail::LayeredCyclicPmap col_pmap(* GlobalFixture::world, x, y, p_rows, p_cols, 1ul, size, true);
+      detail::LayeredCyclicPmap row_pmap(* GlobalFixture::world, x, y, p_rows, p_cols, 1ul, size, false);
+
+      BOOST_CHECK_EQUAL(col_pmap.local_size(), cyclic_pmap.local_size());
+      BOOST_CHECK_EQUAL(row_pmap.local_size(), cyclic_pmap.local_size());
+      for(std::size_t tile = 0ul; tile < x * y; ++tile) {
+        BOOST_CHECK_EQUAL(col_pmap.owner(tile), cyclic_pmap.owner(tile));
+        BOOST_CHECK_EQUAL(row_pmap.owner(tile), cyclic_pmap.owner(tile));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t size = GlobalFixture::world->size();
+
+  for(std::size_t layers = 1ul; layers <= size; ++layers) {
+    const std::size_t layer_size = size / layers;
+    for(std::size_t x = layers; x < 10ul; ++x) {
+      for(std::size_t y = layers; y < 10ul; ++y) {
+        const std::size_t p_rows = std::max<std::size_t>(1ul, std::min(x, layer_size));
+        const std::size_t p_cols = std::max<std::size_t>(1ul, std::min(y, layer_size / p_rows));
+
+        // Columns are layered
+        detail::LayeredCyclicPmap col_pmap(* GlobalFixture::world, x, y, p_rows,
+            p_cols, layers, layer_size, true);
+        // Rows are layered
+        detail::LayeredCyclicPmap row_pmap(* GlobalFixture::world, x, y, p_rows,
+            p_cols, layers, layer_size, false);
+
+        for(std::size_t tile = 0ul; tile < x * y; ++tile) {
+          const std::size_t i = tile / y, j = tile % y;
+          const std::size_t grid_proc = (i % p_rows) * p_cols + (j % p_cols);
+
+          BOOST_CHECK_EQUAL(col_pmap.owner(tile),
+              detail::LayeredCyclicPmap::layer_of(j, y, layers) * layer_size + grid_proc);
+          BOOST_CHECK_EQUAL(row_pmap.owner(tile),
+              detail::LayeredCyclicPmap::layer_of(i, x, layers) * layer_size + grid_proc);
+          BOOST_CHECK_LT(col_pmap.owner(tile), size);
+          BOOST_CHECK_LT(row_pmap.owner(tile), size);
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  const std::size_t size = GlobalFixture::world->size();
+  ProcessID tile_owners[100];
+
+  for(std::size_t layers = 1ul; layers <= size; ++layers) {
+    const std::size_t layer_size = size / layers;
+    for(std::size_t x = layers; x < 10ul; ++x) {
+      for(std::size_t y = layers; y < 10ul; ++y) {
+        const std::size_t p_rows = std::max<std::size_t>(1ul, std::min(x, layer_size));
+        const std::size_t p_cols = std::max<std::size_t>(1ul, std::min(y, layer_size / p_rows));
+        const std::size_t tiles = x * y;
+
+        for(int layer_cols = 0; layer_cols < 2; ++layer_cols) {
+          detail::LayeredCyclicPmap pmap(* GlobalFixture::world, x, y, p_rows,
+              p_cols, layers, layer_size, layer_cols);
+
+          // Check that all local elements map to this rank
+          for(detail::LayeredCyclicPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it)
+            BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+
+          // Check that every tile is in exactly one local group
+          std::size_t total_size = pmap.local_size();
+          GlobalFixture::world->gop.sum(total_size);
+          BOOST_CHECK_EQUAL(total_size, tiles);
+
+          std::fill_n(tile_owners, tiles, 0);
+          for(detail::LayeredCyclicPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it)
+            tile_owners[*it] += GlobalFixture::world->rank();
+
+          GlobalFixture::world->gop.sum(tile_owners, tiles);
+          for(std::size_t tile = 0; tile < tiles; ++tile)
+            BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/tensor/low_rank_tensor.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct LowRankTensorFixture {
+  typedef LowRankTensor<double> tile_type;
+
+  LowRankTensorFixture() : a(Range(20, 30)), b(Range(30, 10)), f(Range(20, 30)) {
+    // a and b have rank 2; f has full rank
+    for(std::size_t i = 0ul; i < 20ul; ++i)
+      for(std::size_t j = 0ul; j < 30ul; ++j) {
+        a(i, j) = double(i + 1) * double(j % 7) + std::cos(double(i)) * double(j);
+        f(i, j) = double((i * 31 + j * 17) % 13) + (i == j ? 10.0 : 0.0);
+      }
+    for(std::size_t i = 0ul; i < 30ul; ++i)
+      for(std::size_t j = 0ul; j < 10ul; ++j)
+        b(i, j) = double(i) - 2.0 * double(j) + double(i * j);
+  }
+
+  static void check_equal(const Tensor<double>& x, const Tensor<double>& y) {
+    BOOST_REQUIRE_EQUAL(x.range(), y.range());
+    for(std::size_t i = 0ul; i < x.size(); ++i)
+      BOOST_CHECK_CLOSE_FRACTION(x[i], y[i], 1.0e-8);
+  }
+
+  Tensor<double> a;
+  Tensor<double> b;
+  Tensor<double> f;
+};
+
+BOOST_FIXTURE_TEST_SUITE( low_rank_tensor_suite, LowRankTensorFixture )
+
+BOOST_AUTO_TEST_CASE( compress )
+{
+  const tile_type la(a);
+  BOOST_CHECK(! la.is_dense());
+  BOOST_CHECK_EQUAL(la.rank(), 2ul);
+  check_equal(la.to_dense(), a);
+  BOOST_CHECK_CLOSE(la.norm(), a.norm(), 1.0e-8);
+  BOOST_CHECK_CLOSE(la.sum(), a.sum(), 1.0e-8);
+
+  const tile_type lf(f);
+  BOOST_CHECK(lf.is_dense());
+  check_equal(lf.to_dense(), f);
+
+  const tile_type z(Range(20, 30));
+  BOOST_CHECK_EQUAL(z.rank(), 0ul);
+  BOOST_CHECK_EQUAL(z.norm(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( arithmetic )
+{
+  const tile_type la(a), lf(f);
+
+  // Low-rank sums are recompressed
+  const tile_type sum = la.add(la.scale(2.0));
+  BOOST_CHECK_EQUAL(sum.rank(), 2ul);
+  check_equal(sum.to_dense(), a.scale(3.0));
+  BOOST_CHECK_LT(la.subt(la).norm(), 1.0e-8 * a.norm());
+
+  check_equal(la.add(lf).to_dense(), a.add(f));
+  BOOST_CHECK_CLOSE(la.dot(lf), a.dot(f), 1.0e-8);
+  BOOST_CHECK_CLOSE(la.dot(la), a.dot(a), 1.0e-8);
+
+  const Permutation transpose({1, 0});
+  const tile_type lt = la.permute(transpose);
+  BOOST_CHECK_EQUAL(lt.rank(), 2ul);
+  check_equal(lt.to_dense(), a.permute(transpose));
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  const tile_type la(a), lb(b), lf(f);
+  const math::GemmHelper nn(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, 2u, 2u);
+  const Tensor<double> ab = a.gemm(b, 2.0, nn);
+
+  const tile_type lab = la.gemm(lb, 2.0, nn);
+  BOOST_CHECK(! lab.is_dense());
+  BOOST_CHECK_LE(lab.rank(), 2ul);
+  check_equal(lab.to_dense(), ab);
+
+  // Mixed dense and low-rank arguments
+  check_equal(lf.gemm(lb, 2.0, nn).to_dense(), f.gemm(b, 2.0, nn));
+
+  // Transposed arguments
+  const math::GemmHelper nt(madness::cblas::NoTrans, madness::cblas::Trans,
+      2u, 2u, 2u);
+  check_equal(la.gemm(lf, 1.0, nt).to_dense(), a.gemm(f, 1.0, nt));
+
+  // Accumulation
+  tile_type c = lab;
+  c.gemm(la, lb, 1.0, nn);
+  check_equal(c.to_dense(), ab.scale(1.5));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -24,6 +24,7 @@
  */
 
 #include "TiledArray/math/blas.h"
+#include "TiledArray/math/parallel_gemm.h"
 #include "tiledarray.h"
 #include "unit_test_config.h"
 
@@ -350,4 +351,209 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( complex_gemm_ld , T, floating_point_types )
   delete [] c;
 }
 
+BOOST_AUTO_TEST_CASE( mixed_precision_gemm )
+{
+  std::vector<float> a(m * k), b(k * n);
+  std::vector<double> c(m * n), expected(m * n);
+  rand_fill(a.data(), m * k, 29);
+  rand_fill(b.data(), k * n, 47);
+
+  const madness::cblas::CBLAS_TRANSPOSE ops[2] =
+      { madness::cblas::NoTrans, madness::cblas::Trans };
+  for(auto op_a : ops) {
+    for(auto op_b : ops) {
+      rand_fill(c.data(), m * n, 99);
+      const integer lda = (op_a == madness::cblas::NoTrans ? k : m);
+      const integer ldb = (op_b == madness::cblas::NoTrans ? n : k);
+      for(integer i = 0; i < m; ++i) {
+        for(integer j = 0; j < n; ++j) {
+          double value = 0.0;
+          for(integer x = 0; x < k; ++x)
+            value += double(op_a == madness::cblas::NoTrans ? a[i * lda + x] : a[x * lda + i])
+                * double(op_b == madness::cblas::NoTrans ? b[x * ldb + j] : b[j * ldb + x]);
+          expected[i * n + j] = 3.0 * value + 2.0 * c[i * n + j];
+        }
+      }
+
+      // Float arguments are accumulated into a double result
+      BOOST_REQUIRE_NO_THROW(TiledArray::math::gemm(op_a, op_b, m, n, k, 3.0,
+          a.data(), lda, b.data(), ldb, 2.0, c.data(), n));
+      for(integer i = 0; i < m * n; ++i)
+        BOOST_CHECK_CLOSE(c[i], expected[i], tol);
+    }
+  }
+
+  // The sum is not rounded to single precision
+  const float x[2] = { 16777216.0f, 1.0f }, y[2] = { 1.0f, 1.0f };
+  double z = 0.0;
+  TiledArray::math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      1, 1, 2, 1.0, x, 2, y, 1, 0.0, &z, 1);
+  BOOST_CHECK_EQUAL(z, 16777217.0);
+}
+
+BOOST_AUTO_TEST_CASE( syrk )
+{
+  using namespace TiledArray::math;
+  // Several blocks, where the last block is smaller than the others
+  const integer n = 3 * syrk_block_size() + 5, k = 7;
+  std::vector<double> a(n * k), c(n * n), expected(n * n);
+  rand_fill(a.data(), a.size(), 29);
+
+  const madness::cblas::CBLAS_TRANSPOSE ops[] = { madness::cblas::NoTrans,
+      madness::cblas::Trans };
+  for(const auto op_a : ops) {
+    const auto op_b = (op_a == madness::cblas::NoTrans ?
+        madness::cblas::Trans : madness::cblas::NoTrans);
+    const integer lda = (op_a == madness::cblas::NoTrans ? k : n);
+
+    // The accumulated matrix need not be symmetric
+    rand_fill(c.data(), c.size(), 99);
+    expected = c;
+    gemm(op_a, op_b, n, n, k, 3.0, a.data(), lda, a.data(), lda, 2.0,
+        expected.data(), n);
+    TiledArray::math::syrk(op_a, n, k, 3.0, a.data(), lda, 2.0, c.data(), n);
+    for(integer i = 0; i < n * n; ++i)
+      BOOST_CHECK_CLOSE(c[i], expected[i], tol);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( small_gemm )
+{
+  using namespace TiledArray::math;
+  // Column count with panels of 8, 4, and 1 columns
+  const integer sm = 5, sn = 13, sk = 7;
+  std::vector<double> a(sm * sk), b(sk * sn), c(sm * sn), expected(sm * sn);
+  rand_fill(a.data(), a.size(), 29);
+  rand_fill(b.data(), b.size(), 47);
+
+  const integer extent = small_gemm_max_extent();
+  const madness::cblas::CBLAS_TRANSPOSE ops[] = { madness::cblas::NoTrans,
+      madness::cblas::Trans };
+  for(const auto op_a : ops) {
+    for(const auto op_b : ops) {
+      const integer lda = (op_a == madness::cblas::NoTrans ? sk : sm);
+      const integer ldb = (op_b == madness::cblas::NoTrans ? sn : sk);
+      rand_fill(c.data(), c.size(), 99);
+      expected = c;
+
+      // The reference is computed by BLAS
+      small_gemm_max_extent() = 0;
+      gemm(op_a, op_b, sm, sn, sk, 3.0, a.data(), lda, b.data(), ldb, 2.0,
+          expected.data(), sn);
+      BOOST_CHECK(! TiledArray::math::small_gemm(op_a, op_b, sm, sn, sk, 3.0,
+          a.data(), lda, b.data(), ldb, 2.0, c.data(), sn));
+
+      small_gemm_max_extent() = extent;
+      BOOST_CHECK(TiledArray::math::small_gemm(op_a, op_b, sm, sn, sk, 3.0,
+          a.data(), lda, b.data(), ldb, 2.0, c.data(), sn));
+      for(integer i = 0; i < sm * sn; ++i)
+        BOOST_CHECK_CLOSE(c[i], expected[i], tol);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( large_gemm )
+{
+  using namespace TiledArray::math;
+  const integer extent = small_gemm_max_extent();
+  small_gemm_max_extent() = 32;
+
+  // m * n * k is 2^32, which wraps to zero in a 32-bit integer
+  BOOST_CHECK(is_small_gemm(32, 32, 32));
+  BOOST_CHECK(! is_small_gemm(1024, 1024, 4096));
+  BOOST_CHECK(! is_small_gemm(2048, 2048, 2048));
+
+  // The smallest product above the bound
+  const integer lm = 33, ln = 32, lk = 32;
+  BOOST_CHECK(! is_small_gemm(lm, ln, lk));
+  std::vector<double> a(lm * lk), b(lk * ln), c(lm * ln, 0.0);
+  rand_fill(a.data(), a.size(), 29);
+  rand_fill(b.data(), b.size(), 47);
+
+  // The small-matrix kernels reject the product, so gemm uses BLAS
+  BOOST_CHECK(! TiledArray::math::small_gemm(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, lm, ln, lk, 1.0, a.data(), lk, b.data(), ln,
+      0.0, c.data(), ln));
+  gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, lm, ln, lk, 1.0,
+      a.data(), lk, b.data(), ln, 0.0, c.data(), ln);
+  for(integer i = 0; i < lm; ++i) {
+    for(integer j = 0; j < ln; ++j) {
+      double expected = 0.0;
+      for(integer x = 0; x < lk; ++x)
+        expected += a[i * lk + x] * b[x * ln + j];
+      BOOST_CHECK_CLOSE(c[i * ln + j], expected, tol);
+    }
+  }
+
+  small_gemm_max_extent() = extent;
+}
+
+BOOST_AUTO_TEST_CASE( blas_threads )
+{
+  using TiledArray::math::BlasThreads;
+  const int budget = BlasThreads::budget();
+
+  TiledArray::set_blas_thread_policy(TiledArray::BlasThreadPolicy::adaptive, 1.0e6);
+  // Small products, and products with busy cores, are single-threaded
+  BOOST_CHECK_EQUAL(BlasThreads::threads(1.0e5, 0, 0ul), 1);
+  BOOST_CHECK_EQUAL(BlasThreads::threads(1.0e12, budget, 0ul), 1);
+  BOOST_CHECK_EQUAL(BlasThreads::threads(1.0e12, 0, std::size_t(budget)), 1);
+  // A large product with idle cores uses them
+  BOOST_CHECK_EQUAL(BlasThreads::threads(1.0e12, 0, 0ul), budget);
+  BOOST_CHECK_EQUAL(BlasThreads::threads(2.0e6, 0, 0ul), std::min(budget, 2));
+
+  TiledArray::set_blas_thread_policy(TiledArray::BlasThreadPolicy::single);
+  BOOST_CHECK_EQUAL(BlasThreads::threads(1.0e12, 0, 0ul), 1);
+
+  TiledArray::set_blas_thread_policy(TiledArray::BlasThreadPolicy::adaptive);
+}
+
+BOOST_AUTO_TEST_CASE( parallel_gemm )
+{
+  using namespace TiledArray::math;
+  std::vector<double> a(m * k), b(k * n), c(m * n), expected(m * n);
+  rand_fill(a.data(), a.size(), 29);
+  rand_fill(b.data(), b.size(), 47);
+
+  // Split every product, whatever the number of idle threads
+  set_parallel_gemm_cache_bytes(0ul);
+  TiledArray::set_blas_thread_policy(TiledArray::BlasThreadPolicy::adaptive, 1.0);
+
+  const madness::cblas::CBLAS_TRANSPOSE ops[] = { madness::cblas::NoTrans,
+      madness::cblas::Trans };
+  for(const auto op_a : ops) {
+    for(const auto op_b : ops) {
+      const integer lda = (op_a == madness::cblas::NoTrans ? k : m);
+      const integer ldb = (op_b == madness::cblas::NoTrans ? n : k);
+      rand_fill(c.data(), c.size(), 99);
+      expected = c;
+      gemm(op_a, op_b, m, n, k, 3.0, a.data(), lda, b.data(), ldb, 2.0,
+          expected.data(), n);
+      parallel_gemm(op_a, op_b, m, n, k, 3.0, a.data(), lda, b.data(), ldb, 2.0,
+          c.data(), n);
+      for(integer i = 0; i < m * n; ++i)
+        BOOST_CHECK_CLOSE(c[i], expected[i], tol);
+
+      // Blocks computed by the calling thread alone
+      TiledArray::detail::ParallelGemmBlocks<double, double, double, double, double> blocks;
+      blocks.op_a = op_a; blocks.op_b = op_b;
+      blocks.m = m; blocks.n = n; blocks.k = k;
+      blocks.alpha = 3.0; blocks.a = a.data(); blocks.lda = lda;
+      blocks.b = b.data(); blocks.ldb = ldb;
+      blocks.beta = 0.0; blocks.c = c.data(); blocks.ldc = n;
+      blocks.block_rows = 4; blocks.block_cols = 3;
+      blocks.next = 0; blocks.done = 0;
+      blocks.run();
+      BOOST_CHECK_EQUAL(blocks.done.load(), 12);
+      gemm(op_a, op_b, m, n, k, 3.0, a.data(), lda, b.data(), ldb, 0.0,
+          expected.data(), n);
+      for(integer i = 0; i < m * n; ++i)
+        BOOST_CHECK_CLOSE(c[i], expected[i], tol);
+    }
+  }
+
+  set_parallel_gemm_cache_bytes(1ul << 20);
+  TiledArray::set_blas_thread_policy(TiledArray::BlasThreadPolicy::adaptive);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
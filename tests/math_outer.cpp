@@ -334,4 +334,45 @@ BOOST_AUTO_TEST_CASE( outer_and_fill_small_left_right )
 
 }
 
+BOOST_AUTO_TEST_CASE( outer_serial )
+{
+  // Check that the blocked kernel agrees with the vectorized kernel
+  std::vector<int> reference = result;
+  TiledArray::math::outer_serial(left.size(), right.size(), & left.front(),
+      & right.front(), & reference.front(), &OuterFixture::add_subt);
+  TiledArray::math::outer(left.size(), right.size(), & left.front(),
+      & right.front(), & result.front(), &OuterFixture::add_subt);
+
+  for(std::size_t i = 0ul; i < result.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], reference[i]);
+}
+
+BOOST_AUTO_TEST_CASE( outer_large )
+{
+  // Compute an outer product that is split across threads
+  const std::size_t m = 397ul, n = 211ul;
+  BOOST_CHECK_GE(m * n, TiledArray::math::parallel_matrix_min_size);
+  std::vector<int> x(m), y(n), a(m * n, 3), b(m * n, 0);
+  rand_fill(x, 11);
+  rand_fill(y, 12);
+
+  TiledArray::math::outer(m, n, & x.front(), & y.front(), & a.front(),
+      &OuterFixture::add_subt);
+  for(std::size_t i = 0ul; i < m; ++i)
+    for(std::size_t j = 0ul; j < n; ++j)
+      BOOST_CHECK_EQUAL(a[i * n + j], 3 + x[i] - y[j]);
+
+  TiledArray::math::outer_fill(m, n, & x.front(), & y.front(), & a.front(),
+      & b.front(), &OuterFixture::add_subt);
+  for(std::size_t i = 0ul; i < m; ++i)
+    for(std::size_t j = 0ul; j < n; ++j)
+      BOOST_CHECK_EQUAL(b[i * n + j], 3 + 2 * (x[i] - y[j]));
+
+  TiledArray::math::outer_fill(m, n, & x.front(), & y.front(), & b.front(),
+      &OuterFixture::subt);
+  for(std::size_t i = 0ul; i < m; ++i)
+    for(std::size_t j = 0ul; j < n; ++j)
+      BOOST_CHECK_EQUAL(b[i * n + j], x[i] - y[j]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -151,4 +151,48 @@ BOOST_AUTO_TEST_CASE( binary_col_reduce )
   }
 }
 
+BOOST_AUTO_TEST_CASE( serial_col_reduce )
+{
+  // Check that the blocked kernel agrees with the vectorized kernel
+  int y_ref[n];
+  std::copy(y, y + n, y_ref);
+
+  math::col_reduce_serial(m, n, a, x, y_ref, MultSum());
+  math::col_reduce(m, n, a, x, y, MultSum());
+
+  for(std::size_t j = 0ul; j < n; ++j)
+    BOOST_CHECK_EQUAL(y[j], y_ref[j]);
+}
+
+BOOST_AUTO_TEST_CASE( large_partial_reduce )
+{
+  // Reduce a matrix that is split across threads
+  const std::size_t M = 301ul, N = 263ul;
+  BOOST_CHECK_GE(M * N, math::parallel_matrix_min_size);
+  std::vector<int> A(M * N), X(M), Y(N);
+  for(std::size_t i = 0ul; i < A.size(); ++i)
+    A[i] = int(i % 7ul) - 3;
+  for(std::size_t i = 0ul; i < M; ++i)
+    X[i] = int(i % 5ul);
+  for(std::size_t j = 0ul; j < N; ++j)
+    Y[j] = int(j % 3ul);
+
+  std::vector<int> row(M, 1), col(N, 2);
+  math::row_reduce(M, N, A.data(), Y.data(), row.data(), MultSum());
+  math::col_reduce(M, N, A.data(), X.data(), col.data(), MultSum());
+
+  for(std::size_t i = 0ul; i < M; ++i) {
+    int expected = 1;
+    for(std::size_t j = 0ul; j < N; ++j)
+      expected += A[i * N + j] * Y[j];
+    BOOST_CHECK_EQUAL(row[i], expected);
+  }
+  for(std::size_t j = 0ul; j < N; ++j) {
+    int expected = 2;
+    for(std::size_t i = 0ul; i < M; ++i)
+      expected += A[i * N + j] * X[i];
+    BOOST_CHECK_EQUAL(col[j], expected);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  math_random.cpp
+ *  October 15, 2026
+ *
+ */
+
+#include "TiledArray/math/random.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+BOOST_AUTO_TEST_SUITE( math_random_suite )
+
+BOOST_AUTO_TEST_CASE( philox )
+{
+  // Known answer of Philox4x32-10 for a zero counter and key
+  const std::uint64_t bits = 0x6627e8d5e169c58dul;
+  BOOST_CHECK_EQUAL(math::philox_uniform(0ul, 0ul),
+      double(bits >> 11) * (1.0 / 9007199254740992.0));
+
+  std::vector<double> a(37ul);
+  math::random_fill(a.size(), 5ul, 100ul, a.data());
+  for(std::size_t i = 0ul; i < a.size(); ++i) {
+    BOOST_CHECK_EQUAL(a[i], math::philox_uniform(5ul, 100ul + i));
+    BOOST_CHECK_GE(a[i], 0.0);
+    BOOST_CHECK_LT(a[i], 1.0);
+  }
+  BOOST_CHECK_NE(math::philox_uniform(5ul, 100ul), math::philox_uniform(6ul, 100ul));
+}
+
+BOOST_AUTO_TEST_CASE( fill_random )
+{
+  World& world = *GlobalFixture::world;
+  const TiledRange1 tr1{0, 3, 8, 10, 16}, tr2{0, 7, 16};
+  TArrayD a(world, TiledRange{ tr1, tr2, tr1 }), b(world, TiledRange{ tr2, tr1, tr2 });
+
+  // The elements only depend on the seed, and not on the tiling
+  a.fill_random(false, 11ul);
+  b.fill_random(false, 11ul);
+  const Range elements = a.trange().elements_range();
+  for(TArrayD::const_iterator it = a.begin(); it != a.end(); ++it) {
+    const TArrayD::value_type tile = *it;
+    for(const auto& index : tile.range()) {
+      const double value = tile[index];
+      BOOST_CHECK_EQUAL(value, math::philox_uniform(11ul, elements.ordinal(index)));
+      BOOST_CHECK_EQUAL(value, b.find(b.trange().element_to_tile(index)).get()[index]);
+    }
+  }
+
+  // Successive fills differ
+  TArrayD c(world, a.trange()), d(world, a.trange());
+  c.fill_random();
+  d.fill_random();
+  double diff = 0.0;
+  for(TArrayD::const_iterator it = c.begin(); it != c.end(); ++it) {
+    const TArrayD::value_type tile = *it;
+    const TArrayD::value_type other = d.find(it.index()).get();
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      diff += std::abs(tile[i] - other[i]);
+  }
+  world.gop.sum(diff);
+  BOOST_CHECK_GT(diff, 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( fill_random_tile )
+{
+  // Tiles that are not TiledArray::Tensor objects get the same elements
+  World& world = *GlobalFixture::world;
+  const TiledRange1 tr1{0, 3, 8, 10, 16};
+  typedef DistArray<Tile<TensorD>, DensePolicy> TileArray;
+  TArrayD a(world, TiledRange{ tr1, tr1 });
+  TileArray b(world, a.trange());
+  a.fill_random(false, 5ul);
+  b.fill_random(false, 5ul);
+
+  for(TileArray::const_iterator it = b.begin(); it != b.end(); ++it) {
+    const TileArray::value_type tile = *it;
+    const TArrayD::value_type ref_tile = a.find(it.index()).get();
+    BOOST_REQUIRE_EQUAL(tile.range(), ref_tile.range());
+    for(std::size_t i = 0ul; i < ref_tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -154,4 +154,40 @@ BOOST_AUTO_TEST_CASE( binary )
   delete [] b;
   delete [] c;
 }
+BOOST_AUTO_TEST_CASE( blocked )
+{
+  // Matrices that span several cache blocks, with partial edge blocks
+  const std::size_t tile = TiledArray::math::TransposeTile::value;
+  const std::size_t m = 2ul * tile + 5ul;
+  const std::size_t n = 3ul * tile + 3ul;
+  const std::size_t mn = m * n;
+
+  std::vector<int> a(mn);
+  std::vector<int> b(mn);
+
+  GlobalFixture::world->srand(1764);
+  for(std::size_t i = 0ul; i < mn; ++i)
+    a[i] = GlobalFixture::world->rand() % 42;
+
+  const auto no_op = [] (const int& a) -> const int& { return a; };
+  const auto copy_op = [] (int* b, const int a) { *b = a; };
+
+  for(std::size_t x = tile - 1ul; x <= m; x += tile / 2ul + 1ul) {
+    for(std::size_t y = tile - 1ul; y <= n; y += tile / 2ul + 1ul) {
+      std::fill(b.begin(), b.end(), 0);
+
+      TiledArray::math::transpose(no_op, copy_op, x, y, m, b.data(), n, a.data());
+
+      for(std::size_t i = 0ul; i < m; ++i) {
+        for(std::size_t j = 0ul; j < n; ++j) {
+          if((i < x) && (j < y)) {
+            BOOST_CHECK_EQUAL(b[j * m + i], a[i * n + j]);
+          } else {
+            BOOST_CHECK_EQUAL(b[j * m + i], 0);
+          }
+        }
+      }
+    }
+  }
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2014  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/math/vector_op.h"
+#include "unit_test_config.h"
+#include <complex>
+#include <limits>
+
+struct VectorOpFixture {
+
+  VectorOpFixture() :
+    // Sizes that are not a multiple of the block size exercise the tail loop
+    left(TILEDARRAY_LOOP_UNWIND * 37 + 3, 0.0),
+    right(left.size(), 0.0),
+    result(left.size(), 0.0)
+  {
+    rand_fill(left, 23);
+    rand_fill(right, 42);
+    rand_fill(result, 79);
+  }
+
+  ~VectorOpFixture() { }
+
+  static void rand_fill(std::vector<double>& vec, const int seed) {
+    GlobalFixture::world->srand(seed);
+    for(std::size_t i = 0ul; i < vec.size(); ++i)
+      vec[i] = GlobalFixture::world->rand() % 101;
+  }
+
+  std::vector<double> left;
+  std::vector<double> right;
+  std::vector<double> result;
+}; // VectorOpFixture
+
+BOOST_FIXTURE_TEST_SUITE( math_vector_op_suite, VectorOpFixture )
+
+BOOST_AUTO_TEST_CASE( simd_traits )
+{
+  BOOST_CHECK((TiledArray::math::is_simd_vectorizable<double, float, int>::value));
+  BOOST_CHECK((! TiledArray::math::is_simd_vectorizable<double,
+      std::complex<double> >::value));
+
+  // The run-time instruction set is never narrower than the baseline
+  BOOST_CHECK(TiledArray::math::simd_isa() >=
+      TiledArray::math::compiled_simd_isa());
+}
+
+BOOST_AUTO_TEST_CASE( vector_op )
+{
+  TiledArray::math::vector_op([] (const double l, const double r)
+      { return l * r + 1.0; }, left.size(), result.data(), left.data(),
+      right.data());
+
+  for(std::size_t i = 0ul; i < result.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], left[i] * right[i] + 1.0);
+}
+
+BOOST_AUTO_TEST_CASE( inplace_vector_op )
+{
+  const std::vector<double> reference = result;
+
+  TiledArray::math::inplace_vector_op([] (double& res, const double l)
+      { res -= 2.0 * l; }, left.size(), result.data(), left.data());
+
+  for(std::size_t i = 0ul; i < result.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], reference[i] - 2.0 * left[i]);
+}
+
+BOOST_AUTO_TEST_CASE( reduce_op )
+{
+  for(std::size_t n = 0ul; n <= left.size(); n += 7ul) {
+    double expected = 3.0;
+    for(std::size_t i = 0ul; i < n; ++i)
+      expected += left[i] * right[i];
+
+    double dot = 3.0;
+    TiledArray::math::reduce_op([] (double& res, const double l, const double r)
+        { res += l * r; }, [] (double& res, const double part) { res += part; },
+        0.0, n, dot, left.data(), right.data());
+
+    // The inputs are integer valued so the reordered sum is exact
+    BOOST_CHECK_EQUAL(dot, expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( compensated_reduce_op )
+{
+  // A plain single precision sum of these terms is off in the third digit
+  const std::vector<float> terms(1ul << 22, 0.1f);
+  double expected = 0.0;
+  for(const float term : terms)
+    expected += term;
+
+  TiledArray::math::CompensatedSum<float> sum;
+  TiledArray::math::compensated_reduce_op([] (const float t) { return t; },
+      terms.size(), sum, terms.data());
+
+  BOOST_CHECK_CLOSE(double(sum.value()), expected,
+      200.0 * std::numeric_limits<float>::epsilon());
+
+  // Joined sums keep their corrections
+  TiledArray::math::CompensatedSum<float> half1, half2;
+  const std::size_t half = terms.size() / 2ul + 3ul;
+  TiledArray::math::compensated_reduce_op([] (const float t) { return t * t; },
+      half, half1, terms.data());
+  TiledArray::math::compensated_reduce_op([] (const float t) { return t * t; },
+      terms.size() - half, half2, terms.data() + half);
+  half1 += half2;
+
+  double expected_squares = 0.0;
+  for(const float term : terms)
+    expected_squares += double(term * term);
+  BOOST_CHECK_CLOSE(double(half1.value()), expected_squares,
+      200.0 * std::numeric_limits<float>::epsilon());
+}
+
+BOOST_AUTO_TEST_CASE( copy_vector )
+{
+  TiledArray::math::copy_vector(left.size(), left.data(), result.data());
+
+  for(std::size_t i = 0ul; i < result.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], left[i]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
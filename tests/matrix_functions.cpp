@@ -0,0 +1,103 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include "TiledArray/algebra/matrix_functions.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct MatrixFunctionsFixture {
+  MatrixFunctionsFixture() :
+    bounds({{0, 3, 7, 12, 15}}), rows(bounds.begin(), bounds.end()),
+    dims({{ rows, rows }}), trange(dims.begin(), dims.end()),
+    n(bounds.back()), s(n, n)
+  {
+    // A banded, diagonally dominant symmetric matrix
+    for(std::size_t i = 0ul; i < n; ++i)
+      for(std::size_t j = 0ul; j < n; ++j)
+        s(i,j) = (i == j ? 2.0 : (std::abs(int(i) - int(j)) < 3 ? 0.2 : 0.0));
+  }
+
+  /// Convert an array to an Eigen matrix on every process
+  static EigenMatrixXd to_matrix(const TArrayD& array) {
+    EigenMatrixXd result = EigenMatrixXd::Zero(
+        array.trange().elements_range().extent(0),
+        array.trange().elements_range().extent(1));
+    for(std::size_t t = 0ul; t < array.size(); ++t) {
+      const TArrayD::value_type tile = array.find(t).get();
+      for(auto it = tile.range().begin(); it != tile.range().end(); ++it)
+        result((*it)[0], (*it)[1]) = tile[*it];
+    }
+    return result;
+  }
+
+  const std::array<std::size_t, 5> bounds;
+  TiledRange1 rows;
+  const std::array<TiledRange1, 2> dims;
+  TiledRange trange;
+  const std::size_t n;
+  EigenMatrixXd s;
+}; // MatrixFunctionsFixture
+
+BOOST_FIXTURE_TEST_SUITE( matrix_functions_suite , MatrixFunctionsFixture )
+
+BOOST_AUTO_TEST_CASE( newton_schulz_sqrt )
+{
+  TArrayD S = eigen_to_array<TArrayD>(*GlobalFixture::world, trange, s, true);
+  TArrayD X;
+  BOOST_REQUIRE_NO_THROW(X = matrix_inverse_sqrt(S));
+
+  const EigenMatrixXd x = to_matrix(X);
+  const EigenMatrixXd identity = EigenMatrixXd::Identity(n, n);
+  BOOST_CHECK_SMALL((x * s * x - identity).norm(), 1.0e-8);
+
+  const EigenMatrixXd r = to_matrix(matrix_sqrt(S));
+  BOOST_CHECK_SMALL((r * r - s).norm(), 1.0e-8);
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( newton_schulz_inverse )
+{
+  TArrayD S = eigen_to_array<TArrayD>(*GlobalFixture::world, trange, s, true);
+  TArrayD X;
+  BOOST_REQUIRE_NO_THROW(X = matrix_inverse(S));
+
+  const EigenMatrixXd x = to_matrix(X);
+  BOOST_CHECK_SMALL((s * x - EigenMatrixXd::Identity(n, n)).norm(), 1.0e-8);
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( exp_diagonal )
+{
+  TArrayD D = diagonal_array<double, DensePolicy>(*GlobalFixture::world,
+      trange, 1.5);
+  const EigenMatrixXd e = to_matrix(matrix_exp(D));
+  BOOST_CHECK_SMALL((e - std::exp(1.5) * EigenMatrixXd::Identity(n, n)).norm(),
+      1.0e-10);
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
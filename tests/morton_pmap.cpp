@@ -0,0 +1,128 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/morton_pmap.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct MortonPmapFixture {
+
+  MortonPmapFixture() { }
+
+};
+
+// =============================================================================
+// MortonPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( morton_pmap_suite, MortonPmapFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  for(std::size_t tiles = 1ul; tiles < 20ul; ++tiles) {
+    Range range(tiles, tiles + 1ul);
+    BOOST_REQUIRE_NO_THROW(TiledArray::detail::MortonPmap pmap(* GlobalFixture::world, range));
+    TiledArray::detail::MortonPmap pmap(* GlobalFixture::world, range);
+    BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+    BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+    BOOST_CHECK_EQUAL(pmap.size(), range.volume());
+  }
+}
+
+BOOST_AUTO_TEST_CASE( order )
+{
+  // The curve visits each quadrant of a 4x4 range before the next one
+  Range range(4ul, 4ul);
+  const std::vector<std::size_t> curve =
+      TiledArray::detail::MortonPmap::order(range);
+  const std::vector<std::size_t> expected =
+      { 0ul, 1ul, 4ul, 5ul, 2ul, 3ul, 6ul, 7ul,
+        8ul, 9ul, 12ul, 13ul, 10ul, 11ul, 14ul, 15ul };
+  BOOST_CHECK_EQUAL_COLLECTIONS(curve.begin(), curve.end(),
+      expected.begin(), expected.end());
+
+  // Each tile of a range that is not a power of two is visited once
+  Range range3(std::vector<std::size_t>{ 1ul, 2ul, 0ul },
+      std::vector<std::size_t>{ 6ul, 5ul, 7ul });
+  std::vector<std::size_t> curve3 = TiledArray::detail::MortonPmap::order(range3);
+  std::sort(curve3.begin(), curve3.end());
+  for(std::size_t i = 0ul; i < range3.volume(); ++i)
+    BOOST_CHECK_EQUAL(curve3[i], i);
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t rank = GlobalFixture::world->rank();
+  const std::size_t size = GlobalFixture::world->size();
+
+  ProcessID* p_owner = new ProcessID[size];
+
+  // Check various pmap sizes
+  for(std::size_t tiles = 1ul; tiles < 20ul; ++tiles) {
+    Range range(tiles, tiles + 1ul);
+    TiledArray::detail::MortonPmap pmap(* GlobalFixture::world, range);
+
+    for(std::size_t tile = 0; tile < range.volume(); ++tile) {
+      std::fill_n(p_owner, size, 0);
+      p_owner[rank] = pmap.owner(tile);
+      // check that the value is in range
+      BOOST_CHECK_LT(p_owner[rank], size);
+      GlobalFixture::world->gop.sum(p_owner, size);
+
+      // Make sure everyone agrees on who owns what.
+      for(std::size_t p = 0ul; p < size; ++p)
+        BOOST_CHECK_EQUAL(p_owner[p], p_owner[rank]);
+    }
+  }
+
+  delete [] p_owner;
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[400];
+
+  for(std::size_t tiles = 1ul; tiles < 20ul; ++tiles) {
+    Range range(tiles, tiles + 1ul);
+    TiledArray::detail::MortonPmap pmap(* GlobalFixture::world, range);
+
+    // Check that all local elements map to this rank, in ascending order
+    for(detail::MortonPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+      BOOST_CHECK(pmap.is_local(*it));
+    }
+    BOOST_CHECK(std::is_sorted(pmap.begin(), pmap.end()));
+
+    std::fill_n(tile_owners, range.volume(), 0);
+    for(detail::MortonPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      tile_owners[*it] += GlobalFixture::world->rank();
+    }
+
+    GlobalFixture::world->gop.sum(tile_owners, range.volume());
+    for(std::size_t tile = 0; tile < range.volume(); ++tile) {
+      BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+    }
+
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
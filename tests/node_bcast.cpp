@@ -0,0 +1,73 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/dist_eval/node_bcast.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using TiledArray::detail::NodeMap;
+using TiledArray::detail::NodeBcast;
+
+BOOST_AUTO_TEST_SUITE( node_bcast_suite )
+
+BOOST_AUTO_TEST_CASE( node_map )
+{
+  std::shared_ptr<NodeMap> map = NodeMap::instance(*GlobalFixture::world);
+  BOOST_REQUIRE(map);
+
+  // The same map is returned for the same world
+  BOOST_CHECK_EQUAL(NodeMap::instance(*GlobalFixture::world).get(), map.get());
+
+  // Each process is mapped to the lowest ranked process on its node
+  for(ProcessID p = 0; p < GlobalFixture::world->size(); ++p) {
+    const ProcessID leader = map->leader(p);
+    BOOST_CHECK_LE(leader, p);
+    BOOST_CHECK_EQUAL(map->leader(leader), leader);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( bcast )
+{
+  TiledArray::World& world = *GlobalFixture::world;
+  std::shared_ptr<NodeMap> map = NodeMap::instance(world);
+
+  // Construct a group of all processes
+  std::vector<ProcessID> procs(world.size());
+  for(ProcessID p = 0; p < world.size(); ++p)
+    procs[p] = p;
+  const madness::uniqueidT id = world.unique_obj_id();
+  madness::Group group(world, procs, madness::DistributedID(id, 0ul));
+
+  // Broadcast from each process in turn
+  for(ProcessID root = 0; root < world.size(); ++root) {
+    NodeBcast node_bcast(world, *map, group, group.rank(root), id,
+        1ul + root * (world.size() + 1ul));
+
+    TiledArray::Future<int> value;
+    if(world.rank() == root)
+      value.set(42 + root);
+    node_bcast.bcast(world, madness::DistributedID(id, 2ul * root),
+        madness::DistributedID(id, 2ul * root + 1ul), value);
+    BOOST_CHECK_EQUAL(value.get(), 42 + root);
+  }
+
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,112 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/out_of_core.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct OutOfCoreFixture {
+  typedef Tensor<double> TensorD;
+  typedef OutOfCoreTile<TensorD> TileD;
+
+  OutOfCoreFixture() :
+    bytes(16ul * sizeof(double)),
+    world(*GlobalFixture::world),
+    store(std::make_shared<TileStore>(world, ".", 2ul * bytes))
+  { }
+
+  static TensorD make_tensor(const double value) {
+    return TensorD(Range(4, 4), value);
+  }
+
+  const std::size_t bytes; ///< The size of the tensor data
+  World& world;
+  std::shared_ptr<TileStore> store;
+};
+
+BOOST_FIXTURE_TEST_SUITE( out_of_core_suite, OutOfCoreFixture )
+
+BOOST_AUTO_TEST_CASE( lazy_tile )
+{
+  BOOST_CHECK(is_lazy_tile<TileD>::value);
+  BOOST_CHECK((std::is_same<eval_trait<TileD>::type, TensorD>::value));
+  BOOST_CHECK(eval_trait<TileD>::nonblocking);
+}
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  TileD t(store, make_tensor(1.0));
+  BOOST_CHECK(! t.empty());
+  BOOST_CHECK(t.is_resident());
+  BOOST_CHECK_EQUAL(t.range(), Range(4, 4));
+  BOOST_CHECK_EQUAL(store->resident_bytes(), bytes);
+  BOOST_CHECK_EQUAL(store->bytes_written(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( spill_and_read )
+{
+  // The store holds two tiles, so the first tile is spilled
+  TileD t1(store, make_tensor(1.0));
+  TileD t2(store, make_tensor(2.0));
+  TileD t3(store, make_tensor(3.0));
+  BOOST_CHECK(! t1.is_resident());
+  BOOST_CHECK(t2.is_resident());
+  BOOST_CHECK(t3.is_resident());
+  BOOST_CHECK_EQUAL(store->resident_bytes(), 2ul * bytes);
+  BOOST_CHECK_EQUAL(store->bytes_written(), bytes);
+
+  // Reading the first tile spills the least recently used tile
+  const TensorD tensor = static_cast<Future<TensorD> >(t1).get();
+  BOOST_CHECK_EQUAL(tensor, make_tensor(1.0));
+  BOOST_CHECK(t1.is_resident());
+  BOOST_CHECK(! t2.is_resident());
+  BOOST_CHECK_EQUAL(store->bytes_read(), bytes);
+  BOOST_CHECK_EQUAL(store->bytes_written(), 2ul * bytes);
+  BOOST_CHECK_GE(store->read_bandwidth(), 0.0);
+  BOOST_CHECK_GE(store->write_bandwidth(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( residency_limit )
+{
+  TileD t1(store, make_tensor(1.0));
+  TileD t2(store, make_tensor(2.0));
+
+  // No tile is resident with a zero limit
+  store->max_resident_bytes(0ul);
+  BOOST_CHECK(! t1.is_resident());
+  BOOST_CHECK(! t2.is_resident());
+  BOOST_CHECK_EQUAL(store->resident_bytes(), 0ul);
+
+  // Reading a tile does not write it again
+  BOOST_CHECK_EQUAL(static_cast<Future<TensorD> >(t2).get(), make_tensor(2.0));
+  BOOST_CHECK(! t2.is_resident());
+  BOOST_CHECK_EQUAL(store->bytes_written(), 2ul * bytes);
+}
+
+BOOST_AUTO_TEST_CASE( destructor )
+{
+  {
+    TileD t(store, make_tensor(1.0));
+  }
+  BOOST_CHECK_EQUAL(store->resident_bytes(), 0ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,144 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/tensor/packed_tensor.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct PackedTensorFixture {
+  typedef PackedTensor<double> tile_type;
+  typedef tile_type::pairs_type pairs_type;
+
+  PackedTensorFixture() :
+    a(make_antisymmetric(Range(5, 5), 1u)), b(make_antisymmetric(Range(5, 5), 2u)),
+    c(make_antisymmetric(Range(4, 4, 3, 3), 3u)), f(Range(5, 6))
+  {
+    for(std::size_t i = 0ul; i < f.size(); ++i)
+      f[i] = double((i * 7) % 11) - 4.5;
+  }
+
+  /// \return A tile that is antisymmetric in modes (0,1), and (2,3) if it
+  /// has rank 4
+  static Tensor<double> make_antisymmetric(const Range& range, const unsigned int seed) {
+    Tensor<double> r(range);
+    for(std::size_t i = 0ul; i < r.size(); ++i)
+      r[i] = double((i * (seed + 4ul) + seed) % 13) - 6.0;
+    if(range.rank() == 2u)
+      return r.subt(r.permute(Permutation({1, 0})));
+    const Tensor<double> r01 = r.subt(r.permute(Permutation({1, 0, 2, 3})));
+    return r01.subt(r01.permute(Permutation({0, 1, 3, 2})));
+  }
+
+  static void check_equal(const Tensor<double>& x, const Tensor<double>& y) {
+    BOOST_REQUIRE_EQUAL(x.range(), y.range());
+    for(std::size_t i = 0ul; i < x.size(); ++i)
+      BOOST_CHECK_SMALL(x[i] - y[i], 1.0e-12);
+  }
+
+  Tensor<double> a;
+  Tensor<double> b;
+  Tensor<double> c;
+  Tensor<double> f;
+};
+
+BOOST_FIXTURE_TEST_SUITE( packed_tensor_suite, PackedTensorFixture )
+
+BOOST_AUTO_TEST_CASE( pack )
+{
+  const tile_type pa(a, pairs_type{{0u, 1u}});
+  BOOST_CHECK_EQUAL(pa.packed().size(), 10ul);
+  check_equal(pa.to_dense(), a);
+
+  // The order of the modes of a pair is irrelevant
+  const tile_type pc(c, pairs_type{{3u, 2u}, {0u, 1u}});
+  BOOST_CHECK_EQUAL(pc.packed().size(), 18ul);
+  BOOST_CHECK(pc.pairs() == (pairs_type{{0u, 1u}, {2u, 3u}}));
+  check_equal(pc.to_dense(), c);
+
+  BOOST_CHECK_CLOSE(pc.norm(), c.norm(), 1.0e-12);
+  BOOST_CHECK_EQUAL(pc.abs_max(), c.abs_max());
+  BOOST_CHECK_EQUAL(pc.sum(), 0.0);
+
+  const tile_type z(Range(4, 4), pairs_type{{0u, 1u}});
+  BOOST_CHECK_EQUAL(z.norm(), 0.0);
+  check_equal(z.to_dense(), Tensor<double>(Range(4, 4), 0.0));
+
+#ifdef TA_EXCEPTION_ERROR
+  BOOST_CHECK_THROW(tile_type(f, pairs_type{{0u, 1u}}), Exception);
+  BOOST_CHECK_THROW(tile_type(c, pairs_type{{0u, 1u}, {1u, 2u}}), Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( arithmetic )
+{
+  const tile_type pa(a, pairs_type{{0u, 1u}}), pb(b, pairs_type{{0u, 1u}});
+  check_equal(pa.add(pb).to_dense(), a.add(b));
+  check_equal(pa.subt(pb, 2.0).to_dense(), a.subt(b, 2.0));
+  check_equal(pa.scale(3.0).to_dense(), a.scale(3.0));
+  check_equal(pa.neg().to_dense(), a.neg());
+  check_equal(pa.mult(pb), a.mult(b));
+
+  tile_type pc = pa.clone();
+  pc.add_to(pb, 3.0);
+  check_equal(pc.to_dense(), a.add(b, 3.0));
+  check_equal(pa.to_dense(), a);
+
+  BOOST_CHECK_CLOSE(pa.dot(pb), a.dot(b), 1.0e-12);
+}
+
+BOOST_AUTO_TEST_CASE( permute )
+{
+  const tile_type pa(a, pairs_type{{0u, 1u}});
+  const Permutation transpose({1, 0});
+  check_equal(pa.permute(transpose).to_dense(), a.permute(transpose));
+
+  // Permutations that reverse the order of the modes of a pair
+  const tile_type pc(c, pairs_type{{0u, 1u}, {2u, 3u}});
+  for(const auto& perm : { Permutation({2, 3, 0, 1}), Permutation({1, 2, 3, 0}),
+      Permutation({3, 0, 2, 1}) })
+  {
+    const tile_type result = pc.permute(perm);
+    BOOST_CHECK_EQUAL(result.packed().size(), 18ul);
+    check_equal(result.to_dense(), c.permute(perm));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  const tile_type pa(a, pairs_type{{0u, 1u}}), pb(b, pairs_type{{0u, 1u}});
+  for(auto left_op : { madness::cblas::NoTrans, madness::cblas::Trans }) {
+    const math::GemmHelper helper(left_op, madness::cblas::NoTrans, 2u, 2u, 2u);
+
+    // Packed-packed, packed-dense, and dense-packed
+    check_equal(pa.gemm(pb, 2.0, helper), a.gemm(b, 2.0, helper));
+    check_equal(pa.gemm(f, 2.0, helper), a.gemm(f, 2.0, helper));
+    check_equal(gemm(b, pa, 2.0, helper), b.gemm(a, 2.0, helper));
+
+    // Accumulation
+    Tensor<double> result = a.gemm(b, 1.0, helper);
+    gemm(result, pa, pb, 1.0, helper);
+    check_equal(result, a.gemm(b, 2.0, helper));
+    gemm(result, b, pa, 1.0, helper);
+    check_equal(result, a.gemm(b, 2.0, helper).add(b.gemm(a, 1.0, helper)));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -540,4 +540,33 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( vector_permutation, Permutation, ptypes )
   BOOST_CHECK(a3 == ar); // check in-place permutation
 }
 
+BOOST_AUTO_TEST_CASE( stored_inverse )
+{
+  // Check the stored inverse of small and large permutations, whose
+  // elements are stored inline and in allocated memory respectively
+  for(const unsigned int n : { 3u, TiledArray::Permutation::max_inline_dim,
+      TiledArray::Permutation::max_inline_dim + 4u })
+  {
+    std::vector<unsigned int> a(n);
+    for(unsigned int i = 0u; i < n; ++i)
+      a[i] = (i + 2u) % n;
+    const TiledArray::Permutation p(a);
+    const auto inv = p.inv_data();
+    BOOST_REQUIRE_EQUAL(inv.size(), n);
+    for(unsigned int i = 0u; i < n; ++i)
+      BOOST_CHECK_EQUAL(inv[p[i]], i);
+
+    const TiledArray::Permutation p_inv = p.inv();
+    BOOST_CHECK_EQUAL(p * p_inv, TiledArray::Permutation::identity(n));
+    BOOST_CHECK_EQUAL(p_inv.inv(), p);
+    BOOST_CHECK(std::equal(p_inv.inv_data().begin(), p_inv.inv_data().end(), a.begin()));
+
+    // Copies do not share storage
+    TiledArray::Permutation q = p;
+    q = p_inv;
+    BOOST_CHECK_EQUAL(q, p_inv);
+    BOOST_CHECK_EQUAL(p.data()[0], a[0]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
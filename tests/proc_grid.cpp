@@ -193,6 +193,218 @@ BOOST_AUTO_TEST_CASE( make_groups )
   }
 }
 
+BOOST_AUTO_TEST_CASE( layered_constructor_test )
+{
+  GlobalFixture::world->srand(time(NULL));
+
+  for(int test = 0; test < 20; ++test) {
+
+    // Generate random process and matrix sizes
+    const ProcessID nprocs = GlobalFixture::world->rand() % 255 + 1;
+    const std::size_t layers = GlobalFixture::world->rand() % nprocs + 1;
+    const std::size_t rows = GlobalFixture::world->rand() % 127 + 1;
+    const std::size_t cols = GlobalFixture::world->rand() % 127 + 1;
+    const std::size_t row_size = rows * ((GlobalFixture::world->rand() % 511) + 1);
+    const std::size_t col_size = cols * ((GlobalFixture::world->rand() % 512) + 1);
+    const std::size_t layer_size = nprocs / layers;
+
+    // The grid of each layer is the 2D grid for the processes of one layer
+    TiledArray::detail::ProcGrid layer_grid0(*GlobalFixture::world, 0, layer_size,
+        rows, cols, row_size, col_size);
+
+    std::size_t local_size = 0ul;
+    for(ProcessID rank = 0; rank < nprocs; ++rank) {
+      TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, rank, nprocs,
+          rows, cols, row_size, col_size, layers);
+
+      BOOST_CHECK_EQUAL(proc_grid.layers(), layers);
+      BOOST_CHECK_EQUAL(proc_grid.layer_size(), layer_size);
+      BOOST_CHECK_EQUAL(proc_grid.proc_rows(), layer_grid0.proc_rows());
+      BOOST_CHECK_EQUAL(proc_grid.proc_cols(), layer_grid0.proc_cols());
+
+      if(std::size_t(rank) < layers * layer_size) {
+        BOOST_CHECK_EQUAL(proc_grid.rank_layer(), ProcessID(rank / layer_size));
+
+        TiledArray::detail::ProcGrid layer_grid(*GlobalFixture::world,
+            rank % layer_size, layer_size, rows, cols, row_size, col_size);
+        BOOST_CHECK_EQUAL(proc_grid.rank_row(), layer_grid.rank_row());
+        BOOST_CHECK_EQUAL(proc_grid.rank_col(), layer_grid.rank_col());
+        BOOST_CHECK_EQUAL(proc_grid.local_size(), layer_grid.local_size());
+      } else {
+        BOOST_CHECK_EQUAL(proc_grid.rank_layer(), -1);
+        BOOST_CHECK_EQUAL(proc_grid.rank_row(), -1);
+        BOOST_CHECK_EQUAL(proc_grid.rank_col(), -1);
+        BOOST_CHECK_EQUAL(proc_grid.local_size(), 0ul);
+      }
+
+      local_size += proc_grid.local_size();
+    }
+
+    // Each layer holds a copy of the grid
+    BOOST_CHECK_EQUAL(local_size, layers * rows * cols);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( layer_ranges )
+{
+  const std::size_t nprocs = 12ul, layers = 3ul, inner_size = 10ul;
+
+  std::size_t k = 0ul;
+  for(std::size_t rank = 0ul; rank < nprocs; rank += nprocs / layers) {
+    TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, rank, nprocs,
+        8, 8, 64, 64, layers);
+
+    // Layers hold contiguous, non-overlapping inner ranges
+    BOOST_CHECK_EQUAL(proc_grid.layer_begin(inner_size), k);
+    BOOST_CHECK_LT(proc_grid.layer_begin(inner_size), proc_grid.layer_end(inner_size));
+    k = proc_grid.layer_end(inner_size);
+  }
+  BOOST_CHECK_EQUAL(k, inner_size);
+}
+
+BOOST_AUTO_TEST_CASE( optimal_layers )
+{
+  // One layer when layers are disabled
+  BOOST_CHECK_EQUAL(TiledArray::detail::ProcGrid::optimal_layers(64, 1024,
+      1024, 1048576, 1024, 1), 1ul);
+
+  // Never more layers than processes, inner tiles, or the maximum
+  BOOST_CHECK_LE(TiledArray::detail::ProcGrid::optimal_layers(4, 64, 64,
+      1048576, 1024, 16), 4ul);
+  BOOST_CHECK_LE(TiledArray::detail::ProcGrid::optimal_layers(64, 64, 64,
+      1048576, 3, 16), 3ul);
+  BOOST_CHECK_LE(TiledArray::detail::ProcGrid::optimal_layers(64, 64, 64,
+      1048576, 1024, 2), 2ul);
+
+  // A long inner dimension with a small result favors more layers
+  BOOST_CHECK_GT(TiledArray::detail::ProcGrid::optimal_layers(64, 256, 256,
+      1048576, 1024, 16), 1ul);
+
+  // A short inner dimension with a large result favors 2D SUMMA
+  BOOST_CHECK_EQUAL(TiledArray::detail::ProcGrid::optimal_layers(64, 65536,
+      65536, 64, 1, 16), 1ul);
+
+  // Memory bound for the partial results
+  BOOST_CHECK_EQUAL(TiledArray::detail::ProcGrid::optimal_layers(64, 256, 256,
+      1048576, 1024, 16, 1024), 1ul);
+}
+
+BOOST_AUTO_TEST_CASE( divisor_layers )
+{
+  // Layer counts that do not divide the number of processes are reduced
+  BOOST_CHECK_EQUAL(TiledArray::detail::ProcGrid::divisor_layers(12, 5), 4ul);
+  BOOST_CHECK_EQUAL(TiledArray::detail::ProcGrid::divisor_layers(12, 6), 6ul);
+  BOOST_CHECK_EQUAL(TiledArray::detail::ProcGrid::divisor_layers(3, 2), 1ul);
+  BOOST_CHECK_EQUAL(TiledArray::detail::ProcGrid::divisor_layers(7, 16), 7ul);
+  BOOST_CHECK_EQUAL(TiledArray::detail::ProcGrid::divisor_layers(8, 0), 1ul);
+
+  // The selected number of layers uses every process
+  for(std::size_t nprocs = 1ul; nprocs <= 64ul; ++nprocs) {
+    const std::size_t layers = TiledArray::detail::ProcGrid::optimal_layers(
+        nprocs, 256, 256, 1048576, 1024, 16);
+    BOOST_CHECK_EQUAL(nprocs % layers, 0ul);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( model_constructor_test )
+{
+  GlobalFixture::world->srand(time(NULL));
+
+  for(int test = 0; test < 100; ++test) {
+
+    // Generate random process and matrix sizes
+    const ProcessID nprocs = GlobalFixture::world->rand() % 255 + 1;
+    const std::size_t rows = GlobalFixture::world->rand() % 255 + 1;
+    const std::size_t cols = GlobalFixture::world->rand() % 255 + 1;
+    const std::size_t row_size = rows * ((GlobalFixture::world->rand() % 127) + 1);
+    const std::size_t col_size = cols * ((GlobalFixture::world->rand() % 128) + 1);
+    const std::size_t inner_size = (GlobalFixture::world->rand() % 4096) + 1;
+    const double left_density = double(GlobalFixture::world->rand() % 100 + 1) / 100.0;
+    const double right_density = double(GlobalFixture::world->rand() % 100 + 1) / 100.0;
+    const std::size_t ranks_per_node = GlobalFixture::world->rand() % 16;
+
+    TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, 0, nprocs,
+        rows, cols, row_size, col_size, inner_size, left_density,
+        right_density, ranks_per_node);
+
+    // Check process grid sizes
+    BOOST_CHECK_LE(proc_grid.proc_size(), nprocs);
+    BOOST_CHECK_EQUAL(proc_grid.proc_size(), proc_grid.proc_rows() * proc_grid.proc_cols());
+    BOOST_CHECK_GE(proc_grid.proc_rows(), 1ul);
+    BOOST_CHECK_LE(proc_grid.proc_rows(), rows);
+    BOOST_CHECK_GE(proc_grid.proc_cols(), 1ul);
+    BOOST_CHECK_LE(proc_grid.proc_cols(), cols);
+    BOOST_CHECK_EQUAL(proc_grid.ranks_per_node(), ranks_per_node);
+
+    // Check that the grid is no worse than the default grid
+    TiledArray::detail::ProcGrid default_grid(*GlobalFixture::world, 0, nprocs,
+        rows, cols, row_size, col_size);
+    BOOST_CHECK_GT(proc_grid.cost(), 0.0);
+    BOOST_CHECK_LE(proc_grid.cost(),
+        TiledArray::detail::ProcGrid::model_cost(default_grid.proc_rows(),
+        default_grid.proc_cols(), rows, cols, row_size, col_size, inner_size,
+        left_density, right_density, ranks_per_node) * (1.0 + 1.0e-12));
+
+    // Check the local counts of this process
+    BOOST_CHECK_EQUAL(proc_grid.rank_row(), 0);
+    BOOST_CHECK_EQUAL(proc_grid.rank_col(), 0);
+    BOOST_CHECK_EQUAL(proc_grid.local_rows(),
+        (rows + proc_grid.proc_rows() - 1ul) / proc_grid.proc_rows());
+    BOOST_CHECK_EQUAL(proc_grid.local_cols(),
+        (cols + proc_grid.proc_cols() - 1ul) / proc_grid.proc_cols());
+  }
+}
+
+BOOST_AUTO_TEST_CASE( model_topology )
+{
+  // A square, communication bound product on 4 nodes with 6 ranks each
+  const std::size_t tiles = 96ul;
+  const std::size_t size = 96ul * 64ul;
+  TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, 0, 24, tiles,
+      tiles, size, size, 64ul, 1.0, 1.0, 6ul);
+  BOOST_CHECK_EQUAL(proc_grid.proc_size(), 24ul);
+  BOOST_CHECK(proc_grid.intra_node_rows());
+
+  // Without node information the row groups are not constrained
+  TiledArray::detail::ProcGrid flat_grid(*GlobalFixture::world, 0, 24, tiles,
+      tiles, size, size, 64ul, 1.0, 1.0, 0ul);
+  BOOST_CHECK(! flat_grid.intra_node_rows());
+  BOOST_CHECK_EQUAL(flat_grid.proc_rows() * flat_grid.proc_cols(), 24ul);
+}
+
+BOOST_AUTO_TEST_CASE( model_idle_procs )
+{
+  // With 7 processes and a communication bound product, a grid with
+  // idle processes is faster than a 1x7 or 7x1 grid
+  TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, 0, 7, 14, 14,
+      14ul, 14ul, 100ul, 1.0, 1.0, 0ul);
+  BOOST_CHECK_LT(proc_grid.proc_size(), 7ul);
+  BOOST_CHECK_GT(proc_grid.proc_rows(), 1ul);
+  BOOST_CHECK_GT(proc_grid.proc_cols(), 1ul);
+
+  // A compute bound product uses all processes
+  TiledArray::detail::ProcGrid compute_grid(*GlobalFixture::world, 0, 7, 14,
+      14, 1400ul, 1400ul, 1000000ul, 1.0, 1.0, 0ul);
+  BOOST_CHECK_EQUAL(compute_grid.proc_size(), 7ul);
+
+  // A process outside the grid has no local tiles
+  TiledArray::detail::ProcGrid idle_grid(*GlobalFixture::world, 6, 7, 14, 14,
+      14ul, 14ul, 100ul, 1.0, 1.0, 0ul);
+  BOOST_CHECK_EQUAL(idle_grid.local_size(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( model_sparsity )
+{
+  // The broadcasts of a sparse left-hand argument are cheaper, so the grid
+  // has more process columns
+  TiledArray::detail::ProcGrid dense_grid(*GlobalFixture::world, 0, 16, 64,
+      64, 6400ul, 6400ul, 100ul, 1.0, 1.0, 0ul);
+  TiledArray::detail::ProcGrid sparse_grid(*GlobalFixture::world, 0, 16, 64,
+      64, 6400ul, 6400ul, 100ul, 0.01, 1.0, 0ul);
+  BOOST_CHECK_EQUAL(dense_grid.proc_rows(), dense_grid.proc_cols());
+  BOOST_CHECK_GT(sparse_grid.proc_cols(), dense_grid.proc_cols());
+}
+
 #if 0
 // This test case us used to evaluate distribute statistics. This unit test
 // should only be enabled when changes are made to the ProcGrid algorithm, and
@@ -261,4 +473,26 @@ BOOST_AUTO_TEST_CASE( generate )
 }
 #endif
 
+BOOST_AUTO_TEST_CASE( machine_model )
+{
+  TiledArray::BlockSizeTuner::MachineModel model;
+  model.latency = 1.0e-5;
+  model.bandwidth = 1.0e9;
+  model.gemm_rate[64ul] = 1.0e9;
+
+  const std::size_t min_elements = TiledArray::detail::tensor_all_reduce_min_elements();
+  TiledArray::apply_machine_model(*GlobalFixture::world, model);
+
+  const double element_time = 8.0 / model.bandwidth;
+  BOOST_CHECK_CLOSE(TiledArray::detail::ProcGrid::flops_per_element(),
+      1.0e9 * double(std::max<std::size_t>(madness::ThreadPool::size(), 1ul))
+      * element_time, 1.0e-8);
+  BOOST_CHECK_CLOSE(TiledArray::detail::ProcGrid::latency_elements(),
+      model.latency / element_time, 1.0e-8);
+
+  // Restore the defaults
+  TiledArray::detail::ProcGrid::set_machine_balance();
+  TiledArray::detail::tensor_all_reduce_min_elements() = min_elements;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,107 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <array>
+#include <cmath>
+#include <Eigen/SVD>
+#include "TiledArray/algebra/randomized_svd.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct RandomizedSVDFixture {
+  RandomizedSVDFixture() :
+    row_bounds({{0, 7, 15, 24, 30, 40}}), col_bounds({{0, 10, 18, 25}}),
+    rows(row_bounds.begin(), row_bounds.end()),
+    cols(col_bounds.begin(), col_bounds.end()),
+    a(EigenMatrixXd::Zero(row_bounds.back(), col_bounds.back()))
+  {
+    // A matrix of rank 4 with well separated singular values
+    for(std::size_t r = 0ul; r < 4ul; ++r) {
+      const double sigma = std::pow(10.0, -double(r));
+      for(std::size_t i = 0ul; i < row_bounds.back(); ++i)
+        for(std::size_t j = 0ul; j < col_bounds.back(); ++j)
+          a(i,j) += sigma * std::sin(double((r + 1ul) * i + 1ul)) *
+              std::cos(double((2ul * r + 1ul) * j));
+    }
+  }
+
+  /// Convert an array to an Eigen matrix on every process
+  static EigenMatrixXd to_matrix(const TArrayD& array) {
+    EigenMatrixXd result(array.trange().elements_range().extent(0),
+        array.trange().elements_range().extent(1));
+    for(std::size_t t = 0ul; t < array.size(); ++t) {
+      const TArrayD::value_type tile = array.find(t).get();
+      for(auto it = tile.range().begin(); it != tile.range().end(); ++it)
+        result((*it)[0], (*it)[1]) = tile[*it];
+    }
+    return result;
+  }
+
+  const std::array<std::size_t, 6> row_bounds;
+  const std::array<std::size_t, 4> col_bounds;
+  TiledRange1 rows;
+  TiledRange1 cols;
+  EigenMatrixXd a;
+}; // RandomizedSVDFixture
+
+BOOST_FIXTURE_TEST_SUITE( randomized_svd_suite , RandomizedSVDFixture )
+
+BOOST_AUTO_TEST_CASE( range_finder )
+{
+  const std::array<TiledRange1, 2> dims = {{ rows, cols }};
+  TArrayD A = eigen_to_array<TArrayD>(*GlobalFixture::world,
+      TiledRange(dims.begin(), dims.end()), a, true);
+
+  const EigenMatrixXd q = to_matrix(randomized_range_finder(A, 6ul));
+  BOOST_CHECK_EQUAL(q.cols(), 6);
+  BOOST_CHECK_SMALL((q.transpose() * q - EigenMatrixXd::Identity(6, 6)).norm(),
+      1.0e-12);
+  BOOST_CHECK_SMALL((a - q * (q.transpose() * a)).norm(), 1.0e-10 * a.norm());
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( svd )
+{
+  const std::array<TiledRange1, 2> dims = {{ rows, cols }};
+  TArrayD A = eigen_to_array<TArrayD>(*GlobalFixture::world,
+      TiledRange(dims.begin(), dims.end()), a, true);
+
+  const auto usv = randomized_svd(A, 4ul);
+  const EigenMatrixXd u = to_matrix(std::get<0>(usv));
+  const std::vector<double>& sigma = std::get<1>(usv);
+  const EigenMatrixXd v = to_matrix(std::get<2>(usv));
+
+  Eigen::JacobiSVD<EigenMatrixXd> reference(a);
+  BOOST_REQUIRE_EQUAL(sigma.size(), 4ul);
+  for(std::size_t r = 0ul; r < 4ul; ++r)
+    BOOST_CHECK_CLOSE(sigma[r], reference.singularValues()[r], 1.0e-8);
+
+  Eigen::VectorXd s(4);
+  for(std::size_t r = 0ul; r < 4ul; ++r)
+    s[r] = sigma[r];
+  BOOST_CHECK_SMALL((u * s.asDiagonal() * v.transpose() - a).norm(),
+      1.0e-10 * a.norm());
+
+  GlobalFixture::world->gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
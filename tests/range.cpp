@@ -391,4 +391,86 @@ BOOST_AUTO_TEST_CASE( swap )
   BOOST_CHECK_EQUAL(r.volume(), volume);
 }
 
+BOOST_AUTO_TEST_CASE( rank_storage )
+{
+  // Ranges of small and large rank are copied, moved, swapped, and resized
+  // consistently, whether the dimension data is stored inline or not
+  const Range small({1, 2, 3}, {4, 5, 6});
+  const Range large({0, 1, 0, 1, 0, 1}, {2, 3, 2, 3, 2, 3});
+
+  for(const Range& x : { small, large }) {
+    Range copy(x);
+    BOOST_CHECK_EQUAL(copy, x);
+    BOOST_CHECK(copy.lobound_data() != x.lobound_data());
+
+    Range moved(std::move(copy));
+    BOOST_CHECK_EQUAL(moved, x);
+    BOOST_CHECK_EQUAL(copy.rank(), 0u);
+    BOOST_CHECK(copy.lobound_data() == nullptr);
+
+    Range assigned;
+    assigned = std::move(moved);
+    BOOST_CHECK_EQUAL(assigned, x);
+    BOOST_CHECK_EQUAL(moved.volume(), 0ul);
+
+    assigned = small;
+    BOOST_CHECK_EQUAL(assigned, small);
+    assigned = large;
+    BOOST_CHECK_EQUAL(assigned, large);
+    assigned.resize(x.lobound(), x.upbound());
+    BOOST_CHECK_EQUAL(assigned, x);
+
+    Range other = (x == small ? large : small);
+    other.swap(assigned);
+    BOOST_CHECK_EQUAL(other, x);
+    BOOST_CHECK_EQUAL(assigned, (x == small ? large : small));
+
+    std::vector<unsigned int> reverse(x.rank());
+    for(unsigned int i = 0u; i < x.rank(); ++i)
+      reverse[i] = x.rank() - i - 1u;
+    const Permutation perm(reverse);
+    Range permuted(perm, x);
+    for(unsigned int i = 0u; i < x.rank(); ++i)
+      BOOST_CHECK_EQUAL(permuted.extent(i), x.extent(x.rank() - i - 1u));
+    Range inplace(x);
+    inplace *= perm;
+    BOOST_CHECK_EQUAL(inplace, permuted);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( static_rank )
+{
+  for(unsigned int rank = 0u; rank <= 6u; ++rank)
+    BOOST_CHECK_EQUAL(TiledArray::detail::rank_dispatch(rank,
+        [] (auto r) { return decltype(r)::value; }),
+        (rank >= 1u && rank <= 4u ? rank : 0u));
+
+  // The fixed-rank and arbitrary-rank index arithmetic agree
+  for(unsigned int rank = 1u; rank <= 5u; ++rank) {
+    std::vector<std::size_t> lower(rank), upper(rank);
+    for(unsigned int i = 0u; i < rank; ++i) {
+      lower[i] = i;
+      upper[i] = i + 2u + (i % 2u);
+    }
+    const Range x(lower, upper);
+
+    std::size_t ordinal = 0ul;
+    for(auto it = x.begin(); it != x.end(); ++it, ++ordinal) {
+      BOOST_CHECK(x.includes(*it));
+      BOOST_CHECK_EQUAL(x.ordinal(*it), ordinal);
+      BOOST_CHECK(x.idx(ordinal) == *it);
+    }
+    BOOST_CHECK_EQUAL(ordinal, x.volume());
+    BOOST_CHECK(! x.includes(upper));
+
+    // Ordinals of a block refer to the elements of the enclosing range
+    std::vector<std::size_t> block_lower(lower);
+    block_lower[rank - 1u] += 1u;
+    const BlockRange block(x, block_lower, upper);
+    std::size_t block_ordinal = 0ul;
+    for(auto it = block.begin(); it != block.end(); ++it, ++block_ordinal)
+      BOOST_CHECK_EQUAL(block.ordinal(block_ordinal), x.ordinal(*it));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,78 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/conversions/rebalance.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct RebalanceFixture {
+
+  RebalanceFixture() : world(* GlobalFixture::world), weights(100ul, 1ul) {
+    // The work is concentrated in the first tiles
+    for(std::size_t i = 0ul; i < 10ul; ++i)
+      weights[i] = 100ul;
+  }
+
+  // The imbalance of a process map, computed from the local tiles
+  double expected_imbalance(const Pmap& pmap) const {
+    std::vector<double> load(pmap.procs(), 0.0);
+    double total = 0.0;
+    for(std::size_t i = 0ul; i < weights.size(); ++i) {
+      load[pmap.owner(i)] += weights[i];
+      total += weights[i];
+    }
+    return *std::max_element(load.begin(), load.end()) /
+        (total / double(pmap.procs())) - 1.0;
+  }
+
+  World& world;
+  std::vector<std::size_t> weights;
+};
+
+BOOST_FIXTURE_TEST_SUITE( rebalance_suite, RebalanceFixture )
+
+BOOST_AUTO_TEST_CASE( imbalance )
+{
+  detail::BlockedPmap blocked(world, weights.size());
+  BOOST_CHECK_CLOSE(TiledArray::imbalance(blocked, weights),
+      expected_imbalance(blocked), 1.0e-10);
+  BOOST_CHECK_GE(TiledArray::imbalance(blocked, weights), 0.0);
+
+  // The weighted map is at least as balanced as the blocked map
+  detail::WeightedPmap weighted(world, weights);
+  BOOST_CHECK_LE(TiledArray::imbalance(weighted, weights),
+      TiledArray::imbalance(blocked, weights) + 1.0e-10);
+
+  // A single process is balanced
+  if(world.size() == 1) {
+    BOOST_CHECK_SMALL(TiledArray::imbalance(blocked, weights), 1.0e-10);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( zero_weights )
+{
+  detail::BlockedPmap blocked(world, weights.size());
+  BOOST_CHECK_EQUAL(TiledArray::imbalance(blocked,
+      std::vector<std::size_t>(weights.size(), 0ul)), 0.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
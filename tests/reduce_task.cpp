@@ -137,6 +137,54 @@ BOOST_AUTO_TEST_CASE( reduce_future )
 
 }
 
+BOOST_AUTO_TEST_CASE( reduce_concurrent )
+{
+  // The arguments are set by many tasks, so they become ready concurrently
+  // on all threads and are reduced into several lanes at once
+  auto value = [] (const int i) { return i % 97; };
+
+  for(int repeat = 0; repeat < 4; ++repeat) {
+    ReduceTask<plus<int> > task(world);
+    int sum = 0;
+    for(int i = 0; i < 10000; ++i) {
+      sum += value(i);
+      task.add(world.taskq.add(value, i));
+    }
+    BOOST_CHECK_EQUAL(task.count(), 10000);
+
+    Future<int> result = task.submit();
+    BOOST_CHECK_EQUAL(result.get(), sum);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( reduce_deterministic )
+{
+  TiledArray::DeterministicReduction::set(true);
+
+  // The sum of these values depends on the order of the additions
+  auto value = [] (const int i) { return (i == 0 ? 1.0e16 : 1.0); };
+
+  std::vector<Future<double> > fut_vec;
+  ReduceTask<plus<double> > task(world);
+  double sum = 0.0;
+  for(int i = 0; i < 100; ++i) {
+    sum += value(i);
+    Future<double> f;
+    fut_vec.push_back(f);
+    task.add(f);
+  }
+
+  Future<double> result = task.submit();
+
+  // Set the arguments in the reverse order
+  for(int i = 99; i >= 0; --i)
+    fut_vec[i].set(value(i));
+
+  BOOST_CHECK_EQUAL(result.get(), sum);
+
+  TiledArray::DeterministicReduction::set(false);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -228,4 +276,68 @@ BOOST_AUTO_TEST_CASE( reduce_zero )
   BOOST_CHECK_EQUAL(result.get(), 0);
 }
 
+BOOST_AUTO_TEST_CASE( reduce_seed )
+{
+  BOOST_CHECK_EQUAL(rt.seed(Future<int>(10)), 1);
+
+  int sum = 10;
+  for(int i = 0; i < 100; ++i) {
+    sum += i * i;
+    rt.add(i, i);
+    BOOST_CHECK_EQUAL(rt.count(), i + 2);
+  }
+
+  Future<int> result = rt.submit();
+
+  BOOST_CHECK_EQUAL(result.get(), sum);
+}
+
+BOOST_AUTO_TEST_CASE( reduce_seed_future )
+{
+  Future<int> seed;
+  rt.seed(seed);
+
+  Future<int> f1;
+  Future<int> f2;
+  rt.add(f1, f2);
+  rt.add(4, 5);
+
+  Future<int> result = rt.submit();
+
+  f1.set(2);
+  f2.set(3);
+  BOOST_CHECK(!(result.probe()));
+
+  seed.set(10);
+
+  BOOST_CHECK_EQUAL(result.get(), 36);
+}
+
+BOOST_AUTO_TEST_CASE( reduce_seed_only )
+{
+  rt.seed(Future<int>(10));
+  Future<int> result = rt.submit();
+
+  BOOST_CHECK_EQUAL(result.get(), 10);
+}
+
+BOOST_AUTO_TEST_CASE( task_priorities )
+{
+  BOOST_CHECK(task_priority(TaskClass::broadcast) == TaskPriority::high);
+  BOOST_CHECK(task_priority(TaskClass::step) == TaskPriority::high);
+  BOOST_CHECK(task_priority(TaskClass::compute) == TaskPriority::normal);
+  BOOST_CHECK(task_priority(TaskClass::finalize) == TaskPriority::normal);
+  BOOST_CHECK(detail::task_attributes(TaskClass::broadcast).is_high_priority());
+
+  // Reductions still complete with high priority compute tasks
+  set_task_priority(TaskClass::compute, TaskPriority::high);
+  BOOST_CHECK(detail::task_attributes(TaskClass::compute).is_high_priority());
+  rt.add(Future<int>(2));
+  rt.add(Future<int>(3));
+  BOOST_CHECK_EQUAL(rt.submit().get(), 5);
+
+  reset_task_priorities();
+  BOOST_CHECK(task_priority(TaskClass::compute) == TaskPriority::normal);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
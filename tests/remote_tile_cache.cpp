@@ -0,0 +1,130 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/remote_tile_cache.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct RemoteTileCacheFixture {
+  typedef detail::RemoteTileCache<Future<int> > Cache;
+
+  RemoteTileCacheFixture() : cache(), requests(0ul) { }
+
+  // Find tile i, counting the requests sent to the owner
+  Future<int> find(const std::size_t i, const std::size_t bytes) {
+    return cache.find(i, bytes,
+        [=] () { ++requests; return Future<int>(int(i)); });
+  }
+
+  Cache cache;
+  std::size_t requests;
+};
+
+BOOST_FIXTURE_TEST_SUITE( remote_tile_cache_suite, RemoteTileCacheFixture )
+
+BOOST_AUTO_TEST_CASE( disabled )
+{
+  BOOST_CHECK(! cache.enabled());
+
+  // A disabled cache sends every request
+  find(0ul, 8ul);
+  find(0ul, 8ul);
+  BOOST_CHECK_EQUAL(requests, 2ul);
+  BOOST_CHECK_EQUAL(cache.bytes(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( hits_and_misses )
+{
+  cache.capacity(100ul);
+  BOOST_CHECK(cache.enabled());
+
+  BOOST_CHECK_EQUAL(find(1ul, 10ul).get(), 1);
+  BOOST_CHECK_EQUAL(find(2ul, 10ul).get(), 2);
+  BOOST_CHECK_EQUAL(find(1ul, 10ul).get(), 1);
+
+  BOOST_CHECK_EQUAL(requests, 2ul);
+  BOOST_CHECK_EQUAL(cache.hits(), 1ul);
+  BOOST_CHECK_EQUAL(cache.misses(), 2ul);
+  BOOST_CHECK_EQUAL(cache.bytes(), 20ul);
+}
+
+BOOST_AUTO_TEST_CASE( lru_eviction )
+{
+  cache.capacity(30ul);
+
+  find(1ul, 10ul);
+  find(2ul, 10ul);
+  find(3ul, 10ul);
+  find(1ul, 10ul); // Tile 2 is now the least recently used
+  find(4ul, 10ul); // Evicts tile 2
+  BOOST_CHECK_EQUAL(requests, 4ul);
+  BOOST_CHECK_EQUAL(cache.bytes(), 30ul);
+
+  find(1ul, 10ul);
+  find(3ul, 10ul);
+  find(4ul, 10ul);
+  BOOST_CHECK_EQUAL(requests, 4ul);
+
+  find(2ul, 10ul);
+  BOOST_CHECK_EQUAL(requests, 5ul);
+
+  // Tiles larger than the capacity are not cached
+  find(5ul, 40ul);
+  find(5ul, 40ul);
+  BOOST_CHECK_EQUAL(requests, 7ul);
+  BOOST_CHECK_EQUAL(cache.bytes(), 30ul);
+
+  // Reducing the capacity evicts tiles
+  cache.capacity(15ul);
+  BOOST_CHECK_EQUAL(cache.bytes(), 10ul);
+}
+
+BOOST_AUTO_TEST_CASE( insert )
+{
+  cache.capacity(30ul);
+
+  // Inserted tiles are found without a request or a miss
+  BOOST_CHECK(cache.insert(1ul, 10ul, Future<int>(1)));
+  BOOST_CHECK(! cache.insert(1ul, 10ul, Future<int>(1)));
+  BOOST_CHECK(! cache.insert(2ul, 40ul, Future<int>(2)));
+  BOOST_CHECK(cache.contains(1ul));
+  BOOST_CHECK(! cache.contains(2ul));
+  BOOST_CHECK_EQUAL(cache.misses(), 0ul);
+
+  BOOST_CHECK_EQUAL(find(1ul, 10ul).get(), 1);
+  BOOST_CHECK_EQUAL(requests, 0ul);
+  BOOST_CHECK_EQUAL(cache.hits(), 1ul);
+  BOOST_CHECK_EQUAL(cache.bytes(), 10ul);
+}
+
+BOOST_AUTO_TEST_CASE( clear )
+{
+  cache.capacity(100ul);
+  find(1ul, 10ul);
+  cache.clear();
+  BOOST_CHECK_EQUAL(cache.bytes(), 0ul);
+
+  find(1ul, 10ul);
+  BOOST_CHECK_EQUAL(requests, 2ul);
+  BOOST_CHECK_EQUAL(cache.misses(), 2ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
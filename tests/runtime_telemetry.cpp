@@ -0,0 +1,112 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  runtime_telemetry.cpp
+ *  October 15, 2026
+ *
+ */
+
+#include <sstream>
+#include "TiledArray/runtime_telemetry.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+using TiledArray::detail::RuntimeTelemetry;
+
+struct RuntimeTelemetryFixture {
+
+  RuntimeTelemetryFixture() :
+    tr1{0, 3, 8, 10, 16},
+    tr{ tr1, tr1 }
+  { RuntimeTelemetry::instance().clear(); }
+
+  ~RuntimeTelemetryFixture() {
+    stop_runtime_telemetry();
+    RuntimeTelemetry::instance().clear();
+  }
+
+  TiledRange1 tr1;
+  TiledRange tr;
+}; // RuntimeTelemetryFixture
+
+BOOST_FIXTURE_TEST_SUITE( runtime_telemetry_suite, RuntimeTelemetryFixture )
+
+BOOST_AUTO_TEST_CASE( statements )
+{
+  World& world = *GlobalFixture::world;
+  TArrayD a(world, tr), b(world, tr), c;
+  a.fill_local(1.0);
+  b.fill_local(2.0);
+
+  // Statements are only recorded while the runtime is sampled
+  c("i,j") = a("i,k") * b("k,j");
+  BOOST_CHECK(RuntimeTelemetry::instance().statements().empty());
+
+  start_runtime_telemetry(0.001);
+  BOOST_CHECK(RuntimeTelemetry::instance().enabled());
+  for(int i = 0; i < 4; ++i)
+    c("i,j") = 2 * (a("i,k") * b("k,j"));
+  stop_runtime_telemetry();
+  BOOST_CHECK(! RuntimeTelemetry::instance().enabled());
+
+  const std::vector<RuntimeStatement> statements =
+      RuntimeTelemetry::instance().statements();
+  BOOST_REQUIRE_EQUAL(statements.size(), 4ul);
+  for(std::size_t i = 0ul; i < statements.size(); ++i) {
+    BOOST_CHECK_EQUAL(statements[i].index, i + 1ul);
+    BOOST_CHECK_EQUAL(statements[i].label.find("i,j ="), 0ul);
+    BOOST_CHECK_EQUAL(statements[i].label.find('\n'), std::string::npos);
+    BOOST_CHECK_GE(statements[i].end, statements[i].begin);
+  }
+
+  // Samples are taken during the statements
+  for(const RuntimeSample& sample : runtime_samples()) {
+    BOOST_CHECK_GE(sample.statement, 1ul);
+    BOOST_CHECK_LE(sample.statement, 4ul);
+    BOOST_CHECK_GE(sample.time, statements[sample.statement - 1ul].begin);
+    BOOST_CHECK_GE(sample.idle_fraction, 0.0);
+    BOOST_CHECK_LE(sample.idle_fraction, 1.0);
+    BOOST_CHECK_GE(sample.active_threads, 0.0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( write )
+{
+  const std::size_t index = RuntimeTelemetry::instance().begin_statement("i = \"x\"");
+  RuntimeTelemetry::instance().end_statement(index);
+
+  std::stringstream os;
+  os << std::scientific;
+  RuntimeTelemetry::instance().write(os, 2);
+
+  // Statements are async events, with escaped labels
+  const std::string trace = os.str();
+  BOOST_CHECK_NE(trace.find("{\"name\":\"i = \\\"x\\\"\",\"cat\":\"statement\",\"ph\":\"b\",\"id\":1,\"pid\":2"),
+      std::string::npos);
+  BOOST_CHECK_NE(trace.find("\"cat\":\"statement\",\"ph\":\"e\",\"id\":1,\"pid\":2"),
+      std::string::npos);
+
+  // The format of the stream is restored
+  BOOST_CHECK(os.flags() & std::ios::scientific);
+
+  RuntimeTelemetry::instance().clear();
+  BOOST_CHECK(RuntimeTelemetry::instance().statements().empty());
+  BOOST_CHECK(runtime_samples().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -207,6 +207,77 @@ BOOST_AUTO_TEST_CASE( comm_constructor )
 }
 
 
+BOOST_AUTO_TEST_CASE( norm_codec )
+{
+  typedef TiledArray::detail::LogNormCodec<std::uint8_t> Codec8;
+  typedef TiledArray::detail::LogNormCodec<std::uint16_t> Codec16;
+
+  BOOST_CHECK_EQUAL(Codec8::encode(0.0f), 0u);
+  BOOST_CHECK_EQUAL(Codec16::encode(0.0f), 0u);
+  BOOST_CHECK_EQUAL(Codec8::decode<float>(0u), 0.0f);
+  BOOST_CHECK_EQUAL(Codec16::decode<float>(0u), 0.0f);
+
+  // Decoded norms are never smaller than the encoded norms
+  for(float norm = 1.0e-10f; norm < 1.0e6f; norm *= 1.37f) {
+    const float norm8 = Codec8::decode<float>(Codec8::encode(norm));
+    BOOST_CHECK(norm8 >= norm);
+    BOOST_CHECK(norm8 <= norm * 1.19f);
+
+    const float norm16 = Codec16::decode<float>(Codec16::encode(norm));
+    BOOST_CHECK(norm16 >= norm);
+    BOOST_CHECK(norm16 <= norm * 1.0014f);
+  }
+
+  // Norms outside the encoded range are rounded up
+  BOOST_CHECK(Codec8::decode<float>(Codec8::encode(1.0e-30f)) >= 1.0e-30f);
+  BOOST_CHECK_EQUAL(Codec8::encode(1.0e30f), Codec8::max_code());
+  BOOST_CHECK_EQUAL(Codec8::decode<float>(Codec8::max_code()),
+      std::numeric_limits<float>::max());
+}
+
+BOOST_AUTO_TEST_CASE( comm_codec_constructor )
+{
+  // Construct test tile norms
+  Tensor<float> tile_norms = make_norm_tensor(tr, 1, 98);
+  Tensor<float> tile_norms_ref = tile_norms.clone();
+
+  // Zero non-local tiles
+  TiledArray::detail::BlockedPmap pmap(*GlobalFixture::world, tr.tiles_range().volume());
+  for(Tensor<float>::size_type i = 0ul; i < tile_norms.size(); ++i)
+    if(! pmap.is_local(i))
+      tile_norms[i] = 0.0f;
+
+  // Construct the shape
+  const TiledArray::detail::LogNormCodec<std::uint16_t> codec;
+  BOOST_CHECK_NO_THROW(SparseShape<float> x(*GlobalFixture::world, tile_norms, tr, codec));
+  SparseShape<float> x(*GlobalFixture::world, tile_norms, tr, codec);
+
+  BOOST_CHECK(! x.empty());
+  BOOST_CHECK(x.validate(tr.tiles_range()));
+  BOOST_CHECK_EQUAL(x.zero_threshold(), SparseShape<float>::threshold());
+
+  size_type zero_tile_count = 0ul;
+
+  for(Tensor<float>::size_type i = 0ul; i < tile_norms.size(); ++i) {
+    const TiledRange::range_type range = tr.make_tile_range(i);
+    const float expected = tile_norms_ref[i] / float(range.volume());
+
+    // Check that the norm has been rounded up
+    if(expected >= SparseShape<float>::threshold()) {
+      BOOST_CHECK(! x.is_zero(i));
+      BOOST_CHECK(x[i] >= expected * 0.99999f);
+      BOOST_CHECK(x[i] <= expected * 1.0015f);
+    } else if(expected == 0.0f) {
+      BOOST_CHECK(x.is_zero(i));
+    }
+
+    if(x.is_zero(i))
+      ++zero_tile_count;
+  }
+
+  BOOST_CHECK_CLOSE(x.sparsity(), float(zero_tile_count) / float(tr.tiles_range().volume()), tolerance);
+}
+
 BOOST_AUTO_TEST_CASE( copy_constructor )
 {
   // Construct the shape
@@ -1181,6 +1252,91 @@ BOOST_AUTO_TEST_CASE( gemm )
   BOOST_CHECK_CLOSE(result.sparsity(), float(zero_tile_count) / float(result_norms.size()), tolerance);
 }
 
+BOOST_AUTO_TEST_CASE( gemm_sparse_product )
+{
+  // Construct shapes where few pairs of tiles are non-zero, so the norms are
+  // contracted with the sparse product
+  Tensor<float> left_norms = make_norm_tensor(tr, 1.0, 23);
+  Tensor<float> right_norms = make_norm_tensor(tr, 1.0, 82);
+  for(std::size_t i = 0ul; i < left_norms.size(); ++i) {
+    if(i % 4ul)
+      left_norms[i] = 0.0f;
+    if((i + 1ul) % 4ul)
+      right_norms[i] = 0.0f;
+  }
+  const SparseShape<float> sparse_left(left_norms, tr);
+  const SparseShape<float> sparse_right(right_norms, tr);
+  BOOST_REQUIRE_LT((1.0f - sparse_left.sparsity()) * (1.0f - sparse_right.sparsity()), 0.1f);
+
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  SparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = sparse_left.gemm(sparse_right, -7.2, gemm_helper));
+
+  // The sparse product matches the contraction of the compressed norms
+  const SparseShape<float> expected =
+      sparse_left.compress().gemm(sparse_right.compress(), -7.2, gemm_helper);
+  BOOST_CHECK(! result.is_compressed());
+  BOOST_REQUIRE(result.data().range() == expected.data().range());
+  for(Tensor<float>::size_type i = 0ul; i < expected.data().size(); ++i) {
+    BOOST_CHECK_CLOSE(result[i], expected[i], tolerance);
+    BOOST_CHECK_EQUAL(result.is_zero(i), expected.is_zero(i));
+  }
+  BOOST_CHECK_CLOSE(result.sparsity(), expected.sparsity(), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( gemm_quadrature )
+{
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  const SparseShape<float> bound = left.gemm(right, -7.2, gemm_helper);
+
+  // Evaluate the contraction with the quadrature estimator
+  BOOST_CHECK(SparseShape<float>::gemm_estimate() == SparseShape<float>::GemmEstimate::bound);
+  SparseShape<float>::gemm_estimate(SparseShape<float>::GemmEstimate::quadrature);
+  SparseShape<float> result, compressed_result;
+  BOOST_CHECK_NO_THROW(result = left.gemm(right, -7.2, gemm_helper));
+  BOOST_CHECK_NO_THROW(compressed_result =
+      left.compress().gemm(right.compress(), -7.2, gemm_helper));
+  SparseShape<float>::gemm_estimate(SparseShape<float>::GemmEstimate::bound);
+
+  const std::size_t m = left.data().range().extent(0);
+  const std::size_t k = left.data().size() / m;
+  const std::size_t n = right.data().range().extent(right.data().range().rank() - 1);
+
+  size_type zero_tile_count = 0ul;
+  for(std::size_t i = 0ul; i < m; ++i) {
+    const TiledRange1::range_type r_i = tr.data()[0].tile(i);
+    const float size_i = r_i.second - r_i.first;
+
+    for(std::size_t j = 0ul; j < n; ++j) {
+      // Compute the expected value
+      double sum = 0.0;
+      for(std::size_t x = 0ul; x < k; ++x) {
+        const double size_x = double(tr.make_tile_range(i * k + x).volume()) / size_i;
+        const double product = 7.2 * left[i * k + x] * right[x * n + j] * size_x * size_x;
+        sum += product * product;
+      }
+      float expected = std::sqrt(sum);
+      if(expected < SparseShape<float>::threshold())
+        expected = 0.0f;
+
+      BOOST_CHECK_CLOSE(result[i * n + j], expected, tolerance);
+      BOOST_CHECK_CLOSE(compressed_result[i * n + j], expected, tolerance);
+
+      // The estimate is not larger than the bound
+      BOOST_CHECK(result[i * n + j] <= bound[i * n + j] * (1.0f + tolerance));
+
+      if(expected < SparseShape<float>::threshold())
+        ++zero_tile_count;
+    }
+  }
+
+  BOOST_CHECK_CLOSE(result.sparsity(), float(zero_tile_count) / float(m * n), tolerance);
+  BOOST_CHECK(result.sparsity() >= bound.sparsity());
+  BOOST_CHECK_EQUAL(result.zero_threshold(), bound.zero_threshold());
+}
+
 BOOST_AUTO_TEST_CASE( gemm_perm )
 {
   const Permutation perm({1,0});
@@ -1240,4 +1396,282 @@ BOOST_AUTO_TEST_CASE( gemm_perm )
   BOOST_CHECK_CLOSE(result.sparsity(), float(zero_tile_count) / float(result_norms.size()), tolerance);
 }
 
+BOOST_AUTO_TEST_CASE( compress )
+{
+  SparseShape<float> compressed;
+  BOOST_REQUIRE_NO_THROW(compressed = sparse_shape.compress());
+  BOOST_CHECK(compressed.is_compressed());
+  BOOST_CHECK(! sparse_shape.is_compressed());
+  BOOST_CHECK(compressed.validate(tr.tiles_range()));
+  BOOST_CHECK_EQUAL(compressed.sparsity(), sparse_shape.sparsity());
+
+  for(Tensor<float>::size_type i = 0ul; i < tr.tiles_range().volume(); ++i) {
+    BOOST_CHECK_EQUAL(compressed[i], sparse_shape[i]);
+    BOOST_CHECK_EQUAL(compressed[tr.tiles_range().idx(i)], sparse_shape[i]);
+    BOOST_CHECK_EQUAL(compressed.is_zero(i), sparse_shape.is_zero(i));
+  }
+
+  // The dense norms of a compressed shape match the original
+  BOOST_CHECK_EQUAL(compressed.data().range(), sparse_shape.data().range());
+  for(Tensor<float>::size_type i = 0ul; i < tr.tiles_range().volume(); ++i)
+    BOOST_CHECK_EQUAL(compressed.data()[i], sparse_shape.data()[i]);
+
+  SparseShape<float> uncompressed = compressed.uncompress();
+  BOOST_CHECK(! uncompressed.is_compressed());
+  BOOST_CHECK_EQUAL(uncompressed.sparsity(), sparse_shape.sparsity());
+  for(Tensor<float>::size_type i = 0ul; i < tr.tiles_range().volume(); ++i)
+    BOOST_CHECK_EQUAL(uncompressed[i], sparse_shape[i]);
+}
+
+BOOST_AUTO_TEST_CASE( compressed_sparse_constructor )
+{
+  Tensor<float> tile_norms = make_norm_tensor(tr, 0.3, 42);
+  std::vector<std::pair<std::vector<std::size_t>, float> > sparse_norms;
+  for(Tensor<float>::size_type i = 0ul; i < tile_norms.size(); ++i)
+    if(tile_norms[i] > SparseShape<float>::threshold())
+      sparse_norms.emplace_back(tr.tiles_range().idx(i), tile_norms[i]);
+
+  SparseShape<float> dense(sparse_norms, tr);
+  SparseShape<float> compressed;
+  BOOST_REQUIRE_NO_THROW(compressed = SparseShape<float>(sparse_norms, tr, true));
+  BOOST_CHECK(compressed.is_compressed());
+  BOOST_CHECK_EQUAL(compressed.sparsity(), dense.sparsity());
+  for(Tensor<float>::size_type i = 0ul; i < tr.tiles_range().volume(); ++i)
+    BOOST_CHECK_CLOSE(compressed[i], dense[i], tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( compressed_ops )
+{
+  const SparseShape<float> c_left = left.compress();
+  const SparseShape<float> c_right = right.compress();
+
+  auto check = [&] (const SparseShape<float>& result, const SparseShape<float>& expected) {
+    BOOST_CHECK(result.is_compressed());
+    BOOST_REQUIRE(result.data().range() == expected.data().range());
+    for(Tensor<float>::size_type i = 0ul; i < expected.data().size(); ++i) {
+      BOOST_CHECK_CLOSE(result[i], expected[i], tolerance);
+      BOOST_CHECK_EQUAL(result.is_zero(i), expected.is_zero(i));
+    }
+    BOOST_CHECK_CLOSE(result.sparsity(), expected.sparsity(), tolerance);
+  };
+
+  check(c_left.perm(perm), left.perm(perm));
+  check(c_left.scale(-2.5), left.scale(-2.5));
+  check(c_left.scale(0.01, perm), left.scale(0.01, perm));
+  check(c_left.add(c_right), left.add(right));
+  check(c_left.add(right, perm), left.add(right, perm));
+  check(c_left.add(c_right, -0.5), left.add(right, -0.5));
+  check(c_left.subt(c_right, 0.5, perm), left.subt(right, 0.5, perm));
+  check(c_left.mult(c_right), left.mult(right));
+  check(c_left.mult(right, perm), left.mult(right, perm));
+  check(c_left.mult(c_right, 0.02), left.mult(right, 0.02));
+  check(c_left.mask(c_right), left.mask(right));
+
+  std::vector<std::size_t> lower(tr.tiles_range().rank(), 1ul);
+  std::vector<std::size_t> upper(tr.tiles_range().upbound().begin(),
+      tr.tiles_range().upbound().end());
+  upper.front() -= 1ul;
+  check(c_left.block(lower, upper), left.block(lower, upper));
+  check(c_left.block(lower, upper, 3.0), left.block(lower, upper, 3.0));
+  check(c_left.block(lower, upper, perm), left.block(lower, upper, perm));
+}
+
+BOOST_AUTO_TEST_CASE( compressed_gemm )
+{
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  SparseShape<float> expected = left.gemm(right, -7.2, gemm_helper);
+  SparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = left.compress().gemm(right.compress(), -7.2, gemm_helper));
+  BOOST_CHECK(result.is_compressed());
+
+  BOOST_REQUIRE(result.data().range() == expected.data().range());
+  for(Tensor<float>::size_type i = 0ul; i < expected.data().size(); ++i) {
+    BOOST_CHECK_CLOSE(result[i], expected[i], tolerance);
+    BOOST_CHECK_EQUAL(result.is_zero(i), expected.is_zero(i));
+  }
+  BOOST_CHECK_CLOSE(result.sparsity(), expected.sparsity(), tolerance);
+
+  // Transposed arguments give the same result
+  std::vector<unsigned int> left_perm_data(GlobalFixture::dim);
+  left_perm_data.front() = GlobalFixture::dim - 1u;
+  for(unsigned int i = 1u; i < GlobalFixture::dim; ++i)
+    left_perm_data[i] = i - 1u;
+  const Permutation left_perm(left_perm_data);
+  math::GemmHelper trans_helper(madness::cblas::Trans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  SparseShape<float> trans_result =
+      left.perm(left_perm).compress().gemm(right.compress(), -7.2, trans_helper);
+  for(Tensor<float>::size_type i = 0ul; i < expected.data().size(); ++i)
+    BOOST_CHECK_CLOSE(trans_result[i], result[i], tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( update )
+{
+  TiledArray::World& world = *GlobalFixture::world;
+  const float threshold = SparseShape<float>::threshold();
+
+  // Modify every fifth tile; alternate tiles become zero or non-zero
+  std::vector<std::pair<size_type, float> > changes;
+  if(world.rank() == 0) {
+    for(size_type i = 0ul; i < tr.tiles_range().volume(); i += 5ul) {
+      const float volume = tr.make_tile_range(i).volume();
+      changes.emplace_back(i, ((i / 5ul) % 2ul ? 0.0f : 3.0f * threshold * volume));
+    }
+  }
+
+  for(const SparseShape<float>& shape : { sparse_shape, sparse_shape.compress() }) {
+    SparseShape<float> result;
+    BOOST_REQUIRE_NO_THROW(result = shape.update(world, changes));
+    BOOST_CHECK_EQUAL(result.is_compressed(), shape.is_compressed());
+    BOOST_CHECK(result.validate(tr.tiles_range()));
+
+    size_type zero_tile_count = 0ul;
+    for(size_type i = 0ul; i < tr.tiles_range().volume(); ++i) {
+      float expected = sparse_shape[i];
+      if(i % 5ul == 0ul)
+        expected = ((i / 5ul) % 2ul ? 0.0f : 3.0f * threshold);
+      BOOST_CHECK_CLOSE(result[i], expected, tolerance);
+      BOOST_CHECK_EQUAL(result.is_zero(i), expected < threshold);
+      if(expected < threshold)
+        ++zero_tile_count;
+    }
+    BOOST_CHECK_CLOSE(result.sparsity(),
+        float(zero_tile_count) / float(tr.tiles_range().volume()), tolerance);
+
+    // The original shape is not modified
+    for(size_type i = 0ul; i < tr.tiles_range().volume(); ++i)
+      BOOST_CHECK_EQUAL(shape[i], sparse_shape[i]);
+  }
+
+  // No changes
+  const SparseShape<float> unchanged =
+      sparse_shape.update(world, std::vector<std::pair<size_type, float> >());
+  BOOST_CHECK_EQUAL(unchanged.sparsity(), sparse_shape.sparsity());
+  for(size_type i = 0ul; i < tr.tiles_range().volume(); ++i)
+    BOOST_CHECK_EQUAL(unchanged[i], sparse_shape[i]);
+}
+
+BOOST_AUTO_TEST_CASE( update_block )
+{
+  const float threshold = SparseShape<float>::threshold();
+  const std::vector<std::size_t> lower(tr.tiles_range().rank(), 1ul);
+  const std::vector<std::size_t> upper(tr.tiles_range().rank(), 4ul);
+
+  // The block of left has more zero tiles than sparse_shape, so the block
+  // update turns non-zero tiles into zero tiles, and zero tiles into
+  // non-zero tiles
+  const SparseShape<float> other = left.block(lower, upper);
+
+  for(const SparseShape<float>& shape : { sparse_shape, sparse_shape.compress() }) {
+    SparseShape<float> result;
+    BOOST_REQUIRE_NO_THROW(result = shape.update_block(lower, upper, other));
+
+    size_type zero_tile_count = 0ul;
+    for(auto it = tr.tiles_range().begin(); it != tr.tiles_range().end(); ++it) {
+      const auto& index = *it;
+      bool in_block = true;
+      std::vector<std::size_t> block_index(index.size());
+      for(std::size_t d = 0ul; d < index.size(); ++d) {
+        in_block = in_block && (index[d] >= lower[d]) && (index[d] < upper[d]);
+        block_index[d] = index[d] - lower[d];
+      }
+      const float expected = (in_block ? other[block_index] : sparse_shape[index]);
+
+      // Zero tiles have zero norms, and no norm is negative
+      BOOST_CHECK_CLOSE(result[index], expected, tolerance);
+      BOOST_CHECK_GE(result[index], 0.0f);
+      BOOST_CHECK_EQUAL(result.is_zero(index), expected < threshold);
+      if(expected < threshold) {
+        BOOST_CHECK_EQUAL(result[index], 0.0f);
+        ++zero_tile_count;
+      }
+    }
+
+    // The zero tile count is updated in both directions
+    BOOST_CHECK_CLOSE(result.sparsity(),
+        float(zero_tile_count) / float(tr.tiles_range().volume()), tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( zero_threshold )
+{
+  // New shapes take the default threshold
+  BOOST_CHECK_EQUAL(sparse_shape.zero_threshold(), SparseShape<float>::threshold());
+
+  // Changing the default does not change existing shapes
+  SparseShape<float>::threshold(0.5);
+  BOOST_CHECK_EQUAL(sparse_shape.zero_threshold(), 0.001f);
+  SparseShape<float> copy(sparse_shape);
+  BOOST_CHECK_EQUAL(copy.zero_threshold(), 0.001f);
+  SparseShape<float>::threshold(0.001);
+
+  // Construct a shape with its own threshold
+  const Tensor<float> tile_norms = make_norm_tensor(tr, 0.5, 42);
+  SparseShape<float> loose(tile_norms, tr, 50.0f);
+  BOOST_CHECK_EQUAL(loose.zero_threshold(), 50.0f);
+  std::size_t zero_tile_count = 0ul;
+  for(Tensor<float>::size_type i = 0ul; i < tile_norms.size(); ++i) {
+    if(sparse_shape[i] < 50.0f) {
+      BOOST_CHECK(loose.is_zero(i));
+      BOOST_CHECK_EQUAL(loose[i], 0.0f);
+      ++zero_tile_count;
+    } else {
+      BOOST_CHECK(! loose.is_zero(i));
+      BOOST_CHECK_EQUAL(loose[i], sparse_shape[i]);
+    }
+  }
+  BOOST_CHECK_CLOSE(loose.sparsity(), float(zero_tile_count) / float(tile_norms.size()), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( with_threshold )
+{
+  for(const bool compressed : { false, true }) {
+    const SparseShape<float> arg = (compressed ? sparse_shape.compress() : sparse_shape);
+    const SparseShape<float> result = arg.with_threshold(50.0f);
+    BOOST_CHECK_EQUAL(result.zero_threshold(), 50.0f);
+    BOOST_CHECK_EQUAL(result.is_compressed(), compressed);
+
+    std::size_t zero_tile_count = 0ul;
+    for(Tensor<float>::size_type i = 0ul; i < tr.tiles_range().volume(); ++i) {
+      if(sparse_shape[i] < 50.0f) {
+        BOOST_CHECK(result.is_zero(i));
+        BOOST_CHECK_EQUAL(result[i], 0.0f);
+        ++zero_tile_count;
+      } else {
+        BOOST_CHECK_EQUAL(result[i], sparse_shape[i]);
+      }
+    }
+    BOOST_CHECK_CLOSE(result.sparsity(),
+        float(zero_tile_count) / float(tr.tiles_range().volume()), tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( threshold_propagation )
+{
+  const SparseShape<float> loose = left.with_threshold(0.1f);
+
+  // Unary operations keep the threshold of the argument
+  BOOST_CHECK_EQUAL(loose.scale(2.0).zero_threshold(), 0.1f);
+  BOOST_CHECK_EQUAL(loose.perm(perm).zero_threshold(), 0.1f);
+  BOOST_CHECK_EQUAL(loose.compress().scale(2.0, perm).zero_threshold(), 0.1f);
+
+  // Binary operations use the tighter threshold
+  BOOST_CHECK_EQUAL(loose.add(right).zero_threshold(), 0.001f);
+  BOOST_CHECK_EQUAL(right.add(loose, perm).zero_threshold(), 0.001f);
+  BOOST_CHECK_EQUAL(loose.mult(right, 2.0).zero_threshold(), 0.001f);
+  BOOST_CHECK_EQUAL(loose.compress().add(right).zero_threshold(), 0.001f);
+
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  const SparseShape<float> tight = right.with_threshold(1.0e-6f);
+  BOOST_CHECK_EQUAL(loose.gemm(tight, 1.0, gemm_helper).zero_threshold(), 1.0e-6f);
+  BOOST_CHECK_EQUAL(loose.compress().gemm(tight, 1.0, gemm_helper).zero_threshold(), 1.0e-6f);
+
+  // The result of scaling is screened with the threshold of the argument
+  const SparseShape<float> result = loose.scale(0.01);
+  for(Tensor<float>::size_type i = 0ul; i < tr.tiles_range().volume(); ++i)
+    BOOST_CHECK_EQUAL(result.is_zero(i), (loose[i] * 0.01f) < 0.1f);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -31,8 +31,12 @@
 
 namespace TiledArray {
 
+  /// Sets the default zero threshold before the fixture shapes are constructed
+  struct SparseShapeThresholdFixture {
+    SparseShapeThresholdFixture() { SparseShape<float>::threshold(0.001); }
+  };
 
-  struct SparseShapeFixture : public TiledRangeFixture{
+  struct SparseShapeFixture : public TiledRangeFixture, public SparseShapeThresholdFixture {
     typedef std::vector<std::size_t> vec_type;
 
     SparseShapeFixture() :
@@ -43,9 +47,7 @@ namespace TiledArray {
       perm_index(tr.tiles_range(), perm),
       tolerance(0.0001)
 
-    {
-      SparseShape<float>::threshold(0.001);
-    }
+    { }
 
     ~SparseShapeFixture() { }
 
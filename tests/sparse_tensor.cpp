@@ -0,0 +1,148 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/tensor/sparse_tensor.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct SparseTensorFixture {
+  typedef SparseTensor<double> tile_type;
+
+  SparseTensorFixture() :
+    a(Range(20, 30), 0.0), b(Range(30, 10), 0.0), f(Range(20, 30))
+  {
+    // a and b have about 10% fill; f is dense
+    for(std::size_t i = 0ul; i < 20ul; ++i)
+      for(std::size_t j = 0ul; j < 30ul; ++j) {
+        if((i * 7 + j * 3) % 10 == 0)
+          a(i, j) = double(i + 1) - 0.5 * double(j);
+        f(i, j) = double((i * 31 + j * 17) % 13) + 1.0;
+      }
+    for(std::size_t i = 0ul; i < 30ul; ++i)
+      for(std::size_t j = 0ul; j < 10ul; ++j)
+        if((i + j * 5) % 9 == 0)
+          b(i, j) = double(i) - 2.0 * double(j) + 1.5;
+  }
+
+  static void check_equal(const Tensor<double>& x, const Tensor<double>& y) {
+    BOOST_REQUIRE_EQUAL(x.range(), y.range());
+    for(std::size_t i = 0ul; i < x.size(); ++i)
+      BOOST_CHECK_CLOSE_FRACTION(x[i], y[i], 1.0e-12);
+  }
+
+  Tensor<double> a;
+  Tensor<double> b;
+  Tensor<double> f;
+};
+
+BOOST_FIXTURE_TEST_SUITE( sparse_tensor_suite, SparseTensorFixture )
+
+BOOST_AUTO_TEST_CASE( compress )
+{
+  const tile_type sa(a);
+  BOOST_CHECK(! sa.is_dense());
+  BOOST_CHECK_LE(sa.fill(), tile_type::fill_threshold());
+  check_equal(sa.to_dense(), a);
+  BOOST_CHECK_CLOSE(sa.norm(), a.norm(), 1.0e-12);
+  BOOST_CHECK_CLOSE(sa.sum(), a.sum(), 1.0e-12);
+
+  const tile_type sf(f);
+  BOOST_CHECK(sf.is_dense());
+  check_equal(sf.to_dense(), f);
+
+  const tile_type z(Range(20, 30));
+  BOOST_CHECK_EQUAL(z.nnz(), 0ul);
+  BOOST_CHECK_EQUAL(z.norm(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( arithmetic )
+{
+  const tile_type sa(a), sf(f);
+
+  // Sparse sums stay sparse, and dense sums are dense
+  const tile_type sum = sa.add(sa.scale(2.0));
+  BOOST_CHECK(! sum.is_dense());
+  check_equal(sum.to_dense(), a.scale(3.0));
+  BOOST_CHECK_EQUAL(sa.subt(sa).nnz(), 0ul);
+  check_equal(sa.add(sf).to_dense(), a.add(f));
+  BOOST_CHECK(sa.add(sf).is_dense());
+
+  // Element-wise products with a sparse argument are sparse
+  const tile_type product = sf.mult(sa);
+  BOOST_CHECK(! product.is_dense());
+  check_equal(product.to_dense(), f.mult(a));
+
+  BOOST_CHECK_CLOSE(sa.dot(sf), a.dot(f), 1.0e-12);
+  BOOST_CHECK_CLOSE(sa.dot(sa), a.dot(a), 1.0e-12);
+
+  const Permutation transpose({1, 0});
+  const tile_type st = sa.permute(transpose);
+  BOOST_CHECK(! st.is_dense());
+  BOOST_CHECK_EQUAL(st.nnz(), sa.nnz());
+  check_equal(st.to_dense(), a.permute(transpose));
+}
+
+BOOST_AUTO_TEST_CASE( conversion )
+{
+  // Adding a dense tile and then subtracting it again recovers the sparse tile
+  const tile_type sa(a), sf(f);
+  const tile_type dense = sa.add(sf);
+  BOOST_CHECK(dense.is_dense());
+  const tile_type sparse = dense.subt(sf);
+  BOOST_CHECK(! sparse.is_dense());
+  check_equal(sparse.to_dense(), a);
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  const tile_type sa(a), sb(b), sf(f);
+  const math::GemmHelper nn(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, 2u, 2u);
+  const Tensor<double> ab = a.gemm(b, 2.0, nn);
+
+  // Sparse-sparse
+  check_equal(sa.gemm(sb, 2.0, nn).to_dense(), ab);
+
+  // Sparse-dense and dense-sparse
+  check_equal(sa.gemm(b, 2.0, nn), ab);
+  check_equal(gemm(a, sb, 2.0, nn), ab);
+  check_equal(sf.gemm(sb, 2.0, nn).to_dense(), f.gemm(b, 2.0, nn));
+
+  // Transposed arguments
+  const math::GemmHelper tn(madness::cblas::Trans, madness::cblas::NoTrans,
+      2u, 2u, 2u);
+  check_equal(sa.gemm(sf, 1.0, tn).to_dense(), a.gemm(f, 1.0, tn));
+  const math::GemmHelper nt(madness::cblas::NoTrans, madness::cblas::Trans,
+      2u, 2u, 2u);
+  const tile_type sbt = sb.permute(Permutation({1, 0}));
+  check_equal(sa.gemm(sbt, 1.0, nt).to_dense(), a.gemm(b, 1.0, nn));
+
+  // Accumulation
+  tile_type c = sa.gemm(sb, 2.0, nn);
+  c.gemm(sa, sb, 1.0, nn);
+  check_equal(c.to_dense(), ab.scale(1.5));
+
+  Tensor<double> d = ab.clone();
+  gemm(d, sa, b, 1.0, nn);
+  check_equal(d, ab.scale(1.5));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
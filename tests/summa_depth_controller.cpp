@@ -0,0 +1,109 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/dist_eval/summa_depth_controller.h"
+#include "unit_test_config.h"
+
+using TiledArray::detail::SummaDepthController;
+
+struct SummaDepthControllerFixture {
+
+  SummaDepthControllerFixture() { }
+
+}; // SummaDepthControllerFixture
+
+BOOST_FIXTURE_TEST_SUITE( summa_depth_controller_suite, SummaDepthControllerFixture )
+
+BOOST_AUTO_TEST_CASE( inactive )
+{
+  SummaDepthController controller;
+  controller.init(0ul, 2ul, 4ul);
+
+  BOOST_CHECK(! controller.active());
+  BOOST_CHECK_EQUAL(controller.depth(), 2ul);
+
+  // Without a memory limit the depth never changes
+  for(int i = 0; i < 10; ++i)
+    BOOST_CHECK_EQUAL(controller.update(1000000ul), 0);
+  BOOST_CHECK_EQUAL(controller.depth(), 2ul);
+  BOOST_CHECK_EQUAL(controller.memory(), 10000000ul);
+
+  controller.release_step(10000000ul);
+  BOOST_CHECK_EQUAL(controller.memory(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( widen )
+{
+  SummaDepthController controller;
+  controller.init(1000ul, 1ul, 3ul);
+  BOOST_CHECK(controller.active());
+
+  // Small steps widen the pipeline up to the maximum depth
+  BOOST_CHECK_EQUAL(controller.update(10ul), 1);
+  BOOST_CHECK_EQUAL(controller.depth(), 2ul);
+  BOOST_CHECK_EQUAL(controller.update(10ul), 1);
+  BOOST_CHECK_EQUAL(controller.depth(), 3ul);
+  BOOST_CHECK_EQUAL(controller.update(10ul), 0);
+  BOOST_CHECK_EQUAL(controller.depth(), 3ul);
+}
+
+BOOST_AUTO_TEST_CASE( narrow )
+{
+  SummaDepthController controller;
+  const std::size_t narrowed = SummaDepthController::narrowed_pipelines();
+  controller.init(1000ul, 3ul, 3ul);
+  BOOST_CHECK_EQUAL(SummaDepthController::narrowed_pipelines(), narrowed);
+
+  // Result tiles use most of the memory
+  controller.acquire_result(600ul);
+  BOOST_CHECK_EQUAL(controller.memory(), 600ul);
+
+  // Large steps narrow the pipeline down to one step
+  BOOST_CHECK_EQUAL(controller.update(250ul), -1);
+  BOOST_CHECK_EQUAL(controller.depth(), 2ul);
+  BOOST_CHECK_EQUAL(controller.update(250ul), -1);
+  BOOST_CHECK_EQUAL(controller.depth(), 1ul);
+  BOOST_CHECK_EQUAL(controller.update(250ul), 0);
+  BOOST_CHECK_EQUAL(controller.depth(), 1ul);
+
+  // The pipeline is counted once, however often it is narrowed
+  BOOST_CHECK_EQUAL(SummaDepthController::narrowed_pipelines(), narrowed + 1ul);
+
+  // Widen again when the tiles of the steps are released
+  controller.release_step(750ul);
+  BOOST_CHECK_EQUAL(controller.memory(), 600ul);
+  BOOST_CHECK_EQUAL(controller.update(10ul), 1);
+  BOOST_CHECK_EQUAL(controller.depth(), 2ul);
+  BOOST_CHECK_EQUAL(controller.memory(), 610ul);
+}
+
+BOOST_AUTO_TEST_CASE( narrow_init )
+{
+  // A pipeline that starts below its maximum depth is counted as narrowed
+  const std::size_t narrowed = SummaDepthController::narrowed_pipelines();
+  SummaDepthController controller;
+  controller.init(1000ul, 1ul, 3ul);
+  BOOST_CHECK_EQUAL(SummaDepthController::narrowed_pipelines(), narrowed + 1ul);
+
+  // but not without a memory limit
+  controller.init(0ul, 1ul, 3ul);
+  BOOST_CHECK_EQUAL(SummaDepthController::narrowed_pipelines(), narrowed + 1ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
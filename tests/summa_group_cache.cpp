@@ -0,0 +1,156 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/dist_eval/summa_group_cache.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using TiledArray::detail::SummaGroupCache;
+
+struct SummaGroupCacheFixture {
+
+  SummaGroupCacheFixture() { SummaGroupCache::clear(); }
+
+  ~SummaGroupCacheFixture() { SummaGroupCache::clear(); }
+
+  /// Construct the key of a contraction of the test world
+
+  /// \param n The inner dimension
+  /// \param zero The zero tile flags
+  static SummaGroupCache::key_type make_key(const std::size_t n,
+      const std::vector<bool>& zero = std::vector<bool>(4, false))
+  {
+    return SummaGroupCache::key_type(GlobalFixture::world->id(),
+        { 2ul, 2ul, n, 1ul, 1ul, 1ul, 1ul }, zero);
+  }
+
+}; // SummaGroupCacheFixture
+
+BOOST_FIXTURE_TEST_SUITE( summa_group_cache_suite, SummaGroupCacheFixture )
+
+BOOST_AUTO_TEST_CASE( find )
+{
+  if(SummaGroupCache::capacity() == 0ul) return;
+
+  const madness::uniqueidT id1 = GlobalFixture::world->unique_obj_id();
+  const madness::uniqueidT id2 = GlobalFixture::world->unique_obj_id();
+
+  std::shared_ptr<SummaGroupCache::Entry> entry = SummaGroupCache::find(make_key(1ul), id1, 4ul);
+  BOOST_REQUIRE(entry);
+  BOOST_CHECK(entry->id() == id1);
+  BOOST_CHECK_EQUAL(SummaGroupCache::size(), 1ul);
+
+  // A second lookup with the same key returns the same entry and keeps the
+  // id of the first lookup
+  std::shared_ptr<SummaGroupCache::Entry> same = SummaGroupCache::find(make_key(1ul), id2, 4ul);
+  BOOST_CHECK_EQUAL(same.get(), entry.get());
+  BOOST_CHECK(same->id() == id1);
+  BOOST_CHECK_EQUAL(SummaGroupCache::size(), 1ul);
+}
+
+BOOST_AUTO_TEST_CASE( groups )
+{
+  if(SummaGroupCache::capacity() == 0ul) return;
+
+  const madness::uniqueidT id = GlobalFixture::world->unique_obj_id();
+  std::shared_ptr<SummaGroupCache::Entry> entry = SummaGroupCache::find(make_key(1ul), id, 4ul);
+  BOOST_REQUIRE(entry);
+
+  // Groups are constructed once, with the id of the entry
+  int count = 0;
+  auto op = [&] (const madness::uniqueidT& group_id) {
+    BOOST_CHECK(group_id == id);
+    ++count;
+    return madness::Group();
+  };
+  for(int i = 0; i < 3; ++i) {
+    BOOST_CHECK(entry->row_group(2ul, op).empty());
+    BOOST_CHECK(entry->col_group(2ul, op).empty());
+  }
+  BOOST_CHECK_EQUAL(count, 2);
+}
+
+BOOST_AUTO_TEST_CASE( evict )
+{
+  const std::size_t capacity = SummaGroupCache::capacity();
+  if(capacity == 0ul) return;
+
+  const madness::uniqueidT id = GlobalFixture::world->unique_obj_id();
+  std::shared_ptr<SummaGroupCache::Entry> entry = SummaGroupCache::find(make_key(0ul), id, 4ul);
+
+  // Fill the cache, which evicts the least recently used entry
+  for(std::size_t key = 1ul; key <= capacity; ++key)
+    SummaGroupCache::find(make_key(key), GlobalFixture::world->unique_obj_id(), 4ul);
+  BOOST_CHECK_EQUAL(SummaGroupCache::size(), capacity);
+
+  std::shared_ptr<SummaGroupCache::Entry> evicted =
+      SummaGroupCache::find(make_key(0ul), GlobalFixture::world->unique_obj_id(), 4ul);
+  BOOST_CHECK_NE(evicted.get(), entry.get());
+  BOOST_CHECK(! (evicted->id() == id));
+}
+
+BOOST_AUTO_TEST_CASE( full_key )
+{
+  if(SummaGroupCache::capacity() == 0ul) return;
+
+  const madness::uniqueidT id = GlobalFixture::world->unique_obj_id();
+  std::shared_ptr<SummaGroupCache::Entry> entry =
+      SummaGroupCache::find(make_key(1ul), id, 4ul);
+
+  // Keys are compared in full, so contractions with different zero tiles
+  // do not share an entry
+  std::vector<bool> zero(4, false);
+  zero[2] = true;
+  BOOST_CHECK(make_key(1ul) == make_key(1ul));
+  BOOST_CHECK(! (make_key(1ul) == make_key(1ul, zero)));
+  std::shared_ptr<SummaGroupCache::Entry> other =
+      SummaGroupCache::find(make_key(1ul, zero), GlobalFixture::world->unique_obj_id(), 4ul);
+  BOOST_CHECK_NE(other.get(), entry.get());
+  BOOST_CHECK_EQUAL(SummaGroupCache::size(), 2ul);
+}
+
+BOOST_AUTO_TEST_CASE( worlds )
+{
+  const std::size_t capacity = SummaGroupCache::capacity();
+  if(capacity == 0ul) return;
+
+  const unsigned long world = GlobalFixture::world->id();
+  const unsigned long other_world = world + 1ul;
+  const madness::uniqueidT id = GlobalFixture::world->unique_obj_id();
+  std::shared_ptr<SummaGroupCache::Entry> entry =
+      SummaGroupCache::find(make_key(0ul), id, 4ul);
+
+  // The contractions of another world do not evict the entries of this one
+  for(std::size_t n = 0ul; n <= capacity; ++n)
+    SummaGroupCache::find(SummaGroupCache::key_type(other_world,
+        { 2ul, 2ul, n, 1ul, 1ul, 1ul, 1ul }, std::vector<bool>(4, false)),
+        GlobalFixture::world->unique_obj_id(), 4ul);
+  BOOST_CHECK_EQUAL(SummaGroupCache::size(world), 1ul);
+  BOOST_CHECK_EQUAL(SummaGroupCache::size(other_world), capacity);
+
+  std::shared_ptr<SummaGroupCache::Entry> same =
+      SummaGroupCache::find(make_key(0ul), GlobalFixture::world->unique_obj_id(), 4ul);
+  BOOST_CHECK_EQUAL(same.get(), entry.get());
+
+  SummaGroupCache::clear(other_world);
+  BOOST_CHECK_EQUAL(SummaGroupCache::size(other_world), 0ul);
+  BOOST_CHECK_EQUAL(SummaGroupCache::size(), 1ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,120 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <sstream>
+#include "TiledArray/dist_eval/summa_timeline.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "range_fixture.h"
+
+using TiledArray::detail::SummaTimeline;
+
+struct SummaTimelineFixture : public TiledRangeFixture {
+
+  SummaTimelineFixture() { SummaTimeline::clear(); }
+
+  ~SummaTimelineFixture() { SummaTimeline::clear(); }
+
+}; // SummaTimelineFixture
+
+BOOST_FIXTURE_TEST_SUITE( summa_timeline_suite, SummaTimelineFixture )
+
+BOOST_AUTO_TEST_CASE( record )
+{
+  const double begin = SummaTimeline::now();
+  SummaTimeline::record("bcast", 3ul, 1, 2ul, begin, 64ul);
+  SummaTimeline::record("contract", 3ul, 1, 2ul, begin, 0ul, 128.0);
+
+  std::vector<SummaTimeline::Event> events = SummaTimeline::events();
+  BOOST_REQUIRE_EQUAL(events.size(), 2ul);
+  BOOST_CHECK_EQUAL(std::string(events[0].stage), "bcast");
+  BOOST_CHECK_EQUAL(events[0].contraction, 3ul);
+  BOOST_CHECK_EQUAL(events[0].rank, 1);
+  BOOST_CHECK_EQUAL(events[0].k, 2ul);
+  BOOST_CHECK_EQUAL(events[0].begin, begin);
+  BOOST_CHECK_GE(events[0].end, begin);
+  BOOST_CHECK_EQUAL(events[0].bytes, 64ul);
+  BOOST_CHECK_EQUAL(events[1].flops, 128.0);
+
+  SummaTimeline::clear();
+  BOOST_CHECK(SummaTimeline::events().empty());
+}
+
+BOOST_AUTO_TEST_CASE( write )
+{
+  SummaTimeline::record("step", 3ul, 0, 5ul, SummaTimeline::now(), 0ul, 42.0);
+
+  std::stringstream ss;
+  ss << std::scientific;
+  SummaTimeline::write(ss);
+  const std::string trace = ss.str();
+
+  BOOST_CHECK_EQUAL(trace.find("{\"traceEvents\":["), 0ul);
+  BOOST_CHECK_NE(trace.find("\"name\":\"step\""), std::string::npos);
+  BOOST_CHECK_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+  BOOST_CHECK_NE(trace.find("\"k\":5"), std::string::npos);
+  BOOST_CHECK_NE(trace.find("\"flops\":42}"), std::string::npos);
+
+  // The format of the stream is restored
+  BOOST_CHECK(ss.flags() & std::ios::scientific);
+}
+
+#ifdef TILEDARRAY_ENABLE_SUMMA_TIMELINE
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  // Evaluate with SUMMA, also with one process
+  TiledArray::set_local_contraction(false);
+
+  TiledArray::TArrayI a(*GlobalFixture::world, tr);
+  TiledArray::TArrayI b(*GlobalFixture::world, tr);
+  TiledArray::TArrayI c;
+  a.fill_local(1);
+  b.fill_local(1);
+  GlobalFixture::world->gop.fence();
+
+  c("i,j") = (a("i,b,c") * b("j,b,c")).set_contraction_mode(
+      TiledArray::expressions::ContractionMode::keep_result);
+  GlobalFixture::world->gop.fence();
+
+  std::size_t steps = 0ul, finalized = 0ul;
+  double flops = 0.0;
+  for(const SummaTimeline::Event& event : SummaTimeline::events()) {
+    BOOST_CHECK_EQUAL(event.rank, GlobalFixture::world->rank());
+    BOOST_CHECK_GE(event.end, event.begin);
+    if(std::string(event.stage) == "step")
+      ++steps;
+    else if(std::string(event.stage) == "finalize")
+      ++finalized;
+    else if(std::string(event.stage) == "contract")
+      flops += event.flops;
+  }
+  BOOST_CHECK_EQUAL(finalized, 1ul);
+  BOOST_CHECK_GT(steps, 0ul);
+
+  // Every contraction is counted on exactly one process
+  GlobalFixture::world->gop.sum(flops);
+  const double m = tr.elements_range().extent_data()[0];
+  const double k = double(tr.elements_range().volume()) / m;
+  BOOST_CHECK_CLOSE(flops, 2.0 * m * m * k, 1.0e-8);
+
+  TiledArray::set_local_contraction(true);
+}
+#endif // TILEDARRAY_ENABLE_SUMMA_TIMELINE
+
+BOOST_AUTO_TEST_SUITE_END()
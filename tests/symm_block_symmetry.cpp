@@ -0,0 +1,101 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  symm_block_symmetry.cpp
+ *
+ */
+
+#include "TiledArray/symm/block_symmetry.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+using TiledArray::symmetry::BlockSymmetry;
+
+struct BlockSymmetryFixture {
+
+  BlockSymmetryFixture() :
+    tr1{0, 2, 4, 6, 8},
+    tr{ tr1, tr1 },
+    labels(BlockSymmetry::tile_labels(tr1, {0, 0, 1, 1, 0, 0, 1, 1})),
+    symm(tr)
+  {
+    symm.conserve({0, 1}, {labels, labels});
+  }
+
+  TiledRange1 tr1;
+  TiledRange tr;
+  BlockSymmetry::labels_type labels;
+  BlockSymmetry symm;
+};
+
+BOOST_FIXTURE_TEST_SUITE( symm_block_symmetry_suite, BlockSymmetryFixture )
+
+BOOST_AUTO_TEST_CASE( allowed_tiles )
+{
+  BOOST_CHECK(labels == (BlockSymmetry::labels_type{0, 1, 0, 1}));
+
+  const auto& range = tr.tiles_range();
+  for(std::size_t i = 0ul; i < 4ul; ++i)
+    for(std::size_t j = 0ul; j < 4ul; ++j) {
+      BOOST_CHECK_EQUAL(symm.is_allowed(range.ordinal({i, j})), (i % 2ul) == (j % 2ul));
+      BOOST_CHECK_EQUAL(symm.shape().is_zero(range.ordinal({i, j})), (i % 2ul) != (j % 2ul));
+    }
+
+  // A non-zero target selects the other blocks
+  BlockSymmetry odd(tr);
+  odd.conserve({0, 1}, {labels, labels}, 1u);
+  BOOST_CHECK(! odd.is_allowed(range.ordinal({0, 0})));
+  BOOST_CHECK(odd.is_allowed(range.ordinal({0, 1})));
+
+  const SparseShape<float> full(1.0f, tr);
+  BOOST_CHECK_EQUAL(symm.mask(full).sparsity(), 0.5f);
+
+#ifdef TA_EXCEPTION_ERROR
+  // The elements of a tile must have the same label
+  BOOST_CHECK_THROW(BlockSymmetry::tile_labels(tr1, {0, 1, 1, 1, 0, 0, 1, 1}),
+      Exception);
+  BOOST_CHECK_THROW(odd.conserve({0}, {{0, 1}}), Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  World& world = *GlobalFixture::world;
+  TSpArrayD x(world, tr, SparseShape<float>(1.0f, tr));
+  x.fill_local(1.0);
+
+  // Blocks forbidden by symmetry stay zero in products of block-symmetric
+  // arrays
+  TSpArrayD y(world, tr, symm.mask(SparseShape<float>(1.0f, tr)));
+  y.fill_local(1.0);
+  TSpArrayD z;
+  z("i,j") = y("i,k") * y("k,j");
+
+  // An expression that is not block-symmetric is masked with set_shape()
+  const SparseShape<float> mask = symm.shape();
+  TSpArrayD w;
+  w("i,j") = (x("i,k") * x("k,j")).set_shape(mask);
+
+  for(std::size_t ord = 0ul; ord < tr.tiles_range().volume(); ++ord) {
+    BOOST_CHECK_EQUAL(z.is_zero(ord), ! symm.is_allowed(ord));
+    BOOST_CHECK_EQUAL(w.is_zero(ord), ! symm.is_allowed(ord));
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,150 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  symm_tile_symmetry.cpp
+ *
+ */
+
+#include "TiledArray/symm/tile_symmetry.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+using TiledArray::symmetry::PermutationGroup;
+using TiledArray::symmetry::TileSymmetry;
+
+struct TileSymmetryFixture {
+
+  TileSymmetryFixture() :
+    tr{ TiledRange1{0, 3, 6, 9}, TiledRange1{0, 3, 6, 9} },
+    group({ symmetry::Permutation{1, 0} })
+  { }
+
+  TiledRange tr;
+  PermutationGroup group;
+};
+
+BOOST_FIXTURE_TEST_SUITE( symm_tile_symmetry_suite, TileSymmetryFixture )
+
+BOOST_AUTO_TEST_CASE( representative )
+{
+  const TileSymmetry symm(group, tr);
+  const auto& range = tr.tiles_range();
+
+  BOOST_CHECK(symm.is_representative(range.ordinal({0, 2})));
+  BOOST_CHECK(symm.is_representative(range.ordinal({1, 1})));
+  BOOST_CHECK(! symm.is_representative(range.ordinal({2, 0})));
+
+  const auto upper = symm.representative(range.ordinal({0, 2}));
+  BOOST_CHECK_EQUAL(upper.first, range.ordinal({0, 2}));
+  BOOST_CHECK(! upper.second);
+
+  const auto lower = symm.representative(range.ordinal({2, 0}));
+  BOOST_CHECK_EQUAL(lower.first, range.ordinal({0, 2}));
+  BOOST_CHECK_EQUAL(lower.second, Permutation({1, 0}));
+
+#ifdef TA_EXCEPTION_ERROR
+  // Symmetric modes must have the same tiling
+  const TiledRange uneven{ TiledRange1{0, 3, 6, 9}, TiledRange1{0, 4, 9} };
+  BOOST_CHECK_THROW(TileSymmetry bad(group, uneven), Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( symmetric_array )
+{
+  World& world = *GlobalFixture::world;
+  TArrayD x(world, tr);
+  x.fill_random();
+
+  TArrayD a, b;
+  a("i,j") = x("i,j") + x("j,i");
+  b("i,j") = a("i,j");
+  world.gop.fence();
+
+  b.set_tile_symmetry(group);
+  BOOST_REQUIRE(b.tile_symmetry());
+
+  // Only the representative tiles are stored
+  std::size_t representatives = 0ul;
+  for(const auto index : *b.pmap())
+    if(b.tile_symmetry()->is_representative(index))
+      ++representatives;
+  BOOST_CHECK_EQUAL(b.memory_usage().tiles, representatives);
+
+  // The other tiles are permuted copies of their representatives
+  for(const auto index : *a.pmap()) {
+    const TensorD expected = a.find(index).get();
+    const TensorD tile = b.find(index).get();
+    BOOST_REQUIRE_EQUAL(tile.range(), expected.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], expected[i]);
+  }
+
+  // Expressions read the materialized tiles
+  BOOST_CHECK_SMALL((b("i,j") - a("j,i")).norm().get(), 1.0e-12);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( symmetric_contraction )
+{
+  World& world = *GlobalFixture::world;
+  TArrayD x(world, tr);
+  x.fill_random();
+
+  TArrayD ref;
+  ref("i,j") = x("i,k") * x("j,k");
+
+  // Only the representative tiles are contracted and stored
+  TArrayD c;
+  c("i,j") = (x("i,k") * x("j,k")).set_symmetry(group);
+  BOOST_REQUIRE(c.tile_symmetry());
+  BOOST_CHECK_SMALL((c("i,j") - ref("i,j")).norm().get(), 1.0e-10);
+
+  // The symmetry of a permuted result is given in the order of its variables
+  TArrayD d;
+  d("j,i") = (x("i,k") * x("j,k")).set_symmetry(group);
+  BOOST_CHECK_SMALL((d("i,j") - ref("i,j")).norm().get(), 1.0e-10);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( implied_symmetry )
+{
+  World& world = *GlobalFixture::world;
+  TArrayD x(world, tr);
+  x.fill_random();
+  TArrayD y;
+  y("i,j") = x("i,j");
+
+  TArrayD ref;
+  ref("i,j") = x("i,k") * y("j,k");
+
+  // The product of an array with its own transpose is symmetric, so only
+  // the upper triangle is contracted, and the result is materialized
+  TArrayD c;
+  c("i,j") = x("i,k") * x("j,k");
+  BOOST_CHECK(! c.tile_symmetry());
+  BOOST_CHECK_SMALL((c("i,j") - ref("i,j")).norm().get(), 1.0e-10);
+
+  TArrayD d;
+  d("i,j") = x("k,i") * x("k,j");
+  ref("i,j") = x("k,i") * y("k,j");
+  BOOST_CHECK(! d.tile_symmetry());
+  BOOST_CHECK_SMALL((d("i,j") - ref("i,j")).norm().get(), 1.0e-10);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,265 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  ta_perf.cpp
+ *
+ */
+
+// Performance regression tests.
+//
+// Each kernel is timed several times after a warm-up run, and its fastest
+// time (the slowest process for distributed kernels) is compared with the
+// baseline of the kernel. A kernel that is slower than its baseline by more
+// than the tolerance is a regression, and the program exits with a non-zero
+// status. Baselines are machine specific; they are written with --update.
+//
+//   ta_perf [--baseline FILE] [--tolerance 0.10] [--repeat 5] [--update]
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <tiledarray.h>
+#include <TiledArray/math/vector_op.h>
+#include <TiledArray/reduce_task.h>
+
+namespace {
+
+  /// Performance test options
+  struct Options {
+    std::string baseline = "perf_baselines.txt"; ///< The baseline file
+    double tolerance = 0.10; ///< Allowed relative slowdown
+    unsigned int repeat = 5u; ///< Number of timed runs of each kernel
+    bool update = false; ///< Write the measured times as the baselines
+  }; // struct Options
+
+  /// Reduction operation of the \c ReduceTask kernel
+  struct SumOp {
+    typedef double result_type;
+    typedef double argument_type;
+
+    result_type operator()() const { return 0.0; }
+    result_type operator()(const result_type temp) const { return temp; }
+    void operator()(result_type& result, const argument_type& arg) const { result += arg; }
+    void operator()(result_type& result, const argument_type& arg1,
+        const argument_type& arg2) const
+    { result += arg1 + arg2; }
+  }; // struct SumOp
+
+  /// A timed kernel
+  struct Kernel {
+    std::string name; ///< The name of the kernel, which is its baseline key
+    std::function<void()> run; ///< Run the kernel once
+  }; // struct Kernel
+
+  /// Time a kernel
+
+  /// \return The fastest time of \c repeat runs, after a warm-up run, on the
+  /// slowest process
+  double time_kernel(TiledArray::World& world, const Kernel& kernel,
+      const unsigned int repeat)
+  {
+    kernel.run();
+    world.gop.fence();
+    double best = std::numeric_limits<double>::max();
+    for(unsigned int i = 0u; i < repeat; ++i) {
+      world.gop.fence();
+      const double start = madness::wall_time();
+      kernel.run();
+      world.gop.fence();
+      best = std::min(best, madness::wall_time() - start);
+    }
+    world.gop.max(best);
+    return best;
+  }
+
+  /// Read the baselines
+
+  /// Lines have the form <tt>name seconds</tt>; empty lines and lines that
+  /// start with \c # are ignored.
+  std::map<std::string, double> read_baselines(const std::string& filename) {
+    std::map<std::string, double> baselines;
+    std::ifstream file(filename);
+    std::string line;
+    while(std::getline(file, line)) {
+      if(line.empty() || line[0] == '#')
+        continue;
+      std::istringstream ss(line);
+      std::string name;
+      double time = 0.0;
+      if(ss >> name >> time)
+        baselines[name] = time;
+    }
+    return baselines;
+  }
+
+  /// Representative kernels
+  std::vector<Kernel> make_kernels(TiledArray::World& world) {
+    using namespace TiledArray;
+    std::vector<Kernel> kernels;
+
+    // Tile permutation
+    auto tile4 = std::make_shared<Tensor<double> >(Range{ 32, 32, 32, 32 }, 1.0);
+    kernels.push_back({ "tile_permute", [tile4] {
+      const Permutation perm{ 3, 2, 0, 1 };
+      Tensor<double> result = tile4->permute(perm);
+    } });
+
+    // Tile GEMM
+    auto tile2 = std::make_shared<Tensor<double> >(Range{ 256, 256 }, 1.0);
+    kernels.push_back({ "tensor_gemm", [tile2] {
+      const math::GemmHelper helper(madness::cblas::NoTrans,
+          madness::cblas::NoTrans, 2u, 2u, 2u);
+      Tensor<double> result = tile2->gemm(*tile2, 1.0, helper);
+    } });
+
+    // Element-wise kernel
+    const std::size_t n = 1ul << 22;
+    auto left = std::make_shared<std::vector<double> >(n, 1.0),
+        right = std::make_shared<std::vector<double> >(n, 2.0),
+        result = std::make_shared<std::vector<double> >(n, 0.0);
+    kernels.push_back({ "vector_op", [left, right, result] {
+      math::vector_op([] (const double l, const double r) { return l * r + 1.0; },
+          left->size(), result->data(), left->data(), right->data());
+    } });
+
+    // SUMMA at small scale
+    const TiledRange1 tr1 = BlockSizeTuner::make_trange1(512ul, 64ul);
+    const TiledRange tr{ tr1, tr1 };
+    auto a = std::make_shared<TArrayD>(world, tr), b = std::make_shared<TArrayD>(world, tr);
+    a->fill(1.0);
+    b->fill(2.0);
+    kernels.push_back({ "summa", [a, b] {
+      TArrayD c;
+      c("i,j") = (*a)("i,k") * (*b)("k,j");
+    } });
+
+    // Shape contraction
+    const TiledRange1 tr_shape = BlockSizeTuner::make_trange1(4096ul, 16ul);
+    const TiledRange shape_tr{ tr_shape, tr_shape };
+    Tensor<float> norms(shape_tr.tiles_range(), 0.0f);
+    for(std::size_t i = 0ul; i < norms.size(); ++i)
+      norms[i] = ((i * 7ul) % 10ul < 3ul ? 16.0f : 0.0f);
+    auto shape = std::make_shared<SparseShape<float> >(norms, shape_tr);
+    kernels.push_back({ "sparse_shape_gemm", [shape] {
+      const math::GemmHelper helper(madness::cblas::NoTrans,
+          madness::cblas::NoTrans, 2u, 2u, 2u);
+      SparseShape<float> result = shape->gemm(*shape, 1.0f, helper);
+    } });
+
+    // Reduction task
+    TiledArray::World* w = &world;
+    kernels.push_back({ "reduce_task", [w] {
+      detail::ReduceTask<SumOp> task(*w);
+      for(int i = 0; i < 100000; ++i)
+        task.add(double(i));
+      task.submit().get();
+    } });
+
+    return kernels;
+  }
+
+} // namespace
+
+int main(int argc, char** argv) {
+  TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+  Options opt;
+  for(int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if(arg == "--update")
+      opt.update = true;
+    else if(arg == "--baseline" && i + 1 < argc)
+      opt.baseline = argv[++i];
+    else if(arg == "--tolerance" && i + 1 < argc)
+      opt.tolerance = std::stod(argv[++i]);
+    else if(arg == "--repeat" && i + 1 < argc)
+      opt.repeat = std::max(std::stoi(argv[++i]), 1);
+    else {
+      if(world.rank() == 0)
+        std::cerr << "Usage: " << argv[0] << " [--baseline FILE]"
+            << " [--tolerance 0.10] [--repeat 5] [--update]\n";
+      TiledArray::finalize();
+      return 1;
+    }
+  }
+
+  const std::map<std::string, double> baselines = read_baselines(opt.baseline);
+  std::vector<std::string> regressions;
+  std::stringstream updated;
+  updated << "# TiledArray performance baselines (seconds), written by ta_perf --update\n"
+      << "# " << world.size() << " processes, " << madness::ThreadPool::size()
+      << " threads\n";
+
+  if(world.rank() == 0)
+    std::cout << std::left << std::setw(20) << "kernel" << std::right
+        << std::setw(14) << "time (s)" << std::setw(14) << "baseline"
+        << std::setw(10) << "change" << "\n";
+  for(const auto& kernel : make_kernels(world)) {
+    const double time = time_kernel(world, kernel, opt.repeat);
+    updated << kernel.name << " " << std::setprecision(6) << time << "\n";
+    if(world.rank() != 0)
+      continue;
+
+    std::cout << std::left << std::setw(20) << kernel.name << std::right
+        << std::setw(14) << std::setprecision(6) << time;
+    const auto it = baselines.find(kernel.name);
+    if(it == baselines.end() || it->second <= 0.0) {
+      std::cout << std::setw(14) << "-" << std::setw(10) << "-" << "\n";
+      continue;
+    }
+    const double change = time / it->second - 1.0;
+    std::cout << std::setw(14) << it->second << std::setw(9) << std::fixed
+        << std::setprecision(1) << 100.0 * change << "%" << std::defaultfloat;
+    if(change > opt.tolerance) {
+      regressions.push_back(kernel.name);
+      std::cout << "  <-- REGRESSION";
+    }
+    std::cout << "\n";
+  }
+
+  int rc = 0;
+  if(world.rank() == 0) {
+    if(opt.update) {
+      std::ofstream file(opt.baseline);
+      file << updated.str();
+      std::cout << "\nBaselines written to " << opt.baseline << "\n";
+    } else if(! regressions.empty()) {
+      std::cerr << "\n!! PERFORMANCE REGRESSION: " << regressions.size()
+          << " kernel(s) more than " << 100.0 * opt.tolerance
+          << "% slower than the baseline:";
+      for(const auto& name : regressions)
+        std::cerr << " " << name;
+      std::cerr << "\n";
+      rc = 1;
+    } else if(baselines.empty()) {
+      std::cout << "\nNo baselines in " << opt.baseline
+          << "; run with --update to record them.\n";
+    }
+  }
+  world.gop.broadcast(rc, 0);
+
+  TiledArray::finalize();
+  return rc;
+}
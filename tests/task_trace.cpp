@@ -0,0 +1,79 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <sstream>
+#include "TiledArray/task_trace.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using TiledArray::detail::TaskTrace;
+using TiledArray::detail::TaskTraceScope;
+
+struct TaskTraceFixture {
+
+  TaskTraceFixture() { TaskTrace::clear(); }
+
+  ~TaskTraceFixture() { TaskTrace::clear(); }
+
+}; // TaskTraceFixture
+
+BOOST_FIXTURE_TEST_SUITE( task_trace_suite, TaskTraceFixture )
+
+BOOST_AUTO_TEST_CASE( record )
+{
+  const double begin = TaskTrace::now();
+  TaskTrace::record("summa", "step", begin);
+
+  std::vector<TaskTrace::Event> events = TaskTrace::events();
+  BOOST_REQUIRE_EQUAL(events.size(), 1ul);
+  BOOST_CHECK_EQUAL(std::string(events[0].category), "summa");
+  BOOST_CHECK_EQUAL(std::string(events[0].name), "step");
+  BOOST_CHECK_EQUAL(events[0].thread, TaskTrace::thread());
+  BOOST_CHECK_EQUAL(events[0].begin, begin);
+  BOOST_CHECK_GE(events[0].end, begin);
+
+  // Scopes only record events when tracing is enabled
+  {
+    TaskTraceScope trace("kernel", "contract");
+  }
+  BOOST_CHECK_EQUAL(TaskTrace::events().size(), TaskTrace::enabled ? 2ul : 1ul);
+}
+
+BOOST_AUTO_TEST_CASE( write )
+{
+  TaskTrace::record("reduce", "drain", TaskTrace::now());
+
+  // Only the trace of rank 0 opens the event array
+  std::stringstream first, second;
+  second << std::scientific;
+  TaskTrace::write(first, 0);
+  TaskTrace::write(second, 3);
+  BOOST_CHECK_EQUAL(first.str().find("[\n"), 0ul);
+  BOOST_CHECK_EQUAL(second.str().find("["), std::string::npos);
+
+  const std::string trace = second.str();
+  BOOST_CHECK_NE(trace.find("\"name\":\"drain\",\"cat\":\"reduce\",\"ph\":\"X\",\"pid\":3"),
+      std::string::npos);
+  BOOST_CHECK_NE(trace.find("\"name\":\"rank 3\""), std::string::npos);
+
+  // The format of the stream is restored
+  BOOST_CHECK(second.flags() & std::ios::scientific);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -169,6 +169,25 @@ BOOST_AUTO_TEST_CASE( permute_constructor_tensor ) {
   }
 }
 
+BOOST_AUTO_TEST_CASE( permute_dot ) {
+  const std::array<std::size_t, 4> start = {{0ul, 0ul, 0ul, 0ul}};
+  const std::array<std::size_t, 4> finish = {{24ul, 42ul, 16ul, 30ul}};
+  TensorN x(range_type(start, finish));
+  rand_fill(1693, x.size(), x.data());
+
+  // Every permutation, with and without a permuted last dimension
+  std::array<unsigned int, 4> p = {{0,1,2,3}};
+  while(std::next_permutation(p.begin(), p.end())) {
+    Permutation perm(p.begin(), p.end());
+    TensorN y(perm * x.range());
+    rand_fill(431, y.size(), y.data());
+
+    const int expected = x.dot(TensorN(y, perm.inv()));
+    BOOST_CHECK_EQUAL(x.dot(y, perm), expected);
+    BOOST_CHECK_EQUAL(x.inner_product(y, perm), expected);
+  }
+}
+
 BOOST_AUTO_TEST_CASE( unary_constructor ) {
   // check constructor
   BOOST_REQUIRE_NO_THROW(TensorN x(t, [] (const int arg) { return arg * 83; }));
@@ -269,6 +288,53 @@ BOOST_AUTO_TEST_CASE( clone ) {
   BOOST_CHECK_EQUAL_COLLECTIONS(tc.begin(), tc.end(), t.begin(), t.end());
 }
 
+BOOST_AUTO_TEST_CASE( shift_view ) {
+  const std::array<long, 3> shift = {{ -1l, 2l, 3l }};
+  TensorN tc = t.clone();
+
+  // A shifted view shares the data of the tensor
+  TensorN view;
+  BOOST_REQUIRE_NO_THROW(view = tc.shift_view(shift));
+  BOOST_CHECK_EQUAL(view.data(), tc.data());
+  BOOST_CHECK_EQUAL(view.range(), TensorN::range_type(tc.range()).inplace_shift(shift));
+  BOOST_CHECK_EQUAL(tc.range(), t.range());
+
+  // The data of a view is not unique while the tensor refers to it
+  BOOST_CHECK(! view.is_unique());
+  BOOST_CHECK(! tc.is_unique());
+  tc = TensorN();
+  BOOST_CHECK(view.is_unique());
+  BOOST_CHECK_EQUAL_COLLECTIONS(view.begin(), view.end(), t.begin(), t.end());
+}
+
+BOOST_AUTO_TEST_CASE( is_unique ) {
+  BOOST_CHECK(! TensorN().is_unique());
+
+  // A clone is the sole owner of its data
+  TensorN tc = t.clone();
+  BOOST_CHECK(tc.is_unique());
+  BOOST_CHECK(TiledArray::is_unique(tc));
+
+  // Shallow copies share the data
+  {
+    TensorN copy = tc;
+    BOOST_CHECK(! tc.is_unique());
+    BOOST_CHECK(! copy.is_unique());
+  }
+  BOOST_CHECK(tc.is_unique());
+
+  // Tiles are unique only when the wrapped tensor is also unique
+  Tile<TensorN> tile(tc);
+  BOOST_CHECK(! tile.is_unique());
+  tc = TensorN();
+  BOOST_CHECK(tile.is_unique());
+  Tile<TensorN> tile_copy = tile;
+  BOOST_CHECK(! TiledArray::is_unique(tile));
+
+  // Tile types without is_unique() are assumed to share their data
+  BOOST_CHECK(! TiledArray::is_unique(1.0));
+}
+
 BOOST_AUTO_TEST_CASE( range_accessor )
 {
   BOOST_CHECK_EQUAL_COLLECTIONS(t.range().lobound_data(), t.range().lobound_data() + t.range().rank(),
@@ -466,6 +532,43 @@ BOOST_AUTO_TEST_CASE( binary_perm_op ) {
 }
 
 
+BOOST_AUTO_TEST_CASE( op_norm ) {
+  TensorN s(r);
+  rand_fill(431, s.size(), s.data());
+
+  // Check that the norm of the result is computed with the result
+  int squared_norm = 0;
+  TensorN x;
+  BOOST_REQUIRE_NO_THROW(x = t.unary([] (const int arg) { return arg * 83; },
+      squared_norm));
+  for(std::size_t i = 0ul; i < x.size(); ++i)
+    BOOST_CHECK_EQUAL(x[i], 83 * t[i]);
+  BOOST_CHECK_EQUAL(squared_norm, x.squared_norm());
+
+  BOOST_REQUIRE_NO_THROW(x = t.binary(s, [] (const int l, const int r)
+      { return l - r; }, squared_norm));
+  for(std::size_t i = 0ul; i < x.size(); ++i)
+    BOOST_CHECK_EQUAL(x[i], t[i] - s[i]);
+  BOOST_CHECK_EQUAL(squared_norm, x.squared_norm());
+
+  // Check the norm of a contraction
+  Tensor<double> left(Range(std::vector<std::size_t>{ 7, 5 }));
+  Tensor<double> right(Range(std::vector<std::size_t>{ 5, 9 }));
+  for(std::size_t i = 0ul; i < left.size(); ++i)
+    left[i] = double(i % 7ul) - 3.0;
+  for(std::size_t i = 0ul; i < right.size(); ++i)
+    right[i] = double(i % 5ul) - 2.0;
+  const math::GemmHelper gemm_helper(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, 2u, 2u, 2u);
+  double gemm_norm = 0.0;
+  Tensor<double> result;
+  BOOST_REQUIRE_NO_THROW(result = left.gemm(right, 2.0, gemm_helper, &gemm_norm));
+  BOOST_CHECK_CLOSE(gemm_norm, result.squared_norm(), 1.0e-10);
+
+  BOOST_REQUIRE_NO_THROW(result.gemm(left, right, 1.0, gemm_helper, &gemm_norm));
+  BOOST_CHECK_CLOSE(gemm_norm, result.squared_norm(), 1.0e-10);
+}
+
 BOOST_AUTO_TEST_CASE( conj_op ) {
   Permutation perm = make_perm();
   TensorZ s(r);
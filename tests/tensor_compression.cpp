@@ -0,0 +1,221 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <madness/world/vector_archive.h>
+#include "TiledArray/tensor/compression.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct TensorCompressionFixture {
+
+  TensorCompressionFixture() : data(1000ul, 0.0) {
+    // Mostly zero data with a few large and a few small elements
+    for(std::size_t i = 0ul; i < data.size(); i += 10ul)
+      data[i] = 1.0 + double(i);
+    for(std::size_t i = 5ul; i < data.size(); i += 50ul)
+      data[i] = 1.0e-12 * double(i);
+  }
+
+  ~TensorCompressionFixture() {
+    TensorCompression::set(TensorCompression::none);
+  }
+
+  // Make a mostly zero array, whose non-zero elements depend on seed
+  static TArrayD make_array(const double seed) {
+    std::array<std::size_t, 4> tiling = {{ 0, 10, 20, 30 }};
+    TiledRange1 tr1(tiling.begin(), tiling.end());
+    TArrayD array(*GlobalFixture::world, TiledRange({ tr1, tr1 }));
+    for(const auto index : *array.pmap()) {
+      TensorD tile(array.trange().make_tile_range(index), 0.0);
+      for(std::size_t i = 0ul; i < tile.size(); i += 10ul)
+        tile[i] = std::sin(seed * double(i + index + 1ul));
+      array.set(index, tile);
+    }
+    return array;
+  }
+
+  std::vector<double> data;
+};
+
+BOOST_FIXTURE_TEST_SUITE( tensor_compression_suite, TensorCompressionFixture )
+
+BOOST_AUTO_TEST_CASE( settings )
+{
+  BOOST_CHECK_EQUAL(TensorCompression::mode(), TensorCompression::none);
+  BOOST_CHECK(! TensorCompression::compress(1ul << 20));
+
+  TensorCompression::set(TensorCompression::lossy, 1024ul, 1.0e-10);
+  BOOST_CHECK_EQUAL(TensorCompression::mode(), TensorCompression::lossy);
+  BOOST_CHECK_EQUAL(TensorCompression::min_bytes(), 1024ul);
+  BOOST_CHECK_EQUAL(TensorCompression::tolerance(), 1.0e-10);
+  BOOST_CHECK(! TensorCompression::compress(1023ul));
+  BOOST_CHECK(TensorCompression::compress(1024ul));
+}
+
+BOOST_AUTO_TEST_CASE( lossless )
+{
+  const std::vector<unsigned char> code =
+      detail::shuffle_encode(data.data(), data.size(), 0.0);
+  BOOST_CHECK_LT(code.size(), data.size() * sizeof(double) / 4ul);
+
+  std::vector<double> result(data.size(), -1.0);
+  detail::shuffle_decode(code.data(), code.size(), result.data(), result.size());
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+      data.begin(), data.end());
+}
+
+BOOST_AUTO_TEST_CASE( lossy )
+{
+  const double tolerance = 1.0e-6;
+  const std::vector<unsigned char> code =
+      detail::shuffle_encode(data.data(), data.size(), tolerance);
+  const std::vector<unsigned char> lossless_code =
+      detail::shuffle_encode(data.data(), data.size(), 0.0);
+  BOOST_CHECK_LT(code.size(), lossless_code.size());
+
+  std::vector<double> result(data.size(), -1.0);
+  detail::shuffle_decode(code.data(), code.size(), result.data(), result.size());
+  for(std::size_t i = 0ul; i < data.size(); ++i) {
+    BOOST_CHECK_LE(std::abs(result[i] - data[i]), tolerance);
+    if(std::abs(data[i]) >= tolerance)
+      BOOST_CHECK_EQUAL(result[i], data[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( incompressible )
+{
+  // Data with few zero bytes is decoded exactly
+  std::vector<float> values(100ul);
+  for(std::size_t i = 0ul; i < values.size(); ++i)
+    values[i] = 1.1f + float(i) * 0.37f;
+  const std::vector<unsigned char> code =
+      detail::shuffle_encode(values.data(), values.size(), 0.0f);
+
+  std::vector<float> result(values.size());
+  detail::shuffle_decode(code.data(), code.size(), result.data(), result.size());
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+      values.begin(), values.end());
+}
+
+BOOST_AUTO_TEST_CASE( archives )
+{
+  TensorD tensor(Range(data.size()));
+  std::copy(data.begin(), data.end(), tensor.begin());
+
+  // Serialize to a message buffer, and to a vector archive
+  auto serialize = [] (const TensorD& t, std::vector<unsigned char>& message,
+      std::vector<unsigned char>& plain)
+  {
+    madness::archive::BufferOutputArchive count_ar;
+    count_ar & t;
+    message.resize(count_ar.size());
+    madness::archive::BufferOutputArchive message_ar(message.data(), message.size());
+    message_ar & t;
+    plain.clear();
+    madness::archive::VectorOutputArchive plain_ar(plain);
+    plain_ar & t;
+  };
+
+  std::vector<unsigned char> message, plain;
+  serialize(tensor, message, plain);
+  const std::size_t message_size = message.size();
+  const std::vector<unsigned char> reference = plain;
+
+  // Only messages are compressed; the format of other archives does not
+  // depend on the compression mode
+  TensorCompression::set(TensorCompression::lossy, 1024ul, 1.0e-6);
+  serialize(tensor, message, plain);
+  BOOST_CHECK_LT(message.size(), message_size / 4ul);
+  BOOST_CHECK(plain == reference);
+
+  TensorD result;
+  madness::archive::BufferInputArchive message_ar(message.data(), message.size());
+  message_ar & result;
+  BOOST_CHECK_EQUAL(result.range(), tensor.range());
+  for(std::size_t i = 0ul; i < data.size(); ++i)
+    BOOST_CHECK_LE(std::abs(result[i] - data[i]), 1.0e-6);
+
+  madness::archive::VectorInputArchive plain_ar(plain);
+  plain_ar & result;
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+      data.begin(), data.end());
+}
+
+BOOST_AUTO_TEST_CASE( compressed_array )
+{
+  TArrayD array = make_array(1.0);
+
+  // The lossless array is exact and smaller than the array
+  const CompressedArray<TensorD, DensePolicy> compressed = make_compressed(array);
+  BOOST_CHECK(! compressed.uncompressed());
+  BOOST_CHECK_LE(compressed.bytes(), compressed.uncompressed_bytes());
+  if(compressed.uncompressed_bytes() > 0ul)
+    BOOST_CHECK_LT(compressed.bytes(), compressed.uncompressed_bytes() / 4ul);
+  TArrayD result = compressed.get();
+  for(TArrayD::const_iterator it = result.begin(); it != result.end(); ++it) {
+    const TensorD tile = *it;
+    const TensorD ref_tile = array.find(it.index()).get();
+    BOOST_CHECK_EQUAL_COLLECTIONS(tile.begin(), tile.end(),
+        ref_tile.begin(), ref_tile.end());
+  }
+
+  // The lossy array bounds the error of each element
+  const double tolerance = 1.0e-2;
+  result = make_compressed(array, TensorCompression::lossy, tolerance).get();
+  for(TArrayD::const_iterator it = result.begin(); it != result.end(); ++it) {
+    const TensorD tile = *it;
+    const TensorD ref_tile = array.find(it.index()).get();
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_LE(std::abs(tile[i] - ref_tile[i]), tolerance);
+  }
+
+  // Arrays are held as is in none mode
+  const auto uncompressed = make_compressed(array, TensorCompression::none);
+  BOOST_CHECK(uncompressed.uncompressed());
+  BOOST_CHECK_EQUAL(uncompressed.bytes(), uncompressed.uncompressed_bytes());
+}
+
+BOOST_AUTO_TEST_CASE( diis_history )
+{
+  // Check that DIIS with a compressed history extrapolates as with an
+  // uncompressed history
+  DIIS<TArrayD> diis(1, 4);
+  DIIS<TArrayD> compressed_diis(1, 4);
+  compressed_diis.set_compression(TensorCompression::lossless);
+  for(int iter = 1; iter <= 6; ++iter) {
+    TArrayD x = make_array(0.5 * iter);
+    TArrayD error = make_array(1.0 / iter);
+    TArrayD compressed_x = make_array(0.5 * iter);
+    TArrayD compressed_error = make_array(1.0 / iter);
+    diis.extrapolate(x, error);
+    compressed_diis.extrapolate(compressed_x, compressed_error);
+    BOOST_CHECK_CLOSE(diis.error_norm(), compressed_diis.error_norm(), 1.0e-8);
+
+    for(TArrayD::const_iterator it = x.begin(); it != x.end(); ++it) {
+      const TensorD tile = *it;
+      const TensorD compressed_tile = compressed_x.find(it.index()).get();
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_SMALL(tile[i] - compressed_tile[i], 1.0e-10);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,107 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/tensor/memory_tracker.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "range_fixture.h"
+#include <sstream>
+
+using namespace TiledArray;
+
+struct MemoryTrackerFixture : public TiledRangeFixture {
+
+  MemoryTrackerFixture() { }
+
+}; // MemoryTrackerFixture
+
+BOOST_FIXTURE_TEST_SUITE( memory_tracker_suite, MemoryTrackerFixture )
+
+BOOST_AUTO_TEST_CASE( tensor_allocation )
+{
+  const std::size_t bytes = 1000ul * sizeof(double);
+  const MemoryStatistics before = memory_statistics();
+  {
+    TensorD t(Range(1000ul), 1.0);
+    const MemoryStatistics during = memory_statistics();
+    BOOST_CHECK_EQUAL(during.live_bytes, before.live_bytes + bytes);
+    BOOST_CHECK_EQUAL(during.live_allocations, before.live_allocations + 1ul);
+    BOOST_CHECK_EQUAL(during.allocations, before.allocations + 1ul);
+
+    // Shallow copies share the data
+    TensorD u = t;
+    BOOST_CHECK_EQUAL(memory_statistics().live_bytes, during.live_bytes);
+  }
+  BOOST_CHECK_EQUAL(memory_statistics().live_bytes, before.live_bytes);
+  BOOST_CHECK_EQUAL(memory_statistics().live_allocations, before.live_allocations);
+}
+
+BOOST_AUTO_TEST_CASE( scoped_peak )
+{
+  const std::size_t bytes = 1000ul * sizeof(double);
+  MemoryScope outer;
+  {
+    TensorD t(Range(1000ul), 1.0);
+  }
+
+  std::size_t inner_peak = 0ul;
+  {
+    MemoryScope inner;
+    BOOST_CHECK_EQUAL(inner.peak_bytes(), inner.baseline_bytes());
+    {
+      TensorD t(Range(500ul), 1.0);
+    }
+    inner_peak = inner.end();
+    BOOST_CHECK(inner_peak >= inner.baseline_bytes() + bytes / 2ul);
+  }
+
+  // The peak of the outer scope includes both tensors, but the inner scope
+  // only saw the smaller one
+  BOOST_CHECK(outer.peak_bytes() >= outer.baseline_bytes() + bytes);
+  BOOST_CHECK(outer.peak_bytes() >= inner_peak);
+}
+
+BOOST_AUTO_TEST_CASE( array_usage )
+{
+  TArrayD a(*GlobalFixture::world, tr);
+  a.fill_local(1.0);
+
+  std::size_t local_tiles = 0ul, local_bytes = 0ul;
+  for(const auto index : *a.pmap()) {
+    ++local_tiles;
+    local_bytes += tr.make_tile_range(index).volume() * sizeof(double);
+  }
+
+  const ArrayMemoryUsage usage = a.memory_usage();
+  BOOST_CHECK_EQUAL(usage.tiles, local_tiles);
+  BOOST_CHECK_EQUAL(usage.pending, 0ul);
+  BOOST_CHECK_EQUAL(usage.bytes, local_bytes);
+
+  // The peak of the last expression evaluation is recorded
+  TArrayD b;
+  b("a,b,c") = 2.0 * a("a,b,c");
+  BOOST_CHECK(memory_statistics().eval_peak_bytes >= local_bytes);
+
+  std::stringstream ss;
+  BOOST_REQUIRE_NO_THROW(memory_report(*GlobalFixture::world, ss));
+  if(GlobalFixture::world->rank() == 0)
+    BOOST_CHECK(ss.str().find("total") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
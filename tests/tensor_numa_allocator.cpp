@@ -0,0 +1,111 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/tensor/numa_allocator.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include <cstdint>
+
+using TiledArray::NumaAllocator;
+using TiledArray::NumaScope;
+using TiledArray::detail::PageAllocator;
+
+struct NumaAllocatorFixture {
+  typedef TiledArray::Tensor<double, NumaAllocator<double> > TensorN;
+
+  NumaAllocatorFixture() { }
+
+  ~NumaAllocatorFixture() { NumaAllocator<double>::set_explicit_huge_pages(false); }
+
+  template <typename T>
+  static void check_buffer(NumaAllocator<T>& alloc, const std::size_t n,
+      const std::size_t alignment)
+  {
+    T* p = nullptr;
+    BOOST_REQUIRE_NO_THROW(p = alloc.allocate(n));
+    BOOST_REQUIRE(p != nullptr);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p) % alignment, 0ul);
+    for(std::size_t i = 0ul; i < n; ++i)
+      p[i] = T(i);
+    BOOST_CHECK_EQUAL(p[n - 1ul], T(n - 1ul));
+    BOOST_CHECK_NO_THROW(alloc.deallocate(p, n));
+  }
+
+}; // NumaAllocatorFixture
+
+BOOST_FIXTURE_TEST_SUITE( numa_allocator_suite, NumaAllocatorFixture )
+
+BOOST_AUTO_TEST_CASE( mapped_bytes )
+{
+  BOOST_CHECK_EQUAL(PageAllocator::mapped_bytes(PageAllocator::min_bytes() + 1ul),
+      PageAllocator::min_bytes() + PageAllocator::page_bytes());
+  BOOST_CHECK_EQUAL(PageAllocator::mapped_bytes(PageAllocator::huge_page_bytes() + 1ul),
+      2ul * PageAllocator::huge_page_bytes());
+}
+
+BOOST_AUTO_TEST_CASE( allocate )
+{
+  NumaAllocator<double> alloc;
+
+  // Small, mapped, and huge-page buffers
+  check_buffer(alloc, 100ul, EIGEN_MAX_ALIGN_BYTES);
+  check_buffer(alloc, PageAllocator::min_bytes() / sizeof(double) + 3ul,
+      PageAllocator::page_bytes());
+  check_buffer(alloc, PageAllocator::huge_page_bytes() / sizeof(double) + 3ul,
+      PageAllocator::page_bytes());
+
+  // Explicit huge pages fall back to transparent huge pages
+  NumaAllocator<double>::set_explicit_huge_pages(true);
+  check_buffer(alloc, PageAllocator::huge_page_bytes() / sizeof(double),
+      PageAllocator::page_bytes());
+
+  // Zero-size allocations
+  BOOST_CHECK(alloc.allocate(0ul) == nullptr);
+  BOOST_CHECK_NO_THROW(alloc.deallocate(nullptr, 0ul));
+}
+
+BOOST_AUTO_TEST_CASE( scope )
+{
+  BOOST_CHECK_EQUAL(NumaScope::node(), -1);
+  {
+    NumaScope outer(0);
+    BOOST_CHECK_EQUAL(NumaScope::node(), 0);
+    {
+      NumaScope inner(NumaScope::local());
+      BOOST_CHECK_EQUAL(NumaScope::node(), NumaScope::local());
+
+      NumaAllocator<double> alloc;
+      check_buffer(alloc, PageAllocator::min_bytes(), PageAllocator::page_bytes());
+    }
+    BOOST_CHECK_EQUAL(NumaScope::node(), 0);
+  }
+  BOOST_CHECK_EQUAL(NumaScope::node(), -1);
+}
+
+BOOST_AUTO_TEST_CASE( tensor )
+{
+  TiledArray::Range r(std::vector<std::size_t>{64ul, 64ul, 64ul});
+  NumaScope scope(NumaScope::local());
+  TensorN t(r, 1.5);
+  TensorN s = t.scale(2.0);
+  for(std::size_t i = 0ul; i < r.volume(); ++i)
+    BOOST_CHECK_EQUAL(s[i], 3.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1109,6 +1109,97 @@ BOOST_AUTO_TEST_CASE( reduce )
 #endif
 #endif
 
+BOOST_AUTO_TEST_CASE( nested_buffer )
+{
+  Tensor<Tensor<int> > t = a.mult(b);
+
+  // The inner tensors are stored in one buffer in the order of the elements
+  for(std::size_t i = 1ul; i < t.size(); ++i)
+    BOOST_CHECK(t[i - 1].data() + t[i - 1].size() <= t[i].data());
+  BOOST_CHECK(t[t.size() - 1].data() - t[0].data() < std::ptrdiff_t(2 * t.size() * 100));
+
+  // Inner tensors keep the shared buffer alive
+  Tensor<int> inner = t(1, 2);
+  t = Tensor<Tensor<int> >();
+  for(std::size_t index = 0ul; index < inner.size(); ++index)
+    BOOST_CHECK_EQUAL(inner[index], a(1,2)[index] * b(1,2)[index]);
+}
+
+BOOST_AUTO_TEST_CASE( nested_gemm )
+{
+  const Range inner_range(std::array<std::size_t, 2>{{3ul, 4ul}});
+  auto make_tot = [&] (const std::size_t m, const std::size_t n) {
+    Tensor<Tensor<int> > tensor(Range(std::array<std::size_t, 2>{{m, n}}));
+    for(std::size_t i = 0ul; i < tensor.size(); ++i)
+      tensor[i] = make_rand_tensor(inner_range);
+    return tensor;
+  };
+  Tensor<Tensor<int> > left = make_tot(3ul, 4ul), right = make_tot(4ul, 5ul);
+
+  // Products with an empty inner tensor are skipped
+  left(1, 2) = Tensor<int>();
+
+  const math::GemmHelper gemm_helper(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, 2u, 2u, 2u);
+  Tensor<Tensor<int> > result;
+  BOOST_REQUIRE_NO_THROW(result = left.gemm(right, 2, gemm_helper));
+  BOOST_CHECK_EQUAL(result.range(), Range(std::array<std::size_t, 2>{{3ul, 5ul}}));
+
+  // Accumulate a second product
+  BOOST_REQUIRE_NO_THROW(result.gemm(left, right, 1, gemm_helper));
+
+  for(std::size_t i = 0ul; i < 3ul; ++i) {
+    for(std::size_t j = 0ul; j < 5ul; ++j) {
+      BOOST_REQUIRE_EQUAL(result(i,j).range(), inner_range);
+      for(std::size_t x = 0ul; x < inner_range.volume(); ++x) {
+        int expected = 0;
+        for(std::size_t p = 0ul; p < 4ul; ++p)
+          if(! left(i,p).empty())
+            expected += 3 * left(i,p)[x] * right(p,j)[x];
+        BOOST_CHECK_EQUAL(result(i,j)[x], expected);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( nested_inner_gemm )
+{
+  Tensor<Tensor<int> > left(Range(std::array<std::size_t, 2>{{2ul, 3ul}}));
+  Tensor<Tensor<int> > right(Range(std::array<std::size_t, 2>{{3ul, 2ul}}));
+  for(std::size_t i = 0ul; i < 2ul; ++i) {
+    for(std::size_t p = 0ul; p < 3ul; ++p) {
+      // Inner contracted dimension that differs for each outer index
+      left(i,p) = make_rand_tensor(Range(std::array<std::size_t, 2>{{4ul + i, 2ul + p}}));
+      right(p,i) = make_rand_tensor(Range(std::array<std::size_t, 2>{{2ul + p, 5ul + i}}));
+    }
+  }
+
+  const math::GemmHelper gemm_helper(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, 2u, 2u, 2u);
+  const math::GemmHelper inner_helper(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, 2u, 2u, 2u);
+  Tensor<Tensor<int> > result;
+  BOOST_REQUIRE_NO_THROW(result = detail::nested_gemm<Tensor<Tensor<int> > >(
+      left, right, 2, gemm_helper, inner_helper));
+
+  for(std::size_t i = 0ul; i < 2ul; ++i) {
+    for(std::size_t j = 0ul; j < 2ul; ++j) {
+      const std::size_t m = 4ul + i, n = 5ul + j;
+      BOOST_REQUIRE_EQUAL(result(i,j).range(),
+          Range(std::array<std::size_t, 2>{{m, n}}));
+      for(std::size_t x = 0ul; x < m; ++x) {
+        for(std::size_t y = 0ul; y < n; ++y) {
+          int expected = 0;
+          for(std::size_t p = 0ul; p < 3ul; ++p)
+            for(std::size_t q = 0ul; q < 2ul + p; ++q)
+              expected += 2 * left(i,p)(x,q) * right(p,j)(q,y);
+          BOOST_CHECK_EQUAL(result(i,j)(x,y), expected);
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE_TEMPLATE( serialization, ITensor, itensor_types )
 {
   const auto& a = ToT<ITensor>(0);
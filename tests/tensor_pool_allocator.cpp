@@ -0,0 +1,140 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/tensor/pool_allocator.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include <cstdint>
+#include <thread>
+
+using TiledArray::PoolAllocator;
+using TiledArray::PoolStatistics;
+using TiledArray::detail::TilePool;
+
+struct PoolAllocatorFixture {
+  typedef TiledArray::Tensor<double, PoolAllocator<double> > TensorN;
+
+  PoolAllocatorFixture() { TilePool::instance().release(); }
+
+  ~PoolAllocatorFixture() { TilePool::instance().release(); }
+
+}; // PoolAllocatorFixture
+
+BOOST_FIXTURE_TEST_SUITE( pool_allocator_suite, PoolAllocatorFixture )
+
+BOOST_AUTO_TEST_CASE( allocate )
+{
+  PoolAllocator<double> alloc;
+  TilePool::instance().reset_statistics();
+
+  double* p = nullptr;
+  BOOST_REQUIRE_NO_THROW(p = alloc.allocate(1000ul));
+  BOOST_REQUIRE(p != nullptr);
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p) % EIGEN_MAX_ALIGN_BYTES, 0ul);
+  for(std::size_t i = 0ul; i < 1000ul; ++i)
+    p[i] = double(i);
+  BOOST_CHECK_EQUAL(PoolAllocator<double>::statistics().misses, 1ul);
+  BOOST_CHECK_EQUAL(PoolAllocator<double>::statistics().bytes_held, 0ul);
+
+  // The freed buffer is held by the pool
+  alloc.deallocate(p, 1000ul);
+  BOOST_CHECK(PoolAllocator<double>::statistics().bytes_held >= 1000ul * sizeof(double));
+
+  // Buffers of the same size class are recycled
+  double* q = alloc.allocate(990ul);
+  BOOST_CHECK_EQUAL(q, p);
+  BOOST_CHECK_EQUAL(PoolAllocator<double>::statistics().hits, 1ul);
+  BOOST_CHECK_EQUAL(PoolAllocator<double>::statistics().bytes_held, 0ul);
+  BOOST_CHECK_CLOSE(PoolAllocator<double>::statistics().hit_rate(), 0.5, 1.0e-8);
+  alloc.deallocate(q, 990ul);
+
+  // Zero-size allocations do not use the pool
+  BOOST_CHECK(alloc.allocate(0ul) == nullptr);
+  BOOST_CHECK_NO_THROW(alloc.deallocate(nullptr, 0ul));
+}
+
+BOOST_AUTO_TEST_CASE( large_buffer )
+{
+  PoolAllocator<char> alloc;
+  TilePool::instance().reset_statistics();
+
+  const std::size_t n = TilePool::max_bytes() + 1ul;
+  char* p = alloc.allocate(n);
+  p[0] = 'a';
+  p[n - 1ul] = 'z';
+  alloc.deallocate(p, n);
+
+  // Buffers larger than the largest size class are not held
+  const PoolStatistics stats = PoolAllocator<char>::statistics();
+  BOOST_CHECK_EQUAL(stats.misses, 1ul);
+  BOOST_CHECK_EQUAL(stats.bytes_held, 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( tensor )
+{
+  TiledArray::Range r(std::vector<std::size_t>{7ul, 9ul, 11ul});
+  TensorN t(r, 1.5);
+  TensorN s = t.scale(2.0);
+  for(std::size_t i = 0ul; i < r.volume(); ++i)
+    BOOST_CHECK_EQUAL(s[i], 3.0);
+
+  // Temporaries of the same size recycle the buffer of the previous one
+  TilePool::instance().reset_statistics();
+  for(int i = 0; i < 10; ++i) {
+    TensorN u = t.add(s);
+    BOOST_CHECK_EQUAL(u[0], 4.5);
+  }
+  BOOST_CHECK_EQUAL(PoolAllocator<double>::statistics().hits, 9ul);
+}
+
+BOOST_AUTO_TEST_CASE( threads )
+{
+  PoolAllocator<double> alloc;
+  TilePool::instance().reset_statistics();
+
+  // Buffers of an exiting thread are returned to the global pool
+  double* p = nullptr;
+  std::thread([&] () {
+    p = alloc.allocate(512ul);
+    alloc.deallocate(p, 512ul);
+  }).join();
+  BOOST_CHECK(PoolAllocator<double>::statistics().bytes_held >= 512ul * sizeof(double));
+
+  double* q = alloc.allocate(512ul);
+  BOOST_CHECK_EQUAL(q, p);
+  BOOST_CHECK_EQUAL(PoolAllocator<double>::statistics().hits, 1ul);
+
+  // Buffers freed by another thread are recycled
+  std::thread([&] () { alloc.deallocate(q, 512ul); }).join();
+  BOOST_CHECK_EQUAL(alloc.allocate(512ul), q);
+  alloc.deallocate(q, 512ul);
+}
+
+BOOST_AUTO_TEST_CASE( release )
+{
+  PoolAllocator<float> alloc;
+  float* p = alloc.allocate(100ul);
+  alloc.deallocate(p, 100ul);
+  BOOST_CHECK(PoolAllocator<float>::statistics().bytes_held > 0ul);
+
+  TilePool::instance().release();
+  BOOST_CHECK_EQUAL(PoolAllocator<float>::statistics().bytes_held, 0ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -406,4 +406,21 @@ BOOST_AUTO_TEST_CASE( scale_to_view )
   }
 }
 
+BOOST_AUTO_TEST_CASE( range_runs )
+{
+  const std::array<int, 3> lower{{1,2,2}}, upper{{4,5,11}};
+  TensorView<int> view = t.block(lower,upper);
+  Tensor<int> tensor = random_tensor(Range(lower, upper));
+
+  // Check that the offsets of the runs of a view and a tensor match the
+  // ordinal offsets of their elements
+  const auto stride = detail::inner_size(view, tensor);
+  BOOST_CHECK_EQUAL(stride, 27ul);
+  detail::RangeRuns<2> runs(stride, view.range(), tensor.range());
+  for(std::size_t i = 0ul; i < view.range().volume(); i += stride, runs.next()) {
+    BOOST_CHECK_EQUAL(runs.offset(0), view.range().ordinal(i));
+    BOOST_CHECK_EQUAL(runs.offset(1), i);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
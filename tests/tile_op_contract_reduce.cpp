@@ -472,4 +472,104 @@ BOOST_AUTO_TEST_CASE( tensor_contract2 )
 }
 
 
+BOOST_AUTO_TEST_CASE( permute_outer )
+{
+  // Set dimension constants
+  const std::size_t
+      left_outer_start = 2, left_outer_finish = 20,
+      inner_start = 3, inner_finish = 30,
+      right_outer_start = 4, right_outer_finish = 40;
+
+  TensorI left = make_tensor(left_outer_start, inner_start, left_outer_finish, inner_finish);
+  TensorI leftT = make_tensor(inner_start, left_outer_start, inner_finish, left_outer_finish);
+  TensorI right = make_tensor(inner_start, right_outer_start, inner_finish, right_outer_finish);
+  TensorI rightT = make_tensor(right_outer_start, inner_start, right_outer_finish, inner_finish);
+
+  const Permutation perm({1, 0});
+  const madness::cblas::CBLAS_TRANSPOSE ops[2] =
+      { madness::cblas::NoTrans, madness::cblas::Trans };
+
+  for(auto left_op : ops) {
+    for(auto right_op : ops) {
+      const TensorI& l = (left_op == madness::cblas::NoTrans ? left : leftT);
+      const TensorI& r = (right_op == madness::cblas::NoTrans ? right : rightT);
+
+      // The reference is the permuted product
+      ContractReduce<TensorI, TensorI, TensorI, int>
+      ref_op(left_op, right_op, 3, 2u, 2u, 2u);
+      TensorI reference;
+      ref_op(reference, l, r);
+      ref_op(reference, l, r);
+      reference = reference.permute(perm);
+
+      // Swapping the outer dimensions is folded into the tile GEMM
+      ContractReduce<TensorI, TensorI, TensorI, int>
+      op(left_op, right_op, 3, 2u, 2u, 2u, perm);
+      BOOST_CHECK(op.perm_in_gemm());
+
+      TensorI result;
+      BOOST_REQUIRE_NO_THROW(op(result, l, r));
+      BOOST_REQUIRE_NO_THROW(op(result, l, r));
+      BOOST_REQUIRE_NO_THROW(result = op(result));
+
+      BOOST_CHECK_EQUAL(result.range(), reference.range());
+      BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+          reference.begin(), reference.end());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( permute_result )
+{
+  TensorI left = make_tensor(2, 3, 4, 10, 11, 12);
+  TensorI right = make_tensor(4, 5, 12, 13);
+
+  // A permutation that does not exchange the outer dimensions in order is
+  // applied to the result tile
+  const Permutation perm({2, 0, 1});
+  ContractReduce<TensorI, TensorI, TensorI, int>
+  op(madness::cblas::NoTrans, madness::cblas::NoTrans, 1, 3u, 3u, 2u, perm);
+  BOOST_CHECK(! op.perm_in_gemm());
+
+  ContractReduce<TensorI, TensorI, TensorI, int>
+  ref_op(madness::cblas::NoTrans, madness::cblas::NoTrans, 1, 3u, 3u, 2u);
+  TensorI reference;
+  ref_op(reference, left, right);
+  reference = reference.permute(perm);
+
+  TensorI result;
+  op(result, left, right);
+  result = op(result);
+
+  BOOST_CHECK_EQUAL(result.range(), reference.range());
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+      reference.begin(), reference.end());
+}
+
+BOOST_AUTO_TEST_CASE( mixed_precision )
+{
+  TensorI left = make_tensor(2, 3, 4, 10, 11, 12);
+  TensorI right = make_tensor(4, 5, 12, 13);
+  TensorF left_f(left.range(), left.begin());
+  TensorF right_f(right.range(), right.begin());
+
+  ContractReduce<TensorI, TensorI, TensorI, int>
+  ref_op(madness::cblas::NoTrans, madness::cblas::NoTrans, 1, 3u, 3u, 2u);
+  TensorI reference;
+  ref_op(reference, left, right);
+  ref_op(reference, left, right);
+
+  // Float tiles are contracted into a double result tile
+  ContractReduce<TensorD, TensorF, TensorF, double>
+  op(madness::cblas::NoTrans, madness::cblas::NoTrans, 1.0, 3u, 3u, 2u);
+  TensorD result;
+  op(result, left_f, right_f);
+  op(result, left_f, right_f);
+  result = op(result);
+
+  BOOST_CHECK_EQUAL(result.range(), reference.range());
+  for(std::size_t i = 0ul; i < result.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], double(reference[i]));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
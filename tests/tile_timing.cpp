@@ -0,0 +1,102 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  tile_timing.cpp
+ *
+ */
+
+#include "TiledArray/tile_timing.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include <sstream>
+
+using namespace TiledArray;
+using TiledArray::detail::TileTimings;
+
+struct TileTimingFixture {
+
+  TileTimingFixture() :
+    tr1{0, 3, 8, 10, 16},
+    tr{ tr1, tr1 }
+  {
+    set_tile_timing(true);
+    reset_tile_timing();
+  }
+
+  ~TileTimingFixture() {
+    set_tile_timing(false);
+    reset_tile_timing();
+  }
+
+  /// \return The number of tiles of \c source timed by all processes
+  static std::size_t count(const TileTimings::Source source) {
+    std::size_t result = 0ul;
+    for(const auto& r : TileTimings::records())
+      if(r.source == source)
+        ++result;
+    GlobalFixture::world->gop.sum(result);
+    return result;
+  }
+
+  TiledRange1 tr1;
+  TiledRange tr;
+}; // TileTimingFixture
+
+BOOST_FIXTURE_TEST_SUITE( tile_timing_suite, TileTimingFixture )
+
+BOOST_AUTO_TEST_CASE( record_tiles )
+{
+  World& world = *GlobalFixture::world;
+  TArrayD a(world, tr), b(world, tr);
+  a.fill_local(1.0);
+  b.fill_local(2.0);
+
+  TArrayD c, d;
+  c("i,j") = a("i,k") * b("k,j");
+  d("i,j") = a("i,j") + b("i,j");
+  world.gop.fence();
+
+  // Each result tile is timed once
+  BOOST_CHECK_EQUAL(count(TileTimings::summa), tr.tiles_range().volume());
+  BOOST_CHECK_EQUAL(count(TileTimings::binary), tr.tiles_range().volume());
+
+  const TileTimingReport report = tile_timing_report(world, 3ul);
+  BOOST_CHECK_EQUAL(report.counts.size(), world.size());
+  BOOST_CHECK(report.imbalance >= 1.0);
+  for(std::size_t p = 0ul; p < report.counts.size(); ++p) {
+    std::size_t binned = 0ul;
+    for(const auto count : report.histograms[p])
+      binned += count;
+    BOOST_CHECK_EQUAL(binned, report.counts[p]);
+    BOOST_CHECK(report.outliers[p].size() <= 3ul);
+    for(const auto& outlier : report.outliers[p])
+      BOOST_CHECK(outlier.time <= report.max_times[p]);
+  }
+
+  std::stringstream ss;
+  report.print(ss);
+  BOOST_CHECK(ss.str().find("imbalance") != std::string::npos);
+
+  // Nothing is recorded when timing is disabled
+  reset_tile_timing();
+  set_tile_timing(false);
+  d("i,j") = a("i,j") + b("i,j");
+  world.gop.fence();
+  BOOST_CHECK_EQUAL(count(TileTimings::binary), 0ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
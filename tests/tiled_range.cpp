@@ -105,6 +105,26 @@ BOOST_AUTO_TEST_CASE( comparison ) {
   BOOST_CHECK(r1 != r3);
 }
 
+BOOST_AUTO_TEST_CASE( shared_data ) {
+  // Identical tilings share their data, and copies do not allocate
+  TiledRange r1{{ 0, 2, 4, 6, 8, 10 },
+                { 0, 3, 6, 9, 12, 15 }};
+  TiledRange r2{{ 0, 2, 4, 6, 8, 10 },
+                { 0, 3, 6, 9, 12, 15 }};
+  TiledRange r3{{ 0, 3, 6, 9, 12, 15 },
+                { 0, 2, 4, 6, 8, 10 }};
+  BOOST_CHECK(r1.shares_data(r2));
+  BOOST_CHECK(! r1.shares_data(r3));
+  const TiledRange r4 = r1;
+  BOOST_CHECK(r4.shares_data(r1));
+  BOOST_CHECK(&r4.tiles_range() == &r1.tiles_range());
+
+  // Permuted tilings share the data of identical tilings
+  const TiledRange r5 = Permutation({1, 0}) * r1;
+  BOOST_CHECK(r5.shares_data(r3));
+  BOOST_CHECK_EQUAL(r5, r3);
+}
+
 BOOST_AUTO_TEST_CASE( assignment )
 {
   TiledRange r1;
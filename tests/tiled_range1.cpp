@@ -182,6 +182,18 @@ BOOST_AUTO_TEST_CASE( element_to_tile )
 
   // Check that the expected and internal element to tile maps match.
   BOOST_CHECK_EQUAL_COLLECTIONS(c.begin(), c.end(), e.begin(), e.end());
+
+  // Check uniform tilings, with and without a smaller last tile, and a
+  // tiling whose last tile is larger, which is not uniform
+  for(const TiledRange1& r : { TiledRange1{ 3, 6, 9, 12 },
+      TiledRange1{ 3, 6, 9, 11 }, TiledRange1{ 3, 6, 9, 13 },
+      TiledRange1{ 0, 10 } })
+  {
+    for(std::size_t t = r.tiles_range().first; t < r.tiles_range().second; ++t)
+      for(std::size_t i = r.tile(t).first; i < r.tile(t).second; ++i)
+        BOOST_CHECK_EQUAL(r.element_to_tile(i), t);
+    BOOST_CHECK(r.find(r.elements_range().second) == r.end());
+  }
 }
 
 BOOST_AUTO_TEST_CASE( comparison )
@@ -0,0 +1,99 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/top_k.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct TopKFixture {
+
+  TopKFixture() : world(* GlobalFixture::world),
+    tr({TiledRange1{0, 4, 9, 12}, TiledRange1{0, 5, 11}})
+  { }
+
+  // The elements of the first tile row are much larger than the others
+  static double element(const Range::index& idx) {
+    return (idx[0] < 4ul ? 1.0 : 1.0e-3) *
+        (double((idx[0] * 7ul + idx[1] * 13ul) % 31ul) - 15.0);
+  }
+
+  // The k largest-magnitude elements, selected from all elements
+  std::vector<std::pair<Range::index, double> >
+  expected(const std::size_t k) const {
+    std::vector<std::pair<std::size_t, double> > elements;
+    const Range& range = tr.elements_range();
+    for(std::size_t i = 0ul; i < range.volume(); ++i)
+      elements.emplace_back(i, element(range.idx(i)));
+    std::stable_sort(elements.begin(), elements.end(),
+        & detail::top_k_before<double>);
+    std::vector<std::pair<Range::index, double> > result;
+    for(std::size_t i = 0ul; i < std::min(k, elements.size()); ++i)
+      result.emplace_back(range.idx(elements[i].first), elements[i].second);
+    return result;
+  }
+
+  static void check_equal(const std::vector<std::pair<Range::index, double> >& expected,
+      const std::vector<std::pair<Range::index, double> >& result)
+  {
+    BOOST_REQUIRE_EQUAL(result.size(), expected.size());
+    for(std::size_t i = 0ul; i < result.size(); ++i) {
+      BOOST_CHECK(result[i].first == expected[i].first);
+      BOOST_CHECK_EQUAL(result[i].second, expected[i].second);
+    }
+  }
+
+  World& world;
+  TiledRange tr;
+};
+
+BOOST_FIXTURE_TEST_SUITE( top_k_suite, TopKFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  TArrayD a(world, tr);
+  a.init_elements(& TopKFixture::element);
+
+  for(const std::size_t k : {0ul, 1ul, 10ul, 200ul})
+    check_equal(expected(k), top_k(a, k));
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  // The shape holds the norms of the tiles, so the tiles of the small
+  // elements can be skipped
+  Tensor<float> norms(tr.tiles_range(), 0.0f);
+  for(std::size_t t = 0ul; t < norms.size(); ++t) {
+    double norm = 0.0;
+    for(const auto& idx : tr.make_tile_range(t))
+      norm += element(idx) * element(idx);
+    norms[t] = std::sqrt(norm);
+  }
+  TSpArrayD a(world, tr, SparseShape<float>(norms, tr));
+  a.init_elements(& TopKFixture::element);
+
+  for(const std::size_t k : {1ul, 10ul, 200ul})
+    check_equal(expected(k), top_k(a, k));
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -32,8 +32,23 @@
 #include "TiledArray/dist_eval/array_eval.h"
 #include "TiledArray/tensor.h"
 #include "TiledArray/tile_op/noop.h"
+#include "TiledArray/tile_op/unary_wrapper.h"
 #include "TiledArray/type_traits.h"
 
+// A lazy tile that fills a tile with its value
+struct FillTileD {
+  typedef TiledArray::Tensor<double> eval_type;
+
+  explicit operator eval_type() const {
+    return eval_type(TiledArray::Range(2, 2), value);
+  }
+
+  template <typename Archive>
+  void serialize(Archive& ar) { ar & value; }
+
+  double value = 0.0;
+};
+
 struct TypeTraitsFixture {
   TypeTraitsFixture() {}
 
@@ -259,4 +274,40 @@ BOOST_AUTO_TEST_CASE(convertibility) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(recomputable_array_tile) {
+  using TileD = TiledArray::Tensor<double>;
+  using Op = TiledArray::detail::UnaryWrapper<
+      TiledArray::detail::Noop<TileD, TileD, true>>;
+  using LazyTileD = TiledArray::detail::LazyArrayTile<TileD, Op>;
+  using LazyFillTileD = TiledArray::detail::LazyArrayTile<FillTileD, Op>;
+
+  constexpr bool tile_is_recomputable =
+      TiledArray::detail::is_recomputable_array_tile<LazyTileD>::value;
+  constexpr bool fill_tile_is_recomputable =
+      TiledArray::detail::is_recomputable_array_tile<LazyFillTileD>::value;
+  BOOST_CHECK(!tile_is_recomputable);
+  BOOST_CHECK(fill_tile_is_recomputable);
+
+  // Lazy tiles are not recomputed by default
+  BOOST_CHECK(TiledArray::lazy_tile_cost<FillTileD>::eval_time(
+      TiledArray::Range(2, 2)) == std::numeric_limits<double>::infinity());
+
+  // A recomputable tile is evaluated after it is deserialized
+  FillTileD fill_tile;
+  fill_tile.value = 3.0;
+  LazyFillTileD lazy_tile(fill_tile, std::make_shared<Op>(Op(
+      TiledArray::detail::Noop<TileD, TileD, true>())), false);
+  madness::archive::BufferOutputArchive count_ar;
+  count_ar & lazy_tile;
+  std::vector<unsigned char> buffer(count_ar.size());
+  madness::archive::BufferOutputArchive out_ar(buffer.data(), buffer.size());
+  out_ar & lazy_tile;
+  LazyFillTileD lazy_tile2;
+  madness::archive::BufferInputArchive in_ar(buffer.data(), buffer.size());
+  in_ar & lazy_tile2;
+  const TileD tile = static_cast<TileD>(lazy_tile2);
+  BOOST_CHECK_EQUAL(tile.size(), 4ul);
+  for (const auto value : tile) BOOST_CHECK_EQUAL(value, 3.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
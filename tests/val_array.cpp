@@ -0,0 +1,101 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  val_array.cpp
+ *  October 15, 2026
+ *
+ */
+
+#include <algorithm>
+#include <vector>
+#include "TiledArray/val_array.h"
+#include "unit_test_config.h"
+
+using TiledArray::detail::ValArray;
+
+struct ValArrayFixture {
+
+  ValArrayFixture() :
+    // A small array, and one that is split across threads
+    sizes({ 37ul, 2ul * TiledArray::math::parallel_vector_min_size + 7ul })
+  { }
+
+  /// Fill an array with small integers, so sums are exact
+  static ValArray<double> make_array(const std::size_t n, const std::size_t f) {
+    ValArray<double> result(n);
+    for(std::size_t i = 0ul; i < n; ++i)
+      result[i] = double((f * i) % 17ul);
+    return result;
+  }
+
+  const std::vector<std::size_t> sizes;
+}; // ValArrayFixture
+
+BOOST_FIXTURE_TEST_SUITE( val_array_suite, ValArrayFixture )
+
+BOOST_AUTO_TEST_CASE( reduce )
+{
+  auto sum = [] (double& result, const double value) { result += value; };
+  auto dot = [] (double& result, const double left, const double right)
+      { result += left * right; };
+  auto max = [] (double& result, const double value)
+      { result = std::max(result, value); };
+
+  for(const std::size_t n : sizes) {
+    const ValArray<double> x = make_array(n, 3ul);
+    const ValArray<double> y = make_array(n, 5ul);
+
+    double expected_sum = 0.0, expected_dot = 0.0, expected_max = -1.0;
+    for(std::size_t i = 0ul; i < n; ++i) {
+      expected_sum += x[i];
+      expected_dot += x[i] * y[i];
+      expected_max = std::max(expected_max, x[i]);
+    }
+
+    // Unary reductions, where the partial results are joined by join_op
+    BOOST_CHECK_EQUAL(x.reduce(0.0, sum, sum), expected_sum);
+    BOOST_CHECK_EQUAL(x.reduce(-1.0, max, max), expected_max);
+
+    // Binary reduction
+    BOOST_CHECK_EQUAL(x.reduce(y, 0.0, dot, sum), expected_dot);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( inplace_binary )
+{
+  for(const std::size_t n : sizes) {
+    ValArray<double> x = make_array(n, 3ul);
+    const ValArray<double> y = make_array(n, 5ul);
+
+    x.binary(y, [] (double& left, const double right) { left += 2.0 * right; });
+    for(std::size_t i = 0ul; i < n; ++i)
+      BOOST_CHECK_EQUAL(x[i], double((3ul * i) % 17ul) + 2.0 * y[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( inplace_unary )
+{
+  for(const std::size_t n : sizes) {
+    ValArray<double> x = make_array(n, 3ul);
+
+    x.unary([] (double& value) { value = 3.0 * value - 1.0; });
+    for(std::size_t i = 0ul; i < n; ++i)
+      BOOST_CHECK_EQUAL(x[i], 3.0 * double((3ul * i) % 17ul) - 1.0);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
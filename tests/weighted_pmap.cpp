@@ -0,0 +1,191 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/weighted_pmap.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct WeightedPmapFixture {
+
+  WeightedPmapFixture() { }
+
+  static std::vector<std::size_t> make_weights(const std::size_t tiles) {
+    // Every third tile is zero, and the tile sizes grow with the index
+    std::vector<std::size_t> weights(tiles);
+    for(std::size_t tile = 0ul; tile < tiles; ++tile)
+      weights[tile] = (tile % 3ul == 0ul ? 0ul : tile + 1ul);
+    return weights;
+  }
+
+};
+
+// =============================================================================
+// WeightedPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( weighted_pmap_suite, WeightedPmapFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    const std::vector<std::size_t> weights = make_weights(tiles);
+    BOOST_REQUIRE_NO_THROW(TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, weights));
+    TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, weights);
+    BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+    BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+    BOOST_CHECK_EQUAL(pmap.size(), tiles);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( partition )
+{
+  for(std::size_t procs = 1ul; procs < 10ul; ++procs) {
+    for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+      const std::vector<std::size_t> weights = make_weights(tiles);
+      const std::vector<std::size_t> first =
+          TiledArray::detail::WeightedPmap::partition(weights, procs);
+
+      BOOST_REQUIRE_EQUAL(first.size(), procs + 1ul);
+      BOOST_CHECK_EQUAL(first.front(), 0ul);
+      BOOST_CHECK_EQUAL(first.back(), tiles);
+
+      // The weight of each block differs from the average by at most the
+      // largest tile weight
+      const std::size_t total = std::accumulate(weights.begin(), weights.end(), 0ul);
+      const std::size_t max_weight = *std::max_element(weights.begin(), weights.end());
+      for(std::size_t p = 0ul; p < procs; ++p) {
+        BOOST_CHECK_LE(first[p], first[p + 1ul]);
+        const std::size_t block = std::accumulate(weights.begin() + first[p],
+            weights.begin() + first[p + 1ul], 0ul);
+        BOOST_CHECK_LE(double(block), double(total) / double(procs) + max_weight);
+      }
+    }
+  }
+
+  // Tiles are counted when all weights are zero
+  const std::vector<std::size_t> first =
+      TiledArray::detail::WeightedPmap::partition(std::vector<std::size_t>(8ul, 0ul), 4ul);
+  const std::vector<std::size_t> expected = { 0ul, 2ul, 4ul, 6ul, 8ul };
+  BOOST_CHECK_EQUAL_COLLECTIONS(first.begin(), first.end(),
+      expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t rank = GlobalFixture::world->rank();
+  const std::size_t size = GlobalFixture::world->size();
+
+  ProcessID* p_owner = new ProcessID[size];
+
+  // Check various pmap sizes
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, make_weights(tiles));
+
+    for(std::size_t tile = 0; tile < tiles; ++tile) {
+      std::fill_n(p_owner, size, 0);
+      p_owner[rank] = pmap.owner(tile);
+      // check that the value is in range
+      BOOST_CHECK_LT(p_owner[rank], size);
+      GlobalFixture::world->gop.sum(p_owner, size);
+
+      // Make sure everyone agrees on who owns what.
+      for(std::size_t p = 0ul; p < size; ++p)
+        BOOST_CHECK_EQUAL(p_owner[p], p_owner[rank]);
+    }
+  }
+
+  delete [] p_owner;
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[100];
+
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, make_weights(tiles));
+
+    // Check that all local elements map to this rank
+    for(detail::WeightedPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+    }
+
+    std::fill_n(tile_owners, tiles, 0);
+    for(detail::WeightedPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      tile_owners[*it] += GlobalFixture::world->rank();
+    }
+
+    GlobalFixture::world->gop.sum(tile_owners, tiles);
+    for(std::size_t tile = 0; tile < tiles; ++tile) {
+      BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+    }
+
+  }
+}
+
+BOOST_AUTO_TEST_CASE( shape_weights )
+{
+  TiledRange tr{ TiledRange1{0, 2, 5, 10}, TiledRange1{0, 4, 8} };
+  Tensor<float> norms(tr.tiles_range(), 1.0f);
+  norms[1] = 0.0f;
+  norms[4] = 0.0f;
+  SparseShape<float> shape(norms, tr);
+
+  TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, tr, shape);
+  BOOST_CHECK_EQUAL(pmap.size(), tr.tiles_range().volume());
+
+  std::size_t local_elements = 0ul;
+  for(const auto tile : pmap)
+    if(! shape.is_zero(tile))
+      local_elements += tr.make_tile_range(tile).volume();
+  GlobalFixture::world->gop.sum(local_elements);
+  BOOST_CHECK_EQUAL(local_elements, 8ul + 12ul + 12ul + 20ul);
+}
+
+BOOST_AUTO_TEST_CASE( diagnostics )
+{
+  TiledRange tr{ TiledRange1{0, 2, 5, 10}, TiledRange1{0, 4, 8} };
+  Tensor<float> norms(tr.tiles_range(), 1.0f);
+  norms[1] = 0.0f;
+  norms[4] = 0.0f;
+  SparseShape<float> shape(norms, tr);
+
+  TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, tr, shape);
+  const PmapDiagnostics diagnostics = pmap_diagnostics(pmap, tr, shape);
+
+  const std::size_t procs = GlobalFixture::world->size();
+  BOOST_CHECK_EQUAL(diagnostics.proc_rows * diagnostics.proc_cols, procs);
+  BOOST_REQUIRE_EQUAL(diagnostics.tiles.size(), procs);
+  BOOST_CHECK_EQUAL(std::accumulate(diagnostics.tiles.begin(),
+      diagnostics.tiles.end(), 0ul), tr.tiles_range().volume());
+  BOOST_CHECK_EQUAL(std::accumulate(diagnostics.nonzero_tiles.begin(),
+      diagnostics.nonzero_tiles.end(), 0ul), 4ul);
+  BOOST_CHECK_EQUAL(std::accumulate(diagnostics.nonzero_bytes.begin(),
+      diagnostics.nonzero_bytes.end(), 0ul), 8ul * (8ul + 12ul + 12ul + 20ul));
+  BOOST_CHECK_GE(diagnostics.imbalance, 1.0);
+  BOOST_CHECK_LE(diagnostics.locality, 1.0);
+  if(procs == 1ul) {
+    BOOST_CHECK_EQUAL(diagnostics.summa_bytes.front(), 0ul);
+    BOOST_CHECK_CLOSE(diagnostics.locality, 1.0, 1.0e-12);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
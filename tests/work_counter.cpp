@@ -0,0 +1,117 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  work_counter.cpp
+ *
+ */
+
+#include "TiledArray/work_counter.h"
+#include "TiledArray/roofline.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include <sstream>
+
+using namespace TiledArray;
+
+struct WorkCounterFixture {
+
+  WorkCounterFixture() :
+    tr1{0, 3, 8, 10, 16},
+    tr{ tr1, tr1 }
+  { }
+
+  /// \return The sum of \c value over all processes
+  static double global_sum(const std::uint64_t value) {
+    double result = double(value);
+    GlobalFixture::world->gop.sum(result);
+    return result;
+  }
+
+  TiledRange1 tr1;
+  TiledRange tr;
+}; // WorkCounterFixture
+
+BOOST_FIXTURE_TEST_SUITE( work_counter_suite, WorkCounterFixture )
+
+BOOST_AUTO_TEST_CASE( expression_counts )
+{
+  World& world = *GlobalFixture::world;
+  TArrayD a(world, tr), b(world, tr);
+  a.fill_local(1.0);
+  b.fill_local(2.0);
+  const double n = double(tr1.elements_range().second);
+
+  // A contraction counts 2mnk flops
+  TArrayD c;
+  c("i,j") = a("i,k") * b("k,j");
+  const WorkStatistics contraction = last_eval_statistics();
+  BOOST_CHECK_EQUAL(global_sum(contraction.flops), 2.0 * n * n * n);
+  BOOST_CHECK(contraction.wall_time >= 0.0);
+
+  // A scaled copy counts one flop per element
+  TArrayD d;
+  d("i,j") = 2.0 * a("i,j");
+  BOOST_CHECK_EQUAL(global_sum(last_eval_statistics().flops), n * n);
+
+  // Process totals include both evaluations
+  BOOST_CHECK(work_statistics().flops >= contraction.flops);
+
+  std::stringstream ss;
+  BOOST_REQUIRE_NO_THROW(eval_report(world, ss));
+  if(world.rank() == 0)
+    BOOST_CHECK(ss.str().find("GFLOP") != std::string::npos);
+
+  reset_work_statistics();
+  BOOST_CHECK_EQUAL(work_statistics().flops, 0ul);
+  BOOST_CHECK_EQUAL(last_eval_statistics().flops, 0ul);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( roofline )
+{
+  World& world = *GlobalFixture::world;
+  TArrayD a(world, tr), b(world, tr);
+  a.fill_local(1.0);
+  b.fill_local(2.0);
+  TArrayD c;
+  c("i,j") = a("i,k") * b("k,j");
+
+  // Without a network model, the evaluation is bound by compute
+  BlockSizeTuner::MachineModel peaks;
+  peaks.gemm_rate[16ul] = 1.0e9;
+  RooflineReport report = roofline_report(world, peaks);
+  BOOST_CHECK(report.bound == RooflineReport::compute ||
+      report.bound == RooflineReport::imbalance);
+  BOOST_CHECK_GT(report.compute_time, 0.0);
+  BOOST_CHECK_GE(report.flop_imbalance, 1.0);
+  BOOST_CHECK_EQUAL(report.transfer_time, 0.0);
+
+  // A slow network bounds a distributed evaluation
+  peaks.latency = 1.0e3;
+  peaks.bandwidth = 1.0;
+  report = roofline_report(world, peaks);
+  if(world.size() > 1)
+    BOOST_CHECK(report.bound == RooflineReport::bandwidth ||
+        report.bound == RooflineReport::latency);
+
+  std::stringstream ss;
+  report.print(ss, "c = a * b");
+  BOOST_CHECK(ss.str().find("-bound") != std::string::npos);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
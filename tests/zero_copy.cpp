@@ -0,0 +1,63 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/zero_copy.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct ZeroCopyFixture {
+
+  ZeroCopyFixture() { }
+
+  ~ZeroCopyFixture() { ZeroCopy::set(0ul); }
+
+};
+
+BOOST_FIXTURE_TEST_SUITE( zero_copy_suite, ZeroCopyFixture )
+
+BOOST_AUTO_TEST_CASE( settings )
+{
+  BOOST_CHECK_EQUAL(ZeroCopy::min_bytes(), 0ul);
+  BOOST_CHECK(! ZeroCopy::enabled(1ul << 30));
+
+  ZeroCopy::set(1024ul);
+  BOOST_CHECK_EQUAL(ZeroCopy::min_bytes(), 1024ul);
+  BOOST_CHECK(! ZeroCopy::enabled(1023ul));
+  BOOST_CHECK(ZeroCopy::enabled(1024ul));
+}
+
+BOOST_AUTO_TEST_CASE( tile_buffer )
+{
+  BOOST_CHECK(detail::has_tile_buffer<Tensor<double> >::value);
+  BOOST_CHECK(detail::has_tile_buffer<Tile<Tensor<double> > >::value);
+  BOOST_CHECK(! detail::has_tile_buffer<int>::value);
+
+  Tensor<double> tensor(Range(3, 4), 1.0);
+  const std::pair<void*, std::size_t> buffer = detail::tile_buffer(tensor);
+  BOOST_CHECK_EQUAL(buffer.first, static_cast<void*>(tensor.data()));
+  BOOST_CHECK_EQUAL(buffer.second, 12ul * sizeof(double));
+
+  Tile<Tensor<double> > tile(tensor);
+  BOOST_CHECK_EQUAL(detail::tile_buffer(tile).first,
+      static_cast<void*>(tile.tensor().data()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()